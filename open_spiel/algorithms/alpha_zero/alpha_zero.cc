@@ -14,22 +14,34 @@
 
 #include "open_spiel/algorithms/alpha_zero/alpha_zero.h"
 
+#include <algorithm>
 #include <cstdlib>
+#include <functional>
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <random>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "open_spiel/abseil-cpp/absl/algorithm/container.h"
 #include "open_spiel/abseil-cpp/absl/random/uniform_real_distribution.h"
 #include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/abseil-cpp/absl/strings/match.h"
+#include "open_spiel/abseil-cpp/absl/strings/numbers.h"
 #include "open_spiel/abseil-cpp/absl/strings/str_join.h"
 #include "open_spiel/abseil-cpp/absl/strings/str_split.h"
+#include "open_spiel/abseil-cpp/absl/strings/string_view.h"
 #include "open_spiel/abseil-cpp/absl/synchronization/mutex.h"
+#include "open_spiel/abseil-cpp/absl/synchronization/notification.h"
 #include "open_spiel/abseil-cpp/absl/time/clock.h"
 #include "open_spiel/abseil-cpp/absl/time/time.h"
+#include "open_spiel/abseil-cpp/absl/types/span.h"
 #include "open_spiel/algorithms/alpha_zero/device_manager.h"
+#include "open_spiel/algorithms/alpha_zero/inference_backend.h"
+#include "open_spiel/algorithms/alpha_zero/onnx_backend.h"
+#include "open_spiel/algorithms/alpha_zero/stub_backend.h"
 #include "open_spiel/algorithms/alpha_zero/vpevaluator.h"
 #include "open_spiel/algorithms/alpha_zero/vpnet.h"
 #include "open_spiel/algorithms/mcts.h"
@@ -40,86 +52,260 @@
 #include "open_spiel/utils/file.h"
 #include "open_spiel/utils/json.h"
 #include "open_spiel/utils/logger.h"
+#include "open_spiel/utils/random.h"
 #include "open_spiel/utils/lru_cache.h"
+#include "open_spiel/utils/replay_buffer.h"
 #include "open_spiel/utils/stats.h"
 #include "open_spiel/utils/thread.h"
 #include "open_spiel/utils/threaded_queue.h"
+#include "open_spiel/utils/trace.h"
+#include "open_spiel/utils/varint.h"
 
 namespace open_spiel::algorithms {
 
+// A game as the moves played, with the visit counts of the search's children
+// rather than the positions and policies, which the learner recreates by
+// replaying the moves, as the games are deterministic. The observations are
+// most of the size of a position, e.g. tens of kilobytes in go, so this keeps
+// the queue to the learner and the files of remote actors small.
 struct Trajectory {
   struct State {
-    std::vector<double> observation;
     open_spiel::Player current_player;
-    std::vector<open_spiel::Action> legal_actions;
     open_spiel::Action action;
-    open_spiel::ActionsAndProbs policy;
+    // The children visited at least once, in order, and their visit counts.
+    std::vector<std::pair<open_spiel::Action, int>> visits;
     double value;
   };
 
+  // The policy is the visit counts to the power 1/temperature, normalized.
+  double temperature;
   std::vector<State> states;
   std::vector<double> returns;
 };
 
+open_spiel::ActionsAndProbs VisitPolicy(const Trajectory::State& state,
+                                        double temperature) {
+  open_spiel::ActionsAndProbs policy;
+  policy.reserve(state.visits.size());
+  for (const auto& [action, count] : state.visits) {
+    policy.emplace_back(action, std::pow(count, 1.0 / temperature));
+  }
+  NormalizePolicy(&policy);
+  return policy;
+}
+
+// Trajectories are sent by the remote actors as varints, with the
+// temperature, values and returns as floats. The visited children are sorted,
+// so are delta encoded.
+std::string EncodeTrajectory(const Trajectory& trajectory) {
+  std::string out;
+  AppendFloat(trajectory.temperature, &out);
+  AppendVarint(trajectory.states.size(), &out);
+  for (const Trajectory::State& state : trajectory.states) {
+    AppendVarint(state.current_player, &out);
+    AppendVarint(state.action, &out);
+    AppendVarint(state.visits.size(), &out);
+    open_spiel::Action last = 0;
+    for (const auto& [action, count] : state.visits) {
+      AppendSignedVarint(action - last, &out);
+      AppendVarint(count, &out);
+      last = action;
+    }
+    AppendFloat(state.value, &out);
+  }
+  AppendVarint(trajectory.returns.size(), &out);
+  for (double r : trajectory.returns) AppendFloat(r, &out);
+  return out;
+}
+
+std::optional<Trajectory> DecodeTrajectory(absl::string_view bytes) {
+  VarintReader reader(bytes);
+  Trajectory trajectory;
+  trajectory.temperature = reader.ReadFloat();
+  trajectory.states.resize(reader.ReadSize());
+  for (Trajectory::State& state : trajectory.states) {
+    state.current_player = reader.Read();
+    state.action = reader.Read();
+    state.visits.resize(reader.ReadSize());
+    open_spiel::Action last = 0;
+    for (auto& [action, count] : state.visits) {
+      action = last + reader.ReadSigned();
+      count = reader.Read();
+      last = action;
+    }
+    state.value = reader.ReadFloat();
+    if (!reader.ok()) return std::nullopt;
+  }
+  trajectory.returns.resize(reader.ReadSize());
+  for (double& r : trajectory.returns) r = reader.ReadFloat();
+  if (!reader.ok() || !reader.empty()) return std::nullopt;
+  return trajectory;
+}
+
+std::string TrajectoriesPath(const AlphaZeroConfig& config, int host) {
+  return absl::StrCat(config.path, "/trajectories-", host, ".bin");
+}
+
+// Where the learner writes the path of the checkpoint the actor hosts should
+// use.
+std::string LatestCheckpointPath(const AlphaZeroConfig& config) {
+  return absl::StrCat(config.path, "/latest_checkpoint");
+}
+
+void WriteLatestCheckpoint(const AlphaZeroConfig& config,
+                           const std::string& checkpoint_path) {
+  file::File(LatestCheckpointPath(config), "w").Write(checkpoint_path + "\n");
+}
+
+// Returns an empty string if there is none yet, or it is being written.
+std::string ReadLatestCheckpoint(const AlphaZeroConfig& config) {
+  std::string path = LatestCheckpointPath(config);
+  if (!file::Exists(path)) return "";
+  std::string contents = file::File(path, "r").ReadContents();
+  if (contents.empty() || contents.back() != '\n') return "";
+  contents.pop_back();
+  return contents;
+}
+
+// The model of every device with the "stub" backend, which needs no graph.
+VPNetModel StubModel(const open_spiel::Game& game,
+                     const AlphaZeroConfig& config, absl::string_view device) {
+  return VPNetModel::Stub(
+      game, config.path, std::string(device),
+      std::make_unique<StubBackend>(
+          game.NumDistinctActions(), /*value=*/0,
+          absl::Milliseconds(config.stub_inference_latency_ms)),
+      absl::Milliseconds(config.stub_learn_latency_ms));
+}
+
+// A model for a device that only serves inference, which the ONNX Runtime
+// backends run instead of TensorFlow if asked.
+VPNetModel InferenceModel(const open_spiel::Game& game,
+                          const AlphaZeroConfig& config,
+                          absl::string_view device) {
+  if (config.inference_backend == "stub") {
+    return StubModel(game, config, device);
+  }
+  VPNetModel model(game, config.path, config.graph_def, std::string(device));
+  if (config.inference_backend == "tensorflow") return model;
+
+  OnnxBackend::Provider provider;
+  OnnxBackend::Precision precision = OnnxBackend::Precision::kFloat32;
+  if (config.inference_backend == "onnx_fp16") {
+    precision = OnnxBackend::Precision::kFloat16;
+  } else if (config.inference_backend == "onnx_int8") {
+    precision = OnnxBackend::Precision::kInt8;
+  }
+  if (config.inference_backend == "onnx" ||
+      precision != OnnxBackend::Precision::kFloat32) {
+    provider = absl::StrContains(device, "gpu") ? OnnxBackend::Provider::kCuda
+                                                : OnnxBackend::Provider::kCpu;
+  } else if (config.inference_backend == "tensorrt") {
+    provider = OnnxBackend::Provider::kTensorRT;
+  } else {
+    SpielFatalError(
+        absl::StrCat("Unknown inference backend: ", config.inference_backend));
+  }
+  // Devices are named like /gpu:1.
+  int device_id = 0;
+  std::vector<absl::string_view> parts = absl::StrSplit(device, ':');
+  if (parts.size() == 2) {
+    SPIEL_CHECK_TRUE(absl::SimpleAtoi(parts[1], &device_id));
+  }
+  model.SetInferenceBackend(std::make_unique<OnnxBackend>(
+      game.ObservationTensorSize(), game.NumDistinctActions(), provider,
+      device_id, precision));
+  return model;
+}
+
+// Plays the move chosen from the visits of the searched root, recording it in
+// the trajectory. Returns whether the game is over, either at a terminal state
+// or as the root's value is beyond the cutoff, with the trajectory's returns
+// set.
+bool PlaySearchedMove(
+    Logger* logger, const SearchNode& root, Philox* rng, double temperature,
+    int temperature_drop, double cutoff_value, bool verbose,
+    open_spiel::State* state, std::vector<std::string>* history,
+    Trajectory* trajectory) {
+  open_spiel::Player player = state->CurrentPlayer();
+  Trajectory::State entry{player, open_spiel::kInvalidAction, {},
+                         root.total_reward / root.explore_count};
+  for (const SearchNode& c : root.children) {
+    int count = c.explore_count.load();
+    if (count > 0) entry.visits.emplace_back(c.action, count);
+  }
+  std::sort(entry.visits.begin(), entry.visits.end());
+  if (history->size() >= temperature_drop) {
+    entry.action = root.BestChild().action;
+  } else {
+    entry.action = open_spiel::SampleAction(
+        VisitPolicy(entry, temperature), *rng).first;
+  }
+
+  open_spiel::Action action = entry.action;
+  double root_value = entry.value;
+  trajectory->states.push_back(std::move(entry));
+  std::string action_str = state->ActionToString(player, action);
+  history->push_back(action_str);
+  state->ApplyAction(action);
+  if (verbose) {
+    logger->Print("Player: %d, action: %s", player, action_str);
+  }
+  if (state->IsTerminal()) {
+    trajectory->returns = state->Returns();
+    return true;
+  } else if (std::abs(root_value) > cutoff_value) {
+    trajectory->returns.resize(2);
+    trajectory->returns[player] = root_value;
+    trajectory->returns[1 - player] = -root_value;
+    return true;
+  }
+  return false;
+}
+
+void LogGame(Logger* logger, int game_num, const Trajectory& trajectory,
+             const std::vector<std::string>& history) {
+  logger->Print(
+      "Game %d: Returns: %s; Actions: %s", game_num,
+      absl::StrJoin(trajectory.returns, " "),
+      absl::StrJoin(history, " "));
+}
+
 Trajectory PlayGame(
     Logger* logger,
     int game_num,
     const open_spiel::Game& game,
     std::vector<std::unique_ptr<MCTSBot>>* bots,
-    std::mt19937* rng, double temperature, int temperature_drop,
-    double cutoff_value, bool verbose = false) {
+    Philox* rng, double temperature, int temperature_drop,
+    double cutoff_value, ConcurrentLatencyHistogram* step_latency = nullptr,
+    bool verbose = false) {
   std::unique_ptr<open_spiel::State> state = game.NewInitialState();
   std::vector<std::string> history;
   Trajectory trajectory;
+  trajectory.temperature = temperature;
 
   while (true) {
     open_spiel::Player player = state->CurrentPlayer();
+    const absl::Time search_start = absl::Now();
     std::unique_ptr<SearchNode> root = (*bots)[player]->MCTSearch(*state);
-    open_spiel::ActionsAndProbs policy;
-    policy.reserve(root->children.size());
-    for (const SearchNode& c : root->children) {
-      policy.emplace_back(
-          c.action, std::pow(c.explore_count, 1.0 / temperature));
-    }
-    NormalizePolicy(&policy);
-    open_spiel::Action action;
-    if (history.size() >= temperature_drop) {
-      action = root->BestChild().action;
-    } else {
-      action = open_spiel::SampleAction(policy, *rng).first;
+    if (step_latency != nullptr) {
+      step_latency->Add(
+          absl::ToInt64Microseconds(absl::Now() - search_start));
     }
-
-    double root_value = root->total_reward / root->explore_count;
-    trajectory.states.push_back(Trajectory::State{
-        state->ObservationTensor(), player,
-        state->LegalActions(), action, std::move(policy), root_value});
-    std::string action_str = state->ActionToString(player, action);
-    history.push_back(action_str);
-    state->ApplyAction(action);
-    if (verbose) {
-      logger->Print("Player: %d, action: %s", player, action_str);
-    }
-    if (state->IsTerminal()) {
-      trajectory.returns = state->Returns();
-      break;
-    } else if (std::abs(root_value) > cutoff_value) {
-      trajectory.returns.resize(2);
-      trajectory.returns[player] = root_value;
-      trajectory.returns[1 - player] = -root_value;
+    if (PlaySearchedMove(logger, *root, rng, temperature, temperature_drop,
+                         cutoff_value, verbose, state.get(), &history,
+                         &trajectory)) {
       break;
     }
   }
 
-  logger->Print(
-      "Game %d: Returns: %s; Actions: %s", game_num,
-      absl::StrJoin(trajectory.returns, " "),
-      absl::StrJoin(history, " "));
+  LogGame(logger, game_num, trajectory, history);
   return trajectory;
 }
 
 std::unique_ptr<MCTSBot> InitAZBot(
     const AlphaZeroConfig& config, const open_spiel::Game& game,
-    std::shared_ptr<Evaluator> evaluator, bool evaluation) {
+    std::shared_ptr<Evaluator> evaluator, bool evaluation, int seed) {
   return std::make_unique<MCTSBot>(
       game,
       std::move(evaluator),
@@ -127,44 +313,280 @@ std::unique_ptr<MCTSBot> InitAZBot(
       config.max_simulations,
       /*max_memory_mb=*/ 10,
       /*solve=*/ false,
-      /*seed=*/ 0,
+      seed,
       /*verbose=*/ false,
       ChildSelectionPolicy::PUCT,
       evaluation ? 0 : config.policy_alpha,
-      evaluation ? 0 : config.policy_epsilon);
+      evaluation ? 0 : config.policy_epsilon,
+      /*num_threads=*/ 1,
+      ParallelismPolicy::TREE,
+      /*reuse_tree=*/ false,
+      config.leaf_batch_size);
 }
 
-// An actor thread runner that generates games and returns trajectories.
+// The profiles of the searches of each actor, added after each of their games,
+// and taken by the learner, and the latency of every move's search, added
+// without locks as the actors play.
+class ActorProfiles {
+ public:
+  explicit ActorProfiles(int actors) : profiles_(actors) {}
+
+  ConcurrentLatencyHistogram* StepLatency() { return &step_latency_; }
+  LatencyHistogram TakeStepLatency() {
+    LatencyHistogram latency = step_latency_.Snapshot();
+    step_latency_.Reset();
+    return latency;
+  }
+
+  void Add(int actor, const MCTSProfile& profile) {
+    absl::MutexLock lock(&m_);
+    profiles_[actor] += profile;
+  }
+
+  std::vector<MCTSProfile> Take() {
+    absl::MutexLock lock(&m_);
+    return std::exchange(profiles_,
+                         std::vector<MCTSProfile>(profiles_.size()));
+  }
+
+ private:
+  absl::Mutex m_;
+  std::vector<MCTSProfile> profiles_;
+  ConcurrentLatencyHistogram step_latency_;
+};
+
+// An actor thread runner that generates games and returns trajectories. The
+// searches are profiled if `profiles` isn't null.
 void actor(const open_spiel::Game& game, const AlphaZeroConfig& config, int num,
            ThreadedQueue<Trajectory>* trajectory_queue,
            std::shared_ptr<VPNetEvaluator> vp_eval,
-           StopToken* stop) {
+           ActorProfiles* profiles, StopToken* stop) {
+  trace::SetThreadName(absl::StrCat("actor-", num));
   std::unique_ptr<Logger> logger;
   if (num < 20) {  // Limit the number of open files.
     logger.reset(new FileLogger(config.path, absl::StrCat("actor-", num)));
   } else {
     logger.reset(new NoopLogger());
   }
-  std::mt19937 rng;
+  // Each actor samples its own stream, rather than all repeating one game.
+  Philox rng(/*seed=*/0, /*stream=*/num);
   absl::uniform_real_distribution<double> dist(0.0, 1.0);
   std::vector<std::unique_ptr<MCTSBot>> bots;
   bots.reserve(2);
   for (int player = 0; player < 2; player++) {
-    bots.push_back(InitAZBot(config, game, vp_eval, false));
+    bots.push_back(InitAZBot(config, game, vp_eval, false, /*seed=*/num));
+    bots.back()->SetProfiling(profiles != nullptr);
   }
-  for (int game_num = 1; !stop->StopRequested(); ++game_num) {
-    double cutoff = (dist(rng) < config.cutoff_probability
-                     ? config.cutoff_value : game.MaxUtility() + 1);
-    if (!trajectory_queue->Push(
-            PlayGame(logger.get(), game_num, game, &bots, &rng,
-                     config.temperature, config.temperature_drop, cutoff),
-            absl::Seconds(10))) {
+  auto new_cutoff = [&]() {
+    return dist(rng) < config.cutoff_probability ? config.cutoff_value
+                                                 : game.MaxUtility() + 1;
+  };
+  ConcurrentLatencyHistogram* step_latency =
+      profiles != nullptr ? profiles->StepLatency() : nullptr;
+  auto push = [&](Trajectory trajectory) {
+    if (!trajectory_queue->Push(std::move(trajectory), absl::Seconds(10))) {
       logger->Print("Failed to push a trajectory after 10 seconds.");
     }
+    if (profiles != nullptr) {
+      for (auto& bot : bots) profiles->Add(num, bot->TakeProfile());
+    }
+  };
+
+  if (config.actor_games <= 1) {
+    for (int game_num = 1; !stop->StopRequested(); ++game_num) {
+      push(PlayGame(logger.get(), game_num, game, &bots, &rng,
+                    config.temperature, config.temperature_drop,
+                    new_cutoff(), step_latency));
+    }
+    logger->Print("Got a quit.");
+    return;
+  }
+
+  // The games are played at once, each with a search in progress. Rather than
+  // waiting on the evaluation of its leaves, the searches are suspended and
+  // their leaves evaluated together, so that one thread fills the inference
+  // batches. The unfinished games are dropped when stopping.
+  struct ActorGame {
+    int game_num;
+    double cutoff;
+    std::unique_ptr<open_spiel::State> state;
+    std::vector<std::string> history;
+    Trajectory trajectory;
+    std::unique_ptr<MCTSBot::SteppedSearch> search;
+    absl::Time search_start;
+  };
+  int next_game_num = 1;
+  auto new_game = [&](ActorGame* g) {
+    g->game_num = next_game_num++;
+    g->cutoff = new_cutoff();
+    g->state = game.NewInitialState();
+    g->history.clear();
+    g->trajectory = Trajectory();
+    g->trajectory.temperature = config.temperature;
+  };
+  auto new_search = [&](ActorGame* g) {
+    g->search_start = absl::Now();
+    g->search = bots[g->state->CurrentPlayer()]->StartSteppedSearch(*g->state);
+  };
+  std::vector<ActorGame> games(config.actor_games);
+  for (ActorGame& g : games) {
+    new_game(&g);
+    new_search(&g);
+  }
+  std::vector<const open_spiel::State*> leaves;
+  std::vector<open_spiel::ActionsAndProbs> priors;
+  while (!stop->StopRequested()) {
+    for (ActorGame& g : games) {
+      // A search may be done without any leaf to evaluate, e.g. with a single
+      // legal action.
+      while (g.search->Done()) {
+        if (step_latency != nullptr) {
+          step_latency->Add(
+              absl::ToInt64Microseconds(absl::Now() - g.search_start));
+        }
+        std::unique_ptr<SearchNode> root = g.search->TakeRoot();
+        if (PlaySearchedMove(logger.get(), *root, &rng, config.temperature,
+                             config.temperature_drop, g.cutoff,
+                             /*verbose=*/false, g.state.get(), &g.history,
+                             &g.trajectory)) {
+          LogGame(logger.get(), g.game_num, g.trajectory, g.history);
+          push(std::move(g.trajectory));
+          new_game(&g);
+        }
+        new_search(&g);
+      }
+    }
+
+    leaves.clear();
+    for (const ActorGame& g : games) {
+      leaves.insert(leaves.end(), g.search->Leaves().begin(),
+                    g.search->Leaves().end());
+    }
+    std::vector<std::vector<double>> values =
+        vp_eval->EvaluateWithPriorBatch(leaves, &priors);
+    int offset = 0;
+    for (ActorGame& g : games) {
+      const int num_leaves = g.search->Leaves().size();
+      g.search->Resume(
+          absl::MakeConstSpan(values).subspan(offset, num_leaves),
+          absl::MakeSpan(priors).subspan(offset, num_leaves));
+      offset += num_leaves;
+    }
   }
   logger->Print("Got a quit.");
 }
 
+// Follows the trajectory files of the remote actor hosts, and adds their
+// trajectories to the queue. Each file is a sequence of records, each the
+// size of an encoded trajectory followed by it, so incomplete records at the
+// end are left for the next read.
+void remote_actors_reader(const AlphaZeroConfig& config,
+                          ThreadedQueue<Trajectory>* trajectory_queue,
+                          StopToken* stop) {
+  FileLogger logger(config.path, "remote-actors");
+  std::vector<int64_t> offsets(config.remote_actor_hosts, 0);
+  std::vector<int64_t> received(config.remote_actor_hosts, 0);
+  while (!stop->StopRequested()) {
+    bool any_read = false;
+    for (int host = 0; host < config.remote_actor_hosts; ++host) {
+      std::string path = TrajectoriesPath(config, host);
+      if (!file::Exists(path)) continue;
+      std::string bytes;
+      {
+        file::File fd(path, "r");
+        int64_t length = fd.Length();
+        if (length < offsets[host]) {  // The host restarted.
+          logger.Print("Host %d restarted after %d trajectories.", host,
+                       received[host]);
+          offsets[host] = 0;
+        }
+        if (length == offsets[host]) continue;
+        fd.Seek(offsets[host]);
+        bytes = fd.Read(length - offsets[host]);
+      }
+      const int64_t start = offsets[host];
+      VarintReader reader(bytes);
+      while (!reader.empty()) {
+        absl::string_view record = reader.ReadBytes(reader.Read());
+        if (!reader.ok()) break;  // Incomplete.
+        offsets[host] = start + bytes.size() - reader.remaining().size();
+        std::optional<Trajectory> trajectory = DecodeTrajectory(record);
+        if (!trajectory) {
+          logger.Print("Skipping a malformed trajectory from host %d.", host);
+          continue;
+        }
+        received[host] += 1;
+        any_read = true;
+        while (!stop->StopRequested() &&
+               !trajectory_queue->Push(*trajectory, absl::Seconds(1))) {}
+      }
+    }
+    if (!any_read) absl::SleepFor(absl::Seconds(1));
+  }
+  logger.Print("Got a quit.");
+}
+
+// The evaluators the actor and evaluator threads use, and the CPU each is
+// pinned to, if any, following config.placement.
+struct Placement {
+  std::vector<std::shared_ptr<VPNetEvaluator>> evals;
+  struct Slot {
+    int cpu;
+    int eval;
+  };
+  std::vector<Slot> slots;
+
+  // Pins the calling thread, the i-th, and returns its evaluator.
+  std::shared_ptr<VPNetEvaluator> Enter(int i) const {
+    const Slot& slot = slots[i % slots.size()];
+    if (slot.cpu >= 0) SetThreadAffinity({slot.cpu});
+    return evals[slot.eval];
+  }
+
+  void ClearCaches() const {
+    for (const auto& eval : evals) eval->ClearCache();
+  }
+};
+
+// Without pinning there is one evaluator for all the threads. With it, each
+// NUMA node gets an evaluator, with its share of the cache and inference
+// threads, and they inherit its CPUs from the thread creating it, while the
+// threads fill the nodes' CPUs in turn. Each thread's cache is then filled,
+// and so allocated, by the threads of its own node.
+Placement PlaceThreads(const AlphaZeroConfig& config,
+                       DeviceManager* device_manager, int num_threads) {
+  std::vector<std::vector<int>> nodes;
+  if (config.placement == "numa") {
+    nodes = CpusByNode();
+  } else if (config.placement != "none") {
+    SpielFatalError(absl::StrCat("Unknown placement: ", config.placement));
+  }
+
+  Placement placement;
+  if (nodes.empty()) {
+    placement.evals.push_back(std::make_shared<VPNetEvaluator>(
+        device_manager, config.inference_batch_size, config.inference_threads,
+        config.inference_cache, num_threads / 16,
+        absl::Milliseconds(config.inference_max_latency_ms)));
+    placement.slots.push_back({-1, 0});
+    return placement;
+  }
+
+  const std::vector<int> affinity = GetThreadAffinity();
+  for (int node = 0; node < nodes.size(); ++node) {
+    SetThreadAffinity(nodes[node]);
+    placement.evals.push_back(std::make_shared<VPNetEvaluator>(
+        device_manager, config.inference_batch_size,
+        std::max<int>(1, config.inference_threads / nodes.size()),
+        config.inference_cache / nodes.size(),
+        num_threads / (16 * nodes.size()),
+        absl::Milliseconds(config.inference_max_latency_ms)));
+    for (int cpu : nodes[node]) placement.slots.push_back({cpu, node});
+  }
+  SetThreadAffinity(affinity);
+  return placement;
+}
+
 class EvalResults {
  public:
   explicit EvalResults(int count, int evaluation_window) {
@@ -216,7 +638,8 @@ void evaluator(const open_spiel::Game& game, const AlphaZeroConfig& config,
                int num, EvalResults* results,
                std::shared_ptr<VPNetEvaluator> vp_eval, StopToken* stop) {
   FileLogger logger(config.path, absl::StrCat("evaluator-", num));
-  std::mt19937 rng;
+  trace::SetThreadName(absl::StrCat("evaluator-", num));
+  Philox rng(/*seed=*/1, /*stream=*/num);
   auto rand_evaluator = std::make_shared<RandomRolloutEvaluator>(1, num);
 
   for (int game_num = 1; !stop->StopRequested(); ++game_num) {
@@ -226,7 +649,8 @@ void evaluator(const open_spiel::Game& game, const AlphaZeroConfig& config,
         10, difficulty / 2.0);
     std::vector<std::unique_ptr<MCTSBot>> bots;
     bots.reserve(2);
-    bots.push_back(InitAZBot(config, game, vp_eval, true));
+    bots.push_back(InitAZBot(config, game, vp_eval, true,
+                             /*seed=*/config.actors + num));
     bots.push_back(std::make_unique<MCTSBot>(
             game,
             rand_evaluator,
@@ -255,23 +679,98 @@ void evaluator(const open_spiel::Game& game, const AlphaZeroConfig& config,
   logger.Print("Got a quit.");
 }
 
+// Does one synchronous data parallel training step on all the devices: each
+// computes the gradients of its shard of the batch, and they all apply the
+// mean, so that they keep the same weights. The gradients are averaged on the
+// host, weighted by the shard sizes, to get those of the whole batch.
+VPNetModel::LossInfo DataParallelLearn(DeviceManager* device_manager,
+                                       const ReplayBuffer& replay_buffer,
+                                       const std::vector<int>& indices) {
+  const int num_devices = device_manager->Count();
+  auto on_all_devices = [num_devices](const std::function<void(int)>& fn) {
+    std::vector<Thread> threads;
+    threads.reserve(num_devices - 1);
+    for (int i = 1; i < num_devices; ++i) {
+      threads.emplace_back([&fn, i]() { fn(i); });
+    }
+    fn(0);
+    for (auto& t : threads) {
+      t.join();
+    }
+  };
+
+  std::vector<std::vector<float>> gradients(num_devices);
+  std::vector<VPNetModel::LossInfo> losses(num_devices);
+  on_all_devices([&](int i) {
+    std::vector<int> shard(indices.begin() + indices.size() * i / num_devices,
+                           indices.begin() +
+                               indices.size() * (i + 1) / num_devices);
+    if (shard.empty()) return;
+    losses[i] = device_manager->Get(shard.size(), i)->ComputeGradients(
+        replay_buffer, shard, &gradients[i]);
+    // Scaled here to spread the work.
+    const float weight = static_cast<float>(shard.size()) / indices.size();
+    for (float& g : gradients[i]) g *= weight;
+  });
+
+  std::vector<float> mean;
+  VPNetModel::LossInfo total;
+  for (int i = 0; i < num_devices; ++i) {
+    if (gradients[i].empty()) continue;
+    if (mean.empty()) {
+      mean = std::move(gradients[i]);
+    } else {
+      SPIEL_CHECK_EQ(gradients[i].size(), mean.size());
+      for (int j = 0; j < mean.size(); ++j) mean[j] += gradients[i][j];
+    }
+    total += losses[i];
+  }
+
+  on_all_devices([&](int i) {
+    device_manager->Get(0, i)->ApplyGradients(mean);
+  });
+  return total;
+}
+
 void learner(const open_spiel::Game& game,
              const AlphaZeroConfig& config,
              DeviceManager* device_manager,
-             std::shared_ptr<VPNetEvaluator> eval,
+             const Placement& placement,
              ThreadedQueue<Trajectory>* trajectory_queue,
              EvalResults* eval_results,
+             ActorProfiles* actor_profiles,
              StopToken* stop) {
   FileLogger logger(config.path, "learner");
-  DataLoggerJsonLines data_logger(config.path, "learner", true);
+  trace::SetThreadName("learner");
+  // Flushed after each batch of records, from the logger's own thread.
+  DataLoggerAsync data_logger(
+      std::make_unique<DataLoggerJsonLines>(config.path, "learner"),
+      /*max_queued=*/1024, /*flush=*/true);
   std::mt19937 rng;
 
   int device_id = 0;
-  logger.Print("Running the learner on device %d: %s", device_id,
-               device_manager->Get(0, device_id)->Device());
+  if (config.data_parallel_learner) {
+    logger.Print("Running the learner on all %d devices.",
+                 device_manager->Count());
+  } else {
+    logger.Print("Running the learner on device %d: %s", device_id,
+                 device_manager->Get(0, device_id)->Device());
+  }
 
-  CircularBuffer<VPNetModel::TrainInputs> replay_buffer(
-      config.replay_buffer_size);
+  ReplayBuffer replay_buffer(config.replay_buffer_size,
+                             game.ObservationTensorSize(),
+                             game.NumDistinctActions(),
+                             config.replay_priority_exponent);
+  // The snapshot is saved from a copy of the buffer, in the background while
+  // the next trajectories are added to it.
+  const std::string snapshot_path =
+      absl::StrCat(config.path, "/replay_buffer");
+  std::optional<Thread> snapshotter;
+  if (config.replay_buffer_snapshot_freq > 0 && file::Exists(snapshot_path)) {
+    replay_buffer.Load(snapshot_path);
+    logger.Print("Restored %d states from %s", replay_buffer.Size(),
+                 snapshot_path);
+  }
   int learn_rate = config.replay_buffer_size / config.replay_buffer_reuse;
   int64_t total_trajectories = 0;
 
@@ -285,6 +784,19 @@ void learner(const open_spiel::Game& game,
   // Actor threads have likely been contributing for a while, so put `last` in
   // the past to avoid a giant spike on the first step.
   absl::Time last = absl::Now() - absl::Seconds(60);
+  // Publishes the checkpoint of the last step, to checkpoint_path.
+  std::optional<Thread> publisher;
+  std::string checkpoint_path;
+  std::vector<absl::Duration> last_busy_times = device_manager->BusyTimes();
+  // The batches being learnt from or prepared, reused from step to step so
+  // their tensors are only allocated once. The prepared ones are notified.
+  struct Prefetch {
+    std::vector<int> indices;
+    VPNetModel::TrainBatch batch;
+    std::unique_ptr<absl::Notification> prepared;
+  };
+  std::vector<Prefetch> prefetches(
+      std::max(0, config.learner_prefetch_batches) + 1);
   for (int step = 1; !stop->StopRequested() &&
                      (config.max_steps == 0 || step <= config.max_steps);
        ++step) {
@@ -299,6 +811,7 @@ void learner(const open_spiel::Game& game,
     }
 
     // Collect trajectories
+    const absl::Time collect_start = absl::Now();
     int queue_size = trajectory_queue->Size();
     int num_states = 0;
     int num_trajectories = 0;
@@ -313,13 +826,16 @@ void learner(const open_spiel::Game& game,
         double p1_outcome = trajectory->returns[0];
         outcomes.Add(p1_outcome > 0 ? 0 : (p1_outcome < 0 ? 1 : 2));
 
+        // Replay the game for the positions.
+        std::unique_ptr<open_spiel::State> position = game.NewInitialState();
         for (const Trajectory::State& state : trajectory->states) {
+          // Prioritize the positions whose value the search got most wrong.
           replay_buffer.Add(
-              VPNetModel::TrainInputs{
-                  state.legal_actions,
-                  state.observation,
-                  state.policy,
-                  p1_outcome});
+              position->ObservationTensor(), position->LegalActions(),
+              VisitPolicy(state, trajectory->temperature), p1_outcome,
+              std::abs(state.value -
+                       trajectory->returns[state.current_player]) + 0.01);
+          position->ApplyAction(state.action);
           num_states += 1;
         }
 
@@ -352,32 +868,85 @@ void learner(const open_spiel::Game& game,
 
     last = now;
 
+    // The weights must not change while the last checkpoint is saved.
+    absl::Duration publish_wait;
+    if (publisher) {
+      publisher->join();
+      publisher.reset();
+      logger.Print("Checkpoint saved: %s", checkpoint_path);
+      publish_wait = absl::Now() - now;
+    }
+
+    // Where the time of the update step goes. The data parallel learner
+    // prepares the batches as part of learning.
+    absl::Duration sample_time;
+    absl::Duration prepare_time;
+    absl::Duration learn_time;
     VPNetModel::LossInfo losses;
-    {  // Extra scope to return the device for use for inference asap.
+    if (config.data_parallel_learner) {
+      for (int i = 0; i < replay_buffer.Size() / config.train_batch_size; i++) {
+        absl::Time start = absl::Now();
+        std::vector<int> indices =
+            replay_buffer.Sample(&rng, config.train_batch_size);
+        absl::Time sampled = absl::Now();
+        losses += DataParallelLearn(device_manager, replay_buffer, indices);
+        sample_time += sampled - start;
+        learn_time += absl::Now() - sampled;
+      }
+    } else {  // The scope returns the device for use for inference asap.
       DeviceManager::DeviceLoan learn_model =
           device_manager->Get(config.train_batch_size, device_id);
+      const VPNetModel* model = learn_model.operator->();
 
-      // Learn from them.
-      for (int i = 0; i < replay_buffer.Size() / config.train_batch_size; i++) {
-        losses += learn_model->Learn(replay_buffer.Sample(
-            &rng, config.train_batch_size));
+      // Learn from them. The indices are sampled here, as rng isn't thread
+      // safe, and the batch after the next few is prepared by the thread pool
+      // while learning from one, into the slot learnt from last. The buffer
+      // doesn't change until they are all learnt from.
+      const int num_batches = replay_buffer.Size() / config.train_batch_size;
+      const int ahead = prefetches.size() - 1;
+      auto prefetch = [&](int i) {
+        absl::Time start = absl::Now();
+        Prefetch& p = prefetches[i % prefetches.size()];
+        p.indices = replay_buffer.Sample(&rng, config.train_batch_size);
+        sample_time += absl::Now() - start;
+        p.prepared = std::make_unique<absl::Notification>();
+        ThreadPool::Default()->Schedule([model, &replay_buffer, &p]() {
+          model->PrepareBatch(replay_buffer, p.indices, &p.batch);
+          p.prepared->Notify();
+        });
+      };
+      for (int i = 0; i < std::min(ahead, num_batches); i++) {
+        prefetch(i);
       }
-    }
-
-    // Always save a checkpoint, either for keeping or for loading the weights
-    // to the other sessions. It only allows numbers, so use -1 as "latest".
-    std::string checkpoint_path =
-        device_manager->Get(0, device_id)->SaveCheckpoint(
-            step % config.checkpoint_freq == 0 ? step : -1);
-    if (device_manager->Count() > 0) {
-      for (int i = 0; i < device_manager->Count(); ++i) {
-        if (i != device_id) {
-          device_manager->Get(0, i)->LoadCheckpoint(checkpoint_path);
+      for (int i = 0; i < num_batches; i++) {
+        Prefetch& p = prefetches[i % prefetches.size()];
+        absl::Time start = absl::Now();
+        if (ahead == 0) {
+          p.indices = replay_buffer.Sample(&rng, config.train_batch_size);
+          absl::Time sampled = absl::Now();
+          sample_time += sampled - start;
+          start = sampled;
+          model->PrepareBatch(replay_buffer, p.indices, &p.batch);
+        } else {
+          if (i + ahead < num_batches) prefetch(i + ahead);
+          start = absl::Now();
+          p.prepared->WaitForNotification();
         }
+        // With prefetching only the time spent waiting for the batch.
+        absl::Time prepared = absl::Now();
+        losses += learn_model->Learn(p.batch);
+        prepare_time += prepared - start;
+        learn_time += absl::Now() - prepared;
       }
     }
-    logger.Print("Checkpoint saved: %s", checkpoint_path);
 
+    open_spiel::BasicStats batch_size;
+    open_spiel::HistogramNumbered batch_size_hist(
+        config.inference_batch_size + 1);
+    for (const auto& eval : placement.evals) {
+      batch_size += eval->BatchSizeStats();
+      batch_size_hist += eval->BatchSizeHistogram();
+    }
     DataLogger::Record record = {
         {"step", step},
         {"total_states", replay_buffer.TotalAdded()},
@@ -397,8 +966,8 @@ void learner(const open_spiel::Game& game,
             {"count", eval_results->EvalCount()},
             {"results", json::CastToArray(eval_results->AvgResults())},
         })},
-        {"batch_size", eval->BatchSizeStats().ToJson()},
-        {"batch_size_hist", eval->BatchSizeHistogram().ToJson()},
+        {"batch_size", batch_size.ToJson()},
+        {"batch_size_hist", batch_size_hist.ToJson()},
         {"loss", json::Object({
              {"policy", losses.Policy()},
              {"value", losses.Value()},
@@ -406,18 +975,73 @@ void learner(const open_spiel::Game& game,
              {"sum", losses.Total()},
         })},
     };
-    eval->ResetBatchSizeStats();
+    open_spiel::BasicStats queue_wait;
+    open_spiel::BasicStats queue_depth;
+    open_spiel::LatencyHistogram inference_latency;
+    LRUCacheInfo cache_info;
+    for (const auto& eval : placement.evals) {
+      queue_wait += eval->QueueWaitStats();
+      queue_depth += eval->QueueDepthStats();
+      inference_latency += eval->InferenceLatency();
+      cache_info += eval->CacheInfo();
+      eval->ResetBatchSizeStats();
+    }
     logger.Print("Losses: policy: %.4f, value: %.4f, l2: %.4f, sum: %.4f",
                  losses.Policy(), losses.Value(), losses.L2(), losses.Total());
 
-    LRUCacheInfo cache_info = eval->CacheInfo();
     if (cache_info.size > 0) {
       logger.Print(absl::StrFormat(
           "Cache size: %d/%d: %.1f%%, hits: %d, misses: %d, hit rate: %.3f%%",
           cache_info.size, cache_info.max_size, 100.0 * cache_info.Usage(),
           cache_info.hits, cache_info.misses, 100.0 * cache_info.HitRate()));
-      eval->ClearCache();
     }
+    // The profile since the last step.
+    json::Array actor_sims_per_s;
+    MCTSProfile actors_profile;
+    for (const MCTSProfile& profile : actor_profiles->Take()) {
+      double search_s = absl::ToDoubleSeconds(profile.search_time);
+      actor_sims_per_s.push_back(
+          search_s > 0 ? profile.simulations / search_s : 0);
+      actors_profile += profile;
+    }
+    double phases_s = absl::ToDoubleSeconds(actors_profile.tree_policy_time +
+                                            actors_profile.evaluation_time +
+                                            actors_profile.backup_time);
+    auto phase_fraction = [phases_s](absl::Duration phase) {
+      return phases_s > 0 ? absl::ToDoubleSeconds(phase) / phases_s : 0;
+    };
+    std::vector<absl::Duration> busy_times = device_manager->BusyTimes();
+    json::Array device_busy;
+    for (int i = 0; i < busy_times.size(); ++i) {
+      device_busy.push_back(
+          absl::ToDoubleSeconds(busy_times[i] - last_busy_times[i]) / seconds);
+    }
+    last_busy_times = busy_times;
+    record.emplace("profile", json::Object({
+        {"actors", json::Object({
+            {"simulations_per_s", actor_sims_per_s},
+            {"tree_policy", phase_fraction(actors_profile.tree_policy_time)},
+            {"evaluation", phase_fraction(actors_profile.evaluation_time)},
+            {"backup", phase_fraction(actors_profile.backup_time)},
+        })},
+        {"queue_wait_ms", queue_wait.ToJson()},
+        {"queue_depth", queue_depth.ToJson()},
+        {"inference_latency_us", inference_latency.ToJson()},
+        {"step_latency_us", actor_profiles->TakeStepLatency().ToJson()},
+        {"device_busy", device_busy},
+        {"learner", json::Object({
+            {"collect_s", absl::ToDoubleSeconds(now - collect_start)},
+            {"publish_wait_s", absl::ToDoubleSeconds(publish_wait)},
+            {"sample_s", absl::ToDoubleSeconds(sample_time)},
+            {"prepare_s", absl::ToDoubleSeconds(prepare_time)},
+            {"learn_s", absl::ToDoubleSeconds(learn_time)},
+        })},
+    }));
+    logger.Print(
+        "Learner: sampling %.2fs, preparing %.2fs, learning %.2fs",
+        absl::ToDoubleSeconds(sample_time), absl::ToDoubleSeconds(prepare_time),
+        absl::ToDoubleSeconds(learn_time));
+
     record.emplace("cache", json::Object({
         {"size", cache_info.size},
         {"max_size", cache_info.max_size},
@@ -432,7 +1056,40 @@ void learner(const open_spiel::Game& game,
 
     data_logger.Write(record);
     logger.Print("");
+
+    // Always save a checkpoint, either for keeping or for loading the weights
+    // to the other sessions. It only allows numbers, so use -1 as "latest".
+    // This is done in the background while the next trajectories are
+    // collected, and the other devices swap in the new weights once loaded.
+    // For the data parallel learner, this also syncs their batch norm
+    // statistics, which are updated from each device's own shards.
+    publisher.emplace([&, step]() {
+      checkpoint_path = device_manager->Get(0, device_id)->SaveCheckpoint(
+          step % config.checkpoint_freq == 0 ? step : -1);
+      for (int i = 0; i < device_manager->Count(); ++i) {
+        if (i != device_id) {
+          device_manager->LoadCheckpoint(i, checkpoint_path);
+        }
+      }
+      placement.ClearCaches();
+      if (config.remote_actor_hosts > 0 && step % config.checkpoint_freq == 0) {
+        WriteLatestCheckpoint(config, checkpoint_path);
+      }
+    });
+
+    if (config.replay_buffer_snapshot_freq > 0 &&
+        step % config.replay_buffer_snapshot_freq == 0) {
+      if (snapshotter) snapshotter->join();
+      snapshotter.emplace(
+          [snapshot = std::make_shared<const ReplayBuffer>(replay_buffer),
+           &snapshot_path]() { snapshot->Save(snapshot_path); });
+    }
+  }
+  if (publisher) {
+    publisher->join();
+    logger.Print("Checkpoint saved: %s", checkpoint_path);
   }
+  if (snapshotter) snapshotter->join();
 }
 
 bool AlphaZero(AlphaZeroConfig config, StopToken* stop) {
@@ -457,7 +1114,9 @@ bool AlphaZero(AlphaZeroConfig config, StopToken* stop) {
 
   std::cout << "Logging directory: " << config.path << std::endl;
 
-  if (config.graph_def.empty()) {
+  if (config.inference_backend == "stub") {
+    std::cout << "Using stub models." << std::endl;
+  } else if (config.graph_def.empty()) {
     config.graph_def = "vpnet.pb";
     std::string model_path = absl::StrCat(config.path, "/", config.graph_def);
     if (file::Exists(model_path)) {
@@ -465,10 +1124,18 @@ bool AlphaZero(AlphaZeroConfig config, StopToken* stop) {
     } else {
       std::cout << "Creating model: " << model_path << std::endl;
     }
-    SPIEL_CHECK_TRUE(CreateGraphDef(
-        *game, config.learning_rate, config.weight_decay,
-        config.path, config.graph_def,
-        config.nn_model, config.nn_width, config.nn_depth));
+    if (config.graph_cache.empty()) {
+      SPIEL_CHECK_TRUE(CreateGraphDef(
+          *game, config.learning_rate, config.weight_decay,
+          config.path, config.graph_def,
+          config.nn_model, config.nn_width, config.nn_depth));
+    } else {
+      SPIEL_CHECK_TRUE(CreateGraphDefCached(
+          *game, config.learning_rate, config.weight_decay,
+          config.path, config.graph_def,
+          config.nn_model, config.nn_width, config.nn_depth,
+          config.graph_cache));
+    }
   } else {
     std::string model_path = absl::StrCat(config.path, "/", config.graph_def);
     if (file::Exists(model_path)) {
@@ -480,12 +1147,17 @@ bool AlphaZero(AlphaZeroConfig config, StopToken* stop) {
 
   std::cout << "Playing game: " << config.game << std::endl;
 
+  config.leaf_batch_size = std::max(1, config.leaf_batch_size);
+  config.actor_games = std::max(1, config.actor_games);
+
   config.inference_batch_size = std::max(1, std::min(
       config.inference_batch_size, config.actors + config.evaluators));
 
   config.inference_threads = std::max(1, std::min(
       config.inference_threads, (1 + config.actors + config.evaluators) / 2));
 
+  config.remote_actor_hosts = std::max(0, config.remote_actor_hosts);
+
   {
     file::File fd(config.path + "/config.json", "w");
     fd.Write(json::ToString(config.ToJson(), true) + "\n");
@@ -493,8 +1165,18 @@ bool AlphaZero(AlphaZeroConfig config, StopToken* stop) {
 
   DeviceManager device_manager;
   for (const absl::string_view& device : absl::StrSplit(config.devices, ',')) {
-    device_manager.AddDevice(VPNetModel(
-        *game, config.path, config.graph_def, std::string(device)));
+    // The learner trains on the first device, so only the others load
+    // checkpoints, into a standby model, and can use another backend.
+    if (device_manager.Count() == 0) {
+      device_manager.AddDevice(
+          config.inference_backend == "stub"
+              ? StubModel(*game, config, device)
+              : VPNetModel(*game, config.path, config.graph_def,
+                           std::string(device)));
+    } else {
+      device_manager.AddDevice(InferenceModel(*game, config, device),
+                               InferenceModel(*game, config, device));
+    }
   }
 
   if (device_manager.Count() == 0) {
@@ -505,33 +1187,45 @@ bool AlphaZero(AlphaZeroConfig config, StopToken* stop) {
   {  // Make sure they're all in sync.
     std::string first_checkpoint = device_manager.Get(0)->SaveCheckpoint(0);
     for (int i = 1; i < device_manager.Count(); ++i) {
-      device_manager.Get(0, i)->LoadCheckpoint(first_checkpoint);
+      device_manager.LoadCheckpoint(i, first_checkpoint);
+    }
+    if (config.remote_actor_hosts > 0) {
+      WriteLatestCheckpoint(config, first_checkpoint);
     }
   }
 
-  auto eval = std::make_shared<VPNetEvaluator>(
-      &device_manager, config.inference_batch_size, config.inference_threads,
-      config.inference_cache, (config.actors + config.evaluators) / 16);
+  const Placement placement = PlaceThreads(
+      config, &device_manager, config.actors + config.evaluators);
 
   ThreadedQueue<Trajectory> trajectory_queue(
       config.replay_buffer_size / config.replay_buffer_reuse);
 
   EvalResults eval_results(config.eval_levels, config.evaluation_window);
 
+  ActorProfiles actor_profiles(config.actors);
   std::vector<Thread> actors;
   actors.reserve(config.actors);
   for (int i = 0; i < config.actors; ++i) {
-    actors.emplace_back(
-        [&, i]() { actor(*game, config, i, &trajectory_queue, eval, stop); });
+    actors.emplace_back([&, i]() {
+      actor(*game, config, i, &trajectory_queue, placement.Enter(i),
+            &actor_profiles, stop);
+    });
   }
   std::vector<Thread> evaluators;
   evaluators.reserve(config.evaluators);
   for (int i = 0; i < config.evaluators; ++i) {
-    evaluators.emplace_back(
-        [&, i]() { evaluator(*game, config, i, &eval_results, eval, stop); });
+    evaluators.emplace_back([&, i]() {
+      evaluator(*game, config, i, &eval_results,
+                placement.Enter(config.actors + i), stop);
+    });
+  }
+  std::vector<Thread> remote_actors;
+  if (config.remote_actor_hosts > 0) {
+    remote_actors.emplace_back(
+        [&]() { remote_actors_reader(config, &trajectory_queue, stop); });
   }
-  learner(*game, config, &device_manager, eval, &trajectory_queue,
-          &eval_results, stop);
+  learner(*game, config, &device_manager, placement, &trajectory_queue,
+          &eval_results, &actor_profiles, stop);
 
   if (!stop->StopRequested()) {
     stop->Stop();
@@ -548,6 +1242,119 @@ bool AlphaZero(AlphaZeroConfig config, StopToken* stop) {
   for (auto& t : evaluators) {
     t.join();
   }
+  for (auto& t : remote_actors) {
+    t.join();
+  }
+#ifdef OPEN_SPIEL_TRACING
+  trace::WriteChromeTrace(absl::StrCat(config.path, "/trace.json"));
+#endif
+  std::cout << "Exiting cleanly." << std::endl;
+  return true;
+}
+
+bool AlphaZeroActorHost(AlphaZeroConfig config, int host, StopToken* stop) {
+  SPIEL_CHECK_GE(host, 0);
+  SPIEL_CHECK_LT(host, config.remote_actor_hosts);
+  std::shared_ptr<const open_spiel::Game> game =
+      open_spiel::LoadGame(config.game);
+  if (config.graph_def.empty()) {
+    config.graph_def = "vpnet.pb";
+  }
+
+  config.leaf_batch_size = std::max(1, config.leaf_batch_size);
+  config.actor_games = std::max(1, config.actor_games);
+  config.inference_batch_size = std::max(1, std::min(
+      config.inference_batch_size, config.actors));
+  config.inference_threads = std::max(1, std::min(
+      config.inference_threads, (1 + config.actors) / 2));
+
+  FileLogger logger(config.path, absl::StrCat("actor-host-", host));
+  std::cout << "Waiting for the learner's first checkpoint in " << config.path
+            << std::endl;
+  std::string checkpoint_path;
+  while (!stop->StopRequested() &&
+         (checkpoint_path = ReadLatestCheckpoint(config)).empty()) {
+    absl::SleepFor(absl::Seconds(1));
+  }
+  if (stop->StopRequested()) {
+    return false;
+  }
+
+  DeviceManager device_manager;
+  for (const absl::string_view& device : absl::StrSplit(config.devices, ',')) {
+    device_manager.AddDevice(InferenceModel(*game, config, device),
+                             InferenceModel(*game, config, device));
+  }
+  if (device_manager.Count() == 0) {
+    std::cerr << "No devices specified?" << std::endl;
+    return false;
+  }
+  for (int i = 0; i < device_manager.Count(); ++i) {
+    device_manager.LoadCheckpoint(i, checkpoint_path);
+  }
+  logger.Print("Loaded checkpoint: %s", checkpoint_path);
+
+  const Placement placement =
+      PlaceThreads(config, &device_manager, config.actors);
+
+  ThreadedQueue<Trajectory> trajectory_queue(config.actors * 4);
+
+  // Numbered after the learner host's actors, as they share the log directory.
+  std::vector<Thread> actors;
+  actors.reserve(config.actors);
+  for (int i = 0; i < config.actors; ++i) {
+    int num = (host + 1) * config.actors + i;
+    actors.emplace_back([&, i, num]() {
+      actor(*game, config, num, &trajectory_queue, placement.Enter(i),
+            /*profiles=*/nullptr, stop);
+    });
+  }
+
+  // Follow the checkpoints of the learner.
+  Thread checkpoint_follower([&]() {
+    FileLogger logger(config.path, absl::StrCat("actor-host-", host, "-ckpt"));
+    while (!stop->StopRequested()) {
+      absl::SleepFor(absl::Seconds(10));
+      std::string latest = ReadLatestCheckpoint(config);
+      if (latest.empty() || latest == checkpoint_path) continue;
+      for (int i = 0; i < device_manager.Count(); ++i) {
+        device_manager.LoadCheckpoint(i, latest);
+      }
+      placement.ClearCaches();
+      checkpoint_path = latest;
+      logger.Print("Loaded checkpoint: %s", checkpoint_path);
+    }
+  });
+
+  // Stream the trajectories to the learner. The file is restarted, which the
+  // learner notices.
+  {
+    file::File fd(TrajectoriesPath(config, host), "w");
+    int64_t num_trajectories = 0;
+    while (!stop->StopRequested()) {
+      std::optional<Trajectory> trajectory =
+          trajectory_queue.Pop(absl::Seconds(1));
+      if (!trajectory) continue;
+      std::string encoded = EncodeTrajectory(*trajectory);
+      std::string record;
+      record.reserve(encoded.size() + 10);
+      AppendVarint(encoded.size(), &record);
+      record += encoded;
+      fd.Write(record);
+      fd.Flush();
+      if (++num_trajectories % 100 == 0) {
+        logger.Print("Sent %d trajectories.", num_trajectories);
+      }
+    }
+  }
+
+  trajectory_queue.BlockNewValues();
+  trajectory_queue.Clear();
+  std::cout << "Joining all the threads." << std::endl;
+  for (auto& t : actors) {
+    t.join();
+  }
+  checkpoint_follower.join();
   std::cout << "Exiting cleanly." << std::endl;
   return true;
 }
@@ -24,24 +24,47 @@ struct AlphaZeroConfig {
   std::string game;
   std::string path;
   std::string graph_def;
+  // Where the graphs created when graph_def is empty are cached for reuse by
+  // later runs, if not empty.
+  std::string graph_cache;
   std::string nn_model;
   int nn_width;
   int nn_depth;
   std::string devices;
+  // Whether the learner trains on all the devices, instead of the first.
+  bool data_parallel_learner;
 
   double learning_rate;
   double weight_decay;
   int train_batch_size;
+  // How many batches the learner prepares ahead on other threads while it
+  // trains on one, 0 to prepare each only once it is needed.
+  int learner_prefetch_batches;
   int inference_batch_size;
   int inference_threads;
+  double inference_max_latency_ms;  // Max time a request waits for a batch.
+  // "tensorflow", or "onnx" or "tensorrt" to run it with ONNX Runtime on the
+  // devices that only serve inference, or "onnx_fp16" or "onnx_int8" to run a
+  // lower precision copy of it with ONNX Runtime, or "stub" for a StubBackend
+  // on every device, the learner's included, which replaces the net with a
+  // uniform policy and a draw value, to benchmark the rest of the pipeline.
+  std::string inference_backend;
+  // The latencies the stub models fake for each inference and training batch.
+  double stub_inference_latency_ms;
+  double stub_learn_latency_ms;
   int inference_cache;
   int replay_buffer_size;
   int replay_buffer_reuse;
+  double replay_priority_exponent;  // 0 for uniform sampling.
+  // How often, in learner steps, the replay buffer is saved to replay_buffer
+  // in path, from which it is restored when the run restarts, or 0 not to.
+  int replay_buffer_snapshot_freq;
   int checkpoint_freq;
   int evaluation_window;
 
   double uct_c;
   int max_simulations;
+  int leaf_batch_size;
   double policy_alpha;
   double policy_epsilon;
   double temperature;
@@ -50,7 +73,16 @@ struct AlphaZeroConfig {
   double cutoff_value;
 
   int actors;
+  // How many games each actor plays at once, interleaving their searches and
+  // evaluating the leaves of all of them in one batch.
+  int actor_games;
   int evaluators;
+  // Where the actor and evaluator threads run: "none" leaves it to the OS,
+  // "numa" pins each to a CPU, filling the NUMA nodes in turn, with a
+  // VPNetEvaluator per node, i.e. a cache and inference threads on its CPUs.
+  std::string placement;
+  // How many hosts run AlphaZeroActorHost, in addition to the local actors.
+  int remote_actor_hosts;
   int eval_levels;
   int max_steps;
 
@@ -59,22 +91,32 @@ struct AlphaZeroConfig {
         {"game", game},
         {"path", path},
         {"graph_def", graph_def},
+        {"graph_cache", graph_cache},
         {"nn_model", nn_model},
         {"nn_width", nn_width},
         {"nn_depth", nn_depth},
         {"devices", devices},
+        {"data_parallel_learner", data_parallel_learner},
         {"learning_rate", learning_rate},
         {"weight_decay", weight_decay},
         {"train_batch_size", train_batch_size},
+        {"learner_prefetch_batches", learner_prefetch_batches},
         {"inference_batch_size", inference_batch_size},
         {"inference_threads", inference_threads},
+        {"inference_max_latency_ms", inference_max_latency_ms},
+        {"inference_backend", inference_backend},
+        {"stub_inference_latency_ms", stub_inference_latency_ms},
+        {"stub_learn_latency_ms", stub_learn_latency_ms},
         {"inference_cache", inference_cache},
         {"replay_buffer_size", replay_buffer_size},
         {"replay_buffer_reuse", replay_buffer_reuse},
+        {"replay_priority_exponent", replay_priority_exponent},
+        {"replay_buffer_snapshot_freq", replay_buffer_snapshot_freq},
         {"checkpoint_freq", checkpoint_freq},
         {"evaluation_window", evaluation_window},
         {"uct_c", uct_c},
         {"max_simulations", max_simulations},
+        {"leaf_batch_size", leaf_batch_size},
         {"policy_alpha", policy_alpha},
         {"policy_epsilon", policy_epsilon},
         {"temperature", temperature},
@@ -82,7 +124,10 @@ struct AlphaZeroConfig {
         {"cutoff_probability", cutoff_probability},
         {"cutoff_value", cutoff_value},
         {"actors", actors},
+        {"actor_games", actor_games},
         {"evaluators", evaluators},
+        {"placement", placement},
+        {"remote_actor_hosts", remote_actor_hosts},
         {"eval_levels", eval_levels},
         {"max_steps", max_steps},
     });
@@ -91,6 +136,14 @@ struct AlphaZeroConfig {
 
 bool AlphaZero(AlphaZeroConfig config, StopToken* stop);
 
+// Runs only the actors, for the learner run by AlphaZero with the same config
+// on another host, with `host` < config.remote_actor_hosts. The hosts share
+// config.path, e.g. over a network filesystem: the actors stream their
+// trajectories in a compact binary format to a file there, which the learner
+// follows, and load the checkpoints the learner saves every checkpoint_freq
+// steps.
+bool AlphaZeroActorHost(AlphaZeroConfig config, int host, StopToken* stop);
+
 }  // namespace open_spiel::algorithms
 
 #endif  // OPEN_SPIEL_ALGORITHMS_ALPHA_ZERO_ALPHA_ZERO_H_
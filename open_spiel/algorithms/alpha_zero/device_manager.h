@@ -15,9 +15,13 @@
 #ifndef OPEN_SPIEL_ALGORITHMS_ALPHA_ZERO_DEVICE_MANAGER_H_
 #define OPEN_SPIEL_ALGORITHMS_ALPHA_ZERO_DEVICE_MANAGER_H_
 
+#include <memory>
+#include <string>
 #include <vector>
 
 #include "open_spiel/abseil-cpp/absl/synchronization/mutex.h"
+#include "open_spiel/abseil-cpp/absl/time/clock.h"
+#include "open_spiel/abseil-cpp/absl/time/time.h"
 #include "open_spiel/algorithms/alpha_zero/vpnet.h"
 
 namespace open_spiel::algorithms {
@@ -26,12 +30,22 @@ namespace open_spiel::algorithms {
 // gives them out based on usage. When you request a device you specify how much
 // work you're going to give it, which is assumed done once the loan is
 // returned.
+//
+// A device can also have a standby model of the same net, so that checkpoints
+// are loaded into it in the background and then swapped in, instead of stalling
+// the inference on that device while they load.
 class DeviceManager {
  public:
   DeviceManager() {}
 
   void AddDevice(VPNetModel model) {  // Not thread safe.
-    devices.emplace_back(Device{std::move(model)});
+    devices.emplace_back();
+    devices.back().models[0] = std::make_unique<VPNetModel>(std::move(model));
+  }
+
+  void AddDevice(VPNetModel model, VPNetModel standby) {  // Not thread safe.
+    AddDevice(std::move(model));
+    devices.back().models[1] = std::make_unique<VPNetModel>(std::move(standby));
   }
 
   // Acts as a pointer to the model, but lets the manager know when you're done.
@@ -43,17 +57,18 @@ class DeviceManager {
     DeviceLoan(const DeviceLoan&) = delete;
     DeviceLoan& operator=(const DeviceLoan&) = delete;
 
-    ~DeviceLoan() { manager_->Return(device_id_, requests_); }
+    ~DeviceLoan() { manager_->Return(device_id_, model_index_, requests_); }
     VPNetModel* operator->() { return model_; }
 
    private:
     DeviceLoan(DeviceManager* manager, VPNetModel* model, int device_id,
-               int requests)
+               int model_index, int requests)
         : manager_(manager), model_(model), device_id_(device_id),
-          requests_(requests) {}
+          model_index_(model_index), requests_(requests) {}
     DeviceManager* manager_;
     VPNetModel* model_;
     int device_id_;
+    int model_index_;
     int requests_;
     friend DeviceManager;
   };
@@ -69,23 +84,78 @@ class DeviceManager {
         }
       }
     }
-    devices[device_id].requests += requests;
-    return DeviceLoan(this, &devices[device_id].model, device_id, requests);
+    Device& device = devices[device_id];
+    if (device.requests == 0 && requests > 0) device.busy_since = absl::Now();
+    device.requests += requests;
+    device.loans[device.active] += 1;
+    return DeviceLoan(this, device.models[device.active].get(), device_id,
+                      device.active, requests);
+  }
+
+  // Loads a checkpoint on a device. With a standby model, it is loaded once
+  // the loans of the standby are returned, and then swapped in, so that later
+  // loans get the new weights while the current ones keep the old.
+  void LoadCheckpoint(int device_id, const std::string& path) {
+    Device& device = devices[device_id];
+    if (device.models[1] == nullptr) {
+      Get(0, device_id)->LoadCheckpoint(path);
+      return;
+    }
+    int standby;
+    {
+      absl::MutexLock lock(&m_);
+      m_.Await(absl::Condition(&StandbyReady, &device));
+      device.loading = true;
+      standby = 1 - device.active;
+    }
+    device.models[standby]->LoadCheckpoint(path);
+    absl::MutexLock lock(&m_);
+    device.active = standby;
+    device.loading = false;
   }
 
   int Count() const { return devices.size(); }
 
+  // The total time each device has had requests outstanding, for profiling.
+  std::vector<absl::Duration> BusyTimes() {
+    absl::MutexLock lock(&m_);
+    const absl::Time now = absl::Now();
+    std::vector<absl::Duration> busy_times;
+    busy_times.reserve(devices.size());
+    for (const Device& device : devices) {
+      absl::Duration busy_time = device.busy_time;
+      if (device.requests > 0) busy_time += now - device.busy_since;
+      busy_times.push_back(busy_time);
+    }
+    return busy_times;
+  }
+
  private:
-  void Return(int device_id, int requests) {
+  void Return(int device_id, int model_index, int requests) {
     absl::MutexLock lock(&m_);
-    devices[device_id].requests -= requests;
+    Device& device = devices[device_id];
+    device.requests -= requests;
+    device.loans[model_index] -= 1;
+    if (device.requests == 0 && requests > 0) {
+      device.busy_time += absl::Now() - device.busy_since;
+    }
   }
 
   struct Device {
-    VPNetModel model;
+    // The model given out, and optionally the standby at 1 - active.
+    std::unique_ptr<VPNetModel> models[2];
+    int active = 0;
+    int loans[2] = {0, 0};
+    bool loading = false;
     int requests = 0;
+    absl::Duration busy_time;
+    absl::Time busy_since;  // While there are requests.
   };
 
+  static bool StandbyReady(Device* device) {
+    return !device->loading && device->loans[1 - device->active] == 0;
+  }
+
   std::vector<Device> devices;
   absl::Mutex m_;
 };
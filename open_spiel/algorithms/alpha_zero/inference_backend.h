@@ -0,0 +1,46 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_ALGORITHMS_ALPHA_ZERO_INFERENCE_BACKEND_H_
+#define OPEN_SPIEL_ALGORITHMS_ALPHA_ZERO_INFERENCE_BACKEND_H_
+
+#include <string>
+
+namespace open_spiel {
+namespace algorithms {
+
+// Runs the inference part of a VPNetModel outside of its TensorFlow session,
+// e.g. with a runtime made for serving. This doesn't depend on TensorFlow, so
+// that implementations can be used without the training stack.
+class InferenceBackend {
+ public:
+  virtual ~InferenceBackend() = default;
+
+  // Runs the net on a batch. The observations are batch_size rows of the
+  // observation tensor, and the legal masks and policies are batch_size rows
+  // of num_actions, all row major. There is one value per row.
+  virtual void Inference(int batch_size, const float* observations,
+                         const bool* legals_mask, float* policy,
+                         float* value) = 0;
+
+  // Loads the weights of a checkpoint written by VPNetModel::SaveCheckpoint.
+  // It's called after the TensorFlow session loaded it, and never while
+  // Inference runs.
+  virtual void LoadCheckpoint(const std::string& path) = 0;
+};
+
+}  // namespace algorithms
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_ALGORITHMS_ALPHA_ZERO_INFERENCE_BACKEND_H_
@@ -0,0 +1,186 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/alpha_zero/onnx_backend.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/file.h"
+#include "open_spiel/utils/run_python.h"
+
+namespace open_spiel {
+namespace algorithms {
+namespace {
+
+// The names tf2onnx gives to the tensors of the graph from model.py.
+constexpr std::array<const char*, 3> kInputNames = {
+    "input:0", "legals_mask:0", "training:0"};
+constexpr std::array<const char*, 2> kOutputNames = {
+    "policy_softmax:0", "value_out:0"};
+
+// The suffix of the model file of each precision, and its name for
+// export_onnx.py.
+std::string ModelSuffix(OnnxBackend::Precision precision) {
+  switch (precision) {
+    case OnnxBackend::Precision::kFloat32:
+      return ".onnx";
+    case OnnxBackend::Precision::kFloat16:
+      return ".fp16.onnx";
+    case OnnxBackend::Precision::kInt8:
+      return ".int8.onnx";
+  }
+  SpielFatalError("Unknown precision.");
+}
+
+std::string PrecisionName(OnnxBackend::Precision precision) {
+  switch (precision) {
+    case OnnxBackend::Precision::kFloat32:
+      return "float32";
+    case OnnxBackend::Precision::kFloat16:
+      return "float16";
+    case OnnxBackend::Precision::kInt8:
+      return "int8";
+  }
+  SpielFatalError("Unknown precision.");
+}
+
+// All the sessions of a process share one environment, which must outlive
+// them.
+Ort::Env& OrtEnv() {
+  static Ort::Env* env = new Ort::Env(ORT_LOGGING_LEVEL_WARNING, "open_spiel");
+  return *env;
+}
+
+}  // namespace
+
+OnnxBackend::OnnxBackend(int observation_size, int num_actions,
+                         Provider provider, int device_id,
+                         Precision precision)
+    : observation_size_(observation_size),
+      num_actions_(num_actions),
+      precision_(precision) {
+  session_options_.SetGraphOptimizationLevel(ORT_ENABLE_ALL);
+  if (provider == Provider::kTensorRT) {
+    OrtTensorRTProviderOptions tensorrt_options{};
+    tensorrt_options.device_id = device_id;
+    session_options_.AppendExecutionProvider_TensorRT(tensorrt_options);
+  }
+  if (provider != Provider::kCpu) {
+    // Also a fallback for the nodes TensorRT doesn't support.
+    OrtCUDAProviderOptions cuda_options{};
+    cuda_options.device_id = device_id;
+    session_options_.AppendExecutionProvider_CUDA(cuda_options);
+  }
+}
+
+void OnnxBackend::LoadCheckpoint(const std::string& path) {
+  std::string onnx_path = absl::StrCat(path, ModelSuffix(precision_));
+  if (!file::Exists(onnx_path)) {
+    std::vector<std::string> args = {"--checkpoint",
+                                     absl::StrCat("'", path, "'")};
+    if (precision_ != Precision::kFloat32) {
+      args.insert(args.end(), {"--precision", PrecisionName(precision_)});
+    }
+    if (precision_ == Precision::kInt8) {
+      absl::MutexLock lock(&calibration_mutex_);
+      if (!calibration_rows_.empty()) {
+        // Raw native floats, one observation per row.
+        std::string calibration_path = absl::StrCat(path, ".calibration");
+        file::File(calibration_path, "w")
+            .Write(absl::string_view(
+                reinterpret_cast<const char*>(calibration_rows_.data()),
+                calibration_rows_.size() * sizeof(float)));
+        args.insert(args.end(),
+                    {"--calibration", absl::StrCat("'", calibration_path, "'")});
+      }
+      calibration_rows_.clear();
+      calibration_rows_seen_ = 0;
+    }
+    SPIEL_CHECK_TRUE(
+        RunPython("open_spiel.python.algorithms.alpha_zero.export_onnx", args));
+  }
+  session_ = std::make_unique<Ort::Session>(OrtEnv(), onnx_path.c_str(),
+                                            session_options_);
+}
+
+void OnnxBackend::Inference(int batch_size, const float* observations,
+                            const bool* legals_mask, float* policy,
+                            float* value) {
+  SPIEL_CHECK_TRUE(session_ != nullptr);
+  if (precision_ == Precision::kInt8) {
+    SampleCalibrationRows(batch_size, observations);
+  }
+  Ort::MemoryInfo memory_info =
+      Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
+
+  // The tensors wrap the buffers of the caller, so nothing is copied here.
+  std::array<int64_t, 2> observations_shape = {batch_size, observation_size_};
+  std::array<int64_t, 2> actions_shape = {batch_size, num_actions_};
+  std::array<int64_t, 2> value_shape = {batch_size, 1};
+  bool training = false;
+  std::array<Ort::Value, 3> inputs = {
+      Ort::Value::CreateTensor<float>(
+          memory_info, const_cast<float*>(observations),
+          static_cast<size_t>(batch_size) * observation_size_,
+          observations_shape.data(), observations_shape.size()),
+      Ort::Value::CreateTensor<bool>(
+          memory_info, const_cast<bool*>(legals_mask),
+          static_cast<size_t>(batch_size) * num_actions_,
+          actions_shape.data(), actions_shape.size()),
+      Ort::Value::CreateTensor<bool>(memory_info, &training, 1, nullptr, 0),
+  };
+  std::array<Ort::Value, 2> outputs = {
+      Ort::Value::CreateTensor<float>(
+          memory_info, policy, static_cast<size_t>(batch_size) * num_actions_,
+          actions_shape.data(), actions_shape.size()),
+      Ort::Value::CreateTensor<float>(memory_info, value, batch_size,
+                                      value_shape.data(), value_shape.size()),
+  };
+  session_->Run(Ort::RunOptions{nullptr}, kInputNames.data(), inputs.data(),
+                inputs.size(), kOutputNames.data(), outputs.data(),
+                outputs.size());
+}
+
+void OnnxBackend::SampleCalibrationRows(int batch_size,
+                                        const float* observations) {
+  // Reservoir sampling: the n-th row seen replaces a random one of the sample
+  // with probability kCalibrationRows / n, once the sample is full.
+  absl::MutexLock lock(&calibration_mutex_);
+  for (int i = 0; i < batch_size; ++i) {
+    const float* row = observations + static_cast<int64_t>(i) *
+                                          observation_size_;
+    ++calibration_rows_seen_;
+    int64_t slot = calibration_rows_.size() / observation_size_;
+    if (slot == kCalibrationRows) {
+      slot = std::uniform_int_distribution<int64_t>(
+          0, calibration_rows_seen_ - 1)(calibration_rng_);
+      if (slot >= kCalibrationRows) continue;
+      std::copy(row, row + observation_size_,
+                calibration_rows_.begin() + slot * observation_size_);
+    } else {
+      calibration_rows_.insert(calibration_rows_.end(), row,
+                               row + observation_size_);
+    }
+  }
+}
+
+}  // namespace algorithms
+}  // namespace open_spiel
@@ -0,0 +1,83 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_ALGORITHMS_ALPHA_ZERO_ONNX_BACKEND_H_
+#define OPEN_SPIEL_ALGORITHMS_ALPHA_ZERO_ONNX_BACKEND_H_
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/synchronization/mutex.h"
+#include "open_spiel/algorithms/alpha_zero/inference_backend.h"
+#include "onnxruntime_cxx_api.h"
+
+namespace open_spiel {
+namespace algorithms {
+
+// Runs inference with ONNX Runtime, on the CPU, with CUDA, or with TensorRT,
+// which compiles the model for the GPU when a checkpoint is loaded.
+//
+// It loads <checkpoint>.onnx, and exports it from the checkpoint with
+// export_onnx.py if it doesn't exist yet. Hosts that only run inference can be
+// given the exported models, and then need neither python nor TensorFlow.
+//
+// With a lower precision, mostly for CPUs, it runs a converted copy of the
+// model instead, <checkpoint>.fp16.onnx or <checkpoint>.int8.onnx, which
+// export_onnx.py writes along with <checkpoint>.onnx. The int8 model has int8
+// weights, and its activations are quantized with ranges calibrated on up to
+// kCalibrationRows observations sampled from those this backend ran since the
+// previous checkpoint, written to <checkpoint>.calibration. With none yet, as
+// for the first checkpoint, the activations are quantized dynamically, as
+// each batch runs. compare_onnx.py reports the speed and accuracy of the
+// converted models against the float one.
+class OnnxBackend : public InferenceBackend {
+ public:
+  enum class Provider { kCpu, kCuda, kTensorRT };
+  enum class Precision { kFloat32, kFloat16, kInt8 };
+
+  static constexpr int kCalibrationRows = 1024;
+
+  OnnxBackend(int observation_size, int num_actions,
+              Provider provider = Provider::kCpu, int device_id = 0,
+              Precision precision = Precision::kFloat32);
+
+  void Inference(int batch_size, const float* observations,
+                 const bool* legals_mask, float* policy,
+                 float* value) override;
+  void LoadCheckpoint(const std::string& path) override;
+
+ private:
+  // Adds the observations of a batch to the calibration sample, each row
+  // being kept with the same probability.
+  void SampleCalibrationRows(int batch_size, const float* observations);
+
+  int observation_size_;
+  int num_actions_;
+  Precision precision_;
+  Ort::SessionOptions session_options_;
+  std::unique_ptr<Ort::Session> session_;
+
+  absl::Mutex calibration_mutex_;
+  std::vector<float> calibration_rows_;
+  int64_t calibration_rows_seen_ = 0;
+  std::mt19937 calibration_rng_;
+};
+
+}  // namespace algorithms
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_ALGORITHMS_ALPHA_ZERO_ONNX_BACKEND_H_
@@ -0,0 +1,41 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/alpha_zero/stub_backend.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#include "open_spiel/abseil-cpp/absl/time/clock.h"
+
+namespace open_spiel {
+namespace algorithms {
+
+void StubBackend::Inference(int batch_size, const float* observations,
+                            const bool* legals_mask, float* policy,
+                            float* value) {
+  if (latency_ > absl::ZeroDuration()) absl::SleepFor(latency_);
+  for (int b = 0; b < batch_size; ++b) {
+    const bool* mask_row = legals_mask + static_cast<int64_t>(b) * num_actions_;
+    float* policy_row = policy + static_cast<int64_t>(b) * num_actions_;
+    const int num_legal = std::count(mask_row, mask_row + num_actions_, true);
+    for (int a = 0; a < num_actions_; ++a) {
+      policy_row[a] = mask_row[a] ? 1.0f / num_legal : 0.0f;
+    }
+    value[b] = value_;
+  }
+}
+
+}  // namespace algorithms
+}  // namespace open_spiel
@@ -0,0 +1,49 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_ALGORITHMS_ALPHA_ZERO_STUB_BACKEND_H_
+#define OPEN_SPIEL_ALGORITHMS_ALPHA_ZERO_STUB_BACKEND_H_
+
+#include <string>
+
+#include "open_spiel/abseil-cpp/absl/time/time.h"
+#include "open_spiel/algorithms/alpha_zero/inference_backend.h"
+
+namespace open_spiel {
+namespace algorithms {
+
+// Stands in for the net, to measure the rest of the pipeline: the policy is
+// uniform over the legal actions and the value is constant, after sleeping
+// for `latency` per batch, as if a device ran it. The checkpoints are ignored.
+class StubBackend : public InferenceBackend {
+ public:
+  StubBackend(int num_actions, double value = 0,
+              absl::Duration latency = absl::ZeroDuration())
+      : num_actions_(num_actions), value_(value), latency_(latency) {}
+
+  void Inference(int batch_size, const float* observations,
+                 const bool* legals_mask, float* policy,
+                 float* value) override;
+  void LoadCheckpoint(const std::string& path) override {}
+
+ private:
+  int num_actions_;
+  double value_;
+  absl::Duration latency_;
+};
+
+}  // namespace algorithms
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_ALGORITHMS_ALPHA_ZERO_STUB_BACKEND_H_
@@ -14,25 +14,50 @@
 
 #include "open_spiel/algorithms/alpha_zero/vpevaluator.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
 
 #include "open_spiel/abseil-cpp/absl/hash/hash.h"
+#include "open_spiel/abseil-cpp/absl/time/clock.h"
 #include "open_spiel/abseil-cpp/absl/time/time.h"
 #include "open_spiel/utils/stats.h"
+#include "open_spiel/utils/trace.h"
 
 namespace open_spiel {
 namespace algorithms {
+namespace {
+
+// The cache key of a state, given the inputs holding its legal actions. For
+// games whose observations are determined by State::HashValue(), it is the
+// hash of the state and legal actions, so that looking up a state does not
+// encode its observation. Otherwise the observation is written to the inputs
+// and hashed with the legal actions.
+uint64_t CacheKey(const State& state, VPNetModel::InferenceInputs* inputs) {
+  if (state.GetGame()->GetType().hash_determines_observation) {
+    return absl::Hash<std::pair<uint64_t, std::vector<Action>>>{}(
+        {state.HashValue(), inputs->legal_actions});
+  }
+  inputs->observations = state.ObservationTensor();
+  return absl::Hash<VPNetModel::InferenceInputs>{}(*inputs);
+}
+
+}  // namespace
 
 VPNetEvaluator::VPNetEvaluator(DeviceManager* device_manager, int batch_size,
-                               int threads, int cache_size, int cache_shards)
+                               int threads, int cache_size, int cache_shards,
+                               absl::Duration max_latency)
     : device_manager_(*device_manager), batch_size_(batch_size),
-      queue_(batch_size * threads * 4), batch_size_hist_(batch_size + 1) {
+      max_latency_(max_latency), queue_(batch_size * threads * 4),
+      batch_size_hist_(batch_size + 1) {
   cache_shards = std::max(1, cache_shards);
   cache_.reserve(cache_shards);
   for (int i = 0; i < cache_shards; ++i) {
     cache_.push_back(
-        std::make_unique<LRUCache<uint64_t, VPNetModel::InferenceOutputs>>(
+        std::make_unique<ClockCache<uint64_t, VPNetModel::InferenceOutputs>>(
             cache_size / cache_shards));
   }
   if (batch_size_ <= 1) {
@@ -77,14 +102,130 @@ open_spiel::ActionsAndProbs VPNetEvaluator::Prior(const State& state) {
   return Inference(state).policy;
 }
 
+std::vector<std::vector<double>> VPNetEvaluator::EvaluateBatch(
+    const std::vector<const State*>& states) {
+  std::vector<std::vector<double>> values;
+  values.reserve(states.size());
+  for (const VPNetModel::InferenceOutputs& outputs : InferenceBatch(states)) {
+    // TODO(author5): currently assumes zero-sum.
+    values.push_back({outputs.value, -outputs.value});
+  }
+  return values;
+}
+
+std::vector<open_spiel::ActionsAndProbs> VPNetEvaluator::PriorBatch(
+    const std::vector<const State*>& states) {
+  std::vector<open_spiel::ActionsAndProbs> priors;
+  priors.reserve(states.size());
+  for (VPNetModel::InferenceOutputs& outputs : InferenceBatch(states)) {
+    priors.push_back(std::move(outputs.policy));
+  }
+  return priors;
+}
+
+std::vector<double> VPNetEvaluator::EvaluateWithPrior(
+    const State& state, open_spiel::ActionsAndProbs* prior) {
+  VPNetModel::InferenceOutputs outputs = Inference(state);
+  *prior = std::move(outputs.policy);
+  // TODO(author5): currently assumes zero-sum.
+  return {outputs.value, -outputs.value};
+}
+
+std::vector<std::vector<double>> VPNetEvaluator::EvaluateWithPriorBatch(
+    const std::vector<const State*>& states,
+    std::vector<open_spiel::ActionsAndProbs>* priors) {
+  std::vector<std::vector<double>> values;
+  values.reserve(states.size());
+  priors->clear();
+  priors->reserve(states.size());
+  for (VPNetModel::InferenceOutputs& outputs : InferenceBatch(states)) {
+    // TODO(author5): currently assumes zero-sum.
+    values.push_back({outputs.value, -outputs.value});
+    priors->push_back(std::move(outputs.policy));
+  }
+  return values;
+}
+
+std::vector<VPNetModel::InferenceOutputs> VPNetEvaluator::InferenceBatch(
+    const std::vector<const State*>& states) {
+  if (cache_.empty()) return UncachedInferenceBatch(states);
+
+  std::vector<VPNetModel::InferenceOutputs> outputs(states.size());
+  std::vector<VPNetModel::InferenceInputs> inputs;
+  std::vector<int> indices;  // The states of the inputs.
+  std::vector<uint64_t> keys;
+  for (int i = 0; i < states.size(); ++i) {
+    VPNetModel::InferenceInputs state_inputs;
+    state_inputs.legal_actions = states[i]->LegalActions();
+    uint64_t key = CacheKey(*states[i], &state_inputs);
+    std::optional<const VPNetModel::InferenceOutputs> opt_outputs =
+        cache_[key % cache_.size()]->Get(key);
+    if (opt_outputs) {
+      outputs[i] = *opt_outputs;
+      continue;
+    }
+    if (state_inputs.observations.empty()) {
+      state_inputs.observations = states[i]->ObservationTensor();
+    }
+    keys.push_back(key);
+    inputs.push_back(std::move(state_inputs));
+    indices.push_back(i);
+  }
+  if (inputs.empty()) return outputs;
+
+  batch_size_stats_.Add(inputs.size());
+  batch_size_hist_.Add(std::min<int>(inputs.size(), batch_size_));
+  std::vector<VPNetModel::InferenceOutputs> batch_outputs =
+      device_manager_.Get(inputs.size())->Inference(inputs);
+  for (int j = 0; j < indices.size(); ++j) {
+    cache_[keys[j] % cache_.size()]->Set(keys[j], batch_outputs[j]);
+    outputs[indices[j]] = std::move(batch_outputs[j]);
+  }
+  return outputs;
+}
+
+std::vector<VPNetModel::InferenceOutputs>
+VPNetEvaluator::UncachedInferenceBatch(
+    const std::vector<const State*>& states) {
+  batch_size_stats_.Add(states.size());
+  batch_size_hist_.Add(std::min<int>(states.size(), batch_size_));
+  // Without a cache there is nothing to hash, so the observations are written
+  // straight into the input tensor.
+  DeviceManager::DeviceLoan model = device_manager_.Get(states.size());
+  VPNetModel::InferenceBatch batch = model->NewInferenceBatch(states.size());
+  std::vector<std::vector<Action>> legal_actions;
+  legal_actions.reserve(states.size());
+  for (const State* state : states) {
+    legal_actions.push_back(state->LegalActions());
+    int index = batch.Add(legal_actions.back());
+    state->ObservationTensor(state->CurrentPlayer(), batch.Observation(index));
+  }
+  model->Inference(&batch);
+
+  std::vector<VPNetModel::InferenceOutputs> outputs;
+  outputs.reserve(states.size());
+  for (int i = 0; i < states.size(); ++i) {
+    outputs.push_back({batch.Value(i), batch.Policy(i, legal_actions[i])});
+  }
+  return outputs;
+}
+
 VPNetModel::InferenceOutputs VPNetEvaluator::Inference(const State& state) {
-  VPNetModel::InferenceInputs inputs = {
-    state.LegalActions(), state.ObservationTensor()};
+  const absl::Time start = absl::Now();
+  VPNetModel::InferenceOutputs outputs = CachedInference(state);
+  inference_latency_.Add(absl::ToInt64Microseconds(absl::Now() - start));
+  return outputs;
+}
+
+VPNetModel::InferenceOutputs VPNetEvaluator::CachedInference(
+    const State& state) {
+  VPNetModel::InferenceInputs inputs;
+  inputs.legal_actions = state.LegalActions();
 
   uint64_t key;
   int cache_shard;
   if (!cache_.empty()) {
-    key = absl::Hash<VPNetModel::InferenceInputs>{}(inputs);
+    key = CacheKey(state, &inputs);
     cache_shard = key % cache_.size();
     std::optional<const VPNetModel::InferenceOutputs> opt_outputs =
         cache_[cache_shard]->Get(key);
@@ -92,13 +233,16 @@ VPNetModel::InferenceOutputs VPNetEvaluator::Inference(const State& state) {
       return *opt_outputs;
     }
   }
+  if (inputs.observations.empty()) {
+    inputs.observations = state.ObservationTensor();
+  }
   VPNetModel::InferenceOutputs outputs;
   if (batch_size_ <= 1) {
     outputs = device_manager_.Get(1)->Inference(std::vector{inputs})[0];
   } else {
     std::promise<VPNetModel::InferenceOutputs> prom;
     std::future<VPNetModel::InferenceOutputs> fut = prom.get_future();
-    queue_.Push(QueueItem{inputs, &prom});
+    queue_.Push(QueueItem{inputs, &prom, absl::Now()});
     outputs = fut.get();
   }
   if (!cache_.empty()) {
@@ -108,63 +252,101 @@ VPNetModel::InferenceOutputs VPNetEvaluator::Inference(const State& state) {
 }
 
 void VPNetEvaluator::Runner() {
-  std::vector<VPNetModel::InferenceInputs> inputs;
-  std::vector<std::promise<VPNetModel::InferenceOutputs>*> promises;
-  inputs.reserve(batch_size_);
-  promises.reserve(batch_size_);
+  std::vector<QueueItem> items;
+  items.reserve(batch_size_);
+  // Allocated for the first batch, once there is a model to ask, then reused.
+  std::optional<VPNetModel::InferenceBatch> batch;
   while (!stop_.StopRequested()) {
     {
       // Only one thread at a time should be listening to the queue to maximize
-      // batch size and minimize latency.
+      // batch size and minimize latency. The actors push without locking.
       absl::MutexLock lock(&inference_queue_m_);
-      absl::Time deadline = absl::Now() + absl::InfiniteDuration();
-      for (int i = 0; i < batch_size_; ++i) {
-        std::optional<QueueItem> item = queue_.Pop(deadline);
-        if (!item) {  // Hit the deadline.
-          break;
+      std::optional<QueueItem> item = queue_.Pop();
+      if (item) {
+        const absl::Time deadline = item->queued + max_latency_;
+        items.push_back(std::move(*item));
+        // Wait for the requests expected before the deadline, then take the
+        // ones already queued.
+        int expected = batch_size_;
+        if (mean_interarrival_ > absl::ZeroDuration()) {
+          expected = std::clamp<int64_t>(
+              1 + (deadline - absl::Now()) / mean_interarrival_, 1,
+              batch_size_);
         }
-        if (inputs.empty()) {
-          deadline = absl::Now() + absl::Milliseconds(1);
-        }
-        inputs.push_back(item->inputs);
-        promises.push_back(item->prom);
+        queue_.PopBatch(expected - 1, deadline, &items);
+        queue_.PopBatch(batch_size_ - static_cast<int>(items.size()),
+                        absl::InfinitePast(), &items);
+        AddArrivals(items);
+        queue_depth_stats_.Add(queue_.Size());
       }
     }
 
-    if (inputs.empty()) {  // Almost certainly StopRequested.
+    if (items.empty()) {  // Almost certainly StopRequested.
       continue;
     }
 
-    {
-      absl::MutexLock lock(&stats_m_);
-      batch_size_stats_.Add(inputs.size());
-      batch_size_hist_.Add(inputs.size());
+    OPEN_SPIEL_TRACE_SPAN("alpha_zero", "InferenceBatch");
+    const absl::Time now = absl::Now();
+    batch_size_stats_.Add(items.size());
+    batch_size_hist_.Add(items.size());
+    for (const QueueItem& item : items) {
+      queue_wait_stats_.Add(absl::ToDoubleMilliseconds(now - item.queued));
+    }
+
+    DeviceManager::DeviceLoan model = device_manager_.Get(items.size());
+    if (!batch) batch = model->NewInferenceBatch(batch_size_);
+    batch->Clear();
+    for (const QueueItem& item : items) {
+      batch->Add(item.inputs);
     }
+    model->Inference(&*batch);
+    for (int i = 0; i < items.size(); ++i) {
+      items[i].prom->set_value(
+          {batch->Value(i), batch->Policy(i, items[i].inputs.legal_actions)});
+    }
+    items.clear();
+  }
+}
 
-    std::vector<VPNetModel::InferenceOutputs> outputs =
-        device_manager_.Get(inputs.size())->Inference(inputs);
-    for (int i = 0; i < promises.size(); ++i) {
-      promises[i]->set_value(outputs[i]);
+void VPNetEvaluator::AddArrivals(const std::vector<QueueItem>& items) {
+  for (const QueueItem& item : items) {
+    if (last_arrival_ != absl::InfinitePast()) {
+      // Concurrent requests may be slightly out of order, and idle periods
+      // shouldn't take long to forget.
+      absl::Duration interval = std::clamp(item.queued - last_arrival_,
+                                           absl::ZeroDuration(), max_latency_);
+      mean_interarrival_ += (interval - mean_interarrival_) / 16;
     }
-    inputs.clear();
-    promises.clear();
+    last_arrival_ = std::max(last_arrival_, item.queued);
   }
 }
 
 void VPNetEvaluator::ResetBatchSizeStats() {
-  absl::MutexLock lock(&stats_m_);
   batch_size_stats_.Reset();
   batch_size_hist_.Reset();
+  queue_wait_stats_.Reset();
+  queue_depth_stats_.Reset();
+  inference_latency_.Reset();
 }
 
 open_spiel::BasicStats VPNetEvaluator::BatchSizeStats() {
-  absl::MutexLock lock(&stats_m_);
-  return batch_size_stats_;
+  return batch_size_stats_.Snapshot();
 }
 
 open_spiel::HistogramNumbered VPNetEvaluator::BatchSizeHistogram() {
-  absl::MutexLock lock(&stats_m_);
-  return batch_size_hist_;
+  return batch_size_hist_.Snapshot();
+}
+
+open_spiel::BasicStats VPNetEvaluator::QueueWaitStats() {
+  return queue_wait_stats_.Snapshot();
+}
+
+open_spiel::BasicStats VPNetEvaluator::QueueDepthStats() {
+  return queue_depth_stats_.Snapshot();
+}
+
+open_spiel::LatencyHistogram VPNetEvaluator::InferenceLatency() {
+  return inference_latency_.Snapshot();
 }
 
 }  // namespace algorithms
@@ -19,22 +19,30 @@
 #include <vector>
 
 #include "open_spiel/abseil-cpp/absl/hash/hash.h"
+#include "open_spiel/abseil-cpp/absl/time/time.h"
 #include "open_spiel/algorithms/alpha_zero/device_manager.h"
 #include "open_spiel/algorithms/alpha_zero/vpnet.h"
 #include "open_spiel/algorithms/mcts.h"
 #include "open_spiel/spiel.h"
+#include "open_spiel/utils/clock_cache.h"
 #include "open_spiel/utils/lru_cache.h"
+#include "open_spiel/utils/mpmc_queue.h"
 #include "open_spiel/utils/stats.h"
 #include "open_spiel/utils/thread.h"
-#include "open_spiel/utils/threaded_queue.h"
 
 namespace open_spiel {
 namespace algorithms {
 
+// Evaluates states with the models of a DeviceManager, batching the requests
+// of the threads sharing it. A batch waits for more requests until the first
+// has been queued for max_latency at most, and only for as many as expected to
+// arrive by then at the recent rate, so that a lightly loaded evaluator adds
+// little latency, and a busy one fills its batches.
 class VPNetEvaluator : public Evaluator {
  public:
   explicit VPNetEvaluator(DeviceManager* device_manager, int batch_size,
-                          int threads, int cache_size, int cache_shards = 1);
+                          int threads, int cache_size, int cache_shards = 1,
+                          absl::Duration max_latency = absl::Milliseconds(1));
   ~VPNetEvaluator() override;
 
   // Return a value of this state for each player.
@@ -43,36 +51,83 @@ class VPNetEvaluator : public Evaluator {
   // Return a policy: the probability of the current player playing each action.
   ActionsAndProbs Prior(const State& state) override;
 
+  // Run the states missing from the cache through the network in one batch,
+  // bypassing the queue shared with the other threads.
+  std::vector<std::vector<double>> EvaluateBatch(
+      const std::vector<const State*>& states) override;
+  std::vector<ActionsAndProbs> PriorBatch(
+      const std::vector<const State*>& states) override;
+
+  // Both from a single inference, i.e. one encoding, one cache lookup and at
+  // most one network call per state.
+  std::vector<double> EvaluateWithPrior(const State& state,
+                                        ActionsAndProbs* prior) override;
+  std::vector<std::vector<double>> EvaluateWithPriorBatch(
+      const std::vector<const State*>& states,
+      std::vector<ActionsAndProbs>* priors) override;
+  bool EvaluatesPriorWithValue() const override { return true; }
+
   void ClearCache();
   LRUCacheInfo CacheInfo();
 
   void ResetBatchSizeStats();
   open_spiel::BasicStats BatchSizeStats();
   open_spiel::HistogramNumbered BatchSizeHistogram();
+  // How long the requests waited in the queue for a batch, in milliseconds.
+  // Also reset by ResetBatchSizeStats.
+  open_spiel::BasicStats QueueWaitStats();
+  // How many requests were left in the queue as each batch was taken, i.e.
+  // waiting for the next ones. Also reset by ResetBatchSizeStats.
+  open_spiel::BasicStats QueueDepthStats();
+  // How long each Evaluate or Prior took, cache hits included, in
+  // microseconds. Also reset by ResetBatchSizeStats.
+  open_spiel::LatencyHistogram InferenceLatency();
 
  private:
   VPNetModel::InferenceOutputs Inference(const State& state);
+  // Inference without the latency measurement, through the cache if any.
+  VPNetModel::InferenceOutputs CachedInference(const State& state);
+  std::vector<VPNetModel::InferenceOutputs> InferenceBatch(
+      const std::vector<const State*>& states);
+  std::vector<VPNetModel::InferenceOutputs> UncachedInferenceBatch(
+      const std::vector<const State*>& states);
 
   void Runner();
 
   DeviceManager& device_manager_;
-  std::vector<std::unique_ptr<LRUCache<uint64_t, VPNetModel::InferenceOutputs>>>
+  // Lock-free reads, so sharding is only needed with very many writers.
+  std::vector<
+      std::unique_ptr<ClockCache<uint64_t, VPNetModel::InferenceOutputs>>>
       cache_;
   const int batch_size_;
 
+  const absl::Duration max_latency_;
+
   struct QueueItem {
     VPNetModel::InferenceInputs inputs;
     std::promise<VPNetModel::InferenceOutputs>* prom;
+    absl::Time queued;
   };
 
-  ThreadedQueue<QueueItem> queue_;
+  // Updates the arrival rate estimate with the requests of a batch.
+  void AddArrivals(const std::vector<QueueItem>& items);
+
+  MPMCQueue<QueueItem> queue_;
   StopToken stop_;
   std::vector<Thread> inference_threads_;
   absl::Mutex inference_queue_m_;  // Only one thread at a time should pop.
 
-  absl::Mutex stats_m_;
-  open_spiel::BasicStats batch_size_stats_;
-  open_spiel::HistogramNumbered batch_size_hist_;
+  // A moving average of the time between requests, and the time of the last,
+  // guarded by inference_queue_m_.
+  absl::Duration mean_interarrival_ = absl::ZeroDuration();
+  absl::Time last_arrival_ = absl::InfinitePast();
+
+  // Updated without locks by every request and batch.
+  open_spiel::ConcurrentBasicStats batch_size_stats_;
+  open_spiel::ConcurrentHistogramNumbered batch_size_hist_;
+  open_spiel::ConcurrentBasicStats queue_wait_stats_;
+  open_spiel::ConcurrentBasicStats queue_depth_stats_;
+  open_spiel::ConcurrentLatencyHistogram inference_latency_;
 };
 
 }  // namespace algorithms
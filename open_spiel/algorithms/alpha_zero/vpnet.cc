@@ -15,20 +15,29 @@
 #include "open_spiel/algorithms/alpha_zero/vpnet.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <cstring>
 #include <memory>
 #include <numeric>
 #include <random>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "open_spiel/abseil-cpp/absl/strings/ascii.h"
+#include "open_spiel/abseil-cpp/absl/strings/match.h"
 #include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/abseil-cpp/absl/strings/str_format.h"
 #include "open_spiel/abseil-cpp/absl/strings/str_join.h"
+#include "open_spiel/abseil-cpp/absl/strings/string_view.h"
+#include "open_spiel/abseil-cpp/absl/time/clock.h"
 #include "third_party/eigen3/unsupported/Eigen/CXX11/src/Tensor/TensorMap.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
 #include "open_spiel/utils/file.h"
 #include "open_spiel/utils/run_python.h"
+#include "open_spiel/utils/trace.h"
+#include "tensorflow/core/common_runtime/gpu/gpu_process_state.h"
 #include "tensorflow/core/graph/default_device.h"
 #include "tensorflow/core/protobuf/saver.proto.h"
 
@@ -58,6 +67,67 @@ bool CreateGraphDef(const Game& game, double learning_rate,
                    });
 }
 
+namespace {
+
+// Bump when export_model.py changes the graphs it writes, to stop using the
+// cached ones.
+constexpr int kGraphDefVersion = 1;
+
+// 64 bit FNV-1a, which unlike absl::Hash is the same from run to run.
+uint64_t StableHash(absl::string_view data) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (unsigned char c : data) {
+    hash = (hash ^ c) * 1099511628211ULL;
+  }
+  return hash;
+}
+
+// Writes the file to a temporary file next to it, then renames that, so
+// processes sharing the directory never see it half written.
+bool Publish(const std::string& contents, const std::string& filename) {
+  std::string tmp = absl::StrCat(filename, ".tmp-", std::random_device()());
+  file::File(tmp, "w").Write(contents);
+  return file::Rename(tmp, filename);
+}
+
+}  // namespace
+
+bool CreateGraphDefCached(
+    const Game& game, double learning_rate,
+    double weight_decay, const std::string& path, const std::string& filename,
+    std::string nn_model, int nn_width, int nn_depth,
+    const std::string& cache_dir) {
+  std::string key = absl::StrFormat(
+      "version: %d\ngame: %s\nnn_model: %s\nnn_width: %d\nnn_depth: %d\n"
+      "learning_rate: %.17g\nweight_decay: %.17g\n",
+      kGraphDefVersion, game.ToString(), nn_model, nn_width, nn_depth,
+      learning_rate, weight_decay);
+  std::string cached = absl::StrCat(
+      cache_dir, "/", absl::Hex(StableHash(key), absl::kZeroPad16));
+  std::string model_path = absl::StrCat(path, "/", filename);
+
+  // The key is stored beside the graph, to tell apart colliding hashes.
+  if (file::Exists(absl::StrCat(cached, ".pb")) &&
+      file::Exists(absl::StrCat(cached, ".txt")) &&
+      file::File(absl::StrCat(cached, ".txt"), "r").ReadContents() == key) {
+    return Publish(
+        file::File(absl::StrCat(cached, ".pb"), "r").ReadContents(),
+        model_path);
+  }
+
+  if (!CreateGraphDef(game, learning_rate, weight_decay, path, filename,
+                      nn_model, nn_width, nn_depth)) {
+    return false;
+  }
+  // Failing to cache it only costs exporting it again next time.
+  if (file::Mkdirs(cache_dir)) {
+    Publish(file::File(model_path, "r").ReadContents(),
+            absl::StrCat(cached, ".pb"));
+    Publish(key, absl::StrCat(cached, ".txt"));
+  }
+  return true;
+}
+
 VPNetModel::VPNetModel(const Game& game, const std::string& path,
                        const std::string& file_name, const std::string& device)
     : device_(device),
@@ -92,8 +162,41 @@ VPNetModel::VPNetModel(const Game& game, const std::string& path,
   TF_CHECK_OK(tf_session_->Run({}, {}, {"init_all_vars_op"}, nullptr));
 }
 
+VPNetModel::VPNetModel(const Game& game, const std::string& path,
+                       const std::string& device,
+                       std::unique_ptr<InferenceBackend> backend,
+                       absl::Duration learn_latency)
+    : device_(device),
+      path_(path),
+      flat_input_size_(game.ObservationTensorSize()),
+      num_actions_(game.NumDistinctActions()),
+      inference_backend_(std::move(backend)),
+      stub_learn_latency_(learn_latency) {
+  SPIEL_CHECK_EQ(game.NumPlayers(), 2);
+  SPIEL_CHECK_EQ(game.GetType().utility, GameType::Utility::kZeroSum);
+  SPIEL_CHECK_TRUE(inference_backend_ != nullptr);
+}
+
+VPNetModel VPNetModel::Stub(const Game& game, const std::string& path,
+                            const std::string& device,
+                            std::unique_ptr<InferenceBackend> backend,
+                            absl::Duration learn_latency) {
+  return VPNetModel(game, path, device, std::move(backend), learn_latency);
+}
+
+VPNetModel::LossInfo VPNetModel::StubLearn() const {
+  if (stub_learn_latency_ > absl::ZeroDuration()) {
+    absl::SleepFor(stub_learn_latency_);
+  }
+  return LossInfo(0, 0, 0);
+}
+
 std::string VPNetModel::SaveCheckpoint(int step) {
   std::string full_path = absl::StrCat(path_, "/checkpoint-", step);
+  if (tf_session_ == nullptr) {
+    file::File(full_path, "w");
+    return full_path;
+  }
   tensorflow::Tensor checkpoint_path(tf::DT_STRING, tf::TensorShape());
   checkpoint_path.scalar<tensorflow::tstring>()() = full_path;
   TF_CHECK_OK(tf_session_->Run(
@@ -103,71 +206,129 @@ std::string VPNetModel::SaveCheckpoint(int step) {
   // doesn't, so do it manually to make loading checkpoints easier.
   file::File(absl::StrCat(full_path, ".meta"), "w").Write(
       model_meta_graph_contents_);
+  // The latest checkpoint is overwritten, so drop what was exported from it.
+  for (const char* suffix : {".onnx", ".fp16.onnx", ".int8.onnx"}) {
+    std::string onnx_path = absl::StrCat(full_path, suffix);
+    if (file::Exists(onnx_path)) file::Remove(onnx_path);
+  }
   return full_path;
 }
 
 void VPNetModel::LoadCheckpoint(const std::string& path) {
+  if (tf_session_ == nullptr) {
+    inference_backend_->LoadCheckpoint(path);
+    return;
+  }
   tf::Tensor checkpoint_path(tf::DT_STRING, tf::TensorShape());
   checkpoint_path.scalar<tensorflow::tstring>()() = path;
   TF_CHECK_OK(tf_session_->Run(
       {{meta_graph_def_.saver_def().filename_tensor_name(), checkpoint_path}},
       {}, {meta_graph_def_.saver_def().restore_op_name()}, nullptr));
+  if (inference_backend_) {
+    inference_backend_->LoadCheckpoint(path);
+  }
 }
 
-std::vector<VPNetModel::InferenceOutputs> VPNetModel::Inference(
-    const std::vector<InferenceInputs>& inputs) {
-  int inference_batch_size = inputs.size();
+int VPNetModel::InferenceBatch::Add(const std::vector<Action>& legal_actions) {
+  SPIEL_CHECK_LT(size_, max_size_);
+  bool* mask_row = legals_mask_.flat<bool>().data() +
+                   static_cast<int64_t>(size_) * num_actions_;
+  std::fill(mask_row, mask_row + num_actions_, false);
+  for (Action action : legal_actions) {
+    mask_row[action] = true;
+  }
+  return size_++;
+}
 
-  // Fill the inputs and mask
-  tensorflow::Tensor tf_inf_inputs(
-      tf::DT_FLOAT, tf::TensorShape({inference_batch_size, flat_input_size_}));
-  tensorflow::Tensor tf_inf_legal_mask(
-      tf::DT_BOOL, tf::TensorShape({inference_batch_size, num_actions_}));
+int VPNetModel::InferenceBatch::Add(const InferenceInputs& inputs) {
+  int index = Add(inputs.legal_actions);
+  SPIEL_CHECK_EQ(inputs.observations.size(), observation_size_);
+  std::copy(inputs.observations.begin(), inputs.observations.end(),
+            Observation(index).begin());
+  return index;
+}
 
-  TensorMap inputs_matrix = tf_inf_inputs.matrix<float>();
-  TensorMapBool mask_matrix = tf_inf_legal_mask.matrix<bool>();
+ActionsAndProbs VPNetModel::InferenceBatch::Policy(
+    int index, const std::vector<Action>& legal_actions) const {
+  const float* policy_row = policy_.flat<float>().data() +
+                            static_cast<int64_t>(index) * num_actions_;
+  ActionsAndProbs policy;
+  policy.reserve(legal_actions.size());
+  for (Action action : legal_actions) {
+    policy.push_back({action, policy_row[action]});
+  }
+  return policy;
+}
 
-  for (int b = 0; b < inference_batch_size; ++b) {
-    // Zero initialize the sparse inputs.
-    for (int a = 0; a < num_actions_; ++a) {
-      mask_matrix(b, a) = 0;
-    }
-    for (Action action : inputs[b].legal_actions) {
-      mask_matrix(b, action) = 1;
-    }
-    for (int i = 0; i < inputs[b].observations.size(); ++i) {
-      inputs_matrix(b, i) = inputs[b].observations[i];
-    }
+VPNetModel::InferenceBatch VPNetModel::NewInferenceBatch(int max_size) const {
+  SPIEL_CHECK_GT(max_size, 0);
+  // Pinned memory can be copied to any GPU by DMA, and isn't worth it on CPU.
+  tf::Allocator* allocator =
+      absl::StrContains(absl::AsciiStrToLower(device_), "gpu")
+          ? tf::GPUProcessState::singleton()->GetGpuHostAllocator(0)
+          : tf::cpu_allocator();
+  InferenceBatch batch;
+  batch.max_size_ = max_size;
+  batch.observation_size_ = flat_input_size_;
+  batch.num_actions_ = num_actions_;
+  batch.observations_ = tf::Tensor(
+      allocator, tf::DT_FLOAT, tf::TensorShape({max_size, flat_input_size_}));
+  batch.legals_mask_ = tf::Tensor(allocator, tf::DT_BOOL,
+                                  tf::TensorShape({max_size, num_actions_}));
+  batch.policy_ =
+      tf::Tensor(tf::DT_FLOAT, tf::TensorShape({max_size, num_actions_}));
+  batch.value_ = tf::Tensor(tf::DT_FLOAT, tf::TensorShape({max_size, 1}));
+  return batch;
+}
+
+void VPNetModel::Inference(InferenceBatch* batch) {
+  OPEN_SPIEL_TRACE_SPAN("vpnet", "Inference");
+  SPIEL_CHECK_EQ(batch->observation_size_, flat_input_size_);
+  SPIEL_CHECK_EQ(batch->num_actions_, num_actions_);
+  if (batch->Size() == 0) return;
+
+  if (inference_backend_) {
+    // The backend writes the outputs in place too.
+    inference_backend_->Inference(
+        batch->Size(), batch->observations_.flat<float>().data(),
+        batch->legals_mask_.flat<bool>().data(),
+        batch->policy_.flat<float>().data(),
+        batch->value_.flat<float>().data());
+    return;
   }
 
-  // Run the inference
+  // The first rows of the tensors, without a copy, which is fine as slices
+  // from row 0 are aligned.
   std::vector<tensorflow::Tensor> tf_outputs;
   TF_CHECK_OK(tf_session_->Run(
-      {{"input", tf_inf_inputs}, {"legals_mask", tf_inf_legal_mask},
+      {{"input", batch->observations_.Slice(0, batch->Size())},
+       {"legals_mask", batch->legals_mask_.Slice(0, batch->Size())},
        {"training", tensorflow::Tensor(false)}},
       {"policy_softmax", "value_out"}, {}, &tf_outputs));
+  // Read where the session put them, rather than copying them back.
+  batch->policy_ = std::move(tf_outputs[0]);
+  batch->value_ = std::move(tf_outputs[1]);
+}
 
-  TensorMap policy_matrix = tf_outputs[0].matrix<float>();
-  TensorMap value_matrix = tf_outputs[1].matrix<float>();
+std::vector<VPNetModel::InferenceOutputs> VPNetModel::Inference(
+    const std::vector<InferenceInputs>& inputs) {
+  InferenceBatch batch = NewInferenceBatch(inputs.size());
+  for (const InferenceInputs& position : inputs) {
+    batch.Add(position);
+  }
+  Inference(&batch);
 
   std::vector<InferenceOutputs> out;
-  out.reserve(inference_batch_size);
-  for (int b = 0; b < inference_batch_size; ++b) {
-    double value = value_matrix(b, 0);
-
-    ActionsAndProbs state_policy;
-    state_policy.reserve(inputs[b].legal_actions.size());
-    for (Action action : inputs[b].legal_actions) {
-      state_policy.push_back({action, policy_matrix(b, action)});
-    }
-
-    out.push_back({value, state_policy});
+  out.reserve(inputs.size());
+  for (int b = 0; b < inputs.size(); ++b) {
+    out.push_back({batch.Value(b), batch.Policy(b, inputs[b].legal_actions)});
   }
-
   return out;
 }
 
 VPNetModel::LossInfo VPNetModel::Learn(const std::vector<TrainInputs>& inputs) {
+  OPEN_SPIEL_TRACE_SPAN("vpnet", "Learn");
+  if (tf_session_ == nullptr) return StubLearn();
   int training_batch_size = inputs.size();
 
   tensorflow::Tensor tf_train_inputs(
@@ -223,5 +384,106 @@ VPNetModel::LossInfo VPNetModel::Learn(const std::vector<TrainInputs>& inputs) {
       tf_outputs[2].scalar<float>()(0));
 }
 
+VPNetModel::TrainBatch VPNetModel::PrepareBatch(
+    const ReplayBuffer& buffer, const std::vector<int>& indices) {
+  TrainBatch batch;
+  PrepareBatch(buffer, indices, &batch);
+  return batch;
+}
+
+void VPNetModel::PrepareBatch(const ReplayBuffer& buffer,
+                              const std::vector<int>& indices,
+                              TrainBatch* batch) const {
+  SPIEL_CHECK_EQ(buffer.ObservationSize(), flat_input_size_);
+  SPIEL_CHECK_EQ(buffer.NumActions(), num_actions_);
+  int training_batch_size = indices.size();
+
+  // Session::Run doesn't hold on to the feeds, so the tensors of a batch
+  // already learnt from can be overwritten.
+  if (batch->feeds.empty() ||
+      batch->feeds[0].second.dim_size(0) != training_batch_size) {
+    batch->feeds = {
+        {"input", tensorflow::Tensor(tf::DT_FLOAT,
+                                     tf::TensorShape({training_batch_size,
+                                                      flat_input_size_}))},
+        {"legals_mask",
+         tensorflow::Tensor(tf::DT_BOOL, tf::TensorShape({training_batch_size,
+                                                          num_actions_}))},
+        {"policy_targets",
+         tensorflow::Tensor(tf::DT_FLOAT, tf::TensorShape({training_batch_size,
+                                                           num_actions_}))},
+        {"value_targets",
+         tensorflow::Tensor(tf::DT_FLOAT,
+                            tf::TensorShape({training_batch_size, 1}))},
+        {"training", tensorflow::Tensor(true)}};
+  }
+
+  // The buffer rows have the layout of the tensor rows.
+  float* inputs_data = batch->feeds[0].second.flat<float>().data();
+  bool* mask_data = batch->feeds[1].second.flat<bool>().data();
+  float* policy_targets_data = batch->feeds[2].second.flat<float>().data();
+  float* value_targets_data = batch->feeds[3].second.flat<float>().data();
+  for (int b = 0; b < training_batch_size; ++b) {
+    const int index = indices[b];
+    absl::Span<const float> observation = buffer.Observation(index);
+    std::copy(observation.begin(), observation.end(),
+              inputs_data + b * flat_input_size_);
+    absl::Span<const uint8_t> mask = buffer.LegalMask(index);
+    std::copy(mask.begin(), mask.end(), mask_data + b * num_actions_);
+    absl::Span<const float> policy = buffer.Policy(index);
+    std::copy(policy.begin(), policy.end(),
+              policy_targets_data + b * num_actions_);
+    value_targets_data[b] = buffer.Value(index);
+  }
+}
+
+VPNetModel::LossInfo VPNetModel::Learn(const TrainBatch& batch) {
+  OPEN_SPIEL_TRACE_SPAN("vpnet", "Learn");
+  if (tf_session_ == nullptr) return StubLearn();
+  // Run a training step and get the losses.
+  std::vector<tensorflow::Tensor> tf_outputs;
+  TF_CHECK_OK(tf_session_->Run(batch.feeds,
+                               {"policy_loss", "value_loss", "l2_reg_loss"},
+                               {"train"}, &tf_outputs));
+
+  return LossInfo(
+      tf_outputs[0].scalar<float>()(0),
+      tf_outputs[1].scalar<float>()(0),
+      tf_outputs[2].scalar<float>()(0));
+}
+
+VPNetModel::LossInfo VPNetModel::ComputeGradients(
+    const ReplayBuffer& buffer, const std::vector<int>& indices,
+    std::vector<float>* gradients) {
+  OPEN_SPIEL_TRACE_SPAN("vpnet", "ComputeGradients");
+  if (tf_session_ == nullptr) {
+    gradients->assign(1, 0);
+    return StubLearn();
+  }
+  std::vector<tensorflow::Tensor> tf_outputs;
+  TF_CHECK_OK(tf_session_->Run(
+      PrepareBatch(buffer, indices).feeds,
+      {"policy_loss", "value_loss", "l2_reg_loss", "flat_gradients"}, {},
+      &tf_outputs));
+
+  auto flat_gradients = tf_outputs[3].flat<float>();
+  gradients->assign(flat_gradients.data(),
+                    flat_gradients.data() + flat_gradients.size());
+  return LossInfo(
+      tf_outputs[0].scalar<float>()(0),
+      tf_outputs[1].scalar<float>()(0),
+      tf_outputs[2].scalar<float>()(0));
+}
+
+void VPNetModel::ApplyGradients(const std::vector<float>& gradients) {
+  if (tf_session_ == nullptr) return;
+  tensorflow::Tensor tf_gradients(
+      tf::DT_FLOAT, tf::TensorShape({static_cast<int64_t>(gradients.size())}));
+  std::copy(gradients.begin(), gradients.end(),
+            tf_gradients.flat<float>().data());
+  TF_CHECK_OK(tf_session_->Run({{"flat_gradients_input", tf_gradients}}, {},
+                               {"apply_flat_gradients"}, nullptr));
+}
+
 }  // namespace algorithms
 }  // namespace open_spiel
@@ -15,7 +15,13 @@
 #ifndef OPEN_SPIEL_ALGORITHMS_ALPHA_ZERO_VPNET_H_
 #define OPEN_SPIEL_ALGORITHMS_ALPHA_ZERO_VPNET_H_
 
+#include <memory>
+
+#include "open_spiel/abseil-cpp/absl/time/time.h"
+#include "open_spiel/abseil-cpp/absl/types/span.h"
+#include "open_spiel/algorithms/alpha_zero/inference_backend.h"
 #include "open_spiel/spiel.h"
+#include "open_spiel/utils/replay_buffer.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/protobuf/meta_graph.proto.h"
 #include "tensorflow/core/public/session.h"
@@ -32,6 +38,15 @@ bool CreateGraphDef(
     double weight_decay, const std::string& path, const std::string& filename,
     std::string nn_model, int nn_width, int nn_depth, bool verbose = false);
 
+// The same, but reuses the graph exported before with the same arguments from
+// cache_dir, under a name hashed from them, so Python only runs the first
+// time. Hosts without Python can start from a cache_dir populated elsewhere.
+bool CreateGraphDefCached(
+    const Game& game, double learning_rate,
+    double weight_decay, const std::string& path, const std::string& filename,
+    std::string nn_model, int nn_width, int nn_depth,
+    const std::string& cache_dir);
+
 
 class VPNetModel {
   // TODO(author7): Save and restore checkpoints:
@@ -97,6 +112,15 @@ class VPNetModel {
              const std::string& file_name,
              const std::string& device = "/cpu:0");
 
+  // A model without a TensorFlow session, e.g. with a StubBackend, to measure
+  // the rest of the pipeline: the backend runs the inference, each training
+  // step only sleeps for learn_latency and has zero losses, and the
+  // checkpoints are empty files.
+  static VPNetModel Stub(const Game& game, const std::string& path,
+                         const std::string& device,
+                         std::unique_ptr<InferenceBackend> backend,
+                         absl::Duration learn_latency = absl::ZeroDuration());
+
   // Move only, not copyable.
   VPNetModel(VPNetModel&& other) = default;
   VPNetModel& operator=(VPNetModel&& other) = default;
@@ -107,15 +131,97 @@ class VPNetModel {
   std::vector<InferenceOutputs> Inference(
     const std::vector<InferenceInputs>& inputs);
 
+  // Input tensors for batches of up to MaxSize() positions, allocated once
+  // and reused from batch to batch, so that the positions can be written in
+  // place, e.g. by State::ObservationTensor. It also holds the output tensors
+  // of the last batch run through it. For a model on a GPU, they are in
+  // pinned host memory, which is copied to the device without staging.
+  class InferenceBatch {
+   public:
+    int MaxSize() const { return max_size_; }
+    int Size() const { return size_; }
+    void Clear() { size_ = 0; }
+
+    // Adds a position with these legal actions, and returns its index. Its
+    // observation is then written into Observation(index).
+    int Add(const std::vector<Action>& legal_actions);
+    int Add(const InferenceInputs& inputs);
+    absl::Span<float> Observation(int index) {
+      return {observations_.flat<float>().data() +
+                  static_cast<int64_t>(index) * observation_size_,
+              static_cast<size_t>(observation_size_)};
+    }
+
+    // The outputs of the position, once the batch has been run.
+    double Value(int index) const { return value_.flat<float>()(index); }
+    ActionsAndProbs Policy(int index,
+                           const std::vector<Action>& legal_actions) const;
+
+   private:
+    friend VPNetModel;
+    int max_size_;
+    int size_ = 0;
+    int observation_size_;
+    int num_actions_;
+    tensorflow::Tensor observations_;
+    tensorflow::Tensor legals_mask_;
+    tensorflow::Tensor policy_;
+    tensorflow::Tensor value_;
+  };
+  InferenceBatch NewInferenceBatch(int max_size) const;
+  void Inference(InferenceBatch* batch);
+
+  // Runs Inference with this backend instead of the TensorFlow session. The
+  // backend loads the checkpoints too, while the session keeps training.
+  void SetInferenceBackend(std::unique_ptr<InferenceBackend> backend) {
+    inference_backend_ = std::move(backend);
+  }
+
   // Training: do one (batch) step of neural net training
   LossInfo Learn(const std::vector<TrainInputs>& inputs);
 
+  // Same, with the positions of a replay buffer, whose rows are copied
+  // straight into the input tensors.
+  LossInfo Learn(const ReplayBuffer& buffer, const std::vector<int>& indices);
+
+  // The same in two steps, e.g. to time them: the input tensors of these
+  // positions, then the training step on them.
+  class TrainBatch {
+   private:
+    std::vector<std::pair<std::string, tensorflow::Tensor>> feeds;
+    friend VPNetModel;
+  };
+  TrainBatch PrepareBatch(const ReplayBuffer& buffer,
+                          const std::vector<int>& indices);
+  // The same into an existing batch, reusing its tensors if they are of the
+  // right size, e.g. to prepare the next batches while learning from one.
+  // Only reads the sizes of the model, so may run on other threads.
+  void PrepareBatch(const ReplayBuffer& buffer, const std::vector<int>& indices,
+                    TrainBatch* batch) const;
+  LossInfo Learn(const TrainBatch& batch);
+
+  // For data parallel training: computes the gradients of the losses of these
+  // positions, flattened into one vector, without applying them.
+  LossInfo ComputeGradients(const ReplayBuffer& buffer,
+                            const std::vector<int>& indices,
+                            std::vector<float>* gradients);
+  // Does a training step with gradients like those from ComputeGradients.
+  void ApplyGradients(const std::vector<float>& gradients);
+
   std::string SaveCheckpoint(int step);
   void LoadCheckpoint(const std::string& path);
 
   const std::string Device() const { return device_; }
 
  private:
+  VPNetModel(const Game& game, const std::string& path,
+             const std::string& device,
+             std::unique_ptr<InferenceBackend> backend,
+             absl::Duration learn_latency);
+
+  // The training step of a stub model.
+  LossInfo StubLearn() const;
+
   std::string device_;
   std::string path_;
 
@@ -130,6 +236,10 @@ class VPNetModel {
   tensorflow::Session* tf_session_ = nullptr;
   tensorflow::MetaGraphDef meta_graph_def_;
   tensorflow::SessionOptions tf_opts_;
+
+  std::unique_ptr<InferenceBackend> inference_backend_;
+  // Only for stub models, which have no session.
+  absl::Duration stub_learn_latency_;
 };
 
 }  // namespace algorithms
@@ -15,6 +15,7 @@
 #include "open_spiel/algorithms/alpha_zero/vpnet.h"
 
 #include <algorithm>
+#include <cstdlib>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -122,6 +123,28 @@ void TestModelCreation(const std::string& nn_model) {
   model.Learn(train_inputs);
 }
 
+void TestGraphCache() {
+  std::cout << "TestGraphCache" << std::endl;
+  std::shared_ptr<const Game> game = LoadGame("tic_tac_toe");
+  std::string tmp_dir = open_spiel::file::GetTmpDir();
+  std::string cache_dir = absl::StrCat(
+      tmp_dir, "/open_spiel_vpnet_test_cache_", std::rand());  // NOLINT
+  auto create = [&](const std::string& filename) {
+    SPIEL_CHECK_TRUE(CreateGraphDefCached(
+        *game, /*learning_rate=*/0.01, /*weight_decay=*/0.0001, tmp_dir,
+        filename, "mlp", /*nn_width=*/64, /*nn_depth=*/2, cache_dir));
+    std::string model_path = absl::StrCat(tmp_dir, "/", filename);
+    std::string contents = file::File(model_path, "r").ReadContents();
+    SPIEL_CHECK_TRUE(file::Remove(model_path));
+    return contents;
+  };
+
+  // The second is a copy of the cached one.
+  std::string exported = create("open_spiel_vpnet_test_cache_1.pb");
+  SPIEL_CHECK_TRUE(file::IsDirectory(cache_dir));
+  SPIEL_CHECK_EQ(create("open_spiel_vpnet_test_cache_2.pb"), exported);
+}
+
 // Can learn a single trajectory
 void TestModelLearnsSimple(const std::string& nn_model) {
   std::cout << "TestModelLearnsSimple: " << nn_model << std::endl;
@@ -207,6 +230,7 @@ int main(int argc, char** argv) {
   // Tests below here reuse the graphs created above. Graph creation is slow
   // due to calling a separate python process.
 
+  open_spiel::algorithms::TestGraphCache();
   open_spiel::algorithms::TestModelLearnsSimple("mlp");
   open_spiel::algorithms::TestModelLearnsSimple("conv2d");
   open_spiel::algorithms::TestModelLearnsSimple("resnet");
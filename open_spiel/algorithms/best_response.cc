@@ -14,15 +14,25 @@
 
 #include "open_spiel/algorithms/best_response.h"
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
+#include <string>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/algorithm/container.h"
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/abseil-cpp/absl/types/span.h"
+#include "open_spiel/algorithms/compiled_game_tree.h"
 
 #include "open_spiel/algorithms/expected_returns.h"
 #include "open_spiel/algorithms/history_tree.h"
 #include "open_spiel/policy.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/thread.h"
 
 namespace open_spiel {
 namespace algorithms {
@@ -35,13 +45,13 @@ TabularBestResponse::TabularBestResponse(const Game& game,
       policy_(policy),
       tree_(HistoryTree(game.NewInitialState(), best_responder_)),
       num_players_(game.NumPlayers()),
-      infosets_(GetAllInfoSets(game.NewInitialState(), best_responder, policy,
-                               &tree_)),
       root_(game.NewInitialState()),
       dummy_policy_(new TabularPolicy(GetUniformPolicy(game))) {
   if (game.GetType().dynamics != GameType::Dynamics::kSequential) {
     SpielFatalError("The game must be turn-based.");
   }
+  int index = 0;
+  ComputeReachProbabilities(tree_.Root(), 1., &index);
 }
 
 TabularBestResponse::TabularBestResponse(
@@ -52,13 +62,62 @@ TabularBestResponse::TabularBestResponse(
       policy_(&tabular_policy_container_),
       tree_(HistoryTree(game.NewInitialState(), best_responder_)),
       num_players_(game.NumPlayers()),
-      infosets_(GetAllInfoSets(game.NewInitialState(), best_responder, policy_,
-                               &tree_)),
       root_(game.NewInitialState()),
       dummy_policy_(new TabularPolicy(GetUniformPolicy(game))) {
   if (game.GetType().dynamics != GameType::Dynamics::kSequential) {
     SpielFatalError("The game must be turn-based.");
   }
+  int index = 0;
+  ComputeReachProbabilities(tree_.Root(), 1., &index);
+}
+
+void TabularBestResponse::ComputeReachProbabilities(HistoryNode* node,
+                                                    double prob, int* index) {
+  switch (node->GetType()) {
+    case StateType::kTerminal:
+      return;
+    case StateType::kChance: {
+      for (Action action : node->GetChildActions()) {
+        std::pair<double, HistoryNode*> prob_and_child = node->GetChild(action);
+        ComputeReachProbabilities(prob_and_child.second,
+                                  prob * prob_and_child.first, index);
+      }
+      return;
+    }
+    case StateType::kDecision:
+      break;
+  }
+
+  if (node->GetState()->CurrentPlayer() == best_responder_) {
+    if (*index == infoset_entries_.size()) {
+      // We look at each decision from the perspective of the best_responder.
+      std::vector<std::pair<HistoryNode*, double>>& infoset =
+          infosets_[node->GetInfoState()];
+      infoset_entries_.push_back({&infoset, static_cast<int>(infoset.size())});
+      infoset.push_back({node, prob});
+    } else {
+      const InfosetEntry& entry = infoset_entries_[*index];
+      (*entry.infoset)[entry.position].second = prob;
+    }
+    ++*index;
+    // Counterfactual reach probabilities exclude the player's actions.
+    for (Action action : node->GetChildActions()) {
+      ComputeReachProbabilities(node->GetChild(action).second, prob, index);
+    }
+    return;
+  }
+
+  ActionsAndProbs state_policy = policy_->GetStatePolicy(*node->GetState());
+  if (state_policy.empty()) {
+    SpielFatalError(node->GetState()->InformationStateString() +
+                    " not found in policy.");
+  }
+  for (Action action : node->GetChildActions()) {
+    const double action_prob = GetProb(state_policy, action);
+    SPIEL_CHECK_GE(action_prob, 0);
+    ComputeReachProbabilities(node->GetChild(action).second,
+                              prob * action_prob, index);
+  }
 }
 
 double TabularBestResponse::HandleTerminalCase(const HistoryNode& node) const {
@@ -198,5 +257,275 @@ Action TabularBestResponse::BestResponseAction(const std::string& infostate) {
   return best_action;
 }
 
+CompiledTreeBestResponse::CompiledTreeBestResponse(
+    const CompiledGameTree& tree, Player best_responder, const Policy* policy,
+    int num_threads)
+    : tree_(tree),
+      best_responder_(best_responder),
+      num_threads_(num_threads),
+      info_state_nodes_(tree.NumInfoStates()),
+      policies_(tree.NumInfoStates()),
+      reach_probabilities_(tree.NumNodes()),
+      values_(tree.NumNodes()),
+      evaluated_(tree.NumNodes()),
+      best_responses_(tree.NumInfoStates()) {
+  SPIEL_CHECK_GE(num_threads_, 1);
+  for (int node = 0; node < tree_.NumNodes(); ++node) {
+    if (tree_.CurrentPlayer(node) == best_responder_) {
+      info_state_nodes_[tree_.InfoState(node)].push_back(node);
+    }
+  }
+  SetPolicy(policy);
+}
+
+void CompiledTreeBestResponse::LoadPolicies(const Policy& policy, int begin,
+                                            int end) {
+  for (int info_state = begin; info_state < end; ++info_state) {
+    if (tree_.InfoStatePlayer(info_state) == best_responder_) continue;
+    ActionsAndProbs state_policy =
+        policy.GetStatePolicy(tree_.InfoStateState(info_state));
+    if (state_policy.empty()) {
+      SpielFatalError(absl::StrCat("InfoState ",
+                                   tree_.InfoStateString(info_state),
+                                   " not found in policy."));
+    }
+    std::vector<double>& probs = policies_[info_state];
+    probs.clear();
+    for (Action action : tree_.InfoStateActions(info_state)) {
+      const double prob = GetProb(state_policy, action);
+      SPIEL_CHECK_GE(prob, 0);
+      probs.push_back(prob);
+    }
+  }
+}
+
+void CompiledTreeBestResponse::SetPolicy(const Policy* policy) {
+  // Each thread queries a contiguous range of the information states.
+  const int num_info_states = tree_.NumInfoStates();
+  const int num_threads = std::min(num_threads_, num_info_states);
+  std::vector<Thread> threads;
+  for (int i = 1; i < num_threads; ++i) {
+    threads.emplace_back([this, policy, i, num_threads, num_info_states]() {
+      LoadPolicies(*policy, num_info_states * i / num_threads,
+                   num_info_states * (i + 1) / num_threads);
+    });
+  }
+  LoadPolicies(*policy, 0, num_info_states / std::max(num_threads, 1));
+  for (Thread& thread : threads) thread.join();
+
+  // The children of a node always come after it.
+  reach_probabilities_[CompiledGameTree::kRoot] = 1;
+  for (int node = 0; node < tree_.NumNodes(); ++node) {
+    if (tree_.IsTerminal(node)) continue;
+    absl::Span<const int> children = tree_.Children(node);
+    for (int i = 0; i < children.size(); ++i) {
+      reach_probabilities_[children[i]] =
+          reach_probabilities_[node] * ChildProbability(node, i);
+    }
+  }
+
+  absl::c_fill(evaluated_, false);
+  absl::c_fill(best_responses_, -1);
+  ComputeValue(CompiledGameTree::kRoot);
+}
+
+double CompiledTreeBestResponse::ChildProbability(int node, int index) const {
+  if (tree_.IsChanceNode(node)) {
+    return tree_.ChanceProbabilities(node)[index];
+  } else if (tree_.CurrentPlayer(node) == best_responder_) {
+    // Counterfactual reach probabilities exclude the player's actions.
+    return 1;
+  } else {
+    return policies_[tree_.InfoState(node)][index];
+  }
+}
+
+double CompiledTreeBestResponse::ComputeValue(int node) {
+  if (evaluated_[node]) return values_[node];
+  double value = 0;
+  if (tree_.IsTerminal(node)) {
+    value = tree_.Returns(node)[best_responder_];
+  } else if (tree_.CurrentPlayer(node) == best_responder_) {
+    const int aidx = ComputeBestResponse(tree_.InfoState(node));
+    value = ComputeValue(tree_.Children(node)[aidx]);
+  } else {
+    // The children which are never reached are only evaluated if a best
+    // response needs them.
+    absl::Span<const int> children = tree_.Children(node);
+    for (int i = 0; i < children.size(); ++i) {
+      const double prob = ChildProbability(node, i);
+      if (prob > 0) value += prob * ComputeValue(children[i]);
+    }
+  }
+  values_[node] = value;
+  evaluated_[node] = true;
+  return value;
+}
+
+int CompiledTreeBestResponse::ComputeBestResponse(int info_state) {
+  if (best_responses_[info_state] >= 0) return best_responses_[info_state];
+  int best_aidx = -1;
+  double best_value = std::numeric_limits<double>::lowest();
+  const int num_actions = tree_.InfoStateActions(info_state).size();
+  for (int aidx = 0; aidx < num_actions; ++aidx) {
+    double value = 0;
+    for (int node : info_state_nodes_[info_state]) {
+      value += reach_probabilities_[node] *
+               ComputeValue(tree_.Children(node)[aidx]);
+    }
+    if (value > best_value) {
+      best_value = value;
+      best_aidx = aidx;
+    }
+  }
+  if (best_aidx == -1) SpielFatalError("No action was chosen.");
+  best_responses_[info_state] = best_aidx;
+  return best_aidx;
+}
+
+Action CompiledTreeBestResponse::BestResponseAction(int info_state) {
+  SPIEL_CHECK_EQ(tree_.InfoStatePlayer(info_state), best_responder_);
+  return tree_.InfoStateActions(info_state)[ComputeBestResponse(info_state)];
+}
+
+std::unordered_map<std::string, Action>
+CompiledTreeBestResponse::GetBestResponseActions() {
+  std::unordered_map<std::string, Action> best_response_actions;
+  for (int info_state = 0; info_state < tree_.NumInfoStates(); ++info_state) {
+    if (tree_.InfoStatePlayer(info_state) == best_responder_) {
+      best_response_actions[tree_.InfoStateString(info_state)] =
+          BestResponseAction(info_state);
+    }
+  }
+  return best_response_actions;
+}
+
+StreamingBestResponse::StreamingBestResponse(const Game& game,
+                                             Player best_responder,
+                                             const Policy* policy)
+    : root_(game.NewInitialState()), best_responder_(best_responder) {
+  if (game.GetType().dynamics != GameType::Dynamics::kSequential) {
+    SpielFatalError("The game must be turn-based.");
+  }
+  SPIEL_CHECK_GE(best_responder_, 0);
+  SPIEL_CHECK_LT(best_responder_, game.NumPlayers());
+  SetPolicy(policy);
+}
+
+void StreamingBestResponse::SetPolicy(const Policy* policy) {
+  policy_ = policy;
+  for (InfoState& info_state : info_states_) {
+    absl::c_fill(info_state.values, 0);
+  }
+  value_ = 0;
+  AccumulateValues(*root_, 1., -1, -1);
+
+  // An information state comes after all the ones it depends on, so they are
+  // resolved from the last. Ties go to the first, i.e. the lowest, action.
+  for (int i = info_states_.size() - 1; i >= 0; --i) {
+    InfoState& info_state = info_states_[i];
+    info_state.best_response = 0;
+    for (int aidx = 1; aidx < info_state.values.size(); ++aidx) {
+      if (info_state.values[aidx] >
+          info_state.values[info_state.best_response]) {
+        info_state.best_response = aidx;
+      }
+    }
+    const double value = info_state.values[info_state.best_response];
+    if (info_state.parent < 0) {
+      value_ += value;
+    } else {
+      info_states_[info_state.parent].values[info_state.parent_action] +=
+          value;
+    }
+  }
+}
+
+void StreamingBestResponse::AccumulateValues(const State& state, double reach,
+                                             int parent, int parent_action) {
+  if (state.IsTerminal()) {
+    const double value = reach * state.PlayerReturn(best_responder_);
+    if (parent < 0) {
+      value_ += value;
+    } else {
+      info_states_[parent].values[parent_action] += value;
+    }
+  } else if (state.IsChanceNode()) {
+    for (const auto& [action, prob] : state.ChanceOutcomes()) {
+      AccumulateValues(*state.Child(action), reach * prob, parent,
+                       parent_action);
+    }
+  } else if (state.CurrentPlayer() == best_responder_) {
+    // Counterfactual reach probabilities exclude the player's actions. The
+    // entry may move as others are added below, so it is only kept by index.
+    const int index = FindOrAddInfoState(state, parent, parent_action);
+    const int num_actions = info_states_[index].actions.size();
+    for (int aidx = 0; aidx < num_actions; ++aidx) {
+      AccumulateValues(*state.Child(info_states_[index].actions[aidx]), reach,
+                       index, aidx);
+    }
+  } else {
+    // The histories which are never reached are still walked, for the best
+    // responses at the information states below them.
+    ActionsAndProbs state_policy;
+    if (reach > 0) {
+      state_policy = policy_->GetStatePolicy(state);
+      if (state_policy.empty()) {
+        SpielFatalError(absl::StrCat("InfoState ",
+                                     state.InformationStateString(),
+                                     " not found in policy."));
+      }
+    }
+    for (Action action : state.LegalActions()) {
+      const double prob = reach > 0 ? GetProb(state_policy, action) : 0;
+      SPIEL_CHECK_GE(prob, 0);
+      AccumulateValues(*state.Child(action), reach * prob, parent,
+                       parent_action);
+    }
+  }
+}
+
+int StreamingBestResponse::FindOrAddInfoState(const State& state, int parent,
+                                              int parent_action) {
+  const std::string info_state =
+      state.InformationStateString(best_responder_);
+  auto [it, inserted] =
+      info_state_indices_.emplace(info_state, info_states_.size());
+  if (inserted) {
+    std::vector<Action> actions = state.LegalActions();
+    std::vector<double> values(actions.size());
+    info_states_.push_back(
+        {parent, parent_action, std::move(actions), std::move(values), -1});
+  } else if (info_states_[it->second].parent != parent ||
+             info_states_[it->second].parent_action != parent_action) {
+    SpielFatalError(absl::StrCat("The information state ", info_state,
+                                 " is reached after different actions of the "
+                                 "best responder: it needs perfect recall."));
+  }
+  return it->second;
+}
+
+Action StreamingBestResponse::BestResponseAction(
+    const std::string& info_state) const {
+  auto it = info_state_indices_.find(info_state);
+  if (it == info_state_indices_.end()) {
+    SpielFatalError(
+        absl::StrCat("Not an information state of the best responder: ",
+                     info_state));
+  }
+  const InfoState& entry = info_states_[it->second];
+  return entry.actions[entry.best_response];
+}
+
+std::unordered_map<std::string, Action>
+StreamingBestResponse::GetBestResponseActions() const {
+  std::unordered_map<std::string, Action> best_response_actions;
+  for (const auto& [info_state, index] : info_state_indices_) {
+    const InfoState& entry = info_states_[index];
+    best_response_actions[info_state] = entry.actions[entry.best_response];
+  }
+  return best_response_actions;
+}
+
 }  // namespace algorithms
 }  // namespace open_spiel
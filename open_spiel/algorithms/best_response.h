@@ -17,9 +17,13 @@
 
 #include <iostream>
 #include <map>
+#include <memory>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
+#include "open_spiel/algorithms/compiled_game_tree.h"
 #include "open_spiel/algorithms/history_tree.h"
 #include "open_spiel/policy.h"
 #include "open_spiel/spiel.h"
@@ -71,15 +75,15 @@ class TabularBestResponse {
 
   // Changes the policy that we are calculating a best response to. This is
   // useful as a large amount of the data structures can be reused, causing
-  // the calculation to be quicker than if we had to re-initialize the class.
+  // the calculation to be quicker than if we had to re-initialize the class:
+  // the tree and infosets are kept, and only their counter-factual
+  // probabilities are recomputed, in one pass over the tree.
   void SetPolicy(const Policy* policy) {
     policy_ = policy;
     value_cache_.clear();
     best_response_actions_.clear();
-    // TODO(author1): Replace this with something that traverses the tree
-    // and rebuilds the probabilities.
-    infosets_ =
-        GetAllInfoSets(root_->Clone(), best_responder_, policy_, &tree_);
+    int index = 0;
+    ComputeReachProbabilities(tree_.Root(), 1., &index);
   }
 
   // Set the policy given a policy table. This stores the table internally.
@@ -105,6 +109,13 @@ class TabularBestResponse {
   // have nothing to do.
   double HandleTerminalCase(const HistoryNode& node) const;
 
+  // Sets the counter-factual probabilities in infosets_ of the decision nodes
+  // of best_responder below node, which is reached with probability prob.
+  // The nodes are numbered in the order of a depth-first walk, by `index`:
+  // the first walk adds them to infosets_, and later ones only update their
+  // probabilities in place.
+  void ComputeReachProbabilities(HistoryNode* node, double prob, int* index);
+
   Player best_responder_;
 
   // Used to store a specific policy if not passed in from the caller.
@@ -128,6 +139,15 @@ class TabularBestResponse {
   std::unordered_map<std::string, std::vector<std::pair<HistoryNode*, double>>>
       infosets_;
 
+  // The entry in infosets_ of each decision node of best_responder, by their
+  // index in ComputeReachProbabilities. The values of an unordered_map never
+  // move, so the pointers stay valid.
+  struct InfosetEntry {
+    std::vector<std::pair<HistoryNode*, double>>* infoset;
+    int position;
+  };
+  std::vector<InfosetEntry> infoset_entries_;
+
   // Caches all best responses calculated so far (for each infostate).
   std::unordered_map<std::string, Action> best_response_actions_;
 
@@ -139,6 +159,148 @@ class TabularBestResponse {
   std::unique_ptr<TabularPolicy> dummy_policy_;
 };
 
+// The same best response as TabularBestResponse, computed over a
+// CompiledGameTree: nodes and information states are integer ids, and no
+// State is kept for the nodes. The counter-factual reach probabilities of all
+// the nodes are computed in one pass down the tree, and the values in one
+// pass up it, each node being evaluated once.
+//
+// The policy is queried once for each information state of the other
+// players, at the state kept for it by the tree, which must be built with
+// keep_states. Those queries are spread over num_threads threads, so the
+// policy must then allow concurrent calls to GetStatePolicy, as the ones
+// reading a table do. The tree must outlive this.
+class CompiledTreeBestResponse {
+ public:
+  CompiledTreeBestResponse(const CompiledGameTree& tree, Player best_responder,
+                           const Policy* policy, int num_threads = 1);
+
+  // Changes the policy that we are calculating a best response to, and
+  // computes the best response to it.
+  void SetPolicy(const Policy* policy);
+
+  // Returns the expected utility for best_responder at the root when playing
+  // the best response.
+  double Value() const { return values_[CompiledGameTree::kRoot]; }
+
+  // Returns the best response at an information state of best_responder.
+  // When two actions have the same value, the first one in the tree is
+  // chosen.
+  Action BestResponseAction(int info_state);
+
+  // Returns a map of information state strings to best responses, for all
+  // the information states of best_responder.
+  std::unordered_map<std::string, Action> GetBestResponseActions();
+
+ private:
+  // The probability of the child at this index, in the counter-factual reach
+  // probability of best_responder.
+  double ChildProbability(int node, int index) const;
+
+  // Computes the value of a node and the ones below it that it depends on,
+  // unless it already has been.
+  double ComputeValue(int node);
+
+  // Chooses the best response at an information state of best_responder,
+  // unless it already has been, and returns the index of its action.
+  int ComputeBestResponse(int info_state);
+
+  // Queries the policy at the information states in [begin, end).
+  void LoadPolicies(const Policy& policy, int begin, int end);
+
+  const CompiledGameTree& tree_;
+  Player best_responder_;
+  const int num_threads_;
+
+  // The decision nodes of each information state of best_responder.
+  std::vector<std::vector<int>> info_state_nodes_;
+
+  // The probabilities of the actions of each information state of the other
+  // players, in the order of the tree.
+  std::vector<std::vector<double>> policies_;
+
+  // For each node, the probability of reaching it when best_responder plays
+  // to reach it, its value, and whether that has been computed.
+  std::vector<double> reach_probabilities_;
+  std::vector<double> values_;
+  std::vector<char> evaluated_;
+
+  // For each information state of best_responder, the index of the action
+  // of its best response, or -1 until it has been chosen.
+  std::vector<int> best_responses_;
+};
+
+// The same best response as TabularBestResponse, computed without building
+// the game tree: one depth-first walk of the game, which only keeps the states
+// of the current history, accumulates the counter-factual value of each
+// action at each information state of best_responder, and a pass over those
+// information states, from the deepest, chooses the best responses. So only
+// those information states are kept in memory, and not the histories, which
+// allows best responses in games whose trees do not fit in memory.
+//
+// This relies on best_responder having perfect recall: the value of an action
+// is then the value of the terminal histories reached without a further
+// decision by best_responder, plus the values of the best responses at the
+// information states that directly follow it. The policy is queried at every
+// decision node of the other players that is reached with a positive
+// probability.
+class StreamingBestResponse {
+ public:
+  StreamingBestResponse(const Game& game, Player best_responder,
+                        const Policy* policy);
+
+  // Changes the policy that we are calculating a best response to, and
+  // computes the best response to it with a new walk of the game.
+  void SetPolicy(const Policy* policy);
+
+  // Returns the expected utility for best_responder at the root when playing
+  // the best response.
+  double Value() const { return value_; }
+
+  // Returns the best response at an information state of best_responder.
+  // When two actions have the same value, the lowest one is chosen.
+  Action BestResponseAction(const std::string& info_state) const;
+
+  // Returns a map of information state strings to best responses, for all
+  // the information states of best_responder.
+  std::unordered_map<std::string, Action> GetBestResponseActions() const;
+
+ private:
+  // Adds the counter-factual values of the terminal histories below state,
+  // which is reached with probability reach by the other players and chance,
+  // to the values of the actions of best_responder which last led to them.
+  // The last action is given by the index of its information state in
+  // info_states_, and its index there, or -1 for histories where
+  // best_responder has not played yet.
+  void AccumulateValues(const State& state, double reach, int parent,
+                        int parent_action);
+
+  // Returns the index in info_states_ of the information state of
+  // best_responder at state, adding it if it is new.
+  int FindOrAddInfoState(const State& state, int parent, int parent_action);
+
+  std::unique_ptr<State> root_;
+  Player best_responder_;
+  const Policy* policy_;
+
+  // The information states of best_responder, each after the ones that lead
+  // to it, with the action of best_responder that led to them last, the
+  // accumulated value of each of their actions and the index of the best one.
+  struct InfoState {
+    int parent;
+    int parent_action;
+    std::vector<Action> actions;
+    std::vector<double> values;
+    int best_response;
+  };
+  std::vector<InfoState> info_states_;
+  std::unordered_map<std::string, int> info_state_indices_;
+
+  // The value at the root, first accumulating that of the terminal histories
+  // reached before any decision of best_responder.
+  double value_;
+};
+
 }  // namespace algorithms
 }  // namespace open_spiel
 
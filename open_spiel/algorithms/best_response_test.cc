@@ -20,6 +20,7 @@
 #include <iostream>
 #include <unordered_set>
 
+#include "open_spiel/algorithms/compiled_game_tree.h"
 #include "open_spiel/algorithms/minimax.h"
 #include "open_spiel/game_parameters.h"
 #include "open_spiel/games/efg_game.h"
@@ -371,6 +372,74 @@ void KuhnPokerUniformBestResponseAfterSwitchingPolicies() {
                                           best_responses);
 }
 
+// Recomputing the reach probabilities in SetPolicy gives the same best
+// response as building it anew.
+void LeducPokerBestResponseAfterSwitchingPolicies() {
+  std::shared_ptr<const Game> game = LoadGame("leduc_poker");
+  TabularPolicy uniform_policy = GetUniformPolicy(*game);
+  TabularPolicy random_policy = GetRandomPolicy(*game, /*seed=*/17);
+  for (Player best_responder : {Player{0}, Player{1}}) {
+    TabularBestResponse response(*game, best_responder, &uniform_policy);
+    response.GetBestResponseActions();
+    response.SetPolicy(&random_policy);
+    TabularBestResponse new_response(*game, best_responder, &random_policy);
+    SPIEL_CHECK_TRUE(response.GetBestResponseActions() ==
+                     new_response.GetBestResponseActions());
+    const std::string root = game->NewInitialState()->ToString();
+    SPIEL_CHECK_FLOAT_EQ(response.Value(root), new_response.Value(root));
+  }
+}
+
+// The best responses over a compiled tree are the same as those over the
+// history tree.
+void CheckCompiledTreeBestResponse(const std::string& game_name) {
+  std::shared_ptr<const Game> game = LoadGame(game_name);
+  const CompiledGameTree tree(*game->NewInitialState(), /*keep_states=*/true);
+  const std::string root = game->NewInitialState()->ToString();
+  TabularPolicy first_action_policy = GetFirstActionPolicy(*game);
+  TabularPolicy random_policy = GetRandomPolicy(*game, /*seed=*/17);
+  for (Player best_responder = 0; best_responder < game->NumPlayers();
+       ++best_responder) {
+    UniformPolicy uniform_policy;
+    CompiledTreeBestResponse best_response(tree, best_responder,
+                                           &uniform_policy);
+    for (const Policy* policy : std::vector<const Policy*>{
+             &uniform_policy, &first_action_policy, &random_policy}) {
+      best_response.SetPolicy(policy);
+      TabularBestResponse expected(*game, best_responder, policy);
+      SPIEL_CHECK_FLOAT_EQ(best_response.Value(), expected.Value(root));
+      SPIEL_CHECK_TRUE(best_response.GetBestResponseActions() ==
+                       expected.GetBestResponseActions());
+    }
+  }
+}
+
+void CheckStreamingBestResponse(const std::string& game_name) {
+  std::shared_ptr<const Game> game = LoadGame(game_name);
+  const std::string root = game->NewInitialState()->ToString();
+  TabularPolicy first_action_policy = GetFirstActionPolicy(*game);
+  TabularPolicy random_policy = GetRandomPolicy(*game, /*seed=*/17);
+  for (Player best_responder = 0; best_responder < game->NumPlayers();
+       ++best_responder) {
+    UniformPolicy uniform_policy;
+    StreamingBestResponse best_response(*game, best_responder,
+                                        &uniform_policy);
+    for (const Policy* policy : std::vector<const Policy*>{
+             &uniform_policy, &first_action_policy, &random_policy}) {
+      best_response.SetPolicy(policy);
+      TabularBestResponse expected(*game, best_responder, policy);
+      SPIEL_CHECK_FLOAT_EQ(best_response.Value(), expected.Value(root));
+      std::unordered_map<std::string, Action> expected_actions =
+          expected.GetBestResponseActions();
+      SPIEL_CHECK_TRUE(best_response.GetBestResponseActions() ==
+                       expected_actions);
+      for (const auto& [info_state, action] : expected_actions) {
+        SPIEL_CHECK_EQ(best_response.BestResponseAction(info_state), action);
+      }
+    }
+  }
+}
+
 // The best response values are taken from the existing Python implementation in
 // open_spiel/algorithms/exploitability.py.
 void KuhnPokerOptimalBestResponsePid0() {
@@ -533,4 +602,12 @@ int main(int argc, char** argv) {
   // Verifies that the code automatically generates the best response actions
   // after swapping policies.
   open_spiel::algorithms::KuhnPokerUniformBestResponseAfterSwitchingPolicies();
+  open_spiel::algorithms::LeducPokerBestResponseAfterSwitchingPolicies();
+  open_spiel::algorithms::CheckCompiledTreeBestResponse("kuhn_poker");
+  open_spiel::algorithms::CheckCompiledTreeBestResponse(
+      "kuhn_poker(players=3)");
+  open_spiel::algorithms::CheckCompiledTreeBestResponse("leduc_poker");
+  open_spiel::algorithms::CheckStreamingBestResponse("kuhn_poker");
+  open_spiel::algorithms::CheckStreamingBestResponse("kuhn_poker(players=3)");
+  open_spiel::algorithms::CheckStreamingBestResponse("leduc_poker");
 }
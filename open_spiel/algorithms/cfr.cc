@@ -15,104 +15,331 @@
 #include "open_spiel/algorithms/cfr.h"
 
 #include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "open_spiel/abseil-cpp/absl/algorithm/container.h"
+#include "open_spiel/abseil-cpp/absl/container/flat_hash_map.h"
+#include "open_spiel/abseil-cpp/absl/container/inlined_vector.h"
+#include "open_spiel/abseil-cpp/absl/strings/string_view.h"
+#include "open_spiel/abseil-cpp/absl/types/span.h"
+#include "open_spiel/algorithms/cfr_checkpoint.h"
+#include "open_spiel/algorithms/policy_file.h"
 #include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/thread.h"
+#include "open_spiel/utils/trace.h"
 
 namespace open_spiel {
 namespace algorithms {
+namespace {
+
+// Returns the table key of the entry for `info_state`.
+const std::string& InfoStateKeyFromString(
+    const std::string& info_state, const CFRInfoStateKeys* info_state_keys) {
+  if (info_state_keys != nullptr) {
+    auto it = info_state_keys->find(info_state);
+    if (it != info_state_keys->end()) return it->second;
+  }
+  return info_state;
+}
 
-CFRAveragePolicy::CFRAveragePolicy(const CFRInfoStateValuesTable& info_states,
-                                   std::shared_ptr<Policy> default_policy)
-    : info_states_(info_states), default_policy_(default_policy) {}
-
-ActionsAndProbs CFRAveragePolicy::GetStatePolicy(const State& state) const {
-  ActionsAndProbs actions_and_probs;
-  auto entry = info_states_.find(state.InformationStateString());
-  if (entry == info_states_.end()) {
-    if (default_policy_) {
-      return default_policy_->GetStatePolicy(state);
-    } else {
-      return actions_and_probs;
-    }
+// Parallel traversals split at the shallowest depth with at least this many
+// subtrees, or the one with the most up to the maximum depth.
+constexpr int kMinParallelSubtrees = 256;
+constexpr int kMaxParallelSplitDepth = 8;
+
+// How many non-terminal nodes there are `depth` actions below `node`.
+int CountNonTerminalNodes(const CompiledGameTree& tree, int node, int depth) {
+  if (tree.IsTerminal(node)) return 0;
+  if (depth == 0) return 1;
+  int count = 0;
+  for (int child : tree.Children(node)) {
+    count += CountNonTerminalNodes(tree, child, depth - 1);
   }
-  GetStatePolicyFromInformationStateValues(entry->second, &actions_and_probs);
-  return actions_and_probs;
+  return count;
 }
 
-ActionsAndProbs CFRAveragePolicy::GetStatePolicy(
-    const std::string& info_state) const {
-  ActionsAndProbs actions_and_probs;
-  auto entry = info_states_.find(info_state);
-  if (entry == info_states_.end()) {
-    if (default_policy_) {
-      return default_policy_->GetStatePolicy(info_state);
-    } else {
-      return actions_and_probs;
+double CounterFactualReachProb(const std::vector<double>& reach_probabilities,
+                               const int player) {
+  double cfr_reach_prob = 1.0;
+  for (int i = 0; i < reach_probabilities.size(); i++) {
+    if (i != player) {
+      cfr_reach_prob *= reach_probabilities[i];
     }
   }
-  GetStatePolicyFromInformationStateValues(entry->second, &actions_and_probs);
-  return actions_and_probs;
+  return cfr_reach_prob;
 }
 
-void CFRAveragePolicy::GetStatePolicyFromInformationStateValues(
-    const CFRInfoStateValues& is_vals,
-    ActionsAndProbs* actions_and_probs) const {
+// The regret and average policy updates of a subtree of a parallel traversal,
+// for each information state: its regrets, then its policy updates.
+using SubtreeUpdates = absl::flat_hash_map<int, std::vector<double>>;
+
+struct Subtree {
+  int node;
+  std::vector<double> reach_probabilities;
+  std::vector<double> value;
+  SubtreeUpdates updates;
+};
+
+// The subtrees a parallel traversal is split into, `depth` actions below its
+// root, in depth-first order. The levels above them are walked twice: to
+// collect them, and then with their values.
+struct ParallelFrontier {
+  int depth;
+  std::vector<Subtree> subtrees;
+  bool collecting = true;
+  int next = 0;
+};
+
+// Writes the average policy from the cumulative one.
+template <typename T>
+void AveragePolicyFromCumulativePolicy(absl::Span<const T> cumulative_policy,
+                                       absl::Span<double> probs) {
   double sum_prob = 0.0;
-  for (int aidx = 0; aidx < is_vals.num_actions(); ++aidx) {
-    sum_prob += is_vals.cumulative_policy[aidx];
+  for (int aidx = 0; aidx < cumulative_policy.size(); ++aidx) {
+    sum_prob += cumulative_policy[aidx];
   }
 
   if (sum_prob == 0.0) {
     // Return a uniform policy at this node
-    double prob = 1. / is_vals.num_actions();
-    for (Action action : is_vals.legal_actions) {
-      actions_and_probs->push_back({action, prob});
-    }
+    std::fill_n(probs.begin(), cumulative_policy.size(),
+                1. / cumulative_policy.size());
     return;
   }
 
-  for (int aidx = 0; aidx < is_vals.num_actions(); ++aidx) {
-    actions_and_probs->push_back({is_vals.legal_actions[aidx],
-                                  is_vals.cumulative_policy[aidx] / sum_prob});
+  for (int aidx = 0; aidx < cumulative_policy.size(); ++aidx) {
+    probs[aidx] = cumulative_policy[aidx] / sum_prob;
   }
 }
 
-CFRCurrentPolicy::CFRCurrentPolicy(const CFRInfoStateValuesTable& info_states,
-                                   std::shared_ptr<Policy> default_policy)
-    : info_states_(info_states), default_policy_(default_policy) {}
+}  // namespace
+
+template <typename T>
+std::pair<int, bool> BasicCFRInfoStateValuesTable<T>::Insert(
+    const std::string& key, absl::Span<const Action> legal_actions,
+    double init_value) {
+  auto [it, inserted] = ids_.try_emplace(key, entries_.size());
+  if (inserted) {
+    const int num_actions = legal_actions.size();
+    Entry entry{values_.Allocate(3 * num_actions),
+                legal_actions_.Allocate(num_actions), num_actions};
+    std::fill(entry.values, entry.values + 2 * num_actions, init_value);
+    std::fill(entry.values + 2 * num_actions, entry.values + 3 * num_actions,
+              1.0 / num_actions);
+    std::copy(legal_actions.begin(), legal_actions.end(),
+              entry.legal_actions);
+    entries_.push_back(entry);
+  }
+  return {it->second, inserted};
+}
+
+template <typename T>
+int FindOrInsertInfoStateId(
+    const State& state, const std::string& info_state_key,
+    const std::vector<Action>& legal_actions, double init_value,
+    BasicCFRInfoStateValuesTable<T>* info_states,
+    CFRInfoStateKeys* info_state_keys) {
+  auto [id, inserted] =
+      info_states->Insert(info_state_key, legal_actions, init_value);
+  if (inserted) {
+    std::string info_state = state.InformationStateString();
+    if (info_state != info_state_key) {
+      info_state_keys->emplace(std::move(info_state), info_state_key);
+    }
+  }
+  return id;
+}
+
+template <typename T>
+BasicCFRInfoStateValues<T> FindOrInsertInfoStateValues(
+    const State& state, const std::string& info_state_key,
+    const std::vector<Action>& legal_actions, double init_value,
+    BasicCFRInfoStateValuesTable<T>* info_states,
+    CFRInfoStateKeys* info_state_keys) {
+  return (*info_states)[FindOrInsertInfoStateId(
+      state, info_state_key, legal_actions, init_value, info_states,
+      info_state_keys)];
+}
+
+template <typename T>
+BasicCFRAveragePolicy<T>::BasicCFRAveragePolicy(
+    const BasicCFRInfoStateValuesTable<T>& info_states,
+    std::shared_ptr<Policy> default_policy,
+    const CFRInfoStateKeys* info_state_keys)
+    : info_states_(&info_states),
+      info_state_keys_(info_state_keys),
+      default_policy_(default_policy) {}
+
+template <typename T>
+BasicCFRAveragePolicy<T>::BasicCFRAveragePolicy(
+    std::shared_ptr<const CFRCheckpoint> checkpoint,
+    std::shared_ptr<Policy> default_policy)
+    : info_states_(nullptr),
+      checkpoint_(std::move(checkpoint)),
+      info_state_keys_(nullptr),
+      default_policy_(default_policy) {
+  SPIEL_CHECK_TRUE(checkpoint_ != nullptr);
+}
+
+template <typename T>
+ActionsAndProbs BasicCFRAveragePolicy<T>::GetStatePolicy(
+    const State& state) const {
+  ActionsAndProbs actions_and_probs;
+  if (!GetStatePolicyFromId(Find(state.InformationStateKey()),
+                            &actions_and_probs) &&
+      default_policy_) {
+    return default_policy_->GetStatePolicy(state);
+  }
+  return actions_and_probs;
+}
+
+template <typename T>
+ActionsAndProbs BasicCFRAveragePolicy<T>::GetStatePolicy(
+    const std::string& info_state) const {
+  ActionsAndProbs actions_and_probs;
+  const int id =
+      checkpoint_ ? checkpoint_->FindInfoStateString(info_state)
+                  : info_states_->Find(
+                        InfoStateKeyFromString(info_state, info_state_keys_));
+  if (!GetStatePolicyFromId(id, &actions_and_probs) && default_policy_) {
+    return default_policy_->GetStatePolicy(info_state);
+  }
+  return actions_and_probs;
+}
+
+template <typename T>
+absl::Span<const Action> BasicCFRAveragePolicy<T>::GetStatePolicyByKey(
+    absl::string_view key, absl::Span<double> probs) const {
+  const int id = Find(key);
+  if (id < 0) return {};
+  AveragePolicyFromId(id, probs);
+  return LegalActions(id);
+}
+
+template <typename T>
+void BasicCFRAveragePolicy<T>::CacheAveragePolicy() {
+  const int num_entries =
+      checkpoint_ ? checkpoint_->NumInfoStates() : info_states_->size();
+  cached_offsets_.clear();
+  cached_offsets_.reserve(num_entries + 1);
+  cached_offsets_.push_back(0);
+  for (int id = 0; id < num_entries; ++id) {
+    cached_offsets_.push_back(cached_offsets_.back() +
+                              LegalActions(id).size());
+  }
+  // Computed before being set, as AveragePolicyFromId reads it if set.
+  std::vector<double> probs(cached_offsets_.back());
+  for (int id = 0; id < num_entries; ++id) {
+    AveragePolicyFromId(id, absl::MakeSpan(&probs[cached_offsets_[id]],
+                                           LegalActions(id).size()));
+  }
+  cached_probs_ = std::move(probs);
+}
+
+template <typename T>
+int BasicCFRAveragePolicy<T>::Find(absl::string_view key) const {
+  return checkpoint_ ? checkpoint_->Find(key) : info_states_->Find(key);
+}
+
+template <typename T>
+absl::Span<const Action> BasicCFRAveragePolicy<T>::LegalActions(
+    int id) const {
+  return checkpoint_ ? checkpoint_->LegalActions(id)
+                     : (*info_states_)[id].legal_actions;
+}
+
+template <typename T>
+void BasicCFRAveragePolicy<T>::AveragePolicyFromId(
+    int id, absl::Span<double> probs) const {
+  if (!cached_probs_.empty()) {
+    std::copy(cached_probs_.begin() + cached_offsets_[id],
+              cached_probs_.begin() + cached_offsets_[id + 1], probs.begin());
+  } else if (checkpoint_) {
+    AveragePolicyFromCumulativePolicy<double>(
+        checkpoint_->CumulativePolicy(id), probs);
+  } else {
+    AveragePolicyFromCumulativePolicy<T>(
+        (*info_states_)[id].cumulative_policy, probs);
+  }
+}
+
+template <typename T>
+bool BasicCFRAveragePolicy<T>::GetStatePolicyFromId(
+    int id, ActionsAndProbs* actions_and_probs) const {
+  if (id < 0) return false;
+  absl::Span<const Action> legal_actions = LegalActions(id);
+  absl::InlinedVector<double, 16> probs(legal_actions.size());
+  AveragePolicyFromId(id, absl::MakeSpan(probs));
+  actions_and_probs->reserve(legal_actions.size());
+  for (int aidx = 0; aidx < legal_actions.size(); ++aidx) {
+    actions_and_probs->push_back({legal_actions[aidx], probs[aidx]});
+  }
+  return true;
+}
 
-ActionsAndProbs CFRCurrentPolicy::GetStatePolicy(const State& state) const {
+template <typename T>
+BasicCFRCurrentPolicy<T>::BasicCFRCurrentPolicy(
+    const BasicCFRInfoStateValuesTable<T>& info_states,
+    std::shared_ptr<Policy> default_policy,
+    const CFRInfoStateKeys* info_state_keys)
+    : info_states_(info_states),
+      info_state_keys_(info_state_keys),
+      default_policy_(default_policy) {}
+
+template <typename T>
+ActionsAndProbs BasicCFRCurrentPolicy<T>::GetStatePolicy(
+    const State& state) const {
   ActionsAndProbs actions_and_probs;
-  auto entry = info_states_.find(state.InformationStateString());
-  if (entry == info_states_.end()) {
+  const int id = info_states_.Find(state.InformationStateKey());
+  if (id < 0) {
     if (default_policy_) {
       return default_policy_->GetStatePolicy(state);
     } else {
       return actions_and_probs;
     }
   }
-  return GetStatePolicyFromInformationStateValues(entry->second,
+  return GetStatePolicyFromInformationStateValues(info_states_[id],
                                                   actions_and_probs);
 }
 
-ActionsAndProbs CFRCurrentPolicy::GetStatePolicy(
+template <typename T>
+ActionsAndProbs BasicCFRCurrentPolicy<T>::GetStatePolicy(
     const std::string& info_state) const {
   ActionsAndProbs actions_and_probs;
-  auto entry = info_states_.find(info_state);
-  if (entry == info_states_.end()) {
+  const int id =
+      info_states_.Find(InfoStateKeyFromString(info_state, info_state_keys_));
+  if (id < 0) {
     if (default_policy_) {
       return default_policy_->GetStatePolicy(info_state);
     } else {
       return actions_and_probs;
     }
   }
-  return GetStatePolicyFromInformationStateValues(entry->second,
+  return GetStatePolicyFromInformationStateValues(info_states_[id],
                                                   actions_and_probs);
 }
 
-ActionsAndProbs CFRCurrentPolicy::GetStatePolicyFromInformationStateValues(
-    const CFRInfoStateValues& is_vals,
+template <typename T>
+absl::Span<const Action> BasicCFRCurrentPolicy<T>::GetStatePolicyByKey(
+    absl::string_view key, absl::Span<double> probs) const {
+  const int id = info_states_.Find(key);
+  if (id < 0) return {};
+  const BasicCFRInfoStateValues<T> is_vals = info_states_[id];
+  std::copy(is_vals.current_policy.begin(), is_vals.current_policy.end(),
+            probs.begin());
+  return is_vals.legal_actions;
+}
+
+template <typename T>
+ActionsAndProbs
+BasicCFRCurrentPolicy<T>::GetStatePolicyFromInformationStateValues(
+    const BasicCFRInfoStateValues<T>& is_vals,
     ActionsAndProbs& actions_and_probs) const {
   for (int aidx = 0; aidx < is_vals.num_actions(); ++aidx) {
     actions_and_probs.push_back(
@@ -121,15 +348,22 @@ ActionsAndProbs CFRCurrentPolicy::GetStatePolicyFromInformationStateValues(
   return actions_and_probs;
 }
 
-CFRSolverBase::CFRSolverBase(const Game& game, bool alternating_updates,
-                             bool linear_averaging, bool regret_matching_plus)
+template <typename T>
+BasicCFRSolverBase<T>::BasicCFRSolverBase(
+    const Game& game, bool alternating_updates, bool linear_averaging,
+    bool regret_matching_plus, int num_threads,
+    std::optional<CFRDiscounting> discounting)
     : game_(game),
       root_state_(game.NewInitialState()),
+      tree_(*root_state_),
       root_reach_probs_(game_.NumPlayers() + 1, 1.0),
       regret_matching_plus_(regret_matching_plus),
       alternating_updates_(alternating_updates),
       linear_averaging_(linear_averaging),
-      chance_player_(game.NumPlayers()) {
+      discounting_(discounting),
+      chance_player_(game.NumPlayers()),
+      num_threads_(num_threads) {
+  SPIEL_CHECK_GE(num_threads_, 1);
   if (game_.GetType().dynamics != GameType::Dynamics::kSequential) {
     SpielFatalError(
         "CFR requires sequential games. If you're trying to run it "
@@ -137,46 +371,93 @@ CFRSolverBase::CFRSolverBase(const Game& game, bool alternating_updates,
         "using turn_based_simultaneous_game.");
   }
 
-  InitializeInfostateNodes(*root_state_);
+  InitializeInfostateNodes();
 }
 
-void CFRSolverBase::InitializeInfostateNodes(const State& state) {
-  if (state.IsTerminal()) {
-    return;
-  }
-  if (state.IsChanceNode()) {
-    for (const auto& action_prob : state.ChanceOutcomes()) {
-      InitializeInfostateNodes(*state.Child(action_prob.first));
+template <typename T>
+void BasicCFRSolverBase<T>::InitializeInfostateNodes() {
+  for (int info_state = 0; info_state < tree_.NumInfoStates(); ++info_state) {
+    const std::string& key = tree_.InfoStateKey(info_state);
+    const int id = info_states_
+                       .Insert(key, tree_.InfoStateActions(info_state),
+                               /*init_value=*/0)
+                       .first;
+    SPIEL_CHECK_EQ(id, info_state);
+    const std::string& info_state_string = tree_.InfoStateString(info_state);
+    if (info_state_string != key) {
+      info_state_keys_.emplace(info_state_string, key);
     }
-    return;
   }
+}
+
+template <typename T>
+void BasicCFRSolverBase<T>::SaveCheckpoint(const std::string& filename) const {
+  SaveCFRCheckpoint(filename, info_states_, info_state_keys_, iteration_);
+}
 
-  int current_player = state.CurrentPlayer();
-  std::string info_state = state.InformationStateString(current_player);
-  std::vector<Action> legal_actions = state.LegalActions();
+template <typename T>
+void BasicCFRSolverBase<T>::LoadCheckpoint(const std::string& filename) {
+  CFRCheckpoint checkpoint(filename);
+  SPIEL_CHECK_EQ(checkpoint.NumInfoStates(), info_states_.size());
+  checkpoint.CopyTo(&info_states_, &info_state_keys_);
+  iteration_ = checkpoint.iteration();
+}
 
-  CFRInfoStateValues is_vals(legal_actions);
-  info_states_[info_state] = is_vals;
+template <typename T>
+void BasicCFRSolverBase<T>::SaveAveragePolicy(const std::string& filename,
+                                              bool single_precision) const {
+  SaveCFRAveragePolicy(filename, info_states_, info_state_keys_,
+                       single_precision);
+}
 
-  for (const Action& action : legal_actions) {
-    InitializeInfostateNodes(*state.Child(action));
+template <typename T>
+void BasicCFRSolverBase<T>::EnableRegretBasedPruning(double regret_threshold,
+                                                     int warmup_iterations,
+                                                     int revisit_interval) {
+  SPIEL_CHECK_LT(regret_threshold, 0);
+  SPIEL_CHECK_GE(warmup_iterations, 0);
+  SPIEL_CHECK_GE(revisit_interval, 1);
+  pruning_ = true;
+  pruning_regret_threshold_ = regret_threshold;
+  pruning_warmup_iterations_ = warmup_iterations;
+  pruning_revisit_interval_ = revisit_interval;
+  pruned_action_offsets_.clear();
+  int num_actions = 0;
+  for (int id = 0; id < info_states_.size(); ++id) {
+    pruned_action_offsets_.push_back(num_actions);
+    num_actions += info_states_[id].num_actions();
   }
+  pruned_actions_.assign(num_actions, false);
+}
+
+template <typename T>
+bool BasicCFRSolverBase<T>::PruneThisIteration() const {
+  return pruning_ && iteration_ > pruning_warmup_iterations_ &&
+         iteration_ % pruning_revisit_interval_ != 0;
 }
 
-void CFRSolverBase::EvaluateAndUpdatePolicy() {
+template <typename T>
+void BasicCFRSolverBase<T>::EvaluateAndUpdatePolicy() {
+  OPEN_SPIEL_TRACE_SPAN("cfr", "Iteration");
   ++iteration_;
   if (alternating_updates_) {
     for (int player = 0; player < game_.NumPlayers(); player++) {
-      ComputeCounterFactualRegret(*root_state_, player, root_reach_probs_,
-                                  nullptr);
+      ComputeCounterFactualRegret(CompiledGameTree::kRoot, player,
+                                  root_reach_probs_, nullptr);
+      if (discounting_) {
+        ApplyDiscounting(player);
+      }
       if (regret_matching_plus_) {
         ApplyRegretMatchingPlusReset();
       }
       ApplyRegretMatching();
     }
   } else {
-    ComputeCounterFactualRegret(*root_state_, std::nullopt, root_reach_probs_,
-                                nullptr);
+    ComputeCounterFactualRegret(CompiledGameTree::kRoot, std::nullopt,
+                                root_reach_probs_, nullptr);
+    if (discounting_) {
+      ApplyDiscounting(std::nullopt);
+    }
     if (regret_matching_plus_) {
       ApplyRegretMatchingPlusReset();
     }
@@ -184,46 +465,106 @@ void CFRSolverBase::EvaluateAndUpdatePolicy() {
   }
 }
 
-static double CounterFactualReachProb(
-    const std::vector<double>& reach_probabilities, const int player) {
-  double cfr_reach_prob = 1.0;
-  for (int i = 0; i < reach_probabilities.size(); i++) {
-    if (i != player) {
-      cfr_reach_prob *= reach_probabilities[i];
-    }
-  }
-  return cfr_reach_prob;
-}
+template <typename T>
+struct BasicCFRSolverBase<T>::Traversal {
+  std::optional<int> alternating_player;
+  const std::vector<const Policy*>* policy_overrides;
+  // Whether the actions in pruned_actions_ are skipped, for the alternating
+  // player.
+  bool prune;
+  // The updates of a subtree of a parallel traversal, which are applied
+  // directly to the table if null.
+  SubtreeUpdates* updates = nullptr;
+  // The subtrees of a parallel traversal, for the levels above them.
+  ParallelFrontier* frontier = nullptr;
+};
 
 // Compute counterfactual regrets. Alternates recursively with
 // ComputeCounterFactualRegretForActionProbs.
 //
 // Args:
-// - state: The state to start the recursion.
+// - node: The node of tree_ to start the recursion.
 // - alternating_player: Optionally only update this player.
 // - reach_probabilities: The reach probabilities of this state for each
 //      player, ending with the chance player.
 //
 // Returns:
 //   The value of the state for each player (excluding the chance player).
-std::vector<double> CFRSolverBase::ComputeCounterFactualRegret(
-    const State& state, const std::optional<int>& alternating_player,
+template <typename T>
+std::vector<double> BasicCFRSolverBase<T>::ComputeCounterFactualRegret(
+    int node, const std::optional<int>& alternating_player,
     const std::vector<double>& reach_probabilities,
     const std::vector<const Policy*>* policy_overrides) {
-  if (state.IsTerminal()) {
-    return state.Returns();
-  }
-  if (state.IsChanceNode()) {
-    ActionsAndProbs actions_and_probs = state.ChanceOutcomes();
-    std::vector<double> dist(actions_and_probs.size(), 0);
-    std::vector<Action> outcomes(actions_and_probs.size(), 0);
-    for (int oidx = 0; oidx < actions_and_probs.size(); ++oidx) {
-      outcomes[oidx] = actions_and_probs[oidx].first;
-      dist[oidx] = actions_and_probs[oidx].second;
+  Traversal traversal{alternating_player, policy_overrides,
+                      alternating_player.has_value() && PruneThisIteration()};
+  if (num_threads_ == 1) {
+    return ComputeCounterFactualRegret(node, reach_probabilities, 0,
+                                       &traversal);
+  }
+
+  // A first pass over the levels above the subtrees collects them, in
+  // depth-first order, without updating anything. The reach probabilities
+  // only depend on the current policies, which don't change during the
+  // traversal.
+  ParallelFrontier frontier;
+  frontier.depth = ParallelSplitDepth();
+  traversal.frontier = &frontier;
+  ComputeCounterFactualRegret(node, reach_probabilities, 0, &traversal);
+
+  std::vector<Subtree>& subtrees = frontier.subtrees;
+  std::atomic<int> next_subtree{0};
+  auto traverse_subtrees = [&]() {
+    for (int i = next_subtree++; i < subtrees.size(); i = next_subtree++) {
+      Traversal subtree_traversal{alternating_player, policy_overrides,
+                                  traversal.prune, &subtrees[i].updates};
+      subtrees[i].value = ComputeCounterFactualRegret(
+          subtrees[i].node, subtrees[i].reach_probabilities, frontier.depth,
+          &subtree_traversal);
+    }
+  };
+  std::vector<Thread> threads;
+  for (int i = 1; i < std::min<int>(num_threads_, subtrees.size()); ++i) {
+    threads.emplace_back(traverse_subtrees);
+  }
+  traverse_subtrees();
+  for (Thread& thread : threads) thread.join();
+
+  for (Subtree& subtree : subtrees) {
+    for (const auto& [id, deltas] : subtree.updates) {
+      BasicCFRInfoStateValues<T> is_vals = info_states_[id];
+      const int num_actions = is_vals.num_actions();
+      for (int aidx = 0; aidx < num_actions; ++aidx) {
+        is_vals.cumulative_regrets[aidx] += deltas[aidx];
+        is_vals.cumulative_policy[aidx] += deltas[num_actions + aidx];
+      }
+    }
+  }
+
+  // Then a second pass does the updates above the subtrees, with their values.
+  frontier.collecting = false;
+  return ComputeCounterFactualRegret(node, reach_probabilities, 0, &traversal);
+}
+
+template <typename T>
+std::vector<double> BasicCFRSolverBase<T>::ComputeCounterFactualRegret(
+    int node, const std::vector<double>& reach_probabilities, int depth,
+    Traversal* traversal) {
+  if (tree_.IsTerminal(node)) {
+    absl::Span<const double> returns = tree_.Returns(node);
+    return std::vector<double>(returns.begin(), returns.end());
+  }
+  if (traversal->frontier != nullptr && depth == traversal->frontier->depth) {
+    ParallelFrontier& frontier = *traversal->frontier;
+    if (frontier.collecting) {
+      frontier.subtrees.push_back({node, reach_probabilities, {}, {}});
+      return std::vector<double>(game_.NumPlayers(), 0.0);
     }
+    return frontier.subtrees[frontier.next++].value;
+  }
+  if (tree_.IsChanceNode(node)) {
     return ComputeCounterFactualRegretForActionProbs(
-        state, alternating_player, reach_probabilities, chance_player_, dist,
-        outcomes, nullptr, policy_overrides);
+        node, reach_probabilities, depth, chance_player_,
+        tree_.ChanceProbabilities(node), nullptr, nullptr, traversal);
   }
   if (AllPlayersHaveZeroReachProb(reach_probabilities)) {
     // The value returned is not used: if the reach probability for all players
@@ -232,64 +573,121 @@ std::vector<double> CFRSolverBase::ComputeCounterFactualRegret(
     return std::vector<double>(game_.NumPlayers(), 0.0);
   }
 
-  int current_player = state.CurrentPlayer();
-  std::string info_state = state.InformationStateString();
-  std::vector<Action> legal_actions = state.LegalActions(current_player);
-
-  // Load current policy.
-  std::vector<double> info_state_policy;
-  if (policy_overrides && policy_overrides->at(current_player)) {
-    GetInfoStatePolicyFromPolicy(&info_state_policy, legal_actions,
+  const int current_player = tree_.CurrentPlayer(node);
+  const int info_state = tree_.InfoState(node);
+  const std::vector<const Policy*>* policy_overrides =
+      traversal->policy_overrides;
+  BasicCFRInfoStateValues<T> is_vals = info_states_[info_state];
+  const int num_actions = is_vals.num_actions();
+
+  // Load current policy. It only changes between traversals. It is copied if
+  // overridden, or stored with less precision.
+  absl::Span<const double> info_state_policy;
+  std::vector<double> policy_copy;
+  const bool overridden =
+      policy_overrides && policy_overrides->at(current_player);
+  if (overridden) {
+    GetInfoStatePolicyFromPolicy(&policy_copy,
                                  policy_overrides->at(current_player),
                                  info_state);
+    info_state_policy = policy_copy;
+  } else if constexpr (std::is_same_v<T, double>) {
+    info_state_policy = is_vals.current_policy;
   } else {
-    info_state_policy = GetPolicy(info_state, legal_actions);
+    policy_copy.assign(is_vals.current_policy.begin(),
+                       is_vals.current_policy.end());
+    info_state_policy = policy_copy;
+  }
+
+  // The actions to skip, when pruning.
+  const char* pruned = nullptr;
+  if (traversal->prune && *traversal->alternating_player == current_player &&
+      !overridden) {
+    pruned = pruned_actions_.data() + pruned_action_offsets_[info_state];
   }
 
   std::vector<double> child_utilities;
-  child_utilities.reserve(legal_actions.size());
+  child_utilities.reserve(num_actions);
   const std::vector<double> state_value =
       ComputeCounterFactualRegretForActionProbs(
-          state, alternating_player, reach_probabilities, current_player,
-          info_state_policy, legal_actions, &child_utilities, policy_overrides);
+          node, reach_probabilities, depth, current_player, info_state_policy,
+          pruned, &child_utilities, traversal);
+  if (traversal->frontier != nullptr && traversal->frontier->collecting) {
+    return state_value;
+  }
 
   // Perform regret and average strategy updates.
+  const std::optional<int>& alternating_player = traversal->alternating_player;
   if (!alternating_player || *alternating_player == current_player) {
-    CFRInfoStateValues is_vals = info_states_[info_state];
-    SPIEL_CHECK_FALSE(is_vals.empty());
 
     const double self_reach_prob = reach_probabilities[current_player];
     const double cfr_reach_prob =
         CounterFactualReachProb(reach_probabilities, current_player);
 
-    for (int aidx = 0; aidx < legal_actions.size(); ++aidx) {
-      // Update regrets.
-      double cfr_regret = cfr_reach_prob *
-                          (child_utilities[aidx] - state_value[current_player]);
-
-      is_vals.cumulative_regrets[aidx] += cfr_regret;
-
-      // Update average policy.
-      if (linear_averaging_) {
-        is_vals.cumulative_policy[aidx] +=
-            iteration_ * self_reach_prob * info_state_policy[aidx];
-      } else {
-        is_vals.cumulative_policy[aidx] +=
-            self_reach_prob * info_state_policy[aidx];
+    auto update = [&](auto* regrets, auto* policy) {
+      for (int aidx = 0; aidx < num_actions; ++aidx) {
+        // Pruned actions have no value, and are not played.
+        if (pruned != nullptr && pruned[aidx]) continue;
+
+        // Update regrets.
+        double cfr_regret =
+            cfr_reach_prob *
+            (child_utilities[aidx] - state_value[current_player]);
+
+        regrets[aidx] += cfr_regret;
+
+        // Update average policy.
+        if (linear_averaging_) {
+          policy[aidx] +=
+              iteration_ * self_reach_prob * info_state_policy[aidx];
+        } else {
+          policy[aidx] += self_reach_prob * info_state_policy[aidx];
+        }
       }
+    };
+
+    // In a subtree of a parallel traversal, the regrets and then the policy
+    // updates are added to its buffer for this information state.
+    if (traversal->updates != nullptr) {
+      std::vector<double>& deltas = (*traversal->updates)[info_state];
+      deltas.resize(2 * num_actions, 0);
+      update(deltas.data(), deltas.data() + num_actions);
+    } else {
+      update(is_vals.cumulative_regrets.data(),
+             is_vals.cumulative_policy.data());
     }
-
-    info_states_[info_state] = is_vals;
   }
 
   return state_value;
 }
 
-void CFRSolverBase::GetInfoStatePolicyFromPolicy(
-    std::vector<double>* info_state_policy,
-    const std::vector<Action>& legal_actions, const Policy* policy,
-    const std::string& info_state) const {
-  ActionsAndProbs actions_and_probs = policy->GetStatePolicy(info_state);
+template <typename T>
+int BasicCFRSolverBase<T>::ParallelSplitDepth() {
+  if (parallel_split_depth_ < 0) {
+    // The shallowest depth with enough subtrees to keep many threads busy,
+    // regardless of how many there are.
+    int most_subtrees = 0;
+    for (int depth = 1; depth <= kMaxParallelSplitDepth; ++depth) {
+      int num_subtrees =
+          CountNonTerminalNodes(tree_, CompiledGameTree::kRoot, depth);
+      if (num_subtrees > most_subtrees) {
+        most_subtrees = num_subtrees;
+        parallel_split_depth_ = depth;
+      }
+      if (num_subtrees == 0 || num_subtrees >= kMinParallelSubtrees) break;
+    }
+    parallel_split_depth_ = std::max(parallel_split_depth_, 1);
+  }
+  return parallel_split_depth_;
+}
+
+template <typename T>
+void BasicCFRSolverBase<T>::GetInfoStatePolicyFromPolicy(
+    std::vector<double>* info_state_policy, const Policy* policy,
+    int info_state) const {
+  absl::Span<const Action> legal_actions = tree_.InfoStateActions(info_state);
+  ActionsAndProbs actions_and_probs =
+      policy->GetStatePolicy(tree_.InfoStateString(info_state));
   info_state_policy->reserve(legal_actions.size());
 
   // The policy may have extra ones not at this infostate
@@ -309,33 +707,37 @@ void CFRSolverBase::GetInfoStatePolicyFromPolicy(
 // Alternates recursively with ComputeCounterFactualRegret.
 //
 // Args:
-// - state: The state to start the recursion.
-// - alternating_player: Optionally only update this player.
-// - reach_probabilities: The reach probabilities of this state.
+// - node: The node of tree_ to start the recursion.
+// - reach_probabilities: The reach probabilities of this node.
+// - depth: How many actions below the root of the traversal this node is.
 // - current_player: Either a player or chance_player_.
-// - action_probs: The action probabilities to use frp this state.
+// - action_probs: The probabilities of the children of this node.
+// - pruned: optionally, which children to skip. They must have probability 0.
 // - child_values_out: optional output parameter which is filled with the child
 //           utilities for each action, for current_player.
+// - traversal: The options of the traversal.
 // Returns:
 //   The value of the state for each player (excluding the chance player).
-std::vector<double> CFRSolverBase::ComputeCounterFactualRegretForActionProbs(
-    const State& state, const std::optional<int>& alternating_player,
-    const std::vector<double>& reach_probabilities, const int current_player,
-    const std::vector<double>& info_state_policy,
-    const std::vector<Action>& legal_actions,
-    std::vector<double>* child_values_out,
-    const std::vector<const Policy*>* policy_overrides) {
+template <typename T>
+std::vector<double>
+BasicCFRSolverBase<T>::ComputeCounterFactualRegretForActionProbs(
+    int node, const std::vector<double>& reach_probabilities, int depth,
+    const int current_player, absl::Span<const double> info_state_policy,
+    const char* pruned, std::vector<double>* child_values_out,
+    Traversal* traversal) {
   std::vector<double> state_value(game_.NumPlayers());
 
-  for (int aidx = 0; aidx < legal_actions.size(); ++aidx) {
-    const Action action = legal_actions[aidx];
+  absl::Span<const int> children = tree_.Children(node);
+  for (int aidx = 0; aidx < children.size(); ++aidx) {
     const double prob = info_state_policy[aidx];
-    const std::unique_ptr<State> new_state = state.Child(action);
+    if (pruned != nullptr && pruned[aidx]) {
+      if (child_values_out != nullptr) child_values_out->push_back(0);
+      continue;
+    }
     std::vector<double> new_reach_probabilities(reach_probabilities);
     new_reach_probabilities[current_player] *= prob;
-    std::vector<double> child_value =
-        ComputeCounterFactualRegret(*new_state, alternating_player,
-                                    new_reach_probabilities, policy_overrides);
+    std::vector<double> child_value = ComputeCounterFactualRegret(
+        children[aidx], new_reach_probabilities, depth + 1, traversal);
     for (int i = 0; i < state_value.size(); ++i) {
       state_value[i] += prob * child_value[i];
     }
@@ -346,7 +748,8 @@ std::vector<double> CFRSolverBase::ComputeCounterFactualRegretForActionProbs(
   return state_value;
 }
 
-bool CFRSolverBase::AllPlayersHaveZeroReachProb(
+template <typename T>
+bool BasicCFRSolverBase<T>::AllPlayersHaveZeroReachProb(
     const std::vector<double>& reach_probabilities) const {
   for (int i = 0; i < game_.NumPlayers(); i++) {
     if (reach_probabilities[i] != 0.0) {
@@ -356,21 +759,8 @@ bool CFRSolverBase::AllPlayersHaveZeroReachProb(
   return true;
 }
 
-std::vector<double> CFRSolverBase::GetPolicy(
-    const std::string& info_state, const std::vector<Action>& legal_actions) {
-  auto entry = info_states_.find(info_state);
-  if (entry == info_states_.end()) {
-    info_states_[info_state] = CFRInfoStateValues(legal_actions);
-    entry = info_states_.find(info_state);
-  }
-
-  SPIEL_CHECK_FALSE(entry == info_states_.end());
-  SPIEL_CHECK_FALSE(entry->second.empty());
-  SPIEL_CHECK_FALSE(entry->second.current_policy.empty());
-  return entry->second.current_policy;
-}
-
-std::string CFRInfoStateValues::ToString() const {
+template <typename T>
+std::string BasicCFRInfoStateValues<T>::ToString() const {
   std::string str = "";
   absl::StrAppend(&str, "Legal actions: ", absl::StrJoin(legal_actions, ", "),
                   "\n");
@@ -384,7 +774,8 @@ std::string CFRInfoStateValues::ToString() const {
   return str;
 }
 
-void CFRInfoStateValues::ApplyRegretMatching() {
+template <typename T>
+void BasicCFRInfoStateValues<T>::ApplyRegretMatching() {
   double sum_positive_regrets = 0.0;
   for (int aidx = 0; aidx < num_actions(); ++aidx) {
     if (cumulative_regrets[aidx] > 0) {
@@ -404,7 +795,9 @@ void CFRInfoStateValues::ApplyRegretMatching() {
   }
 }
 
-int CFRInfoStateValues::SampleActionIndex(double epsilon, double z) {
+template <typename T>
+int BasicCFRInfoStateValues<T>::SampleActionIndex(double epsilon,
+                                                  double z) const {
   double sum = 0;
   for (int aidx = 0; aidx < current_policy.size(); ++aidx) {
     double prob = epsilon * 1.0 / current_policy.size() +
@@ -425,21 +818,77 @@ int CFRInfoStateValues::SampleActionIndex(double epsilon, double z) {
 //  This must be done at the level of the information set, and thus cannot be
 //  done during the tree traversal (which is done on histories). It is thus
 //  performed as an additional step.
-void CFRSolverBase::ApplyRegretMatchingPlusReset() {
-  for (auto& entry : info_states_) {
-    for (int aidx = 0; aidx < entry.second.num_actions(); ++aidx) {
-      if (entry.second.cumulative_regrets[aidx] < 0) {
-        entry.second.cumulative_regrets[aidx] = 0;
+template <typename T>
+void BasicCFRSolverBase<T>::ApplyRegretMatchingPlusReset() {
+  for (int id = 0; id < info_states_.size(); ++id) {
+    for (T& regret : info_states_[id].cumulative_regrets) {
+      if (regret < 0) {
+        regret = 0;
       }
     }
   }
 }
 
-void CFRSolverBase::ApplyRegretMatching() {
-  for (auto& entry : info_states_) {
-    entry.second.ApplyRegretMatching();
+template <typename T>
+void BasicCFRSolverBase<T>::ApplyDiscounting(const std::optional<int>& player) {
+  const double t = iteration_;
+  const double positive_weight =
+      std::pow(t, discounting_->alpha) / (std::pow(t, discounting_->alpha) + 1);
+  const double negative_weight =
+      std::pow(t, discounting_->beta) / (std::pow(t, discounting_->beta) + 1);
+  const double policy_weight = std::pow(t / (t + 1), discounting_->gamma);
+  for (int id = 0; id < info_states_.size(); ++id) {
+    if (player && tree_.InfoStatePlayer(id) != *player) continue;
+    BasicCFRInfoStateValues<T> is_vals = info_states_[id];
+    for (T& regret : is_vals.cumulative_regrets) {
+      regret *= regret > 0 ? positive_weight : negative_weight;
+    }
+    for (T& prob : is_vals.cumulative_policy) {
+      prob *= policy_weight;
+    }
+  }
+}
+
+template <typename T>
+void BasicCFRSolverBase<T>::ApplyRegretMatching() {
+  for (int id = 0; id < info_states_.size(); ++id) {
+    BasicCFRInfoStateValues<T> is_vals = info_states_[id];
+    is_vals.ApplyRegretMatching();
+    if (pruning_) {
+      char* pruned = pruned_actions_.data() + pruned_action_offsets_[id];
+      for (int aidx = 0; aidx < is_vals.num_actions(); ++aidx) {
+        pruned[aidx] = is_vals.current_policy[aidx] == 0 &&
+                       is_vals.cumulative_regrets[aidx] <
+                           pruning_regret_threshold_;
+      }
+    }
   }
 }
 
+template struct BasicCFRInfoStateValues<double>;
+template struct BasicCFRInfoStateValues<float>;
+template class BasicCFRInfoStateValuesTable<double>;
+template class BasicCFRInfoStateValuesTable<float>;
+template int FindOrInsertInfoStateId(const State&, const std::string&,
+                                     const std::vector<Action>&, double,
+                                     BasicCFRInfoStateValuesTable<double>*,
+                                     CFRInfoStateKeys*);
+template int FindOrInsertInfoStateId(const State&, const std::string&,
+                                     const std::vector<Action>&, double,
+                                     BasicCFRInfoStateValuesTable<float>*,
+                                     CFRInfoStateKeys*);
+template BasicCFRInfoStateValues<double> FindOrInsertInfoStateValues(
+    const State&, const std::string&, const std::vector<Action>&, double,
+    BasicCFRInfoStateValuesTable<double>*, CFRInfoStateKeys*);
+template BasicCFRInfoStateValues<float> FindOrInsertInfoStateValues(
+    const State&, const std::string&, const std::vector<Action>&, double,
+    BasicCFRInfoStateValuesTable<float>*, CFRInfoStateKeys*);
+template class BasicCFRAveragePolicy<double>;
+template class BasicCFRAveragePolicy<float>;
+template class BasicCFRCurrentPolicy<double>;
+template class BasicCFRCurrentPolicy<float>;
+template class BasicCFRSolverBase<double>;
+template class BasicCFRSolverBase<float>;
+
 }  // namespace algorithms
 }  // namespace open_spiel
@@ -15,22 +15,34 @@
 #ifndef OPEN_SPIEL_ALGORITHMS_CFR_H_
 #define OPEN_SPIEL_ALGORITHMS_CFR_H_
 
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/container/flat_hash_map.h"
+#include "open_spiel/abseil-cpp/absl/strings/string_view.h"
+#include "open_spiel/abseil-cpp/absl/types/span.h"
+#include "open_spiel/algorithms/compiled_game_tree.h"
 #include "open_spiel/policy.h"
 #include "open_spiel/spiel.h"
 
 namespace open_spiel {
 namespace algorithms {
 
-// A basic structure to store the relevant quantities.
-struct CFRInfoStateValues {
-  CFRInfoStateValues() {}
-  CFRInfoStateValues(std::vector<Action> la, double init_value)
-      : legal_actions(la),
-        cumulative_regrets(la.size(), init_value),
-        cumulative_policy(la.size(), init_value),
-        current_policy(la.size(), 1.0 / la.size()) {}
-  CFRInfoStateValues(std::vector<Action> la) : CFRInfoStateValues(la, 0) {}
+// CFR tables, policies and solvers are templates over the type T in which the
+// regrets and policies are stored: double, or float to halve the memory they
+// take, at the cost of precision. The computations themselves are done in
+// double. The names without Basic are those for double, e.g. CFRSolver is
+// BasicCFRSolver<double>.
 
+// The values of an information state in a CFRInfoStateValuesTable. They point
+// into the storage of the table, so they can be updated in place.
+template <typename T>
+struct BasicCFRInfoStateValues {
   void ApplyRegretMatching();  // Fills current_policy.
   bool empty() const { return legal_actions.empty(); }
   int num_actions() const { return legal_actions.size(); }
@@ -40,59 +52,213 @@ struct CFRInfoStateValues {
 
   // Samples from current policy using randomly generated z, adding epsilon
   // exploration (mixing in uniform).
-  int SampleActionIndex(double epsilon, double z);
+  int SampleActionIndex(double epsilon, double z) const;
 
-  std::vector<Action> legal_actions;
-  std::vector<double> cumulative_regrets;
-  std::vector<double> cumulative_policy;
-  std::vector<double> current_policy;
+  absl::Span<const Action> legal_actions;
+  absl::Span<T> cumulative_regrets;
+  absl::Span<T> cumulative_policy;
+  absl::Span<T> current_policy;
 };
+using CFRInfoStateValues = BasicCFRInfoStateValues<double>;
 
-// A type for tables holding CFR values.
-using CFRInfoStateValuesTable =
-    std::unordered_map<std::string, CFRInfoStateValues>;
+// A table holding CFR values, keyed by State::InformationStateKey.
+//
+// The keys are only used to give each entry an integer id. The values of all
+// the entries are packed into a few large blocks, with the regrets, cumulative
+// policy and current policy of an entry next to each other, rather than in
+// separate vectors of their own. They never move once inserted.
+template <typename T>
+class BasicCFRInfoStateValuesTable {
+ public:
+  // Returns the id of the entry with this key, or -1 if there is none.
+  int Find(absl::string_view key) const {
+    auto it = ids_.find(key);
+    return it == ids_.end() ? -1 : it->second;
+  }
+
+  // Returns the id of the entry with this key, and whether it is new. New
+  // entries get these legal actions, cumulative values of init_value, and a
+  // uniform current policy.
+  std::pair<int, bool> Insert(const std::string& key,
+                              absl::Span<const Action> legal_actions,
+                              double init_value);
+
+  // The values of an entry, which stay valid as more are inserted.
+  BasicCFRInfoStateValues<T> operator[](int id) const {
+    const Entry& entry = entries_[id];
+    const int n = entry.num_actions;
+    return {{entry.legal_actions, static_cast<size_t>(n)},
+            {entry.values, static_cast<size_t>(n)},
+            {entry.values + n, static_cast<size_t>(n)},
+            {entry.values + 2 * n, static_cast<size_t>(n)}};
+  }
+
+  int size() const { return entries_.size(); }
+  bool empty() const { return entries_.empty(); }
+
+  // The ids of all the entries, by key.
+  const absl::flat_hash_map<std::string, int>& ids() const { return ids_; }
+
+ private:
+  struct Entry {
+    T* values;
+    Action* legal_actions;
+    int num_actions;
+  };
+
+  // Arrays allocated in large blocks, which are never freed before the arena.
+  template <typename U>
+  class Arena {
+   public:
+    U* Allocate(int size) {
+      if (size > remaining_) {
+        const int block_size = std::max(size, kBlockSize);
+        blocks_.push_back(std::make_unique<U[]>(block_size));
+        next_ = blocks_.back().get();
+        remaining_ = block_size;
+      }
+      U* allocated = next_;
+      next_ += size;
+      remaining_ -= size;
+      return allocated;
+    }
+
+   private:
+    static constexpr int kBlockSize = 1 << 16;
+    std::vector<std::unique_ptr<U[]>> blocks_;
+    U* next_ = nullptr;
+    int remaining_ = 0;
+  };
+
+  absl::flat_hash_map<std::string, int> ids_;
+  std::vector<Entry> entries_;
+  Arena<T> values_;
+  Arena<Action> legal_actions_;
+};
+using CFRInfoStateValuesTable = BasicCFRInfoStateValuesTable<double>;
+
+// Maps information state strings to the key of their entry in a
+// CFRInfoStateValuesTable, for the entries where the two differ. This lets the
+// policies below be queried by information state string.
+using CFRInfoStateKeys = std::unordered_map<std::string, std::string>;
+
+// Returns the id of the entry of `info_states` for the information state of the
+// current player at `state`, whose key is `info_state_key`, inserting one with
+// the given legal actions and initial value if it is missing. New entries are
+// recorded in `info_state_keys` if needed.
+template <typename T>
+int FindOrInsertInfoStateId(const State& state,
+                            const std::string& info_state_key,
+                            const std::vector<Action>& legal_actions,
+                            double init_value,
+                            BasicCFRInfoStateValuesTable<T>* info_states,
+                            CFRInfoStateKeys* info_state_keys);
+
+// The same, returning the values of the entry.
+template <typename T>
+BasicCFRInfoStateValues<T> FindOrInsertInfoStateValues(
+    const State& state, const std::string& info_state_key,
+    const std::vector<Action>& legal_actions, double init_value,
+    BasicCFRInfoStateValuesTable<T>* info_states,
+    CFRInfoStateKeys* info_state_keys);
+
+class CFRCheckpoint;  // See cfr_checkpoint.h.
 
 // A policy that extracts the average policy from the CFR table values, which
 // can be passed to tabular exploitability.
-class CFRAveragePolicy : public Policy {
+template <typename T>
+class BasicCFRAveragePolicy : public Policy {
  public:
   // Returns the average policy from the CFR values.
   // If a state/info state is not found, return the default policy for the
   // state/info state (or an empty policy if default_policy is nullptr).
   // If an info state has zero cumulative regret for all actions,
   // return a uniform policy.
-  CFRAveragePolicy(const CFRInfoStateValuesTable& info_states,
-                   std::shared_ptr<Policy> default_policy);
+  // `info_state_keys` is needed to query the policy by information state
+  // string when the table keys differ from these strings.
+  BasicCFRAveragePolicy(const BasicCFRInfoStateValuesTable<T>& info_states,
+                        std::shared_ptr<Policy> default_policy,
+                        const CFRInfoStateKeys* info_state_keys = nullptr);
+
+  // The same, reading the values straight from a mapped checkpoint file,
+  // which is kept open as long as the policy.
+  BasicCFRAveragePolicy(std::shared_ptr<const CFRCheckpoint> checkpoint,
+                        std::shared_ptr<Policy> default_policy);
+
   ActionsAndProbs GetStatePolicy(const State& state) const override;
   ActionsAndProbs GetStatePolicy(const std::string& info_state) const override;
 
+  // Writes the probabilities of the legal actions of the entry with this key
+  // (see State::InformationStateKey) to `probs`, which must have room for
+  // them, and returns the legal actions, all without allocating. Returns an
+  // empty span if there is no such entry: the default policy is not used.
+  absl::Span<const Action> GetStatePolicyByKey(absl::string_view key,
+                                               absl::Span<double> probs) const;
+
+  // Normalizes the average policy of every entry once, so that the lookups
+  // only copy it. The values it was computed from must not change afterwards,
+  // e.g. once training stops.
+  void CacheAveragePolicy();
+
  private:
-  const CFRInfoStateValuesTable& info_states_;
-  bool default_to_uniform_;
+  // Exactly one of these is set.
+  const BasicCFRInfoStateValuesTable<T>* info_states_;
+  std::shared_ptr<const CFRCheckpoint> checkpoint_;
+  const CFRInfoStateKeys* info_state_keys_;
   std::shared_ptr<Policy> default_policy_;
-  void GetStatePolicyFromInformationStateValues(
-      const CFRInfoStateValues& is_vals,
-      ActionsAndProbs* actions_and_probs) const;
+
+  // The normalized average policy of each entry, by id, and where each
+  // entry's starts, if cached.
+  std::vector<double> cached_probs_;
+  std::vector<int64_t> cached_offsets_;
+
+  int Find(absl::string_view key) const;
+  absl::Span<const Action> LegalActions(int id) const;
+  // Writes the average policy of the entry with this id.
+  void AveragePolicyFromId(int id, absl::Span<double> probs) const;
+  // Fills `actions_and_probs` from the entry with this id, returning false if
+  // there is none.
+  bool GetStatePolicyFromId(int id, ActionsAndProbs* actions_and_probs) const;
 };
+using CFRAveragePolicy = BasicCFRAveragePolicy<double>;
 
 // A policy that extracts the current policy from the CFR table values.
-class CFRCurrentPolicy : public Policy {
+template <typename T>
+class BasicCFRCurrentPolicy : public Policy {
  public:
   // Returns the current policy from the CFR values. If a default policy is
   // passed in, then it means that it is used if the lookup fails (use nullptr
   // to not use a default policy).
-  CFRCurrentPolicy(const CFRInfoStateValuesTable& info_states,
-                   std::shared_ptr<Policy> default_policy);
+  BasicCFRCurrentPolicy(const BasicCFRInfoStateValuesTable<T>& info_states,
+                        std::shared_ptr<Policy> default_policy,
+                        const CFRInfoStateKeys* info_state_keys = nullptr);
   ActionsAndProbs GetStatePolicy(const State& state) const override;
   ActionsAndProbs GetStatePolicy(const std::string& info_state) const override;
 
+  // As BasicCFRAveragePolicy::GetStatePolicyByKey.
+  absl::Span<const Action> GetStatePolicyByKey(absl::string_view key,
+                                               absl::Span<double> probs) const;
+
  private:
-  const CFRInfoStateValuesTable& info_states_;
+  const BasicCFRInfoStateValuesTable<T>& info_states_;
+  const CFRInfoStateKeys* info_state_keys_;
   std::shared_ptr<Policy> default_policy_;
   ActionsAndProbs GetStatePolicyFromInformationStateValues(
-      const CFRInfoStateValues& is_vals,
+      const BasicCFRInfoStateValues<T>& is_vals,
       ActionsAndProbs& actions_and_probs) const;
 };
+using CFRCurrentPolicy = BasicCFRCurrentPolicy<double>;
+
+// The weights of Discounted CFR: after each iteration t, the cumulative
+// positive regrets are multiplied by t^alpha / (t^alpha + 1), the negative ones
+// by t^beta / (t^beta + 1), and the cumulative policy by (t / (t + 1))^gamma.
+//
+// See https://arxiv.org/abs/1809.04040
+struct CFRDiscounting {
+  double alpha = 1.5;
+  double beta = 0;
+  double gamma = 2;
+};
 
 // Base class supporting different flavours of the Counterfactual Regret
 // Minimization (CFR) algorithm.
@@ -109,47 +275,101 @@ class CFRCurrentPolicy : public Policy {
 // CFR can be view as a policy iteration algorithm. Importantly, the policies
 // themselves do not converge to a Nash policy, but their average does.
 //
-class CFRSolverBase {
+// The game tree is compiled once, by the constructor, into a
+// CompiledGameTree, which every iteration then walks without any State.
+//
+// With num_threads > 1, each traversal of the tree is split into the subtrees
+// below its first few levels, at chance and decision nodes alike, which that
+// many threads (including the calling one) take in turn. The updates of each
+// subtree are buffered, and added to the table in a fixed order once they are
+// all done, so the results only depend on the game, not on the number of
+// threads or their timing. They can differ from the single threaded ones by
+// rounding.
+//
+// With regret-based pruning, traversals for a player skip the subtrees of its
+// actions which it doesn't play and whose cumulative regret is below a
+// threshold, so their regrets are left unchanged. Every few iterations, all
+// the actions are traversed again, so that pruned actions whose regret would
+// have grown back are found.
+//
+// see https://papers.nips.cc/paper/5841-regret-based-pruning-in-extensive-form-games.pdf
+template <typename T>
+class BasicCFRSolverBase {
  public:
-  CFRSolverBase(const Game& game, bool alternating_updates,
-                bool linear_averaging, bool regret_matching_plus);
-  virtual ~CFRSolverBase() = default;
+  BasicCFRSolverBase(const Game& game, bool alternating_updates,
+                     bool linear_averaging, bool regret_matching_plus,
+                     int num_threads = 1,
+                     std::optional<CFRDiscounting> discounting = std::nullopt);
+  virtual ~BasicCFRSolverBase() = default;
 
   // Performs one step of the CFR algorithm.
   virtual void EvaluateAndUpdatePolicy();
 
+  // Enables regret-based pruning, which only applies to alternating updates.
+  // After `warmup_iterations`, the actions with a cumulative regret below
+  // `regret_threshold` (which must be negative) and a current probability of
+  // zero are pruned, except on every `revisit_interval`-th iteration. Regret
+  // Matching+ never leaves negative regrets, so nothing is pruned with it.
+  void EnableRegretBasedPruning(double regret_threshold, int warmup_iterations,
+                                int revisit_interval);
+
   // Computes the average policy, containing the policy for all players.
   // The returned policy instance should only be used during the lifetime of
   // the CFRSolver object.
   std::unique_ptr<Policy> AveragePolicy() const {
-    return std::unique_ptr<Policy>(new CFRAveragePolicy(info_states_, nullptr));
+    return std::unique_ptr<Policy>(
+        new BasicCFRAveragePolicy<T>(info_states_, nullptr, &info_state_keys_));
+  }
+
+  // The same, with the average policy of every information state normalized
+  // once, for serving: the solver must not be updated while it is in use.
+  std::unique_ptr<BasicCFRAveragePolicy<T>> CachedAveragePolicy() const {
+    auto policy = std::make_unique<BasicCFRAveragePolicy<T>>(
+        info_states_, nullptr, &info_state_keys_);
+    policy->CacheAveragePolicy();
+    return policy;
   }
 
   // Computes the current policy, containing the policy for all players.
   // The returned policy instance should only be used during the lifetime of
   // the CFRSolver object.
   std::unique_ptr<Policy> CurrentPolicy() const {
-    return std::unique_ptr<Policy>(new CFRCurrentPolicy(info_states_, nullptr));
+    return std::unique_ptr<Policy>(
+        new BasicCFRCurrentPolicy<T>(info_states_, nullptr, &info_state_keys_));
   }
 
+  // Saves the values of all the information states, and the number of
+  // iterations, to a checkpoint file (see cfr_checkpoint.h). Loading it into
+  // a solver of the same kind for the same game resumes from there.
+  void SaveCheckpoint(const std::string& filename) const;
+  void LoadCheckpoint(const std::string& filename);
+
+  // Writes the average policy to a policy file (see policy_file.h), which
+  // MappedTabularPolicy serves without loading it.
+  void SaveAveragePolicy(const std::string& filename,
+                         bool single_precision = false) const;
+
  protected:
   const Game& game_;
 
   // Iteration to support linear_policy.
   int iteration_ = 0;
-  CFRInfoStateValuesTable info_states_;
+  BasicCFRInfoStateValuesTable<T> info_states_;
+  CFRInfoStateKeys info_state_keys_;
   const std::unique_ptr<State> root_state_;
+  const CompiledGameTree tree_;
   const std::vector<double> root_reach_probs_;
 
   // Compute the counterfactual regret and update the average policy for the
-  // specified player.
+  // specified player, below this node of tree_.
   // The optional `policy_overrides` can be used to specify for each player a
   // policy to use instead of the current policy. `policy_overrides=nullptr`
   // will disable this feature. Otherwise it should be a [num_players] vector,
   // and if `policy_overrides[p] != nullptr` it will be used instead of the
-  // current policy. This feature exists to support CFR-BR.
+  // current policy, through Policy::GetStatePolicy(const std::string&). This
+  // feature exists to support CFR-BR.
   std::vector<double> ComputeCounterFactualRegret(
-      const State& state, const std::optional<int>& alternating_player,
+      int node, const std::optional<int>& alternating_player,
       const std::vector<double>& reach_probabilities,
       const std::vector<const Policy*>* policy_overrides);
 
@@ -157,30 +377,41 @@ class CFRSolverBase {
   void ApplyRegretMatching();
 
  private:
+  // The options of a traversal, and where its updates go; see cfr.cc.
+  struct Traversal;
+
+  // The recursion of ComputeCounterFactualRegret, at `depth` actions below
+  // the node it was called with.
+  std::vector<double> ComputeCounterFactualRegret(
+      int node, const std::vector<double>& reach_probabilities, int depth,
+      Traversal* traversal);
   std::vector<double> ComputeCounterFactualRegretForActionProbs(
-      const State& state, const std::optional<int>& alternating_player,
-      const std::vector<double>& reach_probabilities, const int current_player,
-      const std::vector<double>& info_state_policy,
-      const std::vector<Action>& legal_actions,
-      std::vector<double>* child_values_out,
-      const std::vector<const Policy*>* policy_overrides);
+      int node, const std::vector<double>& reach_probabilities, int depth,
+      const int current_player, absl::Span<const double> info_state_policy,
+      const char* pruned, std::vector<double>* child_values_out,
+      Traversal* traversal);
 
-  void InitializeInfostateNodes(const State& state);
+  // The depth at which parallel traversals of the root are split.
+  int ParallelSplitDepth();
+
+  // Adds the information states of tree_ to the table, with the same ids.
+  void InitializeInfostateNodes();
 
   // Fills `info_state_policy` to be a [num_actions] vector of the probabilities
-  // found in `policy` at the given `info_state`.
+  // found in `policy` at this information state of tree_.
   void GetInfoStatePolicyFromPolicy(std::vector<double>* info_state_policy,
-                                    const std::vector<Action>& legal_actions,
                                     const Policy* policy,
-                                    const std::string& info_state) const;
-
-  // Get the policy at this information state. The probabilities are ordered in
-  // the same order as legal_actions.
-  std::vector<double> GetPolicy(const std::string& info_state,
-                                const std::vector<Action>& legal_actions);
+                                    int info_state) const;
 
   void ApplyRegretMatchingPlusReset();
 
+  // Discounts the cumulative values of this player's information states, or
+  // of all of them, at the end of an iteration of Discounted CFR.
+  void ApplyDiscounting(const std::optional<int>& player);
+
+  // Whether the traversals of this iteration prune, if enabled.
+  bool PruneThisIteration() const;
+
   std::vector<double> RegretMatching(const std::string& info_state,
                                      const std::vector<Action>& legal_actions);
 
@@ -191,20 +422,37 @@ class CFRSolverBase {
   const bool alternating_updates_;
   const bool linear_averaging_;
 
+  const std::optional<CFRDiscounting> discounting_;
+
   const int chance_player_;
+  const int num_threads_;
+  int parallel_split_depth_ = -1;  // Computed on first use.
+
+  // Regret-based pruning. The actions to prune are only updated along with
+  // the current policies, so they don't change during a traversal: those of
+  // an information state start at its offset.
+  bool pruning_ = false;
+  double pruning_regret_threshold_ = 0;
+  int pruning_warmup_iterations_ = 0;
+  int pruning_revisit_interval_ = 1;
+  std::vector<int> pruned_action_offsets_;
+  std::vector<char> pruned_actions_;
 };
+using CFRSolverBase = BasicCFRSolverBase<double>;
 
 // Standard CFR implementation.
 //
 // See https://poker.cs.ualberta.ca/publications/NIPS07-cfr.pdf
-class CFRSolver : public CFRSolverBase {
+template <typename T>
+class BasicCFRSolver : public BasicCFRSolverBase<T> {
  public:
-  explicit CFRSolver(const Game& game)
-      : CFRSolverBase(game,
-                      /*alternating_updates=*/true,
-                      /*linear_averaging=*/false,
-                      /*regret_matching_plus=*/false) {}
+  explicit BasicCFRSolver(const Game& game, int num_threads = 1)
+      : BasicCFRSolverBase<T>(game,
+                              /*alternating_updates=*/true,
+                              /*linear_averaging=*/false,
+                              /*regret_matching_plus=*/false, num_threads) {}
 };
+using CFRSolver = BasicCFRSolver<double>;
 
 // CFR+ implementation.
 //
@@ -214,14 +462,37 @@ class CFRSolver : public CFRSolverBase {
 // - use Regret Matching+ instead of Regret Matching.
 // - use alternating updates instead of simultaneous updates.
 // - use linear averaging.
-class CFRPlusSolver : public CFRSolverBase {
+template <typename T>
+class BasicCFRPlusSolver : public BasicCFRSolverBase<T> {
+ public:
+  BasicCFRPlusSolver(const Game& game, int num_threads = 1)
+      : BasicCFRSolverBase<T>(game,
+                              /*alternating_updates=*/true,
+                              /*linear_averaging=*/true,
+                              /*regret_matching_plus=*/true, num_threads) {}
+};
+using CFRPlusSolver = BasicCFRPlusSolver<double>;
+
+// Discounted CFR (DCFR) implementation.
+//
+// See https://arxiv.org/abs/1809.04040
+//
+// DCFR is CFR with alternating updates, whose cumulative regrets and policy
+// are discounted after each iteration, as described in CFRDiscounting. The
+// default weights are the ones recommended by the paper; alpha = 1, beta = 1
+// and gamma = 1 gives Linear CFR instead.
+template <typename T>
+class BasicDCFRSolver : public BasicCFRSolverBase<T> {
  public:
-  CFRPlusSolver(const Game& game)
-      : CFRSolverBase(game,
-                      /*alternating_updates=*/true,
-                      /*linear_averaging=*/true,
-                      /*regret_matching_plus=*/true) {}
+  BasicDCFRSolver(const Game& game, double alpha = 1.5, double beta = 0,
+                  double gamma = 2, int num_threads = 1)
+      : BasicCFRSolverBase<T>(game,
+                              /*alternating_updates=*/true,
+                              /*linear_averaging=*/false,
+                              /*regret_matching_plus=*/false, num_threads,
+                              CFRDiscounting{alpha, beta, gamma}) {}
 };
+using DCFRSolver = BasicDCFRSolver<double>;
 
 }  // namespace algorithms
 }  // namespace open_spiel
@@ -16,15 +16,16 @@
 
 #include "open_spiel/algorithms/cfr.h"
 #include "open_spiel/policy.h"
+#include "open_spiel/utils/trace.h"
 
 namespace open_spiel {
 namespace algorithms {
 
-CFRBRSolver::CFRBRSolver(const Game& game)
+CFRBRSolver::CFRBRSolver(const Game& game, int num_threads)
     : CFRSolverBase(game,
                     /*alternating_updates=*/false,
                     /*linear_averaging=*/false,
-                    /*regret_matching_plus=*/false),
+                    /*regret_matching_plus=*/false, num_threads),
       policy_overrides_(game.NumPlayers(), nullptr),
       uniform_policy_(GetUniformPolicy(game)) {
   for (int p = 0; p < game_.NumPlayers(); ++p) {
@@ -34,6 +35,7 @@ CFRBRSolver::CFRBRSolver(const Game& game)
 }
 
 void CFRBRSolver::EvaluateAndUpdatePolicy() {
+  OPEN_SPIEL_TRACE_SPAN("cfr", "Iteration");
   ++iteration_;
 
   std::vector<TabularPolicy> br_policies(game_.NumPlayers());
@@ -61,7 +63,7 @@ void CFRBRSolver::EvaluateAndUpdatePolicy() {
     }
 
     // Then collect regret and update p's average strategy.
-    ComputeCounterFactualRegret(*root_state_, p, root_reach_probs_,
+    ComputeCounterFactualRegret(CompiledGameTree::kRoot, p, root_reach_probs_,
                                 &policy_overrides_);
   }
   ApplyRegretMatching();
@@ -32,7 +32,7 @@ namespace algorithms {
 
 class CFRBRSolver : public CFRSolverBase {
  public:
-  explicit CFRBRSolver(const Game& game);
+  explicit CFRBRSolver(const Game& game, int num_threads = 1);
 
   void EvaluateAndUpdatePolicy() override;
 
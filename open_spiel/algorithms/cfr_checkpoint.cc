@@ -0,0 +1,335 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/cfr_checkpoint.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/algorithm/container.h"
+#include "open_spiel/abseil-cpp/absl/container/flat_hash_map.h"
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/file.h"
+
+namespace open_spiel {
+namespace algorithms {
+
+constexpr char kMagic[8] = {'O', 'S', 'C', 'F', 'R', 'C', 'K', 'P'};
+constexpr uint32_t kVersion = 1;
+
+// The sizes of all these are multiples of 8 bytes, so that every array of the
+// file stays aligned.
+struct CFRCheckpoint::Header {
+  char magic[8];
+  uint32_t version;
+  uint32_t reserved;
+  int64_t iteration;
+  int64_t num_entries;
+  int64_t num_actions;  // Of all the entries.
+  int64_t num_aliases;
+  int64_t string_bytes;
+};
+
+struct CFRCheckpoint::Entry {
+  int64_t key_offset;
+  // Where its legal actions start, and its values at three times that: the
+  // cumulative regrets, cumulative policy and current policy in turn.
+  int64_t action_offset;
+  int32_t key_size;
+  int32_t num_actions;
+};
+
+// An information state string which differs from the key of its entry.
+struct CFRCheckpoint::Alias {
+  int64_t string_offset;
+  int32_t string_size;
+  int32_t entry;
+};
+
+static_assert(sizeof(Action) == 8, "Actions are written as 8 bytes.");
+
+namespace {
+
+template <typename T>
+void WriteBytes(file::File* file, const T* data, int64_t size) {
+  SPIEL_CHECK_TRUE(file->Write(
+      absl::string_view(reinterpret_cast<const char*>(data), size * sizeof(T))));
+}
+
+template <typename T>
+void WriteValues(file::File* file, absl::Span<const T> values) {
+  if constexpr (std::is_same_v<T, double>) {
+    WriteBytes(file, values.data(), values.size());
+  } else {
+    const std::vector<double> converted(values.begin(), values.end());
+    WriteBytes(file, converted.data(), converted.size());
+  }
+}
+
+}  // namespace
+
+template <typename T>
+void SaveCFRCheckpoint(const std::string& filename,
+                       const BasicCFRInfoStateValuesTable<T>& info_states,
+                       const CFRInfoStateKeys& info_state_keys,
+                       int64_t iteration) {
+  std::vector<std::pair<absl::string_view, int>> keys(info_states.ids().begin(),
+                                                      info_states.ids().end());
+  std::sort(keys.begin(), keys.end());
+  std::vector<std::pair<absl::string_view, absl::string_view>> aliases(
+      info_state_keys.begin(), info_state_keys.end());
+  std::sort(aliases.begin(), aliases.end());
+
+  CFRCheckpoint::Header header;
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.reserved = 0;
+  header.iteration = iteration;
+  header.num_entries = keys.size();
+  header.num_actions = 0;
+  header.num_aliases = 0;
+  header.string_bytes = 0;
+
+  std::vector<CFRCheckpoint::Entry> entries;
+  absl::flat_hash_map<absl::string_view, int> entry_ids;
+  for (const auto& [key, id] : keys) {
+    const int num_actions = info_states[id].num_actions();
+    entry_ids[key] = entries.size();
+    entries.push_back({header.string_bytes, header.num_actions,
+                       static_cast<int32_t>(key.size()), num_actions});
+    header.string_bytes += key.size();
+    header.num_actions += num_actions;
+  }
+  std::vector<CFRCheckpoint::Alias> alias_entries;
+  for (const auto& [info_state, key] : aliases) {
+    auto it = entry_ids.find(key);
+    if (it == entry_ids.end()) continue;
+    alias_entries.push_back({header.string_bytes,
+                             static_cast<int32_t>(info_state.size()),
+                             it->second});
+    header.string_bytes += info_state.size();
+  }
+  header.num_aliases = alias_entries.size();
+
+  // Written next to the checkpoint first, so that a checkpoint is never seen
+  // half written, even by processes which have it mapped.
+  const std::string tmp_filename = absl::StrCat(filename, ".tmp");
+  {
+    file::File file(tmp_filename, "wb");
+    WriteBytes(&file, &header, 1);
+    WriteBytes(&file, entries.data(), entries.size());
+    WriteBytes(&file, alias_entries.data(), alias_entries.size());
+    for (const auto& [key, id] : keys) {
+      absl::Span<const Action> legal_actions = info_states[id].legal_actions;
+      WriteBytes(&file, legal_actions.data(), legal_actions.size());
+    }
+    for (const auto& [key, id] : keys) {
+      BasicCFRInfoStateValues<T> is_vals = info_states[id];
+      WriteValues<T>(&file, is_vals.cumulative_regrets);
+      WriteValues<T>(&file, is_vals.cumulative_policy);
+      WriteValues<T>(&file, is_vals.current_policy);
+    }
+    for (const auto& [key, id] : keys) {
+      WriteBytes(&file, key.data(), key.size());
+    }
+    for (const auto& [info_state, key] : aliases) {
+      if (entry_ids.contains(key)) {
+        WriteBytes(&file, info_state.data(), info_state.size());
+      }
+    }
+    SPIEL_CHECK_TRUE(file.Flush());
+  }
+  if (std::rename(tmp_filename.c_str(), filename.c_str()) != 0) {
+    SpielFatalError(absl::StrCat("Could not write the checkpoint ", filename));
+  }
+}
+
+CFRCheckpoint::CFRCheckpoint(const std::string& filename) {
+  const int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    SpielFatalError(absl::StrCat("Could not open the checkpoint ", filename));
+  }
+  struct stat file_stat;
+  SPIEL_CHECK_EQ(fstat(fd, &file_stat), 0);
+  size_ = file_stat.st_size;
+  if (size_ < static_cast<int64_t>(sizeof(Header))) {
+    close(fd);
+    SpielFatalError(absl::StrCat(filename, " is not a CFR checkpoint"));
+  }
+  void* data = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    SpielFatalError(absl::StrCat("Could not map the checkpoint ", filename));
+  }
+  data_ = static_cast<const char*>(data);
+
+  const Header* header = reinterpret_cast<const Header*>(data_);
+  if (std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0) {
+    SpielFatalError(absl::StrCat(filename, " is not a CFR checkpoint"));
+  }
+  if (header->version != kVersion) {
+    SpielFatalError(absl::StrCat("Unsupported version ", header->version,
+                                 " of the CFR checkpoint ", filename));
+  }
+  iteration_ = header->iteration;
+  num_entries_ = header->num_entries;
+  num_aliases_ = header->num_aliases;
+  const int64_t num_actions = header->num_actions;
+
+  const char* next = data_ + sizeof(Header);
+  entries_ = reinterpret_cast<const Entry*>(next);
+  next += num_entries_ * sizeof(Entry);
+  aliases_ = reinterpret_cast<const Alias*>(next);
+  next += num_aliases_ * sizeof(Alias);
+  legal_actions_ = reinterpret_cast<const Action*>(next);
+  next += num_actions * sizeof(Action);
+  values_ = reinterpret_cast<const double*>(next);
+  next += 3 * num_actions * sizeof(double);
+  strings_ = next;
+  next += header->string_bytes;
+  if (next - data_ != size_) {
+    SpielFatalError(absl::StrCat("The CFR checkpoint ", filename,
+                                 " has the wrong size: ", size_, " bytes instead"
+                                 " of ", next - data_));
+  }
+  for (int id = 0; id < num_entries_; ++id) {
+    const Entry& entry = entries_[id];
+    SPIEL_CHECK_LE(entry.key_offset + entry.key_size, header->string_bytes);
+    SPIEL_CHECK_LE(entry.action_offset + entry.num_actions, num_actions);
+  }
+  for (int i = 0; i < num_aliases_; ++i) {
+    const Alias& alias = aliases_[i];
+    SPIEL_CHECK_LE(alias.string_offset + alias.string_size,
+                   header->string_bytes);
+    SPIEL_CHECK_LT(alias.entry, num_entries_);
+  }
+}
+
+CFRCheckpoint::~CFRCheckpoint() {
+  munmap(const_cast<char*>(data_), size_);
+}
+
+absl::string_view CFRCheckpoint::String(int64_t offset, int64_t size) const {
+  return absl::string_view(strings_ + offset, size);
+}
+
+absl::string_view CFRCheckpoint::Key(int id) const {
+  return String(entries_[id].key_offset, entries_[id].key_size);
+}
+
+int CFRCheckpoint::Find(absl::string_view key) const {
+  int begin = 0;
+  int end = num_entries_;
+  while (begin < end) {
+    const int middle = begin + (end - begin) / 2;
+    if (Key(middle) < key) {
+      begin = middle + 1;
+    } else {
+      end = middle;
+    }
+  }
+  return begin < num_entries_ && Key(begin) == key ? begin : -1;
+}
+
+int CFRCheckpoint::FindInfoStateString(absl::string_view info_state) const {
+  int begin = 0;
+  int end = num_aliases_;
+  auto alias_string = [this](int i) {
+    return String(aliases_[i].string_offset, aliases_[i].string_size);
+  };
+  while (begin < end) {
+    const int middle = begin + (end - begin) / 2;
+    if (alias_string(middle) < info_state) {
+      begin = middle + 1;
+    } else {
+      end = middle;
+    }
+  }
+  if (begin < num_aliases_ && alias_string(begin) == info_state) {
+    return aliases_[begin].entry;
+  }
+  return Find(info_state);
+}
+
+absl::Span<const Action> CFRCheckpoint::LegalActions(int id) const {
+  return {legal_actions_ + entries_[id].action_offset,
+          static_cast<size_t>(entries_[id].num_actions)};
+}
+
+absl::Span<const double> CFRCheckpoint::Values(int id, int index) const {
+  const Entry& entry = entries_[id];
+  return {values_ + 3 * entry.action_offset + index * entry.num_actions,
+          static_cast<size_t>(entry.num_actions)};
+}
+
+absl::Span<const double> CFRCheckpoint::CumulativeRegrets(int id) const {
+  return Values(id, 0);
+}
+
+absl::Span<const double> CFRCheckpoint::CumulativePolicy(int id) const {
+  return Values(id, 1);
+}
+
+absl::Span<const double> CFRCheckpoint::CurrentPolicy(int id) const {
+  return Values(id, 2);
+}
+
+template <typename T>
+void CFRCheckpoint::CopyTo(BasicCFRInfoStateValuesTable<T>* info_states,
+                           CFRInfoStateKeys* info_state_keys) const {
+  for (int id = 0; id < num_entries_; ++id) {
+    const std::string key(Key(id));
+    auto [table_id, inserted] =
+        info_states->Insert(key, LegalActions(id), /*init_value=*/0);
+    BasicCFRInfoStateValues<T> is_vals = (*info_states)[table_id];
+    if (!inserted && is_vals.legal_actions != LegalActions(id)) {
+      SpielFatalError(absl::StrCat("The legal actions of ", key,
+                                   " differ from the checkpoint"));
+    }
+    absl::c_copy(CumulativeRegrets(id), is_vals.cumulative_regrets.begin());
+    absl::c_copy(CumulativePolicy(id), is_vals.cumulative_policy.begin());
+    absl::c_copy(CurrentPolicy(id), is_vals.current_policy.begin());
+  }
+  for (int i = 0; i < num_aliases_; ++i) {
+    const Alias& alias = aliases_[i];
+    info_state_keys->emplace(
+        std::string(String(alias.string_offset, alias.string_size)),
+        std::string(Key(alias.entry)));
+  }
+}
+
+template void SaveCFRCheckpoint(const std::string&,
+                                const BasicCFRInfoStateValuesTable<double>&,
+                                const CFRInfoStateKeys&, int64_t);
+template void SaveCFRCheckpoint(const std::string&,
+                                const BasicCFRInfoStateValuesTable<float>&,
+                                const CFRInfoStateKeys&, int64_t);
+template void CFRCheckpoint::CopyTo(BasicCFRInfoStateValuesTable<double>*,
+                                    CFRInfoStateKeys*) const;
+template void CFRCheckpoint::CopyTo(BasicCFRInfoStateValuesTable<float>*,
+                                    CFRInfoStateKeys*) const;
+
+}  // namespace algorithms
+}  // namespace open_spiel
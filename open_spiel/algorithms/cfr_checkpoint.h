@@ -0,0 +1,107 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_ALGORITHMS_CFR_CHECKPOINT_H_
+#define OPEN_SPIEL_ALGORITHMS_CFR_CHECKPOINT_H_
+
+#include <cstdint>
+#include <string>
+
+#include "open_spiel/abseil-cpp/absl/strings/string_view.h"
+#include "open_spiel/abseil-cpp/absl/types/span.h"
+#include "open_spiel/algorithms/cfr.h"
+#include "open_spiel/spiel.h"
+
+// Binary checkpoints of the values of a CFRInfoStateValuesTable, which can be
+// mapped into memory as they are, without being parsed. A solved policy can
+// then be served by many processes from one copy of it, in the page cache:
+// see CFRAveragePolicy.
+//
+// The file starts with a header, followed by the entries sorted by key, the
+// information state strings which differ from their keys (also sorted), the
+// legal actions and values of all the entries, and the bytes of the strings.
+// The numbers are written in the byte order of the machine, so a checkpoint
+// should be read on the same architecture that wrote it.
+namespace open_spiel {
+namespace algorithms {
+
+// Writes the table, with the number of iterations that produced it. The
+// values are always written as doubles, whatever their storage in the table.
+template <typename T>
+void SaveCFRCheckpoint(const std::string& filename,
+                       const BasicCFRInfoStateValuesTable<T>& info_states,
+                       const CFRInfoStateKeys& info_state_keys,
+                       int64_t iteration);
+
+// A checkpoint file, mapped read-only for as long as this lives. Its entries
+// are numbered in the order of their keys, which is not the order of their
+// ids in the table that was saved.
+class CFRCheckpoint {
+ public:
+  explicit CFRCheckpoint(const std::string& filename);
+  ~CFRCheckpoint();
+
+  CFRCheckpoint(const CFRCheckpoint&) = delete;
+  CFRCheckpoint& operator=(const CFRCheckpoint&) = delete;
+
+  int64_t iteration() const { return iteration_; }
+  int NumInfoStates() const { return num_entries_; }
+
+  // Returns the entry with this key, or with this information state string,
+  // or -1 if there is none. Both are a binary search over the file.
+  int Find(absl::string_view key) const;
+  int FindInfoStateString(absl::string_view info_state) const;
+
+  absl::string_view Key(int id) const;
+  absl::Span<const Action> LegalActions(int id) const;
+  absl::Span<const double> CumulativeRegrets(int id) const;
+  absl::Span<const double> CumulativePolicy(int id) const;
+  absl::Span<const double> CurrentPolicy(int id) const;
+
+  // Copies the values of all the entries into a table, inserting the ones it
+  // doesn't have yet. Those it already has must have the same legal actions.
+  template <typename T>
+  void CopyTo(BasicCFRInfoStateValuesTable<T>* info_states,
+              CFRInfoStateKeys* info_state_keys) const;
+
+ private:
+  template <typename T>
+  friend void SaveCFRCheckpoint(
+      const std::string& filename,
+      const BasicCFRInfoStateValuesTable<T>& info_states,
+      const CFRInfoStateKeys& info_state_keys, int64_t iteration);
+
+  struct Header;
+  struct Entry;
+  struct Alias;
+
+  absl::string_view String(int64_t offset, int64_t size) const;
+  absl::Span<const double> Values(int id, int index) const;
+
+  const char* data_ = nullptr;
+  int64_t size_ = 0;
+  int64_t iteration_;
+  int num_entries_;
+  int num_aliases_;
+  const Entry* entries_;
+  const Alias* aliases_;
+  const Action* legal_actions_;
+  const double* values_;
+  const char* strings_;
+};
+
+}  // namespace algorithms
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_ALGORITHMS_CFR_CHECKPOINT_H_
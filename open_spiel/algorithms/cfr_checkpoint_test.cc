@@ -0,0 +1,109 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/cfr_checkpoint.h"
+
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/algorithms/cfr.h"
+#include "open_spiel/algorithms/external_sampling_mccfr.h"
+#include "open_spiel/policy.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/tests/basic_tests.h"
+#include "open_spiel/utils/file.h"
+
+namespace open_spiel {
+namespace algorithms {
+namespace {
+
+std::string CheckpointFilename(const std::string& name) {
+  return absl::StrCat(file::GetTmpDir(), "/open_spiel-test-",
+                      std::rand(), "-", name);  // NOLINT
+}
+
+void CFRCheckpointTest_MappedAveragePolicy() {
+  std::shared_ptr<const Game> game = LoadGame("leduc_poker");
+  CFRSolver solver(*game);
+  for (int i = 0; i < 10; ++i) solver.EvaluateAndUpdatePolicy();
+  const std::string filename = CheckpointFilename("leduc.cfr");
+  solver.SaveCheckpoint(filename);
+
+  auto checkpoint = std::make_shared<const CFRCheckpoint>(filename);
+  SPIEL_CHECK_EQ(checkpoint->iteration(), 10);
+  SPIEL_CHECK_EQ(checkpoint->NumInfoStates(), 936);
+  SPIEL_CHECK_EQ(checkpoint->Find("not an information state"), -1);
+  for (int id = 0; id < checkpoint->NumInfoStates(); ++id) {
+    SPIEL_CHECK_EQ(checkpoint->Find(checkpoint->Key(id)), id);
+  }
+
+  CFRAveragePolicy mapped_policy(checkpoint, nullptr);
+  testing::CheckSamePolicies(*game, mapped_policy, *solver.AveragePolicy());
+  std::unique_ptr<State> state = game->NewInitialState();
+  state->ApplyAction(0);
+  state->ApplyAction(1);
+  SPIEL_CHECK_TRUE(mapped_policy.GetStatePolicy(*state) ==
+                   solver.AveragePolicy()->GetStatePolicy(*state));
+  SPIEL_CHECK_TRUE(file::Remove(filename));
+}
+
+void CFRCheckpointTest_ResumeCFR() {
+  std::shared_ptr<const Game> game = LoadGame("kuhn_poker");
+  CFRPlusSolver solver(*game);
+  for (int i = 0; i < 10; ++i) solver.EvaluateAndUpdatePolicy();
+  const std::string filename = CheckpointFilename("kuhn.cfr");
+  solver.SaveCheckpoint(filename);
+
+  // Linear averaging depends on the iteration, which must be restored too.
+  CFRPlusSolver resumed_solver(*game);
+  resumed_solver.LoadCheckpoint(filename);
+  for (int i = 0; i < 10; ++i) {
+    solver.EvaluateAndUpdatePolicy();
+    resumed_solver.EvaluateAndUpdatePolicy();
+  }
+  testing::CheckSamePolicies(*game, *resumed_solver.AveragePolicy(),
+                             *solver.AveragePolicy());
+  testing::CheckSamePolicies(*game, *resumed_solver.CurrentPolicy(),
+                             *solver.CurrentPolicy());
+  SPIEL_CHECK_TRUE(file::Remove(filename));
+}
+
+void CFRCheckpointTest_ResumeExternalSamplingMCCFR() {
+  std::shared_ptr<const Game> game = LoadGame("leduc_poker");
+  ExternalSamplingMCCFRSolver solver(*game);
+  for (int i = 0; i < 100; ++i) solver.RunIteration();
+  const std::string filename = CheckpointFilename("leduc.mccfr");
+  solver.SaveCheckpoint(filename);
+
+  ExternalSamplingMCCFRSolver resumed_solver(*game);
+  resumed_solver.LoadCheckpoint(filename);
+  testing::CheckSamePolicies(*game, *resumed_solver.AveragePolicy(),
+                             *solver.AveragePolicy());
+  SPIEL_CHECK_TRUE(file::Remove(filename));
+}
+
+}  // namespace
+}  // namespace algorithms
+}  // namespace open_spiel
+
+namespace algorithms = open_spiel::algorithms;
+
+int main(int argc, char** argv) {
+  algorithms::CFRCheckpointTest_MappedAveragePolicy();
+  algorithms::CFRCheckpointTest_ResumeCFR();
+  algorithms::CFRCheckpointTest_ResumeExternalSamplingMCCFR();
+}
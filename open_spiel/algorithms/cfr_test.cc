@@ -16,7 +16,11 @@
 
 #include <cmath>
 #include <iostream>
+#include <memory>
+#include <vector>
 
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/abseil-cpp/absl/types/span.h"
 #include "open_spiel/algorithms/expected_returns.h"
 #include "open_spiel/algorithms/history_tree.h"
 #include "open_spiel/algorithms/tabular_exploitability.h"
@@ -26,8 +30,10 @@
 #include "open_spiel/games/liars_dice.h"
 #include "open_spiel/games/matching_pennies_3p.h"
 #include "open_spiel/games/tic_tac_toe.h"
+#include "open_spiel/policy.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
+#include "open_spiel/tests/basic_tests.h"
 
 namespace open_spiel {
 namespace algorithms {
@@ -102,6 +108,167 @@ void CFRPlusTest_KuhnPoker() {
   CheckExploitabilityKuhnPoker(*game, *average_policy);
 }
 
+// Checks that the lookups by key agree with GetStatePolicy at every decision
+// node below the state.
+template <typename CFRPolicy>
+void CheckPolicyByKey(const State& state, const CFRPolicy& policy) {
+  if (state.IsTerminal()) return;
+  if (!state.IsChanceNode()) {
+    const ActionsAndProbs expected = policy.GetStatePolicy(state);
+    std::vector<double> probs(expected.size());
+    absl::Span<const Action> actions = policy.GetStatePolicyByKey(
+        state.InformationStateKey(), absl::MakeSpan(probs));
+    SPIEL_CHECK_EQ(actions.size(), expected.size());
+    for (int i = 0; i < expected.size(); ++i) {
+      SPIEL_CHECK_EQ(actions[i], expected[i].first);
+      SPIEL_CHECK_EQ(probs[i], expected[i].second);
+    }
+  }
+  for (Action action : state.LegalActions()) {
+    CheckPolicyByKey(*state.Child(action), policy);
+  }
+}
+
+void CFRTest_PolicyByKey() {
+  // Leduc poker has keys which differ from its information state strings.
+  std::shared_ptr<const Game> game = LoadGame("leduc_poker");
+  CFRSolver solver(*game);
+  for (int i = 0; i < 5; ++i) solver.EvaluateAndUpdatePolicy();
+  const std::unique_ptr<Policy> average_policy = solver.AveragePolicy();
+  const std::unique_ptr<Policy> current_policy = solver.CurrentPolicy();
+  std::unique_ptr<State> state = game->NewInitialState();
+  CheckPolicyByKey(*state,
+                   dynamic_cast<const CFRAveragePolicy&>(*average_policy));
+  CheckPolicyByKey(*state,
+                   dynamic_cast<const CFRCurrentPolicy&>(*current_policy));
+
+  std::vector<double> probs(3);
+  SPIEL_CHECK_TRUE(
+      solver.CachedAveragePolicy()
+          ->GetStatePolicyByKey("not a key", absl::MakeSpan(probs))
+          .empty());
+  const std::unique_ptr<CFRAveragePolicy> cached =
+      solver.CachedAveragePolicy();
+  CheckPolicyByKey(*state, *cached);
+  testing::CheckSamePolicies(*game, *cached, *average_policy, /*tolerance=*/0);
+}
+
+void CFRTest_KuhnPokerParallel() {
+  std::shared_ptr<const Game> game = LoadGame("kuhn_poker");
+  CFRSolver solver(*game, /*num_threads=*/4);
+  for (int i = 0; i < 300; i++) {
+    solver.EvaluateAndUpdatePolicy();
+  }
+  const std::unique_ptr<Policy> average_policy = solver.AveragePolicy();
+  CheckNashKuhnPoker(*game, *average_policy);
+}
+
+void CFRPlusTest_LeducPokerParallelIsDeterministic() {
+  std::shared_ptr<const Game> game = LoadGame("leduc_poker");
+  CFRPlusSolver solver(*game);
+  CFRPlusSolver two_threads_solver(*game, /*num_threads=*/2);
+  CFRPlusSolver four_threads_solver(*game, /*num_threads=*/4);
+  for (int i = 0; i < 5; i++) {
+    solver.EvaluateAndUpdatePolicy();
+    two_threads_solver.EvaluateAndUpdatePolicy();
+    four_threads_solver.EvaluateAndUpdatePolicy();
+  }
+  // The same whatever the number of threads, and up to rounding, the same as
+  // with one.
+  testing::CheckSamePolicies(*game, *four_threads_solver.AveragePolicy(),
+                             *two_threads_solver.AveragePolicy(),
+                             /*tolerance=*/0);
+  testing::CheckSamePolicies(*game, *four_threads_solver.CurrentPolicy(),
+                             *two_threads_solver.CurrentPolicy(),
+                             /*tolerance=*/0);
+  testing::CheckSamePolicies(*game, *four_threads_solver.AveragePolicy(),
+                             *solver.AveragePolicy(), /*tolerance=*/1e-9);
+}
+
+void DCFRTest_KuhnPoker() {
+  std::shared_ptr<const Game> game = LoadGame("kuhn_poker");
+  DCFRSolver solver(*game);
+  for (int i = 0; i < 200; i++) {
+    solver.EvaluateAndUpdatePolicy();
+  }
+  const std::unique_ptr<Policy> average_policy = solver.AveragePolicy();
+  CheckNashKuhnPoker(*game, *average_policy);
+  CheckExploitabilityKuhnPoker(*game, *average_policy);
+}
+
+void DCFRTest_LeducPokerConvergesFasterThanCFR() {
+  std::shared_ptr<const Game> game = LoadGame("leduc_poker");
+  CFRSolver cfr_solver(*game);
+  DCFRSolver dcfr_solver(*game);
+  for (int i = 0; i < 100; i++) {
+    cfr_solver.EvaluateAndUpdatePolicy();
+    dcfr_solver.EvaluateAndUpdatePolicy();
+  }
+  SPIEL_CHECK_LT(Exploitability(*game, *dcfr_solver.AveragePolicy()),
+                 Exploitability(*game, *cfr_solver.AveragePolicy()) / 4);
+}
+
+void CFRTest_LeducPokerWithPruning() {
+  std::shared_ptr<const Game> game = LoadGame("leduc_poker");
+  CFRSolver solver(*game);
+  CFRSolver pruned_solver(*game);
+  CFRSolver parallel_pruned_solver(*game, /*num_threads=*/4);
+  for (CFRSolver* pruning : {&pruned_solver, &parallel_pruned_solver}) {
+    pruning->EnableRegretBasedPruning(/*regret_threshold=*/-1,
+                                      /*warmup_iterations=*/10,
+                                      /*revisit_interval=*/10);
+  }
+  for (int i = 0; i < 100; i++) {
+    solver.EvaluateAndUpdatePolicy();
+    pruned_solver.EvaluateAndUpdatePolicy();
+    parallel_pruned_solver.EvaluateAndUpdatePolicy();
+  }
+  // Pruning changes the iterations a little, but not how well they converge.
+  SPIEL_CHECK_LE(Exploitability(*game, *pruned_solver.AveragePolicy()),
+                 1.01 * Exploitability(*game, *solver.AveragePolicy()));
+  testing::CheckSamePolicies(*game, *parallel_pruned_solver.AveragePolicy(),
+                             *pruned_solver.AveragePolicy(),
+                             /*tolerance=*/1e-9);
+}
+
+void CFRPlusTest_LeducPokerWithFloatValues() {
+  std::shared_ptr<const Game> game = LoadGame("leduc_poker");
+  CFRPlusSolver solver(*game);
+  BasicCFRPlusSolver<float> float_solver(*game);
+  for (int i = 0; i < 100; i++) {
+    solver.EvaluateAndUpdatePolicy();
+    float_solver.EvaluateAndUpdatePolicy();
+  }
+  // Only the rounding of the stored values differs.
+  testing::CheckSamePolicies(*game, *float_solver.AveragePolicy(),
+                             *solver.AveragePolicy(), /*tolerance=*/1e-4);
+  SPIEL_CHECK_LE(Exploitability(*game, *float_solver.AveragePolicy()),
+                 1.05 * Exploitability(*game, *solver.AveragePolicy()));
+}
+
+void CFRInfoStateValuesTableTest() {
+  CFRInfoStateValuesTable table;
+  SPIEL_CHECK_EQ(table.Find("a"), -1);
+  SPIEL_CHECK_TRUE(table.Insert("a", {3, 5}, 0.5) == std::make_pair(0, true));
+  CFRInfoStateValues values = table[0];
+
+  // Enough entries to need more blocks, which must not move the first one.
+  for (int i = 0; i < 100000; ++i) {
+    table.Insert(absl::StrCat("b", i), {0, 1, 2}, 0);
+  }
+  SPIEL_CHECK_TRUE(table.Insert("a", {0}, 0) == std::make_pair(0, false));
+  SPIEL_CHECK_EQ(table.size(), 100001);
+  SPIEL_CHECK_EQ(table.Find("b7"), 8);
+
+  values.cumulative_regrets[0] = -1;
+  values.ApplyRegretMatching();
+  SPIEL_CHECK_TRUE(table[0].legal_actions == absl::Span<const Action>({3, 5}));
+  SPIEL_CHECK_EQ(table[0].cumulative_policy[0], 0.5);
+  SPIEL_CHECK_EQ(table[0].current_policy[0], 0);
+  SPIEL_CHECK_EQ(table[0].current_policy[1], 1);
+  SPIEL_CHECK_EQ(table[8].current_policy[2], 1. / 3);
+}
+
 void CFRTest_KuhnPokerRunsWithThreePlayers(bool linear_averaging,
                                            bool regret_matching_plus,
                                            bool alternating_updates) {
@@ -192,6 +359,14 @@ int main(int argc, char** argv) {
   algorithms::CFRTest_KuhnPoker();
   algorithms::CFRTest_IIGoof4();
   algorithms::CFRPlusTest_KuhnPoker();
+  algorithms::CFRTest_KuhnPokerParallel();
+  algorithms::CFRTest_PolicyByKey();
+  algorithms::CFRInfoStateValuesTableTest();
+  algorithms::DCFRTest_KuhnPoker();
+  algorithms::DCFRTest_LeducPokerConvergesFasterThanCFR();
+  algorithms::CFRTest_LeducPokerWithPruning();
+  algorithms::CFRPlusTest_LeducPokerParallelIsDeterministic();
+  algorithms::CFRPlusTest_LeducPokerWithFloatValues();
   algorithms::CFRTest_KuhnPokerRunsWithThreePlayers(
       /*linear_averaging=*/false,
       /*regret_matching_plus=*/false,
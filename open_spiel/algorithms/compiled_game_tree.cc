@@ -0,0 +1,87 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/compiled_game_tree.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "open_spiel/algorithms/scoped_child.h"
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace algorithms {
+
+CompiledGameTree::CompiledGameTree(const State& root, bool keep_states)
+    : num_players_(root.NumPlayers()), keep_states_(keep_states) {
+  std::unique_ptr<State> state = root.Clone();
+  AddNodes(state.get());
+}
+
+int CompiledGameTree::AddNodes(State* state) {
+  const int index = nodes_.size();
+  if (state->IsTerminal()) {
+    std::vector<double> returns = state->Returns();
+    nodes_.push_back({kTerminalPlayerId, -1, static_cast<int>(returns_.size()),
+                      num_players_});
+    returns_.insert(returns_.end(), returns.begin(), returns.end());
+    return index;
+  }
+  if (state->IsSimultaneousNode()) {
+    SpielFatalError(
+        "Simultaneous moves not supported. Use "
+        "TurnBasedSimultaneousGame to convert the game first.");
+  }
+
+  const Player player = state->CurrentPlayer();
+  std::vector<Action> actions;
+  std::vector<double> probabilities;
+  int info_state = -1;
+  if (state->IsChanceNode()) {
+    for (const auto& [outcome, prob] : state->ChanceOutcomes()) {
+      actions.push_back(outcome);
+      probabilities.push_back(prob);
+    }
+  } else {
+    actions = state->LegalActions();
+    probabilities.resize(actions.size(), 0);
+    std::string key = state->InformationStateKey();
+    auto [it, inserted] = info_state_ids_.try_emplace(key, info_states_.size());
+    if (inserted) {
+      info_states_.push_back({index, std::move(key),
+                              state->InformationStateString(),
+                              keep_states_ ? state->Clone() : nullptr});
+    }
+    info_state = it->second;
+  }
+
+  // The children are numbered as they are added, after their edges.
+  const int begin = children_.size();
+  const int size = actions.size();
+  nodes_.push_back({player, info_state, begin, size});
+  children_.resize(begin + size);
+  actions_.insert(actions_.end(), actions.begin(), actions.end());
+  chance_probabilities_.insert(chance_probabilities_.end(),
+                               probabilities.begin(), probabilities.end());
+  for (int i = 0; i < size; ++i) {
+    ScopedChild child(state, actions[i]);
+    children_[begin + i] = AddNodes(child.get());
+  }
+  return index;
+}
+
+}  // namespace algorithms
+}  // namespace open_spiel
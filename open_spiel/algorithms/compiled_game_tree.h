@@ -0,0 +1,149 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_ALGORITHMS_COMPILED_GAME_TREE_H_
+#define OPEN_SPIEL_ALGORITHMS_COMPILED_GAME_TREE_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/container/flat_hash_map.h"
+#include "open_spiel/abseil-cpp/absl/types/span.h"
+#include "open_spiel/spiel.h"
+
+namespace open_spiel {
+namespace algorithms {
+
+// The game tree below a state, built once into flat arrays, for algorithms
+// which walk the whole tree over and over, like CFR. Walking it doesn't
+// involve any State: each node only keeps who plays there, its information
+// state, its children, the probabilities of chance outcomes, and the returns
+// of terminals.
+//
+// The nodes are numbered in depth-first order from the root, so the children
+// of a node always come after it, and the information states in the order
+// they are first reached.
+class CompiledGameTree {
+ public:
+  static constexpr int kRoot = 0;
+
+  // The tree below this state of a sequential game, which must be small
+  // enough to enumerate. With keep_states, one state of each information
+  // state is kept as well, for policies which need a State: see
+  // InfoStateState.
+  explicit CompiledGameTree(const State& root, bool keep_states = false);
+
+  int NumNodes() const { return nodes_.size(); }
+  int NumInfoStates() const { return info_states_.size(); }
+  int NumPlayers() const { return num_players_; }
+
+  // A player, kChancePlayerId or kTerminalPlayerId.
+  Player CurrentPlayer(int node) const { return nodes_[node].player; }
+  bool IsTerminal(int node) const {
+    return nodes_[node].player == kTerminalPlayerId;
+  }
+  bool IsChanceNode(int node) const {
+    return nodes_[node].player == kChancePlayerId;
+  }
+
+  // The information state of a decision node, or -1 for other nodes.
+  int InfoState(int node) const { return nodes_[node].info_state; }
+
+  // The children of a non-terminal node, for each of its legal actions or
+  // chance outcomes, with the probabilities of those at chance nodes.
+  absl::Span<const int> Children(int node) const {
+    return {children_.data() + nodes_[node].begin,
+            static_cast<size_t>(nodes_[node].size)};
+  }
+  absl::Span<const Action> Actions(int node) const {
+    return {actions_.data() + nodes_[node].begin,
+            static_cast<size_t>(nodes_[node].size)};
+  }
+  absl::Span<const double> ChanceProbabilities(int node) const {
+    SPIEL_CHECK_TRUE(IsChanceNode(node));
+    return {chance_probabilities_.data() + nodes_[node].begin,
+            static_cast<size_t>(nodes_[node].size)};
+  }
+
+  // The returns of each player at a terminal node.
+  absl::Span<const double> Returns(int node) const {
+    SPIEL_CHECK_TRUE(IsTerminal(node));
+    return {returns_.data() + nodes_[node].begin,
+            static_cast<size_t>(nodes_[node].size)};
+  }
+
+  // The player, legal actions, State::InformationStateKey and
+  // State::InformationStateString of an information state.
+  Player InfoStatePlayer(int info_state) const {
+    return nodes_[info_states_[info_state].node].player;
+  }
+  absl::Span<const Action> InfoStateActions(int info_state) const {
+    return Actions(info_states_[info_state].node);
+  }
+  const std::string& InfoStateKey(int info_state) const {
+    return info_states_[info_state].key;
+  }
+  const std::string& InfoStateString(int info_state) const {
+    return info_states_[info_state].string;
+  }
+
+  // The first state of an information state that was reached, if the tree
+  // was built with keep_states.
+  const State& InfoStateState(int info_state) const {
+    SPIEL_CHECK_TRUE(info_states_[info_state].state != nullptr);
+    return *info_states_[info_state].state;
+  }
+
+  // Returns the information state with this State::InformationStateKey, or
+  // -1 if there is none.
+  int FindInfoState(const std::string& key) const {
+    auto it = info_state_ids_.find(key);
+    return it == info_state_ids_.end() ? -1 : it->second;
+  }
+
+ private:
+  struct Node {
+    Player player;
+    int info_state;
+    // Where its children, actions and chance probabilities start, or its
+    // returns for a terminal node, and how many there are.
+    int begin;
+    int size;
+  };
+  struct InfoStateEntry {
+    int node;  // The first node in it.
+    std::string key;
+    std::string string;
+    std::unique_ptr<State> state;  // With keep_states.
+  };
+
+  // Adds the node of this state and the ones below it, and returns its index.
+  int AddNodes(State* state);
+
+  int num_players_;
+  bool keep_states_;
+  std::vector<Node> nodes_;
+  std::vector<int> children_;
+  std::vector<Action> actions_;
+  std::vector<double> chance_probabilities_;
+  std::vector<double> returns_;
+  std::vector<InfoStateEntry> info_states_;
+  absl::flat_hash_map<std::string, int> info_state_ids_;
+};
+
+}  // namespace algorithms
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_ALGORITHMS_COMPILED_GAME_TREE_H_
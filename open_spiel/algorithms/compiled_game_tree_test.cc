@@ -0,0 +1,98 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/compiled_game_tree.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "open_spiel/algorithms/expected_returns.h"
+#include "open_spiel/policy.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace algorithms {
+namespace {
+
+// Checks the nodes below `node` against the states below `state`.
+void CheckSameTree(const CompiledGameTree& tree, int node, State* state) {
+  SPIEL_CHECK_EQ(tree.CurrentPlayer(node), state->CurrentPlayer());
+  if (state->IsTerminal()) {
+    SPIEL_CHECK_TRUE(tree.Returns(node) ==
+                     absl::Span<const double>(state->Returns()));
+    return;
+  }
+  std::vector<Action> actions;
+  if (state->IsChanceNode()) {
+    SPIEL_CHECK_EQ(tree.InfoState(node), -1);
+    ActionsAndProbs outcomes = state->ChanceOutcomes();
+    for (int i = 0; i < outcomes.size(); ++i) {
+      actions.push_back(outcomes[i].first);
+      SPIEL_CHECK_EQ(tree.ChanceProbabilities(node)[i], outcomes[i].second);
+    }
+  } else {
+    actions = state->LegalActions();
+    const int info_state = tree.InfoState(node);
+    SPIEL_CHECK_EQ(tree.FindInfoState(state->InformationStateKey()),
+                   info_state);
+    SPIEL_CHECK_EQ(tree.InfoStateString(info_state),
+                   state->InformationStateString());
+    SPIEL_CHECK_EQ(tree.InfoStatePlayer(info_state), state->CurrentPlayer());
+  }
+  SPIEL_CHECK_TRUE(tree.Actions(node) == absl::Span<const Action>(actions));
+  for (int i = 0; i < actions.size(); ++i) {
+    const int child = tree.Children(node)[i];
+    SPIEL_CHECK_GT(child, node);
+    std::unique_ptr<State> child_state = state->Child(actions[i]);
+    CheckSameTree(tree, child, child_state.get());
+  }
+}
+
+void CompiledGameTreeTest_KuhnPoker() {
+  std::shared_ptr<const Game> game = LoadGame("kuhn_poker");
+  std::unique_ptr<State> root = game->NewInitialState();
+  CompiledGameTree tree(*root);
+  SPIEL_CHECK_EQ(tree.NumNodes(), 58);
+  SPIEL_CHECK_EQ(tree.NumInfoStates(), 12);
+  SPIEL_CHECK_EQ(tree.NumPlayers(), 2);
+  CheckSameTree(tree, CompiledGameTree::kRoot, root.get());
+}
+
+void CompiledGameTreeTest_ExpectedReturns(const std::string& game_name) {
+  std::shared_ptr<const Game> game = LoadGame(game_name);
+  std::unique_ptr<State> root = game->NewInitialState();
+  CompiledGameTree tree(*root);
+  TabularPolicy policy = GetUniformPolicy(*game);
+  std::vector<double> expected = ExpectedReturns(*root, policy, -1);
+  std::vector<double> returns = ExpectedReturns(tree, policy);
+  SPIEL_CHECK_EQ(returns.size(), expected.size());
+  for (int p = 0; p < returns.size(); ++p) {
+    SPIEL_CHECK_FLOAT_NEAR(returns[p], expected[p], 1e-12);
+  }
+}
+
+}  // namespace
+}  // namespace algorithms
+}  // namespace open_spiel
+
+namespace algorithms = open_spiel::algorithms;
+
+int main(int argc, char** argv) {
+  algorithms::CompiledGameTreeTest_KuhnPoker();
+  algorithms::CompiledGameTreeTest_ExpectedReturns("kuhn_poker");
+  algorithms::CompiledGameTreeTest_ExpectedReturns("leduc_poker");
+  algorithms::CompiledGameTreeTest_ExpectedReturns("kuhn_poker(players=3)");
+}
@@ -0,0 +1,145 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/continual_resolving.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/time/clock.h"
+#include "open_spiel/abseil-cpp/absl/time/time.h"
+#include "open_spiel/algorithms/public_tree_cfr.h"
+#include "open_spiel/games/universal_poker.h"
+#include "open_spiel/games/universal_poker/logic/card_set.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace algorithms {
+
+using universal_poker::UniversalPokerGame;
+using universal_poker::UniversalPokerState;
+using universal_poker::logic::CardSet;
+
+ContinualResolvingBot::ContinualResolvingBot(const Game& game, Player player,
+                                             ContinualResolvingOptions options)
+    : game_(game.shared_from_this()),
+      player_(player),
+      options_(std::move(options)),
+      rng_(options_.seed) {
+  const auto* poker_game = dynamic_cast<const UniversalPokerGame*>(&game);
+  if (poker_game == nullptr || game.NumPlayers() != 2) {
+    SpielFatalError(
+        "ContinualResolvingBot only supports two player universal_poker.");
+  }
+  SPIEL_CHECK_GE(options_.max_iterations, 1);
+  Restart();
+}
+
+void ContinualResolvingBot::Restart() {
+  // The hands are those the solver enumerates.
+  const auto& acpc_game =
+      *static_cast<const UniversalPokerGame&>(*game_).GetACPCGame();
+  const int num_hands =
+      CardSet(acpc_game.NumSuitsDeck(), acpc_game.NumRanksDeck())
+          .SampleCards(acpc_game.GetNbHoleCardsRequired())
+          .size();
+  ranges_.assign(2, std::vector<double>(num_hands, 1.0));
+  num_actions_followed_ = 0;
+  solver_.reset();
+  last_iterations_ = 0;
+}
+
+// The ranges are rebuilt from the history of the next state the bot plays.
+void ContinualResolvingBot::RestartAt(const State& state) { Restart(); }
+
+void ContinualResolvingBot::UpdateRanges(const State& state) {
+  const std::vector<Action>& history = state.FullHistory();
+  std::unique_ptr<State> replay = game_->NewInitialState();
+  for (int i = 0; i < history.size(); ++i) {
+    if (i >= num_actions_followed_ && solver_ != nullptr &&
+        !replay->IsChanceNode()) {
+      std::vector<double>& range = ranges_[replay->CurrentPlayer()];
+      const std::vector<double> probs =
+          solver_->AverageActionProbabilities(*replay, history[i]);
+      for (int hand = 0; hand < range.size(); ++hand) {
+        range[hand] *= probs[hand];
+      }
+
+      // The player took an action which none of its hands would have with
+      // the board, i.e. it doesn't play as solved: start again from all the
+      // hands.
+      const auto& poker_state =
+          static_cast<const UniversalPokerState&>(*replay);
+      const uint64_t board = poker_state.board_cards_.cs.cards;
+      const std::vector<uint64_t>& hands = solver_->Hands();
+      bool reachable = false;
+      for (int hand = 0; hand < range.size() && !reachable; ++hand) {
+        reachable = range[hand] > 0 && !(hands[hand] & board);
+      }
+      if (!reachable) std::fill(range.begin(), range.end(), 1.0);
+    }
+    replay->ApplyAction(history[i]);
+  }
+  num_actions_followed_ = history.size();
+}
+
+ActionsAndProbs ContinualResolvingBot::Resolve(const State& state,
+                                               absl::Time deadline) {
+  SPIEL_CHECK_EQ(state.CurrentPlayer(), player_);
+  UpdateRanges(state);
+  solver_ = std::make_unique<PublicTreeCFRSolver>(
+      state, ranges_, options_.max_rounds, options_.leaf_values);
+  deadline = std::min(deadline, absl::Now() + options_.max_time);
+  last_iterations_ = 0;
+  do {
+    solver_->EvaluateAndUpdatePolicy();
+    ++last_iterations_;
+  } while (last_iterations_ < options_.max_iterations &&
+           absl::Now() < deadline);
+  return solver_->AveragePolicy()->GetStatePolicy(state);
+}
+
+ActionsAndProbs ContinualResolvingBot::GetPolicy(const State& state) {
+  return Resolve(state, absl::InfiniteFuture());
+}
+
+std::pair<ActionsAndProbs, Action> ContinualResolvingBot::StepWithPolicy(
+    const State& state) {
+  ActionsAndProbs policy = GetPolicy(state);
+  const Action action =
+      SampleAction(policy,
+                   std::uniform_real_distribution<double>(0., 1.)(rng_))
+          .first;
+  return {std::move(policy), action};
+}
+
+Action ContinualResolvingBot::Step(const State& state) {
+  return StepWithPolicy(state).second;
+}
+
+Action ContinualResolvingBot::StepUntil(const State& state,
+                                        absl::Time deadline) {
+  const ActionsAndProbs policy = Resolve(state, deadline);
+  return SampleAction(policy,
+                      std::uniform_real_distribution<double>(0., 1.)(rng_))
+      .first;
+}
+
+}  // namespace algorithms
+}  // namespace open_spiel
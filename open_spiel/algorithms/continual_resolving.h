@@ -0,0 +1,104 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_ALGORITHMS_CONTINUAL_RESOLVING_H_
+#define OPEN_SPIEL_ALGORITHMS_CONTINUAL_RESOLVING_H_
+
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/time/time.h"
+#include "open_spiel/algorithms/public_tree_cfr.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_bots.h"
+
+// A bot for two player universal_poker games which plays without a
+// precomputed strategy: at each decision, it solves the subgame at the
+// current public state with PublicTreeCFRSolver, within a budget of
+// iterations and time, and plays its average policy there. The subgames can
+// be limited to a few betting rounds, with the values of their leaves given
+// by a PublicTreeLeafValues function, as in DeepStack (Moravcik et al.,
+// https://arxiv.org/abs/1701.01724).
+//
+// The ranges of both players' hands at the root of each subgame, i.e. their
+// reach probabilities, follow the actions played since the game started under
+// the policies of the previous subgames. The opponent is thus assumed to play
+// as those solved: this is re-solving without DeepStack's gadget for the
+// opponent's counterfactual values, which doesn't guarantee that the bot is
+// not exploited more than its previous subgames were.
+//
+// Note: this is only built with BUILD_WITH_ACPC.
+namespace open_spiel {
+namespace algorithms {
+
+struct ContinualResolvingOptions {
+  // The betting rounds after the current one in each subgame, or all of
+  // them when negative.
+  int max_rounds = -1;
+  // The values of the leaves of the depth-limited subgames. Without them, the
+  // players check or call to the end of the game past the last round.
+  PublicTreeLeafValues leaf_values;
+  // Each subgame is solved until either limit is reached, after at least one
+  // iteration.
+  int max_iterations = 1000;
+  absl::Duration max_time = absl::InfiniteDuration();
+  int seed = 0;
+};
+
+class ContinualResolvingBot : public Bot {
+ public:
+  ContinualResolvingBot(const Game& game, Player player,
+                        ContinualResolvingOptions options);
+
+  Action Step(const State& state) override;
+  // Like Step, but the solving also stops at the deadline.
+  Action StepUntil(const State& state, absl::Time deadline) override;
+  void Restart() override;
+  void RestartAt(const State& state) override;
+
+  bool ProvidesPolicy() override { return true; }
+  ActionsAndProbs GetPolicy(const State& state) override;
+  std::pair<ActionsAndProbs, Action> StepWithPolicy(
+      const State& state) override;
+
+  // The iterations run on the last subgame.
+  int LastIterations() const { return last_iterations_; }
+
+ private:
+  // Solves the subgame at the state, after following its actions in the
+  // ranges, and returns its policy for the state.
+  ActionsAndProbs Resolve(const State& state, absl::Time deadline);
+  // Updates the ranges with the actions played since the last subgame.
+  void UpdateRanges(const State& state);
+
+  std::shared_ptr<const Game> game_;
+  const Player player_;
+  const ContinualResolvingOptions options_;
+  std::mt19937 rng_;
+
+  // The reach of each player's hands, in the order of the solver's hands, and
+  // how much of the history it follows.
+  std::vector<std::vector<double>> ranges_;
+  int num_actions_followed_ = 0;
+  // The last subgame, which gave the policies of the actions played since.
+  std::unique_ptr<PublicTreeCFRSolver> solver_;
+  int last_iterations_ = 0;
+};
+
+}  // namespace algorithms
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_ALGORITHMS_CONTINUAL_RESOLVING_H_
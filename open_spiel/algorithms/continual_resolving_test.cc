@@ -0,0 +1,100 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/continual_resolving.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/time/time.h"
+#include "open_spiel/algorithms/evaluate_bots.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_bots.h"
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace algorithms {
+namespace {
+
+// A Leduc-like game, with one board card in the second round, out of six
+// cards.
+std::shared_ptr<const Game> SmallLimitGame() {
+  return LoadGame(
+      "universal_poker",
+      {{"betting", GameParameter(std::string("limit"))},
+       {"numPlayers", GameParameter(2)},
+       {"numRounds", GameParameter(2)},
+       {"blind", GameParameter(std::string("1 1"))},
+       {"raiseSize", GameParameter(std::string("2 4"))},
+       {"firstPlayer", GameParameter(std::string("1 1"))},
+       {"maxRaises", GameParameter(std::string("2 2"))},
+       {"numSuits", GameParameter(2)},
+       {"numRanks", GameParameter(3)},
+       {"numHoleCards", GameParameter(1)},
+       {"numBoardCards", GameParameter(std::string("0 1"))},
+       {"bettingAbstraction", GameParameter(std::string("fullgame"))}});
+}
+
+// The bot beats a random one, whichever seat it plays.
+void BeatsRandomTest(int max_rounds) {
+  std::shared_ptr<const Game> game = SmallLimitGame();
+  ContinualResolvingOptions options;
+  options.max_rounds = max_rounds;
+  options.max_iterations = 50;
+  double total_return = 0;
+  constexpr int kNumGames = 100;
+  for (int i = 0; i < kNumGames; ++i) {
+    const Player player = i % 2;
+    options.seed = i;
+    ContinualResolvingBot bot(*game, player, options);
+    std::unique_ptr<Bot> random_bot = MakeUniformRandomBot(1 - player, i);
+    std::vector<Bot*> bots = {&bot, random_bot.get()};
+    if (player == 1) std::swap(bots[0], bots[1]);
+    std::unique_ptr<State> state = game->NewInitialState();
+    total_return += EvaluateBots(state.get(), bots, i)[player];
+    SPIEL_CHECK_GE(bot.LastIterations(), 1);
+    SPIEL_CHECK_LE(bot.LastIterations(), options.max_iterations);
+  }
+  SPIEL_CHECK_GT(total_return / kNumGames, 0);
+}
+
+// The solving stops at the time limit, after at least one iteration.
+void TimeLimitTest() {
+  std::shared_ptr<const Game> game = SmallLimitGame();
+  ContinualResolvingOptions options;
+  options.max_iterations = 1000000;
+  options.max_time = absl::Milliseconds(10);
+  ContinualResolvingBot bot(*game, /*player=*/0, options);
+  std::unique_ptr<State> state = game->NewInitialState();
+  while (state->IsChanceNode()) state->ApplyAction(state->LegalActions()[0]);
+  const Action action = bot.Step(*state);
+  SPIEL_CHECK_GE(bot.LastIterations(), 1);
+  SPIEL_CHECK_LT(bot.LastIterations(), options.max_iterations);
+  const std::vector<Action> legal_actions = state->LegalActions();
+  SPIEL_CHECK_TRUE(std::find(legal_actions.begin(), legal_actions.end(),
+                             action) != legal_actions.end());
+}
+
+}  // namespace
+}  // namespace algorithms
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  open_spiel::algorithms::BeatsRandomTest(/*max_rounds=*/-1);
+  open_spiel::algorithms::BeatsRandomTest(/*max_rounds=*/0);
+  open_spiel::algorithms::TimeLimitTest();
+}
@@ -14,20 +14,27 @@
 
 #include "open_spiel/algorithms/deterministic_policy.h"
 
+#include <algorithm>
 #include <climits>
+#include <limits>
+#include <string>
+#include <utility>
 
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
 #include "open_spiel/algorithms/get_legal_actions_map.h"
 
 namespace open_spiel {
 namespace algorithms {
 
-int64_t NumDeterministicPolicies(const Game& game, Player player) {
+int64_t NumDeterministicPolicies(const Game& game, Player player,
+                                 int num_threads) {
+  const LegalActionsTable table =
+      GetLegalActionsTable(game, /*depth_limit=*/-1, player, num_threads);
   int64_t num_policies = 1;
-  std::unordered_map<std::string, std::vector<Action>> legal_actions_map =
-      GetLegalActionsMap(game, -1, player);
-  for (const auto& infostate_str_actions : legal_actions_map) {
-    int64_t num_actions = infostate_str_actions.second.size();
-    SPIEL_CHECK_GT(num_actions, 0);
+  for (const auto& [key_hash, list] : table.Lists()) {
+    const int num_actions = table.Actions(list).size();
+    // Players without actions at a simultaneous node have no choice there.
+    if (num_actions == 0) continue;
 
     // Check for integer overflow.
     if (num_policies > INT64_MAX / num_actions) {
@@ -100,6 +107,24 @@ void DeterministicTabularPolicy::ResetDefaultPolicy() {
   }
 }
 
+void DeterministicTabularPolicy::SetPolicy(int64_t index) {
+  SPIEL_CHECK_GE(index, 0);
+  for (auto& info_state_entry : table_) {
+    LegalsWithIndex& entry = info_state_entry.second;
+    entry.index = index % entry.legal_actions_.size();
+    index /= entry.legal_actions_.size();
+  }
+  SPIEL_CHECK_EQ(index, 0);
+}
+
+int64_t DeterministicTabularPolicy::PolicyIndex() const {
+  int64_t index = 0;
+  for (auto iter = table_.rbegin(); iter != table_.rend(); ++iter) {
+    index = index * iter->second.legal_actions_.size() + iter->second.index;
+  }
+  return index;
+}
+
 void DeterministicTabularPolicy::CreateTable(const Game& game, Player player) {
   std::unordered_map<std::string, std::vector<Action>> legal_actions_map =
       GetLegalActionsMap(game, -1, player);
@@ -119,5 +144,72 @@ std::string DeterministicTabularPolicy::ToString(
   return str;
 }
 
+IndexedDeterministicPolicies::IndexedDeterministicPolicies(const Game& game,
+                                                           Player player) {
+  std::unordered_map<std::string, std::vector<Action>> legal_actions_map =
+      GetLegalActionsMap(game, -1, player);
+  info_states_.reserve(legal_actions_map.size());
+  for (auto& [info_state, legal_actions] : legal_actions_map) {
+    SPIEL_CHECK_FALSE(legal_actions.empty());
+    info_states_.push_back(
+        Entry{info_state, std::move(legal_actions), /*radix=*/0});
+  }
+  std::sort(info_states_.begin(), info_states_.end(),
+            [](const Entry& a, const Entry& b) {
+              return a.name < b.name;
+            });
+
+  // Past 2^63 policies, the remaining digits are always 0.
+  constexpr int64_t kMax = std::numeric_limits<int64_t>::max();
+  num_policies_ = 1;
+  for (int i = 0; i < info_states_.size(); ++i) {
+    Entry& info_state = info_states_[i];
+    indices_[info_state.name] = i;
+    const int64_t num_actions = info_state.legal_actions.size();
+    if (num_policies_ < 0) {
+      info_state.radix = kMax;
+    } else {
+      info_state.radix = num_policies_;
+      num_policies_ =
+          num_policies_ > kMax / num_actions ? -1 : num_policies_ * num_actions;
+    }
+  }
+}
+
+int IndexedDeterministicPolicies::InfoStateIndex(
+    const std::string& info_state) const {
+  auto iter = indices_.find(info_state);
+  return iter == indices_.end() ? -1 : iter->second;
+}
+
+std::string IndexedDeterministicPolicies::PolicyToString(
+    int64_t policy, const std::string& delimiter) const {
+  std::string str = "";
+  for (int i = 0; i < info_states_.size(); ++i) {
+    absl::StrAppend(&str, info_states_[i].name, " ", delimiter, " ",
+                    "action = ", GetAction(policy, i), "\n");
+  }
+  return str;
+}
+
+ActionsAndProbs IndexedDeterministicPolicy::GetStatePolicy(
+    const std::string& info_state) const {
+  const int index = policies_->InfoStateIndex(info_state);
+  SPIEL_CHECK_GE(index, 0);
+  const Action policy_action = policies_->GetAction(index_, index);
+  ActionsAndProbs state_policy;
+  for (Action action : policies_->LegalActions(index)) {
+    state_policy.emplace_back(action, action == policy_action ? 1.0 : 0.0);
+  }
+  return state_policy;
+}
+
+Action IndexedDeterministicPolicy::GetAction(
+    const std::string& info_state) const {
+  const int index = policies_->InfoStateIndex(info_state);
+  SPIEL_CHECK_GE(index, 0);
+  return policies_->GetAction(index_, index);
+}
+
 }  // namespace algorithms
 }  // namespace open_spiel
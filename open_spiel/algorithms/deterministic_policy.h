@@ -16,9 +16,13 @@
 #define OPEN_SPIEL_ALGORITHMS_DETERMINISTIC_POLICY_H_
 
 #include <algorithm>
+#include <cstdint>
 #include <iterator>
-#include <string>
 #include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "open_spiel/policy.h"
@@ -29,8 +33,11 @@ namespace open_spiel {
 namespace algorithms {
 
 // Returns the number of deterministic policies for this player in this game,
-// if the number is less than 2^64-1. Otherwise, returns -1.
-int64_t NumDeterministicPolicies(const Game& game, Player player);
+// if the number is less than 2^64-1. Otherwise, returns -1. The information
+// states are told apart by State::InformationStateKey, and the game is
+// traversed on num_threads threads.
+int64_t NumDeterministicPolicies(const Game& game, Player player,
+                                 int num_threads = 1);
 
 // An simple container object used to store the legal actions (and chosen
 // action) for each information state.
@@ -97,6 +104,11 @@ class DeterministicTabularPolicy : public Policy {
   // list).
   void ResetDefaultPolicy();
 
+  // Sets the policy to the one at the given position in the total order
+  // defined above, or returns the position of the policy.
+  void SetPolicy(int64_t index);
+  int64_t PolicyIndex() const;
+
   // Returns a string representation of the policy, using the specified
   // delimiter to separate information state and action.
   std::string ToString(const std::string& delimiter) const;
@@ -108,6 +120,74 @@ class DeterministicTabularPolicy : public Policy {
   Player player_;
 };
 
+// The deterministic policies of a player, in the total order of
+// DeterministicTabularPolicy, indexed rather than enumerated: the information
+// states are kept in a vector in that order, each with the place value of its
+// digit in the mixed-radix index of a policy, so that the action of any policy
+// is read off its index without building a table per policy.
+class IndexedDeterministicPolicies {
+ public:
+  IndexedDeterministicPolicies(const Game& game, Player player);
+
+  // The number of policies, or -1 if there are 2^63 or more, in which case
+  // only the indices below 2^63 can be used.
+  int64_t NumPolicies() const { return num_policies_; }
+
+  int NumInfoStates() const { return info_states_.size(); }
+  const std::string& InfoState(int info_state) const {
+    return info_states_[info_state].name;
+  }
+  const std::vector<Action>& LegalActions(int info_state) const {
+    return info_states_[info_state].legal_actions;
+  }
+  // The position of the information state in the order, or -1 if the player
+  // never acts in it.
+  int InfoStateIndex(const std::string& info_state) const;
+
+  // The action of the policy at the information state.
+  Action GetAction(int64_t policy, int info_state) const {
+    const Entry& entry = info_states_[info_state];
+    return entry.legal_actions[policy / entry.radix %
+                               entry.legal_actions.size()];
+  }
+
+  // The policy as DeterministicTabularPolicy::ToString.
+  std::string PolicyToString(int64_t policy,
+                             const std::string& delimiter) const;
+
+ private:
+  struct Entry {
+    std::string name;
+    std::vector<Action> legal_actions;
+    int64_t radix;
+  };
+
+  std::vector<Entry> info_states_;
+  std::unordered_map<std::string, int> indices_;
+  int64_t num_policies_;
+};
+
+// One of the policies of an IndexedDeterministicPolicies, as a Policy. Moving
+// to another policy only changes its index, so a single object can evaluate
+// each policy in turn, and several threads can share the indexed policies.
+class IndexedDeterministicPolicy : public Policy {
+ public:
+  explicit IndexedDeterministicPolicy(
+      std::shared_ptr<const IndexedDeterministicPolicies> policies,
+      int64_t index = 0)
+      : policies_(std::move(policies)), index_(index) {}
+
+  int64_t Index() const { return index_; }
+  void SetIndex(int64_t index) { index_ = index; }
+
+  ActionsAndProbs GetStatePolicy(const std::string& info_state) const override;
+  Action GetAction(const std::string& info_state) const;
+
+ private:
+  std::shared_ptr<const IndexedDeterministicPolicies> policies_;
+  int64_t index_;
+};
+
 }  // namespace algorithms
 }  // namespace open_spiel
 
@@ -14,6 +14,10 @@
 
 #include "open_spiel/algorithms/deterministic_policy.h"
 
+#include <cstdint>
+#include <memory>
+#include <string>
+
 #include "open_spiel/games/kuhn_poker.h"
 #include "open_spiel/games/leduc_poker.h"
 
@@ -52,6 +56,47 @@ void NumDeterministicPoliciesTest() {
   SPIEL_CHECK_EQ(NumDeterministicPolicies(*game, 1), -1);
 }
 
+// The indexed policies follow the order of NextPolicy.
+void IndexedDeterministicPoliciesTest() {
+  for (const char* game_name :
+       {"kuhn_poker",
+        "goofspiel(num_cards=3,points_order=descending,imp_info=true)"}) {
+    std::shared_ptr<const Game> game = LoadGame(game_name);
+    for (Player player = 0; player < game->NumPlayers(); ++player) {
+      auto policies =
+          std::make_shared<const IndexedDeterministicPolicies>(*game, player);
+      SPIEL_CHECK_EQ(policies->NumPolicies(),
+                     NumDeterministicPolicies(*game, player));
+      DeterministicTabularPolicy tabular_policy(*game, player);
+      DeterministicTabularPolicy set_policy(*game, player);
+      IndexedDeterministicPolicy indexed_policy(policies);
+      int64_t index = 0;
+      do {
+        SPIEL_CHECK_EQ(tabular_policy.PolicyIndex(), index);
+        set_policy.SetPolicy(index);
+        indexed_policy.SetIndex(index);
+        const std::string str = tabular_policy.ToString(" --- ");
+        SPIEL_CHECK_EQ(set_policy.ToString(" --- "), str);
+        SPIEL_CHECK_EQ(policies->PolicyToString(index, " --- "), str);
+        for (int i = 0; i < policies->NumInfoStates(); ++i) {
+          const std::string& info_state = policies->InfoState(i);
+          SPIEL_CHECK_EQ(policies->InfoStateIndex(info_state), i);
+          SPIEL_CHECK_EQ(indexed_policy.GetAction(info_state),
+                         tabular_policy.GetAction(info_state));
+          SPIEL_CHECK_TRUE(indexed_policy.GetStatePolicy(info_state) ==
+                           tabular_policy.GetStatePolicy(info_state));
+        }
+        ++index;
+      } while (tabular_policy.NextPolicy());
+      SPIEL_CHECK_EQ(index, policies->NumPolicies());
+    }
+  }
+
+  std::shared_ptr<const Game> game = LoadGame("leduc_poker");
+  IndexedDeterministicPolicies policies(*game, 0);
+  SPIEL_CHECK_EQ(policies.NumPolicies(), -1);
+}
+
 }  // namespace
 }  // namespace algorithms
 }  // namespace open_spiel
@@ -59,4 +104,5 @@ void NumDeterministicPoliciesTest() {
 int main(int argc, char** argv) {
   open_spiel::algorithms::KuhnDeterministicPolicyTest();
   open_spiel::algorithms::NumDeterministicPoliciesTest();
+  open_spiel::algorithms::IndexedDeterministicPoliciesTest();
 }
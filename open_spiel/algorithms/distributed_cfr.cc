@@ -0,0 +1,750 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/distributed_cfr.h"
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/strings/numbers.h"
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/abseil-cpp/absl/synchronization/mutex.h"
+#include "open_spiel/abseil-cpp/absl/time/clock.h"
+#include "open_spiel/abseil-cpp/absl/time/time.h"
+#include "open_spiel/algorithms/compiled_game_tree.h"
+#include "open_spiel/policy.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/thread.h"
+
+namespace open_spiel {
+namespace algorithms {
+namespace {
+
+#ifdef MSG_NOSIGNAL
+constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+constexpr int kSendFlags = 0;
+#endif
+
+// The process an information state belongs to. The hash must be the same in
+// every process, unlike std::hash or absl::Hash, so it is FNV-1a.
+int KeyOwner(const std::string& key, int num_processes) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (unsigned char c : key) {
+    hash = (hash ^ c) * 1099511628211ULL;
+  }
+  return hash % num_processes;
+}
+
+// Messages are written and read in the native layout of the numbers.
+class MessageWriter {
+ public:
+  explicit MessageWriter(std::string* out) : out_(out) {}
+  void Int(int64_t value) { Raw(&value, sizeof(value)); }
+  void Double(double value) { Raw(&value, sizeof(value)); }
+  void String(const std::string& value) {
+    Int(value.size());
+    out_->append(value);
+  }
+
+ private:
+  void Raw(const void* data, int size) {
+    out_->append(static_cast<const char*>(data), size);
+  }
+  std::string* out_;
+};
+
+class MessageReader {
+ public:
+  explicit MessageReader(const std::string& in) : in_(in) {}
+  int64_t Int() {
+    int64_t value;
+    Raw(&value, sizeof(value));
+    return value;
+  }
+  double Double() {
+    double value;
+    Raw(&value, sizeof(value));
+    return value;
+  }
+  std::string String() {
+    const int64_t size = Int();
+    SPIEL_CHECK_LE(pos_ + size, in_.size());
+    std::string value = in_.substr(pos_, size);
+    pos_ += size;
+    return value;
+  }
+  bool Done() const { return pos_ == in_.size(); }
+
+ private:
+  void Raw(void* data, int size) {
+    SPIEL_CHECK_LE(pos_ + size, in_.size());
+    std::memcpy(data, in_.data() + pos_, size);
+    pos_ += size;
+  }
+  const std::string& in_;
+  size_t pos_ = 0;
+};
+
+// The messages between threads go through two sets of mailboxes, used by
+// alternate exchanges: a thread may start the next exchange while others
+// are still reading this one's, but not the one after, which needs them.
+struct LocalExchange {
+  explicit LocalExchange(int num_processes)
+      : num_processes(num_processes),
+        mailboxes(2, std::vector<std::vector<std::string>>(
+                         num_processes,
+                         std::vector<std::string>(num_processes))) {}
+
+  const int num_processes;
+  absl::Mutex mutex;
+  absl::CondVar done;
+  // The messages to each process from each one.
+  std::vector<std::vector<std::vector<std::string>>> mailboxes;
+  int num_sent = 0;
+  int64_t exchange = 0;
+};
+
+class LocalCFRTransport : public CFRTransport {
+ public:
+  LocalCFRTransport(int rank, std::shared_ptr<LocalExchange> exchange)
+      : rank_(rank), exchange_(std::move(exchange)) {}
+
+  int Rank() const override { return rank_; }
+  int NumProcesses() const override { return exchange_->num_processes; }
+
+  std::vector<std::string> AllToAll(
+      std::vector<std::string> messages) override {
+    SPIEL_CHECK_EQ(messages.size(), NumProcesses());
+    LocalExchange& exchange = *exchange_;
+    absl::MutexLock lock(&exchange.mutex);
+    const int64_t current = exchange.exchange;
+    auto& mailboxes = exchange.mailboxes[current % 2];
+    for (int p = 0; p < NumProcesses(); ++p) {
+      mailboxes[p][rank_] = std::move(messages[p]);
+    }
+    if (++exchange.num_sent == NumProcesses()) {
+      exchange.num_sent = 0;
+      ++exchange.exchange;
+      exchange.done.SignalAll();
+    }
+    while (exchange.exchange == current) exchange.done.Wait(&exchange.mutex);
+    std::vector<std::string> received(NumProcesses());
+    received.swap(mailboxes[rank_]);
+    return received;
+  }
+
+ private:
+  const int rank_;
+  std::shared_ptr<LocalExchange> exchange_;
+};
+
+void SendAll(int socket, const char* data, size_t size) {
+  while (size > 0) {
+    const ssize_t sent = send(socket, data, size, kSendFlags);
+    if (sent < 0 && errno == EINTR) continue;
+    if (sent <= 0) {
+      SpielFatalError(absl::StrCat("TCP transport: send failed: ",
+                                   std::strerror(errno)));
+    }
+    data += sent;
+    size -= sent;
+  }
+}
+
+void ReceiveAll(int socket, char* data, size_t size) {
+  while (size > 0) {
+    const ssize_t received = recv(socket, data, size, 0);
+    if (received < 0 && errno == EINTR) continue;
+    if (received <= 0) {
+      SpielFatalError(absl::StrCat(
+          "TCP transport: receive failed: ",
+          received == 0 ? "connection closed" : std::strerror(errno)));
+    }
+    data += received;
+    size -= received;
+  }
+}
+
+// Splits "host:port".
+std::pair<std::string, std::string> SplitAddress(const std::string& address) {
+  const size_t colon = address.rfind(':');
+  int port;
+  if (colon == std::string::npos ||
+      !absl::SimpleAtoi(address.substr(colon + 1), &port)) {
+    SpielFatalError(absl::StrCat("TCP transport: bad address '", address,
+                                 "', expected host:port."));
+  }
+  return {address.substr(0, colon), address.substr(colon + 1)};
+}
+
+// Each pair of processes is connected by one socket, which the one with the
+// higher rank opens. Each exchange sends the messages from another thread
+// while receiving, so that large messages can't fill the buffers of both
+// ends of a socket at once.
+class TcpCFRTransport : public CFRTransport {
+ public:
+  TcpCFRTransport(int rank, const std::vector<std::string>& addresses,
+                  double connect_timeout_seconds)
+      : rank_(rank), sockets_(addresses.size(), -1) {
+    SPIEL_CHECK_GE(rank, 0);
+    SPIEL_CHECK_LT(rank, addresses.size());
+    const int listener = Listen(SplitAddress(addresses[rank]).second);
+    const absl::Time deadline =
+        absl::Now() + absl::Seconds(connect_timeout_seconds);
+    for (int p = 0; p < rank; ++p) {
+      sockets_[p] = Connect(addresses[p], deadline);
+      const int64_t my_rank = rank;
+      SendAll(sockets_[p], reinterpret_cast<const char*>(&my_rank),
+              sizeof(my_rank));
+    }
+    for (int i = rank + 1; i < addresses.size(); ++i) {
+      const int socket = accept(listener, nullptr, nullptr);
+      if (socket < 0) {
+        SpielFatalError(absl::StrCat("TCP transport: accept failed: ",
+                                     std::strerror(errno)));
+      }
+      int64_t peer;
+      ReceiveAll(socket, reinterpret_cast<char*>(&peer), sizeof(peer));
+      SPIEL_CHECK_GT(peer, rank);
+      SPIEL_CHECK_LT(peer, addresses.size());
+      SPIEL_CHECK_EQ(sockets_[peer], -1);
+      sockets_[peer] = socket;
+      SetNoDelay(socket);
+    }
+    close(listener);
+  }
+
+  ~TcpCFRTransport() override {
+    for (int socket : sockets_) {
+      if (socket >= 0) close(socket);
+    }
+  }
+
+  int Rank() const override { return rank_; }
+  int NumProcesses() const override { return sockets_.size(); }
+
+  std::vector<std::string> AllToAll(
+      std::vector<std::string> messages) override {
+    SPIEL_CHECK_EQ(messages.size(), NumProcesses());
+    const int n = NumProcesses();
+    // Each process sends to the next ones in turn, and receives from the
+    // previous ones.
+    Thread sender([&]() {
+      for (int i = 1; i < n; ++i) {
+        const int p = (rank_ + i) % n;
+        const uint64_t size = messages[p].size();
+        SendAll(sockets_[p], reinterpret_cast<const char*>(&size),
+                sizeof(size));
+        SendAll(sockets_[p], messages[p].data(), size);
+      }
+    });
+    std::vector<std::string> received(n);
+    for (int i = 1; i < n; ++i) {
+      const int p = (rank_ - i + n) % n;
+      uint64_t size;
+      ReceiveAll(sockets_[p], reinterpret_cast<char*>(&size), sizeof(size));
+      received[p].resize(size);
+      ReceiveAll(sockets_[p], received[p].data(), size);
+    }
+    sender.join();
+    received[rank_] = std::move(messages[rank_]);
+    return received;
+  }
+
+ private:
+  static void SetNoDelay(int socket) {
+    const int one = 1;
+    setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+  }
+
+  static int Listen(const std::string& port) {
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE;
+    addrinfo* info;
+    if (getaddrinfo(nullptr, port.c_str(), &hints, &info) != 0) {
+      SpielFatalError(absl::StrCat("TCP transport: bad port ", port));
+    }
+    const int listener =
+        socket(info->ai_family, info->ai_socktype, info->ai_protocol);
+    const int one = 1;
+    if (listener < 0 ||
+        setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one)) ||
+        bind(listener, info->ai_addr, info->ai_addrlen) != 0 ||
+        listen(listener, SOMAXCONN) != 0) {
+      SpielFatalError(absl::StrCat("TCP transport: can't listen on port ",
+                                   port, ": ", std::strerror(errno)));
+    }
+    freeaddrinfo(info);
+    return listener;
+  }
+
+  // Connects to another process, retrying until it listens or the deadline.
+  static int Connect(const std::string& address, absl::Time deadline) {
+    const auto [host, port] = SplitAddress(address);
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    while (true) {
+      addrinfo* info;
+      if (getaddrinfo(host.c_str(), port.c_str(), &hints, &info) == 0) {
+        const int socket =
+            ::socket(info->ai_family, info->ai_socktype, info->ai_protocol);
+        const bool connected =
+            socket >= 0 &&
+            connect(socket, info->ai_addr, info->ai_addrlen) == 0;
+        freeaddrinfo(info);
+        if (connected) {
+          SetNoDelay(socket);
+          return socket;
+        }
+        if (socket >= 0) close(socket);
+      }
+      if (absl::Now() > deadline) {
+        SpielFatalError(absl::StrCat("TCP transport: can't connect to ",
+                                     address, ": ", std::strerror(errno)));
+      }
+      absl::SleepFor(absl::Milliseconds(50));
+    }
+  }
+
+  const int rank_;
+  std::vector<int> sockets_;
+};
+
+}  // namespace
+
+std::vector<std::unique_ptr<CFRTransport>> MakeLocalCFRTransports(
+    int num_processes) {
+  SPIEL_CHECK_GE(num_processes, 1);
+  auto exchange = std::make_shared<LocalExchange>(num_processes);
+  std::vector<std::unique_ptr<CFRTransport>> transports;
+  for (int rank = 0; rank < num_processes; ++rank) {
+    transports.push_back(
+        std::make_unique<LocalCFRTransport>(rank, exchange));
+  }
+  return transports;
+}
+
+std::unique_ptr<CFRTransport> MakeTcpCFRTransport(
+    int rank, const std::vector<std::string>& addresses,
+    double connect_timeout_seconds) {
+  return std::make_unique<TcpCFRTransport>(rank, addresses,
+                                           connect_timeout_seconds);
+}
+
+DistributedCFRSolver::DistributedCFRSolver(const Game& game,
+                                           CFRTransport* transport,
+                                           int split_depth)
+    : transport_(transport),
+      num_players_(game.NumPlayers()),
+      split_depth_(split_depth) {
+  SPIEL_CHECK_GE(split_depth, 0);
+  if (game.GetType().dynamics != GameType::Dynamics::kSequential) {
+    SpielFatalError("DistributedCFRSolver requires a sequential game.");
+  }
+  const int num_processes = transport_->NumProcesses();
+  keys_by_owner_.resize(num_processes);
+  requests_.resize(num_processes);
+
+  std::unique_ptr<State> root = game.NewInitialState();
+  root_ = AddUpperNodes(root.get(), 0);
+  subtree_values_.assign(subtree_owners_.size(),
+                         std::vector<double>(num_players_, 0.0));
+  subtree_reach_.resize(subtree_owners_.size());
+  policies_.resize(offsets_.empty() ? 0
+                                    : offsets_.back() + actions_.back().size());
+  deltas_.resize(2 * policies_.size());
+  RegisterKeys();
+}
+
+int DistributedCFRSolver::AddUpperNodes(State* state, int depth) {
+  const int index = upper_nodes_.size();
+  upper_nodes_.emplace_back();
+  upper_nodes_[index].player = state->CurrentPlayer();
+  if (state->IsTerminal()) {
+    upper_nodes_[index].returns = state->Returns();
+    return index;
+  }
+  if (depth == split_depth_) {
+    const int subtree = subtree_owners_.size();
+    const int owner = subtree % transport_->NumProcesses();
+    upper_nodes_[index].subtree = subtree;
+    subtree_owners_.push_back(owner);
+    if (owner == transport_->Rank()) {
+      local_subtrees_.push_back(subtree);
+      trees_.push_back(std::make_unique<CompiledGameTree>(*state));
+      const CompiledGameTree& tree = *trees_.back();
+      std::vector<int> tree_keys(tree.NumInfoStates());
+      for (int i = 0; i < tree.NumInfoStates(); ++i) {
+        tree_keys[i] = AddKey(tree.InfoStateKey(i), tree.InfoStateString(i),
+                              tree.InfoStateActions(i));
+      }
+      tree_keys_.push_back(std::move(tree_keys));
+    }
+    return index;
+  }
+
+  std::vector<Action> actions;
+  if (state->IsChanceNode()) {
+    for (const auto& [action, prob] : state->ChanceOutcomes()) {
+      actions.push_back(action);
+      upper_nodes_[index].chance_probabilities.push_back(prob);
+    }
+  } else {
+    actions = state->LegalActions();
+    upper_nodes_[index].info_state =
+        AddKey(state->InformationStateKey(), state->InformationStateString(),
+               actions);
+  }
+  for (Action action : actions) {
+    std::unique_ptr<State> child = state->Child(action);
+    const int child_index = AddUpperNodes(child.get(), depth + 1);
+    upper_nodes_[index].children.push_back(child_index);
+  }
+  return index;
+}
+
+int DistributedCFRSolver::AddKey(const std::string& key,
+                                 const std::string& string,
+                                 absl::Span<const Action> actions) {
+  auto [it, inserted] = key_ids_.insert({key, keys_.size()});
+  if (inserted) {
+    offsets_.push_back(offsets_.empty()
+                           ? 0
+                           : offsets_.back() + actions_.back().size());
+    keys_.push_back(key);
+    strings_.push_back(string);
+    actions_.emplace_back(actions.begin(), actions.end());
+    keys_by_owner_[KeyOwner(key, transport_->NumProcesses())].push_back(
+        it->second);
+  }
+  return it->second;
+}
+
+void DistributedCFRSolver::RegisterKeys() {
+  const int num_processes = transport_->NumProcesses();
+  std::vector<std::string> messages(num_processes);
+  for (int p = 0; p < num_processes; ++p) {
+    MessageWriter writer(&messages[p]);
+    writer.Int(keys_by_owner_[p].size());
+    for (int k : keys_by_owner_[p]) {
+      writer.String(keys_[k]);
+      writer.String(strings_[k]);
+      writer.Int(actions_[k].size());
+      for (Action action : actions_[k]) writer.Int(action);
+    }
+  }
+  messages = transport_->AllToAll(std::move(messages));
+
+  for (int p = 0; p < num_processes; ++p) {
+    MessageReader reader(messages[p]);
+    const int num_keys = reader.Int();
+    for (int i = 0; i < num_keys; ++i) {
+      std::string key = reader.String();
+      std::string string = reader.String();
+      std::vector<Action> actions(reader.Int());
+      for (Action& action : actions) action = reader.Int();
+      auto [it, inserted] = table_ids_.insert({key, table_keys_.size()});
+      if (inserted) {
+        const int num_actions = actions.size();
+        table_offsets_.push_back(cumulative_regrets_.size());
+        table_keys_.push_back(std::move(key));
+        table_strings_.push_back(std::move(string));
+        table_actions_.push_back(std::move(actions));
+        cumulative_regrets_.resize(cumulative_regrets_.size() + num_actions);
+        cumulative_policy_.resize(cumulative_policy_.size() + num_actions);
+        current_policy_.resize(current_policy_.size() + num_actions,
+                               1.0 / num_actions);
+      } else {
+        SPIEL_CHECK_EQ(actions, table_actions_[it->second]);
+      }
+      requests_[p].push_back(it->second);
+    }
+    SPIEL_CHECK_TRUE(reader.Done());
+  }
+}
+
+void DistributedCFRSolver::FetchPolicies() {
+  const int num_processes = transport_->NumProcesses();
+  std::vector<std::string> messages(num_processes);
+  for (int p = 0; p < num_processes; ++p) {
+    MessageWriter writer(&messages[p]);
+    for (int id : requests_[p]) {
+      for (int aidx = 0; aidx < table_actions_[id].size(); ++aidx) {
+        writer.Double(current_policy_[table_offsets_[id] + aidx]);
+      }
+    }
+  }
+  messages = transport_->AllToAll(std::move(messages));
+
+  for (int p = 0; p < num_processes; ++p) {
+    MessageReader reader(messages[p]);
+    for (int k : keys_by_owner_[p]) {
+      for (int aidx = 0; aidx < actions_[k].size(); ++aidx) {
+        policies_[offsets_[k] + aidx] = reader.Double();
+      }
+    }
+    SPIEL_CHECK_TRUE(reader.Done());
+  }
+}
+
+void DistributedCFRSolver::EvaluateAndUpdatePolicy() {
+  const int num_processes = transport_->NumProcesses();
+  const std::vector<double> root_reach(num_players_ + 1, 1.0);
+  for (Player player = 0; player < num_players_; ++player) {
+    FetchPolicies();
+
+    // The reach probabilities of the subtrees, then the values and updates
+    // of this process's.
+    WalkUpperNodes(root_, root_reach, player, /*update=*/false);
+    std::fill(deltas_.begin(), deltas_.end(), 0.0);
+    for (int t = 0; t < trees_.size(); ++t) {
+      const int subtree = local_subtrees_[t];
+      subtree_values_[subtree] =
+          WalkSubtree(*trees_[t], tree_keys_[t], CompiledGameTree::kRoot,
+                      subtree_reach_[subtree], player);
+    }
+
+    // Every process gets the values of all the subtrees, and the updates of
+    // its information states.
+    std::vector<std::string> messages(num_processes);
+    for (int p = 0; p < num_processes; ++p) {
+      MessageWriter writer(&messages[p]);
+      for (int subtree : local_subtrees_) {
+        for (double value : subtree_values_[subtree]) writer.Double(value);
+      }
+      for (int k : keys_by_owner_[p]) {
+        const int begin = 2 * offsets_[k];
+        for (int i = 0; i < 2 * actions_[k].size(); ++i) {
+          writer.Double(deltas_[begin + i]);
+        }
+      }
+    }
+    messages = transport_->AllToAll(std::move(messages));
+
+    for (int p = 0; p < num_processes; ++p) {
+      MessageReader reader(messages[p]);
+      for (int subtree = 0; subtree < subtree_owners_.size(); ++subtree) {
+        if (subtree_owners_[subtree] != p) continue;
+        for (double& value : subtree_values_[subtree]) value = reader.Double();
+      }
+      for (int id : requests_[p]) {
+        const int num_actions = table_actions_[id].size();
+        const int begin = table_offsets_[id];
+        for (int aidx = 0; aidx < num_actions; ++aidx) {
+          cumulative_regrets_[begin + aidx] += reader.Double();
+        }
+        for (int aidx = 0; aidx < num_actions; ++aidx) {
+          cumulative_policy_[begin + aidx] += reader.Double();
+        }
+      }
+      SPIEL_CHECK_TRUE(reader.Done());
+    }
+
+    WalkUpperNodes(root_, root_reach, player, /*update=*/true);
+
+    // Regret matching, as in CFRSolver.
+    for (int id = 0; id < table_keys_.size(); ++id) {
+      const int num_actions = table_actions_[id].size();
+      const double* regrets = &cumulative_regrets_[table_offsets_[id]];
+      double* policy = &current_policy_[table_offsets_[id]];
+      double sum_positive_regrets = 0.0;
+      for (int aidx = 0; aidx < num_actions; ++aidx) {
+        if (regrets[aidx] > 0) sum_positive_regrets += regrets[aidx];
+      }
+      for (int aidx = 0; aidx < num_actions; ++aidx) {
+        if (sum_positive_regrets > 0) {
+          policy[aidx] =
+              regrets[aidx] > 0 ? regrets[aidx] / sum_positive_regrets : 0;
+        } else {
+          policy[aidx] = 1.0 / num_actions;
+        }
+      }
+    }
+  }
+}
+
+std::vector<double> DistributedCFRSolver::WalkUpperNodes(
+    int node, const std::vector<double>& reach, Player player, bool update) {
+  const UpperNode& upper_node = upper_nodes_[node];
+  if (upper_node.player == kTerminalPlayerId) return upper_node.returns;
+  if (upper_node.subtree >= 0) {
+    if (!update) {
+      subtree_reach_[upper_node.subtree] = reach;
+      return std::vector<double>(num_players_, 0.0);
+    }
+    return subtree_values_[upper_node.subtree];
+  }
+
+  std::vector<double> value(num_players_, 0.0);
+  const bool chance = upper_node.player == kChancePlayerId;
+  if (!chance) {
+    bool all_zero = true;
+    for (Player p = 0; p < num_players_; ++p) all_zero &= reach[p] == 0.0;
+    if (all_zero && update) return value;
+  }
+  const Player mover = chance ? num_players_ : upper_node.player;
+  const double* probs = chance
+                            ? upper_node.chance_probabilities.data()
+                            : &policies_[offsets_[upper_node.info_state]];
+  std::vector<double> action_values;
+  for (int aidx = 0; aidx < upper_node.children.size(); ++aidx) {
+    std::vector<double> child_reach(reach);
+    child_reach[mover] *= probs[aidx];
+    const std::vector<double> child_value =
+        WalkUpperNodes(upper_node.children[aidx], child_reach, player, update);
+    for (Player p = 0; p < num_players_; ++p) {
+      value[p] += probs[aidx] * child_value[p];
+    }
+    if (!chance) action_values.push_back(child_value[upper_node.player]);
+  }
+
+  // The information states above the subtrees are updated by the processes
+  // they belong to, directly in their tables.
+  if (update && upper_node.player == player) {
+    auto it = table_ids_.find(keys_[upper_node.info_state]);
+    if (it != table_ids_.end() &&
+        KeyOwner(it->first, transport_->NumProcesses()) ==
+            transport_->Rank()) {
+      const int begin = table_offsets_[it->second];
+      Update(&cumulative_regrets_[begin], &cumulative_policy_[begin], probs,
+             action_values, value, reach, player);
+    }
+  }
+  return value;
+}
+
+std::vector<double> DistributedCFRSolver::WalkSubtree(
+    const CompiledGameTree& tree, const std::vector<int>& tree_keys, int node,
+    const std::vector<double>& reach, Player player) {
+  if (tree.IsTerminal(node)) {
+    absl::Span<const double> returns = tree.Returns(node);
+    return std::vector<double>(returns.begin(), returns.end());
+  }
+  std::vector<double> value(num_players_, 0.0);
+  const bool chance = tree.IsChanceNode(node);
+  int key = -1;
+  if (!chance) {
+    bool all_zero = true;
+    for (Player p = 0; p < num_players_; ++p) all_zero &= reach[p] == 0.0;
+    if (all_zero) return value;
+    key = tree_keys[tree.InfoState(node)];
+  }
+  const Player mover = chance ? num_players_ : tree.CurrentPlayer(node);
+  const double* probs = chance ? tree.ChanceProbabilities(node).data()
+                               : &policies_[offsets_[key]];
+  absl::Span<const int> children = tree.Children(node);
+  std::vector<double> action_values;
+  for (int aidx = 0; aidx < children.size(); ++aidx) {
+    std::vector<double> child_reach(reach);
+    child_reach[mover] *= probs[aidx];
+    const std::vector<double> child_value =
+        WalkSubtree(tree, tree_keys, children[aidx], child_reach, player);
+    for (Player p = 0; p < num_players_; ++p) {
+      value[p] += probs[aidx] * child_value[p];
+    }
+    if (!chance) action_values.push_back(child_value[mover]);
+  }
+
+  if (mover == player) {
+    double* deltas = &deltas_[2 * offsets_[key]];
+    Update(deltas, deltas + children.size(), probs, action_values, value,
+           reach, player);
+  }
+  return value;
+}
+
+void DistributedCFRSolver::Update(double* regrets, double* average,
+                                  const double* policy,
+                                  const std::vector<double>& action_values,
+                                  const std::vector<double>& value,
+                                  const std::vector<double>& reach,
+                                  Player player) {
+  double cfr_reach = 1.0;
+  for (int i = 0; i < reach.size(); ++i) {
+    if (i != player) cfr_reach *= reach[i];
+  }
+  for (int aidx = 0; aidx < action_values.size(); ++aidx) {
+    regrets[aidx] += cfr_reach * (action_values[aidx] - value[player]);
+    average[aidx] += reach[player] * policy[aidx];
+  }
+}
+
+TabularPolicy DistributedCFRSolver::LocalAveragePolicy() const {
+  std::unordered_map<std::string, ActionsAndProbs> table;
+  for (int id = 0; id < table_keys_.size(); ++id) {
+    const int num_actions = table_actions_[id].size();
+    const double* cumulative = &cumulative_policy_[table_offsets_[id]];
+    double sum = 0.0;
+    for (int aidx = 0; aidx < num_actions; ++aidx) sum += cumulative[aidx];
+    ActionsAndProbs& policy = table[table_strings_[id]];
+    for (int aidx = 0; aidx < num_actions; ++aidx) {
+      policy.push_back({table_actions_[id][aidx],
+                        sum == 0.0 ? 1.0 / num_actions
+                                   : cumulative[aidx] / sum});
+    }
+  }
+  return TabularPolicy(table);
+}
+
+TabularPolicy DistributedCFRSolver::GatherAveragePolicy() {
+  std::vector<std::string> messages(transport_->NumProcesses());
+  const TabularPolicy local = LocalAveragePolicy();
+  MessageWriter writer(&messages[0]);
+  writer.Int(local.PolicyTable().size());
+  for (const auto& [info_state, policy] : local.PolicyTable()) {
+    writer.String(info_state);
+    writer.Int(policy.size());
+    for (const auto& [action, prob] : policy) {
+      writer.Int(action);
+      writer.Double(prob);
+    }
+  }
+  messages = transport_->AllToAll(std::move(messages));
+
+  std::unordered_map<std::string, ActionsAndProbs> table;
+  for (const std::string& message : messages) {
+    if (message.empty()) continue;
+    MessageReader reader(message);
+    const int num_info_states = reader.Int();
+    for (int i = 0; i < num_info_states; ++i) {
+      ActionsAndProbs& policy = table[reader.String()];
+      policy.resize(reader.Int());
+      for (auto& [action, prob] : policy) {
+        action = reader.Int();
+        prob = reader.Double();
+      }
+    }
+    SPIEL_CHECK_TRUE(reader.Done());
+  }
+  return TabularPolicy(table);
+}
+
+}  // namespace algorithms
+}  // namespace open_spiel
@@ -0,0 +1,193 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_ALGORITHMS_DISTRIBUTED_CFR_H_
+#define OPEN_SPIEL_ALGORITHMS_DISTRIBUTED_CFR_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/container/flat_hash_map.h"
+#include "open_spiel/abseil-cpp/absl/types/span.h"
+#include "open_spiel/algorithms/compiled_game_tree.h"
+#include "open_spiel/policy.h"
+#include "open_spiel/spiel.h"
+
+// CFR over several processes, for games whose tree or information states
+// don't fit in the memory of one machine.
+//
+// The tree is split at a given depth: every process walks the few levels
+// above it, and each of the subtrees below belongs to one process, which
+// compiles it and walks it. Each information state belongs to one process,
+// chosen by a hash of its key, which keeps its regrets and policies. Every
+// update of a player, the processes:
+//  - get the current policies of the information states they walk from the
+//    processes they belong to;
+//  - walk the levels above the subtrees, for the reach probabilities of their
+//    roots, then their own subtrees;
+//  - exchange the values of their subtrees, and send the regret and average
+//    policy updates of each information state to the process it belongs to;
+//  - walk the levels above the subtrees again with those values, to update
+//    the information states there which belong to them;
+//  - apply regret matching to their information states.
+//
+// It runs the same iterations as CFRSolver, i.e. vanilla CFR with alternating
+// updates, so their policies are the same up to rounding.
+//
+// The processes exchange messages through a CFRTransport, which can be
+// implemented over e.g. MPI. There are transports between threads, and over
+// TCP between processes on machines of the same architecture.
+namespace open_spiel {
+namespace algorithms {
+
+class CFRTransport {
+ public:
+  virtual ~CFRTransport() = default;
+
+  // This process, numbered from 0, and the number of processes.
+  virtual int Rank() const = 0;
+  virtual int NumProcesses() const = 0;
+
+  // Sends messages[p] to each process p, and returns the messages each one
+  // sent to this one, in the order of their ranks. Every process calls it
+  // together. The message to this process is returned as is.
+  virtual std::vector<std::string> AllToAll(
+      std::vector<std::string> messages) = 0;
+};
+
+// Transports between num_processes threads of this process, one each.
+std::vector<std::unique_ptr<CFRTransport>> MakeLocalCFRTransports(
+    int num_processes);
+
+// A transport over TCP, between the processes listening at the addresses,
+// as "host:port", in the order of their ranks. This one listens at
+// addresses[rank], and connects to the others, waiting for up to
+// connect_timeout_seconds for them to start.
+std::unique_ptr<CFRTransport> MakeTcpCFRTransport(
+    int rank, const std::vector<std::string>& addresses,
+    double connect_timeout_seconds = 60);
+
+class DistributedCFRSolver {
+ public:
+  // Every process constructs a solver for the same game and split depth.
+  DistributedCFRSolver(const Game& game, CFRTransport* transport,
+                       int split_depth = 1);
+
+  // Performs one iteration of CFR, updating each player in turn. Every
+  // process calls it together.
+  void EvaluateAndUpdatePolicy();
+
+  // The average policy of the information states which belong to this
+  // process.
+  TabularPolicy LocalAveragePolicy() const;
+
+  // The average policy of all the information states, on process 0, and an
+  // empty one elsewhere. Every process calls it together.
+  TabularPolicy GatherAveragePolicy();
+
+  int NumSubtrees() const { return subtree_owners_.size(); }
+  int NumLocalInfoStates() const { return table_offsets_.size(); }
+
+ private:
+  // A node above the subtrees, or the root of one of them.
+  struct UpperNode {
+    Player player;
+    int info_state = -1;  // Its index in keys_, for decision nodes.
+    std::vector<int> children;
+    std::vector<double> chance_probabilities;
+    std::vector<double> returns;  // For terminals.
+    int subtree = -1;             // For the roots of subtrees.
+  };
+
+  // Adds the nodes at or above the split depth, compiling the subtrees which
+  // belong to this process, and returns the index of the node of the state.
+  int AddUpperNodes(State* state, int depth);
+  // Adds an information state walked by this process, if new, and returns
+  // its index in keys_.
+  int AddKey(const std::string& key, const std::string& string,
+             absl::Span<const Action> actions);
+  // Registers the information states walked by this process with the
+  // processes they belong to.
+  void RegisterKeys();
+  // Fetches the current policies of the information states walked by this
+  // process.
+  void FetchPolicies();
+
+  // Walks the levels above the subtrees: first collecting the reach
+  // probabilities of their roots, then updating the regrets of the player
+  // with their values.
+  std::vector<double> WalkUpperNodes(int node,
+                                     const std::vector<double>& reach,
+                                     Player player, bool update);
+  // Walks a subtree, adding the updates of its information states to
+  // deltas_.
+  std::vector<double> WalkSubtree(const CompiledGameTree& tree,
+                                  const std::vector<int>& tree_keys, int node,
+                                  const std::vector<double>& reach,
+                                  Player player);
+  // Adds an update of the regrets and average policy of an information state.
+  void Update(double* regrets, double* average, const double* policy,
+              const std::vector<double>& action_values,
+              const std::vector<double>& value,
+              const std::vector<double>& reach, Player player);
+
+  CFRTransport* transport_;
+  const int num_players_;
+  const int split_depth_;
+
+  std::vector<UpperNode> upper_nodes_;
+  int root_;
+  // The process of each subtree, and their values and reach probabilities.
+  std::vector<int> subtree_owners_;
+  std::vector<std::vector<double>> subtree_values_;
+  std::vector<std::vector<double>> subtree_reach_;
+  // The subtrees of this process, with their indices and the index in keys_
+  // of each of their information states.
+  std::vector<int> local_subtrees_;
+  std::vector<std::unique_ptr<CompiledGameTree>> trees_;
+  std::vector<std::vector<int>> tree_keys_;
+
+  // The information states walked by this process: their keys, strings and
+  // actions, and where their policies and updates start in policies_ and
+  // deltas_ (which holds the regrets, then the average policy updates).
+  std::vector<std::string> keys_;
+  std::vector<std::string> strings_;
+  std::vector<std::vector<Action>> actions_;
+  std::vector<int> offsets_;
+  absl::flat_hash_map<std::string, int> key_ids_;
+  std::vector<double> policies_;
+  std::vector<double> deltas_;
+  // The information states walked by this process which belong to each
+  // process, as indices in keys_, in the order registered with it.
+  std::vector<std::vector<int>> keys_by_owner_;
+
+  // The information states which belong to this process: their keys,
+  // strings and actions, where their values start in the tables, and which
+  // of them each process walks, in the order it registered them.
+  std::vector<std::string> table_keys_;
+  std::vector<std::string> table_strings_;
+  std::vector<std::vector<Action>> table_actions_;
+  std::vector<int> table_offsets_;
+  absl::flat_hash_map<std::string, int> table_ids_;
+  std::vector<double> cumulative_regrets_;
+  std::vector<double> cumulative_policy_;
+  std::vector<double> current_policy_;
+  std::vector<std::vector<int>> requests_;
+};
+
+}  // namespace algorithms
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_ALGORITHMS_DISTRIBUTED_CFR_H_
@@ -0,0 +1,130 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/distributed_cfr.h"
+
+#include <unistd.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/algorithms/cfr.h"
+#include "open_spiel/policy.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/thread.h"
+
+namespace open_spiel {
+namespace algorithms {
+namespace {
+
+constexpr int kNumIterations = 20;
+
+// Runs the solver in a thread per transport, and returns the policy gathered
+// on process 0.
+TabularPolicy SolveDistributed(
+    const Game& game, const std::vector<CFRTransport*>& transports,
+    int split_depth) {
+  std::vector<TabularPolicy> policies(transports.size());
+  std::vector<Thread> threads;
+  for (int rank = 0; rank < transports.size(); ++rank) {
+    threads.emplace_back([&, rank]() {
+      DistributedCFRSolver solver(game, transports[rank], split_depth);
+      for (int i = 0; i < kNumIterations; ++i) {
+        solver.EvaluateAndUpdatePolicy();
+      }
+      policies[rank] = solver.GatherAveragePolicy();
+    });
+  }
+  for (Thread& thread : threads) thread.join();
+  for (int rank = 1; rank < transports.size(); ++rank) {
+    SPIEL_CHECK_TRUE(policies[rank].PolicyTable().empty());
+  }
+  return policies[0];
+}
+
+// The policy is CFRSolver's, with every information state.
+void CheckSameAsCFRSolver(const Game& game, const TabularPolicy& policy) {
+  CFRSolver solver(game);
+  for (int i = 0; i < kNumIterations; ++i) solver.EvaluateAndUpdatePolicy();
+  const TabularPolicy expected =
+      TabularPolicy(game, *solver.AveragePolicy());
+  SPIEL_CHECK_EQ(policy.PolicyTable().size(), expected.PolicyTable().size());
+  for (const auto& [info_state, expected_probs] : expected.PolicyTable()) {
+    const ActionsAndProbs& probs = policy.GetStatePolicy(info_state);
+    SPIEL_CHECK_EQ(probs.size(), expected_probs.size());
+    for (int aidx = 0; aidx < probs.size(); ++aidx) {
+      SPIEL_CHECK_EQ(probs[aidx].first, expected_probs[aidx].first);
+      SPIEL_CHECK_FLOAT_NEAR(probs[aidx].second, expected_probs[aidx].second,
+                             1e-9);
+    }
+  }
+}
+
+void LocalTransportTest(const std::string& game_name, int num_processes,
+                        int split_depth) {
+  std::shared_ptr<const Game> game = LoadGame(game_name);
+  std::vector<std::unique_ptr<CFRTransport>> transports =
+      MakeLocalCFRTransports(num_processes);
+  std::vector<CFRTransport*> transport_ptrs;
+  for (const auto& transport : transports) {
+    transport_ptrs.push_back(transport.get());
+  }
+  CheckSameAsCFRSolver(*game,
+                       SolveDistributed(*game, transport_ptrs, split_depth));
+}
+
+void TcpTransportTest() {
+  std::shared_ptr<const Game> game = LoadGame("leduc_poker");
+  constexpr int kNumProcesses = 3;
+  // Ports unlikely to be taken, or shared by concurrent runs of the test.
+  const int base_port = 20000 + (getpid() % 10000) * 3;
+  std::vector<std::string> addresses;
+  for (int rank = 0; rank < kNumProcesses; ++rank) {
+    addresses.push_back(absl::StrCat("localhost:", base_port + rank));
+  }
+  std::vector<std::unique_ptr<CFRTransport>> transports(kNumProcesses);
+  std::vector<Thread> threads;
+  for (int rank = 0; rank < kNumProcesses; ++rank) {
+    threads.emplace_back([&, rank]() {
+      transports[rank] = MakeTcpCFRTransport(rank, addresses);
+    });
+  }
+  for (Thread& thread : threads) thread.join();
+  std::vector<CFRTransport*> transport_ptrs;
+  for (const auto& transport : transports) {
+    SPIEL_CHECK_EQ(transport->NumProcesses(), kNumProcesses);
+    transport_ptrs.push_back(transport.get());
+  }
+  CheckSameAsCFRSolver(*game, SolveDistributed(*game, transport_ptrs,
+                                               /*split_depth=*/2));
+}
+
+}  // namespace
+}  // namespace algorithms
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  for (const std::string game : {"kuhn_poker", "leduc_poker"}) {
+    for (int num_processes : {1, 2, 3}) {
+      for (int split_depth : {0, 1, 2, 4}) {
+        open_spiel::algorithms::LocalTransportTest(game, num_processes,
+                                                   split_depth);
+      }
+    }
+  }
+  open_spiel::algorithms::TcpTransportTest();
+}
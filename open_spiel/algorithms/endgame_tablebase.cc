@@ -0,0 +1,341 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/endgame_tablebase.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/algorithms/get_all_states.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/file.h"
+
+namespace open_spiel {
+namespace algorithms {
+
+namespace {
+
+constexpr char kMagic[8] = {'O', 'S', 'E', 'N', 'D', 'T', 'B', 'L'};
+constexpr uint32_t kVersion = 1;
+
+// Its size is a multiple of 8 bytes, so that the arrays after it stay aligned.
+struct Header {
+  char magic[8];
+  uint32_t version;
+  uint32_t reserved;
+  int64_t num_states;
+  int64_t game_string_bytes;
+};
+
+template <typename T>
+void WriteBytes(file::File* file, const T* data, int64_t size) {
+  SPIEL_CHECK_TRUE(file->Write(
+      absl::string_view(reinterpret_cast<const char*>(data), size * sizeof(T))));
+}
+
+// The value of a state for its player, from its value for player 0.
+double ValueForPlayer(Player player, double value) {
+  return player == 1 ? -value : value;
+}
+
+// The values and distances of the states of a graph, solved backwards.
+class RetrogradeSolver {
+ public:
+  RetrogradeSolver(const StateGraph& graph, double max_utility)
+      : graph_(graph),
+        max_utility_(max_utility),
+        values_(graph.NumStates(), 0),
+        distances_(graph.NumStates(), EndgameTablebase::kNoDistance),
+        solved_(graph.NumStates(), false),
+        num_unsolved_successors_(graph.NumStates(), 0) {
+    // The predecessors of each state, in one array, with a predecessor
+    // appearing as many times as it has actions leading to the state.
+    predecessor_offsets_.assign(graph.NumStates() + 1, 0);
+    for (int state = 0; state < graph.NumStates(); ++state) {
+      if (graph.IsTerminal(state)) continue;
+      for (int successor : graph.Successors(state)) {
+        ++predecessor_offsets_[successor + 1];
+      }
+    }
+    for (int state = 0; state < graph.NumStates(); ++state) {
+      predecessor_offsets_[state + 1] += predecessor_offsets_[state];
+    }
+    predecessors_.resize(predecessor_offsets_.back());
+    std::vector<int> next(predecessor_offsets_.begin(),
+                          predecessor_offsets_.end() - 1);
+    for (int state = 0; state < graph.NumStates(); ++state) {
+      if (graph.IsTerminal(state)) continue;
+      for (int successor : graph.Successors(state)) {
+        predecessors_[next[successor]++] = state;
+      }
+    }
+  }
+
+  void Solve() {
+    // The states are solved in the order of this queue, which starts with the
+    // terminals, so that the first winning successor found is the closest.
+    std::vector<int> queue;
+    queue.reserve(graph_.NumStates());
+    for (int state = 0; state < graph_.NumStates(); ++state) {
+      if (graph_.IsTerminal(state)) {
+        values_[state] = graph_.Returns(state)[0];
+        distances_[state] = 0;
+        solved_[state] = true;
+        queue.push_back(state);
+      } else {
+        num_unsolved_successors_[state] = graph_.Successors(state).size();
+      }
+    }
+    for (int i = 0; i < queue.size(); ++i) {
+      const int state = queue[i];
+      for (int p = predecessor_offsets_[state];
+           p < predecessor_offsets_[state + 1]; ++p) {
+        const int predecessor = predecessors_[p];
+        if (solved_[predecessor]) continue;
+        --num_unsolved_successors_[predecessor];
+        const Player player = graph_.CurrentPlayer(predecessor);
+        if (player != kChancePlayerId &&
+            ValueForPlayer(player, values_[state]) >= max_utility_) {
+          values_[predecessor] = values_[state];
+          distances_[predecessor] = distances_[state] + 1;
+        } else if (num_unsolved_successors_[predecessor] == 0) {
+          BackUp(predecessor);
+        } else {
+          continue;
+        }
+        solved_[predecessor] = true;
+        queue.push_back(predecessor);
+      }
+    }
+  }
+
+  bool IsSolved(int state) const { return solved_[state]; }
+  const std::vector<double>& values() const { return values_; }
+  const std::vector<int>& distances() const { return distances_; }
+
+ private:
+  // Solves a state from its successors, which are all solved.
+  void BackUp(int state) {
+    absl::Span<const int> successors = graph_.Successors(state);
+    if (graph_.IsChanceNode(state)) {
+      absl::Span<const double> probs = graph_.ChanceProbabilities(state);
+      double value = 0;
+      int distance = 0;
+      for (int i = 0; i < successors.size(); ++i) {
+        value += probs[i] * values_[successors[i]];
+        distance = std::max(distances_[successors[i]], distance);
+      }
+      values_[state] = value;
+      distances_[state] = distance + 1;
+      return;
+    }
+    const Player player = graph_.CurrentPlayer(state);
+    double best_value = ValueForPlayer(player, values_[successors[0]]);
+    for (int successor : successors) {
+      best_value = std::max(ValueForPlayer(player, values_[successor]),
+                            best_value);
+    }
+    int distance = -1;
+    for (int successor : successors) {
+      if (ValueForPlayer(player, values_[successor]) != best_value) continue;
+      const int successor_distance = distances_[successor];
+      if (distance < 0 ||
+          (best_value > 0 ? successor_distance < distance
+                          : successor_distance > distance)) {
+        distance = successor_distance;
+      }
+    }
+    values_[state] = ValueForPlayer(player, best_value);
+    distances_[state] = distance + 1;
+  }
+
+  const StateGraph& graph_;
+  const double max_utility_;
+  std::vector<double> values_;
+  std::vector<int> distances_;
+  std::vector<bool> solved_;
+  std::vector<int> num_unsolved_successors_;
+  std::vector<int> predecessor_offsets_;
+  std::vector<int> predecessors_;
+};
+
+}  // namespace
+
+void BuildEndgameTablebase(const State& root, const std::string& filename,
+                           int num_threads) {
+  std::shared_ptr<const Game> game = root.GetGame();
+  const GameType& game_type = game->GetType();
+  if (game_type.dynamics != GameType::Dynamics::kSequential) {
+    SpielFatalError("Endgame tablebases are for sequential games.");
+  }
+  if (game_type.information != GameType::Information::kPerfectInformation) {
+    SpielFatalError("Endgame tablebases are for perfect information games.");
+  }
+  if (game->NumPlayers() == 2) {
+    if (game_type.utility != GameType::Utility::kZeroSum) {
+      SpielFatalError("Two-player endgame tablebases are for zero-sum games.");
+    }
+  } else if (game->NumPlayers() != 1) {
+    SpielFatalError("Endgame tablebases are for one or two players.");
+  }
+
+  StateGraph graph(root, /*depth_limit=*/-1, num_threads);
+  RetrogradeSolver solver(graph, game->MaxUtility());
+  solver.Solve();
+  for (int state = 0; state < graph.NumStates(); ++state) {
+    if (!solver.IsSolved(state) && graph.IsChanceNode(state)) {
+      SpielFatalError(
+          "Endgame tablebases do not support cycles through chance nodes.");
+    }
+  }
+
+  std::vector<int> order(graph.NumStates());
+  for (int state = 0; state < graph.NumStates(); ++state) order[state] = state;
+  std::sort(order.begin(), order.end(), [&graph](int a, int b) {
+    return graph.HashValue(a) < graph.HashValue(b);
+  });
+  std::vector<uint64_t> hashes;
+  std::vector<double> values;
+  std::vector<int32_t> distances;
+  hashes.reserve(order.size());
+  values.reserve(order.size());
+  distances.reserve(order.size());
+  for (int state : order) {
+    hashes.push_back(graph.HashValue(state));
+    values.push_back(solver.values()[state]);
+    distances.push_back(solver.distances()[state]);
+  }
+  const std::string game_string = game->ToString();
+
+  Header header;
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.reserved = 0;
+  header.num_states = hashes.size();
+  header.game_string_bytes = game_string.size();
+
+  // Written next to the tablebase first, so that it is never seen half
+  // written, even by processes which have it mapped.
+  const std::string tmp_filename = absl::StrCat(filename, ".tmp");
+  {
+    file::File file(tmp_filename, "wb");
+    WriteBytes(&file, &header, 1);
+    WriteBytes(&file, hashes.data(), hashes.size());
+    WriteBytes(&file, values.data(), values.size());
+    WriteBytes(&file, distances.data(), distances.size());
+    WriteBytes(&file, game_string.data(), game_string.size());
+    SPIEL_CHECK_TRUE(file.Flush());
+  }
+  if (std::rename(tmp_filename.c_str(), filename.c_str()) != 0) {
+    SpielFatalError(absl::StrCat("Could not write the tablebase ", filename));
+  }
+}
+
+// Lookups are binary searches, which gain nothing from read-ahead.
+EndgameTablebase::EndgameTablebase(const std::string& filename)
+    : file_(filename, {file::MMapFile::Access::kRandom}) {
+  const char* data = file_.data();
+  const int64_t size = file_.size();
+  if (size < static_cast<int64_t>(sizeof(Header))) {
+    SpielFatalError(absl::StrCat(filename, " is not an endgame tablebase"));
+  }
+
+  const Header* header = reinterpret_cast<const Header*>(data);
+  if (std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0) {
+    SpielFatalError(absl::StrCat(filename, " is not an endgame tablebase"));
+  }
+  if (header->version != kVersion) {
+    SpielFatalError(absl::StrCat("Unsupported version ", header->version,
+                                 " of the endgame tablebase ", filename));
+  }
+  num_states_ = header->num_states;
+
+  const char* next = data + sizeof(Header);
+  hashes_ = reinterpret_cast<const uint64_t*>(next);
+  next += num_states_ * sizeof(uint64_t);
+  values_ = reinterpret_cast<const double*>(next);
+  next += num_states_ * sizeof(double);
+  distances_ = reinterpret_cast<const int32_t*>(next);
+  next += num_states_ * sizeof(int32_t);
+  game_string_ = absl::string_view(next, header->game_string_bytes);
+  next += header->game_string_bytes;
+  if (next - data != size) {
+    SpielFatalError(absl::StrCat("The endgame tablebase ", filename,
+                                 " has the wrong size: ", size, " bytes instead"
+                                 " of ", next - data));
+  }
+}
+
+int64_t EndgameTablebase::Find(uint64_t hash) const {
+  const uint64_t* it = std::lower_bound(hashes_, hashes_ + num_states_, hash);
+  return it != hashes_ + num_states_ && *it == hash ? it - hashes_ : -1;
+}
+
+std::optional<double> EndgameTablebase::PlayerValue(const State& state,
+                                                    Player player) const {
+  const int64_t id = Find(state);
+  if (id < 0) return std::nullopt;
+  return ValueForPlayer(player, values_[id]);
+}
+
+EndgameTablebaseEvaluator::EndgameTablebaseEvaluator(
+    std::shared_ptr<const EndgameTablebase> tablebase,
+    std::shared_ptr<Evaluator> fallback)
+    : tablebase_(std::move(tablebase)), fallback_(std::move(fallback)) {
+  SPIEL_CHECK_TRUE(tablebase_ != nullptr);
+  SPIEL_CHECK_TRUE(fallback_ != nullptr);
+}
+
+std::vector<double> EndgameTablebaseEvaluator::Evaluate(const State& state) {
+  const int64_t id = tablebase_->Find(state);
+  if (id < 0) return fallback_->Evaluate(state);
+  const double value = tablebase_->Value(id);
+  if (state.NumPlayers() == 1) return {value};
+  return {value, -value};
+}
+
+ActionsAndProbs EndgameTablebaseEvaluator::Prior(const State& state) {
+  return fallback_->Prior(state);
+}
+
+std::function<std::optional<double>(const State&)> EndgameTablebaseOracle(
+    std::shared_ptr<const EndgameTablebase> tablebase) {
+  return [tablebase = std::move(tablebase)](const State& state) {
+    return tablebase->PlayerValue(state, state.CurrentPlayer());
+  };
+}
+
+std::function<double(const State&)> EndgameTablebaseValueFunction(
+    std::shared_ptr<const EndgameTablebase> tablebase,
+    Player maximizing_player, std::function<double(const State&)> fallback) {
+  return [tablebase = std::move(tablebase), maximizing_player,
+          fallback = std::move(fallback)](const State& state) {
+    std::optional<double> value =
+        tablebase->PlayerValue(state, maximizing_player);
+    if (value.has_value()) return *value;
+    if (!fallback) {
+      SpielFatalError(absl::StrCat("The state is not in the tablebase:\n",
+                                   state.ToString()));
+    }
+    return fallback(state);
+  };
+}
+
+}  // namespace algorithms
+}  // namespace open_spiel
@@ -0,0 +1,136 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_ALGORITHMS_ENDGAME_TABLEBASE_H_
+#define OPEN_SPIEL_ALGORITHMS_ENDGAME_TABLEBASE_H_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/strings/string_view.h"
+#include "open_spiel/algorithms/mcts.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/utils/file.h"
+
+// Endgame tablebases: the exact values of all the states reachable from an
+// endgame position, solved once by retrograde analysis and written to a file
+// which is mapped into memory as it is to be looked up, so that searches
+// reaching the endgame stop there instead of solving it again.
+//
+// States are identified by State::HashValue(), as in a StateGraph (see
+// get_all_states.h), so the transpositions the hash recognizes share their
+// entry, and the table is as small as the game's hash makes it. The file
+// starts with a header, followed by the hashes of the states in increasing
+// order, their values and their distances, and the string of the game. The
+// numbers are written in the byte order of the machine, so a tablebase should
+// be read on the same architecture that wrote it.
+namespace open_spiel {
+namespace algorithms {
+
+// Solves all the states reachable from root, and writes them to filename.
+// The game must be sequential, with perfect information, and have one player
+// or two with zero-sum returns. It may have chance nodes.
+//
+// The states are solved backwards from the terminals: a state is solved as
+// soon as one of its successors gives the player to move the game's maximum
+// utility, or else once all of them are solved. The distance of a state is
+// the number of moves to the end of the game, when the player to move wins
+// as quickly as possible and otherwise loses or draws as late as possible;
+// at chance nodes, it is the longest distance of the outcomes. In games with
+// cycles among the states the hash recognizes, the states left unsolved are
+// those neither player can leave without losing: they are drawn, with a value
+// of 0 and no distance. Cycles through chance nodes are not supported.
+//
+// The states are found on num_threads threads.
+void BuildEndgameTablebase(const State& root, const std::string& filename,
+                           int num_threads = 1);
+
+// A tablebase file, mapped read-only for as long as this lives. Lookups are a
+// binary search over the file, and can be made from several threads at once.
+class EndgameTablebase {
+ public:
+  // The distance of drawn states on cycles.
+  static constexpr int kNoDistance = -1;
+
+  explicit EndgameTablebase(const std::string& filename);
+
+  EndgameTablebase(const EndgameTablebase&) = delete;
+  EndgameTablebase& operator=(const EndgameTablebase&) = delete;
+
+  int64_t NumStates() const { return num_states_; }
+
+  // The game that was solved, as returned by Game::ToString().
+  absl::string_view GameString() const { return game_string_; }
+
+  // Returns the entry of the state with this hash, or -1 if there is none.
+  int64_t Find(uint64_t hash) const;
+  int64_t Find(const State& state) const { return Find(state.HashValue()); }
+
+  uint64_t HashValue(int64_t id) const { return hashes_[id]; }
+
+  // The value of a state for player 0, and for the other player of two,
+  // its opposite.
+  double Value(int64_t id) const { return values_[id]; }
+  int Distance(int64_t id) const { return distances_[id]; }
+
+  // The value of the state for the player, or nothing if the state is not in
+  // the table.
+  std::optional<double> PlayerValue(const State& state, Player player) const;
+
+ private:
+  file::MMapFile file_;
+  int64_t num_states_;
+  const uint64_t* hashes_;
+  const double* values_;
+  const int32_t* distances_;
+  absl::string_view game_string_;
+};
+
+// An MCTS evaluator returning the values of the states in the tablebase,
+// and those of fallback for the others. The priors are always fallback's.
+class EndgameTablebaseEvaluator : public Evaluator {
+ public:
+  EndgameTablebaseEvaluator(std::shared_ptr<const EndgameTablebase> tablebase,
+                            std::shared_ptr<Evaluator> fallback);
+
+  std::vector<double> Evaluate(const State& state) override;
+  ActionsAndProbs Prior(const State& state) override;
+
+ private:
+  std::shared_ptr<const EndgameTablebase> tablebase_;
+  std::shared_ptr<Evaluator> fallback_;
+};
+
+// A leaf oracle for AlphaBetaSearcher::SetOracle (see minimax.h), giving the
+// exact values of the states in the tablebase for the player to move.
+std::function<std::optional<double>(const State&)> EndgameTablebaseOracle(
+    std::shared_ptr<const EndgameTablebase> tablebase);
+
+// A value function for AlphaBetaSearch, giving the values of the states in
+// the tablebase for the maximizing player, and those of fallback for the
+// others. Without fallback, all the states it is called on must be in the
+// tablebase.
+std::function<double(const State&)> EndgameTablebaseValueFunction(
+    std::shared_ptr<const EndgameTablebase> tablebase,
+    Player maximizing_player,
+    std::function<double(const State&)> fallback = nullptr);
+
+}  // namespace algorithms
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_ALGORITHMS_ENDGAME_TABLEBASE_H_
@@ -0,0 +1,121 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/endgame_tablebase.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/algorithms/get_all_states.h"
+#include "open_spiel/algorithms/mcts.h"
+#include "open_spiel/algorithms/minimax.h"
+#include "open_spiel/algorithms/value_iteration.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/file.h"
+
+namespace open_spiel {
+namespace algorithms {
+namespace {
+
+std::string TablebaseFilename(const std::string& name) {
+  return absl::StrCat(file::GetTmpDir(), "/open_spiel-test-",
+                      std::rand(), "-", name);  // NOLINT
+}
+
+// The tablebase has the values value iteration finds for all the states.
+void CheckSameValues(const std::string& game_name, double tolerance) {
+  std::shared_ptr<const Game> game = LoadGame(game_name);
+  const std::string filename = TablebaseFilename(game_name);
+  BuildEndgameTablebase(*game->NewInitialState(), filename,
+                        /*num_threads=*/2);
+  const EndgameTablebase tablebase(filename);
+  SPIEL_CHECK_EQ(tablebase.GameString(), game->ToString());
+
+  const StateGraph graph(*game);
+  const std::vector<double> values = ValueIteration(graph, /*threshold=*/1e-9);
+  SPIEL_CHECK_EQ(tablebase.NumStates(), graph.NumStates());
+  for (int state = 0; state < graph.NumStates(); ++state) {
+    const int64_t id = tablebase.Find(graph.HashValue(state));
+    SPIEL_CHECK_GE(id, 0);
+    SPIEL_CHECK_EQ(tablebase.HashValue(id), graph.HashValue(state));
+    SPIEL_CHECK_LE(std::abs(tablebase.Value(id) - values[state]), tolerance);
+    SPIEL_CHECK_GE(tablebase.Distance(id), 0);
+  }
+  SPIEL_CHECK_EQ(tablebase.Find(~graph.HashValue(StateGraph::kRoot)), -1);
+  SPIEL_CHECK_TRUE(file::Remove(filename));
+}
+
+void EndgameTablebaseTest_TicTacToe() {
+  std::shared_ptr<const Game> game = LoadGame("tic_tac_toe");
+  std::unique_ptr<State> state = game->NewInitialState();
+  for (Action action : {0, 3, 1, 4}) state->ApplyAction(action);
+
+  // Construct:
+  // xx.
+  // oo.
+  // ...
+  // where x wins at once, and o would win next.
+  const std::string filename = TablebaseFilename("tic_tac_toe");
+  BuildEndgameTablebase(*state, filename);
+  auto tablebase = std::make_shared<const EndgameTablebase>(filename);
+  const int64_t id = tablebase->Find(*state);
+  SPIEL_CHECK_EQ(tablebase->Value(id), 1);
+  SPIEL_CHECK_EQ(tablebase->Distance(id), 1);
+  SPIEL_CHECK_EQ(*tablebase->PlayerValue(*state, 1), -1);
+  SPIEL_CHECK_FALSE(tablebase->PlayerValue(*game->NewInitialState(), 0));
+
+  std::unique_ptr<State> child = state->Child(8);
+  SPIEL_CHECK_EQ(tablebase->Value(tablebase->Find(*child)), -1);
+  SPIEL_CHECK_EQ(tablebase->Distance(tablebase->Find(*child)), 1);
+
+  EndgameTablebaseEvaluator evaluator(
+      tablebase, std::make_shared<RandomRolloutEvaluator>(1, 0));
+  SPIEL_CHECK_TRUE(evaluator.Evaluate(*child) == std::vector<double>({-1, 1}));
+  SPIEL_CHECK_EQ(evaluator.Prior(*child).size(), 4);
+
+  // The search stops at the states in the tablebase, so it finds their
+  // values without searching them.
+  AlphaBetaSearcher searcher(*game, /*value_function=*/nullptr);
+  searcher.SetOracle(EndgameTablebaseOracle(tablebase));
+  const auto [value, action] = searcher.Search(*state, /*depth_limit=*/-1);
+  SPIEL_CHECK_EQ(value, 1);
+  SPIEL_CHECK_EQ(action, 2);
+  SPIEL_CHECK_TRUE(searcher.LastSearchSolved());
+  SPIEL_CHECK_LE(searcher.NumStatesVisited(), 1 + 4);
+
+  SPIEL_CHECK_EQ(
+      AlphaBetaSearch(*game, state.get(),
+                      EndgameTablebaseValueFunction(tablebase, 0),
+                      /*depth_limit=*/1, /*maximizing_player=*/0)
+          .first,
+      1);
+  SPIEL_CHECK_TRUE(file::Remove(filename));
+}
+
+}  // namespace
+}  // namespace algorithms
+}  // namespace open_spiel
+
+namespace algorithms = open_spiel::algorithms;
+
+int main(int argc, char** argv) {
+  algorithms::CheckSameValues("tic_tac_toe", 0);
+  algorithms::CheckSameValues("catch", 1e-6);
+  algorithms::EndgameTablebaseTest_TicTacToe();
+}
@@ -14,26 +14,53 @@
 
 #include "open_spiel/algorithms/evaluate_bots.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <random>
 #include <vector>
 
+#include "open_spiel/abseil-cpp/absl/synchronization/mutex.h"
+#include "open_spiel/abseil-cpp/absl/time/clock.h"
+#include "open_spiel/abseil-cpp/absl/time/time.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_bots.h"
+#include "open_spiel/utils/stats.h"
+#include "open_spiel/utils/thread.h"
 
 namespace open_spiel {
 
-std::vector<double> EvaluateBots(State* state, const std::vector<Bot*>& bots,
-                                 int seed) {
+namespace {
+
+Action TimedStep(Bot* bot, const State& state, Player player,
+                 std::vector<LatencyHistogram>* step_latency_us) {
+  if (step_latency_us == nullptr) return bot->Step(state);
+  const absl::Time start = absl::Now();
+  const Action action = bot->Step(state);
+  (*step_latency_us)[player].Add(
+      absl::ToInt64Microseconds(absl::Now() - start));
+  return action;
+}
+
+// Plays the game as EvaluateBots, adding the time each Step took to
+// step_latency_us[player] if it isn't null.
+std::vector<double> PlayGame(State* state, const std::vector<Bot*>& bots,
+                             int seed,
+                             std::vector<LatencyHistogram>* step_latency_us) {
   const int num_players = bots.size();
   std::mt19937 rng(seed);
   std::vector<Action> joint_actions(bots.size());
-  if (state->History().empty()) {
+  if (state->FullHistory().empty()) {
     for (auto bot : bots) bot->Restart();
   } else {
     for (auto bot : bots) bot->RestartAt(*state);
   }
   while (!state->IsTerminal()) {
     if (state->IsChanceNode()) {
-      Action action = SampleAction(state->ChanceOutcomes(), rng).first;
+      Action action = state->SampleChanceOutcome(rng).first;
       for (auto bot : bots) bot->InformAction(*state, kChancePlayerId, action);
       state->ApplyAction(action);
     } else if (state->IsSimultaneousNode()) {
@@ -41,13 +68,14 @@ std::vector<double> EvaluateBots(State* state, const std::vector<Bot*>& bots,
         if (state->LegalActions(p).empty()) {
           joint_actions[p] = kInvalidAction;
         } else {
-          joint_actions[p] = bots[p]->Step(*state);
+          joint_actions[p] = TimedStep(bots[p], *state, p, step_latency_us);
         }
       }
       state->ApplyActions(joint_actions);
     } else {
       Player current_player = state->CurrentPlayer();
-      Action action = bots[current_player]->Step(*state);
+      Action action = TimedStep(bots[current_player], *state, current_player,
+                                step_latency_us);
       for (Player p = 0; p < num_players; ++p) {
         if (p != current_player) {
           bots[p]->InformAction(*state, current_player, action);
@@ -61,4 +89,100 @@ std::vector<double> EvaluateBots(State* state, const std::vector<Bot*>& bots,
   return state->Returns();
 }
 
+}  // namespace
+
+std::vector<double> EvaluateBots(State* state, const std::vector<Bot*>& bots,
+                                 int seed) {
+  return PlayGame(state, bots, seed, /*step_latency_us=*/nullptr);
+}
+
+double TournamentResults::ConfidenceHalfWidth(const BasicStats& stats,
+                                              double z) {
+  if (stats.Num() < 2) return std::numeric_limits<double>::infinity();
+  return z * stats.StdDev() / std::sqrt(stats.Num());
+}
+
+TournamentResults PlayTournament(const Game& game,
+                                 const std::vector<BotFactory>& bots,
+                                 const TournamentOptions& options) {
+  const int num_players = game.NumPlayers();
+  SPIEL_CHECK_EQ(bots.size(), num_players);
+  if (options.stop_early) SPIEL_CHECK_GE(num_players, 2);
+
+  // The seeds of each game: one for chance, then one per bot.
+  std::mt19937 rng(options.seed);
+  std::vector<int> seeds(options.num_games * (num_players + 1));
+  for (int& seed : seeds) {
+    seed = std::uniform_int_distribution<int>(
+        0, std::numeric_limits<int>::max())(rng);
+  }
+
+  TournamentResults results;
+  results.returns.resize(num_players);
+  results.step_latency_us.resize(num_players);
+  absl::Mutex m;
+  // The returns of each bot in each game, until they are counted in order.
+  std::vector<std::vector<double>> game_returns(options.num_games);
+  int num_counted = 0;  // Guarded by m, as are game_returns and results.
+  std::atomic<int> next_game{0};
+  std::atomic<bool> stop{false};
+
+  auto play = [&]() {
+    while (!stop) {
+      const int g = next_game++;
+      if (g >= options.num_games) return;
+      const int* game_seeds = &seeds[g * (num_players + 1)];
+      // The bot in each seat.
+      std::vector<int> seat_bot(num_players);
+      for (int i = 0; i < num_players; ++i) {
+        const Player seat = options.rotate_seats ? (i + g) % num_players : i;
+        seat_bot[seat] = i;
+      }
+      std::vector<std::unique_ptr<Bot>> seat_bots;
+      std::vector<Bot*> bot_ptrs;
+      for (Player seat = 0; seat < num_players; ++seat) {
+        seat_bots.push_back(
+            bots[seat_bot[seat]](game, seat, game_seeds[1 + seat_bot[seat]]));
+        bot_ptrs.push_back(seat_bots.back().get());
+      }
+      std::vector<LatencyHistogram> seat_latency(num_players);
+      const std::vector<double> seat_returns = PlayGame(
+          game.NewInitialState().get(), bot_ptrs, game_seeds[0], &seat_latency);
+
+      absl::MutexLock lock(&m);
+      std::vector<double>& returns = game_returns[g];
+      returns.resize(num_players);
+      for (Player seat = 0; seat < num_players; ++seat) {
+        returns[seat_bot[seat]] = seat_returns[seat];
+        results.step_latency_us[seat_bot[seat]] += seat_latency[seat];
+      }
+      // Count the games completed in order, up to the first significant one.
+      while (!stop && num_counted < options.num_games &&
+             !game_returns[num_counted].empty()) {
+        const std::vector<double>& counted = game_returns[num_counted++];
+        for (int i = 0; i < num_players; ++i) {
+          results.returns[i].Add(counted[i]);
+        }
+        if (num_players >= 2) results.margin.Add(counted[0] - counted[1]);
+        if (options.stop_early && num_counted >= options.min_games &&
+            std::abs(results.margin.Avg()) >
+                TournamentResults::ConfidenceHalfWidth(results.margin,
+                                                       options.z)) {
+          results.stopped_early = true;
+          stop = true;
+        }
+      }
+    }
+  };
+  const int num_threads = std::max(1, options.num_threads);
+  if (num_threads == 1) {
+    play();
+  } else {
+    ThreadPool::Default()->ParallelFor(
+        0, num_threads, 1, [&play](int64_t, int64_t) { play(); });
+  }
+  results.num_games = num_counted;
+  return results;
+}
+
 }  // namespace open_spiel
@@ -15,10 +15,13 @@
 #ifndef OPEN_SPIEL_ALGORITHMS_EVALUATE_BOTS_H_
 #define OPEN_SPIEL_ALGORITHMS_EVALUATE_BOTS_H_
 
+#include <functional>
+#include <memory>
 #include <vector>
 
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_bots.h"
+#include "open_spiel/utils/stats.h"
 
 namespace open_spiel {
 
@@ -29,6 +32,59 @@ namespace open_spiel {
 std::vector<double> EvaluateBots(State* state, const std::vector<Bot*>& bots,
                                  int seed);
 
+// Makes a new bot to play as the given player, seeded with seed.
+using BotFactory =
+    std::function<std::unique_ptr<Bot>(const Game& game, Player player,
+                                       int seed)>;
+
+struct TournamentOptions {
+  // The most games to play.
+  int num_games = 100;
+  int seed = 0;
+  // The games are shared out between this many workers of the shared
+  // ThreadPool. The bots of a game only ever run on one thread, but the
+  // factories are called concurrently.
+  int num_threads = 1;
+  // Whether the bots change seats from one game to the next: in game g, bot i
+  // plays as player (i + g) % num_players. Otherwise bot i is always player i.
+  bool rotate_seats = true;
+  // Whether to stop once the first two bots' mean returns differ
+  // significantly, i.e. once the confidence interval of the mean difference
+  // between their returns excludes 0, after at least min_games games.
+  // The interval is checked after every game, so a larger z than for a single
+  // test keeps the chance of stopping on a fluke low.
+  bool stop_early = false;
+  int min_games = 20;
+  double z = 3.0;
+};
+
+struct TournamentResults {
+  // The games played and counted.
+  int num_games = 0;
+  bool stopped_early = false;
+  // The returns of each bot, whichever seat it played.
+  std::vector<BasicStats> returns;
+  // The first bot's return minus the second's, per game.
+  BasicStats margin;
+  // How long each bot's Step took, in microseconds, over every game played,
+  // counted or not.
+  std::vector<LatencyHistogram> step_latency_us;
+
+  // Half the width of the confidence interval of a mean, e.g. of a bot's
+  // returns, from the normal approximation.
+  static double ConfidenceHalfWidth(const BasicStats& stats, double z);
+};
+
+// Plays up to options.num_games games between bots made by the factories,
+// one per player, each game with new bots and its own seeds drawn from
+// options.seed. When stopping early, the results only count the games up to
+// the first one which made the margin significant, in the order of the games,
+// so that they don't depend on the number of threads if the bots are
+// deterministic given their seeds.
+TournamentResults PlayTournament(const Game& game,
+                                 const std::vector<BotFactory>& bots,
+                                 const TournamentOptions& options);
+
 }  // namespace open_spiel
 
 #endif  // OPEN_SPIEL_ALGORITHMS_EVALUATE_BOTS_H_
@@ -70,10 +70,70 @@ void BotTest_RandomVsRandomPolicy() {
   SPIEL_CHECK_FLOAT_NEAR(average_results[1], -0.125, 0.01);
 }
 
+void TournamentTest() {
+  auto game = LoadGame("kuhn_poker");
+  std::vector<BotFactory> factories(2, [](const Game& game, Player player,
+                                          int seed) {
+    return MakeUniformRandomBot(player, seed);
+  });
+  TournamentOptions options;
+  options.num_games = 20000;
+
+  // The first player's advantage evens out when the bots change seats.
+  TournamentResults results = PlayTournament(*game, factories, options);
+  SPIEL_CHECK_EQ(results.num_games, options.num_games);
+  SPIEL_CHECK_FALSE(results.stopped_early);
+  SPIEL_CHECK_EQ(results.returns[0].Num(), options.num_games);
+  SPIEL_CHECK_FLOAT_NEAR(results.returns[0].Avg(), 0, 0.03);
+  SPIEL_CHECK_FLOAT_NEAR(results.returns[1].Avg(), 0, 0.03);
+  SPIEL_CHECK_GT(results.step_latency_us[0].Num(), options.num_games);
+  SPIEL_CHECK_GT(TournamentResults::ConfidenceHalfWidth(results.returns[0],
+                                                        1.96),
+                 0);
+
+  options.rotate_seats = false;
+  results = PlayTournament(*game, factories, options);
+  SPIEL_CHECK_FLOAT_NEAR(results.returns[0].Avg(), 0.125, 0.03);
+  SPIEL_CHECK_FLOAT_NEAR(results.margin.Avg(), 0.25, 0.06);
+
+  // The results don't depend on the number of threads.
+  options.num_threads = 4;
+  TournamentResults threaded = PlayTournament(*game, factories, options);
+  SPIEL_CHECK_EQ(threaded.num_games, results.num_games);
+  SPIEL_CHECK_EQ(threaded.returns[0].Avg(), results.returns[0].Avg());
+  SPIEL_CHECK_EQ(threaded.margin.StdDev(), results.margin.StdDev());
+}
+
+void TournamentStopsEarlyTest() {
+  // Always betting beats playing at random by far.
+  auto game = LoadGame("kuhn_poker");
+  std::vector<BotFactory> factories = {
+      [](const Game& game, Player player, int seed) {
+        return MakeFixedActionPreferenceBot(player, {1});
+      },
+      [](const Game& game, Player player, int seed) {
+        return MakeUniformRandomBot(player, seed);
+      }};
+  TournamentOptions options;
+  options.num_games = 100000;
+  options.stop_early = true;
+  for (int num_threads : {1, 4}) {
+    options.num_threads = num_threads;
+    TournamentResults results = PlayTournament(*game, factories, options);
+    SPIEL_CHECK_TRUE(results.stopped_early);
+    SPIEL_CHECK_LT(results.num_games, options.num_games);
+    SPIEL_CHECK_GE(results.num_games, options.min_games);
+    SPIEL_CHECK_GT(results.margin.Avg(), 0);
+    SPIEL_CHECK_EQ(results.returns[1].Num(), results.num_games);
+  }
+}
+
 }  // namespace
 }  // namespace open_spiel
 
 int main(int argc, char** argv) {
   open_spiel::BotTest_RandomVsRandom();
   open_spiel::BotTest_RandomVsRandomPolicy();
+  open_spiel::TournamentTest();
+  open_spiel::TournamentStopsEarlyTest();
 }
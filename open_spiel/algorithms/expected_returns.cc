@@ -14,233 +14,333 @@
 
 #include "open_spiel/algorithms/expected_returns.h"
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <functional>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "open_spiel/abseil-cpp/absl/container/flat_hash_map.h"
+#include "open_spiel/abseil-cpp/absl/synchronization/mutex.h"
+#include "open_spiel/algorithms/scoped_child.h"
 #include "open_spiel/simultaneous_move_game.h"
 #include "open_spiel/spiel.h"
+#include "open_spiel/utils/thread.h"
 
 namespace open_spiel {
 namespace algorithms {
 namespace {
 
+// Gets the policy of a player at a state.
+using PolicyFunc = std::function<ActionsAndProbs(Player, const State&)>;
+
+// The returns of the states evaluated so far, keyed by their hash and the
+// depth left below them (or -1 without a depth limit). It is split in shards,
+// each with its own lock, so that threads rarely wait for each other.
+class TranspositionCache {
+ public:
+  using Key = std::pair<uint64_t, int>;
+
+  bool Find(const Key& key, std::vector<double>* values) {
+    Shard& shard = shards_[key.first % kNumShards];
+    absl::MutexLock lock(&shard.mutex);
+    auto it = shard.values.find(key);
+    if (it == shard.values.end()) return false;
+    *values = it->second;
+    return true;
+  }
+
+  void Insert(const Key& key, const std::vector<double>& values) {
+    Shard& shard = shards_[key.first % kNumShards];
+    absl::MutexLock lock(&shard.mutex);
+    shard.values.emplace(key, values);
+  }
+
+ private:
+  static constexpr int kNumShards = 64;
+
+  struct Shard {
+    absl::Mutex mutex;
+    absl::flat_hash_map<Key, std::vector<double>> values;
+  };
+
+  std::array<Shard, kNumShards> shards_;
+};
+
 // Implements the recursive traversal using a general way to access the
 // player's policies via a function that takes as arguments the player id and
-// information state.
-// We have a special case for the case where we can get a policy just from the
-// InfostateString as that gives us a 2x speedup.
-std::vector<double> ExpectedReturnsImpl(
-    const State& state,
-    const std::function<ActionsAndProbs(Player, const std::string&)>&
-        policy_func,
-    int depth_limit) {
-  if (state.IsTerminal() || depth_limit == 0) {
-    return state.Rewards();
-  }
+// the state.
+class ExpectedReturnsWalker {
+ public:
+  ExpectedReturnsWalker(const PolicyFunc& policy_func,
+                        bool use_transposition_cache)
+      : policy_func_(policy_func),
+        cache_(use_transposition_cache ? std::make_unique<TranspositionCache>()
+                                       : nullptr) {}
 
-  int num_players = state.NumPlayers();
-  std::vector<double> values(num_players, 0.0);
-  if (state.IsChanceNode()) {
-    ActionsAndProbs action_and_probs = state.ChanceOutcomes();
-    for (const auto& action_and_prob : action_and_probs) {
-      std::unique_ptr<State> child = state.Child(action_and_prob.first);
-      std::vector<double> child_values =
-          ExpectedReturnsImpl(*child, policy_func, depth_limit - 1);
-      for (auto p = Player{0}; p < num_players; ++p) {
-        values[p] += action_and_prob.second * child_values[p];
-      }
+  // The returns of the state, which is back to its original value
+  // afterwards. The children of the state, if it is the root, or of chance
+  // nodes are shared out between num_threads threads.
+  std::vector<double> Evaluate(State* state, int depth_limit, int num_threads,
+                               bool is_root) {
+    if (state->IsTerminal() || depth_limit == 0) {
+      return state->Rewards();
     }
-  } else if (state.IsSimultaneousNode()) {
-    // Walk over all the joint actions, and weight by the product of
-    // probabilities to choose them.
-    values = state.Rewards();
-    auto smstate = dynamic_cast<const SimMoveState*>(&state);
-    SPIEL_CHECK_TRUE(smstate != nullptr);
-    std::vector<ActionsAndProbs> state_policies(num_players);
-    for (auto p = Player{0}; p < num_players; ++p) {
-      state_policies[p] = policy_func(p, state.InformationStateString(p));
-      if (state_policies[p].empty()) {
-        SpielFatalError("Error in ExpectedReturnsImpl; infostate not found.");
+    const TranspositionCache::Key key(state->HashValue(),
+                                      std::max(depth_limit, -1));
+    std::vector<double> values;
+    if (cache_ != nullptr && cache_->Find(key, &values)) return values;
+
+    // Chance nodes have no rewards.
+    values = state->IsChanceNode() ? std::vector<double>(state->NumPlayers(), 0)
+                                   : state->Rewards();
+    const ActionsAndProbs branches = Branches(*state);
+    if (num_threads > 1 && branches.size() > 1 &&
+        (is_root || state->IsChanceNode())) {
+      EvaluateInParallel(*state, branches, depth_limit, num_threads, &values);
+    } else {
+      for (const auto& [action, prob] : branches) {
+        std::vector<double> child_values;
+        if (state->IsSimultaneousNode()) {
+          child_values = Evaluate(Child(*state, action).get(), depth_limit - 1,
+                                  num_threads, false);
+        } else {
+          ScopedChild child(state, action);
+          child_values =
+              Evaluate(child.get(), depth_limit - 1, num_threads, false);
+        }
+        for (auto p = Player{0}; p < state->NumPlayers(); ++p) {
+          values[p] += prob * child_values[p];
+        }
       }
     }
-    for (const Action flat_action : smstate->LegalActions()) {
-      std::vector<Action> actions =
-          smstate->FlatJointActionToActions(flat_action);
-      double joint_action_prob = 1.0;
+    SPIEL_CHECK_EQ(values.size(), state->NumPlayers());
+    if (cache_ != nullptr) cache_->Insert(key, values);
+    return values;
+  }
+
+ private:
+  // The children of a state to evaluate, with the probabilities of reaching
+  // them: the chance outcomes, the actions of the player to move, or the
+  // joint actions of a simultaneous node, as flat actions. The actions the
+  // policies never take are left out.
+  ActionsAndProbs Branches(const State& state) const {
+    if (state.IsChanceNode()) return state.ChanceOutcomes();
+    const int num_players = state.NumPlayers();
+    ActionsAndProbs branches;
+    if (state.IsSimultaneousNode()) {
+      // Walk over all the joint actions, and weight by the product of
+      // probabilities to choose them.
+      auto smstate = dynamic_cast<const SimMoveState*>(&state);
+      SPIEL_CHECK_TRUE(smstate != nullptr);
+      std::vector<ActionsAndProbs> state_policies(num_players);
       for (auto p = Player{0}; p < num_players; ++p) {
-        double player_action_prob = GetProb(state_policies[p], actions[p]);
-        SPIEL_CHECK_GE(player_action_prob, 0.0);
-        SPIEL_CHECK_LE(player_action_prob, 1.0);
-        joint_action_prob *= player_action_prob;
-        if (player_action_prob == 0.0) {
-          break;
+        state_policies[p] = policy_func_(p, state);
+        if (state_policies[p].empty()) {
+          SpielFatalError("Error in ExpectedReturnsImpl; infostate not found.");
         }
       }
-
-      if (joint_action_prob > 0.0) {
-        std::unique_ptr<State> child = state.Clone();
-        child->ApplyActions(actions);
-        std::vector<double> child_values =
-            ExpectedReturnsImpl(*child, policy_func, depth_limit - 1);
+      FlatJointActions joint_actions(*smstate);
+      for (auto it = joint_actions.begin(); it != joint_actions.end(); ++it) {
+        const std::vector<Action>& actions = *it;
+        double joint_action_prob = 1.0;
         for (auto p = Player{0}; p < num_players; ++p) {
-          values[p] += joint_action_prob * child_values[p];
+          double player_action_prob = GetProb(state_policies[p], actions[p]);
+          SPIEL_CHECK_GE(player_action_prob, 0.0);
+          SPIEL_CHECK_LE(player_action_prob, 1.0);
+          joint_action_prob *= player_action_prob;
+          if (player_action_prob == 0.0) {
+            break;
+          }
+        }
+        if (joint_action_prob > 0.0) {
+          branches.push_back({it.flat_action(), joint_action_prob});
         }
       }
+      return branches;
     }
-  } else {
+
     // Turn-based decision node.
-    Player player = state.CurrentPlayer();
-    ActionsAndProbs state_policy =
-        policy_func(player, state.InformationStateString());
+    ActionsAndProbs state_policy = policy_func_(state.CurrentPlayer(), state);
     if (state_policy.empty()) {
       SpielFatalError("Error in ExpectedReturnsImpl; infostate not found.");
     }
-    values = state.Rewards();
     for (const Action action : state.LegalActions()) {
-      std::unique_ptr<State> child = state.Child(action);
       double action_prob = GetProb(state_policy, action);
       SPIEL_CHECK_GE(action_prob, 0.0);
       SPIEL_CHECK_LE(action_prob, 1.0);
-      if (action_prob > 0.0) {
-        std::vector<double> child_values =
-            ExpectedReturnsImpl(*child, policy_func, depth_limit - 1);
-        for (auto p = Player{0}; p < num_players; ++p) {
-          values[p] += action_prob * child_values[p];
-        }
-      }
+      if (action_prob > 0.0) branches.push_back({action, action_prob});
     }
+    return branches;
   }
-  SPIEL_CHECK_EQ(values.size(), state.NumPlayers());
-  return values;
-}
 
-// Same as above, but the policy_func now takes a State as input in, rather
-// than a string.
-std::vector<double> ExpectedReturnsImpl(
-    const State& state,
-    const std::function<ActionsAndProbs(Player, const State&)>& policy_func,
-    int depth_limit) {
-  if (state.IsTerminal() || depth_limit == 0) {
-    return state.Rewards();
+  // The child of a state through one of its branches.
+  static std::unique_ptr<State> Child(const State& state, Action action) {
+    if (!state.IsSimultaneousNode()) return state.Child(action);
+    std::unique_ptr<State> child = state.Clone();
+    child->ApplyActions(
+        static_cast<const SimMoveState&>(state).FlatJointActionToActions(
+            action));
+    return child;
   }
 
-  int num_players = state.NumPlayers();
-  std::vector<double> values(num_players, 0.0);
-  if (state.IsChanceNode()) {
-    ActionsAndProbs action_and_probs = state.ChanceOutcomes();
-    for (const auto& action_and_prob : action_and_probs) {
-      std::unique_ptr<State> child = state.Child(action_and_prob.first);
-      std::vector<double> child_values =
-          ExpectedReturnsImpl(*child, policy_func, depth_limit - 1);
-      for (auto p = Player{0}; p < num_players; ++p) {
-        values[p] += action_and_prob.second * child_values[p];
+  // Evaluates the branches in contiguous ranges, one per thread, each with a
+  // share of the threads for the chance nodes below. The returns are summed
+  // in the order of the branches, so they do not depend on the threads.
+  void EvaluateInParallel(const State& state, const ActionsAndProbs& branches,
+                          int depth_limit, int num_threads,
+                          std::vector<double>* values) {
+    const int num_branches = branches.size();
+    const int num_workers = std::min(num_threads, num_branches);
+    std::vector<std::vector<double>> child_values(num_branches);
+    auto evaluate = [&](int worker) {
+      const int worker_threads = num_threads / num_workers +
+                                 (worker < num_threads % num_workers ? 1 : 0);
+      for (int i = num_branches * worker / num_workers;
+           i < num_branches * (worker + 1) / num_workers; ++i) {
+        child_values[i] = Evaluate(Child(state, branches[i].first).get(),
+                                   depth_limit - 1, worker_threads, false);
       }
+    };
+    std::vector<Thread> threads;
+    for (int worker = 1; worker < num_workers; ++worker) {
+      threads.emplace_back([&evaluate, worker]() { evaluate(worker); });
     }
-  } else if (state.IsSimultaneousNode()) {
-    // Walk over all the joint actions, and weight by the product of
-    // probabilities to choose them.
-    values = state.Rewards();
-    auto smstate = dynamic_cast<const SimMoveState*>(&state);
-    SPIEL_CHECK_TRUE(smstate != nullptr);
-    std::vector<ActionsAndProbs> state_policies(num_players);
-    for (auto p = Player{0}; p < num_players; ++p) {
-      state_policies[p] = policy_func(p, state);
-      if (state_policies[p].empty()) {
-        SpielFatalError("Error in ExpectedReturnsImpl; infostate not found.");
-      }
-    }
-    for (const Action flat_action : smstate->LegalActions()) {
-      std::vector<Action> actions =
-          smstate->FlatJointActionToActions(flat_action);
-      double joint_action_prob = 1.0;
-      for (auto p = Player{0}; p < num_players; ++p) {
-        double player_action_prob = GetProb(state_policies[p], actions[p]);
-        SPIEL_CHECK_GE(player_action_prob, 0.0);
-        SPIEL_CHECK_LE(player_action_prob, 1.0);
-        joint_action_prob *= player_action_prob;
-        if (player_action_prob == 0.0) {
-          break;
-        }
-      }
-
-      if (joint_action_prob > 0.0) {
-        std::unique_ptr<State> child = state.Clone();
-        child->ApplyActions(actions);
-        std::vector<double> child_values =
-            ExpectedReturnsImpl(*child, policy_func, depth_limit - 1);
-        for (auto p = Player{0}; p < num_players; ++p) {
-          values[p] += joint_action_prob * child_values[p];
-        }
-      }
-    }
-  } else {
-    // Turn-based decision node.
-    Player player = state.CurrentPlayer();
-    ActionsAndProbs state_policy = policy_func(player, state);
-    if (state_policy.empty()) {
-      SpielFatalError("Error in ExpectedReturnsImpl; infostate not found.");
-    }
-    values = state.Rewards();
-    for (const Action action : state.LegalActions()) {
-      std::unique_ptr<State> child = state.Child(action);
-      double action_prob = GetProb(state_policy, action);
-      SPIEL_CHECK_GE(action_prob, 0.0);
-      SPIEL_CHECK_LE(action_prob, 1.0);
-      if (action_prob > 0.0) {
-        std::vector<double> child_values =
-            ExpectedReturnsImpl(*child, policy_func, depth_limit - 1);
-        for (auto p = Player{0}; p < num_players; ++p) {
-          values[p] += action_prob * child_values[p];
-        }
+    evaluate(0);
+    for (Thread& thread : threads) thread.join();
+    for (int i = 0; i < num_branches; ++i) {
+      for (auto p = Player{0}; p < state.NumPlayers(); ++p) {
+        (*values)[p] += branches[i].second * child_values[i][p];
       }
     }
   }
-  SPIEL_CHECK_EQ(values.size(), state.NumPlayers());
-  return values;
+
+  const PolicyFunc& policy_func_;
+  std::unique_ptr<TranspositionCache> cache_;
+};
+
+std::vector<double> ExpectedReturnsImpl(const State& state,
+                                        const PolicyFunc& policy_func,
+                                        int depth_limit,
+                                        bool use_transposition_cache,
+                                        int num_threads) {
+  SPIEL_CHECK_GE(num_threads, 1);
+  std::unique_ptr<State> root = state.Clone();
+  ExpectedReturnsWalker walker(policy_func, use_transposition_cache);
+  return walker.Evaluate(root.get(), depth_limit, num_threads,
+                         /*is_root=*/true);
 }
+
 }  // namespace
 
 std::vector<double> ExpectedReturns(const State& state,
                                     const std::vector<const Policy*>& policies,
                                     int depth_limit,
-                                    bool use_infostate_get_policy) {
+                                    bool use_infostate_get_policy,
+                                    bool use_transposition_cache,
+                                    int num_threads) {
+  // Getting a policy from the information state string rather than the
+  // state gives a 2x speedup.
   if (use_infostate_get_policy) {
     return ExpectedReturnsImpl(
         state,
-        [&policies](Player player, const std::string& info_state) {
-          return policies[player]->GetStatePolicy(info_state);
+        [&policies](Player player, const State& state) {
+          return policies[player]->GetStatePolicy(
+              state.InformationStateString(player));
         },
-        depth_limit);
+        depth_limit, use_transposition_cache, num_threads);
   } else {
     return ExpectedReturnsImpl(
         state,
         [&policies](Player player, const State& state) {
           return policies[player]->GetStatePolicy(state);
         },
-        depth_limit);
+        depth_limit, use_transposition_cache, num_threads);
   }
 }
 
 std::vector<double> ExpectedReturns(const State& state,
                                     const Policy& joint_policy, int depth_limit,
-                                    bool use_infostate_get_policy) {
+                                    bool use_infostate_get_policy,
+                                    bool use_transposition_cache,
+                                    int num_threads) {
   if (use_infostate_get_policy) {
     return ExpectedReturnsImpl(
         state,
-        [&joint_policy](Player player, const std::string& info_state) {
-          return joint_policy.GetStatePolicy(info_state);
+        [&joint_policy](Player player, const State& state) {
+          return joint_policy.GetStatePolicy(
+              state.InformationStateString(player));
         },
-        depth_limit);
+        depth_limit, use_transposition_cache, num_threads);
   } else {
     return ExpectedReturnsImpl(
         state,
         [&joint_policy](Player player, const State& state) {
           return joint_policy.GetStatePolicy(state);
         },
-        depth_limit);
+        depth_limit, use_transposition_cache, num_threads);
   }
 }
 
+std::vector<double> ExpectedReturns(
+    const CompiledGameTree& tree, const std::vector<const Policy*>& policies) {
+  // The probabilities of the legal actions of each information state, looked
+  // up the first time it is reached.
+  std::vector<std::vector<double>> info_state_policies(tree.NumInfoStates());
+  auto info_state_policy = [&](int info_state) -> const std::vector<double>& {
+    std::vector<double>& probs = info_state_policies[info_state];
+    if (probs.empty()) {
+      ActionsAndProbs state_policy =
+          policies[tree.InfoStatePlayer(info_state)]->GetStatePolicy(
+              tree.InfoStateString(info_state));
+      if (state_policy.empty()) {
+        SpielFatalError("Error in ExpectedReturns; infostate not found.");
+      }
+      for (Action action : tree.InfoStateActions(info_state)) {
+        double action_prob = GetProb(state_policy, action);
+        SPIEL_CHECK_GE(action_prob, 0.0);
+        SPIEL_CHECK_LE(action_prob, 1.0);
+        probs.push_back(action_prob);
+      }
+    }
+    return probs;
+  };
+
+  // The children of a node come after it, so one pass from the root gives
+  // the probabilities of reaching every node.
+  const int num_players = tree.NumPlayers();
+  std::vector<double> reach_probs(tree.NumNodes(), 0.0);
+  std::vector<double> values(num_players, 0.0);
+  reach_probs[CompiledGameTree::kRoot] = 1.0;
+  for (int node = 0; node < tree.NumNodes(); ++node) {
+    const double reach_prob = reach_probs[node];
+    if (reach_prob == 0.0) continue;
+    if (tree.IsTerminal(node)) {
+      absl::Span<const double> returns = tree.Returns(node);
+      for (auto p = Player{0}; p < num_players; ++p) {
+        values[p] += reach_prob * returns[p];
+      }
+      continue;
+    }
+    absl::Span<const double> probs =
+        tree.IsChanceNode(node) ? tree.ChanceProbabilities(node)
+                                : info_state_policy(tree.InfoState(node));
+    absl::Span<const int> children = tree.Children(node);
+    for (int i = 0; i < children.size(); ++i) {
+      reach_probs[children[i]] = reach_prob * probs[i];
+    }
+  }
+  return values;
+}
+
+std::vector<double> ExpectedReturns(const CompiledGameTree& tree,
+                                    const Policy& joint_policy) {
+  return ExpectedReturns(
+      tree, std::vector<const Policy*>(tree.NumPlayers(), &joint_policy));
+}
+
 }  // namespace algorithms
 }  // namespace open_spiel
@@ -17,6 +17,7 @@
 
 #include <string>
 
+#include "open_spiel/algorithms/compiled_game_tree.h"
 #include "open_spiel/policy.h"
 #include "open_spiel/spiel.h"
 
@@ -34,13 +35,37 @@ namespace algorithms {
 // Policy::GetStatePolicy(const std::string&) rather than
 // Policy::GetStatePolicy(const State&) instead for retrieving the policy at
 // each information state; we use a default of true for performance reasons.
+//
+// With `use_transposition_cache`, the returns of each state are kept, keyed by
+// State::HashValue() and the depth left, so that the transpositions the hash
+// recognizes are only walked once. States with the same hash must then have
+// the same returns and information states. The default hash tells apart all
+// histories, so the cache only helps in games which override it.
+//
+// With `num_threads` > 1, the children of the state, and then those of the
+// chance nodes below them, are shared out between that many threads,
+// including the calling one, and the policies are called concurrently. The
+// returns are the same for any number of threads.
 std::vector<double> ExpectedReturns(const State& state,
                                     const std::vector<const Policy*>& policies,
                                     int depth_limit,
-                                    bool use_infostate_get_policy = true);
+                                    bool use_infostate_get_policy = true,
+                                    bool use_transposition_cache = false,
+                                    int num_threads = 1);
 std::vector<double> ExpectedReturns(const State& state,
                                     const Policy& joint_policy, int depth_limit,
-                                    bool use_infostate_get_policy = true);
+                                    bool use_infostate_get_policy = true,
+                                    bool use_transposition_cache = false,
+                                    int num_threads = 1);
+
+// The same over the whole of a compiled tree, e.g. to evaluate many policies
+// in the same game. It calls Policy::GetStatePolicy(const std::string&) once
+// for each information state, and then sums up the returns of the terminals
+// weighted by the probabilities of reaching them.
+std::vector<double> ExpectedReturns(const CompiledGameTree& tree,
+                                    const std::vector<const Policy*>& policies);
+std::vector<double> ExpectedReturns(const CompiledGameTree& tree,
+                                    const Policy& joint_policy);
 
 }  // namespace algorithms
 }  // namespace open_spiel
@@ -0,0 +1,57 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/expected_returns.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "open_spiel/policy.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace algorithms {
+namespace {
+
+// The cache and the threads give the same returns as the plain walk, with or
+// without a depth limit.
+void CheckSameReturns(const std::string& game_name) {
+  std::shared_ptr<const Game> game = LoadGame(game_name);
+  const TabularPolicy policy = GetUniformPolicy(*game);
+  std::unique_ptr<State> state = game->NewInitialState();
+  for (int depth_limit : {-1, 3}) {
+    const std::vector<double> expected =
+        ExpectedReturns(*state, policy, depth_limit);
+    for (bool use_transposition_cache : {false, true}) {
+      for (int num_threads : {1, 3, 8}) {
+        SPIEL_CHECK_TRUE(ExpectedReturns(*state, policy, depth_limit,
+                                         /*use_infostate_get_policy=*/true,
+                                         use_transposition_cache,
+                                         num_threads) == expected);
+      }
+    }
+  }
+}
+
+}  // namespace
+}  // namespace algorithms
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  open_spiel::algorithms::CheckSameReturns("kuhn_poker");
+  open_spiel::algorithms::CheckSameReturns("leduc_poker");
+  open_spiel::algorithms::CheckSameReturns("tic_tac_toe");
+}
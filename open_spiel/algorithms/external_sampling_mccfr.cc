@@ -14,32 +14,58 @@
 
 #include "open_spiel/algorithms/external_sampling_mccfr.h"
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
 #include <numeric>
 #include <random>
+#include <string>
+#include <vector>
 
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/abseil-cpp/absl/synchronization/mutex.h"
 #include "open_spiel/algorithms/cfr.h"
+#include "open_spiel/algorithms/cfr_checkpoint.h"
+#include "open_spiel/algorithms/policy_file.h"
 #include "open_spiel/policy.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/thread.h"
 
 namespace open_spiel {
 namespace algorithms {
+namespace {
 
-ExternalSamplingMCCFRSolver::ExternalSamplingMCCFRSolver(const Game& game,
-                                                         int seed,
-                                                         AverageType avg_type)
-    : ExternalSamplingMCCFRSolver(game, std::make_shared<UniformPolicy>(), seed,
-                                  avg_type) {}
+// Samples an action index from a policy with a uniform random number z, like
+// CFRInfoStateValues::SampleActionIndex without exploration.
+int SampleActionIndex(const std::vector<double>& policy, double z) {
+  double sum = 0;
+  for (int aidx = 0; aidx < policy.size(); ++aidx) {
+    if (z >= sum && z < sum + policy[aidx]) return aidx;
+    sum += policy[aidx];
+  }
+  SpielFatalError(absl::StrCat("SampleActionIndex: sum of probs is ", sum));
+}
+
+}  // namespace
+
+template <typename T>
+BasicExternalSamplingMCCFRSolver<T>::BasicExternalSamplingMCCFRSolver(
+    const Game& game, int seed, AverageType avg_type, int num_threads)
+    : BasicExternalSamplingMCCFRSolver(game, std::make_shared<UniformPolicy>(),
+                                       seed, avg_type, num_threads) {}
 
-ExternalSamplingMCCFRSolver::ExternalSamplingMCCFRSolver(
+template <typename T>
+BasicExternalSamplingMCCFRSolver<T>::BasicExternalSamplingMCCFRSolver(
     const Game& game, std::shared_ptr<Policy> default_policy, int seed,
-    AverageType avg_type)
+    AverageType avg_type, int num_threads)
     : game_(game.Clone()),
-      rng_(new std::mt19937(seed)),
+      rng_(seed),
       avg_type_(avg_type),
-      dist_(0.0, 1.0),
+      num_threads_(num_threads),
+      value_locks_(kNumValueLocks),
       default_policy_(default_policy) {
+  SPIEL_CHECK_GE(num_threads_, 1);
   if (game_->GetType().dynamics != GameType::Dynamics::kSequential) {
     SpielFatalError(
         "MCCFR requires sequential games. If you're trying to run it "
@@ -48,9 +74,86 @@ ExternalSamplingMCCFRSolver::ExternalSamplingMCCFRSolver(
   }
 }
 
-void ExternalSamplingMCCFRSolver::RunIteration() { RunIteration(rng_.get()); }
+template <typename T>
+void BasicExternalSamplingMCCFRSolver<T>::RunIteration() {
+  RunIteration(&rng_);
+}
+
+template <typename T>
+int BasicExternalSamplingMCCFRSolver<T>::RunIterations(int num_iterations,
+                                                       const StopToken* stop) {
+  auto stopped = [stop]() { return stop != nullptr && stop->StopRequested(); };
+  if (num_threads_ == 1) {
+    int i = 0;
+    for (; i < num_iterations && !stopped(); ++i) RunIteration();
+    return i;
+  }
+
+  const Philox iterations_rng(rng_());
+  std::atomic<int> next_iteration{0};
+  std::atomic<int> num_done{0};
+  auto run_iterations = [&]() {
+    for (int i = next_iteration++; i < num_iterations && !stopped();
+         i = next_iteration++) {
+      Philox rng = iterations_rng.Split(i);
+      RunIteration(&rng);
+      ++num_done;
+    }
+  };
+  std::vector<Thread> threads;
+  for (int i = 1; i < std::min(num_threads_, num_iterations); ++i) {
+    threads.emplace_back(run_iterations);
+  }
+  run_iterations();
+  for (Thread& thread : threads) thread.join();
+  return num_done;
+}
+
+template <typename T>
+int BasicExternalSamplingMCCFRSolver<T>::FindOrInsertInfoStateId(
+    const State& state, const std::string& info_state_key,
+    const std::vector<Action>& legal_actions) {
+  {
+    absl::ReaderMutexLock lock(&table_lock_);
+    const int id = info_states_.Find(info_state_key);
+    if (id >= 0) return id;
+  }
+  absl::MutexLock lock(&table_lock_);
+  return algorithms::FindOrInsertInfoStateId(
+      state, info_state_key, legal_actions, kInitialTableValues, &info_states_,
+      &info_state_keys_);
+}
+
+template <typename T>
+BasicCFRInfoStateValues<T> BasicExternalSamplingMCCFRSolver<T>::InfoStateValues(
+    int id) {
+  absl::ReaderMutexLock lock(&table_lock_);
+  return info_states_[id];
+}
+
+template <typename T>
+std::vector<double> BasicExternalSamplingMCCFRSolver<T>::RegretMatching(
+    int id) {
+  BasicCFRInfoStateValues<T> info_state = InfoStateValues(id);
+  absl::MutexLock lock(ValueLock(id));
+  info_state.ApplyRegretMatching();
+  return std::vector<double>(info_state.current_policy.begin(),
+                             info_state.current_policy.end());
+}
+
+template <typename T>
+void BasicExternalSamplingMCCFRSolver<T>::RunIteration(Philox* rng) {
+  RunIterationWith(rng);
+}
+
+template <typename T>
+void BasicExternalSamplingMCCFRSolver<T>::RunIteration(std::mt19937* rng) {
+  RunIterationWith(rng);
+}
 
-void ExternalSamplingMCCFRSolver::RunIteration(std::mt19937* rng) {
+template <typename T>
+template <typename Rng>
+void BasicExternalSamplingMCCFRSolver<T>::RunIterationWith(Rng* rng) {
   for (auto p = Player{0}; p < game_->NumPlayers(); ++p) {
     UpdateRegrets(*game_->NewInitialState(), p, rng);
   }
@@ -61,13 +164,16 @@ void ExternalSamplingMCCFRSolver::RunIteration(std::mt19937* rng) {
   }
 }
 
-double ExternalSamplingMCCFRSolver::UpdateRegrets(const State& state,
-                                                  Player player,
-                                                  std::mt19937* rng) {
+template <typename T>
+template <typename Rng>
+double BasicExternalSamplingMCCFRSolver<T>::UpdateRegrets(const State& state,
+                                                          Player player,
+                                                          Rng* rng) {
+  std::uniform_real_distribution<double> dist(0.0, 1.0);
   if (state.IsTerminal()) {
     return state.PlayerReturn(player);
   } else if (state.IsChanceNode()) {
-    Action action = SampleAction(state.ChanceOutcomes(), dist_(*rng)).first;
+    Action action = state.SampleChanceOutcome(dist(*rng)).first;
     return UpdateRegrets(*state.Child(action), player, rng);
   } else if (state.IsSimultaneousNode()) {
     SpielFatalError(
@@ -76,36 +182,31 @@ double ExternalSamplingMCCFRSolver::UpdateRegrets(const State& state,
   }
 
   Player cur_player = state.CurrentPlayer();
-  std::string is_key = state.InformationStateString(cur_player);
+  std::string is_key = state.InformationStateKey(cur_player);
   std::vector<Action> legal_actions = state.LegalActions();
 
-  // The insert here only inserts the default value if the key is not found,
-  // otherwise returns the entry in the map.
-  auto iter_and_result = info_states_.insert(
-      {is_key, CFRInfoStateValues(legal_actions, kInitialTableValues)});
-
-  CFRInfoStateValues info_state_copy = iter_and_result.first->second;
-  info_state_copy.ApplyRegretMatching();
+  const int id = FindOrInsertInfoStateId(state, is_key, legal_actions);
+  const std::vector<double> current_policy = RegretMatching(id);
 
   double value = 0;
   std::vector<double> child_values(legal_actions.size(), 0);
 
   if (cur_player != player) {
     // Sample at opponent nodes.
-    int aidx = info_state_copy.SampleActionIndex(0.0, dist_(*rng));
+    int aidx = SampleActionIndex(current_policy, dist(*rng));
     value = UpdateRegrets(*state.Child(legal_actions[aidx]), player, rng);
   } else {
     // Walk over all actions at my nodes
     for (int aidx = 0; aidx < legal_actions.size(); ++aidx) {
       child_values[aidx] =
           UpdateRegrets(*state.Child(legal_actions[aidx]), player, rng);
-      value += info_state_copy.current_policy[aidx] * child_values[aidx];
+      value += current_policy[aidx] * child_values[aidx];
     }
   }
 
   // Now the regret and avg strategy updates.
-  CFRInfoStateValues& info_state = info_states_[is_key];
-
+  BasicCFRInfoStateValues<T> info_state = InfoStateValues(id);
+  absl::MutexLock lock(ValueLock(id));
   if (cur_player == player) {
     // Update regrets
     for (int aidx = 0; aidx < legal_actions.size(); ++aidx) {
@@ -120,14 +221,15 @@ double ExternalSamplingMCCFRSolver::UpdateRegrets(const State& state,
       cur_player == ((player + 1) % game_->NumPlayers())) {
     for (int aidx = 0; aidx < legal_actions.size(); ++aidx) {
       info_state.cumulative_policy[aidx] +=
-          info_state_copy.current_policy[aidx];
+          current_policy[aidx];
     }
   }
 
   return value;
 }
 
-void ExternalSamplingMCCFRSolver::FullUpdateAverage(
+template <typename T>
+void BasicExternalSamplingMCCFRSolver<T>::FullUpdateAverage(
     const State& state, const std::vector<double>& reach_probs) {
   if (state.IsTerminal()) {
     return;
@@ -147,30 +249,48 @@ void ExternalSamplingMCCFRSolver::FullUpdateAverage(
   if (sum == 0.0) return;
 
   Player cur_player = state.CurrentPlayer();
-  std::string is_key = state.InformationStateString(cur_player);
+  std::string is_key = state.InformationStateKey(cur_player);
   std::vector<Action> legal_actions = state.LegalActions();
 
-  // The insert here only inserts the default value if the key is not found,
-  // otherwise returns the entry in the map.
-  auto iter_and_result = info_states_.insert(
-      {is_key, CFRInfoStateValues(legal_actions, kInitialTableValues)});
-
-  CFRInfoStateValues info_state_copy = iter_and_result.first->second;
-  info_state_copy.ApplyRegretMatching();
+  const int id = FindOrInsertInfoStateId(state, is_key, legal_actions);
+  const std::vector<double> current_policy = RegretMatching(id);
 
   for (int aidx = 0; aidx < legal_actions.size(); ++aidx) {
     std::vector<double> new_reach_probs = reach_probs;
-    new_reach_probs[cur_player] *= info_state_copy.current_policy[aidx];
+    new_reach_probs[cur_player] *= current_policy[aidx];
     FullUpdateAverage(*state.Child(legal_actions[aidx]), new_reach_probs);
   }
 
   // Now update the cumulative policy.
-  CFRInfoStateValues& info_state = info_states_[is_key];
+  BasicCFRInfoStateValues<T> info_state = InfoStateValues(id);
+  absl::MutexLock lock(ValueLock(id));
   for (int aidx = 0; aidx < legal_actions.size(); ++aidx) {
     info_state.cumulative_policy[aidx] +=
-        (reach_probs[cur_player] * info_state_copy.current_policy[aidx]);
+        (reach_probs[cur_player] * current_policy[aidx]);
   }
 }
 
+template <typename T>
+void BasicExternalSamplingMCCFRSolver<T>::SaveCheckpoint(
+    const std::string& filename) const {
+  SaveCFRCheckpoint(filename, info_states_, info_state_keys_, /*iteration=*/0);
+}
+
+template <typename T>
+void BasicExternalSamplingMCCFRSolver<T>::LoadCheckpoint(
+    const std::string& filename) {
+  CFRCheckpoint(filename).CopyTo(&info_states_, &info_state_keys_);
+}
+
+template <typename T>
+void BasicExternalSamplingMCCFRSolver<T>::SaveAveragePolicy(
+    const std::string& filename, bool single_precision) const {
+  SaveCFRAveragePolicy(filename, info_states_, info_state_keys_,
+                       single_precision);
+}
+
+template class BasicExternalSamplingMCCFRSolver<double>;
+template class BasicExternalSamplingMCCFRSolver<float>;
+
 }  // namespace algorithms
 }  // namespace open_spiel
@@ -17,11 +17,15 @@
 
 #include <memory>
 #include <random>
+#include <string>
 #include <vector>
 
+#include "open_spiel/abseil-cpp/absl/synchronization/mutex.h"
 #include "open_spiel/algorithms/cfr.h"
 #include "open_spiel/policy.h"
 #include "open_spiel/spiel.h"
+#include "open_spiel/utils/random.h"
+#include "open_spiel/utils/thread.h"
 
 // An implementation of external sampling Monte Carlo Counterfactual Regret
 // Minimization (CFR). See Lanctot 2009 [0] and Chapter 4 of Lanctot 2013 [1]
@@ -54,21 +58,27 @@ enum class AverageType {
   kFull,
 };
 
-class ExternalSamplingMCCFRSolver {
+// The values in the table are stored as T, which (as with the CFR solvers in
+// cfr.h) may be float to halve the memory it takes.
+template <typename T>
+class BasicExternalSamplingMCCFRSolver {
  public:
   static inline constexpr double kInitialTableValues = 0.000001;
 
   // Creates a solver with a specific seed, average type and an explicit
   // default uniform policy for states that have not been visited.
-  ExternalSamplingMCCFRSolver(const Game& game, int seed = 0,
-                              AverageType avg_type = AverageType::kSimple);
+  // RunIterations uses num_threads threads.
+  BasicExternalSamplingMCCFRSolver(const Game& game, int seed = 0,
+                                   AverageType avg_type = AverageType::kSimple,
+                                   int num_threads = 1);
 
   // Creates a solver with a specific seed and average type, and also allows
   // for a custom default policy for nodes that have not been visited.
-  ExternalSamplingMCCFRSolver(const Game& game,
-                              std::shared_ptr<Policy> default_policy,
-                              int seed = 0,
-                              AverageType avg_type = AverageType::kSimple);
+  BasicExternalSamplingMCCFRSolver(const Game& game,
+                                   std::shared_ptr<Policy> default_policy,
+                                   int seed = 0,
+                                   AverageType avg_type = AverageType::kSimple,
+                                   int num_threads = 1);
 
   // Performs one iteration of external sampling MCCFR, updating the regrets
   // and average strategy for all players. This method uses the internal random
@@ -76,28 +86,88 @@ class ExternalSamplingMCCFRSolver {
   void RunIteration();
 
   // Same as above, but uses the specified random number generator instead.
+  // It may be called from several threads at once, each with its own
+  // generator.
+  void RunIteration(Philox* rng);
   void RunIteration(std::mt19937* rng);
 
+  // Performs this many iterations, spread over num_threads threads. Each
+  // iteration samples from its own stream of a generator seeded from the
+  // internal one, whichever thread runs it. The threads update the same table
+  // as they go, so unlike with a single thread, the results depend on their
+  // timing. No new iteration starts once stop, if
+  // any, is requested. Returns the number of iterations performed.
+  int RunIterations(int num_iterations, const StopToken* stop = nullptr);
+
   // Computes the average policy, containing the policy for all players.
   // The returned policy instance should only be used during the lifetime of
   // the CFRSolver object.
   std::unique_ptr<Policy> AveragePolicy() const {
     return std::unique_ptr<Policy>(
-        new CFRAveragePolicy(info_states_, default_policy_));
+        new BasicCFRAveragePolicy<T>(info_states_, default_policy_,
+                                     &info_state_keys_));
+  }
+
+  // The same, with the average policy of every information state normalized
+  // once, for serving: the solver must not be updated while it is in use.
+  std::unique_ptr<BasicCFRAveragePolicy<T>> CachedAveragePolicy() const {
+    auto policy = std::make_unique<BasicCFRAveragePolicy<T>>(
+        info_states_, default_policy_, &info_state_keys_);
+    policy->CacheAveragePolicy();
+    return policy;
   }
 
+  // Saves the table to a checkpoint file (see cfr_checkpoint.h), or loads
+  // one, adding to the table. The state of the random number generator is
+  // not saved. Not to be called while iterations run.
+  void SaveCheckpoint(const std::string& filename) const;
+  void LoadCheckpoint(const std::string& filename);
+
+  // Writes the average policy to a policy file (see policy_file.h), which
+  // MappedTabularPolicy serves without loading it.
+  void SaveAveragePolicy(const std::string& filename,
+                         bool single_precision = false) const;
+
  private:
-  double UpdateRegrets(const State& state, Player player, std::mt19937* rng);
+  // The number of locks over the values of the information states, each of
+  // which guards those whose id is the same modulo this.
+  static constexpr int kNumValueLocks = 1024;
+
+  template <typename Rng>
+  void RunIterationWith(Rng* rng);
+  template <typename Rng>
+  double UpdateRegrets(const State& state, Player player, Rng* rng);
   void FullUpdateAverage(const State& state,
                          const std::vector<double>& reach_probs);
 
+  // Returns the id of the information state of the current player at this
+  // state, whose key is `info_state_key`, inserting it if needed.
+  int FindOrInsertInfoStateId(const State& state,
+                              const std::string& info_state_key,
+                              const std::vector<Action>& legal_actions);
+
+  // Applies regret matching to an information state, and returns its current
+  // policy.
+  std::vector<double> RegretMatching(int id);
+
+  // The values of an information state, which must only be accessed under
+  // its lock.
+  BasicCFRInfoStateValues<T> InfoStateValues(int id);
+  absl::Mutex* ValueLock(int id) { return &value_locks_[id % kNumValueLocks]; }
+
   std::shared_ptr<const Game> game_;
-  std::unique_ptr<std::mt19937> rng_;
+  Philox rng_;
   AverageType avg_type_;
-  CFRInfoStateValuesTable info_states_;
-  std::uniform_real_distribution<double> dist_;
+  const int num_threads_;
+  // The table is locked to look up or insert information states, but not to
+  // update their values: those never move, and have locks of their own.
+  absl::Mutex table_lock_;
+  BasicCFRInfoStateValuesTable<T> info_states_;
+  CFRInfoStateKeys info_state_keys_;
+  std::vector<absl::Mutex> value_locks_;
   std::shared_ptr<Policy> default_policy_;
 };
+using ExternalSamplingMCCFRSolver = BasicExternalSamplingMCCFRSolver<double>;
 
 }  // namespace algorithms
 }  // namespace open_spiel
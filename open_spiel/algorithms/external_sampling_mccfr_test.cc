@@ -63,6 +63,51 @@ void MCCFR_KuhnPoker3PTest(std::mt19937* rng) {
             << NashConv(*game, *full_average_policy) << std::endl;
 }
 
+void MCCFR_ParallelTest(const std::string& game_name, AverageType avg_type,
+                        int iterations, double nashconv_upperbound) {
+  std::shared_ptr<const Game> game = LoadGame(game_name);
+  ExternalSamplingMCCFRSolver solver(*game, kSeed, avg_type,
+                                     /*num_threads=*/4);
+  solver.RunIterations(iterations);
+  const std::unique_ptr<Policy> average_policy = solver.AveragePolicy();
+  double nash_conv = NashConv(*game, *average_policy, true);
+  std::cout << "Game: " << game_name << ", iters = " << iterations
+            << ", 4 threads, NashConv: " << nash_conv << std::endl;
+  SPIEL_CHECK_LE(nash_conv, nashconv_upperbound);
+}
+
+// No iteration starts once a stop is requested.
+void MCCFR_StopTokenTest() {
+  std::shared_ptr<const Game> game = LoadGame("kuhn_poker");
+  ExternalSamplingMCCFRSolver solver(*game, kSeed, AverageType::kSimple,
+                                     /*num_threads=*/2);
+  StopToken stop;
+  SPIEL_CHECK_EQ(solver.RunIterations(10, &stop), 10);
+  stop.Stop();
+  SPIEL_CHECK_EQ(solver.RunIterations(10, &stop), 0);
+}
+
+void MCCFR_FloatValuesTest(const std::string& game_name, int iterations,
+                           double tolerance) {
+  std::shared_ptr<const Game> game = LoadGame(game_name);
+  ExternalSamplingMCCFRSolver solver(*game);
+  BasicExternalSamplingMCCFRSolver<float> float_solver(*game);
+  std::mt19937 rng(kSeed);
+  std::mt19937 float_rng(kSeed);
+  for (int i = 0; i < iterations; i++) {
+    solver.RunIteration(&rng);
+    float_solver.RunIteration(&float_rng);
+  }
+  // Once rounding moves a sample across the boundary between two actions,
+  // the two runs sample different trajectories, but they converge alike.
+  double nash_conv = NashConv(*game, *solver.AveragePolicy(), true);
+  double float_nash_conv = NashConv(*game, *float_solver.AveragePolicy(), true);
+  std::cout << "Game: " << game_name << ", iters = " << iterations
+            << ", NashConv: " << nash_conv << " with doubles, "
+            << float_nash_conv << " with floats" << std::endl;
+  SPIEL_CHECK_LE(std::abs(float_nash_conv - nash_conv), tolerance);
+}
+
 }  // namespace
 }  // namespace algorithms
 }  // namespace open_spiel
@@ -78,4 +123,12 @@ int main(int argc, char** argv) {
   algorithms::MCCFR_2PGameTest("leduc_poker", &rng, 1000, 2.5);
   algorithms::MCCFR_2PGameTest("liars_dice", &rng, 100, 1.6);
   algorithms::MCCFR_KuhnPoker3PTest(&rng);
+  algorithms::MCCFR_FloatValuesTest("leduc_poker", 1000, 0.5);
+  // The threads interleave differently from run to run, so these bounds leave
+  // more room than the ones above.
+  algorithms::MCCFR_ParallelTest("kuhn_poker", algorithms::AverageType::kSimple,
+                                 5000, 0.1);
+  algorithms::MCCFR_ParallelTest("leduc_poker", algorithms::AverageType::kFull,
+                                 1000, 3.5);
+  algorithms::MCCFR_StopTokenTest();
 }
@@ -0,0 +1,311 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/flat_cfr.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/types/span.h"
+#include "open_spiel/algorithms/compiled_game_tree.h"
+#include "open_spiel/policy.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/thread.h"
+
+namespace open_spiel {
+namespace algorithms {
+namespace {
+
+// The nodes or information states each task of a parallel step handles.
+constexpr int kGrain = 1024;
+
+class CpuFlatCFRBackend : public FlatCFRBackend {
+ public:
+  CpuFlatCFRBackend(const FlatCFRTree& tree, int num_threads)
+      : tree_(tree),
+        num_players_(tree.num_players),
+        reach_(tree.NumNodes() * (num_players_ + 1)),
+        values_(tree.NumNodes() * num_players_),
+        policy_(tree.NumActions()),
+        regrets_(tree.NumActions(), 0.0),
+        cumulative_policy_(tree.NumActions(), 0.0) {
+    SPIEL_CHECK_GE(num_threads, 1);
+    if (num_threads > 1) pool_ = std::make_unique<ThreadPool>(num_threads);
+    for (int info_state = 0; info_state < tree_.NumInfoStates();
+         ++info_state) {
+      const int begin = tree_.action_begin[info_state];
+      const int end = tree_.action_begin[info_state + 1];
+      for (int a = begin; a < end; ++a) policy_[a] = 1.0 / (end - begin);
+    }
+    // The root is always reached.
+    std::fill(reach_.begin(), reach_.begin() + num_players_ + 1, 1.0);
+  }
+
+  void RunIterations(int num_iterations) override {
+    for (int i = 0; i < num_iterations; ++i) {
+      for (Player player = 0; player < num_players_; ++player) {
+        UpdatePlayer(player);
+      }
+    }
+  }
+
+  std::vector<double> CumulativePolicy() const override {
+    return cumulative_policy_;
+  }
+
+ private:
+  void ForEach(int begin, int end, const std::function<void(int)>& fn) {
+    if (pool_ == nullptr || end - begin <= kGrain) {
+      for (int i = begin; i < end; ++i) fn(i);
+      return;
+    }
+    pool_->ParallelFor(begin, end, kGrain, [&fn](int64_t first, int64_t last) {
+      for (int64_t i = first; i < last; ++i) fn(i);
+    });
+  }
+
+  // Whether no player reaches a node, in which case CFRSolver doesn't walk
+  // below it, nor update it.
+  bool Unreached(int node) const {
+    const double* reach = &reach_[node * (num_players_ + 1)];
+    for (Player p = 0; p < num_players_; ++p) {
+      if (reach[p] != 0.0) return false;
+    }
+    return true;
+  }
+
+  void UpdatePlayer(Player player) {
+    const int num_reach = num_players_ + 1;
+    for (int level = 1; level < tree_.NumLevels(); ++level) {
+      ForEach(tree_.level_begin[level], tree_.level_begin[level + 1],
+              [&](int node) {
+                const int parent = tree_.parent[node];
+                const int mover = tree_.player[parent] == kChancePlayerId
+                                      ? num_players_
+                                      : tree_.player[parent];
+                const double prob =
+                    tree_.action_index[node] < 0
+                        ? tree_.chance_probability[node]
+                        : policy_[tree_.action_index[node]];
+                double* reach = &reach_[node * num_reach];
+                const double* parent_reach = &reach_[parent * num_reach];
+                for (int p = 0; p < num_reach; ++p) reach[p] = parent_reach[p];
+                reach[mover] *= prob;
+              });
+    }
+
+    for (int level = tree_.NumLevels() - 1; level >= 0; --level) {
+      ForEach(tree_.level_begin[level], tree_.level_begin[level + 1],
+              [&](int node) {
+                double* value = &values_[node * num_players_];
+                const int begin = tree_.begin[node];
+                if (tree_.player[node] == kTerminalPlayerId) {
+                  for (Player p = 0; p < num_players_; ++p) {
+                    value[p] = tree_.returns[begin + p];
+                  }
+                  return;
+                }
+                for (Player p = 0; p < num_players_; ++p) value[p] = 0.0;
+                const bool chance = tree_.player[node] == kChancePlayerId;
+                if (!chance && Unreached(node)) return;
+                for (int c = 0; c < tree_.num_children[node]; ++c) {
+                  const int child = begin + c;
+                  const double prob = chance
+                                          ? tree_.chance_probability[child]
+                                          : policy_[tree_.action_index[child]];
+                  const double* child_value = &values_[child * num_players_];
+                  for (Player p = 0; p < num_players_; ++p) {
+                    value[p] += prob * child_value[p];
+                  }
+                }
+              });
+    }
+
+    ForEach(0, tree_.NumInfoStates(), [&](int info_state) {
+      if (tree_.info_state_player[info_state] != player) return;
+      const int action_begin = tree_.action_begin[info_state];
+      const int num_actions = tree_.action_begin[info_state + 1] - action_begin;
+      double* regrets = &regrets_[action_begin];
+      double* cumulative_policy = &cumulative_policy_[action_begin];
+      double* policy = &policy_[action_begin];
+      for (int i = tree_.node_begin[info_state];
+           i < tree_.node_begin[info_state + 1]; ++i) {
+        const int node = tree_.info_state_nodes[i];
+        if (Unreached(node)) continue;
+        const double* reach = &reach_[node * num_reach];
+        double cfr_reach = 1.0;
+        for (int p = 0; p < num_reach; ++p) {
+          if (p != player) cfr_reach *= reach[p];
+        }
+        const double value = values_[node * num_players_ + player];
+        const int begin = tree_.begin[node];
+        for (int a = 0; a < num_actions; ++a) {
+          const double child_value =
+              values_[(begin + a) * num_players_ + player];
+          regrets[a] += cfr_reach * (child_value - value);
+          cumulative_policy[a] += reach[player] * policy[a];
+        }
+      }
+
+      double sum_positive_regrets = 0.0;
+      for (int a = 0; a < num_actions; ++a) {
+        if (regrets[a] > 0) sum_positive_regrets += regrets[a];
+      }
+      for (int a = 0; a < num_actions; ++a) {
+        if (sum_positive_regrets > 0) {
+          policy[a] = regrets[a] > 0 ? regrets[a] / sum_positive_regrets : 0;
+        } else {
+          policy[a] = 1.0 / num_actions;
+        }
+      }
+    });
+  }
+
+  const FlatCFRTree tree_;
+  const int num_players_;
+  std::unique_ptr<ThreadPool> pool_;
+  // For each node, the reach probabilities of the players and chance, and
+  // the values of the players.
+  std::vector<double> reach_;
+  std::vector<double> values_;
+  // For each action of the tree.
+  std::vector<double> policy_;
+  std::vector<double> regrets_;
+  std::vector<double> cumulative_policy_;
+};
+
+}  // namespace
+
+FlatCFRTree::FlatCFRTree(const CompiledGameTree& tree)
+    : num_players(tree.NumPlayers()) {
+  action_begin.push_back(0);
+  for (int info_state = 0; info_state < tree.NumInfoStates(); ++info_state) {
+    info_state_player.push_back(tree.InfoStatePlayer(info_state));
+    action_begin.push_back(action_begin.back() +
+                           tree.InfoStateActions(info_state).size());
+  }
+
+  // The compiled node of each node, in breadth-first order. The fields from
+  // the parent are set when a node is queued, and the others when it is
+  // reached.
+  std::vector<int> order = {CompiledGameTree::kRoot};
+  parent.push_back(-1);
+  action_index.push_back(-1);
+  chance_probability.push_back(1.0);
+  level_begin.push_back(0);
+  int level_end = 1;
+  for (int node = 0; node < order.size(); ++node) {
+    if (node == level_end) {
+      level_begin.push_back(node);
+      level_end = order.size();
+    }
+    const int compiled = order[node];
+    player.push_back(tree.CurrentPlayer(compiled));
+    info_state.push_back(tree.InfoState(compiled));
+    if (tree.IsTerminal(compiled)) {
+      absl::Span<const double> node_returns = tree.Returns(compiled);
+      begin.push_back(returns.size());
+      num_children.push_back(0);
+      returns.insert(returns.end(), node_returns.begin(), node_returns.end());
+      continue;
+    }
+    absl::Span<const int> children = tree.Children(compiled);
+    begin.push_back(order.size());
+    num_children.push_back(children.size());
+    for (int c = 0; c < children.size(); ++c) {
+      order.push_back(children[c]);
+      parent.push_back(node);
+      if (tree.IsChanceNode(compiled)) {
+        action_index.push_back(-1);
+        chance_probability.push_back(tree.ChanceProbabilities(compiled)[c]);
+      } else {
+        action_index.push_back(action_begin[tree.InfoState(compiled)] + c);
+        chance_probability.push_back(0.0);
+      }
+    }
+  }
+  level_begin.push_back(order.size());
+
+  // The compiled nodes are in depth-first order.
+  std::vector<int> flat(order.size());
+  for (int node = 0; node < order.size(); ++node) flat[order[node]] = node;
+  node_begin.assign(tree.NumInfoStates() + 1, 0);
+  for (int compiled = 0; compiled < tree.NumNodes(); ++compiled) {
+    if (tree.InfoState(compiled) >= 0) {
+      ++node_begin[tree.InfoState(compiled) + 1];
+    }
+  }
+  for (int i = 0; i < tree.NumInfoStates(); ++i) {
+    node_begin[i + 1] += node_begin[i];
+  }
+  info_state_nodes.resize(node_begin.back());
+  std::vector<int> next(node_begin.begin(), node_begin.end() - 1);
+  for (int compiled = 0; compiled < tree.NumNodes(); ++compiled) {
+    if (tree.InfoState(compiled) >= 0) {
+      info_state_nodes[next[tree.InfoState(compiled)]++] = flat[compiled];
+    }
+  }
+}
+
+std::unique_ptr<FlatCFRBackend> MakeCpuFlatCFRBackend(const FlatCFRTree& tree,
+                                                      int num_threads) {
+  return std::make_unique<CpuFlatCFRBackend>(tree, num_threads);
+}
+
+#ifndef OPEN_SPIEL_CUDA
+std::unique_ptr<FlatCFRBackend> MakeCudaFlatCFRBackend(
+    const FlatCFRTree& tree) {
+  SpielFatalError("The CUDA backend of FlatCFRSolver needs OPEN_SPIEL_CUDA.");
+}
+#endif
+
+FlatCFRSolver::FlatCFRSolver(const Game& game, FlatCFRDevice device,
+                             int num_threads)
+    : root_(game.NewInitialState()), tree_(*root_) {
+  const FlatCFRTree flat_tree(tree_);
+  backend_ = device == FlatCFRDevice::kCuda
+                 ? MakeCudaFlatCFRBackend(flat_tree)
+                 : MakeCpuFlatCFRBackend(flat_tree, num_threads);
+}
+
+void FlatCFRSolver::RunIterations(int num_iterations) {
+  backend_->RunIterations(num_iterations);
+  iterations_ += num_iterations;
+}
+
+TabularPolicy FlatCFRSolver::AveragePolicy() const {
+  const std::vector<double> cumulative_policy = backend_->CumulativePolicy();
+  std::unordered_map<std::string, ActionsAndProbs> table;
+  int a = 0;
+  for (int info_state = 0; info_state < tree_.NumInfoStates(); ++info_state) {
+    absl::Span<const Action> actions = tree_.InfoStateActions(info_state);
+    double sum = 0.0;
+    for (int i = 0; i < actions.size(); ++i) sum += cumulative_policy[a + i];
+    ActionsAndProbs& policy = table[tree_.InfoStateString(info_state)];
+    for (int i = 0; i < actions.size(); ++i, ++a) {
+      policy.push_back({actions[i], sum == 0.0 ? 1.0 / actions.size()
+                                               : cumulative_policy[a] / sum});
+    }
+  }
+  return TabularPolicy(table);
+}
+
+}  // namespace algorithms
+}  // namespace open_spiel
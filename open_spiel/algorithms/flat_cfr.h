@@ -0,0 +1,135 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_ALGORITHMS_FLAT_CFR_H_
+#define OPEN_SPIEL_ALGORITHMS_FLAT_CFR_H_
+
+#include <memory>
+#include <vector>
+
+#include "open_spiel/algorithms/compiled_game_tree.h"
+#include "open_spiel/policy.h"
+#include "open_spiel/spiel.h"
+
+// CFR as a sequence of data-parallel steps over the game tree laid out level
+// by level in flat arrays, rather than a recursive walk: each update of a
+// player is
+//  - a pass down the levels, each node taking the reach probabilities of its
+//    parent times the probability of its action;
+//  - a pass up the levels, each node summing the values of its children;
+//  - for each information state of the player, a sum of the regret and
+//    average policy updates of its nodes;
+//  - regret matching at each of those information states.
+// Each step is independent across the nodes of a level or the information
+// states, which suits a GPU: with OPEN_SPIEL_CUDA, the whole tree lives on
+// the device, and only the average policy is copied back, when asked for.
+// The CPU backend runs the same steps, over threads.
+//
+// It runs the same iterations as CFRSolver, i.e. vanilla CFR with alternating
+// updates, adding the updates of each information state in the same order,
+// so their policies are the same.
+namespace open_spiel {
+namespace algorithms {
+
+// The tree of a CompiledGameTree, with its nodes in breadth-first order, so
+// that the nodes of each level, and the children of each node, are
+// contiguous. The information states are those of the CompiledGameTree.
+struct FlatCFRTree {
+  explicit FlatCFRTree(const CompiledGameTree& tree);
+
+  int NumNodes() const { return player.size(); }
+  int NumLevels() const { return level_begin.size() - 1; }
+  int NumInfoStates() const { return action_begin.size() - 1; }
+  int NumActions() const { return action_begin.back(); }
+
+  int num_players;
+  // Where each level starts, and where the last one ends.
+  std::vector<int> level_begin;
+
+  // For each node: who plays there (a player, kChancePlayerId or
+  // kTerminalPlayerId), its information state (or -1), its parent (or -1),
+  // and the probability of the action from its parent, which is either that
+  // of a chance outcome, or the policy at the index action_index of the
+  // parent's information state (and -1 for chance).
+  std::vector<int> player;
+  std::vector<int> info_state;
+  std::vector<int> parent;
+  std::vector<double> chance_probability;
+  std::vector<int> action_index;
+  // The children of non-terminal nodes, and the returns of terminals, start
+  // at begin in the nodes and in returns.
+  std::vector<int> begin;
+  std::vector<int> num_children;
+  std::vector<double> returns;
+
+  // For each information state: its player, where its actions start in the
+  // policies and regrets (and where the last one's end), and its nodes, which
+  // start at node_begin in info_state_nodes, in depth-first order.
+  std::vector<int> info_state_player;
+  std::vector<int> action_begin;
+  std::vector<int> node_begin;
+  std::vector<int> info_state_nodes;
+};
+
+// Where the iterations run, with their state: the current and cumulative
+// policies and the regrets of the tree's actions.
+class FlatCFRBackend {
+ public:
+  virtual ~FlatCFRBackend() = default;
+
+  // Runs iterations of CFR, updating each player in turn.
+  virtual void RunIterations(int num_iterations) = 0;
+
+  // The cumulative policy of each action of the tree.
+  virtual std::vector<double> CumulativePolicy() const = 0;
+};
+
+// Runs the steps over the nodes of each level and the information states
+// with num_threads threads.
+std::unique_ptr<FlatCFRBackend> MakeCpuFlatCFRBackend(const FlatCFRTree& tree,
+                                                      int num_threads = 1);
+
+// Runs the steps on the default CUDA device. Only built with OPEN_SPIEL_CUDA.
+std::unique_ptr<FlatCFRBackend> MakeCudaFlatCFRBackend(
+    const FlatCFRTree& tree);
+
+enum class FlatCFRDevice { kCpu, kCuda };
+
+class FlatCFRSolver {
+ public:
+  // The num_threads are for the CPU.
+  explicit FlatCFRSolver(const Game& game,
+                         FlatCFRDevice device = FlatCFRDevice::kCpu,
+                         int num_threads = 1);
+
+  // Performs one iteration of CFR, or several.
+  void EvaluateAndUpdatePolicy() { RunIterations(1); }
+  void RunIterations(int num_iterations);
+  int Iterations() const { return iterations_; }
+
+  // The average policy, copied from the backend, which may take a while on a
+  // device: it is meant to be called every so many iterations.
+  TabularPolicy AveragePolicy() const;
+
+ private:
+  std::unique_ptr<State> root_;
+  CompiledGameTree tree_;
+  std::unique_ptr<FlatCFRBackend> backend_;
+  int iterations_ = 0;
+};
+
+}  // namespace algorithms
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_ALGORITHMS_FLAT_CFR_H_
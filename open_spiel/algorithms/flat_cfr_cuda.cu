@@ -0,0 +1,301 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// The CUDA backend of FlatCFRSolver: the steps of the CPU backend, as a
+// kernel each, over the tree copied to the device once. Only built with
+// OPEN_SPIEL_CUDA.
+
+#include <cuda_runtime.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "open_spiel/algorithms/flat_cfr.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace algorithms {
+namespace {
+
+constexpr int kThreadsPerBlock = 256;
+
+void CheckCuda(cudaError_t error, const char* what) {
+  if (error != cudaSuccess) {
+    SpielFatalError(std::string("FlatCFRSolver: ") + what + ": " +
+                    cudaGetErrorString(error));
+  }
+}
+
+int NumBlocks(int size) {
+  return (size + kThreadsPerBlock - 1) / kThreadsPerBlock;
+}
+
+// An array on the device.
+template <typename T>
+class DeviceArray {
+ public:
+  explicit DeviceArray(const std::vector<T>& values) : size_(values.size()) {
+    CheckCuda(cudaMalloc(&data_, std::max<size_t>(size_, 1) * sizeof(T)),
+              "cudaMalloc");
+    CheckCuda(cudaMemcpy(data_, values.data(), size_ * sizeof(T),
+                         cudaMemcpyHostToDevice),
+              "cudaMemcpy");
+  }
+  ~DeviceArray() { cudaFree(data_); }
+  DeviceArray(const DeviceArray&) = delete;
+  DeviceArray& operator=(const DeviceArray&) = delete;
+
+  T* data() const { return data_; }
+  std::vector<T> Download() const {
+    std::vector<T> values(size_);
+    CheckCuda(cudaMemcpy(values.data(), data_, size_ * sizeof(T),
+                         cudaMemcpyDeviceToHost),
+              "cudaMemcpy");
+    return values;
+  }
+
+ private:
+  T* data_ = nullptr;
+  size_t size_;
+};
+
+// The tree and the state of the iterations, as device pointers, passed by
+// value to the kernels.
+struct DeviceTree {
+  int num_players;
+  const int* player;
+  const int* parent;
+  const double* chance_probability;
+  const int* action_index;
+  const int* begin;
+  const int* num_children;
+  const double* returns;
+  const int* info_state_player;
+  const int* action_begin;
+  const int* node_begin;
+  const int* info_state_nodes;
+  double* reach;
+  double* values;
+  double* policy;
+  double* regrets;
+  double* cumulative_policy;
+};
+
+__device__ bool Unreached(const DeviceTree& tree, int node) {
+  const double* reach = tree.reach + node * (tree.num_players + 1);
+  for (int p = 0; p < tree.num_players; ++p) {
+    if (reach[p] != 0.0) return false;
+  }
+  return true;
+}
+
+__global__ void ReachKernel(DeviceTree tree, int level_begin, int level_end) {
+  const int node = level_begin + blockIdx.x * blockDim.x + threadIdx.x;
+  if (node >= level_end) return;
+  const int num_reach = tree.num_players + 1;
+  const int parent = tree.parent[node];
+  const int mover = tree.player[parent] == kChancePlayerId
+                        ? tree.num_players
+                        : tree.player[parent];
+  const double prob = tree.action_index[node] < 0
+                          ? tree.chance_probability[node]
+                          : tree.policy[tree.action_index[node]];
+  double* reach = tree.reach + node * num_reach;
+  const double* parent_reach = tree.reach + parent * num_reach;
+  for (int p = 0; p < num_reach; ++p) reach[p] = parent_reach[p];
+  reach[mover] *= prob;
+}
+
+__global__ void ValueKernel(DeviceTree tree, int level_begin, int level_end) {
+  const int node = level_begin + blockIdx.x * blockDim.x + threadIdx.x;
+  if (node >= level_end) return;
+  const int num_players = tree.num_players;
+  double* value = tree.values + node * num_players;
+  const int begin = tree.begin[node];
+  if (tree.player[node] == kTerminalPlayerId) {
+    for (int p = 0; p < num_players; ++p) value[p] = tree.returns[begin + p];
+    return;
+  }
+  for (int p = 0; p < num_players; ++p) value[p] = 0.0;
+  const bool chance = tree.player[node] == kChancePlayerId;
+  if (!chance && Unreached(tree, node)) return;
+  for (int c = 0; c < tree.num_children[node]; ++c) {
+    const int child = begin + c;
+    const double prob = chance ? tree.chance_probability[child]
+                               : tree.policy[tree.action_index[child]];
+    const double* child_value = tree.values + child * num_players;
+    for (int p = 0; p < num_players; ++p) value[p] += prob * child_value[p];
+  }
+}
+
+__global__ void UpdateKernel(DeviceTree tree, int num_info_states,
+                             int player) {
+  const int info_state = blockIdx.x * blockDim.x + threadIdx.x;
+  if (info_state >= num_info_states ||
+      tree.info_state_player[info_state] != player) {
+    return;
+  }
+  const int num_players = tree.num_players;
+  const int action_begin = tree.action_begin[info_state];
+  const int num_actions = tree.action_begin[info_state + 1] - action_begin;
+  double* regrets = tree.regrets + action_begin;
+  double* cumulative_policy = tree.cumulative_policy + action_begin;
+  double* policy = tree.policy + action_begin;
+  for (int i = tree.node_begin[info_state];
+       i < tree.node_begin[info_state + 1]; ++i) {
+    const int node = tree.info_state_nodes[i];
+    if (Unreached(tree, node)) continue;
+    const double* reach = tree.reach + node * (num_players + 1);
+    double cfr_reach = 1.0;
+    for (int p = 0; p <= num_players; ++p) {
+      if (p != player) cfr_reach *= reach[p];
+    }
+    const double value = tree.values[node * num_players + player];
+    const int begin = tree.begin[node];
+    for (int a = 0; a < num_actions; ++a) {
+      const double child_value =
+          tree.values[(begin + a) * num_players + player];
+      regrets[a] += cfr_reach * (child_value - value);
+      cumulative_policy[a] += reach[player] * policy[a];
+    }
+  }
+
+  double sum_positive_regrets = 0.0;
+  for (int a = 0; a < num_actions; ++a) {
+    if (regrets[a] > 0) sum_positive_regrets += regrets[a];
+  }
+  for (int a = 0; a < num_actions; ++a) {
+    if (sum_positive_regrets > 0) {
+      policy[a] = regrets[a] > 0 ? regrets[a] / sum_positive_regrets : 0;
+    } else {
+      policy[a] = 1.0 / num_actions;
+    }
+  }
+}
+
+class CudaFlatCFRBackend : public FlatCFRBackend {
+ public:
+  explicit CudaFlatCFRBackend(const FlatCFRTree& tree)
+      : level_begin_(tree.level_begin),
+        num_info_states_(tree.NumInfoStates()),
+        player_(tree.player),
+        parent_(tree.parent),
+        chance_probability_(tree.chance_probability),
+        action_index_(tree.action_index),
+        begin_(tree.begin),
+        num_children_(tree.num_children),
+        returns_(tree.returns),
+        info_state_player_(tree.info_state_player),
+        action_begin_(tree.action_begin),
+        node_begin_(tree.node_begin),
+        info_state_nodes_(tree.info_state_nodes),
+        reach_(InitialReach(tree)),
+        values_(std::vector<double>(tree.NumNodes() * tree.num_players)),
+        policy_(UniformPolicy(tree)),
+        regrets_(std::vector<double>(tree.NumActions(), 0.0)),
+        cumulative_policy_(std::vector<double>(tree.NumActions(), 0.0)) {
+    tree_ = {tree.num_players,
+             player_.data(),
+             parent_.data(),
+             chance_probability_.data(),
+             action_index_.data(),
+             begin_.data(),
+             num_children_.data(),
+             returns_.data(),
+             info_state_player_.data(),
+             action_begin_.data(),
+             node_begin_.data(),
+             info_state_nodes_.data(),
+             reach_.data(),
+             values_.data(),
+             policy_.data(),
+             regrets_.data(),
+             cumulative_policy_.data()};
+  }
+
+  void RunIterations(int num_iterations) override {
+    const int num_levels = level_begin_.size() - 1;
+    for (int i = 0; i < num_iterations; ++i) {
+      for (int player = 0; player < tree_.num_players; ++player) {
+        for (int level = 1; level < num_levels; ++level) {
+          const int size = level_begin_[level + 1] - level_begin_[level];
+          ReachKernel<<<NumBlocks(size), kThreadsPerBlock>>>(
+              tree_, level_begin_[level], level_begin_[level + 1]);
+        }
+        for (int level = num_levels - 1; level >= 0; --level) {
+          const int size = level_begin_[level + 1] - level_begin_[level];
+          ValueKernel<<<NumBlocks(size), kThreadsPerBlock>>>(
+              tree_, level_begin_[level], level_begin_[level + 1]);
+        }
+        UpdateKernel<<<NumBlocks(num_info_states_), kThreadsPerBlock>>>(
+            tree_, num_info_states_, player);
+      }
+    }
+    CheckCuda(cudaGetLastError(), "kernel launch");
+  }
+
+  std::vector<double> CumulativePolicy() const override {
+    return cumulative_policy_.Download();
+  }
+
+ private:
+  static std::vector<double> InitialReach(const FlatCFRTree& tree) {
+    std::vector<double> reach(tree.NumNodes() * (tree.num_players + 1), 0.0);
+    std::fill(reach.begin(), reach.begin() + tree.num_players + 1, 1.0);
+    return reach;
+  }
+  static std::vector<double> UniformPolicy(const FlatCFRTree& tree) {
+    std::vector<double> policy(tree.NumActions());
+    for (int info_state = 0; info_state < tree.NumInfoStates();
+         ++info_state) {
+      const int begin = tree.action_begin[info_state];
+      const int end = tree.action_begin[info_state + 1];
+      for (int a = begin; a < end; ++a) policy[a] = 1.0 / (end - begin);
+    }
+    return policy;
+  }
+
+  const std::vector<int> level_begin_;
+  const int num_info_states_;
+  DeviceArray<int> player_;
+  DeviceArray<int> parent_;
+  DeviceArray<double> chance_probability_;
+  DeviceArray<int> action_index_;
+  DeviceArray<int> begin_;
+  DeviceArray<int> num_children_;
+  DeviceArray<double> returns_;
+  DeviceArray<int> info_state_player_;
+  DeviceArray<int> action_begin_;
+  DeviceArray<int> node_begin_;
+  DeviceArray<int> info_state_nodes_;
+  DeviceArray<double> reach_;
+  DeviceArray<double> values_;
+  DeviceArray<double> policy_;
+  DeviceArray<double> regrets_;
+  DeviceArray<double> cumulative_policy_;
+  DeviceTree tree_;
+};
+
+}  // namespace
+
+std::unique_ptr<FlatCFRBackend> MakeCudaFlatCFRBackend(
+    const FlatCFRTree& tree) {
+  return std::make_unique<CudaFlatCFRBackend>(tree);
+}
+
+}  // namespace algorithms
+}  // namespace open_spiel
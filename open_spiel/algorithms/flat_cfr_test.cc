@@ -0,0 +1,98 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/flat_cfr.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+
+#include "open_spiel/algorithms/cfr.h"
+#include "open_spiel/algorithms/compiled_game_tree.h"
+#include "open_spiel/policy.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace algorithms {
+namespace {
+
+constexpr int kNumIterations = 30;
+
+// The levels hold every node once, below their parents.
+void FlatTreeTest() {
+  std::shared_ptr<const Game> game = LoadGame("leduc_poker");
+  std::unique_ptr<State> root = game->NewInitialState();
+  const CompiledGameTree compiled(*root);
+  const FlatCFRTree tree(compiled);
+  SPIEL_CHECK_EQ(tree.NumNodes(), compiled.NumNodes());
+  SPIEL_CHECK_EQ(tree.NumInfoStates(), compiled.NumInfoStates());
+  SPIEL_CHECK_EQ(tree.level_begin.back(), tree.NumNodes());
+  for (int level = 1; level < tree.NumLevels(); ++level) {
+    for (int node = tree.level_begin[level];
+         node < tree.level_begin[level + 1]; ++node) {
+      SPIEL_CHECK_GE(tree.parent[node], tree.level_begin[level - 1]);
+      SPIEL_CHECK_LT(tree.parent[node], tree.level_begin[level]);
+    }
+  }
+  SPIEL_CHECK_EQ(tree.info_state_nodes.size(),
+                 tree.NumNodes() - tree.returns.size() / game->NumPlayers() -
+                     std::count(tree.player.begin(), tree.player.end(),
+                                kChancePlayerId));
+}
+
+// The policy is CFRSolver's.
+void SameAsCFRSolverTest(const std::string& game_name, FlatCFRDevice device,
+                         int num_threads) {
+  std::shared_ptr<const Game> game = LoadGame(game_name);
+  CFRSolver expected_solver(*game);
+  FlatCFRSolver solver(*game, device, num_threads);
+  for (int i = 0; i < kNumIterations; ++i) {
+    expected_solver.EvaluateAndUpdatePolicy();
+  }
+  solver.RunIterations(kNumIterations);
+  SPIEL_CHECK_EQ(solver.Iterations(), kNumIterations);
+  const TabularPolicy expected(*game, *expected_solver.AveragePolicy());
+  const TabularPolicy policy = solver.AveragePolicy();
+  SPIEL_CHECK_EQ(policy.PolicyTable().size(), expected.PolicyTable().size());
+  for (const auto& [info_state, expected_probs] : expected.PolicyTable()) {
+    const ActionsAndProbs& probs = policy.GetStatePolicy(info_state);
+    SPIEL_CHECK_EQ(probs.size(), expected_probs.size());
+    for (int a = 0; a < probs.size(); ++a) {
+      SPIEL_CHECK_EQ(probs[a].first, expected_probs[a].first);
+      SPIEL_CHECK_FLOAT_NEAR(probs[a].second, expected_probs[a].second,
+                             1e-12);
+    }
+  }
+}
+
+}  // namespace
+}  // namespace algorithms
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  open_spiel::algorithms::FlatTreeTest();
+  for (const std::string game :
+       {"kuhn_poker", "kuhn_poker(players=3)", "leduc_poker"}) {
+    open_spiel::algorithms::SameAsCFRSolverTest(
+        game, open_spiel::algorithms::FlatCFRDevice::kCpu, /*num_threads=*/1);
+    open_spiel::algorithms::SameAsCFRSolverTest(
+        game, open_spiel::algorithms::FlatCFRDevice::kCpu, /*num_threads=*/4);
+#ifdef OPEN_SPIEL_CUDA
+    open_spiel::algorithms::SameAsCFRSolverTest(
+        game, open_spiel::algorithms::FlatCFRDevice::kCuda,
+        /*num_threads=*/1);
+#endif
+  }
+}
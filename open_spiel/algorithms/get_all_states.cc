@@ -14,10 +14,63 @@
 
 #include "open_spiel/algorithms/get_all_states.h"
 
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/thread.h"
+
 namespace open_spiel {
 namespace algorithms {
 namespace {
 
+// The successors of a state of a StateGraph, found by Expand.
+struct Expansion {
+  std::vector<Action> actions;
+  std::vector<double> chance_probabilities;
+  std::vector<uint64_t> hashes;
+  // The ids of the successors already in the graph, or -1 for the others,
+  // which are kept in children.
+  std::vector<int> successors;
+  std::vector<std::unique_ptr<State>> children;
+};
+
+// Finds the successors of a state. The ids of the states already in the
+// graph are only read, so many states can be expanded at once.
+void Expand(const State& state, const absl::flat_hash_map<uint64_t, int>& ids,
+            Expansion* expansion) {
+  if (state.IsTerminal()) return;
+  if (state.IsSimultaneousNode()) {
+    SpielFatalError(
+        "Simultaneous moves not supported. Use "
+        "TurnBasedSimultaneousGame to convert the game first.");
+  }
+  if (state.IsChanceNode()) {
+    for (const auto& [outcome, prob] : state.ChanceOutcomes()) {
+      expansion->actions.push_back(outcome);
+      expansion->chance_probabilities.push_back(prob);
+    }
+  } else {
+    expansion->actions = state.LegalActions();
+    expansion->chance_probabilities.resize(expansion->actions.size(), 0);
+  }
+  for (Action action : expansion->actions) {
+    std::unique_ptr<State> child = state.Child(action);
+    const uint64_t hash = child->HashValue();
+    auto it = ids.find(hash);
+    expansion->hashes.push_back(hash);
+    if (it == ids.end()) {
+      expansion->successors.push_back(-1);
+      expansion->children.push_back(std::move(child));
+    } else {
+      expansion->successors.push_back(it->second);
+      expansion->children.push_back(nullptr);
+    }
+  }
+}
+
 // Walk a subgame and return all states contained in the subgames. This does
 // a recursive tree walk, therefore all valid sequences must have finite number
 // of actions. The state collection is key-indexed by the state's string
@@ -80,5 +133,121 @@ std::map<std::string, std::unique_ptr<State>> GetAllStates(
   return all_states;
 }
 
+std::map<std::string, std::unique_ptr<State>> GetAllStates(
+    const Game& game, int depth_limit, bool include_terminals,
+    bool include_chance_states, int num_threads) {
+  // The terminal states just past the depth limit are included too, as above.
+  const StateGraph graph(game, depth_limit < 0 ? -1 : depth_limit + 1,
+                         num_threads, /*keep_states=*/true);
+  std::map<std::string, std::unique_ptr<State>> all_states;
+  for (int id = 0; id < graph.NumStates(); ++id) {
+    const bool included =
+        graph.IsTerminal(id)
+            ? include_terminals
+            : (depth_limit < 0 || graph.Depth(id) <= depth_limit) &&
+                  (include_chance_states || !graph.IsChanceNode(id));
+    if (!included) continue;
+    const State& state = graph.GetState(id);
+    std::string key = state.ToString();
+    if (all_states.find(key) == all_states.end()) {
+      all_states[key] = state.Clone();
+    }
+  }
+
+  if (all_states.empty()) {
+    SpielFatalError("GetAllStates returned 0 states!");
+  }
+
+  return all_states;
+}
+
+StateGraph::StateGraph(const Game& game, int depth_limit, int num_threads,
+                       bool keep_states)
+    : StateGraph(*game.NewInitialState(), depth_limit, num_threads,
+                 keep_states) {}
+
+StateGraph::StateGraph(const State& root, int depth_limit, int num_threads,
+                       bool keep_states)
+    : num_players_(root.NumPlayers()) {
+  SPIEL_CHECK_GE(num_threads, 1);
+  std::vector<std::unique_ptr<State>> frontier;
+  frontier.push_back(root.Clone());
+  AddState(frontier[0]->HashValue(), *frontier[0]);
+  depth_offsets_.push_back(0);
+  for (int depth = 0; !frontier.empty(); ++depth) {
+    const int begin = depth_offsets_.back();
+    depth_offsets_.push_back(nodes_.size());
+
+    // The states at this depth are shared out between the threads in
+    // contiguous ranges.
+    std::vector<Expansion> expansions(frontier.size());
+    if (depth_limit < 0 || depth < depth_limit) {
+      const int num_states = frontier.size();
+      const int num_workers = std::min(num_threads, num_states);
+      auto expand = [&](int worker) {
+        for (int i = num_states * worker / num_workers;
+             i < num_states * (worker + 1) / num_workers; ++i) {
+          Expand(*frontier[i], ids_, &expansions[i]);
+        }
+      };
+      std::vector<Thread> threads;
+      for (int worker = 1; worker < num_workers; ++worker) {
+        threads.emplace_back([&expand, worker]() { expand(worker); });
+      }
+      expand(0);
+      for (Thread& thread : threads) thread.join();
+    }
+
+    // The new states are added in order, so that their ids do not depend on
+    // the threads, and they make the next depth.
+    std::vector<std::unique_ptr<State>> next_frontier;
+    for (int i = 0; i < frontier.size(); ++i) {
+      Expansion& expansion = expansions[i];
+      if (!expansion.actions.empty()) {
+        nodes_[begin + i].begin = successors_.size();
+        nodes_[begin + i].size = expansion.actions.size();
+      }
+      for (int j = 0; j < expansion.actions.size(); ++j) {
+        int successor = expansion.successors[j];
+        if (successor < 0) successor = Find(expansion.hashes[j]);
+        if (successor < 0) {
+          successor = AddState(expansion.hashes[j], *expansion.children[j]);
+          next_frontier.push_back(std::move(expansion.children[j]));
+        }
+        successors_.push_back(successor);
+      }
+      actions_.insert(actions_.end(), expansion.actions.begin(),
+                      expansion.actions.end());
+      chance_probabilities_.insert(chance_probabilities_.end(),
+                                   expansion.chance_probabilities.begin(),
+                                   expansion.chance_probabilities.end());
+      if (keep_states) states_.push_back(std::move(frontier[i]));
+    }
+    frontier = std::move(next_frontier);
+  }
+}
+
+int StateGraph::Depth(int state) const {
+  SPIEL_CHECK_GE(state, 0);
+  SPIEL_CHECK_LT(state, NumStates());
+  return std::upper_bound(depth_offsets_.begin(), depth_offsets_.end(),
+                          state) -
+         depth_offsets_.begin() - 1;
+}
+
+int StateGraph::AddState(uint64_t hash, const State& state) {
+  const int id = nodes_.size();
+  ids_[hash] = id;
+  if (state.IsTerminal()) {
+    std::vector<double> returns = state.Returns();
+    nodes_.push_back({hash, kTerminalPlayerId,
+                      static_cast<int>(returns_.size()), num_players_});
+    returns_.insert(returns_.end(), returns.begin(), returns.end());
+  } else {
+    nodes_.push_back({hash, state.CurrentPlayer(), 0, 0});
+  }
+  return id;
+}
+
 }  // namespace algorithms
 }  // namespace open_spiel
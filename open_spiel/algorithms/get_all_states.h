@@ -15,8 +15,14 @@
 #ifndef OPEN_SPIEL_ALGORITHMS_GET_ALL_STATES_H_
 #define OPEN_SPIEL_ALGORITHMS_GET_ALL_STATES_H_
 
+#include <cstdint>
+#include <map>
+#include <memory>
 #include <string>
+#include <vector>
 
+#include "open_spiel/abseil-cpp/absl/container/flat_hash_map.h"
+#include "open_spiel/abseil-cpp/absl/types/span.h"
 #include "open_spiel/spiel.h"
 
 namespace open_spiel {
@@ -39,6 +45,121 @@ std::map<std::string, std::unique_ptr<State>> GetAllStates(
     const Game& game, int depth_limit, bool include_terminals,
     bool include_chance_states);
 
+// The same states, found by building a StateGraph on num_threads threads.
+// States are told apart by State::HashValue() while they are explored, so
+// games whose hash merges transpositions are explored much faster.
+std::map<std::string, std::unique_ptr<State>> GetAllStates(
+    const Game& game, int depth_limit, bool include_terminals,
+    bool include_chance_states, int num_threads);
+
+// All the states of a game, as a graph of compact ids rather than of States:
+// each state only keeps its hash, who plays there, its successors, the
+// probabilities of chance outcomes and the returns of terminals, which is
+// enough to solve the game without any State. States are identified by their
+// State::HashValue(), so the transpositions the hash recognizes are merged,
+// and so would two distinct states with the same hash be.
+//
+// The graph is explored breadth-first, one depth at a time, with the states
+// of a depth expanded on num_threads threads. The ids are in the order the
+// states are first reached breadth-first, which does not depend on the
+// number of threads: the root is 0, and the states first reached at each
+// depth follow the ones before. Only the states of the depth being expanded
+// are kept, unless keep_states.
+//
+// The states at depth_limit are not expanded, so non-terminal states there
+// have no successors; a negative depth limit means no limit, as above.
+// Currently only works for sequential games.
+class StateGraph {
+ public:
+  static constexpr int kRoot = 0;
+
+  explicit StateGraph(const Game& game, int depth_limit = -1,
+                      int num_threads = 1, bool keep_states = false);
+
+  // The states reachable from this state, which is the root, with the depths
+  // counted from it.
+  explicit StateGraph(const State& root, int depth_limit = -1,
+                      int num_threads = 1, bool keep_states = false);
+
+  int NumStates() const { return nodes_.size(); }
+  int NumPlayers() const { return num_players_; }
+
+  // The depth at which a state is first reached, and the first state reached
+  // at a depth, up to the number of depths, which is one past the last.
+  int Depth(int state) const;
+  int NumDepths() const { return depth_offsets_.size() - 1; }
+  int DepthBegin(int depth) const { return depth_offsets_[depth]; }
+
+  uint64_t HashValue(int state) const { return nodes_[state].hash; }
+
+  // A player, kChancePlayerId or kTerminalPlayerId.
+  Player CurrentPlayer(int state) const { return nodes_[state].player; }
+  bool IsTerminal(int state) const {
+    return nodes_[state].player == kTerminalPlayerId;
+  }
+  bool IsChanceNode(int state) const {
+    return nodes_[state].player == kChancePlayerId;
+  }
+
+  // The successors of a non-terminal state, for each of its legal actions or
+  // chance outcomes, with the probabilities of those at chance nodes.
+  absl::Span<const int> Successors(int state) const {
+    return {successors_.data() + nodes_[state].begin,
+            static_cast<size_t>(nodes_[state].size)};
+  }
+  absl::Span<const Action> Actions(int state) const {
+    return {actions_.data() + nodes_[state].begin,
+            static_cast<size_t>(nodes_[state].size)};
+  }
+  absl::Span<const double> ChanceProbabilities(int state) const {
+    SPIEL_CHECK_TRUE(IsChanceNode(state));
+    return {chance_probabilities_.data() + nodes_[state].begin,
+            static_cast<size_t>(nodes_[state].size)};
+  }
+
+  // The returns of each player at a terminal state.
+  absl::Span<const double> Returns(int state) const {
+    SPIEL_CHECK_TRUE(IsTerminal(state));
+    return {returns_.data() + nodes_[state].begin,
+            static_cast<size_t>(nodes_[state].size)};
+  }
+
+  // The state itself, if the graph was built with keep_states.
+  const State& GetState(int state) const {
+    SPIEL_CHECK_FALSE(states_.empty());
+    return *states_[state];
+  }
+
+  // Returns the state with this hash, or -1 if there is none.
+  int Find(uint64_t hash) const {
+    auto it = ids_.find(hash);
+    return it == ids_.end() ? -1 : it->second;
+  }
+
+ private:
+  struct Node {
+    uint64_t hash;
+    Player player;
+    // Where its successors, actions and chance probabilities start, or its
+    // returns for a terminal state, and how many there are.
+    int begin;
+    int size;
+  };
+
+  // Adds a state reached for the first time, and returns its id.
+  int AddState(uint64_t hash, const State& state);
+
+  int num_players_;
+  std::vector<Node> nodes_;
+  std::vector<int> depth_offsets_;
+  std::vector<int> successors_;
+  std::vector<Action> actions_;
+  std::vector<double> chance_probabilities_;
+  std::vector<double> returns_;
+  std::vector<std::unique_ptr<State>> states_;
+  absl::flat_hash_map<uint64_t, int> ids_;
+};
+
 }  // namespace algorithms
 }  // namespace open_spiel
 
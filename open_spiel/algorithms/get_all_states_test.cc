@@ -14,9 +14,109 @@
 
 #include "open_spiel/algorithms/get_all_states.h"
 
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "open_spiel/games/tic_tac_toe.h"
 #include "open_spiel/spiel_utils.h"
 
+namespace open_spiel {
+namespace algorithms {
+namespace {
+
+namespace ttt = open_spiel::tic_tac_toe;
+
+void CheckSameKeys(const std::map<std::string, std::unique_ptr<State>>& states,
+                   const std::map<std::string, std::unique_ptr<State>>&
+                       expected_states) {
+  SPIEL_CHECK_EQ(states.size(), expected_states.size());
+  for (const auto& [key, state] : expected_states) {
+    SPIEL_CHECK_TRUE(states.find(key) != states.end());
+  }
+}
+
+// The states found through a StateGraph are the same as by the tree walk.
+void CheckThreadedGetAllStates(const std::string& game_name,
+                               const std::vector<int>& depth_limits) {
+  std::shared_ptr<const Game> game = LoadGame(game_name);
+  for (int depth_limit : depth_limits) {
+    for (bool include_terminals : {true, false}) {
+      for (bool include_chance_states : {true, false}) {
+        CheckSameKeys(GetAllStates(*game, depth_limit, include_terminals,
+                                   include_chance_states, /*num_threads=*/4),
+                      GetAllStates(*game, depth_limit, include_terminals,
+                                   include_chance_states));
+      }
+    }
+  }
+}
+
+// The ids do not depend on the number of threads.
+void CheckSameGraphs(const StateGraph& graph, const StateGraph& expected) {
+  SPIEL_CHECK_EQ(graph.NumStates(), expected.NumStates());
+  SPIEL_CHECK_EQ(graph.NumDepths(), expected.NumDepths());
+  for (int state = 0; state < expected.NumStates(); ++state) {
+    SPIEL_CHECK_EQ(graph.HashValue(state), expected.HashValue(state));
+    SPIEL_CHECK_EQ(graph.Depth(state), expected.Depth(state));
+    SPIEL_CHECK_EQ(graph.CurrentPlayer(state), expected.CurrentPlayer(state));
+    if (expected.IsTerminal(state)) {
+      SPIEL_CHECK_TRUE(graph.Returns(state) == expected.Returns(state));
+    } else {
+      SPIEL_CHECK_TRUE(graph.Successors(state) == expected.Successors(state));
+      SPIEL_CHECK_TRUE(graph.Actions(state) == expected.Actions(state));
+    }
+  }
+}
+
+void TicTacToeStateGraphTest() {
+  std::shared_ptr<const Game> game = LoadGame("tic_tac_toe");
+  const StateGraph graph(*game, /*depth_limit=*/-1, /*num_threads=*/4,
+                         /*keep_states=*/true);
+  SPIEL_CHECK_EQ(graph.NumStates(), ttt::kNumberStates);
+  SPIEL_CHECK_EQ(graph.NumDepths(), 10);
+  SPIEL_CHECK_EQ(graph.Find(game->NewInitialState()->HashValue()),
+                 StateGraph::kRoot);
+  for (int state = 0; state < graph.NumStates(); ++state) {
+    SPIEL_CHECK_EQ(graph.Find(graph.HashValue(state)), state);
+    SPIEL_CHECK_EQ(graph.GetState(state).HashValue(), graph.HashValue(state));
+    if (graph.IsTerminal(state)) continue;
+    for (int i = 0; i < graph.Successors(state).size(); ++i) {
+      const int successor = graph.Successors(state)[i];
+      SPIEL_CHECK_GT(successor, state);
+      SPIEL_CHECK_EQ(graph.Depth(successor), graph.Depth(state) + 1);
+      SPIEL_CHECK_EQ(graph.GetState(state).Child(graph.Actions(state)[i])
+                         ->ToString(),
+                     graph.GetState(successor).ToString());
+    }
+  }
+  CheckSameGraphs(graph, StateGraph(*game));
+
+  const StateGraph limited_graph(*game, /*depth_limit=*/2);
+  SPIEL_CHECK_EQ(limited_graph.NumDepths(), 3);
+  SPIEL_CHECK_EQ(limited_graph.NumStates(), 1 + 9 + 72);
+  SPIEL_CHECK_TRUE(
+      limited_graph.Successors(limited_graph.DepthBegin(2)).empty());
+}
+
+void KuhnPokerStateGraphTest() {
+  std::shared_ptr<const Game> game = LoadGame("kuhn_poker");
+  const StateGraph graph(*game);
+  SPIEL_CHECK_TRUE(graph.IsChanceNode(StateGraph::kRoot));
+  double total_probability = 0;
+  for (double prob : graph.ChanceProbabilities(StateGraph::kRoot)) {
+    total_probability += prob;
+  }
+  SPIEL_CHECK_FLOAT_EQ(total_probability, 1.);
+  CheckSameGraphs(graph, StateGraph(*game, /*depth_limit=*/-1,
+                                    /*num_threads=*/3));
+}
+
+}  // namespace
+}  // namespace algorithms
+}  // namespace open_spiel
+
 namespace algorithms = open_spiel::algorithms;
 namespace ttt = open_spiel::tic_tac_toe;
 
@@ -26,4 +126,9 @@ int main(int argc, char **argv) {
   auto states = algorithms::GetAllStates(*game, -1, /*include_terminals=*/true,
                                          /*include_chance_states=*/true);
   SPIEL_CHECK_EQ(states.size(), ttt::kNumberStates);
+  algorithms::CheckThreadedGetAllStates("tic_tac_toe", {-1, 0, 1, 3});
+  // The first decision of Kuhn poker is at depth 2, after the deal.
+  algorithms::CheckThreadedGetAllStates("kuhn_poker", {-1, 2, 3});
+  algorithms::TicTacToeStateGraphTest();
+  algorithms::KuhnPokerStateGraphTest();
 }
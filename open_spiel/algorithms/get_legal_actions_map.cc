@@ -14,64 +14,170 @@
 
 #include "open_spiel/algorithms/get_legal_actions_map.h"
 
+#include <memory>
+#include <utility>
+
+#include "open_spiel/utils/thread.h"
+
 namespace open_spiel {
 namespace algorithms {
 namespace {
 
-// Do the tree traversal to fill the map. This function does a depth-first
-// search of all the subtrees to fill the map for all the information states.
-void FillMap(const State& state,
-             std::unordered_map<std::string, std::vector<Action>>* map,
-             int depth_limit, int depth, Player player) {
-  if (state.IsTerminal()) {
-    return;
-  }
-
-  if (depth_limit >= 0 && depth > depth_limit) {
-    return;
-  }
-
+// Calls add(p) for each of the players whose information state this is,
+// restricted to player unless it is kInvalidPlayer.
+template <typename Add>
+void ForEachInfoState(const State& state, Player player, const Add& add) {
   if (state.IsChanceNode()) {
     // Do nothing at chance nodes (no information states).
   } else if (state.IsSimultaneousNode()) {
     // Many players can play at this node.
     for (auto p = Player{0}; p < state.NumPlayers(); ++p) {
-      if (player == kInvalidPlayer || p == player) {
-        std::string info_state = state.InformationStateString(p);
-        if (map->find(info_state) == map->end()) {
-          // Only add it if we don't already have it.
-          std::vector<Action> legal_actions = state.LegalActions(p);
-          (*map)[info_state] = legal_actions;
-        }
-      }
+      if (player == kInvalidPlayer || p == player) add(p);
     }
-  } else {
+  } else if (player == kInvalidPlayer || state.CurrentPlayer() == player) {
     // Regular decision node.
-    if (player == kInvalidPlayer || state.CurrentPlayer() == player) {
-      std::string info_state = state.InformationStateString();
-      if (map->find(info_state) == map->end()) {
+    add(state.CurrentPlayer());
+  }
+}
+
+// Fills a map for GetLegalActionsMap.
+struct MapVisitor {
+  Player player;
+  std::unordered_map<std::string, std::vector<Action>> map;
+
+  void operator()(const State& state) {
+    ForEachInfoState(state, player, [&](Player p) {
+      std::string info_state = state.InformationStateString(p);
+      if (map.find(info_state) == map.end()) {
         // Only add it if we don't already have it.
-        std::vector<Action> legal_actions = state.LegalActions();
-        (*map)[info_state] = legal_actions;
+        map[info_state] = state.LegalActions(p);
       }
-    }
+    });
   }
 
-  // Recursively fill the map for each subtree below.
+  void Merge(MapVisitor& other) { map.merge(other.map); }
+};
+
+// Fills a table for GetLegalActionsTable.
+struct TableVisitor {
+  Player player;
+  LegalActionsTable table;
+
+  void operator()(const State& state) {
+    ForEachInfoState(state, player, [&](Player p) {
+      const uint64_t key_hash =
+          LegalActionsTable::KeyHash(state.InformationStateKey(p));
+      if (table.ActionList(key_hash) < 0) {
+        table.Add(key_hash, state.LegalActions(p));
+      }
+    });
+  }
+
+  void Merge(TableVisitor& other) { table.Merge(other.table); }
+};
+
+// Does a depth-first search of the subtree, calling visit on every
+// non-terminal state within the depth limit.
+template <typename Visitor>
+void Traverse(const State& state, int depth_limit, int depth,
+              Visitor* visit) {
+  if (state.IsTerminal()) {
+    return;
+  }
+
+  if (depth_limit >= 0 && depth > depth_limit) {
+    return;
+  }
+
+  (*visit)(state);
+
+  // Recursively visit each subtree below.
   for (auto action : state.LegalActions()) {
     std::unique_ptr<State> next_state = state.Child(action);
-    FillMap(*next_state, map, depth_limit, depth + 1, player);
+    Traverse(*next_state, depth_limit, depth + 1, visit);
+  }
+}
+
+// Visits the whole game with a copy of the empty visitor per subtree, and
+// merges them into it. The tree is expanded breadth-first until it has a few subtrees
+// per thread, visiting the states on the way, and the subtrees are then
+// traversed in parallel.
+template <typename Visitor>
+void ParallelTraverse(const Game& game, int depth_limit, int num_threads,
+                      Visitor* visitor) {
+  const Visitor empty = *visitor;
+  struct Subtree {
+    std::unique_ptr<State> root;
+    int depth;
+  };
+  std::vector<Subtree> subtrees;
+  subtrees.push_back({game.NewInitialState(), 0});
+  if (num_threads <= 1) {
+    Traverse(*subtrees[0].root, depth_limit, 0, visitor);
+    return;
+  }
+
+  while (!subtrees.empty() && subtrees.size() < 4 * static_cast<size_t>(num_threads)) {
+    std::vector<Subtree> children;
+    for (const Subtree& subtree : subtrees) {
+      const State& state = *subtree.root;
+      if (state.IsTerminal()) continue;
+      if (depth_limit >= 0 && subtree.depth > depth_limit) continue;
+      (*visitor)(state);
+      for (Action action : state.LegalActions()) {
+        children.push_back({state.Child(action), subtree.depth + 1});
+      }
+    }
+    subtrees = std::move(children);
   }
+
+  std::vector<Visitor> visitors(subtrees.size(), empty);
+  ThreadPool::Default()->ParallelFor(
+      0, subtrees.size(), 1, [&](int64_t first, int64_t last) {
+        for (int64_t i = first; i < last; ++i) {
+          Traverse(*subtrees[i].root, depth_limit, subtrees[i].depth,
+                   &visitors[i]);
+        }
+      });
+  for (Visitor& other : visitors) visitor->Merge(other);
 }
 
 }  // namespace
 
 std::unordered_map<std::string, std::vector<Action>> GetLegalActionsMap(
-    const Game& game, int depth_limit, Player player) {
-  std::unordered_map<std::string, std::vector<Action>> map;
-  std::unique_ptr<State> initial_state = game.NewInitialState();
-  FillMap(*initial_state, &map, depth_limit, 0, player);
-  return map;
+    const Game& game, int depth_limit, Player player, int num_threads) {
+  MapVisitor visitor{player, {}};
+  ParallelTraverse(game, depth_limit, num_threads, &visitor);
+  return std::move(visitor.map);
+}
+
+void LegalActionsTable::Add(uint64_t key_hash,
+                            const std::vector<Action>& legal_actions) {
+  lists_.emplace(key_hash, InternList(legal_actions));
+}
+
+void LegalActionsTable::Merge(const LegalActionsTable& other) {
+  // The other table's lists are only looked up once each.
+  std::vector<int> lists(other.action_lists_.size(), -1);
+  for (const auto& [key_hash, list] : other.lists_) {
+    if (lists_.contains(key_hash)) continue;
+    if (lists[list] < 0) lists[list] = InternList(other.action_lists_[list]);
+    lists_.emplace(key_hash, lists[list]);
+  }
+}
+
+int LegalActionsTable::InternList(const std::vector<Action>& legal_actions) {
+  auto [it, inserted] =
+      action_list_index_.emplace(legal_actions, action_lists_.size());
+  if (inserted) action_lists_.push_back(legal_actions);
+  return it->second;
+}
+
+LegalActionsTable GetLegalActionsTable(const Game& game, int depth_limit,
+                                       Player player, int num_threads) {
+  TableVisitor visitor{player, {}};
+  ParallelTraverse(game, depth_limit, num_threads, &visitor);
+  return std::move(visitor.table);
 }
 
 }  // namespace algorithms
@@ -15,10 +15,13 @@
 #ifndef OPEN_SPIEL_ALGORITHMS_GET_LEGAL_ACTIONS_MAP_H_
 #define OPEN_SPIEL_ALGORITHMS_GET_LEGAL_ACTIONS_MAP_H_
 
+#include <cstdint>
+#include <functional>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "open_spiel/abseil-cpp/absl/container/flat_hash_map.h"
 #include "open_spiel/spiel.h"
 
 namespace open_spiel {
@@ -29,8 +32,53 @@ namespace algorithms {
 // do a tree traversal over the entire game, use a negative depth limit. To
 // bundle all the legal actions for all players in the same map, use
 // kInvalidPlayer.
+//
+// With num_threads > 1, the tree is expanded breadth-first from the root until
+// there are a few subtrees per thread, which are then traversed in parallel.
 std::unordered_map<std::string, std::vector<Action>> GetLegalActionsMap(
-    const Game& game, int depth_limit, Player player);
+    const Game& game, int depth_limit, Player player, int num_threads = 1);
+
+// The same legal actions, keyed by the hash of each information state's
+// State::InformationStateKey rather than by its string, and with each distinct
+// list of legal actions stored once, since most games only have a few of them.
+// Two information states whose keys hash the same are merged, like the
+// transpositions of StateGraph.
+class LegalActionsTable {
+ public:
+  static uint64_t KeyHash(const std::string& info_state_key) {
+    return std::hash<std::string>()(info_state_key);
+  }
+
+  int NumInfoStates() const { return lists_.size(); }
+  int NumActionLists() const { return action_lists_.size(); }
+
+  // Returns the index of the information state's list of legal actions, or -1
+  // if it is not in the table.
+  int ActionList(uint64_t key_hash) const {
+    auto it = lists_.find(key_hash);
+    return it == lists_.end() ? -1 : it->second;
+  }
+  const std::vector<Action>& Actions(int list) const {
+    return action_lists_[list];
+  }
+  // The list index of each information state, by key hash.
+  const absl::flat_hash_map<uint64_t, int>& Lists() const { return lists_; }
+
+  // Adds an information state which is not in the table yet.
+  void Add(uint64_t key_hash, const std::vector<Action>& legal_actions);
+  // Adds the information states of the other table which are not in this one.
+  void Merge(const LegalActionsTable& other);
+
+ private:
+  int InternList(const std::vector<Action>& legal_actions);
+
+  absl::flat_hash_map<uint64_t, int> lists_;
+  std::vector<std::vector<Action>> action_lists_;
+  absl::flat_hash_map<std::vector<Action>, int> action_list_index_;
+};
+
+LegalActionsTable GetLegalActionsTable(const Game& game, int depth_limit,
+                                       Player player, int num_threads = 1);
 
 }  // namespace algorithms
 }  // namespace open_spiel
@@ -14,7 +14,10 @@
 
 #include "open_spiel/algorithms/get_legal_actions_map.h"
 
+#include <memory>
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "open_spiel/games/goofspiel.h"
 #include "open_spiel/games/kuhn_poker.h"
@@ -69,10 +72,76 @@ void GoofspielTest() {
   SPIEL_CHECK_GT(map_both.size(), 0);
 }
 
+void ThreadsTest() {
+  for (const char* game_string :
+       {"leduc_poker", "goofspiel(num_cards=3)", "tic_tac_toe"}) {
+    std::shared_ptr<const open_spiel::Game> game =
+        open_spiel::LoadGame(game_string);
+    for (int depth_limit : {-1, 0, 3}) {
+      LegalActionsMap map = algorithms::GetLegalActionsMap(
+          *game, depth_limit, open_spiel::kInvalidPlayer);
+      SPIEL_CHECK_TRUE(algorithms::GetLegalActionsMap(
+                           *game, depth_limit, open_spiel::kInvalidPlayer,
+                           /*num_threads=*/4) == map);
+    }
+  }
+}
+
+// The player's legal actions keyed by State::InformationStateKey.
+void FillKeyMap(const open_spiel::State& state, open_spiel::Player player,
+                LegalActionsMap* map) {
+  if (state.IsTerminal()) return;
+  if (state.IsSimultaneousNode() || state.CurrentPlayer() == player) {
+    map->emplace(state.InformationStateKey(player), state.LegalActions(player));
+  }
+  for (open_spiel::Action action : state.LegalActions()) {
+    FillKeyMap(*state.Child(action), player, map);
+  }
+}
+
+void CheckTable(const std::string& game_string, int num_threads) {
+  std::shared_ptr<const open_spiel::Game> game =
+      open_spiel::LoadGame(game_string);
+  for (open_spiel::Player player = 0; player < game->NumPlayers(); ++player) {
+    LegalActionsMap map;
+    FillKeyMap(*game->NewInitialState(), player, &map);
+    algorithms::LegalActionsTable table = algorithms::GetLegalActionsTable(
+        *game, /*depth_limit=*/-1, player, num_threads);
+    SPIEL_CHECK_EQ(table.NumInfoStates(), map.size());
+    for (const auto& [key, legal_actions] : map) {
+      const int list =
+          table.ActionList(algorithms::LegalActionsTable::KeyHash(key));
+      SPIEL_CHECK_GE(list, 0);
+      SPIEL_CHECK_EQ(table.Actions(list), legal_actions);
+    }
+    SPIEL_CHECK_EQ(table.ActionList(
+                       algorithms::LegalActionsTable::KeyHash("not a key")),
+                   -1);
+  }
+}
+
+void TableTest() {
+  CheckTable("kuhn_poker", 1);
+  CheckTable("leduc_poker", 1);
+  CheckTable("leduc_poker", 4);
+  CheckTable("goofspiel(num_cards=3)", 4);
+
+  // Kuhn poker only ever has pass and bet, so the lists are shared.
+  std::shared_ptr<const open_spiel::Game> game =
+      open_spiel::LoadGame("kuhn_poker");
+  algorithms::LegalActionsTable table = algorithms::GetLegalActionsTable(
+      *game, /*depth_limit=*/-1, open_spiel::kInvalidPlayer, 4);
+  SPIEL_CHECK_EQ(table.NumInfoStates(),
+                 kuhn_poker::kNumInfoStatesP0 + kuhn_poker::kNumInfoStatesP1);
+  SPIEL_CHECK_EQ(table.NumActionLists(), 1);
+}
+
 }  // namespace
 
 int main(int argc, char** argv) {
   KuhnTest();
   LeducTest();
   GoofspielTest();
+  ThreadsTest();
+  TableTest();
 }
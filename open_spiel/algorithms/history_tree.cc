@@ -18,6 +18,7 @@
 #include <limits>
 #include <unordered_set>
 
+#include "open_spiel/algorithms/scoped_child.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
 
@@ -185,41 +186,42 @@ ActionsAndProbs GetSuccessorsWithProbs(const State& state,
   }
 }
 
-// TODO(author1): If this is a bottleneck, it should be possible
-// to pass the probabilities-so-far into the call, and get everything right
-// the first time, without recursion. The recursion is simpler, however.
-std::vector<std::pair<std::unique_ptr<State>, double>> DecisionNodes(
-    const State& parent_state, Player best_responder, const Policy* policy) {
+namespace {
+
+// Appends the decision nodes of best_responder in the sub-game rooted at
+// `state`, weighting each by `prob` times its counter-factual probability
+// relative to `state`. The state is walked in place when it supports
+// UndoAction, so only the returned decision nodes are cloned.
+void AppendDecisionNodes(
+    State* state, Player best_responder, const Policy* policy, double prob,
+    std::vector<std::pair<std::unique_ptr<State>, double>>* states_and_probs) {
   // If the state is terminal, then there are no more decisions to be made,
   // so we're done.
-  if (parent_state.IsTerminal()) return {};
+  if (state->IsTerminal()) return;
 
-  std::vector<std::pair<std::unique_ptr<State>, double>> states_and_probs;
   // We only consider states where the best_responder is making a decision.
-  if (parent_state.CurrentPlayer() == best_responder) {
-    states_and_probs.push_back({parent_state.Clone(), 1.});
+  if (state->CurrentPlayer() == best_responder) {
+    states_and_probs->push_back({state->Clone(), prob});
   }
   ActionsAndProbs actions_and_probs =
-      GetSuccessorsWithProbs(parent_state, best_responder, policy);
-  for (open_spiel::Action action : parent_state.LegalActions()) {
-    std::unique_ptr<State> child = parent_state.Child(action);
-
-    // We recurse here to get the correct probabilities for all children.
-    // This could probably be done in a cleaner, more performant way, but as
-    // this is only done once, at the start of the exploitability calculation,
-    // this is fine for now.
-    std::vector<std::pair<std::unique_ptr<State>, double>> children =
-        DecisionNodes(*child, best_responder, policy);
-    const double prob = GetProb(actions_and_probs, action);
-    SPIEL_CHECK_GE(prob, 0);
-    for (auto& state_and_prob : children) {
-      states_and_probs.push_back(
-          {std::move(state_and_prob.first),
-           // We weight the child probabilities by the probability of taking
-           // the action that would lead to them.
-           prob * state_and_prob.second});
-    }
+      GetSuccessorsWithProbs(*state, best_responder, policy);
+  for (open_spiel::Action action : state->LegalActions()) {
+    const double action_prob = GetProb(actions_and_probs, action);
+    SPIEL_CHECK_GE(action_prob, 0);
+    ScopedChild child(state, action);
+    AppendDecisionNodes(child.get(), best_responder, policy,
+                        prob * action_prob, states_and_probs);
   }
+}
+
+}  // namespace
+
+std::vector<std::pair<std::unique_ptr<State>, double>> DecisionNodes(
+    const State& parent_state, Player best_responder, const Policy* policy) {
+  std::vector<std::pair<std::unique_ptr<State>, double>> states_and_probs;
+  std::unique_ptr<State> state = parent_state.Clone();
+  AppendDecisionNodes(state.get(), best_responder, policy, /*prob=*/1.,
+                      &states_and_probs);
   return states_and_probs;
 }
 
@@ -15,13 +15,18 @@
 #include "open_spiel/algorithms/is_mcts.h"
 
 #include <algorithm>
+#include <atomic>
 #include <numeric>
+#include <string>
+#include <vector>
 
+#include "open_spiel/abseil-cpp/absl/hash/hash.h"
 #include "open_spiel/abseil-cpp/absl/random/discrete_distribution.h"
 #include "open_spiel/abseil-cpp/absl/random/distributions.h"
 #include "open_spiel/abseil-cpp/absl/time/time.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/thread.h"
 
 namespace open_spiel {
 namespace algorithms {
@@ -33,7 +38,7 @@ ISMCTSBot::ISMCTSBot(int seed, std::shared_ptr<Evaluator> evaluator,
                      double uct_c, int max_simulations, int max_world_samples,
                      ISMCTSFinalPolicyType final_policy_type,
                      bool use_observation_string,
-                     bool allow_inconsistent_action_sets)
+                     bool allow_inconsistent_action_sets, int num_threads)
     : rng_(seed),
       evaluator_(evaluator),
       uct_c_(uct_c),
@@ -41,21 +46,27 @@ ISMCTSBot::ISMCTSBot(int seed, std::shared_ptr<Evaluator> evaluator,
       max_world_samples_(max_world_samples),
       final_policy_type_(final_policy_type),
       use_observation_string_(use_observation_string),
-      allow_inconsistent_action_sets_(allow_inconsistent_action_sets) {}
+      allow_inconsistent_action_sets_(allow_inconsistent_action_sets),
+      num_threads_(num_threads) {
+  SPIEL_CHECK_GE(num_threads_, 1);
+}
 
 double ISMCTSBot::RandomNumber() { return absl::Uniform(rng_, 0.0, 1.0); }
 
 void ISMCTSBot::Reset() {
-  nodes_.clear();
-  node_pool_.clear();
+  for (NodeTableShard& shard : node_table_) {
+    shard.nodes.clear();
+    shard.node_pool.clear();
+  }
   root_samples_.clear();
 }
 
-std::string ISMCTSBot::GetStateKey(const State& state) const {
+uint64_t ISMCTSBot::GetStateKey(const State& state) const {
+  // Collisions are unlikely enough with 64 bits to be ignored.
   if (use_observation_string_) {
-    return state.ObservationString();
+    return absl::Hash<std::string>()(state.ObservationString());
   } else {
-    return state.InformationStateString();
+    return absl::Hash<std::string>()(state.InformationStateString());
   }
 }
 
@@ -64,17 +75,29 @@ ActionsAndProbs ISMCTSBot::RunSearch(const State& state) {
   SPIEL_CHECK_EQ(state.GetGame()->GetType().dynamics,
                  GameType::Dynamics::kSequential);
 
-  root_node_ = CreateNewNode(state);
+  const uint64_t root_key = GetStateKey(state);
+  {
+    NodeTableShard& shard = GetShard(root_key);
+    absl::MutexLock lock(&shard.mutex);
+    root_node_ = CreateNewNode(&shard, root_key);
+  }
   SPIEL_CHECK_TRUE(root_node_ != nullptr);
 
-  std::string root_infostate_key = GetStateKey(state);
-
-  for (int sim = 0; sim < max_simulations_; ++sim) {
-    std::unique_ptr<State> sampled_root_state = SampleRootState(state);
-    SPIEL_CHECK_EQ(root_infostate_key, GetStateKey(*sampled_root_state));
-    SPIEL_CHECK_TRUE(sampled_root_state != nullptr);
-    RunSimulation(sampled_root_state.get());
+  // The first thread uses the bot's generator, so that searches with a single
+  // thread are reproducible.
+  std::atomic<int> num_simulations{0};
+  const Philox search_rng(rng_());
+  std::vector<Philox> rngs;
+  for (int i = 1; i < num_threads_; ++i) rngs.push_back(search_rng.Split(i));
+  std::vector<Thread> threads;
+  for (int i = 1; i < num_threads_; ++i) {
+    threads.emplace_back([this, &state, root_key, &num_simulations, &rngs,
+                          i]() {
+      RunSimulations(state, root_key, &num_simulations, &rngs[i - 1]);
+    });
   }
+  RunSimulations(state, root_key, &num_simulations, &rng_);
+  for (Thread& thread : threads) thread.join();
 
   if (allow_inconsistent_action_sets_) {
     // Filter illegals for this state.
@@ -172,47 +195,60 @@ ActionsAndProbs ISMCTSBot::GetFinalPolicy(const State& state,
   return policy;
 }
 
+void ISMCTSBot::RunSimulations(const State& state, uint64_t root_key,
+                               std::atomic<int>* num_simulations,
+                               Philox* rng) {
+  while (num_simulations->fetch_add(1) < max_simulations_) {
+    std::unique_ptr<State> sampled_root_state = SampleRootState(state, rng);
+    SPIEL_CHECK_TRUE(sampled_root_state != nullptr);
+    SPIEL_CHECK_EQ(root_key, GetStateKey(*sampled_root_state));
+    RunSimulation(sampled_root_state.get(), rng);
+  }
+}
+
 std::unique_ptr<State> ISMCTSBot::ISMCTSBot::SampleRootState(
-    const State& state) {
+    const State& state, Philox* rng) {
+  auto random_number = [rng]() { return absl::Uniform(*rng, 0.0, 1.0); };
   if (max_world_samples_ == kUnlimitedNumWorldSamples) {
-    return state.ResampleFromInfostate(state.CurrentPlayer(),
-                                       [this]() { return RandomNumber(); });
-  } else if (root_samples_.size() < max_world_samples_) {
-    root_samples_.push_back(state.ResampleFromInfostate(
-        state.CurrentPlayer(), [this]() { return RandomNumber(); }));
+    return state.ResampleFromInfostate(state.CurrentPlayer(), random_number);
+  }
+  absl::MutexLock lock(&root_samples_mutex_);
+  if (root_samples_.size() < max_world_samples_) {
+    root_samples_.push_back(
+        state.ResampleFromInfostate(state.CurrentPlayer(), random_number));
     return root_samples_.back()->Clone();
   } else if (root_samples_.size() == max_world_samples_) {
-    int idx = absl::Uniform(rng_, 0u, root_samples_.size());
+    int idx = absl::Uniform(*rng, 0u, root_samples_.size());
     return root_samples_[idx]->Clone();
   } else {
     SpielFatalError("Case not handled (badly set max_world_samples..?)");
   }
 }
 
-ISMCTSNode* ISMCTSBot::CreateNewNode(const State& state) {
-  std::string infostate_key = GetStateKey(state);
-  node_pool_.push_back(std::unique_ptr<ISMCTSNode>(new ISMCTSNode));
-  ISMCTSNode* node = node_pool_.back().get();
-  nodes_[infostate_key] = node;
+ISMCTSNode* ISMCTSBot::CreateNewNode(NodeTableShard* shard, uint64_t key) {
+  shard->node_pool.push_back(std::unique_ptr<ISMCTSNode>(new ISMCTSNode));
+  ISMCTSNode* node = shard->node_pool.back().get();
+  shard->nodes[key] = node;
   node->total_visits = kUnexpandedVisitCount;
   return node;
 }
 
-ISMCTSNode* ISMCTSBot::LookupNode(const State& state) {
-  auto iter = nodes_.find(GetStateKey(state));
-  if (iter == nodes_.end()) {
+ISMCTSNode* ISMCTSBot::LookupNode(NodeTableShard* shard, uint64_t key) {
+  auto iter = shard->nodes.find(key);
+  if (iter == shard->nodes.end()) {
     return nullptr;
   } else {
     return iter->second;
   }
 }
 
-ISMCTSNode* ISMCTSBot::LookupOrCreateNode(const State& state) {
-  ISMCTSNode* node = LookupNode(state);
+ISMCTSNode* ISMCTSBot::LookupOrCreateNode(NodeTableShard* shard,
+                                          uint64_t key) {
+  ISMCTSNode* node = LookupNode(shard, key);
   if (node != nullptr) {
     return node;
   } else {
-    return CreateNewNode(state);
+    return CreateNewNode(shard, key);
   }
 }
 
@@ -239,7 +275,8 @@ void ISMCTSBot::ExpandIfNecessary(ISMCTSNode* node, Action action) const {
 }
 
 Action ISMCTSBot::SelectActionTreePolicy(
-    ISMCTSNode* node, const std::vector<Action>& legal_actions) {
+    ISMCTSNode* node, const std::vector<Action>& legal_actions,
+    Philox* rng) {
   // Check to see if we are allowing inconsistent action sets.
   if (allow_inconsistent_action_sets_) {
     // If so, it could mean that the node has actions with child info that are
@@ -248,18 +285,18 @@ Action ISMCTSBot::SelectActionTreePolicy(
     if (temp_node.total_visits == 0) {
       // If we've filtered everything, return a random action.
       Action action =
-          legal_actions[absl::Uniform(rng_, 0u, legal_actions.size())];
+          legal_actions[absl::Uniform(*rng, 0u, legal_actions.size())];
       ExpandIfNecessary(node, action);
       return action;
     } else {
-      return SelectActionUCB(&temp_node);
+      return SelectActionUCB(&temp_node, rng);
     }
   } else {
-    return SelectActionUCB(node);
+    return SelectActionUCB(node, rng);
   }
 }
 
-Action ISMCTSBot::SelectActionUCB(ISMCTSNode* node) {
+Action ISMCTSBot::SelectActionUCB(ISMCTSNode* node, Philox* rng) {
   std::vector<Action> candidates;
   double max_value = -std::numeric_limits<double>::infinity();
 
@@ -290,12 +327,13 @@ Action ISMCTSBot::SelectActionUCB(ISMCTSNode* node) {
   if (candidates.size() == 1) {
     return candidates[0];
   } else {
-    return candidates[absl::Uniform(rng_, 0u, candidates.size())];
+    return candidates[absl::Uniform(*rng, 0u, candidates.size())];
   }
 }
 
 Action ISMCTSBot::CheckExpand(ISMCTSNode* node,
-                              const std::vector<Action>& legal_actions) {
+                              const std::vector<Action>& legal_actions,
+                              Philox* rng) {
   // Fast check in the common/default case.
   if (!allow_inconsistent_action_sets_ &&
       node->child_info.size() == legal_actions.size()) {
@@ -304,7 +342,7 @@ Action ISMCTSBot::CheckExpand(ISMCTSNode* node,
 
   // Shuffle the legal actions to remove the bias from the move order.
   std::vector<Action> legal_actions_copy = legal_actions;
-  std::shuffle(legal_actions_copy.begin(), legal_actions_copy.end(), rng_);
+  std::shuffle(legal_actions_copy.begin(), legal_actions_copy.end(), *rng);
   for (Action action : legal_actions_copy) {
     if (node->child_info.find(action) == node->child_info.end()) {
       return action;
@@ -313,50 +351,64 @@ Action ISMCTSBot::CheckExpand(ISMCTSNode* node,
   return kInvalidAction;
 }
 
-std::vector<double> ISMCTSBot::RunSimulation(State* state) {
+std::vector<double> ISMCTSBot::RunSimulation(State* state,
+                                             Philox* rng) {
   if (state->IsTerminal()) {
     return state->Returns();
   } else if (state->IsChanceNode()) {
     Action chance_action =
-        SampleAction(state->ChanceOutcomes(), RandomNumber()).first;
+        state->SampleChanceOutcome(absl::Uniform(*rng, 0.0, 1.0)).first;
     state->ApplyAction(chance_action);
-    return RunSimulation(state);
+    return RunSimulation(state, rng);
   }
 
   std::vector<Action> legal_actions = state->LegalActions();
   Player cur_player = state->CurrentPlayer();
-  ISMCTSNode* node = LookupOrCreateNode(*state);
-  SPIEL_CHECK_TRUE(node != nullptr);
-
-  if (node->total_visits == kUnexpandedVisitCount) {
-    // Newly created node, so we've just stepped out of the tree.
-    node->total_visits = 0;  // Expand the node.
-    return evaluator_->Evaluate(*state);
-  } else {
-    // Apply tree policy.
-    Action chosen_action = CheckExpand(node, legal_actions);
-    if (chosen_action != kInvalidAction) {
-      // Expand.
-      ExpandIfNecessary(node, chosen_action);
+  const uint64_t key = GetStateKey(*state);
+  NodeTableShard& shard = GetShard(key);
+  ISMCTSNode* node;
+  Action chosen_action;
+  {
+    // The lock is released while simulating the rest of the game, so other
+    // threads can go through the node in the meantime.
+    absl::MutexLock lock(&shard.mutex);
+    node = LookupOrCreateNode(&shard, key);
+    SPIEL_CHECK_TRUE(node != nullptr);
+
+    if (node->total_visits == kUnexpandedVisitCount) {
+      // Newly created node, so we've just stepped out of the tree.
+      node->total_visits = 0;  // Expand the node.
+      chosen_action = kInvalidAction;
     } else {
-      // No expansion, so use the tree policy to select.
-      chosen_action = SelectActionTreePolicy(node, legal_actions);
-    }
-
-    SPIEL_CHECK_NE(chosen_action, kInvalidAction);
+      // Apply tree policy.
+      chosen_action = CheckExpand(node, legal_actions, rng);
+      if (chosen_action != kInvalidAction) {
+        // Expand.
+        ExpandIfNecessary(node, chosen_action);
+      } else {
+        // No expansion, so use the tree policy to select.
+        chosen_action = SelectActionTreePolicy(node, legal_actions, rng);
+      }
 
-    // Need to updates the visits before the recursive call. In games with
-    // imperfect recall, a node could be expanded with zero visit counts, and
-    // you might encounter the same (node, action) pair in the same simulation
-    // and the denominator for the UCT formula would be 0.
-    node->total_visits++;
-    node->child_info[chosen_action].visits++;
+      SPIEL_CHECK_NE(chosen_action, kInvalidAction);
 
-    state->ApplyAction(chosen_action);
-    std::vector<double> returns = RunSimulation(state);
-    node->child_info[chosen_action].return_sum += returns[cur_player];
-    return returns;
+      // Need to updates the visits before the recursive call. In games with
+      // imperfect recall, a node could be expanded with zero visit counts, and
+      // you might encounter the same (node, action) pair in the same
+      // simulation and the denominator for the UCT formula would be 0. With
+      // threads, this also makes the others less likely to follow the same
+      // path before the returns are backed up.
+      node->total_visits++;
+      node->child_info[chosen_action].visits++;
+    }
   }
+  if (chosen_action == kInvalidAction) return evaluator_->Evaluate(*state);
+
+  state->ApplyAction(chosen_action);
+  std::vector<double> returns = RunSimulation(state, rng);
+  absl::MutexLock lock(&shard.mutex);
+  node->child_info[chosen_action].return_sum += returns[cur_player];
+  return returns;
 }
 
 }  // namespace algorithms
@@ -15,14 +15,20 @@
 #ifndef OPEN_SPIEL_ALGORITHMS_IS_MCTS_H_
 #define OPEN_SPIEL_ALGORITHMS_IS_MCTS_H_
 
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <random>
 #include <string>
+#include <vector>
 
 #include "open_spiel/abseil-cpp/absl/container/flat_hash_map.h"
+#include "open_spiel/abseil-cpp/absl/synchronization/mutex.h"
 #include "open_spiel/algorithms/mcts.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_bots.h"
+#include "open_spiel/utils/random.h"
 
 // A basic implementation of Information Set Monte Carlo Tree Search (IS-MCTS)
 // by Cowling et al. https://ieeexplore.ieee.org/abstract/document/6203567.
@@ -62,12 +68,18 @@ class ISMCTSBot : public Bot {
   // (information state string or observation string) which can happen when
   // using observations or with game that have imperfect recall.
   //
+  // With num_threads > 1, that many threads run the simulations of each
+  // search, each on its own determinizations, sharing the node table. The
+  // evaluator is then called from all of them, and the search is not
+  // deterministic.
+  //
   // Important note: this bot requires that State::ResampleFromInfostate is
   // implemented.
   ISMCTSBot(int seed, std::shared_ptr<Evaluator> evaluator, double uct_c,
             int max_simulations, int max_world_samples,
             ISMCTSFinalPolicyType final_policy_type,
-            bool use_observation_string, bool allow_inconsistent_action_sets);
+            bool use_observation_string, bool allow_inconsistent_action_sets,
+            int num_threads = 1);
 
   // An IS-MCTS with sensible defaults.
   ISMCTSBot(int seed, std::shared_ptr<Evaluator> evaluator, double uct_c,
@@ -90,25 +102,42 @@ class ISMCTSBot : public Bot {
   void RestartAt(const State& state) override {}
 
  private:
+  // Nodes are stored by the hash of their state key, in shards which each have
+  // a lock protecting both the table and the nodes in it.
+  static constexpr int kNumNodeTableShards = 64;
+  struct NodeTableShard {
+    absl::Mutex mutex;
+    absl::flat_hash_map<uint64_t, ISMCTSNode*> nodes;
+    std::vector<std::unique_ptr<ISMCTSNode>> node_pool;
+  };
+
   void Reset();
   double RandomNumber();
 
-  std::string GetStateKey(const State& state) const;
-  std::unique_ptr<State> SampleRootState(const State& state);
-  ISMCTSNode* CreateNewNode(const State& state);
-  ISMCTSNode* LookupNode(const State& state);
-  ISMCTSNode* LookupOrCreateNode(const State& state);
+  // A hash of the information state string, or the observation string, of
+  // the state.
+  uint64_t GetStateKey(const State& state) const;
+  NodeTableShard& GetShard(uint64_t key) {
+    return node_table_[key % kNumNodeTableShards];
+  }
+  std::unique_ptr<State> SampleRootState(const State& state,
+                                         Philox* rng);
+  // These require the lock of the shard.
+  ISMCTSNode* CreateNewNode(NodeTableShard* shard, uint64_t key);
+  ISMCTSNode* LookupNode(NodeTableShard* shard, uint64_t key);
+  ISMCTSNode* LookupOrCreateNode(NodeTableShard* shard, uint64_t key);
   Action SelectActionTreePolicy(ISMCTSNode* node,
-                                const std::vector<Action>& legal_actions);
-  Action SelectActionUCB(ISMCTSNode* node);
+                                const std::vector<Action>& legal_actions,
+                                Philox* rng);
+  Action SelectActionUCB(ISMCTSNode* node, Philox* rng);
   ActionsAndProbs GetFinalPolicy(const State& state, ISMCTSNode* node) const;
   void ExpandIfNecessary(ISMCTSNode* node, Action action) const;
 
   // Check if an expansion is possible (i.e. node does not contain all the
   // actions). If so, returns an action not yet in the children. Otherwise,
   // returns kInvalidAction.
-  Action CheckExpand(ISMCTSNode* node,
-                     const std::vector<Action>& legal_actions);
+  Action CheckExpand(ISMCTSNode* node, const std::vector<Action>& legal_actions,
+                     Philox* rng);
 
   // Returns a copy of the node with any actions not in specified legal actions
   // removed.
@@ -116,15 +145,20 @@ class ISMCTSBot : public Bot {
                             const std::vector<Action>& legal_actions) const;
 
   // Run a simulation, returning the player returns.
-  std::vector<double> RunSimulation(State* state);
+  std::vector<double> RunSimulation(State* state, Philox* rng);
+
+  // Runs simulations from samples of the root until max_simulations have been
+  // claimed by all the threads.
+  void RunSimulations(const State& state, uint64_t root_key,
+                      std::atomic<int>* num_simulations, Philox* rng);
 
-  std::mt19937 rng_;
+  Philox rng_;
   std::shared_ptr<Evaluator> evaluator_;
-  absl::flat_hash_map<std::string, ISMCTSNode*> nodes_;
-  std::vector<std::unique_ptr<ISMCTSNode>> node_pool_;
+  std::array<NodeTableShard, kNumNodeTableShards> node_table_;
 
   // If the number of sampled world state is restricted, this list is used to
   // store the sampled states.
+  absl::Mutex root_samples_mutex_;
   std::vector<std::unique_ptr<State>> root_samples_;
 
   const double uct_c_;
@@ -133,6 +167,7 @@ class ISMCTSBot : public Bot {
   const ISMCTSFinalPolicyType final_policy_type_;
   const bool use_observation_string_;
   const bool allow_inconsistent_action_sets_;
+  const int num_threads_;
   ISMCTSNode* root_node_;
 };
 
@@ -98,6 +98,32 @@ void ISMCTS_LeducObservationTest() {
   PlayGame(*game, bot.get(), &rng);
 }
 
+void ISMCTS_MultithreadedTest() {
+  std::mt19937 rng(kSeed);
+  std::shared_ptr<const Game> game = LoadGame("leduc_poker");
+  auto evaluator =
+      std::make_shared<algorithms::RandomRolloutEvaluator>(1, kSeed);
+  for (int max_world_samples : {algorithms::kUnlimitedNumWorldSamples, 10}) {
+    auto bot = std::make_unique<algorithms::ISMCTSBot>(
+        kSeed, evaluator, 5.0, 1000, max_world_samples,
+        algorithms::ISMCTSFinalPolicyType::kNormalizedVisitCount, false, false,
+        /*num_threads=*/4);
+    std::unique_ptr<State> state = game->NewInitialState();
+    while (state->IsChanceNode()) {
+      state->ApplyAction(SampleAction(state->ChanceOutcomes(),
+                                      absl::Uniform(rng, 0.0, 1.0))
+                             .first);
+    }
+    // Every simulation goes through the root once.
+    double total_probability = 0;
+    for (const auto& [action, probability] : bot->GetPolicy(*state)) {
+      total_probability += probability;
+    }
+    SPIEL_CHECK_FLOAT_EQ(total_probability, 1);
+    PlayGame(*game, bot.get(), &rng);
+  }
+}
+
 }  // namespace
 }  // namespace open_spiel
 
@@ -105,4 +131,5 @@ int main(int argc, char** argv) {
   open_spiel::ISMCTS_BasicPlayGameTest_Kuhn();
   open_spiel::ISMCTS_BasicPlayGameTest_Leduc();
   open_spiel::ISMCTS_LeducObservationTest();
+  open_spiel::ISMCTS_MultithreadedTest();
 }
@@ -0,0 +1,202 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/local_best_response.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "open_spiel/policy.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/stats.h"
+#include "open_spiel/utils/thread.h"
+
+namespace open_spiel {
+namespace algorithms {
+namespace {
+
+double Uniform(std::mt19937* rng) {
+  return std::uniform_real_distribution<double>(0., 1.)(*rng);
+}
+
+ActionsAndProbs Outcomes(const Policy& policy, const State& state) {
+  return state.IsChanceNode() ? state.ChanceOutcomes()
+                              : policy.GetStatePolicy(state);
+}
+
+// The probability of the actions of the player's opponents in the history of
+// the state, when they follow the policy.
+double OpponentReach(const Game& game, const Policy& policy,
+                     const State& state, Player player) {
+  std::unique_ptr<State> replay = game.NewInitialState();
+  double reach = 1;
+  for (Action action : state.History()) {
+    if (!replay->IsChanceNode() && replay->CurrentPlayer() != player) {
+      reach *= GetProb(policy.GetStatePolicy(*replay), action);
+      if (reach <= 0) return 0;
+    }
+    replay->ApplyAction(action);
+  }
+  return reach;
+}
+
+// The player's return once everyone plays the policy from the state.
+double Rollout(const Policy& policy, const State& state, Player player,
+               std::mt19937* rng) {
+  std::unique_ptr<State> rollout = state.Clone();
+  while (!rollout->IsTerminal()) {
+    rollout->ApplyAction(
+        SampleAction(Outcomes(policy, *rollout), Uniform(rng)).first);
+  }
+  return rollout->PlayerReturn(player);
+}
+
+// The player's value at the state when everyone plays the policy, expanded
+// exactly for depth plies, then estimated by rollouts.
+double Evaluate(const Policy& policy, const State& state, Player player,
+                int depth, const LocalBestResponseOptions& options,
+                std::mt19937* rng) {
+  if (state.IsTerminal()) return state.PlayerReturn(player);
+  if (depth == 0) {
+    double value = 0;
+    for (int i = 0; i < options.num_rollouts; ++i) {
+      value += Rollout(policy, state, player, rng);
+    }
+    return value / options.num_rollouts;
+  }
+  double value = 0;
+  for (const auto& [action, prob] : Outcomes(policy, state)) {
+    if (prob <= 0) continue;
+    value += prob * Evaluate(policy, *state.Child(action), player, depth - 1,
+                             options, rng);
+  }
+  return value;
+}
+
+// Plays an episode of the player's local best response against the policy,
+// and returns the player's return.
+double PlayEpisode(const Game& game, const Policy& policy, Player player,
+                   const LocalBestResponseOptions& options, std::mt19937* rng) {
+  std::unique_ptr<State> state = game.NewInitialState();
+  while (!state->IsTerminal()) {
+    if (state->CurrentPlayer() == player) {
+      state->ApplyAction(
+          LocalBestResponseAction(game, policy, *state, options, rng));
+    } else {
+      state->ApplyAction(
+          SampleAction(Outcomes(policy, *state), Uniform(rng)).first);
+    }
+  }
+  return state->PlayerReturn(player);
+}
+
+}  // namespace
+
+Action LocalBestResponseAction(const Game& game, const Policy& policy,
+                               const State& state,
+                               const LocalBestResponseOptions& options,
+                               std::mt19937* rng) {
+  const Player player = state.CurrentPlayer();
+  SPIEL_CHECK_GE(player, 0);
+  const std::vector<Action> actions = state.LegalActions();
+  if (actions.size() == 1) return actions[0];
+
+  // The values of the actions, summed over the worlds with their weights.
+  std::vector<double> values(actions.size(), 0);
+  double total_weight = 0;
+  for (int i = 0; i < options.num_worlds; ++i) {
+    const std::unique_ptr<State> world =
+        state.ResampleFromInfostate(player, [rng]() { return Uniform(rng); });
+    const double weight = OpponentReach(game, policy, *world, player);
+    if (weight <= 0) continue;
+    total_weight += weight;
+    for (int a = 0; a < actions.size(); ++a) {
+      values[a] += weight * Evaluate(policy, *world->Child(actions[a]), player,
+                                     options.depth, options, rng);
+    }
+  }
+
+  // Where no world is likely under the policy, nothing was learned about the
+  // actions, so play the policy.
+  if (total_weight <= 0) {
+    return SampleAction(policy.GetStatePolicy(state), Uniform(rng)).first;
+  }
+  return actions[std::max_element(values.begin(), values.end()) -
+                 values.begin()];
+}
+
+LocalBestResponseResults LocalBestResponseExploitability(
+    const Game& game, const Policy& policy,
+    const LocalBestResponseOptions& options) {
+  const GameType& game_type = game.GetType();
+  if (game_type.dynamics != GameType::Dynamics::kSequential) {
+    SpielFatalError("The game must be turn-based.");
+  }
+  if (game_type.utility != GameType::Utility::kZeroSum &&
+      game_type.utility != GameType::Utility::kConstantSum) {
+    SpielFatalError("The game must have zero- or constant-sum utility.");
+  }
+  SPIEL_CHECK_GE(options.num_episodes, 1);
+  SPIEL_CHECK_GE(options.num_worlds, 1);
+  SPIEL_CHECK_GE(options.depth, 0);
+  SPIEL_CHECK_GE(options.num_rollouts, 1);
+
+  // Every episode has its own seed, so that the results don't depend on how
+  // the episodes are shared out between the threads.
+  const int num_players = game.NumPlayers();
+  const int64_t num_episodes =
+      static_cast<int64_t>(num_players) * options.num_episodes;
+  std::vector<double> episode_returns(num_episodes);
+  auto play = [&](int64_t begin, int64_t end) {
+    for (int64_t episode = begin; episode < end; ++episode) {
+      std::seed_seq seed{options.seed, static_cast<int>(episode)};
+      std::mt19937 rng(seed);
+      episode_returns[episode] =
+          PlayEpisode(game, policy, episode % num_players, options, &rng);
+    }
+  };
+  const int num_threads = std::max(1, options.num_threads);
+  if (num_threads == 1) {
+    play(0, num_episodes);
+  } else {
+    ThreadPool::Default()->ParallelFor(
+        0, num_episodes, (num_episodes + num_threads - 1) / num_threads, play);
+  }
+
+  LocalBestResponseResults results;
+  results.returns.resize(num_players);
+  for (int64_t episode = 0; episode < num_episodes; ++episode) {
+    results.returns[episode % num_players].Add(episode_returns[episode]);
+  }
+  // The players' episodes are independent, so the variances of their mean
+  // returns add up.
+  double variance = 0;
+  for (const BasicStats& returns : results.returns) {
+    results.nash_conv += returns.Avg();
+    variance += returns.StdDev() * returns.StdDev() / returns.Num();
+  }
+  results.nash_conv -= game.UtilitySum();
+  results.exploitability = results.nash_conv / num_players;
+  results.exploitability_half_width =
+      options.z * std::sqrt(variance) / num_players;
+  return results;
+}
+
+}  // namespace algorithms
+}  // namespace open_spiel
@@ -0,0 +1,101 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_ALGORITHMS_LOCAL_BEST_RESPONSE_H_
+#define OPEN_SPIEL_ALGORITHMS_LOCAL_BEST_RESPONSE_H_
+
+#include <random>
+#include <vector>
+
+#include "open_spiel/policy.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/utils/stats.h"
+
+// Approximate exploitability for games too large for the exact best responses
+// of tabular_exploitability.h, from local best responses, after Lisy and
+// Bowling, "Equilibrium Approximation Quality of Current No-Limit Poker Bots",
+// https://arxiv.org/abs/1612.07547.
+//
+// A local best responder plays a game against the others following the policy,
+// and at each of its decisions takes the action with the highest value against
+// them, estimated in worlds sampled from its information state. The worlds
+// are weighted by the probability of the opponents' actions in them under the
+// policy, so that they follow the posterior over the hidden information. The
+// value of an action in a world is that of the policy played by everyone from
+// there on, expanded exactly for a few plies, then estimated by rollouts.
+//
+// A local best response is a strategy, if not the best one, so the returns it
+// gets are a lower bound on those of a best response, and the exploitability
+// they give is a lower bound on the exploitability of the policy, up to the
+// sampling error of the episodes played.
+//
+// The game must be sequential, zero-sum or constant-sum, with perfect recall,
+// and implement State::ResampleFromInfostate, sampling the chance outcomes
+// from their prior. The policy is queried concurrently when using several
+// threads.
+
+namespace open_spiel {
+namespace algorithms {
+
+struct LocalBestResponseOptions {
+  // The episodes each player's local best responder plays against the policy.
+  int num_episodes = 1000;
+  // The worlds sampled from the information state at each decision.
+  int num_worlds = 32;
+  // The plies expanded exactly below each action, before the rollouts.
+  int depth = 0;
+  // The rollouts to the end of the game from each leaf of the expansion.
+  int num_rollouts = 1;
+  int seed = 0;
+  // The episodes are shared out between this many workers of the shared
+  // ThreadPool. The results don't depend on it.
+  int num_threads = 1;
+  // The confidence intervals are z standard errors wide on either side.
+  double z = 1.96;
+};
+
+struct LocalBestResponseResults {
+  // The returns of each player's local best responder against the policy.
+  std::vector<BasicStats> returns;
+  // The sum of the local best responders' gains over the policy's values, as
+  // for NashConv, and the exploitability, which is that over the number of
+  // players.
+  double nash_conv = 0;
+  double exploitability = 0;
+  // Half the width of the confidence interval of the exploitability.
+  double exploitability_half_width = 0;
+
+  // The lower end of the confidence interval of the exploitability: the
+  // policy is at least that exploitable, with the confidence given by z.
+  double ExploitabilityLowerBound() const {
+    return exploitability - exploitability_half_width;
+  }
+};
+
+// The action of the player's local best response at the state, which must be
+// the player's decision.
+Action LocalBestResponseAction(const Game& game, const Policy& policy,
+                               const State& state,
+                               const LocalBestResponseOptions& options,
+                               std::mt19937* rng);
+
+// Plays local best responses for every player against the policy.
+LocalBestResponseResults LocalBestResponseExploitability(
+    const Game& game, const Policy& policy,
+    const LocalBestResponseOptions& options);
+
+}  // namespace algorithms
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_ALGORITHMS_LOCAL_BEST_RESPONSE_H_
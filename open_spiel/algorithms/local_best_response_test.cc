@@ -0,0 +1,92 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/local_best_response.h"
+
+#include <memory>
+#include <string>
+
+#include "open_spiel/algorithms/cfr.h"
+#include "open_spiel/algorithms/tabular_exploitability.h"
+#include "open_spiel/policy.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace algorithms {
+namespace {
+
+// With the values expanded to the end of the game, the local best response
+// sees the exact values of the actions in the sampled worlds, and finds a
+// lower bound close to the exact exploitability.
+void UniformPolicyTest(const std::string& game_name, int depth) {
+  std::shared_ptr<const Game> game = LoadGame(game_name);
+  const TabularPolicy policy = GetUniformPolicy(*game);
+  const double exploitability = Exploitability(*game, policy);
+  LocalBestResponseOptions options;
+  options.num_episodes = 2000;
+  options.depth = depth;
+  const LocalBestResponseResults results =
+      LocalBestResponseExploitability(*game, policy, options);
+  SPIEL_CHECK_EQ(results.returns.size(), game->NumPlayers());
+  SPIEL_CHECK_EQ(results.returns[0].Num(), options.num_episodes);
+  SPIEL_CHECK_GT(results.exploitability_half_width, 0);
+  SPIEL_CHECK_GT(results.ExploitabilityLowerBound(), 0);
+  SPIEL_CHECK_LE(results.ExploitabilityLowerBound(), exploitability);
+  SPIEL_CHECK_GT(results.exploitability + results.exploitability_half_width,
+                 0.8 * exploitability);
+}
+
+// An equilibrium can't be shown to be exploitable.
+void EquilibriumTest() {
+  std::shared_ptr<const Game> game = LoadGame("kuhn_poker");
+  CFRPlusSolver solver(*game);
+  for (int i = 0; i < 500; ++i) solver.EvaluateAndUpdatePolicy();
+  const std::unique_ptr<Policy> policy = solver.AveragePolicy();
+  LocalBestResponseOptions options;
+  options.num_episodes = 2000;
+  options.depth = 10;
+  const LocalBestResponseResults results =
+      LocalBestResponseExploitability(*game, *policy, options);
+  SPIEL_CHECK_LE(results.ExploitabilityLowerBound(),
+                 Exploitability(*game, *policy));
+}
+
+// The results don't depend on the number of threads.
+void ThreadsTest() {
+  std::shared_ptr<const Game> game = LoadGame("leduc_poker");
+  const TabularPolicy policy = GetUniformPolicy(*game);
+  LocalBestResponseOptions options;
+  options.num_episodes = 20;
+  options.num_worlds = 4;
+  const LocalBestResponseResults results =
+      LocalBestResponseExploitability(*game, policy, options);
+  options.num_threads = 4;
+  const LocalBestResponseResults threaded_results =
+      LocalBestResponseExploitability(*game, policy, options);
+  SPIEL_CHECK_EQ(results.nash_conv, threaded_results.nash_conv);
+  SPIEL_CHECK_EQ(results.exploitability_half_width,
+                 threaded_results.exploitability_half_width);
+}
+
+}  // namespace
+}  // namespace algorithms
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  open_spiel::algorithms::UniformPolicyTest("kuhn_poker", /*depth=*/10);
+  open_spiel::algorithms::UniformPolicyTest("leduc_poker", /*depth=*/0);
+  open_spiel::algorithms::EquilibriumTest();
+  open_spiel::algorithms::ThreadsTest();
+}
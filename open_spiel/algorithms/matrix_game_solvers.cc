@@ -0,0 +1,490 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/matrix_game_solvers.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/types/span.h"
+#include "open_spiel/matrix_game.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/thread.h"
+
+namespace open_spiel {
+namespace algorithms {
+namespace {
+
+using matrix_game::MatrixGame;
+
+// The columns are processed in blocks of this many, 16KB of doubles.
+constexpr int kColBlock = 2048;
+
+// The tiles of the transposition are kTile x kTile.
+constexpr int kTile = 32;
+
+double Dot(absl::Span<const double> a, absl::Span<const double> b) {
+  SPIEL_CHECK_EQ(a.size(), b.size());
+  // Independent sums, so the additions do not wait on each other.
+  double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+  int i = 0;
+  for (; i + 4 <= a.size(); i += 4) {
+    s0 += a[i] * b[i];
+    s1 += a[i + 1] * b[i + 1];
+    s2 += a[i + 2] * b[i + 2];
+    s3 += a[i + 3] * b[i + 3];
+  }
+  for (; i < a.size(); ++i) s0 += a[i] * b[i];
+  return (s0 + s1) + (s2 + s3);
+}
+
+// Matrices with fewer entries than this per thread are multiplied on fewer
+// threads.
+constexpr int64_t kMinEntriesPerThread = 1 << 16;
+
+// Runs fn(begin, end) on contiguous blocks of [0, size), one per thread,
+// with at most num_threads threads and no fewer than
+// kMinEntriesPerThread entries of a matrix with num_entries entries each.
+void ParallelFor(int size, int64_t num_entries, int num_threads,
+                 const std::function<void(int, int)>& fn) {
+  num_threads = std::min<int64_t>(
+      {num_threads, size, num_entries / kMinEntriesPerThread + 1});
+  if (num_threads <= 1) {
+    fn(0, size);
+    return;
+  }
+  std::vector<Thread> threads;
+  threads.reserve(num_threads - 1);
+  for (int block = 1; block < num_threads; ++block) {
+    threads.emplace_back([&fn, block, size, num_threads]() {
+      fn(static_cast<int64_t>(block) * size / num_threads,
+         static_cast<int64_t>(block + 1) * size / num_threads);
+    });
+  }
+  fn(0, size / num_threads);
+  for (Thread& thread : threads) thread.join();
+}
+
+// y = M x on the rows [row_begin, row_end) of a row-major num_rows x num_cols
+// matrix M.
+void MatrixVectorRows(const double* matrix, int row_begin, int row_end,
+                      int num_cols, const double* x, double* y) {
+  std::fill(y + row_begin, y + row_end, 0.0);
+  for (int begin = 0; begin < num_cols; begin += kColBlock) {
+    const int end = std::min(begin + kColBlock, num_cols);
+    // Four rows at a time, which share the loads of x.
+    int row = row_begin;
+    for (; row + 4 <= row_end; row += 4) {
+      const double* row0 = matrix + static_cast<int64_t>(row) * num_cols;
+      const double* row1 = row0 + num_cols;
+      const double* row2 = row1 + num_cols;
+      const double* row3 = row2 + num_cols;
+      double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+      for (int col = begin; col < end; ++col) {
+        s0 += row0[col] * x[col];
+        s1 += row1[col] * x[col];
+        s2 += row2[col] * x[col];
+        s3 += row3[col] * x[col];
+      }
+      y[row] += s0;
+      y[row + 1] += s1;
+      y[row + 2] += s2;
+      y[row + 3] += s3;
+    }
+    for (; row < row_end; ++row) {
+      const double* row0 = matrix + static_cast<int64_t>(row) * num_cols;
+      double s0 = 0;
+      for (int col = begin; col < end; ++col) s0 += row0[col] * x[col];
+      y[row] += s0;
+    }
+  }
+}
+
+// y = x^T M on the columns [col_begin, col_end) of a row-major num_rows x
+// num_cols matrix M, as a sum of the rows of M, skipping those of weight 0.
+void VectorMatrixCols(const double* matrix, int num_rows, int num_cols,
+                      int col_begin, int col_end, const double* x,
+                      double* y) {
+  std::fill(y + col_begin, y + col_end, 0.0);
+  for (int begin = col_begin; begin < col_end; begin += kColBlock) {
+    const int end = std::min(begin + kColBlock, col_end);
+    for (int row = 0; row < num_rows; ++row) {
+      const double weight = x[row];
+      if (weight == 0) continue;
+      const double* row0 = matrix + static_cast<int64_t>(row) * num_cols;
+      for (int col = begin; col < end; ++col) y[col] += weight * row0[col];
+    }
+  }
+}
+
+// y = M x, the rows shared out between the threads.
+void MatrixVector(const double* matrix, int num_rows, int num_cols,
+                  const double* x, double* y, int num_threads) {
+  ParallelFor(num_rows, static_cast<int64_t>(num_rows) * num_cols,
+              num_threads, [&](int begin, int end) {
+                MatrixVectorRows(matrix, begin, end, num_cols, x, y);
+              });
+}
+
+// y = x^T M, the columns shared out between the threads.
+void VectorMatrix(const double* matrix, int num_rows, int num_cols,
+                  const double* x, double* y, int num_threads) {
+  ParallelFor(num_cols, static_cast<int64_t>(num_rows) * num_cols,
+              num_threads, [&](int begin, int end) {
+                VectorMatrixCols(matrix, num_rows, num_cols, begin, end, x, y);
+              });
+}
+
+// The transpose of a row-major num_rows x num_cols matrix, by tiles.
+std::vector<double> Transpose(const std::vector<double>& matrix, int num_rows,
+                              int num_cols) {
+  std::vector<double> transpose(matrix.size());
+  for (int row_begin = 0; row_begin < num_rows; row_begin += kTile) {
+    const int row_end = std::min(row_begin + kTile, num_rows);
+    for (int col_begin = 0; col_begin < num_cols; col_begin += kTile) {
+      const int col_end = std::min(col_begin + kTile, num_cols);
+      for (int row = row_begin; row < row_end; ++row) {
+        for (int col = col_begin; col < col_end; ++col) {
+          transpose[static_cast<int64_t>(col) * num_rows + row] =
+              matrix[static_cast<int64_t>(row) * num_cols + col];
+        }
+      }
+    }
+  }
+  return transpose;
+}
+
+// Adds a row of a row-major matrix, with as many columns as sums has
+// entries, to sums.
+void AddRow(const std::vector<double>& matrix, int row,
+            std::vector<double>* sums) {
+  const double* values =
+      matrix.data() + static_cast<int64_t>(row) * sums->size();
+  for (int i = 0; i < sums->size(); ++i) (*sums)[i] += values[i];
+}
+
+int ArgMax(const std::vector<double>& values) {
+  return std::max_element(values.begin(), values.end()) - values.begin();
+}
+
+// Projects the values onto the probability simplex (Duchi et al., Efficient
+// Projections onto the l1-Ball for Learning in High Dimensions, 2008).
+void ProjectOntoSimplex(std::vector<double>* values,
+                        std::vector<double>* sorted) {
+  sorted->assign(values->begin(), values->end());
+  std::sort(sorted->begin(), sorted->end(), std::greater<double>());
+  // The threshold is set by the largest values, those above it.
+  double sum = 0;
+  double threshold = 0;
+  for (int i = 0; i < sorted->size(); ++i) {
+    sum += (*sorted)[i];
+    const double candidate = (sum - 1) / (i + 1);
+    if ((*sorted)[i] <= candidate) break;
+    threshold = candidate;
+  }
+  for (double& value : *values) value = std::max(value - threshold, 0.0);
+}
+
+// Estimates the largest singular value of a row-major matrix by power
+// iteration on M^T M.
+double SpectralNorm(const double* matrix, int num_rows, int num_cols,
+                    int num_threads) {
+  constexpr int kNumPowerIterations = 30;
+  // A random start, as constant vectors are often in the kernel of M.
+  std::mt19937 rng(0);
+  std::uniform_real_distribution<double> dist(0.5, 1.5);
+  std::vector<double> v(num_cols);
+  for (double& value : v) value = dist(rng);
+  std::vector<double> w(num_rows);
+  double norm = 0;
+  for (int i = 0; i < kNumPowerIterations; ++i) {
+    const double length = std::sqrt(Dot(v, v));
+    if (length == 0) return 0;
+    for (double& value : v) value /= length;
+    MatrixVector(matrix, num_rows, num_cols, v.data(), w.data(), num_threads);
+    VectorMatrix(matrix, num_rows, num_cols, w.data(), v.data(), num_threads);
+    // v is now M^T M v for a unit v.
+    norm = std::sqrt(std::sqrt(Dot(v, v)));
+  }
+  return norm;
+}
+
+// The duality gap of a profile, given the payoffs of the row player's
+// actions, A y, and of the column player's, x^T A, all scaled by scale.
+double DualityGap(const std::vector<double>& row_payoffs,
+                  const std::vector<double>& col_payoffs, double scale) {
+  return (*std::max_element(row_payoffs.begin(), row_payoffs.end()) -
+          *std::min_element(col_payoffs.begin(), col_payoffs.end())) /
+         scale;
+}
+
+}  // namespace
+
+void ActionPayoffs(const MatrixGame& game, Player player,
+                   absl::Span<const double> opponent_strategy,
+                   absl::Span<double> payoffs, int num_threads) {
+  if (player == matrix_game::kRowPlayer) {
+    SPIEL_CHECK_EQ(opponent_strategy.size(), game.NumCols());
+    SPIEL_CHECK_EQ(payoffs.size(), game.NumRows());
+    MatrixVector(game.RowUtilities().data(), game.NumRows(), game.NumCols(),
+                 opponent_strategy.data(), payoffs.data(), num_threads);
+  } else {
+    SPIEL_CHECK_EQ(player, matrix_game::kColPlayer);
+    SPIEL_CHECK_EQ(opponent_strategy.size(), game.NumRows());
+    SPIEL_CHECK_EQ(payoffs.size(), game.NumCols());
+    VectorMatrix(game.ColUtilities().data(), game.NumRows(), game.NumCols(),
+                 opponent_strategy.data(), payoffs.data(), num_threads);
+  }
+}
+
+std::vector<double> ActionPayoffs(const MatrixGame& game, Player player,
+                                  absl::Span<const double> opponent_strategy,
+                                  int num_threads) {
+  std::vector<double> payoffs(player == matrix_game::kRowPlayer
+                                  ? game.NumRows()
+                                  : game.NumCols());
+  ActionPayoffs(game, player, opponent_strategy, absl::MakeSpan(payoffs),
+                num_threads);
+  return payoffs;
+}
+
+std::vector<double> ExpectedPayoffs(const MatrixGame& game,
+                                    absl::Span<const double> row_strategy,
+                                    absl::Span<const double> col_strategy) {
+  return {Dot(row_strategy, ActionPayoffs(game, matrix_game::kRowPlayer,
+                                          col_strategy)),
+          Dot(col_strategy, ActionPayoffs(game, matrix_game::kColPlayer,
+                                          row_strategy))};
+}
+
+double MatrixGameNashConv(const MatrixGame& game,
+                          absl::Span<const double> row_strategy,
+                          absl::Span<const double> col_strategy) {
+  const std::vector<double> row_payoffs =
+      ActionPayoffs(game, matrix_game::kRowPlayer, col_strategy);
+  const std::vector<double> col_payoffs =
+      ActionPayoffs(game, matrix_game::kColPlayer, row_strategy);
+  return *std::max_element(row_payoffs.begin(), row_payoffs.end()) -
+         Dot(row_strategy, row_payoffs) +
+         *std::max_element(col_payoffs.begin(), col_payoffs.end()) -
+         Dot(col_strategy, col_payoffs);
+}
+
+void RegretMatchingUpdate(absl::Span<const double> payoffs,
+                          absl::Span<const double> strategy,
+                          bool regret_matching_plus,
+                          absl::Span<double> cumulative_regrets,
+                          absl::Span<double> next_strategy) {
+  const int num_actions = payoffs.size();
+  SPIEL_CHECK_EQ(strategy.size(), num_actions);
+  SPIEL_CHECK_EQ(cumulative_regrets.size(), num_actions);
+  SPIEL_CHECK_EQ(next_strategy.size(), num_actions);
+  const double value = Dot(payoffs, strategy);
+  double positive_sum = 0;
+  for (int a = 0; a < num_actions; ++a) {
+    double regret = cumulative_regrets[a] + payoffs[a] - value;
+    if (regret_matching_plus) regret = std::max(regret, 0.0);
+    cumulative_regrets[a] = regret;
+    positive_sum += std::max(regret, 0.0);
+  }
+  if (positive_sum > 0) {
+    for (int a = 0; a < num_actions; ++a) {
+      next_strategy[a] = std::max(cumulative_regrets[a], 0.0) / positive_sum;
+    }
+  } else {
+    std::fill(next_strategy.begin(), next_strategy.end(), 1.0 / num_actions);
+  }
+}
+
+MatrixGameSolution SolveWithRegretMatching(const MatrixGame& game,
+                                           int num_iterations,
+                                           bool regret_matching_plus) {
+  SPIEL_CHECK_GT(num_iterations, 0);
+  const int num_rows = game.NumRows();
+  const int num_cols = game.NumCols();
+  std::vector<double> row_strategy(num_rows, 1.0 / num_rows);
+  std::vector<double> col_strategy(num_cols, 1.0 / num_cols);
+  std::vector<double> row_regrets(num_rows, 0);
+  std::vector<double> col_regrets(num_cols, 0);
+  std::vector<double> row_payoffs(num_rows);
+  std::vector<double> col_payoffs(num_cols);
+  std::vector<double> next_row_strategy(num_rows);
+  std::vector<double> next_col_strategy(num_cols);
+  MatrixGameSolution solution{std::vector<double>(num_rows, 0),
+                              std::vector<double>(num_cols, 0)};
+  double total_weight = 0;
+  for (int t = 1; t <= num_iterations; ++t) {
+    ActionPayoffs(game, matrix_game::kRowPlayer, col_strategy,
+                  absl::MakeSpan(row_payoffs));
+    ActionPayoffs(game, matrix_game::kColPlayer, row_strategy,
+                  absl::MakeSpan(col_payoffs));
+    const double weight = regret_matching_plus ? t : 1;
+    total_weight += weight;
+    for (int row = 0; row < num_rows; ++row) {
+      solution.row_strategy[row] += weight * row_strategy[row];
+    }
+    for (int col = 0; col < num_cols; ++col) {
+      solution.col_strategy[col] += weight * col_strategy[col];
+    }
+    RegretMatchingUpdate(row_payoffs, row_strategy, regret_matching_plus,
+                         absl::MakeSpan(row_regrets),
+                         absl::MakeSpan(next_row_strategy));
+    RegretMatchingUpdate(col_payoffs, col_strategy, regret_matching_plus,
+                         absl::MakeSpan(col_regrets),
+                         absl::MakeSpan(next_col_strategy));
+    row_strategy.swap(next_row_strategy);
+    col_strategy.swap(next_col_strategy);
+  }
+  for (double& p : solution.row_strategy) p /= total_weight;
+  for (double& p : solution.col_strategy) p /= total_weight;
+  return solution;
+}
+
+MatrixGameSolution SolveWithFictitiousPlay(const MatrixGame& game,
+                                           int num_iterations) {
+  SPIEL_CHECK_GT(num_iterations, 0);
+  const int num_rows = game.NumRows();
+  const int num_cols = game.NumCols();
+  // Row c of the transpose holds the row player's utilities against column c.
+  const std::vector<double> row_utilities_by_col =
+      Transpose(game.RowUtilities(), num_rows, num_cols);
+  // The payoffs of the actions against the sums of the opponent's plays.
+  std::vector<double> row_payoffs(num_rows, 0);
+  std::vector<double> col_payoffs(num_cols, 0);
+  MatrixGameSolution solution{std::vector<double>(num_rows, 0),
+                              std::vector<double>(num_cols, 0)};
+  for (int t = 0; t < num_iterations; ++t) {
+    const int row = t == 0 ? 0 : ArgMax(row_payoffs);
+    const int col = t == 0 ? 0 : ArgMax(col_payoffs);
+    solution.row_strategy[row] += 1;
+    solution.col_strategy[col] += 1;
+    AddRow(row_utilities_by_col, col, &row_payoffs);
+    AddRow(game.ColUtilities(), row, &col_payoffs);
+  }
+  for (double& p : solution.row_strategy) p /= num_iterations;
+  for (double& p : solution.col_strategy) p /= num_iterations;
+  return solution;
+}
+
+MatrixGameSolution SolveZeroSumMatrixGame(const MatrixGame& game,
+                                          double epsilon, int max_iterations,
+                                          int num_threads) {
+  // Restart when the gap is this fraction of that at the last restart.
+  constexpr double kRestartFactor = 0.2;
+  const int num_rows = game.NumRows();
+  const int num_cols = game.NumCols();
+  const double* utilities = game.RowUtilities().data();
+  auto compute_row_payoffs = [&](const std::vector<double>& y,
+                                 std::vector<double>* row_payoffs) {
+    MatrixVector(utilities, num_rows, num_cols, y.data(), row_payoffs->data(),
+                 num_threads);
+  };
+  auto compute_col_payoffs = [&](const std::vector<double>& x,
+                                 std::vector<double>* col_payoffs) {
+    VectorMatrix(utilities, num_rows, num_cols, x.data(), col_payoffs->data(),
+                 num_threads);
+  };
+
+  std::vector<double> x(num_rows, 1.0 / num_rows);
+  std::vector<double> y(num_cols, 1.0 / num_cols);
+  std::vector<double> row_payoffs(num_rows);
+  std::vector<double> col_payoffs(num_cols);
+  compute_row_payoffs(y, &row_payoffs);
+  compute_col_payoffs(x, &col_payoffs);
+  MatrixGameSolution best{x, y};
+  double best_gap = DualityGap(row_payoffs, col_payoffs, 1);
+  const double norm =
+      SpectralNorm(utilities, num_rows, num_cols, num_threads);
+  if (best_gap <= epsilon || norm == 0) return best;
+  const double step = 0.9 / norm;
+
+  // The sums of the iterates since the last restart, and of their payoffs,
+  // which are those of the average iterate.
+  std::vector<double> x_sum(num_rows, 0);
+  std::vector<double> y_sum(num_cols, 0);
+  std::vector<double> row_payoffs_sum(num_rows, 0);
+  std::vector<double> col_payoffs_sum(num_cols, 0);
+  int num_summed = 0;
+  double restart_gap = best_gap;
+
+  std::vector<double> next_col_payoffs(num_cols);
+  std::vector<double> sorted;
+  for (int iteration = 0; iteration < max_iterations; ++iteration) {
+    // The row player ascends, then the column player descends against the
+    // extrapolation of the row player's step.
+    for (int row = 0; row < num_rows; ++row) {
+      x[row] += step * row_payoffs[row];
+    }
+    ProjectOntoSimplex(&x, &sorted);
+    compute_col_payoffs(x, &next_col_payoffs);
+    for (int col = 0; col < num_cols; ++col) {
+      y[col] -= step * (2 * next_col_payoffs[col] - col_payoffs[col]);
+    }
+    ProjectOntoSimplex(&y, &sorted);
+    col_payoffs.swap(next_col_payoffs);
+    compute_row_payoffs(y, &row_payoffs);
+
+    for (int row = 0; row < num_rows; ++row) {
+      x_sum[row] += x[row];
+      row_payoffs_sum[row] += row_payoffs[row];
+    }
+    for (int col = 0; col < num_cols; ++col) {
+      y_sum[col] += y[col];
+      col_payoffs_sum[col] += col_payoffs[col];
+    }
+    ++num_summed;
+
+    const double gap = DualityGap(row_payoffs, col_payoffs, 1);
+    const double average_gap =
+        DualityGap(row_payoffs_sum, col_payoffs_sum, num_summed);
+    if (gap < best_gap) {
+      best_gap = gap;
+      best = {x, y};
+    }
+    if (average_gap < best_gap) {
+      best_gap = average_gap;
+      best = {x_sum, y_sum};
+      for (double& p : best.row_strategy) p /= num_summed;
+      for (double& p : best.col_strategy) p /= num_summed;
+    }
+    if (best_gap <= epsilon) break;
+
+    if (std::min(gap, average_gap) <= kRestartFactor * restart_gap) {
+      if (average_gap < gap) {
+        for (int row = 0; row < num_rows; ++row) {
+          x[row] = x_sum[row] / num_summed;
+          row_payoffs[row] = row_payoffs_sum[row] / num_summed;
+        }
+        for (int col = 0; col < num_cols; ++col) {
+          y[col] = y_sum[col] / num_summed;
+          col_payoffs[col] = col_payoffs_sum[col] / num_summed;
+        }
+      }
+      restart_gap = std::min(gap, average_gap);
+      std::fill(x_sum.begin(), x_sum.end(), 0);
+      std::fill(y_sum.begin(), y_sum.end(), 0);
+      std::fill(row_payoffs_sum.begin(), row_payoffs_sum.end(), 0);
+      std::fill(col_payoffs_sum.begin(), col_payoffs_sum.end(), 0);
+      num_summed = 0;
+    }
+  }
+  return best;
+}
+
+}  // namespace algorithms
+}  // namespace open_spiel
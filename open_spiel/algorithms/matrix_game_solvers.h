@@ -0,0 +1,112 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_ALGORITHMS_MATRIX_GAME_SOLVERS_H_
+#define OPEN_SPIEL_ALGORITHMS_MATRIX_GAME_SOLVERS_H_
+
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/types/span.h"
+#include "open_spiel/matrix_game.h"
+#include "open_spiel/spiel.h"
+
+// Solvers for large matrix games, such as those made by ExtensiveToMatrixGame,
+// with thousands of strategies per player. They work on the utility matrices
+// of the game directly, with kernels written for the compiler to vectorize:
+// unit-stride inner loops, several independent accumulators, and the columns
+// processed in blocks which stay in the L1 cache. Strategies are vectors of
+// probabilities over the rows or the columns.
+
+namespace open_spiel {
+namespace algorithms {
+
+// The payoff to the player of each of their actions against a mixed strategy
+// of the other player: the product of the player's utility matrix with the
+// strategy, on the right for the row player and on the left for the column
+// player. Large products are shared out between num_threads threads, each
+// computing a range of the payoffs, so the results do not depend on the
+// number of threads.
+std::vector<double> ActionPayoffs(const matrix_game::MatrixGame& game,
+                                  Player player,
+                                  absl::Span<const double> opponent_strategy,
+                                  int num_threads = 1);
+void ActionPayoffs(const matrix_game::MatrixGame& game, Player player,
+                   absl::Span<const double> opponent_strategy,
+                   absl::Span<double> payoffs, int num_threads = 1);
+
+// The expected payoffs of the two players under a strategy profile.
+std::vector<double> ExpectedPayoffs(const matrix_game::MatrixGame& game,
+                                    absl::Span<const double> row_strategy,
+                                    absl::Span<const double> col_strategy);
+
+// The sum over the players of what they would gain by best responding to the
+// other's strategy; 0 at a Nash equilibrium.
+double MatrixGameNashConv(const matrix_game::MatrixGame& game,
+                          absl::Span<const double> row_strategy,
+                          absl::Span<const double> col_strategy);
+
+// One step of regret matching for a player whose actions had these payoffs
+// under this strategy: adds the regrets of the actions to cumulative_regrets,
+// flooring them at 0 for regret matching+, and writes the next strategy, which
+// is proportional to the positive regrets, or uniform if there are none.
+void RegretMatchingUpdate(absl::Span<const double> payoffs,
+                          absl::Span<const double> strategy,
+                          bool regret_matching_plus,
+                          absl::Span<double> cumulative_regrets,
+                          absl::Span<double> next_strategy);
+
+// The strategies found by a solver.
+struct MatrixGameSolution {
+  std::vector<double> row_strategy;
+  std::vector<double> col_strategy;
+};
+
+// Self-play with regret matching, the players updating simultaneously. The
+// average strategies converge to a Nash equilibrium in two-player zero-sum
+// games, and to a coarse correlated equilibrium in general. With regret
+// matching+, the average weighs iteration t by t, which converges faster.
+// Each iteration is two products of a utility matrix with a vector.
+MatrixGameSolution SolveWithRegretMatching(const matrix_game::MatrixGame& game,
+                                           int num_iterations,
+                                           bool regret_matching_plus = true);
+
+// Fictitious play: at each iteration, both players best respond to the
+// other's average strategy so far. Only the payoffs against the averages are
+// kept, updated with a row of each utility matrix (the row player's is
+// transposed once, in blocks, at the start), so an iteration is linear in the
+// number of strategies rather than in the size of the matrix.
+MatrixGameSolution SolveWithFictitiousPlay(const matrix_game::MatrixGame& game,
+                                           int num_iterations);
+
+// Solves the zero-sum game given by the row player's utilities A, in which
+// the row player maximizes x^T A y and the column player minimizes it; the
+// column player's utilities are ignored. Returns strategies whose duality gap,
+// max_r (A y)_r - min_c (x^T A)_c, is at most epsilon, or the best found in
+// max_iterations iterations.
+//
+// This is the primal-dual hybrid gradient method (Chambolle and Pock, 2011),
+// with projections onto the simplices, and restarts from the current or the
+// average iterate whenever its gap has shrunk enough, which makes it converge
+// linearly (Applegate et al., Faster First-Order Primal-Dual Methods for Linear
+// Programming using Restarts and Sharpness, 2021). An iteration is two
+// products of A with a vector, shared out between num_threads threads.
+MatrixGameSolution SolveZeroSumMatrixGame(const matrix_game::MatrixGame& game,
+                                          double epsilon = 1e-6,
+                                          int max_iterations = 100000,
+                                          int num_threads = 1);
+
+}  // namespace algorithms
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_ALGORITHMS_MATRIX_GAME_SOLVERS_H_
@@ -0,0 +1,172 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/matrix_game_solvers.h"
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "open_spiel/algorithms/matrix_game_utils.h"
+#include "open_spiel/matrix_game.h"
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace algorithms {
+namespace {
+
+using matrix_game::MatrixGame;
+
+std::vector<double> RandomVector(int size, std::mt19937* rng) {
+  std::uniform_real_distribution<double> dist(-1, 1);
+  std::vector<double> values(size);
+  for (double& value : values) value = dist(*rng);
+  return values;
+}
+
+// The kernels agree with the plain sums, across several column blocks and
+// with rows left over from the blocks of four.
+void ActionPayoffsTest() {
+  std::mt19937 rng(0);
+  const int num_rows = 7;
+  const int num_cols = 4500;
+  std::vector<std::vector<double>> row_utilities(num_rows);
+  std::vector<std::vector<double>> col_utilities(num_rows);
+  for (int row = 0; row < num_rows; ++row) {
+    row_utilities[row] = RandomVector(num_cols, &rng);
+    col_utilities[row] = RandomVector(num_cols, &rng);
+  }
+  std::shared_ptr<const MatrixGame> game =
+      matrix_game::CreateMatrixGame(row_utilities, col_utilities);
+  std::vector<double> row_strategy = RandomVector(num_rows, &rng);
+  row_strategy[3] = 0;
+  const std::vector<double> col_strategy = RandomVector(num_cols, &rng);
+
+  const std::vector<double> row_payoffs =
+      ActionPayoffs(*game, matrix_game::kRowPlayer, col_strategy);
+  const std::vector<double> col_payoffs =
+      ActionPayoffs(*game, matrix_game::kColPlayer, row_strategy);
+  double row_value = 0;
+  for (int row = 0; row < num_rows; ++row) {
+    double payoff = 0;
+    for (int col = 0; col < num_cols; ++col) {
+      payoff += game->RowUtility(row, col) * col_strategy[col];
+    }
+    SPIEL_CHECK_FLOAT_NEAR(row_payoffs[row], payoff, 1e-9);
+    row_value += row_strategy[row] * payoff;
+  }
+  double col_value = 0;
+  for (int col = 0; col < num_cols; ++col) {
+    double payoff = 0;
+    for (int row = 0; row < num_rows; ++row) {
+      payoff += row_strategy[row] * game->ColUtility(row, col);
+    }
+    SPIEL_CHECK_FLOAT_NEAR(col_payoffs[col], payoff, 1e-9);
+    col_value += col_strategy[col] * payoff;
+  }
+  const std::vector<double> values =
+      ExpectedPayoffs(*game, row_strategy, col_strategy);
+  SPIEL_CHECK_FLOAT_NEAR(values[0], row_value, 1e-9);
+  SPIEL_CHECK_FLOAT_NEAR(values[1], col_value, 1e-9);
+}
+
+void RegretMatchingUpdateTest() {
+  std::vector<double> regrets = {0, 0, 0};
+  std::vector<double> strategy(3);
+  // The value is 1, so the regrets are 2, -1 and -1.
+  RegretMatchingUpdate({3, 0, 0}, {1.0 / 3, 1.0 / 3, 1.0 / 3},
+                       /*regret_matching_plus=*/false,
+                       absl::MakeSpan(regrets), absl::MakeSpan(strategy));
+  SPIEL_CHECK_EQ(regrets, std::vector<double>({2, -1, -1}));
+  SPIEL_CHECK_EQ(strategy, std::vector<double>({1, 0, 0}));
+  RegretMatchingUpdate({0, 0, 4}, {1, 0, 0}, /*regret_matching_plus=*/true,
+                       absl::MakeSpan(regrets), absl::MakeSpan(strategy));
+  SPIEL_CHECK_EQ(regrets, std::vector<double>({2, 0, 3}));
+  SPIEL_CHECK_EQ(strategy, std::vector<double>({0.4, 0, 0.6}));
+}
+
+void SolversTest() {
+  std::shared_ptr<const MatrixGame> rps = LoadMatrixGame("matrix_rps");
+  for (bool regret_matching_plus : {false, true}) {
+    MatrixGameSolution solution =
+        SolveWithRegretMatching(*rps, 1000, regret_matching_plus);
+    SPIEL_CHECK_LT(MatrixGameNashConv(*rps, solution.row_strategy,
+                                      solution.col_strategy),
+                   0.05);
+  }
+  MatrixGameSolution solution = SolveWithFictitiousPlay(*rps, 10000);
+  SPIEL_CHECK_LT(
+      MatrixGameNashConv(*rps, solution.row_strategy, solution.col_strategy),
+      0.05);
+
+  // Kuhn poker is worth -1/18 to the first player.
+  std::shared_ptr<const MatrixGame> kuhn =
+      ExtensiveToMatrixGame(*LoadGame("kuhn_poker"));
+  solution = SolveWithRegretMatching(*kuhn, 2000);
+  SPIEL_CHECK_LT(
+      MatrixGameNashConv(*kuhn, solution.row_strategy, solution.col_strategy),
+      0.01);
+  const std::vector<double> values =
+      ExpectedPayoffs(*kuhn, solution.row_strategy, solution.col_strategy);
+  SPIEL_CHECK_FLOAT_NEAR(values[0], -1.0 / 18, 0.01);
+  SPIEL_CHECK_FLOAT_NEAR(values[1], 1.0 / 18, 0.01);
+}
+
+void ZeroSumSolverTest() {
+  // Kuhn poker is worth -1/18 to the first player.
+  std::shared_ptr<const MatrixGame> kuhn =
+      ExtensiveToMatrixGame(*LoadGame("kuhn_poker"));
+  MatrixGameSolution solution = SolveZeroSumMatrixGame(*kuhn, 1e-8);
+  SPIEL_CHECK_LT(
+      MatrixGameNashConv(*kuhn, solution.row_strategy, solution.col_strategy),
+      1e-8);
+  SPIEL_CHECK_FLOAT_NEAR(
+      ExpectedPayoffs(*kuhn, solution.row_strategy, solution.col_strategy)[0],
+      -1.0 / 18, 1e-8);
+
+  // A random game, large enough to be shared out between threads, which give
+  // the same strategies.
+  std::mt19937 rng(0);
+  const int num_rows = 300;
+  const int num_cols = 500;
+  std::vector<std::vector<double>> row_utilities(num_rows);
+  std::vector<std::vector<double>> col_utilities(num_rows);
+  for (int row = 0; row < num_rows; ++row) {
+    row_utilities[row] = RandomVector(num_cols, &rng);
+    for (double utility : row_utilities[row]) {
+      col_utilities[row].push_back(-utility);
+    }
+  }
+  std::shared_ptr<const MatrixGame> game =
+      matrix_game::CreateMatrixGame(row_utilities, col_utilities);
+  solution = SolveZeroSumMatrixGame(*game, 1e-6);
+  SPIEL_CHECK_LT(
+      MatrixGameNashConv(*game, solution.row_strategy, solution.col_strategy),
+      1e-6);
+  MatrixGameSolution threaded_solution =
+      SolveZeroSumMatrixGame(*game, 1e-6, 100000, /*num_threads=*/4);
+  SPIEL_CHECK_EQ(threaded_solution.row_strategy, solution.row_strategy);
+  SPIEL_CHECK_EQ(threaded_solution.col_strategy, solution.col_strategy);
+}
+
+}  // namespace
+}  // namespace algorithms
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  open_spiel::algorithms::ActionPayoffsTest();
+  open_spiel::algorithms::RegretMatchingUpdateTest();
+  open_spiel::algorithms::SolversTest();
+  open_spiel::algorithms::ZeroSumSolverTest();
+}
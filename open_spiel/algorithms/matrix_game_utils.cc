@@ -17,7 +17,7 @@
 #include <memory>
 
 #include "open_spiel/algorithms/deterministic_policy.h"
-#include "open_spiel/algorithms/expected_returns.h"
+#include "open_spiel/algorithms/normal_form_payoffs.h"
 #include "open_spiel/simultaneous_move_game.h"
 #include "open_spiel/spiel.h"
 
@@ -91,40 +91,45 @@ std::shared_ptr<const MatrixGame> AsMatrixGame(const NormalFormGame* game) {
       new MatrixGame(type, {}, row_names, col_names, row_utils, col_utils));
 }
 
-std::shared_ptr<const MatrixGame> ExtensiveToMatrixGame(const Game& game) {
+std::shared_ptr<const MatrixGame> ExtensiveToMatrixGame(const Game& game,
+                                                        int num_threads) {
   SPIEL_CHECK_EQ(game.NumPlayers(), 2);
 
   std::vector<std::string> row_names;
   std::vector<std::string> col_names;
-  std::vector<std::vector<double>> row_player_utils;
-  std::vector<std::vector<double>> col_player_utils;
+  std::vector<std::vector<double>> utils;
 
   GameType type = game.GetType();
 
-  std::vector<DeterministicTabularPolicy> policies = {
-      DeterministicTabularPolicy(game, 0), DeterministicTabularPolicy(game, 1)};
-
-  bool first_row = true;
-  do {
-    policies[1].ResetDefaultPolicy();
-    row_names.push_back(policies[0].ToString(" --- "));
-    std::vector<double> row_utils;
-    std::vector<double> col_utils;
-    do {
-      if (first_row) {
-        col_names.push_back(policies[1].ToString(" --- "));
-      }
-      std::unique_ptr<State> state = game.NewInitialState();
-      std::vector<double> returns =
-          ExpectedReturns(*state, {&policies[0], &policies[1]}, -1);
-      row_utils.push_back(returns[0]);
-      col_utils.push_back(returns[1]);
-    } while (policies[1].NextPolicy());
-    first_row = false;
-    row_player_utils.push_back(row_utils);
-    col_player_utils.push_back(col_utils);
-  } while (policies[0].NextPolicy());
+  if (type.dynamics == GameType::Dynamics::kSequential) {
+    NormalFormPayoffs payoffs(game);
+    row_names = payoffs.PolicyNames(0);
+    col_names = payoffs.PolicyNames(1);
+    utils = payoffs.Utilities(num_threads);
+  } else {
+    // Simultaneous-move games evaluate each profile separately.
+    const std::vector<std::shared_ptr<const IndexedDeterministicPolicies>>
+        policies = {
+            std::make_shared<const IndexedDeterministicPolicies>(game, 0),
+            std::make_shared<const IndexedDeterministicPolicies>(game, 1)};
+    for (int64_t policy = 0; policy < policies[0]->NumPolicies(); ++policy) {
+      row_names.push_back(policies[0]->PolicyToString(policy, " --- "));
+    }
+    for (int64_t policy = 0; policy < policies[1]->NumPolicies(); ++policy) {
+      col_names.push_back(policies[1]->PolicyToString(policy, " --- "));
+    }
+    utils = ProfileReturns(game, policies, num_threads);
+  }
 
+  std::vector<std::vector<double>> row_player_utils;
+  std::vector<std::vector<double>> col_player_utils;
+  const int num_cols = col_names.size();
+  for (int row = 0; row < row_names.size(); ++row) {
+    row_player_utils.emplace_back(utils[0].begin() + row * num_cols,
+                                  utils[0].begin() + (row + 1) * num_cols);
+    col_player_utils.emplace_back(utils[1].begin() + row * num_cols,
+                                  utils[1].begin() + (row + 1) * num_cols);
+  }
   return matrix_game::CreateMatrixGame(type.short_name, type.long_name,
                                        row_names, col_names, row_player_utils,
                                        col_player_utils);
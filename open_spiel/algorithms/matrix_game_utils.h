@@ -51,8 +51,13 @@ std::shared_ptr<const matrix_game::MatrixGame> AsMatrixGame(const Game* game);
 //
 // Hence, this method should only be used for  small games! For example, Kuhn
 // poker has 64 deterministic policies, resulting in a 64-by-64 matrix.
+//
+// Sequential games are converted with a single traversal of the game tree
+// (see normal_form_payoffs.h), with the rows shared out between num_threads
+// threads; simultaneous-move games evaluate each profile with its own
+// traversal, the profiles being shared out likewise.
 std::shared_ptr<const matrix_game::MatrixGame> ExtensiveToMatrixGame(
-    const Game& game);
+    const Game& game, int num_threads = 1);
 
 }  // namespace algorithms
 }  // namespace open_spiel
@@ -20,6 +20,8 @@ namespace open_spiel {
 namespace algorithms {
 namespace {
 
+using matrix_game::MatrixGame;
+
 void ConvertToMatrixGameTest() {
   std::shared_ptr<const Game> blotto = LoadGame("blotto");
   std::shared_ptr<const matrix_game::MatrixGame> matrix_blotto =
@@ -46,6 +48,31 @@ void ExtensiveToMatrixGameTest() {
   SPIEL_CHECK_EQ(kuhn_matrix_game->NumCols(), 64);
 }
 
+// Simultaneous-move games evaluate each profile, the same way whatever the
+// number of threads.
+void SimultaneousExtensiveToMatrixGameTest() {
+  std::shared_ptr<const MatrixGame> rps = LoadMatrixGame("matrix_rps");
+  std::shared_ptr<const MatrixGame> converted_rps =
+      ExtensiveToMatrixGame(*rps, /*num_threads=*/2);
+  SPIEL_CHECK_EQ(converted_rps->NumRows(), 3);
+  SPIEL_CHECK_EQ(converted_rps->NumCols(), 3);
+  for (int row = 0; row < 3; ++row) {
+    for (int col = 0; col < 3; ++col) {
+      SPIEL_CHECK_EQ(converted_rps->RowUtility(row, col),
+                     rps->RowUtility(row, col));
+    }
+  }
+
+  std::shared_ptr<const Game> goofspiel =
+      LoadGame("goofspiel(num_cards=3,points_order=descending,imp_info=true)");
+  std::shared_ptr<const MatrixGame> serial = ExtensiveToMatrixGame(*goofspiel);
+  std::shared_ptr<const MatrixGame> threaded =
+      ExtensiveToMatrixGame(*goofspiel, /*num_threads=*/4);
+  SPIEL_CHECK_EQ(serial->NumRows(), 384);
+  SPIEL_CHECK_EQ(serial->RowUtilities(), threaded->RowUtilities());
+  SPIEL_CHECK_EQ(serial->ColUtilities(), threaded->ColUtilities());
+}
+
 }  // namespace
 }  // namespace algorithms
 }  // namespace open_spiel
@@ -53,4 +80,5 @@ void ExtensiveToMatrixGameTest() {
 int main(int argc, char** argv) {
   open_spiel::algorithms::ConvertToMatrixGameTest();
   open_spiel::algorithms::ExtensiveToMatrixGameTest();
+  open_spiel::algorithms::SimultaneousExtensiveToMatrixGameTest();
 }
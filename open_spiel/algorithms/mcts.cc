@@ -15,20 +15,29 @@
 #include "open_spiel/algorithms/mcts.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <limits>
 #include <memory>
+#include <new>
+#include <optional>
 #include <random>
+#include <utility>
 #include <vector>
 
 #include "open_spiel/abseil-cpp/absl/algorithm/container.h"
+#include "open_spiel/abseil-cpp/absl/container/flat_hash_map.h"
 #include "open_spiel/abseil-cpp/absl/random/distributions.h"
 #include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
 #include "open_spiel/abseil-cpp/absl/strings/str_format.h"
+#include "open_spiel/abseil-cpp/absl/synchronization/mutex.h"
 #include "open_spiel/abseil-cpp/absl/time/clock.h"
 #include "open_spiel/abseil-cpp/absl/time/time.h"
+#include "open_spiel/algorithms/opening_book.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/thread.h"
+#include "open_spiel/utils/trace.h"
 
 namespace open_spiel {
 namespace algorithms {
@@ -39,31 +48,355 @@ int MemoryUsedMb(int nodes) {
   return nodes * sizeof(SearchNode) / (1 << 20);
 }
 
-std::vector<double> RandomRolloutEvaluator::Evaluate(const State& state) {
-  std::vector<double> result;
-  for (int i = 0; i < n_rollouts_; ++i) {
-    std::unique_ptr<State> working_state = state.Clone();
-    while (!working_state->IsTerminal()) {
-      if (working_state->IsChanceNode()) {
-        ActionsAndProbs outcomes = working_state->ChanceOutcomes();
-        working_state->ApplyAction(SampleAction(outcomes, rng_).first);
-      } else {
-        std::vector<Action> actions = working_state->LegalActions();
-        working_state->ApplyAction(
-            actions[absl::Uniform(rng_, 0u, actions.size())]);
-      }
+void* SearchNodeArena::Allocate(std::size_t bytes) {
+  constexpr std::size_t kAlignment = alignof(std::max_align_t);
+  bytes = (bytes + kAlignment - 1) / kAlignment * kAlignment;
+  if (bytes > remaining_bytes_) {
+    const std::size_t block_bytes = std::max(bytes, kBlockBytes);
+    blocks_.emplace_back(new char[block_bytes]);
+    next_ = blocks_.back().get();
+    remaining_bytes_ = block_bytes;
+    reserved_bytes_ += block_bytes;
+  }
+  void* ptr = next_;
+  next_ += bytes;
+  remaining_bytes_ -= bytes;
+  return ptr;
+}
+
+SearchNodeChildren::SearchNodeChildren(const SearchNodeChildren& other)
+    : SearchNodeChildren() {
+  *this = other;
+}
+
+SearchNodeChildren::SearchNodeChildren(SearchNodeChildren&& other) noexcept
+    : SearchNodeChildren() {
+  *this = std::move(other);
+}
+
+SearchNodeChildren& SearchNodeChildren::operator=(
+    const SearchNodeChildren& other) {
+  if (this != &other) {
+    clear();
+    Allocate(other.partial_ ? other.capacity_ : other.size_,
+             other.num_widening_actions(), nullptr);
+    if (widening_) {
+      std::copy(other.widening_actions(),
+                other.widening_actions() + other.num_widening_actions() + 1,
+                widening_actions());
     }
+    for (const SearchNode& child : other) push_back(child);
+    partial_ = other.partial_;
+  }
+  return *this;
+}
+
+SearchNodeChildren& SearchNodeChildren::operator=(
+    SearchNodeChildren&& other) noexcept {
+  if (this != &other) {
+    clear();
+    data_ = other.data_;
+    size_ = other.size_;
+    capacity_ = other.capacity_;
+    in_arena_ = other.in_arena_;
+    partial_ = other.partial_;
+    widening_ = other.widening_;
+    other.data_ = nullptr;
+    other.size_ = 0;
+    other.capacity_ = 0;
+    other.in_arena_ = false;
+    other.partial_ = false;
+    other.widening_ = false;
+  }
+  return *this;
+}
 
-    std::vector<double> returns = working_state->Returns();
-    if (result.empty()) {
-      result.swap(returns);
+void SearchNodeChildren::Allocate(uint32_t capacity, int num_actions,
+                                  SearchNodeArena* arena) {
+  std::size_t bytes = capacity * sizeof(SearchNode);
+  if (num_actions > 0) bytes += (num_actions + 1) * sizeof(WideningAction);
+  if (bytes == 0) return;
+  data_ = static_cast<SearchNode*>(arena != nullptr ? arena->Allocate(bytes)
+                                                    : ::operator new(bytes));
+  capacity_ = capacity;
+  in_arena_ = arena != nullptr;
+  widening_ = num_actions > 0;
+}
+
+void SearchNodeChildren::reserve(int capacity, SearchNodeArena* arena) {
+  SPIEL_CHECK_TRUE(data_ == nullptr);
+  Allocate(capacity, 0, arena);
+}
+
+void SearchNodeChildren::reserve_widening(const ActionsAndProbs& actions,
+                                          int capacity,
+                                          SearchNodeArena* arena) {
+  SPIEL_CHECK_TRUE(data_ == nullptr);
+  SPIEL_CHECK_FALSE(actions.empty());
+  SPIEL_CHECK_LE(capacity, actions.size());
+  Allocate(capacity, actions.size(), arena);
+  WideningAction* kept = widening_actions();
+  kept[0] = {static_cast<int32_t>(actions.size()), 0};
+  for (int i = 0; i < actions.size(); ++i) {
+    kept[i + 1] = {static_cast<int32_t>(actions[i].first),
+                   static_cast<float>(actions[i].second)};
+  }
+  partial_ = true;
+}
+
+SearchNode* SearchNodeChildren::widen(Player player) {
+  SPIEL_CHECK_TRUE(widening_);
+  const int num_actions = num_widening_actions();
+  SPIEL_CHECK_LT(size_, num_actions);
+  if (size_ == capacity_) {
+    reallocate(std::min<int>(std::max<uint32_t>(2 * capacity_, 2),
+                             num_actions));
+  }
+  const WideningAction& next = widening_actions()[size_ + 1];
+  new (data_ + size_) SearchNode(next.action, player, next.prior);
+  ++size_;
+  partial_ = size_ < num_actions;
+  return data_ + size_ - 1;
+}
+
+SearchNodeChildren::WideningAction* SearchNodeChildren::widening_actions()
+    const {
+  return reinterpret_cast<WideningAction*>(data_ + capacity_);
+}
+
+int SearchNodeChildren::num_widening_actions() const {
+  return widening_ ? widening_actions()[0].action : 0;
+}
+
+int SearchNodeChildren::allocated_nodes() const {
+  if (!widening_) return capacity_;
+  const int action_bytes =
+      (num_widening_actions() + 1) * sizeof(WideningAction);
+  return capacity_ + (action_bytes + sizeof(SearchNode) - 1) /
+                         sizeof(SearchNode);
+}
+
+void SearchNodeChildren::push_back(const SearchNode& node) {
+  SPIEL_CHECK_LT(size_, capacity_);
+  new (data_ + size_) SearchNode(node);
+  ++size_;
+}
+
+void SearchNodeChildren::push_back(SearchNode&& node) {
+  SPIEL_CHECK_LT(size_, capacity_);
+  new (data_ + size_) SearchNode(std::move(node));
+  ++size_;
+}
+
+SearchNode* SearchNodeChildren::insert(int i, SearchNode&& node) {
+  SPIEL_CHECK_GE(i, 0);
+  SPIEL_CHECK_LE(i, size_);
+  if (size_ == capacity_) reallocate(std::max<uint32_t>(2 * capacity_, 2));
+  if (i == size_) {
+    new (data_ + size_) SearchNode(std::move(node));
+  } else {
+    new (data_ + size_) SearchNode(std::move(data_[size_ - 1]));
+    std::move_backward(data_ + i, data_ + size_ - 1, data_ + size_);
+    data_[i] = std::move(node);
+  }
+  ++size_;
+  return data_ + i;
+}
+
+void SearchNodeChildren::reallocate(int capacity, SearchNodeArena* arena) {
+  SPIEL_CHECK_GE(capacity, size_);
+  SearchNodeChildren old = std::move(*this);
+  Allocate(capacity, old.num_widening_actions(), arena);
+  if (widening_) {
+    std::copy(old.widening_actions(),
+              old.widening_actions() + old.num_widening_actions() + 1,
+              widening_actions());
+  }
+  for (SearchNode& child : old) push_back(std::move(child));
+  partial_ = old.partial_;
+}
+
+void SearchNodeChildren::clear() {
+  for (SearchNode& child : *this) child.~SearchNode();
+  if (!in_arena_) ::operator delete(data_);
+  data_ = nullptr;
+  size_ = 0;
+  capacity_ = 0;
+  in_arena_ = false;
+  partial_ = false;
+  widening_ = false;
+}
+
+SolvedOutcome& SolvedOutcome::operator=(const SolvedOutcome& other) {
+  if (this != &other) *this = other.ToVector();
+  return *this;
+}
+
+SolvedOutcome& SolvedOutcome::operator=(const std::vector<double>& outcome) {
+  if (outcome.empty()) {
+    values_.reset();
+    return *this;
+  }
+  if (size() != static_cast<int>(outcome.size())) {
+    values_ = std::make_unique<double[]>(outcome.size() + 1);
+    values_[0] = outcome.size();
+  }
+  std::copy(outcome.begin(), outcome.end(), values_.get() + 1);
+  return *this;
+}
+
+std::vector<double> SolvedOutcome::ToVector() const {
+  if (empty()) return {};
+  return std::vector<double>(values_.get() + 1, values_.get() + 1 + size());
+}
+
+bool SolvedOutcome::operator==(const SolvedOutcome& other) const {
+  return size() == other.size() &&
+         std::equal(values_.get() + 1, values_.get() + 1 + size(),
+                    other.values_.get() + 1);
+}
+
+std::vector<std::vector<double>> Evaluator::EvaluateBatch(
+    const std::vector<const State*>& states) {
+  std::vector<std::vector<double>> values;
+  values.reserve(states.size());
+  for (const State* state : states) values.push_back(Evaluate(*state));
+  return values;
+}
+
+std::vector<ActionsAndProbs> Evaluator::PriorBatch(
+    const std::vector<const State*>& states) {
+  std::vector<ActionsAndProbs> priors;
+  priors.reserve(states.size());
+  for (const State* state : states) priors.push_back(Prior(*state));
+  return priors;
+}
+
+std::vector<double> Evaluator::EvaluateWithPrior(const State& state,
+                                                 ActionsAndProbs* prior) {
+  *prior = Prior(state);
+  return Evaluate(state);
+}
+
+std::vector<std::vector<double>> Evaluator::EvaluateWithPriorBatch(
+    const std::vector<const State*>& states,
+    std::vector<ActionsAndProbs>* priors) {
+  *priors = PriorBatch(states);
+  return EvaluateBatch(states);
+}
+
+RandomRolloutEvaluator::RandomRolloutEvaluator(int n_rollouts, int seed,
+                                               int num_threads)
+    : n_rollouts_(n_rollouts), seed_(seed), jobs_(num_threads) {
+  for (int i = 1; i < num_threads; ++i) {
+    rollout_threads_.emplace_back([this]() {
+      while (std::optional<std::shared_ptr<RolloutJob>> job = jobs_.Pop()) {
+        RunRollouts(job->get());
+      }
+    });
+  }
+}
+
+RandomRolloutEvaluator::~RandomRolloutEvaluator() {
+  jobs_.BlockNewValues();
+  for (Thread& thread : rollout_threads_) thread.join();
+}
+
+std::unique_ptr<RandomRolloutEvaluator::Worker>
+RandomRolloutEvaluator::AcquireWorker() {
+  absl::MutexLock lock(&m_);
+  if (idle_workers_.empty()) {
+    return std::make_unique<Worker>(seed_, num_workers_++);
+  }
+  std::unique_ptr<Worker> worker = std::move(idle_workers_.back());
+  idle_workers_.pop_back();
+  return worker;
+}
+
+void RandomRolloutEvaluator::ReleaseWorker(std::unique_ptr<Worker> worker) {
+  absl::MutexLock lock(&m_);
+  idle_workers_.push_back(std::move(worker));
+}
+
+void RandomRolloutEvaluator::Rollout(const State& state, Worker* worker,
+                                     std::vector<double>* total_returns) {
+  std::vector<Action>& legal_actions = worker->legal_actions;
+  CopyOrCloneState(state, &worker->working_state);
+  State* working_state = worker->working_state.get();
+  while (!working_state->IsTerminal()) {
+    if (working_state->IsChanceNode()) {
+      working_state->ApplyAction(
+          working_state->SampleChanceOutcome(worker->rng).first);
     } else {
-      SPIEL_CHECK_EQ(returns.size(), result.size());
-      for (int i = 0; i < result.size(); ++i) {
-        result[i] += returns[i];
+      Action action = working_state->SampleRandomLegalAction(worker->rng);
+      if (action == kInvalidAction) {
+        working_state->LegalActions(&legal_actions);
+        action = legal_actions[absl::Uniform(worker->rng, 0u,
+                                             legal_actions.size())];
       }
+      working_state->ApplyAction(action);
+    }
+  }
+
+  std::vector<double> returns = working_state->Returns();
+  if (total_returns->empty()) {
+    total_returns->swap(returns);
+  } else {
+    SPIEL_CHECK_EQ(returns.size(), total_returns->size());
+    for (int i = 0; i < total_returns->size(); ++i) {
+      (*total_returns)[i] += returns[i];
     }
   }
+}
+
+void RandomRolloutEvaluator::RunRollouts(RolloutJob* job) {
+  std::unique_ptr<Worker> worker;
+  std::vector<double> total_returns;
+  int rollouts_done = 0;
+  // The state stays valid until all the claimed rollouts are done.
+  while (job->next_rollout.fetch_add(1) < job->n_rollouts) {
+    if (worker == nullptr) worker = AcquireWorker();
+    Rollout(*job->state, worker.get(), &total_returns);
+    ++rollouts_done;
+  }
+  if (worker == nullptr) return;
+  ReleaseWorker(std::move(worker));
+
+  absl::MutexLock lock(&job->m);
+  if (job->total_returns.empty()) {
+    job->total_returns.swap(total_returns);
+  } else {
+    for (int i = 0; i < total_returns.size(); ++i) {
+      job->total_returns[i] += total_returns[i];
+    }
+  }
+  job->rollouts_done += rollouts_done;
+}
+
+std::vector<double> RandomRolloutEvaluator::Evaluate(const State& state) {
+  std::vector<double> result;
+  if (rollout_threads_.empty() || n_rollouts_ == 1) {
+    std::unique_ptr<Worker> worker = AcquireWorker();
+    for (int i = 0; i < n_rollouts_; ++i) {
+      Rollout(state, worker.get(), &result);
+    }
+    ReleaseWorker(std::move(worker));
+  } else {
+    auto job = std::make_shared<RolloutJob>(&state, n_rollouts_);
+    // Only as many threads as there are rollouts to share are asked to help,
+    // and none if they are all busy with other calls.
+    for (int i = 0; i < rollout_threads_.size() && i < n_rollouts_ - 1; ++i) {
+      if (!jobs_.Push(job, absl::ZeroDuration())) break;
+    }
+    RunRollouts(job.get());
+    absl::MutexLock lock(&job->m);
+    job->m.Await(absl::Condition(
+        +[](RolloutJob* rollout_job) {
+          return rollout_job->rollouts_done == rollout_job->n_rollouts;
+        },
+        job.get()));
+    result.swap(job->total_returns);
+  }
   for (int i = 0; i < result.size(); ++i) {
     result[i] /= n_rollouts_;
   }
@@ -75,39 +408,108 @@ ActionsAndProbs RandomRolloutEvaluator::Prior(const State& state) {
   if (state.IsChanceNode()) {
     return state.ChanceOutcomes();
   } else {
-    std::vector<Action> legal_actions = state.LegalActions();
+    std::unique_ptr<Worker> worker = AcquireWorker();
+    std::vector<Action>& legal_actions = worker->legal_actions;
+    state.LegalActions(&legal_actions);
     ActionsAndProbs prior;
     prior.reserve(legal_actions.size());
     for (const Action& action : legal_actions) {
       prior.emplace_back(action, 1.0 / legal_actions.size());
     }
+    ReleaseWorker(std::move(worker));
     return prior;
   }
 }
 
 // UCT value of given child
-double SearchNode::UCTValue(int parent_explore_count, double uct_c) const {
+double SearchNode::UCTValue(int parent_explore_count, double uct_c,
+                            double virtual_loss_reward) const {
   if (!outcome.empty()) {
     return outcome[player];
   }
 
-  if (explore_count == 0) return std::numeric_limits<double>::infinity();
+  const int pending = virtual_loss;
+  const int count = explore_count + pending;
+  if (count == 0) return std::numeric_limits<double>::infinity();
 
   // The "greedy-value" of choosing a given child is always with respect to
   // the current player for this node.
-  return total_reward / explore_count +
-         uct_c * std::sqrt(std::log(parent_explore_count) / explore_count);
+  return (total_reward + pending * virtual_loss_reward) / count +
+         uct_c * std::sqrt(std::log(parent_explore_count) / count);
 }
 
-double SearchNode::PUCTValue(int parent_explore_count, double uct_c) const {
+double SearchNode::PUCTValue(int parent_explore_count, double uct_c,
+                             double virtual_loss_reward) const {
   // Returns the PUCT value of this node.
   if (!outcome.empty()) {
     return outcome[player];
   }
 
-  return ((explore_count != 0 ? total_reward / explore_count : 0) +
-          uct_c * prior * std::sqrt(parent_explore_count) /
-              (explore_count + 1));
+  const int pending = virtual_loss;
+  const int count = explore_count + pending;
+  return ((count != 0 ? (total_reward + pending * virtual_loss_reward) / count
+                      : 0) +
+          uct_c * prior * std::sqrt(parent_explore_count) / (count + 1));
+}
+
+SearchNode* SelectChild(SearchNode* node, ChildSelectionPolicy policy,
+                        double uct_c, double virtual_loss_reward) {
+  const int parent_explore_count = node->explore_count + node->virtual_loss;
+  SearchNode* chosen_child = nullptr;
+  double max_value = -std::numeric_limits<double>::infinity();
+  // The loops follow UCTValue and PUCTValue, term for term, so that the
+  // values are the same to the last bit.
+  switch (policy) {
+    case ChildSelectionPolicy::UCT: {
+      const double log_parent = std::log(parent_explore_count);
+      for (SearchNode& child : node->children) {
+        double val;
+        if (!child.outcome.empty()) {
+          val = child.outcome[child.player];
+        } else {
+          const int pending =
+              child.virtual_loss.load(std::memory_order_relaxed);
+          const int count =
+              child.explore_count.load(std::memory_order_relaxed) + pending;
+          // Unvisited children come first.
+          if (count == 0) return &child;
+          val = (child.total_reward.load(std::memory_order_relaxed) +
+                 pending * virtual_loss_reward) / count +
+                uct_c * std::sqrt(log_parent / count);
+        }
+        if (val > max_value) {
+          max_value = val;
+          chosen_child = &child;
+        }
+      }
+      break;
+    }
+    case ChildSelectionPolicy::PUCT: {
+      const double sqrt_parent = std::sqrt(parent_explore_count);
+      for (SearchNode& child : node->children) {
+        double val;
+        if (!child.outcome.empty()) {
+          val = child.outcome[child.player];
+        } else {
+          const int pending =
+              child.virtual_loss.load(std::memory_order_relaxed);
+          const int count =
+              child.explore_count.load(std::memory_order_relaxed) + pending;
+          val = (count != 0
+                     ? (child.total_reward.load(std::memory_order_relaxed) +
+                        pending * virtual_loss_reward) / count
+                     : 0) +
+                uct_c * child.prior * sqrt_parent / (count + 1);
+        }
+        if (val > max_value) {
+          max_value = val;
+          chosen_child = &child;
+        }
+      }
+      break;
+    }
+  }
+  return chosen_child;
 }
 
 bool SearchNode::CompareFinal(const SearchNode& b) const {
@@ -166,7 +568,7 @@ std::string SearchNode::ToString(const State& state) const {
       (action != kInvalidAction ? state.ActionToString(player, action)
                                 : "none"),
       player, prior, (explore_count ? total_reward / explore_count : 0.),
-      explore_count,
+      explore_count.load(),
       (outcome.empty()
            ? "none"
            : absl::StrFormat("%4.1f",
@@ -175,7 +577,7 @@ std::string SearchNode::ToString(const State& state) const {
 }
 
 std::vector<double> dirichlet_noise(int count, double alpha,
-                                    std::mt19937* rng) {
+                                    Philox* rng) {
   std::vector<double> noise;
   noise.reserve(count);
 
@@ -195,30 +597,74 @@ MCTSBot::MCTSBot(const Game& game, std::shared_ptr<Evaluator> evaluator,
                  double uct_c, int max_simulations, int64_t max_memory_mb,
                  bool solve, int seed, bool verbose,
                  ChildSelectionPolicy child_selection_policy,
-                 double dirichlet_alpha, double dirichlet_epsilon)
+                 double dirichlet_alpha, double dirichlet_epsilon,
+                 int num_threads, ParallelismPolicy parallelism_policy,
+                 bool reuse_tree, int leaf_batch_size,
+                 absl::Duration max_time)
     : uct_c_{uct_c},
       max_simulations_{max_simulations},
       max_nodes_((max_memory_mb << 20) / sizeof(SearchNode) + 1),
       nodes_(0),
-      gc_limit_(MIN_GC_LIMIT),
       verbose_(verbose),
       solve_(solve),
       max_utility_(game.MaxUtility()),
+      min_utility_(game.MinUtility()),
       dirichlet_alpha_(dirichlet_alpha),
       dirichlet_epsilon_(dirichlet_epsilon),
       rng_(seed),
       child_selection_policy_(child_selection_policy),
-      evaluator_(evaluator) {
+      evaluator_(evaluator),
+      num_threads_(num_threads),
+      parallelism_policy_(parallelism_policy),
+      reuse_tree_(reuse_tree),
+      leaf_batch_size_(leaf_batch_size),
+      max_time_(max_time) {
   GameType game_type = game.GetType();
   if (game_type.reward_model != GameType::RewardModel::kTerminal)
     SpielFatalError("Game must have terminal rewards.");
   if (game_type.dynamics != GameType::Dynamics::kSequential)
     SpielFatalError("Game must have sequential turns.");
+  SPIEL_CHECK_GE(num_threads, 1);
+  SPIEL_CHECK_GE(leaf_batch_size, 1);
 }
 
+MCTSBot::~MCTSBot() { StopPondering(); }
+
+void MCTSBot::Restart() {
+  StopPondering();
+  tree_.reset();
+  tree_history_.clear();
+}
+
+void MCTSBot::RestartAt(const State& state) { Restart(); }
+
 Action MCTSBot::Step(const State& state) {
+  return StepUntil(state, absl::InfiniteFuture());
+}
+
+Action MCTSBot::StepUntil(const State& state, absl::Time deadline) {
+  if (opening_book_ != nullptr) {
+    // Another position with the same hash may have other legal actions.
+    const int64_t id = opening_book_->Find(state);
+    if (id >= 0 && absl::c_linear_search(state.LegalActions(),
+                                         opening_book_->BestAction(id))) {
+      if (verbose_) {
+        std::cerr << "Book move: "
+                  << state.ActionToString(opening_book_->BestAction(id))
+                  << std::endl;
+      }
+      return opening_book_->BestAction(id);
+    }
+  }
   absl::Time start = absl::Now();
-  std::unique_ptr<SearchNode> root = MCTSearch(state);
+  std::unique_ptr<SearchNode> searched;
+  const SearchNode* root;
+  if (reuse_tree_) {
+    root = &ContinueMCTSearchUntil(state, deadline);
+  } else {
+    searched = MCTSearchUntil(state, deadline);
+    root = searched.get();
+  }
   SPIEL_CHECK_GT(root->children.size(), 0);
 
   const SearchNode& best = root->BestChild();
@@ -229,8 +675,8 @@ Action MCTSBot::Step(const State& state) {
         << absl::StrFormat(
                ("Finished %d sims in %.3f secs, %.1f sims/s, "
                 "tree size: %d nodes / %d mb."),
-               root->explore_count, seconds, (root->explore_count / seconds),
-               nodes_, MemoryUsedMb(nodes_))
+               root->explore_count.load(), seconds,
+               (root->explore_count / seconds), nodes_, MemoryUsedMb(nodes_))
         << std::endl;
     std::cerr << "Root:" << std::endl;
     std::cerr << root->ToString(state) << std::endl;
@@ -252,193 +698,890 @@ std::pair<ActionsAndProbs, Action> MCTSBot::StepWithPolicy(const State& state) {
   return {{{action, 1.}}, action};
 }
 
-std::unique_ptr<State> MCTSBot::ApplyTreePolicy(
-    SearchNode* root, const State& state,
-    std::vector<SearchNode*>* visit_path) {
+void MCTSBot::InformAction(const State& state, Player player_id,
+                           Action action) {
+  StopPondering();
+}
+
+void MCTSBot::StartPondering(const State& state) {
+  StopPondering();
+  if (!reuse_tree_ || state.IsTerminal()) return;
+  ponder_stop_ = std::make_unique<StopToken>();
+  // Shared, as the function run by the thread must be copyable.
+  std::shared_ptr<const State> ponder_state = state.Clone();
+  ponder_thread_ = std::make_unique<Thread>(
+      [this, state = std::move(ponder_state)]() {
+        tree_ = Search(*state, ReusableSubtree(*state), absl::InfiniteFuture(),
+                       std::numeric_limits<int>::max());
+        tree_history_ = state->FullHistory();
+      });
+}
+
+void MCTSBot::StopPondering() {
+  if (ponder_thread_ == nullptr) return;
+  ponder_stop_->Stop();
+  ponder_thread_->join();
+  ponder_thread_.reset();
+  ponder_stop_.reset();
+}
+
+namespace {
+
+// Sets the outcome of a node, adding the memory it takes to `nodes`.
+template <typename Outcome>
+void SetOutcome(SearchNode* node, const Outcome& outcome,
+                std::atomic<int>* nodes) {
+  if (node->outcome.empty()) *nodes += 1;
+  node->outcome = outcome;
+}
+
+// Returns the number of nodes in the subtree, as accounted for by SearchTree:
+// each outcome counts as one node.
+int CountNodes(const SearchNode& node) {
+  int nodes = node.children.allocated_nodes();
+  for (const SearchNode& child : node.children) {
+    nodes += !child.outcome.empty() + CountNodes(child);
+  }
+  return nodes;
+}
+
+// Moves all the descendants of the node to the arena. Nodes which do not
+// have all their children yet keep the room for more.
+void MoveToArena(SearchNode* node, SearchNodeArena* arena) {
+  if (node->children.empty()) return;
+  node->children.reallocate(node->children.partial()
+                                ? node->children.capacity()
+                                : node->children.size(),
+                            arena);
+  for (SearchNode& child : node->children) {
+    MoveToArena(&child, arena);
+  }
+}
+
+// Moves the tree to a new arena owned by its root, and releases the previous
+// one. This frees the memory of the nodes that were removed from it.
+void MoveToNewArena(SearchNode* root) {
+  auto arena = std::make_unique<SearchNodeArena>();
+  MoveToArena(root, arena.get());
+  root->arena.arena = std::move(arena);
+}
+
+}  // namespace
+
+MCTSBot::SearchTree::SearchTree(std::unique_ptr<SearchNode> root_,
+                                int max_nodes)
+    : root(std::move(root_)),
+      max_nodes(max_nodes),
+      nodes(1 + !root->outcome.empty() + CountNodes(*root)),
+      gc_limit(MIN_GC_LIMIT) {
+  if (root->arena.arena == nullptr) {
+    root->arena.arena = std::make_unique<SearchNodeArena>();
+  }
+}
+
+void MCTSBot::ExpandNode(SearchTree* tree, SearchNode* node,
+                         const State& state, ActionsAndProbs legal_actions,
+                         Philox* rng) {
+  if (node == tree->root.get() && dirichlet_alpha_ > 0) {
+    std::vector<double> noise =
+        dirichlet_noise(legal_actions.size(), dirichlet_alpha_, rng);
+    for (int i = 0; i < legal_actions.size(); i++) {
+      legal_actions[i].second =
+          (1 - dirichlet_epsilon_) * legal_actions[i].second +
+          dirichlet_epsilon_ * noise[i];
+    }
+  }
+  const bool widening = widening_c_ > 0 && !state.IsChanceNode() &&
+                        node != tree->root.get();
+  if (state.IsChanceNode()) {
+    // Sorted, for FindChanceChild.
+    std::sort(legal_actions.begin(), legal_actions.end());
+  } else {
+    // Reduce bias from move generation order.
+    std::shuffle(legal_actions.begin(), legal_actions.end(), *rng);
+    if (widening) {
+      std::stable_sort(legal_actions.begin(), legal_actions.end(),
+                       [](const std::pair<Action, double>& a,
+                          const std::pair<Action, double>& b) {
+                         return a.second > b.second;
+                       });
+    }
+  }
+  Player player = state.CurrentPlayer();
+
+  absl::MutexLock lock(&tree->mutex);
+  if (!node->children.empty()) return;  // Another thread was faster.
+  SearchNodeArena* arena = tree->root->arena.arena.get();
+  if (widening) {
+    const int width = std::min<int>(WideningWidth(node->explore_count),
+                                    legal_actions.size());
+    node->children.reserve_widening(
+        legal_actions, tree->virtual_loss ? legal_actions.size() : width,
+        arena);
+    for (int i = 0; i < width; ++i) node->children.widen(player);
+  } else {
+    node->children.reserve(legal_actions.size(), arena);
+    for (auto [action, prior] : legal_actions) {
+      node->children.push_back(SearchNode(action, player, prior));
+    }
+  }
+  tree->nodes += node->children.allocated_nodes();
+}
+
+void MCTSBot::WidenNode(SearchTree* tree, SearchNode* node) {
+  absl::MutexLock lock(&tree->mutex);
+  SearchNodeChildren& children = node->children;
+  const int width = WideningWidth(node->explore_count);
+  const int allocated = children.allocated_nodes();
+  const Player player = children[0].player;
+  while (children.partial() && children.size() < width) {
+    // With several simulations in flight, the room for all the children was
+    // allocated at once.
+    SPIEL_CHECK_TRUE(!tree->virtual_loss ||
+                     children.size() < children.capacity());
+    children.widen(player);
+  }
+  tree->nodes += children.allocated_nodes() - allocated;
+}
+
+int MCTSBot::WideningWidth(int explore_count) const {
+  const double width =
+      std::ceil(widening_c_ * std::pow(explore_count, widening_alpha_));
+  return std::max(
+      1, static_cast<int>(std::min<double>(
+             width, std::numeric_limits<int>::max())));
+}
+
+void MCTSBot::SetProgressiveWidening(double widening_c,
+                                     double widening_alpha) {
+  SPIEL_CHECK_GE(widening_c, 0);
+  SPIEL_CHECK_GE(widening_alpha, 0);
+  widening_c_ = widening_c;
+  widening_alpha_ = widening_alpha;
+}
+
+namespace {
+
+// Returns the child of a chance node for an outcome, or null if it has none.
+// The children of chance nodes are sorted by outcome.
+SearchNode* FindChanceChild(SearchNode* node, Action outcome) {
+  auto it = std::lower_bound(
+      node->children.begin(), node->children.end(), outcome,
+      [](const SearchNode& child, Action a) { return child.action < a; });
+  return it != node->children.end() && it->action == outcome ? it : nullptr;
+}
+
+}  // namespace
+
+SearchNode* MCTSBot::AddChanceChild(SearchTree* tree, SearchNode* node,
+                                    Action outcome, double prob) {
+  absl::MutexLock lock(&tree->mutex);
+  SearchNodeChildren& children = node->children;
+  auto it = std::lower_bound(
+      children.begin(), children.end(), outcome,
+      [](const SearchNode& child, Action a) { return child.action < a; });
+  if (it != children.end() && it->action == outcome) return it;
+  const int allocated = children.allocated_nodes();
+  SearchNode* child = children.insert(
+      it - children.begin(), SearchNode(outcome, kChancePlayerId, prob));
+  children.set_partial(true);
+  tree->nodes += children.allocated_nodes() - allocated;
+  return child;
+}
+
+void MCTSBot::ApplyTreePolicy(SearchTree* tree, const State& state,
+                              std::vector<SearchNode*>* visit_path,
+                              std::unique_ptr<State>* working_state_ptr,
+                              Philox* rng) {
+  OPEN_SPIEL_TRACE_SPAN("mcts", "ApplyTreePolicy");
+  const bool virtual_loss = tree->virtual_loss;
+  SearchNode* root = tree->root.get();
   visit_path->push_back(root);
-  std::unique_ptr<State> working_state = state.Clone();
+  if (virtual_loss) root->virtual_loss += 1;
+  CopyOrCloneState(state, working_state_ptr);
+  State* working_state = working_state_ptr->get();
   SearchNode* current_node = root;
+  tree->mutex.ReaderLock();
   while (!working_state->IsTerminal() && current_node->explore_count > 0) {
-    if (current_node->children.empty()) {
+    const bool chance = working_state->IsChanceNode();
+    // Unless several simulations are in flight, which hold pointers to the
+    // children, chance nodes below the root only get children for the
+    // outcomes sampled, which saves expanding e.g. all the deals of a card
+    // game.
+    const bool lazy_chance =
+        chance && !virtual_loss &&
+        (current_node != root || current_node->children.partial());
+    if (current_node->children.empty() && !lazy_chance) {
+      tree->mutex.ReaderUnlock();
       // For a new node, initialize its state, then choose a child as normal.
-      ActionsAndProbs legal_actions = evaluator_->Prior(*working_state);
-      if (current_node == root && dirichlet_alpha_ > 0) {
-        std::vector<double> noise =
-            dirichlet_noise(legal_actions.size(), dirichlet_alpha_, &rng_);
-        for (int i = 0; i < legal_actions.size(); i++) {
-          legal_actions[i].second =
-              (1 - dirichlet_epsilon_) * legal_actions[i].second +
-              dirichlet_epsilon_ * noise[i];
-        }
-      }
-      // Reduce bias from move generation order.
-      std::shuffle(legal_actions.begin(), legal_actions.end(), rng_);
-      Player player = working_state->CurrentPlayer();
-      current_node->children.reserve(legal_actions.size());
-      for (auto [action, prior] : legal_actions) {
-        current_node->children.emplace_back(action, player, prior);
-      }
-      nodes_ += current_node->children.capacity();
+      ExpandNode(tree, current_node, *working_state,
+                 evaluator_->Prior(*working_state), rng);
+      tree->mutex.ReaderLock();
     }
 
     SearchNode* chosen_child = nullptr;
-    if (working_state->IsChanceNode()) {
+    if (chance) {
       // For chance nodes, rollout according to chance node's probability
       // distribution
-      Action chosen_action =
-          SampleAction(working_state->ChanceOutcomes(), rng_).first;
-
-      for (SearchNode& child : current_node->children) {
-        if (child.action == chosen_action) {
-          chosen_child = &child;
-          break;
-        }
+      const auto [chosen_action, prob] =
+          working_state->SampleChanceOutcome(*rng);
+      chosen_child = FindChanceChild(current_node, chosen_action);
+      if (chosen_child == nullptr) {
+        SPIEL_CHECK_TRUE(lazy_chance);
+        tree->mutex.ReaderUnlock();
+        chosen_child = AddChanceChild(tree, current_node, chosen_action, prob);
+        tree->mutex.ReaderLock();
       }
     } else {
-      // Otherwise choose node with largest UCT value.
-      double max_value = -std::numeric_limits<double>::infinity();
-      for (SearchNode& child : current_node->children) {
-        double val;
-        switch (child_selection_policy_) {
-          case ChildSelectionPolicy::UCT:
-            val = child.UCTValue(current_node->explore_count, uct_c_);
-            break;
-          case ChildSelectionPolicy::PUCT:
-            val = child.PUCTValue(current_node->explore_count, uct_c_);
-            break;
-        }
-        if (val > max_value) {
-          max_value = val;
-          chosen_child = &child;
-        }
+      // A progressively widened node first gets the children due after its
+      // visits.
+      if (current_node->children.partial() &&
+          current_node->children.size() <
+              WideningWidth(current_node->explore_count)) {
+        tree->mutex.ReaderUnlock();
+        WidenNode(tree, current_node);
+        tree->mutex.ReaderLock();
       }
+      // Otherwise choose node with largest UCT value.
+      chosen_child = SelectChild(current_node, child_selection_policy_, uct_c_,
+                                 min_utility_);
     }
 
+    if (virtual_loss) chosen_child->virtual_loss += 1;
     working_state->ApplyAction(chosen_child->action);
     current_node = chosen_child;
     visit_path->push_back(current_node);
   }
+  tree->mutex.ReaderUnlock();
+}
+
+namespace {
+
+// Adds the time of the phases of a simulation to a profile, if not null.
+class PhaseTimer {
+ public:
+  explicit PhaseTimer(MCTSProfile* profile)
+      : profile_(profile), last_(profile ? absl::Now() : absl::Time()) {}
+
+  // Adds the time since the last phase ended to this one.
+  void EndPhase(absl::Duration MCTSProfile::*phase) {
+    if (profile_ == nullptr) return;
+    const absl::Time now = absl::Now();
+    profile_->*phase += now - last_;
+    last_ = now;
+  }
 
-  return working_state;
+ private:
+  MCTSProfile* profile_;
+  absl::Time last_;
+};
+
+}  // namespace
+
+MCTSProfile& MCTSProfile::operator+=(const MCTSProfile& other) {
+  searches += other.searches;
+  simulations += other.simulations;
+  search_time += other.search_time;
+  tree_policy_time += other.tree_policy_time;
+  evaluation_time += other.evaluation_time;
+  backup_time += other.backup_time;
+  gc_time += other.gc_time;
+  garbage_collections += other.garbage_collections;
+  nodes += other.nodes;
+  peak_nodes = std::max(peak_nodes, other.peak_nodes);
+  return *this;
 }
 
-std::unique_ptr<SearchNode> MCTSBot::MCTSearch(const State& state) {
-  Player player_id = state.CurrentPlayer();
-  nodes_ = 1;
-  gc_limit_ = MIN_GC_LIMIT;
-  auto root = std::make_unique<SearchNode>(kInvalidAction, player_id, 1);
-  std::vector<SearchNode*> visit_path;
+MCTSProfile MCTSBot::TakeProfile() {
+  absl::MutexLock lock(&profile_mutex_);
+  return std::exchange(profile_, MCTSProfile());
+}
+
+void MCTSBot::ProfileSearch(absl::Time start) {
+  if (!profiling_) return;
+  absl::MutexLock lock(&profile_mutex_);
+  profile_.searches += 1;
+  profile_.search_time += absl::Now() - start;
+}
+
+void MCTSBot::RunSimulation(SearchTree* tree, const State& state,
+                            std::vector<SearchNode*>* visit_path,
+                            std::unique_ptr<State>* working_state_ptr,
+                            Philox* rng, MCTSProfile* profile) {
+  PhaseTimer timer(profile);
+  visit_path->clear();
+  ApplyTreePolicy(tree, state, visit_path, working_state_ptr, rng);
+  timer.EndPhase(&MCTSProfile::tree_policy_time);
+  const State& working_state = **working_state_ptr;
+
+  const bool terminal = working_state.IsTerminal();
   std::vector<double> returns;
-  visit_path.reserve(64);
-  for (int i = 0; i < max_simulations_; ++i) {
+  if (terminal) {
+    returns = working_state.Returns();
+    timer.EndPhase(&MCTSProfile::evaluation_time);
+  } else if (evaluator_->EvaluatesPriorWithValue()) {
+    // Expanding the leaf now saves evaluating it again on its next visit.
+    ActionsAndProbs prior;
+    returns = evaluator_->EvaluateWithPrior(working_state, &prior);
+    timer.EndPhase(&MCTSProfile::evaluation_time);
+    ExpandNode(tree, visit_path->back(), working_state, std::move(prior), rng);
+    timer.EndPhase(&MCTSProfile::tree_policy_time);
+  } else {
+    returns = evaluator_->Evaluate(working_state);
+    timer.EndPhase(&MCTSProfile::evaluation_time);
+  }
+  BackUp(tree, *visit_path, returns, terminal);
+  timer.EndPhase(&MCTSProfile::backup_time);
+}
+
+void MCTSBot::RunSimulationBatch(SearchTree* tree, const State& state,
+                                 int num_leaves, LeafBatch* batch, Philox* rng,
+                                 MCTSProfile* profile) {
+  PhaseTimer timer(profile);
+  SelectLeaves(tree, state, num_leaves, batch, rng);
+  timer.EndPhase(&MCTSProfile::tree_policy_time);
+
+  std::vector<std::vector<double>> values;
+  if (!batch->leaves.empty()) {
+    std::vector<ActionsAndProbs> priors;
+    values = evaluator_->EvaluateWithPriorBatch(batch->leaf_states, &priors);
+    timer.EndPhase(&MCTSProfile::evaluation_time);
+    ExpandLeaves(tree, *batch, absl::MakeSpan(priors), rng);
+    timer.EndPhase(&MCTSProfile::tree_policy_time);
+  }
+
+  BackUpPaths(tree, *batch, values);
+  timer.EndPhase(&MCTSProfile::backup_time);
+}
+
+void MCTSBot::SelectLeaves(SearchTree* tree, const State& state,
+                           int num_leaves, LeafBatch* batch, Philox* rng) {
+  if (batch->visit_paths.size() < num_leaves) {
+    batch->visit_paths.resize(num_leaves);
+    batch->working_states.resize(num_leaves);
+  }
+  batch->num_paths = num_leaves;
+  batch->leaves.clear();
+  batch->leaf_states.clear();
+  batch->path_leaf.assign(num_leaves, -1);
+
+  // The virtual loss of the paths already chosen steers the next ones away,
+  // but several paths may still end at the same leaf, which is then evaluated
+  // once.
+  for (int i = 0; i < num_leaves; ++i) {
+    std::vector<SearchNode*>& visit_path = batch->visit_paths[i];
+    std::unique_ptr<State>& working_state = batch->working_states[i];
     visit_path.clear();
-    returns.clear();
+    ApplyTreePolicy(tree, state, &visit_path, &working_state, rng);
+    if (working_state->IsTerminal()) continue;
+    auto it = std::find(batch->leaves.begin(), batch->leaves.end(),
+                        visit_path.back());
+    batch->path_leaf[i] = it - batch->leaves.begin();
+    if (it == batch->leaves.end()) {
+      batch->leaves.push_back(visit_path.back());
+      batch->leaf_states.push_back(working_state.get());
+    }
+  }
+}
+
+void MCTSBot::ExpandLeaves(SearchTree* tree, const LeafBatch& batch,
+                           absl::Span<ActionsAndProbs> priors, Philox* rng) {
+  SPIEL_CHECK_EQ(priors.size(), batch.leaves.size());
+  for (int j = 0; j < batch.leaves.size(); ++j) {
+    ExpandNode(tree, batch.leaves[j], *batch.leaf_states[j],
+               std::move(priors[j]), rng);
+  }
+}
 
-    std::unique_ptr<State> working_state =
-        ApplyTreePolicy(root.get(), state, &visit_path);
+void MCTSBot::BackUpPaths(SearchTree* tree, const LeafBatch& batch,
+                          absl::Span<const std::vector<double>> values) {
+  SPIEL_CHECK_EQ(values.size(), batch.leaves.size());
+  for (int i = 0; i < batch.num_paths; ++i) {
+    const bool terminal = batch.path_leaf[i] < 0;
+    BackUp(tree, batch.visit_paths[i],
+           terminal ? batch.working_states[i]->Returns()
+                    : values[batch.path_leaf[i]],
+           terminal);
+  }
+}
 
-    bool solved;
-    if (working_state->IsTerminal()) {
-      returns = working_state->Returns();
-      visit_path[visit_path.size() - 1]->outcome = returns;
-      solved = solve_;
-    } else {
-      returns = evaluator_->Evaluate(*working_state);
-      solved = false;
-    }
-
-    // Propagate values back.
-    for (auto it = visit_path.rbegin(); it != visit_path.rend(); ++it) {
-      SearchNode* node = *it;
-
-      node->total_reward +=
-          returns[node->player == kChancePlayerId ? player_id : node->player];
-      node->explore_count += 1;
-
-      // Back up solved results as well.
-      if (solved && !node->children.empty()) {
-        Player player = node->children[0].player;
-        if (player == kChancePlayerId) {
-          // Only back up chance nodes if all have the same outcome.
-          // An alternative would be to back up the weighted average of
-          // outcomes if all children are solved, but that is less clear.
-          const std::vector<double>& outcome = node->children[0].outcome;
-          if (!outcome.empty() &&
-              std::all_of(node->children.begin() + 1, node->children.end(),
-                          [&outcome](const SearchNode& c) {
-                            return c.outcome == outcome;
-                          })) {
-            node->outcome = outcome;
-          } else {
-            solved = false;
-          }
+void MCTSBot::BackUp(SearchTree* tree,
+                     const std::vector<SearchNode*>& visit_path,
+                     const std::vector<double>& returns, bool terminal) {
+  // Outcomes are read while walking down the tree, so setting them (and
+  // backing up solved results) needs exclusive access.
+  absl::MutexLockMaybe lock(terminal ? &tree->mutex : nullptr);
+  bool solved = false;
+  if (terminal) {
+    SetOutcome(visit_path.back(), returns, &tree->nodes);
+    solved = solve_;
+  }
+
+  // Propagate values back.
+  const Player root_player = tree->root->player;
+  for (auto it = visit_path.rbegin(); it != visit_path.rend(); ++it) {
+    SearchNode* node = *it;
+
+    node->total_reward.Add(
+        returns[node->player == kChancePlayerId ? root_player : node->player]);
+    node->explore_count += 1;
+    if (tree->virtual_loss) node->virtual_loss -= 1;
+
+    // Back up solved results as well.
+    if (solved && !node->children.empty()) {
+      Player player = node->children[0].player;
+      if (player == kChancePlayerId) {
+        // Only back up chance nodes if all have the same outcome.
+        // An alternative would be to back up the weighted average of
+        // outcomes if all children are solved, but that is less clear.
+        // The outcomes without children are unknown.
+        const SolvedOutcome& outcome = node->children[0].outcome;
+        if (!outcome.empty() && !node->children.partial() &&
+            std::all_of(node->children.begin() + 1, node->children.end(),
+                        [&outcome](const SearchNode& c) {
+                          return c.outcome == outcome;
+                        })) {
+          SetOutcome(node, outcome, &tree->nodes);
         } else {
-          // If any have max utility (won?), or all children are solved,
-          // choose the one best for the player choosing.
-          const SearchNode* best = nullptr;
-          bool all_solved = true;
-          for (const SearchNode& child : node->children) {
-            if (child.outcome.empty()) {
-              all_solved = false;
-            } else if (best == nullptr ||
-                       child.outcome[player] > best->outcome[player]) {
-              best = &child;
-            }
-          }
-          if (best != nullptr &&
-              (all_solved || best->outcome[player] == max_utility_)) {
-            node->outcome = best->outcome;
-          } else {
-            solved = false;
+          solved = false;
+        }
+      } else {
+        // If any have max utility (won?), or all children are solved,
+        // choose the one best for the player choosing. The actions without
+        // children are unknown.
+        const SearchNode* best = nullptr;
+        bool all_solved = true;
+        for (const SearchNode& child : node->children) {
+          if (child.outcome.empty()) {
+            all_solved = false;
+          } else if (best == nullptr ||
+                     child.outcome[player] > best->outcome[player]) {
+            best = &child;
           }
         }
+        if (best != nullptr &&
+            ((all_solved && !node->children.partial()) ||
+             best->outcome[player] == max_utility_)) {
+          SetOutcome(node, best->outcome, &tree->nodes);
+        } else {
+          solved = false;
+        }
       }
     }
+  }
+}
 
-    if (!root->outcome.empty() ||  // Full game tree is solved.
-        root->children.size() == 1) {
-      break;
+namespace {
+
+// How many simulations each thread of a timed search runs between looks at
+// the clock.
+constexpr int kClockCheckInterval = 16;
+
+// Whether a timed search that started at `start` should stop: it is past its
+// deadline, or the most explored child of the root could not be overtaken by
+// another one in the simulations left, as estimated from the rate so far.
+bool OutOfTime(const SearchNode& root, absl::Time start, absl::Time deadline,
+               int num_simulations, int max_simulations) {
+  const absl::Time now = absl::Now();
+  if (now >= deadline) return true;
+  if (now <= start) return false;
+  const double remaining_simulations = std::min<double>(
+      max_simulations - num_simulations,
+      num_simulations * absl::FDivDuration(deadline - now, now - start));
+  int most_explored = 0;
+  int second_most_explored = 0;
+  for (const SearchNode& child : root.children) {
+    const int explore_count = child.explore_count;
+    if (explore_count > most_explored) {
+      second_most_explored = most_explored;
+      most_explored = explore_count;
+    } else if (explore_count > second_most_explored) {
+      second_most_explored = explore_count;
     }
-    if (max_nodes_ > 1 && nodes_ >= max_nodes_) {
-      // Note that actual memory used as counted by ps/top might exceed the
-      // counted value here, possibly by a significant margin (1.5x even!). Part
-      // of that is not counting the outcome array, but most of that is due to
-      // memory fragmentation and is out of our control without writing our own
-      // memory manager.
-      if (verbose_) {
-        std::cerr << absl::StrFormat(
-            ("Approx %d mb in %d nodes after %d sims, garbage collecting with "
-             "limit %d ... "),
-            MemoryUsedMb(nodes_), nodes_, i, gc_limit_);
+  }
+  return most_explored - second_most_explored > remaining_simulations;
+}
+
+}  // namespace
+
+void MCTSBot::RunSearch(SearchTree* tree, const State& state,
+                        int max_simulations,
+                        const std::vector<Philox*>& rngs) {
+  tree->virtual_loss = rngs.size() > 1 || leaf_batch_size_ > 1;
+  SearchNode* root = tree->root.get();
+  const bool timed = tree->deadline != absl::InfiniteFuture();
+  const absl::Time start = absl::Now();
+  std::atomic<int> num_simulations{0};
+  std::atomic<bool> stop{false};
+  std::atomic<bool> out_of_time{false};
+  auto search = [&](Philox* rng) {
+    LeafBatch batch;
+    batch.visit_paths.resize(1);
+    batch.visit_paths[0].reserve(64);
+    batch.working_states.resize(1);
+    int clock_check_countdown = 0;
+    MCTSProfile thread_profile;
+    MCTSProfile* profile = profiling_ ? &thread_profile : nullptr;
+    while (!stop) {
+      const int first = num_simulations.fetch_add(leaf_batch_size_);
+      if (first >= max_simulations) break;
+      if (leaf_batch_size_ == 1) {
+        RunSimulation(tree, state, &batch.visit_paths[0],
+                      &batch.working_states[0], rng, profile);
+        thread_profile.simulations += 1;
+      } else {
+        const int num_leaves =
+            std::min(leaf_batch_size_, max_simulations - first);
+        RunSimulationBatch(tree, state, num_leaves, &batch, rng, profile);
+        thread_profile.simulations += num_leaves;
+      }
+      // Stop when the full game tree is solved or there is only one choice,
+      // and pause to garbage collect when out of memory.
+      absl::ReaderMutexLock lock(&tree->mutex);
+      if (!root->outcome.empty() || root->children.size() == 1 ||
+          (tree->max_nodes > 1 && tree->nodes >= tree->max_nodes)) {
+        stop = true;
+      }
+      if (timed && --clock_check_countdown <= 0) {
+        clock_check_countdown = kClockCheckInterval;
+        if (OutOfTime(*root, start, tree->deadline, num_simulations,
+                      max_simulations)) {
+          out_of_time = true;
+          stop = true;
+        }
+      }
+      if ((stop_token_ != nullptr && stop_token_->StopRequested()) ||
+          (ponder_stop_ != nullptr && ponder_stop_->StopRequested())) {
+        out_of_time = true;
+        stop = true;
       }
-      GarbageCollect(root.get());
+    }
+    if (profile != nullptr) {
+      absl::MutexLock lock(&profile_mutex_);
+      profile_ += thread_profile;
+    }
+  };
 
-      // Slowly increase or decrease to target releasing half the memory.
-      gc_limit_ *= (nodes_ > max_nodes_ / 2 ? 1.25 : 0.9);
-      gc_limit_ = std::max(MIN_GC_LIMIT, gc_limit_);
-      if (verbose_) {
-        std::cerr << absl::StrFormat(
-            "%d mb in %d nodes remaining\n",
-            MemoryUsedMb(nodes_), nodes_);
+  MCTSProfile gc_profile;
+  while (true) {
+    stop = false;
+    if (rngs.size() == 1) {
+      search(rngs[0]);
+    } else {
+      std::vector<Thread> threads;
+      threads.reserve(rngs.size());
+      for (Philox* rng : rngs) {
+        threads.emplace_back([&search, rng]() { search(rng); });
       }
+      for (Thread& thread : threads) thread.join();
+    }
+
+    if (!root->outcome.empty() ||  // Full game tree is solved.
+        root->children.size() == 1 || out_of_time) {
+      break;
+    }
+    if (tree->max_nodes > 1 && tree->nodes >= tree->max_nodes) {
+      CollectGarbage(tree, &gc_profile);
+    }
+    if (num_simulations >= max_simulations) break;
+  }
+  if (profiling_) {
+    gc_profile.nodes = tree->nodes;
+    gc_profile.peak_nodes = std::max<int64_t>(gc_profile.peak_nodes,
+                                              tree->nodes);
+    absl::MutexLock lock(&profile_mutex_);
+    profile_ += gc_profile;
+  }
+}
+
+namespace {
+
+// Sums the statistics of the roots of independent searches of the same state,
+// and those of their children, into the first root.
+std::unique_ptr<SearchNode> MergeRoots(
+    std::vector<std::unique_ptr<SearchNode>> roots) {
+  std::unique_ptr<SearchNode> merged = std::move(roots[0]);
+  for (int i = 1; i < roots.size(); ++i) {
+    SearchNode* root = roots[i].get();
+    merged->explore_count += root->explore_count;
+    merged->total_reward.Add(root->total_reward);
+    // Proven outcomes do not depend on the search, so any of them will do.
+    if (merged->outcome.empty()) merged->outcome = root->outcome;
+    if (merged->children.empty()) {
+      // Copied to the heap, as the arena of the root is released with it.
+      merged->children = root->children;
+      continue;
     }
+    absl::flat_hash_map<Action, SearchNode*> merged_children;
+    for (SearchNode& child : merged->children) {
+      merged_children[child.action] = &child;
+    }
+    for (const SearchNode& child : root->children) {
+      auto it = merged_children.find(child.action);
+      SPIEL_CHECK_TRUE(it != merged_children.end());
+      SearchNode* merged_child = it->second;
+      merged_child->explore_count += child.explore_count;
+      merged_child->total_reward.Add(child.total_reward);
+      if (merged_child->outcome.empty()) merged_child->outcome = child.outcome;
+    }
+  }
+  return merged;
+}
+
+}  // namespace
+
+std::unique_ptr<SearchNode> MCTSBot::MCTSearch(const State& state) {
+  return MCTSearchUntil(state, absl::InfiniteFuture());
+}
+
+std::unique_ptr<SearchNode> MCTSBot::MCTSearchUntil(const State& state,
+                                                    absl::Time deadline) {
+  StopPondering();
+  return Search(state, nullptr, std::min(deadline, absl::Now() + max_time_),
+                max_simulations_);
+}
+
+const SearchNode& MCTSBot::ContinueMCTSearch(const State& state) {
+  return ContinueMCTSearchUntil(state, absl::InfiniteFuture());
+}
+
+const SearchNode& MCTSBot::ContinueMCTSearchUntil(const State& state,
+                                                  absl::Time deadline) {
+  StopPondering();
+  tree_ = Search(state, ReusableSubtree(state),
+                 std::min(deadline, absl::Now() + max_time_), max_simulations_);
+  tree_history_ = state.FullHistory();
+  return *tree_;
+}
+
+std::unique_ptr<SearchNode> MCTSBot::ReusableSubtree(const State& state) {
+  std::unique_ptr<SearchNode> tree = std::move(tree_);
+  const std::vector<Action>& history = state.FullHistory();
+  if (tree == nullptr || history.size() < tree_history_.size() ||
+      !std::equal(tree_history_.begin(), tree_history_.end(),
+                  history.begin())) {
+    return nullptr;
   }
+  SearchNode* node = tree.get();
+  for (int i = tree_history_.size(); i < history.size(); ++i) {
+    auto child = absl::c_find_if(node->children, [&](const SearchNode& c) {
+      return c.action == history[i];
+    });
+    if (child == node->children.end()) return nullptr;
+    node = &*child;
+  }
+  if (node->children.empty()) return nullptr;
 
+  auto root = std::make_unique<SearchNode>(std::move(*node));
+  // The root has all its children, as in a search from scratch.
+  if (root->children.widening()) {
+    const Player player = root->children[0].player;
+    while (root->children.partial()) root->children.widen(player);
+  }
+  // Only keep the memory of the reused nodes.
+  MoveToNewArena(root.get());
+  root->action = kInvalidAction;
+  root->prior = 1;
+  root->player = state.CurrentPlayer();
+  // The value of the node was from the point of view of the player who chose
+  // it, so it is recomputed from its children.
+  root->explore_count = 0;
+  root->total_reward = 0;
+  for (const SearchNode& child : root->children) {
+    root->explore_count += child.explore_count;
+    root->total_reward.Add(child.total_reward);
+  }
   return root;
 }
 
-void MCTSBot::GarbageCollect(SearchNode* node) {
+int MCTSBot::MaxNodes(const State& state) const {
+  if (max_nodes_ <= 1) return max_nodes_;
+  const int64_t state_bytes = static_cast<int64_t>(num_threads_) *
+                              leaf_batch_size_ *
+                              state.ApproximateMemoryUsage();
+  return std::max<int64_t>(2, max_nodes_ - state_bytes / sizeof(SearchNode));
+}
+
+std::unique_ptr<SearchNode> MCTSBot::Search(const State& state,
+                                            std::unique_ptr<SearchNode> root,
+                                            absl::Time deadline,
+                                            int max_simulations) {
+  OPEN_SPIEL_TRACE_SPAN("mcts", "MCTSearch");
+  const absl::Time start = absl::Now();
+  const Player player = state.CurrentPlayer();
+  if (root == nullptr) {
+    root = std::make_unique<SearchNode>(kInvalidAction, player, 1);
+  }
+  const int max_nodes = MaxNodes(state);
+  if (num_threads_ == 1) {
+    SearchTree tree(std::move(root), max_nodes);
+    tree.deadline = deadline;
+    RunSearch(&tree, state, max_simulations, {&rng_});
+    nodes_ = tree.nodes;
+    ProfileSearch(start);
+    return std::move(tree.root);
+  }
+
+  // Each thread gets its own stream of a generator seeded from the bot's one.
+  const Philox search_rng(rng_());
+  std::vector<Philox> rngs;
+  for (int i = 0; i < num_threads_; ++i) rngs.push_back(search_rng.Split(i));
+
+  if (parallelism_policy_ == ParallelismPolicy::TREE) {
+    SearchTree tree(std::move(root), max_nodes);
+    tree.deadline = deadline;
+    std::vector<Philox*> tree_rngs;
+    for (Philox& rng : rngs) tree_rngs.push_back(&rng);
+    RunSearch(&tree, state, max_simulations, tree_rngs);
+    nodes_ = tree.nodes;
+    ProfileSearch(start);
+    return std::move(tree.root);
+  }
+
+  // Root parallelism: the simulations and the memory are split between
+  // independent trees, each searched by its own thread. A reused root is
+  // given to the first one.
+  std::vector<std::unique_ptr<SearchTree>> trees;
+  for (int i = 0; i < num_threads_; ++i) {
+    trees.push_back(std::make_unique<SearchTree>(
+        i == 0 ? std::move(root)
+               : std::make_unique<SearchNode>(kInvalidAction, player, 1),
+        max_nodes > 1 ? std::max(2, max_nodes / num_threads_) : 1));
+    trees.back()->deadline = deadline;
+  }
+  std::vector<Thread> threads;
+  threads.reserve(num_threads_);
+  for (int i = 0; i < num_threads_; ++i) {
+    int thread_simulations = max_simulations / num_threads_ +
+                             (i < max_simulations % num_threads_ ? 1 : 0);
+    threads.emplace_back(
+        [this, &trees, &rngs, &state, i, thread_simulations]() {
+          RunSearch(trees[i].get(), state, thread_simulations, {&rngs[i]});
+        });
+  }
+  for (Thread& thread : threads) thread.join();
+
+  nodes_ = 0;
+  std::vector<std::unique_ptr<SearchNode>> roots;
+  for (auto& tree : trees) {
+    nodes_ += tree->nodes;
+    roots.push_back(std::move(tree->root));
+  }
+  ProfileSearch(start);
+  return MergeRoots(std::move(roots));
+}
+
+std::unique_ptr<MCTSBot::SteppedSearch> MCTSBot::StartSteppedSearch(
+    const State& state) {
+  return std::make_unique<SteppedSearch>(this, state);
+}
+
+MCTSBot::SteppedSearch::SteppedSearch(MCTSBot* bot, const State& state)
+    : bot_(bot), state_(state.Clone()), start_(absl::Now()) {
+  tree_ = std::make_unique<SearchTree>(
+      std::make_unique<SearchNode>(kInvalidAction, state.CurrentPlayer(), 1),
+      bot->MaxNodes(state));
+  tree_->virtual_loss = bot->leaf_batch_size_ > 1;
+  Advance();
+}
+
+void MCTSBot::SteppedSearch::Resume(
+    absl::Span<const std::vector<double>> values,
+    absl::Span<ActionsAndProbs> priors) {
+  SPIEL_CHECK_FALSE(done_);
+  PhaseTimer timer(bot_->profiling_ ? &profile_ : nullptr);
+  bot_->ExpandLeaves(tree_.get(), batch_, priors, &bot_->rng_);
+  timer.EndPhase(&MCTSProfile::tree_policy_time);
+  bot_->BackUpPaths(tree_.get(), batch_, values);
+  timer.EndPhase(&MCTSProfile::backup_time);
+  Advance();
+}
+
+void MCTSBot::SteppedSearch::Advance() {
+  const SearchNode* root = tree_->root.get();
+  const StopToken* stop = bot_->stop_token_;
+  while (simulations_ < bot_->max_simulations_ && root->outcome.empty() &&
+         root->children.size() != 1 &&
+         !(simulations_ > 0 && stop != nullptr && stop->StopRequested())) {
+    if (tree_->max_nodes > 1 && tree_->nodes >= tree_->max_nodes) {
+      bot_->CollectGarbage(tree_.get(), &profile_);
+    }
+    PhaseTimer timer(bot_->profiling_ ? &profile_ : nullptr);
+    const int num_leaves =
+        std::min(bot_->leaf_batch_size_, bot_->max_simulations_ - simulations_);
+    bot_->SelectLeaves(tree_.get(), *state_, num_leaves, &batch_, &bot_->rng_);
+    timer.EndPhase(&MCTSProfile::tree_policy_time);
+    simulations_ += num_leaves;
+    profile_.simulations += num_leaves;
+    if (!batch_.leaves.empty()) return;
+    bot_->BackUpPaths(tree_.get(), batch_, {});
+    timer.EndPhase(&MCTSProfile::backup_time);
+  }
+
+  done_ = true;
+  batch_.leaves.clear();
+  batch_.leaf_states.clear();
+  bot_->nodes_ = tree_->nodes;
+  if (bot_->profiling_) {
+    profile_.nodes = tree_->nodes;
+    profile_.peak_nodes = std::max<int64_t>(profile_.peak_nodes, tree_->nodes);
+    {
+      absl::MutexLock lock(&bot_->profile_mutex_);
+      bot_->profile_ += profile_;
+    }
+    bot_->ProfileSearch(start_);
+  }
+}
+
+std::unique_ptr<SearchNode> MCTSBot::SteppedSearch::TakeRoot() {
+  SPIEL_CHECK_TRUE(done_);
+  return std::move(tree_->root);
+}
+
+void MCTSBot::CollectGarbage(SearchTree* tree, MCTSProfile* gc_profile) {
+  SearchNode* root = tree->root.get();
+  // The nodes are moved to a new arena after garbage collection, so the
+  // memory they use is the counted value here, up to one partially filled
+  // block, with each proven outcome counted as one node.
+  if (verbose_) {
+    std::cerr << absl::StrFormat(
+        ("Approx %d mb in %d nodes after %d sims, garbage collecting with "
+         "limit %d ... "),
+        MemoryUsedMb(tree->nodes), tree->nodes.load(),
+        root->explore_count.load(), tree->gc_limit);
+  }
+  const absl::Time gc_start = absl::Now();
+  gc_profile->peak_nodes = std::max<int64_t>(gc_profile->peak_nodes,
+                                             tree->nodes);
+  GarbageCollect(tree, root);
+  MoveToNewArena(root);
+  gc_profile->gc_time += absl::Now() - gc_start;
+  gc_profile->garbage_collections += 1;
+
+  // Slowly increase or decrease to target releasing half the memory.
+  tree->gc_limit *= (tree->nodes > tree->max_nodes / 2 ? 1.25 : 0.9);
+  tree->gc_limit = std::max(MIN_GC_LIMIT, tree->gc_limit);
+  if (verbose_) {
+    std::cerr << absl::StrFormat(
+        "%d mb in %d nodes remaining\n",
+        MemoryUsedMb(tree->nodes), tree->nodes.load());
+  }
+}
+
+void MCTSBot::GarbageCollect(SearchTree* tree, SearchNode* node) {
   if (node->children.empty()) {
     return;
   }
-  bool clear_children = node->explore_count < gc_limit_;
+  bool clear_children = node->explore_count < tree->gc_limit;
   for (SearchNode& child : node->children) {
-    GarbageCollect(&child);
+    GarbageCollect(tree, &child);
   }
   if (clear_children) {
-    nodes_ -= node->children.capacity();
+    tree->nodes -= node->children.allocated_nodes();
+    for (const SearchNode& child : node->children) {
+      tree->nodes -= !child.outcome.empty();
+    }
     node->children.clear();
-    node->children.shrink_to_fit();  // release the memory
   }
 }
 
@@ -15,11 +15,25 @@
 #ifndef OPEN_SPIEL_ALGORITHMS_MCTS_H_
 #define OPEN_SPIEL_ALGORITHMS_MCTS_H_
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
 #include <memory>
 #include <random>
+#include <utility>
+#include <vector>
 
+#include "open_spiel/abseil-cpp/absl/synchronization/mutex.h"
+#include "open_spiel/abseil-cpp/absl/time/time.h"
+#include "open_spiel/abseil-cpp/absl/types/span.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_bots.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/random.h"
+#include "open_spiel/utils/thread.h"
+#include "open_spiel/utils/threaded_queue.h"
 
 // A vanilla Monte Carlo Tree Search algorithm.
 //
@@ -53,6 +67,15 @@
 // draw games). Also chance nodes are considered proven only if all children
 // have the same value.
 //
+// The search can also be run by several threads sharing one tree (tree
+// parallelization). To keep the threads from all following the same path, the
+// simulations in flight through a node count as visits returning the minimum
+// utility of the game ("virtual loss") until their result is backed up.
+// Alternatively, each thread can build an independent tree from its own seed
+// (root parallelization), the statistics of the children of the roots being
+// summed at the end. Either way, the evaluator is called concurrently, so it
+// must be thread-safe.
+//
 // Some references:
 // - Sturtevant, An Analysis of UCT in Multi-Player Games,  2008,
 //   https://web.cs.du.edu/~sturtevant/papers/multi-player_UCT.pdf
@@ -62,15 +85,27 @@
 //   https://deepmind.com/blog/article/alphago-zero-starting-scratch
 // - Winands, Bjornsson, and Saito, Monte-Carlo Tree Search Solver, 2008.
 //   https://dke.maastrichtuniversity.nl/m.winands/documents/uctloa.pdf
+// - Chaslot, Winands, and van den Herik, Parallel Monte-Carlo Tree Search,
+//   2008.
+// - Coulom, Computing Elo Ratings of Move Patterns in the Game of Go, 2007,
+//   for progressive widening.
 
 namespace open_spiel {
 namespace algorithms {
 
+class OpeningBook;  // See opening_book.h.
+
 enum class ChildSelectionPolicy {
   UCT,
   PUCT,
 };
 
+// How the simulations of a search are split when using multiple threads.
+enum class ParallelismPolicy {
+  TREE,  // All threads share one tree, and spread out using virtual loss.
+  ROOT,  // Each thread builds its own tree, with a share of the simulations.
+};
+
 // Abstract class representing an evaluation function for a game.
 // The evaluation function takes in an intermediate state in the game and
 // returns an evaluation of that state, which should correlate with chances of
@@ -84,15 +119,49 @@ class Evaluator {
 
   // Return a policy: the probability of the current player playing each action.
   virtual ActionsAndProbs Prior(const State& state) = 0;
+
+  // Batched versions of Evaluate and Prior, returning one result per state.
+  // Evaluators that are more efficient on several states at once (e.g. neural
+  // networks) should override them. By default, they call Evaluate and Prior
+  // on each state in turn.
+  virtual std::vector<std::vector<double>> EvaluateBatch(
+      const std::vector<const State*>& states);
+  virtual std::vector<ActionsAndProbs> PriorBatch(
+      const std::vector<const State*>& states);
+
+  // Evaluate and Prior in one call, and its batched version. Evaluators that
+  // compute both together (e.g. neural networks) should override them and
+  // EvaluatesPriorWithValue. By default, they call each in turn.
+  virtual std::vector<double> EvaluateWithPrior(const State& state,
+                                                ActionsAndProbs* prior);
+  virtual std::vector<std::vector<double>> EvaluateWithPriorBatch(
+      const std::vector<const State*>& states,
+      std::vector<ActionsAndProbs>* priors);
+
+  // Whether EvaluateWithPrior costs about as much as Evaluate, in which case
+  // MCTSBot expands new leaves as it evaluates them rather than on their next
+  // visit.
+  virtual bool EvaluatesPriorWithValue() const { return false; }
 };
 
 // A simple evaluator that returns the average outcome of playing random actions
 // from the given state until the end of the game.
 // n_rollouts is the number of random outcomes to be considered.
+//
+// It is thread-safe: concurrent calls each use their own random generator, the
+// first one seeded with `seed` and the others with `seed + 1`, `seed + 2`, etc.
+// Moves are sampled with State::SampleRandomLegalAction when the game supports
+// it, so rollouts do not generate the legal actions.
+//
+// With num_threads > 1, the rollouts of each call are shared with that many
+// threads, including the calling one, which are started once and kept for the
+// lifetime of the evaluator. This helps when each call runs many long
+// rollouts, but is not deterministic.
 class RandomRolloutEvaluator : public Evaluator {
  public:
-  explicit RandomRolloutEvaluator(int n_rollouts, int seed)
-      : n_rollouts_(n_rollouts), rng_(seed) {}
+  explicit RandomRolloutEvaluator(int n_rollouts, int seed,
+                                  int num_threads = 1);
+  ~RandomRolloutEvaluator() override;
 
   // Runs random games, returning the average returns.
   std::vector<double> Evaluate(const State& state) override;
@@ -101,30 +170,269 @@ class RandomRolloutEvaluator : public Evaluator {
   ActionsAndProbs Prior(const State& state) override;
 
  private:
+  // The random generator and scratch space used by one call at a time. The
+  // scratch space is reused across calls so rollouts do not allocate a vector
+  // per move, nor a new state per rollout for games implementing
+  // State::CopyFrom.
+  struct Worker {
+    Worker(int seed, int stream) : rng(seed, stream) {}
+    Philox rng;
+    std::vector<Action> legal_actions;
+    std::unique_ptr<State> working_state;
+  };
+
+  // The rollouts of one call, claimed one at a time by the threads running
+  // them.
+  struct RolloutJob {
+    RolloutJob(const State* state_, int n_rollouts_)
+        : state(state_), n_rollouts(n_rollouts_) {}
+    const State* state;  // Only valid while rollouts remain to be claimed.
+    const int n_rollouts;
+    std::atomic<int> next_rollout{0};
+    absl::Mutex m;  // Protects the fields below.
+    std::vector<double> total_returns;
+    int rollouts_done = 0;
+  };
+
+  // Plays one random game from the state, adding its returns to
+  // `total_returns`.
+  void Rollout(const State& state, Worker* worker,
+               std::vector<double>* total_returns);
+
+  // Runs rollouts of the job until all of them are claimed.
+  void RunRollouts(RolloutJob* job);
+
+  std::unique_ptr<Worker> AcquireWorker();
+  void ReleaseWorker(std::unique_ptr<Worker> worker);
+
   int n_rollouts_;
-  std::mt19937 rng_;
+  int seed_;
+  absl::Mutex m_;
+  int num_workers_ = 0;
+  std::vector<std::unique_ptr<Worker>> idle_workers_;
+
+  // The jobs waiting for help from the rollout threads.
+  ThreadedQueue<std::shared_ptr<RolloutJob>> jobs_;
+  std::vector<Thread> rollout_threads_;
+};
+
+// A std::atomic which can be copied, so that SearchNodes can be stored in a
+// std::vector. The copies themselves are not atomic: nodes are only copied
+// while no search is running on them.
+template <typename T>
+class CopyableAtomic : public std::atomic<T> {
+ public:
+  CopyableAtomic(T value = T()) : std::atomic<T>(value) {}
+  CopyableAtomic(const CopyableAtomic& other) : std::atomic<T>(other.load()) {}
+  CopyableAtomic& operator=(const CopyableAtomic& other) {
+    this->store(other.load());
+    return *this;
+  }
+  using std::atomic<T>::operator=;
+
+  // Atomically adds delta. Unlike fetch_add, this also works for floating
+  // point types before C++20.
+  void Add(T delta) {
+    T value = this->load(std::memory_order_relaxed);
+    while (!this->compare_exchange_weak(value, value + delta)) {}
+  }
+};
+
+// A bump allocator for the nodes of one search tree, which owns their memory.
+// Nothing is freed before the arena is destroyed: MCTSBot moves the nodes that
+// survive a garbage collection to a new arena instead, so the memory used is
+// that of the live nodes plus at most one partially filled block. Not
+// thread-safe.
+class SearchNodeArena {
+ public:
+  SearchNodeArena() = default;
+  SearchNodeArena(const SearchNodeArena&) = delete;
+  SearchNodeArena& operator=(const SearchNodeArena&) = delete;
+
+  // Returns `bytes` of memory, suitably aligned for any type.
+  void* Allocate(std::size_t bytes);
+
+  // The memory reserved from the heap so far.
+  std::size_t ReservedBytes() const { return reserved_bytes_; }
+
+ private:
+  static constexpr std::size_t kBlockBytes = 1 << 16;
+
+  std::vector<std::unique_ptr<char[]>> blocks_;
+  char* next_ = nullptr;
+  std::size_t remaining_bytes_ = 0;
+  std::size_t reserved_bytes_ = 0;
 };
 
-// A node in the search tree for MCTS
+struct SearchNode;
+
+// The children of a node: an array of fixed capacity, allocated from the arena
+// of the tree if it has one, and from the heap otherwise. Copies are always on
+// the heap, so they remain valid after the arena is destroyed. It only holds a
+// pointer and two counts, to keep nodes small.
+//
+// With progressive widening, the actions and priors of all the children, in
+// the order they are added, follow the children in the same allocation, at 8
+// bytes each rather than a node's 64, and the children are added by widen().
+class SearchNodeChildren {
+ public:
+  SearchNodeChildren()
+      : capacity_(0), in_arena_(false), partial_(false), widening_(false) {}
+  SearchNodeChildren(const SearchNodeChildren& other);
+  SearchNodeChildren(SearchNodeChildren&& other) noexcept;
+  SearchNodeChildren& operator=(const SearchNodeChildren& other);
+  SearchNodeChildren& operator=(SearchNodeChildren&& other) noexcept;
+  ~SearchNodeChildren() { clear(); }
+
+  // Allocates room for `capacity` children, from the arena if not null. The
+  // container must be empty.
+  void reserve(int capacity, SearchNodeArena* arena = nullptr);
+  // Appends a child, within the reserved capacity.
+  void push_back(const SearchNode& node);
+  void push_back(SearchNode&& node);
+  // Replaces the children by copies of [first, last), on the heap.
+  template <typename It>
+  void assign(It first, It last);
+  // Inserts a child before the i-th one, and returns it. When full, this
+  // grows the children on the heap, doubling their capacity. Either way it
+  // moves the children after i, so no pointers to them may be held.
+  SearchNode* insert(int i, SearchNode&& node);
+  // Destroys the children, and releases the memory if it is on the heap.
+  void clear();
+  // Moves the children to a new allocation of `capacity`, which must hold
+  // them, from the arena if not null.
+  void reallocate(int capacity, SearchNodeArena* arena = nullptr);
+
+  // Allocates room for `capacity` children, and keeps the actions, to be
+  // added as children in that order by widen(). The container must be empty.
+  void reserve_widening(const ActionsAndProbs& actions, int capacity,
+                        SearchNodeArena* arena = nullptr);
+  // Appends the child of the next action kept by reserve_widening, for the
+  // player, and returns it. When full, this grows the children on the heap
+  // like insert, so no pointers to them may be held.
+  SearchNode* widen(Player player);
+  bool widening() const { return widening_; }
+
+  // Whether the node does not have all its children yet: only the sampled
+  // outcomes of a chance node, which are inserted as they are first sampled,
+  // or the first actions of a progressively widened node.
+  bool partial() const { return partial_; }
+  void set_partial(bool partial) { partial_ = partial; }
+
+  int size() const { return size_; }
+  int capacity() const { return capacity_; }
+  // The memory held, in nodes: the capacity, and the kept actions.
+  int allocated_nodes() const;
+  bool empty() const { return size_ == 0; }
+  inline SearchNode* begin();
+  inline SearchNode* end();
+  inline const SearchNode* begin() const;
+  inline const SearchNode* end() const;
+  inline SearchNode& operator[](int i);
+  inline const SearchNode& operator[](int i) const;
+
+ private:
+  // An action kept for progressive widening. The first one holds the number
+  // of actions that follow it instead.
+  struct WideningAction {
+    int32_t action;
+    float prior;
+  };
+
+  // Allocates the memory of `capacity` children and, if num_actions > 0, of
+  // that many kept actions, without initializing them.
+  void Allocate(uint32_t capacity, int num_actions, SearchNodeArena* arena);
+  // The kept actions, after the capacity of the children.
+  WideningAction* widening_actions() const;
+  int num_widening_actions() const;
+
+  SearchNode* data_ = nullptr;
+  uint32_t size_ = 0;
+  uint32_t capacity_ : 29;
+  uint32_t in_arena_ : 1;
+  uint32_t partial_ : 1;
+  uint32_t widening_ : 1;
+};
+
+// The outcome of a node for each player if each plays perfectly, once proven.
+// It is a single pointer in the node, and allocates (the equivalent of one
+// node for up to 7 players) only when set, which few nodes are.
+class SolvedOutcome {
+ public:
+  SolvedOutcome() = default;
+  SolvedOutcome(const SolvedOutcome& other) { *this = other; }
+  SolvedOutcome(SolvedOutcome&&) = default;
+  SolvedOutcome& operator=(const SolvedOutcome& other);
+  SolvedOutcome& operator=(SolvedOutcome&&) = default;
+  // An empty vector clears the outcome.
+  SolvedOutcome& operator=(const std::vector<double>& outcome);
+
+  bool empty() const { return values_ == nullptr; }
+  int size() const { return empty() ? 0 : static_cast<int>(values_[0]); }
+  double operator[](Player player) const { return values_[player + 1]; }
+  std::vector<double> ToVector() const;
+
+  bool operator==(const SolvedOutcome& other) const;
+  bool operator!=(const SolvedOutcome& other) const {
+    return !(*this == other);
+  }
+
+ private:
+  // The number of players, followed by the outcome of each.
+  std::unique_ptr<double[]> values_;
+};
+
+// Owns the arena of a tree, from its root. It is not copied along with the
+// root, since the copied children are on the heap.
+struct SearchNodeArenaOwner {
+  SearchNodeArenaOwner() = default;
+  SearchNodeArenaOwner(const SearchNodeArenaOwner&) {}
+  SearchNodeArenaOwner(SearchNodeArenaOwner&&) = default;
+  SearchNodeArenaOwner& operator=(const SearchNodeArenaOwner&) {
+    return *this;
+  }
+  SearchNodeArenaOwner& operator=(SearchNodeArenaOwner&&) = default;
+
+  std::unique_ptr<SearchNodeArena> arena;
+};
+
+// A node in the search tree for MCTS. The fields are kept narrow, and ordered
+// to avoid padding, so that a node fits in a 64 byte cache line.
 struct SearchNode {
-  Action action = 0;            // The action taken to get to this node.
-  double prior = 0;             // The prior probability of playing this action.
-  Player player = 0;            // Which player gets to make this action.
-  int explore_count = 0;        // Number of times this node was explored.
-  double total_reward = 0;      // Total reward passing through this node.
-  std::vector<double> outcome;  // The reward if each players plays perfectly.
-  std::vector<SearchNode> children;  // The successors to this state.
+  // The memory of all the descendants, for the roots returned by MCTSBot. It
+  // must be declared before the children, so it outlives them.
+  SearchNodeArenaOwner arena;
+  // The successors to this state.
+  SearchNodeChildren children;
+  SolvedOutcome outcome;  // The reward if each players plays perfectly.
+  // Total reward passing through this node. It stays a double, as a float sum
+  // would lose precision after a few million simulations.
+  CopyableAtomic<double> total_reward = 0;
+  int32_t action = 0;  // The action taken to get to this node.
+  float prior = 0;     // The prior probability of playing this action.
+  // Number of times this node was explored.
+  CopyableAtomic<int> explore_count = 0;
+  // Number of simulations going through this node that are not backed up yet.
+  // Only used by tree-parallel searches.
+  CopyableAtomic<int> virtual_loss = 0;
+  Player player = 0;  // Which player gets to make this action.
 
   SearchNode() {}
 
   SearchNode(Action action_, Player player_, double prior_)
-      : action(action_), prior(prior_), player(player_) {}
+      : action(action_), prior(prior_), player(player_) {
+    // The action is stored in 32 bits to keep the nodes small.
+    SPIEL_DCHECK_LE(action_, std::numeric_limits<int32_t>::max());
+  }
 
-  // The value as returned by the UCT formula.
-  double UCTValue(int parent_explore_count, double uct_c) const;
+  // The value as returned by the UCT formula. Each pending simulation counts as
+  // one visit returning virtual_loss_reward.
+  double UCTValue(int parent_explore_count, double uct_c,
+                  double virtual_loss_reward = 0) const;
 
-  // The value as returned by the PUCT formula.
-  double PUCTValue(int parent_explore_count, double uct_c) const;
+  // The value as returned by the PUCT formula, with the same virtual loss.
+  double PUCTValue(int parent_explore_count, double uct_c,
+                   double virtual_loss_reward = 0) const;
 
   // The sort order for the BestChild.
   bool CompareFinal(const SearchNode& b) const;
@@ -136,6 +444,51 @@ struct SearchNode {
   std::string ChildrenStr(const State& state) const;
 };
 
+// The child of the node a simulation descends to: the one with the largest
+// UCTValue or PUCTValue, the first one on ties, each pending simulation
+// counting as a visit returning virtual_loss_reward. It gives the same result
+// as comparing the values child by child, but computes the terms which only
+// depend on the parent (the log or square root of its visits) once, and reads
+// each child's counts once, which matters on wide nodes such as go's.
+SearchNode* SelectChild(SearchNode* node, ChildSelectionPolicy policy,
+                        double uct_c, double virtual_loss_reward = 0);
+
+SearchNode* SearchNodeChildren::begin() { return data_; }
+SearchNode* SearchNodeChildren::end() { return data_ + size_; }
+const SearchNode* SearchNodeChildren::begin() const { return data_; }
+const SearchNode* SearchNodeChildren::end() const { return data_ + size_; }
+SearchNode& SearchNodeChildren::operator[](int i) { return data_[i]; }
+const SearchNode& SearchNodeChildren::operator[](int i) const {
+  return data_[i];
+}
+
+template <typename It>
+void SearchNodeChildren::assign(It first, It last) {
+  clear();
+  reserve(std::distance(first, last));
+  for (; first != last; ++first) push_back(*first);
+}
+
+// Where the time of the searches of an MCTSBot went, when it is profiled. The
+// phases are timed with a few clock reads per simulation (or batch of leaves),
+// and summed over the search threads.
+struct MCTSProfile {
+  int64_t searches = 0;
+  int64_t simulations = 0;
+  absl::Duration search_time;       // The wall time of the searches.
+  absl::Duration tree_policy_time;  // Walking down and expanding the tree.
+  absl::Duration evaluation_time;   // Evaluating the leaves.
+  absl::Duration backup_time;       // Backing up their values.
+  absl::Duration gc_time;           // Garbage collecting the trees.
+  int64_t garbage_collections = 0;
+  // The nodes in the trees at the end of the searches, and the most in one
+  // tree at any point, as counted against the memory limit.
+  int64_t nodes = 0;
+  int64_t peak_nodes = 0;
+
+  MCTSProfile& operator+=(const MCTSProfile& other);
+};
+
 // A SpielBot that uses the MCTS algorithm as its policy.
 class MCTSBot : public Bot {
  public:
@@ -149,6 +502,36 @@ class MCTSBot : public Bot {
   // std::shared_ptr<Evaluator>. This is because using a
   // std::shared_ptr<Evaluator> in the constructor leads to the Julia API test
   // failing. We don't know why right now, but intend to fix this.
+  //
+  // The memory limit covers the nodes of the tree and the working states of
+  // the simulations, as measured by State::ApproximateMemoryUsage.
+  //
+  // With num_threads > 1, that many threads run the simulations of each
+  // search, as set by the parallelism policy, and the evaluator is called from
+  // all of them. With ParallelismPolicy::ROOT, the memory limit is split
+  // between the trees.
+  //
+  // With reuse_tree, Step searches with ContinueMCTSearch rather than
+  // MCTSearch.
+  //
+  // With leaf_batch_size > 1, each thread walks down that many paths before
+  // evaluating their leaves together with Evaluator::EvaluateWithPriorBatch,
+  // the virtual loss of the paths in flight spreading them out. The new leaves
+  // are then expanded straight away with the priors. This lets a single thread
+  // fill the batches of e.g. a neural network. Without batches, new leaves are
+  // only expanded straight away, with Evaluator::EvaluateWithPrior, if the
+  // evaluator EvaluatesPriorWithValue.
+  //
+  // With a finite max_time, searches also stop after running for that long,
+  // whichever comes first with max_simulations. Such timed searches check the
+  // clock every few simulations, and stop early once the most explored child
+  // of the root could not be overtaken at the current rate of simulations.
+  //
+  // With reuse_tree, the bot also provides pondering: after StartPondering on
+  // the state following its move, it keeps searching that state in another
+  // thread, with no limit on the simulations or time, until it is stopped.
+  // Most simulations go to the replies the search expects, and the subtree of
+  // the reply actually played is reused by the next step.
   MCTSBot(
       const Game& game, std::shared_ptr<Evaluator> evaluator,
       double uct_c, int max_simulations,
@@ -156,13 +539,29 @@ class MCTSBot : public Bot {
       bool solve,             // Whether to back up solved states.
       int seed, bool verbose,
       ChildSelectionPolicy child_selection_policy = ChildSelectionPolicy::UCT,
-      double dirichlet_alpha = 0, double dirichlet_epsilon = 0);
-  ~MCTSBot() = default;
+      double dirichlet_alpha = 0, double dirichlet_epsilon = 0,
+      int num_threads = 1,
+      ParallelismPolicy parallelism_policy = ParallelismPolicy::TREE,
+      bool reuse_tree = false, int leaf_batch_size = 1,
+      absl::Duration max_time = absl::InfiniteDuration());
+  ~MCTSBot() override;
 
-  void Restart() override {}
-  void RestartAt(const State& state) override {}
+  // Both drop the tree kept by ContinueMCTSearch.
+  void Restart() override;
+  void RestartAt(const State& state) override;
   // Run MCTS for one step, choosing the action, and printing some information.
   Action Step(const State& state) override;
+  // Like Step, but the search also stops at the deadline.
+  Action StepUntil(const State& state, absl::Time deadline) override;
+
+  // Stops pondering; the tree it grew is reused by the next step.
+  void InformAction(const State& state, Player player_id,
+                    Action action) override;
+
+  bool ProvidesPondering() override { return reuse_tree_; }
+  // Does nothing without reuse_tree, or if the state is terminal.
+  void StartPondering(const State& state) override;
+  void StopPondering() override;
 
   // Implements StepWithPolicy. This is equivalent to calling Step, but wraps
   // the action as an ActionsAndProbs with 100% probability assigned to the
@@ -170,10 +569,110 @@ class MCTSBot : public Bot {
   std::pair<ActionsAndProbs, Action> StepWithPolicy(
       const State& state) override;
 
-  // Run MCTS on a given state, and return the resulting search tree.
+  // Run MCTS on a given state, and return the resulting search tree. With
+  // root parallelism, only the root and its children hold the statistics of
+  // all the trees; deeper nodes are those of one of them.
   std::unique_ptr<SearchNode> MCTSearch(const State& state);
 
+  // Like MCTSearch, but the search also stops at the deadline if it is earlier
+  // than the end of max_time, e.g. to meet the deadline of a game server.
+  std::unique_ptr<SearchNode> MCTSearchUntil(const State& state,
+                                             absl::Time deadline);
+
+  // Like MCTSearch, but the bot keeps the resulting tree. If the history of
+  // the next state searched extends the one of this state, e.g. after the
+  // bot's move and the opponent's reply, the search then continues from the
+  // matching subtree rather than from scratch, adding max_simulations to the
+  // simulations it already holds. The returned root remains valid until the
+  // next search or restart.
+  //
+  // The children of a reused root keep their priors, so Dirichlet noise is
+  // only added to roots searched from scratch.
+  const SearchNode& ContinueMCTSearch(const State& state);
+  const SearchNode& ContinueMCTSearchUntil(const State& state,
+                                           absl::Time deadline);
+
+  // Starts a search of the state that the caller runs one batch of leaves at
+  // a time, evaluating the leaves itself; see SteppedSearch. The bot must
+  // outlive the search.
+  class SteppedSearch;
+  std::unique_ptr<SteppedSearch> StartSteppedSearch(const State& state);
+
+  // Whether to profile the searches, which is off by default.
+  void SetProfiling(bool profiling) { profiling_ = profiling; }
+
+  // Progressive widening, which is off (widening_c = 0) by default: the
+  // children of decision nodes other than the root are added in decreasing
+  // order of prior, a node visited n times having
+  // max(1, ceil(widening_c * n^widening_alpha)) of them. This saves creating
+  // the children of wide nodes that are never visited, e.g. in go, with both
+  // UCT and PUCT. Searches with several simulations in flight still add the
+  // children one at a time, but allocate the room for all of them at once, so
+  // that they are not moved while other simulations hold them.
+  void SetProgressiveWidening(double widening_c, double widening_alpha);
+
+  // Searches also stop, as if out of time, once stop is requested, e.g. from
+  // another thread to cancel a long search; they still run one simulation.
+  // The token must outlive the searches, and can be null to remove it.
+  void SetStopToken(const StopToken* stop) { stop_token_ = stop; }
+
+  // Steps play the best action of the book at its positions, without
+  // searching, or search as usual elsewhere. Null, the default, removes it.
+  void SetOpeningBook(std::shared_ptr<const OpeningBook> book) {
+    opening_book_ = std::move(book);
+  }
+  // Returns the profile of the searches since the last call, and resets it.
+  MCTSProfile TakeProfile();
+
  private:
+  // A search tree, and the memory it uses.
+  struct SearchTree {
+    SearchTree(std::unique_ptr<SearchNode> root, int max_nodes);
+
+    std::unique_ptr<SearchNode> root;
+    int max_nodes;  // Max nodes allowed in the tree
+    std::atomic<int> nodes;  // Nodes used in the tree.
+    int gc_limit;
+
+    // Whether several simulations can be in flight at once (several threads,
+    // or batches of leaves), using virtual loss.
+    bool virtual_loss = false;
+
+    // When the search must stop, or absl::InfiniteFuture().
+    absl::Time deadline = absl::InfiniteFuture();
+
+    // Held for reading while threads walk down the tree, and for writing while
+    // a thread expands a node or backs up solved outcomes. The counters of the
+    // nodes are atomics, which are updated without it.
+    absl::Mutex mutex;
+  };
+
+  // Searches the state from the given root, or a new one if it is null, for
+  // up to max_simulations or until the deadline.
+  std::unique_ptr<SearchNode> Search(const State& state,
+                                     std::unique_ptr<SearchNode> root,
+                                     absl::Time deadline, int max_simulations);
+
+  // Detaches the subtree of tree_ matching the state as a new root, or
+  // returns null if there is none.
+  std::unique_ptr<SearchNode> ReusableSubtree(const State& state);
+
+  // The paths of a batch of simulations and their distinct non-terminal
+  // leaves, reused from batch to batch.
+  struct LeafBatch {
+    std::vector<std::vector<SearchNode*>> visit_paths;
+    std::vector<std::unique_ptr<State>> working_states;
+    int num_paths = 0;
+    std::vector<SearchNode*> leaves;
+    std::vector<const State*> leaf_states;
+    std::vector<int> path_leaf;  // The leaf of each path, -1 if terminal.
+  };
+
+  // Runs up to max_simulations on the tree, with one thread per random
+  // generator.
+  void RunSearch(SearchTree* tree, const State& state, int max_simulations,
+                 const std::vector<Philox*>& rngs);
+
   // Applies the UCT policy to play the game until reaching a leaf node.
   //
   // A leaf node is defined as a node that is terminal or has not been evaluated
@@ -181,35 +680,164 @@ class MCTSBot : public Bot {
   // expanded, then expand it's children and continue.
   //
   // Args:
-  //   root: The root node in the search tree.
+  //   tree: The search tree.
   //   state: The state of the game at the root node.
   //   visit_path: A vector of nodes to be filled in descending from the root
   //     node to a leaf node.
-  //
-  // Returns: The state of the game at the leaf node.
-  std::unique_ptr<State> ApplyTreePolicy(SearchNode* root, const State& state,
-                                         std::vector<SearchNode*>* visit_path);
+  //   working_state: Set to the state of the game at the leaf node. It is
+  //     reused across simulations via CopyOrCloneState, so games implementing
+  //     State::CopyFrom do not allocate a new state per simulation.
+  //   rng: The random generator of the calling thread.
+  void ApplyTreePolicy(SearchTree* tree, const State& state,
+                       std::vector<SearchNode*>* visit_path,
+                       std::unique_ptr<State>* working_state,
+                       Philox* rng);
+
+  // Creates the children of a node visited for the second time (or evaluated
+  // with its prior) from the priors of its legal actions, unless another thread
+  // did it first. Must be called without holding the tree mutex.
+  void ExpandNode(SearchTree* tree, SearchNode* node, const State& state,
+                  ActionsAndProbs legal_actions, Philox* rng);
+
+  // Inserts the child of a chance node for an outcome sampled for the first
+  // time, unless another thread did it first, and returns it. Must be called
+  // without holding the tree mutex.
+  SearchNode* AddChanceChild(SearchTree* tree, SearchNode* node,
+                             Action outcome, double prob);
+
+  // Adds the children a progressively widened node is due after its visits,
+  // unless another thread did it first. Must be called without holding the
+  // tree mutex.
+  void WidenNode(SearchTree* tree, SearchNode* node);
+
+  // The number of children of a progressively widened node visited
+  // explore_count times.
+  int WideningWidth(int explore_count) const;
+
+  // Runs one simulation from the root: applies the tree policy, evaluates the
+  // leaf and backs up the values along the visited path.
+  void RunSimulation(SearchTree* tree, const State& state,
+                     std::vector<SearchNode*>* visit_path,
+                     std::unique_ptr<State>* working_state, Philox* rng,
+                     MCTSProfile* profile);
+
+  // Runs num_leaves simulations at once: applies the tree policy num_leaves
+  // times, evaluates and expands the distinct non-terminal leaves in one batch,
+  // then backs up each path.
+  void RunSimulationBatch(SearchTree* tree, const State& state, int num_leaves,
+                          LeafBatch* batch, Philox* rng, MCTSProfile* profile);
+
+  // The steps of RunSimulationBatch: applies the tree policy num_leaves times
+  // into the batch, expands its leaves with their priors, and backs up each
+  // path with the values of its leaf.
+  void SelectLeaves(SearchTree* tree, const State& state, int num_leaves,
+                    LeafBatch* batch, Philox* rng);
+  void ExpandLeaves(SearchTree* tree, const LeafBatch& batch,
+                    absl::Span<ActionsAndProbs> priors, Philox* rng);
+  void BackUpPaths(SearchTree* tree, const LeafBatch& batch,
+                   absl::Span<const std::vector<double>> values);
+
+  // Backs up the returns of a simulation along its path, and the outcome of
+  // the leaf if it is terminal.
+  void BackUp(SearchTree* tree, const std::vector<SearchNode*>& visit_path,
+              const std::vector<double>& returns, bool terminal);
+
+  void GarbageCollect(SearchTree* tree, SearchNode* node);
+  // Garbage collects a tree over its memory limit between simulations, and
+  // adds the time taken to the profile.
+  void CollectGarbage(SearchTree* tree, MCTSProfile* gc_profile);
+
+  // Adds a search that started at `start` to the profile, if profiling.
+  void ProfileSearch(absl::Time start);
 
-  void GarbageCollect(SearchNode* node);
+  // The nodes that fit in the memory limit next to the working states of the
+  // simulations, one per thread and leaf of a batch, each taking about the
+  // memory of `state`.
+  int MaxNodes(const State& state) const;
 
   double uct_c_;
   int max_simulations_;
-  int max_nodes_;  // Max nodes allowed in the tree
-  int nodes_;  // Nodes used in the tree.
-  int gc_limit_;
+  int max_nodes_;  // Max nodes allowed in the tree(s)
+  int nodes_;  // Nodes used by the last search.
   bool verbose_;
   bool solve_;
   double max_utility_;
+  double min_utility_;
   double dirichlet_alpha_;
   double dirichlet_epsilon_;
-  std::mt19937 rng_;
+  Philox rng_;
   const ChildSelectionPolicy child_selection_policy_;
   std::shared_ptr<Evaluator> evaluator_;
+  int num_threads_;
+  ParallelismPolicy parallelism_policy_;
+  bool reuse_tree_;
+  int leaf_batch_size_;
+  absl::Duration max_time_;
+  const StopToken* stop_token_ = nullptr;
+  double widening_c_ = 0;
+  double widening_alpha_ = 0;
+  std::shared_ptr<const OpeningBook> opening_book_;
+
+  // The tree of the last ContinueMCTSearch, and the history of its state.
+  std::unique_ptr<SearchNode> tree_;
+  std::vector<Action> tree_history_;
+
+  // The thread searching in the background while pondering, which owns the
+  // tree until it is joined, and the token stopping it.
+  std::unique_ptr<Thread> ponder_thread_;
+  std::unique_ptr<StopToken> ponder_stop_;
+
+  bool profiling_ = false;
+  absl::Mutex profile_mutex_;  // The search threads add to the profile.
+  MCTSProfile profile_;
+};
+
+// A search run by its caller one batch of leaves at a time, so that a single
+// thread can interleave the searches of many games and evaluate the leaves of
+// all of them together, e.g. in one batch of a neural network, rather than
+// block on the evaluation of each. A batch walks down up to leaf_batch_size
+// paths, as MCTSearch does with leaf_batch_size > 1, and the new leaves are
+// expanded with the priors returned for them. The search stops after
+// max_simulations, once the root is solved or has a single child, or once the
+// bot's stop token is stopped, without a time limit. The tree is garbage
+// collected between batches. Several searches of a bot can be run at once,
+// from one thread at a time, as they share its random generator.
+class MCTSBot::SteppedSearch {
+ public:
+  SteppedSearch(MCTSBot* bot, const State& state);
+
+  bool Done() const { return done_; }
+
+  // The states of the leaves to evaluate for the search to go on, which stay
+  // valid until Resume. Empty once the search is done.
+  const std::vector<const State*>& Leaves() const { return batch_.leaf_states; }
+
+  // Expands the leaves with their priors, which are moved from, backs up
+  // their values, one per player, and walks down the next batch of paths.
+  void Resume(absl::Span<const std::vector<double>> values,
+              absl::Span<ActionsAndProbs> priors);
+
+  // The root of the searched tree, once done.
+  std::unique_ptr<SearchNode> TakeRoot();
+
+ private:
+  // Walks down batches of paths until one has leaves to evaluate, backing up
+  // those that only reach terminal states, or until the search is done.
+  void Advance();
+
+  MCTSBot* bot_;
+  std::unique_ptr<State> state_;
+  std::unique_ptr<SearchTree> tree_;
+  LeafBatch batch_;
+  int simulations_ = 0;
+  bool done_ = false;
+  absl::Time start_;
+  MCTSProfile profile_;
 };
 
 // Returns a vector of noise sampled from a dirichlet distribution. See:
 // https://en.wikipedia.org/wiki/Dirichlet_process
-std::vector<double> dirichlet_noise(int count, double alpha, std::mt19937* rng);
+std::vector<double> dirichlet_noise(int count, double alpha, Philox* rng);
 
 }  // namespace algorithms
 }  // namespace open_spiel
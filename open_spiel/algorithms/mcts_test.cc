@@ -14,10 +14,21 @@
 
 #include "open_spiel/algorithms/mcts.h"
 
+#include <algorithm>
+#include <cmath>
+#include <future>  // NOLINT
+#include <limits>
 #include <memory>
+#include <random>
 #include <utility>
+#include <vector>
 
+#include "open_spiel/abseil-cpp/absl/algorithm/container.h"
+#include "open_spiel/abseil-cpp/absl/strings/str_split.h"
 #include "open_spiel/abseil-cpp/absl/strings/string_view.h"
+#include "open_spiel/abseil-cpp/absl/time/clock.h"
+#include "open_spiel/abseil-cpp/absl/time/time.h"
+#include "open_spiel/abseil-cpp/absl/types/span.h"
 #include "open_spiel/algorithms/evaluate_bots.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_bots.h"
@@ -156,6 +167,877 @@ void MCTSTest_GarbageCollect() {
                    root->explore_count == 1000000);
 }
 
+void MCTSTest_TreeParallelSearch() {
+  auto game = LoadGame("pig(players=2,winscore=10,horizon=20)");
+  std::unique_ptr<State> state = game->NewInitialState();
+  auto evaluator =
+      std::make_shared<open_spiel::algorithms::RandomRolloutEvaluator>(1, 42);
+  algorithms::MCTSBot bot(*game, evaluator, UCT_C,
+                          /*max_simulations=*/ 1000,
+                          /*max_memory_mb=*/ 5,
+                          /*solve=*/ false,
+                          /*seed=*/ 42,
+                          /*verbose=*/ false,
+                          algorithms::ChildSelectionPolicy::UCT,
+                          /*dirichlet_alpha=*/ 0,
+                          /*dirichlet_epsilon=*/ 0,
+                          /*num_threads=*/ 4);
+  std::unique_ptr<algorithms::SearchNode> root = bot.MCTSearch(*state);
+  SPIEL_CHECK_EQ(root->explore_count, 1000);
+  SPIEL_CHECK_EQ(root->virtual_loss, 0);
+  int children_explore_count = 0;
+  for (const algorithms::SearchNode& c : root->children) {
+    children_explore_count += c.explore_count;
+    SPIEL_CHECK_EQ(c.virtual_loss, 0);
+  }
+  // The first simulation of each thread may evaluate the root itself.
+  SPIEL_CHECK_LE(children_explore_count, 999);
+  SPIEL_CHECK_GE(children_explore_count, 1000 - 4);
+}
+
+void MCTSTest_TreeParallelSolveWin() {
+  auto game = LoadGame("tic_tac_toe");
+  std::unique_ptr<State> state = game->NewInitialState();
+  for (const auto& action_str : {"x(0,1)", "o(2,2)"}) {
+    state->ApplyAction(GetAction(*state, action_str));
+  }
+  auto evaluator =
+      std::make_shared<open_spiel::algorithms::RandomRolloutEvaluator>(20, 42);
+  for (auto policy : {algorithms::ChildSelectionPolicy::UCT,
+                      algorithms::ChildSelectionPolicy::PUCT}) {
+    algorithms::MCTSBot bot(*game, evaluator, UCT_C,
+                            /*max_simulations=*/ 10000,
+                            /*max_memory_mb=*/ 10,
+                            /*solve=*/ true,
+                            /*seed=*/ 42,
+                            /*verbose=*/ false, policy,
+                            /*dirichlet_alpha=*/ 0,
+                            /*dirichlet_epsilon=*/ 0,
+                            /*num_threads=*/ 4);
+    std::unique_ptr<algorithms::SearchNode> root = bot.MCTSearch(*state);
+    SPIEL_CHECK_EQ(root->outcome[root->player], 1);
+    const algorithms::SearchNode& best = root->BestChild();
+    SPIEL_CHECK_EQ(state->ActionToString(best.player, best.action), "x(0,2)");
+  }
+}
+
+void MCTSTest_TreeParallelGarbageCollect() {
+  auto game = LoadGame("tic_tac_toe");
+  std::unique_ptr<State> state = game->NewInitialState();
+  auto evaluator =
+      std::make_shared<open_spiel::algorithms::RandomRolloutEvaluator>(1, 42);
+  algorithms::MCTSBot bot(*game, evaluator, UCT_C,
+                          /*max_simulations=*/ 100000,
+                          /*max_memory_mb=*/ 1,
+                          /*solve=*/ false,
+                          /*seed=*/ 42,
+                          /*verbose=*/ false,
+                          algorithms::ChildSelectionPolicy::UCT,
+                          /*dirichlet_alpha=*/ 0,
+                          /*dirichlet_epsilon=*/ 0,
+                          /*num_threads=*/ 4);
+  std::unique_ptr<algorithms::SearchNode> root = bot.MCTSearch(*state);
+  SPIEL_CHECK_EQ(root->explore_count, 100000);
+}
+
+void MCTSTest_RootParallelSearch() {
+  auto game = LoadGame("pig(players=2,winscore=10,horizon=20)");
+  std::unique_ptr<State> state = game->NewInitialState();
+  auto evaluator =
+      std::make_shared<open_spiel::algorithms::RandomRolloutEvaluator>(1, 42);
+  algorithms::MCTSBot bot(*game, evaluator, UCT_C,
+                          /*max_simulations=*/ 1001,
+                          /*max_memory_mb=*/ 5,
+                          /*solve=*/ false,
+                          /*seed=*/ 42,
+                          /*verbose=*/ false,
+                          algorithms::ChildSelectionPolicy::UCT,
+                          /*dirichlet_alpha=*/ 0,
+                          /*dirichlet_epsilon=*/ 0,
+                          /*num_threads=*/ 4,
+                          algorithms::ParallelismPolicy::ROOT);
+  std::unique_ptr<algorithms::SearchNode> root = bot.MCTSearch(*state);
+  SPIEL_CHECK_EQ(root->explore_count, 1001);
+  SPIEL_CHECK_EQ(root->children.size(), state->LegalActions().size());
+  int children_explore_count = 0;
+  for (const algorithms::SearchNode& c : root->children) {
+    children_explore_count += c.explore_count;
+  }
+  // The first simulation of each tree evaluates its root.
+  SPIEL_CHECK_EQ(children_explore_count, 1001 - 4);
+}
+
+void MCTSTest_RootParallelSolveWin() {
+  auto game = LoadGame("tic_tac_toe");
+  std::unique_ptr<State> state = game->NewInitialState();
+  for (const auto& action_str : {"x(0,1)", "o(2,2)"}) {
+    state->ApplyAction(GetAction(*state, action_str));
+  }
+  auto evaluator =
+      std::make_shared<open_spiel::algorithms::RandomRolloutEvaluator>(20, 42);
+  algorithms::MCTSBot bot(*game, evaluator, UCT_C,
+                          /*max_simulations=*/ 40000,
+                          /*max_memory_mb=*/ 10,
+                          /*solve=*/ true,
+                          /*seed=*/ 42,
+                          /*verbose=*/ false,
+                          algorithms::ChildSelectionPolicy::UCT,
+                          /*dirichlet_alpha=*/ 0,
+                          /*dirichlet_epsilon=*/ 0,
+                          /*num_threads=*/ 4,
+                          algorithms::ParallelismPolicy::ROOT);
+  std::unique_ptr<algorithms::SearchNode> root = bot.MCTSearch(*state);
+  SPIEL_CHECK_EQ(root->outcome[root->player], 1);
+  const algorithms::SearchNode& best = root->BestChild();
+  SPIEL_CHECK_EQ(best.outcome[best.player], 1);
+  SPIEL_CHECK_EQ(state->ActionToString(best.player, best.action), "x(0,2)");
+}
+
+void MCTSTest_ReuseTree() {
+  auto game = LoadGame("tic_tac_toe");
+  auto evaluator =
+      std::make_shared<open_spiel::algorithms::RandomRolloutEvaluator>(1, 42);
+  algorithms::MCTSBot bot(*game, evaluator, UCT_C,
+                          /*max_simulations=*/ 1000,
+                          /*max_memory_mb=*/ 10,
+                          /*solve=*/ false,
+                          /*seed=*/ 42,
+                          /*verbose=*/ false,
+                          algorithms::ChildSelectionPolicy::UCT,
+                          /*dirichlet_alpha=*/ 0,
+                          /*dirichlet_epsilon=*/ 0,
+                          /*num_threads=*/ 1,
+                          algorithms::ParallelismPolicy::TREE,
+                          /*reuse_tree=*/ true);
+  std::unique_ptr<State> state = game->NewInitialState();
+  const algorithms::SearchNode* root = &bot.ContinueMCTSearch(*state);
+  SPIEL_CHECK_EQ(root->explore_count, 1000);
+
+  // Play the best move and the best reply, which the tree has explored.
+  const algorithms::SearchNode& move = root->BestChild();
+  const algorithms::SearchNode& reply = move.BestChild();
+  int reused_explore_count = 0;
+  for (const algorithms::SearchNode& c : reply.children) {
+    reused_explore_count += c.explore_count;
+  }
+  SPIEL_CHECK_GT(reused_explore_count, 0);
+  state->ApplyAction(move.action);
+  state->ApplyAction(reply.action);
+  root = &bot.ContinueMCTSearch(*state);
+  SPIEL_CHECK_EQ(root->explore_count, reused_explore_count + 1000);
+  SPIEL_CHECK_EQ(root->player, state->CurrentPlayer());
+
+  // Searching the same state again continues from the same tree.
+  root = &bot.ContinueMCTSearch(*state);
+  SPIEL_CHECK_EQ(root->explore_count, reused_explore_count + 2000);
+
+  // A state which does not follow from the previous one starts over.
+  root = &bot.ContinueMCTSearch(*game->NewInitialState());
+  SPIEL_CHECK_EQ(root->explore_count, 1000);
+
+  bot.Restart();
+  root = &bot.ContinueMCTSearch(*game->NewInitialState());
+  SPIEL_CHECK_EQ(root->explore_count, 1000);
+}
+
+void MCTSTest_CanPlayReusingTree() {
+  auto game = LoadGame("pig(players=2,winscore=20,horizon=30)");
+  auto evaluator =
+      std::make_shared<open_spiel::algorithms::RandomRolloutEvaluator>(5, 42);
+  algorithms::MCTSBot bot(*game, evaluator, UCT_C,
+                          /*max_simulations=*/ 100,
+                          /*max_memory_mb=*/ 5,
+                          /*solve=*/ true,
+                          /*seed=*/ 42,
+                          /*verbose=*/ false,
+                          algorithms::ChildSelectionPolicy::UCT,
+                          /*dirichlet_alpha=*/ 0,
+                          /*dirichlet_epsilon=*/ 0,
+                          /*num_threads=*/ 1,
+                          algorithms::ParallelismPolicy::TREE,
+                          /*reuse_tree=*/ true);
+  auto results =
+      EvaluateBots(game->NewInitialState().get(), {&bot, &bot}, 42);
+  SPIEL_CHECK_FLOAT_EQ(results[0] + results[1], 0);
+}
+
+void MCTSTest_ArenaMemoryLimit() {
+  auto game = LoadGame("tic_tac_toe");
+  std::unique_ptr<State> state = game->NewInitialState();
+  auto evaluator =
+      std::make_shared<open_spiel::algorithms::RandomRolloutEvaluator>(1, 42);
+  algorithms::MCTSBot bot(*game, evaluator, UCT_C,
+                          /*max_simulations=*/ 100000,
+                          /*max_memory_mb=*/ 1,
+                          /*solve=*/ false,
+                          /*seed=*/ 42,
+                          /*verbose=*/ false);
+  std::unique_ptr<algorithms::SearchNode> root = bot.MCTSearch(*state);
+  SPIEL_CHECK_EQ(root->explore_count, 100000);
+  // The tree was garbage collected and moved to new arenas along the way, so
+  // its memory is within the limit, give or take the last expansions.
+  SPIEL_CHECK_LE(root->arena.arena->ReservedBytes(), (1 << 20) * 1.1);
+}
+
+void MCTSTest_CopiesDoNotUseTheArena() {
+  auto [root, state] = SearchTicTacToeState("x(1,1) o(0,0)");
+  algorithms::SearchNode copy = *root;
+  SPIEL_CHECK_TRUE(copy.arena.arena == nullptr);
+  std::string children_str = root->ChildrenStr(*state);
+  root.reset();
+  SPIEL_CHECK_EQ(copy.ChildrenStr(*state), children_str);
+  SPIEL_CHECK_GT(copy.BestChild().children.size(), 0);
+}
+
+void MCTSTest_CompactNodes() {
+  SPIEL_CHECK_LE(sizeof(algorithms::SearchNode), 64);
+
+  algorithms::SolvedOutcome outcome;
+  SPIEL_CHECK_TRUE(outcome.empty());
+  outcome = std::vector<double>{1, -1};
+  SPIEL_CHECK_EQ(outcome.size(), 2);
+  SPIEL_CHECK_EQ(outcome[1], -1);
+  SPIEL_CHECK_TRUE(outcome.ToVector() == std::vector<double>({1, -1}));
+  algorithms::SolvedOutcome copy = outcome;
+  SPIEL_CHECK_TRUE(copy == outcome);
+  copy = std::vector<double>{-1, 1};
+  SPIEL_CHECK_TRUE(copy != outcome);
+  copy = std::vector<double>();
+  SPIEL_CHECK_TRUE(copy.empty());
+
+  // Proven outcomes and children survive copies of the tree.
+  auto [root, state] = SearchTicTacToeState("x(1,1) o(0,0) x(2,2)");
+  SPIEL_CHECK_FALSE(root->outcome.empty());
+  algorithms::SearchNode root_copy = *root;
+  SPIEL_CHECK_TRUE(root_copy.outcome == root->outcome);
+  SPIEL_CHECK_EQ(root_copy.children.size(), root->children.size());
+  for (int i = 0; i < root->children.size(); ++i) {
+    SPIEL_CHECK_EQ(root_copy.children[i].action, root->children[i].action);
+    SPIEL_CHECK_TRUE(root_copy.children[i].outcome ==
+                     root->children[i].outcome);
+  }
+}
+
+// Checks that the children of the chance nodes below a node are sorted by
+// outcome, and counts the chance nodes with some or all of the outcomes.
+void CountChanceNodes(const algorithms::SearchNode& node, int num_outcomes,
+                      int* num_partial, int* num_full) {
+  if (!node.children.empty() &&
+      node.children[0].player == kChancePlayerId) {
+    SPIEL_CHECK_TRUE(std::is_sorted(
+        node.children.begin(), node.children.end(),
+        [](const algorithms::SearchNode& a, const algorithms::SearchNode& b) {
+          return a.action < b.action;
+        }));
+    SPIEL_CHECK_LE(node.children.size(), num_outcomes);
+    if (node.children.partial()) {
+      ++*num_partial;
+    } else {
+      SPIEL_CHECK_EQ(node.children.size(), num_outcomes);
+      ++*num_full;
+    }
+  }
+  for (const algorithms::SearchNode& child : node.children) {
+    CountChanceNodes(child, num_outcomes, num_partial, num_full);
+  }
+}
+
+// Sequential searches only create the children of the chance outcomes they
+// sample, while searches with several simulations in flight create them all.
+void MCTSTest_LazyChanceExpansion() {
+  auto game = LoadGame("pig(players=2,winscore=10,horizon=20)");
+  std::unique_ptr<State> state = game->NewInitialState();
+  auto evaluator =
+      std::make_shared<open_spiel::algorithms::RandomRolloutEvaluator>(1, 42);
+  constexpr int kNumOutcomes = 6;
+  for (int num_threads : {1, 4}) {
+    algorithms::MCTSBot bot(*game, evaluator, UCT_C,
+                            /*max_simulations=*/ 2000,
+                            /*max_memory_mb=*/ 5,
+                            /*solve=*/ false,
+                            /*seed=*/ 42,
+                            /*verbose=*/ false,
+                            algorithms::ChildSelectionPolicy::UCT,
+                            /*dirichlet_alpha=*/ 0,
+                            /*dirichlet_epsilon=*/ 0, num_threads);
+    std::unique_ptr<algorithms::SearchNode> root = bot.MCTSearch(*state);
+    SPIEL_CHECK_EQ(root->explore_count, 2000);
+    int num_partial = 0;
+    int num_full = 0;
+    CountChanceNodes(*root, kNumOutcomes, &num_partial, &num_full);
+    if (num_threads == 1) {
+      SPIEL_CHECK_GT(num_partial, 0);
+    } else {
+      SPIEL_CHECK_EQ(num_partial, 0);
+      SPIEL_CHECK_GT(num_full, 0);
+    }
+
+    // The children inserted as they are sampled survive copies.
+    algorithms::SearchNode copy = *root;
+    int num_copied_partial = 0;
+    int num_copied_full = 0;
+    CountChanceNodes(copy, kNumOutcomes, &num_copied_partial,
+                     &num_copied_full);
+    SPIEL_CHECK_EQ(num_copied_partial, num_partial);
+    SPIEL_CHECK_EQ(num_copied_full, num_full);
+  }
+}
+
+// Random rollouts, with priors increasing with the actions, so that
+// progressively widened nodes add their children in decreasing order.
+class IncreasingPriorEvaluator : public algorithms::RandomRolloutEvaluator {
+ public:
+  IncreasingPriorEvaluator() : RandomRolloutEvaluator(1, 42) {}
+
+  ActionsAndProbs Prior(const State& state) override {
+    std::vector<Action> actions = state.LegalActions();
+    const double total = actions.size() * (actions.size() + 1) / 2.0;
+    ActionsAndProbs prior;
+    for (int i = 0; i < actions.size(); ++i) {
+      prior.push_back({actions[i], (i + 1) / total});
+    }
+    return prior;
+  }
+};
+
+// Checks the children of the decision nodes of the tree: the root has all of
+// them, and the other nodes those of the largest actions, as many as their
+// visits allow. Returns the number of children in the tree.
+int CheckWidenedNodes(const algorithms::SearchNode& node, const State& state,
+                      bool root, double widening_c, double widening_alpha) {
+  if (node.children.empty()) return 0;
+  std::vector<Action> actions = state.LegalActions();
+  SPIEL_CHECK_EQ(node.children.partial(),
+                 node.children.size() < actions.size());
+  if (root) {
+    SPIEL_CHECK_EQ(node.children.size(), actions.size());
+  } else {
+    SPIEL_CHECK_LE(node.children.size(),
+                   std::max(1.0, std::ceil(widening_c *
+                                           std::pow(node.explore_count,
+                                                    widening_alpha))));
+    for (int i = 0; i < node.children.size(); ++i) {
+      SPIEL_CHECK_EQ(node.children[i].action, actions[actions.size() - 1 - i]);
+    }
+  }
+  int num_children = node.children.size();
+  for (const algorithms::SearchNode& child : node.children) {
+    std::unique_ptr<State> child_state = state.Child(child.action);
+    num_children += CheckWidenedNodes(child, *child_state, false, widening_c,
+                                      widening_alpha);
+  }
+  return num_children;
+}
+
+int CountChildren(const algorithms::SearchNode& node) {
+  int num_children = node.children.size();
+  for (const algorithms::SearchNode& child : node.children) {
+    num_children += CountChildren(child);
+  }
+  return num_children;
+}
+
+void MCTSTest_ProgressiveWidening() {
+  auto game = LoadGame("hex(board_size=7)");
+  std::unique_ptr<State> state = game->NewInitialState();
+  auto evaluator = std::make_shared<IncreasingPriorEvaluator>();
+  constexpr double kWideningC = 1;
+  constexpr double kWideningAlpha = 0.5;
+  for (auto policy : {algorithms::ChildSelectionPolicy::UCT,
+                      algorithms::ChildSelectionPolicy::PUCT}) {
+    for (int num_threads : {1, 4}) {
+      auto make_bot = [&]() {
+        return std::make_unique<algorithms::MCTSBot>(
+            *game, evaluator, UCT_C,
+            /*max_simulations=*/ 2000,
+            /*max_memory_mb=*/ 10,
+            /*solve=*/ false,
+            /*seed=*/ 42,
+            /*verbose=*/ false, policy,
+            /*dirichlet_alpha=*/ 0,
+            /*dirichlet_epsilon=*/ 0, num_threads,
+            algorithms::ParallelismPolicy::TREE,
+            /*reuse_tree=*/ true);
+      };
+      std::unique_ptr<algorithms::MCTSBot> bot = make_bot();
+      bot->SetProgressiveWidening(kWideningC, kWideningAlpha);
+      const algorithms::SearchNode* root = &bot->ContinueMCTSearch(*state);
+      SPIEL_CHECK_EQ(root->explore_count, 2000);
+      const int num_children = CheckWidenedNodes(
+          *root, *state, true, kWideningC, kWideningAlpha);
+      SPIEL_CHECK_EQ(CountChildren(algorithms::SearchNode(*root)),
+                     num_children);
+
+      std::unique_ptr<algorithms::SearchNode> full_root =
+          make_bot()->MCTSearch(*state);
+      SPIEL_CHECK_LT(2 * num_children, CountChildren(*full_root));
+
+      // The root reused after the best move and reply gets all its children.
+      const algorithms::SearchNode& move = root->BestChild();
+      std::unique_ptr<State> next_state = state->Child(move.action);
+      next_state->ApplyAction(move.BestChild().action);
+      root = &bot->ContinueMCTSearch(*next_state);
+      CheckWidenedNodes(*root, *next_state, true, kWideningC, kWideningAlpha);
+    }
+  }
+}
+
+// Checks SelectChild against the values of the children compared one by one,
+// on random statistics with unvisited, pending and solved children.
+void MCTSTest_SelectChild() {
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int> count_dist(0, 20);
+  std::uniform_real_distribution<double> unit_dist(0, 1);
+  for (int trial = 0; trial < 200; ++trial) {
+    algorithms::SearchNode node;
+    node.explore_count = 1 + count_dist(rng) * 10;
+    node.virtual_loss = trial % 2 ? count_dist(rng) % 4 : 0;
+    const int num_children = 1 + count_dist(rng) * 18;
+    node.children.reserve(num_children);
+    for (int i = 0; i < num_children; ++i) {
+      algorithms::SearchNode child(i, 0, unit_dist(rng) / num_children);
+      // Leave a few children unvisited in some trials.
+      child.explore_count = count_dist(rng) + (trial % 3 ? 1 : 0);
+      if (trial % 2) child.virtual_loss = count_dist(rng) % 3;
+      child.total_reward = (2 * unit_dist(rng) - 1) * child.explore_count;
+      if (count_dist(rng) == 0) {
+        child.outcome = std::vector<double>{1, -1};
+      }
+      node.children.push_back(std::move(child));
+    }
+    const int parent_count = node.explore_count + node.virtual_loss;
+    for (auto policy : {algorithms::ChildSelectionPolicy::UCT,
+                        algorithms::ChildSelectionPolicy::PUCT}) {
+      const algorithms::SearchNode* expected = nullptr;
+      double max_value = -std::numeric_limits<double>::infinity();
+      for (const algorithms::SearchNode& child : node.children) {
+        const double value =
+            policy == algorithms::ChildSelectionPolicy::UCT
+                ? child.UCTValue(parent_count, UCT_C, /*virtual_loss_reward=*/-1)
+                : child.PUCTValue(parent_count, UCT_C, -1);
+        if (value > max_value) {
+          max_value = value;
+          expected = &child;
+        }
+      }
+      SPIEL_CHECK_EQ(algorithms::SelectChild(&node, policy, UCT_C, -1),
+                     expected);
+    }
+  }
+}
+
+void MCTSTest_ParallelRollouts() {
+  auto game = LoadGame("hex(board_size=5)");
+  std::unique_ptr<State> state = game->NewInitialState();
+  algorithms::RandomRolloutEvaluator evaluator(/*n_rollouts=*/ 1000,
+                                               /*seed=*/ 42,
+                                               /*num_threads=*/ 4);
+  std::vector<double> values = evaluator.Evaluate(*state);
+  SPIEL_CHECK_EQ(values.size(), 2);
+  SPIEL_CHECK_FLOAT_EQ(values[0] + values[1], 0);
+  SPIEL_CHECK_LE(std::abs(values[0]), 1);
+
+  // Searching threads share the rollout threads.
+  auto shared_evaluator =
+      std::make_shared<algorithms::RandomRolloutEvaluator>(20, 42, 4);
+  algorithms::MCTSBot bot(*game, shared_evaluator, UCT_C,
+                          /*max_simulations=*/ 1000,
+                          /*max_memory_mb=*/ 5,
+                          /*solve=*/ true,
+                          /*seed=*/ 42,
+                          /*verbose=*/ false,
+                          algorithms::ChildSelectionPolicy::UCT,
+                          /*dirichlet_alpha=*/ 0,
+                          /*dirichlet_epsilon=*/ 0,
+                          /*num_threads=*/ 2);
+  auto results = EvaluateBots(state.get(), {&bot, &bot}, 42);
+  SPIEL_CHECK_EQ(results[0] + results[1], 0);
+}
+
+// Counts the calls to a random rollout evaluator, which must all be batched.
+class BatchCountingEvaluator : public algorithms::RandomRolloutEvaluator {
+ public:
+  BatchCountingEvaluator() : RandomRolloutEvaluator(1, 42) {}
+
+  std::vector<double> Evaluate(const State& state) override {
+    SPIEL_CHECK_TRUE(in_batch_);
+    return RandomRolloutEvaluator::Evaluate(state);
+  }
+
+  std::vector<std::vector<double>> EvaluateBatch(
+      const std::vector<const State*>& states) override {
+    ++num_batches;
+    max_batch_size = std::max<int>(max_batch_size, states.size());
+    in_batch_ = true;
+    auto values = RandomRolloutEvaluator::EvaluateBatch(states);
+    in_batch_ = false;
+    return values;
+  }
+
+  int num_batches = 0;
+  int max_batch_size = 0;
+
+ private:
+  bool in_batch_ = false;
+};
+
+void MCTSTest_BatchedSearch() {
+  auto game = LoadGame("pig(players=2,winscore=10,horizon=20)");
+  std::unique_ptr<State> state = game->NewInitialState();
+  auto evaluator = std::make_shared<BatchCountingEvaluator>();
+  algorithms::MCTSBot bot(*game, evaluator, UCT_C,
+                          /*max_simulations=*/ 1000,
+                          /*max_memory_mb=*/ 5,
+                          /*solve=*/ false,
+                          /*seed=*/ 42,
+                          /*verbose=*/ false,
+                          algorithms::ChildSelectionPolicy::UCT,
+                          /*dirichlet_alpha=*/ 0,
+                          /*dirichlet_epsilon=*/ 0,
+                          /*num_threads=*/ 1,
+                          algorithms::ParallelismPolicy::TREE,
+                          /*reuse_tree=*/ false,
+                          /*leaf_batch_size=*/ 8);
+  std::unique_ptr<algorithms::SearchNode> root = bot.MCTSearch(*state);
+  SPIEL_CHECK_EQ(root->explore_count, 1000);
+  SPIEL_CHECK_EQ(root->virtual_loss, 0);
+  for (const algorithms::SearchNode& c : root->children) {
+    SPIEL_CHECK_EQ(c.virtual_loss, 0);
+  }
+  SPIEL_CHECK_EQ(evaluator->max_batch_size, 8);
+  // One batch per 8 simulations, but terminal leaves need no evaluation.
+  SPIEL_CHECK_LE(evaluator->num_batches, 1000 / 8);
+}
+
+// A search stepped by its caller grows the tree that MCTSearch grows with the
+// same seed and leaf batches, and several can be interleaved.
+void MCTSTest_SteppedSearch() {
+  auto game = LoadGame("pig(players=2,winscore=10,horizon=20)");
+  std::unique_ptr<State> state = game->NewInitialState();
+  auto make_bot = [&](std::shared_ptr<algorithms::Evaluator> evaluator) {
+    return std::make_unique<algorithms::MCTSBot>(
+        *game, evaluator, UCT_C,
+        /*max_simulations=*/ 500,
+        /*max_memory_mb=*/ 5,
+        /*solve=*/ false,
+        /*seed=*/ 42,
+        /*verbose=*/ false,
+        algorithms::ChildSelectionPolicy::UCT,
+        /*dirichlet_alpha=*/ 0,
+        /*dirichlet_epsilon=*/ 0,
+        /*num_threads=*/ 1,
+        algorithms::ParallelismPolicy::TREE,
+        /*reuse_tree=*/ false,
+        /*leaf_batch_size=*/ 8);
+  };
+  auto expected_evaluator = std::make_shared<BatchCountingEvaluator>();
+  std::unique_ptr<algorithms::SearchNode> expected =
+      make_bot(expected_evaluator)->MCTSearch(*state);
+
+  auto evaluator = std::make_shared<BatchCountingEvaluator>();
+  std::unique_ptr<algorithms::MCTSBot> bot = make_bot(evaluator);
+  std::unique_ptr<algorithms::MCTSBot::SteppedSearch> search =
+      bot->StartSteppedSearch(*state);
+  while (!search->Done()) {
+    std::vector<ActionsAndProbs> priors;
+    std::vector<std::vector<double>> values =
+        evaluator->EvaluateWithPriorBatch(search->Leaves(), &priors);
+    search->Resume(values, absl::MakeSpan(priors));
+  }
+  SPIEL_CHECK_TRUE(search->Leaves().empty());
+  std::unique_ptr<algorithms::SearchNode> root = search->TakeRoot();
+  SPIEL_CHECK_EQ(root->explore_count, expected->explore_count);
+  SPIEL_CHECK_EQ(root->children.size(), expected->children.size());
+  for (int i = 0; i < root->children.size(); ++i) {
+    SPIEL_CHECK_EQ(root->children[i].action, expected->children[i].action);
+    SPIEL_CHECK_EQ(root->children[i].explore_count,
+                   expected->children[i].explore_count);
+    SPIEL_CHECK_EQ(root->children[i].virtual_loss, 0);
+  }
+  SPIEL_CHECK_EQ(evaluator->num_batches, expected_evaluator->num_batches);
+
+  // The leaves of two searches of a bot are evaluated together.
+  std::unique_ptr<State> other_state = state->Child(state->LegalActions()[0]);
+  std::vector<std::unique_ptr<algorithms::MCTSBot::SteppedSearch>> searches;
+  searches.push_back(bot->StartSteppedSearch(*state));
+  searches.push_back(bot->StartSteppedSearch(*other_state));
+  while (!searches[0]->Done() || !searches[1]->Done()) {
+    std::vector<const State*> leaves;
+    for (const auto& s : searches) {
+      leaves.insert(leaves.end(), s->Leaves().begin(), s->Leaves().end());
+    }
+    std::vector<ActionsAndProbs> priors;
+    std::vector<std::vector<double>> values =
+        evaluator->EvaluateWithPriorBatch(leaves, &priors);
+    int offset = 0;
+    for (const auto& s : searches) {
+      if (s->Done()) continue;
+      const int num_leaves = s->Leaves().size();
+      s->Resume(absl::MakeConstSpan(values).subspan(offset, num_leaves),
+                absl::MakeSpan(priors).subspan(offset, num_leaves));
+      offset += num_leaves;
+    }
+  }
+  SPIEL_CHECK_EQ(searches[0]->TakeRoot()->explore_count, 500);
+  SPIEL_CHECK_EQ(searches[1]->TakeRoot()->explore_count, 500);
+}
+
+// A random rollout evaluator which must always be asked for the value and
+// prior together.
+class CombinedCountingEvaluator : public algorithms::RandomRolloutEvaluator {
+ public:
+  CombinedCountingEvaluator() : RandomRolloutEvaluator(1, 42) {}
+
+  std::vector<double> Evaluate(const State& state) override {
+    SPIEL_CHECK_TRUE(combined_);
+    return RandomRolloutEvaluator::Evaluate(state);
+  }
+
+  ActionsAndProbs Prior(const State& state) override {
+    SPIEL_CHECK_TRUE(combined_);
+    return RandomRolloutEvaluator::Prior(state);
+  }
+
+  std::vector<double> EvaluateWithPrior(const State& state,
+                                        ActionsAndProbs* prior) override {
+    ++num_calls;
+    combined_ = true;
+    auto values = RandomRolloutEvaluator::EvaluateWithPrior(state, prior);
+    combined_ = false;
+    return values;
+  }
+
+  bool EvaluatesPriorWithValue() const override { return true; }
+
+  int num_calls = 0;
+
+ private:
+  bool combined_ = false;
+};
+
+void MCTSTest_CombinedEvaluation() {
+  auto game = LoadGame("tic_tac_toe");
+  std::unique_ptr<State> state = game->NewInitialState();
+  auto evaluator = std::make_shared<CombinedCountingEvaluator>();
+  algorithms::MCTSBot bot(*game, evaluator, UCT_C,
+                          /*max_simulations=*/ 1000,
+                          /*max_memory_mb=*/ 5,
+                          /*solve=*/ false,
+                          /*seed=*/ 42,
+                          /*verbose=*/ false);
+  std::unique_ptr<algorithms::SearchNode> root = bot.MCTSearch(*state);
+  SPIEL_CHECK_EQ(root->explore_count, 1000);
+  SPIEL_CHECK_EQ(root->children.size(), 9);
+  // Each non-terminal leaf is evaluated once, and only then.
+  SPIEL_CHECK_GT(evaluator->num_calls, 0);
+  SPIEL_CHECK_LE(evaluator->num_calls, 1000);
+}
+
+void MCTSTest_BatchedSolveWin() {
+  auto game = LoadGame("tic_tac_toe");
+  std::unique_ptr<State> state = game->NewInitialState();
+  for (const auto& action_str : {"x(0,1)", "o(2,2)"}) {
+    state->ApplyAction(GetAction(*state, action_str));
+  }
+  auto evaluator =
+      std::make_shared<open_spiel::algorithms::RandomRolloutEvaluator>(20, 42);
+  for (auto policy : {algorithms::ChildSelectionPolicy::UCT,
+                      algorithms::ChildSelectionPolicy::PUCT}) {
+    algorithms::MCTSBot bot(*game, evaluator, UCT_C,
+                            /*max_simulations=*/ 10000,
+                            /*max_memory_mb=*/ 10,
+                            /*solve=*/ true,
+                            /*seed=*/ 42,
+                            /*verbose=*/ false,
+                            policy,
+                            /*dirichlet_alpha=*/ 0,
+                            /*dirichlet_epsilon=*/ 0,
+                            /*num_threads=*/ 1,
+                            algorithms::ParallelismPolicy::TREE,
+                            /*reuse_tree=*/ false,
+                            /*leaf_batch_size=*/ 16);
+    std::unique_ptr<algorithms::SearchNode> root = bot.MCTSearch(*state);
+    SPIEL_CHECK_EQ(root->outcome[root->player], 1);
+    const algorithms::SearchNode& best = root->BestChild();
+    SPIEL_CHECK_EQ(best.outcome[best.player], 1);
+    SPIEL_CHECK_EQ(state->ActionToString(best.player, best.action), "x(0,2)");
+  }
+}
+
+void MCTSTest_TimedSearch() {
+  auto game = LoadGame("pig(players=2,winscore=10,horizon=20)");
+  std::unique_ptr<State> state = game->NewInitialState();
+  auto evaluator =
+      std::make_shared<open_spiel::algorithms::RandomRolloutEvaluator>(1, 42);
+  algorithms::MCTSBot bot(*game, evaluator, UCT_C,
+                          /*max_simulations=*/ 1000000000,
+                          /*max_memory_mb=*/ 5,
+                          /*solve=*/ false,
+                          /*seed=*/ 42,
+                          /*verbose=*/ false,
+                          algorithms::ChildSelectionPolicy::UCT,
+                          /*dirichlet_alpha=*/ 0,
+                          /*dirichlet_epsilon=*/ 0,
+                          /*num_threads=*/ 1,
+                          algorithms::ParallelismPolicy::TREE,
+                          /*reuse_tree=*/ false,
+                          /*leaf_batch_size=*/ 1,
+                          /*max_time=*/ absl::Milliseconds(100));
+  absl::Time start = absl::Now();
+  std::unique_ptr<algorithms::SearchNode> root = bot.MCTSearch(*state);
+  SPIEL_CHECK_LT(absl::Now() - start, absl::Seconds(5));
+  SPIEL_CHECK_GT(root->explore_count, 1);
+  SPIEL_CHECK_GT(root->children.size(), 0);
+
+  // A deadline earlier than max_time takes precedence.
+  root = bot.MCTSearchUntil(*state, absl::Now() - absl::Seconds(1));
+  SPIEL_CHECK_EQ(root->explore_count, 1);
+
+  // So does a stop request.
+  StopToken stop;
+  stop.Stop();
+  bot.SetStopToken(&stop);
+  root = bot.MCTSearch(*state);
+  SPIEL_CHECK_EQ(root->explore_count, 1);
+}
+
+void MCTSTest_TimedSearchStopsEarly() {
+  // O has to block, all the other moves lose right away.
+  auto game = LoadGame("tic_tac_toe");
+  std::unique_ptr<State> state = game->NewInitialState();
+  for (const auto& action_str : {"x(0,0)", "o(1,1)", "x(0,1)"}) {
+    state->ApplyAction(GetAction(*state, action_str));
+  }
+  auto evaluator =
+      std::make_shared<open_spiel::algorithms::RandomRolloutEvaluator>(20, 42);
+  algorithms::MCTSBot bot(*game, evaluator, UCT_C,
+                          /*max_simulations=*/ 2000,
+                          /*max_memory_mb=*/ 5,
+                          /*solve=*/ false,
+                          /*seed=*/ 42,
+                          /*verbose=*/ false,
+                          algorithms::ChildSelectionPolicy::UCT,
+                          /*dirichlet_alpha=*/ 0,
+                          /*dirichlet_epsilon=*/ 0,
+                          /*num_threads=*/ 1,
+                          algorithms::ParallelismPolicy::TREE,
+                          /*reuse_tree=*/ false,
+                          /*leaf_batch_size=*/ 1,
+                          /*max_time=*/ absl::Seconds(60));
+  std::unique_ptr<algorithms::SearchNode> root = bot.MCTSearch(*state);
+  SPIEL_CHECK_LT(root->explore_count, 2000);
+  const algorithms::SearchNode& best = root->BestChild();
+  SPIEL_CHECK_EQ(state->ActionToString(best.player, best.action), "o(0,2)");
+}
+
+void MCTSTest_Profile() {
+  auto game = LoadGame("tic_tac_toe");
+  std::unique_ptr<State> state = game->NewInitialState();
+  auto evaluator =
+      std::make_shared<algorithms::RandomRolloutEvaluator>(1, 42);
+  for (int leaf_batch_size : {1, 4}) {
+    algorithms::MCTSBot bot(*game, evaluator, UCT_C,
+                            /*max_simulations=*/ 100,
+                            /*max_memory_mb=*/ 5,
+                            /*solve=*/ false,
+                            /*seed=*/ 42,
+                            /*verbose=*/ false,
+                            algorithms::ChildSelectionPolicy::UCT,
+                            /*dirichlet_alpha=*/ 0,
+                            /*dirichlet_epsilon=*/ 0,
+                            /*num_threads=*/ 2,
+                            algorithms::ParallelismPolicy::TREE,
+                            /*reuse_tree=*/ false, leaf_batch_size);
+    bot.MCTSearch(*state);
+    algorithms::MCTSProfile profile = bot.TakeProfile();
+    SPIEL_CHECK_EQ(profile.searches, 0);  // Not profiled by default.
+
+    bot.SetProfiling(true);
+    bot.MCTSearch(*state);
+    bot.MCTSearch(*state);
+    profile = bot.TakeProfile();
+    SPIEL_CHECK_EQ(profile.searches, 2);
+    SPIEL_CHECK_EQ(profile.simulations, 200);
+    SPIEL_CHECK_GT(profile.search_time, absl::ZeroDuration());
+    SPIEL_CHECK_GT(profile.tree_policy_time, absl::ZeroDuration());
+    SPIEL_CHECK_GT(profile.evaluation_time, absl::ZeroDuration());
+    SPIEL_CHECK_GT(profile.backup_time, absl::ZeroDuration());
+    // Summed over both threads.
+    SPIEL_CHECK_LE(profile.tree_policy_time + profile.evaluation_time +
+                       profile.backup_time,
+                   2 * profile.search_time);
+
+    SPIEL_CHECK_EQ(bot.TakeProfile().simulations, 0);
+  }
+}
+
+void MCTSTest_Pondering() {
+  auto game = LoadGame("tic_tac_toe");
+  auto evaluator =
+      std::make_shared<open_spiel::algorithms::RandomRolloutEvaluator>(1, 42);
+  algorithms::MCTSBot bot(*game, evaluator, UCT_C,
+                          /*max_simulations=*/ 100,
+                          /*max_memory_mb=*/ 10,
+                          /*solve=*/ false,
+                          /*seed=*/ 42,
+                          /*verbose=*/ false,
+                          algorithms::ChildSelectionPolicy::UCT,
+                          /*dirichlet_alpha=*/ 0,
+                          /*dirichlet_epsilon=*/ 0,
+                          /*num_threads=*/ 1,
+                          algorithms::ParallelismPolicy::TREE,
+                          /*reuse_tree=*/ true);
+  SPIEL_CHECK_TRUE(bot.ProvidesPondering());
+  bot.StopPondering();  // Does nothing when not pondering.
+
+  std::unique_ptr<State> state = game->NewInitialState();
+  state->ApplyAction(bot.Step(*state));
+  bot.StartPondering(*state);
+  absl::SleepFor(absl::Milliseconds(200));
+
+  // Without pondering, the reply would hold fewer than the 100 simulations of
+  // the first step.
+  const Action reply = state->LegalActions()[0];
+  bot.InformAction(*state, state->CurrentPlayer(), reply);
+  state->ApplyAction(reply);
+  const algorithms::SearchNode& root = bot.ContinueMCTSearch(*state);
+  SPIEL_CHECK_GT(root.explore_count, 300);
+
+  // Restarting or destroying the bot stops it from pondering.
+  state->ApplyAction(root.BestChild().action);
+  bot.StartPondering(*state);
+  bot.Restart();
+  bot.StartPondering(*state);
+}
+
+void MCTSTest_StartStep() {
+  auto game = LoadGame("tic_tac_toe");
+  std::unique_ptr<State> state = game->NewInitialState();
+  auto evaluator =
+      std::make_shared<open_spiel::algorithms::RandomRolloutEvaluator>(1, 42);
+  algorithms::MCTSBot bot(*game, evaluator, UCT_C,
+                          /*max_simulations=*/ 1000000000,
+                          /*max_memory_mb=*/ 10,
+                          /*solve=*/ false,
+                          /*seed=*/ 42,
+                          /*verbose=*/ false);
+  SPIEL_CHECK_FALSE(bot.ProvidesPondering());
+  bot.StartPondering(*state);  // Does nothing without reuse_tree.
+
+  // The state can change while the bot is thinking about its copy.
+  std::future<Action> action =
+      bot.StartStep(*state, absl::Now() + absl::Milliseconds(50));
+  state->ApplyAction(state->LegalActions()[0]);
+  SPIEL_CHECK_TRUE(absl::c_linear_search(
+      game->NewInitialState()->LegalActions(), action.get()));
+
+  // Bots which cannot stop early step as usual.
+  std::unique_ptr<Bot> random_bot = MakeUniformRandomBot(1, 42);
+  action = random_bot->StartStep(*state, absl::Now() - absl::Seconds(1));
+  SPIEL_CHECK_TRUE(
+      absl::c_linear_search(state->LegalActions(), action.get()));
+}
+
 }  // namespace
 }  // namespace open_spiel
 
@@ -168,4 +1050,27 @@ int main(int argc, char** argv) {
   open_spiel::MCTSTest_SolveLoss();
   open_spiel::MCTSTest_SolveWin();
   open_spiel::MCTSTest_GarbageCollect();
+  open_spiel::MCTSTest_TreeParallelSearch();
+  open_spiel::MCTSTest_TreeParallelSolveWin();
+  open_spiel::MCTSTest_TreeParallelGarbageCollect();
+  open_spiel::MCTSTest_RootParallelSearch();
+  open_spiel::MCTSTest_RootParallelSolveWin();
+  open_spiel::MCTSTest_ReuseTree();
+  open_spiel::MCTSTest_CanPlayReusingTree();
+  open_spiel::MCTSTest_ArenaMemoryLimit();
+  open_spiel::MCTSTest_CopiesDoNotUseTheArena();
+  open_spiel::MCTSTest_CompactNodes();
+  open_spiel::MCTSTest_SelectChild();
+  open_spiel::MCTSTest_LazyChanceExpansion();
+  open_spiel::MCTSTest_ProgressiveWidening();
+  open_spiel::MCTSTest_ParallelRollouts();
+  open_spiel::MCTSTest_BatchedSearch();
+  open_spiel::MCTSTest_SteppedSearch();
+  open_spiel::MCTSTest_BatchedSolveWin();
+  open_spiel::MCTSTest_CombinedEvaluation();
+  open_spiel::MCTSTest_TimedSearch();
+  open_spiel::MCTSTest_TimedSearchStopsEarly();
+  open_spiel::MCTSTest_Profile();
+  open_spiel::MCTSTest_Pondering();
+  open_spiel::MCTSTest_StartStep();
 }
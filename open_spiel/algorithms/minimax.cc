@@ -15,16 +15,54 @@
 #include "open_spiel/algorithms/minimax.h"
 
 #include <algorithm>  // std::max
+#include <cstdint>
+#include <functional>
 #include <limits>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
 
+#include "open_spiel/abseil-cpp/absl/time/clock.h"
+#include "open_spiel/abseil-cpp/absl/time/time.h"
 #include "open_spiel/games/tic_tac_toe.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/thread.h"
 
 namespace open_spiel {
 namespace algorithms {
 namespace {
 
+// How many states AlphaBetaSearcher visits between two looks at the clock.
+constexpr int kStatesBetweenTimeChecks = 1024;
+
+// Checks that the game is a deterministic, 2-players, perfect-information
+// 0-sum game.
+void CheckGame(const Game& game) {
+  if (game.NumPlayers() != 2) {
+    SpielFatalError("Game must be a 2-player game");
+  }
+  GameType game_info = game.GetType();
+  if (game_info.chance_mode != GameType::ChanceMode::kDeterministic) {
+    SpielFatalError(absl::StrCat("The game must be a Deterministic one, not ",
+                                 game_info.chance_mode));
+  }
+  if (game_info.information != GameType::Information::kPerfectInformation) {
+    SpielFatalError(
+        absl::StrCat("The game must be a perfect information one, not ",
+                     game_info.information));
+  }
+  if (game_info.dynamics != GameType::Dynamics::kSequential) {
+    SpielFatalError(
+        absl::StrCat("The game must be turn-based, not ", game_info.dynamics));
+  }
+  if (game_info.utility != GameType::Utility::kZeroSum) {
+    SpielFatalError(
+        absl::StrCat("The game must be 0-sum, not  ", game_info.utility));
+  }
+}
+
 // An alpha-beta algorithm.
 //
 // Implements a min-max algorithm with alpha-beta pruning.
@@ -121,27 +159,7 @@ std::pair<double, Action> AlphaBetaSearch(
     const Game& game, const State* state,
     std::function<double(const State&)> value_function, int depth_limit,
     Player maximizing_player) {
-  if (game.NumPlayers() != 2) {
-    SpielFatalError("Game must be a 2-player game");
-  }
-  GameType game_info = game.GetType();
-  if (game_info.chance_mode != GameType::ChanceMode::kDeterministic) {
-    SpielFatalError(absl::StrCat("The game must be a Deterministic one, not ",
-                                 game_info.chance_mode));
-  }
-  if (game_info.information != GameType::Information::kPerfectInformation) {
-    SpielFatalError(
-        absl::StrCat("The game must be a perfect information one, not ",
-                     game_info.information));
-  }
-  if (game_info.dynamics != GameType::Dynamics::kSequential) {
-    SpielFatalError(
-        absl::StrCat("The game must be turn-based, not ", game_info.dynamics));
-  }
-  if (game_info.utility != GameType::Utility::kZeroSum) {
-    SpielFatalError(
-        absl::StrCat("The game must be 0-sum, not  ", game_info.utility));
-  }
+  CheckGame(game);
 
   std::unique_ptr<State> search_root;
   if (state == nullptr) {
@@ -163,5 +181,288 @@ std::pair<double, Action> AlphaBetaSearch(
   return std::pair<double, Action>(value, best_action);
 }
 
+AlphaBetaSearcher::AlphaBetaSearcher(
+    const Game& game, std::function<double(const State&)> value_function,
+    int64_t max_memory_mb, int num_threads)
+    : value_function_(std::move(value_function)),
+      table_locks_(kNumTableLocks),
+      workers_(num_threads) {
+  CheckGame(game);
+  SPIEL_CHECK_GT(max_memory_mb, 0);
+  SPIEL_CHECK_GE(num_threads, 1);
+  // The table has a power of two entries, to index it by the low bits of the
+  // hashes.
+  const int64_t max_entries = (max_memory_mb << 20) / sizeof(TableEntry);
+  int64_t num_entries = 1;
+  while (num_entries * 2 <= max_entries) num_entries *= 2;
+  table_.resize(num_entries);
+  for (Worker& worker : workers_) {
+    worker.history.assign(game.NumPlayers(),
+                          std::vector<int64_t>(game.NumDistinctActions(), 0));
+  }
+}
+
+void AlphaBetaSearcher::Clear() {
+  std::fill(table_.begin(), table_.end(), TableEntry());
+  for (Worker& worker : workers_) {
+    worker.killers.clear();
+    for (std::vector<int64_t>& scores : worker.history) {
+      std::fill(scores.begin(), scores.end(), 0);
+    }
+  }
+}
+
+int64_t AlphaBetaSearcher::NumStatesVisited() const {
+  int64_t num_states_visited = 0;
+  for (const Worker& worker : workers_) {
+    num_states_visited += worker.num_states_visited;
+  }
+  return num_states_visited;
+}
+
+std::pair<double, Action> AlphaBetaSearcher::Search(
+    const State& state, int depth_limit, double time_limit_seconds) {
+  SPIEL_CHECK_FALSE(state.IsTerminal());
+  SPIEL_CHECK_NE(depth_limit, 0);
+  deadline_ = time_limit_seconds > 0
+                  ? absl::Now() + absl::Seconds(time_limit_seconds)
+                  : absl::InfiniteFuture();
+  last_depth_ = 0;
+  last_search_solved_ = false;
+  for (Worker& worker : workers_) worker.num_states_visited = 0;
+  search_done_ = false;
+  std::vector<Thread> threads;
+  for (int i = 1; i < workers_.size(); ++i) {
+    threads.emplace_back([this, &state, depth_limit, i]() {
+      HelpSearch(state, depth_limit, /*first_depth=*/1 + i % 2, &workers_[i]);
+    });
+  }
+
+  Worker* worker = &workers_[0];
+  std::unique_ptr<State> root = state.Clone();
+  const double infinity = std::numeric_limits<double>::infinity();
+  std::pair<double, Action> value_and_action(0, kInvalidAction);
+  for (int depth = 1; depth_limit < 0 || depth <= depth_limit; ++depth) {
+    if (depth > 1 && stop_token_ != nullptr && stop_token_->StopRequested()) {
+      break;
+    }
+    worker->can_stop = depth > 1;
+    worker->stopped = false;
+    bool solved = true;
+    const double value = AlphaBeta(root.get(), depth, -infinity, infinity,
+                                   /*ply=*/0, &solved, worker);
+    if (worker->stopped) break;
+    value_and_action = {value, worker->root_action};
+    last_depth_ = depth;
+    last_search_solved_ = solved;
+    if (solved) break;
+  }
+
+  search_done_ = true;
+  for (Thread& thread : threads) thread.join();
+  return value_and_action;
+}
+
+void AlphaBetaSearcher::HelpSearch(const State& state, int depth_limit,
+                                   int first_depth, Worker* worker) {
+  std::unique_ptr<State> root = state.Clone();
+  const double infinity = std::numeric_limits<double>::infinity();
+  worker->can_stop = true;
+  worker->stopped = false;
+  for (int depth = first_depth; depth_limit < 0 || depth <= depth_limit;
+       ++depth) {
+    bool solved = true;
+    AlphaBeta(root.get(), depth, -infinity, infinity, /*ply=*/0, &solved,
+              worker);
+    if (worker->stopped || solved) return;
+  }
+}
+
+double AlphaBetaSearcher::AlphaBeta(State* state, int depth, double alpha,
+                                    double beta, int ply, bool* solved,
+                                    Worker* worker) {
+  ++worker->num_states_visited;
+  if (worker->can_stop) {
+    if (worker != &workers_[0]) {
+      if (search_done_) worker->stopped = true;
+    } else if (worker->num_states_visited % kStatesBetweenTimeChecks == 0 &&
+               (absl::Now() > deadline_ ||
+                (stop_token_ != nullptr && stop_token_->StopRequested()))) {
+      worker->stopped = true;
+    }
+  }
+  if (worker->stopped) return 0;
+
+  // The entry may be replaced while searching below, so it is read now, and
+  // looked up again to be updated. The value of the root is always searched,
+  // for its best action.
+  const uint64_t hash = state->HashValue();
+  const int64_t index = hash & (table_.size() - 1);
+  absl::Mutex* lock = &table_locks_[index % kNumTableLocks];
+  TableEntry entry;
+  {
+    absl::MutexLock table_lock(lock);
+    entry = table_[index];
+  }
+  Action table_action = kInvalidAction;
+  if (entry.depth >= 0 && entry.hash == hash) {
+    table_action = entry.action;
+    if (ply > 0 && entry.depth >= depth &&
+        (entry.bound == Bound::kExact ||
+         (entry.bound == Bound::kLower && entry.value >= beta) ||
+         (entry.bound == Bound::kUpper && entry.value <= alpha))) {
+      if (entry.depth != kSolvedDepth) *solved = false;
+      return entry.value;
+    }
+  }
+
+  if (oracle_ && ply > 0) {
+    std::optional<double> value = oracle_(*state);
+    if (value.has_value()) return *value;
+  }
+
+  if (depth == 0) {
+    *solved = false;
+    return value_function_ ? value_function_(*state) : 0;
+  }
+
+  const Player player = state->CurrentPlayer();
+  const double original_alpha = alpha;
+  double best_value = -std::numeric_limits<double>::infinity();
+  Action best_action = kInvalidAction;
+  bool all_solved = true;
+  for (Action action : OrderedActions(*state, table_action, ply, worker)) {
+    state->ApplyAction(action);
+    double value;
+    bool child_solved = true;
+    if (state->IsTerminal()) {
+      value = state->PlayerReturn(player);
+    } else if (state->CurrentPlayer() == player) {
+      value = AlphaBeta(state, depth - 1, alpha, beta, ply + 1, &child_solved,
+                        worker);
+    } else {
+      value = -AlphaBeta(state, depth - 1, -beta, -alpha, ply + 1,
+                         &child_solved, worker);
+    }
+    state->UndoAction(player, action);
+    if (worker->stopped) return 0;
+
+    all_solved = all_solved && child_solved;
+    if (value > best_value) {
+      best_value = value;
+      best_action = action;
+      if (ply == 0) worker->root_action = action;
+    }
+    alpha = std::max(alpha, value);
+    if (alpha >= beta) {
+      AddCutoff(player, action, depth, ply, worker);
+      break;
+    }
+  }
+  if (!all_solved) *solved = false;
+
+  const int searched_depth = all_solved ? kSolvedDepth : depth;
+  absl::MutexLock table_lock(lock);
+  TableEntry& new_entry = table_[index];
+  if (new_entry.hash != hash || searched_depth >= new_entry.depth) {
+    new_entry.hash = hash;
+    new_entry.value = best_value;
+    new_entry.action = best_action;
+    new_entry.depth = searched_depth;
+    new_entry.bound = best_value <= original_alpha ? Bound::kUpper
+                      : best_value >= beta         ? Bound::kLower
+                                                   : Bound::kExact;
+  }
+  return best_value;
+}
+
+std::vector<Action> AlphaBetaSearcher::OrderedActions(const State& state,
+                                                      Action table_action,
+                                                      int ply,
+                                                      Worker* worker) const {
+  std::vector<std::array<Action, 2>>& killers = worker->killers;
+  if (ply >= killers.size()) {
+    killers.resize(ply + 1, {kInvalidAction, kInvalidAction});
+  }
+  const std::vector<int64_t>& history = worker->history[state.CurrentPlayer()];
+  const int64_t max_score = std::numeric_limits<int64_t>::max();
+  std::vector<std::pair<int64_t, Action>> scored_actions;
+  for (Action action : state.LegalActions()) {
+    int64_t score = history[action];
+    if (action == table_action) {
+      score = max_score;
+    } else if (action == killers[ply][0]) {
+      score = max_score - 1;
+    } else if (action == killers[ply][1]) {
+      score = max_score - 2;
+    }
+    scored_actions.push_back({score, action});
+  }
+  std::stable_sort(scored_actions.begin(), scored_actions.end(),
+                   [](const std::pair<int64_t, Action>& a,
+                      const std::pair<int64_t, Action>& b) {
+                     return a.first > b.first;
+                   });
+  std::vector<Action> actions;
+  actions.reserve(scored_actions.size());
+  for (const auto& [score, action] : scored_actions) actions.push_back(action);
+  return actions;
+}
+
+void AlphaBetaSearcher::AddCutoff(Player player, Action action, int depth,
+                                  int ply, Worker* worker) const {
+  std::array<Action, 2>& killers = worker->killers[ply];
+  if (killers[0] != action) {
+    killers[1] = killers[0];
+    killers[0] = action;
+  }
+  worker->history[player][action] += static_cast<int64_t>(depth) * depth;
+}
+
+namespace {
+
+class AlphaBetaBot : public Bot {
+ public:
+  AlphaBetaBot(const Game& game,
+               std::function<double(const State&)> value_function,
+               int depth_limit, double time_limit_seconds,
+               int64_t max_memory_mb, int num_threads)
+      : searcher_(game, std::move(value_function), max_memory_mb,
+                  num_threads),
+        depth_limit_(depth_limit),
+        time_limit_seconds_(time_limit_seconds) {}
+
+  void Restart() override { searcher_.Clear(); }
+  void RestartAt(const State& state) override { Restart(); }
+  Action Step(const State& state) override {
+    return searcher_.Search(state, depth_limit_, time_limit_seconds_).second;
+  }
+  bool ProvidesPolicy() override { return true; }
+  ActionsAndProbs GetPolicy(const State& state) override {
+    return StepWithPolicy(state).first;
+  }
+  std::pair<ActionsAndProbs, Action> StepWithPolicy(
+      const State& state) override {
+    const Action action = Step(state);
+    return {{{action, 1.0}}, action};
+  }
+
+ private:
+  AlphaBetaSearcher searcher_;
+  const int depth_limit_;
+  const double time_limit_seconds_;
+};
+
+}  // namespace
+
+std::unique_ptr<Bot> MakeAlphaBetaBot(
+    const Game& game, std::function<double(const State&)> value_function,
+    int depth_limit, double time_limit_seconds, int64_t max_memory_mb,
+    int num_threads) {
+  return std::make_unique<AlphaBetaBot>(game, std::move(value_function),
+                                        depth_limit, time_limit_seconds,
+                                        max_memory_mb, num_threads);
+}
+
 }  // namespace algorithms
 }  // namespace open_spiel
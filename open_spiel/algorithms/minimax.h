@@ -15,10 +15,21 @@
 #ifndef OPEN_SPIEL_ALGORITHMS_MINMAX_H_
 #define OPEN_SPIEL_ALGORITHMS_MINMAX_H_
 
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <limits>
 #include <memory>
+#include <optional>
 #include <utility>
+#include <vector>
 
+#include "open_spiel/abseil-cpp/absl/synchronization/mutex.h"
+#include "open_spiel/abseil-cpp/absl/time/time.h"
 #include "open_spiel/spiel.h"
+#include "open_spiel/spiel_bots.h"
+#include "open_spiel/utils/thread.h"
 
 namespace open_spiel {
 namespace algorithms {
@@ -49,6 +60,147 @@ std::pair<double, Action> AlphaBetaSearch(
     std::function<double(const State&)> value_function, int depth_limit,
     Player maximizing_player);
 
+// An alpha-beta search for playing the same games when they are too large to
+// solve: it searches with iterative deepening, until a depth or time limit,
+// keeping the values and best actions of the states it searched in a
+// transposition table, and ordering the actions it tries first by the best
+// action from the table, then by killer actions (the last two actions that
+// caused a cut-off at the same depth) and then by the history heuristic (how
+// much each action of each player caused cut-offs so far).
+//
+// The table and the heuristics are kept from one search to the next, until
+// Clear(). States are identified by State::HashValue() in the table, so the
+// transpositions the hash recognizes share their entry, and collisions
+// between different states are not detected. The table has a fixed size,
+// and an entry is replaced by any other state, or by the same state searched
+// at least as deep.
+//
+// Values are for the player to move at the state searched, and, as for
+// AlphaBetaSearch, the actions are tried and taken back with
+// State::UndoAction. A player may play several times in a row.
+//
+// With num_threads, the search is parallelized as in Lazy SMP: the other
+// threads run the same iterative deepening, every other one a depth ahead,
+// with their own heuristics but sharing the table, which they fill with
+// entries the main thread then finds. Their results are not used otherwise,
+// and they stop when the main thread does. The table is guarded by a fixed
+// number of locks, and value_function is then called concurrently.
+class AlphaBetaSearcher {
+ public:
+  // value_function gives the value of a non-terminal state for the player to
+  // move there, when it is reached at the depth of an iteration. Without it,
+  // such states are worth 0, and only the states which were searched to the
+  // end of the game have their real value.
+  AlphaBetaSearcher(const Game& game,
+                    std::function<double(const State&)> value_function,
+                    int64_t max_memory_mb = 64, int num_threads = 1);
+
+  // Searches the state with iterative deepening, up to depth_limit plies
+  // (without limit if it is negative), until the value of the state is known
+  // exactly or time_limit_seconds have passed (without limit if it is not
+  // positive). The first iteration, to depth 1, is always completed. Returns
+  // the value of the state and its best action, from the last iteration which
+  // was completed.
+  std::pair<double, Action> Search(const State& state, int depth_limit,
+                                   double time_limit_seconds = 0);
+
+  // Forgets the table and the heuristics.
+  void Clear();
+
+  // An oracle gives the exact value of the states it knows, for the player to
+  // move, or nothing for the others: those it knows are not searched, at any
+  // depth but the root's (see e.g. EndgameTablebaseOracle). It is called
+  // concurrently with num_threads.
+  void SetOracle(std::function<std::optional<double>(const State&)> oracle) {
+    oracle_ = std::move(oracle);
+  }
+
+  // Searches also stop, as if out of time, once stop is requested, e.g. from
+  // another thread to cancel a long search. The token must outlive the
+  // searches, and can be null to remove it.
+  void SetStopToken(const StopToken* stop) { stop_token_ = stop; }
+
+  // The depth of the last iteration completed by the last search, whether the
+  // value it found is exact, and the number of states it visited, on all the
+  // threads.
+  int LastDepth() const { return last_depth_; }
+  bool LastSearchSolved() const { return last_search_solved_; }
+  int64_t NumStatesVisited() const;
+
+ private:
+  enum class Bound : int8_t { kExact, kLower, kUpper };
+
+  struct TableEntry {
+    uint64_t hash = 0;
+    double value = 0;
+    Action action = kInvalidAction;
+    // The depth searched below the state, or kSolvedDepth if the search went
+    // to the end of the game everywhere, or -1 for an empty entry.
+    int depth = -1;
+    Bound bound = Bound::kExact;
+  };
+
+  static constexpr int kSolvedDepth = std::numeric_limits<int>::max();
+  static constexpr int kNumTableLocks = 1024;
+
+  // What each thread searching keeps.
+  struct Worker {
+    // Two killer actions for each ply, and a history score for each action of
+    // each player.
+    std::vector<std::array<Action, 2>> killers;
+    std::vector<std::vector<int64_t>> history;
+
+    // The state of the current search. Only the main thread looks at the
+    // clock, and can stop the others.
+    bool can_stop = false;
+    bool stopped = false;
+    Action root_action = kInvalidAction;
+    int64_t num_states_visited = 0;
+  };
+
+  // Runs the iterative deepening of a helper thread, starting at
+  // first_depth, until the main thread is done.
+  void HelpSearch(const State& state, int depth_limit, int first_depth,
+                  Worker* worker);
+
+  // Returns the value of a non-terminal state for the player to move, if it is
+  // in (alpha, beta), or else a bound on it beyond them. Sets solved to false
+  // if the value depends on states at the depth limit.
+  double AlphaBeta(State* state, int depth, double alpha, double beta, int ply,
+                   bool* solved, Worker* worker);
+
+  // The legal actions of a state, in the order to try them.
+  std::vector<Action> OrderedActions(const State& state, Action table_action,
+                                     int ply, Worker* worker) const;
+
+  // Records that this action caused a cut-off.
+  void AddCutoff(Player player, Action action, int depth, int ply,
+                 Worker* worker) const;
+
+  std::function<double(const State&)> value_function_;
+  std::function<std::optional<double>(const State&)> oracle_;
+  const StopToken* stop_token_ = nullptr;
+  std::vector<TableEntry> table_;
+  std::vector<absl::Mutex> table_locks_;
+
+  // The main thread first.
+  std::vector<Worker> workers_;
+
+  // The state of the current search.
+  absl::Time deadline_;
+  std::atomic<bool> search_done_{false};
+
+  int last_depth_ = 0;
+  bool last_search_solved_ = false;
+};
+
+// A bot playing the action found by an AlphaBetaSearcher with these
+// arguments, keeping its table from one move to the next until restarted.
+std::unique_ptr<Bot> MakeAlphaBetaBot(
+    const Game& game, std::function<double(const State&)> value_function,
+    int depth_limit, double time_limit_seconds, int64_t max_memory_mb = 64,
+    int num_threads = 1);
+
 }  // namespace algorithms
 }  // namespace open_spiel
 
@@ -14,10 +14,17 @@
 
 #include "open_spiel/algorithms/minimax.h"
 
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
 
+#include "open_spiel/algorithms/evaluate_bots.h"
 #include "open_spiel/games/tic_tac_toe.h"
 #include "open_spiel/spiel.h"
+#include "open_spiel/spiel_bots.h"
 #include "open_spiel/spiel_utils.h"
 
 namespace open_spiel {
@@ -64,6 +71,130 @@ void AlphaBetaSearchTest_TicTacToe_Loss() {
   SPIEL_CHECK_EQ(-1.0, value_and_action.first);
 }
 
+// The searcher solves the same positions, reusing its table between them.
+void AlphaBetaSearcherTest_TicTacToe() {
+  std::shared_ptr<const Game> game = LoadGame("tic_tac_toe");
+  AlphaBetaSearcher searcher(*game, /*value_function=*/nullptr,
+                             /*max_memory_mb=*/1);
+  std::unique_ptr<State> state = game->NewInitialState();
+  while (!state->IsTerminal()) {
+    const auto [value, action] = searcher.Search(*state, /*depth_limit=*/-1);
+    SPIEL_CHECK_TRUE(searcher.LastSearchSolved());
+    SPIEL_CHECK_EQ(value, AlphaBetaSearch(*game, state.get(), {}, -1,
+                                          kInvalidPlayer)
+                              .first);
+    const std::vector<Action> legal_actions = state->LegalActions();
+    SPIEL_CHECK_TRUE(std::find(legal_actions.begin(), legal_actions.end(),
+                               action) != legal_actions.end());
+    // Optimal play from the start is a draw.
+    SPIEL_CHECK_EQ(value, 0);
+    state->ApplyAction(action);
+  }
+  SPIEL_CHECK_EQ(state->PlayerReturn(0), 0);
+
+  // Without a table or heuristics, the same search visits more states.
+  state = game->NewInitialState();
+  searcher.Clear();
+  searcher.Search(*state, /*depth_limit=*/-1);
+  const int64_t num_states_visited = searcher.NumStatesVisited();
+  searcher.Search(*state, /*depth_limit=*/-1);
+  SPIEL_CHECK_LT(searcher.NumStatesVisited(), num_states_visited);
+}
+
+void AlphaBetaSearcherTest_TicTacToe_Loss() {
+  std::shared_ptr<const Game> game = LoadGame("tic_tac_toe");
+  std::unique_ptr<State> state = game->NewInitialState();
+  for (Action action : {5, 4, 3, 8}) state->ApplyAction(action);
+  AlphaBetaSearcher searcher(*game, /*value_function=*/nullptr);
+  SPIEL_CHECK_EQ(searcher.Search(*state, /*depth_limit=*/-1).first, -1.0);
+  SPIEL_CHECK_TRUE(searcher.LastSearchSolved());
+}
+
+// In a game too large to solve, the search stops at the depth limit, or when
+// time is up.
+void AlphaBetaSearcherTest_ConnectFour() {
+  std::shared_ptr<const Game> game = LoadGame("connect_four");
+  AlphaBetaSearcher searcher(*game, /*value_function=*/nullptr);
+  std::unique_ptr<State> state = game->NewInitialState();
+  std::pair<double, Action> value_and_action =
+      searcher.Search(*state, /*depth_limit=*/4);
+  SPIEL_CHECK_EQ(searcher.LastDepth(), 4);
+  SPIEL_CHECK_FALSE(searcher.LastSearchSolved());
+  SPIEL_CHECK_NE(value_and_action.second, kInvalidAction);
+
+  value_and_action = searcher.Search(*state, /*depth_limit=*/-1,
+                                     /*time_limit_seconds=*/0.2);
+  SPIEL_CHECK_GE(searcher.LastDepth(), 1);
+  SPIEL_CHECK_FALSE(searcher.LastSearchSolved());
+  SPIEL_CHECK_NE(value_and_action.second, kInvalidAction);
+}
+
+// A stop request ends the search after the first iteration, on all threads.
+void AlphaBetaSearcherTest_StopToken() {
+  std::shared_ptr<const Game> game = LoadGame("connect_four");
+  AlphaBetaSearcher searcher(*game, /*value_function=*/nullptr,
+                             /*max_memory_mb=*/8, /*num_threads=*/2);
+  StopToken stop;
+  stop.Stop();
+  searcher.SetStopToken(&stop);
+  std::unique_ptr<State> state = game->NewInitialState();
+  const std::pair<double, Action> value_and_action =
+      searcher.Search(*state, /*depth_limit=*/-1);
+  SPIEL_CHECK_EQ(searcher.LastDepth(), 1);
+  SPIEL_CHECK_NE(value_and_action.second, kInvalidAction);
+}
+
+// The threads share the table, and only the main one's result is used, so it
+// finds the same values.
+void AlphaBetaSearcherTest_TicTacToe_Threads() {
+  std::shared_ptr<const Game> game = LoadGame("tic_tac_toe");
+  AlphaBetaSearcher searcher(*game, /*value_function=*/nullptr,
+                             /*max_memory_mb=*/1, /*num_threads=*/4);
+  std::unique_ptr<State> state = game->NewInitialState();
+  SPIEL_CHECK_EQ(searcher.Search(*state, /*depth_limit=*/-1).first, 0);
+  SPIEL_CHECK_TRUE(searcher.LastSearchSolved());
+  state->ApplyAction(4);
+  state->ApplyAction(1);
+  SPIEL_CHECK_EQ(searcher.Search(*state, /*depth_limit=*/-1).first, 1);
+  SPIEL_CHECK_TRUE(searcher.LastSearchSolved());
+}
+
+// A bot solving tic-tac-toe never loses to a random one.
+void AlphaBetaBotTest_TicTacToe() {
+  std::shared_ptr<const Game> game = LoadGame("tic_tac_toe");
+  std::unique_ptr<Bot> alpha_beta_bot =
+      MakeAlphaBetaBot(*game, /*value_function=*/nullptr, /*depth_limit=*/-1,
+                       /*time_limit_seconds=*/0, /*max_memory_mb=*/1,
+                       /*num_threads=*/2);
+  for (Player player = 0; player < 2; ++player) {
+    std::unique_ptr<Bot> random_bot = MakeUniformRandomBot(1 - player, 1234);
+    std::vector<Bot*> bots(2);
+    bots[player] = alpha_beta_bot.get();
+    bots[1 - player] = random_bot.get();
+    for (int i = 0; i < 5; ++i) {
+      std::unique_ptr<State> state = game->NewInitialState();
+      SPIEL_CHECK_GE(EvaluateBots(state.get(), bots, /*seed=*/i)[player], 0);
+    }
+  }
+}
+
+// With a time limit, the threads stop when the main one does.
+void AlphaBetaBotTest_ConnectFour() {
+  std::shared_ptr<const Game> game = LoadGame("connect_four");
+  std::unique_ptr<Bot> bot =
+      MakeAlphaBetaBot(*game, /*value_function=*/nullptr, /*depth_limit=*/-1,
+                       /*time_limit_seconds=*/0.1, /*max_memory_mb=*/8,
+                       /*num_threads=*/4);
+  std::unique_ptr<State> state = game->NewInitialState();
+  for (int i = 0; i < 4; ++i) {
+    const Action action = bot->Step(*state);
+    const std::vector<Action> legal_actions = state->LegalActions();
+    SPIEL_CHECK_TRUE(std::find(legal_actions.begin(), legal_actions.end(),
+                               action) != legal_actions.end());
+    state->ApplyAction(action);
+  }
+}
+
 }  // namespace
 }  // namespace algorithms
 }  // namespace open_spiel
@@ -72,4 +203,11 @@ int main(int argc, char **argv) {
   open_spiel::algorithms::AlphaBetaSearchTest_TicTacToe();
   open_spiel::algorithms::AlphaBetaSearchTest_TicTacToe_Win();
   open_spiel::algorithms::AlphaBetaSearchTest_TicTacToe_Loss();
+  open_spiel::algorithms::AlphaBetaSearcherTest_TicTacToe();
+  open_spiel::algorithms::AlphaBetaSearcherTest_TicTacToe_Loss();
+  open_spiel::algorithms::AlphaBetaSearcherTest_ConnectFour();
+  open_spiel::algorithms::AlphaBetaSearcherTest_StopToken();
+  open_spiel::algorithms::AlphaBetaSearcherTest_TicTacToe_Threads();
+  open_spiel::algorithms::AlphaBetaBotTest_TicTacToe();
+  open_spiel::algorithms::AlphaBetaBotTest_ConnectFour();
 }
@@ -0,0 +1,345 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/normal_form_payoffs.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/abseil-cpp/absl/strings/string_view.h"
+#include "open_spiel/abseil-cpp/absl/types/span.h"
+#include "open_spiel/algorithms/expected_returns.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/file.h"
+#include "open_spiel/utils/thread.h"
+
+namespace open_spiel {
+namespace algorithms {
+namespace {
+
+// The number of utilities computed between two writes by WriteRows.
+constexpr int64_t kBatchEntries = 1 << 22;
+
+// Calls fn(begin, end) on num_threads consecutive ranges of [begin, end).
+void ParallelFor(int64_t begin, int64_t end, int num_threads,
+                 const std::function<void(int64_t, int64_t)>& fn) {
+  const int64_t size = end - begin;
+  num_threads = std::max<int64_t>(1, std::min<int64_t>(num_threads, size));
+  std::vector<Thread> threads;
+  threads.reserve(num_threads - 1);
+  for (int block = 1; block < num_threads; ++block) {
+    threads.emplace_back([&fn, begin, size, block, num_threads]() {
+      fn(begin + size * block / num_threads,
+         begin + size * (block + 1) / num_threads);
+    });
+  }
+  fn(begin, begin + size / num_threads);
+  for (Thread& thread : threads) thread.join();
+}
+
+}  // namespace
+
+struct NormalFormPayoffs::Index {
+  std::vector<std::unordered_map<std::string, int>> info_states;
+  // The child of (parent, info state, action index), for each player.
+  std::vector<std::map<std::tuple<int, int, int>, int>> children;
+  // The group of each tuple of sequences.
+  std::map<std::vector<int>, int> groups;
+};
+
+NormalFormPayoffs::NormalFormPayoffs(const Game& game)
+    : num_players_(game.NumPlayers()),
+      info_states_(game.NumPlayers()),
+      sequences_(game.NumPlayers(), {Sequence{-1, -1, -1}}) {
+  SPIEL_CHECK_EQ(game.GetType().dynamics, GameType::Dynamics::kSequential);
+  Index index;
+  index.info_states.resize(num_players_);
+  index.children.resize(num_players_);
+  std::vector<int> sequences(num_players_, 0);
+  Traverse(*game.NewInitialState(), 1.0, &sequences, &index);
+
+  // The policy index of a player is a mixed-radix number with a digit per
+  // information state, the first in lexicographic order being the least
+  // significant, as in DeterministicTabularPolicy.
+  for (Player player = 0; player < num_players_; ++player) {
+    std::vector<InfoState*> ordered;
+    for (InfoState& info_state : info_states_[player]) {
+      ordered.push_back(&info_state);
+    }
+    std::sort(ordered.begin(), ordered.end(),
+              [](const InfoState* a, const InfoState* b) {
+                return a->name < b->name;
+              });
+    int64_t num_policies = 1;
+    for (InfoState* info_state : ordered) {
+      info_state->radix = num_policies;
+      num_policies *= info_state->legal_actions.size();
+      if (num_policies > std::numeric_limits<int>::max()) {
+        SpielFatalError(absl::StrCat("Player ", player,
+                                     " has too many deterministic policies."));
+      }
+    }
+    shape_.push_back(num_policies);
+  }
+  num_rows_ = 1;
+  for (Player player = 0; player + 1 < num_players_; ++player) {
+    num_rows_ *= shape_[player];
+  }
+
+  // Number the last player's sequences which end a group, and list those
+  // consistent with each of the last player's policies.
+  const Player last = num_players_ - 1;
+  std::vector<int> position(sequences_[last].size(), -1);
+  num_last_player_sequences_ = 0;
+  for (int group = 0; group < index.groups.size(); ++group) {
+    int& sequence = group_sequences_[group * num_players_ + last];
+    if (position[sequence] < 0) {
+      position[sequence] = num_last_player_sequences_++;
+    }
+    sequence = position[sequence];
+  }
+  last_player_sequences_.resize(RowSize());
+  for (int policy = 0; policy < RowSize(); ++policy) {
+    const std::vector<char> consistent = Consistent(last, policy);
+    for (int sequence = 0; sequence < consistent.size(); ++sequence) {
+      if (consistent[sequence] && position[sequence] >= 0) {
+        last_player_sequences_[policy].push_back(position[sequence]);
+      }
+    }
+  }
+}
+
+void NormalFormPayoffs::Traverse(const State& state, double chance_prob,
+                                 std::vector<int>* sequences, Index* index) {
+  if (state.IsTerminal()) {
+    auto [iter, inserted] =
+        index->groups.emplace(*sequences, index->groups.size());
+    if (inserted) {
+      group_sequences_.insert(group_sequences_.end(), sequences->begin(),
+                              sequences->end());
+      group_utilities_.resize(group_utilities_.size() + num_players_, 0);
+    }
+    const std::vector<double> returns = state.Returns();
+    for (Player player = 0; player < num_players_; ++player) {
+      group_utilities_[iter->second * num_players_ + player] +=
+          chance_prob * returns[player];
+    }
+    return;
+  }
+  if (state.IsChanceNode()) {
+    for (const auto& [outcome, prob] : state.ChanceOutcomes()) {
+      Traverse(*state.Child(outcome), chance_prob * prob, sequences, index);
+    }
+    return;
+  }
+
+  const Player player = state.CurrentPlayer();
+  const std::vector<Action> legal_actions = state.LegalActions();
+  std::string name = state.InformationStateString(player);
+  auto [info_state_iter, inserted] = index->info_states[player].emplace(
+      name, info_states_[player].size());
+  if (inserted) {
+    info_states_[player].push_back(
+        InfoState{std::move(name), legal_actions, /*radix=*/0});
+  }
+  const int info_state = info_state_iter->second;
+
+  const int parent = (*sequences)[player];
+  for (int action_index = 0; action_index < legal_actions.size();
+       ++action_index) {
+    auto [child_iter, new_child] = index->children[player].emplace(
+        std::make_tuple(parent, info_state, action_index),
+        sequences_[player].size());
+    if (new_child) {
+      sequences_[player].push_back(Sequence{parent, info_state, action_index});
+    }
+    (*sequences)[player] = child_iter->second;
+    Traverse(*state.Child(legal_actions[action_index]), chance_prob, sequences,
+             index);
+  }
+  (*sequences)[player] = parent;
+}
+
+std::vector<char> NormalFormPayoffs::Consistent(Player player,
+                                                int64_t policy) const {
+  // Parents come before their children.
+  const std::vector<Sequence>& sequences = sequences_[player];
+  std::vector<char> consistent(sequences.size(), true);
+  for (int s = 1; s < sequences.size(); ++s) {
+    const InfoState& info_state = info_states_[player][sequences[s].info_state];
+    const int64_t digit =
+        policy / info_state.radix % info_state.legal_actions.size();
+    consistent[s] =
+        consistent[sequences[s].parent] && digit == sequences[s].action_index;
+  }
+  return consistent;
+}
+
+std::vector<std::string> NormalFormPayoffs::PolicyNames(Player player) const {
+  std::vector<const InfoState*> ordered;
+  for (const InfoState& info_state : info_states_[player]) {
+    ordered.push_back(&info_state);
+  }
+  std::sort(ordered.begin(), ordered.end(),
+            [](const InfoState* a, const InfoState* b) {
+              return a->radix < b->radix;
+            });
+  std::vector<std::string> names(shape_[player]);
+  for (int policy = 0; policy < shape_[player]; ++policy) {
+    for (const InfoState* info_state : ordered) {
+      const int digit =
+          policy / info_state->radix % info_state->legal_actions.size();
+      absl::StrAppend(&names[policy], info_state->name, "  ---  action = ",
+                      info_state->legal_actions[digit], "\n");
+    }
+  }
+  return names;
+}
+
+void NormalFormPayoffs::Row(int64_t row, absl::Span<double> utilities) const {
+  SPIEL_CHECK_GE(row, 0);
+  SPIEL_CHECK_LT(row, num_rows_);
+  SPIEL_CHECK_EQ(utilities.size(), num_players_ * RowSize());
+  const Player last = num_players_ - 1;
+
+  // The groups reached by the policies of the first players in this row.
+  std::vector<std::vector<char>> consistent(last);
+  for (Player player = last - 1; player >= 0; --player) {
+    consistent[player] = Consistent(player, row % shape_[player]);
+    row /= shape_[player];
+  }
+  std::vector<double> values(num_last_player_sequences_ * num_players_, 0);
+  const int num_groups = group_utilities_.size() / num_players_;
+  for (int group = 0; group < num_groups; ++group) {
+    const int* group_sequences = &group_sequences_[group * num_players_];
+    bool reached = true;
+    for (Player player = 0; player < last && reached; ++player) {
+      reached = consistent[player][group_sequences[player]];
+    }
+    if (!reached) continue;
+    for (Player player = 0; player < num_players_; ++player) {
+      values[group_sequences[last] * num_players_ + player] +=
+          group_utilities_[group * num_players_ + player];
+    }
+  }
+
+  std::fill(utilities.begin(), utilities.end(), 0);
+  for (int policy = 0; policy < RowSize(); ++policy) {
+    for (int sequence : last_player_sequences_[policy]) {
+      for (Player player = 0; player < num_players_; ++player) {
+        utilities[player * RowSize() + policy] +=
+            values[sequence * num_players_ + player];
+      }
+    }
+  }
+}
+
+std::vector<std::vector<double>> NormalFormPayoffs::Utilities(
+    int num_threads) const {
+  const int row_size = RowSize();
+  std::vector<std::vector<double>> utilities(
+      num_players_, std::vector<double>(num_rows_ * row_size));
+  ParallelFor(0, num_rows_, num_threads, [&](int64_t begin, int64_t end) {
+    std::vector<double> row_utilities(num_players_ * row_size);
+    for (int64_t row = begin; row < end; ++row) {
+      Row(row, absl::MakeSpan(row_utilities));
+      for (Player player = 0; player < num_players_; ++player) {
+        std::copy_n(row_utilities.begin() + player * row_size, row_size,
+                    utilities[player].begin() + row * row_size);
+      }
+    }
+  });
+  return utilities;
+}
+
+void NormalFormPayoffs::WriteRows(const std::string& filename,
+                                  int num_threads) const {
+  const int64_t row_entries = static_cast<int64_t>(num_players_) * RowSize();
+  const int64_t batch_rows = std::max<int64_t>(
+      num_threads, kBatchEntries / row_entries / num_threads * num_threads);
+  std::vector<double> batch(std::min(batch_rows, num_rows_) * row_entries);
+  file::File file(filename, "w");
+  for (int64_t first = 0; first < num_rows_; first += batch_rows) {
+    const int64_t last = std::min(first + batch_rows, num_rows_);
+    ParallelFor(first, last, num_threads, [&](int64_t begin, int64_t end) {
+      for (int64_t row = begin; row < end; ++row) {
+        Row(row, absl::MakeSpan(&batch[(row - first) * row_entries],
+                                row_entries));
+      }
+    });
+    SPIEL_CHECK_TRUE(file.Write(
+        absl::string_view(reinterpret_cast<const char*>(batch.data()),
+                          (last - first) * row_entries * sizeof(double))));
+  }
+}
+
+std::vector<std::vector<double>> ProfileReturns(
+    const Game& game,
+    const std::vector<std::shared_ptr<const IndexedDeterministicPolicies>>&
+        policies,
+    int num_threads) {
+  const int num_players = game.NumPlayers();
+  SPIEL_CHECK_EQ(policies.size(), num_players);
+  int64_t num_profiles = 1;
+  for (const auto& player_policies : policies) {
+    const int64_t num_policies = player_policies->NumPolicies();
+    if (num_policies < 0 ||
+        num_profiles > std::numeric_limits<int64_t>::max() / num_policies) {
+      SpielFatalError("Too many profiles of deterministic policies.");
+    }
+    num_profiles *= num_policies;
+  }
+
+  const std::unique_ptr<State> initial_state = game.NewInitialState();
+  std::vector<std::vector<double>> returns(num_players,
+                                           std::vector<double>(num_profiles));
+  ParallelFor(0, num_profiles, num_threads, [&](int64_t begin, int64_t end) {
+    std::vector<IndexedDeterministicPolicy> profile;
+    std::vector<const Policy*> profile_ptrs;
+    for (Player player = 0; player < num_players; ++player) {
+      profile.emplace_back(policies[player]);
+    }
+    for (const IndexedDeterministicPolicy& policy : profile) {
+      profile_ptrs.push_back(&policy);
+    }
+    for (int64_t index = begin; index < end; ++index) {
+      // The last player's policy changes fastest.
+      int64_t rest = index;
+      for (Player player = num_players - 1; player >= 0; --player) {
+        const int64_t num_policies = policies[player]->NumPolicies();
+        profile[player].SetIndex(rest % num_policies);
+        rest /= num_policies;
+      }
+      const std::vector<double> profile_returns =
+          ExpectedReturns(*initial_state, profile_ptrs, /*depth_limit=*/-1);
+      for (Player player = 0; player < num_players; ++player) {
+        returns[player][index] = profile_returns[player];
+      }
+    }
+  });
+  return returns;
+}
+
+}  // namespace algorithms
+}  // namespace open_spiel
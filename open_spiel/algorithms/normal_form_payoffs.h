@@ -0,0 +1,131 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_ALGORITHMS_NORMAL_FORM_PAYOFFS_H_
+#define OPEN_SPIEL_ALGORITHMS_NORMAL_FORM_PAYOFFS_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/types/span.h"
+#include "open_spiel/algorithms/deterministic_policy.h"
+#include "open_spiel/spiel.h"
+
+namespace open_spiel {
+namespace algorithms {
+
+// The payoffs of every profile of deterministic policies in a sequential
+// game, i.e. the utilities of its normal form, as used by
+// ExtensiveToMatrixGame and ExtensiveToTensorGame.
+//
+// The policies of each player are numbered in the order of
+// DeterministicTabularPolicy::NextPolicy, and the profiles in row-major order,
+// the last player's policy changing fastest. A row is the set of profiles
+// which share the policies of all players but the last.
+//
+// Rather than traversing the game once per profile, the tree is traversed
+// once at construction. Each player's path through a terminal history is
+// recorded as a sequence of (information state, action) pairs, and the
+// terminal histories are grouped by their tuple of sequences, with their
+// utilities weighted by the chance probabilities. A profile reaches a group
+// when each player's policy is consistent with the player's sequence, so a row
+// sums the groups reached by its first players for each sequence of the last
+// player, and each entry of the row adds up the sequences its last policy is
+// consistent with.
+class NormalFormPayoffs {
+ public:
+  explicit NormalFormPayoffs(const Game& game);
+
+  int NumPlayers() const { return num_players_; }
+
+  // The number of deterministic policies of each player.
+  const std::vector<int>& Shape() const { return shape_; }
+  int64_t NumRows() const { return num_rows_; }
+  int RowSize() const { return shape_.back(); }
+
+  // The names of the player's policies, as DeterministicTabularPolicy's
+  // ToString(" --- ").
+  std::vector<std::string> PolicyNames(Player player) const;
+
+  // Writes the utilities of a row, player by player: utilities[p * RowSize()
+  // + c] is the utility to player p when the last player uses policy c.
+  void Row(int64_t row, absl::Span<double> utilities) const;
+
+  // The utilities of every profile, for each player, in the flattened order
+  // of TensorGame. The rows are shared out between num_threads threads.
+  std::vector<std::vector<double>> Utilities(int num_threads = 1) const;
+
+  // Writes every row to the file, in order, as native doubles laid out as by
+  // Row(), for tensors which do not fit in memory. The rows are computed in
+  // batches, each shared out between num_threads threads, and written as
+  // each batch completes.
+  void WriteRows(const std::string& filename, int num_threads = 1) const;
+
+ private:
+  // A player's sequences form a tree rooted at the empty sequence, 0.
+  struct Sequence {
+    int parent;
+    int info_state;
+    int action_index;
+  };
+
+  struct InfoState {
+    std::string name;
+    std::vector<Action> legal_actions;
+    // The place value of its digit in the mixed-radix policy index.
+    int64_t radix;
+  };
+
+  // The lookups used while traversing the tree.
+  struct Index;
+
+  void Traverse(const State& state, double chance_prob,
+                std::vector<int>* sequences, Index* index);
+  // Which of the player's sequences the policy is consistent with.
+  std::vector<char> Consistent(Player player, int64_t policy) const;
+
+  int num_players_;
+  std::vector<int> shape_;
+  int64_t num_rows_;
+  std::vector<std::vector<InfoState>> info_states_;
+  std::vector<std::vector<Sequence>> sequences_;
+  // The terminal groups: the sequence of each player, and the expected
+  // utility of each player over the group's histories, both num_players_
+  // entries per group.
+  std::vector<int> group_sequences_;
+  std::vector<double> group_utilities_;
+  // For each policy of the last player, the sequences ending a group that it
+  // is consistent with. The groups refer to the last player's sequences by
+  // their position among those ending a group.
+  std::vector<std::vector<int>> last_player_sequences_;
+  int num_last_player_sequences_;
+};
+
+// The expected returns of every profile of the players' deterministic
+// policies, in the order of NormalFormPayoffs::Utilities, each profile being
+// evaluated by its own traversal of the game. This converts the games which
+// NormalFormPayoffs does not support, i.e. simultaneous-move games. The
+// profiles are shared out between num_threads threads.
+std::vector<std::vector<double>> ProfileReturns(
+    const Game& game,
+    const std::vector<std::shared_ptr<const IndexedDeterministicPolicies>>&
+        policies,
+    int num_threads = 1);
+
+}  // namespace algorithms
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_ALGORITHMS_NORMAL_FORM_PAYOFFS_H_
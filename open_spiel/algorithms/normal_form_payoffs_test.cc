@@ -0,0 +1,123 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/normal_form_payoffs.h"
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/algorithms/deterministic_policy.h"
+#include "open_spiel/algorithms/expected_returns.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/file.h"
+
+namespace open_spiel {
+namespace algorithms {
+namespace {
+
+// Compares the payoffs with those of each profile evaluated on its own, in
+// the order of ExtensiveToTensorGame.
+void CheckAgainstExpectedReturns(const std::string& game_string) {
+  std::shared_ptr<const Game> game = LoadGame(game_string);
+  NormalFormPayoffs payoffs(*game);
+  const std::vector<std::vector<double>> utilities = payoffs.Utilities();
+
+  std::vector<DeterministicTabularPolicy> policies;
+  std::vector<const Policy*> policy_ptrs;
+  for (Player player = 0; player < game->NumPlayers(); ++player) {
+    policies.emplace_back(*game, player);
+    std::vector<std::string> names;
+    do {
+      names.push_back(policies.back().ToString(" --- "));
+    } while (policies.back().NextPolicy());
+    policies.back().ResetDefaultPolicy();
+    SPIEL_CHECK_EQ(payoffs.Shape()[player], names.size());
+    SPIEL_CHECK_EQ(payoffs.PolicyNames(player), names);
+  }
+  for (const DeterministicTabularPolicy& policy : policies) {
+    policy_ptrs.push_back(&policy);
+  }
+
+  const std::unique_ptr<State> initial_state = game->NewInitialState();
+  int64_t profile = 0;
+  bool last_profile;
+  do {
+    const std::vector<double> returns =
+        ExpectedReturns(*initial_state, policy_ptrs, /*depth_limit=*/-1);
+    for (Player player = 0; player < game->NumPlayers(); ++player) {
+      SPIEL_CHECK_FLOAT_NEAR(utilities[player][profile], returns[player],
+                             1e-12);
+    }
+    ++profile;
+    last_profile = true;
+    for (auto policy = policies.rbegin(); policy != policies.rend();
+         ++policy) {
+      if (policy->NextPolicy()) {
+        last_profile = false;
+        break;
+      }
+      policy->ResetDefaultPolicy();
+    }
+  } while (!last_profile);
+  SPIEL_CHECK_EQ(profile, payoffs.NumRows() * payoffs.RowSize());
+}
+
+void ExpectedReturnsTest() {
+  CheckAgainstExpectedReturns("kuhn_poker");
+  CheckAgainstExpectedReturns("first_sealed_auction(players=3,max_value=4)");
+  CheckAgainstExpectedReturns("tiny_hanabi");
+}
+
+void ThreadsAndFileTest() {
+  std::shared_ptr<const Game> game =
+      LoadGame("first_sealed_auction(players=3,max_value=4)");
+  NormalFormPayoffs payoffs(*game);
+  const std::vector<std::vector<double>> utilities = payoffs.Utilities();
+  SPIEL_CHECK_EQ(payoffs.Utilities(/*num_threads=*/4), utilities);
+
+  const std::string filename =
+      absl::StrCat(file::GetTmpDir(), "/normal_form_payoffs_test.bin");
+  payoffs.WriteRows(filename, /*num_threads=*/3);
+  const std::string contents = file::File(filename, "r").ReadContents();
+  SPIEL_CHECK_TRUE(file::Remove(filename));
+  const int num_players = payoffs.NumPlayers();
+  const int row_size = payoffs.RowSize();
+  SPIEL_CHECK_EQ(contents.size(),
+                 payoffs.NumRows() * num_players * row_size * sizeof(double));
+  for (int64_t row = 0; row < payoffs.NumRows(); ++row) {
+    for (Player player = 0; player < num_players; ++player) {
+      for (int col = 0; col < row_size; ++col) {
+        double utility;
+        std::memcpy(&utility,
+                    &contents[((row * num_players + player) * row_size + col) *
+                              sizeof(double)],
+                    sizeof(double));
+        SPIEL_CHECK_EQ(utility, utilities[player][row * row_size + col]);
+      }
+    }
+  }
+}
+
+}  // namespace
+}  // namespace algorithms
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  open_spiel::algorithms::ExpectedReturnsTest();
+  open_spiel::algorithms::ThreadsAndFileTest();
+}
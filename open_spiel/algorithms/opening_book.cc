@@ -0,0 +1,268 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/opening_book.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/algorithm/container.h"
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/file.h"
+
+namespace open_spiel {
+namespace algorithms {
+
+namespace {
+
+constexpr char kMagic[8] = {'O', 'S', 'O', 'P', 'B', 'O', 'O', 'K'};
+constexpr uint32_t kVersion = 1;
+
+// Its size is a multiple of 8 bytes, so that the arrays after it stay aligned.
+struct Header {
+  char magic[8];
+  uint32_t version;
+  uint32_t reserved;
+  int64_t num_positions;
+  int64_t num_actions;
+  int64_t game_string_bytes;
+};
+
+template <typename T>
+void WriteBytes(file::File* file, const T* data, int64_t size) {
+  SPIEL_CHECK_TRUE(file->Write(
+      absl::string_view(reinterpret_cast<const char*>(data), size * sizeof(T))));
+}
+
+// The results of the search of a position.
+struct Entry {
+  uint64_t hash;
+  Action best_action;
+  double value;
+  ActionsAndProbs visit_fractions;
+};
+
+// Whether the actions of the policy are the legal actions of the state, which
+// they may not be if another position has the same hash.
+bool MatchesLegalActions(const ActionsAndProbs& policy, const State& state) {
+  std::vector<Action> legal_actions = state.LegalActions();
+  if (legal_actions.size() != policy.size()) return false;
+  for (const auto& [action, prob] : policy) {
+    if (!absl::c_binary_search(legal_actions, action)) return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+void BuildOpeningBook(const State& root, MCTSBot* bot, int max_depth,
+                      double min_visit_fraction, const std::string& filename) {
+  SPIEL_CHECK_GE(max_depth, 0);
+  std::shared_ptr<const Game> game = root.GetGame();
+
+  // The positions are searched in breadth-first order, each once.
+  std::vector<Entry> entries;
+  std::unordered_set<uint64_t> seen = {root.HashValue()};
+  std::vector<std::pair<std::unique_ptr<State>, int>> queue;
+  queue.emplace_back(root.Clone(), 0);
+  for (int i = 0; i < queue.size(); ++i) {
+    const State& state = *queue[i].first;
+    const int depth = queue[i].second;
+    if (state.IsTerminal()) continue;
+    std::vector<Action> next_actions;
+    if (state.IsChanceNode()) {
+      for (const auto& [outcome, prob] : state.ChanceOutcomes()) {
+        next_actions.push_back(outcome);
+      }
+    } else {
+      std::unique_ptr<SearchNode> searched = bot->MCTSearch(state);
+      double total_visits = 0;
+      for (const SearchNode& child : searched->children) {
+        total_visits += child.explore_count;
+      }
+      const SearchNode& best = searched->BestChild();
+      Entry entry{state.HashValue(), best.action,
+                  best.explore_count > 0
+                      ? best.total_reward.load() / best.explore_count.load()
+                      : 0.0,
+                  {}};
+      for (const SearchNode& child : searched->children) {
+        const double fraction =
+            total_visits > 0 ? child.explore_count / total_visits : 0.0;
+        entry.visit_fractions.push_back({child.action, fraction});
+        if (fraction >= min_visit_fraction) {
+          next_actions.push_back(child.action);
+        }
+      }
+      absl::c_sort(entry.visit_fractions);
+      entries.push_back(std::move(entry));
+    }
+    if (depth == max_depth) continue;
+    for (Action action : next_actions) {
+      std::unique_ptr<State> child = state.Child(action);
+      if (seen.insert(child->HashValue()).second) {
+        queue.emplace_back(std::move(child), depth + 1);
+      }
+    }
+  }
+
+  absl::c_sort(entries, [](const Entry& a, const Entry& b) {
+    return a.hash < b.hash;
+  });
+  std::vector<uint64_t> hashes;
+  std::vector<int64_t> best_actions;
+  std::vector<double> values;
+  std::vector<int64_t> action_begin = {0};
+  std::vector<int64_t> actions;
+  std::vector<double> visit_fractions;
+  for (const Entry& entry : entries) {
+    hashes.push_back(entry.hash);
+    best_actions.push_back(entry.best_action);
+    values.push_back(entry.value);
+    for (const auto& [action, fraction] : entry.visit_fractions) {
+      actions.push_back(action);
+      visit_fractions.push_back(fraction);
+    }
+    action_begin.push_back(actions.size());
+  }
+  const std::string game_string = game->ToString();
+
+  Header header;
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.reserved = 0;
+  header.num_positions = hashes.size();
+  header.num_actions = actions.size();
+  header.game_string_bytes = game_string.size();
+
+  // Written next to the book first, so that it is never seen half written,
+  // even by processes which have it mapped.
+  const std::string tmp_filename = absl::StrCat(filename, ".tmp");
+  {
+    file::File file(tmp_filename, "wb");
+    WriteBytes(&file, &header, 1);
+    WriteBytes(&file, hashes.data(), hashes.size());
+    WriteBytes(&file, best_actions.data(), best_actions.size());
+    WriteBytes(&file, values.data(), values.size());
+    WriteBytes(&file, action_begin.data(), action_begin.size());
+    WriteBytes(&file, actions.data(), actions.size());
+    WriteBytes(&file, visit_fractions.data(), visit_fractions.size());
+    WriteBytes(&file, game_string.data(), game_string.size());
+    SPIEL_CHECK_TRUE(file.Flush());
+  }
+  if (std::rename(tmp_filename.c_str(), filename.c_str()) != 0) {
+    SpielFatalError(absl::StrCat("Could not write the opening book ",
+                                 filename));
+  }
+}
+
+// Lookups are binary searches, which gain nothing from read-ahead.
+OpeningBook::OpeningBook(const std::string& filename)
+    : file_(filename, {file::MMapFile::Access::kRandom}) {
+  const char* data = file_.data();
+  const int64_t size = file_.size();
+  if (size < static_cast<int64_t>(sizeof(Header))) {
+    SpielFatalError(absl::StrCat(filename, " is not an opening book"));
+  }
+
+  const Header* header = reinterpret_cast<const Header*>(data);
+  if (std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0) {
+    SpielFatalError(absl::StrCat(filename, " is not an opening book"));
+  }
+  if (header->version != kVersion) {
+    SpielFatalError(absl::StrCat("Unsupported version ", header->version,
+                                 " of the opening book ", filename));
+  }
+  num_positions_ = header->num_positions;
+
+  const char* next = data + sizeof(Header);
+  hashes_ = reinterpret_cast<const uint64_t*>(next);
+  next += num_positions_ * sizeof(uint64_t);
+  best_actions_ = reinterpret_cast<const int64_t*>(next);
+  next += num_positions_ * sizeof(int64_t);
+  values_ = reinterpret_cast<const double*>(next);
+  next += num_positions_ * sizeof(double);
+  action_begin_ = reinterpret_cast<const int64_t*>(next);
+  next += (num_positions_ + 1) * sizeof(int64_t);
+  actions_ = reinterpret_cast<const int64_t*>(next);
+  next += header->num_actions * sizeof(int64_t);
+  visit_fractions_ = reinterpret_cast<const double*>(next);
+  next += header->num_actions * sizeof(double);
+  game_string_ = absl::string_view(next, header->game_string_bytes);
+  next += header->game_string_bytes;
+  if (next - data != size) {
+    SpielFatalError(absl::StrCat("The opening book ", filename,
+                                 " has the wrong size: ", size, " bytes instead"
+                                 " of ", next - data));
+  }
+}
+
+int64_t OpeningBook::Find(uint64_t hash) const {
+  const uint64_t* it =
+      std::lower_bound(hashes_, hashes_ + num_positions_, hash);
+  return it != hashes_ + num_positions_ && *it == hash ? it - hashes_ : -1;
+}
+
+ActionsAndProbs OpeningBook::Policy(int64_t id) const {
+  ActionsAndProbs policy;
+  policy.reserve(action_begin_[id + 1] - action_begin_[id]);
+  for (int64_t i = action_begin_[id]; i < action_begin_[id + 1]; ++i) {
+    policy.push_back({actions_[i], visit_fractions_[i]});
+  }
+  return policy;
+}
+
+OpeningBookEvaluator::OpeningBookEvaluator(
+    std::shared_ptr<const OpeningBook> book,
+    std::shared_ptr<Evaluator> fallback)
+    : book_(std::move(book)), fallback_(std::move(fallback)) {
+  SPIEL_CHECK_TRUE(book_ != nullptr);
+  SPIEL_CHECK_TRUE(fallback_ != nullptr);
+}
+
+std::vector<double> OpeningBookEvaluator::Evaluate(const State& state) {
+  const GameType& game_type = state.GetGame()->GetType();
+  const bool zero_sum_pair = state.NumPlayers() == 2 &&
+                             game_type.utility == GameType::Utility::kZeroSum;
+  if (state.IsChanceNode() || state.IsTerminal() ||
+      (state.NumPlayers() != 1 && !zero_sum_pair)) {
+    return fallback_->Evaluate(state);
+  }
+  const int64_t id = book_->Find(state);
+  if (id < 0) return fallback_->Evaluate(state);
+  const double value = book_->Value(id);
+  if (state.NumPlayers() == 1) return {value};
+  return state.CurrentPlayer() == 0 ? std::vector<double>{value, -value}
+                                    : std::vector<double>{-value, value};
+}
+
+ActionsAndProbs OpeningBookEvaluator::Prior(const State& state) {
+  if (!state.IsChanceNode()) {
+    const int64_t id = book_->Find(state);
+    if (id >= 0) {
+      ActionsAndProbs policy = book_->Policy(id);
+      if (MatchesLegalActions(policy, state)) return policy;
+    }
+  }
+  return fallback_->Prior(state);
+}
+
+}  // namespace algorithms
+}  // namespace open_spiel
@@ -0,0 +1,113 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_ALGORITHMS_OPENING_BOOK_H_
+#define OPEN_SPIEL_ALGORITHMS_OPENING_BOOK_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/strings/string_view.h"
+#include "open_spiel/algorithms/mcts.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/utils/file.h"
+
+// Opening books: the results of deep MCTS searches of the first positions of
+// a game, run once offline and written to a file which is mapped into memory
+// as it is to be looked up, so that bots play their opening moves instantly,
+// with the quality of searches much longer than they could afford online.
+//
+// For each position, the book holds the share of the root's visits each
+// action got, the most visited action and its value for the player to move.
+// Positions are identified by State::HashValue(), as in an endgame tablebase
+// (see endgame_tablebase.h), so transpositions share their entry. The file
+// starts with a header, followed by the hashes of the positions in increasing
+// order, their best actions and values, where the actions of each start, the
+// actions and their visit shares, and the string of the game. The numbers
+// are written in the byte order of the machine, so a book should be read on
+// the same architecture that wrote it.
+namespace open_spiel {
+namespace algorithms {
+
+// Searches the positions of the game from root with bot->MCTSearch, and
+// writes their results to filename. The positions searched are the root and,
+// up to max_depth plies from it, the children of the searched positions
+// whose action got at least min_visit_fraction of the visits, and all the
+// outcomes of chance nodes. Each search is one of the bot's, so its number
+// of simulations and threads set the depth and time of the searches.
+void BuildOpeningBook(const State& root, MCTSBot* bot, int max_depth,
+                      double min_visit_fraction, const std::string& filename);
+
+// A book file, mapped read-only for as long as this lives. Lookups are a
+// binary search over the file, and can be made from several threads at once.
+class OpeningBook {
+ public:
+  explicit OpeningBook(const std::string& filename);
+
+  OpeningBook(const OpeningBook&) = delete;
+  OpeningBook& operator=(const OpeningBook&) = delete;
+
+  int64_t NumPositions() const { return num_positions_; }
+
+  // The game of the book, as returned by Game::ToString().
+  absl::string_view GameString() const { return game_string_; }
+
+  // Returns the entry of the position with this hash, or -1 if there is none.
+  int64_t Find(uint64_t hash) const;
+  int64_t Find(const State& state) const { return Find(state.HashValue()); }
+
+  uint64_t HashValue(int64_t id) const { return hashes_[id]; }
+
+  // The most visited action, and its value for the player to move.
+  Action BestAction(int64_t id) const { return best_actions_[id]; }
+  double Value(int64_t id) const { return values_[id]; }
+
+  // The share of the visits of each action searched.
+  ActionsAndProbs Policy(int64_t id) const;
+
+ private:
+  file::MMapFile file_;
+  int64_t num_positions_;
+  const uint64_t* hashes_;
+  const int64_t* best_actions_;
+  const double* values_;
+  const int64_t* action_begin_;
+  const int64_t* actions_;
+  const double* visit_fractions_;
+  absl::string_view game_string_;
+};
+
+// An MCTS evaluator, e.g. around the VPNetEvaluator of AlphaZero, whose
+// priors are the visit shares of the positions in the book, and those of
+// fallback for the others. The values of the positions in the book are
+// theirs too in games of one player, or of two with zero-sum returns.
+class OpeningBookEvaluator : public Evaluator {
+ public:
+  OpeningBookEvaluator(std::shared_ptr<const OpeningBook> book,
+                       std::shared_ptr<Evaluator> fallback);
+
+  std::vector<double> Evaluate(const State& state) override;
+  ActionsAndProbs Prior(const State& state) override;
+
+ private:
+  std::shared_ptr<const OpeningBook> book_;
+  std::shared_ptr<Evaluator> fallback_;
+};
+
+}  // namespace algorithms
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_ALGORITHMS_OPENING_BOOK_H_
@@ -0,0 +1,122 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/opening_book.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/algorithm/container.h"
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/algorithms/mcts.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/file.h"
+
+namespace open_spiel {
+namespace algorithms {
+namespace {
+
+std::string BookFilename(const std::string& name) {
+  return absl::StrCat(file::GetTmpDir(), "/open_spiel-test-",
+                      std::rand(), "-", name);  // NOLINT
+}
+
+std::unique_ptr<MCTSBot> MakeBot(const Game& game, int max_simulations) {
+  return std::make_unique<MCTSBot>(
+      game, std::make_shared<RandomRolloutEvaluator>(1, 0), /*uct_c=*/2,
+      max_simulations, /*max_memory_mb=*/100, /*solve=*/true, /*seed=*/0,
+      /*verbose=*/false);
+}
+
+void OpeningBookTest_TicTacToe() {
+  std::shared_ptr<const Game> game = LoadGame("tic_tac_toe");
+  std::unique_ptr<State> root = game->NewInitialState();
+  const std::string filename = BookFilename("tic_tac_toe");
+  std::unique_ptr<MCTSBot> builder = MakeBot(*game, 2000);
+  BuildOpeningBook(*root, builder.get(), /*max_depth=*/2,
+                   /*min_visit_fraction=*/0.2, filename);
+  auto book = std::make_shared<const OpeningBook>(filename);
+  SPIEL_CHECK_EQ(book->GameString(), game->ToString());
+
+  // The root has the visit shares of all its actions, the best the largest.
+  const int64_t id = book->Find(*root);
+  SPIEL_CHECK_GE(id, 0);
+  SPIEL_CHECK_EQ(book->HashValue(id), root->HashValue());
+  const ActionsAndProbs policy = book->Policy(id);
+  SPIEL_CHECK_EQ(policy.size(), 9);
+  double sum = 0;
+  double best_fraction = 0;
+  for (const auto& [action, fraction] : policy) {
+    sum += fraction;
+    if (action == book->BestAction(id)) best_fraction = fraction;
+  }
+  SPIEL_CHECK_LT(std::abs(sum - 1), 1e-9);
+  for (const auto& [action, fraction] : policy) {
+    SPIEL_CHECK_LE(fraction, best_fraction);
+  }
+  SPIEL_CHECK_GE(book->Value(id), -1);
+  SPIEL_CHECK_LE(book->Value(id), 1);
+
+  // The replies followed are searched, down to max_depth plies.
+  for (const auto& [action, fraction] : policy) {
+    if (fraction < 0.2) continue;
+    std::unique_ptr<State> child = root->Child(action);
+    const int64_t child_id = book->Find(*child);
+    SPIEL_CHECK_GE(child_id, 0);
+    for (const auto& [reply, reply_fraction] : book->Policy(child_id)) {
+      std::unique_ptr<State> grandchild = child->Child(reply);
+      if (reply_fraction < 0.2) continue;
+      SPIEL_CHECK_GE(book->Find(*grandchild), 0);
+      for (Action next : grandchild->LegalActions()) {
+        SPIEL_CHECK_EQ(book->Find(*grandchild->Child(next)), -1);
+      }
+    }
+  }
+  SPIEL_CHECK_EQ(book->Find(~root->HashValue()), -1);
+
+  // A bot with the book plays its moves without searching, and searches
+  // elsewhere.
+  std::unique_ptr<MCTSBot> bot = MakeBot(*game, 100);
+  bot->SetOpeningBook(book);
+  bot->SetProfiling(true);
+  SPIEL_CHECK_EQ(bot->Step(*root), book->BestAction(id));
+  SPIEL_CHECK_EQ(bot->TakeProfile().searches, 0);
+  std::unique_ptr<State> outside = root->Clone();
+  for (Action action : {0, 1, 2, 3}) outside->ApplyAction(action);
+  SPIEL_CHECK_EQ(book->Find(*outside), -1);
+  SPIEL_CHECK_TRUE(
+      absl::c_linear_search(outside->LegalActions(), bot->Step(*outside)));
+  SPIEL_CHECK_EQ(bot->TakeProfile().searches, 1);
+
+  // The evaluator gives the book's priors and values at its positions.
+  OpeningBookEvaluator evaluator(
+      book, std::make_shared<RandomRolloutEvaluator>(1, 0));
+  SPIEL_CHECK_TRUE(evaluator.Prior(*root) == policy);
+  SPIEL_CHECK_TRUE(evaluator.Evaluate(*root) ==
+                   std::vector<double>({book->Value(id), -book->Value(id)}));
+  SPIEL_CHECK_EQ(evaluator.Prior(*outside).size(), 5);
+  SPIEL_CHECK_TRUE(file::Remove(filename));
+}
+
+}  // namespace
+}  // namespace algorithms
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  open_spiel::algorithms::OpeningBookTest_TicTacToe();
+}
@@ -14,33 +14,68 @@
 
 #include "open_spiel/algorithms/outcome_sampling_mccfr.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <memory>
 #include <numeric>
 #include <random>
+#include <string>
+#include <vector>
 
-#include "open_spiel/abseil-cpp/absl/random/discrete_distribution.h"
+#include "open_spiel/abseil-cpp/absl/algorithm/container.h"
+#include "open_spiel/abseil-cpp/absl/random/uniform_real_distribution.h"
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/abseil-cpp/absl/synchronization/mutex.h"
+#include "open_spiel/abseil-cpp/absl/types/span.h"
 #include "open_spiel/algorithms/cfr.h"
+#include "open_spiel/algorithms/cfr_checkpoint.h"
+#include "open_spiel/algorithms/policy_file.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/thread.h"
 
 namespace open_spiel {
 namespace algorithms {
 
-OutcomeSamplingMCCFRSolver::OutcomeSamplingMCCFRSolver(const Game& game,
-                                                       double epsilon, int seed)
-    : OutcomeSamplingMCCFRSolver(game, std::make_shared<UniformPolicy>(),
-                                 epsilon, seed) {}
+namespace {
 
-OutcomeSamplingMCCFRSolver::OutcomeSamplingMCCFRSolver(
+// Samples an action index from a policy with a uniform random number z in
+// [0, 1). If rounding leaves the probabilities summing to less than z, the
+// last action with a positive probability is sampled.
+int SampleActionIndex(absl::Span<const double> policy, double z) {
+  double sum = 0;
+  for (int aidx = 0; aidx < policy.size(); ++aidx) {
+    sum += policy[aidx];
+    if (z < sum) return aidx;
+  }
+  for (int aidx = policy.size() - 1; aidx >= 0; --aidx) {
+    if (policy[aidx] > 0) return aidx;
+  }
+  SpielFatalError(absl::StrCat("SampleActionIndex: sum of probs is ", sum));
+}
+
+}  // namespace
+
+template <typename T>
+BasicOutcomeSamplingMCCFRSolver<T>::BasicOutcomeSamplingMCCFRSolver(
+    const Game& game, double epsilon, int seed, int num_threads)
+    : BasicOutcomeSamplingMCCFRSolver(game, std::make_shared<UniformPolicy>(),
+                                      epsilon, seed, num_threads) {}
+
+template <typename T>
+BasicOutcomeSamplingMCCFRSolver<T>::BasicOutcomeSamplingMCCFRSolver(
     const Game& game, std::shared_ptr<Policy> default_policy, double epsilon,
-    int seed)
+    int seed, int num_threads)
     : game_(game),
       epsilon_(epsilon),
+      num_threads_(num_threads),
+      value_locks_(kNumValueLocks),
       num_players_(game.NumPlayers()),
       update_player_(-1),
       rng_(seed >= 0 ? seed : std::mt19937::default_seed),
-      dist_(0.0, 1.0),
       default_policy_(default_policy) {
+  SPIEL_CHECK_GE(num_threads_, 1);
   if (game_.GetType().dynamics != GameType::Dynamics::kSequential) {
     SpielFatalError(
         "MCCFR requires sequential games. If you're trying to run it "
@@ -49,31 +84,104 @@ OutcomeSamplingMCCFRSolver::OutcomeSamplingMCCFRSolver(
   }
 }
 
-void OutcomeSamplingMCCFRSolver::RunIteration(std::mt19937* rng) {
+template <typename T>
+void BasicOutcomeSamplingMCCFRSolver<T>::RunIteration(Philox* rng) {
+  RunIterationWith(rng);
+}
+
+template <typename T>
+void BasicOutcomeSamplingMCCFRSolver<T>::RunIteration(std::mt19937* rng) {
+  RunIterationWith(rng);
+}
+
+template <typename T>
+template <typename Rng>
+void BasicOutcomeSamplingMCCFRSolver<T>::RunIterationWith(Rng* rng) {
   update_player_ = (update_player_ + 1) % num_players_;
   std::unique_ptr<State> state = game_.NewInitialState();
-  SampleEpisode(state.get(), rng, 1.0, 1.0, 1.0);
+  SampleEpisode(state.get(), update_player_, rng, &workspace_, /*depth=*/0,
+                1.0, 1.0, 1.0);
+}
+
+template <typename T>
+void BasicOutcomeSamplingMCCFRSolver<T>::RunIterations(int num_iterations) {
+  const Player first_player = update_player_ + 1;
+  update_player_ = (update_player_ + num_iterations) % num_players_;
+  auto run_iteration = [&](int iteration, Philox* rng,
+                           Workspace* workspace) {
+    std::unique_ptr<State> state = game_.NewInitialState();
+    SampleEpisode(state.get(), (first_player + iteration) % num_players_, rng,
+                  workspace, /*depth=*/0, 1.0, 1.0, 1.0);
+  };
+  if (num_threads_ == 1) {
+    for (int i = 0; i < num_iterations; ++i) {
+      run_iteration(i, &rng_, &workspace_);
+    }
+    return;
+  }
+
+  const Philox iterations_rng(rng_());
+  std::vector<Workspace> workspaces(num_threads_);
+  std::atomic<int> next_iteration{0};
+  auto run_iterations = [&](int thread) {
+    for (int i = next_iteration++; i < num_iterations; i = next_iteration++) {
+      Philox rng = iterations_rng.Split(i);
+      run_iteration(i, &rng, &workspaces[thread]);
+    }
+  };
+  std::vector<Thread> threads;
+  for (int i = 1; i < std::min(num_threads_, num_iterations); ++i) {
+    threads.emplace_back([&, i]() { run_iterations(i); });
+  }
+  run_iterations(0);
+  for (Thread& thread : threads) thread.join();
 }
 
-std::vector<double> OutcomeSamplingMCCFRSolver::SamplePolicy(
-    const CFRInfoStateValues& info_state) const {
-  std::vector<double> policy = info_state.current_policy;
-  for (int i = 0; i < policy.size(); ++i) {
-    policy[i] = epsilon_ * 1.0 / policy.size() + (1 - epsilon_) * policy[i];
+template <typename T>
+int BasicOutcomeSamplingMCCFRSolver<T>::FindOrInsertInfoStateId(
+    const State& state, const std::string& info_state_key,
+    const std::vector<Action>& legal_actions) {
+  {
+    absl::ReaderMutexLock lock(&table_lock_);
+    const int id = info_states_.Find(info_state_key);
+    if (id >= 0) return id;
   }
-  return policy;
+  absl::MutexLock lock(&table_lock_);
+  return algorithms::FindOrInsertInfoStateId(
+      state, info_state_key, legal_actions, kInitialTableValues, &info_states_,
+      &info_state_keys_);
 }
 
-double OutcomeSamplingMCCFRSolver::Baseline(
-    const State& state, const CFRInfoStateValues& info_state, int aidx) const {
+template <typename T>
+BasicCFRInfoStateValues<T> BasicOutcomeSamplingMCCFRSolver<T>::InfoStateValues(
+    int id) {
+  absl::ReaderMutexLock lock(&table_lock_);
+  return info_states_[id];
+}
+
+template <typename T>
+void BasicOutcomeSamplingMCCFRSolver<T>::SamplePolicy(
+    absl::Span<const double> current_policy,
+    absl::Span<double> sample_policy) const {
+  for (int i = 0; i < current_policy.size(); ++i) {
+    sample_policy[i] = epsilon_ * 1.0 / current_policy.size() +
+                       (1 - epsilon_) * current_policy[i];
+  }
+}
+
+template <typename T>
+double BasicOutcomeSamplingMCCFRSolver<T>::Baseline(
+    const State& state, const BasicCFRInfoStateValues<T>& info_state,
+    int aidx) const {
   // Default to vanilla outcome sampling.
   return 0;
 }
 
 // Applies Eq. 9 of Schmid et al. '19
-double OutcomeSamplingMCCFRSolver::BaselineCorrectedChildValue(
-    const State& state, const CFRInfoStateValues& info_state, int sampled_aidx,
-    int aidx, double child_value, double sample_prob) const {
+template <typename T>
+double BasicOutcomeSamplingMCCFRSolver<T>::BaselineCorrectedChildValue(
+    const State& state, const BasicCFRInfoStateValues<T>& info_state,
+    int sampled_aidx, int aidx, double child_value, double sample_prob) const {
   double baseline = Baseline(state, info_state, aidx);
   if (aidx == sampled_aidx) {
     return baseline + (child_value - baseline) / sample_prob;
@@ -82,20 +190,22 @@ double OutcomeSamplingMCCFRSolver::BaselineCorrectedChildValue(
   }
 }
 
-double OutcomeSamplingMCCFRSolver::SampleEpisode(State* state,
-                                                 std::mt19937* rng,
-                                                 double my_reach,
-                                                 double opp_reach,
-                                                 double sample_reach) {
+template <typename T>
+template <typename Rng>
+double BasicOutcomeSamplingMCCFRSolver<T>::SampleEpisode(
+    State* state, Player update_player, Rng* rng,
+    Workspace* workspace, int depth, double my_reach, double opp_reach,
+    double sample_reach) {
+  absl::uniform_real_distribution<double> dist(0.0, 1.0);
   if (state->IsTerminal()) {
-    return state->PlayerReturn(update_player_);
+    return state->PlayerReturn(update_player);
   } else if (state->IsChanceNode()) {
     std::pair<Action, double> outcome_and_prob =
-        SampleAction(state->ChanceOutcomes(), dist_(*rng));
+        state->SampleChanceOutcome(dist(*rng));
     SPIEL_CHECK_PROB(outcome_and_prob.second);
     SPIEL_CHECK_GT(outcome_and_prob.second, 0);
     state->ApplyAction(outcome_and_prob.first);
-    return SampleEpisode(state, rng, my_reach,
+    return SampleEpisode(state, update_player, rng, workspace, depth, my_reach,
                          outcome_and_prob.second * opp_reach,
                          outcome_and_prob.second * sample_reach);
   } else if (state->IsSimultaneousNode()) {
@@ -107,56 +217,69 @@ double OutcomeSamplingMCCFRSolver::SampleEpisode(State* state,
   SPIEL_CHECK_PROB(sample_reach);
 
   int player = state->CurrentPlayer();
-  std::string is_key = state->InformationStateString(player);
+  std::string is_key = state->InformationStateKey(player);
   std::vector<Action> legal_actions = state->LegalActions();
+  const int num_actions = legal_actions.size();
 
-  // The insert here only inserts the default value if the key is not found,
-  // otherwise returns the entry in the map.
-  auto iter_and_result = info_states_.insert(
-      {is_key, CFRInfoStateValues(legal_actions, kInitialTableValues)});
+  const int id = FindOrInsertInfoStateId(*state, is_key, legal_actions);
+  BasicCFRInfoStateValues<T> info_state = InfoStateValues(id);
 
-  CFRInfoStateValues info_state_copy = iter_and_result.first->second;
-  info_state_copy.ApplyRegretMatching();
+  // The buffer of this depth. Deeper nodes may grow the list of buffers, but
+  // that moves the vectors without moving their elements, which the spans
+  // point to.
+  if (workspace->buffers.size() <= depth) {
+    workspace->buffers.resize(depth + 1);
+  }
+  std::vector<double>& buffer = workspace->buffers[depth];
+  buffer.resize(3 * num_actions);
+  const absl::Span<double> current_policy(buffer.data(), num_actions);
+  const absl::Span<double> sample_policy(buffer.data() + num_actions,
+                                         num_actions);
+  const absl::Span<double> child_values(buffer.data() + 2 * num_actions,
+                                        num_actions);
 
-  const std::vector<double>& sample_policy =
-      (player == update_player_ ? SamplePolicy(info_state_copy)
-                                : info_state_copy.current_policy);
+  {
+    absl::MutexLock lock(ValueLock(id));
+    info_state.ApplyRegretMatching();
+    absl::c_copy(info_state.current_policy, current_policy.begin());
+  }
+  if (player == update_player) {
+    SamplePolicy(current_policy, sample_policy);
+  } else {
+    absl::c_copy(current_policy, sample_policy.begin());
+  }
 
-  absl::discrete_distribution<int> action_dist(sample_policy.begin(),
-                                               sample_policy.end());
-  int sampled_aidx = action_dist(*rng);
+  int sampled_aidx = SampleActionIndex(sample_policy, dist(*rng));
   SPIEL_CHECK_PROB(sample_policy[sampled_aidx]);
   SPIEL_CHECK_GT(sample_policy[sampled_aidx], 0);
 
   state->ApplyAction(legal_actions[sampled_aidx]);
   double child_value = SampleEpisode(
-      state, rng,
-      player == update_player_
-          ? my_reach * info_state_copy.current_policy[sampled_aidx]
+      state, update_player, rng, workspace, depth + 1,
+      player == update_player
+          ? my_reach * current_policy[sampled_aidx]
           : my_reach,
-      player == update_player_
+      player == update_player
           ? opp_reach
-          : opp_reach * info_state_copy.current_policy[sampled_aidx],
+          : opp_reach * current_policy[sampled_aidx],
       sample_reach * sample_policy[sampled_aidx]);
 
   // Compute each of the child estimated values.
-  std::vector<double> child_values(legal_actions.size(), 0);
-  for (int aidx = 0; aidx < legal_actions.size(); ++aidx) {
+  for (int aidx = 0; aidx < num_actions; ++aidx) {
     child_values[aidx] =
-        BaselineCorrectedChildValue(*state, info_state_copy, sampled_aidx, aidx,
+        BaselineCorrectedChildValue(*state, info_state, sampled_aidx, aidx,
                                     child_value, sample_policy[aidx]);
   }
 
   // Compute the value of this history for this policy.
   double value_estimate = 0;
-  for (int aidx = 0; aidx < legal_actions.size(); ++aidx) {
-    value_estimate +=
-        info_state_copy.current_policy[sampled_aidx] * child_values[aidx];
+  for (int aidx = 0; aidx < num_actions; ++aidx) {
+    value_estimate += current_policy[sampled_aidx] * child_values[aidx];
   }
 
-  if (player == update_player_) {
+  if (player == update_player) {
     // Now the regret and avg strategy updates.
-    CFRInfoStateValues& info_state = info_states_[is_key];
+    absl::MutexLock lock(ValueLock(id));
     info_state.ApplyRegretMatching();
 
     // Estimate for the counterfactual value of the policy.
@@ -169,7 +292,7 @@ double OutcomeSamplingMCCFRSolver::SampleEpisode(State* state,
     // tail reaches and divided by the sample tail reach. So when adding regrets
     // to the table, we need only multiply by the opponent reach and divide by
     // the sample reach to this point.
-    for (int aidx = 0; aidx < legal_actions.size(); ++aidx) {
+    for (int aidx = 0; aidx < num_actions; ++aidx) {
       // Estimate for the counterfactual value of the policy replaced by always
       // choosing sampled_aidx at this information state.
       double cf_action_value = child_values[aidx] * opp_reach / sample_reach;
@@ -177,7 +300,7 @@ double OutcomeSamplingMCCFRSolver::SampleEpisode(State* state,
     }
 
     // Update the average policy.
-    for (int aidx = 0; aidx < legal_actions.size(); ++aidx) {
+    for (int aidx = 0; aidx < num_actions; ++aidx) {
       double increment =
           my_reach * info_state.current_policy[aidx] / sample_reach;
       SPIEL_CHECK_FALSE(std::isnan(increment) || std::isinf(increment));
@@ -188,5 +311,27 @@ double OutcomeSamplingMCCFRSolver::SampleEpisode(State* state,
   return value_estimate;
 }
 
+template <typename T>
+void BasicOutcomeSamplingMCCFRSolver<T>::SaveCheckpoint(
+    const std::string& filename) const {
+  SaveCFRCheckpoint(filename, info_states_, info_state_keys_, /*iteration=*/0);
+}
+
+template <typename T>
+void BasicOutcomeSamplingMCCFRSolver<T>::LoadCheckpoint(
+    const std::string& filename) {
+  CFRCheckpoint(filename).CopyTo(&info_states_, &info_state_keys_);
+}
+
+template <typename T>
+void BasicOutcomeSamplingMCCFRSolver<T>::SaveAveragePolicy(
+    const std::string& filename, bool single_precision) const {
+  SaveCFRAveragePolicy(filename, info_states_, info_state_keys_,
+                       single_precision);
+}
+
+template class BasicOutcomeSamplingMCCFRSolver<double>;
+template class BasicOutcomeSamplingMCCFRSolver<float>;
+
 }  // namespace algorithms
 }  // namespace open_spiel
@@ -17,12 +17,15 @@
 
 #include <memory>
 #include <random>
+#include <string>
 #include <vector>
 
-#include "open_spiel/abseil-cpp/absl/random/uniform_real_distribution.h"
+#include "open_spiel/abseil-cpp/absl/synchronization/mutex.h"
+#include "open_spiel/abseil-cpp/absl/types/span.h"
 #include "open_spiel/algorithms/cfr.h"
 #include "open_spiel/policy.h"
 #include "open_spiel/spiel.h"
+#include "open_spiel/utils/random.h"
 
 // An implementation of outcome sampling Monte Carlo Counterfactual Regret
 // Minimization (CFR). This version is implemented in a way that is closer to
@@ -37,61 +40,140 @@
 namespace open_spiel {
 namespace algorithms {
 
-class OutcomeSamplingMCCFRSolver {
+// The values in the table are stored as T, which (as with the CFR solvers in
+// cfr.h) may be float to halve the memory it takes.
+template <typename T>
+class BasicOutcomeSamplingMCCFRSolver {
  public:
   static inline constexpr double kInitialTableValues = 0.000001;
   static inline constexpr double kDefaultEpsilon = 0.6;
 
   // Creates a solver with a specific seed, average type and an explicit
   // default uniform policy for states that have not been visited.
-  OutcomeSamplingMCCFRSolver(const Game& game, double epsilon = kDefaultEpsilon,
-                             int seed = -1);
+  // RunIterations uses num_threads threads.
+  BasicOutcomeSamplingMCCFRSolver(const Game& game,
+                                  double epsilon = kDefaultEpsilon,
+                                  int seed = -1, int num_threads = 1);
 
   // Creates a solver with a specific seed and average type, and also allows
   // for a custom default policy for states that have not been visited.
-  OutcomeSamplingMCCFRSolver(const Game& game,
-                             std::shared_ptr<Policy> default_policy,
-                             double epsilon = kDefaultEpsilon, int seed = -1);
+  BasicOutcomeSamplingMCCFRSolver(const Game& game,
+                                  std::shared_ptr<Policy> default_policy,
+                                  double epsilon = kDefaultEpsilon,
+                                  int seed = -1, int num_threads = 1);
 
   // Performs one iteration of outcome sampling.
   void RunIteration() { RunIteration(&rng_); }
 
   // Same as above, but uses the specified random number generator instead.
+  void RunIteration(Philox* rng);
   void RunIteration(std::mt19937* rng);
 
+  // Performs this many iterations, each sampling one trajectory for the next
+  // player in turn. They are spread over num_threads threads, each with
+  // buffers which are reused from one trajectory to the next. Each iteration
+  // samples from its own stream of a generator seeded from the internal one,
+  // whichever thread runs it. The threads update the
+  // same table as they go, so unlike with a single thread, the results depend
+  // on their timing.
+  void RunIterations(int num_iterations);
+
   // Computes the average policy, containing the policy for all players.
   // The returned policy instance should only be used during the lifetime of
   // the CFRSolver object.
   std::unique_ptr<Policy> AveragePolicy() const {
     return std::unique_ptr<Policy>(
-        new CFRAveragePolicy(info_states_, default_policy_));
+        new BasicCFRAveragePolicy<T>(info_states_, default_policy_,
+                                     &info_state_keys_));
+  }
+
+  // The same, with the average policy of every information state normalized
+  // once, for serving: the solver must not be updated while it is in use.
+  std::unique_ptr<BasicCFRAveragePolicy<T>> CachedAveragePolicy() const {
+    auto policy = std::make_unique<BasicCFRAveragePolicy<T>>(
+        info_states_, default_policy_, &info_state_keys_);
+    policy->CacheAveragePolicy();
+    return policy;
   }
 
+  // Saves the table to a checkpoint file (see cfr_checkpoint.h), or loads
+  // one, adding to the table. The state of the random number generator is
+  // not saved. Not to be called while iterations run.
+  void SaveCheckpoint(const std::string& filename) const;
+  void LoadCheckpoint(const std::string& filename);
+
+  // Writes the average policy to a policy file (see policy_file.h), which
+  // MappedTabularPolicy serves without loading it.
+  void SaveAveragePolicy(const std::string& filename,
+                         bool single_precision = false) const;
+
  private:
-  double SampleEpisode(State* state, std::mt19937* rng, double my_reach,
+  // The number of locks over the values of the information states, each of
+  // which guards those whose id is the same modulo this.
+  static constexpr int kNumValueLocks = 1024;
+
+  // The buffers of the trajectories sampled by one thread. Each depth has
+  // one, holding the current policy, sample policy and child values of the
+  // node at that depth, so that once they have grown, sampling allocates no
+  // vectors for them.
+  struct Workspace {
+    std::vector<std::vector<double>> buffers;
+  };
+
+  // Samples a trajectory from this state, updating the values of
+  // update_player, and returns its estimated value. The depth counts the
+  // decision nodes since the root.
+  template <typename Rng>
+  void RunIterationWith(Rng* rng);
+  template <typename Rng>
+  double SampleEpisode(State* state, Player update_player, Rng* rng,
+                       Workspace* workspace, int depth, double my_reach,
                        double opp_reach, double sample_reach);
-  std::vector<double> SamplePolicy(const CFRInfoStateValues& info_state) const;
+
+  // Mixes epsilon exploration into the current policy.
+  void SamplePolicy(absl::Span<const double> current_policy,
+                    absl::Span<double> sample_policy) const;
 
   // The b_i function from  Schmid et al. '19.
-  double Baseline(const State& state, const CFRInfoStateValues& info_state,
+  double Baseline(const State& state,
+                  const BasicCFRInfoStateValues<T>& info_state,
                   int aidx) const;
 
   // Applies Eq. 9 of Schmid et al. '19
   double BaselineCorrectedChildValue(const State& state,
-                                     const CFRInfoStateValues& info_state,
+                                     const BasicCFRInfoStateValues<T>&
+                                         info_state,
                                      int sampled_aidx, int aidx,
                                      double child_value,
                                      double sample_prob) const;
 
+  // Returns the id of the information state of the current player at this
+  // state, whose key is `info_state_key`, inserting it if needed.
+  int FindOrInsertInfoStateId(const State& state,
+                              const std::string& info_state_key,
+                              const std::vector<Action>& legal_actions);
+
+  // The values of an information state, which must only be accessed under
+  // its lock.
+  BasicCFRInfoStateValues<T> InfoStateValues(int id);
+  absl::Mutex* ValueLock(int id) { return &value_locks_[id % kNumValueLocks]; }
+
   const Game& game_;
   double epsilon_;
-  CFRInfoStateValuesTable info_states_;
+  const int num_threads_;
+  // As in ExternalSamplingMCCFRSolver, the table is locked to look up or
+  // insert information states, and their values have locks of their own.
+  absl::Mutex table_lock_;
+  BasicCFRInfoStateValuesTable<T> info_states_;
+  CFRInfoStateKeys info_state_keys_;
+  std::vector<absl::Mutex> value_locks_;
   int num_players_;
   int update_player_;
-  std::mt19937 rng_;
-  absl::uniform_real_distribution<double> dist_;
+  Philox rng_;
+  Workspace workspace_;
   std::shared_ptr<Policy> default_policy_;
 };
+using OutcomeSamplingMCCFRSolver = BasicOutcomeSamplingMCCFRSolver<double>;
 
 }  // namespace algorithms
 }  // namespace open_spiel
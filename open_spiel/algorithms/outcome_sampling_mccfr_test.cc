@@ -21,6 +21,7 @@
 #include "open_spiel/algorithms/tabular_exploitability.h"
 #include "open_spiel/games/kuhn_poker.h"
 #include "open_spiel/games/leduc_poker.h"
+#include "open_spiel/policy.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
 
@@ -29,6 +30,8 @@ namespace algorithms {
 namespace {
 
 constexpr int kSeed = 230398247;
+constexpr double kDefaultEpsilon =
+    OutcomeSamplingMCCFRSolver::kDefaultEpsilon;
 
 void MCCFR_2PGameTest(const std::string& game_name, std::mt19937* rng,
                       int iterations, double nashconv_upperbound) {
@@ -44,6 +47,55 @@ void MCCFR_2PGameTest(const std::string& game_name, std::mt19937* rng,
   SPIEL_CHECK_LE(nash_conv, nashconv_upperbound);
 }
 
+// With one thread, a batch of iterations runs the same ones as RunIteration.
+void MCCFR_BatchedTest() {
+  std::shared_ptr<const Game> game = LoadGame("leduc_poker");
+  OutcomeSamplingMCCFRSolver solver(*game, kDefaultEpsilon, kSeed);
+  OutcomeSamplingMCCFRSolver batched_solver(*game, kDefaultEpsilon, kSeed);
+  for (int i = 0; i < 1000; i++) solver.RunIteration();
+  batched_solver.RunIterations(1000);
+  for (const auto& [info_state, uniform_policy] :
+       GetUniformPolicy(*game).PolicyTable()) {
+    SPIEL_CHECK_TRUE(
+        batched_solver.AveragePolicy()->GetStatePolicy(info_state) ==
+        solver.AveragePolicy()->GetStatePolicy(info_state));
+  }
+}
+
+void MCCFR_ParallelTest(const std::string& game_name, int iterations,
+                        double nashconv_upperbound) {
+  std::shared_ptr<const Game> game = LoadGame(game_name);
+  OutcomeSamplingMCCFRSolver solver(*game, kDefaultEpsilon, kSeed,
+                                    /*num_threads=*/4);
+  solver.RunIterations(iterations);
+  const std::unique_ptr<Policy> average_policy = solver.AveragePolicy();
+  double nash_conv = NashConv(*game, *average_policy, true);
+  std::cout << "Game: " << game_name << ", iters = " << iterations
+            << ", 4 threads, NashConv: " << nash_conv << std::endl;
+  SPIEL_CHECK_LE(nash_conv, nashconv_upperbound);
+}
+
+void MCCFR_FloatValuesTest(const std::string& game_name, int iterations,
+                           double tolerance) {
+  std::shared_ptr<const Game> game = LoadGame(game_name);
+  OutcomeSamplingMCCFRSolver solver(*game);
+  BasicOutcomeSamplingMCCFRSolver<float> float_solver(*game);
+  std::mt19937 rng(kSeed);
+  std::mt19937 float_rng(kSeed);
+  for (int i = 0; i < iterations; i++) {
+    solver.RunIteration(&rng);
+    float_solver.RunIteration(&float_rng);
+  }
+  // The samples only differ where rounding moves a sampled action across
+  // the boundary between two, so the policies stay close.
+  double nash_conv = NashConv(*game, *solver.AveragePolicy(), true);
+  double float_nash_conv = NashConv(*game, *float_solver.AveragePolicy(), true);
+  std::cout << "Game: " << game_name << ", iters = " << iterations
+            << ", NashConv: " << nash_conv << " with doubles, "
+            << float_nash_conv << " with floats" << std::endl;
+  SPIEL_CHECK_LE(std::abs(float_nash_conv - nash_conv), tolerance);
+}
+
 }  // namespace
 }  // namespace algorithms
 }  // namespace open_spiel
@@ -55,7 +107,13 @@ int main(int argc, char** argv) {
   // Values double-checked with the original implementation used in (Lanctot,
   // "Monte Carlo Sampling and Regret Minimization For Equilibrium Computation
   // and Decision-Making in Large Extensive Form Games", 2013).
-  algorithms::MCCFR_2PGameTest("kuhn_poker", &rng, 10000, 0.04);
-  algorithms::MCCFR_2PGameTest("leduc_poker", &rng, 10000, 3);
+  algorithms::MCCFR_2PGameTest("kuhn_poker", &rng, 50000, 0.04);
+  algorithms::MCCFR_2PGameTest("leduc_poker", &rng, 20000, 3);
   algorithms::MCCFR_2PGameTest("liars_dice", &rng, 1000, 1.7);
+  algorithms::MCCFR_BatchedTest();
+  // The threads interleave differently from run to run, so these bounds leave
+  // more room than the ones above.
+  algorithms::MCCFR_ParallelTest("kuhn_poker", 50000, 0.1);
+  algorithms::MCCFR_ParallelTest("leduc_poker", 20000, 3.5);
+  algorithms::MCCFR_FloatValuesTest("leduc_poker", 10000, 0.1);
 }
@@ -0,0 +1,285 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/policy_file.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/container/flat_hash_map.h"
+#include "open_spiel/abseil-cpp/absl/container/flat_hash_set.h"
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/file.h"
+
+namespace open_spiel {
+namespace algorithms {
+
+constexpr char kMagic[8] = {'O', 'S', 'P', 'O', 'L', 'I', 'C', 'Y'};
+constexpr uint32_t kVersion = 1;
+
+// The sizes of all these are multiples of 8 bytes, so that every array of the
+// file stays aligned.
+struct MappedTabularPolicy::Header {
+  char magic[8];
+  uint32_t version;
+  uint32_t single_precision;
+  int64_t num_entries;
+  int64_t num_action_lists;
+  int64_t num_actions;  // Of all the distinct lists.
+  int64_t num_probs;    // Of all the entries.
+  int64_t string_bytes;
+};
+
+struct MappedTabularPolicy::Entry {
+  int64_t string_offset;
+  int64_t prob_offset;
+  int32_t string_size;
+  int32_t action_list;
+};
+
+static_assert(sizeof(Action) == 8, "Actions are written as 8 bytes.");
+
+namespace {
+
+template <typename T>
+void WriteBytes(file::File* file, const T* data, int64_t size) {
+  SPIEL_CHECK_TRUE(file->Write(
+      absl::string_view(reinterpret_cast<const char*>(data), size * sizeof(T))));
+}
+
+// The bytes taken by the probabilities, padded to a multiple of 8.
+int64_t ProbBytes(int64_t num_probs, bool single_precision) {
+  return single_precision ? (num_probs * sizeof(float) + 7) / 8 * 8
+                          : num_probs * sizeof(double);
+}
+
+}  // namespace
+
+void SavePolicyFile(const std::string& filename, const Policy& policy,
+                    std::vector<absl::string_view> info_states,
+                    bool single_precision) {
+  std::sort(info_states.begin(), info_states.end());
+  SPIEL_CHECK_TRUE(std::adjacent_find(info_states.begin(),
+                                      info_states.end()) == info_states.end());
+
+  MappedTabularPolicy::Header header;
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.single_precision = single_precision;
+  header.num_entries = info_states.size();
+  header.string_bytes = 0;
+
+  std::vector<MappedTabularPolicy::Entry> entries;
+  entries.reserve(info_states.size());
+  std::vector<int64_t> action_offsets = {0};
+  std::vector<Action> actions;
+  absl::flat_hash_map<std::vector<Action>, int> action_lists;
+  std::vector<double> probs;
+  std::vector<Action> state_actions;
+  for (absl::string_view info_state : info_states) {
+    const ActionsAndProbs state_policy =
+        policy.GetStatePolicy(std::string(info_state));
+    state_actions.clear();
+    for (const auto& [action, prob] : state_policy) {
+      state_actions.push_back(action);
+    }
+    auto [it, inserted] =
+        action_lists.emplace(state_actions, action_offsets.size() - 1);
+    if (inserted) {
+      actions.insert(actions.end(), state_actions.begin(), state_actions.end());
+      action_offsets.push_back(actions.size());
+    }
+    entries.push_back({header.string_bytes, static_cast<int64_t>(probs.size()),
+                       static_cast<int32_t>(info_state.size()), it->second});
+    for (const auto& [action, prob] : state_policy) probs.push_back(prob);
+    header.string_bytes += info_state.size();
+  }
+  header.num_action_lists = action_offsets.size() - 1;
+  header.num_actions = actions.size();
+  header.num_probs = probs.size();
+
+  // Written next to the file first, so that a policy is never seen half
+  // written, even by processes which have it mapped.
+  const std::string tmp_filename = absl::StrCat(filename, ".tmp");
+  {
+    file::File file(tmp_filename, "wb");
+    WriteBytes(&file, &header, 1);
+    WriteBytes(&file, entries.data(), entries.size());
+    WriteBytes(&file, action_offsets.data(), action_offsets.size());
+    WriteBytes(&file, actions.data(), actions.size());
+    if (single_precision) {
+      std::vector<float> single(probs.begin(), probs.end());
+      single.resize(ProbBytes(probs.size(), true) / sizeof(float), 0);
+      WriteBytes(&file, single.data(), single.size());
+    } else {
+      WriteBytes(&file, probs.data(), probs.size());
+    }
+    for (absl::string_view info_state : info_states) {
+      WriteBytes(&file, info_state.data(), info_state.size());
+    }
+    SPIEL_CHECK_TRUE(file.Flush());
+  }
+  if (std::rename(tmp_filename.c_str(), filename.c_str()) != 0) {
+    SpielFatalError(absl::StrCat("Could not write the policy ", filename));
+  }
+}
+
+void SavePolicyFile(const std::string& filename, const TabularPolicy& policy,
+                    bool single_precision) {
+  std::vector<absl::string_view> info_states;
+  info_states.reserve(policy.PolicyTable().size());
+  for (const auto& [info_state, state_policy] : policy.PolicyTable()) {
+    info_states.push_back(info_state);
+  }
+  SavePolicyFile(filename, policy, std::move(info_states), single_precision);
+}
+
+void SavePolicyFile(const std::string& filename,
+                    const CompactTabularPolicy& policy) {
+  std::vector<absl::string_view> info_states;
+  info_states.reserve(policy.NumInfoStates());
+  for (int i = 0; i < policy.NumInfoStates(); ++i) {
+    info_states.push_back(policy.InfoState(i));
+  }
+  SavePolicyFile(filename, policy, std::move(info_states),
+                 policy.SinglePrecision());
+}
+
+template <typename T>
+void SaveCFRAveragePolicy(const std::string& filename,
+                          const BasicCFRInfoStateValuesTable<T>& info_states,
+                          const CFRInfoStateKeys& info_state_keys,
+                          bool single_precision) {
+  // The entries are saved under their information state strings, which are
+  // their keys unless recorded otherwise.
+  absl::flat_hash_set<absl::string_view> aliased_keys;
+  std::vector<absl::string_view> strings;
+  strings.reserve(info_states.size());
+  for (const auto& [info_state, key] : info_state_keys) {
+    if (info_states.Find(key) < 0) continue;
+    aliased_keys.insert(key);
+    strings.push_back(info_state);
+  }
+  for (const auto& [key, id] : info_states.ids()) {
+    if (!aliased_keys.contains(key)) strings.push_back(key);
+  }
+  BasicCFRAveragePolicy<T> policy(info_states, /*default_policy=*/nullptr,
+                                  &info_state_keys);
+  SavePolicyFile(filename, policy, std::move(strings), single_precision);
+}
+
+MappedTabularPolicy::MappedTabularPolicy(const std::string& filename)
+    : file_(filename, {file::MMapFile::Access::kRandom}) {
+  if (file_.size() < static_cast<int64_t>(sizeof(Header))) {
+    SpielFatalError(absl::StrCat(filename, " is not a policy file"));
+  }
+  const Header* header = reinterpret_cast<const Header*>(file_.data());
+  if (std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0) {
+    SpielFatalError(absl::StrCat(filename, " is not a policy file"));
+  }
+  if (header->version != kVersion) {
+    SpielFatalError(absl::StrCat("Unsupported version ", header->version,
+                                 " of the policy file ", filename));
+  }
+  single_precision_ = header->single_precision;
+  num_entries_ = header->num_entries;
+  num_action_lists_ = header->num_action_lists;
+
+  const char* next = file_.data() + sizeof(Header);
+  entries_ = reinterpret_cast<const Entry*>(next);
+  next += num_entries_ * sizeof(Entry);
+  action_offsets_ = reinterpret_cast<const int64_t*>(next);
+  next += (num_action_lists_ + 1) * sizeof(int64_t);
+  actions_ = reinterpret_cast<const Action*>(next);
+  next += header->num_actions * sizeof(Action);
+  probs_ = next;
+  next += ProbBytes(header->num_probs, single_precision_);
+  strings_ = next;
+  next += header->string_bytes;
+  if (next - file_.data() != file_.size()) {
+    SpielFatalError(absl::StrCat("The policy file ", filename,
+                                 " has the wrong size: ", file_.size(),
+                                 " bytes instead of ", next - file_.data()));
+  }
+  for (int i = 0; i <= num_action_lists_; ++i) {
+    SPIEL_CHECK_LE(action_offsets_[i], header->num_actions);
+  }
+  for (int id = 0; id < num_entries_; ++id) {
+    const Entry& entry = entries_[id];
+    SPIEL_CHECK_LE(entry.string_offset + entry.string_size,
+                   header->string_bytes);
+    SPIEL_CHECK_LT(entry.action_list, num_action_lists_);
+    SPIEL_CHECK_LE(entry.prob_offset + Actions(id).size(), header->num_probs);
+  }
+}
+
+absl::string_view MappedTabularPolicy::InfoState(int id) const {
+  return absl::string_view(strings_ + entries_[id].string_offset,
+                           entries_[id].string_size);
+}
+
+absl::Span<const Action> MappedTabularPolicy::Actions(int id) const {
+  const int list = entries_[id].action_list;
+  return absl::MakeConstSpan(actions_ + action_offsets_[list],
+                             action_offsets_[list + 1] - action_offsets_[list]);
+}
+
+double MappedTabularPolicy::Prob(int id, int action_index) const {
+  const int64_t i = entries_[id].prob_offset + action_index;
+  return single_precision_ ? reinterpret_cast<const float*>(probs_)[i]
+                           : reinterpret_cast<const double*>(probs_)[i];
+}
+
+int MappedTabularPolicy::Find(absl::string_view info_state) const {
+  int begin = 0;
+  int end = num_entries_;
+  while (begin < end) {
+    const int middle = begin + (end - begin) / 2;
+    if (InfoState(middle) < info_state) {
+      begin = middle + 1;
+    } else {
+      end = middle;
+    }
+  }
+  return begin < num_entries_ && InfoState(begin) == info_state ? begin : -1;
+}
+
+ActionsAndProbs MappedTabularPolicy::GetStatePolicy(
+    const std::string& info_state) const {
+  const int id = Find(info_state);
+  if (id < 0) return {};
+  absl::Span<const Action> actions = Actions(id);
+  ActionsAndProbs state_policy;
+  state_policy.reserve(actions.size());
+  for (int i = 0; i < actions.size(); ++i) {
+    state_policy.push_back({actions[i], Prob(id, i)});
+  }
+  return state_policy;
+}
+
+template void SaveCFRAveragePolicy(const std::string&,
+                                   const BasicCFRInfoStateValuesTable<double>&,
+                                   const CFRInfoStateKeys&, bool);
+template void SaveCFRAveragePolicy(const std::string&,
+                                   const BasicCFRInfoStateValuesTable<float>&,
+                                   const CFRInfoStateKeys&, bool);
+
+}  // namespace algorithms
+}  // namespace open_spiel
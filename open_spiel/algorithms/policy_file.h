@@ -0,0 +1,104 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_ALGORITHMS_POLICY_FILE_H_
+#define OPEN_SPIEL_ALGORITHMS_POLICY_FILE_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/strings/string_view.h"
+#include "open_spiel/abseil-cpp/absl/types/span.h"
+#include "open_spiel/algorithms/cfr.h"
+#include "open_spiel/policy.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/utils/file.h"
+
+// Binary files of tabular policies, which are served by MappedTabularPolicy
+// straight from the file mapped into memory, without being parsed. A fleet of
+// processes can then share one large policy through the page cache.
+//
+// The file starts with a versioned header, followed by the entries sorted by
+// information state string, the distinct lists of actions (as in
+// CompactTabularPolicy), the probabilities of all the entries in double or
+// single precision, and the bytes of the strings. The numbers are written in
+// the byte order of the machine, so a file should be read on the same
+// architecture that wrote it.
+namespace open_spiel {
+namespace algorithms {
+
+// Writes the policy of each of the information states, in any order. The
+// policy is queried by information state string.
+void SavePolicyFile(const std::string& filename, const Policy& policy,
+                    std::vector<absl::string_view> info_states,
+                    bool single_precision = false);
+
+// Writes all the information states of the table.
+void SavePolicyFile(const std::string& filename, const TabularPolicy& policy,
+                    bool single_precision = false);
+void SavePolicyFile(const std::string& filename,
+                    const CompactTabularPolicy& policy);
+
+// Writes the average policy of all the information states of a CFR table, as
+// CFRAveragePolicy returns it. The solvers' SaveAveragePolicy call this.
+template <typename T>
+void SaveCFRAveragePolicy(const std::string& filename,
+                          const BasicCFRInfoStateValuesTable<T>& info_states,
+                          const CFRInfoStateKeys& info_state_keys,
+                          bool single_precision = false);
+
+// A read-only policy served from a policy file, mapped for as long as this
+// lives. Lookups are a binary search over the file, and are safe to make
+// concurrently. Its entries are numbered in the order of their information
+// state strings.
+class MappedTabularPolicy : public Policy {
+ public:
+  explicit MappedTabularPolicy(const std::string& filename);
+
+  ActionsAndProbs GetStatePolicy(const std::string& info_state) const override;
+
+  int NumInfoStates() const { return num_entries_; }
+  bool SinglePrecision() const { return single_precision_; }
+
+  // Returns the entry of the information state, or -1 if there is none.
+  int Find(absl::string_view info_state) const;
+
+  absl::string_view InfoState(int id) const;
+  absl::Span<const Action> Actions(int id) const;
+  double Prob(int id, int action_index) const;
+
+ private:
+  friend void SavePolicyFile(const std::string& filename, const Policy& policy,
+                             std::vector<absl::string_view> info_states,
+                             bool single_precision);
+
+  struct Header;
+  struct Entry;
+
+  file::MMapFile file_;
+  bool single_precision_;
+  int num_entries_;
+  int num_action_lists_;
+  const Entry* entries_;
+  const int64_t* action_offsets_;
+  const Action* actions_;
+  const char* probs_;
+  const char* strings_;
+};
+
+}  // namespace algorithms
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_ALGORITHMS_POLICY_FILE_H_
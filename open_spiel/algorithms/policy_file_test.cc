@@ -0,0 +1,102 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/policy_file.h"
+
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/algorithms/cfr.h"
+#include "open_spiel/algorithms/external_sampling_mccfr.h"
+#include "open_spiel/algorithms/outcome_sampling_mccfr.h"
+#include "open_spiel/algorithms/tabular_exploitability.h"
+#include "open_spiel/policy.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/tests/basic_tests.h"
+#include "open_spiel/utils/file.h"
+
+namespace open_spiel {
+namespace algorithms {
+namespace {
+
+std::string PolicyFilename(const std::string& name) {
+  return absl::StrCat(file::GetTmpDir(), "/open_spiel-test-",
+                      std::rand(), "-", name);  // NOLINT
+}
+
+void PolicyFileTest_TabularPolicy() {
+  std::shared_ptr<const Game> game = LoadGame("leduc_poker");
+  const TabularPolicy policy = GetRandomPolicy(*game, /*seed=*/5);
+  const std::string filename = PolicyFilename("leduc.policy");
+  SavePolicyFile(filename, policy);
+
+  const MappedTabularPolicy mapped(filename);
+  SPIEL_CHECK_FALSE(mapped.SinglePrecision());
+  SPIEL_CHECK_EQ(mapped.NumInfoStates(), policy.PolicyTable().size());
+  SPIEL_CHECK_EQ(mapped.Find("not an information state"), -1);
+  SPIEL_CHECK_TRUE(mapped.GetStatePolicy("not an information state").empty());
+  for (int id = 0; id < mapped.NumInfoStates(); ++id) {
+    SPIEL_CHECK_EQ(mapped.Find(mapped.InfoState(id)), id);
+  }
+  testing::CheckSamePolicies(*game, mapped, policy);
+  SPIEL_CHECK_EQ(Exploitability(*game, mapped),
+                 Exploitability(*game, policy));
+
+  // Single precision, from a compact policy.
+  SavePolicyFile(filename, CompactTabularPolicy(policy,
+                                                /*single_precision=*/true));
+  const MappedTabularPolicy single(filename);
+  SPIEL_CHECK_TRUE(single.SinglePrecision());
+  testing::CheckSamePolicies(*game, single, policy, 1e-7);
+  SPIEL_CHECK_TRUE(file::Remove(filename));
+}
+
+void PolicyFileTest_CFRSolvers() {
+  std::shared_ptr<const Game> game = LoadGame("kuhn_poker");
+  const std::string filename = PolicyFilename("kuhn.policy");
+
+  CFRSolver cfr(*game);
+  for (int i = 0; i < 10; ++i) cfr.EvaluateAndUpdatePolicy();
+  cfr.SaveAveragePolicy(filename);
+  testing::CheckSamePolicies(*game, MappedTabularPolicy(filename),
+                             *cfr.AveragePolicy());
+
+  ExternalSamplingMCCFRSolver external_sampling(*game, /*seed=*/1);
+  for (int i = 0; i < 100; ++i) external_sampling.RunIteration();
+  external_sampling.SaveAveragePolicy(filename);
+  testing::CheckSamePolicies(*game, MappedTabularPolicy(filename),
+                             *external_sampling.AveragePolicy());
+
+  OutcomeSamplingMCCFRSolver outcome_sampling(*game, /*epsilon=*/0.6,
+                                              /*seed=*/1);
+  for (int i = 0; i < 1000; ++i) outcome_sampling.RunIteration();
+  outcome_sampling.SaveAveragePolicy(filename, /*single_precision=*/true);
+  const MappedTabularPolicy mapped(filename);
+  SPIEL_CHECK_TRUE(mapped.SinglePrecision());
+  testing::CheckSamePolicies(*game, mapped, *outcome_sampling.AveragePolicy(),
+                             1e-7);
+  SPIEL_CHECK_TRUE(file::Remove(filename));
+}
+
+}  // namespace
+}  // namespace algorithms
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  open_spiel::algorithms::PolicyFileTest_TabularPolicy();
+  open_spiel::algorithms::PolicyFileTest_CFRSolvers();
+}
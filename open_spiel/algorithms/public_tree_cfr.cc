@@ -0,0 +1,708 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/public_tree_cfr.h"
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "open_spiel/games/universal_poker.h"
+#include "open_spiel/games/universal_poker/logic/card_set.h"
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace algorithms {
+namespace {
+
+using universal_poker::UniversalPokerGame;
+using universal_poker::UniversalPokerState;
+using universal_poker::logic::CardSet;
+
+bool AllZero(const std::vector<double>& values) {
+  return std::all_of(values.begin(), values.end(),
+                     [](double value) { return value == 0; });
+}
+
+}  // namespace
+
+class PublicTreeCFRSolver::PublicTreePolicy : public Policy {
+ public:
+  PublicTreePolicy(const PublicTreeCFRSolver& solver, bool average)
+      : solver_(solver), average_(average) {}
+
+  ActionsAndProbs GetStatePolicy(const State& state) const override {
+    return solver_.GetStatePolicy(state, average_);
+  }
+
+  const PublicTreeCFRSolver& solver() const { return solver_; }
+  bool average() const { return average_; }
+
+ private:
+  const PublicTreeCFRSolver& solver_;
+  const bool average_;
+};
+
+PublicTreeCFRSolver::PublicTreeCFRSolver(const Game& game) {
+  InitHands(game);
+  root_ranges_.assign(2, std::vector<double>(hands_.size(), 1.0));
+  // Each pair of hands which don't share cards is dealt with the same
+  // probability, which the opponent's reach of the root includes.
+  double num_deals = 1;
+  for (int i = 0; i < 2 * num_hole_cards_; ++i) num_deals *= num_deck_cards_ - i;
+  for (int i = 1; i <= num_hole_cards_; ++i) num_deals /= i * i;
+  root_chance_reach_ = 1.0 / num_deals;
+
+  // The betting is the same whatever the cards, so it is built from the
+  // states following one deal of them.
+  std::unique_ptr<State> state = game.NewInitialState();
+  for (int i = 0; i < 2 * num_hole_cards_; ++i) {
+    state->ApplyAction(state->LegalActions()[0]);
+  }
+  root_history_size_ = state->FullHistory().size();
+  root_ = AddBettingNodes(state.get());
+}
+
+PublicTreeCFRSolver::PublicTreeCFRSolver(
+    const State& root, const std::vector<std::vector<double>>& ranges,
+    int max_rounds, PublicTreeLeafValues leaf_values)
+    : leaf_values_(std::move(leaf_values)) {
+  InitHands(*root.GetGame());
+  SPIEL_CHECK_FALSE(root.IsChanceNode());
+  SPIEL_CHECK_FALSE(root.IsTerminal());
+  const auto& poker_state = static_cast<const UniversalPokerState&>(root);
+  root_board_ = poker_state.board_cards_.cs.cards;
+  SPIEL_CHECK_EQ(ranges.size(), 2);
+  root_ranges_ = ranges;
+  for (std::vector<double>& range : root_ranges_) {
+    SPIEL_CHECK_EQ(range.size(), hands_.size());
+    for (int hand = 0; hand < hands_.size(); ++hand) {
+      if (hands_[hand] & root_board_) range[hand] = 0;
+    }
+  }
+  if (max_rounds >= 0) {
+    max_round_ = poker_state.acpc_state().GetRound() + max_rounds;
+  }
+  std::unique_ptr<State> state = root.Clone();
+  root_history_size_ = state->FullHistory().size();
+  root_ = AddBettingNodes(state.get());
+}
+
+void PublicTreeCFRSolver::InitHands(const Game& game) {
+  const auto* poker_game = dynamic_cast<const UniversalPokerGame*>(&game);
+  if (poker_game == nullptr || game.NumPlayers() != 2) {
+    SpielFatalError(
+        "PublicTreeCFRSolver only supports two player universal_poker.");
+  }
+  game_ = game.shared_from_this();
+  const universal_poker::acpc_cpp::ACPCGame& acpc_game =
+      *poker_game->GetACPCGame();
+  num_hole_cards_ = acpc_game.GetNbHoleCardsRequired();
+  SPIEL_CHECK_GE(num_hole_cards_, 1);
+  SPIEL_CHECK_LE(num_hole_cards_, 2);
+
+  CardSet deck(acpc_game.NumSuitsDeck(), acpc_game.NumRanksDeck());
+  num_deck_cards_ = deck.NumCards();
+  const std::vector<uint8_t> cards = deck.ToCardArray();
+  card_masks_.resize(cards.back() + 1, 0);
+  card_hands_.resize(cards.back() + 1);
+  for (uint8_t card : cards) {
+    CardSet card_set;
+    card_set.AddCard(card);
+    card_masks_[card] = card_set.cs.cards;
+  }
+  for (const CardSet& hand : deck.SampleCards(num_hole_cards_)) {
+    const int id = hands_.size();
+    hands_.push_back(hand.cs.cards);
+    hand_ids_[hand.cs.cards] = id;
+    hand_cards_.emplace_back();
+    for (uint8_t card : hand.ToCardArray()) {
+      hand_cards_.back().push_back(card);
+      card_hands_[card].push_back(id);
+    }
+  }
+}
+
+int PublicTreeCFRSolver::AddBettingNodes(State* state) {
+  const auto& poker_state = static_cast<const UniversalPokerState&>(*state);
+  const int index = nodes_.size();
+  nodes_.emplace_back();
+  BettingNode node;
+  if (state->IsTerminal()) {
+    const auto& acpc_state = poker_state.acpc_state();
+    if (acpc_state.NumFolded() > 0) {
+      node.type = BettingNode::kFold;
+      node.value = state->Returns()[0];
+    } else {
+      node.type = BettingNode::kShowdown;
+      SPIEL_CHECK_EQ(acpc_state.Ante(0), acpc_state.Ante(1));
+      node.value = acpc_state.Ante(0);
+    }
+  } else if (state->IsChanceNode() && max_round_ >= 0 &&
+             poker_state.acpc_state().GetRound() > max_round_ &&
+             leaf_values_ != nullptr) {
+    node.type = BettingNode::kLeaf;
+    node.leaf = leaf_states_.size();
+    leaf_states_.push_back(state->Clone());
+  } else if (state->IsChanceNode()) {
+    const auto& acpc_game = *poker_state.acpc_game_;
+    const int round = poker_state.acpc_state().GetRound();
+    const int dealt_before =
+        round == 0 ? 0 : acpc_game.GetNbBoardCardsRequired(round - 1);
+    node.type = BettingNode::kChance;
+    node.round_index = poker_state.board_cards_.NumCards() - dealt_before;
+    node.round_size = acpc_game.GetNbBoardCardsRequired(round) - dealt_before;
+    std::unique_ptr<State> child = state->Child(state->LegalActions()[0]);
+    node.children.push_back(AddBettingNodes(child.get()));
+  } else {
+    node.type = BettingNode::kDecision;
+    node.player = state->CurrentPlayer();
+    // Past the last round of the subgame, without leaf values, the players
+    // check or call to the end.
+    if (max_round_ >= 0 && poker_state.acpc_state().GetRound() > max_round_) {
+      node.actions = {universal_poker::kCall};
+    } else {
+      node.actions = state->LegalActions();
+    }
+    for (Action action : node.actions) {
+      std::unique_ptr<State> child = state->Child(action);
+      node.children.push_back(AddBettingNodes(child.get()));
+    }
+  }
+  nodes_[index] = std::move(node);
+  return index;
+}
+
+int PublicTreeCFRSolver::GetPublicState(int node, uint64_t board) {
+  auto [it, inserted] =
+      public_state_ids_.try_emplace({node, board}, public_states_.size());
+  if (inserted) {
+    const int size = nodes_[node].actions.size() * hands_.size();
+    const int offset = cumulative_regrets_.size();
+    public_states_.push_back({node, board, offset});
+    cumulative_regrets_.resize(offset + size, 0);
+    cumulative_policy_.resize(offset + size, 0);
+    current_policy_.resize(offset + size, 1.0 / nodes_[node].actions.size());
+  }
+  return it->second;
+}
+
+const PublicTreeCFRSolver::HandRanking& PublicTreeCFRSolver::GetHandRanking(
+    uint64_t board) {
+  auto [it, inserted] = hand_rankings_.try_emplace(board);
+  HandRanking& ranking = it->second;
+  if (inserted) {
+    // The hands which share cards with the board are left out.
+    std::vector<std::pair<int, int>> ranked_hands;
+    for (int hand = 0; hand < hands_.size(); ++hand) {
+      if (hands_[hand] & board) continue;
+      CardSet cards;
+      cards.cs.cards = hands_[hand] | board;
+      ranked_hands.push_back({cards.RankCards(), hand});
+    }
+    std::sort(ranked_hands.begin(), ranked_hands.end());
+    for (const auto& [rank, hand] : ranked_hands) {
+      ranking.ranks.push_back(rank);
+      ranking.order.push_back(hand);
+    }
+  }
+  return ranking;
+}
+
+void PublicTreeCFRSolver::EvaluateAndUpdatePolicy() {
+  std::vector<double> opponent_reach;
+  std::vector<double> values;
+  for (Player player = 0; player < 2; ++player) {
+    opponent_reach = root_ranges_[1 - player];
+    for (double& reach : opponent_reach) reach *= root_chance_reach_;
+    ComputeCounterFactualRegret(root_, root_board_, /*last_card=*/-1, player,
+                                root_ranges_[player], opponent_reach, &values);
+    ApplyRegretMatching(player);
+  }
+}
+
+void PublicTreeCFRSolver::ComputeCounterFactualRegret(
+    int node, uint64_t board, int last_card, Player player,
+    const std::vector<double>& reach,
+    const std::vector<double>& opponent_reach, std::vector<double>* values) {
+  const int num_hands = hands_.size();
+  values->assign(num_hands, 0);
+  const BettingNode& betting_node = nodes_[node];
+  if (betting_node.type == BettingNode::kFold) {
+    FoldValues(player == 0 ? betting_node.value : -betting_node.value,
+               opponent_reach, values);
+    return;
+  }
+  if (betting_node.type == BettingNode::kShowdown) {
+    ShowdownValues(betting_node.value, board, opponent_reach, values);
+    return;
+  }
+  if (betting_node.type == BettingNode::kLeaf) {
+    leaf_values_(*leaf_states_[betting_node.leaf], board, player,
+                 opponent_reach, values);
+    return;
+  }
+  if (AllZero(reach) && AllZero(opponent_reach)) return;
+
+  std::vector<double> child_reach;
+  std::vector<double> child_opponent_reach;
+  std::vector<double> child_values;
+  if (betting_node.type == BettingNode::kChance) {
+    // The board cards of a round are dealt in increasing order, as the
+    // state is the same whichever order they come in, so the probability of
+    // each set of them is that of all its orders.
+    const int num_remaining_cards = num_deck_cards_ - 2 * num_hole_cards_ -
+                                    __builtin_popcountll(board);
+    const double prob =
+        static_cast<double>(betting_node.round_size - betting_node.round_index) /
+        num_remaining_cards;
+    const int first_card = betting_node.round_index == 0 ? 0 : last_card + 1;
+    for (int card = first_card; card < card_masks_.size(); ++card) {
+      if (card_masks_[card] == 0 || (card_masks_[card] & board)) continue;
+      child_reach = reach;
+      child_opponent_reach = opponent_reach;
+      for (int hand = 0; hand < num_hands; ++hand) {
+        child_opponent_reach[hand] *= prob;
+      }
+      for (int hand : card_hands_[card]) {
+        child_reach[hand] = 0;
+        child_opponent_reach[hand] = 0;
+      }
+      ComputeCounterFactualRegret(betting_node.children[0],
+                                  board | card_masks_[card], card, player,
+                                  child_reach, child_opponent_reach,
+                                  &child_values);
+      for (int hand : card_hands_[card]) child_values[hand] = 0;
+      for (int hand = 0; hand < num_hands; ++hand) {
+        (*values)[hand] += child_values[hand];
+      }
+    }
+    return;
+  }
+
+  const int num_actions = betting_node.actions.size();
+  if (num_actions == 1) {
+    // There is nothing to choose, e.g. when checking down, so no public
+    // state is kept.
+    ComputeCounterFactualRegret(betting_node.children[0], board, last_card,
+                                player, reach, opponent_reach, values);
+    return;
+  }
+  const int offset = public_states_[GetPublicState(node, board)].offset;
+  if (betting_node.player != player) {
+    for (int aidx = 0; aidx < num_actions; ++aidx) {
+      const double* policy = current_policy_.data() + offset + aidx * num_hands;
+      child_opponent_reach = opponent_reach;
+      for (int hand = 0; hand < num_hands; ++hand) {
+        child_opponent_reach[hand] *= policy[hand];
+      }
+      ComputeCounterFactualRegret(betting_node.children[aidx], board,
+                                  last_card, player, reach,
+                                  child_opponent_reach, &child_values);
+      for (int hand = 0; hand < num_hands; ++hand) {
+        (*values)[hand] += child_values[hand];
+      }
+    }
+    return;
+  }
+
+  // The values of each action, one row per action, then the regret and
+  // average policy updates.
+  std::vector<double> action_values(num_actions * num_hands);
+  for (int aidx = 0; aidx < num_actions; ++aidx) {
+    const double* policy = current_policy_.data() + offset + aidx * num_hands;
+    child_reach = reach;
+    for (int hand = 0; hand < num_hands; ++hand) {
+      child_reach[hand] *= policy[hand];
+    }
+    ComputeCounterFactualRegret(betting_node.children[aidx], board, last_card,
+                                player, child_reach, opponent_reach,
+                                &child_values);
+    std::copy(child_values.begin(), child_values.end(),
+              action_values.begin() + aidx * num_hands);
+    for (int hand = 0; hand < num_hands; ++hand) {
+      (*values)[hand] += policy[hand] * child_values[hand];
+    }
+  }
+  for (int aidx = 0; aidx < num_actions; ++aidx) {
+    const int row = offset + aidx * num_hands;
+    const double* policy = current_policy_.data() + row;
+    double* regrets = cumulative_regrets_.data() + row;
+    double* average = cumulative_policy_.data() + row;
+    const double* action_value = action_values.data() + aidx * num_hands;
+    for (int hand = 0; hand < num_hands; ++hand) {
+      regrets[hand] += action_value[hand] - (*values)[hand];
+      average[hand] += reach[hand] * policy[hand];
+    }
+  }
+}
+
+// The opponent reach of the hands compatible with each hand is the total,
+// minus that of the hands sharing each of its cards, plus that of the hand
+// itself for each of its cards but one, as it shares all of them.
+void PublicTreeCFRSolver::FoldValues(
+    double value, const std::vector<double>& opponent_reach,
+    std::vector<double>* values) const {
+  const double total =
+      std::accumulate(opponent_reach.begin(), opponent_reach.end(), 0.0);
+  std::vector<double> card_reach(card_hands_.size(), 0);
+  for (int card = 0; card < card_hands_.size(); ++card) {
+    for (int hand : card_hands_[card]) card_reach[card] += opponent_reach[hand];
+  }
+  for (int hand = 0; hand < hands_.size(); ++hand) {
+    double reach = total + (num_hole_cards_ - 1) * opponent_reach[hand];
+    for (int card : hand_cards_[hand]) reach -= card_reach[card];
+    (*values)[hand] = value * reach;
+  }
+}
+
+// Each hand wins against the compatible hands ranked lower, and loses against
+// the ones ranked higher, which are summed up going through the hands in
+// order in both directions, a group of equal ranks at a time. The hand itself
+// is never in those, so only the hands sharing each of its cards are taken
+// out.
+void PublicTreeCFRSolver::ShowdownValues(
+    double value, uint64_t board, const std::vector<double>& opponent_reach,
+    std::vector<double>* values) {
+  const HandRanking& ranking = GetHandRanking(board);
+  const int num_ranked = ranking.order.size();
+  std::vector<double> card_reach(card_hands_.size());
+  for (int direction : {1, -1}) {
+    double total = 0;
+    std::fill(card_reach.begin(), card_reach.end(), 0);
+    int begin = direction == 1 ? 0 : num_ranked - 1;
+    while (begin >= 0 && begin < num_ranked) {
+      int end = begin;
+      while (end >= 0 && end < num_ranked &&
+             ranking.ranks[end] == ranking.ranks[begin]) {
+        end += direction;
+      }
+      for (int i = begin; i != end; i += direction) {
+        const int hand = ranking.order[i];
+        double reach = total;
+        for (int card : hand_cards_[hand]) reach -= card_reach[card];
+        (*values)[hand] += direction * value * reach;
+      }
+      for (int i = begin; i != end; i += direction) {
+        const int hand = ranking.order[i];
+        total += opponent_reach[hand];
+        for (int card : hand_cards_[hand]) {
+          card_reach[card] += opponent_reach[hand];
+        }
+      }
+      begin = end;
+    }
+  }
+}
+
+void PublicTreeCFRSolver::ApplyRegretMatching(Player player) {
+  const int num_hands = hands_.size();
+  std::vector<double> sum_positive_regrets(num_hands);
+  for (const PublicState& public_state : public_states_) {
+    const BettingNode& node = nodes_[public_state.node];
+    if (node.player != player) continue;
+    const int num_actions = node.actions.size();
+    const double* regrets = cumulative_regrets_.data() + public_state.offset;
+    double* policy = current_policy_.data() + public_state.offset;
+    std::fill(sum_positive_regrets.begin(), sum_positive_regrets.end(), 0);
+    for (int i = 0; i < num_actions * num_hands; i += num_hands) {
+      for (int hand = 0; hand < num_hands; ++hand) {
+        sum_positive_regrets[hand] += std::max(regrets[i + hand], 0.0);
+      }
+    }
+    for (int i = 0; i < num_actions * num_hands; i += num_hands) {
+      for (int hand = 0; hand < num_hands; ++hand) {
+        policy[i + hand] =
+            sum_positive_regrets[hand] > 0
+                ? std::max(regrets[i + hand], 0.0) / sum_positive_regrets[hand]
+                : 1.0 / num_actions;
+      }
+    }
+  }
+}
+
+ActionsAndProbs PublicTreeCFRSolver::GetStatePolicy(const State& state,
+                                                    bool average) const {
+  const auto& poker_state = static_cast<const UniversalPokerState&>(state);
+  const Player player = state.CurrentPlayer();
+  SPIEL_CHECK_GE(player, 0);
+
+  const int node = FindNode(state);
+  auto it = node < 0 ? public_state_ids_.end()
+                     : public_state_ids_.find(
+                           {node, poker_state.board_cards_.cs.cards});
+  ActionsAndProbs actions_and_probs;
+  if (it == public_state_ids_.end()) {
+    const std::vector<Action> actions = state.LegalActions();
+    for (Action action : actions) {
+      actions_and_probs.push_back({action, 1.0 / actions.size()});
+    }
+    return actions_and_probs;
+  }
+
+  const BettingNode& betting_node = nodes_[node];
+  const int num_actions = betting_node.actions.size();
+
+  const int num_hands = hands_.size();
+  const int hand = hand_ids_.at(poker_state.hole_cards_[player].cs.cards);
+  const int offset = public_states_[it->second].offset + hand;
+  const std::vector<double>& table =
+      average ? cumulative_policy_ : current_policy_;
+  double sum_prob = 0;
+  for (int aidx = 0; aidx < num_actions; ++aidx) {
+    sum_prob += table[offset + aidx * num_hands];
+  }
+  for (int aidx = 0; aidx < num_actions; ++aidx) {
+    actions_and_probs.push_back(
+        {betting_node.actions[aidx],
+         sum_prob > 0 ? table[offset + aidx * num_hands] / sum_prob
+                      : 1.0 / num_actions});
+  }
+  return actions_and_probs;
+}
+
+int PublicTreeCFRSolver::FindNode(const State& state) const {
+  // Follows the betting of the state from the root.
+  const std::vector<Action>& history = state.FullHistory();
+  SPIEL_CHECK_GE(history.size(), root_history_size_);
+  int node = root_;
+  for (int i = root_history_size_; i < history.size(); ++i) {
+    const BettingNode& betting_node = nodes_[node];
+    if (betting_node.type == BettingNode::kLeaf) return -1;
+    if (betting_node.type == BettingNode::kChance) {
+      node = betting_node.children[0];
+    } else {
+      auto it = std::find(betting_node.actions.begin(),
+                          betting_node.actions.end(), history[i]);
+      // Players may bet where the subgame has them check down.
+      if (it == betting_node.actions.end()) return -1;
+      node = betting_node.children[it - betting_node.actions.begin()];
+    }
+  }
+  return nodes_[node].type == BettingNode::kLeaf ? -1 : node;
+}
+
+std::vector<double> PublicTreeCFRSolver::AverageActionProbabilities(
+    const State& state, Action action) const {
+  const auto& poker_state = static_cast<const UniversalPokerState&>(state);
+  const int num_hands = hands_.size();
+  const int node = FindNode(state);
+  auto it = node < 0 ? public_state_ids_.end()
+                     : public_state_ids_.find(
+                           {node, poker_state.board_cards_.cs.cards});
+  if (it == public_state_ids_.end()) {
+    return std::vector<double>(num_hands, 1.0 / state.LegalActions().size());
+  }
+
+  const std::vector<Action>& actions = nodes_[node].actions;
+  const int num_actions = actions.size();
+  auto action_it = std::find(actions.begin(), actions.end(), action);
+  SPIEL_CHECK_TRUE(action_it != actions.end());
+  const double* policy =
+      cumulative_policy_.data() + public_states_[it->second].offset;
+  const double* action_policy =
+      policy + (action_it - actions.begin()) * num_hands;
+  std::vector<double> probs(num_hands);
+  for (int hand = 0; hand < num_hands; ++hand) {
+    double sum_prob = 0;
+    for (int aidx = 0; aidx < num_actions; ++aidx) {
+      sum_prob += policy[aidx * num_hands + hand];
+    }
+    probs[hand] =
+        sum_prob > 0 ? action_policy[hand] / sum_prob : 1.0 / num_actions;
+  }
+  return probs;
+}
+
+double PublicTreeCFRSolver::BestResponseValue(Player player,
+                                              const Policy& policy) {
+  SPIEL_CHECK_EQ(root_history_size_, 2 * num_hole_cards_);
+  SPIEL_CHECK_EQ(root_board_, 0);
+  SPIEL_CHECK_LT(max_round_, 0);
+  std::vector<double> opponent_reach = root_ranges_[1 - player];
+  for (double& reach : opponent_reach) reach *= root_chance_reach_;
+  std::vector<Action> history;
+  std::vector<double> values;
+  BestResponseValues(root_, root_board_, /*last_card=*/-1, player, policy,
+                     opponent_reach, &history, &values);
+  double value = 0;
+  for (int hand = 0; hand < hands_.size(); ++hand) {
+    value += root_ranges_[player][hand] * values[hand];
+  }
+  return value;
+}
+
+double PublicTreeCFRSolver::NashConv(const Policy& policy) {
+  return BestResponseValue(0, policy) + BestResponseValue(1, policy);
+}
+
+void PublicTreeCFRSolver::BestResponseValues(
+    int node, uint64_t board, int last_card, Player player,
+    const Policy& policy, const std::vector<double>& opponent_reach,
+    std::vector<Action>* history, std::vector<double>* values) {
+  const int num_hands = hands_.size();
+  values->assign(num_hands, 0);
+  const BettingNode& betting_node = nodes_[node];
+  if (betting_node.type == BettingNode::kFold) {
+    FoldValues(player == 0 ? betting_node.value : -betting_node.value,
+               opponent_reach, values);
+    return;
+  }
+  if (betting_node.type == BettingNode::kShowdown) {
+    ShowdownValues(betting_node.value, board, opponent_reach, values);
+    return;
+  }
+  if (AllZero(opponent_reach)) return;
+
+  std::vector<double> child_opponent_reach;
+  std::vector<double> child_values;
+  if (betting_node.type == BettingNode::kChance) {
+    const int num_remaining_cards = num_deck_cards_ - 2 * num_hole_cards_ -
+                                    __builtin_popcountll(board);
+    const double prob =
+        static_cast<double>(betting_node.round_size - betting_node.round_index) /
+        num_remaining_cards;
+    const int first_card = betting_node.round_index == 0 ? 0 : last_card + 1;
+    for (int card = first_card; card < card_masks_.size(); ++card) {
+      if (card_masks_[card] == 0 || (card_masks_[card] & board)) continue;
+      child_opponent_reach = opponent_reach;
+      for (int hand = 0; hand < num_hands; ++hand) {
+        child_opponent_reach[hand] *= prob;
+      }
+      for (int hand : card_hands_[card]) child_opponent_reach[hand] = 0;
+      history->push_back(card);
+      BestResponseValues(betting_node.children[0], board | card_masks_[card],
+                         card, player, policy, child_opponent_reach, history,
+                         &child_values);
+      history->pop_back();
+      for (int hand : card_hands_[card]) child_values[hand] = 0;
+      for (int hand = 0; hand < num_hands; ++hand) {
+        (*values)[hand] += child_values[hand];
+      }
+    }
+    return;
+  }
+
+  const int num_actions = betting_node.actions.size();
+  if (betting_node.player == player) {
+    // Each hand takes its best action.
+    for (int aidx = 0; aidx < num_actions; ++aidx) {
+      history->push_back(betting_node.actions[aidx]);
+      BestResponseValues(betting_node.children[aidx], board, last_card, player,
+                         policy, opponent_reach, history, &child_values);
+      history->pop_back();
+      for (int hand = 0; hand < num_hands; ++hand) {
+        (*values)[hand] = aidx == 0
+                              ? child_values[hand]
+                              : std::max((*values)[hand], child_values[hand]);
+      }
+    }
+    return;
+  }
+
+  std::vector<double> probs;
+  PolicyProbabilities(node, board, *history, policy, &probs);
+  for (int aidx = 0; aidx < num_actions; ++aidx) {
+    child_opponent_reach = opponent_reach;
+    for (int hand = 0; hand < num_hands; ++hand) {
+      child_opponent_reach[hand] *= probs[aidx * num_hands + hand];
+    }
+    history->push_back(betting_node.actions[aidx]);
+    BestResponseValues(betting_node.children[aidx], board, last_card, player,
+                       policy, child_opponent_reach, history, &child_values);
+    history->pop_back();
+    for (int hand = 0; hand < num_hands; ++hand) {
+      (*values)[hand] += child_values[hand];
+    }
+  }
+}
+
+void PublicTreeCFRSolver::PolicyProbabilities(
+    int node, uint64_t board, const std::vector<Action>& history,
+    const Policy& policy, std::vector<double>* probs) const {
+  const BettingNode& betting_node = nodes_[node];
+  const int num_hands = hands_.size();
+  const int num_actions = betting_node.actions.size();
+  probs->assign(num_actions * num_hands, 0);
+
+  const auto* tree_policy = dynamic_cast<const PublicTreePolicy*>(&policy);
+  if (tree_policy != nullptr && &tree_policy->solver() == this) {
+    const double* table = nullptr;
+    auto it = public_state_ids_.find({node, board});
+    if (it != public_state_ids_.end()) {
+      table = (tree_policy->average() ? cumulative_policy_ : current_policy_)
+                  .data() +
+              public_states_[it->second].offset;
+    }
+    for (int hand = 0; hand < num_hands; ++hand) {
+      double sum_prob = 0;
+      for (int aidx = 0; table != nullptr && aidx < num_actions; ++aidx) {
+        sum_prob += table[aidx * num_hands + hand];
+      }
+      for (int aidx = 0; aidx < num_actions; ++aidx) {
+        (*probs)[aidx * num_hands + hand] =
+            sum_prob > 0 ? table[aidx * num_hands + hand] / sum_prob
+                         : 1.0 / num_actions;
+      }
+    }
+    return;
+  }
+
+  // Other policies are queried at a state of the public state, with the hole
+  // cards of the player to move set to each hand in turn, which is all their
+  // information state depends on besides the public state. The other hole
+  // cards are dealt away from the board cards.
+  std::unique_ptr<State> state = game_->NewInitialState();
+  for (int i = 0; i < 2 * num_hole_cards_; ++i) {
+    for (Action card : state->LegalActions()) {
+      if ((card_masks_[card] & board) == 0) {
+        state->ApplyAction(card);
+        break;
+      }
+    }
+  }
+  state->ApplyActionsUnchecked(history);
+  auto& poker_state = static_cast<UniversalPokerState&>(*state);
+  for (int hand = 0; hand < num_hands; ++hand) {
+    if (hands_[hand] & board) continue;
+    poker_state.hole_cards_[betting_node.player].cs.cards = hands_[hand];
+    for (const auto& [action, prob] : policy.GetStatePolicy(*state)) {
+      auto it = std::find(betting_node.actions.begin(),
+                          betting_node.actions.end(), action);
+      SPIEL_CHECK_TRUE(it != betting_node.actions.end());
+      (*probs)[(it - betting_node.actions.begin()) * num_hands + hand] = prob;
+    }
+  }
+}
+
+std::unique_ptr<Policy> PublicTreeCFRSolver::AveragePolicy() const {
+  return std::make_unique<PublicTreePolicy>(*this, /*average=*/true);
+}
+
+std::unique_ptr<Policy> PublicTreeCFRSolver::CurrentPolicy() const {
+  return std::make_unique<PublicTreePolicy>(*this, /*average=*/false);
+}
+
+double PublicTreeNashConv(const Game& game, const Policy& policy) {
+  return PublicTreeCFRSolver(game).NashConv(policy);
+}
+
+double PublicTreeExploitability(const Game& game, const Policy& policy) {
+  return PublicTreeNashConv(game, policy) / 2;
+}
+
+}  // namespace algorithms
+}  // namespace open_spiel
@@ -0,0 +1,243 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_ALGORITHMS_PUBLIC_TREE_CFR_H_
+#define OPEN_SPIEL_ALGORITHMS_PUBLIC_TREE_CFR_H_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/container/flat_hash_map.h"
+#include "open_spiel/policy.h"
+#include "open_spiel/spiel.h"
+
+// CFR for two player universal_poker games, over the public tree. Rather than
+// walking each deal of the private cards as a history of its own, it walks
+// each public state (the betting and the board cards) once, carrying vectors
+// over all the possible hands of a player: their reach probabilities on the
+// way down, and their counterfactual values on the way back. The values of
+// the terminals of a public state are computed for all the hands at once, in
+// time linear in the number of hands (after ordering them by strength, for
+// showdowns), leaving out the pairs of hands which share cards.
+//
+// It runs the same iterations as CFRSolver, i.e. vanilla CFR with alternating
+// updates, so their policies are the same up to rounding. Only hands of one
+// or two hole cards are supported. The values of every public state reached
+// are kept, which bounds the size of the games it can solve.
+//
+// It can also solve a subgame, at the public state of a state during play,
+// from given ranges of the players' hands, for re-solving. Such subgames can
+// be limited to a few betting rounds, the public states at which the next one
+// starts being valued by a PublicTreeLeafValues function.
+//
+// The same walk computes best responses in the whole game: the opponent's
+// hands are carried down as a vector of reach probabilities, which their
+// policy updates at each of their public states, and the terminals are valued
+// for all the best responder's hands at once. This gives the NashConv of a
+// policy much faster than TabularBestResponse, which walks every deal.
+//
+// Note: this is only built with BUILD_WITH_ACPC.
+namespace open_spiel {
+namespace algorithms {
+
+// Fills `values` with the counterfactual values to `player` of each of its
+// hands, in the order of PublicTreeCFRSolver::Hands(), at a leaf of a subgame:
+// `state` has the betting up to the next betting round (with meaningless
+// cards), `board` the board cards. The opponent's hands reach the leaf with
+// `opponent_reach`, chance included.
+using PublicTreeLeafValues = std::function<void(
+    const State& state, uint64_t board, Player player,
+    const std::vector<double>& opponent_reach, std::vector<double>* values)>;
+
+class PublicTreeCFRSolver {
+ public:
+  explicit PublicTreeCFRSolver(const Game& game);
+
+  // Solves the subgame at the public state of `root`, a decision node: its
+  // betting and board cards. The hands of each player reach it with
+  // ranges[player], in the order of Hands(). The subgame spans the current
+  // betting round and max_rounds more, or all of them when it is negative.
+  // The public states at which the next round starts are valued with
+  // leaf_values, or, when it is null, by both players checking or calling
+  // to the end of the game.
+  PublicTreeCFRSolver(const State& root,
+                      const std::vector<std::vector<double>>& ranges,
+                      int max_rounds = -1,
+                      PublicTreeLeafValues leaf_values = nullptr);
+
+  // The possible hands of each player, as the CardSet::cs.cards of their hole
+  // cards.
+  const std::vector<uint64_t>& Hands() const { return hands_; }
+
+  // Performs one iteration of CFR, updating each player in turn.
+  void EvaluateAndUpdatePolicy();
+
+  // The average and current policies, at the states of the game. They should
+  // only be used during the lifetime of the solver.
+  std::unique_ptr<Policy> AveragePolicy() const;
+  std::unique_ptr<Policy> CurrentPolicy() const;
+
+  // The probability of the action at the state under the average policy, for
+  // each hand of the player to move. They are uniform where the public state
+  // of the state hasn't been reached, or is outside of the subgame.
+  std::vector<double> AverageActionProbabilities(const State& state,
+                                                 Action action) const;
+
+  // The expected value to `player` of a best response to the other player's
+  // part of `policy`, which is queried once for each of their hands at each of
+  // their public states (the solver's own policies are read from its tables
+  // instead). The solver must be that of the whole game, not of a subgame.
+  double BestResponseValue(Player player, const Policy& policy);
+
+  // The sum of the values of the best responses of both players, as for
+  // algorithms::NashConv: the game is zero-sum.
+  double NashConv(const Policy& policy);
+
+ private:
+  class PublicTreePolicy;
+
+  // A node of the betting tree, which is the public tree without the board
+  // cards: all the deals of a chance node lead to the same child.
+  struct BettingNode {
+    enum Type { kChance, kDecision, kFold, kShowdown, kLeaf };
+    Type type;
+    Player player = kInvalidPlayer;  // For decision nodes.
+    std::vector<Action> actions;
+    std::vector<int> children;
+    // For chance nodes, how many board cards have been dealt in this round
+    // before this one, and how many are dealt in the round altogether.
+    int round_index = 0;
+    int round_size = 0;
+    // For terminals, the returns of player 0: after the fold, or to the
+    // better hand at a showdown.
+    double value = 0;
+    // For leaves, the index of their state in leaf_states_.
+    int leaf = -1;
+  };
+
+  // The values of a public state: a decision node with some board cards. Each
+  // array has num_actions rows of num_hands values.
+  struct PublicState {
+    int node;
+    uint64_t board;
+    int offset;
+  };
+
+  // The hands in order of strength with some board cards, for showdowns.
+  struct HandRanking {
+    std::vector<int> order;
+    std::vector<int> ranks;  // In the same order.
+  };
+
+  // Enumerates the hands, which a game of the given deck deals.
+  void InitHands(const Game& game);
+  int AddBettingNodes(State* state);
+
+  // Returns the index in public_states_ of a public state, adding it if new.
+  int GetPublicState(int node, uint64_t board);
+  const HandRanking& GetHandRanking(uint64_t board);
+
+  // Fills `values` with the counterfactual values to `player` of its hands
+  // at a public state, which is reached with these probabilities by each of
+  // its hands, and (including chance) by each of the opponent's. The last
+  // card dealt is used to deal the board cards of a round in increasing
+  // order, i.e. each set of them once.
+  void ComputeCounterFactualRegret(int node, uint64_t board, int last_card,
+                                   Player player,
+                                   const std::vector<double>& reach,
+                                   const std::vector<double>& opponent_reach,
+                                   std::vector<double>* values);
+  void FoldValues(double value, const std::vector<double>& opponent_reach,
+                  std::vector<double>* values) const;
+  void ShowdownValues(double value, uint64_t board,
+                      const std::vector<double>& opponent_reach,
+                      std::vector<double>* values);
+
+  // Fills `values` with the values to `player` of its hands at a public state
+  // when it best responds to `policy`, as ComputeCounterFactualRegret does
+  // for the current policies. The history holds the actions from the root to
+  // the public state: the betting and the board cards.
+  void BestResponseValues(int node, uint64_t board, int last_card,
+                          Player player, const Policy& policy,
+                          const std::vector<double>& opponent_reach,
+                          std::vector<Action>* history,
+                          std::vector<double>* values);
+  // Fills `probs` with num_actions rows of the probabilities of the actions
+  // under `policy`, for each hand of the player to move at a public state.
+  void PolicyProbabilities(int node, uint64_t board,
+                           const std::vector<Action>& history,
+                           const Policy& policy,
+                           std::vector<double>* probs) const;
+
+  // Updates the current policies of a player's public states.
+  void ApplyRegretMatching(Player player);
+
+  // The policy of the player to move at this state, if it has been reached.
+  ActionsAndProbs GetStatePolicy(const State& state, bool average) const;
+  // The betting node of the state, following its betting from the root, or -1
+  // if it is beyond the leaves.
+  int FindNode(const State& state) const;
+
+  std::shared_ptr<const Game> game_;
+  int num_hole_cards_;
+  int num_deck_cards_;
+
+  // The possible hands of each player, as the CardSet::cs.cards of their
+  // hole cards, and their cards.
+  std::vector<uint64_t> hands_;
+  std::vector<std::vector<int>> hand_cards_;
+  absl::flat_hash_map<uint64_t, int> hand_ids_;
+  // Which hands hold each card.
+  std::vector<std::vector<int>> card_hands_;
+  // The CardSet::cs.cards of each card, in the order of their ids.
+  std::vector<uint64_t> card_masks_;
+
+  std::vector<BettingNode> nodes_;
+  int root_;
+  // Where the root is in the histories of the states, and its board cards.
+  int root_history_size_;
+  uint64_t root_board_ = 0;
+  // The reach of each player's hands at the root, and the factor applied to
+  // the opponent's for chance.
+  std::vector<std::vector<double>> root_ranges_;
+  double root_chance_reach_ = 1;
+
+  // The last betting round in the subgame, and the values and states of its
+  // leaves.
+  int max_round_ = -1;
+  PublicTreeLeafValues leaf_values_;
+  std::vector<std::unique_ptr<State>> leaf_states_;
+
+  std::vector<PublicState> public_states_;
+  absl::flat_hash_map<std::pair<int, uint64_t>, int> public_state_ids_;
+  std::vector<double> cumulative_regrets_;
+  std::vector<double> cumulative_policy_;
+  std::vector<double> current_policy_;
+
+  absl::flat_hash_map<uint64_t, HandRanking> hand_rankings_;
+};
+
+// The NashConv and exploitability of a policy of a two player universal_poker
+// game, the same as those of tabular_exploitability.h up to rounding, from the
+// best responses of a PublicTreeCFRSolver.
+double PublicTreeNashConv(const Game& game, const Policy& policy);
+double PublicTreeExploitability(const Game& game, const Policy& policy);
+
+}  // namespace algorithms
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_ALGORITHMS_PUBLIC_TREE_CFR_H_
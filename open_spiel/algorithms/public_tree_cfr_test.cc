@@ -0,0 +1,191 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/public_tree_cfr.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "open_spiel/algorithms/cfr.h"
+#include "open_spiel/algorithms/tabular_exploitability.h"
+#include "open_spiel/games/universal_poker.h"
+#include "open_spiel/policy.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace algorithms {
+namespace {
+
+// Leduc-like games, with one board card in the second round, out of six
+// cards.
+GameParameters SmallLimitParameters(int num_hole_cards) {
+  return {{"betting", GameParameter(std::string("limit"))},
+          {"numPlayers", GameParameter(2)},
+          {"numRounds", GameParameter(2)},
+          {"blind", GameParameter(std::string("1 1"))},
+          {"raiseSize", GameParameter(std::string("2 4"))},
+          {"firstPlayer", GameParameter(std::string("1 1"))},
+          {"maxRaises", GameParameter(std::string("2 2"))},
+          {"numSuits", GameParameter(2)},
+          {"numRanks", GameParameter(3)},
+          {"numHoleCards", GameParameter(num_hole_cards)},
+          {"numBoardCards", GameParameter(std::string("0 1"))},
+          {"bettingAbstraction", GameParameter(std::string("fullgame"))}};
+}
+
+void CheckSamePolicies(const Policy& expected, const Policy& policy,
+                       State* state) {
+  if (state->IsTerminal()) return;
+  if (!state->IsChanceNode()) {
+    ActionsAndProbs expected_probs = expected.GetStatePolicy(*state);
+    ActionsAndProbs probs = policy.GetStatePolicy(*state);
+    SPIEL_CHECK_EQ(probs.size(), expected_probs.size());
+    for (int i = 0; i < probs.size(); ++i) {
+      SPIEL_CHECK_EQ(probs[i].first, expected_probs[i].first);
+      SPIEL_CHECK_FLOAT_NEAR(probs[i].second, expected_probs[i].second, 1e-9);
+    }
+  }
+  for (Action action : state->LegalActions()) {
+    std::unique_ptr<State> child = state->Child(action);
+    CheckSamePolicies(expected, policy, child.get());
+  }
+}
+
+// The public tree walk runs the same iterations as CFRSolver.
+void PublicTreeCFRTest_SameAsCFR(int num_hole_cards) {
+  std::shared_ptr<const Game> game =
+      LoadGame("universal_poker", SmallLimitParameters(num_hole_cards));
+  CFRSolver expected_solver(*game);
+  PublicTreeCFRSolver solver(*game);
+  for (int i = 0; i < 10; ++i) {
+    expected_solver.EvaluateAndUpdatePolicy();
+    solver.EvaluateAndUpdatePolicy();
+  }
+  std::unique_ptr<State> root = game->NewInitialState();
+  CheckSamePolicies(*expected_solver.AveragePolicy(), *solver.AveragePolicy(),
+                    root.get());
+  CheckSamePolicies(*expected_solver.CurrentPolicy(), *solver.CurrentPolicy(),
+                    root.get());
+}
+
+// A subgame at the root of the betting, with every hand in the ranges, is the
+// whole game, so it is solved the same way.
+void PublicTreeCFRTest_SubgameAtRoot(int num_hole_cards) {
+  std::shared_ptr<const Game> game =
+      LoadGame("universal_poker", SmallLimitParameters(num_hole_cards));
+  std::unique_ptr<State> root = game->NewInitialState();
+  while (root->IsChanceNode()) root->ApplyAction(root->LegalActions()[0]);
+  PublicTreeCFRSolver expected_solver(*game);
+  const int num_hands = expected_solver.Hands().size();
+  PublicTreeCFRSolver solver(
+      *root, std::vector<std::vector<double>>(2, std::vector<double>(num_hands,
+                                                                     1.0)));
+  for (int i = 0; i < 10; ++i) {
+    expected_solver.EvaluateAndUpdatePolicy();
+    solver.EvaluateAndUpdatePolicy();
+  }
+  CheckSamePolicies(*expected_solver.AveragePolicy(), *solver.AveragePolicy(),
+                    root.get());
+}
+
+// Subgames limited to the first round are solved from the values of their
+// leaves, or by checking down.
+void PublicTreeCFRTest_DepthLimited() {
+  std::shared_ptr<const Game> game =
+      LoadGame("universal_poker", SmallLimitParameters(/*num_hole_cards=*/1));
+  std::unique_ptr<State> root = game->NewInitialState();
+  while (root->IsChanceNode()) root->ApplyAction(root->LegalActions()[0]);
+  const int num_hands = PublicTreeCFRSolver(*game).Hands().size();
+  const std::vector<std::vector<double>> ranges(
+      2, std::vector<double>(num_hands, 1.0));
+
+  int num_leaf_values = 0;
+  PublicTreeLeafValues leaf_values =
+      [&num_leaf_values](const State& state, uint64_t board, Player player,
+                         const std::vector<double>& opponent_reach,
+                         std::vector<double>* values) {
+        SPIEL_CHECK_TRUE(state.IsChanceNode());
+        SPIEL_CHECK_EQ(board, 0);
+        ++num_leaf_values;
+        values->assign(opponent_reach.size(), 0);
+      };
+  PublicTreeCFRSolver solver(*root, ranges, /*max_rounds=*/0, leaf_values);
+  solver.EvaluateAndUpdatePolicy();
+  SPIEL_CHECK_GT(num_leaf_values, 0);
+
+  PublicTreeCFRSolver checking_solver(*root, ranges, /*max_rounds=*/0);
+  for (int i = 0; i < 10; ++i) checking_solver.EvaluateAndUpdatePolicy();
+  for (const auto& [action, prob] :
+       checking_solver.AveragePolicy()->GetStatePolicy(*root)) {
+    SPIEL_CHECK_GE(prob, 0);
+  }
+  // The policies in the second round are not solved.
+  std::unique_ptr<State> state = root->Child(universal_poker::kCall);
+  state->ApplyAction(universal_poker::kCall);
+  state->ApplyAction(state->LegalActions()[0]);
+  const std::vector<double> probs = checking_solver.AverageActionProbabilities(
+      *state, universal_poker::kCall);
+  for (double prob : probs) {
+    SPIEL_CHECK_FLOAT_EQ(prob, 1.0 / state->LegalActions().size());
+  }
+}
+
+// The best responses on the public tree match those of TabularBestResponse,
+// for the solver's own policies and for those of other solvers.
+void PublicTreeCFRTest_NashConv(int num_hole_cards) {
+  std::shared_ptr<const Game> game =
+      LoadGame("universal_poker", SmallLimitParameters(num_hole_cards));
+  const TabularPolicy uniform = GetUniformPolicy(*game);
+  SPIEL_CHECK_FLOAT_NEAR(PublicTreeNashConv(*game, uniform),
+                         NashConv(*game, uniform), 1e-9);
+
+  CFRSolver cfr_solver(*game);
+  PublicTreeCFRSolver solver(*game);
+  for (int i = 0; i < 10; ++i) {
+    cfr_solver.EvaluateAndUpdatePolicy();
+    solver.EvaluateAndUpdatePolicy();
+  }
+  std::shared_ptr<Policy> cfr_policy = cfr_solver.AveragePolicy();
+  const double nash_conv = NashConv(*game, *cfr_policy);
+  SPIEL_CHECK_GT(nash_conv, 0);
+  SPIEL_CHECK_FLOAT_NEAR(PublicTreeNashConv(*game, *cfr_policy), nash_conv,
+                         1e-9);
+  SPIEL_CHECK_FLOAT_NEAR(PublicTreeExploitability(*game, *cfr_policy),
+                         Exploitability(*game, *cfr_policy), 1e-9);
+  std::unique_ptr<Policy> average_policy = solver.AveragePolicy();
+  SPIEL_CHECK_FLOAT_NEAR(solver.NashConv(*average_policy), nash_conv, 1e-9);
+  SPIEL_CHECK_FLOAT_NEAR(
+      solver.NashConv(*solver.CurrentPolicy()),
+      NashConv(*game, *solver.CurrentPolicy(), /*use_state_get_policy=*/true),
+      1e-9);
+}
+
+}  // namespace
+}  // namespace algorithms
+}  // namespace open_spiel
+
+namespace algorithms = open_spiel::algorithms;
+
+int main(int argc, char** argv) {
+  algorithms::PublicTreeCFRTest_SameAsCFR(/*num_hole_cards=*/1);
+  algorithms::PublicTreeCFRTest_SameAsCFR(/*num_hole_cards=*/2);
+  algorithms::PublicTreeCFRTest_SubgameAtRoot(/*num_hole_cards=*/1);
+  algorithms::PublicTreeCFRTest_SubgameAtRoot(/*num_hole_cards=*/2);
+  algorithms::PublicTreeCFRTest_DepthLimited();
+  algorithms::PublicTreeCFRTest_NashConv(/*num_hole_cards=*/1);
+  algorithms::PublicTreeCFRTest_NashConv(/*num_hole_cards=*/2);
+}
@@ -0,0 +1,39 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/scoped_child.h"
+
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace algorithms {
+
+ScopedChild::ScopedChild(State* state, Action action)
+    : parent_(state), player_(state->CurrentPlayer()), action_(action) {
+  SPIEL_CHECK_FALSE(state->IsSimultaneousNode());
+  if (state->SupportsUndoAction()) {
+    state->ApplyAction(action);
+    child_ = state;
+  } else {
+    clone_ = state->Child(action);
+    child_ = clone_.get();
+  }
+}
+
+ScopedChild::~ScopedChild() {
+  if (clone_ == nullptr) parent_->UndoAction(player_, action_);
+}
+
+}  // namespace algorithms
+}  // namespace open_spiel
@@ -0,0 +1,57 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_ALGORITHMS_SCOPED_CHILD_H_
+#define OPEN_SPIEL_ALGORITHMS_SCOPED_CHILD_H_
+
+#include <memory>
+
+#include "open_spiel/spiel.h"
+
+namespace open_spiel {
+namespace algorithms {
+
+// The child of a state reached through one action, for recursive tree walks.
+//
+// When the state supports UndoAction, the action is applied to the state
+// itself and undone when the ScopedChild goes out of scope, so a full walk
+// reuses a single State object. Otherwise the child is a clone, as returned by
+// State::Child. Either way, the parent must not be used while the ScopedChild
+// is alive, and it is back to its original value afterwards.
+//
+// Only for sequential (non-simultaneous) nodes.
+class ScopedChild {
+ public:
+  ScopedChild(State* state, Action action);
+  ~ScopedChild();
+
+  ScopedChild(const ScopedChild&) = delete;
+  ScopedChild& operator=(const ScopedChild&) = delete;
+
+  State& operator*() const { return *child_; }
+  State* operator->() const { return child_; }
+  State* get() const { return child_; }
+
+ private:
+  State* parent_;
+  Player player_;
+  Action action_;
+  std::unique_ptr<State> clone_;  // Only used without UndoAction support.
+  State* child_;
+};
+
+}  // namespace algorithms
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_ALGORITHMS_SCOPED_CHILD_H_
@@ -0,0 +1,76 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/scoped_child.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace algorithms {
+namespace {
+
+// Walks the tree below `state` with ScopedChild, checking every child against
+// State::Child and that the parent is restored afterwards. Returns the number
+// of histories visited.
+int CheckTree(State* state, int depth_limit) {
+  if (state->IsTerminal() || depth_limit == 0) return 1;
+  const std::string parent = state->ToString();
+  const std::vector<Action> history = state->History();
+  int num_histories = 1;
+  for (Action action : state->LegalActions()) {
+    std::unique_ptr<State> expected = state->Child(action);
+    {
+      ScopedChild child(state, action);
+      SPIEL_CHECK_EQ(child->ToString(), expected->ToString());
+      SPIEL_CHECK_EQ(child->History(), expected->History());
+      SPIEL_CHECK_EQ(child.get() == state, state->SupportsUndoAction());
+      num_histories += CheckTree(child.get(), depth_limit - 1);
+    }
+    SPIEL_CHECK_EQ(state->ToString(), parent);
+    SPIEL_CHECK_EQ(state->History(), history);
+  }
+  return num_histories;
+}
+
+void ScopedChildTest(const std::string& game_name, int depth_limit,
+                     bool supports_undo) {
+  std::shared_ptr<const Game> game = LoadGame(game_name);
+  std::unique_ptr<State> state = game->NewInitialState();
+  SPIEL_CHECK_EQ(state->SupportsUndoAction(), supports_undo);
+  CheckTree(state.get(), depth_limit);
+}
+
+void KuhnPokerHistoriesTest() {
+  std::unique_ptr<State> state = LoadGame("kuhn_poker")->NewInitialState();
+  SPIEL_CHECK_EQ(CheckTree(state.get(), /*depth_limit=*/-1), 58);
+}
+
+}  // namespace
+}  // namespace algorithms
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  open_spiel::algorithms::KuhnPokerHistoriesTest();
+  open_spiel::algorithms::ScopedChildTest("tic_tac_toe", 4,
+                                          /*supports_undo=*/true);
+  open_spiel::algorithms::ScopedChildTest("connect_four", 3,
+                                          /*supports_undo=*/true);
+  open_spiel::algorithms::ScopedChildTest("leduc_poker", 4,
+                                          /*supports_undo=*/false);
+}
@@ -0,0 +1,405 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/sequence_form.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/abseil-cpp/absl/types/span.h"
+#include "open_spiel/policy.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace algorithms {
+
+struct SequenceForm::Index {
+  std::unordered_map<std::string, int> info_states[2];
+  // The sum of the chance-weighted utilities to player 0 at each pair of
+  // sequences.
+  std::map<std::pair<int, int>, double> payoffs;
+};
+
+SequenceForm::SequenceForm(const Game& game) {
+  const GameType& type = game.GetType();
+  SPIEL_CHECK_EQ(game.NumPlayers(), 2);
+  SPIEL_CHECK_EQ(type.dynamics, GameType::Dynamics::kSequential);
+  if (type.utility != GameType::Utility::kZeroSum &&
+      type.utility != GameType::Utility::kConstantSum) {
+    SpielFatalError(absl::StrCat("The sequence form solver needs a zero-sum "
+                                 "game, but ", game.ToString(), " is not."));
+  }
+  Index index;
+  int sequences[2] = {0, 0};
+  Traverse(*game.NewInitialState(), 1.0, sequences, &index);
+  payoffs_.reserve(index.payoffs.size());
+  for (const auto& [sequence_pair, value] : index.payoffs) {
+    if (value != 0) {
+      payoffs_.push_back({sequence_pair.first, sequence_pair.second, value});
+    }
+  }
+}
+
+void SequenceForm::Traverse(const State& state, double chance_prob,
+                            int sequences[2], Index* index) {
+  if (state.IsTerminal()) {
+    index->payoffs[{sequences[0], sequences[1]}] +=
+        chance_prob * state.PlayerReturn(0);
+    return;
+  }
+  if (state.IsChanceNode()) {
+    for (const auto& [outcome, prob] : state.ChanceOutcomes()) {
+      Traverse(*state.Child(outcome), chance_prob * prob, sequences, index);
+    }
+    return;
+  }
+
+  const Player player = state.CurrentPlayer();
+  const int parent = sequences[player];
+  std::string name = state.InformationStateString(player);
+  auto [iter, inserted] =
+      index->info_states[player].emplace(name, info_states_[player].size());
+  if (inserted) {
+    std::vector<Action> legal_actions = state.LegalActions();
+    const int num_actions = legal_actions.size();
+    info_states_[player].push_back(InfoState{std::move(name),
+                                             std::move(legal_actions), parent,
+                                             num_sequences_[player]});
+    num_sequences_[player] += num_actions;
+  }
+  const InfoState& info_state = info_states_[player][iter->second];
+  if (info_state.parent_sequence != parent) {
+    SpielFatalError(absl::StrCat("Information state ", info_state.name,
+                                 " of player ", player,
+                                 " is reached by different sequences, so the "
+                                 "game does not have perfect recall."));
+  }
+  // The traversal may add information states, moving info_state.
+  const std::vector<Action> legal_actions = info_state.legal_actions;
+  const int first_sequence = info_state.first_sequence;
+  for (int i = 0; i < legal_actions.size(); ++i) {
+    sequences[player] = first_sequence + i;
+    Traverse(*state.Child(legal_actions[i]), chance_prob, sequences, index);
+  }
+  sequences[player] = parent;
+}
+
+void SequenceForm::RowPayoffs(absl::Span<const double> plan,
+                              absl::Span<double> payoffs) const {
+  SPIEL_CHECK_EQ(plan.size(), num_sequences_[1]);
+  SPIEL_CHECK_EQ(payoffs.size(), num_sequences_[0]);
+  std::fill(payoffs.begin(), payoffs.end(), 0);
+  for (const Entry& entry : payoffs_) {
+    payoffs[entry.row] += entry.value * plan[entry.col];
+  }
+}
+
+void SequenceForm::ColPayoffs(absl::Span<const double> plan,
+                              absl::Span<double> payoffs) const {
+  SPIEL_CHECK_EQ(plan.size(), num_sequences_[0]);
+  SPIEL_CHECK_EQ(payoffs.size(), num_sequences_[1]);
+  std::fill(payoffs.begin(), payoffs.end(), 0);
+  for (const Entry& entry : payoffs_) {
+    payoffs[entry.col] += entry.value * plan[entry.row];
+  }
+}
+
+std::vector<double> SequenceForm::NormalizedPlan(
+    Player player, absl::Span<const double> weights) const {
+  SPIEL_CHECK_EQ(weights.size(), num_sequences_[player]);
+  std::vector<double> plan(num_sequences_[player], 0);
+  plan[0] = 1;
+  for (const InfoState& info_state : info_states_[player]) {
+    const int num_actions = info_state.legal_actions.size();
+    double total = 0;
+    for (int i = 0; i < num_actions; ++i) {
+      total += std::max(0.0, weights[info_state.first_sequence + i]);
+    }
+    const double reach = plan[info_state.parent_sequence];
+    for (int i = 0; i < num_actions; ++i) {
+      const int sequence = info_state.first_sequence + i;
+      plan[sequence] =
+          total > 0 ? reach * std::max(0.0, weights[sequence]) / total
+                    : reach / num_actions;
+    }
+  }
+  return plan;
+}
+
+double SequenceForm::BestResponseValue(
+    Player player, absl::Span<const double> payoffs) const {
+  SPIEL_CHECK_EQ(payoffs.size(), num_sequences_[player]);
+  std::vector<double> values(payoffs.begin(), payoffs.end());
+  const std::vector<InfoState>& info_states = info_states_[player];
+  for (auto it = info_states.rbegin(); it != info_states.rend(); ++it) {
+    const double* first = &values[it->first_sequence];
+    const double* last = first + it->legal_actions.size();
+    values[it->parent_sequence] += player == 0 ? *std::max_element(first, last)
+                                               : *std::min_element(first, last);
+  }
+  return values[0];
+}
+
+TabularPolicy SequenceForm::PlanPolicy(Player player,
+                                       absl::Span<const double> plan) const {
+  SPIEL_CHECK_EQ(plan.size(), num_sequences_[player]);
+  TabularPolicy policy;
+  for (const InfoState& info_state : info_states_[player]) {
+    const int num_actions = info_state.legal_actions.size();
+    double total = 0;
+    for (int i = 0; i < num_actions; ++i) {
+      total += std::max(0.0, plan[info_state.first_sequence + i]);
+    }
+    ActionsAndProbs& actions_and_probs = policy.PolicyTable()[info_state.name];
+    actions_and_probs.reserve(num_actions);
+    for (int i = 0; i < num_actions; ++i) {
+      actions_and_probs.emplace_back(
+          info_state.legal_actions[i],
+          total > 0
+              ? std::max(0.0, plan[info_state.first_sequence + i]) / total
+              : 1.0 / num_actions);
+    }
+  }
+  return policy;
+}
+
+namespace {
+
+// Restart when the gap is this fraction of that at the last restart.
+constexpr double kRestartFactor = 0.2;
+// The gaps of the current and average plans are computed every this many
+// iterations, as each costs four products with A.
+constexpr int kGapPeriod = 10;
+
+using InfoStates = std::vector<SequenceForm::InfoState>;
+
+// E x, the constraints on a player's plan x: the empty sequence, then for each
+// information state, the sum of its actions' sequences less its parent's.
+void ConstraintProduct(const InfoStates& info_states,
+                       const std::vector<double>& plan,
+                       std::vector<double>* constraints) {
+  (*constraints)[0] = plan[0];
+  for (int i = 0; i < info_states.size(); ++i) {
+    const SequenceForm::InfoState& info_state = info_states[i];
+    double sum = -plan[info_state.parent_sequence];
+    for (int a = 0; a < info_state.legal_actions.size(); ++a) {
+      sum += plan[info_state.first_sequence + a];
+    }
+    (*constraints)[i + 1] = sum;
+  }
+}
+
+// E^T p, for a vector p over the constraints.
+void ConstraintTransposeProduct(const InfoStates& info_states,
+                                const std::vector<double>& multipliers,
+                                std::vector<double>* sequences) {
+  std::fill(sequences->begin(), sequences->end(), 0);
+  (*sequences)[0] = multipliers[0];
+  for (int i = 0; i < info_states.size(); ++i) {
+    const SequenceForm::InfoState& info_state = info_states[i];
+    const double multiplier = multipliers[i + 1];
+    (*sequences)[info_state.parent_sequence] -= multiplier;
+    for (int a = 0; a < info_state.legal_actions.size(); ++a) {
+      (*sequences)[info_state.first_sequence + a] += multiplier;
+    }
+  }
+}
+
+// Adds the absolute values of the entries of E to the sums of its rows and of
+// its columns.
+void AddConstraintSums(const InfoStates& info_states,
+                       std::vector<double>* row_sums,
+                       std::vector<double>* col_sums) {
+  (*row_sums)[0] += 1;
+  (*col_sums)[0] += 1;
+  for (int i = 0; i < info_states.size(); ++i) {
+    const SequenceForm::InfoState& info_state = info_states[i];
+    (*row_sums)[i + 1] += info_state.legal_actions.size() + 1;
+    (*col_sums)[info_state.parent_sequence] += 1;
+    for (int a = 0; a < info_state.legal_actions.size(); ++a) {
+      (*col_sums)[info_state.first_sequence + a] += 1;
+    }
+  }
+}
+
+void Invert(std::vector<double>* sums) {
+  for (double& sum : *sums) sum = sum > 0 ? 1 / sum : 0;
+}
+
+// The plans of the players with weights x and y, and their gap.
+struct Plans {
+  std::vector<double> x;
+  std::vector<double> y;
+  double gap = 0;
+  double value = 0;
+};
+
+Plans EvaluatePlans(const SequenceForm& sequence_form,
+                    const std::vector<double>& x_weights,
+                    const std::vector<double>& y_weights) {
+  Plans plans{sequence_form.NormalizedPlan(0, x_weights),
+              sequence_form.NormalizedPlan(1, y_weights)};
+  std::vector<double> row_payoffs(plans.x.size());
+  std::vector<double> col_payoffs(plans.y.size());
+  sequence_form.RowPayoffs(plans.y, absl::MakeSpan(row_payoffs));
+  sequence_form.ColPayoffs(plans.x, absl::MakeSpan(col_payoffs));
+  plans.gap = sequence_form.BestResponseValue(0, row_payoffs) -
+              sequence_form.BestResponseValue(1, col_payoffs);
+  plans.value = 0;
+  for (int i = 0; i < plans.x.size(); ++i) {
+    plans.value += plans.x[i] * row_payoffs[i];
+  }
+  return plans;
+}
+
+}  // namespace
+
+SequenceFormSolution SolveSequenceForm(const SequenceForm& sequence_form,
+                                       double epsilon, int max_iterations) {
+  const InfoStates& info_states_x = sequence_form.InfoStates(0);
+  const InfoStates& info_states_y = sequence_form.InfoStates(1);
+  const int num_x = sequence_form.NumSequences(0);
+  const int num_y = sequence_form.NumSequences(1);
+  const int num_p = info_states_x.size() + 1;
+  const int num_q = info_states_y.size() + 1;
+
+  // The step of each variable is the inverse of the sum of the absolute
+  // values in its column of the constraint matrix
+  //
+  //   K = [ E    0   ]
+  //       [ A^T -F^T ]
+  //
+  // for x and q, and in its row for the dual variables p and y.
+  std::vector<double> tau_x(num_x, 0);
+  std::vector<double> tau_q(num_q, 0);
+  std::vector<double> sigma_p(num_p, 0);
+  std::vector<double> sigma_y(num_y, 0);
+  AddConstraintSums(info_states_x, &sigma_p, &tau_x);
+  AddConstraintSums(info_states_y, &tau_q, &sigma_y);
+  for (const SequenceForm::Entry& entry : sequence_form.Payoffs()) {
+    tau_x[entry.row] += std::abs(entry.value);
+    sigma_y[entry.col] += std::abs(entry.value);
+  }
+  Invert(&tau_x);
+  Invert(&tau_q);
+  Invert(&sigma_p);
+  Invert(&sigma_y);
+
+  std::vector<double> x(num_x, 1);
+  std::vector<double> y(num_y, 1);
+  std::vector<double> p(num_p, 0);
+  std::vector<double> q(num_q, 0);
+  Plans best = EvaluatePlans(sequence_form, x, y);
+  double restart_gap = best.gap;
+
+  // The sums of the iterates since the last restart.
+  std::vector<double> x_sum(num_x, 0);
+  std::vector<double> y_sum(num_y, 0);
+  std::vector<double> p_sum(num_p, 0);
+  std::vector<double> q_sum(num_q, 0);
+  int num_summed = 0;
+
+  std::vector<double> x_step(num_x);
+  std::vector<double> y_step(num_y);
+  std::vector<double> p_step(num_p);
+  std::vector<double> q_step(num_q);
+  std::vector<double> row_payoffs(num_x);
+  std::vector<double> col_payoffs(num_y);
+  std::vector<double> x_bar(num_x);
+  std::vector<double> q_bar(num_q);
+  for (int iteration = 0;
+       iteration < max_iterations && best.gap > epsilon; ++iteration) {
+    // The primal variables descend on -q_0, then the duals ascend against
+    // their extrapolation.
+    ConstraintTransposeProduct(info_states_x, p, &x_step);
+    sequence_form.RowPayoffs(y, absl::MakeSpan(row_payoffs));
+    for (int i = 0; i < num_x; ++i) {
+      const double next =
+          std::max(0.0, x[i] + tau_x[i] * (x_step[i] + row_payoffs[i]));
+      x_bar[i] = 2 * next - x[i];
+      x[i] = next;
+    }
+    ConstraintProduct(info_states_y, y, &q_step);
+    for (int i = 0; i < num_q; ++i) {
+      const double next = q[i] + tau_q[i] * ((i == 0) - q_step[i]);
+      q_bar[i] = 2 * next - q[i];
+      q[i] = next;
+    }
+    ConstraintProduct(info_states_x, x_bar, &p_step);
+    for (int i = 0; i < num_p; ++i) {
+      p[i] += sigma_p[i] * ((i == 0) - p_step[i]);
+    }
+    sequence_form.ColPayoffs(x_bar, absl::MakeSpan(col_payoffs));
+    ConstraintTransposeProduct(info_states_y, q_bar, &y_step);
+    for (int i = 0; i < num_y; ++i) {
+      y[i] = std::max(0.0, y[i] - sigma_y[i] * (col_payoffs[i] - y_step[i]));
+    }
+
+    for (int i = 0; i < num_x; ++i) x_sum[i] += x[i];
+    for (int i = 0; i < num_y; ++i) y_sum[i] += y[i];
+    for (int i = 0; i < num_p; ++i) p_sum[i] += p[i];
+    for (int i = 0; i < num_q; ++i) q_sum[i] += q[i];
+    ++num_summed;
+    if ((iteration + 1) % kGapPeriod != 0) continue;
+
+    // The averages are normalized like the iterates, so their sums will do.
+    Plans current = EvaluatePlans(sequence_form, x, y);
+    Plans average = EvaluatePlans(sequence_form, x_sum, y_sum);
+    const double gap = current.gap;
+    const double average_gap = average.gap;
+    if (gap < best.gap) best = std::move(current);
+    if (average_gap < best.gap) best = std::move(average);
+
+    if (std::min(gap, average_gap) <= kRestartFactor * restart_gap) {
+      if (average_gap < gap) {
+        for (int i = 0; i < num_x; ++i) x[i] = x_sum[i] / num_summed;
+        for (int i = 0; i < num_y; ++i) y[i] = y_sum[i] / num_summed;
+        for (int i = 0; i < num_p; ++i) p[i] = p_sum[i] / num_summed;
+        for (int i = 0; i < num_q; ++i) q[i] = q_sum[i] / num_summed;
+      }
+      restart_gap = std::min(gap, average_gap);
+      std::fill(x_sum.begin(), x_sum.end(), 0);
+      std::fill(y_sum.begin(), y_sum.end(), 0);
+      std::fill(p_sum.begin(), p_sum.end(), 0);
+      std::fill(q_sum.begin(), q_sum.end(), 0);
+      num_summed = 0;
+    }
+  }
+
+  SequenceFormSolution solution;
+  solution.policy = sequence_form.PlanPolicy(0, best.x);
+  const TabularPolicy policy_y = sequence_form.PlanPolicy(1, best.y);
+  solution.policy.PolicyTable().insert(policy_y.PolicyTable().begin(),
+                                       policy_y.PolicyTable().end());
+  solution.plans[0] = std::move(best.x);
+  solution.plans[1] = std::move(best.y);
+  solution.value = best.value;
+  solution.nash_conv = best.gap;
+  return solution;
+}
+
+SequenceFormSolution SolveSequenceForm(const Game& game, double epsilon,
+                                       int max_iterations) {
+  return SolveSequenceForm(SequenceForm(game), epsilon, max_iterations);
+}
+
+}  // namespace algorithms
+}  // namespace open_spiel
@@ -0,0 +1,145 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_ALGORITHMS_SEQUENCE_FORM_H_
+#define OPEN_SPIEL_ALGORITHMS_SEQUENCE_FORM_H_
+
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/types/span.h"
+#include "open_spiel/policy.h"
+#include "open_spiel/spiel.h"
+
+// The sequence form of a two-player zero-sum sequential game with perfect
+// recall (Koller, Megiddo and von Stengel, Efficient Computation of
+// Equilibria for Extensive Two-Person Games, 1996), and a solver for it.
+//
+// A player's strategy is given by its realization plan: the probability with
+// which the player plays each of their sequences of actions, the empty
+// sequence having probability 1, and those of the actions at an information
+// state adding up to that of the sequence leading to it. The expected utility
+// of a pair of plans x, y is x^T A y, where A sums the chance-weighted
+// utilities of the terminal histories at the pair of sequences which leads to
+// them. Unlike the normal form of ExtensiveToMatrixGame, the plans and A are
+// linear in the size of the game tree, and A is sparse.
+
+namespace open_spiel {
+namespace algorithms {
+
+class SequenceForm {
+ public:
+  // Builds the sequence form in one traversal of the game tree.
+  explicit SequenceForm(const Game& game);
+
+  // The information states of a player, in the order in which they were first
+  // reached, so that the sequence leading to one belongs to an earlier one.
+  // The sequences of the actions at an information state are consecutive, and
+  // the empty sequence is 0.
+  struct InfoState {
+    std::string name;
+    std::vector<Action> legal_actions;
+    int parent_sequence;
+    int first_sequence;
+  };
+
+  // A non-zero entry of A.
+  struct Entry {
+    int row;
+    int col;
+    double value;
+  };
+
+  int NumSequences(Player player) const { return num_sequences_[player]; }
+  const std::vector<InfoState>& InfoStates(Player player) const {
+    return info_states_[player];
+  }
+  // The utilities to player 0, ordered by row then column.
+  const std::vector<Entry>& Payoffs() const { return payoffs_; }
+
+  // A y, the payoffs to player 0 of each sequence against the plan y of
+  // player 1, and x^T A, those to player 0 of each sequence of player 1.
+  void RowPayoffs(absl::Span<const double> y, absl::Span<double> payoffs) const;
+  void ColPayoffs(absl::Span<const double> x, absl::Span<double> payoffs) const;
+
+  // The realization plan of the behaviour at each information state given by
+  // its non-negative weights over its actions, e.g. those of another plan
+  // which may not add up. The actions of an information state with no weight
+  // are played uniformly.
+  std::vector<double> NormalizedPlan(Player player,
+                                     absl::Span<const double> weights) const;
+
+  // The best a player can do against the payoffs of their sequences: the
+  // maximum of x^T payoffs over the plans x of player 0, or the minimum over
+  // those of player 1, computed from the last information state to the first.
+  double BestResponseValue(Player player,
+                           absl::Span<const double> payoffs) const;
+
+  // The behaviour policy of a player's realization plan, or of weights as
+  // for NormalizedPlan, whose information states are keyed by their names.
+  TabularPolicy PlanPolicy(Player player, absl::Span<const double> plan) const;
+
+ private:
+  // The lookups used while traversing the tree.
+  struct Index;
+
+  void Traverse(const State& state, double chance_prob, int sequences[2],
+                Index* index);
+
+  std::vector<InfoState> info_states_[2];
+  int num_sequences_[2] = {1, 1};
+  std::vector<Entry> payoffs_;
+};
+
+// An equilibrium found by SolveSequenceForm.
+struct SequenceFormSolution {
+  // The realization plans of the players.
+  std::vector<double> plans[2];
+  // The policies of both players.
+  TabularPolicy policy;
+  // The expected utility to player 0.
+  double value;
+  // The sum of what the players gain by best responding, which is the
+  // duality gap of the plans.
+  double nash_conv;
+};
+
+// Solves the sequence form as the linear program
+//
+//   max_{x, q} q_0  s.t.  E x = e,  A^T x - F^T q >= 0,  x >= 0,
+//
+// where E x = e and F y = e are the constraints on the plans x and y of
+// players 0 and 1, and e is 1 for the empty sequence and 0 for the information
+// states. The dual variables of A^T x - F^T q >= 0 are y. This is the
+// primal-dual hybrid gradient method, as SolveZeroSumMatrixGame, with the
+// diagonal step sizes of Pock and Chambolle (Diagonal preconditioning for
+// first order primal-dual algorithms in convex optimization, 2011), and
+// restarts from the current or the average iterate whenever the gap of the
+// plans has shrunk enough. An iteration costs two products with A, so memory
+// and time per iteration are linear in the size of the tree. Returns plans
+// whose NashConv is at most epsilon, or the best found in max_iterations
+// iterations.
+SequenceFormSolution SolveSequenceForm(const SequenceForm& sequence_form,
+                                       double epsilon = 1e-6,
+                                       int max_iterations = 1000000);
+
+// Same as above, building the sequence form of the game.
+SequenceFormSolution SolveSequenceForm(const Game& game,
+                                       double epsilon = 1e-6,
+                                       int max_iterations = 1000000);
+
+}  // namespace algorithms
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_ALGORITHMS_SEQUENCE_FORM_H_
@@ -0,0 +1,92 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/sequence_form.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/types/span.h"
+#include "open_spiel/algorithms/tabular_exploitability.h"
+#include "open_spiel/policy.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace algorithms {
+namespace {
+
+// Each player of Kuhn poker has 6 information states of 2 actions, and the
+// payoffs only pair sequences which end the game.
+void KuhnSequenceFormTest() {
+  std::shared_ptr<const Game> game = LoadGame("kuhn_poker");
+  const SequenceForm sequence_form(*game);
+  for (Player player : {0, 1}) {
+    SPIEL_CHECK_EQ(sequence_form.InfoStates(player).size(), 6);
+    SPIEL_CHECK_EQ(sequence_form.NumSequences(player), 13);
+    for (const SequenceForm::InfoState& info_state :
+         sequence_form.InfoStates(player)) {
+      SPIEL_CHECK_LT(info_state.parent_sequence, info_state.first_sequence);
+    }
+  }
+  SPIEL_CHECK_EQ(sequence_form.Payoffs().size(), 30);
+
+  // The uniform plans, and their value against each other.
+  const std::vector<double> plan_x =
+      sequence_form.NormalizedPlan(0, std::vector<double>(13, 1));
+  const std::vector<double> plan_y =
+      sequence_form.NormalizedPlan(1, std::vector<double>(13, 1));
+  SPIEL_CHECK_EQ(plan_x[0], 1);
+  std::vector<double> row_payoffs(13);
+  sequence_form.RowPayoffs(plan_y, absl::MakeSpan(row_payoffs));
+  double value = 0;
+  for (int i = 0; i < 13; ++i) value += plan_x[i] * row_payoffs[i];
+  SPIEL_CHECK_FLOAT_NEAR(value, 0.125, 1e-12);
+
+  // The gap of the plans is the NashConv of their policies.
+  std::vector<double> col_payoffs(13);
+  sequence_form.ColPayoffs(plan_x, absl::MakeSpan(col_payoffs));
+  const double gap = sequence_form.BestResponseValue(0, row_payoffs) -
+                     sequence_form.BestResponseValue(1, col_payoffs);
+  TabularPolicy policy = sequence_form.PlanPolicy(0, plan_x);
+  const TabularPolicy policy_y = sequence_form.PlanPolicy(1, plan_y);
+  policy.PolicyTable().insert(policy_y.PolicyTable().begin(),
+                              policy_y.PolicyTable().end());
+  SPIEL_CHECK_FLOAT_NEAR(gap, NashConv(*game, policy), 1e-12);
+}
+
+void SolveTest(const std::string& game_name, double epsilon,
+               double expected_value, double value_tolerance) {
+  std::shared_ptr<const Game> game = LoadGame(game_name);
+  const SequenceFormSolution solution = SolveSequenceForm(*game, epsilon);
+  SPIEL_CHECK_LE(solution.nash_conv, epsilon);
+  SPIEL_CHECK_FLOAT_NEAR(solution.nash_conv, NashConv(*game, solution.policy),
+                         1e-9);
+  SPIEL_CHECK_FLOAT_NEAR(solution.value, expected_value, value_tolerance);
+}
+
+}  // namespace
+}  // namespace algorithms
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  open_spiel::algorithms::KuhnSequenceFormTest();
+  open_spiel::algorithms::SolveTest("kuhn_poker", 1e-8, -1.0 / 18, 1e-7);
+  open_spiel::algorithms::SolveTest(
+      "turn_based_simultaneous_game(game=goofspiel(num_cards=4,imp_info=True,"
+      "points_order=descending))",
+      1e-6, 0, 1e-6);
+  open_spiel::algorithms::SolveTest("leduc_poker", 1e-3, -0.0856, 1e-3);
+}
@@ -19,11 +19,14 @@
 #include <map>
 #include <memory>
 #include <numeric>
+#include <random>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "open_spiel/abseil-cpp/absl/algorithm/container.h"
 #include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/algorithms/scoped_child.h"
 #include "open_spiel/simultaneous_move_game.h"
 #include "open_spiel/spiel.h"
 
@@ -64,7 +67,7 @@ HistoryDistribution GetStateDistribution(const State& state,
   // Generate the (info state, action) map for the current player using
   // the state's history.
   std::map<std::string, Action> infostate_action_map;
-  std::vector<Action> history = state.History();
+  const std::vector<Action>& history = state.FullHistory();
   std::unique_ptr<State> tmp_state = game->NewInitialState();
   for (Action action : history) {
     if (tmp_state->CurrentPlayer() == player) {
@@ -166,13 +169,13 @@ std::unique_ptr<HistoryDistribution> UpdateIncrementalStateDistribution(
         GetStateDistribution(state, opponent_policy));
   }
   // The current state must be one action ahead of the dist ones.
-  const std::vector<Action> history = state.History();
+  const std::vector<Action>& history = state.FullHistory();
   Action action = history.back();
   for (int i = 0; i < previous->first.size(); ++i) {
     std::unique_ptr<State>& parent = previous->first[i];
     double& prob = previous->second[i];
     if (Near(prob, 0.)) continue;
-    SPIEL_CHECK_EQ(history.size(), parent->History().size() + 1);
+    SPIEL_CHECK_EQ(history.size(), parent->FullHistory().size() + 1);
     switch (parent->GetType()) {
       case StateType::kChance: {
         open_spiel::ActionsAndProbs outcomes = parent->ChanceOutcomes();
@@ -209,5 +212,165 @@ std::unique_ptr<HistoryDistribution> UpdateIncrementalStateDistribution(
   return previous;
 }
 
+ParticleStateDistribution::ParticleStateDistribution(
+    const Game& game, Player player, const Policy* opponent_policy,
+    int num_particles, int seed, double resampling_threshold)
+    : player_(player),
+      opponent_policy_(opponent_policy),
+      resampling_threshold_(resampling_threshold),
+      rng_(seed),
+      state_(game.NewInitialState()),
+      weights_(num_particles, 1.0 / num_particles) {
+  GameType game_type = game.GetType();
+  SPIEL_CHECK_EQ(game_type.dynamics, GameType::Dynamics::kSequential);
+  SPIEL_CHECK_NE(game_type.chance_mode,
+                 GameType::ChanceMode::kSampledStochastic);
+  SPIEL_CHECK_GE(num_particles, 1);
+  SPIEL_CHECK_GE(resampling_threshold, 0);
+  SPIEL_CHECK_LE(resampling_threshold, 1);
+  particles_.reserve(num_particles);
+  for (int i = 0; i < num_particles; ++i) {
+    particles_.push_back(state_->Clone());
+  }
+}
+
+void ParticleStateDistribution::Update(const State& state) {
+  const std::vector<Action>& history = state.FullHistory();
+  const int num_actions = state_->FullHistory().size();
+  SPIEL_CHECK_GE(history.size(), num_actions);
+  for (int i = num_actions; i < history.size(); ++i) Step(history[i]);
+}
+
+void ParticleStateDistribution::Step(Action action) {
+  state_->ApplyAction(action);
+  const std::string info_state = state_->InformationStateString(player_);
+
+  // The actions of a particle which keep it in the information state, and
+  // their probabilities.
+  ActionsAndProbs outcomes;
+  ActionsAndProbs consistent_outcomes;
+  for (int i = 0; i < particles_.size(); ++i) {
+    if (weights_[i] == 0) continue;
+    State* particle = particles_[i].get();
+    if (particle->IsTerminal()) {
+      weights_[i] = 0;
+      continue;
+    }
+    if (!particle->IsChanceNode() && particle->CurrentPlayer() == player_) {
+      // With perfect recall, the player's own action keeps the particle in
+      // the information state.
+      particle->ApplyAction(action);
+      continue;
+    }
+    if (particle->IsChanceNode()) {
+      outcomes = particle->ChanceOutcomes();
+    } else {
+      const ActionsAndProbs policy = opponent_policy_->GetStatePolicy(*particle);
+      outcomes.clear();
+      for (Action legal_action : particle->LegalActions()) {
+        outcomes.push_back({legal_action, GetProb(policy, legal_action)});
+      }
+    }
+    consistent_outcomes.clear();
+    double total_prob = 0;
+    for (const auto& [outcome, prob] : outcomes) {
+      if (prob <= 0) continue;
+      ScopedChild child(particle, outcome);
+      if (child->InformationStateString(player_) == info_state) {
+        consistent_outcomes.push_back({outcome, prob});
+        total_prob += prob;
+      }
+    }
+    if (consistent_outcomes.empty()) {
+      weights_[i] = 0;
+      continue;
+    }
+    weights_[i] *= total_prob;
+    double z = std::uniform_real_distribution<double>(0, total_prob)(rng_);
+    Action sampled_outcome = consistent_outcomes.back().first;
+    for (const auto& [outcome, prob] : consistent_outcomes) {
+      if (z < prob) {
+        sampled_outcome = outcome;
+        break;
+      }
+      z -= prob;
+    }
+    particle->ApplyAction(sampled_outcome);
+  }
+
+  const double total_weight = absl::c_accumulate(weights_, 0.);
+  if (total_weight == 0) {
+    SpielFatalError(absl::StrCat(
+        "None of the ", particles_.size(),
+        " particles is consistent with the information state ", info_state,
+        "; use more particles."));
+  }
+  for (double& weight : weights_) weight /= total_weight;
+  if (EffectiveSampleSize() < resampling_threshold_ * particles_.size()) {
+    Resample();
+  }
+}
+
+double ParticleStateDistribution::EffectiveSampleSize() const {
+  double sum_squares = 0;
+  for (double weight : weights_) sum_squares += weight * weight;
+  return 1 / sum_squares;
+}
+
+void ParticleStateDistribution::Resample() {
+  // Systematic resampling: the particles are taken at evenly spaced points of
+  // the cumulative weights, from a single random offset.
+  const int num_particles = particles_.size();
+  std::vector<int> counts(num_particles, 0);
+  const double offset = std::uniform_real_distribution<double>(
+      0, 1.0 / num_particles)(rng_);
+  // Rounding errors must not take the particles with no weight at the end.
+  int last = num_particles - 1;
+  while (weights_[last] == 0) --last;
+  int i = 0;
+  double cumulative_weight = weights_[0];
+  for (int j = 0; j < num_particles; ++j) {
+    const double point = offset + static_cast<double>(j) / num_particles;
+    while (point > cumulative_weight && i < last) {
+      cumulative_weight += weights_[++i];
+    }
+    ++counts[i];
+  }
+
+  // The particles taken several times are copied over those not taken.
+  std::vector<int> dropped;
+  for (int i = 0; i < num_particles; ++i) {
+    if (counts[i] == 0) dropped.push_back(i);
+  }
+  int next = 0;
+  for (int i = 0; i < num_particles; ++i) {
+    for (int copy = 1; copy < counts[i]; ++copy) {
+      CopyOrCloneState(*particles_[i], &particles_[dropped[next++]]);
+    }
+  }
+  weights_.assign(num_particles, 1.0 / num_particles);
+}
+
+const State& ParticleStateDistribution::SampleState() {
+  double z = std::uniform_real_distribution<double>(0, 1)(rng_);
+  for (int i = 0; i < particles_.size(); ++i) {
+    if (z < weights_[i]) return *particles_[i];
+    z -= weights_[i];
+  }
+  // Only reached through rounding errors.
+  int last = particles_.size() - 1;
+  while (weights_[last] == 0) --last;
+  return *particles_[last];
+}
+
+HistoryDistribution ParticleStateDistribution::ToHistoryDistribution() const {
+  HistoryDistribution dist;
+  for (const std::unique_ptr<State>& particle : particles_) {
+    dist.first.push_back(particle->Clone());
+  }
+  dist.second = weights_;
+  return dist;
+}
+
 }  // namespace algorithms
 }  // namespace open_spiel
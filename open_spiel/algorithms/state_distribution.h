@@ -15,7 +15,10 @@
 #ifndef OPEN_SPIEL_ALGORITHMS_STATE_DISTRIBUTION_H_
 #define OPEN_SPIEL_ALGORITHMS_STATE_DISTRIBUTION_H_
 
+#include <memory>
+#include <random>
 #include <string>
+#include <vector>
 
 #include "open_spiel/policy.h"
 #include "open_spiel/spiel.h"
@@ -57,6 +60,66 @@ std::unique_ptr<HistoryDistribution> UpdateIncrementalStateDistribution(
     const State& state, const Policy* opponent_policy, int player_id,
     std::unique_ptr<HistoryDistribution> previous);
 
+// A fixed number of weighted histories (particles) approximating the same
+// distribution, for games where enumerating all the histories consistent with
+// an information state is too expensive (e.g. bridge or hanabi). It follows a
+// trajectory of the game from its start, one action at a time, so that each
+// update costs the same whatever the number of consistent histories.
+//
+// At each action of the trajectory, every particle takes one action too: the
+// same one at the player's own decisions, and otherwise one of the chance
+// outcomes or opponent actions which keep it in the player's information
+// state, sampled by their probabilities. Its weight is multiplied by the total
+// probability of those actions; when there is none, it is 0, and the particle
+// is left behind until it is resampled. When the effective sample size (1 /
+// the sum of the squared normalized weights) drops below resampling_threshold
+// times the number of particles, the particles are resampled by their
+// weights, and the states of those dropped are overwritten with copies of
+// those kept (see CopyOrCloneState), rather than reallocated.
+//
+// Same requirements as GetStateDistribution. Histories which the opponent's
+// policy gives no probability are never found, and if all the particles end
+// up with no weight, Update fails: more particles are then needed.
+class ParticleStateDistribution {
+ public:
+  ParticleStateDistribution(const Game& game, Player player,
+                            const Policy* opponent_policy, int num_particles,
+                            int seed, double resampling_threshold = 0.5);
+
+  // Moves the particles along the actions of the state's history which they
+  // have not taken yet. The history must continue the ones given before,
+  // from the start of the game, and will usually be one action longer.
+  void Update(const State& state);
+
+  int NumParticles() const { return particles_.size(); }
+  const std::vector<std::unique_ptr<State>>& Particles() const {
+    return particles_;
+  }
+  // The weights of the particles, which sum to 1.
+  const std::vector<double>& Weights() const { return weights_; }
+  double EffectiveSampleSize() const;
+
+  // Samples one of the particles by their weights.
+  const State& SampleState();
+
+  // A copy of the particles, e.g. for IS-MCTS.
+  HistoryDistribution ToHistoryDistribution() const;
+
+ private:
+  // Moves the particles along one action of the trajectory.
+  void Step(Action action);
+  void Resample();
+
+  const Player player_;
+  const Policy* opponent_policy_;
+  const double resampling_threshold_;
+  std::mt19937 rng_;
+  // Where the trajectory is.
+  std::unique_ptr<State> state_;
+  std::vector<std::unique_ptr<State>> particles_;
+  std::vector<double> weights_;
+};
+
 }  // namespace algorithms
 }  // namespace open_spiel
 
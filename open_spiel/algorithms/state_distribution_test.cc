@@ -167,6 +167,45 @@ void HUNLIncrementalTest() {
   CheckDistHasSameInfostate(*incremental_dist, *state, /*player_id=*/0);
 }
 
+// The particles approximate the exact distribution, and stay in the player's
+// information state along a trajectory.
+void LeducParticleStateDistributionTest() {
+  std::shared_ptr<const Game> game = LoadGame("leduc_poker");
+  TabularPolicy uniform_policy = GetUniformPolicy(*game);
+  ParticleStateDistribution particles(*game, /*player=*/1, &uniform_policy,
+                                      /*num_particles=*/2000, /*seed=*/0);
+  std::unique_ptr<State> state = game->NewInitialState();
+  for (Action action : {0, 1, 1}) {
+    state->ApplyAction(action);
+    particles.Update(*state);
+  }
+  HistoryDistribution particle_dist = particles.ToHistoryDistribution();
+  CheckDistHasSameInfostate(particle_dist, *state, /*player_id=*/1);
+  SPIEL_CHECK_EQ(particles.NumParticles(), 2000);
+
+  // Each of the 5 cards player 0 may have is about as likely.
+  HistoryDistribution dist = GetStateDistribution(*state, &uniform_policy);
+  for (int i = 0; i < dist.first.size(); ++i) {
+    double weight = 0;
+    for (int j = 0; j < particle_dist.first.size(); ++j) {
+      if (particle_dist.first[j]->History() == dist.first[i]->History()) {
+        weight += particle_dist.second[j];
+      }
+    }
+    SPIEL_CHECK_FLOAT_NEAR(weight, dist.second[i], 0.05);
+  }
+  SPIEL_CHECK_EQ(
+      particles.SampleState().InformationStateString(/*player=*/1),
+      state->InformationStateString(/*player=*/1));
+
+  // Several actions at once, up to the public card.
+  state->ApplyAction(state->LegalActions()[0]);
+  state->ApplyAction(state->LegalActions()[0]);
+  particles.Update(*state);
+  CheckDistHasSameInfostate(particles.ToHistoryDistribution(), *state,
+                            /*player_id=*/1);
+  SPIEL_CHECK_GE(particles.EffectiveSampleSize(), 1);
+}
 
 }  // namespace
 }  // namespace algorithms
@@ -177,6 +216,7 @@ namespace algorithms = open_spiel::algorithms;
 int main(int argc, char** argv) {
   algorithms::KuhnStateDistributionTest();
   algorithms::LeducStateDistributionTest();
+  algorithms::LeducParticleStateDistributionTest();
 
   // ACPC is an optional dependency. Only test HUNL if it is registered.
   if (open_spiel::IsGameRegistered(std::string(algorithms::kHUNLGameString))) {
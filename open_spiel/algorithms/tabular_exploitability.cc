@@ -14,21 +14,63 @@
 
 #include "open_spiel/algorithms/tabular_exploitability.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <functional>
 #include <limits>
 #include <unordered_set>
+#include <vector>
 
 #include "open_spiel/algorithms/best_response.h"
+#include "open_spiel/algorithms/compiled_game_tree.h"
 #include "open_spiel/algorithms/expected_returns.h"
 #include "open_spiel/algorithms/history_tree.h"
 #include "open_spiel/policy.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/thread.h"
 
 namespace open_spiel {
 namespace algorithms {
 
+namespace {
+
+// Returns the value of a best response to the policy for each player. The
+// players are shared out between up to num_threads threads, one of which is
+// the calling thread and first runs on_main_thread. Threads left over split the
+// policy queries of each best response.
+std::vector<double> BestResponseValues(
+    const CompiledGameTree& tree, const Policy& policy, int num_threads,
+    const std::function<void()>& on_main_thread = [] {}) {
+  SPIEL_CHECK_GE(num_threads, 1);
+  const int num_players = tree.NumPlayers();
+  const int num_workers = std::min(num_threads, num_players);
+  const int lookup_threads = std::max(1, num_threads / num_players);
+  std::vector<double> values(num_players);
+  std::atomic<int> next_player(0);
+  auto work = [&]() {
+    for (Player p = next_player++; p < num_players; p = next_player++) {
+      CompiledTreeBestResponse best_response(tree, p, &policy, lookup_threads);
+      values[p] = best_response.Value();
+    }
+  };
+  std::vector<Thread> threads;
+  for (int i = 1; i < num_workers; ++i) threads.emplace_back(work);
+  on_main_thread();
+  work();
+  for (Thread& thread : threads) thread.join();
+  return values;
+}
+
+}  // namespace
+
 double Exploitability(const Game& game, const Policy& policy) {
+  return Exploitability(game, policy, /*num_threads=*/1);
+}
+
+double Exploitability(const Game& game, const Policy& policy,
+                      int num_threads) {
   GameType game_type = game.GetType();
   if (game_type.dynamics != GameType::Dynamics::kSequential) {
     SpielFatalError("The game must be turn-based.");
@@ -38,11 +80,10 @@ double Exploitability(const Game& game, const Policy& policy) {
     SpielFatalError("The game must have zero- or constant-sum utility.");
   }
 
-  std::unique_ptr<State> root = game.NewInitialState();
+  const CompiledGameTree tree(*game.NewInitialState(), /*keep_states=*/true);
   double nash_conv = 0;
-  for (auto i = Player{0}; i < game.NumPlayers(); ++i) {
-    TabularBestResponse best_response(game, i, &policy);
-    nash_conv += best_response.Value(root->ToString());
+  for (double value : BestResponseValues(tree, policy, num_threads)) {
+    nash_conv += value;
   }
   return (nash_conv - game.UtilitySum()) / game.NumPlayers();
 }
@@ -60,19 +101,25 @@ double NashConv(const Game& game, const Policy& policy) {
 
 double NashConv(const Game& game, const Policy& policy,
                 bool use_state_get_policy) {
+  return NashConv(game, policy, use_state_get_policy, /*num_threads=*/1);
+}
+
+double NashConv(const Game& game, const Policy& policy,
+                bool use_state_get_policy, int num_threads) {
   GameType game_type = game.GetType();
   if (game_type.dynamics != GameType::Dynamics::kSequential) {
     SpielFatalError("The game must be turn-based.");
   }
 
   std::unique_ptr<State> root = game.NewInitialState();
-  std::vector<double> best_response_values(game.NumPlayers());
-  for (auto p = Player{0}; p < game.NumPlayers(); ++p) {
-    TabularBestResponse best_response(game, p, &policy);
-    best_response_values[p] = best_response.Value(root->ToString());
-  }
-  std::vector<double> on_policy_values =
-      ExpectedReturns(*root, policy, -1, !use_state_get_policy);
+  const CompiledGameTree tree(*root, /*keep_states=*/true);
+  std::vector<double> on_policy_values;
+  std::vector<double> best_response_values =
+      BestResponseValues(tree, policy, num_threads, [&]() {
+        on_policy_values = use_state_get_policy
+                               ? ExpectedReturns(*root, policy, -1, false)
+                               : ExpectedReturns(tree, policy);
+      });
   SPIEL_CHECK_EQ(best_response_values.size(), on_policy_values.size());
   double nash_conv = 0;
   for (auto p = Player{0}; p < game.NumPlayers(); ++p) {
@@ -35,6 +35,12 @@ namespace algorithms {
 // an error.
 double Exploitability(const Game& game, const Policy& policy);
 
+// Same as above, with the best responses of the players computed concurrently
+// on up to num_threads threads. Any threads beyond one per player split the
+// policy queries of each best response, so the policy must allow concurrent
+// calls to GetStatePolicy; the tabular policies all do.
+double Exploitability(const Game& game, const Policy& policy, int num_threads);
+
 // Same function provided for easy Python compatibility.
 double Exploitability(
     const Game& game,
@@ -53,6 +59,12 @@ double Exploitability(
 double NashConv(const Game& game, const Policy& policy,
                 bool use_state_get_policy);
 
+// Same as above, with the best responses of the players, and the expected
+// values of the joint policy, computed concurrently on up to num_threads
+// threads, as for Exploitability.
+double NashConv(const Game& game, const Policy& policy,
+                bool use_state_get_policy, int num_threads);
+
 // Same as above with use_state_get_policy set to false.
 double NashConv(const Game& game, const Policy& policy);
 
@@ -481,6 +481,22 @@ void TestNashConv(const std::string& game_name,
   }
 }
 
+// The threads only share out the work, so the values are the same as on one.
+void TestMultithreadedNashConv(const std::string& game_name) {
+  std::shared_ptr<const Game> game = LoadGame(game_name);
+  TabularPolicy policy = GetUniformPolicy(*game);
+  for (int num_threads : {2, 3, 8}) {
+    SPIEL_CHECK_EQ(NashConv(*game, policy, false, num_threads),
+                   NashConv(*game, policy, false));
+    SPIEL_CHECK_EQ(NashConv(*game, policy, true, num_threads),
+                   NashConv(*game, policy, true));
+    if (game->GetType().utility == GameType::Utility::kZeroSum) {
+      SPIEL_CHECK_EQ(Exploitability(*game, policy, num_threads),
+                     Exploitability(*game, policy));
+    }
+  }
+}
+
 }  // namespace
 }  // namespace algorithms
 }  // namespace open_spiel
@@ -521,4 +537,7 @@ int main(int argc, char** argv) {
                                        open_spiel::GetFirstActionPolicy, 2.);
   open_spiel::algorithms::TestNashConv("leduc_poker",
                                        open_spiel::GetFirstActionPolicy, 2.);
+
+  open_spiel::algorithms::TestMultithreadedNashConv("kuhn_poker(players=3)");
+  open_spiel::algorithms::TestMultithreadedNashConv("leduc_poker");
 }
@@ -17,13 +17,19 @@
 #include <algorithm>
 #include <chrono>  // NOLINT
 #include <cstdint>
+#include <memory>
 #include <random>
 #include <unordered_map>
 #include <vector>
 
+#include "open_spiel/abseil-cpp/absl/random/bit_gen_ref.h"
+#include "open_spiel/abseil-cpp/absl/random/distributions.h"
 #include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/abseil-cpp/absl/types/span.h"
+#include "open_spiel/algorithms/compiled_game_tree.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/thread.h"
 
 namespace open_spiel {
 namespace algorithms {
@@ -39,6 +45,317 @@ std::string StateKey(const Game& game, const State& state,
   }
   return state.ToString();
 }
+
+// The policy of the current player, which must not have more actions than
+// are legal.
+ActionsAndProbs CheckedStatePolicy(const std::vector<TabularPolicy>& policies,
+                                   const State& state) {
+  ActionsAndProbs policy = policies.at(state.CurrentPlayer())
+                               .GetStatePolicy(state.InformationStateString());
+  if (policy.size() > state.LegalActions().size()) {
+    std::string policy_str = "";
+    for (const auto& item : policy) {
+      absl::StrAppend(&policy_str, "(", item.first, ",", item.second, ") ");
+    }
+    SpielFatalError(absl::StrCat(
+        "There are more actions than legal actions from ",
+        typeid(policies.at(state.CurrentPlayer())).name(),
+        "\n Legal actions are: ", absl::StrJoin(state.LegalActions(), " "),
+        " \n Available probabilities were:", policy_str));
+  }
+  return policy;
+}
+
+// Changes the rows of a [batch_size, old_length, width] buffer to new_length
+// steps in place, padding the new steps with pad.
+template <typename T>
+void ResizeRows(int batch_size, int old_length, int new_length, int width,
+                T pad, std::vector<T>* values) {
+  const int64_t old_row = static_cast<int64_t>(old_length) * width;
+  const int64_t new_row = static_cast<int64_t>(new_length) * width;
+  if (new_row == old_row || values->empty()) return;
+  if (new_row < old_row) {
+    // The rows move towards the front, so the earlier ones first.
+    for (int b = 0; b < batch_size; ++b) {
+      std::copy_n(values->begin() + b * old_row, new_row,
+                  values->begin() + b * new_row);
+    }
+    values->resize(batch_size * new_row);
+  } else {
+    values->resize(batch_size * new_row, pad);
+    for (int b = batch_size - 1; b >= 0; --b) {
+      std::copy_backward(values->begin() + b * old_row,
+                         values->begin() + (b + 1) * old_row,
+                         values->begin() + b * new_row + old_row);
+      std::fill(values->begin() + b * new_row + old_row,
+                values->begin() + (b + 1) * new_row, pad);
+    }
+  }
+}
+
+// RecordTrajectory, with either generator.
+template <typename Rng>
+BatchedTrajectory RecordTrajectoryWith(
+    const Game& game, const std::vector<TabularPolicy>& policies,
+    const State& initial_state,
+    const std::unordered_map<std::string, int>& state_to_index,
+    bool include_full_observations, Rng* rng) {
+  if (state_to_index.empty()) SPIEL_CHECK_TRUE(include_full_observations);
+  BatchedTrajectory trajectory(/*batch_size=*/1);
+  std::unique_ptr<open_spiel::State> state = initial_state.Clone();
+  bool find_index = !state_to_index.empty();
+  while (!state->IsTerminal()) {
+    Action action = kInvalidAction;
+    if (state->IsChanceNode()) {
+      action = open_spiel::SampleAction(
+                   state->ChanceOutcomes(),
+                   std::uniform_real_distribution<double>(0.0, 1.0)(*rng))
+                   .first;
+    } else if (state->IsSimultaneousNode()) {
+      open_spiel::SpielFatalError(
+          "We do not support games with simultaneous actions.");
+    } else {
+      // Then we're at a decision node.
+      trajectory.legal_actions[0].push_back(state->LegalActionsMask());
+      if (find_index) {
+        auto it = state_to_index.find(StateKey(game, *state));
+        SPIEL_CHECK_TRUE(it != state_to_index.end());
+        trajectory.state_indices[0].push_back(it->second);
+      } else {
+        trajectory.observations[0].push_back(state->InformationStateTensor());
+      }
+      ActionsAndProbs policy = CheckedStatePolicy(policies, *state);
+      std::vector<double> probs(game.NumDistinctActions(), 0.);
+      for (const std::pair<Action, double>& pair : policy) {
+        probs[pair.first] = pair.second;
+      }
+      trajectory.player_policies[0].push_back(probs);
+      trajectory.player_ids[0].push_back(state->CurrentPlayer());
+      action = SampleAction(policy, *rng).first;
+      trajectory.actions[0].push_back(action);
+    }
+    SPIEL_CHECK_NE(action, kInvalidAction);
+    state->ApplyAction(action);
+  }
+  trajectory.valid[0] = std::vector<int>(trajectory.actions[0].size(), true);
+  trajectory.rewards[0] = state->Returns();
+  trajectory.next_is_terminal[0].resize(trajectory.actions[0].size(), false);
+  trajectory.next_is_terminal[0][trajectory.next_is_terminal[0].size() - 1] =
+      true;
+
+  // We arbitrarily set max_trajectory_length based on the actions field. All
+  // the fields should have the same length.
+  trajectory.max_trajectory_length = trajectory.actions[0].size();
+  return trajectory;
+}
+
+// Records a trajectory into row b of the batch, with its own random number
+// generator. Returns false, with the row partly written, if it is longer
+// than the batch.
+bool RecordColumnarRow(
+    const Game& game, const std::vector<TabularPolicy>& policies,
+    const State& initial_state,
+    const std::unordered_map<std::string, int>& state_to_index, int b,
+    Philox* rng, ColumnarTrajectory* trajectory) {
+  const bool find_index = !state_to_index.empty();
+  std::unique_ptr<State> state = initial_state.Clone();
+  int t = 0;
+  while (!state->IsTerminal()) {
+    Action action = kInvalidAction;
+    if (state->IsChanceNode()) {
+      action = open_spiel::SampleAction(
+                   state->ChanceOutcomes(),
+                   std::uniform_real_distribution<double>(0.0, 1.0)(*rng))
+                   .first;
+    } else if (state->IsSimultaneousNode()) {
+      open_spiel::SpielFatalError(
+          "We do not support games with simultaneous actions.");
+    } else {
+      if (t == trajectory->max_length) return false;
+      const Player player = state->CurrentPlayer();
+      const int step = b * trajectory->max_length + t;
+      absl::Span<float> legal_actions = trajectory->LegalActions(b, t);
+      std::fill(legal_actions.begin(), legal_actions.end(), 0);
+      for (Action legal_action : state->LegalActions()) {
+        legal_actions[legal_action] = 1;
+      }
+      if (find_index) {
+        auto it = state_to_index.find(StateKey(game, *state));
+        SPIEL_CHECK_TRUE(it != state_to_index.end());
+        trajectory->state_indices[step] = it->second;
+      } else {
+        state->InformationStateTensor(player, trajectory->Observation(b, t));
+      }
+      ActionsAndProbs policy = CheckedStatePolicy(policies, *state);
+      absl::Span<float> probs = trajectory->PlayerPolicy(b, t);
+      std::fill(probs.begin(), probs.end(), 0);
+      for (const std::pair<Action, double>& pair : policy) {
+        probs[pair.first] = pair.second;
+      }
+      trajectory->player_ids[step] = player;
+      action = SampleAction(policy, *rng).first;
+      trajectory->actions[step] = action;
+      trajectory->valid[step] = 1;
+      ++t;
+    }
+    SPIEL_CHECK_NE(action, kInvalidAction);
+    state->ApplyAction(action);
+  }
+  SPIEL_CHECK_GT(t, 0);
+  trajectory->lengths[b] = t;
+  trajectory->next_is_terminal[b * trajectory->max_length + t - 1] = 1;
+  const std::vector<double> returns = state->Returns();
+  std::copy(returns.begin(), returns.end(),
+            trajectory->rewards.begin() + b * trajectory->num_players);
+  return true;
+}
+
+// The index of the outcome drawn from the probabilities by z, as SampleAction
+// draws it.
+int SampleIndex(absl::Span<const double> probabilities, double z) {
+  double sum = 0;
+  for (int i = 0; i < probabilities.size(); ++i) {
+    if (sum <= z && z < sum + probabilities[i]) return i;
+    sum += probabilities[i];
+  }
+  SpielFatalError(absl::StrCat("Failed to sample an outcome; z=", z));
+}
+
+// RecordColumnarRow, walking the compiled tree.
+bool RecordCompiledRow(const TrajectoryTree& tree,
+                       const IndexedTabularPolicy& policy, int b, Philox* rng,
+                       ColumnarTrajectory* trajectory) {
+  const CompiledGameTree& game_tree = tree.Tree();
+  int node = CompiledGameTree::kRoot;
+  int t = 0;
+  while (!game_tree.IsTerminal(node)) {
+    int index;
+    if (game_tree.IsChanceNode(node)) {
+      index = SampleIndex(
+          game_tree.ChanceProbabilities(node),
+          std::uniform_real_distribution<double>(0.0, 1.0)(*rng));
+    } else {
+      if (t == trajectory->max_length) return false;
+      const int info_state = game_tree.InfoState(node);
+      const int step = b * trajectory->max_length + t;
+      absl::Span<const float> legal_actions = tree.LegalActionsMask(info_state);
+      std::copy(legal_actions.begin(), legal_actions.end(),
+                trajectory->LegalActions(b, t).begin());
+      if (tree.ObservationSize() > 0) {
+        absl::Span<const float> observation = tree.Observation(info_state);
+        std::copy(observation.begin(), observation.end(),
+                  trajectory->Observation(b, t).begin());
+      } else {
+        const int state_index = tree.StateIndex(info_state);
+        SPIEL_CHECK_GE(state_index, 0);
+        trajectory->state_indices[step] = state_index;
+      }
+      absl::Span<const double> probabilities = policy.Probabilities(info_state);
+      absl::Span<const Action> actions = game_tree.Actions(node);
+      absl::Span<float> probs = trajectory->PlayerPolicy(b, t);
+      std::fill(probs.begin(), probs.end(), 0);
+      for (int i = 0; i < actions.size(); ++i) {
+        probs[actions[i]] = probabilities[i];
+      }
+      trajectory->player_ids[step] = game_tree.CurrentPlayer(node);
+      index = SampleIndex(probabilities,
+                          absl::Uniform(absl::BitGenRef(*rng), 0.0, 1.0));
+      trajectory->actions[step] = actions[index];
+      trajectory->valid[step] = 1;
+      ++t;
+    }
+    node = game_tree.Children(node)[index];
+  }
+  SPIEL_CHECK_GT(t, 0);
+  trajectory->lengths[b] = t;
+  trajectory->next_is_terminal[b * trajectory->max_length + t - 1] = 1;
+  absl::Span<const double> returns = game_tree.Returns(node);
+  std::copy(returns.begin(), returns.end(),
+            trajectory->rewards.begin() + b * trajectory->num_players);
+  return true;
+}
+
+// Copies row from_b of a batch into row to_b of another of the same length.
+void CopyColumnarRow(const ColumnarTrajectory& from, int from_b, int to_b,
+                     ColumnarTrajectory* to) {
+  SPIEL_CHECK_EQ(from.max_length, to->max_length);
+  auto copy = [from_b, to_b](const auto& from_values, int width,
+                             auto* to_values) {
+    std::copy_n(from_values.begin() + from_b * width, width,
+                to_values->begin() + to_b * width);
+  };
+  const int length = from.max_length;
+  copy(from.observations, length * from.observation_size, &to->observations);
+  copy(from.state_indices, length, &to->state_indices);
+  copy(from.legal_actions, length * from.num_actions, &to->legal_actions);
+  copy(from.actions, length, &to->actions);
+  copy(from.player_policies, length * from.num_actions, &to->player_policies);
+  copy(from.player_ids, length, &to->player_ids);
+  copy(from.rewards, from.num_players, &to->rewards);
+  copy(from.valid, length, &to->valid);
+  copy(from.next_is_terminal, length, &to->next_is_terminal);
+  to->lengths[to_b] = from.lengths[from_b];
+}
+
+// Records a batch of trajectories, with record_row(b, rng, trajectory)
+// recording one into row b and returning false if it is longer than the batch.
+// Without a max_unroll_length, the batch starts at initial_length steps.
+template <typename RecordRow>
+ColumnarTrajectory RecordColumnarBatch(int batch_size, int observation_size,
+                                       int num_actions, int num_players,
+                                       int initial_length, std::mt19937* rng,
+                                       int max_unroll_length, int num_threads,
+                                       RecordRow record_row) {
+  SPIEL_CHECK_GT(batch_size, 0);
+  // Without a fixed length, the buffers start at a guess, and the longer
+  // trajectories are recorded again on their own, then copied in once the
+  // buffers have grown to fit them.
+  const bool fixed_length = max_unroll_length > 0;
+  ColumnarTrajectory trajectory(
+      batch_size, fixed_length ? max_unroll_length : initial_length,
+      observation_size, num_actions, num_players);
+  const Philox batch_rng((*rng)());
+  std::vector<std::unique_ptr<ColumnarTrajectory>> overflows(batch_size);
+
+  auto record = [&](int64_t begin, int64_t end) {
+    for (int b = begin; b < end; ++b) {
+      Philox row_rng = batch_rng.Split(b);
+      if (record_row(b, &row_rng, &trajectory)) continue;
+      if (fixed_length) {
+        SpielFatalError(absl::StrCat("A trajectory is longer than ",
+                                     max_unroll_length, " steps."));
+      }
+      for (int length = 2 * trajectory.max_length;; length *= 2) {
+        overflows[b] = std::make_unique<ColumnarTrajectory>(
+            1, length, trajectory.observation_size, trajectory.num_actions,
+            trajectory.num_players);
+        row_rng = batch_rng.Split(b);
+        if (record_row(0, &row_rng, overflows[b].get())) break;
+      }
+    }
+  };
+  if (num_threads <= 1) {
+    record(0, batch_size);
+  } else {
+    ThreadPool::Default()->ParallelFor(
+        0, batch_size, (batch_size + num_threads - 1) / num_threads, record);
+  }
+
+  int longest = 0;
+  for (int b = 0; b < batch_size; ++b) {
+    longest = std::max(longest, overflows[b] ? overflows[b]->lengths[0]
+                                             : trajectory.lengths[b]);
+  }
+  if (longest > trajectory.max_length) trajectory.Resize(longest);
+  for (int b = 0; b < batch_size; ++b) {
+    if (!overflows[b]) continue;
+    overflows[b]->Resize(trajectory.max_length);
+    CopyColumnarRow(*overflows[b], 0, b, &trajectory);
+  }
+  if (!fixed_length) trajectory.ShrinkToFit();
+  return trajectory;
+}
+
 }  // namespace
 
 // Initializes a BatchedTrajectory of size [batch_size, T].
@@ -110,6 +427,46 @@ void BatchedTrajectory::ResizeFields(int length) {
   }
 }
 
+ColumnarTrajectory::ColumnarTrajectory(int batch_size, int max_length,
+                                       int observation_size, int num_actions,
+                                       int num_players)
+    : batch_size(batch_size),
+      max_length(max_length),
+      observation_size(observation_size),
+      num_actions(num_actions),
+      num_players(num_players),
+      lengths(batch_size, 0),
+      // The padding values of BatchedTrajectory::ResizeFields.
+      observations(batch_size * max_length * observation_size, 0),
+      state_indices(batch_size * max_length, 0),
+      legal_actions(batch_size * max_length * num_actions, 1),
+      actions(batch_size * max_length, 0),
+      player_policies(batch_size * max_length * num_actions, 1),
+      player_ids(batch_size * max_length, 0),
+      rewards(batch_size * num_players, 0),
+      valid(batch_size * max_length, 0),
+      next_is_terminal(batch_size * max_length, 0) {}
+
+void ColumnarTrajectory::Resize(int length) {
+  SPIEL_CHECK_GE(length, *std::max_element(lengths.begin(), lengths.end()));
+  ResizeRows<float>(batch_size, max_length, length, observation_size, 0,
+                    &observations);
+  ResizeRows<int>(batch_size, max_length, length, 1, 0, &state_indices);
+  ResizeRows<float>(batch_size, max_length, length, num_actions, 1,
+                    &legal_actions);
+  ResizeRows<Action>(batch_size, max_length, length, 1, 0, &actions);
+  ResizeRows<float>(batch_size, max_length, length, num_actions, 1,
+                    &player_policies);
+  ResizeRows<int>(batch_size, max_length, length, 1, 0, &player_ids);
+  ResizeRows<float>(batch_size, max_length, length, 1, 0, &valid);
+  ResizeRows<float>(batch_size, max_length, length, 1, 0, &next_is_terminal);
+  max_length = length;
+}
+
+void ColumnarTrajectory::ShrinkToFit() {
+  Resize(*std::max_element(lengths.begin(), lengths.end()));
+}
+
 BatchedTrajectory RecordBatchedTrajectory(
     const Game& game, const std::vector<TabularPolicy>& policies,
     const State& initial_state,
@@ -136,66 +493,116 @@ BatchedTrajectory RecordTrajectory(
     const State& initial_state,
     const std::unordered_map<std::string, int>& state_to_index,
     bool include_full_observations, std::mt19937* rng) {
+  return RecordTrajectoryWith(game, policies, initial_state, state_to_index,
+                              include_full_observations, rng);
+}
+
+BatchedTrajectory RecordTrajectory(
+    const Game& game, const std::vector<TabularPolicy>& policies,
+    const State& initial_state,
+    const std::unordered_map<std::string, int>& state_to_index,
+    bool include_full_observations, Philox* rng) {
+  return RecordTrajectoryWith(game, policies, initial_state, state_to_index,
+                              include_full_observations, rng);
+}
+
+ColumnarTrajectory RecordColumnarTrajectory(
+    const Game& game, const std::vector<TabularPolicy>& policies,
+    const State& initial_state,
+    const std::unordered_map<std::string, int>& state_to_index, int batch_size,
+    bool include_full_observations, std::mt19937* rng,
+    int max_unroll_length, int num_threads) {
   if (state_to_index.empty()) SPIEL_CHECK_TRUE(include_full_observations);
-  BatchedTrajectory trajectory(/*batch_size=*/1);
-  std::unique_ptr<open_spiel::State> state = initial_state.Clone();
-  bool find_index = !state_to_index.empty();
-  while (!state->IsTerminal()) {
-    Action action = kInvalidAction;
-    if (state->IsChanceNode()) {
-      action = open_spiel::SampleAction(
-                   state->ChanceOutcomes(),
-                   std::uniform_real_distribution<double>(0.0, 1.0)(*rng))
-                   .first;
-    } else if (state->IsSimultaneousNode()) {
-      open_spiel::SpielFatalError(
-          "We do not support games with simultaneous actions.");
+  const bool find_index = !state_to_index.empty();
+  return RecordColumnarBatch(
+      batch_size, find_index ? 0 : game.InformationStateTensorSize(),
+      game.NumDistinctActions(), game.NumPlayers(),
+      std::min(game.MaxGameLength(), 64), rng, max_unroll_length, num_threads,
+      [&](int b, Philox* row_rng, ColumnarTrajectory* trajectory) {
+        return RecordColumnarRow(game, policies, initial_state, state_to_index,
+                                 b, row_rng, trajectory);
+      });
+}
+
+TrajectoryTree::TrajectoryTree(
+    const Game& game, const State& initial_state,
+    const std::unordered_map<std::string, int>& state_to_index,
+    bool include_full_observations)
+    : tree_(initial_state, /*keep_states=*/include_full_observations),
+      observation_size_(include_full_observations
+                            ? game.InformationStateTensorSize()
+                            : 0),
+      num_actions_(game.NumDistinctActions()) {
+  if (state_to_index.empty()) SPIEL_CHECK_TRUE(include_full_observations);
+  const int num_info_states = tree_.NumInfoStates();
+  observations_.resize(static_cast<int64_t>(num_info_states) *
+                       observation_size_);
+  legal_actions_masks_.resize(static_cast<int64_t>(num_info_states) *
+                              num_actions_);
+  state_indices_.reserve(num_info_states);
+  for (int info_state = 0; info_state < num_info_states; ++info_state) {
+    for (Action action : tree_.InfoStateActions(info_state)) {
+      legal_actions_masks_[static_cast<int64_t>(info_state) * num_actions_ +
+                           action] = 1;
+    }
+    if (include_full_observations) {
+      tree_.InfoStateState(info_state)
+          .InformationStateTensor(
+              tree_.InfoStatePlayer(info_state),
+              absl::MakeSpan(observations_)
+                  .subspan(static_cast<int64_t>(info_state) *
+                               observation_size_,
+                           observation_size_));
     } else {
-      // Then we're at a decision node.
-      trajectory.legal_actions[0].push_back(state->LegalActionsMask());
-      if (find_index) {
-        auto it = state_to_index.find(StateKey(game, *state));
-        SPIEL_CHECK_TRUE(it != state_to_index.end());
-        trajectory.state_indices[0].push_back(it->second);
-      } else {
-        trajectory.observations[0].push_back(state->InformationStateTensor());
-      }
-      ActionsAndProbs policy =
-          policies.at(state->CurrentPlayer())
-              .GetStatePolicy(state->InformationStateString());
-      if (policy.size() > state->LegalActions().size()) {
-        std::string policy_str = "";
-        for (const auto& item : policy) {
-          absl::StrAppend(&policy_str, "(", item.first, ",", item.second, ") ");
-        }
-        SpielFatalError(absl::StrCat(
-            "There are more actions than legal actions from ",
-            typeid(policies.at(state->CurrentPlayer())).name(),
-            "\n Legal actions are: ", absl::StrJoin(state->LegalActions(), " "),
-            " \n Available probabilities were:", policy_str));
-      }
-      std::vector<double> probs(game.NumDistinctActions(), 0.);
-      for (const std::pair<Action, double>& pair : policy) {
-        probs[pair.first] = pair.second;
+      // The information states missing from state_to_index are only an
+      // error if a trajectory reaches them.
+      auto it = state_to_index.find(tree_.InfoStateString(info_state));
+      state_indices_.push_back(it == state_to_index.end() ? -1 : it->second);
+    }
+  }
+}
+
+IndexedTabularPolicy::IndexedTabularPolicy(
+    const TrajectoryTree& tree, const std::vector<TabularPolicy>& policies) {
+  const CompiledGameTree& game_tree = tree.Tree();
+  begins_.reserve(game_tree.NumInfoStates() + 1);
+  begins_.push_back(0);
+  for (int info_state = 0; info_state < game_tree.NumInfoStates();
+       ++info_state) {
+    absl::Span<const Action> actions = game_tree.InfoStateActions(info_state);
+    const ActionsAndProbs policy =
+        policies.at(game_tree.InfoStatePlayer(info_state))
+            .GetStatePolicy(game_tree.InfoStateString(info_state));
+    if (policy.size() > actions.size()) {
+      SpielFatalError(absl::StrCat(
+          "There are more actions than legal actions in the policy of ",
+          game_tree.InfoStateString(info_state)));
+    }
+    const int begin = probabilities_.size();
+    probabilities_.resize(begin + actions.size(), 0);
+    for (const auto& [action, prob] : policy) {
+      auto it = std::find(actions.begin(), actions.end(), action);
+      if (it == actions.end()) {
+        SpielFatalError(absl::StrCat("Illegal action ", action,
+                                     " in the policy of ",
+                                     game_tree.InfoStateString(info_state)));
       }
-      trajectory.player_policies[0].push_back(probs);
-      trajectory.player_ids[0].push_back(state->CurrentPlayer());
-      action = SampleAction(policy, *rng).first;
-      trajectory.actions[0].push_back(action);
+      probabilities_[begin + (it - actions.begin())] = prob;
     }
-    SPIEL_CHECK_NE(action, kInvalidAction);
-    state->ApplyAction(action);
+    begins_.push_back(probabilities_.size());
   }
-  trajectory.valid[0] = std::vector<int>(trajectory.actions[0].size(), true);
-  trajectory.rewards[0] = state->Returns();
-  trajectory.next_is_terminal[0].resize(trajectory.actions[0].size(), false);
-  trajectory.next_is_terminal[0][trajectory.next_is_terminal[0].size() - 1] =
-      true;
+}
 
-  // We arbitrarily set max_trajectory_length based on the actions field. All
-  // the fields should have the same length.
-  trajectory.max_trajectory_length = trajectory.actions[0].size();
-  return trajectory;
+ColumnarTrajectory RecordColumnarTrajectory(
+    const TrajectoryTree& tree, const IndexedTabularPolicy& policy,
+    int batch_size, std::mt19937* rng, int max_unroll_length,
+    int num_threads) {
+  return RecordColumnarBatch(
+      batch_size, tree.ObservationSize(), tree.NumActions(),
+      tree.Tree().NumPlayers(), 64, rng, max_unroll_length, num_threads,
+      [&](int b, Philox* row_rng, ColumnarTrajectory* trajectory) {
+        return RecordCompiledRow(tree, policy, b, row_rng, trajectory);
+      });
 }
 
 BatchedTrajectory RecordBatchedTrajectory(
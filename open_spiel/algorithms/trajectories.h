@@ -20,9 +20,12 @@
 #include <unordered_map>
 #include <vector>
 
+#include "open_spiel/abseil-cpp/absl/types/span.h"
+#include "open_spiel/algorithms/compiled_game_tree.h"
 #include "open_spiel/policy.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/random.h"
 
 namespace open_spiel {
 namespace algorithms {
@@ -72,6 +75,60 @@ struct BatchedTrajectory {
   uint64_t max_trajectory_length = 0;
 };
 
+// A batch of trajectories of shape [B, T] stored column by column: each field
+// is a single row-major buffer, e.g. observations is [B, T, N] with
+// observations[(b * T + t) * N + n] the n-th entry of the observation at step
+// t of trajectory b. The buffers can thus be handed over as they are, e.g. to
+// a TensorFlow tensor or a NumPy array, without the three levels of vectors
+// of BatchedTrajectory, and without padding them afterwards: they are filled
+// with the same padding values as BatchedTrajectory::ResizeFields when
+// created, and the steps recorded overwrite them. valid[b * T + t] is 1 for
+// the steps actually taken, and 0 for the padding.
+struct ColumnarTrajectory {
+  // The observations are left empty if observation_size is 0, e.g. when the
+  // state indices are recorded instead.
+  ColumnarTrajectory(int batch_size, int max_length, int observation_size,
+                     int num_actions, int num_players);
+
+  // Changes T in place, moving each trajectory's steps within the buffers
+  // and padding the new ones. Must be at least the longest trajectory.
+  void Resize(int length);
+  // Resizes to the longest trajectory.
+  void ShrinkToFit();
+
+  // The entries of a step of a trajectory.
+  absl::Span<float> Observation(int b, int t) {
+    return absl::MakeSpan(observations)
+        .subspan((b * max_length + t) * observation_size, observation_size);
+  }
+  absl::Span<float> LegalActions(int b, int t) {
+    return absl::MakeSpan(legal_actions)
+        .subspan((b * max_length + t) * num_actions, num_actions);
+  }
+  absl::Span<float> PlayerPolicy(int b, int t) {
+    return absl::MakeSpan(player_policies)
+        .subspan((b * max_length + t) * num_actions, num_actions);
+  }
+
+  int batch_size;
+  int max_length;  // T
+  int observation_size;
+  int num_actions;
+  int num_players;
+  // The number of steps of each trajectory.
+  std::vector<int> lengths;
+
+  std::vector<float> observations;      // [B, T, observation_size]
+  std::vector<int> state_indices;       // [B, T]
+  std::vector<float> legal_actions;     // [B, T, num_actions]
+  std::vector<Action> actions;          // [B, T]
+  std::vector<float> player_policies;   // [B, T, num_actions]
+  std::vector<int> player_ids;          // [B, T]
+  std::vector<float> rewards;           // [B, num_players]
+  std::vector<float> valid;             // [B, T]
+  std::vector<float> next_is_terminal;  // [B, T]
+};
+
 // If include_full_observations is true, then we record the result of
 // open_spiel::State::InformationStateTensor(); otherwise, we store
 // the index (taken from state_to_index).
@@ -81,6 +138,14 @@ BatchedTrajectory RecordTrajectory(
     const std::unordered_map<std::string, int>& state_to_index,
     bool include_full_observations, std::mt19937* rng_ptr);
 
+// The same, sampling from a counter-based generator, e.g. the stream
+// RecordColumnarTrajectory gives a row.
+BatchedTrajectory RecordTrajectory(
+    const Game& game, const std::vector<TabularPolicy>& policies,
+    const State& initial_state,
+    const std::unordered_map<std::string, int>& state_to_index,
+    bool include_full_observations, Philox* rng_ptr);
+
 BatchedTrajectory RecordBatchedTrajectory(
     const Game& game, const std::vector<TabularPolicy>& policies,
     const State& initial_state,
@@ -104,6 +169,99 @@ BatchedTrajectory RecordBatchedTrajectory(
     const std::unordered_map<std::string, int>& state_to_index, int batch_size,
     bool include_full_observations, int seed, int max_unroll_length = -1);
 
+// As RecordBatchedTrajectory, but recording straight into the buffers of a
+// ColumnarTrajectory, each trajectory into its own row. If max_unroll_length
+// is -1, T is the length of the longest trajectory.
+//
+// Each trajectory samples from its own stream, Split(b) of a Philox seeded
+// from rng_ptr, so the batch only depends on rng_ptr, and not on num_threads:
+// the trajectories are shared out between num_threads blocks run on the
+// shared ThreadPool.
+ColumnarTrajectory RecordColumnarTrajectory(
+    const Game& game, const std::vector<TabularPolicy>& policies,
+    const State& initial_state,
+    const std::unordered_map<std::string, int>& state_to_index, int batch_size,
+    bool include_full_observations, std::mt19937* rng_ptr,
+    int max_unroll_length = -1, int num_threads = 1);
+
+// A game compiled for recording trajectories without building or hashing any
+// string per step: the tree below the initial state as a CompiledGameTree,
+// and for each of its information states what a step records, i.e. its index
+// in state_to_index or its InformationStateTensor, and its legal actions
+// mask. The policies are then an IndexedTabularPolicy over its information
+// states. The game must be small enough to enumerate, as for TabularPolicy.
+class TrajectoryTree {
+ public:
+  // state_to_index is keyed by InformationStateString, as for
+  // RecordTrajectory, and only needed without include_full_observations.
+  TrajectoryTree(const Game& game, const State& initial_state,
+                 const std::unordered_map<std::string, int>& state_to_index,
+                 bool include_full_observations);
+
+  const CompiledGameTree& Tree() const { return tree_; }
+  int ObservationSize() const { return observation_size_; }
+  int NumActions() const { return num_actions_; }
+
+  // The index of an information state in state_to_index.
+  int StateIndex(int info_state) const { return state_indices_[info_state]; }
+  // The InformationStateTensor of an information state, with
+  // include_full_observations.
+  absl::Span<const float> Observation(int info_state) const {
+    return absl::MakeConstSpan(observations_)
+        .subspan(static_cast<int64_t>(info_state) * observation_size_,
+                 observation_size_);
+  }
+  absl::Span<const float> LegalActionsMask(int info_state) const {
+    return absl::MakeConstSpan(legal_actions_masks_)
+        .subspan(static_cast<int64_t>(info_state) * num_actions_,
+                 num_actions_);
+  }
+
+ private:
+  CompiledGameTree tree_;
+  int observation_size_;
+  int num_actions_;
+  std::vector<int> state_indices_;
+  std::vector<float> observations_;
+  std::vector<float> legal_actions_masks_;
+};
+
+// The tabular policies of all the players over the information states of a
+// TrajectoryTree, with the probabilities of each information state's actions,
+// in the order of CompiledGameTree::InfoStateActions, looked up by its number
+// rather than by its string.
+class IndexedTabularPolicy {
+ public:
+  // The policies of the players, by player, as RecordTrajectory takes them.
+  // Each information state's policy is looked up once, and must not have more
+  // actions than are legal.
+  IndexedTabularPolicy(const TrajectoryTree& tree,
+                       const std::vector<TabularPolicy>& policies);
+
+  absl::Span<const double> Probabilities(int info_state) const {
+    return absl::MakeConstSpan(probabilities_)
+        .subspan(begins_[info_state],
+                 begins_[info_state + 1] - begins_[info_state]);
+  }
+  absl::Span<double> MutableProbabilities(int info_state) {
+    return absl::MakeSpan(probabilities_)
+        .subspan(begins_[info_state],
+                 begins_[info_state + 1] - begins_[info_state]);
+  }
+
+ private:
+  std::vector<int> begins_;  // Where each information state's entries start.
+  std::vector<double> probabilities_;
+};
+
+// As RecordColumnarTrajectory, but walking the tree rather than States, and
+// sampling the same trajectories from the same seed when the TabularPolicy
+// entries are in the order of the legal actions.
+ColumnarTrajectory RecordColumnarTrajectory(
+    const TrajectoryTree& tree, const IndexedTabularPolicy& policy,
+    int batch_size, std::mt19937* rng_ptr, int max_unroll_length = -1,
+    int num_threads = 1);
+
 // Stateful version of RecordTrajectory. There are several optimisations that
 // this allows. Currently, the only optimisation is preventing making multiple
 // copies of the state_to_index class. When state_to_index.empty() is false,
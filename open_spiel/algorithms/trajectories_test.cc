@@ -18,6 +18,7 @@
 
 #include "open_spiel/policy.h"
 #include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/random.h"
 
 namespace open_spiel {
 namespace algorithms {
@@ -253,6 +254,138 @@ void BatchedTrajectoryResizesCorrectly(const std::string& game_name) {
   }
 }
 
+// The columnar trajectories are those recorded by RecordTrajectory from the
+// seed of each, with the padding of BatchedTrajectory, whatever the number of
+// threads.
+void ColumnarTrajectoryMatchesBatched(const std::string& game_name,
+                                      bool include_full_observations) {
+  std::shared_ptr<const Game> game = LoadGame(game_name);
+  const std::vector<TabularPolicy> policies(2, GetUniformPolicy(*game));
+  std::unordered_map<std::string, int> states_to_indices;
+  if (!include_full_observations) {
+    states_to_indices = GetStatesToIndices(*game);
+  }
+  std::unique_ptr<State> initial_state = game->NewInitialState();
+  std::mt19937 rng(7);
+  const Philox batch_rng(rng());
+  BatchedTrajectory batched(kBatchSize);
+  for (int b = 0; b < kBatchSize; ++b) {
+    Philox trajectory_rng = batch_rng.Split(b);
+    BatchedTrajectory trajectory =
+        RecordTrajectory(*game, policies, *initial_state, states_to_indices,
+                         include_full_observations, &trajectory_rng);
+    batched.MoveTrajectory(b, &trajectory);
+  }
+  batched.ResizeFields();
+  rng.seed(7);
+  ColumnarTrajectory columnar = RecordColumnarTrajectory(
+      *game, policies, *initial_state, states_to_indices, kBatchSize,
+      include_full_observations, &rng);
+  rng.seed(7);
+  const ColumnarTrajectory threaded = RecordColumnarTrajectory(
+      *game, policies, *initial_state, states_to_indices, kBatchSize,
+      include_full_observations, &rng, /*max_unroll_length=*/-1,
+      /*num_threads=*/4);
+  SPIEL_CHECK_EQ(threaded.actions, columnar.actions);
+  SPIEL_CHECK_EQ(threaded.observations, columnar.observations);
+  SPIEL_CHECK_EQ(threaded.rewards, columnar.rewards);
+
+  const int length = batched.max_trajectory_length;
+  const int num_actions = game->NumDistinctActions();
+  SPIEL_CHECK_EQ(columnar.batch_size, kBatchSize);
+  SPIEL_CHECK_EQ(columnar.max_length, length);
+  SPIEL_CHECK_EQ(columnar.actions.size(), kBatchSize * length);
+  SPIEL_CHECK_EQ(columnar.legal_actions.size(),
+                 kBatchSize * length * num_actions);
+  SPIEL_CHECK_EQ(columnar.observations.size(),
+                 include_full_observations
+                     ? kBatchSize * length * game->InformationStateTensorSize()
+                     : 0);
+  for (int b = 0; b < kBatchSize; ++b) {
+    for (Player player = 0; player < game->NumPlayers(); ++player) {
+      SPIEL_CHECK_EQ(columnar.rewards[b * game->NumPlayers() + player],
+                     batched.rewards[b][player]);
+    }
+    for (int t = 0; t < length; ++t) {
+      const int step = b * length + t;
+      SPIEL_CHECK_EQ(columnar.actions[step], batched.actions[b][t]);
+      SPIEL_CHECK_EQ(columnar.player_ids[step], batched.player_ids[b][t]);
+      SPIEL_CHECK_EQ(columnar.valid[step], batched.valid[b][t]);
+      SPIEL_CHECK_EQ(columnar.next_is_terminal[step],
+                     batched.next_is_terminal[b][t]);
+      SPIEL_CHECK_EQ(columnar.state_indices[step], batched.state_indices[b][t]);
+      for (int a = 0; a < num_actions; ++a) {
+        SPIEL_CHECK_EQ(columnar.LegalActions(b, t)[a],
+                       batched.legal_actions[b][t][a]);
+        SPIEL_CHECK_FLOAT_EQ(columnar.PlayerPolicy(b, t)[a],
+                             batched.player_policies[b][t][a]);
+      }
+      for (int i = 0; i < columnar.observation_size; ++i) {
+        SPIEL_CHECK_FLOAT_EQ(columnar.Observation(b, t)[i],
+                             batched.observations[b][t][i]);
+      }
+    }
+  }
+
+  // Resizing in place keeps the steps and pads the new ones.
+  const std::vector<Action> actions = columnar.actions;
+  const std::vector<float> legal_actions = columnar.legal_actions;
+  columnar.Resize(length + 5);
+  for (int b = 0; b < kBatchSize; ++b) {
+    for (int t = 0; t < length + 5; ++t) {
+      const int step = b * (length + 5) + t;
+      if (t < length) {
+        SPIEL_CHECK_EQ(columnar.actions[step], actions[b * length + t]);
+      } else {
+        SPIEL_CHECK_EQ(columnar.actions[step], 0);
+        SPIEL_CHECK_EQ(columnar.valid[step], 0);
+        SPIEL_CHECK_EQ(columnar.LegalActions(b, t)[0], 1);
+      }
+    }
+  }
+  columnar.ShrinkToFit();
+  SPIEL_CHECK_EQ(columnar.max_length, length);
+  SPIEL_CHECK_EQ(columnar.actions, actions);
+  SPIEL_CHECK_EQ(columnar.legal_actions, legal_actions);
+}
+
+// Walking the compiled tree records the trajectories that the string-keyed
+// policies and state indices record from the same seed.
+void CompiledTrajectoryMatchesColumnar(const std::string& game_name,
+                                       bool include_full_observations) {
+  std::shared_ptr<const Game> game = LoadGame(game_name);
+  const std::vector<TabularPolicy> policies(2, GetUniformPolicy(*game));
+  std::unordered_map<std::string, int> states_to_indices;
+  if (!include_full_observations) {
+    states_to_indices = GetStatesToIndices(*game);
+  }
+  std::unique_ptr<State> initial_state = game->NewInitialState();
+  const TrajectoryTree tree(*game, *initial_state, states_to_indices,
+                            include_full_observations);
+  const IndexedTabularPolicy policy(tree, policies);
+  for (int num_threads : {1, 4}) {
+    std::mt19937 rng(7);
+    const ColumnarTrajectory expected = RecordColumnarTrajectory(
+        *game, policies, *initial_state, states_to_indices, kBatchSize,
+        include_full_observations, &rng);
+    rng.seed(7);
+    const ColumnarTrajectory compiled = RecordColumnarTrajectory(
+        tree, policy, kBatchSize, &rng, /*max_unroll_length=*/-1, num_threads);
+    SPIEL_CHECK_EQ(compiled.max_length, expected.max_length);
+    SPIEL_CHECK_EQ(compiled.observation_size, expected.observation_size);
+    SPIEL_CHECK_EQ(compiled.lengths, expected.lengths);
+    SPIEL_CHECK_EQ(compiled.observations, expected.observations);
+    SPIEL_CHECK_EQ(compiled.state_indices, expected.state_indices);
+    SPIEL_CHECK_EQ(compiled.legal_actions, expected.legal_actions);
+    SPIEL_CHECK_EQ(compiled.actions, expected.actions);
+    SPIEL_CHECK_EQ(compiled.player_policies, expected.player_policies);
+    SPIEL_CHECK_EQ(compiled.player_ids, expected.player_ids);
+    SPIEL_CHECK_EQ(compiled.rewards, expected.rewards);
+    SPIEL_CHECK_EQ(compiled.valid, expected.valid);
+    SPIEL_CHECK_EQ(compiled.next_is_terminal, expected.next_is_terminal);
+  }
+}
+
 }  // namespace
 }  // namespace algorithms
 }  // namespace open_spiel
@@ -276,5 +409,15 @@ int main() {
     alg::RecordBatchedTrajectoryPlayerIdsIsCorrect(game_name);
     alg::RecordBatchedTrajectoryNextIsTerminalIsCorrect(game_name);
     alg::BatchedTrajectoryResizesCorrectly(game_name);
+    alg::ColumnarTrajectoryMatchesBatched(game_name,
+                                          /*include_full_observations=*/true);
+    alg::ColumnarTrajectoryMatchesBatched(game_name,
+                                          /*include_full_observations=*/false);
+  }
+  for (const std::string& game_name : {"kuhn_poker", "leduc_poker"}) {
+    alg::CompiledTrajectoryMatchesColumnar(game_name,
+                                           /*include_full_observations=*/true);
+    alg::CompiledTrajectoryMatchesColumnar(game_name,
+                                           /*include_full_observations=*/false);
   }
 }
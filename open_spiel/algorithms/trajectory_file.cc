@@ -0,0 +1,314 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/trajectory_file.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/abseil-cpp/absl/strings/string_view.h"
+#include "open_spiel/abseil-cpp/absl/types/span.h"
+#include "open_spiel/algorithms/trajectories.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/file.h"
+#include "open_spiel/utils/varint.h"
+
+namespace open_spiel {
+namespace algorithms {
+namespace {
+
+constexpr char kMagic[8] = {'O', 'S', 'T', 'R', 'A', 'J', 'E', 'C'};
+constexpr uint64_t kVersion = 1;
+
+// Appends the non-zero entries of a vector: their number times 2, plus 1 if
+// they are all 1, then the gaps between their indices, then their values
+// unless they are all 1.
+void AppendSparse(absl::Span<const float> values, std::string* out) {
+  int nnz = 0;
+  bool all_ones = true;
+  for (float value : values) {
+    if (value == 0) continue;
+    ++nnz;
+    all_ones = all_ones && value == 1;
+  }
+  AppendVarint(2 * nnz + all_ones, out);
+  int previous = -1;
+  for (int i = 0; i < values.size(); ++i) {
+    if (values[i] == 0) continue;
+    AppendVarint(i - previous - 1, out);
+    previous = i;
+  }
+  if (all_ones) return;
+  for (float value : values) {
+    if (value != 0) AppendFloat(value, out);
+  }
+}
+
+// Reads the entries written by AppendSparse into values, which the caller
+// has set to 0. Returns false if the input is malformed.
+bool ReadSparse(VarintReader* reader, absl::Span<float> values) {
+  const uint64_t head = reader->Read();
+  if (head / 2 > values.size()) return false;
+  // The indices come first, so the entries are marked with 1 until their
+  // values are read.
+  int index = -1;
+  for (uint64_t i = 0; i < head / 2; ++i) {
+    const uint64_t gap = reader->Read();
+    if (gap >= values.size() - (index + 1)) return false;
+    index += gap + 1;
+    values[index] = 1;
+  }
+  if ((head & 1) == 0) {
+    for (float& value : values) {
+      if (value != 0) value = reader->ReadFloat();
+    }
+  }
+  return reader->ok();
+}
+
+// Appends a column section, prefixed by its size.
+void AppendSection(const std::string& column, std::string* out) {
+  AppendVarint(column.size(), out);
+  out->append(column);
+}
+
+}  // namespace
+
+TrajectoryFileWriter::TrajectoryFileWriter(const std::string& filename,
+                                           int observation_size,
+                                           int num_actions, int num_players)
+    : file_(filename, "wb"),
+      observation_size_(observation_size),
+      num_actions_(num_actions),
+      num_players_(num_players) {
+  SPIEL_CHECK_GE(observation_size, 0);
+  SPIEL_CHECK_GT(num_actions, 0);
+  SPIEL_CHECK_GT(num_players, 0);
+  std::string header(kMagic, sizeof(kMagic));
+  AppendVarint(kVersion, &header);
+  AppendVarint(observation_size, &header);
+  AppendVarint(num_actions, &header);
+  AppendVarint(num_players, &header);
+  SPIEL_CHECK_TRUE(file_.Write(header));
+}
+
+void TrajectoryFileWriter::Append(const ColumnarTrajectory& trajectories) {
+  SPIEL_CHECK_EQ(trajectories.observation_size, observation_size_);
+  SPIEL_CHECK_EQ(trajectories.num_actions, num_actions_);
+  SPIEL_CHECK_EQ(trajectories.num_players, num_players_);
+  const int batch_size = trajectories.batch_size;
+  const int max_length = trajectories.max_length;
+  const std::vector<int>& lengths = trajectories.lengths;
+  // Visits the steps taken, in order.
+  auto for_each_step = [&](auto&& f) {
+    for (int b = 0; b < batch_size; ++b) {
+      for (int t = 0; t < lengths[b]; ++t) f(b * max_length + t);
+    }
+  };
+
+  chunk_.clear();
+  AppendVarint(batch_size, &chunk_);
+  for (int length : lengths) {
+    SPIEL_CHECK_LE(length, max_length);
+    AppendVarint(length, &chunk_);
+  }
+  for (float reward : trajectories.rewards) AppendFloat(reward, &chunk_);
+
+  column_.clear();
+  for_each_step([&](int step) {
+    AppendVarint(trajectories.player_ids[step], &column_);
+  });
+  AppendSection(column_, &chunk_);
+
+  column_.clear();
+  for_each_step(
+      [&](int step) { AppendVarint(trajectories.actions[step], &column_); });
+  AppendSection(column_, &chunk_);
+
+  for (const std::vector<float>* values :
+       {&trajectories.legal_actions, &trajectories.player_policies}) {
+    column_.clear();
+    for_each_step([&](int step) {
+      AppendSparse(absl::MakeConstSpan(*values).subspan(step * num_actions_,
+                                                        num_actions_),
+                   &column_);
+    });
+    AppendSection(column_, &chunk_);
+  }
+
+  column_.clear();
+  if (observation_size_ > 0) {
+    for_each_step([&](int step) {
+      AppendSparse(absl::MakeConstSpan(trajectories.observations)
+                       .subspan(step * observation_size_, observation_size_),
+                   &column_);
+    });
+  } else {
+    for_each_step([&](int step) {
+      AppendVarint(trajectories.state_indices[step], &column_);
+    });
+  }
+  AppendSection(column_, &chunk_);
+
+  // The size comes first, so that a reader can skip from chunk to chunk.
+  std::string size;
+  AppendVarint(chunk_.size(), &size);
+  SPIEL_CHECK_TRUE(file_.Write(size));
+  SPIEL_CHECK_TRUE(file_.Write(chunk_));
+  ++num_chunks_;
+  num_trajectories_ += batch_size;
+}
+
+void TrajectoryFileWriter::Flush() { SPIEL_CHECK_TRUE(file_.Flush()); }
+
+TrajectoryFileReader::TrajectoryFileReader(const std::string& filename)
+    : file_(filename, {file::MMapFile::Access::kSequential}) {
+  const absl::string_view contents = file_.Contents();
+  if (contents.size() < sizeof(kMagic) ||
+      std::memcmp(contents.data(), kMagic, sizeof(kMagic)) != 0) {
+    SpielFatalError(absl::StrCat(filename, " is not a trajectory file"));
+  }
+  VarintReader reader(contents.substr(sizeof(kMagic)));
+  const uint64_t version = reader.Read();
+  if (version != kVersion) {
+    SpielFatalError(absl::StrCat("Unsupported version ", version,
+                                 " of the trajectory file ", filename));
+  }
+  observation_size_ = reader.Read();
+  num_actions_ = reader.Read();
+  num_players_ = reader.Read();
+  if (!reader.ok()) {
+    SpielFatalError(absl::StrCat("Truncated header in ", filename));
+  }
+
+  // Only the sizes and batch sizes are read here, to find the chunks.
+  while (!reader.empty()) {
+    const uint64_t size = reader.Read();
+    if (!reader.ok() || size > reader.remaining().size()) break;
+    const absl::string_view chunk = reader.ReadBytes(size);
+    num_trajectories_ += VarintReader(chunk).Read();
+    chunks_.push_back(chunk);
+  }
+}
+
+ColumnarTrajectory TrajectoryFileReader::ReadChunk(int64_t chunk) const {
+  SPIEL_CHECK_GE(chunk, 0);
+  SPIEL_CHECK_LT(chunk, chunks_.size());
+  auto corrupt = [&]() {
+    SpielFatalError(absl::StrCat("Chunk ", chunk, " of the trajectory file is "
+                                 "corrupt."));
+  };
+  VarintReader reader(chunks_[chunk]);
+  const int batch_size = reader.ReadSize();
+  std::vector<int> lengths(batch_size);
+  for (int& length : lengths) length = reader.ReadSize();
+  if (!reader.ok() || batch_size == 0) corrupt();
+  const int max_length = *std::max_element(lengths.begin(), lengths.end());
+
+  ColumnarTrajectory trajectories(batch_size, max_length, observation_size_,
+                                  num_actions_, num_players_);
+  trajectories.lengths = lengths;
+  for (float& reward : trajectories.rewards) reward = reader.ReadFloat();
+  // Visits the steps taken, in order, while the section can be read.
+  auto for_each_step = [&](VarintReader* section, auto&& f) {
+    for (int b = 0; b < batch_size; ++b) {
+      for (int t = 0; t < lengths[b] && section->ok(); ++t) {
+        f(b * max_length + t);
+      }
+    }
+    if (!section->ok() || !section->empty()) corrupt();
+  };
+  // The next section, whose size prefixes it.
+  auto next_section = [&]() {
+    VarintReader section(reader.ReadBytes(reader.Read()));
+    if (!reader.ok()) corrupt();
+    return section;
+  };
+
+  for (int b = 0; b < batch_size; ++b) {
+    for (int t = 0; t < lengths[b]; ++t) {
+      trajectories.valid[b * max_length + t] = 1;
+    }
+    if (lengths[b] > 0) {
+      trajectories.next_is_terminal[b * max_length + lengths[b] - 1] = 1;
+    }
+  }
+
+  VarintReader player_ids = next_section();
+  for_each_step(&player_ids, [&](int step) {
+    trajectories.player_ids[step] = player_ids.Read();
+  });
+
+  VarintReader actions = next_section();
+  for_each_step(&actions, [&](int step) {
+    trajectories.actions[step] = actions.Read();
+  });
+
+  for (std::vector<float>* values :
+       {&trajectories.legal_actions, &trajectories.player_policies}) {
+    VarintReader section = next_section();
+    for_each_step(&section, [&](int step) {
+      absl::Span<float> entries =
+          absl::MakeSpan(*values).subspan(step * num_actions_, num_actions_);
+      std::fill(entries.begin(), entries.end(), 0);
+      if (!ReadSparse(&section, entries)) corrupt();
+    });
+  }
+
+  VarintReader observations = next_section();
+  if (observation_size_ > 0) {
+    // The padding of the observations is already 0.
+    for_each_step(&observations, [&](int step) {
+      if (!ReadSparse(&observations,
+                      absl::MakeSpan(trajectories.observations)
+                          .subspan(step * observation_size_,
+                                   observation_size_))) {
+        corrupt();
+      }
+    });
+  } else {
+    for_each_step(&observations, [&](int step) {
+      trajectories.state_indices[step] = observations.Read();
+    });
+  }
+  if (!reader.empty()) corrupt();
+  return trajectories;
+}
+
+void RecordTrajectoriesToFile(
+    const Game& game, const std::vector<TabularPolicy>& policies,
+    const State& initial_state,
+    const std::unordered_map<std::string, int>& state_to_index,
+    int64_t num_trajectories, int chunk_size, bool include_full_observations,
+    std::mt19937* rng_ptr, TrajectoryFileWriter* writer, int num_threads) {
+  SPIEL_CHECK_GE(num_trajectories, 0);
+  SPIEL_CHECK_GT(chunk_size, 0);
+  for (int64_t recorded = 0; recorded < num_trajectories;
+       recorded += chunk_size) {
+    writer->Append(RecordColumnarTrajectory(
+        game, policies, initial_state, state_to_index,
+        std::min<int64_t>(chunk_size, num_trajectories - recorded),
+        include_full_observations, rng_ptr, /*max_unroll_length=*/-1,
+        num_threads));
+  }
+}
+
+}  // namespace algorithms
+}  // namespace open_spiel
@@ -0,0 +1,119 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_ALGORITHMS_TRAJECTORY_FILE_H_
+#define OPEN_SPIEL_ALGORITHMS_TRAJECTORY_FILE_H_
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/strings/string_view.h"
+#include "open_spiel/algorithms/trajectories.h"
+#include "open_spiel/policy.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/utils/file.h"
+
+// Files of trajectories, for offline datasets too large to be held in memory.
+// The trajectories are appended in chunks, each a ColumnarTrajectory, as they
+// are recorded, and read back a chunk at a time from the file mapped into
+// memory.
+//
+// The file starts with a header giving the schema: the observation size (0
+// when state indices are recorded), the number of actions and the number of
+// players. Each chunk follows as its size and its trajectories' lengths and
+// rewards, then a section per column: the player ids, the actions, the legal
+// actions, the policies, and the observations or state indices. Only the
+// steps taken are stored, not the padding, with the integers as varints and
+// the legal actions, policies and observations as their non-zero entries,
+// whose indices are delta-encoded and whose values are left out when they are
+// all 1, as for one-hot observations and legal action masks.
+namespace open_spiel {
+namespace algorithms {
+
+// Appends chunks of trajectories to a new file.
+class TrajectoryFileWriter {
+ public:
+  // observation_size is 0 if the state indices are recorded instead.
+  TrajectoryFileWriter(const std::string& filename, int observation_size,
+                       int num_actions, int num_players);
+
+  // Appends the trajectories as one chunk, which must have the schema of the
+  // file. Only the chunk's encoding is held in memory, as it is written.
+  void Append(const ColumnarTrajectory& trajectories);
+
+  int64_t NumChunks() const { return num_chunks_; }
+  int64_t NumTrajectories() const { return num_trajectories_; }
+
+  // Flushes the chunks written so far to disk, e.g. for the file to be read
+  // while more are being appended.
+  void Flush();
+
+ private:
+  file::File file_;
+  const int observation_size_;
+  const int num_actions_;
+  const int num_players_;
+  int64_t num_chunks_ = 0;
+  int64_t num_trajectories_ = 0;
+  // The encoding buffers, reused from chunk to chunk.
+  std::string chunk_;
+  std::string column_;
+};
+
+// Reads a file of trajectories mapped into memory. A chunk cut short at the
+// end of the file, e.g. by a writer which is still running, is left out.
+// Chunks may be read concurrently.
+class TrajectoryFileReader {
+ public:
+  explicit TrajectoryFileReader(const std::string& filename);
+
+  int ObservationSize() const { return observation_size_; }
+  int NumActions() const { return num_actions_; }
+  int NumPlayers() const { return num_players_; }
+  int64_t NumChunks() const { return chunks_.size(); }
+  int64_t NumTrajectories() const { return num_trajectories_; }
+
+  // Decodes a chunk, whose max_length is that of its longest trajectory.
+  ColumnarTrajectory ReadChunk(int64_t chunk) const;
+
+ private:
+  file::MMapFile file_;
+  int observation_size_;
+  int num_actions_;
+  int num_players_;
+  int64_t num_trajectories_ = 0;
+  // The bytes of each chunk within the file.
+  std::vector<absl::string_view> chunks_;
+};
+
+// Records num_trajectories trajectories with RecordColumnarTrajectory,
+// chunk_size at a time, appending each chunk to the writer as it is recorded,
+// so that the memory used is bounded by a chunk whatever the size of the
+// dataset. Each chunk is seeded from rng_ptr, as by RecordColumnarTrajectory,
+// and is as long as its longest trajectory.
+void RecordTrajectoriesToFile(
+    const Game& game, const std::vector<TabularPolicy>& policies,
+    const State& initial_state,
+    const std::unordered_map<std::string, int>& state_to_index,
+    int64_t num_trajectories, int chunk_size, bool include_full_observations,
+    std::mt19937* rng_ptr, TrajectoryFileWriter* writer,
+    int num_threads = 1);
+
+}  // namespace algorithms
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_ALGORITHMS_TRAJECTORY_FILE_H_
@@ -0,0 +1,146 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/trajectory_file.h"
+
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/algorithms/trajectories.h"
+#include "open_spiel/policy.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/file.h"
+
+namespace open_spiel {
+namespace algorithms {
+namespace {
+
+std::string TrajectoryFilename(const std::string& name) {
+  return absl::StrCat(file::GetTmpDir(), "/open_spiel-test-",
+                      std::rand(), "-", name);  // NOLINT
+}
+
+std::unordered_map<std::string, int> GetStatesToIndices(const Game& game) {
+  std::unordered_map<std::string, int> state_index;
+  std::vector<std::unique_ptr<State>> to_visit;
+  to_visit.push_back(game.NewInitialState());
+  int index = 0;
+  while (!to_visit.empty()) {
+    std::unique_ptr<State> state = std::move(to_visit.back());
+    to_visit.pop_back();
+    if (!state->IsChanceNode() && !state->IsTerminal()) {
+      state_index[state->InformationStateString()] = index;
+    }
+    ++index;
+    for (Action action : state->LegalActions()) {
+      to_visit.push_back(state->Child(action));
+    }
+  }
+  return state_index;
+}
+
+void CheckSameTrajectories(const ColumnarTrajectory& trajectories,
+                           const ColumnarTrajectory& expected) {
+  SPIEL_CHECK_EQ(trajectories.batch_size, expected.batch_size);
+  SPIEL_CHECK_EQ(trajectories.max_length, expected.max_length);
+  SPIEL_CHECK_EQ(trajectories.observation_size, expected.observation_size);
+  SPIEL_CHECK_EQ(trajectories.num_actions, expected.num_actions);
+  SPIEL_CHECK_EQ(trajectories.num_players, expected.num_players);
+  SPIEL_CHECK_EQ(trajectories.lengths, expected.lengths);
+  SPIEL_CHECK_EQ(trajectories.observations, expected.observations);
+  SPIEL_CHECK_EQ(trajectories.state_indices, expected.state_indices);
+  SPIEL_CHECK_EQ(trajectories.legal_actions, expected.legal_actions);
+  SPIEL_CHECK_EQ(trajectories.actions, expected.actions);
+  SPIEL_CHECK_EQ(trajectories.player_policies, expected.player_policies);
+  SPIEL_CHECK_EQ(trajectories.player_ids, expected.player_ids);
+  SPIEL_CHECK_EQ(trajectories.rewards, expected.rewards);
+  SPIEL_CHECK_EQ(trajectories.valid, expected.valid);
+  SPIEL_CHECK_EQ(trajectories.next_is_terminal, expected.next_is_terminal);
+}
+
+// The chunks read back are those recorded in memory from the same seed.
+void TrajectoryFileRoundTrips(const std::string& game_name,
+                              bool include_full_observations) {
+  std::shared_ptr<const Game> game = LoadGame(game_name);
+  std::unordered_map<std::string, int> states_to_indices;
+  if (!include_full_observations) {
+    states_to_indices = GetStatesToIndices(*game);
+  }
+  std::vector<TabularPolicy> policies(2, GetUniformPolicy(*game));
+  std::unique_ptr<State> initial_state = game->NewInitialState();
+  const int observation_size =
+      include_full_observations ? game->InformationStateTensorSize() : 0;
+  const std::string filename = TrajectoryFilename(game_name + ".trajectories");
+
+  constexpr int kNumTrajectories = 100;
+  constexpr int kChunkSize = 32;
+  std::mt19937 rng(7);
+  {
+    TrajectoryFileWriter writer(filename, observation_size,
+                                game->NumDistinctActions(),
+                                game->NumPlayers());
+    RecordTrajectoriesToFile(*game, policies, *initial_state,
+                             states_to_indices, kNumTrajectories, kChunkSize,
+                             include_full_observations, &rng, &writer,
+                             /*num_threads=*/2);
+    SPIEL_CHECK_EQ(writer.NumChunks(), 4);
+    SPIEL_CHECK_EQ(writer.NumTrajectories(), kNumTrajectories);
+  }
+
+  {  // The reader unmaps the file before it is truncated below.
+    const TrajectoryFileReader reader(filename);
+    SPIEL_CHECK_EQ(reader.ObservationSize(), observation_size);
+    SPIEL_CHECK_EQ(reader.NumActions(), game->NumDistinctActions());
+    SPIEL_CHECK_EQ(reader.NumPlayers(), game->NumPlayers());
+    SPIEL_CHECK_EQ(reader.NumChunks(), 4);
+    SPIEL_CHECK_EQ(reader.NumTrajectories(), kNumTrajectories);
+    std::mt19937 expected_rng(7);
+    for (int chunk = 0; chunk < reader.NumChunks(); ++chunk) {
+      const int batch_size =
+          chunk < 3 ? kChunkSize : kNumTrajectories % kChunkSize;
+      CheckSameTrajectories(
+          reader.ReadChunk(chunk),
+          RecordColumnarTrajectory(*game, policies, *initial_state,
+                                   states_to_indices, batch_size,
+                                   include_full_observations, &expected_rng));
+    }
+  }
+
+  // A chunk cut short, as by a writer still running, is left out.
+  const std::string contents = file::File(filename, "rb").ReadContents();
+  file::File(filename, "wb").Write(contents.substr(0, contents.size() - 1));
+  const TrajectoryFileReader truncated(filename);
+  SPIEL_CHECK_EQ(truncated.NumChunks(), 3);
+  SPIEL_CHECK_EQ(truncated.NumTrajectories(), 3 * kChunkSize);
+  SPIEL_CHECK_TRUE(file::Remove(filename));
+}
+
+}  // namespace
+}  // namespace algorithms
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  for (const char* game : {"kuhn_poker", "leduc_poker"}) {
+    for (bool include_full_observations : {false, true}) {
+      open_spiel::algorithms::TrajectoryFileRoundTrips(
+          game, include_full_observations);
+    }
+  }
+}
@@ -0,0 +1,291 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/transposition_mcts.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/abseil-cpp/absl/strings/str_format.h"
+#include "open_spiel/abseil-cpp/absl/time/clock.h"
+#include "open_spiel/abseil-cpp/absl/time/time.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace algorithms {
+namespace {
+
+// Keeps terminal states apart from the non-terminal states with the same hash.
+constexpr uint64_t kTerminalKey = 0x9b05688c2b3e6c1fULL;
+
+// Rough size of a table entry, including the hash table slot and the node
+// allocation, but not the edges.
+int64_t NodeBytes(int num_players) {
+  return sizeof(std::pair<const uint64_t, TranspositionNode>) +
+         2 * sizeof(void*) + num_players * sizeof(double);
+}
+
+}  // namespace
+
+double TranspositionNode::Value(Player reward_player) const {
+  return explore_count ? total_rewards[reward_player] / explore_count : 0;
+}
+
+std::vector<double> TranspositionNode::Values() const {
+  std::vector<double> values(total_rewards.size());
+  for (int p = 0; p < values.size(); ++p) values[p] = Value(p);
+  return values;
+}
+
+const TranspositionEdge& TranspositionNode::BestEdge() const {
+  SPIEL_CHECK_FALSE(edges.empty());
+  auto edge_value = [this](const TranspositionEdge& edge) {
+    return edge.child == nullptr || player < 0 ? 0
+                                               : edge.child->Value(player);
+  };
+  return *std::max_element(
+      edges.begin(), edges.end(),
+      [&edge_value](const TranspositionEdge& a, const TranspositionEdge& b) {
+        if (a.explore_count != b.explore_count) {
+          return a.explore_count < b.explore_count;
+        }
+        return edge_value(a) < edge_value(b);
+      });
+}
+
+std::string TranspositionNode::EdgesStr(const State& state) const {
+  std::vector<const TranspositionEdge*> refs;
+  refs.reserve(edges.size());
+  for (const TranspositionEdge& edge : edges) refs.push_back(&edge);
+  std::sort(refs.begin(), refs.end(),
+            [](const TranspositionEdge* a, const TranspositionEdge* b) {
+              return a->explore_count > b->explore_count;
+            });
+  std::string out;
+  for (const TranspositionEdge* edge : refs) {
+    const TranspositionNode* child = edge->child;
+    absl::StrAppend(
+        &out,
+        absl::StrFormat(
+            "%6s: prior: %5.3f, value: %6.3f, sims: %5d, child sims: %5d\n",
+            state.ActionToString(player, edge->action), edge->prior,
+            (child != nullptr && player >= 0 ? child->Value(player) : 0.),
+            edge->explore_count,
+            (child != nullptr ? child->explore_count : 0)));
+  }
+  return out;
+}
+
+TranspositionMCTSBot::TranspositionMCTSBot(
+    const Game& game, std::shared_ptr<Evaluator> evaluator, double uct_c,
+    int max_simulations, int64_t max_memory_mb, int seed, bool verbose,
+    ChildSelectionPolicy child_selection_policy)
+    : uct_c_{uct_c},
+      max_simulations_{max_simulations},
+      max_memory_bytes_(max_memory_mb << 20),
+      verbose_(verbose),
+      num_players_(game.NumPlayers()),
+      rng_(seed),
+      child_selection_policy_(child_selection_policy),
+      evaluator_(evaluator) {
+  GameType game_type = game.GetType();
+  if (game_type.reward_model != GameType::RewardModel::kTerminal)
+    SpielFatalError("Game must have terminal rewards.");
+  if (game_type.dynamics != GameType::Dynamics::kSequential)
+    SpielFatalError("Game must have sequential turns.");
+}
+
+TranspositionNode* TranspositionMCTSBot::FindOrInsert(const State& state) {
+  const uint64_t key =
+      state.IsTerminal() ? state.HashValue() ^ kTerminalKey : state.HashValue();
+  auto it = table_.find(key);
+  if (it != table_.end()) return &it->second;
+  const int64_t node_bytes = NodeBytes(num_players_);
+  if (!table_.empty() &&
+      memory_used_bytes_ + node_bytes > max_memory_bytes_) {
+    return nullptr;
+  }
+  memory_used_bytes_ += node_bytes;
+  return &table_
+              .try_emplace(key, state.IsTerminal() ? kTerminalPlayerId
+                                                   : state.CurrentPlayer(),
+                           num_players_)
+              .first->second;
+}
+
+bool TranspositionMCTSBot::ExpandNode(TranspositionNode* node,
+                                      const State& state) {
+  ActionsAndProbs legal_actions = evaluator_->Prior(state);
+  const int64_t edges_bytes = legal_actions.size() * sizeof(TranspositionEdge);
+  if (memory_used_bytes_ + edges_bytes > max_memory_bytes_) return false;
+  memory_used_bytes_ += edges_bytes;
+
+  // Reduce bias from move generation order.
+  std::shuffle(legal_actions.begin(), legal_actions.end(), rng_);
+  node->edges.reserve(legal_actions.size());
+  for (auto [action, prior] : legal_actions) {
+    node->edges.emplace_back(action, prior);
+  }
+  return true;
+}
+
+TranspositionEdge* TranspositionMCTSBot::SelectEdge(TranspositionNode* node,
+                                                    const State& state) {
+  if (state.IsChanceNode()) {
+    Action chosen_action = state.SampleChanceOutcome(rng_).first;
+    for (TranspositionEdge& edge : node->edges) {
+      if (edge.action == chosen_action) return &edge;
+    }
+    SpielFatalError(absl::StrCat("Chance outcome ", chosen_action,
+                                 " is not an edge of the node."));
+  }
+
+  // The values come from the positions, so they include the simulations that
+  // reached them through other paths, while the edges count how often each
+  // action was tried from here.
+  TranspositionEdge* chosen_edge = nullptr;
+  double max_value = -std::numeric_limits<double>::infinity();
+  for (TranspositionEdge& edge : node->edges) {
+    const TranspositionNode* child = edge.child;
+    const double child_value =
+        child != nullptr ? child->Value(node->player) : 0;
+    double val;
+    switch (child_selection_policy_) {
+      case ChildSelectionPolicy::UCT:
+        val = edge.explore_count == 0
+                  ? std::numeric_limits<double>::infinity()
+                  : child_value + uct_c_ * std::sqrt(
+                                               std::log(node->explore_count) /
+                                               edge.explore_count);
+        break;
+      case ChildSelectionPolicy::PUCT:
+        val = child_value + uct_c_ * edge.prior *
+                                std::sqrt(node->explore_count) /
+                                (edge.explore_count + 1);
+        break;
+    }
+    if (val > max_value) {
+      max_value = val;
+      chosen_edge = &edge;
+    }
+  }
+  return chosen_edge;
+}
+
+void TranspositionMCTSBot::RunSimulation(TranspositionNode* root,
+                                         const State& state) {
+  visit_path_.clear();
+  edge_path_.clear();
+  visit_path_.push_back(root);
+  CopyOrCloneState(state, &working_state_);
+  State* working_state = working_state_.get();
+  TranspositionNode* node = root;
+  std::vector<double> returns;
+  bool back_up_leaf = true;
+  while (true) {
+    if (working_state->IsTerminal()) {
+      returns = working_state->Returns();
+      break;
+    }
+    // New positions, and those not stored, are evaluated.
+    if (node == nullptr || node->explore_count == 0 ||
+        (node->edges.empty() && !ExpandNode(node, *working_state))) {
+      returns = evaluator_->Evaluate(*working_state);
+      break;
+    }
+
+    TranspositionEdge* edge = SelectEdge(node, *working_state);
+    working_state->ApplyAction(edge->action);
+    edge_path_.push_back(edge);
+    // The same action can lead to a terminal state or not depending on the
+    // history (e.g. repetitions), so the child is looked up again then.
+    const Player next_player = working_state->IsTerminal()
+                                   ? kTerminalPlayerId
+                                   : working_state->CurrentPlayer();
+    if (edge->child == nullptr || edge->child->player != next_player) {
+      edge->child = FindOrInsert(*working_state);
+    }
+    TranspositionNode* child = edge->child;
+    visit_path_.push_back(child);
+
+    // The position was reached more often through other paths than through
+    // this edge: back up its value rather than searching it again.
+    if (child != nullptr && child->explore_count > edge->explore_count) {
+      returns = child->Values();
+      back_up_leaf = false;
+      break;
+    }
+    node = child;
+  }
+
+  // A position can appear more than once in the path, in which case it is
+  // updated once per visit.
+  const int num_updated = visit_path_.size() - (back_up_leaf ? 0 : 1);
+  for (int i = 0; i < num_updated; ++i) {
+    TranspositionNode* visited = visit_path_[i];
+    if (visited == nullptr) continue;
+    visited->explore_count += 1;
+    for (Player p = 0; p < num_players_; ++p) {
+      visited->total_rewards[p] += returns[p];
+    }
+  }
+  for (TranspositionEdge* edge : edge_path_) edge->explore_count += 1;
+}
+
+const TranspositionNode& TranspositionMCTSBot::MCGSearch(const State& state) {
+  SPIEL_CHECK_FALSE(state.IsTerminal());
+  table_.clear();
+  memory_used_bytes_ = 0;
+  TranspositionNode* root = FindOrInsert(state);
+  for (int i = 0; i < max_simulations_; ++i) {
+    RunSimulation(root, state);
+    if (root->edges.size() == 1) break;  // Only one choice.
+  }
+  return *root;
+}
+
+Action TranspositionMCTSBot::Step(const State& state) {
+  absl::Time start = absl::Now();
+  const TranspositionNode& root = MCGSearch(state);
+  const TranspositionEdge& best = root.BestEdge();
+
+  if (verbose_) {
+    double seconds = absl::ToDoubleSeconds(absl::Now() - start);
+    std::cerr << absl::StrFormat(
+                     ("Finished %d sims in %.3f secs, %.1f sims/s, "
+                      "graph size: %d nodes / %d mb."),
+                     root.explore_count, seconds, root.explore_count / seconds,
+                     NumNodes(), memory_used_bytes_ >> 20)
+              << std::endl;
+    std::cerr << "Edges:" << std::endl;
+    std::cerr << root.EdgesStr(state) << std::endl;
+  }
+
+  return best.action;
+}
+
+std::pair<ActionsAndProbs, Action> TranspositionMCTSBot::StepWithPolicy(
+    const State& state) {
+  Action action = Step(state);
+  return {{{action, 1.}}, action};
+}
+
+}  // namespace algorithms
+}  // namespace open_spiel
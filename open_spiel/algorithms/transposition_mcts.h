@@ -0,0 +1,173 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_ALGORITHMS_TRANSPOSITION_MCTS_H_
+#define OPEN_SPIEL_ALGORITHMS_TRANSPOSITION_MCTS_H_
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/container/node_hash_map.h"
+#include "open_spiel/algorithms/mcts.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_bots.h"
+
+// A Monte Carlo Tree Search that shares the statistics of identical positions
+// reached by different move orders, so that the search tree becomes a directed
+// acyclic graph (Monte Carlo Graph Search).
+//
+// Positions are identified by State::HashValue() and stored in a transposition
+// table bounded by max_memory_mb. Each position holds the visit count and total
+// rewards of every simulation that went through it, whatever the path, while
+// each edge (position, action) holds the number of simulations that chose the
+// action from that position. Children are selected as in MCTSBot, with the
+// value of an edge being the value of the position it leads to and the
+// exploration term using the edge count.
+//
+// When a simulation reaches a position that has already been visited more
+// often than the edge leading to it (i.e. through another path), the value of
+// that position is backed up along the path instead of running a new
+// simulation below it. In a game without transpositions this is the same as
+// MCTSBot.
+//
+// Positions with the same hash must have the same legal actions. Whether a
+// state is terminal, and its returns, are always taken from the state itself,
+// so games where it depends on the history (e.g. repetitions in chess) are
+// still handled, terminal states being stored apart from non-terminal ones.
+// Hash collisions between different positions are not detected.
+//
+// When the table is full, new positions are evaluated but not stored, and the
+// search carries on in the graph built so far. The table is rebuilt for every
+// search. This implementation supports sequential n-player games, with or
+// without chance nodes, but neither MCTS-Solver nor threads.
+//
+// Some references:
+// - Childs, Brodeur, and Kocsis, Transpositions and Move Groups in Monte Carlo
+//   Tree Search, 2008.
+// - Saffidine, Cazenave, and Mehat, UCD: Upper Confidence bound for rooted
+//   Directed acyclic graphs, 2012.
+// - Czech, Korus, and Kersting, Monte-Carlo Graph Search for AlphaZero, 2020,
+//   https://arxiv.org/abs/2012.11045
+
+namespace open_spiel {
+namespace algorithms {
+
+struct TranspositionNode;
+
+// An action from a position, and the number of simulations that chose it from
+// there.
+struct TranspositionEdge {
+  TranspositionEdge(Action action_, double prior_)
+      : action(action_), prior(prior_) {}
+
+  Action action;
+  double prior;
+  int explore_count = 0;
+  // The position this action leads to, set when first explored. It stays null
+  // if the table was full.
+  TranspositionNode* child = nullptr;
+};
+
+// A position in the graph, and the statistics of all the simulations that went
+// through it.
+struct TranspositionNode {
+  TranspositionNode(Player player_, int num_players)
+      : player(player_), total_rewards(num_players, 0) {}
+
+  // The average reward of the simulations through this node for the player.
+  double Value(Player reward_player) const;
+
+  // The average rewards of the simulations through this node.
+  std::vector<double> Values() const;
+
+  // The edge explored most often, ties broken by the value of its child.
+  const TranspositionEdge& BestEdge() const;
+
+  // Describes the edges, from most to least explored.
+  std::string EdgesStr(const State& state) const;
+
+  Player player;  // The player to move, or kTerminalPlayerId.
+  int explore_count = 0;
+  std::vector<double> total_rewards;  // One per player.
+  std::vector<TranspositionEdge> edges;  // Empty until expanded.
+};
+
+class TranspositionMCTSBot : public Bot {
+ public:
+  // As MCTSBot, see mcts.h. The evaluator is not called concurrently.
+  TranspositionMCTSBot(
+      const Game& game, std::shared_ptr<Evaluator> evaluator, double uct_c,
+      int max_simulations,
+      int64_t max_memory_mb,  // Max memory use in megabytes.
+      int seed, bool verbose,
+      ChildSelectionPolicy child_selection_policy = ChildSelectionPolicy::UCT);
+
+  void Restart() override { table_.clear(); }
+  void RestartAt(const State& state) override { Restart(); }
+  // Run a search for one step, choosing the action, and printing some
+  // information.
+  Action Step(const State& state) override;
+
+  // Equivalent to calling Step, with 100% probability assigned to the action.
+  std::pair<ActionsAndProbs, Action> StepWithPolicy(
+      const State& state) override;
+
+  // Searches from the given state, and returns the node of the state. The
+  // graph remains valid until the next search or restart.
+  const TranspositionNode& MCGSearch(const State& state);
+
+  // The number of positions in the graph of the last search.
+  int NumNodes() const { return table_.size(); }
+
+ private:
+  // Returns the node of the state, inserting it if needed, or null if the
+  // table is full.
+  TranspositionNode* FindOrInsert(const State& state);
+
+  // Adds the edges of a node. Returns false if the table is full.
+  bool ExpandNode(TranspositionNode* node, const State& state);
+
+  // Chooses the edge to follow from a node, which must be expanded.
+  TranspositionEdge* SelectEdge(TranspositionNode* node, const State& state);
+
+  void RunSimulation(TranspositionNode* root, const State& state);
+
+  double uct_c_;
+  int max_simulations_;
+  int64_t max_memory_bytes_;
+  int64_t memory_used_bytes_ = 0;  // Approximate.
+  bool verbose_;
+  int num_players_;
+  std::mt19937 rng_;
+  const ChildSelectionPolicy child_selection_policy_;
+  std::shared_ptr<Evaluator> evaluator_;
+
+  // Keyed by State::HashValue(), salted for terminal states. The nodes need
+  // stable addresses since the edges point to them.
+  absl::node_hash_map<uint64_t, TranspositionNode> table_;
+
+  // Scratch space reused across simulations.
+  std::unique_ptr<State> working_state_;
+  std::vector<TranspositionNode*> visit_path_;
+  std::vector<TranspositionEdge*> edge_path_;
+};
+
+}  // namespace algorithms
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_ALGORITHMS_TRANSPOSITION_MCTS_H_
@@ -0,0 +1,125 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/transposition_mcts.h"
+
+#include <memory>
+#include <utility>
+
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/abseil-cpp/absl/strings/string_view.h"
+#include "open_spiel/algorithms/evaluate_bots.h"
+#include "open_spiel/algorithms/mcts.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace {
+
+constexpr double UCT_C = 2;
+
+std::unique_ptr<algorithms::TranspositionMCTSBot> InitBot(
+    const Game& game, int max_simulations, int max_memory_mb,
+    algorithms::ChildSelectionPolicy policy =
+        algorithms::ChildSelectionPolicy::UCT) {
+  auto evaluator =
+      std::make_shared<algorithms::RandomRolloutEvaluator>(20, 42);
+  return std::make_unique<algorithms::TranspositionMCTSBot>(
+      game, std::move(evaluator), UCT_C, max_simulations, max_memory_mb,
+      /*seed=*/42, /*verbose=*/false, policy);
+}
+
+Action GetAction(const State& state, const absl::string_view action_str) {
+  for (Action action : state.LegalActions()) {
+    if (action_str == state.ActionToString(state.CurrentPlayer(), action))
+      return action;
+  }
+  SpielFatalError(absl::StrCat("Illegal action: ", action_str));
+}
+
+void TranspositionMCTSTest_CanPlayTicTacToe() {
+  auto game = LoadGame("tic_tac_toe");
+  auto bot0 = InitBot(*game, 1000, 5);
+  auto bot1 = InitBot(*game, 1000, 5);
+  auto results =
+      EvaluateBots(game->NewInitialState().get(), {bot0.get(), bot1.get()}, 42);
+  SPIEL_CHECK_EQ(results[0] + results[1], 0);
+}
+
+void TranspositionMCTSTest_CanPlayThreePlayerStochasticGames() {
+  auto game = LoadGame("pig(players=3,winscore=20,horizon=30)");
+  auto bot0 = InitBot(*game, 1000, 5);
+  auto bot1 = InitBot(*game, 1000, 5);
+  auto bot2 = InitBot(*game, 1000, 5);
+  auto results = EvaluateBots(game->NewInitialState().get(),
+                              {bot0.get(), bot1.get(), bot2.get()}, 42);
+  SPIEL_CHECK_FLOAT_EQ(results[0] + results[1] + results[2], 0);
+}
+
+void TranspositionMCTSTest_FindsWin() {
+  auto game = LoadGame("tic_tac_toe");
+  std::unique_ptr<State> state = game->NewInitialState();
+  for (const auto& action_str : {"x(0,1)", "o(2,2)"}) {
+    state->ApplyAction(GetAction(*state, action_str));
+  }
+  SPIEL_CHECK_EQ(state->ToString(), ".x.\n...\n..o");
+  for (auto policy : {algorithms::ChildSelectionPolicy::UCT,
+                      algorithms::ChildSelectionPolicy::PUCT}) {
+    auto bot = InitBot(*game, 10000, 10, policy);
+    const algorithms::TranspositionNode& root = bot->MCGSearch(*state);
+    SPIEL_CHECK_EQ(root.explore_count, 10000);
+    const algorithms::TranspositionEdge& best = root.BestEdge();
+    SPIEL_CHECK_EQ(state->ActionToString(root.player, best.action), "x(0,2)");
+    SPIEL_CHECK_GT(best.child->Value(root.player), 0.5);
+  }
+}
+
+void TranspositionMCTSTest_SharesTranspositions() {
+  // Tic-tac-toe has 5478 distinct states, far fewer than its paths.
+  auto game = LoadGame("tic_tac_toe");
+  std::unique_ptr<State> state = game->NewInitialState();
+  auto bot = InitBot(*game, 50000, 10);
+  const algorithms::TranspositionNode& root = bot->MCGSearch(*state);
+  SPIEL_CHECK_EQ(root.explore_count, 50000);
+  SPIEL_CHECK_LE(bot->NumNodes(), 5478);
+  int edges_explore_count = 0;
+  for (const algorithms::TranspositionEdge& edge : root.edges) {
+    edges_explore_count += edge.explore_count;
+    // A child is only reached from the root, so it is counted by its edge.
+    SPIEL_CHECK_EQ(edge.child->explore_count, edge.explore_count);
+  }
+  // The first simulation evaluates the root itself.
+  SPIEL_CHECK_EQ(edges_explore_count, 50000 - 1);
+}
+
+void TranspositionMCTSTest_MemoryLimit() {
+  auto game = LoadGame("connect_four");
+  std::unique_ptr<State> state = game->NewInitialState();
+  auto bot = InitBot(*game, 20000, 1);
+  const algorithms::TranspositionNode& root = bot->MCGSearch(*state);
+  SPIEL_CHECK_EQ(root.explore_count, 20000);
+  SPIEL_CHECK_LT(bot->NumNodes(),
+                 (1 << 20) / sizeof(algorithms::TranspositionNode));
+}
+
+}  // namespace
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  open_spiel::TranspositionMCTSTest_CanPlayTicTacToe();
+  open_spiel::TranspositionMCTSTest_CanPlayThreePlayerStochasticGames();
+  open_spiel::TranspositionMCTSTest_FindsWin();
+  open_spiel::TranspositionMCTSTest_SharesTranspositions();
+  open_spiel::TranspositionMCTSTest_MemoryLimit();
+}
@@ -15,8 +15,14 @@
 #include "open_spiel/algorithms/value_iteration.h"
 
 #include <algorithm>
+#include <cmath>
+#include <map>
+#include <string>
+#include <vector>
 
+#include "open_spiel/abseil-cpp/absl/types/span.h"
 #include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/thread.h"
 
 namespace open_spiel {
 namespace algorithms {
@@ -68,13 +74,12 @@ void InitializeMaps(const map<std::string, state_pointer>& states,
   }
 }
 
-}  // namespace
-
-std::map<std::string, double> ValueIteration(const Game& game, int depth_limit,
-                                             double threshold) {
-  using state_action = std::pair<std::string, Action>;
-  using state_prob = std::pair<std::string, double>;
+// Below this, the states of a depth are not worth sharing out with another
+// thread.
+constexpr int kMinStatesPerThread = 1024;
 
+// Checks that value iteration supports the game.
+void CheckGame(const Game& game) {
   // Currently only supports 1-player or 2-player zero sum games
   SPIEL_CHECK_TRUE(game.NumPlayers() == 1 || game.NumPlayers() == 2);
   if (game.NumPlayers() == 2) {
@@ -86,6 +91,112 @@ std::map<std::string, double> ValueIteration(const Game& game, int depth_limit,
   SPIEL_CHECK_EQ(game.GetType().dynamics, GameType::Dynamics::kSequential);
   SPIEL_CHECK_EQ(game.GetType().information,
                  GameType::Information::kPerfectInformation);
+}
+
+// Returns the value of a non-terminal state of the graph, w.r.t. player 0, in
+// terms of the values of its successors.
+double BackUp(const StateGraph& graph, int state,
+              const std::vector<double>& values) {
+  absl::Span<const int> successors = graph.Successors(state);
+  if (successors.empty()) return 0;
+  if (graph.IsChanceNode(state)) {
+    absl::Span<const double> probs = graph.ChanceProbabilities(state);
+    double value = 0;
+    for (int i = 0; i < successors.size(); ++i) {
+      value += probs[i] * values[successors[i]];
+    }
+    return value;
+  }
+  // Player 0 is maximizing the value (which is w.r.t. player 0)
+  // Player 1 is minimizing the value
+  const bool maximizing = graph.CurrentPlayer(state) == Player{0};
+  double value = values[successors[0]];
+  for (int successor : successors.subspan(1)) {
+    value = maximizing ? std::max(value, values[successor])
+                       : std::min(value, values[successor]);
+  }
+  return value;
+}
+
+}  // namespace
+
+std::vector<double> ValueIteration(const StateGraph& graph, double threshold,
+                                   int num_threads) {
+  SPIEL_CHECK_GE(num_threads, 1);
+  std::vector<double> values(graph.NumStates());
+  for (int state = 0; state < graph.NumStates(); ++state) {
+    if (graph.IsTerminal(state)) values[state] = graph.Returns(state)[0];
+  }
+
+  // The new values of a depth, and the largest change of each thread.
+  std::vector<double> new_values;
+  std::vector<double> errors(num_threads);
+  double error;
+  do {
+    error = 0;
+    for (int depth = graph.NumDepths() - 1; depth >= 0; --depth) {
+      const int begin = graph.DepthBegin(depth);
+      const int num_states = graph.DepthBegin(depth + 1) - begin;
+      const int num_workers = std::max(
+          1, std::min(num_threads, num_states / kMinStatesPerThread));
+      new_values.resize(num_states);
+      auto update = [&](int worker) {
+        double worker_error = 0;
+        for (int i = num_states * worker / num_workers;
+             i < num_states * (worker + 1) / num_workers; ++i) {
+          const int state = begin + i;
+          if (graph.IsTerminal(state)) {
+            new_values[i] = values[state];
+            continue;
+          }
+          new_values[i] = BackUp(graph, state, values);
+          worker_error =
+              std::max(std::abs(new_values[i] - values[state]), worker_error);
+        }
+        errors[worker] = worker_error;
+      };
+      std::vector<Thread> threads;
+      for (int worker = 1; worker < num_workers; ++worker) {
+        threads.emplace_back([&update, worker]() { update(worker); });
+      }
+      update(0);
+      for (Thread& thread : threads) thread.join();
+      std::copy(new_values.begin(), new_values.end(), values.begin() + begin);
+      for (int worker = 0; worker < num_workers; ++worker) {
+        error = std::max(errors[worker], error);
+      }
+    }
+  } while (error > threshold);
+  return values;
+}
+
+std::map<std::string, double> ValueIteration(const Game& game, int depth_limit,
+                                             double threshold,
+                                             int num_threads) {
+  CheckGame(game);
+  // As for GetAllStates, the terminal states just past the depth limit are
+  // included, and the others there are given a value of 0.
+  const StateGraph graph(game, depth_limit < 0 ? -1 : depth_limit + 1,
+                         num_threads, /*keep_states=*/true);
+  std::vector<double> values = ValueIteration(graph, threshold, num_threads);
+  std::map<std::string, double> values_by_key;
+  for (int state = 0; state < graph.NumStates(); ++state) {
+    if (graph.IsChanceNode(state)) continue;
+    if (depth_limit >= 0 && graph.Depth(state) > depth_limit &&
+        !graph.IsTerminal(state)) {
+      continue;
+    }
+    values_by_key.emplace(graph.GetState(state).ToString(), values[state]);
+  }
+  return values_by_key;
+}
+
+std::map<std::string, double> ValueIteration(const Game& game, int depth_limit,
+                                             double threshold) {
+  using state_action = std::pair<std::string, Action>;
+  using state_prob = std::pair<std::string, double>;
+
+  CheckGame(game);
 
   auto states = GetAllStates(game, depth_limit, /*include_terminals=*/true,
                              /*include_chance_states=*/false);
@@ -15,6 +15,10 @@
 #ifndef OPEN_SPIEL_ALGORITHMS_VALUE_ITERATION_H_
 #define OPEN_SPIEL_ALGORITHMS_VALUE_ITERATION_H_
 
+#include <map>
+#include <string>
+#include <vector>
+
 #include "open_spiel/algorithms/get_all_states.h"
 #include "open_spiel/spiel.h"
 
@@ -33,6 +37,27 @@ namespace algorithms {
 std::map<std::string, double> ValueIteration(const Game& game, int depth_limit,
                                              double threshold);
 
+// The same values, computed over a StateGraph of the game (see
+// get_all_states.h) on num_threads threads, and keyed the same way.
+std::map<std::string, double> ValueIteration(const Game& game, int depth_limit,
+                                             double threshold, int num_threads);
+
+// Value iteration over a StateGraph, returning the value of each of its
+// states, chance nodes included. The states at the depth limit of the graph
+// are given a value of 0.
+//
+// The values are kept in an array indexed by the ids of the states, and each
+// sweep goes through the depths of the graph from the deepest, so that most
+// successors are already updated when a state is (as in Gauss-Seidel
+// iteration): a game without cycles is solved in one sweep, and a second
+// one then checks it. The states of a depth are updated together, from the
+// values before the update for the successors at the same depth (as in
+// Jacobi iteration), which lets them be shared out between num_threads
+// threads. The iteration stops once no value changes by more than threshold
+// in a sweep.
+std::vector<double> ValueIteration(const StateGraph& graph, double threshold,
+                                   int num_threads = 1);
+
 }  // namespace algorithms
 }  // namespace open_spiel
 
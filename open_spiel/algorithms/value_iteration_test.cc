@@ -0,0 +1,70 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/algorithms/value_iteration.h"
+
+#include <cmath>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "open_spiel/algorithms/get_all_states.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace algorithms {
+namespace {
+
+// The values over a StateGraph match the ones over the states found by
+// GetAllStates, for the same states.
+void CheckSameValues(const std::string& game_name, double tolerance) {
+  std::shared_ptr<const Game> game = LoadGame(game_name);
+  const std::map<std::string, double> expected_values =
+      ValueIteration(*game, /*depth_limit=*/-1, /*threshold=*/1e-9);
+  for (int num_threads : {1, 4}) {
+    const std::map<std::string, double> values =
+        ValueIteration(*game, /*depth_limit=*/-1, /*threshold=*/1e-9,
+                       num_threads);
+    SPIEL_CHECK_EQ(values.size(), expected_values.size());
+    for (const auto& [key, value] : expected_values) {
+      SPIEL_CHECK_TRUE(values.find(key) != values.end());
+      SPIEL_CHECK_LE(std::abs(values.at(key) - value), tolerance);
+    }
+  }
+}
+
+void TicTacToeTest() {
+  std::shared_ptr<const Game> game = LoadGame("tic_tac_toe");
+  const StateGraph graph(*game);
+  const std::vector<double> values =
+      ValueIteration(graph, /*threshold=*/0, /*num_threads=*/4);
+  SPIEL_CHECK_EQ(values[StateGraph::kRoot], 0);
+
+  // The states beyond the depth limit are left out.
+  const std::map<std::string, double> limited_values = ValueIteration(
+      *game, /*depth_limit=*/2, /*threshold=*/0.01, /*num_threads=*/2);
+  SPIEL_CHECK_EQ(limited_values.size(), 1 + 9 + 72);
+  SPIEL_CHECK_EQ(limited_values.at(game->NewInitialState()->ToString()), 0);
+}
+
+}  // namespace
+}  // namespace algorithms
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  open_spiel::algorithms::CheckSameValues("tic_tac_toe", 0);
+  open_spiel::algorithms::CheckSameValues("catch", 1e-6);
+  open_spiel::algorithms::TicTacToeTest();
+}
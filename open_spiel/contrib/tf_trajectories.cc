@@ -15,9 +15,11 @@
 #include "open_spiel/contrib/tf_trajectories.h"
 
 #include <algorithm>
+#include <array>
 #include <cstring>
 #include <memory>
 #include <numeric>
+#include <optional>
 #include <random>
 #include <vector>
 
@@ -25,6 +27,7 @@
 #include "open_spiel/abseil-cpp/absl/strings/str_join.h"
 #include "third_party/eigen3/unsupported/Eigen/CXX11/src/Tensor/TensorMap.h"
 #include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/thread.h"
 
 namespace open_spiel {
 namespace algorithms {
@@ -114,47 +117,63 @@ void TFBatchTrajectoryRecorder::InitTF() {
   TF_CHECK_OK(tf_session_->Run({}, {}, {"init_all_vars_op"}, nullptr));
 }
 
-void TFBatchTrajectoryRecorder::FillInputsAndMasks() {
-  TensorMap inputs_matrix = tf_inputs_.matrix<float>();
-  TensorMap mask_matrix = tf_legal_mask_.matrix<float>();
+void TFBatchTrajectoryRecorder::FillInputsAndMasks(
+    int begin, int end, tf::Tensor* inputs, tf::Tensor* legal_mask) {
+  TensorMap inputs_matrix = inputs->matrix<float>();
+  TensorMap mask_matrix = legal_mask->matrix<float>();
 
   std::vector<double> info_state_vector;
-  for (int b = 0; b < batch_size_; ++b) {
+  for (int b = begin; b < end; ++b) {
     if (!terminal_flags_[b]) {
       std::vector<int> mask = states_[b]->LegalActionsMask();
       // Is there a way to use a vector operation here?
       for (int a = 0; a < mask.size(); ++a) {
-        mask_matrix(b, a) = mask[a];
+        mask_matrix(b - begin, a) = mask[a];
       }
 
       states_[b]->InformationStateTensor(states_[b]->CurrentPlayer(),
                                          &info_state_vector);
       for (int i = 0; i < info_state_vector.size(); ++i) {
-        inputs_matrix(b, i) = info_state_vector[i];
+        inputs_matrix(b - begin, i) = info_state_vector[i];
       }
     }
   }
 }
 
-void TFBatchTrajectoryRecorder::ApplyActions() {
-  std::vector<double> prob_dist(num_actions_, 0.0);
-  auto sampled_action = tf_outputs_[1].matrix<int64>();
-  for (int b = 0; b < batch_size_; ++b) {
+void TFBatchTrajectoryRecorder::FillInputsAndMasks() {
+  FillInputsAndMasks(0, batch_size_, &tf_inputs_, &tf_legal_mask_);
+}
+
+void TFBatchTrajectoryRecorder::ApplyActions(
+    int begin, int end, const tf::Tensor& legal_mask,
+    const std::vector<tf::Tensor>& outputs) {
+  auto sampled_action = outputs[1].matrix<int64>();
+  for (int b = begin; b < end; ++b) {
     if (!terminal_flags_[b]) {
-      Action action = sampled_action(b);
+      Action action = sampled_action(b - begin);
       SPIEL_CHECK_GE(action, 0);
       SPIEL_CHECK_LT(action, num_actions_);
-      SPIEL_CHECK_EQ(tf_legal_mask_.matrix<float>()(b, action), 1);
+      SPIEL_CHECK_EQ(legal_mask.matrix<float>()(b - begin, action), 1);
       states_[b]->ApplyAction(action);
       SampleChance(b);
     }
   }
 }
 
-void TFBatchTrajectoryRecorder::RunInference() {
+void TFBatchTrajectoryRecorder::ApplyActions() {
+  ApplyActions(0, batch_size_, tf_legal_mask_, tf_outputs_);
+}
+
+void TFBatchTrajectoryRecorder::RunInference(
+    const tf::Tensor& inputs, const tf::Tensor& legal_mask,
+    std::vector<tf::Tensor>* outputs) {
   TF_CHECK_OK(tf_session_->Run(
-      {{"input", tf_inputs_}, {"legals_mask", tf_legal_mask_}},
-      {"policy_softmax", "sampled_actions/Multinomial"}, {}, &tf_outputs_));
+      {{"input", inputs}, {"legals_mask", legal_mask}},
+      {"policy_softmax", "sampled_actions/Multinomial"}, {}, outputs));
+}
+
+void TFBatchTrajectoryRecorder::RunInference() {
+  RunInference(tf_inputs_, tf_legal_mask_, &tf_outputs_);
 }
 
 void TFBatchTrajectoryRecorder::GetNextStatesTF() {
@@ -172,5 +191,105 @@ void TFBatchTrajectoryRecorder::Record() {
   }
 }
 
+void TFBatchTrajectoryRecorder::RecordPipelined() {
+  Reset();
+  if (batch_size_ < 2) {
+    Record();
+    return;
+  }
+  struct Half {
+    int begin;
+    int end;
+    tf::Tensor inputs;
+    tf::Tensor legal_mask;
+    std::vector<tf::Tensor> outputs;
+    // Running the network, from another thread.
+    std::optional<Thread> inference;
+  };
+  std::array<Half, 2> halves;
+  for (int h = 0; h < 2; ++h) {
+    Half& half = halves[h];
+    half.begin = h * batch_size_ / 2;
+    half.end = (h + 1) * batch_size_ / 2;
+    const int size = half.end - half.begin;
+    half.inputs =
+        tf::Tensor(tf::DT_FLOAT, tf::TensorShape({size, flat_input_size_}));
+    half.legal_mask =
+        tf::Tensor(tf::DT_FLOAT, tf::TensorShape({size, num_actions_}));
+  }
+  auto done = [this](const Half& half) {
+    return std::all_of(terminal_flags_.begin() + half.begin,
+                       terminal_flags_.begin() + half.end,
+                       [](int terminal) { return terminal; });
+  };
+  // Only the inference runs on the other thread, so the games and their flags
+  // are only ever touched from this one.
+  auto start = [this, &done](Half* half) {
+    if (done(*half)) return;
+    FillInputsAndMasks(half->begin, half->end, &half->inputs,
+                       &half->legal_mask);
+    half->inference.emplace([this, half]() {
+      RunInference(half->inputs, half->legal_mask, &half->outputs);
+    });
+  };
+  auto finish = [this](Half* half) {
+    if (!half->inference) return;
+    half->inference->join();
+    half->inference.reset();
+    ApplyActions(half->begin, half->end, half->legal_mask, half->outputs);
+  };
+
+  // Each half is stepped and encoded while the other is in the network.
+  start(&halves[0]);
+  start(&halves[1]);
+  while (num_terminals_ < batch_size_) {
+    for (Half& half : halves) {
+      finish(&half);
+      start(&half);
+    }
+  }
+  for (Half& half : halves) finish(&half);
+}
+
+void TFBatchTrajectoryRecorder::Record(ColumnarTrajectory* trajectory) {
+  SPIEL_CHECK_EQ(trajectory->batch_size, batch_size_);
+  SPIEL_CHECK_EQ(trajectory->observation_size, flat_input_size_);
+  SPIEL_CHECK_EQ(trajectory->num_actions, num_actions_);
+  Reset();
+  for (int t = 0; num_terminals_ < batch_size_; ++t) {
+    SPIEL_CHECK_LT(t, trajectory->max_length);
+    FillInputsAndMasks();
+    RunInference();
+    const float* inputs = tf_inputs_.flat<float>().data();
+    const float* masks = tf_legal_mask_.flat<float>().data();
+    const float* policies = tf_outputs_[0].flat<float>().data();
+    auto sampled_action = tf_outputs_[1].matrix<int64>();
+    std::vector<int> was_terminal = terminal_flags_;
+    for (int b = 0; b < batch_size_; ++b) {
+      if (was_terminal[b]) continue;
+      const int step = b * trajectory->max_length + t;
+      std::memcpy(trajectory->Observation(b, t).data(),
+                  inputs + b * flat_input_size_,
+                  flat_input_size_ * sizeof(float));
+      std::memcpy(trajectory->LegalActions(b, t).data(),
+                  masks + b * num_actions_, num_actions_ * sizeof(float));
+      std::memcpy(trajectory->PlayerPolicy(b, t).data(),
+                  policies + b * num_actions_, num_actions_ * sizeof(float));
+      trajectory->actions[step] = sampled_action(b);
+      trajectory->player_ids[step] = states_[b]->CurrentPlayer();
+      trajectory->valid[step] = 1;
+    }
+    ApplyActions();
+    for (int b = 0; b < batch_size_; ++b) {
+      if (was_terminal[b] || !terminal_flags_[b]) continue;
+      trajectory->lengths[b] = t + 1;
+      trajectory->next_is_terminal[b * trajectory->max_length + t] = 1;
+      const std::vector<double> returns = states_[b]->Returns();
+      std::copy(returns.begin(), returns.end(),
+                trajectory->rewards.begin() + b * trajectory->num_players);
+    }
+  }
+}
+
 }  // namespace algorithms
 }  // namespace open_spiel
@@ -17,6 +17,7 @@
 
 #include <string>
 
+#include "open_spiel/algorithms/trajectories.h"
 #include "open_spiel/spiel.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/graph/default_device.h"
@@ -54,6 +55,20 @@ class TFBatchTrajectoryRecorder {
   // structures (see algorithms/trajectories.{h,cc}).
   void Record();
 
+  // Records batch-size trajectories into a ColumnarTrajectory of the same
+  // batch size, created with the game's InformationStateTensorSize and
+  // NumDistinctActions, and long enough for every trajectory. Its
+  // [B, T, N] float buffers have the layout of the input, mask and policy
+  // tensors, so each step is copied over row by row.
+  void Record(ColumnarTrajectory* trajectory);
+
+  // As Record, but with the batch split in two halves in flight at once:
+  // while one half runs through the network, the other applies its sampled
+  // actions and encodes its next inputs, so that simulating the games and
+  // inference overlap rather than take turns. Each half is a separate Run of
+  // the session, of half the batch size.
+  void RecordPipelined();
+
  protected:
   void ApplyActions();
 
@@ -67,6 +82,16 @@ class TFBatchTrajectoryRecorder {
   tensorflow::Tensor tf_inputs_;
   tensorflow::Tensor tf_legal_mask_;
 
+  // The versions for the games [begin, end), whose inputs and masks are the
+  // rows of the tensors from begin on.
+  void FillInputsAndMasks(int begin, int end, tensorflow::Tensor* inputs,
+                          tensorflow::Tensor* legal_mask);
+  void ApplyActions(int begin, int end, const tensorflow::Tensor& legal_mask,
+                    const std::vector<tensorflow::Tensor>& outputs);
+  void RunInference(const tensorflow::Tensor& inputs,
+                    const tensorflow::Tensor& legal_mask,
+                    std::vector<tensorflow::Tensor>* outputs);
+
   void FillInputsAndMasks();
   void RunInference();
   void GetNextStatesTF();
@@ -34,6 +34,12 @@ void DoubleRecordTFTrajectoryExample(const std::string& game_name) {
   recorder.Record();
 }
 
+void PipelinedTFTrajectoryExample(const std::string& game_name) {
+  std::shared_ptr<const Game> game = LoadGame(game_name);
+  TFBatchTrajectoryRecorder recorder(*game, "/tmp/graph.pb", 1024);
+  recorder.RecordPipelined();
+}
+
 }  // namespace
 }  // namespace algorithms
 }  // namespace open_spiel
@@ -48,4 +54,5 @@ int main(int argc, char** argv) {
   //   1024 games with TF policy: 1.24 sec (~832 episodes / sec)
   algorithms::SimpleTFTrajectoryExample("breakthrough");
   algorithms::DoubleRecordTFTrajectoryExample("breakthrough");
+  algorithms::PipelinedTFTrajectoryExample("breakthrough");
 }
@@ -24,6 +24,9 @@ ABSL_FLAG(std::string, path, "/tmp/az", "Where to output the logs.");
 ABSL_FLAG(std::string, graph_def, "",
           ("Where to get the graph. This could be from export_model.py, or "
            "from a checkpoint. If this is empty it'll create one."));
+ABSL_FLAG(std::string, graph_cache, "/tmp/open_spiel_graphs",
+          ("Where to cache the graphs it creates, to reuse them in later runs "
+           "with the same game and model flags. Empty to not cache them."));
 ABSL_FLAG(std::string, nn_model, "resnet", "Model torso type.");
 ABSL_FLAG(int, nn_width, 128, "Width of the model, passed to export_model.py.");
 ABSL_FLAG(int, nn_depth, 10, "Depth of the model, passed to export_model.py.");
@@ -45,19 +48,51 @@ ABSL_FLAG(int, replay_buffer_size, 1 << 16,
           "How many states to store in the replay buffer.");
 ABSL_FLAG(double, replay_buffer_reuse, 3,
           "How many times to reuse each state in the replay buffer.");
+ABSL_FLAG(double, replay_priority_exponent, 0,
+          "Sample states by their value error to this power, 0 for uniform.");
+ABSL_FLAG(int, replay_buffer_snapshot_freq, 100,
+          "Save the replay buffer every N steps, to restore it on restart, "
+          "or 0 not to.");
 ABSL_FLAG(int, checkpoint_freq, 100, "Save a checkpoint every N steps.");
 ABSL_FLAG(int, max_simulations, 300, "How many simulations to run.");
+ABSL_FLAG(int, leaf_batch_size, 1,
+          "How many MCTS leaves each actor evaluates at once.");
 ABSL_FLAG(int, train_batch_size, 1 << 10,
           "How many states to learn from per batch.");
+ABSL_FLAG(int, learner_prefetch_batches, 2,
+          "How many batches to prepare ahead while learning from one.");
 ABSL_FLAG(int, inference_batch_size, 1,
           "How many threads to wait for for inference.");
 ABSL_FLAG(int, inference_threads, 0, "How many threads to run inference.");
+ABSL_FLAG(double, inference_max_latency_ms, 1,
+          "How long an inference request may wait for a fuller batch.");
+ABSL_FLAG(std::string, inference_backend, "tensorflow",
+          "What runs inference on the devices that only serve inference: "
+          "tensorflow, onnx, onnx_fp16, onnx_int8 or tensorrt, or stub for "
+          "fake models on every device, to benchmark the rest.");
+ABSL_FLAG(double, stub_inference_latency_ms, 0,
+          "How long the stub models take per inference batch.");
+ABSL_FLAG(double, stub_learn_latency_ms, 0,
+          "How long the stub models take per training batch.");
 ABSL_FLAG(int, inference_cache, 1 << 18,
           "Whether to cache the results from inference.");
 ABSL_FLAG(std::string, devices, "/cpu:0", "Comma separated list of devices.");
+ABSL_FLAG(bool, data_parallel_learner, false,
+          "Whether to split each training batch across all the devices.");
 ABSL_FLAG(bool, verbose, false, "Show the MCTS stats of possible moves.");
 ABSL_FLAG(int, actors, 4, "How many actors to run.");
+ABSL_FLAG(int, actor_games, 1,
+          ("How many games each actor plays at once, evaluating the leaves of "
+           "their searches together."));
 ABSL_FLAG(int, evaluators, 2, "How many evaluators to run.");
+ABSL_FLAG(std::string, placement, "none",
+          ("Where to run the actors and evaluators: none, or numa to pin them "
+           "to CPUs with an inference cache per NUMA node."));
+ABSL_FLAG(int, remote_actor_hosts, 0,
+          "How many other hosts run actors for this learner.");
+ABSL_FLAG(int, actor_host, -1,
+          ("If set, only run the actors, as this remote actor host, for the "
+           "learner using the same flags and --path."));
 ABSL_FLAG(int, eval_levels, 7,
           ("Play evaluation games vs MCTS+Solver, with max_simulations*10^(n/2)"
            " simulations for n in range(eval_levels). Default of 7 means "
@@ -90,22 +125,37 @@ int main(int argc, char** argv) {
   config.game = absl::GetFlag(FLAGS_game);
   config.path = absl::GetFlag(FLAGS_path);
   config.graph_def = absl::GetFlag(FLAGS_graph_def);
+  config.graph_cache = absl::GetFlag(FLAGS_graph_cache);
   config.nn_model = absl::GetFlag(FLAGS_nn_model);
   config.nn_width = absl::GetFlag(FLAGS_nn_width);
   config.nn_depth = absl::GetFlag(FLAGS_nn_depth);
   config.devices = absl::GetFlag(FLAGS_devices);
+  config.data_parallel_learner = absl::GetFlag(FLAGS_data_parallel_learner);
   config.learning_rate = absl::GetFlag(FLAGS_learning_rate);
   config.weight_decay = absl::GetFlag(FLAGS_weight_decay);
   config.train_batch_size = absl::GetFlag(FLAGS_train_batch_size);
+  config.learner_prefetch_batches =
+      absl::GetFlag(FLAGS_learner_prefetch_batches);
   config.replay_buffer_size = absl::GetFlag(FLAGS_replay_buffer_size);
   config.replay_buffer_reuse = absl::GetFlag(FLAGS_replay_buffer_reuse);
+  config.replay_priority_exponent =
+      absl::GetFlag(FLAGS_replay_priority_exponent);
+  config.replay_buffer_snapshot_freq =
+      absl::GetFlag(FLAGS_replay_buffer_snapshot_freq);
   config.checkpoint_freq = absl::GetFlag(FLAGS_checkpoint_freq);
   config.evaluation_window = 100;
   config.uct_c = absl::GetFlag(FLAGS_uct_c);
   config.max_simulations = absl::GetFlag(FLAGS_max_simulations);
+  config.leaf_batch_size = absl::GetFlag(FLAGS_leaf_batch_size);
   config.train_batch_size = absl::GetFlag(FLAGS_train_batch_size);
   config.inference_batch_size = absl::GetFlag(FLAGS_inference_batch_size);
   config.inference_threads = absl::GetFlag(FLAGS_inference_threads);
+  config.inference_max_latency_ms =
+      absl::GetFlag(FLAGS_inference_max_latency_ms);
+  config.inference_backend = absl::GetFlag(FLAGS_inference_backend);
+  config.stub_inference_latency_ms =
+      absl::GetFlag(FLAGS_stub_inference_latency_ms);
+  config.stub_learn_latency_ms = absl::GetFlag(FLAGS_stub_learn_latency_ms);
   config.inference_cache = absl::GetFlag(FLAGS_inference_cache);
   config.policy_alpha = absl::GetFlag(FLAGS_policy_alpha);
   config.policy_epsilon = absl::GetFlag(FLAGS_policy_epsilon);
@@ -114,9 +164,16 @@ int main(int argc, char** argv) {
   config.cutoff_probability = absl::GetFlag(FLAGS_cutoff_probability);
   config.cutoff_value = absl::GetFlag(FLAGS_cutoff_value);
   config.actors = absl::GetFlag(FLAGS_actors);
+  config.actor_games = absl::GetFlag(FLAGS_actor_games);
   config.evaluators = absl::GetFlag(FLAGS_evaluators);
+  config.placement = absl::GetFlag(FLAGS_placement);
+  config.remote_actor_hosts = absl::GetFlag(FLAGS_remote_actor_hosts);
   config.eval_levels = absl::GetFlag(FLAGS_eval_levels);
   config.max_steps = absl::GetFlag(FLAGS_max_steps);
 
+  int actor_host = absl::GetFlag(FLAGS_actor_host);
+  if (actor_host >= 0) {
+    return !AlphaZeroActorHost(config, actor_host, &stop_token);
+  }
   return !AlphaZero(config, &stop_token);
 }
@@ -0,0 +1,196 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Throughput benchmark of the AlphaZero pipeline, without the net.
+//
+// This runs the actors, evaluators and learner of AlphaZero for a number of
+// learner steps, with stub models on every device: a uniform policy and a
+// draw value, after a fixed latency per inference or training batch. What is
+// left is the cost of the searches, the batching of their requests, the
+// replay buffer and the queues, which a real net hides. For each step after
+// the first, whose rates include the startup, this reports the games and
+// positions per second, and the depths of the trajectory queue to the learner
+// and of the inference queues, as JSON, e.g.:
+//
+//   benchmark_alpha_zero --game=connect_four --actors=8 \
+//       --inference_batch_size=8 --stub_inference_latency_ms=2
+
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/flags/flag.h"
+#include "open_spiel/abseil-cpp/absl/flags/parse.h"
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/abseil-cpp/absl/strings/str_split.h"
+#include "open_spiel/algorithms/alpha_zero/alpha_zero.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/file.h"
+#include "open_spiel/utils/json.h"
+#include "open_spiel/utils/stats.h"
+#include "open_spiel/utils/thread.h"
+
+ABSL_FLAG(std::string, game, "tic_tac_toe", "The game to play.");
+ABSL_FLAG(std::string, path, "/tmp/az_benchmark",
+          "Where AlphaZero writes its logs and checkpoints.");
+ABSL_FLAG(int, steps, 10, "How many learner steps to run.");
+ABSL_FLAG(int, actors, 4, "How many actors to run.");
+ABSL_FLAG(int, actor_games, 1, "How many games each actor plays at once.");
+ABSL_FLAG(int, evaluators, 0, "How many evaluators to run.");
+ABSL_FLAG(int, max_simulations, 100, "Simulations per move.");
+ABSL_FLAG(int, leaf_batch_size, 1, "Leaves each search evaluates at once.");
+ABSL_FLAG(std::string, devices, "/cpu:0", "Comma separated list of devices.");
+ABSL_FLAG(int, inference_batch_size, 4,
+          "How many requests an inference batch waits for.");
+ABSL_FLAG(int, inference_threads, 2, "How many threads run inference.");
+ABSL_FLAG(double, inference_max_latency_ms, 1,
+          "How long an inference request may wait for a fuller batch.");
+ABSL_FLAG(int, inference_cache, 0,
+          "The size of the inference cache. Caching the stub's constant "
+          "outputs mostly measures the cache.");
+ABSL_FLAG(double, stub_inference_latency_ms, 0,
+          "How long the stub models take per inference batch.");
+ABSL_FLAG(double, stub_learn_latency_ms, 0,
+          "How long the stub models take per training batch.");
+ABSL_FLAG(int, train_batch_size, 256, "Positions per training batch.");
+ABSL_FLAG(int, replay_buffer_size, 1 << 12, "Positions in the replay buffer.");
+ABSL_FLAG(int, replay_buffer_reuse, 4,
+          "How many times each position is learnt from, on average.");
+ABSL_FLAG(std::string, placement, "none",
+          "Where the actors run: none or numa.");
+ABSL_FLAG(std::string, output, "", "File to write the JSON to, or stdout.");
+
+namespace open_spiel {
+namespace {
+
+algorithms::AlphaZeroConfig BenchmarkConfig() {
+  algorithms::AlphaZeroConfig config;
+  config.game = absl::GetFlag(FLAGS_game);
+  config.path = absl::GetFlag(FLAGS_path);
+  config.devices = absl::GetFlag(FLAGS_devices);
+  config.data_parallel_learner = false;
+  config.learning_rate = 0.001;
+  config.weight_decay = 0.0001;
+  config.train_batch_size = absl::GetFlag(FLAGS_train_batch_size);
+  config.learner_prefetch_batches = 2;
+  config.inference_batch_size = absl::GetFlag(FLAGS_inference_batch_size);
+  config.inference_threads = absl::GetFlag(FLAGS_inference_threads);
+  config.inference_max_latency_ms =
+      absl::GetFlag(FLAGS_inference_max_latency_ms);
+  config.inference_backend = "stub";
+  config.stub_inference_latency_ms =
+      absl::GetFlag(FLAGS_stub_inference_latency_ms);
+  config.stub_learn_latency_ms = absl::GetFlag(FLAGS_stub_learn_latency_ms);
+  config.inference_cache = absl::GetFlag(FLAGS_inference_cache);
+  config.replay_buffer_size = absl::GetFlag(FLAGS_replay_buffer_size);
+  config.replay_buffer_reuse = absl::GetFlag(FLAGS_replay_buffer_reuse);
+  config.replay_priority_exponent = 0;
+  config.replay_buffer_snapshot_freq = 0;
+  config.checkpoint_freq = 1 << 30;  // Only the "latest" one.
+  config.evaluation_window = 100;
+  config.uct_c = 2;
+  config.max_simulations = absl::GetFlag(FLAGS_max_simulations);
+  config.leaf_batch_size = absl::GetFlag(FLAGS_leaf_batch_size);
+  config.policy_alpha = 1;
+  config.policy_epsilon = 0.25;
+  config.temperature = 1;
+  config.temperature_drop = 10;
+  config.cutoff_probability = 0;
+  config.cutoff_value = 0.95;
+  config.actors = absl::GetFlag(FLAGS_actors);
+  config.actor_games = absl::GetFlag(FLAGS_actor_games);
+  config.evaluators = absl::GetFlag(FLAGS_evaluators);
+  config.placement = absl::GetFlag(FLAGS_placement);
+  config.remote_actor_hosts = 0;
+  config.eval_levels = 7;
+  config.max_steps = absl::GetFlag(FLAGS_steps);
+  return config;
+}
+
+// Numbers which happen to be whole are parsed back as ints.
+double Number(const json::Value& value) {
+  return value.IsInt() ? value.GetInt() : value.GetDouble();
+}
+
+// The throughput of each learner step, from the records the learner logged.
+json::Object StepResults(const std::string& path) {
+  json::Array steps;
+  BasicStats games_per_s;
+  BasicStats positions_per_s;
+  BasicStats trajectory_queue;
+  BasicStats inference_queue;
+  const std::string log =
+      file::File(absl::StrCat(path, "/learner.jsonl"), "r").ReadContents();
+  for (absl::string_view line : absl::StrSplit(log, '\n', absl::SkipEmpty())) {
+    std::optional<json::Value> parsed = json::FromString(line);
+    SPIEL_CHECK_TRUE(parsed.has_value() && parsed->IsObject());
+    const json::Object& record = parsed->GetObject();
+    const json::Object& profile = record.at("profile").GetObject();
+    const json::Object& queue_depth = profile.at("queue_depth").GetObject();
+    const int64_t step = record.at("step").GetInt();
+    json::Object result = {
+        {"step", step},
+        {"games_per_s", Number(record.at("trajectories_per_s"))},
+        {"positions_per_s", Number(record.at("states_per_s"))},
+        {"trajectory_queue_depth", record.at("queue_size").GetInt()},
+        {"inference_queue_depth", Number(queue_depth.at("avg"))},
+        {"inference_queue_depth_max", Number(queue_depth.at("max"))},
+        {"inference_queue_wait_ms",
+         Number(profile.at("queue_wait_ms").GetObject().at("avg"))},
+        {"inference_batch_size",
+         Number(record.at("batch_size").GetObject().at("avg"))},
+    };
+    if (step > 1) {
+      games_per_s.Add(Number(result["games_per_s"]));
+      positions_per_s.Add(Number(result["positions_per_s"]));
+      trajectory_queue.Add(Number(result["trajectory_queue_depth"]));
+      inference_queue.Add(Number(result["inference_queue_depth"]));
+    }
+    steps.push_back(std::move(result));
+  }
+  return {{"games_per_s", games_per_s.ToJson()},
+          {"positions_per_s", positions_per_s.ToJson()},
+          {"trajectory_queue_depth", trajectory_queue.ToJson()},
+          {"inference_queue_depth", inference_queue.ToJson()},
+          {"steps", steps}};
+}
+
+}  // namespace
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+
+  open_spiel::algorithms::AlphaZeroConfig config =
+      open_spiel::BenchmarkConfig();
+  open_spiel::StopToken stop;
+  if (!open_spiel::algorithms::AlphaZero(config, &stop)) return 1;
+
+  // AlphaZero clamps some of the config, which it wrote to config.json.
+  const std::string json = open_spiel::json::ToString(
+      open_spiel::json::Object{
+          {"config", *open_spiel::json::FromString(
+                         open_spiel::file::File(config.path + "/config.json",
+                                                "r").ReadContents())},
+          {"results", open_spiel::StepResults(config.path)}},
+      /*wrap=*/true);
+  if (absl::GetFlag(FLAGS_output).empty()) {
+    std::cout << json << std::endl;
+  } else {
+    open_spiel::file::File(absl::GetFlag(FLAGS_output), "w").Write(json);
+  }
+}
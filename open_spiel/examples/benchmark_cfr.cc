@@ -0,0 +1,232 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Convergence-versus-time benchmark of the CFR solvers.
+//
+// Each solver runs on each game for the same wall clock budget. The NashConv
+// of its average policy is computed after log-spaced numbers of iterations,
+// outside of the timed iterations, giving a curve of NashConv against the
+// iterations and the time they took. Along with the curves, this reports the
+// iterations per second and the peak memory allocated by each solver, on
+// the main thread, as JSON, e.g.:
+//
+//   benchmark_cfr --games="kuhn_poker;leduc_poker" --solvers=cfr,cfr_plus
+//
+// The games are separated by semicolons, as their parameters contain commas.
+// Games which are not registered in this build, e.g. universal_poker without
+// ACPC, are skipped.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/flags/flag.h"
+#include "open_spiel/abseil-cpp/absl/flags/parse.h"
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/abseil-cpp/absl/strings/str_split.h"
+#include "open_spiel/abseil-cpp/absl/time/clock.h"
+#include "open_spiel/abseil-cpp/absl/time/time.h"
+#include "open_spiel/algorithms/cfr.h"
+#include "open_spiel/algorithms/external_sampling_mccfr.h"
+#include "open_spiel/algorithms/flat_cfr.h"
+#include "open_spiel/algorithms/outcome_sampling_mccfr.h"
+#include "open_spiel/algorithms/tabular_exploitability.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/tests/allocation_counter.h"
+#include "open_spiel/utils/file.h"
+#include "open_spiel/utils/json.h"
+
+ABSL_FLAG(std::string, games,
+          "kuhn_poker;leduc_poker;liars_dice;"
+          "universal_poker(betting=limit,numPlayers=2,numRounds=2,"
+          "blind=1 1,raiseSize=2 4,firstPlayer=1 1,maxRaises=2 2,numSuits=2,"
+          "numRanks=3,numHoleCards=1,numBoardCards=0 1)",
+          "Semicolon-separated list of games to benchmark.");
+ABSL_FLAG(std::string, solvers,
+          "cfr,cfr_plus,linear_cfr,dcfr,flat_cfr,external_sampling_mccfr,"
+          "outcome_sampling_mccfr",
+          "Comma-separated list of solvers to benchmark.");
+ABSL_FLAG(double, time_budget_seconds, 10,
+          "The time each solver runs iterations for on each game, not "
+          "counting the NashConv computations.");
+ABSL_FLAG(int, points_per_decade, 4,
+          "How many NashConv points to compute per factor of ten iterations.");
+ABSL_FLAG(int, seed, 0, "Seed of the sampling solvers.");
+ABSL_FLAG(std::string, output, "", "File to write the JSON to, or stdout.");
+
+namespace open_spiel {
+namespace {
+
+// A solver under benchmark: runs one iteration, or computes the NashConv of
+// its average policy.
+struct BenchmarkedSolver {
+  std::function<void()> run_iteration;
+  std::function<double()> nash_conv;
+};
+
+// The solvers with EvaluateAndUpdatePolicy and AveragePolicy.
+template <typename Solver>
+BenchmarkedSolver IteratedSolver(const Game& game,
+                                 std::shared_ptr<Solver> solver) {
+  return {[solver]() { solver->EvaluateAndUpdatePolicy(); },
+          [solver, &game]() {
+            return algorithms::NashConv(game, *solver->AveragePolicy(),
+                                        /*use_state_get_policy=*/true);
+          }};
+}
+
+// The solvers with RunIteration and AveragePolicy.
+template <typename Solver>
+BenchmarkedSolver SampledSolver(const Game& game,
+                                std::shared_ptr<Solver> solver) {
+  return {[solver]() { solver->RunIteration(); },
+          [solver, &game]() {
+            return algorithms::NashConv(game, *solver->AveragePolicy(),
+                                        /*use_state_get_policy=*/true);
+          }};
+}
+
+BenchmarkedSolver MakeSolver(const std::string& name, const Game& game) {
+  const int seed = absl::GetFlag(FLAGS_seed);
+  if (name == "cfr") {
+    return IteratedSolver(game, std::make_shared<algorithms::CFRSolver>(game));
+  } else if (name == "cfr_plus") {
+    return IteratedSolver(game,
+                          std::make_shared<algorithms::CFRPlusSolver>(game));
+  } else if (name == "linear_cfr") {
+    return IteratedSolver(game, std::make_shared<algorithms::DCFRSolver>(
+                                    game, /*alpha=*/1, /*beta=*/1,
+                                    /*gamma=*/1));
+  } else if (name == "dcfr") {
+    return IteratedSolver(game, std::make_shared<algorithms::DCFRSolver>(game));
+  } else if (name == "flat_cfr") {
+    auto solver = std::make_shared<algorithms::FlatCFRSolver>(game);
+    return {[solver]() { solver->EvaluateAndUpdatePolicy(); },
+            [solver, &game]() {
+              return algorithms::NashConv(game, solver->AveragePolicy(),
+                                          /*use_state_get_policy=*/true);
+            }};
+  } else if (name == "external_sampling_mccfr") {
+    return SampledSolver(
+        game,
+        std::make_shared<algorithms::ExternalSamplingMCCFRSolver>(game, seed));
+  } else if (name == "outcome_sampling_mccfr") {
+    return SampledSolver(
+        game, std::make_shared<algorithms::OutcomeSamplingMCCFRSolver>(
+                  game, algorithms::OutcomeSamplingMCCFRSolver::kDefaultEpsilon,
+                  seed));
+  }
+  SpielFatalError(absl::StrCat("Unknown solver: ", name));
+}
+
+// The iteration after which the n-th NashConv is computed, from 0.
+int64_t CheckpointIteration(int n) {
+  return std::ceil(
+      std::pow(10.0, static_cast<double>(n) /
+                         absl::GetFlag(FLAGS_points_per_decade)) -
+      1e-9);
+}
+
+json::Object BenchmarkSolver(const Game& game, const std::string& name) {
+  testing::AllocationCounter counter;
+  BenchmarkedSolver solver = MakeSolver(name, game);
+
+  const absl::Duration budget =
+      absl::Seconds(absl::GetFlag(FLAGS_time_budget_seconds));
+  absl::Duration time;
+  int64_t iterations = 0;
+  int checkpoint = 0;
+  int64_t last_point = -1;
+  int64_t peak_bytes = 0;
+  json::Array curve;
+  auto add_point = [&]() {
+    // The NashConv computation is left out of the peak memory.
+    peak_bytes = std::max(peak_bytes, counter.PeakLiveBytes());
+    const double nash_conv = solver.nash_conv();
+    counter.ResetPeak();
+    curve.push_back(json::Object{{"iterations", iterations},
+                                 {"seconds", absl::ToDoubleSeconds(time)},
+                                 {"nash_conv", nash_conv}});
+    last_point = iterations;
+  };
+  while (time < budget) {
+    const absl::Time start = absl::Now();
+    solver.run_iteration();
+    time += absl::Now() - start;
+    ++iterations;
+    if (iterations >= CheckpointIteration(checkpoint)) {
+      add_point();
+      while (CheckpointIteration(checkpoint) <= iterations) ++checkpoint;
+    }
+  }
+  if (last_point != iterations) add_point();
+
+  const double seconds = absl::ToDoubleSeconds(time);
+  return {{"game", game.ToString()},
+          {"solver", name},
+          {"iterations", iterations},
+          {"seconds", seconds},
+          {"iterations_per_second", iterations / seconds},
+          {"peak_memory_mb", peak_bytes / double{1 << 20}},
+          {"curve", curve}};
+}
+
+}  // namespace
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+
+  const std::vector<std::string> solvers =
+      absl::StrSplit(absl::GetFlag(FLAGS_solvers), ',', absl::SkipEmpty());
+  open_spiel::json::Array results;
+  for (absl::string_view game_view :
+       absl::StrSplit(absl::GetFlag(FLAGS_games), ';', absl::SkipEmpty())) {
+    const std::string game_string(game_view);
+    const std::string short_name =
+        open_spiel::GameParametersFromString(game_string)["name"]
+            .string_value();
+    if (!open_spiel::IsGameRegistered(short_name)) {
+      std::cerr << "Skipping " << game_string << ", which is not registered"
+                << std::endl;
+      continue;
+    }
+    std::shared_ptr<const open_spiel::Game> game =
+        open_spiel::LoadGame(game_string);
+    for (const std::string& solver : solvers) {
+      std::cerr << "Benchmarking " << solver << " on " << game->ToString()
+                << std::endl;
+      results.push_back(open_spiel::BenchmarkSolver(*game, solver));
+    }
+  }
+
+  const std::string json = open_spiel::json::ToString(
+      open_spiel::json::Object{
+          {"time_budget_seconds", absl::GetFlag(FLAGS_time_budget_seconds)},
+          {"points_per_decade", absl::GetFlag(FLAGS_points_per_decade)},
+          {"seed", absl::GetFlag(FLAGS_seed)},
+          {"results", results}},
+      /*wrap=*/true);
+  if (absl::GetFlag(FLAGS_output).empty()) {
+    std::cout << json << std::endl;
+  } else {
+    open_spiel::file::File(absl::GetFlag(FLAGS_output), "w").Write(json);
+  }
+}
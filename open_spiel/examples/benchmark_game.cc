@@ -12,19 +12,42 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <functional>
 #include <iostream>
+#include <map>
+#include <memory>
 #include <random>
+#include <string>
 #include <vector>
 
 #include "open_spiel/abseil-cpp/absl/flags/flag.h"
 #include "open_spiel/abseil-cpp/absl/flags/parse.h"
+#include "open_spiel/abseil-cpp/absl/strings/numbers.h"
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
 #include "open_spiel/abseil-cpp/absl/strings/str_format.h"
+#include "open_spiel/abseil-cpp/absl/strings/str_split.h"
+#include "open_spiel/game_transforms/misere.h"
+#include "open_spiel/games/breakthrough.h"
+#include "open_spiel/games/connect_four.h"
+#include "open_spiel/games/tic_tac_toe.h"
 #include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/thread.h"
 
 ABSL_FLAG(std::string, game, "tic_tac_toe", "The name of the game to play.");
 ABSL_FLAG(int, sims, 1000, "How many simulations to run.");
 ABSL_FLAG(int, attempts, 5, "How many sets of simulations to run.");
 ABSL_FLAG(bool, verbose, false, "How many sets of simulations to run.");
+ABSL_FLAG(bool, compare_wrapped, false,
+          "Also time the misere version of the game, wrapped with "
+          "WrappedState and, for the games with a typed wrapper below, "
+          "TypedWrappedState.");
+ABSL_FLAG(std::string, threads, "",
+          "A comma-separated list of thread counts, e.g. 1,2,4,8. When set, "
+          "each count runs --sims simulations on each of that many threads at "
+          "once, and the moves/s over all of them are compared to those of "
+          "one thread, to show how well the game scales across cores.");
 
 namespace open_spiel {
 
@@ -38,6 +61,7 @@ int RandomSimulation(std::mt19937* rng, const Game& game, bool verbose) {
   }
 
   std::vector<double> obs;
+  std::vector<Action> legal_actions;
   bool provides_info_state = game.GetType().provides_information_state_tensor;
   bool provides_observations = game.GetType().provides_observation_tensor;
 
@@ -77,9 +101,9 @@ int RandomSimulation(std::mt19937* rng, const Game& game, bool verbose) {
       state->ApplyActions(joint_action);
     } else {
       // Sample an action uniformly.
-      std::vector<Action> actions = state->LegalActions();
-      std::uniform_int_distribution<int> dis(0, actions.size() - 1);
-      Action action = actions[dis(*rng)];
+      state->LegalActions(&legal_actions);
+      std::uniform_int_distribution<int> dis(0, legal_actions.size() - 1);
+      Action action = legal_actions[dis(*rng)];
       if (verbose) {
         int p = state->CurrentPlayer();
         std::cout << "Player " << p
@@ -96,20 +120,33 @@ int RandomSimulation(std::mt19937* rng, const Game& game, bool verbose) {
   return game_length;
 }
 
+// The games whose misere versions can be timed with TypedWrappedState, by
+// short name, as the wrapper needs the type of their states.
+const std::map<std::string,
+               std::function<std::shared_ptr<const Game>(const std::string&)>>&
+TypedMisereLoaders() {
+  static const auto* loaders = new std::map<
+      std::string,
+      std::function<std::shared_ptr<const Game>(const std::string&)>>{
+      {"breakthrough", LoadTypedMisereGame<breakthrough::BreakthroughState>},
+      {"connect_four", LoadTypedMisereGame<connect_four::ConnectFourState>},
+      {"tic_tac_toe", LoadTypedMisereGame<tic_tac_toe::TicTacToeState>},
+  };
+  return *loaders;
+}
+
 // Perform num_sims random simulations of the specified game, and output the
 // time taken.
-void RandomSimBenchmark(const std::string& game_def, int num_sims,
-                        bool verbose) {
+void RandomSimBenchmark(const std::string& label, const Game& game,
+                        int num_sims, bool verbose) {
   std::mt19937 rng;
-  std::cout << absl::StrFormat("Benchmark: game: %s, num_sims: %d. ", game_def,
+  std::cout << absl::StrFormat("Benchmark: game: %s, num_sims: %d. ", label,
                                num_sims);
 
-  auto game = LoadGame(game_def);
-
   absl::Time start = absl::Now();
   int num_moves = 0;
   for (int sim = 0; sim < num_sims; ++sim) {
-    num_moves += RandomSimulation(&rng, *game, verbose);
+    num_moves += RandomSimulation(&rng, game, verbose);
   }
   absl::Time end = absl::Now();
   double seconds = absl::ToDoubleSeconds(end - start);
@@ -121,14 +158,106 @@ void RandomSimBenchmark(const std::string& game_def, int num_sims,
             << std::endl;
 }
 
+// Runs num_sims random simulations on each of num_threads threads at once,
+// each with its own generator but sharing the game, and returns the moves per
+// second over all of them.
+double ThreadedMovesPerSecond(const Game& game, int num_threads, int num_sims) {
+  std::vector<int> num_moves(num_threads, 0);
+  std::vector<Thread> threads;
+  absl::Time start = absl::Now();
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&game, &num_moves, t, num_sims]() {
+      std::mt19937 rng(t);
+      int moves = 0;
+      for (int sim = 0; sim < num_sims; ++sim) {
+        moves += RandomSimulation(&rng, game, /*verbose=*/false);
+      }
+      num_moves[t] = moves;
+    });
+  }
+  for (Thread& thread : threads) thread.join();
+  double seconds = absl::ToDoubleSeconds(absl::Now() - start);
+  int total_moves = 0;
+  for (int moves : num_moves) total_moves += moves;
+  return total_moves / seconds;
+}
+
+// Times the simulations on each number of threads, keeping the best of
+// num_attempts, and outputs the moves/s over all threads and the efficiency
+// per thread: the fraction of the moves/s of one thread that each thread
+// keeps. Shared state in the game, allocator contention and the reference
+// counting of the game by its states all show up as a lower efficiency.
+void ThreadScalingBenchmark(const std::string& label, const Game& game,
+                            const std::vector<int>& thread_counts,
+                            int num_sims, int num_attempts) {
+  std::cout << absl::StrFormat(
+                   "Scaling benchmark: game: %s, num_sims per thread: %d.",
+                   label, num_sims)
+            << std::endl;
+  auto best_rate = [&](int num_threads) {
+    double rate = 0;
+    for (int i = 0; i < num_attempts; ++i) {
+      rate = std::max(rate,
+                      ThreadedMovesPerSecond(game, num_threads, num_sims));
+    }
+    return rate;
+  };
+  const double single_thread_rate = best_rate(1);
+  for (int num_threads : thread_counts) {
+    const double rate =
+        num_threads == 1 ? single_thread_rate : best_rate(num_threads);
+    std::cout << absl::StrFormat(
+                     "  threads: %3d, %.1f moves/s, %.1f moves/s per thread, "
+                     "efficiency: %.1f%%",
+                     num_threads, rate, rate / num_threads,
+                     100 * rate / (num_threads * single_thread_rate))
+              << std::endl;
+  }
+}
+
 }  // namespace open_spiel
 
 int main(int argc, char** argv) {
   absl::ParseCommandLine(argc, argv);
 
-  for (int i = 0; i < absl::GetFlag(FLAGS_attempts); ++i) {
-    open_spiel::RandomSimBenchmark(absl::GetFlag(FLAGS_game),
-                                   absl::GetFlag(FLAGS_sims),
-                                   absl::GetFlag(FLAGS_verbose));
+  const std::string game_def = absl::GetFlag(FLAGS_game);
+  std::vector<std::pair<std::string, std::shared_ptr<const open_spiel::Game>>>
+      games = {{game_def, open_spiel::LoadGame(game_def)}};
+  if (absl::GetFlag(FLAGS_compare_wrapped)) {
+    games.emplace_back(
+        absl::StrCat("misere(game=", game_def, ")"),
+        open_spiel::LoadGame("misere", {{"game", open_spiel::GameParameter(
+                                            open_spiel::GameParametersFromString(
+                                                game_def))}}));
+    const auto& loaders = open_spiel::TypedMisereLoaders();
+    auto it = loaders.find(games[0].second->GetType().short_name);
+    if (it != loaders.end()) {
+      games.emplace_back(absl::StrCat("typed misere(game=", game_def, ")"),
+                         it->second(game_def));
+    }
+  }
+
+  std::vector<int> thread_counts;
+  for (absl::string_view count :
+       absl::StrSplit(absl::GetFlag(FLAGS_threads), ',', absl::SkipEmpty())) {
+    int num_threads;
+    if (!absl::SimpleAtoi(count, &num_threads) || num_threads < 1) {
+      open_spiel::SpielFatalError(
+          absl::StrCat("Invalid thread count in --threads: ", count));
+    }
+    thread_counts.push_back(num_threads);
+  }
+
+  for (const auto& [label, game] : games) {
+    if (!thread_counts.empty()) {
+      open_spiel::ThreadScalingBenchmark(label, *game, thread_counts,
+                                         absl::GetFlag(FLAGS_sims),
+                                         absl::GetFlag(FLAGS_attempts));
+      continue;
+    }
+    for (int i = 0; i < absl::GetFlag(FLAGS_attempts); ++i) {
+      open_spiel::RandomSimBenchmark(label, *game, absl::GetFlag(FLAGS_sims),
+                                     absl::GetFlag(FLAGS_verbose));
+    }
   }
 }
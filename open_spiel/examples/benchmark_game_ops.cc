@@ -0,0 +1,272 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Per-operation micro-benchmarks of the State API, for every registered game.
+//
+// States are collected from random rollouts, and each operation is then timed
+// over all of them. For each game and operation this reports the average time
+// and the number of heap allocations (and bytes) per call, as JSON, e.g.:
+//
+//   benchmark_game_ops --games=tic_tac_toe,kuhn_poker --output=/tmp/ops.json
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/flags/flag.h"
+#include "open_spiel/abseil-cpp/absl/flags/parse.h"
+#include "open_spiel/abseil-cpp/absl/strings/str_split.h"
+#include "open_spiel/abseil-cpp/absl/time/clock.h"
+#include "open_spiel/abseil-cpp/absl/time/time.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/tests/allocation_counter.h"
+#include "open_spiel/utils/file.h"
+#include "open_spiel/utils/json.h"
+
+ABSL_FLAG(std::string, games, "",
+          "Comma-separated list of games to benchmark. Defaults to all the "
+          "registered games that can be loaded without parameters.");
+ABSL_FLAG(int, rollouts, 10, "Random rollouts used to collect the states.");
+ABSL_FLAG(int, max_states, 1000, "Maximum number of states per game.");
+ABSL_FLAG(int, repetitions, 5, "How many times to run each op on each state.");
+ABSL_FLAG(int, seed, 0, "Seed of the random rollouts.");
+ABSL_FLAG(std::string, output, "", "File to write the JSON to, or stdout.");
+
+namespace open_spiel {
+namespace {
+
+using States = std::vector<std::unique_ptr<State>>;
+
+struct OpStats {
+  int64_t count = 0;
+  absl::Duration time;
+  int64_t allocations = 0;
+  int64_t bytes = 0;
+
+  json::Object ToJson() const {
+    const double n = count;
+    return {{"count", count},
+            {"ns_per_op", absl::ToDoubleNanoseconds(time) / n},
+            {"allocations_per_op", allocations / n},
+            {"bytes_per_op", bytes / n}};
+  }
+};
+
+// Runs `fn`, which performs `num_ops` operations, and adds its cost to stats.
+template <typename Fn>
+void Measure(int64_t num_ops, OpStats* stats, Fn fn) {
+  testing::AllocationCounter counter;
+  const absl::Time start = absl::Now();
+  fn();
+  stats->time += absl::Now() - start;
+  stats->allocations += counter.Allocations();
+  stats->bytes += counter.Bytes();
+  stats->count += num_ops;
+}
+
+// One action per player at simultaneous nodes, a single action otherwise.
+std::vector<Action> SampleActions(const State& state, std::mt19937* rng) {
+  if (state.IsChanceNode()) {
+    return {SampleAction(state.ChanceOutcomes(), *rng).first};
+  }
+  auto uniform = [rng](const std::vector<Action>& actions) {
+    if (actions.empty()) return kInvalidAction;
+    return actions[std::uniform_int_distribution<int>(0, actions.size() - 1)(
+        *rng)];
+  };
+  if (state.IsSimultaneousNode()) {
+    std::vector<Action> joint_action;
+    for (Player p = 0; p < state.NumPlayers(); ++p) {
+      joint_action.push_back(uniform(state.LegalActions(p)));
+    }
+    return joint_action;
+  }
+  return {uniform(state.LegalActions())};
+}
+
+void Apply(const std::vector<Action>& actions, State* state) {
+  if (state->IsSimultaneousNode()) {
+    state->ApplyActions(actions);
+  } else {
+    state->ApplyAction(actions[0]);
+  }
+}
+
+States CollectStates(const Game& game, std::mt19937* rng) {
+  const int max_states = absl::GetFlag(FLAGS_max_states);
+  States states;
+  for (int i = 0; i < absl::GetFlag(FLAGS_rollouts); ++i) {
+    std::unique_ptr<State> state = game.NewInitialState();
+    while (states.size() < max_states) {
+      states.push_back(state->Clone());
+      if (state->IsTerminal()) break;
+      Apply(SampleActions(*state, rng), state.get());
+    }
+  }
+  return states;
+}
+
+// The player whose view is benchmarked for observations and info states.
+Player ObservingPlayer(const State& state) {
+  return state.CurrentPlayer() >= 0 ? state.CurrentPlayer() : 0;
+}
+
+json::Object BenchmarkGame(const Game& game, std::mt19937* rng) {
+  const GameType& type = game.GetType();
+  const States states = CollectStates(game, rng);
+  States non_terminal;
+  for (const auto& state : states) {
+    if (!state->IsTerminal()) non_terminal.push_back(state->Clone());
+  }
+  std::vector<std::vector<Action>> actions;
+  for (const auto& state : non_terminal) {
+    actions.push_back(SampleActions(*state, rng));
+  }
+
+  OpStats new_initial_state, legal_actions, apply_action, clone;
+  OpStats observation_tensor, information_state_string, chance_outcomes;
+  OpStats serialize;
+  for (int rep = 0; rep < absl::GetFlag(FLAGS_repetitions); ++rep) {
+    // Destroyed outside of the measurements.
+    States scratch(states.size());
+    Measure(states.size(), &new_initial_state, [&]() {
+      for (auto& state : scratch) state = game.NewInitialState();
+    });
+    scratch = States(states.size());
+    Measure(states.size(), &clone, [&]() {
+      for (int i = 0; i < states.size(); ++i) scratch[i] = states[i]->Clone();
+    });
+    Measure(states.size(), &serialize, [&]() {
+      for (const auto& state : states) state->Serialize();
+    });
+
+    int64_t num_legal_actions = 0;
+    for (const auto& state : non_terminal) {
+      if (state->IsChanceNode()) continue;
+      num_legal_actions +=
+          state->IsSimultaneousNode() ? state->NumPlayers() : 1;
+    }
+    Measure(num_legal_actions, &legal_actions, [&]() {
+      for (const auto& state : non_terminal) {
+        if (state->IsChanceNode()) continue;
+        if (state->IsSimultaneousNode()) {
+          for (Player p = 0; p < state->NumPlayers(); ++p) {
+            state->LegalActions(p);
+          }
+        } else {
+          state->LegalActions();
+        }
+      }
+    });
+
+    int64_t num_chance_nodes = 0;
+    for (const auto& state : non_terminal) {
+      num_chance_nodes += state->IsChanceNode();
+    }
+    Measure(num_chance_nodes, &chance_outcomes, [&]() {
+      for (const auto& state : non_terminal) {
+        if (state->IsChanceNode()) state->ChanceOutcomes();
+      }
+    });
+
+    States children(non_terminal.size());
+    for (int i = 0; i < non_terminal.size(); ++i) {
+      children[i] = non_terminal[i]->Clone();
+    }
+    Measure(children.size(), &apply_action, [&]() {
+      for (int i = 0; i < children.size(); ++i) {
+        Apply(actions[i], children[i].get());
+      }
+    });
+
+    if (type.provides_observation_tensor) {
+      Measure(states.size(), &observation_tensor, [&]() {
+        for (const auto& state : states) {
+          state->ObservationTensor(ObservingPlayer(*state));
+        }
+      });
+    }
+    if (type.provides_information_state_string) {
+      Measure(states.size(), &information_state_string, [&]() {
+        for (const auto& state : states) {
+          state->InformationStateString(ObservingPlayer(*state));
+        }
+      });
+    }
+  }
+
+  json::Object ops = {{"NewInitialState", new_initial_state.ToJson()},
+                      {"Clone", clone.ToJson()},
+                      {"Serialize", serialize.ToJson()}};
+  if (legal_actions.count > 0) ops["LegalActions"] = legal_actions.ToJson();
+  if (apply_action.count > 0) ops["ApplyAction"] = apply_action.ToJson();
+  if (chance_outcomes.count > 0) {
+    ops["ChanceOutcomes"] = chance_outcomes.ToJson();
+  }
+  if (observation_tensor.count > 0) {
+    ops["ObservationTensor"] = observation_tensor.ToJson();
+  }
+  if (information_state_string.count > 0) {
+    ops["InformationStateString"] = information_state_string.ToJson();
+  }
+  return {{"game", game.ToString()},
+          {"num_states", static_cast<int64_t>(states.size())},
+          {"ops", ops}};
+}
+
+std::vector<std::string> GamesToBenchmark() {
+  const std::string games = absl::GetFlag(FLAGS_games);
+  if (!games.empty()) return absl::StrSplit(games, ',');
+  std::vector<std::string> names;
+  for (const GameType& type : RegisteredGameTypes()) {
+    if (type.default_loadable && !type.ContainsRequiredParameters()) {
+      names.push_back(type.short_name);
+    }
+  }
+  return names;
+}
+
+}  // namespace
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+  std::mt19937 rng(absl::GetFlag(FLAGS_seed));
+
+  open_spiel::json::Array results;
+  for (const std::string& game_name : open_spiel::GamesToBenchmark()) {
+    std::cerr << "Benchmarking " << game_name << std::endl;
+    std::shared_ptr<const open_spiel::Game> game =
+        open_spiel::LoadGame(game_name);
+    results.push_back(open_spiel::BenchmarkGame(*game, &rng));
+  }
+
+  const std::string json = open_spiel::json::ToString(
+      open_spiel::json::Object{
+          {"rollouts", absl::GetFlag(FLAGS_rollouts)},
+          {"max_states", absl::GetFlag(FLAGS_max_states)},
+          {"repetitions", absl::GetFlag(FLAGS_repetitions)},
+          {"seed", absl::GetFlag(FLAGS_seed)},
+          {"games", results}},
+      /*wrap=*/true);
+  if (absl::GetFlag(FLAGS_output).empty()) {
+    std::cout << json << std::endl;
+  } else {
+    open_spiel::file::File(absl::GetFlag(FLAGS_output), "w").Write(json);
+  }
+}
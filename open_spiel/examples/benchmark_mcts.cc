@@ -0,0 +1,199 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Throughput benchmark of MCTSBot, on a fixed set of positions per game.
+//
+// Each position is searched with a RandomRolloutEvaluator, and with an
+// evaluator returning constant values, which leaves the cost of the tree
+// itself. For each game, position and evaluator this reports the simulations
+// and nodes per second, the peak memory of the tree and the time spent
+// garbage collecting it, as JSON, e.g.:
+//
+//   benchmark_mcts --games=connect_four --max_simulations=100000
+//
+// The positions are fixed so that the results of different versions of the
+// search can be compared.
+
+#include <sys/resource.h>
+
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/flags/flag.h"
+#include "open_spiel/abseil-cpp/absl/flags/parse.h"
+#include "open_spiel/abseil-cpp/absl/strings/str_split.h"
+#include "open_spiel/abseil-cpp/absl/time/time.h"
+#include "open_spiel/algorithms/mcts.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/file.h"
+#include "open_spiel/utils/json.h"
+
+ABSL_FLAG(std::string, games, "tic_tac_toe,connect_four,breakthrough",
+          "Comma-separated list of games to benchmark. Games without fixed "
+          "positions below are searched from their initial state.");
+ABSL_FLAG(int, max_simulations, 10000, "Simulations per search.");
+ABSL_FLAG(int, repetitions, 1, "How many times to search each position.");
+ABSL_FLAG(int, rollout_count, 1, "Rollouts per random rollout evaluation.");
+ABSL_FLAG(double, uct_c, 2, "UCT exploration constant.");
+ABSL_FLAG(int, max_memory_mb, 1000,
+          "The memory limit of the tree, beyond which it is garbage "
+          "collected.");
+ABSL_FLAG(bool, solve, false,
+          "Whether to use MCTS-Solver. Solved positions stop their searches "
+          "early.");
+ABSL_FLAG(int, num_threads, 1, "How many threads to search with.");
+ABSL_FLAG(int, seed, 0, "Seed of the searches and rollouts.");
+ABSL_FLAG(std::string, output, "", "File to write the JSON to, or stdout.");
+
+namespace open_spiel {
+namespace {
+
+// The positions searched for each game, as serialized by State::Serialize.
+const std::map<std::string, std::vector<std::string>>& BenchmarkPositions() {
+  static const auto* positions =
+      new std::map<std::string, std::vector<std::string>>{
+          {"tic_tac_toe", {"", "0\n5\n", "7\n6\n1\n4\n"}},
+          {"connect_four",
+           {".......\n.......\n.......\n.......\n.......\n.......\n",
+            ".......\n.......\n.......\n...x...\n...o..o\n.o.x..x\n",
+            ".......\n.......\n...o...\n...x...\n..xo.o.\n.oxx.xo\n"}},
+          {"breakthrough",
+           {"bbbbbbbbbbbbbbbb................................wwwwwwwwwwwwwwww",
+            "bbb.bbbbbbb.bb.b..bb..b...............w..ww.....w.w.www."
+            "wwwwwwww",
+            "b.bbbb.bbbb..bbb.w.........bbb...w.w.....w...bw.w.w..www."
+            "wwwww.w"}},
+      };
+  return *positions;
+}
+
+// Values every state as a draw, with uniform priors, so that searches only
+// cost the tree and the moves down it.
+class ConstantEvaluator : public algorithms::Evaluator {
+ public:
+  std::vector<double> Evaluate(const State& state) override {
+    return std::vector<double>(state.NumPlayers(), 0);
+  }
+
+  ActionsAndProbs Prior(const State& state) override {
+    if (state.IsChanceNode()) return state.ChanceOutcomes();
+    const std::vector<Action> actions = state.LegalActions();
+    ActionsAndProbs prior;
+    prior.reserve(actions.size());
+    for (Action action : actions) {
+      prior.emplace_back(action, 1.0 / actions.size());
+    }
+    return prior;
+  }
+};
+
+json::Object BenchmarkSearch(const Game& game, const State& state,
+                             std::shared_ptr<algorithms::Evaluator> evaluator) {
+  algorithms::MCTSBot bot(
+      game, std::move(evaluator), absl::GetFlag(FLAGS_uct_c),
+      absl::GetFlag(FLAGS_max_simulations), absl::GetFlag(FLAGS_max_memory_mb),
+      absl::GetFlag(FLAGS_solve), absl::GetFlag(FLAGS_seed),
+      /*verbose=*/false, algorithms::ChildSelectionPolicy::UCT,
+      /*dirichlet_alpha=*/0, /*dirichlet_epsilon=*/0,
+      absl::GetFlag(FLAGS_num_threads));
+  bot.SetProfiling(true);
+  for (int i = 0; i < absl::GetFlag(FLAGS_repetitions); ++i) {
+    bot.MCTSearch(state);
+  }
+  const algorithms::MCTSProfile profile = bot.TakeProfile();
+  const double seconds = absl::ToDoubleSeconds(profile.search_time);
+  const double node_mb = sizeof(algorithms::SearchNode) / double{1 << 20};
+  return {{"searches", profile.searches},
+          {"simulations", profile.simulations},
+          {"nodes", profile.nodes},
+          {"search_ms", seconds * 1000},
+          {"simulations_per_second", profile.simulations / seconds},
+          {"nodes_per_second", profile.nodes / seconds},
+          {"peak_tree_mb", profile.peak_nodes * node_mb},
+          {"garbage_collections", profile.garbage_collections},
+          {"gc_ms", absl::ToDoubleMilliseconds(profile.gc_time)}};
+}
+
+json::Object BenchmarkGame(const std::string& game_name) {
+  std::shared_ptr<const Game> game = LoadGame(game_name);
+  std::vector<std::string> positions = {game->NewInitialState()->Serialize()};
+  auto it = BenchmarkPositions().find(game_name);
+  if (it != BenchmarkPositions().end()) positions = it->second;
+
+  json::Array results;
+  for (const std::string& position : positions) {
+    std::unique_ptr<State> state = game->DeserializeState(position);
+    SPIEL_CHECK_FALSE(state->IsTerminal());
+    json::Object evaluators = {
+        {"random_rollout",
+         BenchmarkSearch(*game, *state,
+                         std::make_shared<algorithms::RandomRolloutEvaluator>(
+                             absl::GetFlag(FLAGS_rollout_count),
+                             absl::GetFlag(FLAGS_seed)))},
+        {"constant", BenchmarkSearch(*game, *state,
+                                     std::make_shared<ConstantEvaluator>())}};
+    results.push_back(json::Object{{"position", position},
+                                   {"evaluators", evaluators}});
+  }
+  return {{"game", game->ToString()}, {"positions", results}};
+}
+
+// The peak resident memory of the process so far.
+double MaxResidentMb() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+  return usage.ru_maxrss / double{1 << 20};  // In bytes.
+#else
+  return usage.ru_maxrss / double{1 << 10};  // In kilobytes.
+#endif
+}
+
+}  // namespace
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+
+  open_spiel::json::Array results;
+  for (absl::string_view game_name :
+       absl::StrSplit(absl::GetFlag(FLAGS_games), ',', absl::SkipEmpty())) {
+    std::cerr << "Benchmarking " << game_name << std::endl;
+    results.push_back(open_spiel::BenchmarkGame(std::string(game_name)));
+  }
+
+  const std::string json = open_spiel::json::ToString(
+      open_spiel::json::Object{
+          {"max_simulations", absl::GetFlag(FLAGS_max_simulations)},
+          {"repetitions", absl::GetFlag(FLAGS_repetitions)},
+          {"rollout_count", absl::GetFlag(FLAGS_rollout_count)},
+          {"uct_c", absl::GetFlag(FLAGS_uct_c)},
+          {"max_memory_mb", absl::GetFlag(FLAGS_max_memory_mb)},
+          {"solve", absl::GetFlag(FLAGS_solve)},
+          {"num_threads", absl::GetFlag(FLAGS_num_threads)},
+          {"seed", absl::GetFlag(FLAGS_seed)},
+          {"games", results},
+          {"max_resident_mb", open_spiel::MaxResidentMb()}},
+      /*wrap=*/true);
+  if (absl::GetFlag(FLAGS_output).empty()) {
+    std::cout << json << std::endl;
+  } else {
+    open_spiel::file::File(absl::GetFlag(FLAGS_output), "w").Write(json);
+  }
+}
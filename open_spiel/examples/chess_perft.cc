@@ -0,0 +1,89 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// Move generation benchmark for chess: counts the leaves of the move tree of
+// standard test positions to a given depth (perft), and reports the number of
+// nodes per second, e.g.:
+//
+//   chess_perft --depth=5
+//   chess_perft --fen="8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1" --depth=6
+
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/flags/flag.h"
+#include "open_spiel/abseil-cpp/absl/flags/parse.h"
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/abseil-cpp/absl/time/clock.h"
+#include "open_spiel/abseil-cpp/absl/time/time.h"
+#include "open_spiel/games/chess/chess_board.h"
+#include "open_spiel/spiel_utils.h"
+
+ABSL_FLAG(std::string, fen, "",
+          "Position to count from. Defaults to the standard test positions.");
+ABSL_FLAG(int, depth, 4, "Depth of the move tree, in plies.");
+
+namespace open_spiel {
+namespace chess {
+namespace {
+
+// The positions of https://www.chessprogramming.org/Perft_Results.
+const std::vector<std::string>& DefaultPositions() {
+  static const auto* positions = new std::vector<std::string>{
+      "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+      "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+      "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+      "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+      "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+      "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 "
+      "10"};
+  return *positions;
+}
+
+void RunPerft(const std::vector<std::string>& fens, int depth) {
+  int64_t total_nodes = 0;
+  absl::Duration total_time;
+  for (const std::string& fen : fens) {
+    std::optional<StandardChessBoard> board =
+        StandardChessBoard::BoardFromFEN(fen);
+    if (!board) SpielFatalError(absl::StrCat("Invalid FEN: ", fen));
+    const absl::Time start = absl::Now();
+    const int64_t nodes = Perft(*board, depth);
+    const absl::Duration time = absl::Now() - start;
+    total_nodes += nodes;
+    total_time += time;
+    std::cout << fen << "\n  depth " << depth << ": " << nodes << " nodes in "
+              << absl::FormatDuration(time) << ", "
+              << nodes / absl::ToDoubleSeconds(time) << " nodes/s" << std::endl;
+  }
+  std::cout << "Total: " << total_nodes << " nodes in "
+            << absl::FormatDuration(total_time) << ", "
+            << total_nodes / absl::ToDoubleSeconds(total_time) << " nodes/s"
+            << std::endl;
+}
+
+}  // namespace
+}  // namespace chess
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+  const std::string fen = absl::GetFlag(FLAGS_fen);
+  open_spiel::chess::RunPerft(
+      fen.empty() ? open_spiel::chess::DefaultPositions()
+                  : std::vector<std::string>{fen},
+      absl::GetFlag(FLAGS_depth));
+}
@@ -12,21 +12,89 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
 #include<functional>
+#include <iostream>
+#include <iterator>
+#include <list>
 #include <map>
+#include <memory>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
 #include "open_spiel/abseil-cpp/absl/algorithm/container.h"
 #include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
 #include "open_spiel/abseil-cpp/absl/strings/str_join.h"
+#include "open_spiel/abseil-cpp/absl/strings/str_split.h"
+#include "open_spiel/abseil-cpp/absl/synchronization/mutex.h"
+#include "open_spiel/abseil-cpp/absl/time/clock.h"
+#include "open_spiel/abseil-cpp/absl/time/time.h"
 #include "open_spiel/algorithms/mcts.h"
 #include "open_spiel/abseil-cpp/absl/flags/flag.h"
 #include "open_spiel/abseil-cpp/absl/flags/parse.h"
+#include "open_spiel/game_parameters.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/thread.h"
+
+#ifdef OPEN_SPIEL_GTP_ALPHA_ZERO
+#include "open_spiel/algorithms/alpha_zero/device_manager.h"
+#include "open_spiel/algorithms/alpha_zero/vpevaluator.h"
+#include "open_spiel/algorithms/alpha_zero/vpnet.h"
+#endif
 
 ABSL_FLAG(std::string, game, "tic_tac_toe", "The name of the game to play.");
+ABSL_FLAG(int, max_simulations, 1000, "How many simulations to run per move.");
+ABSL_FLAG(double, move_time, 0,
+          "Seconds to think per move when the controller sends no time_left, "
+          "or 0 to only limit the number of simulations.");
+ABSL_FLAG(int, port, 0,
+          "If set, serve a GTP session to each connection on this TCP port, "
+          "instead of one session on stdin/stdout. The sessions share the "
+          "evaluator, but each has its own game and bot.");
+ABSL_FLAG(int, max_sessions, 1024,
+          "How many sessions the server plays at once. Connections beyond "
+          "that are refused.");
+
+#ifdef OPEN_SPIEL_GTP_ALPHA_ZERO
+// The AlphaZero net is trained for one game, so with --az_path the sessions
+// play --game only.
+ABSL_FLAG(std::string, az_path, "",
+          "If set, evaluate with the AlphaZero net in this directory, as "
+          "written by alpha_zero_example, instead of random rollouts.");
+ABSL_FLAG(std::string, az_graph_def, "vpnet.pb",
+          "The graph of the net, in --az_path.");
+ABSL_FLAG(std::string, az_checkpoint, "checkpoint--1",
+          "The checkpoint to load, in --az_path.");
+ABSL_FLAG(std::string, devices, "/cpu:0", "Comma separated list of devices.");
+ABSL_FLAG(int, inference_batch_size, 16,
+          "How many requests, from any session, an inference batch waits "
+          "for.");
+ABSL_FLAG(int, inference_threads, 2, "How many threads run inference.");
+ABSL_FLAG(double, inference_max_latency_ms, 1,
+          "How long an inference request may wait for a fuller batch.");
+ABSL_FLAG(int, inference_cache, 1 << 20,
+          "The size of the inference cache shared by all the sessions.");
+#endif
+
+// Without byo-yomi stones, the time left is shared by about that many moves.
+constexpr int kMovesToPlanFor = 30;
+// Fraction of the time budget kept as a safety margin for the communication.
+constexpr double kTimeMargin = 0.05;
+
+#ifdef MSG_NOSIGNAL
+constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+constexpr int kSendFlags = 0;
+#endif
 
 std::string Success() { return "=\n\n"; }
 std::string Success(const std::string& s) {
@@ -36,67 +104,158 @@ std::string Failure(const std::string& s) {
   return absl::StrCat("? ", s, "\n\n");
 }
 
-std::unique_ptr<open_spiel::Bot> MakeBot(
+bool UsesAlphaZero() {
+#ifdef OPEN_SPIEL_GTP_ALPHA_ZERO
+  return !absl::GetFlag(FLAGS_az_path).empty();
+#else
+  return false;
+#endif
+}
+
+std::unique_ptr<open_spiel::algorithms::MCTSBot> MakeBot(
     const open_spiel::Game& game,
     std::shared_ptr<open_spiel::algorithms::Evaluator> evaluator) {
+  const double move_time = absl::GetFlag(FLAGS_move_time);
+  // As AlphaZero's evaluators play.
+  const bool alpha_zero = UsesAlphaZero();
   return std::make_unique<open_spiel::algorithms::MCTSBot>(
-      game, std::move(evaluator), /*uct_c=*/2, /*max_simulations=*/1000,
-      /*max_memory_mb=*/0, /*solve=*/true, /*seed=*/0, /*verbose=*/false);
+      game, std::move(evaluator), /*uct_c=*/2,
+      absl::GetFlag(FLAGS_max_simulations),
+      /*max_memory_mb=*/0, /*solve=*/!alpha_zero, /*seed=*/0,
+      /*verbose=*/false,
+      alpha_zero ? open_spiel::algorithms::ChildSelectionPolicy::PUCT
+                 : open_spiel::algorithms::ChildSelectionPolicy::UCT,
+      /*dirichlet_alpha=*/0, /*dirichlet_epsilon=*/0, /*num_threads=*/1,
+      open_spiel::algorithms::ParallelismPolicy::TREE, /*reuse_tree=*/false,
+      /*leaf_batch_size=*/1,
+      move_time > 0 ? absl::Seconds(move_time) : absl::InfiniteDuration());
 }
 
-// Implements the Go Text Protocol, GTP, which is a text based protocol for
-// communication with computer Go programs
-// (https://www.lysator.liu.se/~gunnar/gtp/). This offers the open_spiel games
-// and the mcts bot as a command line gtp server, which can be played against
-// third party programs, or used on the command line directly.
-int main(int argc, char** argv) {
-  absl::ParseCommandLine(argc, argv);
+// Whether `params`, as parsed from a client's game string, name a registered
+// game, and only parameters which it takes, of the right types, including its
+// mandatory ones. LoadGame treats those mistakes as fatal, which in server mode
+// would end every session rather than fail the client's command.
+bool CheckGameParameters(const open_spiel::GameParameters& params,
+                         std::string* error) {
+  auto name = params.find("name");
+  if (name == params.end() || !name->second.has_string_value() ||
+      !open_spiel::IsGameRegistered(name->second.string_value())) {
+    *error = "Unknown game";
+    return false;
+  }
+  open_spiel::GameType game_type;
+  for (const open_spiel::GameType& type : open_spiel::RegisteredGameTypes()) {
+    if (type.short_name == name->second.string_value()) game_type = type;
+  }
+  for (const auto& [key, value] : params) {
+    if (key == "name") continue;
+    auto spec = game_type.parameter_specification.find(key);
+    if (spec == game_type.parameter_specification.end()) {
+      *error = absl::StrCat("Unknown parameter ", key);
+      return false;
+    }
+    if (value.type() != spec->second.type() &&
+        !(value.type() == open_spiel::GameParameter::Type::kInt &&
+          spec->second.type() == open_spiel::GameParameter::Type::kDouble)) {
+      *error = absl::StrCat("Wrong type for parameter ", key);
+      return false;
+    }
+    if (value.type() == open_spiel::GameParameter::Type::kGame &&
+        !CheckGameParameters(value.game_value(), error)) {
+      return false;
+    }
+  }
+  for (const auto& [key, spec] : game_type.parameter_specification) {
+    if (spec.is_mandatory() && params.find(key) == params.end()) {
+      *error = absl::StrCat("Missing parameter ", key);
+      return false;
+    }
+  }
+  return true;
+}
 
-  std::string game_name = absl::GetFlag(FLAGS_game);
-  std::shared_ptr<const open_spiel::Game> game =
-      open_spiel::LoadGame(game_name);
+// One game played over GTP: the state of the game, the bot playing it and
+// the time left, as set by the controller. The server plays many sessions at
+// once, one per connection, which only share the evaluator.
+class GtpSession {
+ public:
+  // With fixed_game, the commands changing the game are refused, as for an
+  // evaluator which only knows --game.
+  GtpSession(std::shared_ptr<open_spiel::algorithms::Evaluator> evaluator,
+             bool fixed_game);
 
-  std::unique_ptr<open_spiel::State> state = game->NewInitialState();
+  GtpSession(const GtpSession&) = delete;
+  GtpSession& operator=(const GtpSession&) = delete;
 
-  auto evaluator =
-      std::make_shared<open_spiel::algorithms::RandomRolloutEvaluator>(
-      /*n_rollouts=*/1, /*seed=*/0);
-  std::unique_ptr<open_spiel::Bot> bot = MakeBot(*game, evaluator);
+  // Runs one command, returning the response. Sets `quit` after "quit".
+  std::string Execute(const std::string& line, bool* quit);
 
+ private:
   using Args = std::vector<std::string>;
-  std::map<std::string, std::function<std::string(const Args&)>> cmds = {
+
+  // Switches to the game, if it's valid and the client may change the game.
+  // Otherwise returns false, with the reason in `error`.
+  bool SetGame(const open_spiel::GameParameters& params, std::string* error);
+
+  std::shared_ptr<open_spiel::algorithms::Evaluator> evaluator_;
+  const bool fixed_game_;
+  std::shared_ptr<const open_spiel::Game> game_;
+  std::unique_ptr<open_spiel::State> state_;
+  std::unique_ptr<open_spiel::algorithms::MCTSBot> bot_;
+
+  // As last set by time_left, time_left_seconds_ being negative until then.
+  double time_left_seconds_ = -1;
+  int stones_left_ = 0;
+
+  std::map<std::string, std::function<std::string(const Args&)>> cmds_;
+};
+
+GtpSession::GtpSession(
+    std::shared_ptr<open_spiel::algorithms::Evaluator> evaluator,
+    bool fixed_game)
+    : evaluator_(std::move(evaluator)),
+      fixed_game_(fixed_game),
+      game_(open_spiel::LoadGame(absl::GetFlag(FLAGS_game))),
+      state_(game_->NewInitialState()),
+      bot_(MakeBot(*game_, evaluator_)) {
+  cmds_ = {
     {"name", [](const Args&) { return Success("open_spiel"); }},
     {"version", [](const Args&) { return Success("unknown"); }},
     {"protocol_version", [](const Args&) { return Success("2"); }},
     {"quit", [](const Args&) { return Success(); }},
-    {"list_commands", [&cmds](const Args& args) {
+    {"list_commands", [this](const Args& args) {
       std::vector<std::string> keys;
-      keys.reserve(cmds.size());
-      for (auto const& item : cmds) {
+      keys.reserve(cmds_.size());
+      for (auto const& item : cmds_) {
         keys.push_back(item.first);
       }
       return Success(absl::StrJoin(keys, " "));
     }},
-    {"known_command", [&cmds](const Args& args) {
+    {"known_command", [this](const Args& args) {
       if (args.empty()) {
         return Failure("Not enough args");
       }
-      return Success(cmds.find(args[0]) == cmds.end() ? "false" : "true");
+      return Success(cmds_.find(args[0]) == cmds_.end() ? "false" : "true");
     }},
     {"known_games", [](const Args& args) {
       return Success(absl::StrJoin(open_spiel::RegisteredGames(), " "));
     }},
-    {"game", [&bot, &game, &state, &evaluator](const Args& args) {
+    {"game", [this](const Args& args) {
       if (args.empty()) {
-        return Success(game->ToString());
+        return Success(game_->ToString());
       }
-      game = open_spiel::LoadGame(args[0]);
-      state = game->NewInitialState();
-      bot = MakeBot(*game, evaluator);
-      return Success(game->ToString());
+      open_spiel::GameParameters params;
+      try {
+        params = open_spiel::GameParametersFromString(args[0]);
+      } catch (const std::logic_error&) {  // From std::stoi and std::stod.
+        return Failure("Failed to parse the game");
+      }
+      std::string error;
+      if (!SetGame(params, &error)) return Failure(error);
+      return Success(game_->ToString());
     }},
-    {"boardsize", [&bot, &game, &state, &evaluator](const Args& args) {
-      open_spiel::GameParameters params = game->GetParameters();
+    {"boardsize", [this](const Args& args) {
+      open_spiel::GameParameters params = game_->GetParameters();
       if (params.find("board_size") == params.end()) {
         return Failure("Game doesn't support setting the board size");
       }
@@ -104,47 +263,79 @@ int main(int argc, char** argv) {
         return Success(params["board_size"].ToString());
       }
       int board_size;
-      if (!absl::SimpleAtoi(args[0], &board_size)) {
-        return Failure("Failed to parse first arg as an int");
+      if (!absl::SimpleAtoi(args[0], &board_size) || board_size <= 0) {
+        return Failure("Failed to parse first arg as a positive int");
       }
       params["board_size"] = open_spiel::GameParameter(board_size);
-      game = open_spiel::LoadGame(game->GetType().short_name, params);
-      state = game->NewInitialState();
-      bot = MakeBot(*game, evaluator);
+      params["name"] = open_spiel::GameParameter(game_->GetType().short_name);
+      std::string error;
+      if (!SetGame(params, &error)) return Failure(error);
       return Success();
     }},
-    {"play", [&bot, &state](const Args& args) {
+    {"play", [this](const Args& args) {
       if (args.size() < 2) {
         return Failure("Not enough args");
       }
       // Ignore player arg, assume it's always the current player.
       const std::string& action_str = args[1];
-      for (const open_spiel::Action action : state->LegalActions()) {
-        if (action_str == state->ActionToString(action)) {
-          bot->InformAction(*state, state->CurrentPlayer(), action);
-          state->ApplyAction(action);
+      for (const open_spiel::Action action : state_->LegalActions()) {
+        if (action_str == state_->ActionToString(action)) {
+          bot_->InformAction(*state_, state_->CurrentPlayer(), action);
+          state_->ApplyAction(action);
           return Success();
         }
       }
       return Failure("Invalid action");
     }},
-    {"genmove", [&bot, &state](const Args& args) {
-      if (state->IsTerminal()) {
+    {"time_settings", [](const Args& args) {
+      // The controller sends the time left before each move, see time_left.
+      if (args.size() < 3) {
+        return Failure("Not enough args");
+      }
+      return Success();
+    }},
+    {"time_left", [this](const Args& args) {
+      // Ignore color arg, assume it's always the current player.
+      if (args.size() < 3) {
+        return Failure("Not enough args");
+      }
+      if (!absl::SimpleAtod(args[1], &time_left_seconds_) ||
+          !absl::SimpleAtoi(args[2], &stones_left_)) {
+        return Failure("Failed to parse the time and stones left");
+      }
+      return Success();
+    }},
+    {"genmove", [this](const Args& args) {
+      if (state_->IsTerminal()) {
         return Failure("Game is already over");
       }
       // Ignore player arg, assume it's always the current player.
-      open_spiel::Action action = bot->Step(*state);
-      std::string action_str = state->ActionToString(action);
-      state->ApplyAction(action);
+      open_spiel::Action action;
+      if (time_left_seconds_ < 0) {
+        action = bot_->Step(*state_);
+      } else {
+        // Spread the time left over the stones left of the byo-yomi period,
+        // or over the rest of the game.
+        const double budget =
+            (1 - kTimeMargin) * time_left_seconds_ /
+            (stones_left_ > 0 ? stones_left_ : kMovesToPlanFor);
+        std::unique_ptr<open_spiel::algorithms::SearchNode> root =
+            bot_->MCTSearchUntil(*state_, absl::Now() + absl::Seconds(budget));
+        // Without the time for a single expansion, play any legal move.
+        action = root->children.empty() ? state_->LegalActions()[0]
+                                        : root->BestChild().action;
+      }
+      std::string action_str = state_->ActionToString(action);
+      state_->ApplyAction(action);
       return Success(action_str);
     }},
-    {"clear_board", [&bot, &game, &state](const Args& args) {
-      state = game->NewInitialState();
-      bot->Restart();
+    {"clear_board", [this](const Args& args) {
+      state_ = game_->NewInitialState();
+      bot_->Restart();
       return Success();
     }},
-    {"undo", [&bot, &game, &state](const Args& args) {
-      std::vector<open_spiel::Action> history = state->History();
+    {"undo", [this](const Args& args) {
+      std::vector<open_spiel::Action> history = state_->History();
       int count = 1;
       if (!args.empty() && !absl::SimpleAtoi(args[0], &count)) {
         return Failure("Failed to parse first arg as an int");
@@ -154,58 +345,249 @@ int main(int argc, char** argv) {
             "Can't undo ", count, " moves from game of length ",
             history.size()));
       }
-      state = game->NewInitialState();
-      bot->Restart();
+      state_ = game_->NewInitialState();
+      bot_->Restart();
       for (int i = 0; i < history.size() - count; ++i) {
-        bot->InformAction(*state, state->CurrentPlayer(), history[i]);
-        state->ApplyAction(history[i]);
+        bot_->InformAction(*state_, state_->CurrentPlayer(), history[i]);
+        state_->ApplyAction(history[i]);
       }
       return Success();
     }},
-    {"showboard", [&state](const Args& args) {
-      return Success("\n" + state->ToString());
+    {"showboard", [this](const Args& args) {
+      return Success("\n" + state_->ToString());
     }},
-    {"history", [&state](const Args& args) {
-      return Success(state->HistoryString());
+    {"history", [this](const Args& args) {
+      return Success(state_->HistoryString());
     }},
-    {"is_terminal", [&state](const Args& args) {
-      return Success(state->IsTerminal() ? "true" : "false");
+    {"is_terminal", [this](const Args& args) {
+      return Success(state_->IsTerminal() ? "true" : "false");
     }},
-    {"current_player", [&state](const Args& args) {
-      return Success(absl::StrCat(state->CurrentPlayer()));
+    {"current_player", [this](const Args& args) {
+      return Success(absl::StrCat(state_->CurrentPlayer()));
     }},
-    {"returns", [&state](const Args& args) {
-      return Success(absl::StrJoin(state->Returns(), " "));
+    {"returns", [this](const Args& args) {
+      return Success(absl::StrJoin(state_->Returns(), " "));
     }},
-    {"legal_actions", [&state](const Args& args) {
+    {"legal_actions", [this](const Args& args) {
       std::vector<std::string> actions;
-      std::vector<open_spiel::Action> legal_actions = state->LegalActions();
+      std::vector<open_spiel::Action> legal_actions = state_->LegalActions();
       actions.reserve(legal_actions.size());
       for (const open_spiel::Action action : legal_actions) {
-        actions.push_back(state->ActionToString(action));
+        actions.push_back(state_->ActionToString(action));
       }
       return Success(absl::StrJoin(actions, " "));
     }},
   };
+}
 
-  std::cerr << "Welcome to OpenSpiel GTP interface. Try `list_commands`."
-            << std::endl << std::endl;
-  for (std::string line; std::getline(std::cin, line);) {
-    std::vector<std::string> parts = absl::StrSplit(line, ' ');
-    if (parts.empty()) continue;
-    std::string& cmd = parts[0];
-
-    auto cmd_it = cmds.find(cmd);
-    if (cmd_it == cmds.end()) {
-      std::cout << Failure("unknown command");
+bool GtpSession::SetGame(const open_spiel::GameParameters& params,
+                         std::string* error) {
+  if (fixed_game_) {
+    if (open_spiel::GameParametersToString(params) == game_->ToString()) {
+      state_ = game_->NewInitialState();
+      bot_->Restart();
+      return true;
+    }
+    *error = absl::StrCat("This server only plays ", game_->ToString());
+    return false;
+  }
+  if (!CheckGameParameters(params, error)) return false;
+  game_ = open_spiel::LoadGame(params);
+  state_ = game_->NewInitialState();
+  bot_ = MakeBot(*game_, evaluator_);
+  return true;
+}
+
+std::string GtpSession::Execute(const std::string& line, bool* quit) {
+  std::vector<std::string> parts = absl::StrSplit(line, ' ');
+  std::string& cmd = parts[0];
+
+  auto cmd_it = cmds_.find(cmd);
+  if (cmd_it == cmds_.end()) {
+    return Failure("unknown command");
+  }
+
+  Args args(parts.begin() + 1, parts.end());
+  *quit = cmd == "quit";
+  return cmd_it->second(args);
+}
+
+void SendAll(int socket, const std::string& data) {
+  for (size_t sent = 0; sent < data.size();) {
+    const ssize_t n =
+        send(socket, data.data() + sent, data.size() - sent, kSendFlags);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) return;  // The reads notice the connection closing.
+    sent += n;
+  }
+}
+
+// Reads the next line from the socket, without its end of line, keeping what
+// follows it in `buffer`. Returns false once the connection is closed.
+bool ReceiveLine(int socket, std::string* buffer, std::string* line) {
+  size_t end;
+  while ((end = buffer->find('\n')) == std::string::npos) {
+    char data[4096];
+    const ssize_t n = recv(socket, data, sizeof(data), 0);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) return false;
+    buffer->append(data, n);
+  }
+  line->assign(*buffer, 0, end);
+  buffer->erase(0, end + 1);
+  if (!line->empty() && line->back() == '\r') line->pop_back();
+  return true;
+}
+
+// Plays one session with the controller at the other end of the socket, until
+// it quits or disconnects.
+void ServeSession(
+    int socket, std::shared_ptr<open_spiel::algorithms::Evaluator> evaluator) {
+  const int one = 1;
+  setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+  GtpSession session(std::move(evaluator), /*fixed_game=*/UsesAlphaZero());
+  std::string buffer;
+  bool quit = false;
+  for (std::string line; !quit && ReceiveLine(socket, &buffer, &line);) {
+    if (line.empty()) continue;
+    SendAll(socket, session.Execute(line, &quit));
+  }
+  close(socket);
+}
+
+int Listen(int port) {
+  addrinfo hints{};
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+  hints.ai_flags = AI_PASSIVE;
+  addrinfo* info;
+  if (getaddrinfo(nullptr, absl::StrCat(port).c_str(), &hints, &info) != 0) {
+    open_spiel::SpielFatalError(absl::StrCat("Bad port ", port));
+  }
+  const int listener =
+      socket(info->ai_family, info->ai_socktype, info->ai_protocol);
+  const int one = 1;
+  if (listener < 0 ||
+      setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one)) ||
+      bind(listener, info->ai_addr, info->ai_addrlen) != 0 ||
+      listen(listener, SOMAXCONN) != 0) {
+    open_spiel::SpielFatalError(absl::StrCat(
+        "Can't listen on port ", port, ": ", std::strerror(errno)));
+  }
+  freeaddrinfo(info);
+  return listener;
+}
+
+// Serves a session to each connection on the port, each on its own thread, so
+// that a slow search only delays its own game. With an evaluator that batches
+// the requests of concurrent searches, like AlphaZero's VPNetEvaluator, the
+// sessions' searches also share its batches and cache.
+void Serve(int port,
+           std::shared_ptr<open_spiel::algorithms::Evaluator> evaluator) {
+  struct Session {
+    std::unique_ptr<open_spiel::Thread> thread;
+    bool done = false;
+  };
+  absl::Mutex mutex;
+  std::list<Session> sessions;  // Guarded by mutex.
+  int num_done = 0;  // Guarded by mutex.
+  const int max_sessions = absl::GetFlag(FLAGS_max_sessions);
+
+  // Joins the sessions as they end, rather than on the next connection.
+  open_spiel::Thread reaper([&]() {
+    while (true) {
+      std::list<Session> ended;
+      {
+        absl::MutexLock lock(&mutex);
+        mutex.Await(absl::Condition(
+            +[](int* num_done) { return *num_done > 0; }, &num_done));
+        for (auto it = sessions.begin(); it != sessions.end();) {
+          auto next = std::next(it);
+          if (it->done) ended.splice(ended.end(), sessions, it);
+          it = next;
+        }
+        num_done = 0;
+      }
+      for (Session& session : ended) session.thread->join();
+    }
+  });
+
+  const int listener = Listen(port);
+  std::cerr << "Serving GTP on port " << port << std::endl;
+  while (true) {
+    const int socket = accept(listener, nullptr, nullptr);
+    if (socket < 0) {
+      if (errno == EINTR || errno == ECONNABORTED) continue;
+      open_spiel::SpielFatalError(
+          absl::StrCat("accept failed: ", std::strerror(errno)));
+    }
+    absl::MutexLock lock(&mutex);
+    if (static_cast<int>(sessions.size()) - num_done >= max_sessions) {
+      SendAll(socket, Failure("too many sessions"));
+      close(socket);
       continue;
     }
+    // The session stays at this address when the reaper takes it.
+    Session* session = &sessions.emplace_back();
+    session->thread = std::make_unique<open_spiel::Thread>(
+        [socket, evaluator, session, &mutex, &num_done]() {
+          ServeSession(socket, evaluator);
+          absl::MutexLock lock(&mutex);
+          session->done = true;
+          ++num_done;
+        });
+  }
+}
+
+// Implements the Go Text Protocol, GTP, which is a text based protocol for
+// communication with computer Go programs
+// (https://www.lysator.liu.se/~gunnar/gtp/). This offers the open_spiel games
+// and the mcts bot as a command line gtp server, which can be played against
+// third party programs, or used on the command line directly. With --port, it
+// serves many games at once over TCP instead.
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
 
-    Args args(parts.begin() + 1, parts.end());
-    std::cout << cmd_it->second(args);
-    if (cmd == "quit") {
-      break;
+  std::shared_ptr<open_spiel::algorithms::Evaluator> evaluator =
+      std::make_shared<open_spiel::algorithms::RandomRolloutEvaluator>(
+      /*n_rollouts=*/1, /*seed=*/0);
+#ifdef OPEN_SPIEL_GTP_ALPHA_ZERO
+  // One net, inference queue and cache for all the sessions, so that the
+  // requests of their searches are batched together.
+  open_spiel::algorithms::DeviceManager device_manager;
+  if (UsesAlphaZero()) {
+    std::shared_ptr<const open_spiel::Game> game =
+        open_spiel::LoadGame(absl::GetFlag(FLAGS_game));
+    const std::string az_path = absl::GetFlag(FLAGS_az_path);
+    for (absl::string_view device :
+         absl::StrSplit(absl::GetFlag(FLAGS_devices), ',')) {
+      device_manager.AddDevice(open_spiel::algorithms::VPNetModel(
+          *game, az_path, absl::GetFlag(FLAGS_az_graph_def),
+          std::string(device)));
+    }
+    for (int i = 0; i < device_manager.Count(); ++i) {
+      device_manager.LoadCheckpoint(
+          i, absl::StrCat(az_path, "/", absl::GetFlag(FLAGS_az_checkpoint)));
     }
+    evaluator = std::make_shared<open_spiel::algorithms::VPNetEvaluator>(
+        &device_manager, absl::GetFlag(FLAGS_inference_batch_size),
+        absl::GetFlag(FLAGS_inference_threads),
+        absl::GetFlag(FLAGS_inference_cache), /*cache_shards=*/16,
+        absl::Milliseconds(absl::GetFlag(FLAGS_inference_max_latency_ms)));
+  }
+#endif
+
+  if (absl::GetFlag(FLAGS_port) > 0) {
+    Serve(absl::GetFlag(FLAGS_port), evaluator);
+    return 0;
+  }
+
+  GtpSession session(evaluator, /*fixed_game=*/UsesAlphaZero());
+  std::cerr << "Welcome to OpenSpiel GTP interface. Try `list_commands`."
+            << std::endl << std::endl;
+  bool quit = false;
+  for (std::string line; !quit && std::getline(std::cin, line);) {
+    std::cout << session.Execute(line, &quit);
   }
   return 0;
 }
@@ -34,6 +34,8 @@ ABSL_FLAG(std::string, player1, "mcts", "Who controls player1.");
 ABSL_FLAG(std::string, player2, "random", "Who controls player2.");
 ABSL_FLAG(double, uct_c, 2, "UCT exploration constant.");
 ABSL_FLAG(int, rollout_count, 10, "How many rollouts per evaluation.");
+ABSL_FLAG(int, rollout_threads, 1,
+          "How many threads share the rollouts of each evaluation.");
 ABSL_FLAG(int, max_simulations, 10000, "How many simulations to run.");
 ABSL_FLAG(int, num_games, 1, "How many games to play.");
 ABSL_FLAG(int, max_memory_mb, 1000,
@@ -42,6 +44,11 @@ ABSL_FLAG(bool, solve, true, "Whether to use MCTS-Solver.");
 ABSL_FLAG(uint_fast32_t, seed, 0, "Seed for MCTS.");
 ABSL_FLAG(bool, verbose, false, "Show the MCTS stats of possible moves.");
 ABSL_FLAG(bool, quiet, false, "Show the MCTS stats of possible moves.");
+ABSL_FLAG(int, num_threads, 1, "How many threads to search with.");
+ABSL_FLAG(bool, root_parallel, false,
+          "Whether the threads build independent trees, or share one.");
+ABSL_FLAG(bool, reuse_tree, false,
+          "Whether to continue the search from the previous move's tree.");
 
 uint_fast32_t Seed() {
   uint_fast32_t seed = absl::GetFlag(FLAGS_seed);
@@ -60,7 +67,14 @@ std::unique_ptr<open_spiel::Bot> InitBot(
         game, std::move(evaluator), absl::GetFlag(FLAGS_uct_c),
         absl::GetFlag(FLAGS_max_simulations),
         absl::GetFlag(FLAGS_max_memory_mb), absl::GetFlag(FLAGS_solve), Seed(),
-        absl::GetFlag(FLAGS_verbose));
+        absl::GetFlag(FLAGS_verbose),
+        open_spiel::algorithms::ChildSelectionPolicy::UCT,
+        /*dirichlet_alpha=*/0, /*dirichlet_epsilon=*/0,
+        absl::GetFlag(FLAGS_num_threads),
+        absl::GetFlag(FLAGS_root_parallel)
+            ? open_spiel::algorithms::ParallelismPolicy::ROOT
+            : open_spiel::algorithms::ParallelismPolicy::TREE,
+        absl::GetFlag(FLAGS_reuse_tree));
   }
   open_spiel::SpielFatalError("Bad player type. Known types: mcts, random");
 }
@@ -151,7 +165,8 @@ int main(int argc, char** argv) {
 
   auto evaluator =
       std::make_shared<open_spiel::algorithms::RandomRolloutEvaluator>(
-          absl::GetFlag(FLAGS_rollout_count), Seed());
+          absl::GetFlag(FLAGS_rollout_count), Seed(),
+          absl::GetFlag(FLAGS_rollout_threads));
 
   std::vector<std::unique_ptr<open_spiel::Bot>> bots;
   bots.push_back(InitBot(absl::GetFlag(FLAGS_player1), *game, 0, evaluator));
@@ -0,0 +1,138 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Reports the memory taken by the states of every registered game, over the
+// states of random games: the average and largest ApproximateMemoryUsage(),
+// and the heap bytes a Clone() allocates, e.g.:
+//
+//   state_memory_report --games=chess,go --rollouts=20
+//
+// The last column is the ratio of the two. Far from 1, it points at a game
+// whose ApproximateMemoryUsage misses what its states own, which is then
+// also missed by the memory accounting of MCTSBot.
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/flags/flag.h"
+#include "open_spiel/abseil-cpp/absl/flags/parse.h"
+#include "open_spiel/abseil-cpp/absl/strings/str_format.h"
+#include "open_spiel/abseil-cpp/absl/strings/str_split.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/tests/allocation_counter.h"
+
+ABSL_FLAG(std::string, games, "",
+          "Comma-separated list of games to report on. Defaults to all the "
+          "registered games that can be loaded without parameters.");
+ABSL_FLAG(int, rollouts, 10, "Random games played from each initial state.");
+ABSL_FLAG(int, max_states, 1000, "Maximum number of states per game.");
+ABSL_FLAG(int, seed, 0, "Seed of the random games.");
+
+namespace open_spiel {
+namespace {
+
+// The average and largest of some byte counts.
+struct ByteStats {
+  void Add(int64_t bytes) {
+    ++count;
+    total += bytes;
+    max = std::max(max, bytes);
+  }
+  double Mean() const {
+    return count == 0 ? 0 : static_cast<double>(total) / count;
+  }
+
+  int64_t count = 0;
+  int64_t total = 0;
+  int64_t max = 0;
+};
+
+// One action per player at simultaneous nodes, a single action otherwise.
+void ApplyRandomAction(State* state, std::mt19937* rng) {
+  if (state->IsChanceNode()) {
+    state->ApplyAction(SampleAction(state->ChanceOutcomes(), *rng).first);
+    return;
+  }
+  auto uniform = [rng](const std::vector<Action>& actions) {
+    if (actions.empty()) return kInvalidAction;
+    return actions[std::uniform_int_distribution<int>(0, actions.size() - 1)(
+        *rng)];
+  };
+  if (state->IsSimultaneousNode()) {
+    std::vector<Action> joint_action;
+    for (Player p = 0; p < state->NumPlayers(); ++p) {
+      joint_action.push_back(uniform(state->LegalActions(p)));
+    }
+    state->ApplyActions(joint_action);
+  } else {
+    state->ApplyAction(uniform(state->LegalActions()));
+  }
+}
+
+void ReportGame(const std::string& game_name, std::mt19937* rng) {
+  std::shared_ptr<const Game> game = LoadGame(game_name);
+  const int max_states = absl::GetFlag(FLAGS_max_states);
+  ByteStats state_bytes, clone_bytes;
+  for (int i = 0; i < absl::GetFlag(FLAGS_rollouts); ++i) {
+    std::unique_ptr<State> state = game->NewInitialState();
+    while (state_bytes.count < max_states) {
+      state_bytes.Add(state->ApproximateMemoryUsage());
+      testing::AllocationCounter counter;
+      std::unique_ptr<State> clone = state->Clone();
+      clone_bytes.Add(counter.Bytes());
+      if (state->IsTerminal()) break;
+      ApplyRandomAction(state.get(), rng);
+    }
+  }
+  std::cout << absl::StrFormat(
+                   "%-30s %8d %12.0f %12d %12.0f %12d %6.2f", game_name,
+                   state_bytes.count, state_bytes.Mean(), state_bytes.max,
+                   clone_bytes.Mean(), clone_bytes.max,
+                   clone_bytes.Mean() / state_bytes.Mean())
+            << std::endl;
+}
+
+std::vector<std::string> GamesToReport() {
+  const std::string games = absl::GetFlag(FLAGS_games);
+  if (!games.empty()) return absl::StrSplit(games, ',');
+  std::vector<std::string> names;
+  for (const GameType& type : RegisteredGameTypes()) {
+    if (type.default_loadable && !type.ContainsRequiredParameters()) {
+      names.push_back(type.short_name);
+    }
+  }
+  return names;
+}
+
+}  // namespace
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+  std::mt19937 rng(absl::GetFlag(FLAGS_seed));
+
+  std::cout << absl::StrFormat("%-30s %8s %12s %12s %12s %12s %6s", "game",
+                               "states", "state_mean", "state_max",
+                               "clone_mean", "clone_max", "ratio")
+            << std::endl;
+  for (const std::string& game_name : open_spiel::GamesToReport()) {
+    open_spiel::ReportGame(game_name, &rng);
+  }
+}
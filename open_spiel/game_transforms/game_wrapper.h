@@ -15,6 +15,12 @@
 #ifndef OPEN_SPIEL_GAME_TRANSFORMS_GAME_WRAPPER_H_
 #define OPEN_SPIEL_GAME_TRANSFORMS_GAME_WRAPPER_H_
 
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/types/span.h"
 #include "open_spiel/spiel.h"
 
 // Wraps a game, forwarding everything to the original implementation.
@@ -73,7 +79,11 @@ class WrappedState : public State {
 
   void UndoAction(Player player, Action action) override {
     state_->UndoAction(player, action);
-    history_.pop_back();
+    PopHistory();
+  }
+
+  bool SupportsUndoAction() const override {
+    return state_->SupportsUndoAction();
   }
 
   ActionsAndProbs ChanceOutcomes() const override {
@@ -96,6 +106,135 @@ class WrappedState : public State {
   std::unique_ptr<State> state_;
 };
 
+// As WrappedState, for a transform which knows the concrete type of the
+// states it wraps. The wrapped state is held by value rather than behind a
+// pointer, so a clone is a single allocation, and since the dynamic type of
+// state_ is known, the forwarded calls can be devirtualized and inlined.
+// InnerState must be copyable.
+template <typename InnerState>
+class TypedWrappedState : public State {
+ public:
+  TypedWrappedState(std::shared_ptr<const Game> game, const InnerState& state)
+      : State(game), state_(state) {}
+  TypedWrappedState(const TypedWrappedState& other) = default;
+
+  Player CurrentPlayer() const override { return state_.CurrentPlayer(); }
+
+  std::vector<Action> LegalActions(Player player) const override {
+    return inner().LegalActions(player);
+  }
+
+  std::vector<Action> LegalActions() const override {
+    return inner().LegalActions();
+  }
+
+  void LegalActions(std::vector<Action>* actions) const override {
+    inner().LegalActions(actions);
+  }
+
+  Action SampleRandomLegalAction(absl::BitGenRef rng) const override {
+    return state_.SampleRandomLegalAction(rng);
+  }
+
+  std::string ActionToString(Player player, Action action_id) const override {
+    return state_.ActionToString(player, action_id);
+  }
+
+  std::string ToString() const override { return state_.ToString(); }
+
+  bool IsTerminal() const override { return state_.IsTerminal(); }
+
+  std::vector<double> Rewards() const override { return state_.Rewards(); }
+
+  std::vector<double> Returns() const override { return state_.Returns(); }
+
+  std::string InformationStateString(Player player) const override {
+    return state_.InformationStateString(player);
+  }
+
+  void InformationStateTensor(Player player,
+                              std::vector<double>* values) const override {
+    inner().InformationStateTensor(player, values);
+  }
+
+  void InformationStateTensor(Player player,
+                              absl::Span<float> values) const override {
+    inner().InformationStateTensor(player, values);
+  }
+
+  void InformationStateTensor(Player player,
+                              absl::Span<uint8_t> values) const override {
+    inner().InformationStateTensor(player, values);
+  }
+
+  void InformationStateTensor(Player player,
+                              SparseTensor* tensor) const override {
+    inner().InformationStateTensor(player, tensor);
+  }
+
+  std::string ObservationString(Player player) const override {
+    return state_.ObservationString(player);
+  }
+
+  void ObservationTensor(Player player,
+                         std::vector<double>* values) const override {
+    inner().ObservationTensor(player, values);
+  }
+
+  void ObservationTensor(Player player,
+                         absl::Span<float> values) const override {
+    inner().ObservationTensor(player, values);
+  }
+
+  void ObservationTensor(Player player,
+                         absl::Span<uint8_t> values) const override {
+    inner().ObservationTensor(player, values);
+  }
+
+  void ObservationTensor(Player player, SparseTensor* tensor) const override {
+    inner().ObservationTensor(player, tensor);
+  }
+
+  std::unique_ptr<State> Clone() const override = 0;
+
+  // Derived classes with members of their own must override this.
+  bool CopyFrom(const State& other) override {
+    *this = static_cast<const TypedWrappedState&>(other);
+    return true;
+  }
+
+  void UndoAction(Player player, Action action) override {
+    state_.UndoAction(player, action);
+    PopHistory();
+  }
+
+  bool SupportsUndoAction() const override {
+    return state_.SupportsUndoAction();
+  }
+
+  ActionsAndProbs ChanceOutcomes() const override {
+    return state_.ChanceOutcomes();
+  }
+
+  std::vector<Action> LegalChanceOutcomes() const override {
+    return state_.LegalChanceOutcomes();
+  }
+
+ protected:
+  void DoApplyAction(Action action_id) override {
+    state_.ApplyAction(action_id);
+  }
+
+  void DoApplyActions(const std::vector<Action>& actions) override {
+    state_.ApplyActions(actions);
+  }
+
+  // The wrapped state as a State, as InnerState may hide some overloads.
+  const State& inner() const { return state_; }
+
+  InnerState state_;
+};
+
 class WrappedGame : public Game {
  public:
   WrappedGame(std::shared_ptr<const Game> game, GameType game_type,
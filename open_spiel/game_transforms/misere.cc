@@ -35,12 +35,6 @@ const GameType kGameType{/*short_name=*/"misere",
                                                  /*is_mandatory=*/true)}},
                          /*default_loadable=*/false};
 
-GameType MisereGameType(GameType game_type) {
-  game_type.short_name = kGameType.short_name;
-  game_type.long_name = absl::StrCat("Misere ", game_type.long_name);
-  return game_type;
-}
-
 std::shared_ptr<const Game> Factory(const GameParameters& params) {
   auto game = LoadGame(params.at("game").game_value());
   GameType game_type = MisereGameType(game->GetType());
@@ -51,6 +45,12 @@ REGISTER_SPIEL_GAME(kGameType, Factory);
 
 }  // namespace
 
+GameType MisereGameType(GameType game_type) {
+  game_type.short_name = kGameType.short_name;
+  game_type.long_name = absl::StrCat("Misere ", game_type.long_name);
+  return game_type;
+}
+
 MisereGame::MisereGame(std::shared_ptr<const Game> game, GameType game_type,
                        GameParameters game_parameters)
     : WrappedGame(game, game_type, game_parameters) {}
@@ -15,7 +15,12 @@
 #ifndef OPEN_SPIEL_GAME_TRANSFORMS_MISERE_H_
 #define OPEN_SPIEL_GAME_TRANSFORMS_MISERE_H_
 
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "open_spiel/game_transforms/game_wrapper.h"
+#include "open_spiel/game_parameters.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
 
@@ -71,6 +76,63 @@ class MisereGame : public WrappedGame {
   double UtilitySum() const override { return -game_->UtilitySum(); }
 };
 
+// As MisereState, holding the wrapped state by value; see TypedWrappedState.
+template <typename InnerState>
+class TypedMisereState : public TypedWrappedState<InnerState> {
+ public:
+  TypedMisereState(std::shared_ptr<const Game> game, const InnerState& state)
+      : TypedWrappedState<InnerState>(game, state) {}
+  TypedMisereState(const TypedMisereState& other) = default;
+
+  std::vector<double> Rewards() const override {
+    return Negative(this->state_.Rewards());
+  }
+
+  std::vector<double> Returns() const override {
+    return Negative(this->state_.Returns());
+  }
+
+  std::unique_ptr<State> Clone() const override {
+    return std::unique_ptr<State>(new TypedMisereState(*this));
+  }
+};
+
+// The misere version of a game whose states are all InnerStates, with
+// TypedMisereStates.
+template <typename InnerState>
+class TypedMisereGame : public MisereGame {
+ public:
+  using MisereGame::MisereGame;
+
+  std::unique_ptr<State> NewInitialState() const override {
+    std::unique_ptr<State> state = game_->NewInitialState();
+    const auto* inner_state = dynamic_cast<const InnerState*>(state.get());
+    SPIEL_CHECK_TRUE(inner_state != nullptr);
+    return std::unique_ptr<State>(
+        new TypedMisereState<InnerState>(shared_from_this(), *inner_state));
+  }
+
+  std::shared_ptr<const Game> Clone() const override {
+    return std::shared_ptr<const Game>(new TypedMisereGame(*this));
+  }
+};
+
+GameType MisereGameType(GameType game_type);
+
+// Loads the misere version of a game whose states are all InnerStates, e.g.
+// LoadTypedMisereGame<tic_tac_toe::TicTacToeState>("tic_tac_toe"). The game
+// behaves as "misere(game=...)", but skips an indirection in every call to
+// its states.
+template <typename InnerState>
+std::shared_ptr<const Game> LoadTypedMisereGame(
+    const std::string& game_string) {
+  std::shared_ptr<const Game> game = LoadGame(game_string);
+  GameParameters params = {
+      {"game", GameParameter(GameParametersFromString(game_string))}};
+  return std::shared_ptr<const Game>(new TypedMisereGame<InnerState>(
+      game, MisereGameType(game->GetType()), params));
+}
+
 }  // namespace open_spiel
 
 #endif  // OPEN_SPIEL_GAME_TRANSFORMS_MISERE_H_
@@ -14,7 +14,13 @@
 
 #include "open_spiel/game_transforms/misere.h"
 
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "open_spiel/games/tic_tac_toe.h"
 #include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
 #include "open_spiel/tests/basic_tests.h"
 
 namespace open_spiel {
@@ -29,8 +35,40 @@ void BasicMisereTests() {
   testing::RandomSimTest(*LoadGame("misere(game=leduc_poker())"), 100);
 }
 
+void TypedMisereTests() {
+  std::shared_ptr<const Game> typed_game =
+      LoadTypedMisereGame<tic_tac_toe::TicTacToeState>("tic_tac_toe");
+  std::shared_ptr<const Game> game = LoadGame("misere(game=tic_tac_toe())");
+  SPIEL_CHECK_EQ(typed_game->ToString(), game->ToString());
+  SPIEL_CHECK_EQ(typed_game->MaxUtility(), game->MaxUtility());
+  testing::RandomSimTest(*typed_game, 100);
+
+  // The typed and untyped wrappers play the same games.
+  std::mt19937 rng(0);
+  for (int i = 0; i < 100; ++i) {
+    std::unique_ptr<State> typed_state = typed_game->NewInitialState();
+    std::unique_ptr<State> state = game->NewInitialState();
+    while (!state->IsTerminal()) {
+      SPIEL_CHECK_EQ(typed_state->LegalActions(), state->LegalActions());
+      SPIEL_CHECK_EQ(typed_state->ObservationString(0),
+                     state->ObservationString(0));
+      std::vector<Action> actions = state->LegalActions();
+      std::uniform_int_distribution<int> dist(0, actions.size() - 1);
+      Action action = actions[dist(rng)];
+      typed_state = typed_state->Child(action);
+      state->ApplyAction(action);
+    }
+    SPIEL_CHECK_TRUE(typed_state->IsTerminal());
+    SPIEL_CHECK_EQ(typed_state->Returns(), state->Returns());
+    SPIEL_CHECK_EQ(typed_state->History(), state->History());
+  }
+}
+
 }  // namespace
 }  // namespace misere
 }  // namespace open_spiel
 
-int main(int argc, char** argv) { open_spiel::misere::BasicMisereTests(); }
+int main(int argc, char** argv) {
+  open_spiel::misere::BasicMisereTests();
+  open_spiel::misere::TypedMisereTests();
+}
@@ -14,8 +14,13 @@
 
 #include "open_spiel/game_transforms/normal_form_extensive_game.h"
 
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "open_spiel/algorithms/deterministic_policy.h"
-#include "open_spiel/algorithms/expected_returns.h"
+#include "open_spiel/algorithms/normal_form_payoffs.h"
 #include "open_spiel/spiel.h"
 
 namespace open_spiel {
@@ -51,47 +56,38 @@ std::shared_ptr<const Game> Factory(const GameParameters& params) {
 
 REGISTER_SPIEL_GAME(kGameType, Factory);
 
-std::shared_ptr<const TensorGame> ExtensiveToTensorGame(const Game& game) {
+std::shared_ptr<const TensorGame> ExtensiveToTensorGame(const Game& game,
+                                                        int num_threads) {
   std::vector<std::vector<std::string>> action_names(game.NumPlayers());
 
   GameType type = game.GetType();
-
-  std::vector<algorithms::DeterministicTabularPolicy> policies;
-  for (Player player = 0; player < game.NumPlayers(); ++player) {
-    algorithms::DeterministicTabularPolicy policy(game, player);
-    do {
-      action_names[player].push_back(policy.ToString(/*delimiter=*/" --- "));
-    } while (policy.NextPolicy());
-    policy.ResetDefaultPolicy();
-    policies.push_back(policy);
-  }
-  std::vector<const Policy*> policy_ptrs(policies.size());
-    for (Player player = 0; player < game.NumPlayers(); ++player) {
-      policy_ptrs[player] = &policies[player];
-    }
-  const std::unique_ptr<State> initial_state = game.NewInitialState();
-  std::vector<std::vector<double>> utils(game.NumPlayers());
-  bool last_entry;
-  do {
-    std::vector<double> returns = algorithms::ExpectedReturns(
-        *initial_state, policy_ptrs, /*depth_limit=*/-1);
+  if (type.dynamics == GameType::Dynamics::kSequential) {
+    algorithms::NormalFormPayoffs payoffs(game);
     for (Player player = 0; player < game.NumPlayers(); ++player) {
-      utils[player].push_back(returns[player]);
+      action_names[player] = payoffs.PolicyNames(player);
     }
-    last_entry = true;
-    for (auto policy = policies.rbegin(); policy != policies.rend(); ++policy) {
-      if (policy->NextPolicy()) {
-        last_entry = false;
-        break;
-      } else {
-        policy->ResetDefaultPolicy();
-      }
-    }
-  } while (!last_entry);
+    return tensor_game::CreateTensorGame(kGameType.short_name,
+                                         "Normal-form " + type.long_name,
+                                         action_names,
+                                         payoffs.Utilities(num_threads));
+  }
 
-  return tensor_game::CreateTensorGame(kGameType.short_name,
-                                       "Normal-form " + type.long_name,
-                                       action_names, utils);
+  // Simultaneous-move games evaluate each profile separately.
+  std::vector<std::shared_ptr<const algorithms::IndexedDeterministicPolicies>>
+      policies;
+  for (Player player = 0; player < game.NumPlayers(); ++player) {
+    policies.push_back(
+        std::make_shared<const algorithms::IndexedDeterministicPolicies>(
+            game, player));
+    for (int64_t policy = 0; policy < policies.back()->NumPolicies();
+         ++policy) {
+      action_names[player].push_back(
+          policies.back()->PolicyToString(policy, /*delimiter=*/" --- "));
+    }
+  }
+  return tensor_game::CreateTensorGame(
+      kGameType.short_name, "Normal-form " + type.long_name, action_names,
+      algorithms::ProfileReturns(game, policies, num_threads));
 }
 
 }  // namespace open_spiel
@@ -35,9 +35,13 @@ namespace open_spiel {
 //
 // Hence, this method should only be used for  small games! For example, Kuhn
 // poker has 64 deterministic policies, resulting in a 64-by-64 matrix.
-
+//
+// Sequential games are converted with a single traversal of the game tree
+// (see algorithms/normal_form_payoffs.h), with the rows of the tensor shared
+// out between num_threads threads; simultaneous-move games evaluate each
+// profile with its own traversal, the profiles being shared out likewise.
 std::shared_ptr<const tensor_game::TensorGame> ExtensiveToTensorGame(
-    const Game& game);
+    const Game& game, int num_threads = 1);
 
 }  // namespace open_spiel
 
@@ -0,0 +1,177 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/game_transforms/observation_history.h"
+
+#include <algorithm>
+
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace {
+
+// These parameters are the most-general case. The actual game may be simpler.
+const GameType kGameType{
+    /*short_name=*/"observation_history",
+    /*long_name=*/"Observation History of a Regular Game",
+    GameType::Dynamics::kSequential,
+    GameType::ChanceMode::kSampledStochastic,
+    GameType::Information::kImperfectInformation,
+    GameType::Utility::kGeneralSum,
+    GameType::RewardModel::kRewards,
+    /*max_num_players=*/100,
+    /*min_num_players=*/1,
+    /*provides_information_state_string=*/true,
+    /*provides_information_state_tensor=*/true,
+    /*provides_observation_string=*/true,
+    /*provides_observation_tensor=*/true,
+    {{"game",
+      GameParameter(GameParameter::Type::kGame, /*is_mandatory=*/true)},
+     {"frames", GameParameter(8)}},
+    /*default_loadable=*/false};
+
+std::shared_ptr<const Game> Factory(const GameParameters& params) {
+  auto game = LoadGame(params.at("game").game_value());
+  GameType game_type = ObservationHistoryGameType(game->GetType());
+  return std::shared_ptr<const Game>(
+      new ObservationHistoryGame(game, game_type, params));
+}
+
+REGISTER_SPIEL_GAME(kGameType, Factory);
+
+// Whether the frames are stacked along the last dimension.
+bool IsInterleaved(const std::vector<int>& shape, TensorLayout layout) {
+  return shape.size() == 3 && layout == TensorLayout::kHWC;
+}
+
+}  // namespace
+
+GameType ObservationHistoryGameType(GameType game_type) {
+  if (!game_type.provides_observation_tensor) {
+    SpielFatalError(absl::StrCat("observation_history needs a game with ",
+                                 "observation tensors, which ",
+                                 game_type.short_name, " doesn't provide."));
+  }
+  game_type.short_name = kGameType.short_name;
+  game_type.long_name =
+      absl::StrCat("Observation History of ", game_type.long_name);
+  game_type.parameter_specification = kGameType.parameter_specification;
+  // The states keep the default HashValue(), the hash of their history, which
+  // determines the older frames too, so hash_determines_observation holds.
+  return game_type;
+}
+
+ObservationHistoryGame::ObservationHistoryGame(
+    std::shared_ptr<const Game> game, GameType game_type,
+    GameParameters game_parameters)
+    : WrappedGame(game, game_type, game_parameters),
+      num_frames_(ParameterValue<int>("frames")),
+      frame_size_(game_->ObservationTensorSize()),
+      frame_run_size_(frame_size_) {
+  SPIEL_CHECK_GE(num_frames_, 1);
+  std::vector<int> shape = game_->ObservationTensorShape();
+  SPIEL_CHECK_FALSE(shape.empty());
+  if (IsInterleaved(shape, game_->ObservationTensorLayout())) {
+    frame_run_size_ = shape.back();
+  }
+}
+
+std::vector<int> ObservationHistoryGame::ObservationTensorShape() const {
+  std::vector<int> shape = game_->ObservationTensorShape();
+  if (IsInterleaved(shape, game_->ObservationTensorLayout())) {
+    shape.back() *= num_frames_;
+  } else {
+    shape.front() *= num_frames_;
+  }
+  return shape;
+}
+
+ObservationHistoryState::ObservationHistoryState(
+    std::shared_ptr<const Game> game, std::unique_ptr<State> state)
+    : WrappedState(game, std::move(state)),
+      history_game_(static_cast<const ObservationHistoryGame&>(*game)) {
+  // All the frames before the start of the game share one frame of zeros.
+  auto zeros = std::make_shared<Frame>(
+      static_cast<size_t>(num_players_) * history_game_.FrameSize(), 0.0f);
+  frames_.assign(history_game_.NumFrames(), zeros);
+  newest_ = frames_.size() - 1;
+  PushFrame(/*initial=*/true);
+}
+
+void ObservationHistoryState::DoApplyAction(Action action_id) {
+  state_->ApplyAction(action_id);
+  PushFrame(/*initial=*/false);
+}
+
+void ObservationHistoryState::DoApplyActions(
+    const std::vector<Action>& actions) {
+  state_->ApplyActions(actions);
+  PushFrame(/*initial=*/false);
+}
+
+void ObservationHistoryState::PushFrame(bool initial) {
+  const int previous = newest_;
+  newest_ = (newest_ + 1) % frames_.size();
+  std::shared_ptr<Frame>& frame = frames_[newest_];
+  if (frame.use_count() > 1) {
+    // Shared with a clone or with other slots: copy on write.
+    frame = std::make_shared<Frame>(*frames_[previous]);
+  } else if (newest_ != previous) {
+    // The oldest frame is only ours, so reuse its storage.
+    *frame = *frames_[previous];
+  }
+  const int size = history_game_.FrameSize();
+  for (Player player = 0; player < num_players_; ++player) {
+    absl::Span<float> values(frame->data() + player * size, size);
+    if (initial || !state_->UpdateObservationTensor(player, values)) {
+      state_->ObservationTensor(player, values);
+    }
+  }
+}
+
+void ObservationHistoryState::ObservationTensor(
+    Player player, absl::Span<float> values) const {
+  SPIEL_CHECK_GE(player, 0);
+  SPIEL_CHECK_LT(player, num_players_);
+  const int size = history_game_.FrameSize();
+  const int num_frames = frames_.size();
+  SPIEL_CHECK_EQ(values.size(), size * num_frames);
+  // In the kCHW layout a run is a whole frame, so the frames are simply
+  // concatenated.
+  const int run = history_game_.FrameRunSize();
+  for (int i = 0; i < num_frames; ++i) {
+    const Frame& frame = *frames_[(newest_ - i + num_frames) % num_frames];
+    const float* source = frame.data() + player * size;
+    for (int j = 0; j < size / run; ++j) {
+      std::copy(source + j * run, source + (j + 1) * run,
+                values.begin() + (j * num_frames + i) * run);
+    }
+  }
+}
+
+void ObservationHistoryState::ObservationTensor(
+    Player player, std::vector<double>* values) const {
+  std::vector<float> stacked(history_game_.ObservationTensorSize());
+  ObservationTensor(player, absl::MakeSpan(stacked));
+  values->assign(stacked.begin(), stacked.end());
+}
+
+int64_t ObservationHistoryState::ApproximateMemoryUsage() const {
+  return sizeof(*this) + HistoryMemoryUsage() +
+         state_->ApproximateMemoryUsage() +
+         frames_.capacity() * sizeof(frames_[0]);
+}
+
+}  // namespace open_spiel
@@ -0,0 +1,134 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_GAME_TRANSFORMS_OBSERVATION_HISTORY_H_
+#define OPEN_SPIEL_GAME_TRANSFORMS_OBSERVATION_HISTORY_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/types/span.h"
+#include "open_spiel/game_parameters.h"
+#include "open_spiel/game_transforms/game_wrapper.h"
+#include "open_spiel/spiel.h"
+
+// Transforms a game so that its observation tensor is the stack of the last
+// `frames` observation tensors of the original game, newest first, as the
+// history planes of AlphaZero's networks for Go and chess. Before the start of
+// the game, the older frames are zeros.
+//
+// Each state keeps the encoded frames in a ring, and encodes only the new one
+// after each action, with UpdateObservationTensor where the game supports it,
+// so asking for the observation doesn't re-encode the past states. Frames are
+// never modified once another state shares them, so a clone copies pointers to
+// the frames rather than the frames themselves.
+//
+// The stack is along the channels: the first dimension of the shape for the
+// kCHW layout (and tensors of other ranks), the last one for kHWC, where the
+// frames of each position are then next to each other.
+//
+// The wrapped game must provide observation tensors at every state, including
+// chance nodes and terminal states. Undo is not supported, as the frame which
+// fell off the ring can't be recovered.
+
+namespace open_spiel {
+
+class ObservationHistoryGame;
+
+class ObservationHistoryState : public WrappedState {
+ public:
+  ObservationHistoryState(std::shared_ptr<const Game> game,
+                          std::unique_ptr<State> state);
+  ObservationHistoryState(const ObservationHistoryState& other) = default;
+
+  void ObservationTensor(Player player,
+                         std::vector<double>* values) const override;
+  void ObservationTensor(Player player,
+                         absl::Span<float> values) const override;
+
+  std::unique_ptr<State> Clone() const override {
+    return std::unique_ptr<State>(new ObservationHistoryState(*this));
+  }
+
+  void UndoAction(Player player, Action action) override {
+    SpielFatalError("UndoAction is not supported by observation_history.");
+  }
+  bool SupportsUndoAction() const override { return false; }
+
+  // Only counts the pointers to the frames, which are shared with the clones.
+  int64_t ApproximateMemoryUsage() const override;
+
+ protected:
+  void DoApplyAction(Action action_id) override;
+  void DoApplyActions(const std::vector<Action>& actions) override;
+
+ private:
+  // Encodes the frame of the current state into the next slot of the ring,
+  // which becomes the newest one: from scratch for the initial state, and
+  // otherwise by updating a copy of the previous frame.
+  void PushFrame(bool initial);
+
+  // The observation tensors of all the players, one after the other.
+  using Frame = std::vector<float>;
+
+  const ObservationHistoryGame& history_game_;
+  // A ring of frames, of which frames_[newest_] is the current state's.
+  // Several slots, and several states, may point to the same frame, which must
+  // then not be modified.
+  std::vector<std::shared_ptr<Frame>> frames_;
+  int newest_ = 0;
+};
+
+class ObservationHistoryGame : public WrappedGame {
+ public:
+  ObservationHistoryGame(std::shared_ptr<const Game> game, GameType game_type,
+                         GameParameters game_parameters);
+  ObservationHistoryGame(const ObservationHistoryGame& other) = default;
+
+  std::unique_ptr<State> NewInitialState() const override {
+    return std::unique_ptr<State>(new ObservationHistoryState(
+        shared_from_this(), game_->NewInitialState()));
+  }
+
+  std::shared_ptr<const Game> Clone() const override {
+    return std::shared_ptr<const Game>(new ObservationHistoryGame(*this));
+  }
+
+  std::vector<int> ObservationTensorShape() const override;
+  TensorLayout ObservationTensorLayout() const override {
+    return game_->ObservationTensorLayout();
+  }
+
+  // The number of observations stacked.
+  int NumFrames() const { return num_frames_; }
+
+  // The size of one observation tensor of the wrapped game.
+  int FrameSize() const { return frame_size_; }
+
+  // The size of the contiguous runs of a frame in the stacked tensor: the
+  // channels of one position for kHWC, the whole frame otherwise.
+  int FrameRunSize() const { return frame_run_size_; }
+
+ private:
+  int num_frames_;
+  int frame_size_;
+  int frame_run_size_;
+};
+
+GameType ObservationHistoryGameType(GameType game_type);
+
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_GAME_TRANSFORMS_OBSERVATION_HISTORY_H_
@@ -0,0 +1,110 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/game_transforms/observation_history.h"
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/tests/basic_tests.h"
+
+namespace open_spiel {
+namespace observation_history {
+namespace {
+
+namespace testing = open_spiel::testing;
+
+void BasicObservationHistoryTests() {
+  testing::LoadGameTest("observation_history(game=tic_tac_toe())");
+  testing::RandomSimTest(
+      *LoadGame("observation_history(game=tic_tac_toe(),frames=3)"), 100);
+  testing::RandomSimTest(
+      *LoadGame("observation_history(game=leduc_poker(),frames=2)"), 100);
+  testing::RandomSimTest(
+      *LoadGame("observation_history(game=goofspiel(num_cards=4),frames=4)"),
+      10);
+}
+
+void ShapeTest() {
+  std::shared_ptr<const Game> game =
+      LoadGame("observation_history(game=tic_tac_toe())");
+  SPIEL_CHECK_EQ(game->ObservationTensorShape(), (std::vector<int>{24, 3, 3}));
+  SPIEL_CHECK_EQ(game->NewInitialState()->ObservationTensor(0).size(),
+                 game->ObservationTensorSize());
+}
+
+// Plays random games, checking that each state's observation is the stack of
+// the wrapped game's observations of it and of its ancestors, newest first,
+// and that clones keep their own history.
+void StackedFramesTest(const std::string& game_string, int num_frames) {
+  std::shared_ptr<const Game> inner_game = LoadGame(game_string);
+  std::shared_ptr<const Game> game =
+      LoadGame(absl::StrCat("observation_history(game=", game_string,
+                            ",frames=", num_frames, ")"));
+  const int size = inner_game->ObservationTensorSize();
+  std::mt19937 rng(0);
+  for (int i = 0; i < 10; ++i) {
+    std::unique_ptr<State> state = game->NewInitialState();
+    std::vector<std::unique_ptr<State>> inner_states;
+    inner_states.push_back(inner_game->NewInitialState());
+    std::unique_ptr<State> clone;
+    while (true) {
+      for (Player player = 0; player < game->NumPlayers(); ++player) {
+        std::vector<double> stacked = state->ObservationTensor(player);
+        SPIEL_CHECK_EQ(stacked.size(), size * num_frames);
+        for (int frame = 0; frame < num_frames; ++frame) {
+          std::vector<double> expected(size, 0);
+          if (frame < inner_states.size()) {
+            expected = inner_states[inner_states.size() - 1 - frame]
+                           ->ObservationTensor(player);
+          }
+          std::vector<double> actual(stacked.begin() + frame * size,
+                                     stacked.begin() + (frame + 1) * size);
+          SPIEL_CHECK_EQ(actual, expected);
+        }
+      }
+      if (state->IsTerminal()) break;
+      if (inner_states.size() == 2) clone = state->Clone();
+      std::vector<Action> actions = state->LegalActions();
+      std::uniform_int_distribution<int> dist(0, actions.size() - 1);
+      Action action = actions[dist(rng)];
+      state->ApplyAction(action);
+      inner_states.push_back(inner_states.back()->Child(action));
+    }
+    // The clone's frames weren't changed by the moves played after it.
+    if (clone != nullptr) {
+      std::vector<double> stacked = clone->ObservationTensor(0);
+      std::vector<double> newest(stacked.begin(), stacked.begin() + size);
+      SPIEL_CHECK_EQ(newest, inner_states[1]->ObservationTensor(0));
+    }
+  }
+}
+
+}  // namespace
+}  // namespace observation_history
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  open_spiel::observation_history::BasicObservationHistoryTests();
+  open_spiel::observation_history::ShapeTest();
+  open_spiel::observation_history::StackedFramesTest("tic_tac_toe()", 3);
+  open_spiel::observation_history::StackedFramesTest("tic_tac_toe()", 1);
+  // Go updates its observation tensors incrementally.
+  open_spiel::observation_history::StackedFramesTest("go(board_size=5)", 4);
+}
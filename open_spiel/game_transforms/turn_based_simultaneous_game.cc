@@ -20,6 +20,7 @@
 #include <utility>
 
 #include "open_spiel/spiel.h"
+#include "open_spiel/utils/varint.h"
 
 namespace open_spiel {
 
@@ -90,10 +91,15 @@ void TurnBasedSimultaneousState::RolloutModeIncrementCurrentPlayer() {
   }
 }
 
+State* TurnBasedSimultaneousState::MutableState() {
+  if (state_.use_count() > 1) state_ = state_->Clone();
+  return state_.get();
+}
+
 void TurnBasedSimultaneousState::DoApplyAction(Action action_id) {
   if (state_->IsChanceNode()) {
     SPIEL_CHECK_FALSE(rollout_mode_);
-    state_->ApplyAction(action_id);
+    MutableState()->ApplyAction(action_id);
     DetermineWhoseTurn();
   } else {
     if (rollout_mode_) {
@@ -103,12 +109,12 @@ void TurnBasedSimultaneousState::DoApplyAction(Action action_id) {
       RolloutModeIncrementCurrentPlayer();
       // Check if we then need to apply it.
       if (current_player_ == num_players_) {
-        state_->ApplyActions(action_vector_);
+        MutableState()->ApplyActions(action_vector_);
         DetermineWhoseTurn();
       }
     } else {
       SPIEL_CHECK_NE(state_->CurrentPlayer(), kSimultaneousPlayerId);
-      state_->ApplyAction(action_id);
+      MutableState()->ApplyAction(action_id);
       DetermineWhoseTurn();
     }
   }
@@ -169,6 +175,19 @@ std::string TurnBasedSimultaneousState::InformationStateString(
   return extra_info + state_->InformationStateString(player);
 }
 
+std::string TurnBasedSimultaneousState::InformationStateKey(
+    Player player) const {
+  SPIEL_CHECK_GE(player, 0);
+  SPIEL_CHECK_LT(player, num_players_);
+
+  std::string key;
+  AppendSignedVarint(current_player_, &key);
+  if (rollout_mode_ && player < current_player_) {
+    AppendSignedVarint(action_vector_[player], &key);
+  }
+  return key + state_->InformationStateKey(player);
+}
+
 void TurnBasedSimultaneousState::InformationStateTensor(
     Player player, std::vector<double>* values) const {
   SPIEL_CHECK_GE(player, 0);
@@ -251,7 +270,7 @@ void TurnBasedSimultaneousState::ObservationTensor(
 TurnBasedSimultaneousState::TurnBasedSimultaneousState(
     const TurnBasedSimultaneousState& other)
     : State(other),
-      state_(other.state_->Clone()),
+      state_(other.state_),
       action_vector_(other.action_vector_),
       current_player_(other.current_player_),
       rollout_mode_(other.rollout_mode_) {}
@@ -45,6 +45,7 @@ class TurnBasedSimultaneousState : public State {
   bool IsTerminal() const override;
   std::vector<double> Returns() const override;
   std::string InformationStateString(Player player) const override;
+  std::string InformationStateKey(Player player) const override;
   void InformationStateTensor(Player player,
                               std::vector<double>* values) const override;
   std::string ObservationString(Player player) const override;
@@ -64,7 +65,14 @@ class TurnBasedSimultaneousState : public State {
   void DetermineWhoseTurn();
   void RolloutModeIncrementCurrentPlayer();
 
-  std::unique_ptr<State> state_;
+  // The wrapped state, to modify: a copy of its own if it is shared.
+  State* MutableState();
+
+  // The wrapped state, shared by the clones until one of them applies an
+  // action to it. While a simultaneous node is rolled out, the players'
+  // actions are only buffered, so the clones made along the way do not copy
+  // the wrapped state.
+  std::shared_ptr<State> state_;
 
   // A vector of actions that is used primarily to store the intermediate
   // actions taken by the players when extending the simultaneous move nodes
@@ -123,9 +123,37 @@ void BasicTurnBasedSimultaneousTests() {
   }
 }
 
+// Clones share the wrapped state until one of them applies an action to it.
+void SharedStateTest() {
+  std::shared_ptr<const Game> game = LoadGame(
+      "turn_based_simultaneous_game(game=goofspiel(points_order=descending))");
+  std::unique_ptr<State> state = game->NewInitialState();
+  const auto* turn_based_state =
+      dynamic_cast<TurnBasedSimultaneousState*>(state.get());
+  SPIEL_CHECK_EQ(turn_based_state->SimultaneousGameState()->CurrentPlayer(),
+                 kSimultaneousPlayerId);
+  const std::string initial_string = state->ToString();
+
+  std::unique_ptr<State> child = state->Child(state->LegalActions()[0]);
+  const auto* turn_based_child =
+      dynamic_cast<TurnBasedSimultaneousState*>(child.get());
+  SPIEL_CHECK_EQ(turn_based_child->SimultaneousGameState(),
+                 turn_based_state->SimultaneousGameState());
+
+  std::unique_ptr<State> grandchild = child->Child(child->LegalActions()[0]);
+  const auto* turn_based_grandchild =
+      dynamic_cast<TurnBasedSimultaneousState*>(grandchild.get());
+  SPIEL_CHECK_NE(turn_based_grandchild->SimultaneousGameState(),
+                 turn_based_state->SimultaneousGameState());
+  SPIEL_CHECK_NE(grandchild->ToString(), initial_string);
+  SPIEL_CHECK_EQ(state->ToString(), initial_string);
+  SPIEL_CHECK_EQ(child->CurrentPlayer(), 1);
+}
+
 }  // namespace
 }  // namespace open_spiel
 
 int main(int argc, char** argv) {
   open_spiel::BasicTurnBasedSimultaneousTests();
+  open_spiel::SharedStateTest();
 }
@@ -15,15 +15,22 @@
 #include "open_spiel/games/backgammon.h"
 
 #include <algorithm>
+#include <array>
+#include <bitset>
+#include <cstdint>
 #include <cstdlib>
-#include <set>
+#include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
 #include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/abseil-cpp/absl/strings/string_view.h"
 #include "open_spiel/game_parameters.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/alias_table.h"
+#include "open_spiel/utils/varint.h"
 
 namespace open_spiel {
 namespace backgammon {
@@ -88,6 +95,19 @@ static std::shared_ptr<const Game> Factory(const GameParameters& params) {
 }
 
 REGISTER_SPIEL_GAME(kGameType, Factory);
+
+// Snapshot helpers, see BackgammonState::AppendSnapshot.
+void AppendInts(const std::vector<int>& values, std::string* bytes) {
+  AppendVarint(values.size(), bytes);
+  for (int value : values) AppendSignedVarint(value, bytes);
+}
+
+std::vector<int> ReadInts(VarintReader* reader) {
+  std::vector<int> values(reader->ReadSize());
+  for (int& value : values) value = reader->ReadSigned();
+  return values;
+}
+
 }  // namespace
 
 ScoringType ParseScoringType(const std::string& st_str) {
@@ -361,6 +381,7 @@ int BackgammonState::DiceValue(int i) const {
 
 void BackgammonState::DoApplyAction(Action move) {
   if (IsChanceNode()) {
+    legal_actions_.Clear();
     turn_history_info_.push_back(TurnHistoryInfo(kChancePlayerId, prev_player_,
                                                  dice_, move, double_turn_,
                                                  false, false));
@@ -413,7 +434,11 @@ void BackgammonState::DoApplyAction(Action move) {
   }
 
   // Normal move action.
-  std::vector<CheckerMove> moves = SpielMoveToCheckerMoves(cur_player_, move);
+  if (!LegalActionSet()[move]) {
+    SpielFatalError(absl::StrCat("Illegal action: ", move));
+  }
+  legal_actions_.Clear();
+  std::array<CheckerMove, 2> moves = DecodeCheckerMoves(cur_player_, move);
   bool first_move_hit = ApplyCheckerMove(cur_player_, moves[0]);
   bool second_move_hit = ApplyCheckerMove(cur_player_, moves[1]);
 
@@ -471,8 +496,7 @@ void BackgammonState::UndoAction(int player, Action action) {
     dice_ = thi.dice;
     double_turn_ = thi.double_turn;
     if (player != kChancePlayerId) {
-      std::vector<CheckerMove> moves = SpielMoveToCheckerMoves(player, action);
-      SPIEL_CHECK_EQ(moves.size(), 2);
+      std::array<CheckerMove, 2> moves = DecodeCheckerMoves(player, action);
       moves[0].hit = thi.first_move_hit;
       moves[1].hit = thi.second_move_hit;
       UndoCheckerMove(player, moves[1]);
@@ -488,7 +512,8 @@ void BackgammonState::UndoAction(int player, Action action) {
     }
   }
   turn_history_info_.pop_back();
-  history_.pop_back();
+  PopHistory();
+  legal_actions_.Clear();
 }
 
 Action BackgammonState::TranslateAction(int from1, int from2,
@@ -525,31 +550,33 @@ Action BackgammonState::EncodedPassMove() const { return 25; }
 Action BackgammonState::CheckerMovesToSpielMove(
     const std::vector<CheckerMove>& moves) const {
   SPIEL_CHECK_LE(moves.size(), 2);
+  return EncodeCheckerMoves(moves.empty() ? CheckerMove() : moves[0],
+                            moves.size() > 1 ? moves[1] : CheckerMove());
+}
+
+Action BackgammonState::EncodeCheckerMoves(const CheckerMove& first,
+                                           const CheckerMove& second) const {
   int dig0 = EncodedPassMove();
   int dig1 = EncodedPassMove();
   bool high_roll_first = false;
   int high_roll = DiceValue(0) >= DiceValue(1) ? DiceValue(0) : DiceValue(1);
 
-  if (!moves.empty()) {
-    int pos1 = moves[0].pos;
-    if (pos1 == kBarPos) {
-      pos1 = EncodedBarMove();
-    }
-    if (pos1 != kPassPos) {
-      int num1 = moves[0].num;
-      dig0 = pos1;
-      high_roll_first = num1 == high_roll;
-    }
+  int pos1 = first.pos;
+  if (pos1 == kBarPos) {
+    pos1 = EncodedBarMove();
+  }
+  if (pos1 != kPassPos) {
+    int num1 = first.num;
+    dig0 = pos1;
+    high_roll_first = num1 == high_roll;
   }
 
-  if (moves.size() > 1) {
-    int pos2 = moves[1].pos;
-    if (pos2 == kBarPos) {
-      pos2 = EncodedBarMove();
-    }
-    if (pos2 != kPassPos) {
-      dig1 = pos2;
-    }
+  int pos2 = second.pos;
+  if (pos2 == kBarPos) {
+    pos2 = EncodedBarMove();
+  }
+  if (pos2 != kPassPos) {
+    dig1 = pos2;
   }
 
   Action move = dig1 * 26 + dig0;
@@ -563,6 +590,12 @@ Action BackgammonState::CheckerMovesToSpielMove(
 
 std::vector<CheckerMove> BackgammonState::SpielMoveToCheckerMoves(
     int player, Action spiel_move) const {
+  std::array<CheckerMove, 2> cmoves = DecodeCheckerMoves(player, spiel_move);
+  return {cmoves[0], cmoves[1]};
+}
+
+std::array<CheckerMove, 2> BackgammonState::DecodeCheckerMoves(
+    int player, Action spiel_move) const {
   SPIEL_CHECK_GE(spiel_move, 0);
   SPIEL_CHECK_LT(spiel_move, kNumDistinctActions);
 
@@ -571,8 +604,8 @@ std::vector<CheckerMove> BackgammonState::SpielMoveToCheckerMoves(
     spiel_move -= 676;
   }
 
-  std::vector<Action> digits = {spiel_move % 26, spiel_move / 26};
-  std::vector<CheckerMove> cmoves;
+  const Action digits[2] = {spiel_move % 26, spiel_move / 26};
+  std::array<CheckerMove, 2> cmoves;
   int high_roll = DiceValue(0) >= DiceValue(1) ? DiceValue(0) : DiceValue(1);
   int low_roll = DiceValue(0) < DiceValue(1) ? DiceValue(0) : DiceValue(1);
 
@@ -589,11 +622,9 @@ std::vector<CheckerMove> BackgammonState::SpielMoveToCheckerMoves(
     SPIEL_CHECK_GE(num, 1);
     SPIEL_CHECK_LE(num, 6);
 
-    if (digits[i] == EncodedPassMove()) {
-      cmoves.push_back(CheckerMove(kPassPos, -1, false));
-    } else {
-      cmoves.push_back(CheckerMove(
-          digits[i] == EncodedBarMove() ? kBarPos : digits[i], num, false));
+    if (digits[i] != EncodedPassMove()) {
+      cmoves[i] = CheckerMove(
+          digits[i] == EncodedBarMove() ? kBarPos : digits[i], num, false);
     }
   }
   return cmoves;
@@ -860,56 +891,66 @@ int BackgammonState::IsBackgammoned(int player) const {
   return false;
 }
 
-std::set<CheckerMove> BackgammonState::LegalCheckerMoves(int player) const {
-  std::set<CheckerMove> moves;
+int BackgammonState::LegalCheckerMoves(
+    int player, std::array<CheckerMove, kMaxCheckerMoves>* moves) const {
+  // The distinct dice outcomes still usable, so that doubles give each move
+  // only once.
+  int outcomes[2];
+  int num_outcomes = 0;
+  for (int outcome : dice_) {
+    if (UsableDiceOutcome(outcome) &&
+        (num_outcomes == 0 || outcomes[0] != outcome)) {
+      SPIEL_CHECK_LT(num_outcomes, 2);
+      outcomes[num_outcomes++] = outcome;
+    }
+  }
 
+  int num_moves = 0;
   if (bar_[player] > 0) {
     // If there are any checkers are the bar, must move them out first.
-    for (int outcome : dice_) {
-      if (UsableDiceOutcome(outcome)) {
-        int pos = PositionFromBar(player, outcome);
-        if (NumOppCheckers(player, pos) <= 1) {
-          bool hit = NumOppCheckers(player, pos) == 1;
-          moves.insert(CheckerMove(kBarPos, outcome, hit));
-        }
+    for (int o = 0; o < num_outcomes; ++o) {
+      int pos = PositionFromBar(player, outcomes[o]);
+      if (NumOppCheckers(player, pos) <= 1) {
+        bool hit = NumOppCheckers(player, pos) == 1;
+        (*moves)[num_moves++] = CheckerMove(kBarPos, outcomes[o], hit);
       }
     }
-    return moves;
+    return num_moves;
   }
 
   // Regular board moves.
   bool all_in_home = AllInHome(player);
+  int furthest = all_in_home ? FurthestCheckerInHome(player) : -1;
   for (int i = 0; i < kNumPoints; ++i) {
     if (board_[player][i] > 0) {
-      for (int outcome : dice_) {
-        if (UsableDiceOutcome(outcome)) {
-          int pos = PositionFrom(player, i, outcome);
-          if (pos == kScorePos && all_in_home) {
-            // Check whether a bear off move is legal.
-
-            // It is ok to bear off if all the checkers are at home and the
-            // point being used to move from exactly matches the distance from
-            // just stepping off the board.
-            if ((player == kXPlayerId && i + outcome == 24) ||
-                (player == kOPlayerId && i - outcome == -1)) {
-              moves.insert(CheckerMove(i, outcome, false));
-            } else {
-              // Otherwise, a die can only be used to move a checker off if
-              // there are no checkers further than it in the player's home.
-              if (i == FurthestCheckerInHome(player)) {
-                moves.insert(CheckerMove(i, outcome, false));
-              }
+      for (int o = 0; o < num_outcomes; ++o) {
+        int outcome = outcomes[o];
+        int pos = PositionFrom(player, i, outcome);
+        if (pos == kScorePos && all_in_home) {
+          // Check whether a bear off move is legal.
+
+          // It is ok to bear off if all the checkers are at home and the
+          // point being used to move from exactly matches the distance from
+          // just stepping off the board.
+          if ((player == kXPlayerId && i + outcome == 24) ||
+              (player == kOPlayerId && i - outcome == -1)) {
+            (*moves)[num_moves++] = CheckerMove(i, outcome, false);
+          } else {
+            // Otherwise, a die can only be used to move a checker off if
+            // there are no checkers further than it in the player's home.
+            if (i == furthest) {
+              (*moves)[num_moves++] = CheckerMove(i, outcome, false);
             }
-          } else if (pos != kScorePos && NumOppCheckers(player, pos) <= 1) {
-            // Regular move.
-            bool hit = NumOppCheckers(player, pos) == 1;
-            moves.insert(CheckerMove(i, outcome, hit));
           }
+        } else if (pos != kScorePos && NumOppCheckers(player, pos) <= 1) {
+          // Regular move.
+          bool hit = NumOppCheckers(player, pos) == 1;
+          (*moves)[num_moves++] = CheckerMove(i, outcome, hit);
         }
       }
     }
   }
-  return moves;
+  return num_moves;
 }
 
 bool BackgammonState::ApplyCheckerMove(int player, const CheckerMove& move) {
@@ -1004,44 +1045,71 @@ void BackgammonState::UndoCheckerMove(int player, const CheckerMove& move) {
   }
 }
 
-// Returns the maximum move size (2, 1, or 0)
-int BackgammonState::RecLegalMoves(
-    std::vector<CheckerMove> moveseq,
-    std::set<std::vector<CheckerMove>>* movelist) {
-  if (moveseq.size() == 2) {
-    movelist->insert(moveseq);
-    return moveseq.size();
+LegalActionsCache& LegalActionsCache::operator=(
+    const LegalActionsCache& other) {
+  if (other.Get(&actions_)) {
+    status_.store(kFilled, std::memory_order_relaxed);
+  } else {
+    status_.store(kEmpty, std::memory_order_relaxed);
   }
+  return *this;
+}
 
-  std::set<CheckerMove> moves_here = LegalCheckerMoves(cur_player_);
-
-  if (moves_here.empty()) {
-    movelist->insert(moveseq);
-    return moveseq.size();
-  }
+bool LegalActionsCache::Get(Actions* actions) const {
+  if (status_.load(std::memory_order_acquire) != kFilled) return false;
+  *actions = actions_;
+  return true;
+}
 
-  int max_moves = -1;
-  for (const auto& move : moves_here) {
-    moveseq.push_back(move);
-    ApplyCheckerMove(cur_player_, move);
-    int child_max = RecLegalMoves(moveseq, movelist);
-    UndoCheckerMove(cur_player_, move);
-    max_moves = std::max(child_max, max_moves);
-    moveseq.pop_back();
+void LegalActionsCache::Set(const Actions& actions) {
+  int expected = kEmpty;
+  if (!status_.compare_exchange_strong(expected, kFilling,
+                                       std::memory_order_acquire)) {
+    return;
   }
+  actions_ = actions;
+  status_.store(kFilled, std::memory_order_release);
+}
 
-  return max_moves;
+void BackgammonState::CopyPositionFrom(const BackgammonState& other) {
+  cur_player_ = other.cur_player_;
+  dice_ = other.dice_;
+  bar_ = other.bar_;
+  scores_ = other.scores_;
+  board_ = other.board_;
 }
 
-std::vector<Action> BackgammonState::ProcessLegalMoves(
-    int max_moves, const std::set<std::vector<CheckerMove>>& movelist) const {
-  if (max_moves == 0) {
-    SPIEL_CHECK_EQ(movelist.size(), 1);
-    SPIEL_CHECK_TRUE(movelist.begin()->empty());
+std::bitset<kNumDistinctActions> BackgammonState::LegalActionSet() const {
+  std::bitset<kNumDistinctActions> actions;
+  if (!legal_actions_.Get(&actions)) {
+    GenerateLegalActions(&actions);
+    legal_actions_.Set(actions);
+  }
+  return actions;
+}
 
+void BackgammonState::GenerateLegalActions(
+    std::bitset<kNumDistinctActions>* actions) const {
+  SPIEL_CHECK_EQ(CountTotalCheckers(kXPlayerId), kNumCheckersPerPlayer);
+  SPIEL_CHECK_EQ(CountTotalCheckers(kOPlayerId), kNumCheckersPerPlayer);
+  actions->reset();
+
+  // The second checker moves are found by playing each first one on a copy of
+  // the position and undoing it. Each thread keeps its copy, so that its
+  // vectors are only allocated once.
+  thread_local std::unique_ptr<BackgammonState> scratch;
+  if (scratch == nullptr) {
+    scratch.reset(new BackgammonState(*this));
+  } else {
+    scratch->CopyPositionFrom(*this);
+  }
+  std::array<CheckerMove, kMaxCheckerMoves> first_moves;
+  std::array<CheckerMove, kMaxCheckerMoves> second_moves;
+  const int num_first_moves = LegalCheckerMoves(cur_player_, &first_moves);
+  if (num_first_moves == 0) {
     // Passing is always a legal move!
-    return {CheckerMovesToSpielMove(
-        {{kPassPos, -1, false}, {kPassPos, -1, false}})};
+    actions->set(EncodeCheckerMoves(CheckerMove(), CheckerMove()));
+    return;
   }
 
   // Rule 2 in Movement of Checkers:
@@ -1051,49 +1119,49 @@ std::vector<Action> BackgammonState::ProcessLegalMoves(
   // both, the player must play the larger one. When neither number can be used,
   // the player loses his turn. In the case of doubles, when all four numbers
   // cannot be played, the player must play as many numbers as he can.
-  std::vector<Action> legal_actions;
+  bool two_moves = false;
   int max_roll = -1;
-  for (const auto& move : movelist) {
-    if (max_moves == 2) {
-      // Only add moves that are size 2.
-      if (move.size() == 2) {
-        legal_actions.push_back(CheckerMovesToSpielMove(move));
-      }
-    } else if (max_moves == 1) {
-      // We are just finding the maximum roll.
-      max_roll = std::max(max_roll, move[0].num);
+  for (int i = 0; i < num_first_moves; ++i) {
+    const CheckerMove& first = first_moves[i];
+    scratch->ApplyCheckerMove(cur_player_, first);
+    const int num_second_moves =
+        scratch->LegalCheckerMoves(cur_player_, &second_moves);
+    for (int j = 0; j < num_second_moves; ++j) {
+      actions->set(EncodeCheckerMoves(first, second_moves[j]));
     }
+    scratch->UndoCheckerMove(cur_player_, first);
+    two_moves = two_moves || num_second_moves > 0;
+    max_roll = std::max(max_roll, first.num);
   }
 
-  if (max_moves == 1) {
-    // Another round to add those that have the max die roll.
-    for (const auto& move : movelist) {
-      if (move[0].num == max_roll) {
-        legal_actions.push_back(CheckerMovesToSpielMove(move));
+  if (!two_moves) {
+    for (int i = 0; i < num_first_moves; ++i) {
+      if (first_moves[i].num == max_roll) {
+        actions->set(EncodeCheckerMoves(first_moves[i], CheckerMove()));
       }
     }
   }
-
-  SPIEL_CHECK_FALSE(legal_actions.empty());
-  return legal_actions;
+  SPIEL_CHECK_TRUE(actions->any());
 }
 
 std::vector<Action> BackgammonState::LegalActions() const {
-  if (IsChanceNode()) return LegalChanceOutcomes();
-  if (IsTerminal()) return {};
+  std::vector<Action> legal_actions;
+  LegalActions(&legal_actions);
+  return legal_actions;
+}
 
-  SPIEL_CHECK_EQ(CountTotalCheckers(kXPlayerId), kNumCheckersPerPlayer);
-  SPIEL_CHECK_EQ(CountTotalCheckers(kOPlayerId), kNumCheckersPerPlayer);
+void BackgammonState::LegalActions(std::vector<Action>* actions) const {
+  if (IsChanceNode()) {
+    *actions = LegalChanceOutcomes();
+    return;
+  }
+  actions->clear();
+  if (IsTerminal()) return;
 
-  std::unique_ptr<State> cstate = this->Clone();
-  BackgammonState* state = dynamic_cast<BackgammonState*>(cstate.get());
-  std::set<std::vector<CheckerMove>> movelist;
-  int max_moves = state->RecLegalMoves({}, &movelist);
-  SPIEL_CHECK_GE(max_moves, 0);
-  SPIEL_CHECK_LE(max_moves, 2);
-  std::vector<Action> legal_actions = ProcessLegalMoves(max_moves, movelist);
-  std::sort(legal_actions.begin(), legal_actions.end());
-  return legal_actions;
+  const std::bitset<kNumDistinctActions> legal_actions = LegalActionSet();
+  for (Action action = 0; action < kNumDistinctActions; ++action) {
+    if (legal_actions[action]) actions->push_back(action);
+  }
 }
 
 std::vector<std::pair<Action, double>> BackgammonState::ChanceOutcomes() const {
@@ -1101,6 +1169,17 @@ std::vector<std::pair<Action, double>> BackgammonState::ChanceOutcomes() const {
   return kChanceOutcomes;
 }
 
+std::pair<Action, double> BackgammonState::SampleChanceOutcome(
+    double z) const {
+  SPIEL_CHECK_TRUE(IsChanceNode());
+  static const AliasTable* const kChanceTable = [] {
+    std::vector<double> probs;
+    for (const auto& [outcome, prob] : kChanceOutcomes) probs.push_back(prob);
+    return new AliasTable(probs);
+  }();
+  return kChanceOutcomes[kChanceTable->Sample(z)];
+}
+
 std::string BackgammonState::ToString() const {
   std::vector<std::string> board_array = {
       "+------|------+", "|......|......|", "|......|......|",
@@ -1211,6 +1290,74 @@ std::unique_ptr<State> BackgammonState::Clone() const {
   return std::unique_ptr<State>(new BackgammonState(*this));
 }
 
+bool BackgammonState::CopyFrom(const State& other) {
+  *this = static_cast<const BackgammonState&>(other);
+  return true;
+}
+
+bool BackgammonState::AppendSnapshot(std::string* bytes) const {
+  for (int value : {cur_player_, prev_player_, turns_, x_turns_, o_turns_,
+                    static_cast<int>(double_turn_)}) {
+    AppendSignedVarint(value, bytes);
+  }
+  AppendInts(dice_, bytes);
+  AppendInts(bar_, bytes);
+  AppendInts(scores_, bytes);
+  for (const std::vector<int>& points : board_) AppendInts(points, bytes);
+  AppendVarint(turn_history_info_.size(), bytes);
+  for (const TurnHistoryInfo& info : turn_history_info_) {
+    for (int value : {info.player, info.prev_player}) {
+      AppendSignedVarint(value, bytes);
+    }
+    AppendInts(info.dice, bytes);
+    AppendSignedVarint(info.action, bytes);
+    for (bool flag :
+         {info.double_turn, info.first_move_hit, info.second_move_hit}) {
+      AppendVarint(flag, bytes);
+    }
+  }
+  return true;
+}
+
+bool BackgammonState::RestoreSnapshot(const std::vector<Action>& history,
+                                      absl::string_view bytes) {
+  VarintReader reader(bytes);
+  cur_player_ = reader.ReadSigned();
+  prev_player_ = reader.ReadSigned();
+  turns_ = reader.ReadSigned();
+  x_turns_ = reader.ReadSigned();
+  o_turns_ = reader.ReadSigned();
+  double_turn_ = reader.ReadSigned();
+  dice_ = ReadInts(&reader);
+  bar_ = ReadInts(&reader);
+  scores_ = ReadInts(&reader);
+  for (std::vector<int>& points : board_) points = ReadInts(&reader);
+  const uint64_t num_turns = reader.ReadSize();
+  turn_history_info_.clear();
+  for (int i = 0; i < num_turns; ++i) {
+    const int player = reader.ReadSigned();
+    const int prev_player = reader.ReadSigned();
+    std::vector<int> dice = ReadInts(&reader);
+    const Action action = reader.ReadSigned();
+    const bool double_turn = reader.Read();
+    const bool first_move_hit = reader.Read();
+    const bool second_move_hit = reader.Read();
+    turn_history_info_.emplace_back(player, prev_player, dice, action,
+                                    double_turn, first_move_hit,
+                                    second_move_hit);
+  }
+  if (!reader.ok() || !reader.empty() || bar_.size() != kNumPlayers ||
+      scores_.size() != kNumPlayers) {
+    return false;
+  }
+  for (const std::vector<int>& points : board_) {
+    if (points.size() != kNumPoints) return false;
+  }
+  history_ = history;
+  legal_actions_.Clear();
+  return true;
+}
+
 void BackgammonState::SetState(int cur_player, bool double_turn,
                                const std::vector<int>& dice,
                                const std::vector<int>& bar,
@@ -1222,6 +1369,7 @@ void BackgammonState::SetState(int cur_player, bool double_turn,
   bar_ = bar;
   scores_ = scores;
   board_ = board;
+  legal_actions_.Clear();
 
   SPIEL_CHECK_EQ(CountTotalCheckers(kXPlayerId), kNumCheckersPerPlayer);
   SPIEL_CHECK_EQ(CountTotalCheckers(kOPlayerId), kNumCheckersPerPlayer);
@@ -16,11 +16,13 @@
 #define OPEN_SPIEL_GAMES_BACKGAMMON_H_
 
 #include <array>
+#include <atomic>
+#include <bitset>
 #include <memory>
-#include <set>
 #include <string>
 #include <vector>
 
+#include "open_spiel/abseil-cpp/absl/strings/string_view.h"
 #include "open_spiel/spiel.h"
 
 // An implementation of the classic: https://en.wikipedia.org/wiki/Backgammon
@@ -60,6 +62,10 @@ inline constexpr const int kScorePos = 101;
 // number is encoded as a 2-digit number in base 26.
 inline constexpr const int kNumDistinctActions = 1352;
 
+// The most checker moves a single die can make: one from each point, plus
+// one from the bar. A roll has at most two distinct dice.
+inline constexpr const int kMaxCheckerMoves = 2 * (kNumPoints + 1);
+
 // See ObservationTensorShape for details.
 inline constexpr const int kBoardEncodingSize = 4 * kNumPoints * kNumPlayers;
 inline constexpr const int kStateEncodingSize =
@@ -79,6 +85,7 @@ struct CheckerMove {
   int pos;  // 0-24  (0-23 for locations on the board and kBarPos)
   int num;  // 1-6
   bool hit;
+  CheckerMove() : CheckerMove(kPassPos, -1, false) {}
   CheckerMove(int _pos, int _num, bool _hit)
       : pos(_pos), num(_num), hit(_hit) {}
   bool operator<(const CheckerMove& rhs) const {
@@ -109,16 +116,47 @@ struct TurnHistoryInfo {
 
 class BackgammonGame;
 
+// The legal actions of a decision node, filled at most once by whichever const
+// reader of the state first needs them. The set is only read once it is
+// complete, so concurrent readers of a state can share it.
+class LegalActionsCache {
+ public:
+  using Actions = std::bitset<kNumDistinctActions>;
+
+  LegalActionsCache() = default;
+  LegalActionsCache(const LegalActionsCache& other) { *this = other; }
+  LegalActionsCache& operator=(const LegalActionsCache& other);
+
+  // Copies the cached set to actions and returns true if it is filled.
+  bool Get(Actions* actions) const;
+
+  // Caches actions, unless another reader is filling or has filled the set.
+  void Set(const Actions& actions);
+
+  // Forgets the set, when the position changes. Not thread-safe.
+  void Clear() { status_.store(kEmpty, std::memory_order_relaxed); }
+
+ private:
+  enum Status { kEmpty, kFilling, kFilled };
+
+  Actions actions_;
+  std::atomic<int> status_{kEmpty};
+};
+
 class BackgammonState : public State {
  public:
   BackgammonState(const BackgammonState&) = default;
+  BackgammonState& operator=(const BackgammonState&) = default;
   BackgammonState(std::shared_ptr<const Game>, ScoringType scoring_type);
 
   Player CurrentPlayer() const override;
   void UndoAction(Player player, Action action) override;
+  bool SupportsUndoAction() const override { return true; }
   std::vector<Action> LegalActions() const override;
+  void LegalActions(std::vector<Action>* actions) const override;
   std::string ActionToString(Player player, Action move_id) const override;
   std::vector<std::pair<Action, double>> ChanceOutcomes() const override;
+  std::pair<Action, double> SampleChanceOutcome(double z) const override;
   std::string ToString() const override;
   bool IsTerminal() const override;
   std::vector<double> Returns() const override;
@@ -126,6 +164,10 @@ class BackgammonState : public State {
   void ObservationTensor(Player player,
                          std::vector<double>* values) const override;
   std::unique_ptr<State> Clone() const override;
+  bool CopyFrom(const State& other) override;
+  bool AppendSnapshot(std::string* bytes) const override;
+  bool RestoreSnapshot(const std::vector<Action>& history,
+                       absl::string_view bytes) override;
 
   // Setter function used for debugging and tests. Note: this does not set the
   // historical information properly, so Undo likely will not work on states
@@ -169,6 +211,9 @@ class BackgammonState : public State {
   int score(int player) const { return scores_[player]; }
   int dice(int i) const { return dice_[i]; }
   bool double_turn() const { return double_turn_; }
+  // The player who moved last, whose opponent rolls next at a chance node,
+  // or kChancePlayerId before the first move.
+  int prev_player() const { return prev_player_; }
 
   // Get the number of checkers on the board in the specified position belonging
   // to the specified player. The position can be kBarPos or any valid position
@@ -213,11 +258,30 @@ class BackgammonState : public State {
 
   bool ApplyCheckerMove(int player, const CheckerMove& move);
   void UndoCheckerMove(int player, const CheckerMove& move);
-  std::set<CheckerMove> LegalCheckerMoves(int player) const;
-  int RecLegalMoves(std::vector<CheckerMove> moveseq,
-                    std::set<std::vector<CheckerMove>>* movelist);
-  std::vector<Action> ProcessLegalMoves(
-      int max_moves, const std::set<std::vector<CheckerMove>>& movelist) const;
+
+  // Writes the distinct single checker moves the player can make with the
+  // unused dice to moves, and returns how many there are.
+  int LegalCheckerMoves(int player,
+                        std::array<CheckerMove, kMaxCheckerMoves>* moves) const;
+
+  // The allocation-free versions of the action encoding and decoding.
+  Action EncodeCheckerMoves(const CheckerMove& first,
+                            const CheckerMove& second) const;
+  std::array<CheckerMove, 2> DecodeCheckerMoves(int player,
+                                                Action spiel_move) const;
+
+  // The legal actions of the current decision node, from legal_actions_ or
+  // generated and cached there.
+  std::bitset<kNumDistinctActions> LegalActionSet() const;
+
+  // Generates the legal actions of the current decision node. The checker
+  // moves are tried on a scratch copy of the position, so this doesn't write
+  // to the state.
+  void GenerateLegalActions(std::bitset<kNumDistinctActions>* actions) const;
+
+  // Copies the position of other, but not its history, reusing the storage of
+  // this state.
+  void CopyPositionFrom(const BackgammonState& other);
 
   ScoringType scoring_type_;  // Which rules apply when scoring the game.
 
@@ -232,6 +296,11 @@ class BackgammonState : public State {
   std::vector<int> scores_;  // Checkers returned home by each player.
   std::vector<std::vector<int>> board_;  // Checkers for each player on points.
   std::vector<TurnHistoryInfo> turn_history_info_;  // Info needed for Undo.
+
+  // The legal actions of the current decision node, computed on the first
+  // call to LegalActions or ApplyAction there and cleared by any change of
+  // position.
+  mutable LegalActionsCache legal_actions_;
 };
 
 class BackgammonGame : public Game {
@@ -0,0 +1,476 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/games/backgammon/backgammon_bearoff.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/file.h"
+#include "open_spiel/utils/thread.h"
+
+namespace open_spiel {
+namespace backgammon {
+namespace {
+
+constexpr char kMagic[8] = {'O', 'S', 'B', 'E', 'A', 'R', 'O', 'F'};
+constexpr uint32_t kVersion = 1;
+
+// Its size is a multiple of 8 bytes, so that the arrays after it stay aligned.
+struct Header {
+  char magic[8];
+  uint32_t version;
+  int32_t num_points;
+  int32_t one_sided_checkers;
+  int32_t two_sided_checkers;
+  int32_t num_rolls;
+  int32_t reserved;
+};
+
+// A bound on the rolls bearing off can take: each roll moves at least 3 pips
+// or bears off at least a checker.
+constexpr int kMaxNumRolls = 6 * kNumCheckersPerPlayer / 3 +
+                             kNumCheckersPerPlayer + 1;
+
+// The 21 distinct rolls, with the first die at most the second.
+constexpr int kNumRolls = 21;
+struct Roll {
+  int die1;
+  int die2;
+  double prob;
+};
+const std::array<Roll, kNumRolls>& Rolls() {
+  static const std::array<Roll, kNumRolls> rolls = [] {
+    std::array<Roll, kNumRolls> rolls;
+    int r = 0;
+    for (int die1 = 1; die1 <= 6; ++die1) {
+      for (int die2 = die1; die2 <= 6; ++die2) {
+        rolls[r++] = {die1, die2, die1 == die2 ? 1.0 / 36 : 2.0 / 36};
+      }
+    }
+    return rolls;
+  }();
+  return rolls;
+}
+
+int64_t Binomial(int n, int k) {
+  if (k < 0 || k > n) return 0;
+  int64_t result = 1;
+  for (int i = 1; i <= k; ++i) result = result * (n - k + i) / i;
+  return result;
+}
+
+int NumCheckers(const BearoffSide& side) {
+  int num_checkers = 0;
+  for (int checkers : side) num_checkers += checkers;
+  return num_checkers;
+}
+
+int Pips(const BearoffSide& side) {
+  int pips = 0;
+  for (int i = 0; i < kNumHomePoints; ++i) pips += (i + 1) * side[i];
+  return pips;
+}
+
+// Plays the dice in turn from side, and adds the indices of the sides it can
+// reach to children. A die can always be played while a checker is left: a
+// checker may bear off with a higher number than it needs if none is further.
+void PlayDice(const BearoffSide& side, const int* dice, int num_dice,
+              std::vector<int64_t>* children) {
+  int furthest = kNumHomePoints - 1;
+  while (furthest >= 0 && side[furthest] == 0) --furthest;
+  if (num_dice == 0 || furthest < 0) {
+    children->push_back(BearoffIndex(side));
+    return;
+  }
+  for (int i = 0; i <= furthest; ++i) {
+    if (side[i] == 0) continue;
+    const int to = i - dice[0];
+    if (to < -1 && i != furthest) continue;
+    BearoffSide next = side;
+    --next[i];
+    if (to >= 0) ++next[to];
+    PlayDice(next, dice + 1, num_dice - 1, children);
+  }
+}
+
+// The distinct sides the roll can lead to.
+std::vector<int64_t> Children(const BearoffSide& side, const Roll& roll) {
+  std::vector<int64_t> children;
+  if (roll.die1 == roll.die2) {
+    const int dice[4] = {roll.die1, roll.die1, roll.die1, roll.die1};
+    PlayDice(side, dice, 4, &children);
+  } else {
+    const int dice[2] = {roll.die1, roll.die2};
+    const int reversed[2] = {roll.die2, roll.die1};
+    PlayDice(side, dice, 2, &children);
+    PlayDice(side, reversed, 2, &children);
+  }
+  std::sort(children.begin(), children.end());
+  children.erase(std::unique(children.begin(), children.end()),
+                 children.end());
+  return children;
+}
+
+// Groups the items by level, so that each only depends on items of lower
+// levels, and calls fn(item) on the items of each level in turn, in parallel.
+void ForEachByLevel(const std::vector<int>& levels, int num_threads,
+                    const std::function<void(int64_t)>& fn) {
+  const int num_levels = *std::max_element(levels.begin(), levels.end()) + 1;
+  std::vector<int64_t> begin(num_levels + 1, 0);
+  for (int level : levels) ++begin[level + 1];
+  for (int l = 0; l < num_levels; ++l) begin[l + 1] += begin[l];
+  std::vector<int64_t> items(levels.size());
+  std::vector<int64_t> next(begin.begin(), begin.end() - 1);
+  for (int64_t item = 0; item < levels.size(); ++item) {
+    items[next[levels[item]]++] = item;
+  }
+  auto run = [&](int64_t first, int64_t last) {
+    for (int64_t i = first; i < last; ++i) fn(items[i]);
+  };
+  for (int l = 0; l < num_levels; ++l) {
+    const int64_t size = begin[l + 1] - begin[l];
+    if (num_threads <= 1 || size <= 1) {
+      run(begin[l], begin[l + 1]);
+    } else {
+      ThreadPool::Default()->ParallelFor(
+          begin[l], begin[l + 1], (size + num_threads - 1) / num_threads, run);
+    }
+  }
+}
+
+template <typename T>
+void WriteBytes(file::File* file, const T* data, int64_t size) {
+  SPIEL_CHECK_TRUE(file->Write(
+      absl::string_view(reinterpret_cast<const char*>(data), size * sizeof(T))));
+}
+
+}  // namespace
+
+int64_t BearoffIndex(const BearoffSide& side) {
+  // The checkers counted from the furthest point make a strictly increasing
+  // sequence, ranked by the combinatorial number system. Bearing off lowers
+  // the sequence, so every side reached from a side has a lower index.
+  int64_t index = 0;
+  int checkers = 0;
+  for (int k = 0; k < kNumHomePoints; ++k) {
+    SPIEL_CHECK_GE(side[kNumHomePoints - 1 - k], 0);
+    checkers += side[kNumHomePoints - 1 - k];
+    index += Binomial(checkers + k, k + 1);
+  }
+  return index;
+}
+
+BearoffSide BearoffSideFromIndex(int64_t index) {
+  SPIEL_CHECK_GE(index, 0);
+  std::array<int, kNumHomePoints> sequence;
+  for (int k = kNumHomePoints - 1; k >= 0; --k) {
+    int a = k;
+    while (Binomial(a + 1, k + 1) <= index) ++a;
+    sequence[k] = a;
+    index -= Binomial(a, k + 1);
+  }
+  BearoffSide side;
+  int previous = 0;
+  for (int k = 0; k < kNumHomePoints; ++k) {
+    const int checkers = sequence[k] - k;
+    side[kNumHomePoints - 1 - k] = checkers - previous;
+    previous = checkers;
+  }
+  return side;
+}
+
+int64_t NumBearoffSides(int num_checkers) {
+  return Binomial(num_checkers + kNumHomePoints, kNumHomePoints);
+}
+
+std::optional<BearoffSide> PlayerBearoffSide(const BackgammonState& state,
+                                             Player player) {
+  if (state.bar(player) > 0) return std::nullopt;
+  BearoffSide side;
+  for (int pos = 0; pos < kNumPoints; ++pos) {
+    // The home of X is 18-23, and that of O 0-5.
+    const int point = player == kXPlayerId ? kNumPoints - pos : pos + 1;
+    const int checkers = state.board(player, pos);
+    if (point > kNumHomePoints) {
+      if (checkers > 0) return std::nullopt;
+    } else {
+      side[point - 1] = checkers;
+    }
+  }
+  return side;
+}
+
+void BuildBearoffDatabase(const std::string& filename, int one_sided_checkers,
+                          int two_sided_checkers, int num_threads) {
+  SPIEL_CHECK_GE(one_sided_checkers, 1);
+  SPIEL_CHECK_LE(one_sided_checkers, kNumCheckersPerPlayer);
+  SPIEL_CHECK_GE(two_sided_checkers, 0);
+  SPIEL_CHECK_LE(two_sided_checkers, one_sided_checkers);
+  const std::array<Roll, kNumRolls>& rolls = Rolls();
+
+  // One-sided: each roll is played to the side needing the fewest rolls on
+  // average.
+  const int64_t num_one_sided = NumBearoffSides(one_sided_checkers);
+  std::vector<double> distributions(num_one_sided * kMaxNumRolls, 0.0);
+  std::vector<double> expected_rolls(num_one_sided, 0.0);
+  distributions[0] = 1.0;
+  std::vector<int> pips(num_one_sided);
+  for (int64_t s = 0; s < num_one_sided; ++s) {
+    pips[s] = Pips(BearoffSideFromIndex(s));
+  }
+  ForEachByLevel(pips, num_threads, [&](int64_t s) {
+    if (s == 0) return;
+    const BearoffSide side = BearoffSideFromIndex(s);
+    double* distribution = &distributions[s * kMaxNumRolls];
+    expected_rolls[s] = 1.0;
+    for (const Roll& roll : rolls) {
+      int64_t best = -1;
+      for (int64_t child : Children(side, roll)) {
+        if (best < 0 || expected_rolls[child] < expected_rolls[best]) {
+          best = child;
+        }
+      }
+      expected_rolls[s] += roll.prob * expected_rolls[best];
+      const double* child_distribution = &distributions[best * kMaxNumRolls];
+      for (int n = 1; n < kMaxNumRolls; ++n) {
+        distribution[n] += roll.prob * child_distribution[n - 1];
+      }
+    }
+  });
+  int num_rolls = 1;
+  for (int64_t s = 0; s < num_one_sided; ++s) {
+    for (int n = 0; n < kMaxNumRolls; ++n) {
+      if (distributions[s * kMaxNumRolls + n] > 0) {
+        num_rolls = std::max(num_rolls, n + 1);
+      }
+    }
+  }
+  SPIEL_CHECK_LT(num_rolls, kMaxNumRolls);
+  std::vector<float> packed_distributions(num_one_sided * num_rolls);
+  for (int64_t s = 0; s < num_one_sided; ++s) {
+    std::copy_n(&distributions[s * kMaxNumRolls], num_rolls,
+                &packed_distributions[s * num_rolls]);
+  }
+
+  // Two-sided: the probability w(a, b) that a, on roll against b, wins is the
+  // average over the rolls of the best 1 - w(b, c) over the sides c a can
+  // play to. The total pips of (b, c) are below those of (a, b).
+  const int64_t num_two_sided = NumBearoffSides(two_sided_checkers);
+  std::vector<std::vector<int64_t>> children(num_two_sided * kNumRolls);
+  for (int64_t s = 0; s < num_two_sided; ++s) {
+    const BearoffSide side = BearoffSideFromIndex(s);
+    for (int r = 0; r < kNumRolls; ++r) {
+      if (s > 0) children[s * kNumRolls + r] = Children(side, rolls[r]);
+    }
+  }
+  std::vector<float> two_sided(num_two_sided * num_two_sided, 0.0f);
+  std::vector<int> pair_pips(two_sided.size());
+  for (int64_t a = 0; a < num_two_sided; ++a) {
+    for (int64_t b = 0; b < num_two_sided; ++b) {
+      pair_pips[a * num_two_sided + b] = pips[a] + pips[b];
+    }
+  }
+  ForEachByLevel(pair_pips, num_threads, [&](int64_t pair) {
+    const int64_t a = pair / num_two_sided;
+    const int64_t b = pair % num_two_sided;
+    if (a == 0 || b == 0) {
+      // The game is over, won by the side with no checkers left.
+      two_sided[pair] = a == 0 && b > 0 ? 1.0f : 0.0f;
+      return;
+    }
+    double win = 0.0;
+    for (int r = 0; r < kNumRolls; ++r) {
+      double best = 0.0;
+      for (int64_t c : children[a * kNumRolls + r]) {
+        best = std::max(
+            best, c == 0 ? 1.0 : 1.0 - two_sided[b * num_two_sided + c]);
+      }
+      win += rolls[r].prob * best;
+    }
+    two_sided[pair] = win;
+  });
+
+  Header header;
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.num_points = kNumHomePoints;
+  header.one_sided_checkers = one_sided_checkers;
+  header.two_sided_checkers = two_sided_checkers;
+  header.num_rolls = num_rolls;
+  header.reserved = 0;
+
+  // Written next to the database first, so that it is never seen half
+  // written, even by processes which have it mapped.
+  const std::string tmp_filename = absl::StrCat(filename, ".tmp");
+  {
+    file::File file(tmp_filename, "wb");
+    WriteBytes(&file, &header, 1);
+    WriteBytes(&file, packed_distributions.data(),
+               packed_distributions.size());
+    WriteBytes(&file, two_sided.data(), two_sided.size());
+    SPIEL_CHECK_TRUE(file.Flush());
+  }
+  if (std::rename(tmp_filename.c_str(), filename.c_str()) != 0) {
+    SpielFatalError(absl::StrCat("Could not write the bearoff database ",
+                                 filename));
+  }
+}
+
+BearoffDatabase::BearoffDatabase(const std::string& filename)
+    : file_(filename, {file::MMapFile::Access::kRandom}) {
+  const char* data = file_.data();
+  const int64_t size = file_.size();
+  if (size < static_cast<int64_t>(sizeof(Header))) {
+    SpielFatalError(absl::StrCat(filename, " is not a bearoff database"));
+  }
+
+  const Header* header = reinterpret_cast<const Header*>(data);
+  if (std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0 ||
+      header->num_points != kNumHomePoints) {
+    SpielFatalError(absl::StrCat(filename, " is not a bearoff database"));
+  }
+  if (header->version != kVersion) {
+    SpielFatalError(absl::StrCat("Unsupported version ", header->version,
+                                 " of the bearoff database ", filename));
+  }
+  one_sided_checkers_ = header->one_sided_checkers;
+  two_sided_checkers_ = header->two_sided_checkers;
+  num_rolls_ = header->num_rolls;
+  num_one_sided_ = NumBearoffSides(one_sided_checkers_);
+  num_two_sided_ = NumBearoffSides(two_sided_checkers_);
+
+  const char* next = data + sizeof(Header);
+  distributions_ = reinterpret_cast<const float*>(next);
+  next += num_one_sided_ * num_rolls_ * sizeof(float);
+  two_sided_ = reinterpret_cast<const float*>(next);
+  next += num_two_sided_ * num_two_sided_ * sizeof(float);
+  if (next - data != size) {
+    SpielFatalError(absl::StrCat("The bearoff database ", filename,
+                                 " has the wrong size: ", size, " bytes "
+                                 "instead of ", next - data));
+  }
+}
+
+double BearoffDatabase::ExpectedRolls(int64_t side) const {
+  absl::Span<const float> distribution = RollDistribution(side);
+  double expected = 0.0;
+  for (int n = 0; n < num_rolls_; ++n) expected += n * distribution[n];
+  return expected;
+}
+
+double BearoffDatabase::OneSidedWinProbability(int64_t on_roll,
+                                               int64_t opponent) const {
+  absl::Span<const float> mine = RollDistribution(on_roll);
+  absl::Span<const float> theirs = RollDistribution(opponent);
+  double win = 0.0;
+  double theirs_at_least = 1.0;
+  for (int n = 0; n < num_rolls_; ++n) {
+    win += mine[n] * theirs_at_least;
+    theirs_at_least -= theirs[n];
+  }
+  return std::clamp(win, 0.0, 1.0);
+}
+
+double BearoffDatabase::WinProbability(int64_t on_roll,
+                                       int64_t opponent) const {
+  SPIEL_CHECK_TRUE(HasOneSided(on_roll));
+  SPIEL_CHECK_TRUE(HasOneSided(opponent));
+  return HasTwoSided(on_roll) && HasTwoSided(opponent)
+             ? TwoSidedWinProbability(on_roll, opponent)
+             : OneSidedWinProbability(on_roll, opponent);
+}
+
+std::optional<double> BearoffDatabase::Value(const BackgammonState& state,
+                                             bool* exact) const {
+  if (state.IsTerminal()) {
+    if (exact != nullptr) *exact = true;
+    return state.Returns()[kXPlayerId];
+  }
+  // Only single wins are counted.
+  if (state.GetGame()->MaxUtility() > 1 &&
+      (state.score(kXPlayerId) == 0 || state.score(kOPlayerId) == 0)) {
+    return std::nullopt;
+  }
+  std::array<int64_t, kNumPlayers> sides;
+  for (Player player : {kXPlayerId, kOPlayerId}) {
+    std::optional<BearoffSide> side = PlayerBearoffSide(state, player);
+    if (!side) return std::nullopt;
+    sides[player] = BearoffIndex(*side);
+    if (!HasOneSided(sides[player])) return std::nullopt;
+  }
+
+  if (state.IsChanceNode()) {
+    // The opponent of the player who moved last is to roll.
+    if (state.prev_player() == kChancePlayerId) return std::nullopt;
+    const Player on_roll = state.Opponent(state.prev_player());
+    const double value =
+        2 * WinProbability(sides[on_roll], sides[1 - on_roll]) - 1;
+    if (exact != nullptr) {
+      *exact = HasTwoSided(sides[0]) && HasTwoSided(sides[1]);
+    }
+    return on_roll == kXPlayerId ? value : -value;
+  }
+
+  // The dice are rolled: the value is that of the best move.
+  const Player player = state.CurrentPlayer();
+  double best = player == kXPlayerId ? -std::numeric_limits<double>::infinity()
+                                     : std::numeric_limits<double>::infinity();
+  bool all_exact = true;
+  for (Action action : state.LegalActions()) {
+    std::unique_ptr<State> child = state.Child(action);
+    bool child_exact = false;
+    std::optional<double> value =
+        Value(static_cast<const BackgammonState&>(*child), &child_exact);
+    if (!value) return std::nullopt;
+    all_exact = all_exact && child_exact;
+    best = player == kXPlayerId ? std::max(best, *value)
+                                : std::min(best, *value);
+  }
+  if (exact != nullptr) *exact = all_exact;
+  return best;
+}
+
+BearoffEvaluator::BearoffEvaluator(
+    std::shared_ptr<const BearoffDatabase> database,
+    std::shared_ptr<algorithms::Evaluator> fallback)
+    : database_(std::move(database)), fallback_(std::move(fallback)) {
+  SPIEL_CHECK_TRUE(database_ != nullptr);
+  SPIEL_CHECK_TRUE(fallback_ != nullptr);
+}
+
+std::vector<double> BearoffEvaluator::Evaluate(const State& state) {
+  std::optional<double> value =
+      database_->Value(static_cast<const BackgammonState&>(state));
+  if (!value) return fallback_->Evaluate(state);
+  return {*value, -*value};
+}
+
+ActionsAndProbs BearoffEvaluator::Prior(const State& state) {
+  return fallback_->Prior(state);
+}
+
+}  // namespace backgammon
+}  // namespace open_spiel
@@ -0,0 +1,152 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_GAMES_BACKGAMMON_BACKGAMMON_BEAROFF_H_
+#define OPEN_SPIEL_GAMES_BACKGAMMON_BACKGAMMON_BEAROFF_H_
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/types/span.h"
+#include "open_spiel/algorithms/mcts.h"
+#include "open_spiel/games/backgammon.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/utils/file.h"
+
+// Bearoff databases for backgammon: the odds of the positions where both
+// players have all their checkers in their home boards, or off, so that no
+// checker can be hit any more, computed once and written to a file which is
+// mapped into memory as it is to be looked up.
+//
+// The side of a player is identified by a combinatorial index of the number
+// of checkers on each of the six points of their home board, which ranks the
+// sides of up to n checkers from 0 (all off) to C(n + 6, 6) - 1, so the sides
+// with fewer checkers come first. The database holds:
+//  - one-sided: for each side of up to one_sided_checkers, the distribution
+//    of the number of rolls it takes to bear off when each roll is played to
+//    bear off in as few rolls as possible on average. Combining those of the
+//    two players gives the odds of the race, closely but not exactly;
+//  - two-sided: for each pair of sides of up to two_sided_checkers, the exact
+//    probability that the player on roll wins when both play perfectly.
+//
+// The file starts with a header, followed by the one-sided distributions and
+// the two-sided probabilities, as floats in the byte order of the machine.
+namespace open_spiel {
+namespace backgammon {
+
+inline constexpr int kNumHomePoints = 6;
+
+// The number of checkers on each point of a home board, the point i + 1 pips
+// away from bearing off first.
+using BearoffSide = std::array<int, kNumHomePoints>;
+
+// The index of a side, and back.
+int64_t BearoffIndex(const BearoffSide& side);
+BearoffSide BearoffSideFromIndex(int64_t index);
+
+// The number of sides of up to num_checkers checkers.
+int64_t NumBearoffSides(int num_checkers);
+
+// The side of the player in the state, or nothing if they have a checker on
+// the bar or outside their home board.
+std::optional<BearoffSide> PlayerBearoffSide(const BackgammonState& state,
+                                             Player player);
+
+// Computes the database and writes it to filename, on num_threads blocks
+// run on the shared ThreadPool. The two-sided table has NumBearoffSides(
+// two_sided_checkers)^2 entries, i.e. 853776 for 6 checkers.
+void BuildBearoffDatabase(const std::string& filename,
+                          int one_sided_checkers = kNumCheckersPerPlayer,
+                          int two_sided_checkers = 6, int num_threads = 1);
+
+// A database file, mapped read-only for as long as this lives. Lookups can be
+// made from several threads at once.
+class BearoffDatabase {
+ public:
+  explicit BearoffDatabase(const std::string& filename);
+
+  BearoffDatabase(const BearoffDatabase&) = delete;
+  BearoffDatabase& operator=(const BearoffDatabase&) = delete;
+
+  int OneSidedCheckers() const { return one_sided_checkers_; }
+  int TwoSidedCheckers() const { return two_sided_checkers_; }
+  bool HasOneSided(int64_t side) const { return side < num_one_sided_; }
+  bool HasTwoSided(int64_t side) const { return side < num_two_sided_; }
+
+  // The probability that the side bears off in exactly n rolls, for n in
+  // [0, MaxRolls()].
+  int MaxRolls() const { return num_rolls_ - 1; }
+  absl::Span<const float> RollDistribution(int64_t side) const {
+    return absl::MakeConstSpan(distributions_ + side * num_rolls_,
+                               num_rolls_);
+  }
+  double ExpectedRolls(int64_t side) const;
+
+  // The probability that the player on roll wins, from the one-sided
+  // distributions: the player on roll wins if they need at most as many rolls
+  // as their opponent.
+  double OneSidedWinProbability(int64_t on_roll, int64_t opponent) const;
+  // The exact probability, from the two-sided table.
+  double TwoSidedWinProbability(int64_t on_roll, int64_t opponent) const {
+    return two_sided_[on_roll * num_two_sided_ + opponent];
+  }
+  // The two-sided probability if both sides are in the table, and the
+  // one-sided one otherwise. Both sides must have one-sided entries.
+  double WinProbability(int64_t on_roll, int64_t opponent) const;
+
+  // The value of a bearoff position for player 0, the value of the other
+  // player being its opposite, or nothing if it is not a bearoff position in
+  // the database, or a gammon can still be scored. It is exact if both sides
+  // are in the two-sided table, in which case *exact is set to true. The
+  // players to move, but not the dice to roll, are searched exhaustively.
+  std::optional<double> Value(const BackgammonState& state,
+                              bool* exact = nullptr) const;
+
+ private:
+  file::MMapFile file_;
+  int one_sided_checkers_;
+  int two_sided_checkers_;
+  int num_rolls_;
+  int64_t num_one_sided_;
+  int64_t num_two_sided_;
+  const float* distributions_;
+  const float* two_sided_;
+};
+
+// An MCTS evaluator returning the values of the bearoff positions in the
+// database, and those of fallback for the others, so that once both players
+// are past contact the simulations stop at the leaf instead of rolling the
+// race out. The priors are always fallback's. The states must be
+// BackgammonStates.
+class BearoffEvaluator : public algorithms::Evaluator {
+ public:
+  BearoffEvaluator(std::shared_ptr<const BearoffDatabase> database,
+                   std::shared_ptr<algorithms::Evaluator> fallback);
+
+  std::vector<double> Evaluate(const State& state) override;
+  ActionsAndProbs Prior(const State& state) override;
+
+ private:
+  std::shared_ptr<const BearoffDatabase> database_;
+  std::shared_ptr<algorithms::Evaluator> fallback_;
+};
+
+}  // namespace backgammon
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_GAMES_BACKGAMMON_BACKGAMMON_BEAROFF_H_
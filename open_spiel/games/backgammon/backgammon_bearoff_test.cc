@@ -0,0 +1,187 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/games/backgammon/backgammon_bearoff.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/algorithms/mcts.h"
+#include "open_spiel/games/backgammon.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/file.h"
+
+namespace open_spiel {
+namespace backgammon {
+namespace {
+
+std::string DatabaseFilename() {
+  return absl::StrCat(file::GetTmpDir(), "/open_spiel-test-", std::rand(),
+                      "-bearoff.db");  // NOLINT
+}
+
+// The value for X, searching every roll and move to the end of the game.
+double Expectimax(const State& state) {
+  if (state.IsTerminal()) return state.Returns()[kXPlayerId];
+  if (state.IsChanceNode()) {
+    double value = 0;
+    for (const auto& [outcome, prob] : state.ChanceOutcomes()) {
+      value += prob * Expectimax(*state.Child(outcome));
+    }
+    return value;
+  }
+  const bool maximize = state.CurrentPlayer() == kXPlayerId;
+  double best = maximize ? -std::numeric_limits<double>::infinity()
+                         : std::numeric_limits<double>::infinity();
+  for (Action action : state.LegalActions()) {
+    const double value = Expectimax(*state.Child(action));
+    best = maximize ? std::max(best, value) : std::min(best, value);
+  }
+  return best;
+}
+
+// A state where X is to play the dice, with the checkers of both players in
+// their home boards.
+std::unique_ptr<State> BearoffState(const Game& game, const BearoffSide& x,
+                                    const BearoffSide& o,
+                                    const std::vector<int>& dice) {
+  std::vector<std::vector<int>> board(2, std::vector<int>(kNumPoints, 0));
+  for (int i = 0; i < kNumHomePoints; ++i) {
+    board[kXPlayerId][kNumPoints - 1 - i] = x[i];
+    board[kOPlayerId][i] = o[i];
+  }
+  std::vector<int> scores = {
+      kNumCheckersPerPlayer - std::accumulate(x.begin(), x.end(), 0),
+      kNumCheckersPerPlayer - std::accumulate(o.begin(), o.end(), 0)};
+  std::unique_ptr<State> state = game.NewInitialState();
+  static_cast<BackgammonState*>(state.get())
+      ->SetState(kXPlayerId, false, dice, {0, 0}, scores, board);
+  return state;
+}
+
+void BearoffIndexTest() {
+  const int64_t num_sides = NumBearoffSides(4);
+  SPIEL_CHECK_EQ(num_sides, 210);
+  for (int64_t index = 0; index < num_sides; ++index) {
+    const BearoffSide side = BearoffSideFromIndex(index);
+    SPIEL_CHECK_LE(std::accumulate(side.begin(), side.end(), 0), 4);
+    SPIEL_CHECK_EQ(BearoffIndex(side), index);
+  }
+  SPIEL_CHECK_EQ(BearoffIndex({0, 0, 0, 0, 0, 0}), 0);
+  // Moving a checker closer, or off, lowers the index.
+  SPIEL_CHECK_LT(BearoffIndex({1, 0, 0, 0, 0, 1}),
+                 BearoffIndex({0, 0, 0, 0, 0, 2}));
+  SPIEL_CHECK_LT(BearoffIndex({0, 0, 0, 0, 0, 1}),
+                 BearoffIndex({1, 0, 0, 0, 0, 1}));
+}
+
+void BearoffDatabaseTest() {
+  const std::string filename = DatabaseFilename();
+  BuildBearoffDatabase(filename, /*one_sided_checkers=*/5,
+                       /*two_sided_checkers=*/3, /*num_threads=*/4);
+  auto database = std::make_shared<const BearoffDatabase>(filename);
+  SPIEL_CHECK_EQ(database->OneSidedCheckers(), 5);
+  SPIEL_CHECK_EQ(database->TwoSidedCheckers(), 3);
+  for (int64_t side = 0; side < NumBearoffSides(5); ++side) {
+    absl::Span<const float> distribution = database->RollDistribution(side);
+    double total = 0;
+    for (float prob : distribution) total += prob;
+    SPIEL_CHECK_FLOAT_NEAR(total, 1.0, 1e-5);
+  }
+  SPIEL_CHECK_EQ(database->ExpectedRolls(0), 0);
+  SPIEL_CHECK_FLOAT_NEAR(
+      database->ExpectedRolls(BearoffIndex({1, 0, 0, 0, 0, 0})), 1.0, 1e-6);
+  // A checker on the 6-point bears off in one roll unless the roll is 1-1,
+  // 1-2, 1-3, 1-4 or 2-3, and in two otherwise.
+  SPIEL_CHECK_FLOAT_NEAR(
+      database->ExpectedRolls(BearoffIndex({0, 0, 0, 0, 0, 1})), 1 + 9. / 36,
+      1e-6);
+
+  // The two-sided values are exact under the rules of the game.
+  std::shared_ptr<const Game> game = LoadGame("backgammon");
+  const std::vector<std::vector<BearoffSide>> positions = {
+      {{1, 0, 0, 0, 0, 0}, {0, 0, 0, 0, 1, 0}},
+      {{0, 1, 1, 0, 0, 0}, {1, 1, 0, 0, 0, 0}},
+      {{0, 0, 0, 2, 0, 0}, {0, 1, 0, 0, 0, 0}},
+      {{0, 0, 1, 0, 0, 1}, {0, 0, 0, 0, 1, 0}},
+  };
+  for (const auto& position : positions) {
+    for (const std::vector<int>& dice :
+         std::vector<std::vector<int>>{{1, 2}, {3, 3}, {6, 5}}) {
+      std::unique_ptr<State> state =
+          BearoffState(*game, position[0], position[1], dice);
+      bool exact = false;
+      std::optional<double> value = database->Value(
+          static_cast<const BackgammonState&>(*state), &exact);
+      SPIEL_CHECK_TRUE(value.has_value());
+      SPIEL_CHECK_TRUE(exact);
+      SPIEL_CHECK_FLOAT_NEAR(*value, Expectimax(*state), 1e-5);
+    }
+    // The one-sided odds are close to the exact ones.
+    const int64_t x_side = BearoffIndex(position[0]);
+    const int64_t o_side = BearoffIndex(position[1]);
+    SPIEL_CHECK_FLOAT_NEAR(database->OneSidedWinProbability(x_side, o_side),
+                           database->TwoSidedWinProbability(x_side, o_side),
+                           0.05);
+  }
+
+  // Positions out of the tables, or with contact, are evaluated by the
+  // fallback.
+  BearoffEvaluator evaluator(
+      database, std::make_shared<algorithms::RandomRolloutEvaluator>(1, 0));
+  std::unique_ptr<State> state = BearoffState(
+      *game, {0, 0, 0, 0, 0, 4}, {0, 0, 0, 0, 0, 4}, {1, 2});
+  SPIEL_CHECK_TRUE(database->Value(
+      static_cast<const BackgammonState&>(*state)).has_value());
+  state = BearoffState(*game, {2, 2, 2, 0, 0, 0}, {1, 0, 0, 0, 0, 0}, {1, 2});
+  SPIEL_CHECK_FALSE(database->Value(
+      static_cast<const BackgammonState&>(*state)).has_value());
+  state = game->NewInitialState();
+  state->ApplyAction(state->LegalActions()[0]);
+  SPIEL_CHECK_FALSE(database->Value(
+      static_cast<const BackgammonState&>(*state)).has_value());
+  SPIEL_CHECK_EQ(evaluator.Evaluate(*state).size(), 2);
+  state = BearoffState(*game, {1, 0, 0, 0, 0, 0}, {0, 1, 0, 0, 0, 0}, {1, 2});
+  SPIEL_CHECK_TRUE(evaluator.Evaluate(*state) ==
+                   std::vector<double>({1.0, -1.0}));
+
+  // With gammons, the players who have both borne off a checker can only
+  // win a single point.
+  std::shared_ptr<const Game> gammons =
+      LoadGame("backgammon", {{"scoring_type",
+                               GameParameter(std::string("enable_gammons"))}});
+  state = BearoffState(*gammons, {1, 0, 0, 0, 0, 0}, {0, 1, 0, 0, 0, 0},
+                       {1, 2});
+  SPIEL_CHECK_TRUE(database->Value(
+      static_cast<const BackgammonState&>(*state)).has_value());
+  SPIEL_CHECK_TRUE(file::Remove(filename));
+}
+
+}  // namespace
+}  // namespace backgammon
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  open_spiel::backgammon::BearoffIndexTest();
+  open_spiel::backgammon::BearoffDatabaseTest();
+}
@@ -16,6 +16,8 @@
 
 #include <algorithm>
 #include <random>
+#include <set>
+#include <vector>
 
 #include "open_spiel/spiel.h"
 #include "open_spiel/tests/basic_tests.h"
@@ -333,6 +335,178 @@ void DoublesBearOffOutsideHome() {
   action = bstate->CheckerMovesToSpielMove({{20, 4, false}, {20, 4, false}});
   SPIEL_CHECK_TRUE(ActionsContains(legal_actions, action));
 }
+// The position and rules used by ReferenceLegalActions, which finds the legal
+// actions as the generator of the state did before it was rewritten to fill a
+// bitset: by listing every sequence of single checker moves in sets.
+struct ReferencePosition {
+  int player;
+  std::vector<int> dice;
+  std::vector<int> bar;
+  std::vector<std::vector<int>> board;
+
+  explicit ReferencePosition(const BackgammonState& state)
+      : player(state.CurrentPlayer()),
+        dice({state.dice(0), state.dice(1)}),
+        bar({state.bar(kXPlayerId), state.bar(kOPlayerId)}),
+        board(kNumPlayers, std::vector<int>(kNumPoints)) {
+    for (int p = 0; p < kNumPlayers; ++p) {
+      for (int pos = 0; pos < kNumPoints; ++pos) {
+        board[p][pos] = state.board(p, pos);
+      }
+    }
+  }
+
+  int PositionFrom(int pos, int spaces) const {
+    if (pos == kBarPos) return player == kXPlayerId ? -1 + spaces : 24 - spaces;
+    int new_pos = player == kXPlayerId ? pos + spaces : pos - spaces;
+    return new_pos < 0 || new_pos > 23 ? kScorePos : new_pos;
+  }
+
+  int NumOppCheckers(int pos) const { return board[1 - player][pos]; }
+
+  bool AllInHome() const {
+    if (bar[player] > 0) return false;
+    for (int i = player == kXPlayerId ? 0 : 6;
+         i <= (player == kXPlayerId ? 17 : 23); ++i) {
+      if (board[player][i] > 0) return false;
+    }
+    return true;
+  }
+
+  int FurthestCheckerInHome() const {
+    int furthest = -1;
+    for (int i = 0; i < 6; ++i) {
+      int pos = player == kXPlayerId ? 23 - i : i;
+      if (board[player][pos] > 0) furthest = pos;
+    }
+    return furthest;
+  }
+
+  std::set<CheckerMove> LegalCheckerMoves() const {
+    std::set<CheckerMove> moves;
+    if (bar[player] > 0) {
+      for (int outcome : dice) {
+        if (outcome < 1 || outcome > 6) continue;
+        int pos = PositionFrom(kBarPos, outcome);
+        if (NumOppCheckers(pos) <= 1) {
+          moves.insert(CheckerMove(kBarPos, outcome, NumOppCheckers(pos) == 1));
+        }
+      }
+      return moves;
+    }
+    bool all_in_home = AllInHome();
+    for (int i = 0; i < kNumPoints; ++i) {
+      if (board[player][i] == 0) continue;
+      for (int outcome : dice) {
+        if (outcome < 1 || outcome > 6) continue;
+        int pos = PositionFrom(i, outcome);
+        if (pos == kScorePos && all_in_home) {
+          if ((player == kXPlayerId && i + outcome == 24) ||
+              (player == kOPlayerId && i - outcome == -1) ||
+              i == FurthestCheckerInHome()) {
+            moves.insert(CheckerMove(i, outcome, false));
+          }
+        } else if (pos != kScorePos && NumOppCheckers(pos) <= 1) {
+          moves.insert(CheckerMove(i, outcome, NumOppCheckers(pos) == 1));
+        }
+      }
+    }
+    return moves;
+  }
+
+  void ApplyCheckerMove(const CheckerMove& move) {
+    if (move.pos == kBarPos) {
+      bar[player]--;
+    } else {
+      board[player][move.pos]--;
+    }
+    for (int& outcome : dice) {
+      if (outcome == move.num) {
+        outcome += 6;
+        break;
+      }
+    }
+    int next_pos = PositionFrom(move.pos, move.num);
+    if (next_pos == kScorePos) return;
+    board[player][next_pos]++;
+    if (board[1 - player][next_pos] == 1) {
+      board[1 - player][next_pos]--;
+      bar[1 - player]++;
+    }
+  }
+
+  // Adds the sequences of up to two checker moves from here to movelist and
+  // returns the length of the longest.
+  int RecLegalMoves(std::vector<CheckerMove> moveseq,
+                    std::set<std::vector<CheckerMove>>* movelist) const {
+    std::set<CheckerMove> moves_here;
+    if (moveseq.size() < 2) moves_here = LegalCheckerMoves();
+    if (moves_here.empty()) {
+      movelist->insert(moveseq);
+      return moveseq.size();
+    }
+    int max_moves = -1;
+    for (const CheckerMove& move : moves_here) {
+      ReferencePosition child = *this;
+      child.ApplyCheckerMove(move);
+      moveseq.push_back(move);
+      max_moves = std::max(max_moves, child.RecLegalMoves(moveseq, movelist));
+      moveseq.pop_back();
+    }
+    return max_moves;
+  }
+};
+
+std::vector<Action> ReferenceLegalActions(const BackgammonState& state) {
+  std::set<std::vector<CheckerMove>> movelist;
+  int max_moves = ReferencePosition(state).RecLegalMoves({}, &movelist);
+  std::vector<Action> legal_actions;
+  if (max_moves == 0) {
+    legal_actions.push_back(state.CheckerMovesToSpielMove(
+        {{kPassPos, -1, false}, {kPassPos, -1, false}}));
+    return legal_actions;
+  }
+  // Both dice must be used if possible, and otherwise the larger one.
+  int max_roll = -1;
+  for (const std::vector<CheckerMove>& moves : movelist) {
+    if (moves.size() == max_moves) max_roll = std::max(max_roll, moves[0].num);
+  }
+  for (const std::vector<CheckerMove>& moves : movelist) {
+    if (moves.size() == max_moves &&
+        (max_moves == 2 || moves[0].num == max_roll)) {
+      legal_actions.push_back(state.CheckerMovesToSpielMove(moves));
+    }
+  }
+  std::sort(legal_actions.begin(), legal_actions.end());
+  legal_actions.erase(std::unique(legal_actions.begin(), legal_actions.end()),
+                      legal_actions.end());
+  return legal_actions;
+}
+
+// Plays random games, checking that the legal actions of each decision node
+// are those of the reference generator, also from a clone of the state.
+void LegalActionsMatchReferenceTest() {
+  std::shared_ptr<const Game> game = LoadGame("backgammon");
+  std::mt19937 rng(0);
+  for (int i = 0; i < 100; ++i) {
+    std::unique_ptr<State> state = game->NewInitialState();
+    while (!state->IsTerminal()) {
+      std::vector<Action> legal_actions;
+      if (state->IsChanceNode()) {
+        legal_actions = state->LegalActions();
+      } else {
+        std::unique_ptr<State> clone = state->Clone();
+        legal_actions = state->LegalActions();
+        const auto& bstate = static_cast<const BackgammonState&>(*state);
+        SPIEL_CHECK_EQ(legal_actions, ReferenceLegalActions(bstate));
+        SPIEL_CHECK_EQ(clone->LegalActions(), legal_actions);
+      }
+      std::uniform_int_distribution<int> dist(0, legal_actions.size() - 1);
+      state->ApplyAction(legal_actions[dist(rng)]);
+    }
+  }
+}
+
 void HumanReadableNotation() {
   std::shared_ptr<const Game> game = LoadGame("backgammon");
   std::unique_ptr<State> state = game->NewInitialState();
@@ -536,4 +710,5 @@ int main(int argc, char** argv) {
   open_spiel::backgammon::DoublesBearOffOutsideHome();
   open_spiel::backgammon::BasicBackgammonTestsVaryScoring();
   open_spiel::backgammon::HumanReadableNotation();
+  open_spiel::backgammon::LegalActionsMatchReferenceTest();
 }
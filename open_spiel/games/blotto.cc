@@ -14,10 +14,13 @@
 
 #include "open_spiel/games/blotto.h"
 
+#include <limits>
+#include <numeric>
 #include <set>
 
 #include "open_spiel/game_parameters.h"
 #include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
 
 namespace open_spiel {
 namespace blotto {
@@ -54,14 +57,11 @@ REGISTER_SPIEL_GAME(kGameType, Factory);
 }  // namespace
 
 BlottoState::BlottoState(std::shared_ptr<const Game> game, int coins,
-                         int fields, const ActionMap* action_map,
-                         const std::vector<Action>* legal_actions)
+                         int fields)
     : NFGState(game),
       coins_(coins),
       fields_(fields),
       joint_action_({}),
-      action_map_(action_map),
-      legal_actions_(legal_actions),
       returns_({}) {}
 
 void BlottoState::DoApplyActions(const std::vector<Action>& actions) {
@@ -70,7 +70,12 @@ void BlottoState::DoApplyActions(const std::vector<Action>& actions) {
   // Now determine returns.
   returns_.resize(num_players_, 0);
   std::vector<int> scores(num_players_, 0);
+  const auto& game = static_cast<const BlottoGame&>(*game_);
   std::vector<std::vector<int>> player_actions;
+  player_actions.reserve(num_players_);
+  for (auto p = Player{0}; p < num_players_; ++p) {
+    player_actions.push_back(game.ActionToAllocation(joint_action_[p]));
+  }
 
   for (int f = 0; f < fields_; ++f) {
     int num_winners = 0;
@@ -78,11 +83,6 @@ void BlottoState::DoApplyActions(const std::vector<Action>& actions) {
     int max_value = -1;
 
     for (auto p = Player{0}; p < num_players_; ++p) {
-      // Get the expanded action if necessary.
-      if (p >= player_actions.size()) {
-        player_actions.push_back(action_map_->at(joint_action_[p]));
-      }
-
       if (player_actions[p][f] > max_value) {
         num_winners = 1;
         winner = p;
@@ -128,11 +128,14 @@ void BlottoState::DoApplyActions(const std::vector<Action>& actions) {
 
 std::vector<Action> BlottoState::LegalActions(Player player) const {
   if (IsTerminal()) return {};
-  return (*legal_actions_);
+  std::vector<Action> actions(game_->NumDistinctActions());
+  std::iota(actions.begin(), actions.end(), 0);
+  return actions;
 }
 
 std::string BlottoState::ActionToString(Player player, Action move_id) const {
-  return "[" + absl::StrJoin(action_map_->at(move_id), ",") + "]";
+  const auto& game = static_cast<const BlottoGame&>(*game_);
+  return "[" + absl::StrJoin(game.ActionToAllocation(move_id), ",") + "]";
 }
 
 std::string BlottoState::ToString() const {
@@ -155,41 +158,72 @@ std::unique_ptr<State> BlottoState::Clone() const {
 
 int BlottoGame::NumDistinctActions() const { return num_distinct_actions_; }
 
-void BlottoGame::CreateActionMapRec(int* count, int coins_left,
-                                    const std::vector<int>& action) {
-  if (action.size() == fields_) {
-    if (coins_left == 0) {
-      // All coins used, valid move.
-      (*action_map_)[*count] = action;
-      (*count)++;
-      return;
-    } else {
-      // Not all coins used, invalid move.
-      return;
+// The allocations are ordered lexicographically, so the action is found by
+// skipping, field by field, the blocks of allocations putting fewer coins on
+// it.
+std::vector<int> BlottoGame::ActionToAllocation(Action action) const {
+  SPIEL_CHECK_GE(action, 0);
+  SPIEL_CHECK_LT(action, num_distinct_actions_);
+  std::vector<int> allocation(fields_);
+  int coins_left = coins_;
+  for (int f = 0; f < fields_; ++f) {
+    int coins = 0;
+    while (action >= NumAllocations(coins_left - coins, fields_ - f - 1)) {
+      action -= NumAllocations(coins_left - coins, fields_ - f - 1);
+      ++coins;
     }
-  } else {
-    for (int num_coins = 0; num_coins <= coins_left; ++num_coins) {
-      std::vector<int> new_action = action;
-      new_action.push_back(num_coins);
-      CreateActionMapRec(count, coins_left - num_coins, new_action);
+    allocation[f] = coins;
+    coins_left -= coins;
+  }
+  return allocation;
+}
+
+Action BlottoGame::AllocationToAction(
+    const std::vector<int>& allocation) const {
+  SPIEL_CHECK_EQ(allocation.size(), fields_);
+  Action action = 0;
+  int coins_left = coins_;
+  for (int f = 0; f < fields_; ++f) {
+    SPIEL_CHECK_GE(allocation[f], 0);
+    SPIEL_CHECK_LE(allocation[f], coins_left);
+    for (int coins = 0; coins < allocation[f]; ++coins) {
+      action += NumAllocations(coins_left - coins, fields_ - f - 1);
     }
+    coins_left -= allocation[f];
   }
+  SPIEL_CHECK_EQ(coins_left, 0);
+  return action;
 }
 
 BlottoGame::BlottoGame(const GameParameters& params)
     : NormalFormGame(kGameType, params),
-      num_distinct_actions_(0),  // Set properly after CreateActionMap.
+      num_distinct_actions_(0),  // Set properly below.
       coins_(ParameterValue<int>("coins")),
       fields_(ParameterValue<int>("fields")),
       players_(ParameterValue<int>("players")) {
-  action_map_.reset(new ActionMap());
-  CreateActionMapRec(&num_distinct_actions_, coins_, {});
-
-  // The action set is static for all states, so create it only once.
-  legal_actions_.reset(new std::vector<Action>(num_distinct_actions_));
-  for (Action action = 0; action < num_distinct_actions_; ++action) {
-    (*legal_actions_)[action] = action;
+  SPIEL_CHECK_GE(coins_, 0);
+  SPIEL_CHECK_GE(fields_, 1);
+  // Putting c coins on f fields puts either none on the first field and all
+  // on the others, or one on the first and the other c - 1 on all f fields.
+  num_allocations_.resize((coins_ + 1) * (fields_ + 1));
+  for (int c = 0; c <= coins_; ++c) {
+    for (int f = 0; f <= fields_; ++f) {
+      int64_t& count = num_allocations_[c * (fields_ + 1) + f];
+      if (f == 0) {
+        count = c == 0 ? 1 : 0;
+      } else {
+        count = NumAllocations(c, f - 1);
+        if (c > 0) count += NumAllocations(c - 1, f);
+        count = std::min<int64_t>(count, std::numeric_limits<int>::max());
+      }
+    }
+  }
+  const int64_t num_actions = NumAllocations(coins_, fields_);
+  if (num_actions >= std::numeric_limits<int>::max()) {
+    SpielFatalError(absl::StrCat("Too many actions for blotto with ", coins_,
+                                 " coins and ", fields_, " fields."));
   }
+  num_distinct_actions_ = num_actions;
 }
 
 }  // namespace blotto
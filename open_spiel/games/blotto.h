@@ -15,9 +15,9 @@
 #ifndef OPEN_SPIEL_GAMES_BLOTTO_H_
 #define OPEN_SPIEL_GAMES_BLOTTO_H_
 
+#include <cstdint>
 #include <memory>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 #include "open_spiel/normal_form_game.h"
@@ -36,17 +36,18 @@
 //   "coins"      int    number of coins each player starts with (default: 10)
 //   "fields"     int    number of fields (default: 3)
 //   "players"    int    number of players (default: 2)
+//
+// The actions are the ways of putting all the coins on the fields, ordered
+// lexicographically by the coins on each field. They are not enumerated: an
+// action is turned into its allocation when needed, so that large instances
+// stay cheap to create.
 
 namespace open_spiel {
 namespace blotto {
 
-using ActionMap = std::unordered_map<Action, std::vector<int>>;
-
 class BlottoState : public NFGState {
  public:
-  BlottoState(std::shared_ptr<const Game> game, int coins, int fields,
-              const ActionMap* action_map,
-              const std::vector<Action>* legal_actions_);
+  BlottoState(std::shared_ptr<const Game> game, int coins, int fields);
 
   std::vector<Action> LegalActions(Player player) const override;
   std::string ActionToString(Player player, Action move_id) const override;
@@ -62,30 +63,17 @@ class BlottoState : public NFGState {
   int coins_;
   int fields_;
   std::vector<Action> joint_action_;  // The action taken by all the players.
-  const ActionMap* action_map_;
-  const std::vector<Action>* legal_actions_;
   std::vector<double> returns_;
 };
 
 class BlottoGame : public NormalFormGame {
  public:
   explicit BlottoGame(const GameParameters& params);
-  BlottoGame(const BlottoGame& other)
-      : NormalFormGame(other),
-        num_distinct_actions_(other.num_distinct_actions_),
-        coins_(other.coins_),
-        fields_(other.fields_),
-        players_(other.players_),
-        action_map_(
-            std::unique_ptr<ActionMap>(new ActionMap(*other.action_map_))),
-        legal_actions_(std::unique_ptr<std::vector<Action>>(
-            new std::vector<Action>(*other.legal_actions_))) {}
 
   int NumDistinctActions() const override;
   std::unique_ptr<State> NewInitialState() const override {
-    return std::unique_ptr<State>(new BlottoState(shared_from_this(), coins_,
-                                                  fields_, action_map_.get(),
-                                                  legal_actions_.get()));
+    return std::unique_ptr<State>(
+        new BlottoState(shared_from_this(), coins_, fields_));
   }
 
   int NumPlayers() const override { return players_; }
@@ -96,16 +84,23 @@ class BlottoGame : public NormalFormGame {
     return std::shared_ptr<const Game>(new BlottoGame(*this));
   }
 
+  // The coins the action puts on each field.
+  std::vector<int> ActionToAllocation(Action action) const;
+  // The inverse: the action putting these coins on the fields.
+  Action AllocationToAction(const std::vector<int>& allocation) const;
+
  private:
-  void CreateActionMapRec(int* count, int coins_left,
-                          const std::vector<int>& action);
+  // The number of ways of putting the coins on the fields.
+  int64_t NumAllocations(int coins, int fields) const {
+    return num_allocations_[coins * (fields_ + 1) + fields];
+  }
 
   int num_distinct_actions_;
   int coins_;
   int fields_;
   int players_;
-  std::unique_ptr<ActionMap> action_map_;
-  std::unique_ptr<std::vector<Action>> legal_actions_;
+  // NumAllocations for up to coins_ coins and fields_ fields.
+  std::vector<int64_t> num_allocations_;
 };
 
 }  // namespace blotto
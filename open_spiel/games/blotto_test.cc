@@ -12,7 +12,13 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include "open_spiel/games/blotto.h"
+
+#include <memory>
+#include <vector>
+
 #include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
 #include "open_spiel/tests/basic_tests.h"
 
 namespace open_spiel {
@@ -31,8 +37,60 @@ void BasicBlottoTests() {
   }
 }
 
+// The allocations of the coins, in the order of the actions.
+void AllAllocations(int coins_left, int fields, std::vector<int>* allocation,
+                    std::vector<std::vector<int>>* allocations) {
+  if (allocation->size() == fields - 1) {
+    allocation->push_back(coins_left);
+    allocations->push_back(*allocation);
+    allocation->pop_back();
+    return;
+  }
+  for (int coins = 0; coins <= coins_left; ++coins) {
+    allocation->push_back(coins);
+    AllAllocations(coins_left - coins, fields, allocation, allocations);
+    allocation->pop_back();
+  }
+}
+
+void ActionIndexingTest() {
+  for (int fields = 1; fields <= 4; ++fields) {
+    std::shared_ptr<const Game> game =
+        LoadGame("blotto", {{"coins", GameParameter(6)},
+                            {"fields", GameParameter(fields)}});
+    const auto& blotto_game = static_cast<const BlottoGame&>(*game);
+    std::vector<int> allocation;
+    std::vector<std::vector<int>> allocations;
+    AllAllocations(6, fields, &allocation, &allocations);
+    SPIEL_CHECK_EQ(game->NumDistinctActions(), allocations.size());
+    for (Action action = 0; action < allocations.size(); ++action) {
+      SPIEL_CHECK_EQ(blotto_game.ActionToAllocation(action),
+                     allocations[action]);
+      SPIEL_CHECK_EQ(blotto_game.AllocationToAction(allocations[action]),
+                     action);
+    }
+  }
+
+  // Too large to enumerate, but not to index.
+  std::shared_ptr<const Game> game = LoadGame(
+      "blotto", {{"coins", GameParameter(100)}, {"fields", GameParameter(6)}});
+  SPIEL_CHECK_EQ(game->NumDistinctActions(), 96560646);
+  std::unique_ptr<State> state = game->NewInitialState();
+  SPIEL_CHECK_EQ(state->ActionToString(0, 0), "[0,0,0,0,0,100]");
+  SPIEL_CHECK_EQ(state->ActionToString(0, game->NumDistinctActions() - 1),
+                 "[100,0,0,0,0,0]");
+  const auto& blotto_game = static_cast<const BlottoGame&>(*game);
+  const std::vector<int> allocation = {10, 20, 0, 30, 15, 25};
+  SPIEL_CHECK_EQ(blotto_game.ActionToAllocation(
+                     blotto_game.AllocationToAction(allocation)),
+                 allocation);
+}
+
 }  // namespace
 }  // namespace blotto
 }  // namespace open_spiel
 
-int main(int argc, char** argv) { open_spiel::blotto::BasicBlottoTests(); }
+int main(int argc, char** argv) {
+  open_spiel::blotto::BasicBlottoTests();
+  open_spiel::blotto::ActionIndexingTest();
+}
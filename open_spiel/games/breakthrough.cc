@@ -15,11 +15,14 @@
 #include "open_spiel/games/breakthrough.h"
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "open_spiel/game_parameters.h"
+#include "open_spiel/utils/plane_encoding.h"
 #include "open_spiel/utils/tensor_view.h"
 
 namespace open_spiel {
@@ -55,7 +58,9 @@ const GameType kGameType{/*short_name=*/"breakthrough",
                          /*provides_observation_tensor=*/true,
                          /*parameter_specification=*/
                          {{"rows", GameParameter(kDefaultRows)},
-                          {"columns", GameParameter(kDefaultColumns)}}};
+                          {"columns", GameParameter(kDefaultColumns)}},
+                         /*default_loadable=*/true,
+                         /*hash_determines_observation=*/true};
 
 std::shared_ptr<const Game> Factory(const GameParameters& params) {
   return std::shared_ptr<const Game>(new BreakthroughGame(params));
@@ -63,6 +68,15 @@ std::shared_ptr<const Game> Factory(const GameParameters& params) {
 
 REGISTER_SPIEL_GAME(kGameType, Factory);
 
+// Zobrist key of a piece on a cell; empty cells do not contribute to the hash.
+uint64_t CellKey(int cell, CellState state) {
+  if (state == CellState::kEmpty) return 0;
+  return MixBits(cell * kCellStates + static_cast<int>(state));
+}
+
+// Zobrist key for white (player 1) to play.
+constexpr uint64_t kWhiteToPlayKey = 0x65d200ce55b19ad8ULL;
+
 int StateToPlayer(CellState state) {
   switch (state) {
     case CellState::kBlack:
@@ -114,6 +128,55 @@ std::string ColLabel(int col) {
   return label;
 }
 
+// Calls f on each legal action of the player on a kRows x kCols board kept as
+// bitboards, in the same increasing order as the generic loop.
+template <int kRows, int kCols, typename F>
+void ForEachBitboardLegalAction(
+    const std::array<uint64_t, kNumPlayers>& piece_bits, Player player,
+    const F& f) {
+  static_assert(kRows * kCols <= kMaxBitboardCells);
+  constexpr int kCells = kRows * kCols;
+  constexpr uint64_t kBoardMask =
+      kCells == 64 ? ~uint64_t{0} : (uint64_t{1} << kCells) - 1;
+  constexpr uint64_t kFirstColumn = [] {
+    uint64_t mask = 0;
+    for (int r = 0; r < kRows; ++r) mask |= uint64_t{1} << (r * kCols);
+    return mask;
+  }();
+  constexpr uint64_t kLastColumn = kFirstColumn << (kCols - 1);
+
+  const uint64_t own = piece_bits[player];
+  const uint64_t opponent = piece_bits[1 - player];
+  const uint64_t empty = ~(own | opponent) & kBoardMask;
+  const uint64_t diagonal_targets = empty | opponent;
+
+  // The pieces which can move to the left, forward and to the right, black
+  // going up the rows and white down.
+  std::array<uint64_t, kNumDirections / 2> movers;
+  if (player == kBlackPlayerId) {
+    movers = {own & ~kFirstColumn & (diagonal_targets >> (kCols - 1)),
+              own & (empty >> kCols),
+              own & ~kLastColumn & (diagonal_targets >> (kCols + 1))};
+  } else {
+    movers = {own & ~kFirstColumn & (diagonal_targets << (kCols + 1)),
+              own & (empty << kCols),
+              own & ~kLastColumn & (diagonal_targets << (kCols - 1))};
+  }
+  const int row_offset = player == kBlackPlayerId ? kCols : -kCols;
+  const int first_dir = player * kNumDirections / 2;
+
+  for (uint64_t pieces = movers[0] | movers[1] | movers[2]; pieces;
+       pieces &= pieces - 1) {
+    const int cell = __builtin_ctzll(pieces);
+    for (int o = 0; o < kNumDirections / 2; o++) {
+      if (!((movers[o] >> cell) & 1)) continue;
+      const int target = cell + row_offset + o - 1;
+      const int capture = (opponent >> target) & 1;
+      f((cell * kNumDirections + first_dir + o) * 2 + capture);
+    }
+  }
+}
+
 }  // namespace
 
 BreakthroughState::BreakthroughState(std::shared_ptr<const Game> game, int rows,
@@ -122,7 +185,9 @@ BreakthroughState::BreakthroughState(std::shared_ptr<const Game> game, int rows,
   SPIEL_CHECK_GT(rows_, 1);
   SPIEL_CHECK_GT(cols_, 1);
 
-  board_ = std::vector<CellState>(rows_ * cols_, CellState::kEmpty);
+  if (rows_ * cols_ > kMaxBitboardCells) {
+    board_ = std::vector<CellState>(rows_ * cols_, CellState::kEmpty);
+  }
   for (int r = 0; r < rows_; r++) {
     for (int c = 0; c < cols_; c++) {
       // Only use two rows if there are at least 6 rows.
@@ -141,6 +206,33 @@ BreakthroughState::BreakthroughState(std::shared_ptr<const Game> game, int rows,
   total_moves_ = 0;
 }
 
+void BreakthroughState::SetBoard(int r, int c, CellState cs) {
+  const int cell = r * cols_ + c;
+  hash_ ^= CellKey(cell, board(r, c)) ^ CellKey(cell, cs);
+  if (!board_.empty()) {
+    board_[cell] = cs;
+    return;
+  }
+  const uint64_t bit = uint64_t{1} << cell;
+  piece_bits_[kBlackPlayerId] &= ~bit;
+  piece_bits_[kWhitePlayerId] &= ~bit;
+  if (cs != CellState::kEmpty) piece_bits_[StateToPlayer(cs)] |= bit;
+}
+
+void BreakthroughState::DecodeAction(Action action, int* r1, int* c1,
+                                     int* dir, bool* capture) const {
+  *capture = action % 2 == 1;
+  action /= 2;
+  *dir = action % kNumDirections;
+  const int cell = action / kNumDirections;
+  *r1 = cell / cols_;
+  *c1 = cell % cols_;
+}
+
+uint64_t BreakthroughState::HashValue() const {
+  return cur_player_ == kWhitePlayerId ? hash_ ^ kWhiteToPlayKey : hash_;
+}
+
 int BreakthroughState::CurrentPlayer() const {
   if (IsTerminal()) {
     return kTerminalPlayerId;
@@ -150,12 +242,9 @@ int BreakthroughState::CurrentPlayer() const {
 }
 
 void BreakthroughState::DoApplyAction(Action action) {
-  std::vector<int> values(4, -1);
-  UnrankActionMixedBase(action, {rows_, cols_, kNumDirections, 2}, &values);
-  int r1 = values[0];
-  int c1 = values[1];
-  int dir = values[2];
-  bool capture = values[3] == 1;
+  int r1, c1, dir;
+  bool capture;
+  DecodeAction(action, &r1, &c1, &dir, &capture);
   int r2 = r1 + kDirRowOffsets[dir];
   int c2 = c1 + kDirColOffsets[dir];
 
@@ -193,12 +282,9 @@ void BreakthroughState::DoApplyAction(Action action) {
 
 std::string BreakthroughState::ActionToString(Player player,
                                               Action action) const {
-  std::vector<int> values(4, -1);
-  UnrankActionMixedBase(action, {rows_, cols_, kNumDirections, 2}, &values);
-  int r1 = values[0];
-  int c1 = values[1];
-  int dir = values[2];
-  bool capture = values[3] == 1;
+  int r1, c1, dir;
+  bool capture;
+  DecodeAction(action, &r1, &c1, &dir, &capture);
   int r2 = r1 + kDirRowOffsets[dir];
   int c2 = c1 + kDirColOffsets[dir];
 
@@ -216,8 +302,22 @@ std::string BreakthroughState::ActionToString(Player player,
 
 std::vector<Action> BreakthroughState::LegalActions() const {
   std::vector<Action> movelist;
-  if (IsTerminal()) return movelist;
+  LegalActions(&movelist);
+  return movelist;
+}
+
+void BreakthroughState::LegalActions(std::vector<Action>* movelist) const {
+  movelist->clear();
+  if (IsTerminal()) return;
   const Player player = CurrentPlayer();
+  const auto add = [movelist](Action action) { movelist->push_back(action); };
+  if (board_.empty() && rows_ == 8 && cols_ == 8) {
+    ForEachBitboardLegalAction<8, 8>(piece_bits_, player, add);
+    return;
+  } else if (board_.empty() && rows_ == 6 && cols_ == 6) {
+    ForEachBitboardLegalAction<6, 6>(piece_bits_, player, add);
+    return;
+  }
   CellState mystate = PlayerToState(player);
   std::vector<int> action_bases = {rows_, cols_, kNumDirections, 2};
   std::vector<int> action_values = {0, 0, 0, 0};
@@ -237,13 +337,13 @@ std::vector<Action> BreakthroughState::LegalActions() const {
             if (board(rp, cp) == CellState::kEmpty) {
               // Regular move.
               action_values[3] = 0;
-              movelist.push_back(
+              movelist->push_back(
                   RankActionMixedBase(action_bases, action_values));
             } else if ((o == 0 || o == 2) &&
                        board(rp, cp) == OpponentState(mystate)) {
               // Capture move (can only capture diagonally)
               action_values[3] = 1;
-              movelist.push_back(
+              movelist->push_back(
                   RankActionMixedBase(action_bases, action_values));
             }
           }
@@ -251,8 +351,24 @@ std::vector<Action> BreakthroughState::LegalActions() const {
       }
     }
   }
+}
 
-  return movelist;
+void BreakthroughState::LegalActionsMask(Player player,
+                                         absl::Span<uint8_t> mask) const {
+  if (!board_.empty() || !((rows_ == 8 && cols_ == 8) ||
+                           (rows_ == 6 && cols_ == 6))) {
+    State::LegalActionsMask(player, mask);
+    return;
+  }
+  SPIEL_CHECK_EQ(mask.size(), num_distinct_actions_);
+  std::fill(mask.begin(), mask.end(), 0);
+  if (player != CurrentPlayer()) return;
+  const auto set = [mask](Action action) { mask[action] = 1; };
+  if (rows_ == 8) {
+    ForEachBitboardLegalAction<8, 8>(piece_bits_, player, set);
+  } else {
+    ForEachBitboardLegalAction<6, 6>(piece_bits_, player, set);
+  }
 }
 
 bool BreakthroughState::InBounds(int r, int c) const {
@@ -323,29 +439,72 @@ std::string BreakthroughState::ObservationString(Player player) const {
   return ToString();
 }
 
-void BreakthroughState::ObservationTensor(Player player,
-                                          std::vector<double>* values) const {
+template <typename T>
+void BreakthroughState::WriteObservationTensor(Player player,
+                                               absl::Span<T> values) const {
   SPIEL_CHECK_GE(player, 0);
   SPIEL_CHECK_LT(player, num_players_);
 
-  TensorView<3> view(values, {kCellStates, rows_, cols_}, true);
+  const int num_cells = rows_ * cols_;
+  SPIEL_CHECK_EQ(values.size(), kCellStates * num_cells);
+  if (board_.empty()) {
+    // The planes of black, white and the empty cells, from the bitboards.
+    const uint64_t black = piece_bits_[kBlackPlayerId];
+    const uint64_t white = piece_bits_[kWhitePlayerId];
+    BitboardPlane(black, values.subspan(0, num_cells));
+    BitboardPlane(white, values.subspan(num_cells, num_cells));
+    BitboardPlane(~(black | white), values.subspan(2 * num_cells, num_cells));
+    return;
+  }
+  OneHotPlanes(
+      num_cells, kCellStates,
+      [this](int cell) {
+        return observation_plane(cell / cols_, cell % cols_);
+      },
+      values);
+}
 
-  for (int r = 0; r < rows_; r++) {
-    for (int c = 0; c < cols_; c++) {
-      int plane = observation_plane(r, c);
-      SPIEL_CHECK_TRUE(plane >= 0 && plane < kCellStates);
-      view[{plane, r, c}] = 1.0;
-    }
+void BreakthroughState::ObservationTensor(Player player,
+                                          std::vector<double>* values) const {
+  values->resize(kCellStates * rows_ * cols_);
+  WriteObservationTensor(player, absl::MakeSpan(*values));
+}
+
+void BreakthroughState::ObservationTensor(Player player,
+                                          absl::Span<float> values) const {
+  WriteObservationTensor(player, values);
+}
+
+void BreakthroughState::ObservationTensor(Player player,
+                                          absl::Span<uint8_t> values) const {
+  WriteObservationTensor(player, values);
+}
+
+bool BreakthroughState::UpdateObservationTensor(
+    Player player, absl::Span<float> values) const {
+  SPIEL_CHECK_GE(player, 0);
+  SPIEL_CHECK_LT(player, num_players_);
+  SPIEL_CHECK_FALSE(history_.empty());
+
+  // A move only changes the cell it leaves and the one it enters.
+  int r1, c1, dir;
+  bool capture;
+  DecodeAction(history_.back(), &r1, &c1, &dir, &capture);
+  const std::array<std::pair<int, int>, 2> cells = {
+      {{r1, c1}, {r1 + kDirRowOffsets[dir], c1 + kDirColOffsets[dir]}}};
+
+  TensorView<3, float> view(values, {kCellStates, rows_, cols_}, false);
+  for (const auto& [r, c] : cells) {
+    const int plane = observation_plane(r, c);
+    for (int p = 0; p < kCellStates; ++p) view[{p, r, c}] = p == plane;
   }
+  return true;
 }
 
 void BreakthroughState::UndoAction(Player player, Action action) {
-  std::vector<int> values(4, -1);
-  UnrankActionMixedBase(action, {rows_, cols_, kNumDirections, 2}, &values);
-  int r1 = values[0];
-  int c1 = values[1];
-  int dir = values[2];
-  bool capture = values[3] == 1;
+  int r1, c1, dir;
+  bool capture;
+  DecodeAction(action, &r1, &c1, &dir, &capture);
   int r2 = r1 + kDirRowOffsets[dir];
   int c2 = c1 + kDirColOffsets[dir];
 
@@ -370,13 +529,23 @@ void BreakthroughState::UndoAction(Player player, Action action) {
       pieces_[0]++;
     }
   }
-  history_.pop_back();
+  PopHistory();
+}
+
+int64_t BreakthroughState::ApproximateMemoryUsage() const {
+  return sizeof(*this) + HistoryMemoryUsage() +
+         board_.capacity() * sizeof(CellState);
 }
 
 std::unique_ptr<State> BreakthroughState::Clone() const {
   return std::unique_ptr<State>(new BreakthroughState(*this));
 }
 
+bool BreakthroughState::CopyFrom(const State& other) {
+  *this = static_cast<const BreakthroughState&>(other);
+  return true;
+}
+
 BreakthroughGame::BreakthroughGame(const GameParameters& params)
     : Game(kGameType, params),
       rows_(ParameterValue<int>("rows")),
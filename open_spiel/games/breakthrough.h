@@ -16,10 +16,12 @@
 #define OPEN_SPIEL_GAMES_BREAKTHROUGH_H_
 
 #include <array>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include "open_spiel/abseil-cpp/absl/types/span.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
 
@@ -40,6 +42,7 @@ inline constexpr int kCellStates =
     1 + kNumPlayers;  // player 0, player 1, empty.
 inline constexpr int kDefaultRows = 8;
 inline constexpr int kDefaultColumns = 8;
+inline constexpr int kMaxBitboardCells = 64;
 
 // State of a cell.
 enum class CellState {
@@ -60,24 +63,57 @@ class BreakthroughState : public State {
   std::string ObservationString(Player player) const override;
   void ObservationTensor(Player player,
                          std::vector<double>* values) const override;
+  void ObservationTensor(Player player,
+                         absl::Span<float> values) const override;
+  void ObservationTensor(Player player,
+                         absl::Span<uint8_t> values) const override;
+  bool UpdateObservationTensor(Player player,
+                               absl::Span<float> values) const override;
   std::unique_ptr<State> Clone() const override;
+  bool CopyFrom(const State& other) override;
+  int64_t ApproximateMemoryUsage() const override;
+  uint64_t HashValue() const override;
   void UndoAction(Player player, Action action) override;
+  bool SupportsUndoAction() const override { return true; }
 
   bool InBounds(int r, int c) const;
-  void SetBoard(int r, int c, CellState cs) { board_[r * cols_ + c] = cs; }
+  void SetBoard(int r, int c, CellState cs);
   void SetPieces(int idx, int value) { pieces_[idx] = value; }
-  CellState board(int row, int col) const { return board_[row * cols_ + col]; }
+  CellState board(int row, int col) const {
+    const int cell = row * cols_ + col;
+    if (!board_.empty()) return board_[cell];
+    if ((piece_bits_[kBlackPlayerId] >> cell) & 1) return CellState::kBlack;
+    if ((piece_bits_[kWhitePlayerId] >> cell) & 1) return CellState::kWhite;
+    return CellState::kEmpty;
+  }
   int pieces(int idx) const { return pieces_[idx]; }
   int rows() const { return rows_; }
   int cols() const { return cols_; }
   std::vector<Action> LegalActions() const override;
+  void LegalActions(std::vector<Action>* actions) const override;
+  void LegalActionsMask(Player player,
+                        absl::Span<uint8_t> mask) const override;
   std::string Serialize() const override;
 
+  // The cells of the player's pieces, bit row * cols() + col. Only for boards
+  // of at most 64 cells.
+  uint64_t PieceBits(Player player) const {
+    SPIEL_CHECK_TRUE(board_.empty());
+    return piece_bits_[player];
+  }
+
  protected:
   void DoApplyAction(Action action) override;
 
  private:
+  // Shared implementation of the ObservationTensor overloads.
+  template <typename T>
+  void WriteObservationTensor(Player player, absl::Span<T> values) const;
   int observation_plane(int r, int c) const;
+  // Decodes an action into the cell it moves from, its direction, and whether
+  // it is a capture.
+  void DecodeAction(Action action, int* r1, int* c1, int* dir,
+                    bool* capture) const;
 
   // Fields sets to bad/invalid values. Use Game::NewInitialState().
   Player cur_player_ = kInvalidPlayer;
@@ -86,7 +122,12 @@ class BreakthroughState : public State {
   std::array<int, 2> pieces_;
   int rows_ = -1;
   int cols_ = -1;
-  std::vector<CellState> board_;  // for (row,col) we use row*cols_ + col.
+  // Boards of at most 64 cells are kept as one bitboard per player, using bit
+  // row*cols_ + col; board_ is left empty. Larger boards use board_, with
+  // row*cols_ + col for (row,col).
+  std::array<uint64_t, kNumPlayers> piece_bits_ = {0, 0};
+  std::vector<CellState> board_;
+  uint64_t hash_ = 0;             // Zobrist hash of the board.
 };
 
 class BreakthroughGame : public Game {
@@ -14,7 +14,12 @@
 
 #include "open_spiel/games/breakthrough.h"
 
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
 #include "open_spiel/tests/basic_tests.h"
 
 namespace open_spiel {
@@ -36,6 +41,33 @@ void BasicBreakthroughTests() {
   testing::RandomSimTest(*LoadGame("breakthrough"), 100);
 }
 
+void BoardSizesTest() {
+  // Bitboards with and without their fast paths, and the generic board.
+  testing::RandomSimTest(*LoadGame("breakthrough(rows=6,columns=6)"), 50);
+  testing::RandomSimTest(*LoadGame("breakthrough(rows=5,columns=7)"), 50);
+  testing::RandomSimTest(*LoadGame("breakthrough(rows=9,columns=9)"), 10);
+}
+
+void CaptureTest() {
+  // Black on d5 is blocked by white on d4, and can capture on e4.
+  std::shared_ptr<const Game> game = LoadGame("breakthrough");
+  std::string board(64, '.');
+  board[3 * 8 + 3] = 'b';
+  board[4 * 8 + 3] = 'w';
+  board[4 * 8 + 4] = 'w';
+  std::unique_ptr<State> state = game->DeserializeState(board);
+  const auto& bt_state = static_cast<const BreakthroughState&>(*state);
+  SPIEL_CHECK_EQ(bt_state.PieceBits(kBlackPlayerId), uint64_t{1} << 27);
+  std::vector<Action> actions = state->LegalActions();
+  SPIEL_CHECK_EQ(actions.size(), 2);
+  SPIEL_CHECK_EQ(state->ActionToString(kBlackPlayerId, actions[0]), "d5c4");
+  SPIEL_CHECK_EQ(state->ActionToString(kBlackPlayerId, actions[1]), "d5e4*");
+  state->ApplyAction(actions[1]);
+  SPIEL_CHECK_EQ(bt_state.pieces(kWhitePlayerId), 1);
+  SPIEL_CHECK_EQ(bt_state.PieceBits(kBlackPlayerId), uint64_t{1} << 36);
+  SPIEL_CHECK_EQ(bt_state.PieceBits(kWhitePlayerId), uint64_t{1} << 35);
+}
+
 }  // namespace
 }  // namespace breakthrough
 }  // namespace open_spiel
@@ -43,4 +75,6 @@ void BasicBreakthroughTests() {
 int main(int argc, char** argv) {
   open_spiel::breakthrough::BasicSerializationTest();
   open_spiel::breakthrough::BasicBreakthroughTests();
+  open_spiel::breakthrough::BoardSizesTest();
+  open_spiel::breakthrough::CaptureTest();
 }
@@ -14,24 +14,23 @@
 
 #include "open_spiel/games/bridge.h"
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <cstring>
+#include <functional>
 #include <memory>
+#include <vector>
 
 #include "open_spiel/abseil-cpp/absl/strings/str_format.h"
 #include "open_spiel/abseil-cpp/absl/strings/string_view.h"
 #include "open_spiel/games/bridge/double_dummy_solver/include/dll.h"
 #include "open_spiel/game_parameters.h"
 #include "open_spiel/games/bridge/bridge_scoring.h"
+#include "open_spiel/games/bridge/double_dummy_cache.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
-
-// Our preferred version of the double_dummy_solver defines a DDS_EXTERNAL
-// macro to add a prefix to the exported symbols to avoid name clashes.
-// In order to compile with versions of the double_dummy_solver which do not
-// do this, we define DDS_EXTERNAL as an identity if it isn't already defined.
-#ifndef DDS_EXTERNAL
-#define DDS_EXTERNAL(x) x
-#endif
+#include "open_spiel/utils/constrained_deal.h"
 
 namespace open_spiel {
 namespace bridge {
@@ -342,52 +341,50 @@ std::string BridgeState::ObservationString(Player player) const {
   return rv;
 }
 
-void BridgeState::ObservationTensor(Player player,
-                                    std::vector<double>* values) const {
-  SPIEL_CHECK_GE(player, 0);
-  SPIEL_CHECK_LT(player, num_players_);
-
-  std::fill(values->begin(), values->end(), 0.0);
-  values->resize(game_->ObservationTensorSize());
+template <typename SetOne>
+void BridgeState::WriteObservationTensor(Player player, SetOne set_one) const {
   if (phase_ == Phase::kGameOver || phase_ == Phase::kDeal) return;
   int partnership = Partnership(player);
-  auto ptr = values->begin();
+  int offset = 0;
   if (num_cards_played_ > 0) {
     // Observation for play phase
-    if (phase_ == Phase::kPlay) ptr[2] = 1;
-    ptr += kNumObservationTypes;
+    if (phase_ == Phase::kPlay) set_one(offset + 2);
+    offset += kNumObservationTypes;
 
     // Contract
-    ptr[contract_.level - 1] = 1;
-    ptr += kNumBidLevels;
+    set_one(offset + contract_.level - 1);
+    offset += kNumBidLevels;
 
     // Trump suit
-    ptr[contract_.trumps] = 1;
-    ptr += kNumDenominations;
+    set_one(offset + contract_.trumps);
+    offset += kNumDenominations;
 
     // Double status
-    *ptr++ = contract_.double_status == DoubleStatus::kUndoubled;
-    *ptr++ = contract_.double_status == DoubleStatus::kDoubled;
-    *ptr++ = contract_.double_status == DoubleStatus::kRedoubled;
+    if (contract_.double_status == DoubleStatus::kUndoubled) set_one(offset);
+    if (contract_.double_status == DoubleStatus::kDoubled) set_one(offset + 1);
+    if (contract_.double_status == DoubleStatus::kRedoubled) {
+      set_one(offset + 2);
+    }
+    offset += kNumOtherCalls;
 
     // Identity of the declarer.
-    ptr[(contract_.declarer + kNumPlayers - player) % kNumPlayers] = 1;
-    ptr += kNumPlayers;
+    set_one(offset + (contract_.declarer + kNumPlayers - player) % kNumPlayers);
+    offset += kNumPlayers;
 
     // Vulnerability.
-    ptr[is_vulnerable_[Partnership(contract_.declarer)]] = 1.0;
-    ptr += kNumVulnerabilities;
+    set_one(offset + is_vulnerable_[Partnership(contract_.declarer)]);
+    offset += kNumVulnerabilities;
 
     // Our remaining cards.
     for (int i = 0; i < kNumCards; ++i)
-      if (holder_[i] == player) ptr[i] = 1;
-    ptr += kNumCards;
+      if (holder_[i] == player) set_one(offset + i);
+    offset += kNumCards;
 
     // Dummy's remaining cards.
     const int dummy = contract_.declarer ^ 2;
     for (int i = 0; i < kNumCards; ++i)
-      if (holder_[i] == dummy) ptr[i] = 1;
-    ptr += kNumCards;
+      if (holder_[i] == dummy) set_one(offset + i);
+    offset += kNumCards;
 
     // Indexing into history for recent tricks.
     int current_trick = num_cards_played_ / kNumPlayers;
@@ -400,64 +397,87 @@ void BridgeState::ObservationTensor(Player player,
       for (int i = 0; i < kNumPlayers; ++i) {
         int card = history_[this_trick_start - kNumPlayers + i];
         int relative_player = (i + leader + kNumPlayers - player) % kNumPlayers;
-        ptr[relative_player * kNumCards + card] = 1;
+        set_one(offset + relative_player * kNumCards + card);
       }
     }
-    ptr += kNumPlayers * kNumCards;
+    offset += kNumPlayers * kNumCards;
 
     // Current trick
     int leader = tricks_[current_trick].Leader();
     for (int i = 0; i < this_trick_cards_played; ++i) {
       int card = history_[this_trick_start + i];
       int relative_player = (i + leader + kNumPlayers - player) % kNumPlayers;
-      ptr[relative_player * kNumCards + card] = 1;
+      set_one(offset + relative_player * kNumCards + card);
     }
-    ptr += kNumPlayers * kNumCards;
+    offset += kNumPlayers * kNumCards;
 
     // Number of tricks taken by each side.
-    ptr[num_declarer_tricks_] = 1;
-    ptr += kNumTricks;
-    ptr[num_cards_played_ / 4 - num_declarer_tricks_] = 1;
-    ptr += kNumTricks;
-    SPIEL_CHECK_EQ(std::distance(values->begin(), ptr),
-                   kPlayTensorSize + kNumObservationTypes);
-    SPIEL_CHECK_LE(std::distance(values->begin(), ptr), values->size());
+    set_one(offset + num_declarer_tricks_);
+    offset += kNumTricks;
+    set_one(offset + num_cards_played_ / 4 - num_declarer_tricks_);
+    offset += kNumTricks;
+    SPIEL_CHECK_EQ(offset, kPlayTensorSize + kNumObservationTypes);
   } else {
     // Observation for auction or opening lead.
-    ptr[phase_ == Phase::kPlay ? 1 : 0] = 1;
-    ptr += kNumObservationTypes;
-    ptr[is_vulnerable_[partnership]] = 1;
-    ptr += kNumVulnerabilities;
-    ptr[is_vulnerable_[1 - partnership]] = 1;
-    ptr += kNumVulnerabilities;
+    set_one(offset + (phase_ == Phase::kPlay ? 1 : 0));
+    offset += kNumObservationTypes;
+    set_one(offset + is_vulnerable_[partnership]);
+    offset += kNumVulnerabilities;
+    set_one(offset + is_vulnerable_[1 - partnership]);
+    offset += kNumVulnerabilities;
+    // Where the bid, double and redouble of each bid start.
+    const auto bid_offset = [offset](int bid) {
+      return offset + kNumPlayers + (bid - kFirstBid) * kNumPlayers * 3;
+    };
     int last_bid = 0;
     for (int i = kNumCards; i < history_.size(); ++i) {
       int this_call = history_[i] - kBiddingActionBase;
       int relative_bidder = (i + kNumPlayers - player) % kNumPlayers;
-      if (last_bid == 0 && this_call == kPass) ptr[relative_bidder] = 1;
+      if (last_bid == 0 && this_call == kPass) {
+        set_one(offset + relative_bidder);
+      }
       if (this_call == kDouble) {
-        ptr[kNumPlayers + (last_bid - kFirstBid) * kNumPlayers * 3 +
-            kNumPlayers + relative_bidder] = 1;
+        set_one(bid_offset(last_bid) + kNumPlayers + relative_bidder);
       } else if (this_call == kRedouble) {
-        ptr[kNumPlayers + (last_bid - kFirstBid) * kNumPlayers * 3 +
-            kNumPlayers * 2 + relative_bidder] = 1;
+        set_one(bid_offset(last_bid) + kNumPlayers * 2 + relative_bidder);
       } else if (this_call != kPass) {
         last_bid = this_call;
-        ptr[kNumPlayers + (last_bid - kFirstBid) * kNumPlayers * 3 +
-            relative_bidder] = 1;
+        set_one(bid_offset(last_bid) + relative_bidder);
       }
     }
-    ptr += kNumPlayers * (1 + 3 * kNumBids);
+    offset += kNumPlayers * (1 + 3 * kNumBids);
     for (int i = 0; i < kNumCards; ++i)
-      if (holder_[i] == player) ptr[i] = 1;
-    ptr += kNumCards;
-    SPIEL_CHECK_EQ(std::distance(values->begin(), ptr),
-                   kAuctionTensorSize + kNumObservationTypes);
-    SPIEL_CHECK_LE(std::distance(values->begin(), ptr), values->size());
+      if (holder_[i] == player) set_one(offset + i);
+    offset += kNumCards;
+    SPIEL_CHECK_EQ(offset, kAuctionTensorSize + kNumObservationTypes);
   }
 }
 
-void BridgeState::ComputeDoubleDummyTricks() {
+void BridgeState::ObservationTensor(Player player,
+                                    std::vector<double>* values) const {
+  SPIEL_CHECK_GE(player, 0);
+  SPIEL_CHECK_LT(player, num_players_);
+
+  std::fill(values->begin(), values->end(), 0.0);
+  values->resize(game_->ObservationTensorSize());
+  WriteObservationTensor(player, [values](int index) { (*values)[index] = 1; });
+}
+
+void BridgeState::ObservationTensor(Player player,
+                                    SparseTensor* tensor) const {
+  SPIEL_CHECK_GE(player, 0);
+  SPIEL_CHECK_LT(player, num_players_);
+
+  // The entries are all ones, and the calls of the auction are not written in
+  // order of their index.
+  tensor->Reset(game_->ObservationTensorSize());
+  WriteObservationTensor(
+      player, [tensor](int index) { tensor->indices.push_back(index); });
+  std::sort(tensor->indices.begin(), tensor->indices.end());
+  tensor->values.assign(tensor->indices.size(), 1);
+}
+
+ddTableDeal BridgeState::DoubleDummyDeal() const {
   ddTableDeal dd_table_deal{};
   for (int suit = 0; suit < kNumSuits; ++suit) {
     for (int rank = 0; rank < kNumCardsPerSuit; ++rank) {
@@ -465,13 +485,32 @@ void BridgeState::ComputeDoubleDummyTricks() {
       dd_table_deal.cards[player][suit] += 1 << (2 + rank);
     }
   }
-  DDS_EXTERNAL(SetMaxThreads)(0);
-  const int return_code =
-      DDS_EXTERNAL(CalcDDtable)(dd_table_deal, &double_dummy_results_);
-  if (return_code != RETURN_NO_FAULT) {
-    char error_message[80];
-    DDS_EXTERNAL(ErrorMessage)(return_code, error_message);
-    SpielFatalError(absl::StrCat("double_dummy_solver:", error_message));
+  return dd_table_deal;
+}
+
+bool BridgeState::NeedsDoubleDummyResults() const {
+  return use_double_dummy_result_ && phase_ == Phase::kAuction &&
+         !double_dummy_results_.has_value();
+}
+
+void BridgeState::ComputeDoubleDummyTricks() {
+  double_dummy_results_ = DoubleDummyCache::Default().Solve(DoubleDummyDeal());
+}
+
+void BridgeState::ComputeDoubleDummyTricks(
+    const std::vector<BridgeState*>& states) {
+  std::vector<BridgeState*> unsolved;
+  std::vector<ddTableDeal> deals;
+  for (BridgeState* state : states) {
+    if (state->NeedsDoubleDummyResults()) {
+      unsolved.push_back(state);
+      deals.push_back(state->DoubleDummyDeal());
+    }
+  }
+  std::vector<ddTableResults> results =
+      DoubleDummyCache::Default().SolveBatch(deals);
+  for (int i = 0; i < unsolved.size(); ++i) {
+    unsolved[i]->double_dummy_results_ = results[i];
   }
 }
 
@@ -551,6 +590,76 @@ std::vector<std::pair<Action, double>> BridgeState::ChanceOutcomes() const {
   return outcomes;
 }
 
+// Uniform over the cards not dealt yet, picked without listing them.
+std::pair<Action, double> BridgeState::SampleChanceOutcome(double z) const {
+  const int num_cards_remaining = kNumCards - history_.size();
+  int index = std::min<int>(z * num_cards_remaining, num_cards_remaining - 1);
+  for (int card = 0; card < kNumCards; ++card) {
+    if (!holder_[card].has_value() && index-- == 0) {
+      return {card, 1.0 / num_cards_remaining};
+    }
+  }
+  SpielFatalError("No card left to deal.");
+}
+
+std::unique_ptr<State> BridgeState::ResampleFromInfostate(
+    int player_id, std::function<double()> rng) const {
+  // The player knows their own cards, the dummy's once the lead is made, and
+  // the cards played. The other cards are dealt again between the hands they
+  // are in now, keeping their sizes. A player who didn't follow suit gets no
+  // card of the suit led.
+  const int first_play = history_.size() - num_cards_played_;
+  std::optional<Player> dummy;
+  if (num_cards_played_ > 0) dummy = contract_.declarer ^ 2;
+  std::array<std::vector<int>, kNumPlayers> played;
+  std::array<std::array<bool, kNumSuits>, kNumPlayers> is_void{};
+  for (int i = 0; i < num_cards_played_; ++i) {
+    const Trick& trick = tricks_[i / kNumPlayers];
+    const Player player = (trick.Leader() + i % kNumPlayers) % kNumPlayers;
+    const int card = history_[first_play + i];
+    played[player].push_back(card);
+    if (CardSuit(card) != trick.LedSuit()) {
+      is_void[player][static_cast<int>(trick.LedSuit())] = true;
+    }
+  }
+  std::vector<int> hidden;
+  std::vector<uint32_t> allowed;
+  std::vector<int> sizes(kNumPlayers, 0);
+  for (int card = 0; card < kNumCards; ++card) {
+    if (!holder_[card].has_value() || holder_[card] == player_id ||
+        holder_[card] == dummy) {
+      continue;
+    }
+    hidden.push_back(card);
+    ++sizes[*holder_[card]];
+    uint32_t hands = 0;
+    for (Player p = 0; p < kNumPlayers; ++p) {
+      if (p != player_id && p != dummy &&
+          !is_void[p][static_cast<int>(CardSuit(card))]) {
+        hands |= 1 << p;
+      }
+    }
+    allowed.push_back(hands);
+  }
+  std::vector<int> deal = ConstrainedDeal(allowed, sizes, rng);
+
+  // What each hidden hand was dealt: its cards now and those it played.
+  std::array<std::vector<int>, kNumPlayers> dealt = played;
+  for (int i = 0; i < hidden.size(); ++i) dealt[deal[i]].push_back(hidden[i]);
+
+  std::unique_ptr<State> state = game_->NewInitialState();
+  for (int i = 0; i < history_.size(); ++i) {
+    Action action = history_[i];
+    const Player receiver = i % kNumPlayers;
+    if (i < kNumCards && receiver != player_id && receiver != dummy) {
+      action = dealt[receiver].back();
+      dealt[receiver].pop_back();
+    }
+    state->ApplyAction(action);
+  }
+  return state;
+}
+
 void BridgeState::DoApplyAction(Action action) {
   switch (phase_) {
     case Phase::kDeal:
@@ -567,7 +676,6 @@ void BridgeState::DoApplyAction(Action action) {
 void BridgeState::ApplyDealAction(int card) {
   holder_[card] = (history_.size() % kNumPlayers);
   if (history_.size() == kNumCards - 1) {
-    if (use_double_dummy_result_) ComputeDoubleDummyTricks();
     phase_ = Phase::kAuction;
     current_player_ = kFirstPlayer;
   }
@@ -595,10 +703,11 @@ void BridgeState::ApplyBiddingAction(int call) {
     } else if (num_passes_ == 3 && contract_.level > 0) {
       // After there has been a bid, three consecutive passes end the auction.
       if (use_double_dummy_result_) {
+        if (!double_dummy_results_.has_value()) ComputeDoubleDummyTricks();
         phase_ = Phase::kGameOver;
         num_declarer_tricks_ =
             double_dummy_results_
-                .resTable[contract_.trumps][contract_.declarer];
+                ->resTable[contract_.trumps][contract_.declarer];
         ScoreUp();
       } else {
         phase_ = Phase::kPlay;
@@ -43,6 +43,8 @@
 // partner). There will thus be 26 turns for declarer, and 13 turns for each
 // of the defenders during the play.
 
+#include <functional>
+#include <memory>
 #include <optional>
 
 #include "open_spiel/games/bridge/double_dummy_solver/include/dll.h"
@@ -136,11 +138,22 @@ class BridgeState : public State {
   std::string ObservationString(Player player) const override;
   void ObservationTensor(Player player,
                          std::vector<double>* values) const override;
+  void ObservationTensor(Player player, SparseTensor* tensor) const override;
   std::unique_ptr<State> Clone() const override {
     return std::unique_ptr<State>(new BridgeState(*this));
   }
   std::vector<Action> LegalActions() const override;
   std::vector<std::pair<Action, double>> ChanceOutcomes() const override;
+  std::pair<Action, double> SampleChanceOutcome(double z) const override;
+  std::unique_ptr<State> ResampleFromInfostate(
+      int player_id, std::function<double()> rng) const override;
+
+  // The double-dummy results of a state are solved when its auction ends,
+  // unless they already were. This solves those of the states which are dealt
+  // and need them, all together, e.g. for a batch of environments after the
+  // deal. The results are also cached (see double_dummy_cache.h).
+  static void ComputeDoubleDummyTricks(
+      const std::vector<BridgeState*>& states);
 
  protected:
   void DoApplyAction(Action action) override;
@@ -155,7 +168,14 @@ class BridgeState : public State {
   void ApplyBiddingAction(int call);
   void ApplyPlayAction(int card);
   void ComputeDoubleDummyTricks();
+  ddTableDeal DoubleDummyDeal() const;
+  bool NeedsDoubleDummyResults() const;
   void ScoreUp();
+  // Shared implementation of the ObservationTensor overloads, which calls
+  // `set_one(index)` for each entry of the tensor which is one; the others are
+  // zero.
+  template <typename SetOne>
+  void WriteObservationTensor(Player player, SetOne set_one) const;
   Trick& CurrentTrick() { return tricks_[num_cards_played_ / kNumPlayers]; }
   const Trick& CurrentTrick() const {
     return tricks_[num_cards_played_ / kNumPlayers];
@@ -176,7 +196,7 @@ class BridgeState : public State {
   std::array<Trick, kNumTricks> tricks_{};
   std::vector<double> returns_ = std::vector<double>(kNumPlayers);
   std::array<std::optional<Player>, kNumCards> holder_{};
-  ddTableResults double_dummy_results_{};
+  std::optional<ddTableResults> double_dummy_results_;
 };
 
 class BridgeGame : public Game {
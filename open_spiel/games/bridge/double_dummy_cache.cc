@@ -0,0 +1,123 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "open_spiel/games/bridge/double_dummy_cache.h"
+
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/abseil-cpp/absl/synchronization/mutex.h"
+#include "open_spiel/spiel_utils.h"
+
+// For compatibility with versions of the double dummy solver code which
+// don't amend exported names.
+#ifndef DDS_EXTERNAL
+#define DDS_EXTERNAL(x) x
+#endif
+
+namespace open_spiel {
+namespace bridge {
+namespace {
+
+// The default cache holds this many deals, of about 200 bytes each.
+constexpr int kDefaultCacheSize = 1 << 16;
+
+void CheckReturnCode(int return_code) {
+  if (return_code != RETURN_NO_FAULT) {
+    char error_message[80];
+    DDS_EXTERNAL(ErrorMessage)(return_code, error_message);
+    SpielFatalError(absl::StrCat("double_dummy_solver:", error_message));
+  }
+}
+
+}  // namespace
+
+std::vector<ddTableResults> CalcDoubleDummyTables(
+    const std::vector<ddTableDeal>& deals) {
+  static absl::Mutex* solver_mutex = new absl::Mutex();
+  absl::MutexLock lock(solver_mutex);
+  DDS_EXTERNAL(SetMaxThreads)(0);
+
+  std::vector<ddTableResults> results(deals.size());
+  if (deals.size() == 1) {
+    CheckReturnCode(DDS_EXTERNAL(CalcDDtable)(deals[0], &results[0]));
+    return results;
+  }
+
+  // All the denominations are solved, so CalcAllTables takes up to
+  // MAXNOOFTABLES deals at a time. Its arguments are too large for the stack.
+  auto table_deals = std::make_unique<ddTableDeals>();
+  auto tables_results = std::make_unique<ddTablesRes>();
+  auto par_results = std::make_unique<allParResults>();
+  int trump_filter[DDS_STRAINS] = {0, 0, 0, 0, 0};
+  for (int begin = 0; begin < deals.size(); begin += MAXNOOFTABLES) {
+    const int end = std::min<int>(begin + MAXNOOFTABLES, deals.size());
+    table_deals->noOfTables = end - begin;
+    std::copy(deals.begin() + begin, deals.begin() + end, table_deals->deals);
+    CheckReturnCode(DDS_EXTERNAL(CalcAllTables)(
+        table_deals.get(), /*mode=*/-1, trump_filter, tables_results.get(),
+        par_results.get()));
+    std::copy(tables_results->results, tables_results->results + (end - begin),
+              results.begin() + begin);
+  }
+  return results;
+}
+
+DoubleDummyCache& DoubleDummyCache::Default() {
+  static DoubleDummyCache* cache = new DoubleDummyCache(kDefaultCacheSize);
+  return *cache;
+}
+
+DoubleDummyCache::Key DoubleDummyCache::MakeKey(const ddTableDeal& deal) {
+  Key key;
+  for (int hand = 0; hand < DDS_HANDS; ++hand) {
+    for (int suit = 0; suit < DDS_SUITS; ++suit) {
+      key[hand * DDS_SUITS + suit] = deal.cards[hand][suit];
+    }
+  }
+  return key;
+}
+
+ddTableResults DoubleDummyCache::Solve(const ddTableDeal& deal) {
+  return SolveBatch({deal})[0];
+}
+
+std::vector<ddTableResults> DoubleDummyCache::SolveBatch(
+    const std::vector<ddTableDeal>& deals) {
+  std::vector<ddTableResults> results(deals.size());
+  std::vector<ddTableDeal> missing_deals;
+  std::vector<int> missing_indices;
+  for (int i = 0; i < deals.size(); ++i) {
+    if (std::optional<const ddTableResults> cached =
+            cache_.Get(MakeKey(deals[i]))) {
+      results[i] = *cached;
+    } else {
+      missing_deals.push_back(deals[i]);
+      missing_indices.push_back(i);
+    }
+  }
+  if (missing_deals.empty()) return results;
+
+  std::vector<ddTableResults> solved = CalcDoubleDummyTables(missing_deals);
+  for (int i = 0; i < missing_deals.size(); ++i) {
+    results[missing_indices[i]] = solved[i];
+    cache_.Set(MakeKey(missing_deals[i]), solved[i]);
+  }
+  return results;
+}
+
+}  // namespace bridge
+}  // namespace open_spiel
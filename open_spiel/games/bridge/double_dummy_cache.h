@@ -0,0 +1,70 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef OPEN_SPIEL_GAMES_BRIDGE_DOUBLE_DUMMY_CACHE_H_
+#define OPEN_SPIEL_GAMES_BRIDGE_DOUBLE_DUMMY_CACHE_H_
+
+// Double-dummy solving of many deals at once, with a cache of the results.
+//
+// The double_dummy_solver solves a single deal with CalcDDtable, and several
+// with CalcAllTables, which shares them among its threads. Callers that have
+// many deals to solve (e.g. batched environments) should collect them and
+// call SolveBatch, so that the deals which are not in the cache are solved
+// together.
+
+#include <array>
+#include <vector>
+
+#include "open_spiel/games/bridge/double_dummy_solver/include/dll.h"
+#include "open_spiel/utils/lru_cache.h"
+
+namespace open_spiel {
+namespace bridge {
+
+// Solves the deals, in as few calls to CalcAllTables as it allows, and returns
+// their results in the same order. Calls to the solver are serialized, as it
+// is not reentrant.
+std::vector<ddTableResults> CalcDoubleDummyTables(
+    const std::vector<ddTableDeal>& deals);
+
+// A cache of double-dummy results keyed by deal, evicting the least recently
+// used ones. It can be used from several threads at once.
+class DoubleDummyCache {
+ public:
+  explicit DoubleDummyCache(int max_size) : cache_(max_size) {}
+
+  // The cache shared by the bridge games.
+  static DoubleDummyCache& Default();
+
+  ddTableResults Solve(const ddTableDeal& deal);
+
+  // Returns the results of the deals, in the same order, solving the ones
+  // which are not in the cache together.
+  std::vector<ddTableResults> SolveBatch(const std::vector<ddTableDeal>& deals);
+
+  LRUCacheInfo Info() { return cache_.Info(); }
+  void Clear() { cache_.Clear(); }
+
+ private:
+  // The holdings of each hand in each suit.
+  using Key = std::array<unsigned int, DDS_HANDS * DDS_SUITS>;
+
+  static Key MakeKey(const ddTableDeal& deal);
+
+  LRUCache<Key, ddTableResults> cache_;
+};
+
+}  // namespace bridge
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_GAMES_BRIDGE_DOUBLE_DUMMY_CACHE_H_
@@ -12,10 +12,21 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+
+#include "open_spiel/games/bridge.h"
 #include "open_spiel/games/bridge/bridge_scoring.h"
+#include "open_spiel/games/bridge/double_dummy_cache.h"
 #include "open_spiel/games/bridge_uncontested_bidding.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/tests/basic_tests.h"
+#include "open_spiel/utils/file.h"
 
 namespace open_spiel {
 namespace bridge {
@@ -41,6 +52,96 @@ void DeserializeStateTest() {
   SPIEL_CHECK_EQ(state->ToString(), "AKQJ.543.QJ8.T92 97532.A2.9.QJ853 ");
 }
 
+// Solving the deals of several states together gives each the results it
+// would have solved on its own at the end of the auction.
+void DoubleDummyBatchTest() {
+  auto game = LoadGame("bridge");
+  std::mt19937 rng(42);
+  std::vector<std::unique_ptr<State>> states;
+  std::vector<BridgeState*> batch;
+  for (int i = 0; i < 4; ++i) {
+    states.push_back(game->NewInitialState());
+    while (states.back()->IsChanceNode()) {
+      states.back()->ApplyAction(
+          SampleAction(states.back()->ChanceOutcomes(),
+                       absl::Uniform(rng, 0.0, 1.0))
+              .first);
+    }
+    batch.push_back(static_cast<BridgeState*>(states.back().get()));
+  }
+  std::vector<std::unique_ptr<State>> unbatched;
+  for (const auto& state : states) unbatched.push_back(state->Clone());
+  DoubleDummyCache::Default().Clear();
+  BridgeState::ComputeDoubleDummyTricks(batch);
+  DoubleDummyCache::Default().Clear();
+
+  // Bid 1NT, and pass it out.
+  const Action pass = kBiddingActionBase;
+  const Action one_no_trump = kBiddingActionBase + kNumOtherCalls + kNoTrump;
+  const std::vector<Action> bids = {one_no_trump, pass, pass, pass};
+  for (int i = 0; i < states.size(); ++i) {
+    for (Action bid : bids) {
+      states[i]->ApplyAction(bid);
+      unbatched[i]->ApplyAction(bid);
+    }
+    SPIEL_CHECK_TRUE(states[i]->IsTerminal());
+    SPIEL_CHECK_EQ(states[i]->Returns(), unbatched[i]->Returns());
+  }
+}
+
+// Deals drawn from a database are scored with its results, whatever the seed
+// of the game.
+void DealDatabaseTest() {
+  const std::string filename =
+      absl::StrCat(file::GetTmpDir(), "/open_spiel-test-deals-",
+                   std::mt19937(std::random_device()())());
+  bridge_uncontested_bidding::BuildDealDatabase("2NT", 3, 1, filename);
+  bridge_uncontested_bidding::DealDatabase database(filename);
+  SPIEL_CHECK_EQ(database.NumDeals(), 3);
+  SPIEL_CHECK_EQ(database.Subgame(), "2NT");
+  std::vector<std::string> deals;
+  for (int i = 0; i < database.NumDeals(); ++i) {
+    const bridge_uncontested_bidding::Deal deal = database.GetDeal(i);
+    deals.push_back(
+        absl::StrCat(deal.HandString(0, 13), " ", deal.HandString(13, 26)));
+    SPIEL_CHECK_EQ(database.Results(i).size(),
+                   bridge_uncontested_bidding::kNumRedeals);
+  }
+
+  std::vector<std::string> scored;
+  for (int seed = 0; seed < 10; ++seed) {
+    auto game = LoadGame("bridge_uncontested_bidding",
+                         {{"subgame", GameParameter(std::string("2NT"))},
+                          {"deal_database", GameParameter(filename)},
+                          {"rng_seed", GameParameter(seed)}});
+    if (seed == 0) testing::RandomSimTest(*game, 3);
+    auto state = game->NewInitialState();
+    state->ApplyAction(0);
+    const std::string deal = state->ToString().substr(0, deals[0].size());
+    SPIEL_CHECK_TRUE(std::find(deals.begin(), deals.end(), deal) !=
+                     deals.end());
+    // Pass.
+    state->ApplyAction(0);
+    SPIEL_CHECK_TRUE(state->IsTerminal());
+    scored.push_back(state->ToString());
+  }
+  for (const std::string& score : scored) {
+    for (const std::string& other : scored) {
+      if (score.substr(0, deals[0].size()) ==
+          other.substr(0, deals[0].size())) {
+        SPIEL_CHECK_EQ(score, other);
+      }
+    }
+  }
+  SPIEL_CHECK_TRUE(file::Remove(filename));
+}
+
+void ResampleTest() {
+  testing::ResampleInfostateTest(
+      *LoadGame("bridge", {{"use_double_dummy_result", GameParameter(false)}}),
+      /*num_sims=*/10);
+}
+
 }  // namespace
 }  // namespace bridge
 }  // namespace open_spiel
@@ -49,4 +150,7 @@ int main(int argc, char** argv) {
   open_spiel::bridge::DeserializeStateTest();
   open_spiel::bridge::ScoringTests();
   open_spiel::bridge::BasicGameTests();
+  open_spiel::bridge::DoubleDummyBatchTest();
+  open_spiel::bridge::ResampleTest();
+  open_spiel::bridge::DealDatabaseTest();
 }
@@ -16,18 +16,18 @@
 
 #include <cstring>
 #include <memory>
+#include <string>
+#include <vector>
 
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/abseil-cpp/absl/strings/string_view.h"
 #include "open_spiel/games/bridge/double_dummy_solver/include/dll.h"
 #include "open_spiel/game_parameters.h"
 #include "open_spiel/games/bridge/bridge_scoring.h"
+#include "open_spiel/games/bridge/double_dummy_cache.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
-
-// For compatibility with versions of the double dummy solver code which
-// don't amend exported names.
-#ifndef DDS_EXTERNAL
-#define DDS_EXTERNAL(x) x
-#endif
+#include "open_spiel/utils/file.h"
 
 namespace open_spiel {
 namespace bridge_uncontested_bidding {
@@ -41,8 +41,6 @@ using open_spiel::bridge::kNoTrump;
 using open_spiel::bridge::kSpades;
 using open_spiel::bridge::kUndoubled;
 
-constexpr int kNumRedeals = 10;  // how many possible layouts to analyse
-
 const GameType kGameType{
     /*short_name=*/"bridge_uncontested_bidding",
     /*long_name=*/"Bridge: Uncontested Bidding",
@@ -62,6 +60,7 @@ const GameType kGameType{
         {"subgame", GameParameter(static_cast<std::string>(""))},
         {"rng_seed", GameParameter(0)},
         {"relative_scoring", GameParameter(false)},
+        {"deal_database", GameParameter(static_cast<std::string>(""))},
     }};
 
 std::shared_ptr<const Game> Factory(const GameParameters& params) {
@@ -88,8 +87,181 @@ bool Is2NTDeal(const Deal& deal) {
 }
 bool NoFilter(const Deal& deal) { return true; }
 
+std::function<bool(const Deal&)> DealFilter(const std::string& subgame) {
+  if (subgame == "2NT") return Is2NTDeal;
+  SPIEL_CHECK_EQ(subgame, "");
+  return NoFilter;
+}
+
+// The deals with our cards and kNumRedeals layouts of the opponents' cards:
+// those of the deal first, then random ones, which are left in the deal.
+std::vector<ddTableDeal> Layouts(Deal* deal, std::mt19937* rng) {
+  // Populate East-West cards
+  ddTableDeal dd_table_deal{};
+  for (Player player = 0; player < kNumPlayers; ++player) {
+    for (int i = kNumCardsPerHand * player; i < kNumCardsPerHand * (1 + player);
+         ++i) {
+      dd_table_deal.cards[player * 2][deal->Suit(i)] += 1
+                                                        << (2 + deal->Rank(i));
+    }
+  }
+
+  // Redeal North-South cards.
+  std::vector<ddTableDeal> dd_table_deals;
+  dd_table_deals.reserve(kNumRedeals);
+  for (int ideal = 0; ideal < kNumRedeals; ++ideal) {
+    if (ideal > 0) deal->Shuffle(rng, kNumCardsPerHand * 2, kNumCards);
+    for (int opponent = 0; opponent < kNumPlayers; ++opponent) {
+      std::fill(dd_table_deal.cards[1 + opponent * 2],
+                dd_table_deal.cards[1 + opponent * 2] + 4, 0);
+      for (int i = kNumCardsPerHand * (2 + opponent);
+           i < kNumCardsPerHand * (3 + opponent); ++i) {
+        dd_table_deal.cards[1 + opponent * 2][deal->Suit(i)] +=
+            1 << (2 + deal->Rank(i));
+      }
+    }
+    dd_table_deals.push_back(dd_table_deal);
+  }
+  return dd_table_deals;
+}
+
+// The deal database starts with a header, followed by a record for each deal:
+// its cards, then the tricks of each layout, for each strain and hand.
+constexpr char kMagic[8] = {'O', 'S', 'B', 'R', 'D', 'E', 'A', 'L'};
+constexpr uint32_t kVersion = 1;
+constexpr int kResultsBytes = DDS_STRAINS * DDS_HANDS;
+constexpr int kRecordBytes = kNumCards + kNumRedeals * kResultsBytes;
+
+struct Header {
+  char magic[8];
+  uint32_t version;
+  uint32_t num_redeals;
+  char subgame[8];  // Null-terminated.
+  int64_t num_deals;
+};
+
 }  // namespace
 
+DealDatabase::DealDatabase(const std::string& filename)
+    : file_(filename, {file::MMapFile::Access::kRandom}) {
+  const char* data = file_.data();
+  const int64_t size = file_.size();
+  if (size < static_cast<int64_t>(sizeof(Header))) {
+    SpielFatalError(absl::StrCat(filename, " is not a deal database"));
+  }
+  const Header* header = reinterpret_cast<const Header*>(data);
+  if (std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0) {
+    SpielFatalError(absl::StrCat(filename, " is not a deal database"));
+  }
+  if (header->version != kVersion) {
+    SpielFatalError(absl::StrCat("Unsupported version ", header->version,
+                                 " of the deal database ", filename));
+  }
+  if (header->num_redeals != kNumRedeals) {
+    SpielFatalError(absl::StrCat("The deal database ", filename, " has ",
+                                 header->num_redeals, " layouts per deal, not ",
+                                 kNumRedeals));
+  }
+  subgame_ = std::string(header->subgame,
+                         strnlen(header->subgame, sizeof(header->subgame)));
+  num_deals_ = header->num_deals;
+  if (num_deals_ < 1 || size != sizeof(Header) + num_deals_ * kRecordBytes) {
+    SpielFatalError(absl::StrCat("The deal database ", filename,
+                                 " has the wrong size"));
+  }
+  records_ = reinterpret_cast<const uint8_t*>(data + sizeof(Header));
+}
+
+const uint8_t* DealDatabase::Record(int64_t index) const {
+  SPIEL_CHECK_GE(index, 0);
+  SPIEL_CHECK_LT(index, num_deals_);
+  return records_ + index * kRecordBytes;
+}
+
+Deal DealDatabase::GetDeal(int64_t index) const {
+  const uint8_t* record = Record(index);
+  std::array<int, kNumCards> cards;
+  for (int i = 0; i < kNumCards; ++i) cards[i] = record[i];
+  return Deal(cards);
+}
+
+std::vector<ddTableResults> DealDatabase::Results(int64_t index) const {
+  const uint8_t* tricks = Record(index) + kNumCards;
+  std::vector<ddTableResults> results(kNumRedeals);
+  for (ddTableResults& result : results) {
+    for (int strain = 0; strain < DDS_STRAINS; ++strain) {
+      for (int hand = 0; hand < DDS_HANDS; ++hand) {
+        result.resTable[strain][hand] = *tricks++;
+      }
+    }
+  }
+  return results;
+}
+
+void BuildDealDatabase(const std::string& subgame, int64_t num_deals, int seed,
+                       const std::string& filename) {
+  const std::function<bool(const Deal&)> filter = DealFilter(subgame);
+  SPIEL_CHECK_GE(num_deals, 1);
+  SPIEL_CHECK_LT(subgame.size(), sizeof(Header::subgame));
+  Header header{};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.num_redeals = kNumRedeals;
+  std::memcpy(header.subgame, subgame.data(), subgame.size());
+  header.num_deals = num_deals;
+
+  // The deals are solved in batches, which the solver shares among its
+  // threads.
+  constexpr int kBatchSize = 1024;
+  std::mt19937 rng(seed);
+  Deal deal;
+  std::string records;
+  const std::string tmp_filename = absl::StrCat(filename, ".tmp");
+  {
+    file::File file(tmp_filename, "wb");
+    SPIEL_CHECK_TRUE(file.Write(absl::string_view(
+        reinterpret_cast<const char*>(&header), sizeof(header))));
+    for (int64_t begin = 0; begin < num_deals; begin += kBatchSize) {
+      const int batch_size = std::min<int64_t>(kBatchSize, num_deals - begin);
+      records.assign(batch_size * kRecordBytes, 0);
+      std::vector<ddTableDeal> layouts;
+      layouts.reserve(batch_size * kNumRedeals);
+      for (int i = 0; i < batch_size; ++i) {
+        do {
+          deal.Shuffle(&rng);
+        } while (!filter(deal));
+        for (int c = 0; c < kNumCards; ++c) {
+          records[i * kRecordBytes + c] = deal.Card(c);
+        }
+        for (const ddTableDeal& layout : Layouts(&deal, &rng)) {
+          layouts.push_back(layout);
+        }
+      }
+      const std::vector<ddTableResults> results =
+          bridge::CalcDoubleDummyTables(layouts);
+      for (int i = 0; i < batch_size; ++i) {
+        char* tricks = &records[i * kRecordBytes + kNumCards];
+        for (int layout = 0; layout < kNumRedeals; ++layout) {
+          const ddTableResults& result = results[i * kNumRedeals + layout];
+          for (int strain = 0; strain < DDS_STRAINS; ++strain) {
+            for (int hand = 0; hand < DDS_HANDS; ++hand) {
+              *tricks++ = result.resTable[strain][hand];
+            }
+          }
+        }
+      }
+      SPIEL_CHECK_TRUE(file.Write(records));
+    }
+    SPIEL_CHECK_TRUE(file.Flush());
+  }
+  // Written next to the database first, so that it is never seen half
+  // written, even by processes which have it mapped.
+  if (!file::Rename(tmp_filename, filename)) {
+    SpielFatalError(absl::StrCat("Could not write the deal database ",
+                                 filename));
+  }
+}
+
 int UncontestedBiddingState::CurrentPlayer() const {
   if (!dealt_) return kChancePlayerId;
   if (IsTerminal()) return kTerminalPlayerId;
@@ -251,15 +423,12 @@ void UncontestedBiddingState::ScoreDeal() {
     }
   }
 
-  // Populate East-West cards
-  ddTableDeal dd_table_deal{};
-  for (Player player = 0; player < kNumPlayers; ++player) {
-    for (int i = kNumCardsPerHand * player; i < kNumCardsPerHand * (1 + player);
-         ++i) {
-      dd_table_deal.cards[player * 2][deal_.Suit(i)] += 1
-                                                        << (2 + deal_.Rank(i));
-    }
-  }
+  // Redeal North-South cards, and analyze all the deals together, unless
+  // they were analyzed when the deal database was built.
+  const std::vector<ddTableResults> all_results =
+      deal_index_ >= 0 ? deal_database_->Results(deal_index_)
+                       : bridge::DoubleDummyCache::Default().SolveBatch(
+                             Layouts(&deal_, &rng_));
 
   // Initialize scores to zero
   score_ = 0;
@@ -267,32 +436,7 @@ void UncontestedBiddingState::ScoreDeal() {
   std::fill(reference_scores_.begin(), reference_scores_.end(), 0);
 
   // For each redeal
-  for (int ideal = 0; ideal < kNumRedeals; ++ideal) {
-    if (ideal > 0) deal_.Shuffle(&rng_, kNumCardsPerHand * 2, kNumCards);
-
-    // Populate (reshuffled) North-South cards
-    for (int opponent = 0; opponent < kNumPlayers; ++opponent) {
-      std::fill(dd_table_deal.cards[1 + opponent * 2],
-                dd_table_deal.cards[1 + opponent * 2] + 4, 0);
-      for (int i = kNumCardsPerHand * (2 + opponent);
-           i < kNumCardsPerHand * (3 + opponent); ++i) {
-        dd_table_deal.cards[1 + opponent * 2][deal_.Suit(i)] +=
-            1 << (2 + deal_.Rank(i));
-      }
-    }
-
-    // Analyze the deal.
-    DDS_EXTERNAL(SetMaxThreads)(0);
-    struct ddTableResults results;
-    const int return_code = DDS_EXTERNAL(CalcDDtable)(dd_table_deal, &results);
-
-    // Check for errors.
-    if (return_code != RETURN_NO_FAULT) {
-      char error_message[80];
-      DDS_EXTERNAL(ErrorMessage)(return_code, error_message);
-      SpielFatalError(absl::StrCat("double_dummy_solver:", error_message));
-    }
-
+  for (const ddTableResults& results : all_results) {
     // Compute the score and update the total.
     if (!passed_out) {
       const int declarer_tricks =
@@ -318,6 +462,12 @@ void UncontestedBiddingState::DoApplyAction(Action action_id) {
   if (dealt_) {
     actions_.push_back(action_id);
     if (IsTerminal()) ScoreDeal();
+  } else if (deal_database_ != nullptr) {
+    // We don't use absl::uniform_int_distribution, as in Deal::Shuffle.
+    const uint64_t random = static_cast<uint64_t>(rng_()) << 32 | rng_();
+    deal_index_ = random % deal_database_->NumDeals();
+    deal_ = deal_database_->GetDeal(deal_index_);
+    dealt_ = true;
   } else {
     do {
       deal_.Shuffle(&rng_);
@@ -337,6 +487,17 @@ UncontestedBiddingGame::UncontestedBiddingGame(const GameParameters& params)
       deal_filter_{NoFilter},
       rng_seed_(ParameterValue<int>("rng_seed")) {
   std::string subgame = ParameterValue<std::string>("subgame");
+  const std::string deal_database =
+      ParameterValue<std::string>("deal_database");
+  if (!deal_database.empty()) {
+    deal_database_ = std::make_shared<const DealDatabase>(deal_database);
+    if (deal_database_->Subgame() != subgame) {
+      SpielFatalError(absl::StrCat("The deal database ", deal_database,
+                                   " is for the subgame '",
+                                   deal_database_->Subgame(), "', not '",
+                                   subgame, "'"));
+    }
+  }
   if (subgame == "2NT") {
     deal_filter_ = Is2NTDeal;
     forced_actions_ = {k2NT};
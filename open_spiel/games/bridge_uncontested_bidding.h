@@ -16,6 +16,13 @@
 #define OPEN_SPIEL_GAMES_BRIDGE_UNCONTESTED_BIDDING_H_
 
 #include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
 
 // Uncontested bridge bidding. A two-player purely cooperative game.
 //
@@ -91,9 +98,17 @@
 // for player 1 will be the score relative to the best-scoring of the possible
 // contracts (so 0 if the contract reached is the best-scoring contract,
 // otherwise negative).
+//
+// Solving the layouts takes far longer than the rest of an episode. When
+// training on a fixed pool of deals, they can be dealt and solved once by
+// BuildDealDatabase, and the file it writes given as the `deal_database`
+// parameter: the deals are then drawn uniformly from it, and scored from its
+// results without calling the solver.
 
 #include "open_spiel/games/bridge/bridge_scoring.h"
+#include "open_spiel/games/bridge/double_dummy_solver/include/dll.h"
 #include "open_spiel/spiel.h"
+#include "open_spiel/utils/file.h"
 
 namespace open_spiel {
 namespace bridge_uncontested_bidding {
@@ -110,6 +125,8 @@ inline constexpr int kNumCards = kNumSuits * kNumCardsPerSuit;
 inline constexpr int kNumPlayers = 2;
 inline constexpr int kNumHands = 4;
 inline constexpr int kNumCardsPerHand = 13;
+// How many layouts of the opponents' cards are analysed for each deal.
+inline constexpr int kNumRedeals = 10;
 inline constexpr int kMinScore = -650;  // 13 undertricks, at 50 each
 inline constexpr int kMaxScore = 1520;  // 7NT making
 inline constexpr int kStateSize =
@@ -138,16 +155,53 @@ class Deal {
   std::array<int, kNumCards> cards_;  // 0..12 are West's, then E, N, S
 };
 
+// A file of deals of a subgame, each with the double-dummy results of its
+// layouts of the opponents' cards, mapped read-only for as long as this lives.
+// The records are of a fixed size, so a deal is found by its index. The
+// numbers are single bytes, so the file can be read on any machine.
+class DealDatabase {
+ public:
+  explicit DealDatabase(const std::string& filename);
+
+  DealDatabase(const DealDatabase&) = delete;
+  DealDatabase& operator=(const DealDatabase&) = delete;
+
+  int64_t NumDeals() const { return num_deals_; }
+  // The subgame the deals are for, as the game's parameter.
+  const std::string& Subgame() const { return subgame_; }
+
+  // The deal, with the opponents' cards of its first layout.
+  Deal GetDeal(int64_t index) const;
+  // The results of each layout of the deal.
+  std::vector<ddTableResults> Results(int64_t index) const;
+
+ private:
+  const uint8_t* Record(int64_t index) const;
+
+  file::MMapFile file_;
+  std::string subgame_;
+  int64_t num_deals_;
+  const uint8_t* records_;
+};
+
+// Deals num_deals deals of the subgame with an rng seeded with seed, solves
+// their layouts, and writes them to filename as a DealDatabase. The solver
+// runs on all the threads it is allowed, on many deals at once.
+void BuildDealDatabase(const std::string& subgame, int64_t num_deals, int seed,
+                       const std::string& filename);
+
 class UncontestedBiddingState : public State {
  public:
   UncontestedBiddingState(std::shared_ptr<const Game> game,
                           std::vector<Contract> reference_contracts,
                           std::function<bool(const Deal&)> deal_filter,
+                          const DealDatabase* deal_database,
                           std::vector<Action> actions, int rng_seed)
       : State(game),
         reference_contracts_(std::move(reference_contracts)),
         actions_(std::move(actions)),
         deal_filter_(deal_filter),
+        deal_database_(deal_database),
         rng_(rng_seed),
         dealt_(false) {}
   UncontestedBiddingState(std::shared_ptr<const Game> game,
@@ -193,6 +247,10 @@ class UncontestedBiddingState : public State {
   // filtering is required, or it may check that the opening bidder has a
   // balanced hand with 20-21 HCP (a 2NT opener - see above).
   std::function<bool(const Deal&)> deal_filter_;
+  // If not null, the deals are drawn from it instead, deal_index_ being the
+  // one dealt. It belongs to the game.
+  const DealDatabase* deal_database_ = nullptr;
+  int64_t deal_index_ = -1;
   mutable std::mt19937 rng_;
   mutable Deal deal_;
   bool dealt_;
@@ -206,8 +264,8 @@ class UncontestedBiddingGame : public Game {
   int NumDistinctActions() const override { return kNumActions; }
   std::unique_ptr<State> NewInitialState() const override {
     return std::unique_ptr<State>(new UncontestedBiddingState(
-        shared_from_this(), reference_contracts_, deal_filter_, forced_actions_,
-        ++rng_seed_));
+        shared_from_this(), reference_contracts_, deal_filter_,
+        deal_database_.get(), forced_actions_, ++rng_seed_));
   }
   int NumPlayers() const override { return kNumPlayers; }
   double MinUtility() const override {
@@ -230,6 +288,7 @@ class UncontestedBiddingGame : public Game {
   std::vector<Contract> reference_contracts_;
   std::vector<Action> forced_actions_;
   std::function<bool(const Deal&)> deal_filter_;
+  std::shared_ptr<const DealDatabase> deal_database_;
   mutable int rng_seed_;
 };
 
@@ -15,11 +15,17 @@
 #include "open_spiel/games/catch.h"
 
 #include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <random>
 #include <utility>
+#include <vector>
 
+#include "open_spiel/abseil-cpp/absl/types/span.h"
 #include "open_spiel/game_parameters.h"
 #include "open_spiel/spiel_utils.h"
 #include "open_spiel/utils/tensor_view.h"
+#include "open_spiel/vector_state.h"
 
 namespace open_spiel {
 namespace catch_ {
@@ -49,6 +55,81 @@ std::shared_ptr<const Game> Factory(const GameParameters& params) {
 
 REGISTER_SPIEL_GAME(kGameType, Factory);
 
+// Catch for VectorState: the ball and paddle of every slot.
+class CatchKernel : public BatchedKernel {
+ public:
+  CatchKernel(const CatchGame& game, int num_states)
+      : num_rows_(game.NumRows()),
+        num_columns_(game.NumColumns()),
+        ball_outcomes_(game.NewInitialState()->ChanceOutcomes()),
+        ball_row_(num_states),
+        ball_col_(num_states),
+        paddle_col_(num_states) {}
+
+  void Reset(int begin, int end, absl::Span<std::mt19937> rngs) override {
+    for (int i = begin; i < end; ++i) ResetSlot(i, rngs[i]);
+  }
+
+  void Step(int begin, int end, absl::Span<const Action> actions,
+            absl::Span<std::mt19937> rngs, absl::Span<float> rewards,
+            absl::Span<float> dones) override {
+    for (int i = begin; i < end; ++i) {
+      ++ball_row_[i];
+      paddle_col_[i] = std::clamp(
+          paddle_col_[i] + static_cast<int>(actions[i]) - 1, 0,
+          num_columns_ - 1);
+    }
+    for (int i = begin; i < end; ++i) {
+      const bool done = ball_row_[i] >= num_rows_ - 1;
+      const float caught = ball_col_[i] == paddle_col_[i] ? 1 : -1;
+      rewards[i] = done ? caught : 0;
+      dones[i] = done;
+    }
+    for (int i = begin; i < end; ++i) {
+      if (dones[i]) ResetSlot(i, rngs[i]);
+    }
+  }
+
+  void ObservationTensors(int begin, int end,
+                          absl::Span<float> values) const override {
+    const int size = num_rows_ * num_columns_;
+    std::fill(values.begin() + begin * size, values.begin() + end * size, 0);
+    for (int i = begin; i < end; ++i) {
+      float* grid = values.data() + i * size;
+      grid[ball_row_[i] * num_columns_ + ball_col_[i]] = 1;
+      grid[(num_rows_ - 1) * num_columns_ + paddle_col_[i]] = 1;
+    }
+  }
+
+  void LegalActionsMasks(int begin, int end,
+                         absl::Span<uint8_t> values) const override {
+    std::fill(values.begin() + begin * kNumActions,
+              values.begin() + end * kNumActions, 1);
+  }
+
+ private:
+  void ResetSlot(int i, std::mt19937& rng) {
+    ball_col_[i] = SampleAction(ball_outcomes_, rng).first;
+    ball_row_[i] = 0;
+    paddle_col_[i] = num_columns_ / 2;
+  }
+
+  const int num_rows_;
+  const int num_columns_;
+  const ActionsAndProbs ball_outcomes_;
+  std::vector<int> ball_row_;
+  std::vector<int> ball_col_;
+  std::vector<int> paddle_col_;
+};
+
+std::unique_ptr<BatchedKernel> KernelFactory(const Game& game,
+                                             int num_states) {
+  return std::make_unique<CatchKernel>(static_cast<const CatchGame&>(game),
+                                       num_states);
+}
+
+REGISTER_BATCHED_KERNEL("catch", KernelFactory);
+
 std::string StateToString(CellState state) {
   switch (state) {
     case CellState::kEmpty:
@@ -196,7 +277,7 @@ void CatchState::UndoAction(Player player, Action move) {
   paddle_col_ =
       std::min(std::max(paddle_col_ - direction, 0), num_columns_ - 1);
   --ball_row_;
-  history_.pop_back();
+  PopHistory();
 }
 
 std::unique_ptr<State> CatchState::Clone() const {
@@ -14,12 +14,15 @@
 
 #include "open_spiel/games/chess.h"
 
+#include <algorithm>
 #include <optional>
 
 #include "open_spiel/abseil-cpp/absl/algorithm/container.h"
+#include "open_spiel/abseil-cpp/absl/types/span.h"
 #include "open_spiel/games/chess/chess_board.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/plane_encoding.h"
 
 namespace open_spiel {
 namespace chess {
@@ -57,15 +60,13 @@ REGISTER_SPIEL_GAME(kGameType, Factory);
 void AddPieceTypePlane(Color color, PieceType piece_type,
                        const StandardChessBoard& board,
                        std::vector<double>* values) {
-  for (int8_t y = 0; y < BoardSize(); ++y) {
-    for (int8_t x = 0; x < BoardSize(); ++x) {
-      Piece piece_on_board = board.at(Square{x, y});
-      values->push_back(piece_on_board.color == color &&
-                                piece_on_board.type == piece_type
-                            ? 1.0
-                            : 0.0);
-    }
-  }
+  // The plane is filled from the board's bitboard, whose bits are in the same
+  // order as the plane's squares.
+  const int offset = values->size();
+  const int num_squares = BoardSize() * BoardSize();
+  values->resize(offset + num_squares);
+  BitboardPlane(board.PieceBitboard(Piece{color, piece_type}),
+                absl::MakeSpan(values->data() + offset, num_squares));
 }
 
 // Adds a uniform scalar plane scaled with min and max.
@@ -79,13 +80,50 @@ void AddScalarPlane(T val, T min, T max, std::vector<double>* values) {
 void AddBinaryPlane(bool val, std::vector<double>* values) {
   AddScalarPlane<int>(val ? 1 : 0, 0, 1, values);
 }
+
+// The plane of the pieces of a color and type in the observation tensor,
+// whose piece planes follow kPieceTypes, white then black, then the empty
+// squares.
+int PiecePlane(const Piece& piece) {
+  if (piece.type == PieceType::kEmpty) return 2 * kPieceTypes.size();
+  return 2 * (static_cast<int>(piece.type) - 1) +
+         (piece.color == Color::kBlack ? 1 : 0);
+}
+
+// Sets the piece planes of a square of the observation tensor.
+void UpdateSquare(const Square& square, const StandardChessBoard& board,
+                  absl::Span<float> values) {
+  const int num_squares = BoardSize() * BoardSize();
+  const int index = SquareToIndex(square);
+  const int piece_plane = PiecePlane(board.at(square));
+  for (int plane = 0; plane <= 2 * kPieceTypes.size(); ++plane) {
+    values[plane * num_squares + index] = plane == piece_plane;
+  }
+}
+
+// Sets a uniform scalar plane of the observation tensor, as AddScalarPlane,
+// unless it already has the value.
+template <typename T>
+void UpdateScalarPlane(T val, T min, T max, int plane,
+                       absl::Span<float> values) {
+  const float normalized_val = static_cast<double>(val - min) / (max - min);
+  const int num_squares = BoardSize() * BoardSize();
+  auto begin = values.begin() + plane * num_squares;
+  if (*begin != normalized_val) {
+    std::fill(begin, begin + num_squares, normalized_val);
+  }
+}
+
+void UpdateBinaryPlane(bool val, int plane, absl::Span<float> values) {
+  UpdateScalarPlane<int>(val ? 1 : 0, 0, 1, plane, values);
+}
 }  // namespace
 
 ChessState::ChessState(std::shared_ptr<const Game> game)
     : State(game),
       start_board_(MakeDefaultBoard()),
       current_board_(start_board_) {
-  repetitions_[current_board_.HashValue()] = 1;
+  reversible_hashes_.push_back(current_board_.HashValue());
 }
 
 ChessState::ChessState(std::shared_ptr<const Game> game, const std::string& fen)
@@ -94,14 +132,15 @@ ChessState::ChessState(std::shared_ptr<const Game> game, const std::string& fen)
   SPIEL_CHECK_TRUE(maybe_board);
   start_board_ = *maybe_board;
   current_board_ = start_board_;
-  repetitions_[current_board_.HashValue()] = 1;
+  reversible_hashes_.push_back(current_board_.HashValue());
 }
 
 void ChessState::DoApplyAction(Action action) {
   Move move = ActionToMove(action, Board());
   moves_history_.push_back(move);
   Board().ApplyMove(move);
-  ++repetitions_[current_board_.HashValue()];
+  if (Board().IrreversibleMoveCounter() == 0) reversible_hashes_.clear();
+  reversible_hashes_.push_back(current_board_.HashValue());
   cached_legal_actions_.reset();
 }
 
@@ -122,6 +161,23 @@ std::vector<Action> ChessState::LegalActions() const {
   return *cached_legal_actions_;
 }
 
+void ChessState::LegalActions(std::vector<Action>* actions) const {
+  MaybeGenerateLegalActions();
+  actions->clear();
+  if (IsTerminal()) return;
+  actions->insert(actions->end(), cached_legal_actions_->begin(),
+                  cached_legal_actions_->end());
+}
+
+void ChessState::LegalActionsMask(Player player,
+                                  absl::Span<uint8_t> mask) const {
+  SPIEL_CHECK_EQ(mask.size(), num_distinct_actions_);
+  std::fill(mask.begin(), mask.end(), 0);
+  if (player != CurrentPlayer()) return;
+  MaybeGenerateLegalActions();
+  for (Action action : *cached_legal_actions_) mask[action] = 1;
+}
+
 int EncodeMove(const Square& from_square, int destination_index, int board_size,
                int num_actions_destinations) {
   return (from_square.x * board_size + from_square.y) *
@@ -168,17 +224,17 @@ Action MoveToAction(const Move& move) {
     // For a given starting square, an underpromotion can have 3 possible
     // destination squares (straight, left diagonal, right diagonal) and 3
     // possible piece types.
-    SPIEL_CHECK_EQ(move.piece.type, PieceType::kPawn);
-    SPIEL_CHECK_TRUE((move.piece.color == color &&
-                      player_move.from.y == BoardSize() - 2 &&
-                      player_move.to.y == BoardSize() - 1) ||
-                     (move.piece.color == OppColor(color) &&
-                      player_move.from.y == 1 && player_move.to.y == 0));
+    SPIEL_DCHECK_EQ(move.piece.type, PieceType::kPawn);
+    SPIEL_DCHECK_TRUE((move.piece.color == color &&
+                       player_move.from.y == BoardSize() - 2 &&
+                       player_move.to.y == BoardSize() - 1) ||
+                      (move.piece.color == OppColor(color) &&
+                       player_move.from.y == 1 && player_move.to.y == 0));
 
     int promotion_index;
     {
       auto itr = absl::c_find(kUnderPromotionIndexToType, move.promotion_type);
-      SPIEL_CHECK_TRUE(itr != kUnderPromotionIndexToType.end());
+      SPIEL_DCHECK_TRUE(itr != kUnderPromotionIndexToType.end());
       promotion_index = std::distance(kUnderPromotionIndexToType.begin(), itr);
     }
 
@@ -187,7 +243,7 @@ Action MoveToAction(const Move& move) {
       auto itr = absl::c_find_if(
           kUnderPromotionDirectionToOffset,
           [offset](Offset o) { return o.x_offset == offset.x_offset; });
-      SPIEL_CHECK_NE(itr, kUnderPromotionDirectionToOffset.end());
+      SPIEL_DCHECK_NE(itr, kUnderPromotionDirectionToOffset.end());
       direction_index =
           std::distance(kUnderPromotionDirectionToOffset.begin(), itr);
     }
@@ -198,7 +254,7 @@ Action MoveToAction(const Move& move) {
     // For the normal moves, we simply encode starting and destination square.
     int destination_index =
         OffsetToDestinationIndex(offset, kKnightOffsets, BoardSize());
-    SPIEL_CHECK_TRUE(destination_index >= 0 && destination_index < 64);
+    SPIEL_DCHECK_TRUE(destination_index >= 0 && destination_index < 64);
     return starting_index + kNumUnderPromotions + destination_index;
   }
 }
@@ -206,13 +262,13 @@ Action MoveToAction(const Move& move) {
 std::pair<Square, int> ActionToDestination(int action, int board_size,
                                            int num_actions_destinations) {
   const int xy = action / num_actions_destinations;
-  SPIEL_CHECK_GE(xy, 0);
-  SPIEL_CHECK_LT(xy, board_size * board_size);
+  SPIEL_DCHECK_GE(xy, 0);
+  SPIEL_DCHECK_LT(xy, board_size * board_size);
   const int8_t x = xy / board_size;
   const int8_t y = xy % board_size;
   const int destination_index = action % num_actions_destinations;
-  SPIEL_CHECK_GE(destination_index, 0);
-  SPIEL_CHECK_LT(destination_index, num_actions_destinations);
+  SPIEL_DCHECK_GE(destination_index, 0);
+  SPIEL_DCHECK_LT(destination_index, num_actions_destinations);
   return {Square{x, y}, destination_index};
 }
 
@@ -226,7 +282,7 @@ Move ActionToMove(const Action& action, const StandardChessBoard& board) {
   bool is_castling = false;
   auto [from_square, destination_index] =
       ActionToDestination(action, BoardSize(), kNumActionDestinations);
-  SPIEL_CHECK_LT(destination_index, kNumActionDestinations);
+  SPIEL_DCHECK_LT(destination_index, kNumActionDestinations);
 
   bool is_under_promotion = destination_index < kNumUnderPromotions;
   Offset offset;
@@ -310,12 +366,8 @@ void ChessState::ObservationTensor(Player player,
 
   AddPieceTypePlane(Color::kEmpty, PieceType::kEmpty, Board(), values);
 
-  const auto entry = repetitions_.find(Board().HashValue());
-  SPIEL_CHECK_FALSE(entry == repetitions_.end());
-  int repetitions = entry->second;
-
   // Num repetitions for the current board.
-  AddScalarPlane(repetitions, 1, 3, values);
+  AddScalarPlane(NumRepetitions(), 1, 3, values);
 
   // Side to play.
   AddScalarPlane(ColorToPlayer(Board().ToPlay()), 0, 1, values);
@@ -337,26 +389,95 @@ void ChessState::ObservationTensor(Player player,
       Board().CastlingRight(Color::kBlack, CastlingDirection::kRight), values);
 }
 
+bool ChessState::UpdateObservationTensor(Player player,
+                                         absl::Span<float> values) const {
+  SPIEL_CHECK_GE(player, 0);
+  SPIEL_CHECK_LT(player, num_players_);
+  SPIEL_CHECK_FALSE(moves_history_.empty());
+  SPIEL_CHECK_EQ(values.size(), game_->ObservationTensorSize());
+
+  // A move changes the squares it moves from and to and, for an en passant
+  // capture, the square of the captured pawn, which is next to the one it
+  // moves from. Castling moves a rook too, so its whole rank is rewritten.
+  const Move& move = moves_history_.back();
+  if (move.is_castling) {
+    for (int8_t x = 0; x < BoardSize(); ++x) {
+      UpdateSquare(Square{x, move.from.y}, Board(), values);
+    }
+  } else {
+    UpdateSquare(move.from, Board(), values);
+    UpdateSquare(move.to, Board(), values);
+    if (move.piece.type == PieceType::kPawn && move.from.x != move.to.x) {
+      UpdateSquare(Square{move.to.x, move.from.y}, Board(), values);
+    }
+  }
+
+  // The scalar planes, in the order of ObservationTensor.
+  int plane = 2 * kPieceTypes.size() + 1;
+  UpdateScalarPlane(NumRepetitions(), 1, 3, plane++, values);
+  UpdateScalarPlane(ColorToPlayer(Board().ToPlay()), 0, 1, plane++, values);
+  UpdateScalarPlane(Board().IrreversibleMoveCounter(), 0, 101, plane++,
+                    values);
+  for (Color color : {Color::kWhite, Color::kBlack}) {
+    for (CastlingDirection direction :
+         {CastlingDirection::kLeft, CastlingDirection::kRight}) {
+      UpdateBinaryPlane(Board().CastlingRight(color, direction), plane++,
+                        values);
+    }
+  }
+  return true;
+}
+
+int64_t ChessState::ApproximateMemoryUsage() const {
+  int64_t bytes = sizeof(*this) + HistoryMemoryUsage() +
+                  moves_history_.capacity() * sizeof(Move) +
+                  reversible_hashes_.capacity() * sizeof(uint64_t);
+  if (cached_legal_actions_) {
+    bytes += cached_legal_actions_->capacity() * sizeof(Action);
+  }
+  return bytes;
+}
+
 std::unique_ptr<State> ChessState::Clone() const {
   return std::unique_ptr<State>(new ChessState(*this));
 }
 
+bool ChessState::CopyFrom(const State& other) {
+  *this = static_cast<const ChessState&>(other);
+  return true;
+}
+
 void ChessState::UndoAction(Player player, Action action) {
   // TODO: Make this fast by storing undo info in another stack.
   SPIEL_CHECK_GE(moves_history_.size(), 1);
-  --repetitions_[current_board_.HashValue()];
   moves_history_.pop_back();
-  history_.pop_back();
+  PopHistory();
   current_board_ = start_board_;
+  reversible_hashes_.assign(1, current_board_.HashValue());
   for (const Move& move : moves_history_) {
     current_board_.ApplyMove(move);
+    if (current_board_.IrreversibleMoveCounter() == 0) {
+      reversible_hashes_.clear();
+    }
+    reversible_hashes_.push_back(current_board_.HashValue());
   }
+  cached_legal_actions_.reset();
 }
 
 bool ChessState::IsRepetitionDraw() const {
-  const auto entry = repetitions_.find(Board().HashValue());
-  SPIEL_CHECK_FALSE(entry == repetitions_.end());
-  return entry->second >= kNumRepetitionsToDraw;
+  return NumRepetitions() >= kNumRepetitionsToDraw;
+}
+
+int ChessState::NumRepetitions() const {
+  SPIEL_CHECK_FALSE(reversible_hashes_.empty());
+  // The hash includes the side to play, so only every other position can
+  // match.
+  const int last = reversible_hashes_.size() - 1;
+  int repetitions = 0;
+  for (int i = last; i >= 0; i -= 2) {
+    repetitions += reversible_hashes_[i] == reversible_hashes_[last];
+  }
+  return repetitions;
 }
 
 std::optional<std::vector<double>> ChessState::MaybeFinalReturns() const {
@@ -21,7 +21,6 @@
 #include <memory>
 #include <string>
 #include <vector>
-#include "open_spiel/abseil-cpp/absl/container/flat_hash_map.h"
 #include "open_spiel/abseil-cpp/absl/algorithm/container.h"
 #include "open_spiel/games/chess/chess_board.h"
 #include "open_spiel/spiel.h"
@@ -154,6 +153,9 @@ class ChessState : public State {
     return IsTerminal() ? kTerminalPlayerId : ColorToPlayer(Board().ToPlay());
   }
   std::vector<Action> LegalActions() const override;
+  void LegalActions(std::vector<Action>* actions) const override;
+  void LegalActionsMask(Player player,
+                        absl::Span<uint8_t> mask) const override;
   std::string ActionToString(Player player, Action action) const override;
   std::string ToString() const override;
 
@@ -166,8 +168,14 @@ class ChessState : public State {
   std::string ObservationString(Player player) const override;
   void ObservationTensor(Player player,
                          std::vector<double>* values) const override;
+  bool UpdateObservationTensor(Player player,
+                               absl::Span<float> values) const override;
   std::unique_ptr<State> Clone() const override;
+  bool CopyFrom(const State& other) override;
+  int64_t ApproximateMemoryUsage() const override;
+  uint64_t HashValue() const override { return current_board_.HashValue(); }
   void UndoAction(Player player, Action action) override;
+  bool SupportsUndoAction() const override { return true; }
 
   // Current board.
   StandardChessBoard& Board() { return current_board_; }
@@ -188,6 +196,9 @@ class ChessState : public State {
   // board position has already appeared twice in the history).
   bool IsRepetitionDraw() const;
 
+  // How many times the current board has occurred, including now.
+  int NumRepetitions() const;
+
   // Calculates legal actions and caches them. This is separate from
   // LegalActions() as there are a number of other methods that need the value
   // of LegalActions. This is a separate method as it's called from
@@ -205,18 +216,11 @@ class ChessState : public State {
   // We store the current board position as an optimization.
   StandardChessBoard current_board_;
 
-  // RepetitionTable records how many times the given hash exists in the history
-  // stack (including the current board).
-  // We are already indexing by board hash, so there is no need to hash that
-  // hash again, so we use a custom passthrough hasher.
-  class PassthroughHash {
-   public:
-    std::size_t operator()(uint64_t x) const {
-      return static_cast<std::size_t>(x);
-    }
-  };
-  using RepetitionTable = absl::flat_hash_map<uint64_t, int, PassthroughHash>;
-  RepetitionTable repetitions_;
+  // The hashes of the positions since the last irreversible move (a capture or
+  // pawn move), ending with the current board. Earlier positions can't occur
+  // again, so repetitions are counted by scanning this backwards. It holds at
+  // most kNumReversibleMovesToDraw + 1 hashes, so it is cheap to clone.
+  std::vector<uint64_t> reversible_hashes_;
   mutable std::optional<std::vector<Action>> cached_legal_actions_;
 };
 
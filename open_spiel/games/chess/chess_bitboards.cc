@@ -0,0 +1,247 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "open_spiel/games/chess/chess_bitboards.h"
+
+#include <array>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace chess {
+namespace {
+
+using chess_common::Offset;
+using chess_common::Square;
+
+constexpr std::array<Offset, 4> kRookDirections = {
+    {{1, 0}, {-1, 0}, {0, 1}, {0, -1}}};
+constexpr std::array<Offset, 4> kBishopDirections = {
+    {{1, 1}, {-1, 1}, {1, -1}, {-1, -1}}};
+
+// The magic numbers of the standard board, found by the search in
+// BitboardAttacks::InitMagics_ and checked when the tables are built, so that
+// they need not be searched for each time.
+constexpr std::array<Bitboard, 64> kStandardRookMagics = {{
+    0x0080008040002010ULL, 0x2040100020004000ULL, 0x8200220008804010ULL,
+    0x2080100104080080ULL, 0x8280040042080080ULL, 0x6200010822008410ULL,
+    0x1880020041000080ULL, 0x4100010009804232ULL, 0x2010802040008000ULL,
+    0x3024804008802002ULL, 0x00a0802000100080ULL, 0x0802808010000800ULL,
+    0x0002000886012010ULL, 0x0140800200040080ULL, 0x0002000801820004ULL,
+    0x1002001084420904ULL, 0x000480800ae04000ULL, 0x0000818020014000ULL,
+    0x9c80410011002004ULL, 0x0322020020400810ULL, 0x0004008008008004ULL,
+    0x2800808002000400ULL, 0x4000040002011008ULL, 0x3102020010411084ULL,
+    0x0000410100208008ULL, 0x4000200040005001ULL, 0x8000200080801000ULL,
+    0x0080100080080080ULL, 0x0044000808004080ULL, 0x4406000901000400ULL,
+    0x0001000101040200ULL, 0x0040108a00010844ULL, 0x0100804000800020ULL,
+    0x0010004001402008ULL, 0x0000408202001020ULL, 0x8040080080801001ULL,
+    0x203d001005000802ULL, 0x3800020080800400ULL, 0x8440020804000110ULL,
+    0x00490002430002a2ULL, 0x00c0400080208014ULL, 0x8810002000424000ULL,
+    0x0000804012020020ULL, 0x8c85001000210009ULL, 0x0088000402004040ULL,
+    0x2002000804010100ULL, 0x0200020004010100ULL, 0x020a040c40860001ULL,
+    0xc188221100438200ULL, 0x5100310040088100ULL, 0x4408402604108200ULL,
+    0x1005401009220200ULL, 0x0000080080040080ULL, 0x0062008002040080ULL,
+    0x2021000200040100ULL, 0x0100040040810200ULL, 0x0400800041002011ULL,
+    0x1040001981224101ULL, 0x0000411120000b01ULL, 0x0031100004a04901ULL,
+    0x1023000408000211ULL, 0x0082000810410482ULL, 0x040059080250009cULL,
+    0x0001000132004281ULL}};
+
+constexpr std::array<Bitboard, 64> kStandardBishopMagics = {{
+    0x00202032104a4082ULL, 0x0005044404002004ULL, 0x020401240d020011ULL,
+    0x0421104300024080ULL, 0x008a121040000100ULL, 0x8048481804000810ULL,
+    0x0802248c0440460cULL, 0x4003064802082201ULL, 0x5004112008014040ULL,
+    0x040c088141041500ULL, 0x9000100102042481ULL, 0x0082284843020380ULL,
+    0xa020111040000000ULL, 0x0020084808040200ULL, 0x4030204104602089ULL,
+    0x2004539201100243ULL, 0x0020024004840080ULL, 0x1018002008691240ULL,
+    0x0210000101020010ULL, 0x0902000440110128ULL, 0x0004101202020008ULL,
+    0x1202000041104108ULL, 0x800100740701d000ULL, 0x5022040100908400ULL,
+    0x0050080004081020ULL, 0x4018604002420209ULL, 0x00020100b2040c00ULL,
+    0x40948081c80200d2ULL, 0x230080200a020040ULL, 0x0008050802010100ULL,
+    0x6008208000420808ULL, 0x00220040020110c0ULL, 0x2902200480909028ULL,
+    0x2342222050103128ULL, 0x0422003000c20080ULL, 0x4021040400080210ULL,
+    0x0620008400228021ULL, 0x81c8c08500820100ULL, 0x8001041880242220ULL,
+    0x102880a503020101ULL, 0x4204018410304030ULL, 0x0004020110400424ULL,
+    0x006c0c0048000401ULL, 0x1088282018000101ULL, 0x1100409009000080ULL,
+    0x0c82108101000204ULL, 0x2002040102026423ULL, 0x0a24080081140020ULL,
+    0x9224011482204000ULL, 0x000610840402a000ULL, 0x20408100909010c1ULL,
+    0x000900c904090040ULL, 0x00024024a5040054ULL, 0x3000080248220020ULL,
+    0x0050200811025000ULL, 0x0020a11228810610ULL, 0x0002411400a00400ULL,
+    0x0000004042101000ULL, 0x0404009042289000ULL, 0x0420240020840420ULL,
+    0x1185000010e12600ULL, 0x0808000820088224ULL, 0x203812a002008204ULL,
+    0x0060080108122040ULL}};
+
+template <uint32_t kBoardSize>
+bool InBoard(const Square& sq) {
+  return sq.x >= 0 && sq.x < kBoardSize && sq.y >= 0 && sq.y < kBoardSize;
+}
+
+template <uint32_t kBoardSize>
+Bitboard SquareBit(const Square& sq) {
+  return Bitboard{1} << (sq.y * kBoardSize + sq.x);
+}
+
+template <uint32_t kBoardSize>
+Square IndexToSquare(int index) {
+  return Square{static_cast<int8_t>(index % kBoardSize),
+                static_cast<int8_t>(index / kBoardSize)};
+}
+
+// The squares one step away from sq, for each of the offsets.
+template <uint32_t kBoardSize, std::size_t N>
+Bitboard StepAttacks(const Square& sq, const std::array<Offset, N>& offsets) {
+  Bitboard attacks = 0;
+  for (const Offset& offset : offsets) {
+    const Square dest = sq + offset;
+    if (InBoard<kBoardSize>(dest)) attacks |= SquareBit<kBoardSize>(dest);
+  }
+  return attacks;
+}
+
+// The squares attacked along the rays, walking them square by square.
+template <uint32_t kBoardSize>
+Bitboard RayAttacks(const Square& sq, const std::array<Offset, 4>& directions,
+                    Bitboard occupied) {
+  Bitboard attacks = 0;
+  for (const Offset& step : directions) {
+    for (Square dest = sq + step; InBoard<kBoardSize>(dest); dest += step) {
+      attacks |= SquareBit<kBoardSize>(dest);
+      if (occupied & SquareBit<kBoardSize>(dest)) break;
+    }
+  }
+  return attacks;
+}
+
+// The squares of the rays whose occupancy changes the attacks: all but the
+// last square of each ray.
+template <uint32_t kBoardSize>
+Bitboard RelevantOccupancy(const Square& sq,
+                           const std::array<Offset, 4>& directions) {
+  Bitboard mask = 0;
+  for (const Offset& step : directions) {
+    for (Square dest = sq + step; InBoard<kBoardSize>(dest + step);
+         dest += step) {
+      mask |= SquareBit<kBoardSize>(dest);
+    }
+  }
+  return mask;
+}
+
+}  // namespace
+
+template <uint32_t kBoardSize>
+const BitboardAttacks<kBoardSize>& BitboardAttacks<kBoardSize>::Get() {
+  static const auto* attacks = new BitboardAttacks();
+  return *attacks;
+}
+
+template <uint32_t kBoardSize>
+BitboardAttacks<kBoardSize>::BitboardAttacks() {
+  static constexpr std::array<Offset, 8> kKingOffsets = {
+      {{1, 0}, {1, 1}, {1, -1}, {0, 1}, {0, -1}, {-1, 1}, {-1, 0}, {-1, -1}}};
+  static constexpr std::array<Offset, 8> kKnightOffsets = {
+      {{-2, -1}, {-2, 1}, {-1, -2}, {-1, 2}, {2, -1}, {2, 1}, {1, -2}, {1, 2}}};
+  static constexpr std::array<Offset, 2> kBlackPawnOffsets = {
+      {{-1, -1}, {1, -1}}};
+  static constexpr std::array<Offset, 2> kWhitePawnOffsets = {
+      {{-1, 1}, {1, 1}}};
+  for (int index = 0; index < kNumSquares; ++index) {
+    const Square sq = IndexToSquare<kBoardSize>(index);
+    king_[index] = StepAttacks<kBoardSize>(sq, kKingOffsets);
+    knight_[index] = StepAttacks<kBoardSize>(sq, kKnightOffsets);
+    pawn_[0][index] = StepAttacks<kBoardSize>(sq, kBlackPawnOffsets);
+    pawn_[1][index] = StepAttacks<kBoardSize>(sq, kWhitePawnOffsets);
+  }
+  const bool standard = kBoardSize == 8;
+  InitMagics_(kRookDirections,
+              standard ? kStandardRookMagics.data() : nullptr, &rook_magics_,
+              &rook_table_);
+  InitMagics_(kBishopDirections,
+              standard ? kStandardBishopMagics.data() : nullptr,
+              &bishop_magics_, &bishop_table_);
+}
+
+template <uint32_t kBoardSize>
+void BitboardAttacks<kBoardSize>::InitMagics_(
+    const std::array<Offset, 4>& directions, const Bitboard* known_magics,
+    std::array<Magic, kNumSquares>* magics, std::vector<Bitboard>* table) {
+  // The tables of all the squares are laid out one after the other, so they
+  // are sized first, and pointed to once they no longer move.
+  std::array<int, kNumSquares> offsets;
+  int table_size = 0;
+  for (int index = 0; index < kNumSquares; ++index) {
+    Magic& magic = (*magics)[index];
+    magic.mask = RelevantOccupancy<kBoardSize>(IndexToSquare<kBoardSize>(index),
+                                               directions);
+    magic.shift = 64 - NumSquares(magic.mask);
+    offsets[index] = table_size;
+    table_size += 1 << NumSquares(magic.mask);
+  }
+  table->assign(table_size, 0);
+
+  // Sparse random numbers make good magics; the seed keeps the search
+  // deterministic.
+  std::mt19937_64 rng(/*seed=*/728361);
+  std::vector<Bitboard> occupancies;
+  std::vector<Bitboard> reference;
+  std::vector<int> epoch_used;
+  for (int index = 0; index < kNumSquares; ++index) {
+    Magic& magic = (*magics)[index];
+    const Square sq = IndexToSquare<kBoardSize>(index);
+    Bitboard* attacks = table->data() + offsets[index];
+    const int size = 1 << NumSquares(magic.mask);
+
+    // Enumerates the subsets of the mask (the Carry-Rippler trick).
+    occupancies.clear();
+    reference.clear();
+    Bitboard subset = 0;
+    do {
+      occupancies.push_back(subset);
+      reference.push_back(RayAttacks<kBoardSize>(sq, directions, subset));
+      subset = (subset - magic.mask) & magic.mask;
+    } while (subset);
+
+    // An entry is free unless it was filled in the current attempt.
+    epoch_used.assign(size, 0);
+    for (int attempt = 1;; ++attempt) {
+      if (attempt == 1 && known_magics != nullptr) {
+        magic.magic = known_magics[index];
+      } else {
+        do {
+          magic.magic = rng() & rng() & rng();
+        } while (kNumSquares == 64 &&
+                 NumSquares((magic.mask * magic.magic) >> 56) < 6);
+      }
+      bool found = true;
+      for (int i = 0; i < occupancies.size(); ++i) {
+        const int entry = (occupancies[i] * magic.magic) >> magic.shift;
+        if (epoch_used[entry] < attempt) {
+          epoch_used[entry] = attempt;
+          attacks[entry] = reference[i];
+        } else if (attacks[entry] != reference[i]) {
+          found = false;
+          break;
+        }
+      }
+      if (found) break;
+    }
+    magic.attacks = attacks;
+  }
+}
+
+template class BitboardAttacks<8>;
+
+}  // namespace chess
+}  // namespace open_spiel
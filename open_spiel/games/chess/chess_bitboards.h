@@ -0,0 +1,120 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef OPEN_SPIEL_GAMES_IMPL_CHESS_CHESS_BITBOARDS_H_
+#define OPEN_SPIEL_GAMES_IMPL_CHESS_CHESS_BITBOARDS_H_
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "open_spiel/games/chess/chess_common.h"
+
+namespace open_spiel {
+namespace chess {
+
+// A set of squares, where bit y * board_size + x stands for the square {x, y}.
+using Bitboard = uint64_t;
+
+inline int NumSquares(Bitboard bitboard) {
+  return __builtin_popcountll(bitboard);
+}
+
+// The index of the lowest square of a non-empty bitboard.
+inline int LowestSquareIndex(Bitboard bitboard) {
+  return __builtin_ctzll(bitboard);
+}
+
+// Calls f(index) for the index of each square of the bitboard, in increasing
+// order.
+template <typename F>
+void ForEachSquareIndex(Bitboard bitboard, const F& f) {
+  for (; bitboard; bitboard &= bitboard - 1) f(LowestSquareIndex(bitboard));
+}
+
+// The squares attacked by each piece type from each square of a board of
+// kBoardSize x kBoardSize squares, which must fit in a bitboard.
+//
+// Sliding attacks are looked up in magic bitboard tables: the occupied squares
+// of the rays of a piece, but their last ones, are multiplied by a magic number
+// which maps each set of them to a distinct entry of the table of the square.
+// The magic numbers are searched for when the tables are first built, except
+// on the standard board, whose magics are known.
+template <uint32_t kBoardSize>
+class BitboardAttacks {
+ public:
+  static_assert(kBoardSize * kBoardSize <= 64,
+                "The board does not fit in a bitboard.");
+  static constexpr int kNumSquares = kBoardSize * kBoardSize;
+
+  // The tables, built on the first call.
+  static const BitboardAttacks& Get();
+
+  // All the squares of the board.
+  static constexpr Bitboard kAllSquares =
+      kNumSquares == 64 ? ~Bitboard{0} : (Bitboard{1} << kNumSquares) - 1;
+
+  Bitboard King(int index) const { return king_[index]; }
+  Bitboard Knight(int index) const { return knight_[index]; }
+
+  // The squares attacked by a pawn moving up the board if white, or down if
+  // not.
+  Bitboard Pawn(bool white, int index) const { return pawn_[white][index]; }
+
+  // The squares attacked by a rook or a bishop, up to and including the first
+  // occupied square in each direction.
+  Bitboard Rook(int index, Bitboard occupied) const {
+    return Lookup_(rook_magics_[index], occupied);
+  }
+  Bitboard Bishop(int index, Bitboard occupied) const {
+    return Lookup_(bishop_magics_[index], occupied);
+  }
+  Bitboard Queen(int index, Bitboard occupied) const {
+    return Rook(index, occupied) | Bishop(index, occupied);
+  }
+
+ private:
+  struct Magic {
+    Bitboard mask;
+    Bitboard magic;
+    int shift;
+    const Bitboard* attacks;
+  };
+
+  BitboardAttacks();
+
+  Bitboard Lookup_(const Magic& magic, Bitboard occupied) const {
+    return magic.attacks[((occupied & magic.mask) * magic.magic) >>
+                         magic.shift];
+  }
+
+  // Finds the magics of a piece moving in the directions, trying those of
+  // known_magics first if it is not null, and fills their tables.
+  void InitMagics_(const std::array<chess_common::Offset, 4>& directions,
+                   const Bitboard* known_magics,
+                   std::array<Magic, kNumSquares>* magics,
+                   std::vector<Bitboard>* table);
+
+  std::array<Bitboard, kNumSquares> king_;
+  std::array<Bitboard, kNumSquares> knight_;
+  std::array<std::array<Bitboard, kNumSquares>, 2> pawn_;
+  std::array<Magic, kNumSquares> rook_magics_;
+  std::array<Magic, kNumSquares> bishop_magics_;
+  std::vector<Bitboard> rook_table_;
+  std::vector<Bitboard> bishop_table_;
+};
+
+}  // namespace chess
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_GAMES_IMPL_CHESS_CHESS_BITBOARDS_H_
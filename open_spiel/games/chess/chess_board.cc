@@ -321,6 +321,12 @@ ChessBoard<kBoardSize>::ChessBoard()
       castling_rights_{{true, true}, {true, true}},
       zobrist_hash_(0) {
   board_.fill(kEmptyPiece);
+  color_bitboards_.fill(0);
+  color_bitboards_[static_cast<int>(Color::kEmpty)] =
+      BitboardAttacks<kBoardSize>::kAllSquares;
+  piece_type_bitboards_.fill(0);
+  piece_type_bitboards_[static_cast<int>(PieceType::kEmpty)] =
+      BitboardAttacks<kBoardSize>::kAllSquares;
 }
 
 template <uint32_t kBoardSize>
@@ -439,131 +445,107 @@ ChessBoard<kBoardSize>::BoardFromFEN(const std::string &fen) {
 
 template <uint32_t kBoardSize>
 Square ChessBoard<kBoardSize>::find(const Piece &piece) const {
-  for (int8_t y = 0; y < kBoardSize; ++y) {
-    for (int8_t x = 0; x < kBoardSize; ++x) {
-      Square sq{x, y};
-      if (at(sq) == piece) {
-        return sq;
-      }
-    }
-  }
-
-  return InvalidSquare();
+  const Bitboard squares = PieceBitboard(piece);
+  if (!squares) return InvalidSquare();
+  return IndexToSquare_(LowestSquareIndex(squares));
 }
 
 template <uint32_t kBoardSize>
 void ChessBoard<kBoardSize>::GenerateLegalMoves(
     const MoveYieldFn &yield) const {
-  auto king_square = find(Piece{to_play_, PieceType::kKing});
-
-  GeneratePseudoLegalMoves([this, &king_square, &yield](const Move &move) {
-    // See if the move is legal by applying, checking whether the king is
-    // under attack, and undoing the move.
-    // TODO: Optimize this.
-    auto board_copy = *this;
-    board_copy.ApplyMove(move);
-
-    auto ks = at(move.from).type == PieceType::kKing ? move.to : king_square;
-
-    if (board_copy.UnderAttack(ks, to_play_)) {
-      return true;
-    } else {
-      return yield(move);
-    }
-  });
+  GenerateLegalMoves<MoveYieldFn>(yield);
 }
 
 template <uint32_t kBoardSize>
 void ChessBoard<kBoardSize>::GeneratePseudoLegalMoves(
     const MoveYieldFn &yield) const {
-  bool generating = true;
+  GeneratePseudoLegalMoves<MoveYieldFn>(yield);
+}
 
-#define YIELD(move)     \
-  if (!yield(move)) {   \
-    generating = false; \
-  }
+template <uint32_t kBoardSize>
+void ChessBoard<kBoardSize>::FindPinsAndChecks_(
+    Square king_square, PinsAndChecks_ *pins_and_checks) const {
+  // The orthogonal directions first, then the diagonal ones.
+  static const std::array<Offset, 8> kDirections = {
+      {{1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {-1, 1}, {1, -1}, {-1, -1}}};
+  const Color opponent_color = OppColor(to_play_);
+  auto add_checker = [pins_and_checks](Square from, Square to, Offset step) {
+    ++pins_and_checks->num_checkers;
+    for (Square sq = from;; sq += step) {
+      pins_and_checks->blocks_check[SquareToIndex_(sq)] = true;
+      if (sq == to) break;
+    }
+  };
 
-  for (int8_t y = 0; y < kBoardSize && generating; ++y) {
-    for (int8_t x = 0; x < kBoardSize && generating; ++x) {
-      Square sq{x, y};
-      auto &piece = at(sq);
-      if (piece.type != PieceType::kEmpty && piece.color == to_play_) {
-        switch (piece.type) {
-          case PieceType::kKing:
-            GenerateKingDestinations_(
-                sq, to_play_,
-                [&yield, &piece, &sq, &generating](const Square &to) {
-                  YIELD(Move(sq, to, piece));
-                });
-            GenerateCastlingDestinations_(
-                sq, to_play_,
-                [&yield, &piece, &sq, &generating](const Square &to) {
-                  YIELD(Move(sq, to, piece, PieceType::kEmpty, true));
-                });
-            break;
-          case PieceType::kQueen:
-            GenerateQueenDestinations_(
-                sq, to_play_,
-                [&yield, &sq, &piece, &generating](const Square &to) {
-                  YIELD(Move(sq, to, piece));
-                });
-            break;
-          case PieceType::kRook:
-            GenerateRookDestinations_(
-                sq, to_play_,
-                [&yield, &sq, &piece, &generating](const Square &to) {
-                  YIELD(Move(sq, to, piece));
-                });
-            break;
-          case PieceType::kBishop:
-            GenerateBishopDestinations_(
-                sq, to_play_,
-                [&yield, &sq, &piece, &generating](const Square &to) {
-                  YIELD(Move(sq, to, piece));
-                });
-            break;
-          case PieceType::kKnight:
-            GenerateKnightDestinations_(
-                sq, to_play_,
-                [&yield, &sq, &piece, &generating](const Square &to) {
-                  YIELD(Move(sq, to, piece));
-                });
-            break;
-          case PieceType::kPawn:
-            GeneratePawnDestinations_(
-                sq, to_play_,
-                [&yield, &sq, &piece, &generating](const Square &to) {
-                  if (IsPawnPromotionRank(to)) {
-                    YIELD(Move(sq, to, piece, PieceType::kQueen));
-                    YIELD(Move(sq, to, piece, PieceType::kRook));
-                    YIELD(Move(sq, to, piece, PieceType::kBishop));
-                    YIELD(Move(sq, to, piece, PieceType::kKnight));
-                  } else {
-                    YIELD(Move(sq, to, piece));
-                  }
-                });
-            GeneratePawnCaptureDestinations_(
-                sq, to_play_, true, /* include enpassant */
-                [&yield, &sq, &piece, &generating](const Square &to) {
-                  if (IsPawnPromotionRank(to)) {
-                    YIELD(Move(sq, to, piece, PieceType::kQueen));
-                    YIELD(Move(sq, to, piece, PieceType::kRook));
-                    YIELD(Move(sq, to, piece, PieceType::kBishop));
-                    YIELD(Move(sq, to, piece, PieceType::kKnight));
-                  } else {
-                    YIELD(Move(sq, to, piece));
-                  }
-                });
-            break;
-          default:
-            std::cerr << "Unknown piece type: " << static_cast<int>(piece.type)
-                      << std::endl;
+  // Sliding pieces, looking from the king for an opponent's piece, with at
+  // most one of ours in between.
+  for (int d = 0; d < kDirections.size(); ++d) {
+    const Offset step = kDirections[d];
+    const PieceType slider = d < 4 ? PieceType::kRook : PieceType::kBishop;
+    Square pinned = InvalidSquare();
+    for (Square sq = king_square + step; InBoardArea(sq); sq += step) {
+      const Piece &piece = at(sq);
+      if (piece.type == PieceType::kEmpty) continue;
+      if (piece.color == to_play_) {
+        if (pinned != InvalidSquare()) break;
+        pinned = sq;
+        continue;
+      }
+      if (piece.type == slider || piece.type == PieceType::kQueen) {
+        if (pinned == InvalidSquare()) {
+          add_checker(king_square + step, sq, step);
+        } else {
+          pins_and_checks->pin_directions[SquareToIndex_(pinned)] = step;
         }
       }
+      break;
     }
   }
 
-#undef YIELD
+  for (const auto &offset : kKnightOffsets) {
+    Square sq = king_square + offset;
+    if (InBoardArea(sq) &&
+        at(sq) == Piece{opponent_color, PieceType::kKnight}) {
+      add_checker(sq, sq, offset);
+    }
+  }
+  const int8_t y_direction = to_play_ == Color::kWhite ? 1 : -1;
+  for (int8_t x_direction : {-1, 1}) {
+    Square sq = king_square + Offset{x_direction, y_direction};
+    if (InBoardArea(sq) && at(sq) == Piece{opponent_color, PieceType::kPawn}) {
+      add_checker(sq, sq, Offset{x_direction, y_direction});
+    }
+  }
+}
+
+template <uint32_t kBoardSize>
+bool ChessBoard<kBoardSize>::IsLegal_(
+    const Move &move, Square king_square,
+    const PinsAndChecks_ &pins_and_checks) const {
+  // King moves, and en passant captures, which can uncover a check along the
+  // rank of both pawns, are tested by applying them.
+  if (move.piece.type == PieceType::kKing ||
+      (move.piece.type == PieceType::kPawn && move.to == EpSquare() &&
+       IsEmpty(move.to))) {
+    auto board_copy = *this;
+    board_copy.ApplyMove(move);
+    return !board_copy.UnderAttack(
+        move.piece.type == PieceType::kKing ? move.to : king_square, to_play_);
+  }
+
+  // Only the king can get out of a double check, and other pieces must
+  // capture the checking piece or block it.
+  if (pins_and_checks.num_checkers > 1) return false;
+  if (pins_and_checks.num_checkers == 1 &&
+      !pins_and_checks.blocks_check[SquareToIndex_(move.to)]) {
+    return false;
+  }
+
+  // A pinned piece can only move along the line of the pin.
+  const Offset pin = pins_and_checks.pin_directions[SquareToIndex_(move.from)];
+  if (pin.x_offset == 0 && pin.y_offset == 0) return true;
+  return (move.to.x - king_square.x) * pin.y_offset ==
+         (move.to.y - king_square.y) * pin.x_offset;
 }
 
 template <uint32_t kBoardSize>
@@ -918,7 +900,7 @@ void ChessBoard<kBoardSize>::ApplyMove(const Move &move) {
   // Special cases that require adjustment -
   // 1. Castling
   if (move.is_castling) {
-    SPIEL_CHECK_EQ(moving_piece.type, PieceType::kKing);
+    SPIEL_DCHECK_EQ(moving_piece.type, PieceType::kKing);
     // We can tell which side we are castling to using "to" square.
     if (to_play_ == Color::kWhite) {
       if (move.to == Square{2, 0}) {
@@ -970,8 +952,8 @@ void ChessBoard<kBoardSize>::ApplyMove(const Move &move) {
     } else {
       ++captured_pawn_square.y;
     }
-    SPIEL_CHECK_EQ(at(captured_pawn_square),
-                   (Piece{OppColor(to_play_), PieceType::kPawn}));
+    SPIEL_DCHECK_EQ(at(captured_pawn_square),
+                    (Piece{OppColor(to_play_), PieceType::kPawn}));
     set_square(captured_pawn_square, kEmptyPiece);
   }
 
@@ -1006,76 +988,26 @@ bool ChessBoard<kBoardSize>::TestApplyMove(const Move &move) {
 template <uint32_t kBoardSize>
 bool ChessBoard<kBoardSize>::UnderAttack(const Square &sq,
                                          Color our_color) const {
-  SPIEL_CHECK_NE(sq, InvalidSquare());
-
-  bool under_attack = false;
-  Color opponent_color = OppColor(our_color);
-
-  // We do this by pretending we are a piece of different types, and seeing if
-  // we can attack opponent pieces. Eg. if we pretend we are a knight, and can
-  // attack an opponent knight, that means the knight can also attack us.
-
-  // King moves (this is possible because we use this function for checking
-  // whether we are moving into check, and we can be trying to move the king
-  // into a square attacked by opponent king).
-  GenerateKingDestinations_(
-      sq, our_color, [this, &under_attack, &opponent_color](const Square &to) {
-        if (at(to) == Piece{opponent_color, PieceType::kKing}) {
-          under_attack = true;
-        }
-      });
-  if (under_attack) {
-    return true;
-  }
-
-  // Rook moves (for rooks and queens)
-  GenerateRookDestinations_(
-      sq, our_color, [this, &under_attack, &opponent_color](const Square &to) {
-        if ((at(to) == Piece{opponent_color, PieceType::kRook}) ||
-            (at(to) == Piece{opponent_color, PieceType::kQueen})) {
-          under_attack = true;
-        }
-      });
-  if (under_attack) {
-    return true;
-  }
-
-  // Bishop moves (for bishops and queens)
-  GenerateBishopDestinations_(
-      sq, our_color, [this, &under_attack, &opponent_color](const Square &to) {
-        if ((at(to) == Piece{opponent_color, PieceType::kBishop}) ||
-            (at(to) == Piece{opponent_color, PieceType::kQueen})) {
-          under_attack = true;
-        }
-      });
-  if (under_attack) {
-    return true;
-  }
-
-  // Knight moves
-  GenerateKnightDestinations_(
-      sq, our_color, [this, &under_attack, &opponent_color](const Square &to) {
-        if (at(to) == Piece{opponent_color, PieceType::kKnight}) {
-          under_attack = true;
-        }
-      });
-  if (under_attack) {
-    return true;
-  }
-
-  // Pawn captures.
-  GeneratePawnCaptureDestinations_(
-      sq, our_color, false /* no ep */,
-      [this, &under_attack, &opponent_color](const Square &to) {
-        if (at(to) == Piece{opponent_color, PieceType::kPawn}) {
-          under_attack = true;
-        }
-      });
-  if (under_attack) {
-    return true;
-  }
-
-  return false;
+  SPIEL_DCHECK_NE(sq, InvalidSquare());
+
+  // The opponent's pieces attacking the square are those which a piece of the
+  // same type on the square would attack (pawns looking the other way).
+  const BitboardAttacks<kBoardSize> &attacks =
+      BitboardAttacks<kBoardSize>::Get();
+  const int index = SquareToIndex_(sq);
+  const Bitboard opponent = ColorBitboard(OppColor(our_color));
+  const Bitboard occupied = OccupiedBitboard_();
+  const Bitboard queens = PieceTypeBitboard(PieceType::kQueen);
+  return (attacks.King(index) & opponent &
+          PieceTypeBitboard(PieceType::kKing)) ||
+         (attacks.Knight(index) & opponent &
+          PieceTypeBitboard(PieceType::kKnight)) ||
+         (attacks.Pawn(our_color == Color::kWhite, index) & opponent &
+          PieceTypeBitboard(PieceType::kPawn)) ||
+         (attacks.Rook(index, occupied) & opponent &
+          (PieceTypeBitboard(PieceType::kRook) | queens)) ||
+         (attacks.Bishop(index, occupied) & opponent &
+          (PieceTypeBitboard(PieceType::kBishop) | queens));
 }
 
 template <uint32_t kBoardSize>
@@ -1124,241 +1056,6 @@ std::string ChessBoard<kBoardSize>::DebugString() const {
   return s;
 }
 
-// King moves without castling.
-template <uint32_t kBoardSize>
-template <typename YieldFn>
-void ChessBoard<kBoardSize>::GenerateKingDestinations_(
-    Square sq, Color color, const YieldFn &yield) const {
-  static const std::array<Offset, 8> kOffsets = {
-      {{1, 0}, {1, 1}, {1, -1}, {0, 1}, {0, -1}, {-1, 1}, {-1, 0}, {-1, -1}}};
-
-  for (const auto &offset : kOffsets) {
-    Square dest = sq + offset;
-    if (InBoardArea(dest) && IsEmptyOrEnemy(dest, color)) {
-      yield(dest);
-    }
-  }
-}
-
-template <uint32_t kBoardSize>
-template <typename YieldFn>
-void ChessBoard<kBoardSize>::GenerateCastlingDestinations_(
-    Square sq, Color color, const YieldFn &yield) const {
-  // There are 8 conditions for castling -
-  // 1. The rook involved must not have moved.
-  // 2. The king must not have moved.
-  // 3. The rook involved must still be alive.
-  // 4. All squares king jumps over must be empty.
-  // 5. All squares the rook jumps over must be empty.
-  // 6. The squares the king jumps over must not be under attack.
-  // 7. The king must not be in check.
-  // (8). The square the king ends up in must not be under attack.
-  //
-  // We don't check for (8) here because this is not unique to castling, and
-  // we will check for it later.
-  //
-  // We use the generalized definition of castling from Chess960, instead of
-  // hard-coding starting squares.
-  // By Chess960 rules, the king and rook end up in the same positions as in
-  // standard chess, but they can start from any squares.
-  //
-  // Castling to one side doesn't necessarily mean the king will move towards
-  // that side.
-  // Eg.
-  // |RK...R..| + long castle (to the left) =>
-  // |..KR.R..|
-
-  // Whether all squares between sq1 and sq2 exclusive are empty, and
-  // optionally safe (not under attack).
-  const auto check_squares_between = [this, &color](const Square &sq1,
-                                                    const Square &sq2,
-                                                    bool check_safe) -> bool {
-    SPIEL_CHECK_EQ(sq1.y, sq2.y);
-
-    if (sq1.x <= sq2.x) {
-      for (Square test_square = sq1 + Offset{1, 0}; test_square != sq2;
-           test_square += Offset{1, 0}) {
-        if (!IsEmpty(test_square) ||
-            (check_safe && UnderAttack(test_square, color))) {
-          return false;
-        }
-      }
-    } else {
-      for (Square test_square = sq1 + Offset{-1, 0}; test_square != sq2;
-           test_square += Offset{-1, 0}) {
-        if (!IsEmpty(test_square) ||
-            (check_safe && UnderAttack(test_square, color))) {
-          return false;
-        }
-      }
-    }
-
-    return true;
-  };
-
-  const auto check_castling_conditions =
-      [this, &sq, &color, &check_squares_between](int8_t direction) -> bool {
-    // First we need to find the rook.
-    Square rook_sq = sq + Offset{direction, 0};
-    bool rook_found = false;
-
-    // Yes, we do actually have to check colour -
-    // https://github.com/official-stockfish/Stockfish/issues/356
-    for (; InBoardArea(rook_sq); rook_sq.x += direction) {
-      if (at(rook_sq) == Piece{color, PieceType::kRook}) {
-        rook_found = true;
-        break;
-      }
-    }
-
-    if (!rook_found) {
-      std::cerr << "Where did our rook go?" << *this << "\n"
-                << "Square: " << SquareToString(sq) << std::endl;
-      SpielFatalError("Rook not found");
-    }
-
-    static_assert(kBoardSize == 8,
-                  "This is not boardsize-independent! What does castling "
-                  "mean for other boardsizes?");
-    int8_t rook_final_x = direction == -1 ? 3 /* d-file */ : 5 /* f-file */;
-    Square rook_final_sq = Square{rook_final_x, sq.y};
-    int8_t king_final_x = direction == -1 ? 2 /* c-file */ : 6 /* g-file */;
-    Square king_final_sq = Square{king_final_x, sq.y};
-
-    // 4. 5. 6. All squares the king and rook jump over, including the final
-    // squares, must be empty. Squares king jumps over must additionally be
-    // safe.
-    if (!IsEmpty(rook_final_sq) || !IsEmpty(king_final_sq) ||
-        !check_squares_between(rook_sq, rook_final_sq, false) ||
-        !check_squares_between(sq, king_final_sq, true)) {
-      return false;
-    }
-
-    return true;
-  };
-
-  // 1. 2. 3. Moving the king, moving the rook, or the rook getting captured
-  // will reset the flag.
-  bool can_left_castle = CastlingRight(color, CastlingDirection::kLeft) &&
-                         check_castling_conditions(-1);
-  bool can_right_castle = CastlingRight(color, CastlingDirection::kRight) &&
-                          check_castling_conditions(1);
-
-  if (can_left_castle || can_right_castle) {
-    // 7. No castling to escape from check.
-    if (UnderAttack(sq, color)) {
-      return;
-    }
-
-    static_assert(kBoardSize == 8,
-                  "This is not boardsize-independent! What does castling "
-                  "mean for other boardsizes?");
-    if (can_left_castle) {
-      yield(Square{static_cast<int8_t>(2), sq.y});
-    }
-
-    if (can_right_castle) {
-      yield(Square{static_cast<int8_t>(6), sq.y});
-    }
-  }
-}
-
-template <uint32_t kBoardSize>
-template <typename YieldFn>
-void ChessBoard<kBoardSize>::GenerateQueenDestinations_(
-    Square sq, Color color, const YieldFn &yield) const {
-  GenerateRookDestinations_(sq, color, yield);
-  GenerateBishopDestinations_(sq, color, yield);
-}
-
-template <uint32_t kBoardSize>
-template <typename YieldFn>
-void ChessBoard<kBoardSize>::GenerateRookDestinations_(
-    Square sq, Color color, const YieldFn &yield) const {
-  GenerateRayDestinations_(sq, color, {1, 0}, yield);
-  GenerateRayDestinations_(sq, color, {-1, 0}, yield);
-  GenerateRayDestinations_(sq, color, {0, 1}, yield);
-  GenerateRayDestinations_(sq, color, {0, -1}, yield);
-}
-
-template <uint32_t kBoardSize>
-template <typename YieldFn>
-void ChessBoard<kBoardSize>::GenerateBishopDestinations_(
-    Square sq, Color color, const YieldFn &yield) const {
-  GenerateRayDestinations_(sq, color, {1, 1}, yield);
-  GenerateRayDestinations_(sq, color, {-1, 1}, yield);
-  GenerateRayDestinations_(sq, color, {1, -1}, yield);
-  GenerateRayDestinations_(sq, color, {-1, -1}, yield);
-}
-
-template <uint32_t kBoardSize>
-template <typename YieldFn>
-void ChessBoard<kBoardSize>::GenerateKnightDestinations_(
-    Square sq, Color color, const YieldFn &yield) const {
-  for (const auto &offset : kKnightOffsets) {
-    Square dest = sq + offset;
-    if (InBoardArea(dest) && IsEmptyOrEnemy(dest, color)) {
-      yield(dest);
-    }
-  }
-}
-
-// Pawn moves without captures.
-template <uint32_t kBoardSize>
-template <typename YieldFn>
-void ChessBoard<kBoardSize>::GeneratePawnDestinations_(
-    Square sq, Color color, const YieldFn &yield) const {
-  int8_t y_direction = color == Color::kWhite ? 1 : -1;
-  Square dest = sq + Offset{0, y_direction};
-  if (InBoardArea(dest) && IsEmpty(dest)) {
-    yield(dest);
-
-    // Test for double move.
-    if (IsPawnStartingRank(sq, color)) {
-      dest = sq + Offset{0, static_cast<int8_t>(2 * y_direction)};
-      if (IsEmpty(dest)) {
-        yield(dest);
-      }
-    }
-  }
-}
-
-// Pawn capture destinations, with or without en passant.
-template <uint32_t kBoardSize>
-template <typename YieldFn>
-void ChessBoard<kBoardSize>::GeneratePawnCaptureDestinations_(
-    Square sq, Color color, bool include_ep, const YieldFn &yield) const {
-  int8_t y_direction = color == Color::kWhite ? 1 : -1;
-  Square dest = sq + Offset{1, y_direction};
-  if (InBoardArea(dest) &&
-      (IsEnemy(dest, color) || (include_ep && dest == EpSquare()))) {
-    yield(dest);
-  }
-
-  dest = sq + Offset{-1, y_direction};
-  if (InBoardArea(dest) &&
-      (IsEnemy(dest, color) || (include_ep && dest == EpSquare()))) {
-    yield(dest);
-  }
-}
-
-template <uint32_t kBoardSize>
-template <typename YieldFn>
-void ChessBoard<kBoardSize>::GenerateRayDestinations_(
-    Square sq, Color color, Offset offset_step, const YieldFn &yield) const {
-  for (Square dest = sq + offset_step; InBoardArea(dest); dest += offset_step) {
-    if (IsEmpty(dest)) {
-      yield(dest);
-    } else if (IsEnemy(dest, color)) {
-      yield(dest);
-      break;
-    } else {
-      // We have a friendly piece.
-      break;
-    }
-  }
-}
-
 template <uint32_t kBoardSize>
 std::string ChessBoard<kBoardSize>::ToUnicodeString() const {
   std::string out = "\n";
@@ -1457,6 +1154,12 @@ void ChessBoard<kBoardSize>::set_square(Square sq, Piece piece) {
                                  [static_cast<int>(piece.type)];
 
   board_[position] = piece;
+
+  const Bitboard bit = Bitboard{1} << position;
+  color_bitboards_[static_cast<int>(current_piece.color)] &= ~bit;
+  piece_type_bitboards_[static_cast<int>(current_piece.type)] &= ~bit;
+  color_bitboards_[static_cast<int>(piece.color)] |= bit;
+  piece_type_bitboards_[static_cast<int>(piece.type)] |= bit;
 }
 
 template <uint32_t kBoardSize>
@@ -1553,5 +1256,21 @@ StandardChessBoard MakeDefaultBoard() {
   return *maybe_board;
 }
 
+int64_t Perft(const StandardChessBoard &board, int depth) {
+  if (depth == 0) return 1;
+  int64_t num_leaves = 0;
+  board.GenerateLegalMoves([&board, &num_leaves, depth](const Move &move) {
+    if (depth == 1) {
+      ++num_leaves;
+    } else {
+      StandardChessBoard child = board;
+      child.ApplyMove(move);
+      num_leaves += Perft(child, depth - 1);
+    }
+    return true;
+  });
+  return num_leaves;
+}
+
 }  // namespace chess
 }  // namespace open_spiel
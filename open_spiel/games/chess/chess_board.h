@@ -24,6 +24,8 @@
 #include <utility>
 #include <vector>
 
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/games/chess/chess_bitboards.h"
 #include "open_spiel/games/chess/chess_common.h"
 #include "open_spiel/spiel_utils.h"
 
@@ -238,6 +240,19 @@ class ChessBoard {
     return board_;
   }
 
+  // The squares of the pieces of a color (or the empty squares, for
+  // Color::kEmpty), of a piece type of either color, and of a piece, as
+  // bitboards kept along with the pieces.
+  Bitboard ColorBitboard(Color color) const {
+    return color_bitboards_[static_cast<int>(color)];
+  }
+  Bitboard PieceTypeBitboard(PieceType type) const {
+    return piece_type_bitboards_[static_cast<int>(type)];
+  }
+  Bitboard PieceBitboard(const Piece& piece) const {
+    return ColorBitboard(piece.color) & PieceTypeBitboard(piece.type);
+  }
+
   Color ToPlay() const { return to_play_; }
   void SetToPlay(Color c);
 
@@ -260,9 +275,19 @@ class ChessBoard {
   // The yield function should return whether generation should continue.
   // For performance reasons, we do not guarantee that no more moves will be
   // generated if yield returns false. It is only for optimization.
+  //
+  // The templated versions call yield directly, so that it can be inlined,
+  // rather than through a std::function for each move; they are the ones
+  // called with a lambda. Legal moves are found from the pins and checks of
+  // the king, without applying the moves, except for king moves and en
+  // passant captures.
   using MoveYieldFn = std::function<bool(const Move&)>;
   void GenerateLegalMoves(const MoveYieldFn& yield) const;
   void GeneratePseudoLegalMoves(const MoveYieldFn& yield) const;
+  template <typename YieldFn>
+  void GenerateLegalMoves(const YieldFn& yield) const;
+  template <typename YieldFn>
+  void GeneratePseudoLegalMoves(const YieldFn& yield) const;
 
   bool HasLegalMoves() const {
     bool found = false;
@@ -363,6 +388,15 @@ class ChessBoard {
 
  private:
   static size_t SquareToIndex_(Square sq) { return sq.y * kBoardSize + sq.x; }
+  static Square IndexToSquare_(int index) {
+    return Square{static_cast<int8_t>(index % kBoardSize),
+                  static_cast<int8_t>(index / kBoardSize)};
+  }
+
+  Bitboard OccupiedBitboard_() const {
+    return color_bitboards_[static_cast<int>(Color::kWhite)] |
+           color_bitboards_[static_cast<int>(Color::kBlack)];
+  }
 
   /* Generate*Destinations functions call yield(sq) for every potential
    * destination generated.
@@ -421,15 +455,37 @@ class ChessBoard {
   void GeneratePawnCaptureDestinations_(Square sq, Color color, bool include_ep,
                                         const YieldFn& yield) const;
 
-  // Helper function.
+  // Helper function, yielding the squares of the bitboard.
   template <typename YieldFn>
-  void GenerateRayDestinations_(Square sq, Color color, Offset offset_step,
-                                const YieldFn& yield) const;
+  void GenerateBitboardDestinations_(Bitboard destinations,
+                                     const YieldFn& yield) const;
+
+  // The pieces checking the king of the player to move, and those pinned to
+  // it, for legal move generation.
+  struct PinsAndChecks_ {
+    int num_checkers = 0;
+    // The squares which capture or block the only checking piece: that
+    // piece's square and those between it and the king.
+    std::array<bool, kBoardSize * kBoardSize> blocks_check{};
+    // For the squares of pinned pieces, the direction of the pin, from the
+    // king, and {0, 0} for the other squares.
+    std::array<Offset, kBoardSize * kBoardSize> pin_directions{};
+  };
+
+  void FindPinsAndChecks_(Square king_square,
+                          PinsAndChecks_* pins_and_checks) const;
+
+  // Whether a pseudo-legal move of the player to move is legal.
+  bool IsLegal_(const Move& move, Square king_square,
+                const PinsAndChecks_& pins_and_checks) const;
 
   void SetIrreversibleMoveCounter(int c);
   void SetMovenumber(int move_number);
 
   std::array<Piece, kBoardSize * kBoardSize> board_;
+  // Indexed by Color, and by PieceType.
+  std::array<Bitboard, 3> color_bitboards_;
+  std::array<Bitboard, 7> piece_type_bitboards_;
   Color to_play_;
   Square ep_square_;
   int32_t irreversible_move_counter_;
@@ -446,6 +502,335 @@ class ChessBoard {
   uint64_t zobrist_hash_;
 };
 
+template <uint32_t kBoardSize>
+template <typename YieldFn>
+void ChessBoard<kBoardSize>::GenerateLegalMoves(const YieldFn& yield) const {
+  const Square king_square = find(Piece{to_play_, PieceType::kKing});
+  PinsAndChecks_ pins_and_checks;
+  FindPinsAndChecks_(king_square, &pins_and_checks);
+  GeneratePseudoLegalMoves(
+      [this, &king_square, &pins_and_checks, &yield](const Move& move) {
+        if (!IsLegal_(move, king_square, pins_and_checks)) return true;
+        return yield(move);
+      });
+}
+
+template <uint32_t kBoardSize>
+template <typename YieldFn>
+void ChessBoard<kBoardSize>::GeneratePseudoLegalMoves(
+    const YieldFn& yield) const {
+  bool generating = true;
+
+#define YIELD(move)     \
+  if (!yield(move)) {   \
+    generating = false; \
+  }
+
+  // The squares of our pieces, in increasing order.
+  for (Bitboard own = ColorBitboard(to_play_); own && generating;
+       own &= own - 1) {
+    const Square sq = IndexToSquare_(LowestSquareIndex(own));
+    const Piece& piece = at(sq);
+    switch (piece.type) {
+      case PieceType::kKing:
+        GenerateKingDestinations_(
+            sq, to_play_,
+            [&yield, &piece, &sq, &generating](const Square& to) {
+              YIELD(Move(sq, to, piece));
+            });
+        GenerateCastlingDestinations_(
+            sq, to_play_,
+            [&yield, &piece, &sq, &generating](const Square& to) {
+              YIELD(Move(sq, to, piece, PieceType::kEmpty, true));
+            });
+        break;
+      case PieceType::kQueen:
+        GenerateQueenDestinations_(
+            sq, to_play_,
+            [&yield, &sq, &piece, &generating](const Square& to) {
+              YIELD(Move(sq, to, piece));
+            });
+        break;
+      case PieceType::kRook:
+        GenerateRookDestinations_(
+            sq, to_play_,
+            [&yield, &sq, &piece, &generating](const Square& to) {
+              YIELD(Move(sq, to, piece));
+            });
+        break;
+      case PieceType::kBishop:
+        GenerateBishopDestinations_(
+            sq, to_play_,
+            [&yield, &sq, &piece, &generating](const Square& to) {
+              YIELD(Move(sq, to, piece));
+            });
+        break;
+      case PieceType::kKnight:
+        GenerateKnightDestinations_(
+            sq, to_play_,
+            [&yield, &sq, &piece, &generating](const Square& to) {
+              YIELD(Move(sq, to, piece));
+            });
+        break;
+      case PieceType::kPawn:
+        GeneratePawnDestinations_(
+            sq, to_play_,
+            [&yield, &sq, &piece, &generating](const Square& to) {
+              if (IsPawnPromotionRank(to)) {
+                YIELD(Move(sq, to, piece, PieceType::kQueen));
+                YIELD(Move(sq, to, piece, PieceType::kRook));
+                YIELD(Move(sq, to, piece, PieceType::kBishop));
+                YIELD(Move(sq, to, piece, PieceType::kKnight));
+              } else {
+                YIELD(Move(sq, to, piece));
+              }
+            });
+        GeneratePawnCaptureDestinations_(
+            sq, to_play_, true, /* include enpassant */
+            [&yield, &sq, &piece, &generating](const Square& to) {
+              if (IsPawnPromotionRank(to)) {
+                YIELD(Move(sq, to, piece, PieceType::kQueen));
+                YIELD(Move(sq, to, piece, PieceType::kRook));
+                YIELD(Move(sq, to, piece, PieceType::kBishop));
+                YIELD(Move(sq, to, piece, PieceType::kKnight));
+              } else {
+                YIELD(Move(sq, to, piece));
+              }
+            });
+        break;
+      default:
+        SpielFatalError(absl::StrCat("Unknown piece type: ",
+                                     static_cast<int>(piece.type)));
+    }
+  }
+
+#undef YIELD
+}
+
+// King moves without castling.
+template <uint32_t kBoardSize>
+template <typename YieldFn>
+void ChessBoard<kBoardSize>::GenerateKingDestinations_(
+    Square sq, Color color, const YieldFn& yield) const {
+  GenerateBitboardDestinations_(
+      BitboardAttacks<kBoardSize>::Get().King(SquareToIndex_(sq)) &
+          ~ColorBitboard(color),
+      yield);
+}
+
+template <uint32_t kBoardSize>
+template <typename YieldFn>
+void ChessBoard<kBoardSize>::GenerateCastlingDestinations_(
+    Square sq, Color color, const YieldFn& yield) const {
+  // There are 8 conditions for castling -
+  // 1. The rook involved must not have moved.
+  // 2. The king must not have moved.
+  // 3. The rook involved must still be alive.
+  // 4. All squares king jumps over must be empty.
+  // 5. All squares the rook jumps over must be empty.
+  // 6. The squares the king jumps over must not be under attack.
+  // 7. The king must not be in check.
+  // (8). The square the king ends up in must not be under attack.
+  //
+  // We don't check for (8) here because this is not unique to castling, and
+  // we will check for it later.
+  //
+  // We use the generalized definition of castling from Chess960, instead of
+  // hard-coding starting squares.
+  // By Chess960 rules, the king and rook end up in the same positions as in
+  // standard chess, but they can start from any squares.
+  //
+  // Castling to one side doesn't necessarily mean the king will move towards
+  // that side.
+  // Eg.
+  // |RK...R..| + long castle (to the left) =>
+  // |..KR.R..|
+
+  // Whether all squares between sq1 and sq2 exclusive are empty, and
+  // optionally safe (not under attack).
+  const auto check_squares_between = [this, &color](const Square& sq1,
+                                                    const Square& sq2,
+                                                    bool check_safe) -> bool {
+    SPIEL_DCHECK_EQ(sq1.y, sq2.y);
+
+    if (sq1.x <= sq2.x) {
+      for (Square test_square = sq1 + Offset{1, 0}; test_square != sq2;
+           test_square += Offset{1, 0}) {
+        if (!IsEmpty(test_square) ||
+            (check_safe && UnderAttack(test_square, color))) {
+          return false;
+        }
+      }
+    } else {
+      for (Square test_square = sq1 + Offset{-1, 0}; test_square != sq2;
+           test_square += Offset{-1, 0}) {
+        if (!IsEmpty(test_square) ||
+            (check_safe && UnderAttack(test_square, color))) {
+          return false;
+        }
+      }
+    }
+
+    return true;
+  };
+
+  const auto check_castling_conditions =
+      [this, &sq, &color, &check_squares_between](int8_t direction) -> bool {
+    // First we need to find the rook.
+    Square rook_sq = sq + Offset{direction, 0};
+    bool rook_found = false;
+
+    // Yes, we do actually have to check colour -
+    // https://github.com/official-stockfish/Stockfish/issues/356
+    for (; InBoardArea(rook_sq); rook_sq.x += direction) {
+      if (at(rook_sq) == Piece{color, PieceType::kRook}) {
+        rook_found = true;
+        break;
+      }
+    }
+
+    if (!rook_found) {
+      std::cerr << "Where did our rook go?" << *this << "\n"
+                << "Square: " << SquareToString(sq) << std::endl;
+      SpielFatalError("Rook not found");
+    }
+
+    static_assert(kBoardSize == 8,
+                  "This is not boardsize-independent! What does castling "
+                  "mean for other boardsizes?");
+    int8_t rook_final_x = direction == -1 ? 3 /* d-file */ : 5 /* f-file */;
+    Square rook_final_sq = Square{rook_final_x, sq.y};
+    int8_t king_final_x = direction == -1 ? 2 /* c-file */ : 6 /* g-file */;
+    Square king_final_sq = Square{king_final_x, sq.y};
+
+    // 4. 5. 6. All squares the king and rook jump over, including the final
+    // squares, must be empty. Squares king jumps over must additionally be
+    // safe.
+    if (!IsEmpty(rook_final_sq) || !IsEmpty(king_final_sq) ||
+        !check_squares_between(rook_sq, rook_final_sq, false) ||
+        !check_squares_between(sq, king_final_sq, true)) {
+      return false;
+    }
+
+    return true;
+  };
+
+  // 1. 2. 3. Moving the king, moving the rook, or the rook getting captured
+  // will reset the flag.
+  bool can_left_castle = CastlingRight(color, CastlingDirection::kLeft) &&
+                         check_castling_conditions(-1);
+  bool can_right_castle = CastlingRight(color, CastlingDirection::kRight) &&
+                          check_castling_conditions(1);
+
+  if (can_left_castle || can_right_castle) {
+    // 7. No castling to escape from check.
+    if (UnderAttack(sq, color)) {
+      return;
+    }
+
+    static_assert(kBoardSize == 8,
+                  "This is not boardsize-independent! What does castling "
+                  "mean for other boardsizes?");
+    if (can_left_castle) {
+      yield(Square{static_cast<int8_t>(2), sq.y});
+    }
+
+    if (can_right_castle) {
+      yield(Square{static_cast<int8_t>(6), sq.y});
+    }
+  }
+}
+
+template <uint32_t kBoardSize>
+template <typename YieldFn>
+void ChessBoard<kBoardSize>::GenerateQueenDestinations_(
+    Square sq, Color color, const YieldFn& yield) const {
+  GenerateBitboardDestinations_(
+      BitboardAttacks<kBoardSize>::Get().Queen(SquareToIndex_(sq),
+                                               OccupiedBitboard_()) &
+          ~ColorBitboard(color),
+      yield);
+}
+
+template <uint32_t kBoardSize>
+template <typename YieldFn>
+void ChessBoard<kBoardSize>::GenerateRookDestinations_(
+    Square sq, Color color, const YieldFn& yield) const {
+  GenerateBitboardDestinations_(
+      BitboardAttacks<kBoardSize>::Get().Rook(SquareToIndex_(sq),
+                                              OccupiedBitboard_()) &
+          ~ColorBitboard(color),
+      yield);
+}
+
+template <uint32_t kBoardSize>
+template <typename YieldFn>
+void ChessBoard<kBoardSize>::GenerateBishopDestinations_(
+    Square sq, Color color, const YieldFn& yield) const {
+  GenerateBitboardDestinations_(
+      BitboardAttacks<kBoardSize>::Get().Bishop(SquareToIndex_(sq),
+                                                OccupiedBitboard_()) &
+          ~ColorBitboard(color),
+      yield);
+}
+
+template <uint32_t kBoardSize>
+template <typename YieldFn>
+void ChessBoard<kBoardSize>::GenerateKnightDestinations_(
+    Square sq, Color color, const YieldFn& yield) const {
+  GenerateBitboardDestinations_(
+      BitboardAttacks<kBoardSize>::Get().Knight(SquareToIndex_(sq)) &
+          ~ColorBitboard(color),
+      yield);
+}
+
+// Pawn moves without captures.
+template <uint32_t kBoardSize>
+template <typename YieldFn>
+void ChessBoard<kBoardSize>::GeneratePawnDestinations_(
+    Square sq, Color color, const YieldFn& yield) const {
+  int8_t y_direction = color == Color::kWhite ? 1 : -1;
+  Square dest = sq + Offset{0, y_direction};
+  if (InBoardArea(dest) && IsEmpty(dest)) {
+    yield(dest);
+
+    // Test for double move.
+    if (IsPawnStartingRank(sq, color)) {
+      dest = sq + Offset{0, static_cast<int8_t>(2 * y_direction)};
+      if (IsEmpty(dest)) {
+        yield(dest);
+      }
+    }
+  }
+}
+
+// Pawn capture destinations, with or without en passant.
+template <uint32_t kBoardSize>
+template <typename YieldFn>
+void ChessBoard<kBoardSize>::GeneratePawnCaptureDestinations_(
+    Square sq, Color color, bool include_ep, const YieldFn& yield) const {
+  int8_t y_direction = color == Color::kWhite ? 1 : -1;
+  Square dest = sq + Offset{1, y_direction};
+  if (InBoardArea(dest) &&
+      (IsEnemy(dest, color) || (include_ep && dest == EpSquare()))) {
+    yield(dest);
+  }
+
+  dest = sq + Offset{-1, y_direction};
+  if (InBoardArea(dest) &&
+      (IsEnemy(dest, color) || (include_ep && dest == EpSquare()))) {
+    yield(dest);
+  }
+}
+
+template <uint32_t kBoardSize>
+template <typename YieldFn>
+void ChessBoard<kBoardSize>::GenerateBitboardDestinations_(
+    Bitboard destinations, const YieldFn& yield) const {
+  ForEachSquareIndex(destinations,
+                     [&yield](int index) { yield(IndexToSquare_(index)); });
+}
+
 template <uint32_t kBoardSize>
 inline std::ostream& operator<<(std::ostream& stream,
                                 const ChessBoard<kBoardSize>& board) {
@@ -458,6 +843,10 @@ inline std::ostream& operator<<(std::ostream& stream, const PieceType& pt) {
 
 StandardChessBoard MakeDefaultBoard();
 
+// The number of sequences of depth legal moves from the board (the leaves of
+// its move tree of that depth), for testing and benchmarking move generation.
+int64_t Perft(const StandardChessBoard& board, int depth);
+
 }  // namespace chess
 }  // namespace open_spiel
 
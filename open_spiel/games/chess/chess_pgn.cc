@@ -0,0 +1,370 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/games/chess/chess_pgn.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/strings/ascii.h"
+#include "open_spiel/abseil-cpp/absl/strings/match.h"
+#include "open_spiel/abseil-cpp/absl/types/span.h"
+#include "open_spiel/games/chess/chess_board.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/thread.h"
+
+namespace open_spiel {
+namespace chess {
+namespace {
+
+// The characters which end a token of the movetext besides spaces.
+constexpr absl::string_view kDelimiters = "{}();";
+
+bool IsFile(char c) { return c >= 'a' && c <= 'h'; }
+bool IsRank(char c) { return c >= '1' && c <= '8'; }
+
+// Returns the position of the end of the line starting at or before i.
+size_t EndOfLine(absl::string_view text, size_t i) {
+  const size_t end = text.find('\n', i);
+  return end == absl::string_view::npos ? text.size() : end;
+}
+
+// Whether ChessBoard::ParseSANMove can parse the move, which it checks fails
+// on rather than returning nullopt for some malformed moves.
+bool IsSANShaped(absl::string_view move) {
+  while (!move.empty() && (move.back() == '!' || move.back() == '?')) {
+    move.remove_suffix(1);
+  }
+  if (!move.empty() && (move.back() == '+' || move.back() == '#')) {
+    move.remove_suffix(1);
+  }
+  if (move == "O-O" || move == "O-O-O") return true;
+  if (move.size() >= 2 && move[move.size() - 2] == '=') {
+    if (!absl::StrContains("NBRQ", move.back())) return false;
+    move.remove_suffix(2);
+  }
+  if (!move.empty() && absl::StrContains("NBRQK", move.front())) {
+    move.remove_prefix(1);
+  }
+  if (move.size() < 2 || !IsFile(move[move.size() - 2]) ||
+      !IsRank(move.back())) {
+    return false;
+  }
+  move.remove_suffix(2);
+  // The disambiguation of the source square, and the capture.
+  if (!move.empty() && IsFile(move.front())) move.remove_prefix(1);
+  if (!move.empty() && IsRank(move.front())) move.remove_prefix(1);
+  if (!move.empty() && move.front() == 'x') move.remove_prefix(1);
+  return move.empty();
+}
+
+// Parses a tag pair, e.g. [Result "1-0"], with \" and \\ escaped in the
+// value.
+bool ParseTag(absl::string_view line, std::string* name, std::string* value) {
+  line = absl::StripAsciiWhitespace(line);
+  if (line.size() < 2 || line.front() != '[' || line.back() != ']') {
+    return false;
+  }
+  line = absl::StripAsciiWhitespace(line.substr(1, line.size() - 2));
+  const size_t space = line.find_first_of(" \t");
+  if (space == absl::string_view::npos) return false;
+  *name = std::string(line.substr(0, space));
+  line = absl::StripLeadingAsciiWhitespace(line.substr(space));
+  if (line.size() < 2 || line.front() != '"' || line.back() != '"') {
+    return false;
+  }
+  value->clear();
+  for (size_t i = 1; i + 1 < line.size(); ++i) {
+    if (line[i] == '\\' && i + 2 < line.size()) ++i;
+    value->push_back(line[i]);
+  }
+  return true;
+}
+
+// The returns of a result, with Black as player 0.
+std::optional<std::vector<double>> ResultReturns(absl::string_view result) {
+  if (result == "1-0") return std::vector<double>{-1, 1};
+  if (result == "0-1") return std::vector<double>{1, -1};
+  if (result == "1/2-1/2") return std::vector<double>{0, 0};
+  return std::nullopt;
+}
+
+bool IsResult(absl::string_view token) {
+  return token == "*" || ResultReturns(token).has_value();
+}
+
+// Splits the tags and moves of a game, ignoring comments, variations,
+// annotations and move numbers. Returns false if they are malformed.
+bool SplitGame(absl::string_view text, std::vector<std::string>* moves,
+               std::string* result, std::string* fen, std::string* variant) {
+  bool line_start = true;
+  int variation_depth = 0;
+  size_t i = 0;
+  while (i < text.size()) {
+    const char c = text[i];
+    if (line_start && (c == '[' || c == '%')) {
+      // A tag pair, or an escaped line.
+      const size_t end = EndOfLine(text, i);
+      if (c == '[') {
+        std::string name, value;
+        if (!ParseTag(text.substr(i, end - i), &name, &value)) return false;
+        if (name == "Result") *result = value;
+        if (name == "FEN") *fen = value;
+        if (name == "Variant") *variant = value;
+      }
+      i = end;
+      continue;
+    }
+    line_start = c == '\n';
+    if (absl::ascii_isspace(c)) {
+      ++i;
+    } else if (c == '{') {
+      const size_t end = text.find('}', i);
+      if (end == absl::string_view::npos) return false;
+      i = end + 1;
+    } else if (c == ';') {
+      i = EndOfLine(text, i);
+    } else if (c == '(') {
+      ++variation_depth;
+      ++i;
+    } else if (c == ')') {
+      if (variation_depth-- == 0) return false;
+      ++i;
+    } else if (c == '}') {
+      return false;
+    } else {
+      size_t end = i;
+      while (end < text.size() && !absl::ascii_isspace(text[end]) &&
+             !absl::StrContains(kDelimiters, text[end])) {
+        ++end;
+      }
+      absl::string_view token = text.substr(i, end - i);
+      i = end;
+      if (variation_depth > 0 || token.front() == '$') continue;
+      if (IsResult(token)) {
+        if (result->empty()) *result = std::string(token);
+        continue;
+      }
+      std::string move(token);
+      // Move numbers, e.g. "12." or "12...", may be followed by the move
+      // without a space.
+      size_t digits = 0;
+      while (digits < move.size() && absl::ascii_isdigit(move[digits])) {
+        ++digits;
+      }
+      if (digits < move.size() && move[digits] == '.') {
+        move.erase(0, move.find_first_not_of('.', digits));
+        if (move.find_first_not_of('.') == std::string::npos) continue;
+      }
+      // Castling is sometimes written with zeros.
+      if (absl::StartsWith(move, "0-0")) {
+        for (int j = 0; j < move.size() && (move[j] == '0' || move[j] == '-');
+             ++j) {
+          if (move[j] == '0') move[j] = 'O';
+        }
+      }
+      moves->push_back(std::move(move));
+    }
+  }
+  return variation_depth == 0;
+}
+
+// Calls fn(begin, end) on num_threads blocks covering [0, size).
+void ForEachBlock(int size, int num_threads,
+                  const std::function<void(int64_t, int64_t)>& fn) {
+  if (num_threads <= 1 || size <= 1) {
+    fn(0, size);
+  } else {
+    ThreadPool::Default()->ParallelFor(
+        0, size, (size + num_threads - 1) / num_threads, fn);
+  }
+}
+
+std::unique_ptr<State> InitialState(const ChessGame& game,
+                                    const std::string& fen) {
+  return fen.empty() ? game.NewInitialState() : game.NewInitialState(fen);
+}
+
+// Replays the game into row b of the batch.
+void WriteRow(const ChessGame& game, const PgnGame& pgn, int b,
+              algorithms::ColumnarTrajectory* batch) {
+  std::unique_ptr<State> state = InitialState(game, pgn.fen);
+  const int length = std::min<int>(pgn.actions.size(), batch->max_length);
+  for (int t = 0; t < length; ++t) {
+    const Player player = state->CurrentPlayer();
+    const int step = b * batch->max_length + t;
+    // The observation of a chess state is the same for both players, so each
+    // but the first is that of the previous step, updated with the move.
+    absl::Span<float> observation = batch->Observation(b, t);
+    if (t > 0) {
+      absl::Span<const float> previous = batch->Observation(b, t - 1);
+      std::copy(previous.begin(), previous.end(), observation.begin());
+    }
+    if (t == 0 || !state->UpdateObservationTensor(player, observation)) {
+      state->ObservationTensor(player, observation);
+    }
+    absl::Span<float> legal_actions = batch->LegalActions(b, t);
+    std::fill(legal_actions.begin(), legal_actions.end(), 0);
+    for (Action legal_action : state->LegalActions()) {
+      legal_actions[legal_action] = 1;
+    }
+    const Action action = pgn.actions[t];
+    absl::Span<float> policy = batch->PlayerPolicy(b, t);
+    std::fill(policy.begin(), policy.end(), 0);
+    policy[action] = 1;
+    batch->player_ids[step] = player;
+    batch->actions[step] = action;
+    batch->valid[step] = 1;
+    state->ApplyAction(action);
+  }
+  batch->lengths[b] = length;
+  if (length == pgn.actions.size()) {
+    batch->next_is_terminal[b * batch->max_length + length - 1] = 1;
+  }
+  std::copy(pgn.returns.begin(), pgn.returns.end(),
+            batch->rewards.begin() + b * batch->num_players);
+}
+
+}  // namespace
+
+PgnGame ParsePgnGame(const ChessGame& game, absl::string_view text) {
+  PgnGame pgn;
+  std::vector<std::string> moves;
+  std::string result, variant;
+  if (!SplitGame(text, &moves, &result, &pgn.fen, &variant)) return pgn;
+  if (!variant.empty() && absl::AsciiStrToLower(variant) != "standard") {
+    return pgn;
+  }
+  if (result.empty() || result == "*") {
+    pgn.status = PgnGameStatus::kUnfinished;
+    return pgn;
+  }
+  std::optional<std::vector<double>> returns = ResultReturns(result);
+  if (!returns) return pgn;
+  if (!pgn.fen.empty() && !StandardChessBoard::BoardFromFEN(pgn.fen)) {
+    return pgn;
+  }
+
+  std::unique_ptr<State> state = InitialState(game, pgn.fen);
+  const ChessState& chess_state = static_cast<const ChessState&>(*state);
+  for (const std::string& move : moves) {
+    if (state->IsTerminal()) break;
+    if (!IsSANShaped(move)) return pgn;
+    std::optional<Move> parsed = chess_state.Board().ParseSANMove(move);
+    if (!parsed) return pgn;
+    const Action action = MoveToAction(*parsed);
+    state->ApplyAction(action);
+    pgn.actions.push_back(action);
+  }
+  if (pgn.actions.empty()) return pgn;
+  pgn.returns = *std::move(returns);
+  pgn.status = PgnGameStatus::kValid;
+  return pgn;
+}
+
+PgnReader::PgnReader(const std::string& filename, int num_threads)
+    : game_(std::static_pointer_cast<const ChessGame>(LoadGame("chess"))),
+      file_(filename, {file::MMapFile::Access::kSequential}),
+      remaining_(file_.Contents()),
+      num_threads_(num_threads) {
+  remaining_ = absl::StripLeadingAsciiWhitespace(remaining_);
+}
+
+absl::string_view PgnReader::NextGameText() {
+  // A game ends where the tags of the next one start, i.e. at the first line
+  // starting with '[' after its moves, outside of comments.
+  bool line_start = true;
+  bool in_movetext = false;
+  size_t i = 0;
+  while (i < remaining_.size()) {
+    const char c = remaining_[i];
+    if (line_start && (c == '[' || c == '%')) {
+      if (c == '[' && in_movetext) break;
+      i = EndOfLine(remaining_, i);
+      continue;
+    }
+    line_start = c == '\n';
+    if (c == '{') {
+      const size_t end = remaining_.find('}', i);
+      i = end == absl::string_view::npos ? remaining_.size() : end + 1;
+      continue;
+    }
+    if (c == ';') {
+      i = EndOfLine(remaining_, i);
+      continue;
+    }
+    if (!absl::ascii_isspace(c)) in_movetext = true;
+    ++i;
+  }
+  absl::string_view text = remaining_.substr(0, i);
+  remaining_ = absl::StripLeadingAsciiWhitespace(remaining_.substr(i));
+  return text;
+}
+
+algorithms::ColumnarTrajectory PgnReader::NextBatch(int batch_size,
+                                                    int max_length) {
+  SPIEL_CHECK_GT(batch_size, 0);
+  std::vector<PgnGame> games;
+  while (games.size() < batch_size && !Done()) {
+    // The games are split serially, which is a single pass over the text, and
+    // parsed in parallel.
+    std::vector<absl::string_view> texts;
+    while (texts.size() + games.size() < batch_size && !Done()) {
+      texts.push_back(NextGameText());
+    }
+    std::vector<PgnGame> parsed(texts.size());
+    ForEachBlock(texts.size(), num_threads_, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; ++i) {
+        parsed[i] = ParsePgnGame(*game_, texts[i]);
+      }
+    });
+    for (PgnGame& pgn : parsed) {
+      ++stats_.games;
+      if (pgn.status == PgnGameStatus::kUnfinished) {
+        ++stats_.unfinished_games;
+      } else if (pgn.status == PgnGameStatus::kInvalid) {
+        ++stats_.invalid_games;
+      } else {
+        games.push_back(std::move(pgn));
+      }
+    }
+  }
+
+  int length = max_length;
+  if (length <= 0) {
+    length = 0;
+    for (const PgnGame& pgn : games) {
+      length = std::max<int>(length, pgn.actions.size());
+    }
+  }
+  algorithms::ColumnarTrajectory batch(games.size(), length,
+                           game_->ObservationTensorSize(),
+                           game_->NumDistinctActions(), game_->NumPlayers());
+  ForEachBlock(games.size(), num_threads_, [&](int64_t begin, int64_t end) {
+    for (int64_t b = begin; b < end; ++b) {
+      WriteRow(*game_, games[b], b, &batch);
+    }
+  });
+  for (int b = 0; b < batch.batch_size; ++b) stats_.steps += batch.lengths[b];
+  return batch;
+}
+
+}  // namespace chess
+}  // namespace open_spiel
@@ -0,0 +1,110 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_GAMES_CHESS_CHESS_PGN_H_
+#define OPEN_SPIEL_GAMES_CHESS_CHESS_PGN_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/strings/string_view.h"
+#include "open_spiel/algorithms/trajectories.h"
+#include "open_spiel/games/chess.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/utils/file.h"
+
+// Reads chess games in Portable Game Notation into training data: the games
+// of an archive, streamed from a file mapped into memory, are parsed and
+// replayed on several threads, and written a batch at a time into a
+// ColumnarTrajectory (see algorithms/trajectories.h), with a row per game.
+// https://en.wikipedia.org/wiki/Portable_Game_Notation
+//
+// At each step of a game, the observation is the ObservationTensor of the
+// player to move, the policy is one-hot on the move played, and the rewards
+// are those of the result of the game as recorded, e.g. {-1, 1} for 1-0, as
+// Black is player 0. Comments, variations and annotations are ignored, and
+// games starting from a position are read from their FEN tag.
+namespace open_spiel {
+namespace chess {
+
+enum class PgnGameStatus {
+  kValid,
+  // The result is "*", or missing, so the game has no rewards.
+  kUnfinished,
+  // A tag or move could not be parsed, a move is illegal, or there are no
+  // moves.
+  kInvalid,
+};
+
+struct PgnGame {
+  PgnGameStatus status = PgnGameStatus::kInvalid;
+  // The position the game starts from, empty for the standard one.
+  std::string fen;
+  // The actions of the moves, up to the end of the game under the rules of
+  // ChessGame, which draws by repetition or the 50 moves rule without a
+  // claim, so the moves of a game continued after those are dropped.
+  std::vector<Action> actions;
+  // The returns of the recorded result.
+  std::vector<double> returns;
+};
+
+// Parses the text of a single game, tags and movetext.
+PgnGame ParsePgnGame(const ChessGame& game, absl::string_view text);
+
+struct PgnReaderStats {
+  int64_t games = 0;
+  int64_t unfinished_games = 0;
+  int64_t invalid_games = 0;
+  // The steps written, over all the batches.
+  int64_t steps = 0;
+};
+
+class PgnReader {
+ public:
+  // The games are parsed and replayed in num_threads blocks on the shared
+  // ThreadPool.
+  explicit PgnReader(const std::string& filename, int num_threads = 1);
+
+  PgnReader(const PgnReader&) = delete;
+  PgnReader& operator=(const PgnReader&) = delete;
+
+  // Whether every game of the file has been read.
+  bool Done() const { return remaining_.empty(); }
+
+  // Returns the next batch_size valid games, or fewer at the end of the file
+  // (down to none, with a batch size of 0), skipping the others. T is the
+  // length of the longest game, or max_length if it is positive, in which
+  // case the longer games are cut to their first max_length moves, and have
+  // no step with next_is_terminal.
+  algorithms::ColumnarTrajectory NextBatch(int batch_size, int max_length = -1);
+
+  const PgnReaderStats& Stats() const { return stats_; }
+
+ private:
+  // Returns the text of the next game, and an empty one at the end.
+  absl::string_view NextGameText();
+
+  std::shared_ptr<const ChessGame> game_;
+  file::MMapFile file_;
+  absl::string_view remaining_;
+  int num_threads_;
+  PgnReaderStats stats_;
+};
+
+}  // namespace chess
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_GAMES_CHESS_CHESS_PGN_H_
@@ -0,0 +1,164 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/games/chess/chess_pgn.h"
+
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/abseil-cpp/absl/types/span.h"
+#include "open_spiel/algorithms/trajectories.h"
+#include "open_spiel/games/chess.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/file.h"
+
+namespace open_spiel {
+namespace chess {
+namespace {
+
+// Scholar's mate, with comments, a variation and annotations.
+constexpr char kScholarsMate[] = R"([Event "Test"]
+[White "A"]
+[Black "B"]
+[Result "1-0"]
+
+1. e4 e5 2. Bc4 {The bishop eyes f7.} Nc6 (2... Nf6 3. d3) 3. Qh5 Nf6?? $4
+; Defends nothing.
+4. Qxf7# 1-0
+)";
+
+constexpr char kPgn[] = R"([Event "Mate"]
+[Result "1-0"]
+
+1. e4 e5 2. Bc4 {The bishop eyes f7.} Nc6 (2... Nf6 3. d3) 3. Qh5 Nf6?? $4
+; Defends nothing.
+4. Qxf7# 1-0
+
+[Event "Castling"]
+[Result "1/2-1/2"]
+
+1.e4 e5 2.Nf3 Nc6 3.Bc4 Bc5 4.0-0 Nf6 5.d3 O-O 1/2-1/2
+
+[Event "Unfinished"]
+[Result "*"]
+
+1. d4 d5 *
+
+[Event "Illegal"]
+[Result "0-1"]
+
+1. e5 e6 0-1
+
+[Event "Endgame"]
+[FEN "4k3/8/8/8/8/8/4P3/4K3 w - - 0 1"]
+[SetUp "1"]
+[Result "0-1"]
+
+1. e4 Kd7 2. e5 Ke6 0-1
+)";
+
+void ParsePgnGameTest() {
+  std::shared_ptr<const ChessGame> game =
+      std::static_pointer_cast<const ChessGame>(LoadGame("chess"));
+  PgnGame pgn = ParsePgnGame(*game, kScholarsMate);
+  SPIEL_CHECK_TRUE(pgn.status == PgnGameStatus::kValid);
+  SPIEL_CHECK_EQ(pgn.actions.size(), 7);
+  SPIEL_CHECK_TRUE(pgn.returns == std::vector<double>({-1, 1}));
+  std::unique_ptr<State> state = game->NewInitialState();
+  for (Action action : pgn.actions) state->ApplyAction(action);
+  SPIEL_CHECK_TRUE(state->IsTerminal());
+  SPIEL_CHECK_EQ(state->Returns(), pgn.returns);
+
+  SPIEL_CHECK_TRUE(ParsePgnGame(*game, "1. e4 *").status ==
+                   PgnGameStatus::kUnfinished);
+  SPIEL_CHECK_TRUE(ParsePgnGame(*game, "1. e4").status ==
+                   PgnGameStatus::kUnfinished);
+  for (const char* text : {"1. e5 1-0", "1. Nf3 Ng6 0-1", "1. e4 {e5 1-0",
+                           "1. e4 (1. d4 1-0", "1. e4 e5 2. Qxx 1-0",
+                           "[Variant \"Chess960\"]\n1. e4 1-0", "1-0"}) {
+    SPIEL_CHECK_TRUE(ParsePgnGame(*game, text).status ==
+                     PgnGameStatus::kInvalid);
+  }
+}
+
+void PgnReaderTest() {
+  const std::string filename =
+      absl::StrCat(file::GetTmpDir(), "/open_spiel-test-",
+                   std::rand(), "-games.pgn");  // NOLINT
+  file::File(filename, "w").Write(kPgn);
+  std::shared_ptr<const Game> game = LoadGame("chess");
+
+  for (int num_threads : {1, 2}) {
+    PgnReader reader(filename, num_threads);
+    algorithms::ColumnarTrajectory batch = reader.NextBatch(2);
+    SPIEL_CHECK_EQ(batch.batch_size, 2);
+    SPIEL_CHECK_EQ(batch.max_length, 10);
+    SPIEL_CHECK_EQ(batch.lengths[0], 7);
+    SPIEL_CHECK_EQ(batch.lengths[1], 10);
+    SPIEL_CHECK_EQ(batch.rewards, std::vector<float>({-1, 1, 0, 0}));
+    SPIEL_CHECK_EQ(batch.next_is_terminal[6], 1);
+    SPIEL_CHECK_EQ(batch.valid[7], 0);
+
+    // Each step holds the observation of the state, with the move played as
+    // the policy.
+    std::unique_ptr<State> state = game->NewInitialState();
+    for (int t = 0; t < batch.lengths[1]; ++t) {
+      const int step = batch.max_length + t;
+      SPIEL_CHECK_EQ(batch.player_ids[step], state->CurrentPlayer());
+      SPIEL_CHECK_EQ(batch.valid[step], 1);
+      std::vector<float> observation(game->ObservationTensorSize());
+      state->ObservationTensor(state->CurrentPlayer(),
+                               absl::MakeSpan(observation));
+      absl::Span<float> recorded = batch.Observation(1, t);
+      SPIEL_CHECK_TRUE(std::vector<float>(recorded.begin(), recorded.end()) ==
+                       observation);
+      const Action action = batch.actions[step];
+      SPIEL_CHECK_EQ(batch.PlayerPolicy(1, t)[action], 1);
+      for (Action legal_action : state->LegalActions()) {
+        SPIEL_CHECK_EQ(batch.LegalActions(1, t)[legal_action], 1);
+      }
+      state->ApplyAction(action);
+    }
+    SPIEL_CHECK_FALSE(reader.Done());
+
+    // The unfinished and illegal games are skipped.
+    batch = reader.NextBatch(2, /*max_length=*/3);
+    SPIEL_CHECK_TRUE(reader.Done());
+    SPIEL_CHECK_EQ(batch.batch_size, 1);
+    SPIEL_CHECK_EQ(batch.lengths[0], 3);
+    SPIEL_CHECK_EQ(batch.next_is_terminal[2], 0);
+    SPIEL_CHECK_EQ(batch.rewards, std::vector<float>({1, -1}));
+    SPIEL_CHECK_EQ(reader.NextBatch(2).batch_size, 0);
+
+    const PgnReaderStats& stats = reader.Stats();
+    SPIEL_CHECK_EQ(stats.games, 5);
+    SPIEL_CHECK_EQ(stats.unfinished_games, 1);
+    SPIEL_CHECK_EQ(stats.invalid_games, 1);
+    SPIEL_CHECK_EQ(stats.steps, 20);
+  }
+  SPIEL_CHECK_TRUE(file::Remove(filename));
+}
+
+}  // namespace
+}  // namespace chess
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  open_spiel::chess::ParsePgnGameTest();
+  open_spiel::chess::PgnReaderTest();
+}
@@ -14,7 +14,9 @@
 
 #include "open_spiel/games/chess.h"
 
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 
 #include "open_spiel/games/chess/chess_board.h"
@@ -68,6 +70,33 @@ void MoveGenerationTests() {
   SPIEL_CHECK_EQ(CountNumLegalMoves(start_pos), 20);
 }
 
+void CheckPerft(const std::string& fen, int depth, int64_t num_leaves) {
+  std::optional<StandardChessBoard> board =
+      StandardChessBoard::BoardFromFEN(fen);
+  SPIEL_CHECK_TRUE(board);
+  SPIEL_CHECK_EQ(Perft(*board, depth), num_leaves);
+}
+
+// Counts from https://www.chessprogramming.org/Perft_Results, covering
+// castling, en passant, promotions, pins and checks.
+void PerftTests() {
+  CheckPerft("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 3,
+             8902);
+  CheckPerft(
+      "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+      2, 2039);
+  CheckPerft("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 4, 43238);
+  CheckPerft(
+      "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 3,
+      9467);
+  CheckPerft("rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 2,
+             1486);
+  CheckPerft(
+      "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 "
+      "10",
+      2, 2079);
+}
+
 void TerminalReturnTests() {
   std::shared_ptr<const Game> game = LoadGame("chess");
   ChessState checkmate_state(
@@ -98,6 +127,31 @@ void TerminalReturnTests() {
   ApplySANMove("Rh2", &repetition_state);
   SPIEL_CHECK_EQ(repetition_state.IsTerminal(), true);
   SPIEL_CHECK_EQ(repetition_state.Returns(), (std::vector<double>{0.0, 0.0}));
+
+  // Undoing the last move, or cloning, keeps the earlier repetitions.
+  std::unique_ptr<State> clone = repetition_state.Clone();
+  SPIEL_CHECK_EQ(clone->IsTerminal(), true);
+  Action last_move = repetition_state.History().back();
+  repetition_state.UndoAction(0, last_move);
+  SPIEL_CHECK_EQ(repetition_state.IsTerminal(), false);
+  repetition_state.ApplyAction(last_move);
+  SPIEL_CHECK_EQ(repetition_state.IsTerminal(), true);
+
+  // Repetitions are counted from the last pawn move or capture.
+  ChessState pawn_state(game, "8/8/5k2/8/8/8/P6r/2K5 w - - 50 1");
+  ApplySANMove("Kd1", &pawn_state);
+  ApplySANMove("Rh3", &pawn_state);
+  ApplySANMove("Kc1", &pawn_state);
+  ApplySANMove("Rh2", &pawn_state);
+  ApplySANMove("a3", &pawn_state);
+  for (int i = 0; i < 2; ++i) {
+    SPIEL_CHECK_EQ(pawn_state.IsTerminal(), false);
+    ApplySANMove("Rh3", &pawn_state);
+    ApplySANMove("Kd1", &pawn_state);
+    ApplySANMove("Rh2", &pawn_state);
+    ApplySANMove("Kc1", &pawn_state);
+  }
+  SPIEL_CHECK_EQ(pawn_state.IsTerminal(), true);
 }
 
 void UndoTests() {
@@ -241,6 +295,35 @@ void MoveConversionTests() {
   }
 }
 
+// The bitboards kept by the board agree with its pieces along random games.
+void BitboardTests() {
+  std::mt19937 rng(7);
+  for (int i = 0; i < 20; ++i) {
+    StandardChessBoard board = MakeDefaultBoard();
+    while (board.HasLegalMoves() && board.IrreversibleMoveCounter() < 100) {
+      for (int8_t y = 0; y < board.BoardSize(); ++y) {
+        for (int8_t x = 0; x < board.BoardSize(); ++x) {
+          const Bitboard bit = Bitboard{1} << (y * board.BoardSize() + x);
+          const Piece& piece = board.at(Square{x, y});
+          SPIEL_CHECK_TRUE(board.ColorBitboard(piece.color) & bit);
+          SPIEL_CHECK_TRUE(board.PieceTypeBitboard(piece.type) & bit);
+        }
+      }
+      SPIEL_CHECK_EQ(NumSquares(board.ColorBitboard(Color::kWhite) |
+                                board.ColorBitboard(Color::kBlack) |
+                                board.ColorBitboard(Color::kEmpty)),
+                     64);
+      std::vector<Move> moves;
+      board.GenerateLegalMoves([&moves](const Move& move) {
+        moves.push_back(move);
+        return true;
+      });
+      board.ApplyMove(moves[absl::uniform_int_distribution<int>(
+          0, moves.size() - 1)(rng)]);
+    }
+  }
+}
+
 }  // namespace
 }  // namespace chess
 }  // namespace open_spiel
@@ -248,6 +331,8 @@ void MoveConversionTests() {
 int main(int argc, char** argv) {
   open_spiel::chess::BasicChessTests();
   open_spiel::chess::MoveGenerationTests();
+  open_spiel::chess::PerftTests();
+  open_spiel::chess::BitboardTests();
   open_spiel::chess::UndoTests();
   open_spiel::chess::TerminalReturnTests();
   open_spiel::chess::ObservationTensorTests();
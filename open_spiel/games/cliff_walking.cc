@@ -15,11 +15,18 @@
 #include "open_spiel/games/cliff_walking.h"
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <random>
 #include <utility>
+#include <vector>
 
+#include "open_spiel/abseil-cpp/absl/types/span.h"
 #include "open_spiel/game_parameters.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
+#include "open_spiel/vector_state.h"
 
 namespace open_spiel {
 namespace cliff_walking {
@@ -52,6 +59,82 @@ std::shared_ptr<const Game> Factory(const GameParameters& params) {
 
 REGISTER_SPIEL_GAME(kGameType, Factory);
 
+// Moves of each action, indexed by CliffWalkingAction.
+constexpr std::array<int, kNumActions> kRowOffsets = {0, -1, 0, 1};
+constexpr std::array<int, kNumActions> kColOffsets = {1, 0, -1, 0};
+
+// CliffWalking for VectorState: the position and time of every slot.
+class CliffWalkingKernel : public BatchedKernel {
+ public:
+  CliffWalkingKernel(const CliffWalkingGame& game, int num_states)
+      : height_(game.Height()),
+        width_(game.Width()),
+        horizon_(game.MaxGameLength()),
+        player_row_(num_states),
+        player_col_(num_states),
+        time_counter_(num_states) {}
+
+  void Reset(int begin, int end, absl::Span<std::mt19937> rngs) override {
+    std::fill(player_row_.begin() + begin, player_row_.begin() + end,
+              height_ - 1);
+    std::fill(player_col_.begin() + begin, player_col_.begin() + end, 0);
+    std::fill(time_counter_.begin() + begin, time_counter_.begin() + end, 0);
+  }
+
+  void Step(int begin, int end, absl::Span<const Action> actions,
+            absl::Span<std::mt19937> rngs, absl::Span<float> rewards,
+            absl::Span<float> dones) override {
+    for (int i = begin; i < end; ++i) {
+      const int row = std::clamp(player_row_[i] + kRowOffsets[actions[i]], 0,
+                                 height_ - 1);
+      const int col = std::clamp(player_col_[i] + kColOffsets[actions[i]], 0,
+                                 width_ - 1);
+      const int time = time_counter_[i] + 1;
+      // The cliff is the bottom row between the start and the goal.
+      const bool bottom = row == height_ - 1;
+      const bool cliff = bottom && col > 0 && col < width_ - 1;
+      const bool goal = bottom && col == width_ - 1;
+      const bool done = time >= horizon_ || cliff || goal;
+      rewards[i] = cliff ? -100 : -1;
+      dones[i] = done;
+      player_row_[i] = done ? height_ - 1 : row;
+      player_col_[i] = done ? 0 : col;
+      time_counter_[i] = done ? 0 : time;
+    }
+  }
+
+  void ObservationTensors(int begin, int end,
+                          absl::Span<float> values) const override {
+    const int size = height_ * width_;
+    std::fill(values.begin() + begin * size, values.begin() + end * size, 0);
+    for (int i = begin; i < end; ++i) {
+      values[i * size + player_row_[i] * width_ + player_col_[i]] = 1;
+    }
+  }
+
+  void LegalActionsMasks(int begin, int end,
+                         absl::Span<uint8_t> values) const override {
+    std::fill(values.begin() + begin * kNumActions,
+              values.begin() + end * kNumActions, 1);
+  }
+
+ private:
+  const int height_;
+  const int width_;
+  const int horizon_;
+  std::vector<int> player_row_;
+  std::vector<int> player_col_;
+  std::vector<int> time_counter_;
+};
+
+std::unique_ptr<BatchedKernel> KernelFactory(const Game& game,
+                                             int num_states) {
+  return std::make_unique<CliffWalkingKernel>(
+      static_cast<const CliffWalkingGame&>(game), num_states);
+}
+
+REGISTER_BATCHED_KERNEL("cliff_walking", KernelFactory);
+
 }  // namespace
 
 CliffWalkingState::CliffWalkingState(std::shared_ptr<const Game> game)
@@ -177,7 +260,7 @@ void CliffWalkingState::UndoAction(Player player, Action move) {
   player_row_ = std::min(std::max(player_row_, 0), height_ - 1);
   player_col_ = std::min(std::max(player_col_, 0), width_ - 1);
   --time_counter_;
-  history_.pop_back();
+  PopHistory();
 }
 
 std::unique_ptr<State> CliffWalkingState::Clone() const {
@@ -18,7 +18,7 @@
 #include <memory>
 #include <utility>
 
-#include "open_spiel/utils/tensor_view.h"
+#include "open_spiel/utils/plane_encoding.h"
 
 namespace open_spiel {
 namespace connect_four {
@@ -39,8 +39,9 @@ const GameType kGameType{
     /*provides_information_state_tensor=*/false,
     /*provides_observation_string=*/true,
     /*provides_observation_tensor=*/true,
-    /*parameter_specification=*/{}  // no parameters
-};
+    /*parameter_specification=*/{},  // no parameters
+    /*default_loadable=*/true,
+    /*hash_determines_observation=*/true};
 
 std::shared_ptr<const Game> Factory(const GameParameters& params) {
   return std::shared_ptr<const Game>(new ConnectFourGame(params));
@@ -74,12 +75,40 @@ std::string StateToString(CellState state) {
 }
 }  // namespace
 
-CellState& ConnectFourState::CellAt(int row, int col) {
-  return board_[row * kCols + col];
+bool HasFour(uint64_t stones) {
+  // Vertical, horizontal and the two diagonals.
+  for (int shift : {1, kBitsPerCol, kBitsPerCol - 1, kBitsPerCol + 1}) {
+    const uint64_t pairs = stones & (stones >> shift);
+    if (pairs & (pairs >> (2 * shift))) return true;
+  }
+  return false;
+}
+
+uint64_t WinningCells(uint64_t stones, uint64_t occupied) {
+  // Vertical lines can only be completed on top.
+  uint64_t cells = (stones << 1) & (stones << 2) & (stones << 3);
+  for (int shift : {kBitsPerCol, kBitsPerCol - 1, kBitsPerCol + 1}) {
+    // The cell is at either end of three stones, or fills a gap in them.
+    uint64_t pairs = (stones << shift) & (stones << (2 * shift));
+    cells |= pairs & (stones << (3 * shift));
+    cells |= pairs & (stones >> shift);
+    pairs = (stones >> shift) & (stones >> (2 * shift));
+    cells |= pairs & (stones << shift);
+    cells |= pairs & (stones >> (3 * shift));
+  }
+  return cells & (kBoardMask ^ occupied);
 }
 
 CellState ConnectFourState::CellAt(int row, int col) const {
-  return board_[row * kCols + col];
+  const uint64_t bit = CellBit(row, col);
+  if (stones_[0] & bit) return PlayerToState(0);
+  if (stones_[1] & bit) return PlayerToState(1);
+  return CellState::kEmpty;
+}
+
+void ConnectFourState::SetCell(int row, int col, Player player) {
+  stones_[player] |= CellBit(row, col);
+  heights_[col] = std::max(heights_[col], row + 1);
 }
 
 int ConnectFourState::CurrentPlayer() const {
@@ -91,10 +120,8 @@ int ConnectFourState::CurrentPlayer() const {
 }
 
 void ConnectFourState::DoApplyAction(Action move) {
-  SPIEL_CHECK_EQ(CellAt(kRows - 1, move), CellState::kEmpty);
-  int row = 0;
-  while (CellAt(row, move) != CellState::kEmpty) ++row;
-  CellAt(row, move) = PlayerToState(CurrentPlayer());
+  SPIEL_CHECK_LT(heights_[move], kRows);
+  stones_[current_player_] |= CellBit(heights_[move]++, move);
 
   if (HasLine(current_player_)) {
     outcome_ = static_cast<Outcome>(current_player_);
@@ -105,63 +132,36 @@ void ConnectFourState::DoApplyAction(Action move) {
   current_player_ = 1 - current_player_;
 }
 
+void ConnectFourState::UndoAction(Player player, Action move) {
+  SPIEL_CHECK_GT(heights_[move], 0);
+  stones_[player] &= ~CellBit(--heights_[move], move);
+  current_player_ = player;
+  outcome_ = Outcome::kUnknown;
+  PopHistory();
+}
+
 std::vector<Action> ConnectFourState::LegalActions() const {
-  // Can move in any non-full column.
   std::vector<Action> moves;
-  if (IsTerminal()) return moves;
-  for (int col = 0; col < kCols; ++col) {
-    if (CellAt(kRows - 1, col) == CellState::kEmpty) moves.push_back(col);
-  }
+  LegalActions(&moves);
   return moves;
 }
 
-std::string ConnectFourState::ActionToString(Player player,
-                                             Action action_id) const {
-  return absl::StrCat(StateToString(PlayerToState(player)), action_id);
-}
-
-bool ConnectFourState::HasLineFrom(Player player, int row, int col) const {
-  return HasLineFromInDirection(player, row, col, 0, 1) ||
-         HasLineFromInDirection(player, row, col, -1, -1) ||
-         HasLineFromInDirection(player, row, col, -1, 0) ||
-         HasLineFromInDirection(player, row, col, -1, 1);
-}
-
-bool ConnectFourState::HasLineFromInDirection(Player player, int row, int col,
-                                              int drow, int dcol) const {
-  if (row + 3 * drow >= kRows || col + 3 * dcol >= kCols ||
-      row + 3 * drow < 0 || col + 3 * dcol < 0)
-    return false;
-  CellState c = PlayerToState(player);
-  for (int i = 0; i < 4; ++i) {
-    if (CellAt(row, col) != c) return false;
-    row += drow;
-    col += dcol;
-  }
-  return true;
-}
-
-bool ConnectFourState::HasLine(Player player) const {
-  CellState c = PlayerToState(player);
+void ConnectFourState::LegalActions(std::vector<Action>* moves) const {
+  // Can move in any non-full column.
+  moves->clear();
+  if (IsTerminal()) return;
   for (int col = 0; col < kCols; ++col) {
-    for (int row = 0; row < kRows; ++row) {
-      if (CellAt(row, col) == c && HasLineFrom(player, row, col)) return true;
-    }
+    if (heights_[col] < kRows) moves->push_back(col);
   }
-  return false;
 }
 
-bool ConnectFourState::IsFull() const {
-  for (int col = 0; col < kCols; ++col) {
-    if (CellAt(kRows - 1, col) == CellState::kEmpty) return false;
-  }
-  return true;
+std::string ConnectFourState::ActionToString(Player player,
+                                             Action action_id) const {
+  return absl::StrCat(StateToString(PlayerToState(player)), action_id);
 }
 
 ConnectFourState::ConnectFourState(std::shared_ptr<const Game> game)
-    : State(game) {
-  std::fill(begin(board_), end(board_), CellState::kEmpty);
-}
+    : State(game) {}
 
 std::string ConnectFourState::ToString() const {
   std::string str;
@@ -208,22 +208,49 @@ int PlayerRelative(CellState state, Player current) {
   }
 }
 
-void ConnectFourState::ObservationTensor(Player player,
-                                         std::vector<double>* values) const {
+template <typename T>
+void ConnectFourState::WriteObservationTensor(Player player,
+                                              absl::Span<T> values) const {
   SPIEL_CHECK_GE(player, 0);
   SPIEL_CHECK_LT(player, num_players_);
 
-  TensorView<2> view(values, {kCellStates, kNumCells}, true);
+  OneHotPlanes(
+      kNumCells, kCellStates,
+      [this, player](int cell) {
+        return PlayerRelative(CellAt(cell / kCols, cell % kCols), player);
+      },
+      values);
+}
 
-  for (int cell = 0; cell < kNumCells; ++cell) {
-    view[{PlayerRelative(board_[cell], player), cell}] = 1.0;
-  }
+void ConnectFourState::ObservationTensor(Player player,
+                                         std::vector<double>* values) const {
+  values->resize(kCellStates * kNumCells);
+  WriteObservationTensor(player, absl::MakeSpan(*values));
+}
+
+void ConnectFourState::ObservationTensor(Player player,
+                                         absl::Span<float> values) const {
+  WriteObservationTensor(player, values);
+}
+
+void ConnectFourState::ObservationTensor(Player player,
+                                         absl::Span<uint8_t> values) const {
+  WriteObservationTensor(player, values);
+}
+
+int64_t ConnectFourState::ApproximateMemoryUsage() const {
+  return sizeof(*this) + HistoryMemoryUsage();
 }
 
 std::unique_ptr<State> ConnectFourState::Clone() const {
   return std::unique_ptr<State>(new ConnectFourState(*this));
 }
 
+bool ConnectFourState::CopyFrom(const State& other) {
+  *this = static_cast<const ConnectFourState&>(other);
+  return true;
+}
+
 std::string ConnectFourState::Serialize() const { return ToString(); }
 
 ConnectFourGame::ConnectFourGame(const GameParameters& params)
@@ -244,15 +271,14 @@ ConnectFourState::ConnectFourState(std::shared_ptr<const Game> game,
   for (const char ch : str) {
     switch (ch) {
       case '.':
-        CellAt(r, c) = CellState::kEmpty;
         break;
       case 'x':
         ++xs;
-        CellAt(r, c) = CellState::kCross;
+        SetCell(r, c, 0);
         break;
       case 'o':
         ++os;
-        CellAt(r, c) = CellState::kNought;
+        SetCell(r, c, 1);
         break;
     }
     if (ch == '.' || ch == 'x' || ch == 'o') {
@@ -268,6 +294,12 @@ ConnectFourState::ConnectFourState(std::shared_ptr<const Game> game,
   SPIEL_CHECK_TRUE(c == 0 &&
                    ("Problem parsing state (column value should be 0)"));
   current_player_ = (xs == os) ? 0 : 1;
+  for (int col = 0; col < kCols; ++col) {
+    for (int row = 0; row < heights_[col]; ++row) {
+      SPIEL_CHECK_TRUE(CellAt(row, col) != CellState::kEmpty &&
+                       ("Problem parsing state (floating stone)."));
+    }
+  }
 
   if (HasLine(0)) {
     outcome_ = Outcome::kPlayer1;
@@ -21,6 +21,7 @@
 #include <string>
 #include <vector>
 
+#include "open_spiel/abseil-cpp/absl/types/span.h"
 #include "open_spiel/spiel.h"
 
 // Simple game of Connect Four
@@ -42,6 +43,32 @@ inline constexpr int kNumCells = kRows * kCols;
 inline constexpr int kCellStates =
     1 + kNumPlayers;  // player 0, player 1, empty
 
+// The board is kept as a bitboard of the stones of each player: the cell at
+// (row, col) is bit col * kBitsPerCol + row. The bit above the top of each
+// column is always empty, so that the lines found by shifting the boards do
+// not wrap around from one column to the next.
+inline constexpr int kBitsPerCol = kRows + 1;
+
+inline constexpr uint64_t CellBit(int row, int col) {
+  return uint64_t{1} << (col * kBitsPerCol + row);
+}
+
+// The bits of the bottom row, and of all the cells of the board.
+inline constexpr uint64_t kBottomMask = [] {
+  uint64_t mask = 0;
+  for (int col = 0; col < kCols; ++col) mask |= CellBit(0, col);
+  return mask;
+}();
+inline constexpr uint64_t kBoardMask =
+    kBottomMask * ((uint64_t{1} << kRows) - 1);
+
+// Do these stones make a line of four?
+bool HasFour(uint64_t stones);
+
+// The empty cells which would give these stones a line of four. occupied is
+// the mask of all the stones on the board.
+uint64_t WinningCells(uint64_t stones, uint64_t occupied);
+
 // Outcome of the game.
 enum class Outcome {
   kPlayer1 = 0,
@@ -64,9 +91,11 @@ class ConnectFourState : public State {
   explicit ConnectFourState(std::shared_ptr<const Game> game,
                             const std::string& str);
   ConnectFourState(const ConnectFourState& other) = default;
+  ConnectFourState& operator=(const ConnectFourState&) = default;
 
   Player CurrentPlayer() const override;
   std::vector<Action> LegalActions() const override;
+  void LegalActions(std::vector<Action>* actions) const override;
   std::string ActionToString(Player player, Action action_id) const override;
   std::string ToString() const override;
   bool IsTerminal() const override;
@@ -75,23 +104,53 @@ class ConnectFourState : public State {
   std::string ObservationString(Player player) const override;
   void ObservationTensor(Player player,
                          std::vector<double>* values) const override;
+  void ObservationTensor(Player player,
+                         absl::Span<float> values) const override;
+  void ObservationTensor(Player player,
+                         absl::Span<uint8_t> values) const override;
   std::unique_ptr<State> Clone() const override;
+  bool CopyFrom(const State& other) override;
+  int64_t ApproximateMemoryUsage() const override;
+  uint64_t HashValue() const override { return MixBits(PositionKey()); }
+  void UndoAction(Player player, Action move) override;
+  bool SupportsUndoAction() const override { return true; }
   std::string Serialize() const override;
 
+  // The bitboard of the player's stones, and of all the stones.
+  uint64_t Stones(Player player) const { return stones_[player]; }
+  uint64_t Occupied() const { return stones_[0] | stones_[1]; }
+
+  // The cells where the next stone of each column would land, for the
+  // columns which are not full.
+  uint64_t LegalMovesMask() const {
+    return (Occupied() + kBottomMask) & kBoardMask;
+  }
+
+  // A key identifying the position, including the player to move, in 49
+  // bits. HashValue() is a mix of its bits.
+  uint64_t PositionKey() const {
+    return stones_[0] + Occupied() + kBottomMask;
+  }
+
  protected:
   void DoApplyAction(Action move) override;
 
  private:
-  CellState& CellAt(int row, int col);
+  // Shared implementation of the ObservationTensor overloads.
+  template <typename T>
+  void WriteObservationTensor(Player player, absl::Span<T> values) const;
   CellState CellAt(int row, int col) const;
-  bool HasLine(Player player) const;  // Does this player have a line?
-  bool HasLineFrom(Player player, int row, int col) const;
-  bool HasLineFromInDirection(Player player, int row, int col, int drow,
-                              int dcol) const;
-  bool IsFull() const;         // Is the board full?
+  void SetCell(int row, int col, Player player);
+  bool HasLine(Player player) const {  // Does this player have a line?
+    return HasFour(stones_[player]);
+  }
+  bool IsFull() const {  // Is the board full?
+    return Occupied() == kBoardMask;
+  }
   Player current_player_ = 0;  // Player zero goes first
   Outcome outcome_ = Outcome::kUnknown;
-  std::array<CellState, kNumCells> board_;
+  std::array<uint64_t, kNumPlayers> stones_{};  // Bitboards of the stones.
+  std::array<int, kCols> heights_{};  // The number of stones in each column.
 };
 
 // Game object.
@@ -0,0 +1,216 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/games/connect_four/connect_four_solver.h"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/synchronization/mutex.h"
+#include "open_spiel/games/connect_four.h"
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace connect_four {
+namespace {
+
+// The bounds of the scores.
+constexpr int kMinScore = -kNumCells / 2;
+constexpr int kMaxScore = (kNumCells + 1) / 2;
+
+// The columns in the order they are searched.
+constexpr std::array<int, kCols> kColumnOrder = [] {
+  std::array<int, kCols> order{};
+  for (int i = 0; i < kCols; ++i) {
+    order[i] = kCols / 2 + (1 - 2 * (i % 2)) * (i + 1) / 2;
+  }
+  return order;
+}();
+
+constexpr uint64_t ColumnMask(int col) {
+  return ((uint64_t{1} << kRows) - 1) << (col * kBitsPerCol);
+}
+
+// The moves the player to move can make without letting the opponent win at
+// once: they must block any threat the opponent could complete, and not play
+// below one.
+uint64_t NonLosingMoves(uint64_t stones, uint64_t occupied) {
+  uint64_t moves = (occupied + kBottomMask) & kBoardMask;
+  const uint64_t threats = WinningCells(stones ^ occupied, occupied);
+  const uint64_t forced = moves & threats;
+  if (forced) {
+    if (forced & (forced - 1)) return 0;  // Two threats cannot be blocked.
+    moves = forced;
+  }
+  return moves & ~(threats >> 1);
+}
+
+}  // namespace
+
+ConnectFourSolver::ConnectFourSolver(int log2_table_size)
+    : table_mask_((uint64_t{1} << log2_table_size) - 1),
+      keys_(table_mask_ + 1),
+      values_(table_mask_ + 1) {}
+
+int ConnectFourSolver::Solve(const ConnectFourState& state) {
+  SPIEL_CHECK_FALSE(state.IsTerminal());
+  const uint64_t stones = state.Stones(state.CurrentPlayer());
+  const uint64_t occupied = state.Occupied();
+  const int num_stones = __builtin_popcountll(occupied);
+  if (WinningCells(stones, occupied) & state.LegalMovesMask()) {
+    return (kNumCells + 1 - num_stones) / 2;
+  }
+
+  // Narrows the score down with null window searches, trying the values
+  // closest to 0 first as they are the quickest to refute.
+  int min = -(kNumCells - num_stones) / 2;
+  int max = (kNumCells + 1 - num_stones) / 2;
+  while (min < max) {
+    int med = min + (max - min) / 2;
+    if (med <= 0 && min / 2 < med) {
+      med = min / 2;
+    } else if (med >= 0 && max / 2 > med) {
+      med = max / 2;
+    }
+    const int score = Negamax(stones, occupied, num_stones, med, med + 1);
+    if (score <= med) {
+      max = score;
+    } else {
+      min = score;
+    }
+  }
+  return min;
+}
+
+int ConnectFourSolver::Negamax(uint64_t stones, uint64_t occupied,
+                               int num_stones, int alpha, int beta) {
+  ++num_nodes_;
+  const uint64_t moves = NonLosingMoves(stones, occupied);
+  if (moves == 0) return -(kNumCells - num_stones) / 2;
+  if (num_stones >= kNumCells - 2) return 0;
+
+  // Neither player can win with their next stone.
+  int min = -(kNumCells - 2 - num_stones) / 2;
+  if (alpha < min) {
+    alpha = min;
+    if (alpha >= beta) return alpha;
+  }
+  int max = (kNumCells - 1 - num_stones) / 2;
+  if (beta > max) {
+    beta = max;
+    if (alpha >= beta) return beta;
+  }
+
+  // The table keeps upper bounds as score - kMinScore + 1, and lower bounds
+  // above them as score + kMaxScore - 2 * kMinScore + 2.
+  const uint64_t key = stones + occupied + kBottomMask;
+  const uint64_t entry = MixBits(key) & table_mask_;
+  if (keys_[entry] == key && values_[entry] != 0) {
+    const int value = values_[entry];
+    if (value > kMaxScore - kMinScore + 1) {
+      min = value + 2 * kMinScore - kMaxScore - 2;
+      if (alpha < min) {
+        alpha = min;
+        if (alpha >= beta) return alpha;
+      }
+    } else {
+      max = value + kMinScore - 1;
+      if (beta > max) {
+        beta = max;
+        if (alpha >= beta) return beta;
+      }
+    }
+  }
+
+  // Orders the moves by the number of threats they make, the central columns
+  // first among equals.
+  std::array<uint64_t, kCols> ordered_moves;
+  std::array<int, kCols> move_scores;
+  int num_moves = 0;
+  for (int col : kColumnOrder) {
+    const uint64_t move = moves & ColumnMask(col);
+    if (!move) continue;
+    const int score =
+        __builtin_popcountll(WinningCells(stones | move, occupied | move));
+    int i = num_moves++;
+    for (; i > 0 && move_scores[i - 1] < score; --i) {
+      ordered_moves[i] = ordered_moves[i - 1];
+      move_scores[i] = move_scores[i - 1];
+    }
+    ordered_moves[i] = move;
+    move_scores[i] = score;
+  }
+
+  for (int i = 0; i < num_moves; ++i) {
+    // The opponent's stones are those the player to move does not have.
+    const int score = -Negamax(stones ^ occupied, occupied | ordered_moves[i],
+                               num_stones + 1, -beta, -alpha);
+    if (score >= beta) {
+      keys_[entry] = key;
+      values_[entry] = score + kMaxScore - 2 * kMinScore + 2;
+      return score;
+    }
+    if (score > alpha) alpha = score;
+  }
+  keys_[entry] = key;
+  values_[entry] = alpha - kMinScore + 1;
+  return alpha;
+}
+
+ConnectFourSolverEvaluator::ConnectFourSolverEvaluator(
+    int max_empty_cells, std::shared_ptr<algorithms::Evaluator> fallback,
+    int log2_table_size)
+    : max_empty_cells_(max_empty_cells),
+      fallback_(std::move(fallback)),
+      solver_(log2_table_size) {}
+
+std::vector<double> ConnectFourSolverEvaluator::Evaluate(const State& state) {
+  if (state.IsTerminal()) return state.Returns();
+  const auto* connect_four_state =
+      dynamic_cast<const ConnectFourState*>(&state);
+  SPIEL_CHECK_TRUE(connect_four_state != nullptr);
+  const int num_empty_cells =
+      kNumCells - __builtin_popcountll(connect_four_state->Occupied());
+  if (fallback_ != nullptr && num_empty_cells > max_empty_cells_) {
+    return fallback_->Evaluate(state);
+  }
+
+  int score;
+  {
+    absl::MutexLock lock(&mutex_);
+    score = solver_.Solve(*connect_four_state);
+  }
+  const double value = score > 0 ? 1 : score < 0 ? -1 : 0;
+  std::vector<double> returns(kNumPlayers);
+  returns[state.CurrentPlayer()] = value;
+  returns[1 - state.CurrentPlayer()] = -value;
+  return returns;
+}
+
+ActionsAndProbs ConnectFourSolverEvaluator::Prior(const State& state) {
+  if (fallback_ != nullptr) return fallback_->Prior(state);
+  std::vector<Action> legal_actions = state.LegalActions();
+  ActionsAndProbs prior;
+  prior.reserve(legal_actions.size());
+  for (Action action : legal_actions) {
+    prior.emplace_back(action, 1.0 / legal_actions.size());
+  }
+  return prior;
+}
+
+}  // namespace connect_four
+}  // namespace open_spiel
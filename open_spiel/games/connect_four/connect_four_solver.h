@@ -0,0 +1,88 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_GAMES_CONNECT_FOUR_CONNECT_FOUR_SOLVER_H_
+#define OPEN_SPIEL_GAMES_CONNECT_FOUR_CONNECT_FOUR_SOLVER_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/synchronization/mutex.h"
+#include "open_spiel/algorithms/mcts.h"
+#include "open_spiel/games/connect_four.h"
+#include "open_spiel/spiel.h"
+
+namespace open_spiel {
+namespace connect_four {
+
+// Solves connect four positions exactly, by a null window alpha-beta search
+// on the bitboards of ConnectFourState, in the manner of Pascal Pons' solver
+// (http://blog.gamesolver.org). The search only plays the moves which do not
+// lose at once, tries the central columns and the moves making the most
+// threats first, and keeps the bounds it finds in a transposition table,
+// which is kept from one position to the next.
+class ConnectFourSolver {
+ public:
+  // The transposition table has 2^log2_table_size entries of 9 bytes.
+  explicit ConnectFourSolver(int log2_table_size = 23);
+
+  // The score of a non-terminal position for the player to move: 0 if it is
+  // a draw with best play, positive if they win and negative if they lose.
+  // Winning with one's n-th stone scores kNumCells / 2 + 1 - n, so the
+  // quicker the win, the larger the score.
+  int Solve(const ConnectFourState& state);
+
+  // The number of positions searched so far.
+  int64_t NumNodes() const { return num_nodes_; }
+
+ private:
+  // stones are those of the player to move, and occupied all of them.
+  int Negamax(uint64_t stones, uint64_t occupied, int num_stones, int alpha,
+              int beta);
+
+  uint64_t table_mask_;
+  std::vector<uint64_t> keys_;
+  std::vector<int8_t> values_;  // 0 for the empty entries.
+  int64_t num_nodes_ = 0;
+};
+
+// An MCTS evaluator giving the exact values of the states with at most
+// max_empty_cells empty cells, and those of fallback for the others. The
+// priors are fallback's, or uniform without a fallback, in which case all the
+// states are solved; from the initial state, this takes minutes.
+//
+// The solver is shared by the calls, which are serialized.
+class ConnectFourSolverEvaluator : public algorithms::Evaluator {
+ public:
+  ConnectFourSolverEvaluator(
+      int max_empty_cells,
+      std::shared_ptr<algorithms::Evaluator> fallback = nullptr,
+      int log2_table_size = 23);
+
+  // The states must be ConnectFourStates.
+  std::vector<double> Evaluate(const State& state) override;
+  ActionsAndProbs Prior(const State& state) override;
+
+ private:
+  int max_empty_cells_;
+  std::shared_ptr<algorithms::Evaluator> fallback_;
+  absl::Mutex mutex_;
+  ConnectFourSolver solver_;
+};
+
+}  // namespace connect_four
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_GAMES_CONNECT_FOUR_CONNECT_FOUR_SOLVER_H_
@@ -14,6 +14,11 @@
 
 #include "open_spiel/games/connect_four.h"
 
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "open_spiel/games/connect_four/connect_four_solver.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
 #include "open_spiel/tests/basic_tests.h"
@@ -79,6 +84,89 @@ void DeserializeDraw() {
   SPIEL_CHECK_EQ(state->Returns(), (std::vector<double>{0, 0}));
 }
 
+void TranspositionsShareTheirKey() {
+  std::shared_ptr<const Game> game = LoadGame("connect_four");
+  std::unique_ptr<State> state = game->NewInitialState();
+  std::unique_ptr<State> transposed = game->NewInitialState();
+  for (Action action : {3, 2, 4}) state->ApplyAction(action);
+  for (Action action : {4, 2, 3}) transposed->ApplyAction(action);
+  const auto& c4_state = static_cast<const ConnectFourState&>(*state);
+  SPIEL_CHECK_EQ(c4_state.PositionKey(),
+                 static_cast<const ConnectFourState&>(*transposed)
+                     .PositionKey());
+  SPIEL_CHECK_EQ(state->HashValue(), transposed->HashValue());
+  SPIEL_CHECK_EQ(c4_state.LegalMovesMask(),
+                 CellBit(0, 0) | CellBit(0, 1) | CellBit(1, 2) |
+                     CellBit(1, 3) | CellBit(1, 4) | CellBit(0, 5) |
+                     CellBit(0, 6));
+
+  state->UndoAction(0, 4);
+  SPIEL_CHECK_NE(c4_state.PositionKey(),
+                 static_cast<const ConnectFourState&>(*transposed)
+                     .PositionKey());
+}
+
+// The value of the state for the player to move, by a plain minimax search.
+int MinimaxValue(State* state) {
+  if (state->IsTerminal()) return state->PlayerReturn(state->CurrentPlayer());
+  const Player player = state->CurrentPlayer();
+  int value = -1;
+  for (Action action : state->LegalActions()) {
+    state->ApplyAction(action);
+    int child_value = state->IsTerminal() ? state->PlayerReturn(player)
+                                          : -MinimaxValue(state);
+    state->UndoAction(player, action);
+    value = std::max(value, child_value);
+    if (value == 1) break;
+  }
+  return value;
+}
+
+void SolverMatchesMinimax() {
+  std::shared_ptr<const Game> game = LoadGame("connect_four");
+  ConnectFourSolver solver(/*log2_table_size=*/16);
+  std::mt19937 rng(42);
+  int num_solved = 0;
+  while (num_solved < 50) {
+    std::unique_ptr<State> state = game->NewInitialState();
+    for (int i = 0; i < kNumCells - 12 && !state->IsTerminal(); ++i) {
+      std::vector<Action> actions = state->LegalActions();
+      state->ApplyAction(actions[rng() % actions.size()]);
+    }
+    if (state->IsTerminal()) continue;
+    const int score =
+        solver.Solve(static_cast<const ConnectFourState&>(*state));
+    const int value = MinimaxValue(state.get());
+    SPIEL_CHECK_EQ(score > 0 ? 1 : score < 0 ? -1 : 0, value);
+    ++num_solved;
+  }
+}
+
+void SolverScoresQuickWins() {
+  std::shared_ptr<const Game> game = LoadGame("connect_four");
+  std::unique_ptr<State> state = game->NewInitialState();
+  for (Action action : {3, 3, 4, 4}) state->ApplyAction(action);
+  ConnectFourSolver solver(/*log2_table_size=*/16);
+  // x wins with their fourth stone, at 2 or 5.
+  SPIEL_CHECK_EQ(solver.Solve(static_cast<const ConnectFourState&>(*state)),
+                 kNumCells / 2 + 1 - 4);
+  state->ApplyAction(2);
+  // o can only block one end, and x wins with their fourth stone at the other.
+  SPIEL_CHECK_EQ(solver.Solve(static_cast<const ConnectFourState&>(*state)),
+                 -(kNumCells / 2 + 1 - 4));
+}
+
+void SolverEvaluatorTest() {
+  std::shared_ptr<const Game> game = LoadGame("connect_four");
+  std::unique_ptr<State> state = game->NewInitialState();
+  for (Action action : {3, 3, 4, 4}) state->ApplyAction(action);
+  ConnectFourSolverEvaluator evaluator(/*max_empty_cells=*/kNumCells,
+                                       /*fallback=*/nullptr,
+                                       /*log2_table_size=*/16);
+  SPIEL_CHECK_EQ(evaluator.Evaluate(*state), (std::vector<double>{1, -1}));
+  SPIEL_CHECK_EQ(evaluator.Prior(*state).size(), kCols);
+}
+
 }  // namespace
 }  // namespace connect_four
 }  // namespace open_spiel
@@ -88,4 +176,8 @@ int main(int argc, char **argv) {
   open_spiel::connect_four::FastLoss();
   open_spiel::connect_four::BasicSerializationTest();
   open_spiel::connect_four::DeserializeDraw();
+  open_spiel::connect_four::TranspositionsShareTheirKey();
+  open_spiel::connect_four::SolverMatchesMinimax();
+  open_spiel::connect_four::SolverScoresQuickWins();
+  open_spiel::connect_four::SolverEvaluatorTest();
 }
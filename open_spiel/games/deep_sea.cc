@@ -15,14 +15,20 @@
 #include "open_spiel/games/deep_sea.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <cstdlib>
+#include <memory>
+#include <random>
 #include <utility>
+#include <vector>
 
 #include "open_spiel/abseil-cpp/absl/random/distributions.h"
 #include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/abseil-cpp/absl/types/span.h"
 #include "open_spiel/game_parameters.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
+#include "open_spiel/vector_state.h"
 
 namespace open_spiel {
 namespace deep_sea {
@@ -57,6 +63,71 @@ std::shared_ptr<Game> Factory(const GameParameters& params) {
 
 REGISTER_SPIEL_GAME(kGameType, Factory);
 
+// DeepSea for VectorState: the position of the player in every slot.
+class DeepSeaKernel : public BatchedKernel {
+ public:
+  DeepSeaKernel(const DeepSeaGame& game, int num_states)
+      : size_(game.MaxGameLength()),
+        move_cost_(-game.UnscaledMoveCost() / size_),
+        player_row_(num_states),
+        player_col_(num_states) {
+    const std::vector<bool> action_mapping = game.ActionMapping();
+    action_mapping_.assign(action_mapping.begin(), action_mapping.end());
+  }
+
+  void Reset(int begin, int end, absl::Span<std::mt19937> rngs) override {
+    std::fill(player_row_.begin() + begin, player_row_.begin() + end, 0);
+    std::fill(player_col_.begin() + begin, player_col_.begin() + end, 0);
+  }
+
+  void Step(int begin, int end, absl::Span<const Action> actions,
+            absl::Span<std::mt19937> rngs, absl::Span<float> rewards,
+            absl::Span<float> dones) override {
+    for (int i = begin; i < end; ++i) {
+      const int row = player_row_[i];
+      const int col = player_col_[i];
+      const bool right = actions[i] == action_mapping_[row * size_ + col];
+      const bool done = row + 1 == size_;
+      const bool treasure = done && right && col + 1 == size_;
+      rewards[i] = (right ? move_cost_ : 0.0) + (treasure ? 1.0 : 0.0);
+      dones[i] = done;
+      // Slots whose episode ended go back to the top.
+      player_row_[i] = done ? 0 : row + 1;
+      player_col_[i] = done ? 0 : right ? col + 1 : std::max(col - 1, 0);
+    }
+  }
+
+  void ObservationTensors(int begin, int end,
+                          absl::Span<float> values) const override {
+    const int size = size_ * size_;
+    std::fill(values.begin() + begin * size, values.begin() + end * size, 0);
+    for (int i = begin; i < end; ++i) {
+      values[i * size + player_row_[i] * size_ + player_col_[i]] = 1;
+    }
+  }
+
+  void LegalActionsMasks(int begin, int end,
+                         absl::Span<uint8_t> values) const override {
+    std::fill(values.begin() + begin * kNumActions,
+              values.begin() + end * kNumActions, 1);
+  }
+
+ private:
+  const int size_;
+  const double move_cost_;
+  std::vector<uint8_t> action_mapping_;
+  std::vector<int> player_row_;
+  std::vector<int> player_col_;
+};
+
+std::unique_ptr<BatchedKernel> KernelFactory(const Game& game,
+                                             int num_states) {
+  return std::make_unique<DeepSeaKernel>(
+      static_cast<const DeepSeaGame&>(game), num_states);
+}
+
+REGISTER_BATCHED_KERNEL("deep_sea", KernelFactory);
+
 }  // namespace
 
 DeepSeaState::DeepSeaState(std::shared_ptr<const Game> game) : State(game) {
@@ -179,7 +250,7 @@ void DeepSeaState::UndoAction(Player player, Action move) {
   player_col_ -= direction_history_.back() ? 1 : -1;
   --player_row_;
   direction_history_.pop_back();
-  history_.pop_back();
+  PopHistory();
 }
 
 void DeepSeaState::DoApplyAction(Action move) {
@@ -14,21 +14,50 @@
 
 #include "open_spiel/games/efg_game.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
-#include <fstream>
+#include <limits>
+#include <utility>
 
 #include "open_spiel/abseil-cpp/absl/strings/numbers.h"
 #include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
 #include "open_spiel/abseil-cpp/absl/strings/str_split.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/file.h"
 
 namespace open_spiel {
 namespace efg_game {
 namespace {
 
-constexpr int kBuffSize = 1024;
+constexpr char kBinaryMagic[8] = {'O', 'S', 'E', 'F', 'G', 'B', 'I', 'N'};
+constexpr uint32_t kBinaryVersion = 1;
+
+// The header of the files written by EFGGame::WriteBinary. It is followed by
+// the ids of the prologue strings, the nodes, the values, the string offsets
+// and the string characters, each starting at a multiple of 8 bytes.
+struct BinaryHeader {
+  char magic[8];
+  uint32_t version;
+  int32_t node_size;  // Catches changes of the layout of Node.
+  int32_t num_players;
+  int32_t num_nodes;
+  int64_t num_values;
+  int64_t num_strings;
+  int64_t num_chars;
+};
+
+// The id of the empty string, which is the first of the strings.
+constexpr int kEmptyStringId = 0;
+
+int64_t Align(int64_t size) { return (size + 7) / 8 * 8; }
 
 // Facts about the game. These are defaults that will differ depending on the
 // game's descriptions. Using dummy defaults just to register the game.
@@ -55,26 +84,32 @@ std::shared_ptr<const Game> Factory(const GameParameters& params) {
 
 REGISTER_SPIEL_GAME(kGameType, Factory);
 
-std::string NodeToString(const Node* node) {
+std::string NodeToString(const EFGGame& game, const Node& node) {
   std::string str = "";
-  if (node->type == NodeType::kTerminal) {
-    absl::StrAppend(&str, "Terminal: ", node->name, " ", node->outcome_name);
-    for (double payoff : node->payoffs) {
-      absl::StrAppend(&str, " ", payoff);
+  if (node.type == NodeType::kTerminal) {
+    absl::StrAppend(&str, "Terminal: ", game.GetString(node.name), " ",
+                    game.GetString(node.outcome_name));
+    for (int p = 0; p < game.NumPlayers(); ++p) {
+      absl::StrAppend(&str, " ", game.GetValue(node.values + p));
     }
     absl::StrAppend(&str, "\n");
-  } else if (node->type == NodeType::kChance) {
-    absl::StrAppend(&str, "Chance: ", node->name, " ", node->infoset_number,
-                    " ", node->infoset_name);
-    for (int i = 0; i < node->children.size(); ++i) {
-      absl::StrAppend(&str, " ", node->actions[i], " ", node->probs[i]);
+  } else if (node.type == NodeType::kChance) {
+    absl::StrAppend(&str, "Chance: ", game.GetString(node.name), " ",
+                    node.infoset_number, " ",
+                    game.GetString(node.infoset_name));
+    for (int i = 0; i < node.num_children; ++i) {
+      const Node& child = game.GetNode(node.first_child + i);
+      absl::StrAppend(&str, " ", game.GetString(child.action_name), " ",
+                      game.GetValue(node.values + i));
     }
     absl::StrAppend(&str, "\n");
-  } else if (node->type == NodeType::kPlayer) {
-    absl::StrAppend(&str, "Player: ", node->name, " ", node->player_number, " ",
-                    node->infoset_number, " ", node->infoset_name);
-    for (int i = 0; i < node->children.size(); ++i) {
-      absl::StrAppend(&str, " ", node->actions[i]);
+  } else if (node.type == NodeType::kPlayer) {
+    absl::StrAppend(&str, "Player: ", game.GetString(node.name), " ",
+                    node.player_number, " ", node.infoset_number, " ",
+                    game.GetString(node.infoset_name));
+    for (int i = 0; i < node.num_children; ++i) {
+      const Node& child = game.GetNode(node.first_child + i);
+      absl::StrAppend(&str, " ", game.GetString(child.action_name));
     }
     absl::StrAppend(&str, "\n");
   }
@@ -83,7 +118,9 @@ std::string NodeToString(const Node* node) {
 }  // namespace
 
 EFGState::EFGState(std::shared_ptr<const Game> game, const Node* root)
-    : State(game), cur_node_(root) {}
+    : State(game),
+      efg_game_(static_cast<const EFGGame*>(game.get())),
+      cur_node_(root) {}
 
 Player EFGState::CurrentPlayer() const {
   if (cur_node_->type == NodeType::kChance) {
@@ -99,12 +136,14 @@ Player EFGState::CurrentPlayer() const {
 }
 
 std::string EFGState::ActionToString(Player player, Action action) const {
-  SPIEL_CHECK_LT(action, cur_node_->actions.size());
-  return cur_node_->actions[action];
+  SPIEL_CHECK_LT(action, cur_node_->num_children);
+  return std::string(efg_game_->GetString(
+      efg_game_->GetNode(cur_node_->first_child + action).action_name));
 }
 
 std::string EFGState::ToString() const {
-  return absl::StrCat(cur_node_->id, ": ", NodeToString(cur_node_));
+  return absl::StrCat(cur_node_->id, ": ",
+                      NodeToString(*efg_game_, *cur_node_));
 }
 
 bool EFGState::IsTerminal() const {
@@ -112,12 +151,13 @@ bool EFGState::IsTerminal() const {
 }
 
 std::vector<double> EFGState::Returns() const {
+  std::vector<double> returns(num_players_, 0);
   if (cur_node_->type == NodeType::kTerminal) {
-    SPIEL_CHECK_EQ(cur_node_->payoffs.size(), num_players_);
-    return cur_node_->payoffs;
-  } else {
-    return std::vector<double>(num_players_, 0);
+    for (int p = 0; p < num_players_; ++p) {
+      returns[p] = efg_game_->GetValue(cur_node_->values + p);
+    }
   }
+  return returns;
 }
 
 std::string EFGState::InformationStateString(Player player) const {
@@ -127,14 +167,16 @@ std::string EFGState::InformationStateString(Player player) const {
   // the names are optional. But the numbers are unique per player, so must
   // add the player number.
   return absl::StrCat(cur_node_->player_number - 1, "-", player, "-",
-                      cur_node_->infoset_number, "-", cur_node_->infoset_name);
+                      cur_node_->infoset_number, "-",
+                      efg_game_->GetString(cur_node_->infoset_name));
 }
 
 std::string EFGState::ObservationString(Player player) const {
   SPIEL_CHECK_GE(player, 0);
   SPIEL_CHECK_LT(player, num_players_);
   return absl::StrCat(cur_node_->player_number - 1, "-", player, "-",
-                      cur_node_->infoset_number, "-", cur_node_->infoset_name);
+                      cur_node_->infoset_number, "-",
+                      efg_game_->GetString(cur_node_->infoset_name));
 }
 
 std::unique_ptr<State> EFGState::Clone() const {
@@ -142,22 +184,22 @@ std::unique_ptr<State> EFGState::Clone() const {
 }
 
 void EFGState::UndoAction(Player player, Action action) {
-  SPIEL_CHECK_TRUE(cur_node_->parent != nullptr);
-  cur_node_ = cur_node_->parent;
+  SPIEL_CHECK_GE(cur_node_->parent, 0);
+  cur_node_ = &efg_game_->GetNode(cur_node_->parent);
+  PopHistory();
 }
 
 void EFGState::DoApplyAction(Action action) {
   // Actions in these games are just indices into the legal actions.
   SPIEL_CHECK_FALSE(cur_node_->type == NodeType::kTerminal);
-  SPIEL_CHECK_LT(action, cur_node_->children.size());
-  SPIEL_CHECK_FALSE(cur_node_->children[action] == nullptr);
-  cur_node_ = cur_node_->children[action];
+  SPIEL_CHECK_LT(action, cur_node_->num_children);
+  cur_node_ = &efg_game_->GetNode(cur_node_->first_child + action);
 }
 
 std::vector<Action> EFGState::LegalActions() const {
   // Actions in these games are just indices into the legal actions.
-  std::vector<Action> actions(cur_node_->actions.size(), 0);
-  for (int i = 0; i < cur_node_->actions.size(); ++i) {
+  std::vector<Action> actions(cur_node_->num_children, 0);
+  for (int i = 0; i < cur_node_->num_children; ++i) {
     actions[i] = i;
   }
   if (cur_node_->type != NodeType::kTerminal) {
@@ -169,10 +211,10 @@ std::vector<Action> EFGState::LegalActions() const {
 std::vector<std::pair<Action, double>> EFGState::ChanceOutcomes() const {
   SPIEL_CHECK_TRUE(IsChanceNode());
   SPIEL_CHECK_TRUE(cur_node_->type == NodeType::kChance);
-  std::vector<std::pair<Action, double>> outcomes(cur_node_->children.size());
-  for (int i = 0; i < cur_node_->children.size(); ++i) {
+  std::vector<std::pair<Action, double>> outcomes(cur_node_->num_children);
+  for (int i = 0; i < cur_node_->num_children; ++i) {
     outcomes[i].first = i;
-    outcomes[i].second = cur_node_->probs[i];
+    outcomes[i].second = efg_game_->GetValue(cur_node_->values + i);
   }
   return outcomes;
 }
@@ -203,25 +245,37 @@ EFGGame::EFGGame(const GameParameters& params)
       perfect_information_(true) {
   filename_ = ParameterValue<std::string>("filename");
 
-  std::ifstream file;
-  file.open(filename_.c_str());
-  if (!file.is_open()) {
+  const int fd = open(filename_.c_str(), O_RDONLY);
+  if (fd < 0) {
     SpielFatalError(absl::StrCat("Could not open input file: ", filename_));
   }
-
-  string_data_ = "";
-  char buffer[kBuffSize];
-  while (!file.eof()) {
-    memset(buffer, 0, kBuffSize);
-    file.read(buffer, kBuffSize - 1);
-    absl::StrAppend(&string_data_, buffer);
+  struct stat file_stat;
+  SPIEL_CHECK_EQ(fstat(fd, &file_stat), 0);
+  mapped_size_ = file_stat.st_size;
+  if (mapped_size_ == 0) {
+    close(fd);
+    SpielFatalError(absl::StrCat("Empty input file: ", filename_));
   }
-  file.close();
-
-  SPIEL_CHECK_GT(string_data_.size(), 0);
+  void* data = mmap(nullptr, mapped_size_, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    SpielFatalError(absl::StrCat("Could not map input file: ", filename_));
+  }
+  mapped_data_ = static_cast<const char*>(data);
 
-  // Now parse the string data into a data structure.
-  ParseGame();
+  if (mapped_size_ >= sizeof(kBinaryMagic) &&
+      std::memcmp(mapped_data_, kBinaryMagic, sizeof(kBinaryMagic)) == 0) {
+    ReadBinary();
+  } else {
+    // The text is read once, from start to end, and not needed afterwards.
+    madvise(data, mapped_size_, MADV_SEQUENTIAL);
+    text_ = absl::string_view(mapped_data_, mapped_size_);
+    ParseGame();
+    munmap(data, mapped_size_);
+    mapped_data_ = nullptr;
+    mapped_size_ = 0;
+  }
+  AnalyzeTree();
 }
 
 EFGGame::EFGGame(const std::string& data)
@@ -236,7 +290,16 @@ EFGGame::EFGGame(const std::string& data)
       identical_payoffs_(true),
       general_sum_(true),
       perfect_information_(true) {
+  SPIEL_CHECK_GT(string_data_.size(), 0);
+  text_ = string_data_;
   ParseGame();
+  AnalyzeTree();
+}
+
+EFGGame::~EFGGame() {
+  if (mapped_data_ != nullptr) {
+    munmap(const_cast<char*>(mapped_data_), mapped_size_);
+  }
 }
 
 std::shared_ptr<const Game> LoadEFGGame(const std::string& data) {
@@ -251,16 +314,33 @@ bool EFGGame::IsNodeToken(char c) const {
   return (c == 'c' || c == 'p' || c == 't');
 }
 
-std::unique_ptr<Node> EFGGame::NewNode() const {
-  std::unique_ptr<Node> new_node = std::make_unique<Node>();
-  new_node->id = nodes_.size();
-  return new_node;
+int EFGGame::NewNode(int parent, int action_name) {
+  SPIEL_CHECK_LT(owned_nodes_.size(), std::numeric_limits<int>::max());
+  Node node{};
+  node.id = owned_nodes_.size();
+  node.parent = parent;
+  node.action_name = action_name;
+  owned_nodes_.push_back(node);
+  return node.id;
+}
+
+// The strings are stored once each, as names are often repeated. The keys of
+// the map are views of the text, which lives as long as the parsing.
+int EFGGame::InternString(absl::string_view str) {
+  if (str.empty()) return kEmptyStringId;
+  auto [iter, inserted] =
+      string_ids_.emplace(str, owned_string_offsets_.size() - 1);
+  if (inserted) {
+    owned_string_chars_.append(str.data(), str.size());
+    owned_string_offsets_.push_back(owned_string_chars_.size());
+  }
+  return iter->second;
 }
 
-bool EFGGame::ParseDoubleValue(const std::string& str, double* value) const {
-  if (str.find('/') != std::string::npos) {
+bool EFGGame::ParseDoubleValue(absl::string_view str, double* value) const {
+  if (str.find('/') != absl::string_view::npos) {
     // Check for rational number of the form X/Y
-    std::vector<std::string> parts = absl::StrSplit(str, '/');
+    std::vector<absl::string_view> parts = absl::StrSplit(str, '/');
     SPIEL_CHECK_EQ(parts.size(), 2);
     int numerator = 0, denominator = 0;
     bool success = absl::SimpleAtoi(parts[0], &numerator);
@@ -280,38 +360,34 @@ bool EFGGame::ParseDoubleValue(const std::string& str, double* value) const {
   }
 }
 
-std::string EFGGame::NextToken() {
-  std::string str = "";
+// Tokens are views of the text, so that reading them copies nothing.
+absl::string_view EFGGame::NextToken() {
   bool reading_quoted_string = false;
 
-  if (string_data_.at(pos_) == '"') {
+  if (text_.at(pos_) == '"') {
     reading_quoted_string = true;
     pos_++;
   }
 
-  while (true) {
-    // Check stopping condition:
-    if (pos_ >= string_data_.length() ||
-        (reading_quoted_string && string_data_.at(pos_) == '"') ||
-        (!reading_quoted_string && IsWhiteSpace(string_data_.at(pos_)))) {
-      break;
-    }
-
-    str.push_back(string_data_.at(pos_));
+  const int64_t start = pos_;
+  while (pos_ < text_.length() &&
+         (reading_quoted_string ? text_[pos_] != '"'
+                                : !IsWhiteSpace(text_[pos_]))) {
     pos_++;
   }
+  const absl::string_view token = text_.substr(start, pos_ - start);
 
   if (reading_quoted_string) {
-    SPIEL_CHECK_EQ(string_data_.at(pos_), '"');
+    SPIEL_CHECK_EQ(text_.at(pos_), '"');
   }
   pos_++;
 
   // Advance the position to the next token.
-  while (pos_ < string_data_.length() && IsWhiteSpace(string_data_.at(pos_))) {
+  while (pos_ < text_.length() && IsWhiteSpace(text_[pos_])) {
     pos_++;
   }
 
-  return str;
+  return token;
 }
 
 /*
@@ -351,30 +427,34 @@ t "" 16 "Outcome 16" { 10.000000 0.000000 }
 void EFGGame::ParsePrologue() {
   // Parse the first part of the header "EFG 2 R "
   SPIEL_CHECK_TRUE(NextToken() == "EFG");
-  SPIEL_CHECK_LT(pos_, string_data_.length());
+  SPIEL_CHECK_LT(pos_, text_.length());
   SPIEL_CHECK_TRUE(NextToken() == "2");
-  SPIEL_CHECK_LT(pos_, string_data_.length());
+  SPIEL_CHECK_LT(pos_, text_.length());
   SPIEL_CHECK_TRUE(NextToken() == "R");
-  SPIEL_CHECK_LT(pos_, string_data_.length());
-  SPIEL_CHECK_EQ(string_data_.at(pos_), '"');
-  name_ = NextToken();
-  std::string token = NextToken();
+  SPIEL_CHECK_LT(pos_, text_.length());
+  SPIEL_CHECK_EQ(text_.at(pos_), '"');
+  const int name = InternString(NextToken());
+  absl::string_view token = NextToken();
   SPIEL_CHECK_TRUE(token == "{");
-  SPIEL_CHECK_EQ(string_data_.at(pos_), '"');
+  SPIEL_CHECK_EQ(text_.at(pos_), '"');
+  std::vector<int> player_names;
   token = NextToken();
   while (token != "}") {
-    player_names_.push_back(token);
+    player_names.push_back(InternString(token));
     token = NextToken();
   }
-  num_players_ = player_names_.size();
-  if (string_data_.at(pos_) == '"') {
-    description_ = NextToken();
+  int description = kEmptyStringId;
+  if (text_.at(pos_) == '"') {
+    description = InternString(NextToken());
   }
-  SPIEL_CHECK_LT(pos_, string_data_.length());
-  SPIEL_CHECK_TRUE(IsNodeToken(string_data_.at(pos_)));
+  prologue_strings_ = {name, description};
+  prologue_strings_.insert(prologue_strings_.end(), player_names.begin(),
+                           player_names.end());
+  SPIEL_CHECK_LT(pos_, text_.length());
+  SPIEL_CHECK_TRUE(IsNodeToken(text_.at(pos_)));
 }
 
-void EFGGame::ParseChanceNode(Node* parent, Node* child, int depth) {
+void EFGGame::ParseChanceNode(Node* node) {
   // a text string, giving the name of the node
   // a positive integer specifying the information set number
   // (optional) the name of the information set
@@ -385,47 +465,39 @@ void EFGGame::ParseChanceNode(Node* parent, Node* child, int depth) {
   //
   // c "ROOT" 1 "(0,1)" { "1G" 0.500000 "1B" 0.500000 } 0
   SPIEL_CHECK_TRUE(NextToken() == "c");
-  num_chance_nodes_++;
-  max_depth_ = std::max(max_depth_, depth);
-  child->type = NodeType::kChance;
-  child->parent = parent;
-  SPIEL_CHECK_EQ(string_data_.at(pos_), '"');
-  child->name = NextToken();
-  SPIEL_CHECK_FALSE(string_data_.at(pos_) == '"');
-  SPIEL_CHECK_TRUE(absl::SimpleAtoi(NextToken(), &child->infoset_number));
-  if (string_data_.at(pos_) == '"') {
-    child->infoset_name = NextToken();
+  node->type = NodeType::kChance;
+  SPIEL_CHECK_EQ(text_.at(pos_), '"');
+  node->name = InternString(NextToken());
+  SPIEL_CHECK_FALSE(text_.at(pos_) == '"');
+  SPIEL_CHECK_TRUE(absl::SimpleAtoi(NextToken(), &node->infoset_number));
+  node->infoset_name = kEmptyStringId;
+  if (text_.at(pos_) == '"') {
+    node->infoset_name = InternString(NextToken());
   }
   // I do not understand how the list of children can be optional.
   SPIEL_CHECK_TRUE(NextToken() == "{");
-  int chance_outcomes = 0;
   double prob_sum = 0.0;
-  while (string_data_.at(pos_) == '"') {
-    child->actions.push_back(NextToken());
+  node->first_child = owned_nodes_.size();
+  node->values = owned_values_.size();
+  while (text_.at(pos_) == '"') {
+    const int action_name = InternString(NextToken());
     double prob = -1;
     SPIEL_CHECK_TRUE(ParseDoubleValue(NextToken(), &prob));
     SPIEL_CHECK_GE(prob, 0.0);
     SPIEL_CHECK_LE(prob, 1.0);
     prob_sum += prob;
-    child->probs.push_back(prob);
-    nodes_.push_back(NewNode());
-    child->children.push_back(nodes_.back().get());
-    chance_outcomes++;
+    owned_values_.push_back(prob);
+    NewNode(node->id, action_name);
+    node->num_children++;
   }
-  SPIEL_CHECK_GT(child->actions.size(), 0);
+  SPIEL_CHECK_GT(node->num_children, 0);
   SPIEL_CHECK_TRUE(Near(prob_sum, 1.0));
-  max_chance_outcomes_ = std::max(max_chance_outcomes_, chance_outcomes);
   SPIEL_CHECK_TRUE(NextToken() == "}");
-  SPIEL_CHECK_TRUE(absl::SimpleAtoi(NextToken(), &child->outcome_number));
+  SPIEL_CHECK_TRUE(absl::SimpleAtoi(NextToken(), &node->outcome_number));
   // Do not support optional payoffs here for now.
-
-  // Now, recurse:
-  for (Node* grand_child : child->children) {
-    RecParseSubtree(child, grand_child, depth + 1);
-  }
 }
 
-void EFGGame::ParsePlayerNode(Node* parent, Node* child, int depth) {
+void EFGGame::ParsePlayerNode(Node* node) {
   // a text string, giving the name of the node
   // a positive integer specifying the player who owns the node
   // a positive integer specifying the information set
@@ -437,45 +509,30 @@ void EFGGame::ParsePlayerNode(Node* parent, Node* child, int depth) {
   //
   // p "" 1 1 "(1,1)" { "H" "L" } 0
   SPIEL_CHECK_TRUE(NextToken() == "p");
-  max_depth_ = std::max(max_depth_, depth);
-  child->type = NodeType::kPlayer;
-  child->parent = parent;
-  SPIEL_CHECK_EQ(string_data_.at(pos_), '"');
-  child->name = NextToken();
-  SPIEL_CHECK_FALSE(string_data_.at(pos_) == '"');
-  SPIEL_CHECK_TRUE(absl::SimpleAtoi(NextToken(), &child->player_number));
-  SPIEL_CHECK_TRUE(absl::SimpleAtoi(NextToken(), &child->infoset_number));
-  infoset_num_to_states_count_[child->infoset_number] += 1;
-  if (infoset_num_to_states_count_[child->infoset_number]) {
-    perfect_information_ = false;
-  }
-  if (string_data_.at(pos_) == '"') {
-    child->infoset_name = NextToken();
+  node->type = NodeType::kPlayer;
+  SPIEL_CHECK_EQ(text_.at(pos_), '"');
+  node->name = InternString(NextToken());
+  SPIEL_CHECK_FALSE(text_.at(pos_) == '"');
+  SPIEL_CHECK_TRUE(absl::SimpleAtoi(NextToken(), &node->player_number));
+  SPIEL_CHECK_TRUE(absl::SimpleAtoi(NextToken(), &node->infoset_number));
+  node->infoset_name = kEmptyStringId;
+  if (text_.at(pos_) == '"') {
+    node->infoset_name = InternString(NextToken());
   }
   // Do not understand how the list of actions can be optional.
   SPIEL_CHECK_TRUE(NextToken() == "{");
-  int actions = 0;
-  while (string_data_.at(pos_) == '"') {
-    std::string action_str = NextToken();
-    child->actions.push_back(action_str);
-    AddActionToMap(action_str);
-    nodes_.push_back(NewNode());
-    child->children.push_back(nodes_.back().get());
-    actions++;
-  }
-  SPIEL_CHECK_GT(child->actions.size(), 0);
-  max_actions_ = std::max(max_actions_, actions);
+  node->first_child = owned_nodes_.size();
+  while (text_.at(pos_) == '"') {
+    NewNode(node->id, InternString(NextToken()));
+    node->num_children++;
+  }
+  SPIEL_CHECK_GT(node->num_children, 0);
   SPIEL_CHECK_TRUE(NextToken() == "}");
-  SPIEL_CHECK_TRUE(absl::SimpleAtoi(NextToken(), &child->outcome_number));
+  SPIEL_CHECK_TRUE(absl::SimpleAtoi(NextToken(), &node->outcome_number));
   // Do not support optional payoffs here for now.
-
-  // Now, recurse:
-  for (Node* grand_child : child->children) {
-    RecParseSubtree(child, grand_child, depth + 1);
-  }
 }
 
-void EFGGame::ParseTerminalNode(Node* parent, Node* child, int depth) {
+void EFGGame::ParseTerminalNode(Node* node) {
   // a text string, giving the name of the node
   // a nonnegative integer specifying the outcome
   // (optional) the name of the outcome
@@ -483,101 +540,255 @@ void EFGGame::ParseTerminalNode(Node* parent, Node* child, int depth) {
   //
   // t "" 1 "Outcome 1" { 10.000000 2.000000 }
   SPIEL_CHECK_TRUE(NextToken() == "t");
-  max_depth_ = std::max(max_depth_, depth);
-  child->type = NodeType::kTerminal;
-  child->parent = parent;
-  SPIEL_CHECK_EQ(string_data_.at(pos_), '"');
-  child->name = NextToken();
-  SPIEL_CHECK_TRUE(absl::SimpleAtoi(NextToken(), &child->outcome_number));
-  if (string_data_.at(pos_) == '"') {
-    child->outcome_name = NextToken();
+  node->type = NodeType::kTerminal;
+  SPIEL_CHECK_EQ(text_.at(pos_), '"');
+  node->name = InternString(NextToken());
+  SPIEL_CHECK_TRUE(absl::SimpleAtoi(NextToken(), &node->outcome_number));
+  node->outcome_name = kEmptyStringId;
+  if (text_.at(pos_) == '"') {
+    node->outcome_name = InternString(NextToken());
   }
   SPIEL_CHECK_TRUE(NextToken() == "{");
-
-  int idx = 0;
-  double util_sum = 0;
-  bool identical = true;
-  while (string_data_.at(pos_) != '}') {
+  node->values = owned_values_.size();
+  while (text_.at(pos_) != '}') {
     double utility = 0;
     SPIEL_CHECK_TRUE(ParseDoubleValue(NextToken(), &utility));
-    child->payoffs.push_back(utility);
-    util_sum += utility;
-    if (!min_util_.has_value()) {
-      min_util_ = utility;
-    }
-    if (!max_util_.has_value()) {
-      max_util_ = utility;
-    }
-    min_util_ = std::min(min_util_.value(), utility);
-    max_util_ = std::max(max_util_.value(), utility);
-
-    if (identical && idx >= 1 &&
-        Near(child->payoffs[idx - 1], child->payoffs[idx])) {
-      identical = true;
-    } else {
-      identical = false;
-    }
-
-    idx++;
+    owned_values_.push_back(utility);
   }
-  SPIEL_CHECK_EQ(child->payoffs.size(), num_players_);
+  SPIEL_CHECK_EQ(owned_values_.size() - node->values, num_players_);
   SPIEL_CHECK_TRUE(NextToken() == "}");
-
-  // Inspect the utilities to classify the utility type for this game.
-  if (!util_sum_.has_value()) {
-    util_sum_ = util_sum;
-  }
-
-  if (constant_sum_ && Near(util_sum_.value(), util_sum)) {
-    constant_sum_ = true;
-  } else {
-    constant_sum_ = false;
-  }
-
-  if (identical_payoffs_ && identical) {
-    identical_payoffs_ = true;
-  } else {
-    identical_payoffs_ = false;
-  }
 }
 
-void EFGGame::RecParseSubtree(Node* parent, Node* child, int depth) {
-  switch (string_data_.at(pos_)) {
+// The node is parsed into a copy, as parsing adds its children to the nodes.
+void EFGGame::ParseNode(int id) {
+  Node node = owned_nodes_[id];
+  switch (text_.at(pos_)) {
     case 'c':
-      ParseChanceNode(parent, child, depth);
+      ParseChanceNode(&node);
       break;
     case 'p':
-      ParsePlayerNode(parent, child, depth);
+      ParsePlayerNode(&node);
       break;
     case 't':
-      ParseTerminalNode(parent, child, depth);
+      ParseTerminalNode(&node);
       break;
     default:
       SpielFatalError(absl::StrCat("Unexpected character at pos ", pos_, ": ",
-                                   string_data_.substr(pos_, 1)));
+                                   text_.substr(pos_, 1)));
   }
+  owned_nodes_[id] = node;
 }
 
-std::string EFGGame::PrettyTree(const Node* node,
+std::string EFGGame::PrettyTree(const Node& node,
                                 const std::string& indent) const {
-  std::string str = indent + NodeToString(node);
-  for (Node* child : node->children) {
-    str += PrettyTree(child, indent + "  ");
+  std::string str = indent + NodeToString(*this, node);
+  for (int i = 0; i < node.num_children; ++i) {
+    str += PrettyTree(nodes_[node.first_child + i], indent + "  ");
   }
   return str;
 }
 
 void EFGGame::ParseGame() {
+  // The empty string, the most common, is interned up front.
+  owned_string_offsets_ = {0, 0};
+
   // Skip any initial whitespace.
-  while (IsWhiteSpace(string_data_.at(pos_))) {
+  while (IsWhiteSpace(text_.at(pos_))) {
     pos_++;
   }
-  SPIEL_CHECK_LT(pos_, string_data_.length());
+  SPIEL_CHECK_LT(pos_, text_.length());
 
   ParsePrologue();
-  nodes_.push_back(NewNode());
-  RecParseSubtree(nullptr, nodes_[0].get(), 0);
-  SPIEL_CHECK_GE(pos_, string_data_.length());
+  num_players_ = prologue_strings_.size() - 2;
+
+  // The nodes are listed in preorder. Each node adds its children to the
+  // nodes, so the children of a node have consecutive ids, and the ranges of
+  // children left to parse are kept on a stack rather than on the call
+  // stack, which deep trees would overflow.
+  NewNode(/*parent=*/-1, /*action_name=*/kEmptyStringId);
+  ParseNode(0);
+  std::vector<std::pair<int, int>> unparsed_children;
+  if (owned_nodes_[0].num_children > 0) {
+    unparsed_children.push_back({1, owned_nodes_.size()});
+  }
+  while (!unparsed_children.empty()) {
+    const int id = unparsed_children.back().first++;
+    if (id + 1 == unparsed_children.back().second) {
+      unparsed_children.pop_back();
+    }
+    ParseNode(id);
+    const Node& node = owned_nodes_[id];
+    if (node.num_children > 0) {
+      unparsed_children.push_back(
+          {node.first_child, node.first_child + node.num_children});
+    }
+  }
+  SPIEL_CHECK_GE(pos_, text_.length());
+
+  // Only the tree is kept.
+  text_ = absl::string_view();
+  string_ids_ = absl::flat_hash_map<absl::string_view, int>();
+  owned_nodes_.shrink_to_fit();
+  owned_values_.shrink_to_fit();
+  nodes_ = owned_nodes_.data();
+  num_nodes_ = owned_nodes_.size();
+  values_ = owned_values_.data();
+  num_values_ = owned_values_.size();
+  string_offsets_ = owned_string_offsets_.data();
+  string_chars_ = owned_string_chars_.data();
+  num_strings_ = owned_string_offsets_.size() - 1;
+}
+
+void EFGGame::ReadBinary() {
+  if (mapped_size_ < sizeof(BinaryHeader)) {
+    SpielFatalError(absl::StrCat(filename_, " is too short"));
+  }
+  const BinaryHeader* header =
+      reinterpret_cast<const BinaryHeader*>(mapped_data_);
+  if (header->version != kBinaryVersion || header->node_size != sizeof(Node)) {
+    SpielFatalError(
+        absl::StrCat("Unsupported version ", header->version,
+                     " or node size ", header->node_size, " of ", filename_));
+  }
+  num_players_ = header->num_players;
+  num_nodes_ = header->num_nodes;
+  num_values_ = header->num_values;
+  num_strings_ = header->num_strings;
+  const int64_t prologue_size =
+      Align((num_players_ + 2) * sizeof(int32_t));
+  const int64_t nodes_size = num_nodes_ * sizeof(Node);
+  const int64_t values_size = num_values_ * sizeof(double);
+  const int64_t offsets_size = (num_strings_ + 1) * sizeof(int64_t);
+  if (mapped_size_ != sizeof(BinaryHeader) + prologue_size + nodes_size +
+                          values_size + offsets_size + header->num_chars) {
+    SpielFatalError(absl::StrCat(filename_, " has the wrong size"));
+  }
+
+  const char* data = mapped_data_ + sizeof(BinaryHeader);
+  const int32_t* prologue_strings = reinterpret_cast<const int32_t*>(data);
+  prologue_strings_.assign(prologue_strings,
+                           prologue_strings + num_players_ + 2);
+  data += prologue_size;
+  nodes_ = reinterpret_cast<const Node*>(data);
+  data += nodes_size;
+  values_ = reinterpret_cast<const double*>(data);
+  data += values_size;
+  string_offsets_ = reinterpret_cast<const int64_t*>(data);
+  data += offsets_size;
+  string_chars_ = data;
+}
+
+void EFGGame::WriteBinary(const std::string& filename) const {
+  BinaryHeader header;
+  std::memcpy(header.magic, kBinaryMagic, sizeof(kBinaryMagic));
+  header.version = kBinaryVersion;
+  header.node_size = sizeof(Node);
+  header.num_players = num_players_;
+  header.num_nodes = num_nodes_;
+  header.num_values = num_values_;
+  header.num_strings = num_strings_;
+  header.num_chars = string_offsets_[num_strings_];
+
+  const auto write = [](file::File* file, const void* data, int64_t size) {
+    SPIEL_CHECK_TRUE(file->Write(
+        absl::string_view(static_cast<const char*>(data), size)));
+  };
+  // Written next to the file first, so that it is never seen half written.
+  const std::string tmp_filename = absl::StrCat(filename, ".tmp");
+  {
+    file::File file(tmp_filename, "wb");
+    write(&file, &header, sizeof(header));
+    std::vector<int32_t> prologue_strings(
+        Align((num_players_ + 2) * sizeof(int32_t)) / sizeof(int32_t), 0);
+    std::copy(prologue_strings_.begin(), prologue_strings_.end(),
+              prologue_strings.begin());
+    write(&file, prologue_strings.data(),
+          prologue_strings.size() * sizeof(int32_t));
+    write(&file, nodes_, num_nodes_ * sizeof(Node));
+    write(&file, values_, num_values_ * sizeof(double));
+    write(&file, string_offsets_, (num_strings_ + 1) * sizeof(int64_t));
+    write(&file, string_chars_, header.num_chars);
+    SPIEL_CHECK_TRUE(file.Flush());
+  }
+  if (std::rename(tmp_filename.c_str(), filename.c_str()) != 0) {
+    SpielFatalError(absl::StrCat("Could not write ", filename));
+  }
+}
+
+// Gathers the facts about the game from the tree, visiting it in preorder
+// like the parser does.
+void EFGGame::AnalyzeTree() {
+  name_ = std::string(GetString(prologue_strings_[0]));
+  description_ = std::string(GetString(prologue_strings_[1]));
+  player_names_.clear();
+  for (int p = 0; p < num_players_; ++p) {
+    player_names_.push_back(std::string(GetString(prologue_strings_[p + 2])));
+  }
+
+  std::vector<std::pair<int, int>> stack = {{0, 0}};  // Node ids and depths.
+  while (!stack.empty()) {
+    const auto [id, depth] = stack.back();
+    stack.pop_back();
+    const Node& node = nodes_[id];
+    max_depth_ = std::max(max_depth_, depth);
+    if (node.type == NodeType::kChance) {
+      num_chance_nodes_++;
+      max_chance_outcomes_ = std::max(max_chance_outcomes_, node.num_children);
+    } else if (node.type == NodeType::kPlayer) {
+      infoset_num_to_states_count_[node.infoset_number] += 1;
+      if (infoset_num_to_states_count_[node.infoset_number]) {
+        perfect_information_ = false;
+      }
+      for (int i = 0; i < node.num_children; ++i) {
+        AddActionToMap(std::string(
+            GetString(nodes_[node.first_child + i].action_name)));
+      }
+      max_actions_ = std::max(max_actions_, node.num_children);
+    } else {
+      double util_sum = 0;
+      bool identical = true;
+      for (int idx = 0; idx < num_players_; ++idx) {
+        const double utility = values_[node.values + idx];
+        util_sum += utility;
+        if (!min_util_.has_value()) {
+          min_util_ = utility;
+        }
+        if (!max_util_.has_value()) {
+          max_util_ = utility;
+        }
+        min_util_ = std::min(min_util_.value(), utility);
+        max_util_ = std::max(max_util_.value(), utility);
+
+        if (identical && idx >= 1 &&
+            Near(values_[node.values + idx - 1], utility)) {
+          identical = true;
+        } else {
+          identical = false;
+        }
+      }
+
+      // Inspect the utilities to classify the utility type for this game.
+      if (!util_sum_.has_value()) {
+        util_sum_ = util_sum;
+      }
+
+      if (constant_sum_ && Near(util_sum_.value(), util_sum)) {
+        constant_sum_ = true;
+      } else {
+        constant_sum_ = false;
+      }
+
+      if (identical_payoffs_ && identical) {
+        identical_payoffs_ = true;
+      } else {
+        identical_payoffs_ = false;
+      }
+    }
+    // The children are pushed last to first, to be visited first to last.
+    for (int i = node.num_children - 1; i >= 0; --i) {
+      stack.push_back({node.first_child + i, depth + 1});
+    }
+  }
 
   // Modify the game type.
   if (num_chance_nodes_ > 0) {
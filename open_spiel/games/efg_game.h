@@ -15,12 +15,15 @@
 #ifndef OPEN_SPIEL_GAMES_EFG_GAME_H_
 #define OPEN_SPIEL_GAMES_EFG_GAME_H_
 
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "open_spiel/abseil-cpp/absl/container/flat_hash_map.h"
+#include "open_spiel/abseil-cpp/absl/strings/string_view.h"
 #include "open_spiel/game_parameters.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
@@ -35,6 +38,12 @@
 //   - Payoffs / outcomes at non-terminal nodes are not supported
 //   - Player nodes and chance nodes must each have one child
 //
+// The file is mapped and tokenized in place, and the tree is kept in a few
+// flat arrays, with the strings interned, so that large trees take little
+// more memory than the file. EFGGame::WriteBinary saves these arrays, and a
+// file so written can be given as the filename to map them back directly,
+// instead of parsing the text again.
+//
 
 namespace open_spiel {
 namespace efg_game {
@@ -45,21 +54,28 @@ enum class NodeType {
   kTerminal,
 };
 
-// A node object that represent a subtree of the game.
+// A node of the game tree. The game keeps the nodes in an array indexed by
+// their ids, in which the children of a node are consecutive, and the
+// strings in a table (see EFGGame::GetString).
 struct Node {
-  Node* parent;
   NodeType type;
   int id;
-  std::string name;
-  int infoset_number;
+  int parent;  // -1 for the root.
   int player_number;
-  std::string infoset_name;
-  std::string outcome_name;
+  int infoset_number;
   int outcome_number;
-  std::vector<std::string> actions;
-  std::vector<Node*> children;
-  std::vector<double> probs;
-  std::vector<double> payoffs;
+  int first_child;
+  int num_children;
+  // Ids of strings. The action name is that of the action of the parent
+  // leading to this node.
+  int name;
+  int infoset_name;
+  int outcome_name;
+  int action_name;
+  // The index of the first of the game's values for this node: the
+  // probabilities of the children of a chance node, or the payoffs of a
+  // terminal node.
+  int64_t values;
 };
 
 // A function to load an EFG directly from string data. Note: games loaded
@@ -67,6 +83,8 @@ struct Node {
 // the general LoadGame with the filename argument if serialization is required.
 std::shared_ptr<const Game> LoadEFGGame(const std::string& data);
 
+class EFGGame;
+
 class EFGState : public State {
  public:
   explicit EFGState(std::shared_ptr<const Game> game, const Node* root);
@@ -79,6 +97,7 @@ class EFGState : public State {
   std::string ObservationString(Player player) const override;
   std::unique_ptr<State> Clone() const override;
   void UndoAction(Player player, Action action) override;
+  bool SupportsUndoAction() const override { return true; }
   std::vector<Action> LegalActions() const override;
   std::vector<std::pair<Action, double>> ChanceOutcomes() const override;
 
@@ -86,6 +105,7 @@ class EFGState : public State {
   void DoApplyAction(Action action) override;
 
  private:
+  const EFGGame* efg_game_;
   const Node* cur_node_;
 };
 
@@ -93,9 +113,9 @@ class EFGGame : public Game {
  public:
   explicit EFGGame(const GameParameters& params);
   explicit EFGGame(const std::string& data);
+  ~EFGGame();
   std::unique_ptr<State> NewInitialState() const override {
-    return std::unique_ptr<State>(
-        new EFGState(shared_from_this(), nodes_[0].get()));
+    return std::unique_ptr<State>(new EFGState(shared_from_this(), nodes_));
   }
 
   int NumDistinctActions() const override;
@@ -127,24 +147,60 @@ class EFGGame : public Game {
     action_ids_[label] = action_ids_.size();
   }
 
+  int NumNodes() const { return num_nodes_; }
+  const Node& GetNode(int id) const { return nodes_[id]; }
+  absl::string_view GetString(int id) const {
+    return absl::string_view(string_chars_ + string_offsets_[id],
+                             string_offsets_[id + 1] - string_offsets_[id]);
+  }
+  double GetValue(int64_t index) const { return values_[index]; }
+
+  // Saves the parsed tree, to be mapped back by loading the game with this
+  // filename. The numbers are in the byte order of this machine.
+  void WriteBinary(const std::string& filename) const;
+
  private:
-  std::unique_ptr<Node> NewNode() const;
+  int NewNode(int parent, int action_name);
+  int InternString(absl::string_view str);
   void ParseGame();
   void ParsePrologue();
-  std::string NextToken();
-  bool ParseDoubleValue(const std::string& str, double* value) const;
+  absl::string_view NextToken();
+  bool ParseDoubleValue(absl::string_view str, double* value) const;
   bool IsWhiteSpace(char c) const;
   bool IsNodeToken(char c) const;
-  void ParseChanceNode(Node* parent, Node* child, int depth);
-  void ParsePlayerNode(Node* parent, Node* child, int depth);
-  void ParseTerminalNode(Node* parent, Node* child, int depth);
-  void RecParseSubtree(Node* parent, Node* child, int depth);
-  std::string PrettyTree(const Node* node, const std::string& indent) const;
+  void ParseChanceNode(Node* node);
+  void ParsePlayerNode(Node* node);
+  void ParseTerminalNode(Node* node);
+  void ParseNode(int id);
+  void ReadBinary();
+  void AnalyzeTree();
+  std::string PrettyTree(const Node& node, const std::string& indent) const;
 
   std::string filename_;
   std::string string_data_;
-  int pos_;
-  std::vector<std::unique_ptr<Node>> nodes_;
+
+  // The text being parsed, and the position in it.
+  absl::string_view text_;
+  int64_t pos_;
+  absl::flat_hash_map<absl::string_view, int> string_ids_;
+
+  // The tree, either owned by the game or mapped from a binary file.
+  std::vector<Node> owned_nodes_;
+  std::vector<double> owned_values_;
+  std::vector<int64_t> owned_string_offsets_;
+  std::string owned_string_chars_;
+  const char* mapped_data_ = nullptr;
+  int64_t mapped_size_ = 0;
+  const Node* nodes_ = nullptr;
+  int num_nodes_ = 0;
+  const double* values_ = nullptr;
+  int64_t num_values_ = 0;
+  const int64_t* string_offsets_ = nullptr;  // One more than the strings.
+  const char* string_chars_ = nullptr;
+  int num_strings_ = 0;
+  // The ids of the name, the description and the player names.
+  std::vector<int> prologue_strings_;
+
   std::string name_;
   std::string description_;
   std::vector<std::string> player_names_;
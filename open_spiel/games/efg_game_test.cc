@@ -18,10 +18,12 @@
 #include <memory>
 #include <optional>
 
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
 #include "open_spiel/games/efg_game_data.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
 #include "open_spiel/tests/basic_tests.h"
+#include "open_spiel/utils/file.h"
 
 namespace open_spiel {
 namespace efg_game {
@@ -119,6 +121,51 @@ void EFGGameSimTestsSignalingFromFile() {
   }
 }
 
+// Checks that the two states, and all those below them, are the same.
+void CheckSameSubtrees(const State& state1, const State& state2) {
+  SPIEL_CHECK_EQ(state1.ToString(), state2.ToString());
+  SPIEL_CHECK_EQ(state1.LegalActions(), state2.LegalActions());
+  if (state1.IsTerminal()) {
+    SPIEL_CHECK_EQ(state1.Returns(), state2.Returns());
+    return;
+  }
+  if (state1.IsChanceNode()) {
+    SPIEL_CHECK_TRUE(state1.ChanceOutcomes() == state2.ChanceOutcomes());
+  } else {
+    for (Player player = 0; player < state1.NumPlayers(); ++player) {
+      SPIEL_CHECK_EQ(state1.InformationStateString(player),
+                     state2.InformationStateString(player));
+    }
+  }
+  for (Action action : state1.LegalActions()) {
+    SPIEL_CHECK_EQ(state1.ActionToString(action),
+                   state2.ActionToString(action));
+    CheckSameSubtrees(*state1.Child(action), *state2.Child(action));
+  }
+}
+
+void EFGGameBinaryTests() {
+  const std::string filename =
+      absl::StrCat(file::GetTmpDir(), "/open_spiel-test-", std::rand(),  // NOLINT
+                   "-signaling.efgb");
+  std::shared_ptr<const Game> game = LoadEFGGame(GetSignalingEFGData());
+  static_cast<const EFGGame&>(*game).WriteBinary(filename);
+  std::shared_ptr<const Game> mapped_game =
+      LoadGame("efg_game", {{"filename", GameParameter(filename)}});
+  SPIEL_CHECK_TRUE(mapped_game->GetType().chance_mode ==
+                   game->GetType().chance_mode);
+  SPIEL_CHECK_TRUE(mapped_game->GetType().information ==
+                   game->GetType().information);
+  SPIEL_CHECK_TRUE(mapped_game->GetType().utility == game->GetType().utility);
+  SPIEL_CHECK_EQ(mapped_game->NumDistinctActions(), game->NumDistinctActions());
+  SPIEL_CHECK_EQ(mapped_game->MaxGameLength(), game->MaxGameLength());
+  SPIEL_CHECK_EQ(mapped_game->MinUtility(), game->MinUtility());
+  SPIEL_CHECK_EQ(mapped_game->MaxUtility(), game->MaxUtility());
+  CheckSameSubtrees(*game->NewInitialState(), *mapped_game->NewInitialState());
+  testing::RandomSimTest(*mapped_game, 100);
+  SPIEL_CHECK_TRUE(file::Remove(filename));
+}
+
 }  // namespace
 }  // namespace efg_game
 }  // namespace open_spiel
@@ -130,4 +177,5 @@ int main(int argc, char** argv) {
   open_spiel::efg_game::EFGGameSimTestsKuhnFromFile();
   open_spiel::efg_game::EFGGameSimTestsSignalingFromData();
   open_spiel::efg_game::EFGGameSimTestsSignalingFromFile();
+  open_spiel::efg_game::EFGGameBinaryTests();
 }
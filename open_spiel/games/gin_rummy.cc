@@ -15,8 +15,11 @@
 #include "open_spiel/games/gin_rummy.h"
 
 #include <algorithm>
+#include <functional>
 #include <map>
+#include <memory>
 #include <utility>
+#include <vector>
 
 #include "open_spiel/abseil-cpp/absl/algorithm/container.h"
 #include "open_spiel/abseil-cpp/absl/strings/str_format.h"
@@ -29,6 +32,14 @@ namespace open_spiel {
 namespace gin_rummy {
 namespace {
 
+// Swaps proposed between the hidden hand of a knocker and the stock when
+// resampling it, see ResampleFromInfostate.
+constexpr int kNumResampleSwaps = 200;
+
+int RandomIndex(int size, const std::function<double()>& rng) {
+  return std::min<int>(rng() * size, size - 1);
+}
+
 const GameType kGameType{
     /*short_name=*/"gin_rummy",
     /*long_name=*/"Gin Rummy",
@@ -437,6 +448,124 @@ std::vector<std::pair<Action, double>> GinRummyState::ChanceOutcomes() const {
   return outcomes;
 }
 
+// Uniform over the stock, picked without listing it.
+std::pair<Action, double> GinRummyState::SampleChanceOutcome(double z) const {
+  SPIEL_CHECK_TRUE(IsChanceNode());
+  int index = std::min<int>(z * stock_size_, stock_size_ - 1);
+  for (int card = 0; card < kNumCards; ++card) {
+    if (deck_[card] && index-- == 0) return {card, 1.0 / stock_size_};
+  }
+  SpielFatalError("The stock is empty.");
+}
+
+std::unique_ptr<State> GinRummyState::ResampleFromInfostate(
+    int player_id, std::function<double()> rng) const {
+  // The player sees every card except those the opponent was dealt or drew
+  // from the stock, and the stock. Those are dealt again, with each card the
+  // opponent went on to discard, meld or lay off dealt to them before it was
+  // shown: the cards are placed from the one shown first, each among the
+  // opponent's deals before it, which leaves the most room for the rest. The
+  // opponent's other hidden deals take random cards from the remaining ones.
+  const Player opponent = Opponent(player_id);
+  std::vector<int> hidden_deals;  // History indices.
+  std::vector<std::pair<int, int>> shown;  // Index when shown, card.
+  std::vector<bool> is_hidden(kNumCards, false);
+  std::unique_ptr<State> replay = game_->NewInitialState();
+  auto& replay_state = static_cast<GinRummyState&>(*replay);
+  for (int i = 0; i < history_.size(); ++i) {
+    const Action action = history_[i];
+    if (!replay_state.IsChanceNode() && replay_state.cur_player_ == opponent) {
+      std::vector<int> cards;
+      if (action < kNumCards) {
+        cards = {static_cast<int>(action)};
+      } else if (action >= kMeldActionBase) {
+        cards = int_to_meld.at(action - kMeldActionBase);
+      }
+      for (int card : cards) {
+        if (is_hidden[card]) shown.emplace_back(i, card);
+        is_hidden[card] = false;
+      }
+    }
+    const bool is_deal = replay_state.IsChanceNode();
+    replay_state.ApplyAction(action);
+    if (is_deal && absl::c_linear_search(replay_state.hands_[opponent],
+                                         static_cast<int>(action))) {
+      hidden_deals.push_back(i);
+      is_hidden[action] = true;
+    }
+  }
+
+  // The opponent's cards not shown yet, and the stock.
+  std::vector<int> hand;
+  std::vector<int> known_hand;
+  for (int card : hands_[opponent]) {
+    (is_hidden[card] ? hand : known_hand).push_back(card);
+  }
+  std::vector<int> stock;
+  for (int card = 0; card < kNumCards; ++card) {
+    if (deck_[card]) stock.push_back(card);
+  }
+
+  // A knocker's hand must still make the knock. It is sampled by random swaps
+  // with the stock which keep it legal, from the hand it really is; otherwise
+  // it is any of the cards left.
+  if (knocked_[opponent] &&
+      (phase_ == Phase::kKnock || phase_ == Phase::kLayoff)) {
+    auto is_legal = [&](const std::vector<int>& cards) {
+      std::vector<int> full_hand = known_hand;
+      full_hand.insert(full_hand.end(), cards.begin(), cards.end());
+      if (phase_ == Phase::kKnock) {
+        return MinDeadwood(full_hand) <= knock_card_;
+      }
+      const int deadwood = TotalCardValue(full_hand);
+      return deadwood <= knock_card_ &&
+             (deadwood == 0) == (deadwood_[opponent] == 0);
+    };
+    for (int i = 0; i < kNumResampleSwaps && !hand.empty() && !stock.empty();
+         ++i) {
+      const int h = RandomIndex(hand.size(), rng);
+      const int s = RandomIndex(stock.size(), rng);
+      std::swap(hand[h], stock[s]);
+      if (!is_legal(hand)) std::swap(hand[h], stock[s]);
+    }
+  } else {
+    std::vector<int> pool = hand;
+    pool.insert(pool.end(), stock.begin(), stock.end());
+    for (int i = 0; i < hand.size(); ++i) {
+      std::swap(pool[i], pool[i + RandomIndex(pool.size() - i, rng)]);
+      hand[i] = pool[i];
+    }
+  }
+
+  std::vector<std::optional<int>> deals(hidden_deals.size());
+  std::sort(shown.begin(), shown.end());
+  for (const auto& [index, card] : shown) {
+    std::vector<int> free;
+    for (int d = 0; d < hidden_deals.size() && hidden_deals[d] < index; ++d) {
+      if (!deals[d].has_value()) free.push_back(d);
+    }
+    SPIEL_CHECK_FALSE(free.empty());
+    deals[free[RandomIndex(free.size(), rng)]] = card;
+  }
+  for (std::optional<int>& deal : deals) {
+    if (deal.has_value()) continue;
+    const int h = RandomIndex(hand.size(), rng);
+    deal = hand[h];
+    hand[h] = hand.back();
+    hand.pop_back();
+  }
+
+  std::unique_ptr<State> state = game_->NewInitialState();
+  for (int i = 0, d = 0; i < history_.size(); ++i) {
+    if (d < hidden_deals.size() && hidden_deals[d] == i) {
+      state->ApplyAction(*deals[d++]);
+    } else {
+      state->ApplyAction(history_[i]);
+    }
+  }
+  return state;
+}
+
 std::string GinRummyState::ActionToString(Player player, Action action) const {
   if (player == kChancePlayerId) {
     return absl::StrCat("Chance outcome: ", CardString(action));
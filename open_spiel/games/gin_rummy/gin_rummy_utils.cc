@@ -15,11 +15,15 @@
 #include "open_spiel/games/gin_rummy/gin_rummy_utils.h"
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
+#include <optional>
 #include <set>
 #include <utility>
 
 #include "open_spiel/abseil-cpp/absl/algorithm/container.h"
 #include "open_spiel/spiel.h"
+#include "open_spiel/utils/clock_cache.h"
 
 namespace open_spiel {
 namespace gin_rummy {
@@ -290,17 +294,132 @@ VecVecVecInt AllMeldGroups(const VecInt &cards) {
   return all_meld_groups;
 }
 
+uint64_t CardMask(const VecInt &cards) {
+  uint64_t mask = 0;
+  for (int card : cards) mask |= uint64_t{1} << card;
+  return mask;
+}
+
+namespace {
+
+// The number of hands whose best meld value is cached.
+constexpr int kMeldValueCacheSize = 1 << 16;
+
+int MaskValue(uint64_t cards) {
+  int value = 0;
+  for (; cards; cards &= cards - 1) value += CardValue(__builtin_ctzll(cards));
+  return value;
+}
+
+// The melds as bitmasks, by id, with their values, and the ids of the melds
+// by their lowest card.
+struct MeldTables {
+  std::array<uint64_t, kNumMeldIds> masks;
+  std::array<int, kNumMeldIds> values;
+  std::array<VecInt, kNumCards> ids_by_lowest_card;
+};
+
+const MeldTables &GetMeldTables() {
+  static const MeldTables *tables = [] {
+    auto *tables = new MeldTables();
+    for (int meld_id = 0; meld_id < kNumMeldIds; ++meld_id) {
+      const uint64_t mask = CardMask(int_to_meld.at(meld_id));
+      tables->masks[meld_id] = mask;
+      tables->values[meld_id] = MaskValue(mask);
+      tables->ids_by_lowest_card[__builtin_ctzll(mask)].push_back(meld_id);
+    }
+    return tables;
+  }();
+  return *tables;
+}
+
+// The cards which are part of at least one meld of the cards. The others are
+// deadwood in every meld group.
+uint64_t MeldableCards(const MeldTables &tables, uint64_t cards) {
+  uint64_t meldable = 0;
+  for (uint64_t rest = cards; rest; rest &= rest - 1) {
+    for (int meld_id : tables.ids_by_lowest_card[__builtin_ctzll(rest)]) {
+      const uint64_t meld = tables.masks[meld_id];
+      if ((meld & ~cards) == 0) meldable |= meld;
+    }
+  }
+  return meldable;
+}
+
+// Depth first search for the best meld group: the lowest card is either left
+// as deadwood, or put in one of the melds it is the lowest card of.
+int SearchMaxMeldValue(const MeldTables &tables, uint64_t cards) {
+  if (cards == 0) return 0;
+  const uint64_t rest = cards & (cards - 1);
+  int best = SearchMaxMeldValue(tables, rest);
+  for (int meld_id : tables.ids_by_lowest_card[__builtin_ctzll(cards)]) {
+    const uint64_t meld = tables.masks[meld_id];
+    if ((meld & ~cards) != 0) continue;
+    best = std::max(best, tables.values[meld_id] +
+                              SearchMaxMeldValue(tables, cards & ~meld));
+  }
+  return best;
+}
+
+// See MinDeadwood.
+int MaskMinDeadwood(uint64_t cards) {
+  const int total_value = MaskValue(cards);
+  if (__builtin_popcountll(cards) != kMaxHandSize) {
+    return total_value - MaxMeldValue(cards);
+  }
+  // If we have 11 cards we can discard one.
+  int min_deadwood = total_value;
+  for (uint64_t rest = cards; rest; rest &= rest - 1) {
+    const int card = __builtin_ctzll(rest);
+    const uint64_t hand = cards & ~(uint64_t{1} << card);
+    min_deadwood = std::min(
+        min_deadwood, total_value - CardValue(card) - MaxMeldValue(hand));
+  }
+  return min_deadwood;
+}
+
+}  // namespace
+
+uint64_t MeldMask(int meld_id) {
+  SPIEL_CHECK_GE(meld_id, 0);
+  SPIEL_CHECK_LT(meld_id, kNumMeldIds);
+  return GetMeldTables().masks[meld_id];
+}
+
+// Only the cards which can be melded matter, so they are the key of the cache.
+int MaxMeldValue(uint64_t cards) {
+  static auto *cache = new ClockCache<uint64_t, int>(kMeldValueCacheSize);
+  const MeldTables &tables = GetMeldTables();
+  cards = MeldableCards(tables, cards);
+  if (cards == 0) return 0;
+  if (std::optional<const int> value = cache->Get(cards)) return *value;
+  return cache->Insert(cards, SearchMaxMeldValue(tables, cards));
+}
+
 // "Best" means any meld group that achieves the lowest possible deadwood
 // count for the given cards. In general this is non-unique.
 VecVecInt BestMeldGroup(const VecInt &cards) {
-  int best_meld_group_total_value = 0;
+  const MeldTables &tables = GetMeldTables();
   VecVecInt best_meld_group;
-  VecVecVecInt all_meld_groups = AllMeldGroups(cards);
-  for (const auto &meld_group : all_meld_groups) {
-    int meld_group_total_value = TotalCardValue(meld_group);
-    if (meld_group_total_value > best_meld_group_total_value) {
-      best_meld_group_total_value = meld_group_total_value;
-      best_meld_group = meld_group;
+  uint64_t rest = MeldableCards(tables, CardMask(cards));
+  int value = MaxMeldValue(rest);
+  // Follows the search down the branches which reach the best value.
+  while (value > 0) {
+    const int card = __builtin_ctzll(rest);
+    if (SearchMaxMeldValue(tables, rest & (rest - 1)) == value) {
+      rest &= rest - 1;
+      continue;
+    }
+    for (int meld_id : tables.ids_by_lowest_card[card]) {
+      const uint64_t meld = tables.masks[meld_id];
+      if ((meld & ~rest) == 0 &&
+          tables.values[meld_id] + SearchMaxMeldValue(tables, rest & ~meld) ==
+              value) {
+        best_meld_group.push_back(int_to_meld.at(meld_id));
+        rest &= ~meld;
+        value -= tables.values[meld_id];
+        break;
+      }
     }
   }
   return best_meld_group;
@@ -312,26 +431,9 @@ int MinDeadwood(VecInt hand, std::optional<int> card) {
   return MinDeadwood(hand);
 }
 
-// Minimum deadwood count over all meld groups.
-int MinDeadwood(const VecInt &hand) {
-  VecInt deadwood = hand;
-  VecVecInt best_melds = BestMeldGroup(hand);
-
-  for (const auto &meld : best_melds) {
-    for (auto card : meld) {
-      deadwood.erase(std::remove(deadwood.begin(), deadwood.end(), card),
-                     deadwood.end());
-    }
-  }
-  // If we have 11 cards we can discard one.
-  if (hand.size() == kMaxHandSize && !deadwood.empty()) {
-    absl::c_sort(deadwood, CompareRanks);
-    deadwood.pop_back();
-  }
-  int deadwood_total = 0;
-  for (int card : deadwood) deadwood_total += CardValue(card);
-  return deadwood_total;
-}
+// Minimum deadwood count over all meld groups. With 11 cards, this is after
+// discarding the card leaving the least deadwood.
+int MinDeadwood(const VecInt &hand) { return MaskMinDeadwood(CardMask(hand)); }
 
 // Returns the one card that can be layed off on a three card rank meld.
 int RankMeldLayoff(const VecInt &meld) {
@@ -365,19 +467,24 @@ VecInt SuitMeldLayoffs(const VecInt &meld) {
 // melds leaves only the 8d for 8 points.
 // Returns vector of meld_ids (see MeldToInt).
 VecInt LegalMelds(const VecInt &hand, int knock_card) {
-  int total_hand_value = TotalCardValue(hand);
-  std::set<int> meld_set;
-  VecInt hand_(hand);
-  VecVecVecInt all_meld_groups = AllMeldGroups(hand_);
-  for (const auto &meld_group : all_meld_groups) {
-    int meld_group_total_value = TotalCardValue(meld_group);
-    if (total_hand_value - meld_group_total_value <= knock_card) {
-      for (const auto &meld : meld_group) {
-        meld_set.insert(meld_to_int.at(meld));
+  // A meld is in a meld group leaving at most knock_card deadwood if the best
+  // meld group of the other cards does, once the meld is added to it.
+  const MeldTables &tables = GetMeldTables();
+  const uint64_t cards = CardMask(hand);
+  const int min_meld_value = TotalCardValue(hand) - knock_card;
+  VecInt legal_melds;
+  for (uint64_t rest = cards; rest; rest &= rest - 1) {
+    for (int meld_id : tables.ids_by_lowest_card[__builtin_ctzll(rest)]) {
+      const uint64_t meld = tables.masks[meld_id];
+      if ((meld & ~cards) == 0 &&
+          tables.values[meld_id] + MaxMeldValue(cards & ~meld) >=
+              min_meld_value) {
+        legal_melds.push_back(meld_id);
       }
     }
   }
-  return VecInt(meld_set.begin(), meld_set.end());
+  absl::c_sort(legal_melds);
+  return legal_melds;
 }
 
 // Returns the legal discards when a player has knocked. Normally a player can
@@ -385,16 +492,15 @@ VecInt LegalMelds(const VecInt &hand, int knock_card) {
 // discard a card that preseves the ability to arrange the hand so that the
 // total deadwood is less than the knock card.
 VecInt LegalDiscards(const VecInt &hand, int knock_card) {
-  std::set<int> legal_discards;
-  for (int i = 0; i < hand.size(); ++i) {
-    VecInt hand_(hand);
-    hand_.erase(hand_.begin() + i);
-    int deadwood = MinDeadwood(hand_);
-    if (deadwood <= knock_card) {
-      legal_discards.insert(hand[i]);
+  const uint64_t cards = CardMask(hand);
+  VecInt legal_discards;
+  for (uint64_t rest = cards; rest; rest &= rest - 1) {
+    const int card = __builtin_ctzll(rest);
+    if (MaskMinDeadwood(cards & ~(uint64_t{1} << card)) <= knock_card) {
+      legal_discards.push_back(card);
     }
   }
-  return VecInt(legal_discards.begin(), legal_discards.end());
+  return legal_discards;
 }
 
 VecInt AllLayoffs(const VecInt &layed_melds, const VecInt &previous_layoffs) {
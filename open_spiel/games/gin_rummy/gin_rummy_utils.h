@@ -15,7 +15,9 @@
 #ifndef OPEN_SPIEL_GAMES_GIN_RUMMY_UTILS_H_
 #define OPEN_SPIEL_GAMES_GIN_RUMMY_UTILS_H_
 
+#include <cstdint>
 #include <map>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -26,6 +28,7 @@ inline constexpr int kNumSuits = 4;
 inline constexpr int kNumRanks = 13;
 inline constexpr int kNumCards = kNumSuits * kNumRanks;
 inline constexpr int kMaxHandSize = 11;
+inline constexpr int kNumMeldIds = 185;
 
 using VecInt = std::vector<int>;
 using VecVecInt = std::vector<std::vector<int>>;
@@ -69,6 +72,18 @@ VecVecInt BestMeldGroup(const VecInt &cards);
 int MinDeadwood(VecInt hand, std::optional<int> card);
 int MinDeadwood(const VecInt &hand);
 
+// The deadwood computations also work on sets of cards as bitmasks, with bit i
+// set for card i.
+uint64_t CardMask(const VecInt &cards);
+
+// The bitmask of the meld with this id (see MeldToInt).
+uint64_t MeldMask(int meld_id);
+
+// The largest total value of non-overlapping melds of the cards, i.e. that of
+// the best meld groups. The results are cached, as the same hands are scored
+// many times over a game.
+int MaxMeldValue(uint64_t cards);
+
 int RankMeldLayoff(const VecInt &meld);
 VecInt SuitMeldLayoffs(const VecInt &meld);
 
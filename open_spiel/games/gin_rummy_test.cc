@@ -28,6 +28,7 @@ namespace testing = open_spiel::testing;
 void BasicGameTests() {
   testing::LoadGameTest("gin_rummy");
   testing::RandomSimTest(*LoadGame("gin_rummy"), 10);
+  testing::ResampleInfostateTest(*LoadGame("gin_rummy"), /*num_sims=*/10);
 }
 
 void MeldTests() {
@@ -125,6 +126,43 @@ void MeldTests() {
   SPIEL_CHECK_EQ(deadwood, 3);
 }
 
+void DeadwoodTests() {
+  for (int meld_id = 0; meld_id < kNumMeldIds; ++meld_id) {
+    SPIEL_CHECK_EQ(MeldMask(meld_id), CardMask(int_to_meld.at(meld_id)));
+  }
+
+  // +--------------------------+
+  // |  2s3s4s5s                |
+  // |  2c3c  5c                |
+  // |  2d                      |
+  // |    3h4h5h                |
+  // +--------------------------+
+  // Several meld groups leave 8 deadwood, but only 2s2c2d, 3s4s5s, 3h4h5h
+  // leaves 3c5c, and so 3 deadwood after discarding the 5c.
+  std::vector<std::string> cards = {"2s", "3s", "4s", "5s", "2c", "3c",
+                                    "5c", "2d", "3h", "4h", "5h"};
+  std::vector<int> card_ints = CardStringsToCardInts(cards);
+  SPIEL_CHECK_EQ(MaxMeldValue(CardMask(card_ints)), 30);
+  SPIEL_CHECK_EQ(TotalCardValue(BestMeldGroup(card_ints)), 30);
+  SPIEL_CHECK_EQ(MinDeadwood(card_ints), 3);
+  SPIEL_CHECK_EQ(LegalDiscards(card_ints, 3),
+                 CardStringsToCardInts({"5c"}));
+
+  // Without the 5c, the 5s5c5h meld is gone, and the other melds of the
+  // best meld group are the only ones leaving at most 3 deadwood.
+  card_ints.erase(absl::c_find(card_ints, CardInt("5c")));
+  VecInt legal_melds;
+  for (const std::vector<std::string>& meld :
+       {std::vector<std::string>{"2s", "2c", "2d"},
+        std::vector<std::string>{"3s", "4s", "5s"},
+        std::vector<std::string>{"3h", "4h", "5h"}}) {
+    legal_melds.push_back(meld_to_int.at(CardStringsToCardInts(meld)));
+  }
+  absl::c_sort(legal_melds);
+  SPIEL_CHECK_EQ(MinDeadwood(card_ints), 3);
+  SPIEL_CHECK_EQ(LegalMelds(card_ints, 3), legal_melds);
+}
+
 // An extremely rare situation, but one that does arise in actual gameplay.
 // Tests both layoff and undercut functionality.
 void GameplayTest1() {
@@ -539,6 +577,7 @@ void OklahomaTest() {
 int main(int argc, char** argv) {
   open_spiel::gin_rummy::BasicGameTests();
   open_spiel::gin_rummy::MeldTests();
+  open_spiel::gin_rummy::DeadwoodTests();
   open_spiel::gin_rummy::GameplayTest1();
   open_spiel::gin_rummy::GameplayTest2();
   open_spiel::gin_rummy::GameplayTest3();
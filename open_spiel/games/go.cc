@@ -14,7 +14,10 @@
 
 #include "open_spiel/games/go.h"
 
+#include <algorithm>
 #include <sstream>
+#include <utility>
+#include <vector>
 
 #include "open_spiel/game_parameters.h"
 #include "open_spiel/games/go/go_board.h"
@@ -45,7 +48,8 @@ const GameType kGameType{
         {"board_size", GameParameter(19)},
         {"handicap", GameParameter(0)},
     },
-};
+    /*default_loadable=*/true,
+    /*hash_determines_observation=*/true};
 
 std::shared_ptr<const Game> Factory(const GameParameters& params) {
   return std::shared_ptr<const Game>(new GoGame(params));
@@ -75,6 +79,11 @@ std::vector<VirtualPoint> HandicapStones(int num_handicap) {
   return points;
 }
 
+// Zobrist keys for the parts of the state that are not on the board.
+constexpr uint64_t kWhiteToPlayKey = 0x3c6ef372fe94f82bULL;
+constexpr uint64_t kLastMovePassKey = 0xa54ff53a5f1d36f1ULL;
+constexpr uint64_t kSuperkoKey = 0x510e527fade682d1ULL;
+
 }  // namespace
 
 GoState::GoState(std::shared_ptr<const Game> game, int board_size, float komi,
@@ -103,34 +112,82 @@ void GoState::ObservationTensor(int player, std::vector<double>* values) const {
   SPIEL_CHECK_GE(player, 0);
   SPIEL_CHECK_LT(player, num_players_);
 
-  int num_cells = board_.board_size() * board_.board_size();
-  values->resize(num_cells * (CellStates() + 1));
-  std::fill(values->begin(), values->end(), 0.);
+  // The stone planes, then a fourth binary plane for komi (whether white is
+  // to play).
+  const int num_cells = board_.board_size() * board_.board_size();
+  values->assign(stone_planes_.begin(), stone_planes_.end());
+  values->resize(num_cells * (CellStates() + 1),
+                 to_play_ == GoColor::kWhite ? 1.0 : 0.0);
+}
 
-  // Add planes: black, white, empty.
-  int cell = 0;
-  for (VirtualPoint p : BoardPoints(board_.board_size())) {
-    int color_val = static_cast<int>(board_.PointColor(p));
-    (*values)[num_cells * color_val + cell] = 1.0;
-    ++cell;
+bool GoState::UpdateObservationTensor(int player,
+                                      absl::Span<float> values) const {
+  SPIEL_CHECK_GE(player, 0);
+  SPIEL_CHECK_LT(player, num_players_);
+  SPIEL_CHECK_FALSE(history_.empty());
+
+  const int board_size = board_.board_size();
+  const int num_cells = board_size * board_size;
+  SPIEL_CHECK_EQ(values.size(), num_cells * (CellStates() + 1));
+  const VirtualPoint point = board_.ActionToVirtualAction(history_.back());
+  if (point != kVirtualPass) {
+    // The changed cells are the point played and the stones it captured,
+    // which are connected to it: flood fill from the point over the cells
+    // whose planes are out of date, bringing them up to date.
+    const std::pair<int, int> row_col = VirtualPointTo2DPoint(point);
+    std::vector<int> cells = {row_col.first * board_size + row_col.second};
+    while (!cells.empty()) {
+      const int cell = cells.back();
+      cells.pop_back();
+      bool changed = false;
+      for (int plane = 0; plane < CellStates(); ++plane) {
+        const int index = plane * num_cells + cell;
+        if (values[index] != stone_planes_[index]) {
+          values[index] = stone_planes_[index];
+          changed = true;
+        }
+      }
+      if (!changed) continue;
+      const int row = cell / board_size;
+      const int col = cell % board_size;
+      if (row > 0) cells.push_back(cell - board_size);
+      if (row + 1 < board_size) cells.push_back(cell + board_size);
+      if (col > 0) cells.push_back(cell - 1);
+      if (col + 1 < board_size) cells.push_back(cell + 1);
+    }
   }
-  SPIEL_CHECK_EQ(cell, num_cells);
-
-  // Add a fourth binary plane for komi (whether white is to play).
-  std::fill(values->begin() + (CellStates() * num_cells), values->end(),
-            (to_play_ == GoColor::kWhite ? 1.0 : 0.0));
+  std::fill(values.begin() + num_cells * CellStates(), values.end(),
+            to_play_ == GoColor::kWhite ? 1.0 : 0.0);
+  return true;
 }
 
 std::vector<Action> GoState::LegalActions() const {
   std::vector<Action> actions{};
-  if (IsTerminal()) return actions;
+  LegalActions(&actions);
+  return actions;
+}
+
+void GoState::LegalActions(std::vector<Action>* actions) const {
+  actions->clear();
+  if (IsTerminal()) return;
   for (VirtualPoint p : BoardPoints(board_.board_size())) {
     if (board_.IsLegalMove(p, to_play_)) {
-      actions.push_back(board_.VirtualActionToAction(p));
+      actions->push_back(board_.VirtualActionToAction(p));
     }
   }
-  actions.push_back(board_.pass_action());
-  return actions;
+  actions->push_back(board_.pass_action());
+}
+
+void GoState::LegalActionsMask(Player player, absl::Span<uint8_t> mask) const {
+  SPIEL_CHECK_EQ(mask.size(), num_distinct_actions_);
+  std::fill(mask.begin(), mask.end(), 0);
+  if (player != CurrentPlayer()) return;
+  for (VirtualPoint p : BoardPoints(board_.board_size())) {
+    if (board_.IsLegalMove(p, to_play_)) {
+      mask[board_.VirtualActionToAction(p)] = 1;
+    }
+  }
+  mask[board_.pass_action()] = 1;
 }
 
 std::string GoState::ActionToString(Player player, Action action) const {
@@ -182,23 +239,69 @@ std::vector<double> GoState::Returns() const {
   return returns;
 }
 
+int64_t GoState::ApproximateMemoryUsage() const {
+  // The repetition table holds a node per position, and an array of
+  // buckets.
+  return sizeof(*this) + HistoryMemoryUsage() +
+         stone_planes_.capacity() * sizeof(double) +
+         repetitions_.size() * (sizeof(uint64_t) + sizeof(void*)) +
+         repetitions_.bucket_count() * sizeof(void*);
+}
+
 std::unique_ptr<State> GoState::Clone() const {
   return std::unique_ptr<State>(new GoState(*this));
 }
 
+uint64_t GoState::HashValue() const {
+  // The last move matters since two consecutive passes end the game.
+  uint64_t hash = board_.HashValue();
+  if (to_play_ == GoColor::kWhite) hash ^= kWhiteToPlayKey;
+  if (!history_.empty() && history_.back() == board_.pass_action()) {
+    hash ^= kLastMovePassKey;
+  }
+  if (superko_) hash ^= kSuperkoKey;
+  return hash;
+}
+
+bool GoState::CopyFrom(const State& other) {
+  *this = static_cast<const GoState&>(other);
+  return true;
+}
+
 void GoState::UndoAction(Player player, Action action) {
   // We don't have direct undo functionality, but copying the board and
   // replaying all actions is still pretty fast (> 1 million undos/second).
-  history_.pop_back();
+  PopHistory();
   ResetBoard();
-  for (Action action : history_) {
-    DoApplyAction(action);
-  }
+  for (Action action : history_) PlayBoardMove(action, nullptr);
+  ResetStonePlanes();
 }
 
 void GoState::DoApplyAction(Action action) {
-  SPIEL_CHECK_TRUE(
-      board_.PlayMove(board_.ActionToVirtualAction(action), to_play_));
+  const GoColor player = to_play_;
+  std::vector<VirtualPoint> captured_stones;
+  SPIEL_CHECK_TRUE(PlayBoardMove(action, &captured_stones));
+  const VirtualPoint point = board_.ActionToVirtualAction(action);
+  if (point != kVirtualPass) {
+    UpdateStonePlanes(point, GoColor::kEmpty);
+    for (VirtualPoint p : captured_stones) {
+      UpdateStonePlanes(p, OppColor(player));
+    }
+  }
+}
+
+void GoState::DoApplyActionsUnchecked(absl::Span<const Action> actions) {
+  for (Action action : actions) {
+    PlayBoardMove(action, nullptr);
+    PushHistory(action);
+  }
+  ResetStonePlanes();
+}
+
+bool GoState::PlayBoardMove(Action action,
+                            std::vector<VirtualPoint>* captured_stones) {
+  const bool legal = board_.PlayMove(board_.ActionToVirtualAction(action),
+                                     to_play_, captured_stones);
   to_play_ = OppColor(to_play_);
 
   bool was_inserted = repetitions_.insert(board_.HashValue()).second;
@@ -206,6 +309,7 @@ void GoState::DoApplyAction(Action action) {
     // We have encountered this position before.
     superko_ = true;
   }
+  return legal;
 }
 
 void GoState::ResetBoard() {
@@ -222,6 +326,28 @@ void GoState::ResetBoard() {
   repetitions_.clear();
   repetitions_.insert(board_.HashValue());
   superko_ = false;
+  ResetStonePlanes();
+}
+
+void GoState::ResetStonePlanes() {
+  const int num_cells = board_.board_size() * board_.board_size();
+  stone_planes_.assign(num_cells * CellStates(), 0.);
+  int cell = 0;
+  for (VirtualPoint p : BoardPoints(board_.board_size())) {
+    int color_val = static_cast<int>(board_.PointColor(p));
+    stone_planes_[num_cells * color_val + cell] = 1.0;
+    ++cell;
+  }
+  SPIEL_CHECK_EQ(cell, num_cells);
+}
+
+void GoState::UpdateStonePlanes(VirtualPoint p, GoColor previous_color) {
+  const int num_cells = board_.board_size() * board_.board_size();
+  const std::pair<int, int> row_col = VirtualPointTo2DPoint(p);
+  const int cell = row_col.first * board_.board_size() + row_col.second;
+  stone_planes_[num_cells * static_cast<int>(previous_color) + cell] = 0.;
+  stone_planes_[num_cells * static_cast<int>(board_.PointColor(p)) + cell] =
+      1.0;
 }
 
 GoGame::GoGame(const GameParameters& params)
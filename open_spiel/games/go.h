@@ -23,6 +23,7 @@
 #include <unordered_set>
 #include <vector>
 
+#include "open_spiel/abseil-cpp/absl/types/span.h"
 #include "open_spiel/games/go/go_board.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
@@ -74,6 +75,9 @@ class GoState : public State {
     return IsTerminal() ? kTerminalPlayerId : ColorToPlayer(to_play_);
   }
   std::vector<Action> LegalActions() const override;
+  void LegalActions(std::vector<Action>* actions) const override;
+  void LegalActionsMask(Player player,
+                        absl::Span<uint8_t> mask) const override;
   std::string ActionToString(Player player, Action action) const override;
   std::string ToString() const override;
 
@@ -86,22 +90,48 @@ class GoState : public State {
   // (whether white is to play).
   void ObservationTensor(int player,
                          std::vector<double>* values) const override;
+  bool UpdateObservationTensor(int player,
+                               absl::Span<float> values) const override;
 
   std::vector<double> Returns() const override;
 
   std::unique_ptr<State> Clone() const override;
+  bool CopyFrom(const State& other) override;
+  int64_t ApproximateMemoryUsage() const override;
+  uint64_t HashValue() const override;
   void UndoAction(Player player, Action action) override;
+  bool SupportsUndoAction() const override { return true; }
 
   const GoBoard& board() const { return board_; }
+  float komi() const { return komi_; }
+  int handicap() const { return handicap_; }
+  GoColor to_play() const { return to_play_; }
 
  protected:
   void DoApplyAction(Action action) override;
+  // Replays the moves on the board, and rebuilds the stone planes once.
+  void DoApplyActionsUnchecked(absl::Span<const Action> actions) override;
 
  private:
   void ResetBoard();
 
+  // Plays the move of the action and passes the turn, recording the position
+  // for superko, but leaving the stone planes as they were. Returns whether
+  // the move was legal.
+  bool PlayBoardMove(Action action,
+                     std::vector<VirtualPoint>* captured_stones);
+
+  // Rebuilds the stone planes from the board, or updates them for a point of
+  // the board which was of the previous color.
+  void ResetStonePlanes();
+  void UpdateStonePlanes(VirtualPoint p, GoColor previous_color);
+
   GoBoard board_;
 
+  // The black, white and empty planes of the observation tensor, updated as
+  // the stones are played and captured, so that ObservationTensor copies them.
+  std::vector<double> stone_planes_;
+
   // RepetitionTable records which positions we have already encountered.
   // We are already indexing by board hash, so there is no need to hash that
   // hash again, so we use a custom passthrough hasher.
@@ -114,8 +144,8 @@ class GoState : public State {
   using RepetitionTable = std::unordered_set<uint64_t, PassthroughHash>;
   RepetitionTable repetitions_;
 
-  const float komi_;
-  const int handicap_;
+  float komi_;
+  int handicap_;
   GoColor to_play_;
   bool superko_;
 };
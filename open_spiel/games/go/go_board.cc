@@ -16,6 +16,7 @@
 
 #include <iomanip>
 
+#include "open_spiel/abseil-cpp/absl/random/distributions.h"
 #include "open_spiel/abseil-cpp/absl/random/uniform_int_distribution.h"
 #include "open_spiel/games/chess/chess_common.h"
 #include "open_spiel/spiel_utils.h"
@@ -236,9 +237,12 @@ void GoBoard::Clear() {
     chains_[i].reset_border();
   }
 
+  num_empty_points_ = 0;
   for (VirtualPoint p : BoardPoints(board_size_)) {
     board_[p].color = GoColor::kEmpty;
     chains_[p].reset();
+    empty_index_[p] = num_empty_points_;
+    empty_points_[num_empty_points_++] = p;
   }
 
   for (VirtualPoint p : BoardPoints(board_size_)) {
@@ -254,7 +258,8 @@ void GoBoard::Clear() {
   last_ko_point_ = kInvalidPoint;
 }
 
-bool GoBoard::PlayMove(VirtualPoint p, GoColor c) {
+bool GoBoard::PlayMove(VirtualPoint p, GoColor c,
+                       std::vector<VirtualPoint>* captured_stones) {
   if (p == kVirtualPass) {
     last_ko_point_ = kInvalidPoint;
     return true;
@@ -274,7 +279,7 @@ bool GoBoard::PlayMove(VirtualPoint p, GoColor c) {
   JoinChainsAround(p, c);
   SetStone(p, c);
   RemoveLibertyFromNeighbouringChains(p);
-  int stones_captured = CaptureDeadChains(p, c);
+  int stones_captured = CaptureDeadChains(p, c, captured_stones);
 
   if (played_in_enemy_eye && stones_captured == 1) {
     last_ko_point_ = last_captures_[0];
@@ -282,7 +287,7 @@ bool GoBoard::PlayMove(VirtualPoint p, GoColor c) {
     last_ko_point_ = kInvalidPoint;
   }
 
-  SPIEL_CHECK_GT(chain(p).num_pseudo_liberties, 0);
+  SPIEL_DCHECK_GT(chain(p).num_pseudo_liberties, 0);
 
   return true;
 }
@@ -296,6 +301,69 @@ void GoBoard::SetStone(VirtualPoint p, GoColor c) {
       c == GoColor::kEmpty ? PointColor(p) : c)];
 
   board_[p].color = c;
+
+  if (c == GoColor::kEmpty) {
+    empty_index_[p] = num_empty_points_;
+    empty_points_[num_empty_points_++] = p;
+  } else {
+    SwapEmptyPoints(empty_index_[p], --num_empty_points_);
+  }
+}
+
+void GoBoard::SwapEmptyPoints(int i, int j) {
+  std::swap(empty_points_[i], empty_points_[j]);
+  empty_index_[empty_points_[i]] = i;
+  empty_index_[empty_points_[j]] = j;
+}
+
+bool GoBoard::IsEye(VirtualPoint p, GoColor c) const {
+  bool surrounded = true;
+  Neighbours(p, [this, c, &surrounded](VirtualPoint n) {
+    GoColor s = PointColor(n);
+    surrounded &= (s == c || s == GoColor::kGuard);
+  });
+  if (!surrounded) return false;
+
+  int num_opponent_diagonals = 0;
+  bool on_edge = false;
+  for (VirtualPoint d : {p + kVirtualBoardSize + 1, p + kVirtualBoardSize - 1,
+                         p - kVirtualBoardSize + 1, p - kVirtualBoardSize - 1}) {
+    GoColor s = PointColor(d);
+    num_opponent_diagonals += (s == OppColor(c));
+    on_edge |= (s == GoColor::kGuard);
+  }
+  return num_opponent_diagonals < (on_edge ? 1 : 2);
+}
+
+VirtualPoint GoBoard::PlayRandomMove(GoColor c, std::mt19937* rng) {
+  // The candidates are the first num_candidates empty points. Those which
+  // cannot be played are swapped past them, so each is tried at most once,
+  // and each playable point is equally likely to be drawn first.
+  for (int num_candidates = num_empty_points_; num_candidates > 0;
+       --num_candidates) {
+    int i = absl::Uniform(*rng, 0, num_candidates);
+    VirtualPoint p = empty_points_[i];
+    if (!IsEye(p, c) && IsLegalMove(p, c)) {
+      PlayMove(p, c);
+      return p;
+    }
+    SwapEmptyPoints(i, num_candidates - 1);
+  }
+  PlayMove(kVirtualPass, c);
+  return kVirtualPass;
+}
+
+int GoBoard::PlayRandomGame(GoColor to_play, bool last_move_pass,
+                            int max_moves, std::mt19937* rng) {
+  int num_moves = 0;
+  while (num_moves < max_moves) {
+    bool pass = PlayRandomMove(to_play, rng) == kVirtualPass;
+    ++num_moves;
+    if (pass && last_move_pass) break;
+    last_move_pass = pass;
+    to_play = OppColor(to_play);
+  }
+  return num_moves;
 }
 
 // Combines the groups around the newly placed stone at vertex. If no groups
@@ -355,14 +423,16 @@ void GoBoard::RemoveLibertyFromNeighbouringChains(VirtualPoint p) {
   Neighbours(p, [this, p](VirtualPoint n) { chain(n).remove_liberty(p); });
 }
 
-int GoBoard::CaptureDeadChains(VirtualPoint p, GoColor c) {
+int GoBoard::CaptureDeadChains(VirtualPoint p, GoColor c,
+                               std::vector<VirtualPoint>* captured_stones) {
   int stones_captured = 0;
   int capture_index = 0;
-  Neighbours(p, [this, c, &capture_index, &stones_captured](VirtualPoint n) {
+  Neighbours(p, [this, c, captured_stones, &capture_index,
+                 &stones_captured](VirtualPoint n) {
     if (PointColor(n) == OppColor(c) && chain(n).num_pseudo_liberties == 0) {
       last_captures_[capture_index++] = ChainHead(n);
       stones_captured += chain(n).num_stones;
-      RemoveChain(n);
+      RemoveChain(n, captured_stones);
     }
   });
 
@@ -373,13 +443,15 @@ int GoBoard::CaptureDeadChains(VirtualPoint p, GoColor c) {
   return stones_captured;
 }
 
-void GoBoard::RemoveChain(VirtualPoint p) {
+void GoBoard::RemoveChain(VirtualPoint p,
+                          std::vector<VirtualPoint>* captured_stones) {
   VirtualPoint this_chain_head = ChainHead(p);
   VirtualPoint cur = p;
   do {
     VirtualPoint next = board_[cur].chain_next;
 
     SetStone(cur, GoColor::kEmpty);
+    if (captured_stones != nullptr) captured_stones->push_back(cur);
     InitNewChain(cur);
 
     Neighbours(cur, [this, this_chain_head, cur](VirtualPoint n) {
@@ -18,6 +18,7 @@
 #include <array>
 #include <cstdint>
 #include <ostream>
+#include <random>
 #include <vector>
 #include "open_spiel/spiel_utils.h"
 
@@ -107,7 +108,32 @@ class GoBoard {
 
   bool IsLegalMove(VirtualPoint p, GoColor c) const;
 
-  bool PlayMove(VirtualPoint p, GoColor c);
+  // If captured_stones is not null, the points of the stones captured by the
+  // move are appended to it.
+  bool PlayMove(VirtualPoint p, GoColor c,
+                std::vector<VirtualPoint> *captured_stones = nullptr);
+
+  // The empty points of the board, in no particular order.
+  inline int NumEmptyPoints() const { return num_empty_points_; }
+  inline VirtualPoint EmptyPoint(int i) const { return empty_points_[i]; }
+
+  // Whether c would fill one of its own eyes by playing at the empty point p:
+  // all its neighbours are c stones, and the opponent holds at most one of its
+  // diagonals, or none on the edge of the board.
+  bool IsEye(VirtualPoint p, GoColor c) const;
+
+  // Fast playouts, without the State API. PlayRandomMove plays a uniformly
+  // random legal move of c which does not fill one of its eyes, or passes if
+  // there is none, and returns the point played. Each empty point is tried at
+  // most once, so a move takes constant time unless most of the empty points
+  // cannot be played.
+  VirtualPoint PlayRandomMove(GoColor c, std::mt19937* rng);
+
+  // Plays random moves, starting with to_play, until two passes in a row
+  // (counting the last move if last_move_pass) or max_moves moves, and
+  // returns the number of moves played.
+  int PlayRandomGame(GoColor to_play, bool last_move_pass, int max_moves,
+                     std::mt19937* rng);
 
   // kInvalidPoint if there is no ko, otherwise the point of the ko.
   inline VirtualPoint LastKoPoint() const { return last_ko_point_; }
@@ -185,9 +211,11 @@ class GoBoard {
   void JoinChainsAround(VirtualPoint p, GoColor c);
   void SetStone(VirtualPoint p, GoColor c);
   void RemoveLibertyFromNeighbouringChains(VirtualPoint p);
-  int CaptureDeadChains(VirtualPoint p, GoColor c);
-  void RemoveChain(VirtualPoint p);
+  int CaptureDeadChains(VirtualPoint p, GoColor c,
+                        std::vector<VirtualPoint> *captured_stones);
+  void RemoveChain(VirtualPoint p, std::vector<VirtualPoint> *captured_stones);
   void InitNewChain(VirtualPoint p);
+  void SwapEmptyPoints(int i, int j);
 
   struct Vertex {
     VirtualPoint chain_head;
@@ -226,6 +254,11 @@ class GoBoard {
   // Chains captured in the last move, kInvalidPoint otherwise.
   std::array<VirtualPoint, 4> last_captures_;
 
+  // The empty points, and the index of each in empty_points_.
+  std::array<VirtualPoint, kMaxBoardSize * kMaxBoardSize> empty_points_;
+  std::array<uint16_t, kVirtualBoardPoints> empty_index_;
+  int num_empty_points_;
+
   int board_size_;
   int pass_action_;
 
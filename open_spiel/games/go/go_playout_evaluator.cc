@@ -0,0 +1,75 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "open_spiel/games/go/go_playout_evaluator.h"
+
+#include <random>
+#include <vector>
+
+#include "open_spiel/games/go.h"
+#include "open_spiel/games/go/go_board.h"
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace go {
+
+GoPlayoutEvaluator::GoPlayoutEvaluator(int n_rollouts, int seed)
+    : n_rollouts_(n_rollouts), seed_(seed) {}
+
+std::vector<double> GoPlayoutEvaluator::Evaluate(const State& state) {
+  if (state.IsTerminal()) return state.Returns();
+  const auto* go_state = dynamic_cast<const GoState*>(&state);
+  SPIEL_CHECK_TRUE(go_state != nullptr);
+
+  const GoBoard& board = go_state->board();
+  const std::vector<Action>& history = state.History();
+  const bool last_move_pass =
+      !history.empty() && history.back() == board.pass_action();
+  const int max_moves = MaxGameLength(board.board_size()) - history.size();
+
+  std::mt19937 rng(seed_ + num_calls_.fetch_add(1));
+  double black_return = 0;
+  for (int i = 0; i < n_rollouts_; ++i) {
+    GoBoard playout_board = board;
+    playout_board.PlayRandomGame(go_state->to_play(), last_move_pass,
+                                 max_moves, &rng);
+    float black_score = TrompTaylorScore(playout_board, go_state->komi(),
+                                         go_state->handicap());
+    if (black_score > 0) {
+      black_return += WinUtility();
+    } else if (black_score < 0) {
+      black_return += LossUtility();
+    } else {
+      black_return += DrawUtility();
+    }
+  }
+  black_return /= n_rollouts_;
+
+  std::vector<double> returns(NumPlayers());
+  returns[ColorToPlayer(GoColor::kBlack)] = black_return;
+  returns[ColorToPlayer(GoColor::kWhite)] = -black_return;
+  return returns;
+}
+
+ActionsAndProbs GoPlayoutEvaluator::Prior(const State& state) {
+  std::vector<Action> legal_actions = state.LegalActions();
+  ActionsAndProbs prior;
+  prior.reserve(legal_actions.size());
+  for (Action action : legal_actions) {
+    prior.emplace_back(action, 1.0 / legal_actions.size());
+  }
+  return prior;
+}
+
+}  // namespace go
+}  // namespace open_spiel
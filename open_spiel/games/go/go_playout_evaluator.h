@@ -0,0 +1,50 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef OPEN_SPIEL_GAMES_GO_GO_PLAYOUT_EVALUATOR_H_
+#define OPEN_SPIEL_GAMES_GO_GO_PLAYOUT_EVALUATOR_H_
+
+#include <atomic>
+#include <vector>
+
+#include "open_spiel/algorithms/mcts.h"
+#include "open_spiel/spiel.h"
+
+namespace open_spiel {
+namespace go {
+
+// An MCTS evaluator for go, averaging the Tromp-Taylor results of random
+// playouts run on copies of the board (see GoBoard::PlayRandomMove), rather
+// than through the State API as RandomRolloutEvaluator does. The playouts do
+// not fill their own eyes, and ignore superko. The prior is uniform.
+//
+// Each call draws its own random generator, so the evaluator can be used from
+// several threads at once.
+class GoPlayoutEvaluator : public algorithms::Evaluator {
+ public:
+  GoPlayoutEvaluator(int n_rollouts, int seed);
+
+  // The states must be GoStates.
+  std::vector<double> Evaluate(const State& state) override;
+  ActionsAndProbs Prior(const State& state) override;
+
+ private:
+  int n_rollouts_;
+  int seed_;
+  std::atomic<int> num_calls_{0};
+};
+
+}  // namespace go
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_GAMES_GO_GO_PLAYOUT_EVALUATOR_H_
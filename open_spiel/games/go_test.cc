@@ -14,7 +14,13 @@
 
 #include "open_spiel/games/go.h"
 
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "open_spiel/algorithms/mcts.h"
 #include "open_spiel/games/go/go_board.h"
+#include "open_spiel/games/go/go_playout_evaluator.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
 #include "open_spiel/tests/basic_tests.h"
@@ -38,6 +44,25 @@ void BasicGoTests() {
   testing::RandomSimTestWithUndo(*LoadGame("go", params), 3);
 }
 
+// The observation planes, updated as moves are played, match the board.
+void ObservationTensorMatchesBoard(const GoState& state) {
+  const int board_size = state.board().board_size();
+  const int num_cells = board_size * board_size;
+  std::vector<double> values;
+  state.ObservationTensor(0, &values);
+  SPIEL_CHECK_EQ(values.size(), num_cells * (CellStates() + 1));
+  int cell = 0;
+  for (VirtualPoint p : BoardPoints(board_size)) {
+    const int color = static_cast<int>(state.board().PointColor(p));
+    for (int plane = 0; plane < CellStates(); ++plane) {
+      SPIEL_CHECK_EQ(values[plane * num_cells + cell], plane == color);
+    }
+    SPIEL_CHECK_EQ(values[CellStates() * num_cells + cell],
+                   values[CellStates() * num_cells]);
+    ++cell;
+  }
+}
+
 void HandicapTest() {
   std::shared_ptr<const Game> game =
       LoadGame("go", {{"board_size", open_spiel::GameParameter(kBoardSize)},
@@ -47,6 +72,7 @@ void HandicapTest() {
   SPIEL_CHECK_EQ(state.CurrentPlayer(), ColorToPlayer(GoColor::kWhite));
   SPIEL_CHECK_EQ(state.board().PointColor(MakePoint("d4")), GoColor::kBlack);
   SPIEL_CHECK_EQ(state.board().PointColor(MakePoint("q16")), GoColor::kBlack);
+  ObservationTensorMatchesBoard(state);
 }
 
 void ConcreteActionsAreUsedInTheAPI() {
@@ -63,6 +89,92 @@ void ConcreteActionsAreUsedInTheAPI() {
   }
 }
 
+// Along random games, which capture stones, after replaying them in bulk and
+// after undoing moves.
+void IncrementalObservationTensorTest() {
+  std::shared_ptr<const Game> game =
+      LoadGame("go", {{"board_size", open_spiel::GameParameter(9)}});
+  std::mt19937 rng(11);
+  bool captured = false;
+  for (int i = 0; i < 5; ++i) {
+    std::unique_ptr<State> state = game->NewInitialState();
+    int num_stones = 0;
+    while (!state->IsTerminal()) {
+      const GoState& go_state = static_cast<const GoState&>(*state);
+      ObservationTensorMatchesBoard(go_state);
+      std::vector<Action> actions = state->LegalActions();
+      state->ApplyAction(actions[absl::uniform_int_distribution<int>(
+          0, actions.size() - 1)(rng)]);
+      const std::vector<double> values = state->ObservationTensor(0);
+      const int new_num_stones =
+          std::count(values.begin(), values.begin() + 81 * 2, 1.);
+      captured |= new_num_stones < num_stones;
+      num_stones = new_num_stones;
+    }
+    ObservationTensorMatchesBoard(static_cast<const GoState&>(*state));
+
+    // Replaying the game in bulk rebuilds the same state.
+    std::unique_ptr<State> replayed = game->NewInitialState();
+    replayed->ApplyActionsUnchecked(state->FullHistory());
+    ObservationTensorMatchesBoard(static_cast<const GoState&>(*replayed));
+    SPIEL_CHECK_EQ(replayed->ToString(), state->ToString());
+    SPIEL_CHECK_EQ(replayed->HashValue(), state->HashValue());
+    SPIEL_CHECK_EQ(replayed->FullHistory(), state->FullHistory());
+    SPIEL_CHECK_TRUE(replayed->IsTerminal());
+    SPIEL_CHECK_EQ(replayed->Returns(), state->Returns());
+
+    for (int j = 0; j < 10; ++j) state->UndoAction(-1, state->History().back());
+    ObservationTensorMatchesBoard(static_cast<const GoState&>(*state));
+  }
+  SPIEL_CHECK_TRUE(captured);
+}
+
+void PlayoutTest() {
+  std::mt19937 rng(3);
+  for (int i = 0; i < 10; ++i) {
+    GoBoard board(9);
+    board.PlayRandomGame(GoColor::kBlack, /*last_move_pass=*/false,
+                         MaxGameLength(9), &rng);
+
+    // The empty point list matches the board.
+    int num_empty = 0;
+    for (VirtualPoint p : BoardPoints(9)) num_empty += board.IsEmpty(p);
+    SPIEL_CHECK_EQ(board.NumEmptyPoints(), num_empty);
+    for (int j = 0; j < board.NumEmptyPoints(); ++j) {
+      SPIEL_CHECK_TRUE(board.IsEmpty(board.EmptyPoint(j)));
+    }
+
+    // Both players passed, having only eyes left to fill.
+    for (GoColor c : {GoColor::kBlack, GoColor::kWhite}) {
+      for (int j = 0; j < board.NumEmptyPoints(); ++j) {
+        VirtualPoint p = board.EmptyPoint(j);
+        SPIEL_CHECK_TRUE(board.IsEye(p, c) || !board.IsLegalMove(p, c));
+      }
+    }
+  }
+}
+
+void PlayoutEvaluatorTest() {
+  std::shared_ptr<const Game> game =
+      LoadGame("go", {{"board_size", open_spiel::GameParameter(9)}});
+  auto evaluator = std::make_shared<GoPlayoutEvaluator>(/*n_rollouts=*/20,
+                                                        /*seed=*/1);
+  std::unique_ptr<State> state = game->NewInitialState();
+  std::vector<double> values = evaluator->Evaluate(*state);
+  SPIEL_CHECK_EQ(values.size(), 2);
+  SPIEL_CHECK_GE(values[0], -1);
+  SPIEL_CHECK_LE(values[0], 1);
+  SPIEL_CHECK_EQ(values[0], -values[1]);
+  SPIEL_CHECK_EQ(evaluator->Prior(*state).size(), 9 * 9 + 1);
+
+  algorithms::MCTSBot bot(*game, evaluator, /*uct_c=*/2,
+                          /*max_simulations=*/100, /*max_memory_mb=*/100,
+                          /*solve=*/false, /*seed=*/1, /*verbose=*/false);
+  for (int i = 0; i < 4; ++i) state->ApplyAction(bot.Step(*state));
+  values = evaluator->Evaluate(*state);
+  SPIEL_CHECK_EQ(values[0], -values[1]);
+}
+
 }  // namespace
 }  // namespace go
 }  // namespace open_spiel
@@ -71,4 +183,7 @@ int main(int argc, char** argv) {
   open_spiel::go::BasicGoTests();
   open_spiel::go::HandicapTest();
   open_spiel::go::ConcreteActionsAreUsedInTheAPI();
+  open_spiel::go::IncrementalObservationTensorTest();
+  open_spiel::go::PlayoutTest();
+  open_spiel::go::PlayoutEvaluatorTest();
 }
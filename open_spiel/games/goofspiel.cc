@@ -21,6 +21,7 @@
 #include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
 #include "open_spiel/game_parameters.h"
 #include "open_spiel/spiel.h"
+#include "open_spiel/utils/varint.h"
 
 namespace open_spiel {
 namespace goofspiel {
@@ -79,7 +80,9 @@ GoofspielState::GoofspielState(std::shared_ptr<const Game> game, int num_cards,
       point_card_index_(-1),
       point_card_sequence_({}),
       win_sequence_({}),
-      actions_history_({}) {
+      actions_history_({}),
+      action_strings_(game->NumPlayers()),
+      action_keys_(game->NumPlayers()) {
   // Points and point-card deck.
   points_.resize(num_players_);
   std::fill(points_.begin(), points_.end(), 0);
@@ -126,6 +129,8 @@ void GoofspielState::DoApplyAction(Action action_id) {
   SPIEL_CHECK_GE(point_card_index_, 0);
   SPIEL_CHECK_LT(point_card_index_, point_deck_.size());
   point_card_sequence_.push_back(point_deck_[point_card_index_]);
+  absl::StrAppend(&point_card_string_, point_card_sequence_.back(), " ");
+  AppendVarint(point_card_sequence_.back(), &point_card_key_);
   current_player_ = kSimultaneousPlayerId;
 }
 
@@ -162,9 +167,15 @@ void GoofspielState::DoApplyActions(const std::vector<Action>& actions) {
     // Tied among several players: discarded.
     win_sequence_.push_back(kInvalidPlayer);
   }
+  absl::StrAppend(&win_string_, win_sequence_.back(), " ");
+  AppendSignedVarint(win_sequence_.back(), &win_key_);
 
   // Add these actions to the history.
   actions_history_.push_back(actions);
+  for (auto p = Player{0}; p < num_players_; ++p) {
+    absl::StrAppend(&action_strings_[p], actions[p], " ");
+    AppendVarint(actions[p], &action_keys_[p]);
+  }
 
   // Remove the cards from the player's hands.
   for (auto p = Player{0}; p < num_players_; ++p) {
@@ -276,20 +287,11 @@ std::string GoofspielState::ToString() const {
   // In imperfect information, the full state depends on both betting sequences
   if (impinfo_) {
     for (auto p = Player{0}; p < num_players_; ++p) {
-      absl::StrAppend(&result, "P", p, " actions: ");
-      for (int i = 0; i < actions_history_.size(); ++i) {
-        absl::StrAppend(&result, actions_history_[i][p]);
-        absl::StrAppend(&result, " ");
-      }
-      absl::StrAppend(&result, "\n");
+      absl::StrAppend(&result, "P", p, " actions: ", action_strings_[p], "\n");
     }
   }
 
-  absl::StrAppend(&result, "Point card sequence: ");
-  for (int i = 0; i < point_card_sequence_.size(); ++i) {
-    absl::StrAppend(&result, point_card_sequence_[i], " ");
-  }
-  absl::StrAppend(&result, "\n");
+  absl::StrAppend(&result, "Point card sequence: ", point_card_string_, "\n");
 
   return result + points_line + "\n";
 }
@@ -352,25 +354,15 @@ std::string GoofspielState::InformationStateString(Player player) const {
         // outcomes if the opponent chooses differently.
         absl::StrAppend(&result, "P");
         absl::StrAppend(&result, p);
-        absl::StrAppend(&result, " action sequence: ");
-        for (int i = 0; i < actions_history_.size(); ++i) {
-          absl::StrAppend(&result, actions_history_[i][p]);
-          absl::StrAppend(&result, " ");
-        }
-        absl::StrAppend(&result, "\n");
+        absl::StrAppend(&result, " action sequence: ", action_strings_[p],
+                        "\n");
       }
     }
 
-    for (int i = 0; i < win_sequence_.size(); ++i) {
-      absl::StrAppend(&win_sequence, win_sequence_[i]);
-      win_sequence.push_back(' ');
-    }
+    absl::StrAppend(&win_sequence, win_string_);
 
-    absl::StrAppend(&result, "Point card sequence: ");
-    for (int i = 0; i < point_card_sequence_.size(); ++i) {
-      absl::StrAppend(&result, point_card_sequence_[i], " ");
-    }
-    absl::StrAppend(&result, "\n");
+    absl::StrAppend(&result, "Point card sequence: ", point_card_string_,
+                    "\n");
 
     return result + win_sequence + "\n" + points_line + "\n";
   } else {
@@ -379,6 +371,22 @@ std::string GoofspielState::InformationStateString(Player player) const {
   }
 }
 
+// The hands and points follow from the action, point card and win sequences.
+std::string GoofspielState::InformationStateKey(Player player) const {
+  SPIEL_CHECK_GE(player, 0);
+  SPIEL_CHECK_LT(player, num_players_);
+  if (!impinfo_) return InformationStateString(player);
+
+  std::string key;
+  AppendVarint(player, &key);
+  AppendVarint(actions_history_.size(), &key);
+  key.append(action_keys_[player]);
+  AppendVarint(point_card_sequence_.size(), &key);
+  key.append(point_card_key_);
+  key.append(win_key_);
+  return key;
+}
+
 std::string GoofspielState::ObservationString(Player player) const {
   SPIEL_CHECK_GE(player, 0);
   SPIEL_CHECK_LT(player, num_players_);
@@ -412,9 +420,7 @@ std::string GoofspielState::ObservationString(Player player) const {
     absl::StrAppend(&hands, "\n");
 
     // Show the win sequence.
-    for (int i = 0; i < win_sequence_.size(); ++i) {
-      absl::StrAppend(&win_seq, win_sequence_[i], " ");
-    }
+    absl::StrAppend(&win_seq, win_string_);
     return absl::StrCat(current_trick, "\n", points_line, "\n", hands, win_seq,
                         "\n");
   } else {
@@ -579,6 +585,91 @@ void GoofspielState::ObservationTensor(Player player,
   SPIEL_CHECK_EQ(values->size(), game_->ObservationTensorSize());
 }
 
+void GoofspielState::AddPointTotals(Player player, int* offset,
+                                    SparseTensor* tensor) const {
+  const int max_points_slots = (num_cards_ * (num_cards_ + 1)) / 2 + 1;
+  Player p = player;
+  for (int n = 0; n < num_players_; NextPlayer(&n, &p)) {
+    tensor->Add(*offset + points_[p]);
+    *offset += max_points_slots;
+  }
+}
+
+void GoofspielState::AddHands(Player player, bool all_players, int* offset,
+                              SparseTensor* tensor) const {
+  Player p = player;
+  for (int n = 0; n < (all_players ? num_players_ : 1); NextPlayer(&n, &p)) {
+    for (int c = 0; c < num_cards_; ++c) {
+      if (player_hands_[p][c]) tensor->Add(*offset + c);
+    }
+    *offset += num_cards_;
+  }
+}
+
+void GoofspielState::AddWinSequence(int* offset, SparseTensor* tensor) const {
+  // Tied tricks have no winner.
+  for (int i = 0; i < win_sequence_.size(); ++i) {
+    if (win_sequence_[i] >= 0 && win_sequence_[i] < num_players_) {
+      tensor->Add(*offset + i * num_players_ + win_sequence_[i]);
+    }
+  }
+  *offset += num_cards_ * num_players_;
+}
+
+void GoofspielState::AddPointCardSequence(int* offset,
+                                          SparseTensor* tensor) const {
+  for (int i = 0; i < point_card_sequence_.size(); ++i) {
+    tensor->Add(*offset + i * num_cards_ + point_card_sequence_[i] - 1);
+  }
+  *offset += num_cards_ * num_cards_;
+}
+
+void GoofspielState::InformationStateTensor(Player player,
+                                            SparseTensor* tensor) const {
+  SPIEL_CHECK_GE(player, 0);
+  SPIEL_CHECK_LT(player, num_players_);
+
+  // The same layout as the dense version above.
+  tensor->Reset(game_->InformationStateTensorSize());
+  int offset = 0;
+  AddPointTotals(player, &offset, tensor);
+  if (impinfo_) {
+    AddHands(player, /*all_players=*/false, &offset, tensor);
+    AddWinSequence(&offset, tensor);
+    AddPointCardSequence(&offset, tensor);
+    for (int i = 0; i < actions_history_.size(); ++i) {
+      tensor->Add(offset + i * num_cards_ + actions_history_[i][player]);
+    }
+    offset += num_cards_ * num_cards_;
+  } else {
+    AddPointCardSequence(&offset, tensor);
+    AddHands(player, /*all_players=*/true, &offset, tensor);
+  }
+  SPIEL_CHECK_EQ(offset, tensor->size);
+}
+
+void GoofspielState::ObservationTensor(Player player,
+                                       SparseTensor* tensor) const {
+  SPIEL_CHECK_GE(player, 0);
+  SPIEL_CHECK_LT(player, num_players_);
+
+  // The same layout as the dense version above.
+  tensor->Reset(game_->ObservationTensorSize());
+  int offset = 0;
+  if (point_card_index_ >= 0 && point_card_index_ < num_cards_) {
+    tensor->Add(point_card_index_);
+  }
+  offset += num_cards_;
+  AddPointTotals(player, &offset, tensor);
+  if (impinfo_) {
+    AddHands(player, /*all_players=*/false, &offset, tensor);
+    AddWinSequence(&offset, tensor);
+  } else {
+    AddHands(player, /*all_players=*/true, &offset, tensor);
+  }
+  SPIEL_CHECK_EQ(offset, tensor->size);
+}
+
 std::unique_ptr<State> GoofspielState::Clone() const {
   return std::unique_ptr<State>(new GoofspielState(*this));
 }
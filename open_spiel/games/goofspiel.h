@@ -71,12 +71,16 @@ class GoofspielState : public SimMoveState {
   bool IsTerminal() const override;
   std::vector<double> Returns() const override;
   std::string InformationStateString(Player player) const override;
+  std::string InformationStateKey(Player player) const override;
   std::string ObservationString(Player player) const override;
 
   void InformationStateTensor(Player player,
                               std::vector<double>* values) const override;
   void ObservationTensor(Player player,
                          std::vector<double>* values) const override;
+  void InformationStateTensor(Player player,
+                              SparseTensor* tensor) const override;
+  void ObservationTensor(Player player, SparseTensor* tensor) const override;
   std::unique_ptr<State> Clone() const override;
   std::vector<std::pair<Action, double>> ChanceOutcomes() const override;
 
@@ -90,6 +94,14 @@ class GoofspielState : public SimMoveState {
   // Increments the count and increments the player mod num_players_.
   void NextPlayer(int* count, Player* player) const;
 
+  // The parts of the sparse tensors, each adding its non-zero entries to
+  // `tensor` from `*offset`, which is then moved past the part.
+  void AddPointTotals(Player player, int* offset, SparseTensor* tensor) const;
+  void AddHands(Player player, bool all_players, int* offset,
+                SparseTensor* tensor) const;
+  void AddWinSequence(int* offset, SparseTensor* tensor) const;
+  void AddPointCardSequence(int* offset, SparseTensor* tensor) const;
+
   int num_cards_;
   PointsOrder points_order_;
   bool impinfo_;
@@ -104,6 +116,17 @@ class GoofspielState : public SimMoveState {
   std::vector<int> point_card_sequence_;
   std::vector<int> win_sequence_;  // Which player won
   std::vector<std::vector<Action>> actions_history_;
+
+  // The sequences above as they appear in the strings and keys of the
+  // information states, appended to as the game goes so that they are not
+  // rebuilt on every call: each player's own actions, the point cards and
+  // the winners.
+  std::vector<std::string> action_strings_;
+  std::vector<std::string> action_keys_;
+  std::string point_card_string_;
+  std::string point_card_key_;
+  std::string win_string_;
+  std::string win_key_;
 };
 
 class GoofspielGame : public Game {
@@ -29,6 +29,8 @@ void BasicGoofspielTests() {
   testing::LoadGameTest("goofspiel");
   testing::ChanceOutcomesTest(*LoadGame("goofspiel"));
   testing::RandomSimTest(*LoadGame("goofspiel"), 100);
+  testing::RandomSimTest(
+      *LoadGame("goofspiel", {{"imp_info", GameParameter(true)}}), 100);
   for (Player players = 3; players <= 5; players++) {
     testing::RandomSimTest(
         *LoadGame("goofspiel", {{"players", GameParameter(players)}}), 100);
@@ -14,6 +14,9 @@
 
 #include "open_spiel/games/hanabi.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "open_spiel/game_parameters.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
@@ -136,6 +139,20 @@ std::vector<int> OpenSpielHanabiGame::ObservationTensorShape() const {
   return encoder_.Shape();
 }
 
+void OpenSpielHanabiGame::ObservationTensors(
+    absl::Span<const OpenSpielHanabiState* const> states,
+    absl::Span<float> values) const {
+  const int size = ObservationTensorSize();
+  SPIEL_CHECK_EQ(values.size(), states.size() * NumPlayers() * size);
+  for (int i = 0; i < states.size(); ++i) {
+    for (Player player = 0; player < NumPlayers(); ++player) {
+      states[i]->ObservationTensor(
+          player,
+          values.subspan((i * NumPlayers() + player) * size, size));
+    }
+  }
+}
+
 int OpenSpielHanabiGame::MaxGameLength() const {
   // This is an overestimate.
   return game_.NumPlayers() * game_.HandSize()                  // Initial deal
@@ -203,15 +220,52 @@ std::string OpenSpielHanabiState::ObservationString(Player player) const {
   return hanabi_learning_env::HanabiObservation(state_, player).ToString();
 }
 
+const std::vector<int>& OpenSpielHanabiState::Encoding(Player player) const {
+  if (encoding_history_sizes_[player] != static_cast<int>(history_.size())) {
+    encodings_[player] = game_->Encoder().Encode(
+        hanabi_learning_env::HanabiObservation(state_, player));
+    encoding_history_sizes_[player] = history_.size();
+  }
+  return encodings_[player];
+}
+
+template <typename T>
+void OpenSpielHanabiState::WriteObservationTensor(Player player,
+                                                  absl::Span<T> values) const {
+  SPIEL_CHECK_GE(player, 0);
+  SPIEL_CHECK_LT(player, num_players_);
+
+  const std::vector<int>& encoding = Encoding(player);
+  SPIEL_CHECK_EQ(values.size(), encoding.size());
+  std::copy(encoding.begin(), encoding.end(), values.begin());
+}
+
 void OpenSpielHanabiState::ObservationTensor(
     Player player, std::vector<double>* values) const {
+  values->resize(game_->ObservationTensorSize());
+  WriteObservationTensor(player, absl::MakeSpan(*values));
+}
+
+void OpenSpielHanabiState::ObservationTensor(Player player,
+                                             absl::Span<float> values) const {
+  WriteObservationTensor(player, values);
+}
+
+void OpenSpielHanabiState::ObservationTensor(Player player,
+                                             absl::Span<uint8_t> values) const {
+  WriteObservationTensor(player, values);
+}
+
+void OpenSpielHanabiState::ObservationTensor(Player player,
+                                             SparseTensor* tensor) const {
   SPIEL_CHECK_GE(player, 0);
   SPIEL_CHECK_LT(player, num_players_);
 
-  auto obs = game_->Encoder().Encode(
-      hanabi_learning_env::HanabiObservation(state_, player));
-  values->resize(obs.size());
-  for (int i = 0; i < obs.size(); ++i) values->at(i) = obs[i];
+  const std::vector<int>& encoding = Encoding(player);
+  tensor->Reset(encoding.size());
+  for (int i = 0; i < encoding.size(); ++i) {
+    if (encoding[i] != 0) tensor->Add(i, encoding[i]);
+  }
 }
 
 std::unique_ptr<State> OpenSpielHanabiState::Clone() const {
@@ -239,7 +293,9 @@ OpenSpielHanabiState::OpenSpielHanabiState(std::shared_ptr<const Game> game)
     : State(game),
       state_(&(static_cast<const OpenSpielHanabiGame&>(*game).HanabiGame())),
       game_(static_cast<const OpenSpielHanabiGame*>(game.get())),
-      prev_state_score_(0.) {}
+      prev_state_score_(0.),
+      encodings_(num_players_),
+      encoding_history_sizes_(num_players_, -1) {}
 
 }  // namespace hanabi
 }  // namespace open_spiel
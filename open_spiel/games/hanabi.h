@@ -30,7 +30,9 @@
 // (TLDR: Set the environment variable BUILD_WITH_HANABI to ON).
 
 #include <memory>
+#include <vector>
 
+#include "open_spiel/abseil-cpp/absl/types/span.h"
 #include "open_spiel/spiel.h"
 #include "hanabi_lib/canonical_encoders.h"
 #include "hanabi_lib/hanabi_game.h"
@@ -39,6 +41,8 @@
 namespace open_spiel {
 namespace hanabi {
 
+class OpenSpielHanabiState;
+
 class OpenSpielHanabiGame : public Game {
  public:
   explicit OpenSpielHanabiGame(const GameParameters& params);
@@ -58,6 +62,13 @@ class OpenSpielHanabiGame : public Game {
 
   const hanabi_learning_env::HanabiGame& HanabiGame() const { return game_; }
 
+  // Writes the observations of all the players of each of the states, those
+  // of states[i] for player p at (i * NumPlayers() + p) *
+  // ObservationTensorSize(), e.g. for a batch of environments at each step.
+  void ObservationTensors(
+      absl::Span<const OpenSpielHanabiState* const> states,
+      absl::Span<float> values) const;
+
  private:
   std::unordered_map<std::string, std::string> MapParams() const;
   hanabi_learning_env::HanabiGame game_;
@@ -80,6 +91,11 @@ class OpenSpielHanabiState : public State {
   std::string ObservationString(Player player) const override;
   void ObservationTensor(Player player,
                          std::vector<double>* values) const override;
+  void ObservationTensor(Player player,
+                         absl::Span<float> values) const override;
+  void ObservationTensor(Player player,
+                         absl::Span<uint8_t> values) const override;
+  void ObservationTensor(Player player, SparseTensor* tensor) const override;
 
   std::unique_ptr<State> Clone() const override;
   ActionsAndProbs ChanceOutcomes() const override;
@@ -90,9 +106,22 @@ class OpenSpielHanabiState : public State {
   void DoApplyAction(Action action) override;
 
  private:
+  // Shared implementation of the ObservationTensor overloads.
+  template <typename T>
+  void WriteObservationTensor(Player player, absl::Span<T> values) const;
+
+  // The encoding of the player's observation, which is only computed again
+  // once the state has changed.
+  const std::vector<int>& Encoding(Player player) const;
+
   hanabi_learning_env::HanabiState state_;
   const OpenSpielHanabiGame* game_;
   double prev_state_score_;
+
+  // The last encoding of each player's observation, and the length of the
+  // history when it was made, or -1.
+  mutable std::vector<std::vector<int>> encodings_;
+  mutable std::vector<int> encoding_history_sizes_;
 };
 
 }  // namespace hanabi
@@ -14,6 +14,10 @@
 
 #include "open_spiel/games/hanabi.h"
 
+#include <memory>
+#include <random>
+#include <vector>
+
 #include "open_spiel/game_parameters.h"
 #include "open_spiel/spiel_utils.h"
 #include "open_spiel/tests/basic_tests.h"
@@ -34,8 +38,43 @@ void BasicHanabiTests() {
   }
 }
 
+// The float and batched observations match the double ones, also when they
+// are asked for again after the state has changed.
+void ObservationTensorTest() {
+  std::shared_ptr<const Game> game =
+      LoadGame("hanabi", {{"players", GameParameter(3)}});
+  const auto& hanabi_game = static_cast<const OpenSpielHanabiGame&>(*game);
+  const int size = game->ObservationTensorSize();
+  std::mt19937 rng(0);
+  std::unique_ptr<State> state = game->NewInitialState();
+  std::vector<float> batch(game->NumPlayers() * size);
+  while (!state->IsTerminal()) {
+    if (!state->IsChanceNode()) {
+      const auto* hanabi_state =
+          static_cast<const OpenSpielHanabiState*>(state.get());
+      hanabi_game.ObservationTensors({hanabi_state}, absl::MakeSpan(batch));
+      for (Player player = 0; player < game->NumPlayers(); ++player) {
+        const std::vector<double> expected = state->ObservationTensor(player);
+        std::vector<float> values(size);
+        state->ObservationTensor(player, absl::MakeSpan(values));
+        for (int i = 0; i < size; ++i) {
+          SPIEL_CHECK_EQ(values[i], expected[i]);
+          SPIEL_CHECK_EQ(batch[player * size + i], expected[i]);
+        }
+      }
+    }
+    std::vector<Action> actions = state->LegalActions();
+    state->ApplyAction(
+        actions[std::uniform_int_distribution<int>(0, actions.size() - 1)(
+            rng)]);
+  }
+}
+
 }  // namespace
 }  // namespace hanabi
 }  // namespace open_spiel
 
-int main(int argc, char **argv) { open_spiel::hanabi::BasicHanabiTests(); }
+int main(int argc, char **argv) {
+  open_spiel::hanabi::BasicHanabiTests();
+  open_spiel::hanabi::ObservationTensorTest();
+}
@@ -19,6 +19,7 @@
 #include <utility>
 #include <vector>
 
+#include "open_spiel/abseil-cpp/absl/random/distributions.h"
 #include "open_spiel/game_parameters.h"
 #include "open_spiel/utils/tensor_view.h"
 
@@ -107,6 +108,14 @@ constexpr int kBitsSetTable64[] = {
     3, 4, 4, 5, 2, 3, 3, 4, 3, 4, 4, 5, 3, 4, 4, 5, 4, 5, 5, 6,
 };
 
+// The features of a group in its UnionFind: the corners it touches in the
+// low bits, and its edges above them.
+constexpr int kEdgeShift = 6;
+constexpr int kCornerMask = (1 << kEdgeShift) - 1;
+
+// The same number of random cells tried as in hex.
+constexpr int kMaxSampleTries = 16;
+
 }  // namespace
 
 int Move::Corner(int board_size) const {
@@ -147,9 +156,6 @@ std::string Move::ToString() const {
   return absl::StrCat(std::string(1, static_cast<char>('a' + x)), y + 1);
 }
 
-int HavannahState::Cell::NumCorners() const { return kBitsSetTable64[corner]; }
-int HavannahState::Cell::NumEdges() const { return kBitsSetTable64[edge]; }
-
 HavannahState::HavannahState(std::shared_ptr<const Game> game, int board_size,
                              bool ansi_color_output)
     : State(game),
@@ -160,10 +166,11 @@ HavannahState::HavannahState(std::shared_ptr<const Game> game, int board_size,
       neighbors_(get_neighbors(board_size)),
       ansi_color_output_(ansi_color_output) {
   board_.resize(board_diameter_ * board_diameter_);
+  groups_ = UnionFind(board_diameter_ * board_diameter_);
   for (int i = 0; i < board_.size(); i++) {
     Move m = ActionToMove(i);
-    board_[i] = Cell((m.OnBoard() ? kPlayerNone : kPlayerInvalid), i,
-                     m.Corner(board_size), m.Edge(board_size));
+    board_[i] = Cell(m.OnBoard() ? kPlayerNone : kPlayerInvalid);
+    groups_.Reset(i, m.Corner(board_size) | m.Edge(board_size) << kEdgeShift);
   }
 }
 
@@ -173,16 +180,38 @@ Move HavannahState::ActionToMove(Action action_id) const {
 }
 
 std::vector<Action> HavannahState::LegalActions() const {
-  // Can move in any empty cell.
   std::vector<Action> moves;
-  if (IsTerminal()) return {};
-  moves.reserve(board_.size() - moves_made_);
+  LegalActions(&moves);
+  return moves;
+}
+
+void HavannahState::LegalActions(std::vector<Action>* moves) const {
+  // Can move in any empty cell.
+  moves->clear();
+  if (IsTerminal()) return;
+  moves->reserve(board_.size() - moves_made_);
   for (int cell = 0; cell < board_.size(); ++cell) {
     if (board_[cell].player == kPlayerNone) {
-      moves.push_back(cell);
+      moves->push_back(cell);
     }
   }
-  return moves;
+}
+
+Action HavannahState::SampleRandomLegalAction(absl::BitGenRef rng) const {
+  // Samples as HexState does, but about a quarter of the random cells are off
+  // the hexagonal board, in the corners of the square that stores it.
+  SPIEL_CHECK_FALSE(IsTerminal());
+  for (int i = 0; i < kMaxSampleTries; ++i) {
+    int cell = absl::Uniform<int>(rng, 0, board_.size());
+    if (board_[cell].player == kPlayerNone) return cell;
+  }
+  int num_empty = 0;
+  for (const Cell& cell : board_) num_empty += cell.player == kPlayerNone;
+  int index = absl::Uniform<int>(rng, 0, num_empty);
+  for (int cell = 0; cell < board_.size(); ++cell) {
+    if (board_[cell].player == kPlayerNone && index-- == 0) return cell;
+  }
+  SpielFatalError("No empty cell to play in.");
 }
 
 std::string HavannahState::ActionToString(Player player,
@@ -329,7 +358,7 @@ void HavannahState::DoApplyAction(Action action) {
       skip = false;
     } else if (m.OnBoard()) {
       if (current_player_ == board_[m.xy].player) {
-        alreadyjoined |= JoinGroups(move.xy, m.xy);
+        alreadyjoined |= groups_.Join(move.xy, m.xy);
 
         // Skip the next one. If it is the same group, it is already connected
         // and forms a sharp corner, which we can ignore.
@@ -338,8 +367,9 @@ void HavannahState::DoApplyAction(Action action) {
     }
   }
 
-  const Cell& group = board_[FindGroupLeader(move.xy)];
-  if (group.NumEdges() >= 3 || group.NumCorners() >= 2 ||
+  const int features = groups_.Features(move.xy);
+  if (kBitsSetTable64[features >> kEdgeShift] >= 3 ||
+      kBitsSetTable64[features & kCornerMask] >= 2 ||
       (alreadyjoined && CheckRingDFS(move, 0, 3))) {
     outcome_ = current_player_;
   } else if (moves_made_ == valid_cells_) {
@@ -349,39 +379,6 @@ void HavannahState::DoApplyAction(Action action) {
   current_player_ = (current_player_ == kPlayer1 ? kPlayer2 : kPlayer1);
 }
 
-int HavannahState::FindGroupLeader(int cell) {
-  int parent = board_[cell].parent;
-  if (parent != cell) {
-    do {  // Follow the parent chain up to the group leader.
-      parent = board_[parent].parent;
-    } while (parent != board_[parent].parent);
-    // Do path compression, but only the current one to avoid recursion.
-    board_[cell].parent = parent;
-  }
-  return parent;
-}
-
-bool HavannahState::JoinGroups(int cell_a, int cell_b) {
-  int leader_a = FindGroupLeader(cell_a);
-  int leader_b = FindGroupLeader(cell_b);
-
-  if (leader_a == leader_b)  // Already the same group.
-    return true;
-
-  if (board_[leader_a].size < board_[leader_b].size) {
-    // Force group a's subtree to be bigger.
-    std::swap(leader_a, leader_b);
-  }
-
-  // Group b joins group a.
-  board_[leader_b].parent = leader_a;
-  board_[leader_a].size += board_[leader_b].size;
-  board_[leader_a].corner |= board_[leader_b].corner;
-  board_[leader_a].edge |= board_[leader_b].edge;
-
-  return false;
-}
-
 bool HavannahState::CheckRingDFS(const Move& move, int left, int right) {
   if (!move.OnBoard()) return false;
 
@@ -403,6 +400,22 @@ std::unique_ptr<State> HavannahState::Clone() const {
   return std::unique_ptr<State>(new HavannahState(*this));
 }
 
+bool HavannahState::CopyFrom(const State& other) {
+  const auto& state = static_cast<const HavannahState&>(other);
+  if (board_size_ != state.board_size_ ||
+      ansi_color_output_ != state.ansi_color_output_) {
+    return false;
+  }
+  State::operator=(state);
+  board_ = state.board_;
+  groups_ = state.groups_;
+  current_player_ = state.current_player_;
+  outcome_ = state.outcome_;
+  moves_made_ = state.moves_made_;
+  last_move_ = state.last_move_;
+  return true;
+}
+
 HavannahGame::HavannahGame(const GameParameters& params)
     : Game(kGameType, params),
       board_size_(ParameterValue<int>("board_size")),
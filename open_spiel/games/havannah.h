@@ -23,6 +23,7 @@
 #include <vector>
 
 #include "open_spiel/spiel.h"
+#include "open_spiel/utils/union_find.h"
 
 // https://en.wikipedia.org/wiki/Havannah
 // Does not implement pie rule to balance the game
@@ -94,12 +95,8 @@ typedef std::vector<std::array<Move, kMaxNeighbors>> NeighborList;
 
 // State of an in-play game.
 class HavannahState : public State {
-  // Represents a single cell on the board, as well as the structures needed for
-  // groups of cells. Groups of cells are defined by a union-find structure
-  // embedded in the array of cells. Following the `parent` indices will lead to
-  // the group leader which has the up to date size, corner and edge
-  // connectivity of that group. Size, corner and edge are not valid for any
-  // cell that is not a group leader.
+  // Represents a single cell on the board. The groups of cells, with the
+  // corners and edges they touch, are kept in groups_.
   struct Cell {
     // Who controls this cell.
     HavannahPlayer player;
@@ -108,29 +105,8 @@ class HavannahState : public State {
     // false except while running CheckRingDFS.
     bool mark;
 
-    // A parent index to allow finding the group leader. It is the leader of the
-    // group if it points to itself. Allows path compression to shorten the path
-    // from a direct parent to the leader.
-    uint16_t parent;
-
-    // These three are only defined for the group leader's cell.
-    uint16_t size;   // Size of this group of cells.
-    uint8_t corner;  // A bitset of which corners this group is connected to.
-    uint8_t edge;    // A bitset of which edges this group is connected to.
-
     Cell() {}
-    Cell(HavannahPlayer player_, int parent_, int corner_, int edge_)
-        : player(player_),
-          mark(false),
-          parent(parent_),
-          size(1),
-          corner(corner_),
-          edge(edge_) {}
-
-    // How many corner or edges this group of cell is connected to. Only defined
-    // if called on the group leader.
-    int NumCorners() const;
-    int NumEdges() const;
+    explicit Cell(HavannahPlayer player_) : player(player_), mark(false) {}
   };
 
  public:
@@ -154,18 +130,14 @@ class HavannahState : public State {
   void ObservationTensor(Player player,
                          std::vector<double>* values) const override;
   std::unique_ptr<State> Clone() const override;
+  bool CopyFrom(const State& other) override;
   std::vector<Action> LegalActions() const override;
+  void LegalActions(std::vector<Action>* actions) const override;
+  Action SampleRandomLegalAction(absl::BitGenRef rng) const override;
 
  protected:
   void DoApplyAction(Action action) override;
 
-  // Find the leader of the group. Not const due to union-find path compression.
-  int FindGroupLeader(int cell);
-
-  // Join the groups of two positions, propagating group size, and edge/corner
-  // connections. Returns true if they were already the same group.
-  bool JoinGroups(int cell_a, int cell_b);
-
   // Do a depth first search for a ring starting at `move`.
   // `left` and `right give the direction bounds for the search. A valid ring
   // won't take any sharp turns, only going in one of the 3 forward directions.
@@ -180,6 +152,9 @@ class HavannahState : public State {
 
  private:
   std::vector<Cell> board_;
+  // The groups of stones. Their features are the bitset of the corners they
+  // touch, and above it that of the edges.
+  UnionFind groups_;
   HavannahPlayer current_player_ = kPlayer1;
   HavannahPlayer outcome_ = kPlayerNone;
   const int board_size_;
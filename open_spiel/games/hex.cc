@@ -15,11 +15,13 @@
 #include "open_spiel/games/hex.h"
 
 #include <algorithm>
+#include <array>
 #include <memory>
 #include <utility>
 #include <vector>
 
-#include "open_spiel/utils/tensor_view.h"
+#include "open_spiel/abseil-cpp/absl/random/distributions.h"
+#include "open_spiel/utils/plane_encoding.h"
 
 namespace open_spiel {
 namespace hex {
@@ -50,8 +52,40 @@ std::shared_ptr<const Game> Factory(const GameParameters& params) {
 
 REGISTER_SPIEL_GAME(kGameType, Factory);
 
+// Random cells tried before counting the empty ones, when sampling a move.
+constexpr int kMaxSampleTries = 16;
+
+// The edges of a player, as features of their groups: north and south for
+// black, west and east for white.
+constexpr int kFirstEdge = 1;
+constexpr int kSecondEdge = 2;
+constexpr int kBothEdges = kFirstEdge | kSecondEdge;
+
+CellState PlayerColour(Player player) {
+  return player == 0 ? CellState::kBlack : CellState::kWhite;
+}
+
+CellState EdgesToState(Player player, int edges) {
+  static constexpr CellState kStates[kNumPlayers][kBothEdges + 1] = {
+      {CellState::kBlack, CellState::kBlackNorth, CellState::kBlackSouth,
+       CellState::kBlackWin},
+      {CellState::kWhite, CellState::kWhiteWest, CellState::kWhiteEast,
+       CellState::kWhiteWin}};
+  return kStates[player][edges];
+}
+
 }  // namespace
 
+int HexState::CellEdges(Player player, int cell) const {
+  if (player == 0) {
+    return (cell < board_size_ ? kFirstEdge : 0) |
+           (cell >= board_size_ * (board_size_ - 1) ? kSecondEdge : 0);
+  }
+  const int column = cell % board_size_;
+  return (column == 0 ? kFirstEdge : 0) |
+         (column == board_size_ - 1 ? kSecondEdge : 0);
+}
+
 CellState HexState::PlayerAndActionToState(Player player, Action move) const {
   // This function returns the CellState resulting from the given move.
   // The cell state tells us:
@@ -61,63 +95,30 @@ CellState HexState::PlayerAndActionToState(Player player, Action move) const {
   //   winning connection.
   //
   // We know the colour from the argument player
-  // For connectedness to the edges, we check if the move is in first/last
-  // row/column, or if any of the neighbours are the same colour and connected.
-  switch (player) {
-    case 0: {
-      bool north_connected = false;
-      bool south_connected = false;
-      if (move < board_size_) {  // First row
-        north_connected = true;
-      } else if (move >= board_size_ * (board_size_ - 1)) {  // Last row
-        south_connected = true;
-      }
-      for (int neighbour : AdjacentCells(move)) {
-        if (board_[neighbour] == CellState::kBlackNorth) {
-          north_connected = true;
-        } else if (board_[neighbour] == CellState::kBlackSouth) {
-          south_connected = true;
-        }
-      }
-      if (north_connected && south_connected) {
-        return CellState::kBlackWin;
-      } else if (north_connected) {
-        return CellState::kBlackNorth;
-      } else if (south_connected) {
-        return CellState::kBlackSouth;
-      } else {
-        return CellState::kBlack;
-      }
-    }
-    case 1: {
-      bool west_connected = false;
-      bool east_connected = false;
-      if (move % board_size_ == 0) {  // First column
-        west_connected = true;
-      } else if (move % board_size_ == board_size_ - 1) {  // Last column
-        east_connected = true;
-      }
-      for (int neighbour : AdjacentCells(move)) {
-        if (board_[neighbour] == CellState::kWhiteWest) {
-          west_connected = true;
-        } else if (board_[neighbour] == CellState::kWhiteEast) {
-          east_connected = true;
-        }
-      }
-      if (west_connected && east_connected) {
-        return CellState::kWhiteWin;
-      } else if (west_connected) {
-        return CellState::kWhiteWest;
-      } else if (east_connected) {
-        return CellState::kWhiteEast;
-      } else {
-        return CellState::kWhite;
-      }
+  // For connectedness to the edges, we check the edges the move is on, and
+  // those of the groups of the same colour it touches.
+  if (player != 0 && player != 1) {
+    SpielFatalError(absl::StrCat("Invalid player id ", player));
+  }
+  const CellState colour = PlayerColour(player);
+  int edges = CellEdges(player, move);
+  std::array<int, kMaxNeighbours> neighbours;
+  const int num_neighbours = AdjacentCells(move, &neighbours);
+  for (int i = 0; i < num_neighbours; ++i) {
+    if (board_[neighbours[i]] == colour) {
+      edges |= groups_.Features(neighbours[i]);
     }
-    default:
-      SpielFatalError(absl::StrCat("Invalid player id ", player));
-      return CellState::kEmpty;
   }
+  return EdgesToState(player, edges);
+}
+
+CellState HexState::BoardAt(int cell) const {
+  if (board_[cell] == CellState::kBlack) {
+    return EdgesToState(0, groups_.Features(cell));
+  } else if (board_[cell] == CellState::kWhite) {
+    return EdgesToState(1, groups_.Features(cell));
+  }
+  return board_[cell];
 }
 
 std::string StateToString(CellState state) {
@@ -148,51 +149,104 @@ std::string StateToString(CellState state) {
 
 void HexState::DoApplyAction(Action move) {
   SPIEL_CHECK_EQ(board_[move], CellState::kEmpty);
-  CellState move_cell_state = PlayerAndActionToState(CurrentPlayer(), move);
-  board_[move] = move_cell_state;
-
-  if (move_cell_state == CellState::kBlackWin) {
-    result_black_perspective_ = 1;
-  } else if (move_cell_state == CellState::kWhiteWin) {
-    result_black_perspective_ = -1;
-  } else if (move_cell_state != CellState::kBlack &&
-             move_cell_state != CellState::kWhite) {
-    // Move is connected to an edge but not winning.
-    // Update edge-connected groups with a flood-fill, to maintain that all edge
-    // connected nodes are known about.
-    // We don't do flood fill if a player has won, so it's impossible for a cell
-    // connected to an edge to be changed by the flood-fill.
-    CellState cell_state_to_change =
-        (current_player_ == 0 ? CellState::kBlack : CellState::kWhite);
-    // We assume that move can safely be cast to int
-    std::vector<int> flood_stack = {static_cast<int>(move)};
-    int latest_cell;
-    while (!flood_stack.empty()) {
-      latest_cell = flood_stack.back();
-      flood_stack.pop_back();
-      for (int neighbour : AdjacentCells(latest_cell)) {
-        if (board_[neighbour] == cell_state_to_change) {
-          // We make the change before putting the cell on the queue to avoid
-          // putting the same cell on the queue multiple times
-          board_[neighbour] = move_cell_state;
-          flood_stack.push_back(neighbour);
-        }
-      }
+  const CellState colour = PlayerColour(current_player_);
+  int edges = CellEdges(current_player_, move);
+  std::array<int, kMaxNeighbours> neighbours;
+  const int num_neighbours = AdjacentCells(move, &neighbours);
+  for (int i = 0; i < num_neighbours; ++i) {
+    if (board_[neighbours[i]] == colour) {
+      edges |= groups_.Features(neighbours[i]);
+    }
+  }
+
+  if (edges == kBothEdges) {
+    // The winning stone is not joined to its groups, which keep the edges
+    // they had.
+    board_[move] = EdgesToState(current_player_, edges);
+    result_black_perspective_ = current_player_ == 0 ? 1 : -1;
+  } else {
+    board_[move] = colour;
+    groups_.Reset(move, CellEdges(current_player_, move));
+    for (int i = 0; i < num_neighbours; ++i) {
+      if (board_[neighbours[i]] == colour) groups_.Join(move, neighbours[i]);
     }
   }
   current_player_ = 1 - current_player_;
 }
 
 std::vector<Action> HexState::LegalActions() const {
-  // Can move in any empty cell.
   std::vector<Action> moves;
-  if (IsTerminal()) return moves;
+  LegalActions(&moves);
+  return moves;
+}
+
+void HexState::LegalActions(std::vector<Action>* moves) const {
+  // Can move in any empty cell.
+  moves->clear();
+  if (IsTerminal()) return;
   for (int cell = 0; cell < board_.size(); ++cell) {
     if (board_[cell] == CellState::kEmpty) {
-      moves.push_back(cell);
+      moves->push_back(cell);
     }
   }
-  return moves;
+}
+
+void HexState::LegalActionsMask(Player player,
+                                absl::Span<uint8_t> mask) const {
+  SPIEL_CHECK_EQ(mask.size(), board_.size());
+  const bool to_play = player == CurrentPlayer();
+  for (int cell = 0; cell < board_.size(); ++cell) {
+    mask[cell] = to_play && board_[cell] == CellState::kEmpty;
+  }
+}
+
+Action HexState::SampleRandomLegalAction(absl::BitGenRef rng) const {
+  // Random cells are mostly empty until late in the game. Otherwise pick one
+  // of the empty cells, which is just as uniform.
+  SPIEL_CHECK_FALSE(IsTerminal());
+  for (int i = 0; i < kMaxSampleTries; ++i) {
+    int cell = absl::Uniform<int>(rng, 0, board_.size());
+    if (board_[cell] == CellState::kEmpty) return cell;
+  }
+  int index = absl::Uniform<int>(
+      rng, 0, std::count(board_.begin(), board_.end(), CellState::kEmpty));
+  for (int cell = 0; cell < board_.size(); ++cell) {
+    if (board_[cell] == CellState::kEmpty && index-- == 0) return cell;
+  }
+  SpielFatalError("No empty cell to play in.");
+}
+
+std::vector<double> HexState::RandomFillReturns(absl::BitGenRef rng) const {
+  if (IsTerminal()) return Returns();
+  std::vector<CellState> board = board_;
+  UnionFind groups = groups_;
+  std::vector<int> empty_cells;
+  for (int cell = 0; cell < board_.size(); ++cell) {
+    if (board_[cell] == CellState::kEmpty) empty_cells.push_back(cell);
+  }
+  std::shuffle(empty_cells.begin(), empty_cells.end(), rng);
+
+  Player player = current_player_;
+  std::array<int, kMaxNeighbours> neighbours;
+  for (int cell : empty_cells) {
+    const CellState colour = PlayerColour(player);
+    board[cell] = colour;
+    groups.Reset(cell, CellEdges(player, cell));
+    const int num_neighbours = AdjacentCells(cell, &neighbours);
+    for (int i = 0; i < num_neighbours; ++i) {
+      if (board[neighbours[i]] == colour) groups.Join(cell, neighbours[i]);
+    }
+    player = 1 - player;
+  }
+
+  // Exactly one of the players connects their edges on a full board.
+  for (int cell = 0; cell < board_size_; ++cell) {
+    if (board[cell] == CellState::kBlack &&
+        groups.Features(cell) == kBothEdges) {
+      return {1, -1};
+    }
+  }
+  return {-1, 1};
 }
 
 std::string HexState::ActionToString(Player player, Action action_id) const {
@@ -203,27 +257,30 @@ std::string HexState::ActionToString(Player player, Action action_id) const {
                       action_id / board_size_, ")");
 }
 
-std::vector<int> HexState::AdjacentCells(int cell) const {
-  std::vector<int> neighbours = {
-      cell - board_size_, cell - board_size_ + 1, cell - 1,
-      cell + 1,           cell + board_size_ - 1, cell + board_size_};
-  for (int i = kMaxNeighbours - 1; i >= 0; i--) {
-    // Check for invalid neighbours and remove
-    // Iterating in reverse to avoid changing the index of a candidate neighbour
-    if (neighbours[i] < 0 || (neighbours[i] >= board_size_ * board_size_) ||
-        (neighbours[i] % board_size_ == 0 &&
-         cell % board_size_ == board_size_ - 1) ||
-        (neighbours[i] % board_size_ == board_size_ - 1 &&
-         cell % board_size_ == 0)) {
-      neighbours.erase(neighbours.begin() + i);
+int HexState::AdjacentCells(
+    int cell, std::array<int, kMaxNeighbours>* neighbours) const {
+  const int row = cell / board_size_;
+  const int column = cell % board_size_;
+  int num_neighbours = 0;
+  if (row > 0) {
+    (*neighbours)[num_neighbours++] = cell - board_size_;
+    if (column < board_size_ - 1) {
+      (*neighbours)[num_neighbours++] = cell - board_size_ + 1;
     }
   }
-  return neighbours;
+  if (column > 0) (*neighbours)[num_neighbours++] = cell - 1;
+  if (column < board_size_ - 1) (*neighbours)[num_neighbours++] = cell + 1;
+  if (row < board_size_ - 1) {
+    if (column > 0) (*neighbours)[num_neighbours++] = cell + board_size_ - 1;
+    (*neighbours)[num_neighbours++] = cell + board_size_;
+  }
+  return num_neighbours;
 }
 
 HexState::HexState(std::shared_ptr<const Game> game, int board_size)
     : State(game), board_size_(board_size) {
   board_.resize(board_size * board_size, CellState::kEmpty);
+  groups_ = UnionFind(board_size * board_size);
 }
 
 std::string HexState::ToString() const {
@@ -239,7 +296,7 @@ std::string HexState::ToString() const {
       line_num++;
       absl::StrAppend(&str, std::string(line_num, ' '));
     }
-    absl::StrAppend(&str, StateToString(board_[cell]));
+    absl::StrAppend(&str, StateToString(BoardAt(cell)));
     absl::StrAppend(&str, " ");
   }
   return str;
@@ -269,17 +326,63 @@ void HexState::ObservationTensor(Player player,
   SPIEL_CHECK_GE(player, 0);
   SPIEL_CHECK_LT(player, num_players_);
 
-  TensorView<2> view(values, {kCellStates, static_cast<int>(board_.size())},
-                     true);
-  for (int cell = 0; cell < board_.size(); ++cell) {
-    view[{static_cast<int>(board_[cell]) - kMinValueCellState, cell}] = 1.0;
+  const int num_cells = board_.size();
+  values->resize(kCellStates * num_cells);
+  OneHotPlanes(
+      num_cells, kCellStates,
+      [this](int cell) {
+        return static_cast<int>(BoardAt(cell)) - kMinValueCellState;
+      },
+      absl::MakeSpan(*values));
+}
+
+bool HexState::UpdateObservationTensor(Player player,
+                                       absl::Span<float> values) const {
+  SPIEL_CHECK_GE(player, 0);
+  SPIEL_CHECK_LT(player, num_players_);
+  SPIEL_CHECK_FALSE(history_.empty());
+
+  // Besides the stone played, a move changes the edges of the groups it joins,
+  // which are next to it. So the changed cells are found by a flood fill from
+  // the stone over the cells whose planes are out of date.
+  const int num_cells = board_.size();
+  SPIEL_CHECK_EQ(values.size(), kCellStates * num_cells);
+  std::vector<int> cells = {static_cast<int>(history_.back())};
+  std::array<int, kMaxNeighbours> neighbours;
+  while (!cells.empty()) {
+    const int cell = cells.back();
+    cells.pop_back();
+    const int state = static_cast<int>(BoardAt(cell)) - kMinValueCellState;
+    bool changed = false;
+    for (int plane = 0; plane < kCellStates; ++plane) {
+      float& value = values[plane * num_cells + cell];
+      if (value != (plane == state)) {
+        value = plane == state;
+        changed = true;
+      }
+    }
+    if (!changed) continue;
+    const int num_neighbours = AdjacentCells(cell, &neighbours);
+    cells.insert(cells.end(), neighbours.begin(),
+                 neighbours.begin() + num_neighbours);
   }
+  return true;
+}
+
+int64_t HexState::ApproximateMemoryUsage() const {
+  return sizeof(*this) + HistoryMemoryUsage() +
+         board_.capacity() * sizeof(CellState) + groups_.HeapMemoryUsage();
 }
 
 std::unique_ptr<State> HexState::Clone() const {
   return std::unique_ptr<State>(new HexState(*this));
 }
 
+bool HexState::CopyFrom(const State& other) {
+  *this = static_cast<const HexState&>(other);
+  return true;
+}
+
 HexGame::HexGame(const GameParameters& params)
     : Game(kGameType, params), board_size_(ParameterValue<int>("board_size")) {}
 }  // namespace hex
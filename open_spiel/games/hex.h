@@ -22,6 +22,7 @@
 #include <vector>
 
 #include "open_spiel/spiel.h"
+#include "open_spiel/utils/union_find.h"
 
 // The classic game of Hex: https://en.wikipedia.org/wiki/Hex_(board_game)
 // Does not implement pie rule to balance the game
@@ -66,6 +67,7 @@ class HexState : public State {
   HexState(std::shared_ptr<const Game> game, int board_size);
 
   HexState(const HexState&) = default;
+  HexState& operator=(const HexState&) = default;
 
   Player CurrentPlayer() const override {
     return IsTerminal() ? kTerminalPlayerId : current_player_;
@@ -78,20 +80,42 @@ class HexState : public State {
   std::string ObservationString(Player player) const override;
   void ObservationTensor(Player player,
                          std::vector<double>* values) const override;
+  bool UpdateObservationTensor(Player player,
+                               absl::Span<float> values) const override;
   std::unique_ptr<State> Clone() const override;
+  bool CopyFrom(const State& other) override;
+  int64_t ApproximateMemoryUsage() const override;
   std::vector<Action> LegalActions() const override;
-  CellState BoardAt(int cell) const { return board_[cell]; }
+  void LegalActions(std::vector<Action>* actions) const override;
+  void LegalActionsMask(Player player,
+                        absl::Span<uint8_t> mask) const override;
+  Action SampleRandomLegalAction(absl::BitGenRef rng) const override;
+  CellState BoardAt(int cell) const;
+
+  // The returns of the game if the empty cells were played in a random order.
+  // Filling the board cannot change who connects their edges, so this is a
+  // random playout which only looks for the winner once, at the end.
+  std::vector<double> RandomFillReturns(absl::BitGenRef rng) const;
 
  protected:
+  // The colour of the stones, kBlack, kWhite or kEmpty, or the winning move.
+  // The edges the stones are connected to are those of their group.
   std::vector<CellState> board_;
   void DoApplyAction(Action move) override;
 
  private:
   CellState PlayerAndActionToState(Player player, Action move) const;
+  // The edges of the player the cell touches: 1 for north or west, 2 for
+  // south or east.
+  int CellEdges(Player player, int cell) const;
+  // Fills neighbours with the cells adjacent to cell, and returns their number.
+  int AdjacentCells(int cell,
+                    std::array<int, kMaxNeighbours>* neighbours) const;
   Player current_player_ = 0;                      // Player zero goes first
   double result_black_perspective_ = 0;            // 1 if Black (player 0) wins
-  std::vector<int> AdjacentCells(int cell) const;  // Cells adjacent to cell
-  const int board_size_;
+  // The groups of stones, with the edges of their player they touch.
+  UnionFind groups_;
+  int board_size_;
 };
 
 // Game object.
@@ -12,7 +12,16 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include "open_spiel/games/hex.h"
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/random/distributions.h"
 #include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
 #include "open_spiel/tests/basic_tests.h"
 
 namespace open_spiel {
@@ -28,8 +37,60 @@ void BasicHexTests() {
   testing::RandomSimTest(*LoadGame("hex"), 5);
 }
 
+void RandomFillTest() {
+  std::mt19937 rng(42);
+  std::shared_ptr<const Game> game = LoadGame("hex(board_size=5)");
+  for (int i = 0; i < 20; ++i) {
+    std::unique_ptr<State> state = game->NewInitialState();
+    while (true) {
+      const auto& hex_state = static_cast<const HexState&>(*state);
+      const std::vector<double> returns = hex_state.RandomFillReturns(rng);
+      if (state->IsTerminal()) {
+        SPIEL_CHECK_EQ(returns, state->Returns());
+        break;
+      }
+      SPIEL_CHECK_EQ(std::abs(returns[0]), 1);
+      SPIEL_CHECK_EQ(returns[0], -returns[1]);
+      std::vector<Action> actions = state->LegalActions();
+      state->ApplyAction(actions[absl::Uniform<int>(rng, 0, actions.size())]);
+    }
+  }
+
+  // On a 2x2 board, white wins whatever the order of the last two stones.
+  std::unique_ptr<State> state = LoadGame("hex(board_size=2)")->NewInitialState();
+  state->ApplyAction(0);
+  state->ApplyAction(2);
+  for (int i = 0; i < 10; ++i) {
+    SPIEL_CHECK_EQ(static_cast<const HexState&>(*state).RandomFillReturns(rng),
+                   (std::vector<double>{-1, 1}));
+  }
+}
+
+void EdgeConnectionTest() {
+  // The stones show the edges their group is connected to.
+  std::unique_ptr<State> state = LoadGame("hex(board_size=3)")->NewInitialState();
+  const auto& hex_state = static_cast<const HexState&>(*state);
+  state->ApplyAction(4);  // Black in the centre.
+  SPIEL_CHECK_EQ(hex_state.BoardAt(4), CellState::kBlack);
+  state->ApplyAction(3);  // White on the west edge.
+  SPIEL_CHECK_EQ(hex_state.BoardAt(3), CellState::kWhiteWest);
+  state->ApplyAction(1);  // Black joins the centre to the north edge.
+  SPIEL_CHECK_EQ(hex_state.BoardAt(1), CellState::kBlackNorth);
+  SPIEL_CHECK_EQ(hex_state.BoardAt(4), CellState::kBlackNorth);
+  state->ApplyAction(0);
+  SPIEL_CHECK_FALSE(state->IsTerminal());
+  state->ApplyAction(7);  // Black connects north and south.
+  SPIEL_CHECK_EQ(hex_state.BoardAt(7), CellState::kBlackWin);
+  SPIEL_CHECK_EQ(hex_state.BoardAt(4), CellState::kBlackNorth);
+  SPIEL_CHECK_EQ(state->Returns(), (std::vector<double>{1, -1}));
+}
+
 }  // namespace
 }  // namespace hex
 }  // namespace open_spiel
 
-int main(int argc, char** argv) { open_spiel::hex::BasicHexTests(); }
+int main(int argc, char** argv) {
+  open_spiel::hex::BasicHexTests();
+  open_spiel::hex::RandomFillTest();
+  open_spiel::hex::EdgeConnectionTest();
+}
@@ -179,6 +179,19 @@ std::string KuhnState::InformationStateString(Player player) const {
   return str;
 }
 
+// Same layout as the information state string, one byte per card or bet.
+std::string KuhnState::InformationStateKey(Player player) const {
+  SPIEL_CHECK_GE(player, 0);
+  SPIEL_CHECK_LT(player, num_players_);
+
+  std::string key;
+  if (history_.size() <= player) return key;
+  key.push_back(static_cast<char>(history_[player]));
+  for (int i = num_players_; i < history_.size(); ++i)
+    key.push_back(static_cast<char>(history_[i]));
+  return key;
+}
+
 // Observation is card then contributions to the pot, e.g. 111
 std::string KuhnState::ObservationString(Player player) const {
   SPIEL_CHECK_GE(player, 0);
@@ -254,11 +267,12 @@ void KuhnState::UndoAction(Player player, Action move) {
     // Undoing a bet / pass.
     if (move == ActionType::kBet) {
       pot_ -= 1;
+      ante_[player] -= kAnte;
       if (player == first_bettor_) first_bettor_ = kInvalidPlayer;
     }
     winner_ = kInvalidPlayer;
   }
-  history_.pop_back();
+  PopHistory();
 }
 
 std::vector<std::pair<Action, double>> KuhnState::ChanceOutcomes() const {
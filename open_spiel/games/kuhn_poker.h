@@ -56,6 +56,7 @@ class KuhnState : public State {
   bool IsTerminal() const override;
   std::vector<double> Returns() const override;
   std::string InformationStateString(Player player) const override;
+  std::string InformationStateKey(Player player) const override;
   std::string ObservationString(Player player) const override;
   void InformationStateTensor(Player player,
                               std::vector<double>* values) const override;
@@ -63,6 +64,7 @@ class KuhnState : public State {
                          std::vector<double>* values) const override;
   std::unique_ptr<State> Clone() const override;
   void UndoAction(Player player, Action move) override;
+  bool SupportsUndoAction() const override { return true; }
   std::vector<std::pair<Action, double>> ChanceOutcomes() const override;
   std::vector<Action> LegalActions() const override;
   std::vector<int> hand() const { return {card_dealt_[CurrentPlayer()]}; }
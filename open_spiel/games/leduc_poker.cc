@@ -23,6 +23,7 @@
 #include "open_spiel/abseil-cpp/absl/strings/str_join.h"
 #include "open_spiel/game_parameters.h"
 #include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/varint.h"
 
 namespace open_spiel {
 namespace leduc_poker {
@@ -79,7 +80,11 @@ LeducState::LeducState(std::shared_ptr<const Game> game)
       folded_(game->NumPlayers(), false),
       // Sequence of actions for each round. Needed to report information state.
       round1_sequence_(),
-      round2_sequence_() {
+      round2_sequence_(),
+      round1_string_(),
+      round2_string_(),
+      round1_key_(),
+      round2_key_() {
   // Cards by value (0-6 for standard 2-player game, kInvalidCard if no longer
   // in the deck.)
   deck_.resize(deck_size_);
@@ -236,10 +241,10 @@ std::string LeducState::ToString() const {
   }
 
   absl::StrAppend(&result, "\nRound 1 sequence: ");
-  absl::StrAppend(&result, absl::StrJoin(round1_sequence_, " "));
+  absl::StrAppend(&result, round1_string_);
 
   absl::StrAppend(&result, "\nRound 2 sequence: ");
-  absl::StrAppend(&result, absl::StrJoin(round2_sequence_, " "));
+  absl::StrAppend(&result, round2_string_);
 
   absl::StrAppend(&result, "\n");
 
@@ -273,8 +278,23 @@ std::string LeducState::InformationStateString(Player player) const {
       "[Round %i][Player: %i][Pot: %i][Money: %s[Private: %i]][Round1]: "
       "%s[Public: %i]\nRound 2 sequence: %s",
       round_, cur_player_, pot_, absl::StrJoin(money_, " "),
-      private_cards_[player], absl::StrJoin(round1_sequence_, " "),
-      public_card_, absl::StrJoin(round2_sequence_, " "));
+      private_cards_[player], round1_string_, public_card_, round2_string_);
+}
+
+// Packs the fields the information state string is built from. The pot and
+// money are determined by the betting sequences, so they are left out.
+std::string LeducState::InformationStateKey(Player player) const {
+  SPIEL_CHECK_GE(player, 0);
+  SPIEL_CHECK_LT(player, num_players_);
+  std::string key;
+  AppendVarint(round_, &key);
+  AppendSignedVarint(cur_player_, &key);
+  AppendSignedVarint(private_cards_[player], &key);
+  AppendSignedVarint(public_card_, &key);
+  AppendVarint(round1_sequence_.size(), &key);
+  key.append(round1_key_);
+  key.append(round2_key_);
+  return key;
 }
 
 // Observation is card then contribution of each players to the pot.
@@ -520,12 +540,19 @@ void LeducState::NewRound() {
 }
 
 void LeducState::SequenceAppendMove(int move) {
-  if (round_ == 1) {
-    round1_sequence_.push_back(move);
-  } else {
+  std::vector<int>* sequence = &round1_sequence_;
+  std::string* sequence_string = &round1_string_;
+  std::string* sequence_key = &round1_key_;
+  if (round_ != 1) {
     SPIEL_CHECK_EQ(round_, 2);
-    round2_sequence_.push_back(move);
+    sequence = &round2_sequence_;
+    sequence_string = &round2_string_;
+    sequence_key = &round2_key_;
   }
+  if (!sequence->empty()) sequence_string->push_back(' ');
+  absl::StrAppend(sequence_string, move);
+  AppendVarint(move, sequence_key);
+  sequence->push_back(move);
 }
 
 void LeducState::Ante(Player player, int amount) {
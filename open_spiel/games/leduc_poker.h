@@ -69,6 +69,7 @@ class LeducState : public State {
   bool IsTerminal() const override;
   std::vector<double> Returns() const override;
   std::string InformationStateString(Player player) const override;
+  std::string InformationStateKey(Player player) const override;
   std::string ObservationString(Player player) const override;
   void InformationStateTensor(Player player,
                               std::vector<double>* values) const override;
@@ -151,6 +152,12 @@ class LeducState : public State {
   // Sequence of actions for each round. Needed to report information state.
   std::vector<int> round1_sequence_;
   std::vector<int> round2_sequence_;
+  // The same sequences as they appear in the information state string and
+  // key, appended to move by move so that neither is rebuilt on every call.
+  std::string round1_string_;
+  std::string round2_string_;
+  std::string round1_key_;
+  std::string round2_key_;
 };
 
 class LeducGame : public Game {
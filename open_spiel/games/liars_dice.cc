@@ -19,6 +19,7 @@
 #include <utility>
 
 #include "open_spiel/game_parameters.h"
+#include "open_spiel/utils/varint.h"
 
 namespace open_spiel {
 namespace liars_dice {
@@ -27,7 +28,6 @@ namespace {
 // Default Parameters.
 constexpr int kDefaultPlayers = 2;
 constexpr int kDefaultNumDice = 1;
-constexpr int kDiceSides = 6;  // Number of sides on the dice.
 constexpr int kInvalidOutcome = -1;
 constexpr int kInvalidBid = -1;
 
@@ -74,7 +74,8 @@ LiarsDiceState::LiarsDiceState(std::shared_ptr<const Game> game,
       num_dice_(num_dice),
       num_dice_rolled_(game->NumPlayers(), 0),
       bidseq_(),
-      bidseq_str_() {
+      bidseq_str_(),
+      bidseq_key_() {
   for (int const& num_dices : num_dice_) {
     std::vector<int> initial_outcomes(num_dices, kInvalidOutcome);
     dice_outcomes_.push_back(initial_outcomes);
@@ -106,17 +107,11 @@ void LiarsDiceState::ResolveWinner() {
   std::pair<int, int> bid =
       LiarsDiceGame::GetQuantityFace(current_bid_, total_num_dice_);
   int quantity = bid.first, face = bid.second;
-  int matches = 0;
 
   // Count all the matches among all dice from all the players
   // kDiceSides (e.g. 6) is wild, so it always matches.
-  for (auto p = Player{0}; p < num_players_; p++) {
-    for (int d = 0; d < num_dice_[p]; d++) {
-      if (dice_outcomes_[p][d] == face || dice_outcomes_[p][d] == kDiceSides) {
-        matches++;
-      }
-    }
-  }
+  int matches = face_counts_[face - 1];
+  if (face != kDiceSides) matches += face_counts_[kDiceSides - 1];
 
   // If the number of matches are at least the quantity bid, then the bidder
   // wins. Otherwise, the caller wins.
@@ -141,6 +136,7 @@ void LiarsDiceState::DoApplyAction(Action action) {
     // Assign the roll.
     dice_outcomes_[cur_roller_][slot] = action;
     num_dice_rolled_[cur_roller_]++;
+    face_counts_[action - 1]++;
 
     // Check to see if we must change the roller.
     if (num_dice_rolled_[cur_roller_] == num_dice_[cur_roller_]) {
@@ -155,20 +151,22 @@ void LiarsDiceState::DoApplyAction(Action action) {
       }
     }
   } else {
-    // Check for legal actions.
-    if (!bidseq_.empty() && action <= bidseq_.back()) {
+    // Check for legal actions. Bids only go up, so the last one is the
+    // current bid.
+    if (action <= current_bid_) {
       SpielFatalError(absl::StrCat("Illegal action. ", action,
                                    " should be strictly higher than ",
-                                   bidseq_.back()));
+                                   current_bid_));
     }
+    bidseq_.push_back(action);
+    AppendBidString(action, &bidseq_str_);
+    AppendVarint(action, &bidseq_key_);
     if (action == total_num_dice_ * kDiceSides) {
       // This was the calling bid, game is over.
-      bidseq_.push_back(action);
       calling_player_ = cur_player_;
       ResolveWinner();
     } else {
       // Up the bid and move to the next player.
-      bidseq_.push_back(action);
       current_bid_ = action;
       bidding_player_ = cur_player_;
       cur_player_ = NextPlayerRoundRobin(cur_player_, num_players_);
@@ -178,6 +176,15 @@ void LiarsDiceState::DoApplyAction(Action action) {
   }
 }
 
+void LiarsDiceState::AppendBidString(int bid, std::string* out) const {
+  if (bid == total_num_dice_ * kDiceSides) {
+    absl::StrAppend(out, " Liar");
+  } else {
+    auto quantity_face = LiarsDiceGame::GetQuantityFace(bid, total_num_dice_);
+    absl::StrAppend(out, " ", quantity_face.first, "-", quantity_face.second);
+  }
+}
+
 std::vector<Action> LiarsDiceState::LegalActions() const {
   if (IsTerminal()) return {};
   // A chance node is a single die roll.
@@ -189,21 +196,38 @@ std::vector<Action> LiarsDiceState::LegalActions() const {
     return outcomes;
   }
 
+  const int liar = total_num_dice_ * kDiceSides;
   std::vector<Action> actions;
+  actions.reserve(liar - current_bid_);
 
   // Any move higher than the current bid is allowed. (Bids start at 0)
-  for (int b = current_bid_ + 1; b < total_num_dice_ * kDiceSides; b++) {
+  for (int b = current_bid_ + 1; b < liar; b++) {
     actions.push_back(b);
   }
 
   // Calling Liar is only available if at least one move has been made.
   if (total_moves_ > 0) {
-    actions.push_back(total_num_dice_ * kDiceSides);
+    actions.push_back(liar);
   }
 
   return actions;
 }
 
+std::unique_ptr<State> LiarsDiceState::ResampleFromInfostate(
+    int player_id, std::function<double()> rng) const {
+  // The bids don't depend on the dice, so the other players' dice are
+  // independent of what the player has seen and are simply rolled again.
+  std::unique_ptr<State> state = game_->NewInitialState();
+  auto& dice_state = static_cast<LiarsDiceState&>(*state);
+  for (Action action : history_) {
+    if (dice_state.IsChanceNode() && dice_state.cur_roller_ != player_id) {
+      action = SampleAction(dice_state.ChanceOutcomes(), rng()).first;
+    }
+    state->ApplyAction(action);
+  }
+  return state;
+}
+
 std::vector<std::pair<Action, double>> LiarsDiceState::ChanceOutcomes() const {
   SPIEL_CHECK_TRUE(IsChanceNode());
 
@@ -222,16 +246,18 @@ std::string LiarsDiceState::InformationStateString(Player player) const {
   SPIEL_CHECK_GE(player, 0);
   SPIEL_CHECK_LT(player, num_players_);
 
-  std::string result = absl::StrJoin(dice_outcomes_[player], "");
-  for (int b = 0; b < bidseq_.size(); b++) {
-    if (bidseq_[b] == total_num_dice_ * kDiceSides) {
-      absl::StrAppend(&result, " Liar");
-    } else {
-      auto bid = LiarsDiceGame::GetQuantityFace(bidseq_[b], total_num_dice_);
-      absl::StrAppend(&result, " ", bid.first, "-", bid.second);
-    }
-  }
-  return result;
+  return absl::StrCat(absl::StrJoin(dice_outcomes_[player], ""), bidseq_str_);
+}
+
+std::string LiarsDiceState::InformationStateKey(Player player) const {
+  SPIEL_CHECK_GE(player, 0);
+  SPIEL_CHECK_LT(player, num_players_);
+
+  std::string key;
+  AppendVarint(dice_outcomes_[player].size(), &key);
+  for (int outcome : dice_outcomes_[player]) AppendVarint(outcome, &key);
+  key.append(bidseq_key_);
+  return key;
 }
 
 std::string LiarsDiceState::ToString() const {
@@ -249,14 +275,7 @@ std::string LiarsDiceState::ToString() const {
                         cur_roller_);
   }
 
-  for (int b = 0; b < bidseq_.size(); b++) {
-    if (bidseq_[b] == total_num_dice_ * kDiceSides) {
-      absl::StrAppend(&result, " Liar");
-    } else {
-      auto bid = LiarsDiceGame::GetQuantityFace(bidseq_[b], total_num_dice_);
-      absl::StrAppend(&result, " ", bid.first, "-", bid.second);
-    }
-  }
+  absl::StrAppend(&result, bidseq_str_);
   return result;
 }
 
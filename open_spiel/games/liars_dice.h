@@ -16,6 +16,7 @@
 #define OPEN_SPIEL_GAMES_LIARS_DICE_H_
 
 #include <array>
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -35,6 +36,8 @@
 namespace open_spiel {
 namespace liars_dice {
 
+inline constexpr int kDiceSides = 6;  // Number of sides on the dice.
+
 class LiarsDiceGame;
 
 class LiarsDiceState : public State {
@@ -51,6 +54,7 @@ class LiarsDiceState : public State {
   bool IsTerminal() const override;
   std::vector<double> Returns() const override;
   std::string InformationStateString(Player player) const override;
+  std::string InformationStateKey(Player player) const override;
   void InformationStateTensor(
       Player player, std::vector<double>* values) const override;
   void ObservationTensor(
@@ -58,12 +62,16 @@ class LiarsDiceState : public State {
   std::unique_ptr<State> Clone() const override;
   std::vector<std::pair<Action, double>> ChanceOutcomes() const override;
   std::vector<Action> LegalActions() const override;
+  std::unique_ptr<State> ResampleFromInfostate(
+      int player_id, std::function<double()> rng) const override;
 
  protected:
   void DoApplyAction(Action action_id) override;
 
  private:
   void ResolveWinner();
+  // Appends the bid as it appears in the information state string.
+  void AppendBidString(int bid, std::string* out) const;
 
   // Initialized to invalid values. Use Game::NewInitialState().
   Player cur_player_;  // Player whose turn it is.
@@ -79,12 +87,18 @@ class LiarsDiceState : public State {
 
   // Dice outcomes: first indexed by player, then sorted by outcome.
   std::vector<std::vector<int>> dice_outcomes_;
+  // How many of all the dice rolled so far show each face, from 1, so that
+  // the call is resolved without going over the dice.
+  std::array<int, kDiceSides> face_counts_{};
   std::vector<int> num_dice_;         // How many dice each player has.
   std::vector<int> num_dice_rolled_;  // Number of dice currently rolled.
 
-  // Used to encode the information state.
+  // Used to encode the information state. The bids are also kept as they
+  // appear in InformationStateString and InformationStateKey, appended to
+  // as each bid is made, so that neither rebuilds the whole sequence.
   std::vector<int> bidseq_;
   std::string bidseq_str_;
+  std::string bidseq_key_;
 };
 
 class LiarsDiceGame : public Game {
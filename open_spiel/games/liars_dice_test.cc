@@ -12,7 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include "open_spiel/games/liars_dice.h"
 #include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
 #include "open_spiel/tests/basic_tests.h"
 
 namespace open_spiel {
@@ -25,6 +27,44 @@ void BasicLiarsDiceTests() {
   testing::LoadGameTest("liars_dice");
   testing::ChanceOutcomesTest(*LoadGame("liars_dice"));
   testing::RandomSimTest(*LoadGame("liars_dice"), 100);
+  testing::ResampleInfostateTest(*LoadGame("liars_dice"), /*num_sims=*/10);
+  testing::ResampleInfostateTest(
+      *LoadGame("liars_dice", {{"numdice", GameParameter(2)}}),
+      /*num_sims=*/10);
+}
+
+// Sixes are wild, so they count towards bids on any face, but only once
+// towards bids on sixes.
+void WildDiceTest() {
+  std::shared_ptr<const Game> game =
+      LoadGame("liars_dice", {{"numdice", GameParameter(2)}});
+  const int liar = game->NumDistinctActions() - 1;
+  auto bid = [](int quantity, int face) {
+    return (quantity - 1) * kDiceSides + face - 1;
+  };
+
+  // Two twos and a six make three twos.
+  std::unique_ptr<State> state = game->NewInitialState();
+  for (Action action : {2, 6, 2, 3, bid(3, 2), liar}) {
+    state->ApplyAction(action);
+  }
+  SPIEL_CHECK_TRUE(state->IsTerminal());
+  SPIEL_CHECK_EQ(state->Returns(), std::vector<double>({1.0, -1.0}));
+
+  // But the six doesn't make two sixes.
+  state = game->NewInitialState();
+  for (Action action : {2, 6, 2, 3, bid(1, 6), bid(2, 6), liar}) {
+    state->ApplyAction(action);
+  }
+  SPIEL_CHECK_TRUE(state->IsTerminal());
+  SPIEL_CHECK_EQ(state->Returns(), std::vector<double>({1.0, -1.0}));
+
+  // Nor do four threes.
+  state = game->NewInitialState();
+  for (Action action : {2, 6, 2, 3, bid(4, 3), liar}) {
+    state->ApplyAction(action);
+  }
+  SPIEL_CHECK_EQ(state->Returns(), std::vector<double>({-1.0, 1.0}));
 }
 
 }  // namespace
@@ -33,4 +73,5 @@ void BasicLiarsDiceTests() {
 
 int main(int argc, char** argv) {
   open_spiel::liars_dice::BasicLiarsDiceTests();
+  open_spiel::liars_dice::WildDiceTest();
 }
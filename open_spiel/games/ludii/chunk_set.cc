@@ -11,9 +11,10 @@
 // WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 // See the License for the specific language governing permissions and
 // limitations under the License.
-
 #include "open_spiel/games/ludii/chunk_set.h"
 
+#include "open_spiel/games/ludii/jni_cache.h"
+
 namespace open_spiel {
 namespace ludii {
 
@@ -21,30 +22,15 @@ ChunkSet::ChunkSet(JNIEnv *env, jobject chunkset)
     : env(env), chunkset(chunkset) {}
 
 std::string ChunkSet::Print() const {
-  jclass chunkSetClass = env->FindClass("util/ChunkSet");
-  jmethodID tostring_id =
-      env->GetMethodID(chunkSetClass, "toString", "()Ljava/lang/String;");
-  jstring string_obj = (jstring)env->CallObjectMethod(chunkset, tostring_id);
-
-  const char *rawString = env->GetStringUTFChars(string_obj, 0);
-  std::string cppString(rawString);
-  env->ReleaseStringUTFChars(string_obj, rawString);
-
-  return cppString;
+  jstring string_obj = (jstring)env->CallObjectMethod(
+      chunkset, GetJNICache(env).chunk_set_to_string);
+  return ToString(env, string_obj);
 }
 
 std::string ChunkSet::ToChunkString() const {
-  jclass chunkSetClass = env->FindClass("util/ChunkSet");
-  jmethodID toChunkString_id =
-      env->GetMethodID(chunkSetClass, "toChunkString", "()Ljava/lang/String;");
-  jstring string_obj =
-      (jstring)env->CallObjectMethod(chunkset, toChunkString_id);
-
-  const char *rawString = env->GetStringUTFChars(string_obj, 0);
-  std::string cppString(rawString);
-  env->ReleaseStringUTFChars(string_obj, rawString);
-
-  return cppString;
+  jstring string_obj = (jstring)env->CallObjectMethod(
+      chunkset, GetJNICache(env).chunk_set_to_chunk_string);
+  return ToString(env, string_obj);
 }
 
 }  // namespace ludii
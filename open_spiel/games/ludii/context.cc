@@ -11,22 +11,18 @@
 // WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 // See the License for the specific language governing permissions and
 // limitations under the License.
-
 #include "open_spiel/games/ludii/context.h"
 
 #include "open_spiel/games/ludii/game.h"
+#include "open_spiel/games/ludii/jni_cache.h"
 
 namespace open_spiel {
 namespace ludii {
 
 Context::Context(JNIEnv *env, Game game, Trial trial) : env(env) {
-  jclass context_class = env->FindClass("util/Context");
-  jmethodID context_const_id =
-      env->GetMethodID(context_class, "<init>", "(Lgame/Game;Lutil/Trial;)V");
-  jobject context_obj = env->NewObject(context_class, context_const_id,
-                                       game.GetObj(), trial.GetObj());
-
-  context = context_obj;
+  const JNICache &cache = GetJNICache(env);
+  context = env->NewObject(cache.context_class, cache.context_init,
+                           game.GetObj(), trial.GetObj());
 }
 
 jobject Context::GetObj() const { return context; }
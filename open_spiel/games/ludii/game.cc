@@ -11,10 +11,14 @@
 // WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 // See the License for the specific language governing permissions and
 // limitations under the License.
-
 #include "open_spiel/games/ludii/game.h"
 
+#include <random>
+#include <string>
+#include <vector>
+
 #include "open_spiel/games/ludii/context.h"
+#include "open_spiel/games/ludii/jni_cache.h"
 
 namespace open_spiel {
 namespace ludii {
@@ -27,63 +31,98 @@ std::string Game::GetPath() const { return game_path; }
 jobject Game::GetObj() const { return game; }
 
 std::string Game::GetName() const {
-  jclass gameClass = env->FindClass("game/Game");
-  jmethodID name_id =
-      env->GetMethodID(gameClass, "name", "()Ljava/lang/String;");
-  jstring stringArray = (jstring)env->CallObjectMethod(game, name_id);
-
-  // convert jstring game name to char array
-  const char *strReturn = env->GetStringUTFChars(stringArray, 0);
-  std::string string_name(strReturn);
-  env->ReleaseStringUTFChars(stringArray, strReturn);
-
-  return string_name;
+  const JNICache &cache = GetJNICache(env);
+  jstring name = (jstring)env->CallObjectMethod(game, cache.game_name);
+  return ToString(env, name);
 }
 
 void Game::Create(int viewSize) const {
-  jclass gameClass = env->FindClass("game/Game");
-  jmethodID create_id = env->GetMethodID(gameClass, "create", "(I)V");
-  env->CallVoidMethod(game, create_id, viewSize);
+  env->CallVoidMethod(game, GetJNICache(env).game_create, viewSize);
 }
 
 int Game::StateFlags() const {
-  jclass gameClass = env->FindClass("game/Game");
-  jmethodID stateFlags_id = env->GetMethodID(gameClass, "stateFlags", "()I");
-  return (int)env->CallIntMethod(game, stateFlags_id);
+  return (int)env->CallIntMethod(game, GetJNICache(env).game_state_flags);
 }
 
 Mode Game::GetMode() const {
-  jclass gameClass = env->FindClass("game/Game");
-  jmethodID mode_id = env->GetMethodID(gameClass, "mode", "()Lgame/mode/Mode;");
-  jobject mode = env->CallObjectMethod(game, mode_id);
+  jobject mode = env->CallObjectMethod(game, GetJNICache(env).game_mode);
   return Mode(env, mode);
 }
 
 void Game::Start(Context context) const {
-  jclass gameClass = env->FindClass("game/Game");
-  jmethodID start_id =
-      env->GetMethodID(gameClass, "start", "(Lutil/Context;)V");
-  env->CallVoidMethod(game, start_id, context.GetObj());
+  env->CallVoidMethod(game, GetJNICache(env).game_start, context.GetObj());
 }
 
 Moves Game::GetMoves(Context context) const {
-  jclass gameClass = env->FindClass("game/Game");
-  jmethodID moves_id = env->GetMethodID(
-      gameClass, "moves", "(Lutil/Context;)Lgame/rules/play/moves/Moves;");
-  jobject moves_obj = env->CallObjectMethod(game, moves_id, context.GetObj());
-  jclass clsObj = env->GetObjectClass(context.GetObj());
-
+  jobject moves_obj = env->CallObjectMethod(game, GetJNICache(env).game_moves,
+                                            context.GetObj());
   return Moves(env, moves_obj);
 }
 
 Move Game::Apply(Context context, Move move) const {
-  jclass gameClass = env->FindClass("game/Game");
-  jmethodID apply_id = env->GetMethodID(
-      gameClass, "apply", "(Lutil/Context;Lutil/Move;)Lutil/Move;");
+  jobject move_obj = env->CallObjectMethod(game, GetJNICache(env).game_apply,
+                                           context.GetObj(), move.GetObj());
+  return Move(env, move_obj);
+}
+
+Game::Step Game::ApplyAndGetMoves(Context context, Move move) const {
+  const JNICache &cache = GetJNICache(env);
+  jobject context_obj = context.GetObj();
   jobject move_obj =
-      env->CallObjectMethod(game, apply_id, context.GetObj(), move.GetObj());
+      env->CallObjectMethod(game, cache.game_apply, context_obj, move.GetObj());
+  Step step{Move(env, move_obj), {}, false, 0};
+
+  jobject trial_obj = env->CallObjectMethod(context_obj, cache.context_trial);
+  step.over = env->CallBooleanMethod(trial_obj, cache.trial_over);
+  jobject state_obj = env->CallObjectMethod(context_obj, cache.context_state);
+  step.mover = (int)env->CallIntMethod(state_obj, cache.state_mover);
+  env->DeleteLocalRef(trial_obj);
+  env->DeleteLocalRef(state_obj);
+  if (step.over) return step;
+
+  jobject moves_obj =
+      env->CallObjectMethod(game, cache.game_moves, context_obj);
+  jobject list_obj = env->CallObjectMethod(moves_obj, cache.moves_moves);
+  int num_moves = env->CallIntMethod(list_obj, cache.fast_array_list_size);
+  step.legal_moves.reserve(num_moves);
+  for (int i = 0; i < num_moves; ++i) {
+    step.legal_moves.push_back(Move(
+        env, env->CallObjectMethod(list_obj, cache.fast_array_list_get, i)));
+  }
+  env->DeleteLocalRef(moves_obj);
+  env->DeleteLocalRef(list_obj);
+  return step;
+}
 
-  return Move(env, move_obj);
+int Game::RandomPlayout(Context context, int max_num_moves, int seed) const {
+  const JNICache &cache = GetJNICache(env);
+  jobject context_obj = context.GetObj();
+  jobject trial_obj = env->CallObjectMethod(context_obj, cache.context_trial);
+  std::mt19937 rng(seed);
+  int num_moves = 0;
+  while (num_moves < max_num_moves &&
+         !env->CallBooleanMethod(trial_obj, cache.trial_over)) {
+    // Each move makes a handful of local references, which are dropped with
+    // their frame rather than piling up for the length of the trial.
+    env->PushLocalFrame(8);
+    jobject moves_obj =
+        env->CallObjectMethod(game, cache.game_moves, context_obj);
+    jobject list_obj = env->CallObjectMethod(moves_obj, cache.moves_moves);
+    int num_legal_moves =
+        env->CallIntMethod(list_obj, cache.fast_array_list_size);
+    if (num_legal_moves == 0) {
+      env->PopLocalFrame(nullptr);
+      break;
+    }
+    int index = std::uniform_int_distribution<int>(0, num_legal_moves - 1)(rng);
+    jobject move_obj =
+        env->CallObjectMethod(list_obj, cache.fast_array_list_get, index);
+    env->CallObjectMethod(game, cache.game_apply, context_obj, move_obj);
+    env->PopLocalFrame(nullptr);
+    ++num_moves;
+  }
+  env->DeleteLocalRef(trial_obj);
+  return num_moves;
 }
 
 }  // namespace ludii
@@ -16,6 +16,7 @@
 #define OPEN_SPIEL_GAMES_LUDII_GAME_H_
 
 #include <string>
+#include <vector>
 
 #include "jni.h"  // NOLINT
 #include "open_spiel/games/ludii/mode.h"
@@ -49,6 +50,24 @@ class Game {
 
   Move Apply(Context context, Move move) const;
 
+  // What the next move is chosen from, once a move is applied.
+  struct Step {
+    Move move;                      // As returned by Apply.
+    std::vector<Move> legal_moves;  // Empty once the trial is over.
+    bool over;
+    int mover;
+  };
+
+  // Applies the move and fetches the next legal moves, whether the trial is
+  // over and who moves next, with none of the lookups of the separate calls.
+  Step ApplyAndGetMoves(Context context, Move move) const;
+
+  // Plays uniformly random moves until the trial is over or max_num_moves
+  // moves are played, and returns the number played. The moves are never
+  // wrapped, and their references are dropped after each move, so the
+  // playout costs a few JNI calls a move.
+  int RandomPlayout(Context context, int max_num_moves, int seed) const;
+
  private:
   JNIEnv *env;
   jobject game;
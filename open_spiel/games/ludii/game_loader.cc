@@ -11,12 +11,13 @@
 // WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 // See the License for the specific language governing permissions and
 // limitations under the License.
-
 #include "open_spiel/games/ludii/game_loader.h"
 
 #include <cstring>
 #include <string>
 
+#include "open_spiel/games/ludii/jni_cache.h"
+
 namespace open_spiel {
 namespace ludii {
 
@@ -25,36 +26,30 @@ GameLoader::GameLoader(JNIEnv *env) : env(env) {}
 std::vector<std::string> GameLoader::ListGames() const {
   std::vector<std::string> gamesVector;
 
-  jclass gameLoader = env->FindClass("player/GameLoader");
-  jmethodID mid =
-      env->GetStaticMethodID(gameLoader, "listGames", "()[Ljava/lang/String;");
-  jobjectArray stringArray =
-      (jobjectArray)env->CallStaticObjectMethod(gameLoader, mid);
+  const JNICache &cache = GetJNICache(env);
+  jobjectArray stringArray = (jobjectArray)env->CallStaticObjectMethod(
+      cache.game_loader_class, cache.game_loader_list_games);
 
   int stringCount = env->GetArrayLength(stringArray);
+  gamesVector.reserve(stringCount);
 
   for (int i = 0; i < stringCount; i++) {
-    // get array element and convert it from jstring
     jstring string = (jstring)(env->GetObjectArrayElement(stringArray, i));
-    const char *rawString = env->GetStringUTFChars(string, 0);
-
-    std::string cppString(rawString);
-    gamesVector.push_back(cppString);
-
-    env->ReleaseStringUTFChars(string, rawString);
+    gamesVector.push_back(ToString(env, string));
+    env->DeleteLocalRef(string);
   }
 
   return gamesVector;
 }
 
 Game GameLoader::LoadGame(std::string game_name) const {
-  jclass gameLoader = env->FindClass("player/GameLoader");
-  jmethodID mid = env->GetStaticMethodID(gameLoader, "loadGameFromName",
-                                         "(Ljava/lang/String;)Lgame/Game;");
+  const JNICache &cache = GetJNICache(env);
 
   // convert game name to java string
   jstring j_game_name = env->NewStringUTF(game_name.c_str());
-  jobject game_obj = env->CallStaticObjectMethod(gameLoader, mid, j_game_name);
+  jobject game_obj = env->CallStaticObjectMethod(
+      cache.game_loader_class, cache.game_loader_load_game_from_name,
+      j_game_name);
 
   return Game(env, game_obj, game_name);
 }
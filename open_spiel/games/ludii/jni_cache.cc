@@ -0,0 +1,155 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/games/ludii/jni_cache.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace open_spiel {
+namespace ludii {
+namespace {
+
+jclass FindClass(JNIEnv *env, const char *name) {
+  jclass local_class = env->FindClass(name);
+  if (local_class == nullptr) {
+    std::cerr << "Ludii class not found: " << name << std::endl;
+    std::abort();
+  }
+  jclass global_class = static_cast<jclass>(env->NewGlobalRef(local_class));
+  env->DeleteLocalRef(local_class);
+  return global_class;
+}
+
+jmethodID GetMethodID(JNIEnv *env, jclass cls, const char *name,
+                      const char *signature) {
+  jmethodID method_id = env->GetMethodID(cls, name, signature);
+  if (method_id == nullptr) {
+    std::cerr << "Ludii method not found: " << name << signature << std::endl;
+    std::abort();
+  }
+  return method_id;
+}
+
+jmethodID GetStaticMethodID(JNIEnv *env, jclass cls, const char *name,
+                            const char *signature) {
+  jmethodID method_id = env->GetStaticMethodID(cls, name, signature);
+  if (method_id == nullptr) {
+    std::cerr << "Ludii method not found: " << name << signature << std::endl;
+    std::abort();
+  }
+  return method_id;
+}
+
+JNICache *NewJNICache(JNIEnv *env) {
+  JNICache *cache = new JNICache();
+
+  cache->game_class = FindClass(env, "game/Game");
+  cache->game_name = GetMethodID(env, cache->game_class, "name",
+                                 "()Ljava/lang/String;");
+  cache->game_create = GetMethodID(env, cache->game_class, "create", "(I)V");
+  cache->game_state_flags =
+      GetMethodID(env, cache->game_class, "stateFlags", "()I");
+  cache->game_mode =
+      GetMethodID(env, cache->game_class, "mode", "()Lgame/mode/Mode;");
+  cache->game_start =
+      GetMethodID(env, cache->game_class, "start", "(Lutil/Context;)V");
+  cache->game_moves =
+      GetMethodID(env, cache->game_class, "moves",
+                  "(Lutil/Context;)Lgame/rules/play/moves/Moves;");
+  cache->game_apply = GetMethodID(env, cache->game_class, "apply",
+                                  "(Lutil/Context;Lutil/Move;)Lutil/Move;");
+
+  cache->game_loader_class = FindClass(env, "player/GameLoader");
+  cache->game_loader_list_games =
+      GetStaticMethodID(env, cache->game_loader_class, "listGames",
+                        "()[Ljava/lang/String;");
+  cache->game_loader_load_game_from_name =
+      GetStaticMethodID(env, cache->game_loader_class, "loadGameFromName",
+                        "(Ljava/lang/String;)Lgame/Game;");
+
+  cache->mode_class = FindClass(env, "game/mode/Mode");
+  cache->mode_num_players =
+      GetMethodID(env, cache->mode_class, "numPlayers", "()I");
+
+  cache->context_class = FindClass(env, "util/Context");
+  cache->context_init = GetMethodID(env, cache->context_class, "<init>",
+                                    "(Lgame/Game;Lutil/Trial;)V");
+  cache->context_trial =
+      GetMethodID(env, cache->context_class, "trial", "()Lutil/Trial;");
+  cache->context_state =
+      GetMethodID(env, cache->context_class, "state", "()Lutil/state/State;");
+
+  cache->trial_class = FindClass(env, "util/Trial");
+  cache->trial_init =
+      GetMethodID(env, cache->trial_class, "<init>", "(Lgame/Game;)V");
+  cache->trial_state =
+      GetMethodID(env, cache->trial_class, "state", "()Lutil/state/State;");
+  cache->trial_over = GetMethodID(env, cache->trial_class, "over", "()Z");
+
+  cache->state_class = FindClass(env, "util/state/State");
+  cache->state_container_states =
+      GetMethodID(env, cache->state_class, "containerStates",
+                  "()[Lutil/state/containerState/ContainerState;");
+  cache->state_mover = GetMethodID(env, cache->state_class, "mover", "()I");
+
+  cache->container_state_class =
+      FindClass(env, "util/state/containerState/ContainerState");
+  cache->container_state_empty = GetMethodID(
+      env, cache->container_state_class, "empty", "()Lutil/Region;");
+  cache->container_state_clone_who = GetMethodID(
+      env, cache->container_state_class, "cloneWho", "()Lutil/ChunkSet;");
+  cache->container_state_clone_what = GetMethodID(
+      env, cache->container_state_class, "cloneWhat", "()Lutil/ChunkSet;");
+
+  cache->region_class = FindClass(env, "util/Region");
+  cache->region_bit_set =
+      GetMethodID(env, cache->region_class, "bitSet", "()Lutil/ChunkSet;");
+
+  cache->chunk_set_class = FindClass(env, "util/ChunkSet");
+  cache->chunk_set_to_string = GetMethodID(env, cache->chunk_set_class,
+                                           "toString", "()Ljava/lang/String;");
+  cache->chunk_set_to_chunk_string = GetMethodID(
+      env, cache->chunk_set_class, "toChunkString", "()Ljava/lang/String;");
+
+  cache->moves_class = FindClass(env, "game/rules/play/moves/Moves");
+  cache->moves_moves =
+      GetMethodID(env, cache->moves_class, "moves", "()Lmain/FastArrayList;");
+
+  cache->fast_array_list_class = FindClass(env, "main/FastArrayList");
+  cache->fast_array_list_size =
+      GetMethodID(env, cache->fast_array_list_class, "size", "()I");
+  cache->fast_array_list_get = GetMethodID(
+      env, cache->fast_array_list_class, "get", "(I)Ljava/lang/Object;");
+
+  return cache;
+}
+
+}  // namespace
+
+const JNICache &GetJNICache(JNIEnv *env) {
+  static const JNICache *cache = NewJNICache(env);
+  return *cache;
+}
+
+std::string ToString(JNIEnv *env, jstring string) {
+  const char *chars = env->GetStringUTFChars(string, 0);
+  std::string cpp_string(chars);
+  env->ReleaseStringUTFChars(string, chars);
+  return cpp_string;
+}
+
+}  // namespace ludii
+}  // namespace open_spiel
@@ -0,0 +1,91 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef OPEN_SPIEL_GAMES_LUDII_JNI_CACHE_H_
+#define OPEN_SPIEL_GAMES_LUDII_JNI_CACHE_H_
+
+#include <string>
+
+#include "jni.h"  // NOLINT
+
+namespace open_spiel {
+namespace ludii {
+
+// The Ludii classes and methods the wrappers call, looked up once per process
+// rather than at every call. The classes are held by global references, which
+// keeps them loaded, and so their method ids valid.
+struct JNICache {
+  jclass game_class;
+  jmethodID game_name;
+  jmethodID game_create;
+  jmethodID game_state_flags;
+  jmethodID game_mode;
+  jmethodID game_start;
+  jmethodID game_moves;
+  jmethodID game_apply;
+
+  jclass game_loader_class;
+  jmethodID game_loader_list_games;           // Static.
+  jmethodID game_loader_load_game_from_name;  // Static.
+
+  jclass mode_class;
+  jmethodID mode_num_players;
+
+  jclass context_class;
+  jmethodID context_init;
+  jmethodID context_trial;
+  jmethodID context_state;
+
+  jclass trial_class;
+  jmethodID trial_init;
+  jmethodID trial_state;
+  jmethodID trial_over;
+
+  jclass state_class;
+  jmethodID state_container_states;
+  jmethodID state_mover;
+
+  jclass container_state_class;
+  jmethodID container_state_empty;
+  jmethodID container_state_clone_who;
+  jmethodID container_state_clone_what;
+
+  jclass region_class;
+  jmethodID region_bit_set;
+
+  jclass chunk_set_class;
+  jmethodID chunk_set_to_string;
+  jmethodID chunk_set_to_chunk_string;
+
+  jclass moves_class;
+  jmethodID moves_moves;
+
+  jclass fast_array_list_class;
+  jmethodID fast_array_list_size;
+  jmethodID fast_array_list_get;
+};
+
+// The cache, filled on the first call, which must be made once the Ludii jar
+// is on the class path of the JVM. Later calls may come from any thread
+// attached to the same JVM.
+const JNICache& GetJNICache(JNIEnv *env);
+
+// Converts a Java string to a C++ one.
+std::string ToString(JNIEnv *env, jstring string);
+
+}  // namespace ludii
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_GAMES_LUDII_JNI_CACHE_H_
@@ -104,5 +104,17 @@ int main(int argc, char** argv) {
   // apply a move to the game
   ludii::Move move_after_apply = test_game.Apply(c, mv[0]);
 
+  // apply a move and get the next moves in one call
+  ludii::Game::Step step =
+      test_game.ApplyAndGetMoves(c, test_game.GetMoves(c).GetMoves()[0]);
+  std::cout << "next mover: " << step.mover
+            << ", legal moves: " << step.legal_moves.size() << std::endl;
+
+  // play out the rest of the trial at random
+  int num_moves = test_game.RandomPlayout(c, /*max_num_moves=*/1000,
+                                          /*seed=*/0);
+  std::cout << "random playout of " << num_moves
+            << " moves, over: " << t.Over() << std::endl;
+
   return 1;
 }
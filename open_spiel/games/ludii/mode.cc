@@ -11,18 +11,17 @@
 // WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 // See the License for the specific language governing permissions and
 // limitations under the License.
-
 #include "open_spiel/games/ludii/mode.h"
 
+#include "open_spiel/games/ludii/jni_cache.h"
+
 namespace open_spiel {
 namespace ludii {
 
 Mode::Mode(JNIEnv *env, jobject mode) : env(env), mode(mode) {}
 
 int Mode::NumPlayers() const {
-  jclass gameClass = env->FindClass("game/mode/Mode");
-  jmethodID stateFlags_id = env->GetMethodID(gameClass, "numPlayers", "()I");
-  return (int)env->CallIntMethod(mode, stateFlags_id);
+  return (int)env->CallIntMethod(mode, GetJNICache(env).mode_num_players);
 }
 
 }  // namespace ludii
@@ -11,9 +11,10 @@
 // WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 // See the License for the specific language governing permissions and
 // limitations under the License.
-
 #include "open_spiel/games/ludii/moves.h"
 
+#include "open_spiel/games/ludii/jni_cache.h"
+
 namespace open_spiel {
 namespace ludii {
 
@@ -22,21 +23,15 @@ Moves::Moves(JNIEnv *env, jobject moves) : env(env), moves(moves) {}
 std::vector<Move> Moves::GetMoves() const {
   std::vector<Move> moveVector;
 
-  jclass moves_class = env->FindClass("game/rules/play/moves/Moves");
-  jmethodID moves_id =
-      env->GetMethodID(moves_class, "moves", "()Lmain/FastArrayList;");
-  jobject moveFastArray_obj = env->CallObjectMethod(moves, moves_id);
-
-  jclass fastArray_class = env->FindClass("main/FastArrayList");
-  jmethodID fastArraySize_id = env->GetMethodID(fastArray_class, "size", "()I");
-  jmethodID fastArrayGet_id =
-      env->GetMethodID(fastArray_class, "get", "(I)Ljava/lang/Object;");
-
-  jint fastArraySize = env->CallIntMethod(moveFastArray_obj, fastArraySize_id);
+  const JNICache &cache = GetJNICache(env);
+  jobject moveFastArray_obj = env->CallObjectMethod(moves, cache.moves_moves);
+  jint fastArraySize =
+      env->CallIntMethod(moveFastArray_obj, cache.fast_array_list_size);
+  moveVector.reserve(fastArraySize);
 
   for (int i = 0; i < fastArraySize; i++) {
     jobject move_obj =
-        env->CallObjectMethod(moveFastArray_obj, fastArrayGet_id, i);
+        env->CallObjectMethod(moveFastArray_obj, cache.fast_array_list_get, i);
     moveVector.push_back(Move(env, move_obj));
   }
 
@@ -11,20 +11,18 @@
 // WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 // See the License for the specific language governing permissions and
 // limitations under the License.
-
 #include "open_spiel/games/ludii/region.h"
 
+#include "open_spiel/games/ludii/jni_cache.h"
+
 namespace open_spiel {
 namespace ludii {
 
 Region::Region(JNIEnv *env, jobject region) : env(env), region(region) {}
 
 ChunkSet Region::BitSet() const {
-  jclass regionClass = env->FindClass("util/Region");
-  jmethodID bitSet_id =
-      env->GetMethodID(regionClass, "bitSet", "()Lutil/ChunkSet;");
-  jobject chunkset_obj = env->CallObjectMethod(region, bitSet_id);
-
+  jobject chunkset_obj =
+      env->CallObjectMethod(region, GetJNICache(env).region_bit_set);
   return ChunkSet(env, chunkset_obj);
 }
 
@@ -11,9 +11,10 @@
 // WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 // See the License for the specific language governing permissions and
 // limitations under the License.
-
 #include "open_spiel/games/ludii/state.h"
 
+#include "open_spiel/games/ludii/jni_cache.h"
+
 namespace open_spiel {
 namespace ludii {
 
@@ -22,13 +23,10 @@ State::State(JNIEnv *env, jobject state) : env(env), state(state) {}
 std::vector<ContainerState> State::ContainerStates() const {
   std::vector<ContainerState> containerStateVector;
 
-  jclass stateClass = env->FindClass("util/state/State");
-  jmethodID containerStates_id =
-      env->GetMethodID(stateClass, "containerStates",
-                       "()[Lutil/state/containerState/ContainerState;");
-  jobjectArray containerStateArray =
-      (jobjectArray)env->CallObjectMethod(state, containerStates_id);
+  jobjectArray containerStateArray = (jobjectArray)env->CallObjectMethod(
+      state, GetJNICache(env).state_container_states);
   int containerStateCount = env->GetArrayLength(containerStateArray);
+  containerStateVector.reserve(containerStateCount);
 
   for (int i = 0; i < containerStateCount; i++) {
     jobject containerStateObj =
@@ -40,10 +38,7 @@ std::vector<ContainerState> State::ContainerStates() const {
 }
 
 int State::Mover() const {
-  jclass stateClass = env->FindClass("util/state/State");
-  jmethodID mover_id = env->GetMethodID(stateClass, "mover", "()I");
-
-  return (int)env->CallIntMethod(state, mover_id);
+  return (int)env->CallIntMethod(state, GetJNICache(env).state_mover);
 }
 
 }  // namespace ludii
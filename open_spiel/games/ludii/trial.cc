@@ -11,38 +11,28 @@
 // WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 // See the License for the specific language governing permissions and
 // limitations under the License.
-
 #include "open_spiel/games/ludii/trial.h"
 
+#include "open_spiel/games/ludii/jni_cache.h"
+
 namespace open_spiel {
 namespace ludii {
 
 Trial::Trial(JNIEnv *env, Game game) : env(env) {
-  jclass trial_class = env->FindClass("util/Trial");
-  jmethodID trial_const_id =
-      env->GetMethodID(trial_class, "<init>", "(Lgame/Game;)V");
-  jobject trial_obj =
-      env->NewObject(trial_class, trial_const_id, game.GetObj());
-
-  trial = trial_obj;
+  const JNICache &cache = GetJNICache(env);
+  trial = env->NewObject(cache.trial_class, cache.trial_init, game.GetObj());
 }
 
 jobject Trial::GetObj() const { return trial; }
 
 State Trial::GetState() const {
-  jclass trial_class = env->FindClass("util/Trial");
-  jmethodID state_id =
-      env->GetMethodID(trial_class, "state", "()Lutil/state/State;");
-  jobject state_obj = env->CallObjectMethod(trial, state_id);
-
+  jobject state_obj =
+      env->CallObjectMethod(trial, GetJNICache(env).trial_state);
   return State(env, state_obj);
 }
 
 bool Trial::Over() const {
-  jclass trial_class = env->FindClass("util/Trial");
-  jmethodID over_id = env->GetMethodID(trial_class, "over", "()Z");
-
-  return (bool)env->CallObjectMethod(trial, over_id);
+  return env->CallBooleanMethod(trial, GetJNICache(env).trial_over);
 }
 
 }  // namespace ludii
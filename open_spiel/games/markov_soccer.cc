@@ -14,11 +14,18 @@
 
 #include "open_spiel/games/markov_soccer.h"
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <memory>
+#include <random>
 #include <utility>
+#include <vector>
 
+#include "open_spiel/abseil-cpp/absl/types/span.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/utils/tensor_view.h"
+#include "open_spiel/vector_state.h"
 
 namespace open_spiel {
 namespace markov_soccer {
@@ -72,6 +79,160 @@ constexpr int kNumMovementActions = 5;
 
 constexpr std::array<int, 5> row_offsets = {{-1, 1, 0, 0, 0}};
 constexpr std::array<int, 5> col_offsets = {{0, 0, -1, 1, 0}};
+
+// Observation planes of the players without and with the ball, then of the
+// free ball and the empty cells.
+constexpr int kBallPlane = 4;
+constexpr int kEmptyPlane = 5;
+
+// Markov soccer for VectorState: the positions of the players and the ball in
+// every slot. The moves are resolved as in MarkovSoccerState::ResolveMove.
+class MarkovSoccerKernel : public BatchedKernel {
+ public:
+  MarkovSoccerKernel(const MarkovSoccerGame& game, int num_states)
+      : grid_(game.GetGrid()),
+        horizon_(game.MaxGameLength()),
+        ball_outcomes_(game.NewInitialState()->ChanceOutcomes()),
+        initiative_outcomes_({{kChanceInit0Action, 0.5},
+                              {kChanceInit1Action, 0.5}}),
+        ball_holder_(num_states),
+        ball_row_(num_states),
+        ball_col_(num_states),
+        winner_(num_states),
+        total_moves_(num_states) {
+    for (int p = 0; p < 2; ++p) {
+      player_row_[p].resize(num_states);
+      player_col_[p].resize(num_states);
+    }
+  }
+
+  void Reset(int begin, int end, absl::Span<std::mt19937> rngs) override {
+    for (int i = begin; i < end; ++i) ResetSlot(i, rngs[i]);
+  }
+
+  void Step(int begin, int end, absl::Span<const Action> actions,
+            absl::Span<std::mt19937> rngs, absl::Span<float> rewards,
+            absl::Span<float> dones) override {
+    for (int i = begin; i < end; ++i) {
+      const bool first_is_0 =
+          SampleAction(initiative_outcomes_, rngs[i]).first ==
+          kChanceInit0Action;
+      const Player first = first_is_0 ? 0 : 1;
+      ResolveMove(i, first, actions[2 * i + first]);
+      // A goal ends the episode, whatever the other move.
+      if (winner_[i] == kInvalidPlayer) {
+        ResolveMove(i, 1 - first, actions[2 * i + 1 - first]);
+      }
+      ++total_moves_[i];
+    }
+    for (int i = begin; i < end; ++i) {
+      const bool timeout = total_moves_[i] >= horizon_;
+      const bool done = timeout || winner_[i] != kInvalidPlayer;
+      const float reward =
+          timeout || !done ? 0 : winner_[i] == 0 ? 1 : -1;
+      rewards[2 * i] = reward;
+      rewards[2 * i + 1] = -reward;
+      dones[i] = done;
+      if (done) ResetSlot(i, rngs[i]);
+    }
+  }
+
+  void ObservationTensors(int begin, int end,
+                          absl::Span<float> values) const override {
+    const int num_cells = grid_.num_rows * grid_.num_cols;
+    const int size = kCellStates * num_cells;
+    for (int i = begin; i < end; ++i) {
+      float* planes = values.data() + 2 * i * size;
+      std::fill(planes, planes + kEmptyPlane * num_cells, 0);
+      std::fill(planes + kEmptyPlane * num_cells, planes + size, 1);
+      for (Player p = 0; p < 2; ++p) {
+        const int cell = player_row_[p][i] * grid_.num_cols +
+                         player_col_[p][i];
+        const int plane = 2 * p + (ball_holder_[i] == p ? 1 : 0);
+        planes[plane * num_cells + cell] = 1;
+        planes[kEmptyPlane * num_cells + cell] = 0;
+      }
+      if (ball_holder_[i] == kInvalidPlayer) {
+        const int cell = ball_row_[i] * grid_.num_cols + ball_col_[i];
+        planes[kBallPlane * num_cells + cell] = 1;
+        planes[kEmptyPlane * num_cells + cell] = 0;
+      }
+      // Both players observe the whole field.
+      std::copy(planes, planes + size, planes + size);
+    }
+  }
+
+  void LegalActionsMasks(int begin, int end,
+                         absl::Span<uint8_t> values) const override {
+    std::fill(values.begin() + 2 * begin * kNumMovementActions,
+              values.begin() + 2 * end * kNumMovementActions, 1);
+  }
+
+ private:
+  void ResetSlot(int i, std::mt19937& rng) {
+    player_row_[0][i] = grid_.a_start.first;
+    player_col_[0][i] = grid_.a_start.second;
+    player_row_[1][i] = grid_.b_start.first;
+    player_col_[1][i] = grid_.b_start.second;
+    const int ball_loc = SampleAction(ball_outcomes_, rng).first -
+                         kNumInitiativeChanceOutcomes;
+    ball_holder_[i] = kInvalidPlayer;
+    ball_row_[i] = grid_.ball_start_points[ball_loc].first;
+    ball_col_[i] = grid_.ball_start_points[ball_loc].second;
+    winner_[i] = kInvalidPlayer;
+    // Placing the ball counts as a move.
+    total_moves_[i] = 1;
+  }
+
+  void ResolveMove(int i, Player player, Action move) {
+    const int new_row = player_row_[player][i] + row_offsets[move];
+    const int new_col = player_col_[player][i] + col_offsets[move];
+    const bool has_ball = ball_holder_[i] == player;
+    if (new_row < 0 || new_col < 0 || new_row >= grid_.num_rows ||
+        new_col >= grid_.num_cols) {
+      // The goals are beyond rows 1 and 2 of the opponent's side.
+      const int goal_col = player == 0 ? grid_.num_cols : -1;
+      if (has_ball && (new_row == 1 || new_row == 2) && new_col == goal_col) {
+        winner_[i] = player;
+      }
+      return;
+    }
+    if (move == kStand) return;
+
+    const Player other = 1 - player;
+    if (new_row == player_row_[other][i] && new_col == player_col_[other][i]) {
+      // Running into the opponent loses the ball to them.
+      if (has_ball) ball_holder_[i] = other;
+      return;
+    }
+    if (ball_holder_[i] == kInvalidPlayer && new_row == ball_row_[i] &&
+        new_col == ball_col_[i]) {
+      ball_holder_[i] = player;
+    }
+    player_row_[player][i] = new_row;
+    player_col_[player][i] = new_col;
+  }
+
+  const Grid grid_;
+  const int horizon_;
+  const ActionsAndProbs ball_outcomes_;
+  const ActionsAndProbs initiative_outcomes_;
+  std::array<std::vector<int>, 2> player_row_;
+  std::array<std::vector<int>, 2> player_col_;
+  std::vector<Player> ball_holder_;  // kInvalidPlayer for a free ball.
+  std::vector<int> ball_row_;
+  std::vector<int> ball_col_;
+  std::vector<Player> winner_;
+  std::vector<int> total_moves_;
+};
+
+std::unique_ptr<BatchedKernel> KernelFactory(const Game& game,
+                                             int num_states) {
+  return std::make_unique<MarkovSoccerKernel>(
+      static_cast<const MarkovSoccerGame&>(game), num_states);
+}
+
+REGISTER_BATCHED_KERNEL("markov_soccer", KernelFactory);
 }  // namespace
 
 MarkovSoccerState::MarkovSoccerState(std::shared_ptr<const Game> game,
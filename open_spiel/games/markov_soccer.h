@@ -131,6 +131,7 @@ class MarkovSoccerGame : public SimMoveGame {
   }
   std::vector<int> ObservationTensorShape() const override;
   int MaxGameLength() const override { return horizon_; }
+  const Grid& GetGrid() const { return grid_; }
 
  private:
   Grid grid_;
@@ -0,0 +1,353 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/games/mean_field_games/crowd_modelling.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/types/span.h"
+#include "open_spiel/game_parameters.h"
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace crowd_modelling {
+namespace {
+
+const GameType kGameType{
+    /*short_name=*/"mfg_crowd_modelling",
+    /*long_name=*/"Mean Field Crowd Modelling",
+    GameType::Dynamics::kSequential,
+    GameType::ChanceMode::kExplicitStochastic,
+    GameType::Information::kPerfectInformation,
+    GameType::Utility::kGeneralSum,
+    GameType::RewardModel::kRewards,
+    /*max_num_players=*/kNumPlayers,
+    /*min_num_players=*/kNumPlayers,
+    /*provides_information_state_string=*/true,
+    /*provides_information_state_tensor=*/false,
+    /*provides_observation_string=*/true,
+    /*provides_observation_tensor=*/true,
+    /*parameter_specification=*/
+    {{"size", GameParameter(kDefaultSize)},
+     {"horizon", GameParameter(kDefaultHorizon)},
+     {"crowd_aversion", GameParameter(kDefaultCrowdAversion)}}};
+
+std::shared_ptr<const Game> Factory(const GameParameters& params) {
+  return std::shared_ptr<const Game>(new CrowdModellingGame(params));
+}
+
+REGISTER_SPIEL_GAME(kGameType, Factory);
+
+// The noise moves the agent like the actions, each with probability 1/3.
+constexpr double kNoiseProbability = 1.0 / kNumActions;
+
+// The position after a move (an action or noise).
+int Moved(int position, int move, int size) {
+  return (position + move - 1 + size) % size;
+}
+
+// The values of the policy or, if it is empty, of a best response, which is
+// then returned in best_response if it is not null. The Q-values of each time
+// are computed from the values of the next for all the positions at once.
+std::vector<double> Backward(const CrowdModellingGame& game,
+                             absl::Span<const double> flow,
+                             absl::Span<const double> policy,
+                             std::vector<double>* best_response) {
+  const int size = game.Size();
+  const int horizon = game.Horizon();
+  SPIEL_CHECK_EQ(flow.size(), (horizon + 1) * size);
+  if (best_response != nullptr) {
+    best_response->assign(horizon * size * kNumActions, 0);
+  }
+  std::vector<double> values((horizon + 1) * size, 0);
+  // The value after each action, before the noise.
+  std::vector<double> after_move(size);
+  std::vector<double> q_values(size * kNumActions);
+  for (int t = horizon - 1; t >= 0; --t) {
+    const double* next_values = &values[(t + 1) * size];
+    for (int x = 0; x < size; ++x) {
+      double value = 0;
+      for (int noise = 0; noise < kNumActions; ++noise) {
+        value += next_values[Moved(x, noise, size)];
+      }
+      after_move[x] = value * kNoiseProbability;
+    }
+    for (int x = 0; x < size; ++x) {
+      const double density = flow[t * size + x];
+      for (int a = 0; a < kNumActions; ++a) {
+        q_values[x * kNumActions + a] =
+            game.Reward(x, a, density) + after_move[Moved(x, a, size)];
+      }
+    }
+    double* step_values = &values[t * size];
+    for (int x = 0; x < size; ++x) {
+      const double* q = &q_values[x * kNumActions];
+      if (!policy.empty()) {
+        const double* probs = &policy[(t * size + x) * kNumActions];
+        double value = 0;
+        for (int a = 0; a < kNumActions; ++a) value += probs[a] * q[a];
+        step_values[x] = value;
+      } else {
+        const int best = std::max_element(q, q + kNumActions) - q;
+        step_values[x] = q[best];
+        if (best_response != nullptr) {
+          (*best_response)[(t * size + x) * kNumActions + best] = 1;
+        }
+      }
+    }
+  }
+  return values;
+}
+
+}  // namespace
+
+CrowdModellingState::CrowdModellingState(std::shared_ptr<const Game> game)
+    : State(game),
+      size_(static_cast<const CrowdModellingGame&>(*game).Size()),
+      horizon_(static_cast<const CrowdModellingGame&>(*game).Horizon()) {}
+
+Player CrowdModellingState::CurrentPlayer() const {
+  if (IsTerminal()) return kTerminalPlayerId;
+  if (position_ < 0 || moved_) return kChancePlayerId;
+  return 0;
+}
+
+std::vector<Action> CrowdModellingState::LegalActions() const {
+  if (IsTerminal()) return {};
+  if (position_ < 0) {
+    std::vector<Action> positions(size_);
+    for (int x = 0; x < size_; ++x) positions[x] = x;
+    return positions;
+  }
+  return {0, 1, 2};
+}
+
+ActionsAndProbs CrowdModellingState::ChanceOutcomes() const {
+  SPIEL_CHECK_TRUE(IsChanceNode());
+  // The population starts spread uniformly.
+  const int num_outcomes = position_ < 0 ? size_ : kNumActions;
+  ActionsAndProbs outcomes;
+  outcomes.reserve(num_outcomes);
+  for (int outcome = 0; outcome < num_outcomes; ++outcome) {
+    outcomes.emplace_back(outcome, 1.0 / num_outcomes);
+  }
+  return outcomes;
+}
+
+std::string CrowdModellingState::ActionToString(Player player,
+                                                Action action_id) const {
+  if (player == kChancePlayerId && position_ < 0) {
+    return absl::StrCat("init_position=", action_id);
+  }
+  const std::string move = action_id == 0   ? "left"
+                           : action_id == 1 ? "stay"
+                                            : "right";
+  return player == kChancePlayerId ? absl::StrCat("noise=", move) : move;
+}
+
+std::string CrowdModellingState::ToString() const {
+  if (position_ < 0) return "initial";
+  return absl::StrCat("(", position_, ", ", time_, ")", moved_ ? "_a" : "");
+}
+
+bool CrowdModellingState::IsTerminal() const { return time_ >= horizon_; }
+
+// The reward of an action is earned once the noise has been applied, at the
+// next decision.
+std::vector<double> CrowdModellingState::Rewards() const {
+  if (IsChanceNode()) return {0.0};
+  return {last_reward_};
+}
+
+std::vector<double> CrowdModellingState::Returns() const { return {return_}; }
+
+std::string CrowdModellingState::InformationStateString(Player player) const {
+  SPIEL_CHECK_GE(player, 0);
+  SPIEL_CHECK_LT(player, num_players_);
+  return HistoryString();
+}
+
+std::string CrowdModellingState::ObservationString(Player player) const {
+  SPIEL_CHECK_GE(player, 0);
+  SPIEL_CHECK_LT(player, num_players_);
+  return ToString();
+}
+
+void CrowdModellingState::ObservationTensor(Player player,
+                                            std::vector<double>* values) const {
+  SPIEL_CHECK_GE(player, 0);
+  SPIEL_CHECK_LT(player, num_players_);
+  values->assign(size_ + horizon_ + 1, 0);
+  if (position_ >= 0) (*values)[position_] = 1;
+  (*values)[size_ + time_] = 1;
+}
+
+std::unique_ptr<State> CrowdModellingState::Clone() const {
+  return std::unique_ptr<State>(new CrowdModellingState(*this));
+}
+
+void CrowdModellingState::SetDistributionFlow(std::vector<double> flow) {
+  SPIEL_CHECK_EQ(flow.size(), (horizon_ + 1) * size_);
+  flow_ = std::make_shared<const std::vector<double>>(std::move(flow));
+}
+
+double CrowdModellingState::Density() const {
+  if (flow_ == nullptr) return 1.0 / size_;
+  return (*flow_)[time_ * size_ + position_];
+}
+
+void CrowdModellingState::DoApplyAction(Action action) {
+  if (position_ < 0) {
+    position_ = action;
+    return;
+  }
+  if (!moved_) {
+    const auto& game = static_cast<const CrowdModellingGame&>(*game_);
+    last_reward_ = game.Reward(position_, action, Density());
+    return_ += last_reward_;
+  } else {
+    ++time_;
+  }
+  position_ = Moved(position_, action, size_);
+  moved_ = !moved_;
+}
+
+CrowdModellingGame::CrowdModellingGame(const GameParameters& params)
+    : Game(kGameType, params),
+      size_(ParameterValue<int>("size")),
+      horizon_(ParameterValue<int>("horizon")),
+      crowd_aversion_(ParameterValue<double>("crowd_aversion")) {
+  SPIEL_CHECK_GE(size_, 1);
+  SPIEL_CHECK_GE(horizon_, 1);
+  SPIEL_CHECK_GE(crowd_aversion_, 0);
+}
+
+double CrowdModellingGame::MaxUtility() const {
+  return horizon_ * (1 - crowd_aversion_ * std::log(kMinDensity));
+}
+
+double CrowdModellingGame::Reward(int position, Action action,
+                                  double density) const {
+  const double half = size_ / 2.0;
+  const double position_reward = 1 - std::abs(position - size_ / 2) / half;
+  const double crowd_reward =
+      -crowd_aversion_ * std::log(std::max(density, kMinDensity));
+  return std::max(position_reward, 0.0) + crowd_reward -
+         kMoveCost * std::abs(action - 1);
+}
+
+std::vector<double> UniformPolicy(const CrowdModellingGame& game) {
+  return std::vector<double>(game.Horizon() * game.Size() * kNumActions,
+                             1.0 / kNumActions);
+}
+
+std::vector<double> ForwardDistribution(const CrowdModellingGame& game,
+                                        absl::Span<const double> policy) {
+  const int size = game.Size();
+  const int horizon = game.Horizon();
+  SPIEL_CHECK_EQ(policy.size(), horizon * size * kNumActions);
+  std::vector<double> flow((horizon + 1) * size, 0);
+  std::fill(flow.begin(), flow.begin() + size, 1.0 / size);
+  // The distribution after the actions, before the noise.
+  std::vector<double> after_move(size);
+  for (int t = 0; t < horizon; ++t) {
+    const double* distribution = &flow[t * size];
+    const double* probs = &policy[t * size * kNumActions];
+    std::fill(after_move.begin(), after_move.end(), 0);
+    for (int x = 0; x < size; ++x) {
+      for (int a = 0; a < kNumActions; ++a) {
+        after_move[Moved(x, a, size)] +=
+            distribution[x] * probs[x * kNumActions + a];
+      }
+    }
+    double* next = &flow[(t + 1) * size];
+    for (int x = 0; x < size; ++x) {
+      for (int noise = 0; noise < kNumActions; ++noise) {
+        next[Moved(x, noise, size)] += after_move[x] * kNoiseProbability;
+      }
+    }
+  }
+  return flow;
+}
+
+std::vector<double> PolicyValues(const CrowdModellingGame& game,
+                                 absl::Span<const double> flow,
+                                 absl::Span<const double> policy) {
+  SPIEL_CHECK_EQ(policy.size(), game.Horizon() * game.Size() * kNumActions);
+  return Backward(game, flow, policy, nullptr);
+}
+
+std::vector<double> BestResponseValues(const CrowdModellingGame& game,
+                                       absl::Span<const double> flow,
+                                       std::vector<double>* best_response) {
+  return Backward(game, flow, {}, best_response);
+}
+
+double Exploitability(const CrowdModellingGame& game,
+                      absl::Span<const double> policy) {
+  const std::vector<double> flow = ForwardDistribution(game, policy);
+  const std::vector<double> policy_values = PolicyValues(game, flow, policy);
+  const std::vector<double> best_values =
+      BestResponseValues(game, flow, nullptr);
+  double exploitability = 0;
+  for (int x = 0; x < game.Size(); ++x) {
+    exploitability += flow[x] * (best_values[x] - policy_values[x]);
+  }
+  return exploitability;
+}
+
+std::vector<double> FictitiousPlay(const CrowdModellingGame& game,
+                                   int num_iterations) {
+  const int num_cells = game.Horizon() * game.Size();
+  std::vector<double> policy = UniformPolicy(game);
+  // The sums, over the policies played, of their flows, and of their flows
+  // times their policies: the average policy is their ratio.
+  std::vector<double> flow_sum = ForwardDistribution(game, policy);
+  std::vector<double> weighted_policy_sum(num_cells * kNumActions);
+  for (int i = 0; i < num_cells * kNumActions; ++i) {
+    weighted_policy_sum[i] = flow_sum[i / kNumActions] * policy[i];
+  }
+  std::vector<double> average_flow(flow_sum.size());
+  std::vector<double> best_response;
+  for (int iteration = 1; iteration <= num_iterations; ++iteration) {
+    for (int i = 0; i < flow_sum.size(); ++i) {
+      average_flow[i] = flow_sum[i] / iteration;
+    }
+    BestResponseValues(game, average_flow, &best_response);
+    const std::vector<double> flow = ForwardDistribution(game, best_response);
+    for (int i = 0; i < flow.size(); ++i) flow_sum[i] += flow[i];
+    for (int i = 0; i < num_cells * kNumActions; ++i) {
+      weighted_policy_sum[i] += flow[i / kNumActions] * best_response[i];
+    }
+  }
+  // Where no policy ever went, any policy will do.
+  for (int cell = 0; cell < num_cells; ++cell) {
+    const double weight = flow_sum[cell];
+    for (int a = 0; a < kNumActions; ++a) {
+      const int i = cell * kNumActions + a;
+      policy[i] =
+          weight > 0 ? weighted_policy_sum[i] / weight : 1.0 / kNumActions;
+    }
+  }
+  return policy;
+}
+
+}  // namespace crowd_modelling
+}  // namespace open_spiel
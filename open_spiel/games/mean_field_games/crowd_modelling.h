@@ -0,0 +1,184 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_GAMES_MEAN_FIELD_GAMES_CROWD_MODELLING_H_
+#define OPEN_SPIEL_GAMES_MEAN_FIELD_GAMES_CROWD_MODELLING_H_
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/types/span.h"
+#include "open_spiel/spiel.h"
+
+// A mean field game of crowd modelling, on a ring of positions: a population
+// of infinitely many agents, all starting spread uniformly, each moves left,
+// right or not at all at every step, after which noise moves it left, right
+// or not at all, with the same probability. An agent wants to be near the
+// middle of the ring, but also away from the crowd: the reward of a step is
+//   1 - |x - size / 2| / (size / 2) - crowd_aversion * log(mu_t(x))
+// less a cost for moving, where x is the position of the agent and mu_t(x)
+// the part of the population there at that time.
+//
+// The game is that of a representative agent, the population being given by
+// its distribution over the positions at each time (its flow), which is
+// uniform until SetDistributionFlow is called. A mean field equilibrium is a
+// policy which is a best response to the flow it produces when the whole
+// population plays it. The game can be played and solved with the usual
+// algorithms for a given flow, but the functions below work on the positions
+// and times all at once, to compute flows and values as fictitious play
+// needs them.
+//
+// Parameters:
+//   "size"            int     number of positions on the ring  (default = 10)
+//   "horizon"         int     number of steps                  (default = 10)
+//   "crowd_aversion"  double  weight of the crowd in rewards   (default = 1.0)
+
+namespace open_spiel {
+namespace crowd_modelling {
+
+inline constexpr int kNumPlayers = 1;
+inline constexpr int kNumActions = 3;  // Left, stay, right.
+inline constexpr int kDefaultSize = 10;
+inline constexpr int kDefaultHorizon = 10;
+inline constexpr double kDefaultCrowdAversion = 1.0;
+// The cost of a step left or right.
+inline constexpr double kMoveCost = 0.1;
+// The densities in rewards are at least this, so that they stay bounded.
+inline constexpr double kMinDensity = 1e-6;
+
+class CrowdModellingState : public State {
+ public:
+  explicit CrowdModellingState(std::shared_ptr<const Game> game);
+  CrowdModellingState(const CrowdModellingState&) = default;
+
+  Player CurrentPlayer() const override;
+  std::string ActionToString(Player player, Action action_id) const override;
+  std::string ToString() const override;
+  bool IsTerminal() const override;
+  std::vector<double> Rewards() const override;
+  std::vector<double> Returns() const override;
+  std::string InformationStateString(Player player) const override;
+  std::string ObservationString(Player player) const override;
+  void ObservationTensor(Player player,
+                         std::vector<double>* values) const override;
+  std::unique_ptr<State> Clone() const override;
+  std::vector<Action> LegalActions() const override;
+  ActionsAndProbs ChanceOutcomes() const override;
+
+  // Sets the flow of the population the rewards are computed from, as
+  // ForwardDistribution returns it. It is shared with the clones and the
+  // states reached from this one.
+  void SetDistributionFlow(std::vector<double> flow);
+
+  int Position() const { return position_; }
+  int Time() const { return time_; }
+
+ protected:
+  void DoApplyAction(Action action) override;
+
+ private:
+  double Density() const;
+
+  const int size_;
+  const int horizon_;
+  int position_ = -1;  // Until chance places the agent.
+  int time_ = 0;
+  // Whether the agent has moved and the noise is to be applied.
+  bool moved_ = false;
+  double last_reward_ = 0;
+  double return_ = 0;
+  // Uniform when null.
+  std::shared_ptr<const std::vector<double>> flow_;
+};
+
+class CrowdModellingGame : public Game {
+ public:
+  explicit CrowdModellingGame(const GameParameters& params);
+
+  std::unique_ptr<State> NewInitialState() const override {
+    return std::unique_ptr<State>(new CrowdModellingState(shared_from_this()));
+  }
+  std::shared_ptr<const Game> Clone() const override {
+    return std::shared_ptr<const Game>(new CrowdModellingGame(*this));
+  }
+  int NumDistinctActions() const override { return kNumActions; }
+  int MaxChanceOutcomes() const override {
+    return std::max(size_, kNumActions);
+  }
+  int NumPlayers() const override { return kNumPlayers; }
+  double MinUtility() const override { return -horizon_ * kMoveCost; }
+  double MaxUtility() const override;
+  int MaxGameLength() const override { return 2 * horizon_; }
+  // The position and the time, one-hot.
+  std::vector<int> ObservationTensorShape() const override {
+    return {size_ + horizon_ + 1};
+  }
+
+  int Size() const { return size_; }
+  int Horizon() const { return horizon_; }
+
+  // The reward of taking the action at the position, where the density of
+  // the population is the given one.
+  double Reward(int position, Action action, double density) const;
+
+ private:
+  const int size_;
+  const int horizon_;
+  const double crowd_aversion_;
+};
+
+// The functions below work with dense tables, over the times t from 0 to the
+// horizon and the positions x:
+//  - a flow gives the distribution of the population, flow[t * size + x],
+//    t going up to the horizon;
+//  - a policy gives the probability of each action,
+//    policy[(t * size + x) * kNumActions + action], for t below the horizon;
+//  - values give the expected return from each position and time,
+//    values[t * size + x], which is 0 at the horizon.
+
+// The policy taking each action with the same probability.
+std::vector<double> UniformPolicy(const CrowdModellingGame& game);
+
+// The flow of the population when every agent plays the policy.
+std::vector<double> ForwardDistribution(const CrowdModellingGame& game,
+                                        absl::Span<const double> policy);
+
+// The values of the policy for an agent in the population with this flow.
+std::vector<double> PolicyValues(const CrowdModellingGame& game,
+                                 absl::Span<const double> flow,
+                                 absl::Span<const double> policy);
+
+// The values of a best response to the flow, also returning a deterministic
+// best response in best_response if it is not null.
+std::vector<double> BestResponseValues(const CrowdModellingGame& game,
+                                       absl::Span<const double> flow,
+                                       std::vector<double>* best_response);
+
+// How much an agent would gain by deviating from the policy when the whole
+// population plays it: 0 exactly for an equilibrium.
+double Exploitability(const CrowdModellingGame& game,
+                      absl::Span<const double> policy);
+
+// Runs fictitious play for mean field games: each iteration adds a best
+// response to the average flow so far, and the average policy is the one
+// producing the average flow. Returns that policy.
+std::vector<double> FictitiousPlay(const CrowdModellingGame& game,
+                                   int num_iterations);
+
+}  // namespace crowd_modelling
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_GAMES_MEAN_FIELD_GAMES_CROWD_MODELLING_H_
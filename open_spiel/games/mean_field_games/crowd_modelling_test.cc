@@ -0,0 +1,136 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/games/mean_field_games/crowd_modelling.h"
+
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/tests/basic_tests.h"
+
+namespace open_spiel {
+namespace crowd_modelling {
+namespace {
+
+namespace testing = open_spiel::testing;
+
+void BasicCrowdModellingTests() {
+  testing::LoadGameTest("mfg_crowd_modelling");
+  testing::ChanceOutcomesTest(*LoadGame("mfg_crowd_modelling"));
+  testing::RandomSimTest(*LoadGame("mfg_crowd_modelling"), 100);
+}
+
+std::shared_ptr<const Game> SmallGame() {
+  return LoadGame("mfg_crowd_modelling",
+                  {{"size", GameParameter(5)}, {"horizon", GameParameter(3)}});
+}
+
+// A policy moving right where it can, and staying otherwise.
+std::vector<double> SomePolicy(const CrowdModellingGame& game) {
+  std::vector<double> policy(game.Horizon() * game.Size() * kNumActions, 0);
+  for (int cell = 0; cell < game.Horizon() * game.Size(); ++cell) {
+    policy[cell * kNumActions + (cell % 2 == 0 ? 2 : 1)] = 0.75;
+    policy[cell * kNumActions] = 0.25;
+  }
+  return policy;
+}
+
+// The expected return of the policy, from the states of the game.
+double ExpectedReturn(const CrowdModellingState& state,
+                      const std::vector<double>& policy, int size) {
+  if (state.IsTerminal()) return state.PlayerReturn(0);
+  ActionsAndProbs outcomes;
+  if (state.IsChanceNode()) {
+    outcomes = state.ChanceOutcomes();
+  } else {
+    for (Action a = 0; a < kNumActions; ++a) {
+      outcomes.emplace_back(
+          a, policy[(state.Time() * size + state.Position()) * kNumActions +
+                    a]);
+    }
+  }
+  double value = 0;
+  for (const auto& [action, prob] : outcomes) {
+    std::unique_ptr<State> child = state.Child(action);
+    value += prob * ExpectedReturn(
+                        static_cast<const CrowdModellingState&>(*child),
+                        policy, size);
+  }
+  return value;
+}
+
+void ForwardAndBackwardTest() {
+  std::shared_ptr<const Game> game = SmallGame();
+  const auto& crowd_game = static_cast<const CrowdModellingGame&>(*game);
+  const int size = crowd_game.Size();
+  const std::vector<double> policy = SomePolicy(crowd_game);
+  const std::vector<double> flow = ForwardDistribution(crowd_game, policy);
+  for (int t = 0; t <= crowd_game.Horizon(); ++t) {
+    SPIEL_CHECK_FLOAT_NEAR(std::accumulate(flow.begin() + t * size,
+                                           flow.begin() + (t + 1) * size, 0.0),
+                           1.0, 1e-12);
+  }
+
+  // The values match the returns of the game played with the flow.
+  const std::vector<double> values = PolicyValues(crowd_game, flow, policy);
+  std::unique_ptr<State> state = game->NewInitialState();
+  auto& crowd_state = static_cast<CrowdModellingState&>(*state);
+  crowd_state.SetDistributionFlow(flow);
+  double expected_return = 0;
+  for (int x = 0; x < size; ++x) expected_return += values[x] / size;
+  SPIEL_CHECK_FLOAT_NEAR(ExpectedReturn(crowd_state, policy, size),
+                         expected_return, 1e-9);
+
+  // So do those of the best response, which are higher.
+  std::vector<double> best_response;
+  const std::vector<double> best_values =
+      BestResponseValues(crowd_game, flow, &best_response);
+  for (int i = 0; i < values.size(); ++i) {
+    SPIEL_CHECK_GE(best_values[i], values[i] - 1e-12);
+  }
+  SPIEL_CHECK_FLOAT_NEAR(
+      ExpectedReturn(crowd_state, best_response, size),
+      std::accumulate(best_values.begin(), best_values.begin() + size, 0.0) /
+          size,
+      1e-9);
+}
+
+void FictitiousPlayTest() {
+  std::shared_ptr<const Game> game = LoadGame("mfg_crowd_modelling");
+  const auto& crowd_game = static_cast<const CrowdModellingGame&>(*game);
+  const double uniform_exploitability =
+      Exploitability(crowd_game, UniformPolicy(crowd_game));
+  SPIEL_CHECK_GT(uniform_exploitability, 0);
+  double exploitability = uniform_exploitability;
+  for (int num_iterations : {10, 100}) {
+    const double next_exploitability =
+        Exploitability(crowd_game, FictitiousPlay(crowd_game, num_iterations));
+    SPIEL_CHECK_GE(next_exploitability, 0);
+    SPIEL_CHECK_LT(next_exploitability, exploitability);
+    exploitability = next_exploitability;
+  }
+}
+
+}  // namespace
+}  // namespace crowd_modelling
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  open_spiel::crowd_modelling::BasicCrowdModellingTests();
+  open_spiel::crowd_modelling::ForwardAndBackwardTest();
+  open_spiel::crowd_modelling::FictitiousPlayTest();
+}
@@ -19,13 +19,17 @@
 #include <cstdint>
 #include <memory>
 #include <random>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "open_spiel/abseil-cpp/absl/random/poisson_distribution.h"
 #include "open_spiel/abseil-cpp/absl/random/uniform_int_distribution.h"
 #include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
 #include "open_spiel/abseil-cpp/absl/strings/str_join.h"
 #include "open_spiel/abseil-cpp/absl/strings/str_split.h"
+#include "open_spiel/abseil-cpp/absl/strings/strip.h"
+#include "open_spiel/abseil-cpp/absl/types/span.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
 
@@ -84,8 +88,8 @@ std::string NegotiationState::ActionToString(Player player,
       if (move_id == parent_game_.NumDistinctProposals() - 1) {
         absl::StrAppend(&action_string, "Proposal: Agreement reached!");
       } else {
-        std::vector<int> proposal = DecodeProposal(move_id);
-        std::string prop_str = absl::StrJoin(proposal, ", ");
+        std::string prop_str =
+            absl::StrJoin(parent_game_.ProposalQuantities(move_id), ", ");
         absl::StrAppend(&action_string, "Proposal: [", prop_str, "]");
       }
     } else {
@@ -113,16 +117,15 @@ std::vector<double> NegotiationState::Returns() const {
 
   int proposing_player = proposals_.size() % 2 == 1 ? 0 : 1;
   int other_player = 1 - proposing_player;
-  const std::vector<int>& final_proposal = proposals_.back();
+  const int final_proposal = ProposalIndex(proposals_.back());
 
+  // The other player gets what is left of the whole pool, the last proposal.
+  const ProposalTable& table = *proposal_table_;
   std::vector<double> returns(num_players_, 0.0);
-  for (int j = 0; j < num_items_; ++j) {
-    returns[proposing_player] +=
-        agent_utils_[proposing_player][j] * final_proposal[j];
-    returns[other_player] +=
-        agent_utils_[other_player][j] * (item_pool_[j] - final_proposal[j]);
-  }
-
+  returns[proposing_player] =
+      table.utilities[proposing_player][final_proposal];
+  returns[other_player] = table.utilities[other_player].back() -
+                          table.utilities[other_player][final_proposal];
   return returns;
 }
 
@@ -147,8 +150,10 @@ std::string NegotiationState::ObservationString(Player player) const {
   absl::StrAppend(&str, "Turn Type: ", TurnTypeToString(turn_type_), "\n");
 
   if (!proposals_.empty()) {
-    absl::StrAppend(&str, "Most recent proposal: [",
-                    absl::StrJoin(proposals_.back(), ", "), "]\n");
+    absl::StrAppend(
+        &str, "Most recent proposal: [",
+        absl::StrJoin(parent_game_.ProposalQuantities(proposals_.back()), ", "),
+        "]\n");
   }
 
   if (!utterances_.empty()) {
@@ -233,8 +238,8 @@ void NegotiationState::ObservationTensor(Player player,
 
   // Last proposal.
   if (!proposals_.empty()) {
-    for (int item = 0; item < num_items_; ++item) {
-      (*values)[offset + proposals_.back()[item]] = 1;
+    for (int quantity : parent_game_.ProposalQuantities(proposals_.back())) {
+      (*values)[offset + quantity] = 1;
       offset += kMaxQuantity + 1;
     }
   } else {
@@ -314,6 +319,66 @@ void NegotiationState::DetermineItemPoolAndUtilities() {
       }
     }
   }
+
+  BuildProposalTable();
+}
+
+void NegotiationState::SetItemPoolAndUtilities(
+    std::vector<int> item_pool, std::vector<std::vector<int>> agent_utils) {
+  SPIEL_CHECK_EQ(item_pool.size(), num_items_);
+  SPIEL_CHECK_EQ(agent_utils.size(), num_players_);
+  item_pool_ = std::move(item_pool);
+  agent_utils_ = std::move(agent_utils);
+  BuildProposalTable();
+}
+
+void NegotiationState::BuildProposalTable() {
+  auto table = std::make_shared<ProposalTable>();
+  table->strides.assign(num_items_, 1);
+  for (int i = num_items_ - 2; i >= 0; --i) {
+    table->strides[i] = table->strides[i + 1] * (item_pool_[i + 1] + 1);
+  }
+  const int num_proposals = table->strides[0] * (item_pool_[0] + 1);
+  table->proposals.reserve(num_proposals);
+  for (Player p = 0; p < num_players_; ++p) {
+    table->utilities[p].reserve(num_proposals);
+  }
+
+  // Count through the proposals: starting from the right, move left trying
+  // to increase a quantity. When successful, increment it and set all the
+  // quantities to its right back to 0.
+  std::vector<int> proposal(num_items_, 0);
+  int i = 0;
+  while (i >= 0) {
+    Action action = 0;
+    for (int quantity : proposal) {
+      action = action * (kMaxQuantity + 1) + quantity;
+    }
+    table->proposals.push_back(action);
+    for (Player p = 0; p < num_players_; ++p) {
+      int utility = 0;
+      for (int j = 0; j < num_items_; ++j) {
+        utility += agent_utils_[p][j] * proposal[j];
+      }
+      table->utilities[p].push_back(utility);
+    }
+
+    for (i = num_items_ - 1; i >= 0 && proposal[i] == item_pool_[i]; --i) {
+      proposal[i] = 0;
+    }
+    if (i >= 0) ++proposal[i];
+  }
+  SPIEL_CHECK_EQ(table->proposals.size(), num_proposals);
+  proposal_table_ = std::move(table);
+}
+
+int NegotiationState::ProposalIndex(Action proposal) const {
+  absl::Span<const int> quantities = parent_game_.ProposalQuantities(proposal);
+  int index = 0;
+  for (int i = 0; i < num_items_; ++i) {
+    index += quantities[i] * proposal_table_->strides[i];
+  }
+  return index;
 }
 
 void NegotiationState::InitializeEpisode() {
@@ -331,8 +396,7 @@ void NegotiationState::DoApplyAction(Action move_id) {
         // Agreement!
         agreement_reached_ = true;
       } else {
-        std::vector<int> proposal = DecodeProposal(move_id);
-        proposals_.push_back(proposal);
+        proposals_.push_back(move_id);
       }
 
       if (enable_utterances_) {
@@ -352,23 +416,6 @@ void NegotiationState::DoApplyAction(Action move_id) {
   }
 }
 
-bool NegotiationState::NextProposal(std::vector<int>* proposal) const {
-  // Starting from the right, move left trying to increase the value. When
-  // successful, increment the value and set all the right digits back to 0.
-  for (int i = num_items_ - 1; i >= 0; --i) {
-    if ((*proposal)[i] + 1 <= item_pool_[i]) {
-      // Success!
-      (*proposal)[i]++;
-      for (int j = i + 1; j < num_items_; ++j) {
-        (*proposal)[j] = 0;
-      }
-      return true;
-    }
-  }
-
-  return false;
-}
-
 std::vector<int> NegotiationState::DecodeInteger(int encoded_value,
                                                  int dimensions,
                                                  int num_digit_values) const {
@@ -393,12 +440,6 @@ int NegotiationState::EncodeInteger(const std::vector<int>& container,
   return encoded_value;
 }
 
-Action NegotiationState::EncodeProposal(
-    const std::vector<int>& proposal) const {
-  SPIEL_CHECK_EQ(proposal.size(), num_items_);
-  return EncodeInteger(proposal, kMaxQuantity + 1);
-}
-
 Action NegotiationState::EncodeUtterance(
     const std::vector<int>& utterance) const {
   SPIEL_CHECK_EQ(utterance.size(), utterance_dim_);
@@ -407,10 +448,6 @@ Action NegotiationState::EncodeUtterance(
          EncodeInteger(utterance, num_symbols_);
 }
 
-std::vector<int> NegotiationState::DecodeProposal(int encoded_proposal) const {
-  return DecodeInteger(encoded_proposal, num_items_, kMaxQuantity + 1);
-}
-
 std::vector<int> NegotiationState::DecodeUtterance(
     int encoded_utterance) const {
   // Utterance ids are offset from zero (starting at NumDistinctProposals()).
@@ -424,15 +461,11 @@ std::vector<Action> NegotiationState::LegalActions() const {
   } else if (IsTerminal()) {
     return {};
   } else if (turn_type_ == TurnType::kProposal) {
+    // Proposals are always enabled, so first add them.
+    const std::vector<Action>& proposals = proposal_table_->proposals;
     std::vector<Action> legal_actions;
-
-    // Proposals are always enabled, so first contruct them.
-    std::vector<int> proposal(num_items_, 0);
-    legal_actions.push_back(EncodeProposal(proposal));
-
-    while (NextProposal(&proposal)) {
-      legal_actions.push_back(EncodeProposal(proposal));
-    }
+    legal_actions.reserve(proposals.size() + 1);
+    legal_actions.assign(proposals.begin(), proposals.end());
 
     if (!proposals_.empty()) {
       // Add the agreement action only if there's been at least one proposal.
@@ -475,8 +508,10 @@ std::string NegotiationState::ToString() const {
   absl::StrAppend(&str, "Turn Type: ", TurnTypeToString(turn_type_), "\n");
 
   for (int i = 0; i < proposals_.size(); ++i) {
-    absl::StrAppend(&str, "Player ", i % 2, " proposes: [",
-                    absl::StrJoin(proposals_[i], ", "), "]");
+    absl::StrAppend(
+        &str, "Player ", i % 2, " proposes: [",
+        absl::StrJoin(parent_game_.ProposalQuantities(proposals_[i]), ", "),
+        "]");
     if (enable_utterances_ && i < utterances_.size()) {
       absl::StrAppend(&str, " utters: [", absl::StrJoin(utterances_[i], ", "),
                       "]");
@@ -509,6 +544,7 @@ NegotiationGame::NegotiationGame(const GameParameters& params)
       legal_utterances_({}),
       rng_(new std::mt19937(seed_ >= 0 ? seed_ : std::mt19937::default_seed)) {
   ConstructLegalUtterances();
+  ConstructProposalQuantities();
 }
 
 // Need to provide a custom copy constructor to clone the RNG.
@@ -521,6 +557,7 @@ NegotiationGame::NegotiationGame(const NegotiationGame& other)
       utterance_dim_(other.utterance_dim_),
       seed_(other.seed_),
       legal_utterances_(other.legal_utterances_),
+      proposal_quantities_(other.proposal_quantities_),
       rng_(new std::mt19937(*other.rng_)) {}
 
 void NegotiationGame::ConstructLegalUtterances() {
@@ -532,6 +569,19 @@ void NegotiationGame::ConstructLegalUtterances() {
   }
 }
 
+void NegotiationGame::ConstructProposalQuantities() {
+  const int num_proposals = NumDistinctProposals() - 1;
+  proposal_quantities_.resize(num_proposals * num_items_);
+  for (int proposal = 0; proposal < num_proposals; ++proposal) {
+    int encoded = proposal;
+    for (int i = num_items_ - 1; i >= 0; --i) {
+      proposal_quantities_[proposal * num_items_ + i] =
+          encoded % (kMaxQuantity + 1);
+      encoded /= kMaxQuantity + 1;
+    }
+  }
+}
+
 int NegotiationGame::MaxGameLength() const {
   if (enable_utterances_) {
     return 2 * kMaxSteps;  // Every step is two turns: proposal, then utterance.
@@ -580,29 +630,33 @@ std::unique_ptr<State> NegotiationGame::DeserializeState(
   if (str == "chance") {
     return NewInitialState();
   } else {
-    std::vector<std::string> lines = absl::StrSplit(str, '\n');
+    // Serialize ends the last line with a newline too.
+    std::vector<std::string> lines =
+        absl::StrSplit(absl::StripSuffix(str, "\n"), '\n');
     std::unique_ptr<State> state = NewInitialState();
     SPIEL_CHECK_EQ(lines.size(), 5);
     NegotiationState& nstate = static_cast<NegotiationState&>(*state);
     // Take the chance action, but then reset the quantities.
     nstate.ApplyAction(0);
-    nstate.ItemPool().clear();
-    nstate.AgentUtils().clear();
     // Max steps
     nstate.SetMaxSteps(std::stoi(lines[0]));
     // Item pool.
+    std::vector<int> item_pool;
     std::vector<std::string> parts = absl::StrSplit(lines[1], ' ');
     for (const auto& part : parts) {
-      nstate.ItemPool().push_back(std::stoi(part));
+      item_pool.push_back(std::stoi(part));
     }
     // Agent utilities.
+    std::vector<std::vector<int>> agent_utils;
     for (Player player : {0, 1}) {
       parts = absl::StrSplit(lines[2 + player], ' ');
-      nstate.AgentUtils().push_back({});
+      agent_utils.push_back({});
       for (const auto& part : parts) {
-        nstate.AgentUtils()[player].push_back(std::stoi(part));
+        agent_utils[player].push_back(std::stoi(part));
       }
     }
+    nstate.SetItemPoolAndUtilities(std::move(item_pool),
+                                   std::move(agent_utils));
     nstate.SetCurrentPlayer(0);
     // Actions.
     if (lines.size() == 5) {
@@ -15,11 +15,13 @@
 #ifndef OPEN_SPIEL_GAMES_NEGOTIATION_H_
 #define OPEN_SPIEL_GAMES_NEGOTIATION_H_
 
+#include <array>
 #include <memory>
 #include <random>
 #include <string>
 #include <vector>
 
+#include "open_spiel/abseil-cpp/absl/types/span.h"
 #include "open_spiel/spiel.h"
 
 // A simple negotiation game where agents propose splits of a group of items,
@@ -93,8 +95,8 @@ class NegotiationState : public State {
   const std::vector<std::vector<int>>& AgentUtils() const {
     return agent_utils_;
   }
-  std::vector<int>& ItemPool() { return item_pool_; }
-  std::vector<std::vector<int>>& AgentUtils() { return agent_utils_; }
+  void SetItemPoolAndUtilities(std::vector<int> item_pool,
+                               std::vector<std::vector<int>> agent_utils);
   void SetCurrentPlayer(Player p) { cur_player_ = p; }
   int MaxSteps() const { return max_steps_; }
   void SetMaxSteps(int max_steps) { max_steps_ = max_steps; }
@@ -110,17 +112,19 @@ class NegotiationState : public State {
   // Initialize state variables to start an episode.
   void InitializeEpisode();
 
-  // Get the next valid proposal; returns false when there are no more.
-  bool NextProposal(std::vector<int>* proposal) const;
+  // Builds the proposal table of the item pool and utilities.
+  void BuildProposalTable();
+
+  // The position of a legal proposal in the proposal table.
+  int ProposalIndex(Action proposal) const;
 
   // Action encoding and decoding helpers. Actions are encoded as follows:
   // the first values { 0, 1, ... , NumDistinctProposals() - 1 } are reserved
-  // for proposals, encoded in the usual way (fixed base). The next
-  // NumDistinctUtterances() values are reserved for utterances, so these begin
-  // at an offset of NumDistinctProposals().
-  Action EncodeProposal(const std::vector<int>& proposal) const;
+  // for proposals, encoded in the usual way (fixed base), see
+  // NegotiationGame::ProposalQuantities. The next NumDistinctUtterances()
+  // values are reserved for utterances, so these begin at an offset of
+  // NumDistinctProposals().
   Action EncodeUtterance(const std::vector<int>& utterance) const;
-  std::vector<int> DecodeProposal(int encoded_proposal) const;
   std::vector<int> DecodeUtterance(int encoded_utterance) const;
 
   std::vector<int> DecodeInteger(int encoded_value, int dimensions,
@@ -147,8 +151,21 @@ class NegotiationState : public State {
   // player i's utility for the jth item.
   std::vector<std::vector<int>> agent_utils_;
 
+  // The legal proposals for the item pool, in increasing order, and what
+  // each is worth to the players. The proposals are counted in the mixed
+  // radix of the item pool, so the position of one is the sum of its
+  // quantities times the strides, and the last is the whole pool. Built
+  // once the pool and utilities are known, and shared by the clones.
+  struct ProposalTable {
+    std::vector<Action> proposals;
+    std::vector<int> strides;
+    // utilities[p][i] is player p's utility for the items of proposals[i].
+    std::array<std::vector<int>, kNumPlayers> utilities;
+  };
+  std::shared_ptr<const ProposalTable> proposal_table_;
+
   // History of proposals.
-  std::vector<std::vector<int>> proposals_;
+  std::vector<Action> proposals_;
 
   // History of utterances.
   std::vector<std::vector<int>> utterances_;
@@ -195,8 +212,15 @@ class NegotiationGame : public Game {
     return legal_utterances_;
   }
 
+  // The quantity of each item in a proposal, excluding the agreement action.
+  absl::Span<const int> ProposalQuantities(Action proposal) const {
+    return absl::MakeConstSpan(proposal_quantities_)
+        .subspan(proposal * num_items_, num_items_);
+  }
+
  private:
   void ConstructLegalUtterances();
+  void ConstructProposalQuantities();
 
   bool enable_proposals_;
   bool enable_utterances_;
@@ -205,6 +229,8 @@ class NegotiationGame : public Game {
   int utterance_dim_;
   int seed_;
   std::vector<Action> legal_utterances_;
+  // The quantities of every proposal, num_items_ per proposal.
+  std::vector<int> proposal_quantities_;
   std::unique_ptr<std::mt19937> rng_;
 };
 
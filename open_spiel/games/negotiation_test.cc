@@ -12,7 +12,14 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include "open_spiel/games/negotiation.h"
+
+#include <memory>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/types/span.h"
 #include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
 #include "open_spiel/tests/basic_tests.h"
 
 namespace open_spiel {
@@ -49,10 +56,53 @@ void BasicNegotiationTests() {
       100);
 }
 
+void ProposalReturnsTest() {
+  std::shared_ptr<const Game> game =
+      LoadGame("negotiation", {{"enable_utterances", GameParameter(false)},
+                               {"rng_seed", GameParameter(7)}});
+  const auto& ngame = static_cast<const NegotiationGame&>(*game);
+  for (int episode = 0; episode < 20; ++episode) {
+    std::unique_ptr<State> state = game->NewInitialState();
+    state->ApplyAction(0);
+    const auto& nstate = static_cast<const NegotiationState&>(*state);
+    const std::vector<int>& item_pool = nstate.ItemPool();
+
+    // The proposals are those within the item pool, then the agreement.
+    std::vector<Action> proposals = state->LegalActions();
+    int num_proposals = 1;
+    for (int quantity : item_pool) num_proposals *= quantity + 1;
+    SPIEL_CHECK_EQ(proposals.size(), num_proposals);
+    for (Action proposal : proposals) {
+      absl::Span<const int> quantities = ngame.ProposalQuantities(proposal);
+      for (int i = 0; i < item_pool.size(); ++i) {
+        SPIEL_CHECK_LE(quantities[i], item_pool[i]);
+      }
+    }
+
+    const Action proposal = proposals[episode % proposals.size()];
+    state->ApplyAction(proposal);
+    state->ApplyAction(ngame.NumDistinctProposals() - 1);
+    SPIEL_CHECK_TRUE(state->IsTerminal());
+    absl::Span<const int> quantities = ngame.ProposalQuantities(proposal);
+    std::vector<double> expected(kNumPlayers, 0);
+    for (int i = 0; i < item_pool.size(); ++i) {
+      expected[0] += nstate.AgentUtils()[0][i] * quantities[i];
+      expected[1] +=
+          nstate.AgentUtils()[1][i] * (item_pool[i] - quantities[i]);
+    }
+    SPIEL_CHECK_EQ(state->Returns(), expected);
+
+    // The table is rebuilt for a deserialized state.
+    std::unique_ptr<State> copy = game->DeserializeState(state->Serialize());
+    SPIEL_CHECK_EQ(copy->Returns(), expected);
+  }
+}
+
 }  // namespace
 }  // namespace negotiation
 }  // namespace open_spiel
 
 int main(int argc, char** argv) {
   open_spiel::negotiation::BasicNegotiationTests();
+  open_spiel::negotiation::ProposalReturnsTest();
 }
@@ -22,7 +22,7 @@
 
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
-#include "open_spiel/utils/tensor_view.h"
+#include "open_spiel/utils/plane_encoding.h"
 
 namespace open_spiel {
 namespace othello {
@@ -69,6 +69,34 @@ inline std::string ColumnString(int col) {
   return std::string(1, "abcdefgh"[col]);
 }
 
+// The cells of the first and last columns.
+constexpr uint64_t kFirstColumn = 0x0101010101010101ULL;
+constexpr uint64_t kLastColumn = kFirstColumn << (kNumCols - 1);
+
+// Moves all the disks of a bitboard one cell in the direction, dropping those
+// which leave the board.
+inline uint64_t Shift(uint64_t disks, Direction dir) {
+  switch (dir) {
+    case kUp:
+      return disks >> kNumCols;
+    case kDown:
+      return disks << kNumCols;
+    case kLeft:
+      return (disks >> 1) & ~kLastColumn;
+    case kRight:
+      return (disks << 1) & ~kFirstColumn;
+    case kUpLeft:
+      return (disks >> (kNumCols + 1)) & ~kLastColumn;
+    case kUpRight:
+      return (disks >> (kNumCols - 1)) & ~kFirstColumn;
+    case kDownLeft:
+      return (disks << (kNumCols - 1)) & ~kLastColumn;
+    case kDownRight:
+      return (disks << (kNumCols + 1)) & ~kFirstColumn;
+  }
+  return 0;
+}
+
 }  // namespace
 
 Move Move::Next(Direction dir) const {
@@ -98,60 +126,45 @@ inline bool Move::OnBoard() const {
   return (row >= 0) && (row < kNumRows) && (col >= 0) && (col < kNumCols); 
 }
 
-int OthelloState::CountSteps(Player player, int action, Direction dir) const {
-  Move move(action);
-  move = move.Next(dir);
-
-  int count = 0;
-  CellState cell = PlayerToState(player);
-  while (move.OnBoard()) {
-    if (BoardAt(move) == cell) {
-      return count;
-    } else if (BoardAt(move) == CellState::kEmpty) {
-      return 0;
-    }
-
-    count++;
-    move = move.Next(dir);
-  }
-
-  return 0;
-}
-
-bool OthelloState::CanCapture(Player player, int move) const {
-  if (board_[move] != CellState::kEmpty) return false;
-
+uint64_t OthelloState::LegalMovesMask(Player player) const {
+  const uint64_t own = disks_[player];
+  const uint64_t opponent = disks_[1 - player];
+  const uint64_t empty = ~(own | opponent);
+  uint64_t moves = 0;
   for (auto direction : kDirections) {
-    if (CountSteps(player, move, direction) != 0) {
-      return true;
+    // The runs of up to six opponent disks next to the player's disks, and
+    // the empty cells just after them.
+    uint64_t run = Shift(own, direction) & opponent;
+    for (int i = 0; i < kNumCols - 3; ++i) {
+      run |= Shift(run, direction) & opponent;
     }
+    moves |= Shift(run, direction) & empty;
   }
-
-  return false;
+  return moves;
 }
 
-void OthelloState::Capture(Player player, int action, Direction dir, int steps) {
-  Move move(action);
-  move = move.Next(dir);
-  
-  CellState cell = PlayerToState(player);
-  for (int step = 0; step < steps; step++) {
-    if (BoardAt(move) == CellState::kEmpty || BoardAt(move) == cell) {
-      SpielFatalError(absl::StrCat("Cannot capture cell (", move.GetRow(), ", ", move.GetColumn(), ")"));
+uint64_t OthelloState::Captures(Player player, int action) const {
+  const uint64_t own = disks_[player];
+  const uint64_t opponent = disks_[1 - player];
+  uint64_t captures = 0;
+  for (auto direction : kDirections) {
+    uint64_t run = 0;
+    uint64_t cell = Shift(uint64_t{1} << action, direction);
+    while (cell & opponent) {
+      run |= cell;
+      cell = Shift(cell, direction);
     }
-
-    board_[move.GetAction()] = cell;
-    move = move.Next(dir);
+    if (cell & own) captures |= run;
   }
+  return captures;
 }
 
 int OthelloState::DiskCount(Player player) const {
-  return absl::c_count(board_, PlayerToState(player));
+  return __builtin_popcountll(disks_[player]);
 }
 
 bool OthelloState::NoValidActions() const {
-  return (LegalRegularActions(Player(0)).empty() &&
-          LegalRegularActions(Player(1)).empty());
+  return LegalMovesMask(Player(0)) == 0 && LegalMovesMask(Player(1)) == 0;
 }
 
 CellState PlayerToState(Player player) {
@@ -186,7 +199,8 @@ std::string StateToString(Player player, CellState state) {
 }
 
 bool OthelloState::ValidAction(Player player, int move) const {
-  return (board_[move] == CellState::kEmpty && CanCapture(player, move));
+  const uint64_t bit = uint64_t{1} << move;
+  return ((disks_[0] | disks_[1]) & bit) == 0 && Captures(player, move) != 0;
 }
 
 void OthelloState::DoApplyAction(Action action) {
@@ -197,15 +211,9 @@ void OthelloState::DoApplyAction(Action action) {
 
   SPIEL_CHECK_TRUE(ValidAction(current_player_, action));
 
-  CellState cell = PlayerToState(current_player_);
-  board_[action] = cell;
-
-  for (auto direction : kDirections) {
-    int steps = CountSteps(current_player_, action, direction);
-    if (steps > 0) {
-      Capture(current_player_, action, direction, steps);
-    }
-  }
+  const uint64_t captures = Captures(current_player_, action);
+  disks_[current_player_] |= captures | (uint64_t{1} << action);
+  disks_[1 - current_player_] &= ~captures;
 
   if (NoValidActions()) {  // check for end game state
     int count_zero = DiskCount(Player(0));
@@ -225,10 +233,8 @@ void OthelloState::DoApplyAction(Action action) {
 
 std::vector<Action> OthelloState::LegalRegularActions(Player p) const {
   std::vector<Action> moves;
-  for (int cell = 0; cell < kNumCells; ++cell) {
-    if (ValidAction(p, cell)) {
-      moves.push_back(cell);
-    }
+  for (uint64_t mask = LegalMovesMask(p); mask; mask &= mask - 1) {
+    moves.push_back(__builtin_ctzll(mask));
   }
   return moves;
 }
@@ -251,11 +257,10 @@ std::string OthelloState::ActionToString(Player player,
 }
 
 OthelloState::OthelloState(std::shared_ptr<const Game> game) : State(game) {
-  absl::c_fill(board_, CellState::kEmpty);
-  board_[Move(3, 3).GetAction()] = CellState::kWhite;
-  board_[Move(3, 4).GetAction()] = CellState::kBlack;
-  board_[Move(4, 3).GetAction()] = CellState::kBlack;
-  board_[Move(4, 4).GetAction()] = CellState::kWhite;
+  disks_[0] = (uint64_t{1} << Move(3, 4).GetAction()) |
+              (uint64_t{1} << Move(4, 3).GetAction());
+  disks_[1] = (uint64_t{1} << Move(3, 3).GetAction()) |
+              (uint64_t{1} << Move(4, 4).GetAction());
 }
 
 std::string OthelloState::ToString(Player player) const {
@@ -307,24 +312,27 @@ void OthelloState::ObservationTensor(Player player,
   SPIEL_CHECK_GE(player, 0);
   SPIEL_CHECK_LT(player, num_players_);
 
-  // Treat `values` as a 2-d tensor.
-  TensorView<2> view(values, {kCellStates, kNumCells}, true);
+  // The planes of the empty cells, the player's disks and the opponent's.
+  values->resize(kCellStates * kNumCells);
+  absl::Span<double> planes = absl::MakeSpan(*values);
+  BitboardPlane(~(disks_[0] | disks_[1]), planes.subspan(0, kNumCells));
+  BitboardPlane(disks_[player], planes.subspan(kNumCells, kNumCells));
+  BitboardPlane(disks_[1 - player], planes.subspan(2 * kNumCells, kNumCells));
+}
 
-  for (int cell = 0; cell < kNumCells; ++cell) {
-    if (board_[cell] == CellState::kEmpty) {
-      view[{0, cell}] = 1;
-    } else if (board_[cell] == PlayerToState(player)) {
-      view[{1, cell}] = 1;
-    } else {  // Opponent's piece
-      view[{2, cell}] = 1;
-    }
-  }
+int64_t OthelloState::ApproximateMemoryUsage() const {
+  return sizeof(*this) + HistoryMemoryUsage();
 }
 
 std::unique_ptr<State> OthelloState::Clone() const {
   return std::unique_ptr<State>(new OthelloState(*this));
 }
 
+bool OthelloState::CopyFrom(const State& other) {
+  *this = static_cast<const OthelloState&>(other);
+  return true;
+}
+
 OthelloGame::OthelloGame(const GameParameters& params)
     : Game(kGameType, params) {}
 
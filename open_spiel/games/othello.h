@@ -16,12 +16,12 @@
 #define OPEN_SPIEL_GAMES_OTHELLO_H_
 
 #include <array>
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <string>
 #include <vector>
 
-#include "open_spiel/abseil-cpp/absl/algorithm/container.h"  // for c_fill
 #include "open_spiel/spiel.h"
 
 // Simple game of Othello:
@@ -80,6 +80,8 @@ private:
   int row, col;
 };
 
+CellState PlayerToState(Player player);
+
 // State of an in-play game.
 class OthelloState : public State {
  public:
@@ -100,14 +102,23 @@ class OthelloState : public State {
   void ObservationTensor(Player player,
                          std::vector<double>* values) const override;
   std::unique_ptr<State> Clone() const override;
+  bool CopyFrom(const State& other) override;
+  int64_t ApproximateMemoryUsage() const override;
   std::vector<Action> LegalActions() const override;
 
+  // The bitboard of the player's disks, with the cell of action a as bit a.
+  uint64_t Disks(Player player) const { return disks_[player]; }
+
  private:
-  std::array<CellState, kNumCells> board_;
+  // The disks of each player, as bitboards.
+  std::array<uint64_t, kNumPlayers> disks_;
   void DoApplyAction(Action move) override;
 
   CellState BoardAt(int row, int col) const {
-    return board_[Move(row, col).GetAction()];
+    const uint64_t bit = uint64_t{1} << Move(row, col).GetAction();
+    if (disks_[0] & bit) return PlayerToState(0);
+    if (disks_[1] & bit) return PlayerToState(1);
+    return CellState::kEmpty;
   }
 
   CellState BoardAt(Move move) const { return BoardAt(move.GetRow(), move.GetColumn()); }
@@ -126,15 +137,12 @@ class OthelloState : public State {
   // Returns the number of pieces on the board for the given player.
   int DiskCount(Player player) const;
 
-  // Returns true if the specified move would result in a capture.
-  bool CanCapture(Player player, int action) const;
+  // Returns the bitboard of the cells where the player can place a disk.
+  uint64_t LegalMovesMask(Player player) const;
 
-  // Returns the number of capturable disks of the opponent in the given
-  // direction from the given starting location.
-  int CountSteps(Player player, int action, Direction dir) const;
-
-  // Updates the board to reflect a capture move.
-  void Capture(Player player, int action, Direction dir, int steps);
+  // Returns the bitboard of the opponent's disks the player would capture by
+  // placing a disk on the cell of the action.
+  uint64_t Captures(Player player, int action) const;
 
   Player current_player_ = 0;  // Player zero goes first
   Player outcome_ = kInvalidPlayer;
@@ -161,8 +169,6 @@ class OthelloGame : public Game {
   int MaxGameLength() const override { return kNumCells; }
 };
 
-
-CellState PlayerToState(Player player);
 std::string StateToString(CellState state);
 std::string StateToString(Player player, CellState state);
 
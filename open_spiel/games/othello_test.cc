@@ -12,6 +12,12 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include "open_spiel/games/othello.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
 #include "open_spiel/spiel.h"
 #include "open_spiel/tests/basic_tests.h"
 
@@ -27,10 +33,28 @@ void BasicOthelloTests() {
   testing::RandomSimTest(*LoadGame("othello"), 100);
 }
 
+void CaptureTest() {
+  std::shared_ptr<const Game> game = LoadGame("othello");
+  std::unique_ptr<State> state = game->NewInitialState();
+  SPIEL_CHECK_EQ(state->LegalActions(), (std::vector<Action>{19, 26, 37, 44}));
+
+  // Black at d3 captures d4, and flips the captured disk in that direction
+  // only.
+  state->ApplyAction(19);
+  const auto& othello_state = static_cast<const OthelloState&>(*state);
+  SPIEL_CHECK_EQ(othello_state.Disks(0), (uint64_t{1} << 19) |
+                                             (uint64_t{1} << 27) |
+                                             (uint64_t{1} << 28) |
+                                             (uint64_t{1} << 35));
+  SPIEL_CHECK_EQ(othello_state.Disks(1), uint64_t{1} << 36);
+  SPIEL_CHECK_EQ(state->LegalActions(), (std::vector<Action>{18, 20, 34}));
+}
+
 }  // namespace
 }  // namespace othello
 }  // namespace open_spiel
 
 int main(int argc, char** argv) {
   open_spiel::othello::BasicOthelloTests();
+  open_spiel::othello::CaptureTest();
 }
@@ -14,9 +14,17 @@
 
 #include "open_spiel/games/oware.h"
 
-#include <iomanip>
-
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/abseil-cpp/absl/strings/str_format.h"
+#include "open_spiel/abseil-cpp/absl/strings/string_view.h"
 #include "open_spiel/game_parameters.h"
+#include "open_spiel/utils/varint.h"
 
 namespace open_spiel {
 namespace oware {
@@ -48,6 +56,41 @@ std::shared_ptr<const Game> Factory(const GameParameters& params) {
 
 REGISTER_SPIEL_GAME(kGameType, Factory);
 
+// Snapshot encoding of a board, see OwareState::AppendSnapshot.
+void AppendBoard(const OwareBoard& board, std::string* bytes) {
+  AppendVarint(board.CurrentPlayer(), bytes);
+  for (Player player = 0; player < kNumPlayers; ++player) {
+    AppendVarint(board.Score(player), bytes);
+  }
+  for (int house = 0; house < board.NumHouses(); ++house) {
+    AppendVarint(board.Seeds(house), bytes);
+  }
+}
+
+// Reads a board with as many houses as board into board, if it is valid.
+bool ReadBoard(VarintReader* reader, OwareBoard* board) {
+  const uint64_t current_player = reader->Read();
+  std::vector<int> score(kNumPlayers);
+  std::vector<int> seeds(board->NumHouses());
+  uint64_t total_seeds = 0;
+  for (int& player_score : score) {
+    const uint64_t value = reader->Read();
+    total_seeds += value;
+    player_score = value;
+  }
+  for (int& house_seeds : seeds) {
+    const uint64_t value = reader->Read();
+    total_seeds += value;
+    house_seeds = value;
+  }
+  if (!reader->ok() || current_player >= kNumPlayers ||
+      total_seeds > kMaxSeeds) {
+    return false;
+  }
+  *board = OwareBoard(current_player, score, seeds);
+  return true;
+}
+
 }  // namespace
 
 OwareState::OwareState(std::shared_ptr<const Game> game,
@@ -63,10 +106,10 @@ OwareState::OwareState(std::shared_ptr<const Game> game,
 OwareState::OwareState(std::shared_ptr<const Game> game,
                        const OwareBoard& board)
     : State(game),
-      num_houses_per_player_(board.seeds.size() / kNumPlayers),
+      num_houses_per_player_(board.NumHouses() / kNumPlayers),
       total_seeds_(board.TotalSeeds()),
       board_(board) {
-  SPIEL_CHECK_EQ(0, board.seeds.size() % kNumPlayers);
+  SPIEL_CHECK_EQ(0, board.NumHouses() % kNumPlayers);
   SPIEL_CHECK_TRUE(IsTerminal() || !LegalActions().empty());
   boards_since_last_capture_.insert(board_);
 }
@@ -74,20 +117,20 @@ OwareState::OwareState(std::shared_ptr<const Game> game,
 std::vector<Action> OwareState::LegalActions() const {
   std::vector<Action> actions;
   if (IsTerminal()) return actions;
-  const Player lower = PlayerLowerHouse(board_.current_player);
-  const Player upper = PlayerUpperHouse(board_.current_player);
+  const Player lower = PlayerLowerHouse(board_.CurrentPlayer());
+  const Player upper = PlayerUpperHouse(board_.CurrentPlayer());
   if (OpponentSeeds() == 0) {
     // In case the opponent does not have any seeds, a player must make
     // a move which gives the opponent seeds.
     for (int house = lower; house <= upper; house++) {
       const int first_seeds_in_own_row = upper - house;
-      if (board_.seeds[house] - first_seeds_in_own_row > 0) {
+      if (board_.Seeds(house) - first_seeds_in_own_row > 0) {
         actions.push_back(HouseToAction(house));
       }
     }
   } else {
     for (int house = lower; house <= upper; house++) {
-      if (board_.seeds[house] > 0) {
+      if (board_.Seeds(house) > 0) {
         actions.push_back(HouseToAction(house));
       }
     }
@@ -99,50 +142,45 @@ std::string OwareState::ActionToString(Player player, Action action) const {
   return std::string(1, (player == Player{0} ? 'A' : 'a') + action);
 }
 
-void OwareState::WritePlayerScore(std::ostringstream& out,
-                                  Player player) const {
-  out << "Player " << player << " score = " << board_.score[player];
-  if (CurrentPlayer() == player) {
-    out << " [PLAYING]" << std::endl;
-  } else {
-    out << std::endl;
-  }
+void OwareState::WritePlayerScore(std::string* out, Player player) const {
+  absl::StrAppend(out, "Player ", player, " score = ", board_.Score(player),
+                  CurrentPlayer() == player ? " [PLAYING]\n" : "\n");
 }
 
 std::string OwareState::ToString() const {
-  std::ostringstream out;
+  std::string out;
   if (IsTerminal()) {
-    out << "[FINISHED]" << std::endl;
+    out.append("[FINISHED]\n");
   }
-  WritePlayerScore(out, 1);
+  WritePlayerScore(&out, 1);
 
   // Add player 1 labels.
   for (int action = num_houses_per_player_ - 1; action >= 0; action--) {
-    out << std::setw(3) << std::right << ActionToString(1, action);
+    absl::StrAppendFormat(&out, "%3s", ActionToString(1, action));
   }
-  out << std::endl;
+  out.push_back('\n');
 
   // Add player 1 house seeds.
   for (int house = kNumPlayers * num_houses_per_player_ - 1;
        house >= num_houses_per_player_; house--) {
-    out << std::setw(3) << std::right << board_.seeds[house];
+    absl::StrAppendFormat(&out, "%3d", board_.Seeds(house));
   }
-  out << std::endl;
+  out.push_back('\n');
 
   // Add player 0 house seeds.
   for (int house = 0; house < num_houses_per_player_; house++) {
-    out << std::setw(3) << std::right << board_.seeds[house];
+    absl::StrAppendFormat(&out, "%3d", board_.Seeds(house));
   }
-  out << std::endl;
+  out.push_back('\n');
 
   // Add player 0 labels.
   for (int action = 0; action < num_houses_per_player_; action++) {
-    out << std::setw(3) << std::right << ActionToString(0, action);
+    absl::StrAppendFormat(&out, "%3s", ActionToString(0, action));
   }
-  out << std::endl;
+  out.push_back('\n');
 
-  WritePlayerScore(out, 0);
-  return out.str();
+  WritePlayerScore(&out, 0);
+  return out;
 }
 
 bool OwareState::IsTerminal() const {
@@ -150,15 +188,15 @@ bool OwareState::IsTerminal() const {
   // (works both for even and odd number of seeds), or when all seeds
   // are equally shared.
   const int limit = total_seeds_ / 2;
-  return board_.score[0] > limit || board_.score[1] > limit ||
-         (board_.score[0] == limit && board_.score[1] == limit);
+  return board_.Score(0) > limit || board_.Score(1) > limit ||
+         (board_.Score(0) == limit && board_.Score(1) == limit);
 }
 
 std::vector<double> OwareState::Returns() const {
   if (IsTerminal()) {
-    if (board_.score[0] > board_.score[1]) {
+    if (board_.Score(0) > board_.Score(1)) {
       return {1, -1};
-    } else if (board_.score[0] < board_.score[1]) {
+    } else if (board_.Score(0) < board_.Score(1)) {
       return {-1, 1};
     } else {
       return {0, 0};
@@ -172,31 +210,68 @@ std::unique_ptr<State> OwareState::Clone() const {
   return std::unique_ptr<State>(new OwareState(*this));
 }
 
+bool OwareState::AppendSnapshot(std::string* bytes) const {
+  AppendBoard(board_, bytes);
+  AppendVarint(boards_since_last_capture_.size(), bytes);
+  for (const OwareBoard& board : boards_since_last_capture_) {
+    AppendBoard(board, bytes);
+  }
+  return true;
+}
+
+bool OwareState::RestoreSnapshot(const std::vector<Action>& history,
+                                 absl::string_view bytes) {
+  VarintReader reader(bytes);
+  OwareBoard board = board_;
+  if (!ReadBoard(&reader, &board)) return false;
+  const uint64_t num_boards = reader.ReadSize();
+  std::unordered_set<OwareBoard, OwareBoardHash> boards;
+  OwareBoard previous_board = board_;
+  for (int i = 0; i < num_boards; ++i) {
+    if (!ReadBoard(&reader, &previous_board)) return false;
+    boards.insert(previous_board);
+  }
+  if (!reader.ok() || !reader.empty() || board.TotalSeeds() != total_seeds_) {
+    return false;
+  }
+  board_ = board;
+  boards_since_last_capture_ = std::move(boards);
+  history_ = history;
+  return true;
+}
+
 int OwareState::DistributeSeeds(int house) {
-  int to_distribute = board_.seeds[house];
+  const int to_distribute = board_.Seeds(house);
   SPIEL_CHECK_NE(to_distribute, 0);
-  board_.seeds[house] = 0;
+  board_.AddSeeds(house, -to_distribute);
+  // Seeds are never sown into the house they were drawn from, so each lap of
+  // the board sows one seed in each of the other houses.
+  const int num_laps = to_distribute / (NumHouses() - 1);
+  if (num_laps > 0) {
+    for (int index = 0; index < NumHouses(); ++index) {
+      if (index != house) board_.AddSeeds(index, num_laps);
+    }
+  }
   int index = house;
-  while (to_distribute > 0) {
+  for (int i = 0; i < to_distribute % (NumHouses() - 1); ++i) {
     index = (index + 1) % NumHouses();
-    // Seeds are never sown into the house they were drawn from.
-    if (index != house) {
-      board_.seeds[index]++;
-      to_distribute--;
-    }
+    if (index == house) index = (index + 1) % NumHouses();
+    board_.AddSeeds(index, 1);
   }
+  // After whole laps only, the last seed is in the house before the start.
+  if (index == house) index = (house + NumHouses() - 1) % NumHouses();
   return index;
 }
 
 bool OwareState::InOpponentRow(int house) const {
-  return (house / num_houses_per_player_) != board_.current_player;
+  return (house / num_houses_per_player_) != board_.CurrentPlayer();
 }
 
 bool OwareState::IsGrandSlam(int house) const {
   // If there are seeds beyond the house in which the last seed was dropped,
   // it is not a Grand Slam.
   for (int index = UpperHouse(house); index > house; index--) {
-    if (board_.seeds[index] > 0) {
+    if (board_.Seeds(index) > 0) {
       return false;
     }
   }
@@ -206,8 +281,8 @@ bool OwareState::IsGrandSlam(int house) const {
   // the way seeds are sown.
   const int lower = LowerHouse(house);
   for (int index = house; index >= lower; index--) {
-    SPIEL_CHECK_GT(board_.seeds[index], 0);
-    if (!ShouldCapture(board_.seeds[index])) {
+    SPIEL_CHECK_GT(board_.Seeds(index), 0);
+    if (!ShouldCapture(board_.Seeds(index))) {
       return false;
     }
   }
@@ -216,11 +291,11 @@ bool OwareState::IsGrandSlam(int house) const {
 
 int OwareState::OpponentSeeds() const {
   int count = 0;
-  const Player opponent = 1 - board_.current_player;
+  const Player opponent = 1 - board_.CurrentPlayer();
   const int lower = PlayerLowerHouse(opponent);
   const int upper = PlayerUpperHouse(opponent);
   for (int house = lower; house <= upper; house++) {
-    count += board_.seeds[house];
+    count += board_.Seeds(house);
   }
   return count;
 }
@@ -229,14 +304,15 @@ int OwareState::DoCaptureFrom(int house) {
   const int lower = LowerHouse(house);
   int captured = 0;
   for (int index = house; index >= lower; index--) {
-    if (ShouldCapture(board_.seeds[index])) {
-      captured += board_.seeds[index];
-      board_.seeds[index] = 0;
+    const int seeds = board_.Seeds(index);
+    if (ShouldCapture(seeds)) {
+      captured += seeds;
+      board_.AddSeeds(index, -seeds);
     } else {
       break;
     }
   }
-  board_.score[board_.current_player] += captured;
+  board_.AddScore(board_.CurrentPlayer(), captured);
   return captured;
 }
 
@@ -253,7 +329,7 @@ void OwareState::DoApplyAction(Action action) {
       boards_since_last_capture_.clear();
     }
   }
-  board_.current_player = 1 - board_.current_player;
+  board_.SwitchPlayer();
 
   if (!boards_since_last_capture_.insert(board_).second) {
     // We have game repetition, the game is ended.
@@ -268,8 +344,9 @@ void OwareState::DoApplyAction(Action action) {
 void OwareState::CollectAndTerminate() {
   for (int house = 0; house < NumHouses(); house++) {
     const Player player = house / num_houses_per_player_;
-    board_.score[player] += board_.seeds[house];
-    board_.seeds[house] = 0;
+    const int seeds = board_.Seeds(house);
+    board_.AddScore(player, seeds);
+    board_.AddSeeds(house, -seeds);
   }
 }
 
@@ -286,11 +363,11 @@ void OwareState::ObservationTensor(Player player,
 
   values->resize(/*seeds*/ NumHouses() + /*scores*/ kNumPlayers);
   for (int house = 0; house < NumHouses(); ++house) {
-    (*values)[house] = ((double)board_.seeds[house]) / total_seeds_;
+    (*values)[house] = ((double)board_.Seeds(house)) / total_seeds_;
   }
   for (Player player = 0; player < kNumPlayers; ++player) {
     (*values)[NumHouses() + player] =
-        ((double)board_.score[player]) / total_seeds_;
+        ((double)board_.Score(player)) / total_seeds_;
   }
 }
 
@@ -16,8 +16,11 @@
 #define OPEN_SPIEL_GAMES_OWARE_H_
 
 #include <memory>
+#include <string>
 #include <unordered_set>
+#include <vector>
 
+#include "open_spiel/abseil-cpp/absl/strings/string_view.h"
 #include "open_spiel/games/oware/oware_board.h"
 #include "open_spiel/spiel.h"
 
@@ -61,7 +64,7 @@ class OwareState : public State {
                       const OwareBoard& board);
 
   Player CurrentPlayer() const override {
-    return IsTerminal() ? kTerminalPlayerId : board_.current_player;
+    return IsTerminal() ? kTerminalPlayerId : board_.CurrentPlayer();
   }
 
   std::vector<Action> LegalActions() const override;
@@ -70,6 +73,11 @@ class OwareState : public State {
   bool IsTerminal() const override;
   std::vector<double> Returns() const override;
   std::unique_ptr<State> Clone() const override;
+  bool AppendSnapshot(std::string* bytes) const override;
+  bool RestoreSnapshot(const std::vector<Action>& history,
+                       absl::string_view bytes) override;
+  // The hash of the board, which leaves out the boards seen before.
+  uint64_t HashValue() const override { return board_.HashValue(); }
   const OwareBoard& Board() const { return board_; }
   std::string ObservationString(Player player) const override;
 
@@ -85,7 +93,7 @@ class OwareState : public State {
   void DoApplyAction(Action action) override;
 
  private:
-  void WritePlayerScore(std::ostringstream& out, Player player) const;
+  void WritePlayerScore(std::string* out, Player player) const;
 
   // Collects the seeds from the given house and distributes them
   // counterclockwise, skipping the starting position in all cases.
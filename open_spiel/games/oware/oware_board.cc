@@ -12,25 +12,134 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+
 #include "open_spiel/games/oware/oware_board.h"
 
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+
 namespace open_spiel {
 namespace oware {
+namespace {
+
+constexpr int kMaxNumHouses = kNumPlayers * kMaxHousesPerPlayer;
+
+// The random keys of the hash: one per house, then one per score and one for
+// player 1 to move, from a splitmix64 sequence.
+constexpr std::array<uint64_t, kMaxNumHouses + kNumPlayers + 1> kHashKeys = [] {
+  std::array<uint64_t, kMaxNumHouses + kNumPlayers + 1> keys{};
+  uint64_t state = 0;
+  for (uint64_t& key : keys) {
+    state += 0x9e3779b97f4a7c15;
+    uint64_t z = state;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+    key = z ^ (z >> 31);
+  }
+  return keys;
+}();
+constexpr int kScoreKeys = kMaxNumHouses;
+constexpr int kPlayerKey = kMaxNumHouses + kNumPlayers;
+
+// The binomial coefficients C(n, k), for all the n and k that boards need,
+// or kTooLarge for those that do not fit.
+constexpr uint64_t kTooLarge = ~uint64_t{0};
+constexpr int kMaxBinomialN = kMaxSeeds + kMaxNumHouses;
+using BinomialTable =
+    std::array<std::array<uint64_t, kMaxNumHouses>, kMaxBinomialN>;
+constexpr BinomialTable kBinomials = [] {
+  BinomialTable binomials{};
+  for (int n = 0; n < kMaxBinomialN; ++n) {
+    binomials[n][0] = 1;
+    for (int k = 1; k < kMaxNumHouses && k <= n; ++k) {
+      const uint64_t a = binomials[n - 1][k - 1];
+      const uint64_t b = k < n ? binomials[n - 1][k] : 0;
+      binomials[n][k] = a > kTooLarge - b ? kTooLarge : a + b;
+    }
+  }
+  return binomials;
+}();
+
+// The number of ways of laying num_seeds seeds out in num_houses houses.
+uint64_t NumLayouts(int num_houses, int num_seeds) {
+  return kBinomials[num_seeds + num_houses - 1][num_houses - 1];
+}
+
+// The number of boards with num_seeds seeds in play: a layout of the seeds,
+// the score of player 0, and the player to move.
+uint64_t NumBoards(int num_houses, int total_seeds, int num_seeds) {
+  return NumLayouts(num_houses, num_seeds) * (total_seeds - num_seeds + 1) *
+         kNumPlayers;
+}
+
+}  // namespace
 
 OwareBoard::OwareBoard(int num_houses_per_player, int num_seeds_per_house)
-    : current_player(Player{0}),
-      score(kNumPlayers, 0),
-      seeds(kNumPlayers * num_houses_per_player, num_seeds_per_house) {}
+    : num_houses_(kNumPlayers * num_houses_per_player),
+      current_player_(Player{0}),
+      score_{},
+      seeds_{} {
+  SPIEL_CHECK_GE(num_houses_per_player, 1);
+  SPIEL_CHECK_LE(num_houses_per_player, kMaxHousesPerPlayer);
+  SPIEL_CHECK_LE(num_houses_ * num_seeds_per_house, kMaxSeeds);
+  for (int house = 0; house < num_houses_; ++house) {
+    seeds_[house] = num_seeds_per_house;
+  }
+  ComputeHash();
+}
 
 OwareBoard::OwareBoard(Player current_player, const std::vector<int>& score,
                        const std::vector<int>& seeds)
-    : current_player(current_player), score(score), seeds(seeds) {
+    : num_houses_(seeds.size()),
+      current_player_(current_player),
+      score_{},
+      seeds_{} {
   SPIEL_CHECK_EQ(score.size(), kNumPlayers);
+  SPIEL_CHECK_GE(num_houses_, kNumPlayers);
+  SPIEL_CHECK_LE(num_houses_, kMaxNumHouses);
+  for (Player player = 0; player < kNumPlayers; ++player) {
+    score_[player] = score[player];
+  }
+  for (int house = 0; house < num_houses_; ++house) {
+    seeds_[house] = seeds[house];
+  }
+  SPIEL_CHECK_LE(TotalSeeds(), kMaxSeeds);
+  ComputeHash();
+}
+
+void OwareBoard::ComputeHash() {
+  hash_ = current_player_ * kHashKeys[kPlayerKey];
+  for (Player player = 0; player < kNumPlayers; ++player) {
+    hash_ += score_[player] * kHashKeys[kScoreKeys + player];
+  }
+  for (int house = 0; house < num_houses_; ++house) {
+    hash_ += seeds_[house] * kHashKeys[house];
+  }
+}
+
+void OwareBoard::SwitchPlayer() {
+  hash_ += (1 - 2 * current_player_) * kHashKeys[kPlayerKey];
+  current_player_ = 1 - current_player_;
+}
+
+void OwareBoard::AddScore(Player player, int count) {
+  score_[player] += count;
+  hash_ += count * kHashKeys[kScoreKeys + player];
+}
+
+void OwareBoard::AddSeeds(int house, int count) {
+  seeds_[house] += count;
+  hash_ += count * kHashKeys[house];
 }
 
 bool OwareBoard::operator==(const OwareBoard& other) const {
-  return current_player == other.current_player && score == other.score &&
-         seeds == other.seeds;
+  return hash_ == other.hash_ && num_houses_ == other.num_houses_ &&
+         current_player_ == other.current_player_ && score_ == other.score_ &&
+         seeds_ == other.seeds_;
 }
 
 bool OwareBoard::operator!=(const OwareBoard& other) const {
@@ -38,32 +147,100 @@ bool OwareBoard::operator!=(const OwareBoard& other) const {
 }
 
 std::string OwareBoard::ToString() const {
-  return absl::StrCat(current_player, " | ", absl::StrJoin(score, " "), " | ",
-                      absl::StrJoin(seeds, " "));
-}
-
-size_t OwareBoard::HashValue() const {
-  // Hashing similar to boost::hash_combine.
-  size_t hash = current_player;
-  for (int player_score : score) {
-    hash ^= (size_t)player_score + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-  }
-  for (int house_seeds : seeds) {
-    hash ^= (size_t)house_seeds + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+  std::string str = absl::StrCat(current_player_, " | ", Score(0), " ",
+                                 Score(1), " |");
+  for (int house = 0; house < num_houses_; ++house) {
+    absl::StrAppend(&str, " ", Seeds(house));
   }
-  return hash;
+  return str;
 }
+
 int OwareBoard::TotalSeeds() const {
   int total = 0;
-  for (int house_seeds : seeds) {
-    total += house_seeds;
+  for (int house = 0; house < num_houses_; ++house) {
+    total += seeds_[house];
   }
-  for (int score_seeds : score) {
+  for (int score_seeds : score_) {
     total += score_seeds;
   }
   return total;
 }
 
+// The boards are ordered by the number of seeds in play, then by their
+// layout, the score of player 0 and the player to move. A layout of n seeds
+// in h houses is ranked as the set of the positions of the h - 1 walls
+// between the houses among n + h - 1 places, in the combinatorial number
+// system.
+int64_t OwareBoard::Index() const {
+  const int total_seeds = TotalSeeds();
+  const int num_seeds = total_seeds - score_[0] - score_[1];
+  uint64_t index = 0;
+  for (int seeds = 0; seeds < num_seeds; ++seeds) {
+    index += NumBoards(num_houses_, total_seeds, seeds);
+  }
+  uint64_t rank = 0;
+  int wall = -1;
+  for (int house = 0; house < num_houses_ - 1; ++house) {
+    wall += seeds_[house] + 1;
+    rank += kBinomials[wall][house + 1];
+  }
+  index += (rank * (total_seeds - num_seeds + 1) + score_[0]) * kNumPlayers +
+           current_player_;
+  return index;
+}
+
+int64_t OwareBoard::NumIndices(int num_houses_per_player, int total_seeds) {
+  SPIEL_CHECK_LE(num_houses_per_player, kMaxHousesPerPlayer);
+  SPIEL_CHECK_LE(total_seeds, kMaxSeeds);
+  const int num_houses = kNumPlayers * num_houses_per_player;
+  int64_t num_indices = 0;
+  for (int seeds = 0; seeds <= total_seeds; ++seeds) {
+    const uint64_t num_layouts = NumLayouts(num_houses, seeds);
+    int64_t num_boards;
+    if (num_layouts > INT64_MAX ||
+        __builtin_mul_overflow(static_cast<int64_t>(num_layouts),
+                               (total_seeds - seeds + 1) * kNumPlayers,
+                               &num_boards) ||
+        __builtin_add_overflow(num_indices, num_boards, &num_indices)) {
+      SpielFatalError(absl::StrCat("Too many Oware boards to index, with ",
+                                   num_houses, " houses and ", total_seeds,
+                                   " seeds"));
+    }
+  }
+  return num_indices;
+}
+
+OwareBoard OwareBoard::FromIndex(int num_houses_per_player, int total_seeds,
+                                 int64_t index) {
+  SPIEL_CHECK_GE(index, 0);
+  SPIEL_CHECK_LT(index, NumIndices(num_houses_per_player, total_seeds));
+  const int num_houses = kNumPlayers * num_houses_per_player;
+  uint64_t rest = index;
+  int num_seeds = 0;
+  while (rest >= NumBoards(num_houses, total_seeds, num_seeds)) {
+    rest -= NumBoards(num_houses, total_seeds, num_seeds++);
+  }
+  std::vector<int> score(kNumPlayers);
+  const Player current_player = rest % kNumPlayers;
+  rest /= kNumPlayers;
+  score[0] = rest % (total_seeds - num_seeds + 1);
+  score[1] = total_seeds - num_seeds - score[0];
+  uint64_t rank = rest / (total_seeds - num_seeds + 1);
+
+  // Finds the walls from the last, each at the highest place that fits.
+  std::vector<int> seeds(num_houses);
+  int next_wall = num_seeds + num_houses - 1;
+  for (int house = num_houses - 2; house >= 0; --house) {
+    int wall = next_wall - 1;
+    while (kBinomials[wall][house + 1] > rank) --wall;
+    rank -= kBinomials[wall][house + 1];
+    seeds[house + 1] = next_wall - wall - 1;
+    next_wall = wall;
+  }
+  seeds[0] = next_wall;
+  return OwareBoard(current_player, score, seeds);
+}
+
 std::ostream& operator<<(std::ostream& os, const OwareBoard& board) {
   return os << board.ToString();
 }
@@ -12,9 +12,12 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+
 #ifndef OPEN_SPIEL_GAMES_OWARE_OWARE_BOARD_H_
 #define OPEN_SPIEL_GAMES_OWARE_OWARE_BOARD_H_
 
+#include <array>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -25,8 +28,13 @@ namespace oware {
 
 inline constexpr int kNumPlayers = 2;
 
-// Simple Oware board struct storing the current player, scores and seeds.
-struct OwareBoard {
+// The largest boards supported. Each house and score is a byte.
+inline constexpr int kMaxHousesPerPlayer = 12;
+inline constexpr int kMaxSeeds = 255;
+
+// Oware board storing the current player, scores and seeds, packed in fixed
+// size arrays, with a hash of them which is kept up to date as they change.
+class OwareBoard {
  public:
   OwareBoard(int num_houses_per_player, int num_seeds_per_house);
   // Custom board setup to support testing.
@@ -37,20 +45,45 @@ struct OwareBoard {
   bool operator==(const OwareBoard& other) const;
   bool operator!=(const OwareBoard& other) const;
   std::string ToString() const;
-  size_t HashValue() const;
+
+  // The hash is a sum of a random key per seed, per captured seed and for the
+  // player to move, so each change updates it in constant time.
+  uint64_t HashValue() const { return hash_; }
+
+  // A perfect hash of the board: its index among all the boards with the same
+  // number of houses and TotalSeeds(), from 0 to NumIndices() - 1. This is
+  // meant for tables with an entry for each position, such as tablebases.
+  int64_t Index() const;
+  static int64_t NumIndices(int num_houses_per_player, int total_seeds);
+  static OwareBoard FromIndex(int num_houses_per_player, int total_seeds,
+                              int64_t index);
 
   // Returns total number of seeds, both those
   // captured and the ones still in play.
   int TotalSeeds() const;
 
-  Player current_player;
-  // The number of seeds each player has in their score house, one entry
-  // for each player.
-  std::vector<int> score;
+  int NumHouses() const { return num_houses_; }
+  Player CurrentPlayer() const { return current_player_; }
+  // The number of seeds each player has in their score house.
+  int Score(Player player) const { return score_[player]; }
   // The number of seeds in each house. First the (kNumHousesPerPlayer) houses
   // for player 0, then for player 1, in counterclockwise order (i.e. the order
   // in which seeds are sown).
-  std::vector<int> seeds;
+  int Seeds(int house) const { return seeds_[house]; }
+
+  void SwitchPlayer();
+  void AddScore(Player player, int count);
+  // The count may be negative, to take seeds out of the house.
+  void AddSeeds(int house, int count);
+
+ private:
+  void ComputeHash();
+
+  int num_houses_;
+  Player current_player_;
+  std::array<uint8_t, kNumPlayers> score_;
+  std::array<uint8_t, kNumPlayers * kMaxHousesPerPlayer> seeds_;
+  uint64_t hash_;
 };
 
 std::ostream& operator<<(std::ostream& os, const OwareBoard& board);
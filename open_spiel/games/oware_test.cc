@@ -14,6 +14,10 @@
 
 #include "open_spiel/games/oware.h"
 
+#include <memory>
+#include <random>
+#include <vector>
+
 #include "open_spiel/tests/basic_tests.h"
 
 namespace open_spiel {
@@ -122,6 +126,39 @@ void GameEndsByRepetitionTest() {
                  OwareBoard(0, {24, 24}, {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}));
 }
 
+// The hash kept up to date during a game is the hash of the board built
+// afresh, and the index of each board gives the board back.
+void BoardHashAndIndexTest() {
+  std::shared_ptr<const Game> game = LoadGame("oware");
+  std::unique_ptr<State> state = game->NewInitialState();
+  std::mt19937 rng(0);
+  while (!state->IsTerminal()) {
+    const OwareBoard& board = static_cast<OwareState*>(state.get())->Board();
+    std::vector<int> score = {board.Score(0), board.Score(1)};
+    std::vector<int> seeds;
+    for (int house = 0; house < board.NumHouses(); ++house) {
+      seeds.push_back(board.Seeds(house));
+    }
+    SPIEL_CHECK_EQ(board.HashValue(),
+                   OwareBoard(board.CurrentPlayer(), score, seeds).HashValue());
+    SPIEL_CHECK_EQ(board, OwareBoard::FromIndex(6, 48, board.Index()));
+    std::vector<Action> actions = state->LegalActions();
+    state->ApplyAction(actions[rng() % actions.size()]);
+  }
+}
+
+void BoardIndexTest() {
+  // For each player to move, the seed is in one of the 4 houses, or captured
+  // by either player.
+  SPIEL_CHECK_EQ(OwareBoard::NumIndices(2, 1), 2 * (4 + 2));
+  const int64_t num_indices = OwareBoard::NumIndices(2, 4);
+  for (int64_t index = 0; index < num_indices; ++index) {
+    const OwareBoard board = OwareBoard::FromIndex(2, 4, index);
+    SPIEL_CHECK_EQ(board.TotalSeeds(), 4);
+    SPIEL_CHECK_EQ(board.Index(), index);
+  }
+}
+
 }  // namespace
 }  // namespace oware
 }  // namespace open_spiel
@@ -136,4 +173,6 @@ int main(int argc, char** argv) {
   open_spiel::oware::NoCaptureBecauseTooFewSeedsTest();
   open_spiel::oware::NoCaptureBecauseTooManySeedsTest();
   open_spiel::oware::NoCaptureBecauseGrandSlamTest();
+  open_spiel::oware::BoardHashAndIndexTest();
+  open_spiel::oware::BoardIndexTest();
 }
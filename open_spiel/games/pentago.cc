@@ -15,10 +15,14 @@
 #include "open_spiel/games/pentago.h"
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
 #include <memory>
 #include <utility>
 #include <vector>
 
+#include "open_spiel/spiel_utils.h"
 #include "open_spiel/utils/tensor_view.h"
 
 namespace open_spiel {
@@ -145,6 +149,68 @@ uint64_t rotate_quadrant_ccw(uint64_t b, int quadrant) {
   return (b & ~m) | (((b & m) >> 2) & m) | (((b & m) << 6) & m);
 }
 
+// Where a symmetry of the board takes (x, y).
+int SymmetricXY(int symmetry, int x, int y) {
+  constexpr int kLast = kBoardSize - 1;
+  switch (symmetry) {
+    case 0: return x + y * kBoardSize;
+    case 1: return (kLast - y) + x * kBoardSize;
+    case 2: return (kLast - x) + (kLast - y) * kBoardSize;
+    case 3: return y + (kLast - x) * kBoardSize;
+    case 4: return (kLast - x) + y * kBoardSize;
+    case 5: return x + (kLast - y) * kBoardSize;
+    case 6: return y + x * kBoardSize;
+    case 7: return (kLast - y) + (kLast - x) * kBoardSize;
+    default: SpielFatalError("Unknown symmetry.");
+  }
+}
+
+// The bitboards are 36 bits, looked up a byte at a time.
+constexpr int kBoardBytes = (kBoardPositions + 7) / 8;
+
+// The image of each byte of a bitboard under each symmetry, so that a board is
+// transformed with a lookup per byte rather than a move per stone.
+using SymmetryTables = std::array<
+    std::array<std::array<uint64_t, 256>, kBoardBytes>, kNumSymmetries>;
+
+const SymmetryTables& GetSymmetryTables() {
+  static const SymmetryTables* tables = [] {
+    auto* tables = new SymmetryTables();
+    for (int symmetry = 0; symmetry < kNumSymmetries; ++symmetry) {
+      // The image of each bit.
+      std::array<uint64_t, kBoardPositions> images;
+      for (int xy = 0; xy < kBoardPositions; ++xy) {
+        images[xy_to_bit[xy]] = xy_bit_mask[SymmetricXY(
+            symmetry, xy % kBoardSize, xy / kBoardSize)];
+      }
+      for (int byte = 0; byte < kBoardBytes; ++byte) {
+        for (int value = 0; value < 256; ++value) {
+          uint64_t image = 0;
+          for (int i = 0; i < 8 && byte * 8 + i < kBoardPositions; ++i) {
+            if (value & (1 << i)) image |= images[byte * 8 + i];
+          }
+          (*tables)[symmetry][byte][value] = image;
+        }
+      }
+    }
+    return tables;
+  }();
+  return *tables;
+}
+
+uint64_t Transform(uint64_t board, int symmetry) {
+  const auto& table = GetSymmetryTables()[symmetry];
+  uint64_t image = 0;
+  for (int byte = 0; byte < kBoardBytes; ++byte) {
+    image |= table[byte][(board >> (8 * byte)) & 0xFF];
+  }
+  return image;
+}
+
+uint64_t PositionHash(uint64_t player1, uint64_t player2) {
+  return MixBits(player1 ^ MixBits(player2));
+}
+
 }  // namespace
 
 PentagoState::PentagoState(std::shared_ptr<const Game> game,
@@ -316,10 +382,63 @@ void PentagoState::DoApplyAction(Action action) {
   current_player_ = (current_player_ == kPlayer1 ? kPlayer2 : kPlayer1);
 }
 
+void PentagoState::UndoAction(Player player, Action action) {
+  Move move(action);
+  // Rotate back, then take the stone off.
+  if (move.dir == 0) {
+    board_[0] = rotate_quadrant_cw(board_[0], move.quadrant);
+    board_[1] = rotate_quadrant_cw(board_[1], move.quadrant);
+  } else {
+    board_[0] = rotate_quadrant_ccw(board_[0], move.quadrant);
+    board_[1] = rotate_quadrant_ccw(board_[1], move.quadrant);
+  }
+  board_[player] &= ~xy_bit_mask[move.xy];
+  moves_made_--;
+  outcome_ = kPlayerNone;
+  current_player_ = static_cast<PentagoPlayer>(player);
+  PopHistory();
+}
+
+uint64_t PentagoState::HashValue() const {
+  return PositionHash(board_[0], board_[1]);
+}
+
+uint64_t PentagoState::SymmetricHashValue() const {
+  uint64_t hash = HashValue();
+  for (int symmetry = 1; symmetry < kNumSymmetries; ++symmetry) {
+    hash = std::min(hash, PositionHash(Transform(board_[0], symmetry),
+                                       Transform(board_[1], symmetry)));
+  }
+  return hash;
+}
+
+double LinesValue(const State& state) {
+  const auto& pentago_state = static_cast<const PentagoState&>(state);
+  const Player player = state.CurrentPlayer();
+  SPIEL_CHECK_GE(player, 0);
+  const uint64_t mine = pentago_state.Stones(player);
+  const uint64_t theirs = pentago_state.Stones(1 - player);
+  // A line with n stones of one player and none of the other counts 4^n.
+  int score = 0;
+  for (uint64_t line : win_mask) {
+    const int my_stones = __builtin_popcountll(mine & line);
+    const int their_stones = __builtin_popcountll(theirs & line);
+    if (their_stones == 0) score += 1 << (2 * my_stones);
+    if (my_stones == 0) score -= 1 << (2 * their_stones);
+  }
+  constexpr double kScale = 256;
+  return score / (std::abs(score) + kScale);
+}
+
 std::unique_ptr<State> PentagoState::Clone() const {
   return std::unique_ptr<State>(new PentagoState(*this));
 }
 
+bool PentagoState::CopyFrom(const State& other) {
+  *this = static_cast<const PentagoState&>(other);
+  return true;
+}
+
 PentagoGame::PentagoGame(const GameParameters& params)
     : Game(kGameType, params),
       ansi_color_output_(ParameterValue<bool>("ansi_color_output")) {}
@@ -40,6 +40,8 @@ inline constexpr int kPossibleRotations = 8;
 inline constexpr int kPossibleActions = kBoardPositions * kPossibleRotations;
 inline constexpr int kPossibleWinConditions = 32;
 inline constexpr int kCellStates = 1 + kNumPlayers;
+// The rotations and reflections of the whole board, including the identity.
+inline constexpr int kNumSymmetries = 8;
 
 enum PentagoPlayer {
   kPlayer1,
@@ -55,6 +57,7 @@ class PentagoState : public State {
                bool ansi_color_output = false);
 
   PentagoState(const PentagoState&) = default;
+  PentagoState& operator=(const PentagoState&) = default;
 
   Player CurrentPlayer() const override {
     return IsTerminal() ? kTerminalPlayerId : static_cast<int>(current_player_);
@@ -71,7 +74,21 @@ class PentagoState : public State {
   void ObservationTensor(Player player,
                          std::vector<double>* values) const override;
   std::unique_ptr<State> Clone() const override;
+  bool CopyFrom(const State& other) override;
   std::vector<Action> LegalActions() const override;
+  uint64_t HashValue() const override;
+  void UndoAction(Player player, Action action) override;
+  bool SupportsUndoAction() const override { return true; }
+
+  // A hash of the position which is the same for the positions it turns into
+  // by rotating or reflecting the whole board, which are worth the same. It
+  // can key caches of values, but not of actions, which are not symmetric;
+  // HashValue is for those.
+  uint64_t SymmetricHashValue() const;
+
+  // The bitboard of the player's stones, in the bit order of the quadrant
+  // rotations.
+  uint64_t Stones(Player player) const { return board_[player]; }
 
  protected:
   void DoApplyAction(Action action) override;
@@ -84,9 +101,15 @@ class PentagoState : public State {
   PentagoPlayer current_player_ = kPlayer1;
   PentagoPlayer outcome_ = kPlayerNone;
   int moves_made_ = 0;
-  const bool ansi_color_output_;
+  bool ansi_color_output_;
 };
 
+// A heuristic value of a non-terminal state for the player to move, in
+// (-1, 1), e.g. as the value_function of an AlphaBetaSearcher. It counts the
+// lines of five each player can still complete, weighting them by the stones
+// already in them.
+double LinesValue(const State& state);
+
 // Game object.
 class PentagoGame : public Game {
  public:
@@ -12,6 +12,15 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include "open_spiel/games/pentago.h"
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/random/distributions.h"
+#include "open_spiel/algorithms/minimax.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
 #include "open_spiel/tests/basic_tests.h"
@@ -33,8 +42,82 @@ void BasicPentagoTests() {
   testing::RandomSimTest(*LoadGame("pentago(ansi_color_output=True)"), 10);
 }
 
+// The action placing a stone at (x, y) and turning the top right quadrant
+// counterclockwise.
+Action PlaceAndTurnTopRight(int x, int y) {
+  return (x + y * kBoardSize) * kPossibleRotations + 2;
+}
+
+std::unique_ptr<State> Play(const Game& game,
+                            const std::vector<Action>& actions) {
+  std::unique_ptr<State> state = game.NewInitialState();
+  for (Action action : actions) state->ApplyAction(action);
+  return state;
+}
+
+uint64_t SymmetricHash(const State& state) {
+  return static_cast<const PentagoState&>(state).SymmetricHashValue();
+}
+
+void HashTest() {
+  std::shared_ptr<const Game> game = LoadGame("pentago");
+
+  // A stone in any corner, the top right quadrant being empty to turn.
+  std::unique_ptr<State> a1 = Play(*game, {PlaceAndTurnTopRight(0, 0)});
+  std::unique_ptr<State> f6 = Play(*game, {PlaceAndTurnTopRight(5, 5)});
+  std::unique_ptr<State> a6 = Play(*game, {PlaceAndTurnTopRight(0, 5)});
+  std::unique_ptr<State> b1 = Play(*game, {PlaceAndTurnTopRight(1, 0)});
+  SPIEL_CHECK_NE(a1->HashValue(), f6->HashValue());
+  SPIEL_CHECK_NE(a1->HashValue(), a6->HashValue());
+  SPIEL_CHECK_EQ(SymmetricHash(*a1), SymmetricHash(*f6));
+  SPIEL_CHECK_EQ(SymmetricHash(*a1), SymmetricHash(*a6));
+  SPIEL_CHECK_NE(SymmetricHash(*a1), SymmetricHash(*b1));
+
+  // The same position reached in another order.
+  std::unique_ptr<State> state = Play(
+      *game, {PlaceAndTurnTopRight(0, 0), PlaceAndTurnTopRight(5, 5),
+              PlaceAndTurnTopRight(1, 0), PlaceAndTurnTopRight(4, 5)});
+  std::unique_ptr<State> transposed = Play(
+      *game, {PlaceAndTurnTopRight(1, 0), PlaceAndTurnTopRight(4, 5),
+              PlaceAndTurnTopRight(0, 0), PlaceAndTurnTopRight(5, 5)});
+  SPIEL_CHECK_EQ(state->HashValue(), transposed->HashValue());
+  SPIEL_CHECK_NE(state->HistoryHash(), transposed->HistoryHash());
+}
+
+// Solves endgames with the AlphaBetaSearcher, which takes the moves back with
+// UndoAction, and checks it against the plain alpha-beta search.
+void SolveEndgamesTest() {
+  std::shared_ptr<const Game> game = LoadGame("pentago");
+  std::mt19937 rng(7);
+  algorithms::AlphaBetaSearcher searcher(*game, LinesValue);
+  int num_solved = 0;
+  while (num_solved < 3) {
+    std::unique_ptr<State> state = game->NewInitialState();
+    for (int i = 0; i < kBoardPositions - 4 && !state->IsTerminal(); ++i) {
+      std::vector<Action> actions = state->LegalActions();
+      state->ApplyAction(actions[absl::Uniform<int>(rng, 0, actions.size())]);
+    }
+    if (state->IsTerminal()) continue;
+    const double heuristic = LinesValue(*state);
+    SPIEL_CHECK_GT(heuristic, -1);
+    SPIEL_CHECK_LT(heuristic, 1);
+
+    searcher.Clear();
+    const double value = searcher.Search(*state, /*depth_limit=*/-1).first;
+    SPIEL_CHECK_TRUE(searcher.LastSearchSolved());
+    SPIEL_CHECK_EQ(value, algorithms::AlphaBetaSearch(*game, state.get(), {},
+                                                      -1, kInvalidPlayer)
+                              .first);
+    ++num_solved;
+  }
+}
+
 }  // namespace
 }  // namespace pentago
 }  // namespace open_spiel
 
-int main(int argc, char** argv) { open_spiel::pentago::BasicPentagoTests(); }
+int main(int argc, char** argv) {
+  open_spiel::pentago::BasicPentagoTests();
+  open_spiel::pentago::HashTest();
+  open_spiel::pentago::SolveEndgamesTest();
+}
@@ -14,6 +14,9 @@
 
 #include "open_spiel/games/phantom_ttt.h"
 
+#include <algorithm>
+#include <array>
+#include <functional>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -58,6 +61,24 @@ std::shared_ptr<const Game> Factory(const GameParameters& params) {
   return std::shared_ptr<const Game>(new PhantomTTTGame(params));
 }
 
+// Whether the marked cells include a line.
+bool HasLine(const std::array<bool, kNumCells>& marked) {
+  static constexpr int kLines[][3] = {{0, 1, 2}, {3, 4, 5}, {6, 7, 8},
+                                      {0, 3, 6}, {1, 4, 7}, {2, 5, 8},
+                                      {0, 4, 8}, {2, 4, 6}};
+  for (const auto& line : kLines) {
+    if (marked[line[0]] && marked[line[1]] && marked[line[2]]) return true;
+  }
+  return false;
+}
+
+// A uniformly random element.
+int Choose(const std::vector<int>& values, const std::function<double()>& rng) {
+  SPIEL_CHECK_FALSE(values.empty());
+  int index = static_cast<int>(rng() * values.size());
+  return values[std::min<int>(index, values.size() - 1)];
+}
+
 REGISTER_SPIEL_GAME(kGameType, Factory);
 
 }  // namespace
@@ -240,11 +261,125 @@ void PhantomTTTState::UndoAction(Player player, Action move) {
   player_view[move] = CellState::kEmpty;
   action_sequence_.pop_back();
 
-  history_.pop_back();
+  PopHistory();
   // Note, do not change the player.. this will already have been done above
   // if necessary.
 }
 
+std::unique_ptr<State> PhantomTTTState::ResampleFromInfostate(
+    int player_id, std::function<double()> rng) const {
+  // The player knows their own actions and what each found. The opponent's
+  // actions keep their places in the sequence, which the information state
+  // tensor shows, and whether they failed, which follows from the player's
+  // turns. A failed one is moved to a mark of the player's that the opponent
+  // hasn't found yet. The opponent's marks go on the cells where the player
+  // found them, before the player tried them, and on cells the player hasn't
+  // tried, chosen so that they don't make a line.
+  SPIEL_CHECK_FALSE(IsTerminal());
+  const Player opponent = 1 - player_id;
+  const CellState player_mark = PlayerToState(player_id);
+  const CellState opponent_mark = PlayerToState(opponent);
+  const auto& player_view = player_id == Player{0} ? x_view_ : o_view_;
+
+  // When the player found each of the opponent's marks, and which cells the
+  // player hasn't tried.
+  std::array<int, kNumCells> found_at;
+  std::fill(found_at.begin(), found_at.end(), -1);
+  for (int i = 0; i < action_sequence_.size(); ++i) {
+    const auto& [player, move] = action_sequence_[i];
+    if (player == player_id && player_view[move] == opponent_mark) {
+      found_at[move] = i;
+    }
+  }
+  std::vector<int> untried;
+  std::array<bool, kNumCells> found;
+  for (int cell = 0; cell < kNumCells; ++cell) {
+    found[cell] = found_at[cell] >= 0;
+    if (player_view[cell] == CellState::kEmpty) untried.push_back(cell);
+  }
+
+  // The opponent's successful actions, and so how many marks are on cells
+  // the player hasn't tried. A failed action is always on the player's mark.
+  std::vector<int> successes;
+  for (int i = 0; i < action_sequence_.size(); ++i) {
+    const auto& [player, move] = action_sequence_[i];
+    if (player == opponent && state_.BoardAt(move) != player_mark) {
+      successes.push_back(i);
+    }
+  }
+  const int num_found = std::count(found.begin(), found.end(), true);
+  const int num_hidden = successes.size() - num_found;
+  SPIEL_CHECK_GE(num_hidden, 0);
+
+  // Which untried cells have them, uniformly among the choices that don't
+  // make a line with the found marks. There are at most 2^9 to look at.
+  std::vector<int> hidden_choices;
+  for (int subset = 0; subset < (1 << untried.size()); ++subset) {
+    if (__builtin_popcount(subset) != num_hidden) continue;
+    std::array<bool, kNumCells> marked = found;
+    for (int j = 0; j < untried.size(); ++j) {
+      if (subset & (1 << j)) marked[untried[j]] = true;
+    }
+    if (!HasLine(marked)) hidden_choices.push_back(subset);
+  }
+  const int hidden = Choose(hidden_choices, rng);
+  std::vector<int> to_place;  // The opponent's marks yet to be placed.
+  for (int j = 0; j < untried.size(); ++j) {
+    if (hidden & (1 << j)) to_place.push_back(untried[j]);
+  }
+  for (int cell = 0; cell < kNumCells; ++cell) {
+    if (found[cell]) to_place.push_back(cell);
+  }
+
+  std::unique_ptr<State> state = game_->NewInitialState();
+  auto& phantom_state = static_cast<PhantomTTTState&>(*state);
+  const auto& opponent_view =
+      opponent == Player{0} ? phantom_state.x_view_ : phantom_state.o_view_;
+  int num_successes = 0;
+  for (int i = 0; i < action_sequence_.size(); ++i) {
+    const auto& [player, move] = action_sequence_[i];
+    if (player == player_id) {
+      state->ApplyAction(move);
+    } else if (num_successes < successes.size() &&
+               successes[num_successes] == i) {
+      // Placing a mark on a found cell is only forced if otherwise the
+      // remaining successes can't place the found marks before the player
+      // found them, earliest deadline first.
+      std::vector<int> deadlines;
+      int earliest = -1;
+      for (int cell : to_place) {
+        if (!found[cell]) continue;
+        deadlines.push_back(found_at[cell]);
+        if (earliest < 0 || found_at[cell] < found_at[earliest]) {
+          earliest = cell;
+        }
+      }
+      std::sort(deadlines.begin(), deadlines.end());
+      bool forced = false;
+      for (int j = 0; j < deadlines.size(); ++j) {
+        const int next = num_successes + 1 + j;
+        if (next >= successes.size() || successes[next] >= deadlines[j]) {
+          forced = true;
+        }
+      }
+      const int cell = forced ? earliest : Choose(to_place, rng);
+      to_place.erase(std::find(to_place.begin(), to_place.end(), cell));
+      state->ApplyAction(cell);
+      ++num_successes;
+    } else {
+      std::vector<int> unfound;
+      for (int cell = 0; cell < kNumCells; ++cell) {
+        if (phantom_state.state_.BoardAt(cell) == player_mark &&
+            opponent_view[cell] == CellState::kEmpty) {
+          unfound.push_back(cell);
+        }
+      }
+      state->ApplyAction(Choose(unfound, rng));
+    }
+  }
+  return state;
+}
+
 PhantomTTTGame::PhantomTTTGame(const GameParameters& params)
     : Game(kGameType, params),
       game_(std::static_pointer_cast<const tic_tac_toe::TicTacToeGame>(
@@ -12,6 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <string>
+
 #include "open_spiel/spiel.h"
 #include "open_spiel/tests/basic_tests.h"
 
@@ -25,6 +27,10 @@ void BasicPhantomTTTTests() {
   testing::LoadGameTest("phantom_ttt");
   testing::NoChanceOutcomesTest(*LoadGame("phantom_ttt"));
   testing::RandomSimTest(*LoadGame("phantom_ttt"), 100);
+  testing::ResampleInfostateTest(*LoadGame("phantom_ttt"), /*num_sims=*/100);
+  testing::ResampleInfostateTest(
+      *LoadGame("phantom_ttt", {{"obstype", GameParameter(std::string("reveal-numturns"))}}),
+      /*num_sims=*/100);
 }
 
 }  // namespace
@@ -16,6 +16,7 @@
 
 #include <sys/types.h>
 
+#include <algorithm>
 #include <utility>
 
 #include "open_spiel/game_parameters.h"
@@ -243,6 +244,12 @@ std::vector<std::pair<Action, double>> PigState::ChanceOutcomes() const {
   return outcomes;
 }
 
+std::pair<Action, double> PigState::SampleChanceOutcome(double z) const {
+  SPIEL_CHECK_TRUE(IsChanceNode());
+  const int face = std::min<int>(z * dice_outcomes_, dice_outcomes_ - 1);
+  return {face + 1, 1.0 / dice_outcomes_};
+}
+
 std::string PigState::ToString() const {
   return absl::StrCat("Scores: ", absl::StrJoin(scores_, " "),
                       ", Turn total: ", turn_total_,
@@ -15,9 +15,7 @@
 #include "open_spiel/games/quoridor.h"
 
 #include <algorithm>
-#include <functional>
 #include <memory>
-#include <queue>
 #include <utility>
 #include <vector>
 
@@ -61,67 +59,19 @@ REGISTER_SPIEL_GAME(kGameType, Factory);
 }  // namespace
 
 class QuoridorState::SearchState {
-  using DistanceAndMove = std::pair<int, Move>;
-
-  class SearchQueue
-      : public std::priority_queue<DistanceAndMove,
-                                   std::vector<DistanceAndMove>,
-                                   std::greater<DistanceAndMove>> {
-   public:
-    void clear() { c.clear(); }
-    void reserve(int capacity) { c.reserve(capacity); }
-  };
-
  public:
-  explicit SearchState(int board_diameter) {
-    int size = board_diameter * board_diameter;
-    mark_.resize(size, false);
-    on_shortest_path_.resize(size, false);
-    distance_.resize(size, UndefinedDistance());
-    queue_.reserve(size);
-  }
-
-  bool IsEmpty() const { return queue_.empty(); }
-
-  void ClearSearchQueue() { queue_.clear(); }
-
-  bool Push(int dist, Move move) {
-    if (mark_[move.xy] == false) {
-      mark_[move.xy] = true;
-      queue_.emplace(dist, move);
-      return true;
-    } else {
-      return false;
-    }
-  }
-
-  Move Pop() {
-    Move move = queue_.top().second;
-    queue_.pop();
-    return move;
-  }
-
-  void ResetSearchQueue() {
-    std::fill(mark_.begin(), mark_.end(), false);
-    queue_.clear();
-  }
-
-  void ResetDists() {
-    std::fill(distance_.begin(), distance_.end(), UndefinedDistance());
-  }
+  explicit SearchState(int board_diameter)
+      : on_shortest_path_(board_diameter * board_diameter, false) {}
 
-  void SetDist(Move move, int dist) { distance_[move.xy] = dist; }
-  int GetDist(Move move) const { return distance_[move.xy]; }
   void SetOnShortestPath(Move move) { on_shortest_path_[move.xy] = true; }
   bool IsOnShortestPath(Move move) const { return on_shortest_path_[move.xy]; }
 
-  static constexpr int UndefinedDistance() { return -1; }
+  // The cells first reached at each step of the last shortest path search.
+  std::vector<CellSet>& layers() { return layers_; }
 
  private:
-  SearchQueue queue_;
-  std::vector<bool> mark_;     // Whether this position has been pushed before.
-  std::vector<int> distance_;  // Distance from player.
   std::vector<bool> on_shortest_path_;  // Is this position on a shortest path?
+  std::vector<CellSet> layers_;
 };
 
 std::string Move::ToString() const {
@@ -144,6 +94,8 @@ QuoridorState::QuoridorState(std::shared_ptr<const Game> game, int board_size,
       board_diameter_(board_size * 2 - 1),
       ansi_color_output_(ansi_color_output) {
   board_.resize(board_diameter_ * board_diameter_, kPlayerNone);
+  open_east_ = CellSet(board_size);
+  open_south_ = CellSet(board_size);
   wall_count_[kPlayer1] = wall_count;
   wall_count_[kPlayer2] = wall_count;
   int start_x = board_size - (board_size % 2);
@@ -153,6 +105,12 @@ QuoridorState::QuoridorState(std::shared_ptr<const Game> game, int board_size,
   SetPlayer(player_loc_[kPlayer2], kPlayer2, kPlayerNone);
   end_zone_[kPlayer1] = player_loc_[kPlayer2].y;
   end_zone_[kPlayer2] = player_loc_[kPlayer1].y;
+  for (int y = 0; y < board_size; ++y) {
+    for (int x = 0; x < board_size; ++x) {
+      if (x < board_size - 1) open_east_.Set(x + y * board_size);
+      if (y < board_size - 1) open_south_.Set(x + y * board_size);
+    }
+  }
 }
 
 Move QuoridorState::ActionToMove(Action action_id) const {
@@ -267,85 +225,81 @@ bool QuoridorState::IsValidWall(Move m, SearchState* search_state) const {
   if (count <= 1) return true;
 
   // Do a full search to verify both players can get to their respective goals.
-  return (SearchEndZone(kPlayer1, m, m + offset * 2, search_state) &&
-          SearchEndZone(kPlayer2, m, m + offset * 2, search_state));
+  return (SearchEndZone(kPlayer1, m, m + offset * 2) &&
+          SearchEndZone(kPlayer2, m, m + offset * 2));
 }
 
-bool QuoridorState::SearchEndZone(QuoridorPlayer p, Move wall1, Move wall2,
-                                  SearchState* search_state) const {
-  search_state->ResetSearchQueue();
-  Offset dir(1, 0);  // Direction is arbitrary. Queue will make it fast.
-  int goal = end_zone_[p];
-  int goal_dir = (goal == 0 ? -1 : 1);  // Sort for shortest dist in a min-heap.
-  search_state->Push(0, player_loc_[p]);
-  while (!search_state->IsEmpty()) {
-    Move c = search_state->Pop();
-    for (int i = 0; i < 4; ++i) {
-      Move wall = c + dir;
-      if (!IsWall(wall) && wall != wall1 && wall != wall2) {
-        Move move = c + dir * 2;
-        if (move.y == goal) {
-          return true;
-        }
-        search_state->Push(goal_dir * (goal - move.y), move);
-      }
-      dir = dir.rotate_left();
-    }
-  }
+CellSet QuoridorState::GoalCells(QuoridorPlayer p) const {
+  CellSet goal(board_size_);
+  const int first_cell = (end_zone_[p] / 2) * board_size_;
+  for (int x = 0; x < board_size_; ++x) goal.Set(first_cell + x);
+  return goal;
+}
 
-  return false;
+bool QuoridorState::SearchEndZone(QuoridorPlayer p, Move wall1,
+                                  Move wall2) const {
+  CellSet open_east = open_east_;
+  CellSet open_south = open_south_;
+  ClosePassage(wall1, &open_east, &open_south);
+  ClosePassage(wall2, &open_east, &open_south);
+
+  // Floods the cells the pawn can reach, all the cells of the set stepping at
+  // once, until it reaches its goal row or stops growing.
+  const CellSet goal = GoalCells(p);
+  CellSet reached(board_size_);
+  reached.Set(PawnCell(player_loc_[p]));
+  while (true) {
+    CellSet next = reached.Step(open_east, open_south);
+    if ((next & goal).Any()) return true;
+    if (next == reached) return false;
+    reached = next;
+  }
 }
 
 void QuoridorState::SearchShortestPath(QuoridorPlayer p,
                                        SearchState* search_state) const {
-  search_state->ResetSearchQueue();
-  search_state->ResetDists();
-  Offset dir(1, 0);  // Direction is arbitrary. Queue will make it fast.
-  int goal = end_zone_[p];
-  int goal_dir = (goal == 0 ? -1 : 1);  // Sort for shortest dist in a min-heap.
-  search_state->Push(0, player_loc_[p]);
-  search_state->SetDist(player_loc_[p], 0);
-  Move goal_found = GetMove(-1, -1);  // invalid
-
-  // A* search for the end-zone, keeping distances to each cell.
-  while (!search_state->IsEmpty()) {
-    Move c = search_state->Pop();
-    int dist = search_state->GetDist(c);
-    for (int i = 0; i < 4; ++i) {
-      Move wall = c + dir;
-      if (!IsWall(wall)) {
-        Move move = c + dir * 2;
-        if (move.y == goal) {
-          search_state->SetDist(move, dist + 1);
-          search_state->ClearSearchQueue();  // Break out of the search.
-          goal_found = move;
-          break;
-        }
-        if (search_state->Push(dist + 1 + goal_dir * (goal - move.y), move)) {
-          search_state->SetDist(move, dist + 1);
-        }
-      }
-      dir = dir.rotate_left();
-    }
+  // Breadth first search for the end-zone, one step of all the cells at once,
+  // keeping the cells first reached at each step.
+  std::vector<CellSet>& layers = search_state->layers();
+  layers.clear();
+  const CellSet goal = GoalCells(p);
+  CellSet reached(board_size_);
+  reached.Set(PawnCell(player_loc_[p]));
+  layers.push_back(reached);
+  CellSet goal_reached;
+  while (true) {
+    CellSet next = reached.Step(open_east_, open_south_);
+    goal_reached = next & goal;
+    if (goal_reached.Any()) break;
+    if (next == reached) return;  // Walls never cut every path.
+    layers.push_back(next.Minus(reached));
+    reached = next;
   }
 
-  // Trace the way back, setting them to be on a shortest path.
-  Move current = goal_found;
-  int dist = search_state->GetDist(current);
-  while (current != player_loc_[p]) {
-    for (int i = 0; i < 4; ++i) {
-      Move wall = current + dir;
-      if (!IsWall(wall)) {
-        Move move = current + dir * 2;
-        int dist2 = search_state->GetDist(move);
-        if (dist2 != search_state->UndefinedDistance() && dist2 + 1 == dist) {
-          search_state->SetOnShortestPath(wall);
-          current = move;
-          dist = dist2;
-          break;
-        }
-      }
-      dir = dir.rotate_left();
+  // Trace the way back from a goal cell, setting the passages on the way to be
+  // on a shortest path.
+  int cell = (end_zone_[p] / 2) * board_size_;
+  while (!goal_reached.Test(cell)) ++cell;
+  for (int step = layers.size() - 1; step >= 0; --step) {
+    const CellSet& previous = layers[step];
+    const int x = cell % board_size_;
+    const int y = cell / board_size_;
+    if (x < board_size_ - 1 && open_east_.Test(cell) &&
+        previous.Test(cell + 1)) {
+      search_state->SetOnShortestPath(GetMove(2 * x + 1, 2 * y));
+      cell += 1;
+    } else if (x > 0 && open_east_.Test(cell - 1) && previous.Test(cell - 1)) {
+      search_state->SetOnShortestPath(GetMove(2 * x - 1, 2 * y));
+      cell -= 1;
+    } else if (y < board_size_ - 1 && open_south_.Test(cell) &&
+               previous.Test(cell + board_size_)) {
+      search_state->SetOnShortestPath(GetMove(2 * x, 2 * y + 1));
+      cell += board_size_;
+    } else {
+      SPIEL_CHECK_TRUE(y > 0 && open_south_.Test(cell - board_size_) &&
+                       previous.Test(cell - board_size_));
+      search_state->SetOnShortestPath(GetMove(2 * x, 2 * y - 1));
+      cell -= board_size_;
     }
   }
 }
@@ -465,6 +419,8 @@ void QuoridorState::DoApplyAction(Action action) {
     SetPlayer(move + offset * 0, kPlayerWall, kPlayerNone);
     SetPlayer(move + offset * 1, kPlayerWall, kPlayerNone);
     SetPlayer(move + offset * 2, kPlayerWall, kPlayerNone);
+    ClosePassage(move, &open_east_, &open_south_);
+    ClosePassage(move + offset * 2, &open_east_, &open_south_);
     wall_count_[current_player_] -= 1;
   } else {
     SetPlayer(player_loc_[current_player_], kPlayerNone, current_player_);
@@ -15,6 +15,7 @@
 #ifndef OPEN_SPIEL_GAMES_QUORIDOR_H_
 #define OPEN_SPIEL_GAMES_QUORIDOR_H_
 
+#include <array>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -83,6 +84,77 @@ struct Move {
   Move operator-(const Offset& o) const { return Move(x - o.x, y - o.y, size); }
 };
 
+// A set of the cells pawns stand on, bit x + y * board_size for the cell of
+// Move(2 * x, 2 * y). Its operations only touch the words the board needs, 2
+// for the default board.
+class CellSet {
+ public:
+  CellSet() = default;
+  explicit CellSet(int board_size)
+      : board_size_(board_size),
+        num_words_((board_size * board_size + 63) / 64) {}
+
+  void Set(int cell) { words_[cell / 64] |= uint64_t{1} << (cell % 64); }
+  void Reset(int cell) { words_[cell / 64] &= ~(uint64_t{1} << (cell % 64)); }
+  bool Test(int cell) const { return (words_[cell / 64] >> (cell % 64)) & 1; }
+  bool Any() const {
+    for (int i = 0; i < num_words_; ++i) {
+      if (words_[i]) return true;
+    }
+    return false;
+  }
+  bool operator==(const CellSet& other) const {
+    for (int i = 0; i < num_words_; ++i) {
+      if (words_[i] != other.words_[i]) return false;
+    }
+    return true;
+  }
+  CellSet operator&(const CellSet& other) const {
+    CellSet result(board_size_);
+    for (int i = 0; i < num_words_; ++i) {
+      result.words_[i] = words_[i] & other.words_[i];
+    }
+    return result;
+  }
+  // The cells of this set which are not in the other.
+  CellSet Minus(const CellSet& other) const {
+    CellSet result(board_size_);
+    for (int i = 0; i < num_words_; ++i) {
+      result.words_[i] = words_[i] & ~other.words_[i];
+    }
+    return result;
+  }
+
+  // These cells, with those one step away from them through the passages
+  // open to the east, and to the south, from the cells of those sets.
+  CellSet Step(const CellSet& open_east, const CellSet& open_south) const {
+    const int n = board_size_;
+    CellSet result(n);
+    // The cells stepping east and south, in this word and the one before.
+    uint64_t east_before = 0;
+    uint64_t south_before = 0;
+    for (int i = 0; i < num_words_; ++i) {
+      const uint64_t after = i < num_words_ - 1 ? words_[i + 1] : 0;
+      const uint64_t east = words_[i] & open_east.words_[i];
+      const uint64_t south = words_[i] & open_south.words_[i];
+      result.words_[i] =
+          words_[i] | east << 1 | east_before >> 63 | south << n |
+          south_before >> (64 - n) |
+          ((words_[i] >> 1 | after << 63) & open_east.words_[i]) |
+          ((words_[i] >> n | after << (64 - n)) & open_south.words_[i]);
+      east_before = east;
+      south_before = south;
+    }
+    return result;
+  }
+
+ private:
+  int board_size_ = 0;
+  int num_words_ = 0;
+  // Only the first num_words_ are used, the others stay 0.
+  std::array<uint64_t, (kMaxBoardSize * kMaxBoardSize + 63) / 64> words_{};
+};
+
 // State of an in-play game.
 class QuoridorState : public State {
  public:
@@ -125,6 +197,16 @@ class QuoridorState : public State {
   }
 
  private:
+  int PawnCell(Move m) const { return m.x / 2 + (m.y / 2) * board_size_; }
+
+  // Closes the passage across the wall segment in the sets of open passages.
+  void ClosePassage(Move wall, CellSet* open_east, CellSet* open_south) const {
+    (wall.IsVerticalWall() ? open_east : open_south)->Reset(PawnCell(wall));
+  }
+
+  // The goal row of the player.
+  CellSet GoalCells(QuoridorPlayer p) const;
+
   // SearchState contains details that are only used in the .cc file.
   // A different technique in the same area is called pimpl (pointer to
   // implementation).
@@ -133,11 +215,14 @@ class QuoridorState : public State {
   // Helpers for `LegaLActions`.
   void AddActions(Move cur, Offset offset, std::vector<Action>* moves) const;
   bool IsValidWall(Move m, SearchState*) const;
-  bool SearchEndZone(QuoridorPlayer p, Move wall1, Move wall2,
-                     SearchState*) const;
+  bool SearchEndZone(QuoridorPlayer p, Move wall1, Move wall2) const;
   void SearchShortestPath(QuoridorPlayer p, SearchState* search_state) const;
 
   std::vector<QuoridorPlayer> board_;
+  // The cells from which a pawn can step east, and south, without crossing a
+  // wall or leaving the board.
+  CellSet open_east_;
+  CellSet open_south_;
   int wall_count_[kNumPlayers];
   int end_zone_[kNumPlayers];
   Move player_loc_[kNumPlayers];
@@ -12,7 +12,10 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <iostream>
+#include <memory>
+#include <vector>
 
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
@@ -45,8 +48,33 @@ void BasicQuoridorTests() {
       *LoadGame("quoridor(board_size=5,ansi_color_output=True)"), 3);
 }
 
+bool IsLegal(const State& state, Action action) {
+  std::vector<Action> actions = state.LegalActions();
+  return std::find(actions.begin(), actions.end(), action) != actions.end();
+}
+
+void WallLegalityTest() {
+  // On a 4x4 board, actions are x + 7 * y on the 7x7 grid of cells and walls.
+  std::unique_ptr<State> state =
+      LoadGame("quoridor(board_size=4)")->NewInitialState();
+  SPIEL_CHECK_TRUE(IsLegal(*state, 3 * 7 + 0));
+  SPIEL_CHECK_TRUE(IsLegal(*state, 3 * 7 + 4));
+  state->ApplyAction(3 * 7 + 0);  // A horizontal wall across a1 and b1.
+
+  // Across c2 and d2, it would cut the board in two, but not one row lower.
+  SPIEL_CHECK_FALSE(IsLegal(*state, 3 * 7 + 4));
+  SPIEL_CHECK_TRUE(IsLegal(*state, 5 * 7 + 4));
+  // Walls overlapping or crossing it are never legal, those touching it can be.
+  SPIEL_CHECK_FALSE(IsLegal(*state, 3 * 7 + 2));
+  SPIEL_CHECK_FALSE(IsLegal(*state, 2 * 7 + 1));
+  SPIEL_CHECK_TRUE(IsLegal(*state, 2 * 7 + 3));
+}
+
 }  // namespace
 }  // namespace quoridor
 }  // namespace open_spiel
 
-int main(int argc, char** argv) { open_spiel::quoridor::BasicQuoridorTests(); }
+int main(int argc, char** argv) {
+  open_spiel::quoridor::BasicQuoridorTests();
+  open_spiel::quoridor::WallLegalityTest();
+}
@@ -14,11 +14,20 @@
 
 #include "open_spiel/games/skat.h"
 
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <vector>
+
 #include "open_spiel/abseil-cpp/absl/strings/str_format.h"
 #include "open_spiel/abseil-cpp/absl/strings/string_view.h"
 #include "open_spiel/game_parameters.h"
+#include "open_spiel/games/skat/skat_solver.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/constrained_deal.h"
 
 
 namespace open_spiel {
@@ -38,8 +47,8 @@ const GameType kGameType{/*short_name=*/"skat",
                          /*provides_information_state_tensor=*/false,
                          /*provides_observation_string=*/true,
                          /*provides_observation_tensor=*/true,
-                         /*parameter_specification=*/{}  // no parameters
-};
+                         /*parameter_specification=*/
+                         {{"use_solver_result", GameParameter(false)}}};
 
 std::shared_ptr<const Game> Factory(const GameParameters& params) {
   return std::shared_ptr<const Game>(new SkatGame(params));
@@ -191,6 +200,32 @@ CardLocation PlayerToLocation(int player) {
   }
 }
 
+// Where the card dealt in the given round goes.
+CardLocation DealtTo(int deal_round) {
+  // Cards 0-2, 11-14, 23-25 to player 1.
+  // Cards 3-5, 15-18, 26-28 to player 2.
+  // Cards 6-8, 19-22, 29-31 to player 3.
+  // Cards 9-10 into the Skat.
+  // While this might seem a bit weird, this is the official order Skat cards
+  // are dealt.
+  if ((deal_round >= 0 && deal_round <= 2) ||
+      (deal_round >= 11 && deal_round <= 14) ||
+      (deal_round >= 23 && deal_round <= 25)) {
+    return kHand0;
+  } else if ((deal_round >= 3 && deal_round <= 5) ||
+      (deal_round >= 15 && deal_round <= 18) ||
+      (deal_round >= 26 && deal_round <= 28)) {
+    return kHand1;
+  } else if ((deal_round >= 6 && deal_round <= 8) ||
+      (deal_round >= 19 && deal_round <= 22) ||
+      (deal_round >= 29 && deal_round <= 31)) {
+    return kHand2;
+  } else {
+    SPIEL_CHECK_TRUE(deal_round == 9 || deal_round == 10);
+    return kSkat;
+  }
+}
+
 // *********************************** Trick ***********************************
 
 int Trick::FirstCard() const {
@@ -233,8 +268,8 @@ std::string Trick::ToString() const {
 
 // ********************************* SkatState *********************************
 
-SkatState::SkatState(std::shared_ptr<const Game> game)
-      : State(game) {
+SkatState::SkatState(std::shared_ptr<const Game> game, bool use_solver_result)
+      : State(game), use_solver_result_(use_solver_result) {
   card_locations_.fill(kDeck);
   player_bids_.fill(kPass);
 }
@@ -368,27 +403,7 @@ void SkatState::DoApplyAction(Action action) {
 void SkatState::ApplyDealAction(int card) {
   SPIEL_CHECK_EQ(card_locations_[card], kDeck);
   int deal_round = history_.size();
-  // Cards 0-2, 11-14, 23-25 to player 1.
-  // Cards 3-5, 15-18, 26-28 to player 2.
-  // Cards 6-8, 19-22, 29-31 to player 3.
-  // Cards 9-10 into the Skat.
-  // While this might seem a bit weird, this is the official order Skat cards
-  // are dealt.
-  if ((deal_round >= 0 && deal_round <= 2) ||
-      (deal_round >= 11 && deal_round <= 14) ||
-      (deal_round >= 23 && deal_round <= 25)) {
-    card_locations_[card] = kHand0;
-  } else if ((deal_round >= 3 && deal_round <= 5) ||
-      (deal_round >= 15 && deal_round <= 18) ||
-      (deal_round >= 26 && deal_round <= 28)) {
-    card_locations_[card] = kHand1;
-  } else if ((deal_round >= 6 && deal_round <= 8) ||
-      (deal_round >= 19 && deal_round <= 22) ||
-      (deal_round >= 29 && deal_round <= 31)) {
-    card_locations_[card] = kHand2;
-  } else if (deal_round == 9 || deal_round == 10) {
-    card_locations_[card] = kSkat;
-  }
+  card_locations_[card] = DealtTo(deal_round);
   if (deal_round == kNumCards - 1) {
     current_player_ = 0;
     phase_ = kBidding;
@@ -441,6 +456,10 @@ void SkatState::ApplyDiscardCardsAction(int card) {
   if (CardsInSkat() == 2) {
     phase_ = kPlay;
     current_player_ = 0;
+    if (use_solver_result_) {
+      returns_ = SolvedReturns();
+      phase_ = kGameOver;
+    }
   }
 }
 
@@ -503,13 +522,97 @@ void SkatState::ScoreUp() {
       }
     }
   }
+  returns_ = ReturnsFromPoints(points_solo_, points_team_);
+}
+
+std::vector<double> SkatState::ReturnsFromPoints(int points_solo,
+                                                 int points_team) const {
+  std::vector<double> returns(kNumPlayers);
   for (int pl = 0; pl < kNumPlayers; ++pl) {
     if (solo_player_ == pl) {
-      returns_[pl] = (points_solo_ - 60) / 120.0;
+      returns[pl] = (points_solo - 60) / 120.0;
     } else {
-      returns_[pl] = (points_team_ - 60) / 240.0;
+      returns[pl] = (points_team - 60) / 240.0;
     }
   }
+  return returns;
+}
+
+std::vector<double> SkatState::SolvedReturns() const {
+  SPIEL_CHECK_TRUE(phase_ == kDiscardCards || phase_ == kPlay);
+  CardPlayRules rules;
+  rules.null_game = game_type_ == kNullGame;
+  for (int led = 0; led < kNumCards; ++led) {
+    rules.points[led] = CardValue(led);
+    for (int card = 0; card < kNumCards; ++card) {
+      if (FollowsSuit(card, led)) rules.follows[led] |= 1u << card;
+      rules.order[led][card] = CardOrder(card, led);
+    }
+  }
+  std::array<uint32_t, kNumPlayers> hands{};
+  std::vector<int> skat;
+  for (int card = 0; card < kNumCards; ++card) {
+    const CardLocation location = card_locations_[card];
+    if (location >= kHand0 && location <= kHand2) {
+      hands[location - kHand0] |= 1u << card;
+    } else if (location == kSkat) {
+      skat.push_back(card);
+    }
+  }
+
+  // The value for the solo player of the play from here: their card points,
+  // or for a null game, 1 if they win and 0 otherwise.
+  CardPlaySolver solver(rules);
+  int value;
+  if (phase_ == kPlay) {
+    std::vector<int> trick;
+    if (num_cards_played_ % kNumPlayers != 0) trick = CurrentTrick().GetCards();
+    value = solver.Solve(hands, solo_player_, current_player_, trick);
+    if (!rules.null_game) {
+      for (int card : skat) value += CardValue(card);
+    }
+  } else {
+    // Each way the solo player can complete their discards.
+    std::vector<int> cards;
+    for (int card = 0; card < kNumCards; ++card) {
+      if (hands[solo_player_] & (1u << card)) cards.push_back(card);
+    }
+    std::vector<std::vector<int>> discards;
+    if (skat.size() == 1) {
+      for (int card : cards) discards.push_back({card});
+    } else {
+      for (int i = 0; i < cards.size(); ++i) {
+        for (int j = i + 1; j < cards.size(); ++j) {
+          discards.push_back({cards[i], cards[j]});
+        }
+      }
+    }
+    // Each is only searched for a value above the best so far, with the
+    // transpositions found for the others.
+    value = -1;
+    for (const std::vector<int>& discard : discards) {
+      std::array<uint32_t, kNumPlayers> discarded_hands = hands;
+      int skat_points = 0;
+      if (!rules.null_game) {
+        for (int card : skat) skat_points += CardValue(card);
+        for (int card : discard) skat_points += CardValue(card);
+      }
+      for (int card : discard) discarded_hands[solo_player_] &= ~(1u << card);
+      const int max_value = rules.null_game ? 1 : kMaxCardPoints;
+      value = std::max(value, skat_points + solver.Solve(discarded_hands,
+                                                         solo_player_,
+                                                         /*player=*/0,
+                                                         /*trick=*/{},
+                                                         value - skat_points,
+                                                         max_value + 1));
+    }
+  }
+
+  if (rules.null_game) {
+    return value == 1 ? ReturnsFromPoints(90, 30) : ReturnsFromPoints(30, 90);
+  }
+  const int points_solo = points_solo_ + value;
+  return ReturnsFromPoints(points_solo, kMaxCardPoints - points_solo);
 }
 
 std::string SkatState::CardLocationsToString() const {
@@ -589,31 +692,26 @@ std::vector<Action> SkatState::DiscardCardsLegalActions() const {
   return legal_actions;
 }
 
+bool SkatState::FollowsSuit(int card, int first_card) const {
+  int suit = CardSuit(first_card);
+  if (game_type_ == kNullGame) {
+    return card % kNumSuits == suit;
+  }
+  // Jacks are trumps, not part of their suit.
+  return (IsTrump(first_card) && CardRank(card) == kJack) ||
+         (suit == CardSuit(card) && CardRank(card) != kJack);
+}
+
 std::vector<Action> SkatState::PlayLegalActions() const {
   std::vector<Action> legal_actions;
   legal_actions.reserve(kNumTricks - num_cards_played_ / kNumPlayers);
   if (num_cards_played_ % kNumPlayers != 0) {
     // Check if we can follow suit.
     int first_card = CurrentTrick().FirstCard();
-    int suit = CardSuit(first_card);
-    if (game_type_ == kNullGame) {
-      for (int rank = 0; rank < kNumRanks; ++rank) {
-        int card = rank * kNumSuits + static_cast<int>(suit);
-        if (card_locations_[card] == PlayerToLocation(current_player_)) {
-          legal_actions.push_back(card);
-        }
-      }
-    } else {
-      // This is a bid fidely but it makes sure the legal actions are sorted
-      // (which is required), which the special status of jacks makes hard
-      // otherwise.
-      for (int card = 0; card < kNumCards; ++card) {
-        if ((IsTrump(first_card) && CardRank(card) == kJack) ||
-            (suit == CardSuit(card) && CardRank(card) != kJack)) {
-          if (card_locations_[card] == PlayerToLocation(current_player_)) {
-            legal_actions.push_back(card);
-          }
-        }
+    for (int card = 0; card < kNumCards; ++card) {
+      if (FollowsSuit(card, first_card) &&
+          card_locations_[card] == PlayerToLocation(current_player_)) {
+        legal_actions.push_back(card);
       }
     }
   }
@@ -642,6 +740,18 @@ std::vector<std::pair<Action, double>> SkatState::ChanceOutcomes() const {
   return outcomes;
 }
 
+// Uniform over the cards left in the deck, picked without listing them.
+std::pair<Action, double> SkatState::SampleChanceOutcome(double z) const {
+  const int num_cards_remaining = kNumCards - history_.size();
+  int index = std::min<int>(z * num_cards_remaining, num_cards_remaining - 1);
+  for (int card = 0; card < kNumCards; ++card) {
+    if (card_locations_[card] == kDeck && index-- == 0) {
+      return {card, 1.0 / num_cards_remaining};
+    }
+  }
+  SpielFatalError("No card left to deal.");
+}
+
 void SkatState::ObservationTensor(Player player,
                                   std::vector<double>* values) const {
   SPIEL_CHECK_GE(player, 0);
@@ -719,6 +829,108 @@ int GetIntFromOneHot(std::vector<double>::iterator one_hot, int num_values) {
   return -1;
 }
 
+std::unique_ptr<State> SkatState::ResampleFromInfostate(
+    int player_id, std::function<double()> rng) const {
+  // The player knows their own cards, the bids, the cards played and, as the
+  // solo player, the Skat. The other cards are dealt again to where they are
+  // now: the other hands, the Skat and the deck. A player who didn't follow
+  // suit gets none of the cards they could have followed with.
+  const CardLocation own_hand = PlayerToLocation(player_id);
+  const bool knows_skat = player_id == solo_player_;
+  std::array<std::vector<int>, kNumPlayers> void_in;  // Led cards not followed.
+  const int num_tricks =
+      std::min(kNumTricks, (num_cards_played_ + kNumPlayers - 1) / kNumPlayers);
+  for (int t = 0; t < num_tricks; ++t) {
+    const std::vector<int> cards = tricks_[t].GetCards();
+    for (int i = 1; i < cards.size(); ++i) {
+      if (!FollowsSuit(cards[i], cards[0])) {
+        void_in[tricks_[t].PlayerAtPosition(i)].push_back(cards[0]);
+      }
+    }
+  }
+  std::vector<int> hidden;
+  std::vector<uint32_t> allowed;
+  std::vector<int> sizes(kSkat + 1, 0);  // Indexed by CardLocation.
+  for (int card = 0; card < kNumCards; ++card) {
+    const CardLocation location = card_locations_[card];
+    if (location == own_hand || location == kTrick ||
+        (location == kSkat && knows_skat)) {
+      continue;
+    }
+    hidden.push_back(card);
+    ++sizes[location];
+    uint32_t hands = 1 << kDeck;
+    if (!knows_skat) hands |= 1 << kSkat;
+    for (Player p = 0; p < kNumPlayers; ++p) {
+      if (p == player_id) continue;
+      bool could_follow = false;
+      for (int led : void_in[p]) could_follow |= FollowsSuit(card, led);
+      if (!could_follow) hands |= 1 << PlayerToLocation(p);
+    }
+    allowed.push_back(hands);
+  }
+  std::array<CardLocation, kNumCards> locations = card_locations_;
+  std::vector<int> deal = ConstrainedDeal(allowed, sizes, rng);
+  for (int i = 0; i < hidden.size(); ++i) {
+    locations[hidden[i]] = static_cast<CardLocation>(deal[i]);
+  }
+
+  // What each location was dealt: the cards there and those played from it.
+  // The solo player took the Skat up, so their cards and the Skat are dealt
+  // again between them, but the solo player knows the original Skat.
+  std::array<std::vector<int>, kSkat + 1> dealt;
+  for (int card = 0; card < kNumCards; ++card) {
+    if (locations[card] != kTrick) dealt[locations[card]].push_back(card);
+  }
+  for (int t = 0; t < num_tricks; ++t) {
+    const std::vector<int> cards = tricks_[t].GetCards();
+    for (int i = 0; i < cards.size(); ++i) {
+      dealt[PlayerToLocation(tricks_[t].PlayerAtPosition(i))].push_back(
+          cards[i]);
+    }
+  }
+  std::vector<int> discards;
+  if (solo_player_ >= 0) {
+    const CardLocation solo_hand = PlayerToLocation(solo_player_);
+    discards = dealt[kSkat];
+    std::vector<int>& pool = dealt[solo_hand];
+    pool.insert(pool.end(), discards.begin(), discards.end());
+    if (knows_skat) {
+      dealt[kSkat] = {static_cast<int>(history_[9]),
+                      static_cast<int>(history_[10])};
+    } else {
+      dealt[kSkat].clear();
+      for (int i = 0; i < kNumCardsInSkat; ++i) {
+        const int index = std::min<int>(rng() * pool.size(), pool.size() - 1);
+        dealt[kSkat].push_back(pool[index]);
+        pool.erase(pool.begin() + index);
+      }
+    }
+    for (int card : dealt[kSkat]) {
+      auto it = std::find(pool.begin(), pool.end(), card);
+      if (it != pool.end()) pool.erase(it);
+    }
+  }
+
+  std::unique_ptr<State> state = game_->NewInitialState();
+  auto& skat_state = static_cast<SkatState&>(*state);
+  for (int i = 0; i < history_.size(); ++i) {
+    Action action = history_[i];
+    if (skat_state.phase_ == kDeal) {
+      const CardLocation location = DealtTo(i);
+      if (location != own_hand && !(location == kSkat && knows_skat)) {
+        action = dealt[location].back();
+        dealt[location].pop_back();
+      }
+    } else if (skat_state.phase_ == kDiscardCards && !knows_skat) {
+      action = discards.back();
+      discards.pop_back();
+    }
+    state->ApplyAction(action);
+  }
+  return state;
+}
+
 std::string SkatState::ObservationString(Player player) const {
   SPIEL_CHECK_GE(player, 0);
   SPIEL_CHECK_LT(player, num_players_);
@@ -786,7 +998,8 @@ SkatGame::SkatGame(const GameParameters& params)
     : Game(kGameType, params) {}
 
 std::unique_ptr<State> SkatGame::NewInitialState() const {
-  return std::unique_ptr<State>(new SkatState(shared_from_this()));
+  return std::unique_ptr<State>(
+      new SkatState(shared_from_this(), UseSolverResult()));
 }
 
 }  // namespace skat
@@ -15,7 +15,9 @@
 #ifndef OPEN_SPIEL_GAMES_SKAT_H_
 #define OPEN_SPIEL_GAMES_SKAT_H_
 
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "open_spiel/spiel.h"
 
@@ -37,6 +39,11 @@
 // makes it a zero-sum game and since there are 120 points in total, each side
 // gets a positive score if they get more than half the points.
 //
+// With use_solver_result, the game ends as soon as the Skat is discarded,
+// with the returns of the cards played out perfectly by players who all know
+// the hands (see SkatState::SolvedReturns), as bridge's
+// use_double_dummy_result does for its auction.
+//
 // The action space is as follows:
 //   0..31     Cards, used for dealing, discarding and playing cards.
 //   32+       Bidding, currently you can only bid for a game type.
@@ -54,6 +61,7 @@ inline constexpr int kNumTricks = (kNumCards - kNumCardsInSkat) / kNumPlayers;
 inline constexpr int kBiddingActionBase = kNumCards;  // First bidding action.
 inline constexpr int kNumBiddingActions = kNumGameTypes;
 inline constexpr int kNumActions = kNumCards + kNumBiddingActions;
+inline constexpr int kMaxCardPoints = 120;  // The points of all the cards.
 inline constexpr char kEmptyCardSymbol[] = "🂠";
 
 inline constexpr int kObservationTensorSize =
@@ -138,7 +146,7 @@ class Trick {
 
 class SkatState : public State {
  public:
-  SkatState(std::shared_ptr<const Game> game);
+  SkatState(std::shared_ptr<const Game> game, bool use_solver_result);
   SkatState(const SkatState&) = default;
 
   Player CurrentPlayer() const override {
@@ -154,10 +162,19 @@ class SkatState : public State {
   std::string ToString() const override;
   std::vector<Action> LegalActions() const override;
   std::vector<std::pair<Action, double>> ChanceOutcomes() const override;
+  std::pair<Action, double> SampleChanceOutcome(double z) const override;
 
   std::string ObservationString(Player player) const override;
   void ObservationTensor(Player player,
                          std::vector<double>* values) const override;
+  std::unique_ptr<State> ResampleFromInfostate(
+      int player_id, std::function<double()> rng) const override;
+
+  // The returns if the cards are played out perfectly by players who all know
+  // the hands, found by CardPlaySolver (see skat/skat_solver.h). In the
+  // discarding phase, the solo player also discards the best cards. The
+  // state must be in the discarding or the play phase.
+  std::vector<double> SolvedReturns() const;
 
  protected:
   void DoApplyAction(Action action) override;
@@ -175,11 +192,14 @@ class SkatState : public State {
   void EndBidding(Player winner, SkatGameType game_type);
   int NextPlayer() { return (current_player_ + 1) % kNumPlayers; }
   bool IsTrump(int card) const;
+  // Whether the card follows suit when first_card was led.
+  bool FollowsSuit(int card, int first_card) const;
   int CardOrder(int card, int first_card) const;
   int TrumpOrder(int card) const;
   int NullOrder(Rank rank) const;
   int WinsTrick() const;
   void ScoreUp();
+  std::vector<double> ReturnsFromPoints(int points_solo, int points_team) const;
   int CardsInSkat() const;
   int CurrentTrickIndex() const {
     return std::min(kNumTricks - 1, num_cards_played_ / kNumPlayers);
@@ -191,6 +211,7 @@ class SkatState : public State {
   }
   std::string CardLocationsToString() const;
 
+  const bool use_solver_result_;
   SkatGameType game_type_ = kUnknownGame;   // The trump suit (or notrumps)
   Phase phase_ = kDeal;
   // CardLocation for each card.
@@ -225,6 +246,9 @@ class SkatGame : public Game {
   std::vector<int> ObservationTensorShape() const override {
     return {kObservationTensorSize};
   }
+  bool UseSolverResult() const {
+    return ParameterValue<bool>("use_solver_result", false);
+  }
 };
 
 }  // namespace skat
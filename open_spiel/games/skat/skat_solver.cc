@@ -0,0 +1,292 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/games/skat/skat_solver.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "open_spiel/games/skat.h"
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace skat {
+
+namespace {
+
+// Whether the two cards play the same part in every trick but for their rank,
+// in which the first is lower, and are worth the same.
+bool RanksBelow(const CardPlayRules& rules, int low, int high) {
+  if (!rules.null_game && rules.points[low] != rules.points[high]) {
+    return false;
+  }
+  if (rules.order[low][low] >= rules.order[high][high]) return false;
+  for (int led = 0; led < kNumCards; ++led) {
+    const bool low_follows = (rules.follows[led] >> low) & 1;
+    const bool high_follows = (rules.follows[led] >> high) & 1;
+    if (low_follows != high_follows) return false;
+    const int low_order = rules.order[led][low];
+    const int high_order = rules.order[led][high];
+    if ((low_order < 0) != (high_order < 0)) return false;
+    if (low_order >= 0 && low_order >= high_order) return false;
+  }
+  for (int card = 0; card < kNumCards; ++card) {
+    if (card == low || card == high) continue;
+    if (rules.order[low][card] != rules.order[high][card]) return false;
+  }
+  return rules.follows[low] == rules.follows[high];
+}
+
+}  // namespace
+
+CardPlaySolver::CardPlaySolver(const CardPlayRules& rules) : rules_(rules) {
+  for (int low = 0; low < kNumCards; ++low) {
+    for (int high = 0; high < kNumCards; ++high) {
+      if (!RanksBelow(rules_, low, high)) continue;
+      equivalent_[low * kNumCards + high] = true;
+      // Any card in a trick with both is ranked between them if it is above
+      // one and below the other there.
+      for (int card = 0; card < kNumCards; ++card) {
+        const int order = rules_.order[high][card];
+        if (order > rules_.order[high][low] &&
+            order < rules_.order[high][high]) {
+          between_[low][high] |= 1u << card;
+        }
+      }
+    }
+  }
+}
+
+int CardPlaySolver::Solve(const std::array<uint32_t, kNumPlayers>& hands,
+                          Player solo_player, Player player,
+                          const std::vector<int>& trick) {
+  return Solve(hands, solo_player, player, trick, -1, MaxValue() + 1);
+}
+
+int CardPlaySolver::Solve(const std::array<uint32_t, kNumPlayers>& hands,
+                          Player solo_player, Player player,
+                          const std::vector<int>& trick, int alpha,
+                          int beta) {
+  SPIEL_CHECK_LT(trick.size(), kNumPlayers);
+  hands_ = hands;
+  solo_player_ = solo_player;
+  trick_size_ = trick.size();
+  for (int i = 0; i < trick_size_; ++i) trick_[i] = trick[i];
+  leader_ = (player + kNumPlayers - trick_size_) % kNumPlayers;
+
+  // Narrowing down the value by zero-window searches, each telling whether
+  // it is at least some test value, cuts off more than one wide search. The
+  // bounds they leave in the table make the later ones quick.
+  int lower = alpha;
+  int upper = beta;
+  int value = alpha;
+  while (lower < upper) {
+    const int test = lower + (upper - lower + 1) / 2;
+    value = Search(player, test - 1, test);
+    if (value >= test) {
+      lower = value;
+    } else {
+      upper = value;
+    }
+  }
+  return value;
+}
+
+int CardPlaySolver::Search(Player player, int alpha, int beta) {
+  const bool trick_start = trick_size_ == 0;
+  uint64_t key = 0;
+  if (trick_start) {
+    const uint32_t cards_left = hands_[0] | hands_[1] | hands_[2];
+    if (cards_left == 0) return rules_.null_game ? 1 : 0;
+    if (!rules_.null_game) {
+      // The solo player wins at most the points left.
+      int points_left = 0;
+      for (uint32_t cards = cards_left; cards != 0; cards &= cards - 1) {
+        points_left += rules_.points[__builtin_ctz(cards)];
+      }
+      if (points_left <= alpha) return points_left;
+      beta = std::min(beta, points_left + 1);
+    }
+    key = cards_left | static_cast<uint64_t>(player) << 32;
+    auto it = table_.find(key);
+    if (it != table_.end()) {
+      const Bounds& bounds = it->second;
+      if (bounds.lower >= beta || bounds.lower == bounds.upper) {
+        return bounds.lower;
+      }
+      if (bounds.upper <= alpha) return bounds.upper;
+      alpha = std::max(alpha, bounds.lower);
+      beta = std::min(beta, bounds.upper);
+    }
+  }
+  const int search_alpha = alpha;
+  const int search_beta = beta;
+
+  std::array<int, kNumTricks> moves;
+  const int num_moves = OrderedMoves(player, &moves);
+  const bool maximizing = player == solo_player_;
+  int best = maximizing ? std::numeric_limits<int>::min()
+                        : std::numeric_limits<int>::max();
+  for (int i = 0; i < num_moves; ++i) {
+    const int card = moves[i];
+    hands_[player] &= ~(1u << card);
+    trick_[trick_size_++] = card;
+    int value;
+    if (trick_size_ == kNumPlayers) {
+      const Player winner = TrickWinner();
+      const std::array<int, kNumPlayers> trick = trick_;
+      const Player leader = leader_;
+      trick_size_ = 0;
+      leader_ = winner;
+      if (rules_.null_game) {
+        // The solo player loses as soon as they win a trick.
+        value = winner == solo_player_ ? 0 : Search(winner, alpha, beta);
+      } else {
+        int won = 0;
+        if (winner == solo_player_) {
+          for (int c : trick) won += rules_.points[c];
+        }
+        value = won + Search(winner, alpha - won, beta - won);
+      }
+      trick_ = trick;
+      leader_ = leader;
+      trick_size_ = kNumPlayers;
+    } else {
+      value = Search((player + 1) % kNumPlayers, alpha, beta);
+    }
+    --trick_size_;
+    hands_[player] |= 1u << card;
+
+    if (maximizing) {
+      best = std::max(best, value);
+      alpha = std::max(alpha, best);
+    } else {
+      best = std::min(best, value);
+      beta = std::min(beta, best);
+    }
+    if (alpha >= beta) break;
+  }
+
+  if (trick_start) {
+    Bounds& bounds =
+        table_.try_emplace(key, Bounds{0, MaxValue()}).first->second;
+    if (best <= search_alpha) {
+      bounds.upper = std::min(bounds.upper, best);
+    } else if (best >= search_beta) {
+      bounds.lower = std::max(bounds.lower, best);
+    } else {
+      bounds = {best, best};
+    }
+  }
+  return best;
+}
+
+int CardPlaySolver::TrickWinner() const {
+  const int led = trick_[0];
+  int winning_position = 0;
+  for (int i = 1; i < trick_size_; ++i) {
+    if (rules_.order[led][trick_[i]] >
+        rules_.order[led][trick_[winning_position]]) {
+      winning_position = i;
+    }
+  }
+  return (leader_ + winning_position) % kNumPlayers;
+}
+
+int CardPlaySolver::OrderedMoves(Player player,
+                                 std::array<int, kNumTricks>* moves) const {
+  uint32_t legal = hands_[player];
+  if (trick_size_ > 0) {
+    const uint32_t following = legal & rules_.follows[trick_[0]];
+    if (following != 0) legal = following;
+  }
+
+  // Leads go from the highest card down. Later in the trick, a side which is
+  // winning it puts on points, and one which isn't tries its winning cards
+  // first, taking the most points with the lowest card, and otherwise throws
+  // its cheapest card.
+  std::array<std::pair<int, int>, kNumTricks> scored;  // Score, card.
+  int num_moves = 0;
+  const int led = trick_size_ > 0 ? trick_[0] : -1;
+  int winning_order = -1;
+  bool partner_winning = false;
+  if (trick_size_ > 0) {
+    const Player winner = TrickWinner();
+    winning_order =
+        rules_.order[led][trick_[(winner - leader_ + kNumPlayers) %
+                                 kNumPlayers]];
+    partner_winning = (winner == solo_player_) == (player == solo_player_);
+  }
+  // Of equivalent cards, only the lowest is tried.
+  uint32_t in_play = hands_[0] | hands_[1] | hands_[2];
+  for (int i = 0; i < trick_size_; ++i) in_play |= 1u << trick_[i];
+  for (int card = 0; card < kNumCards; ++card) {
+    if (!(legal & (1u << card))) continue;
+    bool has_lower_equivalent = false;
+    for (uint32_t others = legal; others != 0; others &= others - 1) {
+      const int other = __builtin_ctz(others);
+      if (equivalent_[other * kNumCards + card] &&
+          (between_[other][card] & in_play) == 0) {
+        has_lower_equivalent = true;
+        break;
+      }
+    }
+    if (has_lower_equivalent) continue;
+    const int points = rules_.points[card];
+    int score;
+    if (trick_size_ == 0) {
+      score = rules_.order[card][card];
+    } else {
+      const int order = rules_.order[led][card];
+      if (partner_winning) {
+        score = points * kNumCards - order;
+      } else if (order > winning_order) {
+        score = kNumCards * kNumCards + points * kNumCards - order;
+      } else {
+        score = -points * kNumCards - order;
+      }
+    }
+    scored[num_moves++] = {score, card};
+  }
+  std::sort(scored.begin(), scored.begin() + num_moves,
+            [](const std::pair<int, int>& a, const std::pair<int, int>& b) {
+              return a.first > b.first;
+            });
+  for (int i = 0; i < num_moves; ++i) (*moves)[i] = scored[i].second;
+  return num_moves;
+}
+
+std::vector<double> SkatSolverEvaluator::Evaluate(const State& state) {
+  if (state.IsTerminal()) return state.Returns();
+  const auto* skat_state = dynamic_cast<const SkatState*>(&state);
+  SPIEL_CHECK_TRUE(skat_state != nullptr);
+  return skat_state->SolvedReturns();
+}
+
+ActionsAndProbs SkatSolverEvaluator::Prior(const State& state) {
+  std::vector<Action> legal_actions = state.LegalActions();
+  ActionsAndProbs prior;
+  prior.reserve(legal_actions.size());
+  for (Action action : legal_actions) {
+    prior.emplace_back(action, 1.0 / legal_actions.size());
+  }
+  return prior;
+}
+
+}  // namespace skat
+}  // namespace open_spiel
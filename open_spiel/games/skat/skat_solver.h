@@ -0,0 +1,109 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_GAMES_SKAT_SKAT_SOLVER_H_
+#define OPEN_SPIEL_GAMES_SKAT_SKAT_SOLVER_H_
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/container/flat_hash_map.h"
+#include "open_spiel/algorithms/mcts.h"
+#include "open_spiel/games/skat.h"
+#include "open_spiel/spiel.h"
+
+// A perfect-information solver for the play of skat, the counterpart of the
+// double-dummy solver for bridge: it finds what the solo player makes when
+// everyone plays knowing all the hands. Hands are bitmasks of the cards, the
+// moves of each trick are ordered to try the likely best ones first, and the
+// bounds found at the start of each trick are kept in a transposition table,
+// keyed by the cards left and the leader.
+namespace open_spiel {
+namespace skat {
+
+// The rules of the game being played, as SkatState applies them.
+struct CardPlayRules {
+  bool null_game = false;
+  // The cards which follow suit when the card is led.
+  std::array<uint32_t, kNumCards> follows{};
+  // order[led][card] ranks the card in a trick led by led; the highest wins.
+  std::array<std::array<int8_t, kNumCards>, kNumCards> order{};
+  std::array<int8_t, kNumCards> points{};
+};
+
+class CardPlaySolver {
+ public:
+  explicit CardPlaySolver(const CardPlayRules& rules);
+
+  // Solves the play from the given position, with player to play after the
+  // cards of the current trick, and the hands holding all the cards still to
+  // be played. Returns the card points the solo player wins in the tricks
+  // left, or for a null game, 1 if the solo player wins no more tricks and
+  // 0 otherwise.
+  //
+  // With a window, the value is only exact within (alpha, beta): a value at
+  // most alpha is an upper bound, and one at least beta a lower bound.
+  //
+  // The transposition table is kept from one call to the next, so those must
+  // be on the same deal, with each card still to be played in the hand it
+  // was dealt to, e.g. for each way the solo player can discard.
+  int Solve(const std::array<uint32_t, kNumPlayers>& hands, Player solo_player,
+            Player player, const std::vector<int>& trick);
+  int Solve(const std::array<uint32_t, kNumPlayers>& hands, Player solo_player,
+            Player player, const std::vector<int>& trick, int alpha, int beta);
+
+ private:
+  struct Bounds {
+    int lower;
+    int upper;
+  };
+
+  int Search(Player player, int alpha, int beta);
+  int MaxValue() const { return rules_.null_game ? 1 : kMaxCardPoints; }
+  int TrickWinner() const;
+  // The legal cards of the player, in the order to try them.
+  int OrderedMoves(Player player, std::array<int, kNumTricks>* moves) const;
+
+  const CardPlayRules rules_;
+  // equivalent_[low * kNumCards + high] tells whether the two cards differ
+  // only in rank, low being the lower (or for a null game, also in points).
+  // They are then equivalent in a hand once none of the cards ranked between
+  // them, between_[low][high], is left to be played.
+  std::array<bool, kNumCards * kNumCards> equivalent_{};
+  std::array<std::array<uint32_t, kNumCards>, kNumCards> between_{};
+  std::array<uint32_t, kNumPlayers> hands_{};
+  Player solo_player_ = 0;
+  std::array<int, kNumPlayers> trick_{};
+  int trick_size_ = 0;
+  Player leader_ = 0;
+  // Keyed by the cards left and the player to lead.
+  absl::flat_hash_map<uint64_t, Bounds> table_;
+};
+
+// An MCTS evaluator for skat, returning the solved returns of the states (see
+// SkatState::SolvedReturns), which must be in the discarding or the play
+// phase. It reads the hidden cards, so is best used on states sampled with
+// ResampleFromInfostate. The prior is uniform.
+class SkatSolverEvaluator : public algorithms::Evaluator {
+ public:
+  // The states must be SkatStates.
+  std::vector<double> Evaluate(const State& state) override;
+  ActionsAndProbs Prior(const State& state) override;
+};
+
+}  // namespace skat
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_GAMES_SKAT_SKAT_SOLVER_H_
@@ -14,6 +14,13 @@
 
 #include "open_spiel/games/skat.h"
 
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "open_spiel/games/skat/skat_solver.h"
+#include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
 #include "open_spiel/tests/basic_tests.h"
 
@@ -26,6 +33,97 @@ namespace testing = open_spiel::testing;
 void BasicSkatTests() {
   testing::LoadGameTest("skat");
   testing::RandomSimTest(*LoadGame("skat"), 10);
+  testing::ResampleInfostateTest(*LoadGame("skat"), /*num_sims=*/10);
+}
+
+// The value of the state for the solo player, searching all the moves.
+double MinimaxValue(const State& state, Player solo_player) {
+  if (state.IsTerminal()) return state.Returns()[solo_player];
+  const bool maximizing = state.CurrentPlayer() == solo_player;
+  double best = maximizing ? -1 : 1;
+  for (Action action : state.LegalActions()) {
+    std::unique_ptr<State> child = state.Child(action);
+    const double value = MinimaxValue(*child, solo_player);
+    best = maximizing ? std::max(best, value) : std::min(best, value);
+  }
+  return best;
+}
+
+// Plays randomly until only a few tricks are left, then checks the solver
+// against a search through the State API, for each type of game.
+void SolverMatchesMinimaxTest() {
+  std::shared_ptr<const Game> game = LoadGame("skat");
+  std::mt19937 rng(7);
+  for (int game_type = kDiamondsTrump; game_type <= kNullGame; ++game_type) {
+    for (int deal = 0; deal < 5; ++deal) {
+      std::unique_ptr<State> state = game->NewInitialState();
+      while (state->IsChanceNode()) {
+        std::vector<Action> cards = state->LegalActions();
+        state->ApplyAction(cards[rng() % cards.size()]);
+      }
+      const Player solo_player = deal % kNumPlayers;
+      for (Player p = 0; p < solo_player; ++p) {
+        state->ApplyAction(kBiddingActionBase + kPass);
+      }
+      state->ApplyAction(kBiddingActionBase + game_type);
+      while (!state->IsTerminal() && state->History().size() < 60) {
+        std::vector<Action> actions = state->LegalActions();
+        state->ApplyAction(actions[rng() % actions.size()]);
+      }
+      if (state->IsTerminal()) continue;
+      const auto& skat_state = static_cast<const SkatState&>(*state);
+      SPIEL_CHECK_EQ(skat_state.SolvedReturns()[solo_player],
+                     MinimaxValue(*state, solo_player));
+    }
+  }
+}
+
+void SolverEvaluatorTest() {
+  std::shared_ptr<const Game> game = LoadGame("skat");
+  std::mt19937 rng(3);
+  std::unique_ptr<State> state = game->NewInitialState();
+  while (state->IsChanceNode()) {
+    std::vector<Action> cards = state->LegalActions();
+    state->ApplyAction(cards[rng() % cards.size()]);
+  }
+  state->ApplyAction(kBiddingActionBase + kGrand);
+  SkatSolverEvaluator evaluator;
+  // The solo player can do no better than their best discard.
+  const double before_discards = evaluator.Evaluate(*state)[0];
+  state->ApplyAction(state->LegalActions()[0]);
+  state->ApplyAction(state->LegalActions()[0]);
+  SPIEL_CHECK_GE(before_discards, evaluator.Evaluate(*state)[0]);
+  // In the play, the solo player takes the best card, and the others the
+  // worst for them.
+  while (!state->IsTerminal()) {
+    const bool solo = state->CurrentPlayer() == 0;
+    double best = solo ? -1 : 1;
+    for (Action action : state->LegalActions()) {
+      const double value = evaluator.Evaluate(*state->Child(action))[0];
+      best = solo ? std::max(best, value) : std::min(best, value);
+    }
+    SPIEL_CHECK_EQ(evaluator.Evaluate(*state)[0], best);
+    state->ApplyAction(state->LegalActions()[0]);
+  }
+}
+
+void SolverResultTest() {
+  std::shared_ptr<const Game> game =
+      LoadGame("skat", {{"use_solver_result", GameParameter(true)}});
+  testing::RandomSimTest(*game, 3);
+  std::mt19937 rng(5);
+  std::unique_ptr<State> state = game->NewInitialState();
+  while (state->IsChanceNode()) {
+    std::vector<Action> cards = state->LegalActions();
+    state->ApplyAction(cards[rng() % cards.size()]);
+  }
+  state->ApplyAction(kBiddingActionBase + kClubsTrump);
+  state->ApplyAction(state->LegalActions()[0]);
+  const std::vector<double> solved =
+      static_cast<const SkatState&>(*state).SolvedReturns();
+  state->ApplyAction(state->LegalActions()[0]);
+  SPIEL_CHECK_TRUE(state->IsTerminal());
+  SPIEL_CHECK_LE(state->Returns()[0], solved[0]);
 }
 
 }  // namespace
@@ -34,4 +132,7 @@ void BasicSkatTests() {
 
 int main(int argc, char **argv) {
   open_spiel::skat::BasicSkatTests();
+  open_spiel::skat::SolverMatchesMinimaxTest();
+  open_spiel::skat::SolverEvaluatorTest();
+  open_spiel::skat::SolverResultTest();
 }
@@ -20,7 +20,7 @@
 #include <vector>
 
 #include "open_spiel/spiel_utils.h"
-#include "open_spiel/utils/tensor_view.h"
+#include "open_spiel/utils/plane_encoding.h"
 
 namespace open_spiel {
 namespace tic_tac_toe {
@@ -41,8 +41,9 @@ const GameType kGameType{
     /*provides_information_state_tensor=*/false,
     /*provides_observation_string=*/true,
     /*provides_observation_tensor=*/true,
-    /*parameter_specification=*/{}  // no parameters
-};
+    /*parameter_specification=*/{},  // no parameters
+    /*default_loadable=*/true,
+    /*hash_determines_observation=*/true};
 
 std::shared_ptr<const Game> Factory(const GameParameters& params) {
   return std::shared_ptr<const Game>(new TicTacToeGame(params));
@@ -50,6 +51,12 @@ std::shared_ptr<const Game> Factory(const GameParameters& params) {
 
 REGISTER_SPIEL_GAME(kGameType, Factory);
 
+// Zobrist key of a piece on a cell; empty cells do not contribute to the hash.
+uint64_t CellKey(int cell, CellState state) {
+  if (state == CellState::kEmpty) return 0;
+  return MixBits(cell * kCellStates + static_cast<int>(state));
+}
+
 }  // namespace
 
 CellState PlayerToState(Player player) {
@@ -80,6 +87,7 @@ std::string StateToString(CellState state) {
 void TicTacToeState::DoApplyAction(Action move) {
   SPIEL_CHECK_EQ(board_[move], CellState::kEmpty);
   board_[move] = PlayerToState(CurrentPlayer());
+  hash_ ^= CellKey(move, board_[move]);
   if (HasLine(current_player_)) {
     outcome_ = current_player_;
   }
@@ -88,15 +96,20 @@ void TicTacToeState::DoApplyAction(Action move) {
 }
 
 std::vector<Action> TicTacToeState::LegalActions() const {
-  if (IsTerminal()) return {};
-  // Can move in any empty cell.
   std::vector<Action> moves;
+  LegalActions(&moves);
+  return moves;
+}
+
+void TicTacToeState::LegalActions(std::vector<Action>* moves) const {
+  moves->clear();
+  if (IsTerminal()) return;
+  // Can move in any empty cell.
   for (int cell = 0; cell < kNumCells; ++cell) {
     if (board_[cell] == CellState::kEmpty) {
-      moves.push_back(cell);
+      moves->push_back(cell);
     }
   }
-  return moves;
 }
 
 std::string TicTacToeState::ActionToString(Player player,
@@ -162,30 +175,54 @@ std::string TicTacToeState::ObservationString(Player player) const {
   return ToString();
 }
 
-void TicTacToeState::ObservationTensor(Player player,
-                                       std::vector<double>* values) const {
+template <typename T>
+void TicTacToeState::WriteObservationTensor(Player player,
+                                            absl::Span<T> values) const {
   SPIEL_CHECK_GE(player, 0);
   SPIEL_CHECK_LT(player, num_players_);
 
-  // Treat `values` as a 2-d tensor.
-  TensorView<2> view(values, {kCellStates, kNumCells}, true);
-  for (int cell = 0; cell < kNumCells; ++cell) {
-    view[{static_cast<int>(board_[cell]), cell}] = 1.0;
-  }
+  // A plane per cell state.
+  OneHotPlanes(absl::MakeConstSpan(board_), kCellStates, values);
+}
+
+void TicTacToeState::ObservationTensor(Player player,
+                                       std::vector<double>* values) const {
+  values->resize(kCellStates * kNumCells);
+  WriteObservationTensor(player, absl::MakeSpan(*values));
+}
+
+void TicTacToeState::ObservationTensor(Player player,
+                                       absl::Span<float> values) const {
+  WriteObservationTensor(player, values);
+}
+
+void TicTacToeState::ObservationTensor(Player player,
+                                       absl::Span<uint8_t> values) const {
+  WriteObservationTensor(player, values);
 }
 
 void TicTacToeState::UndoAction(Player player, Action move) {
+  hash_ ^= CellKey(move, board_[move]);
   board_[move] = CellState::kEmpty;
   current_player_ = player;
   outcome_ = kInvalidPlayer;
   num_moves_ -= 1;
-  history_.pop_back();
+  PopHistory();
+}
+
+int64_t TicTacToeState::ApproximateMemoryUsage() const {
+  return sizeof(*this) + HistoryMemoryUsage();
 }
 
 std::unique_ptr<State> TicTacToeState::Clone() const {
   return std::unique_ptr<State>(new TicTacToeState(*this));
 }
 
+bool TicTacToeState::CopyFrom(const State& other) {
+  *this = static_cast<const TicTacToeState&>(other);
+  return true;
+}
+
 TicTacToeGame::TicTacToeGame(const GameParameters& params)
     : Game(kGameType, params) {}
 
@@ -21,6 +21,7 @@
 #include <string>
 #include <vector>
 
+#include "open_spiel/abseil-cpp/absl/types/span.h"
 #include "open_spiel/spiel.h"
 
 // Simple game of Noughts and Crosses:
@@ -67,9 +68,18 @@ class TicTacToeState : public State {
   std::string ObservationString(Player player) const override;
   void ObservationTensor(Player player,
                          std::vector<double>* values) const override;
+  void ObservationTensor(Player player,
+                         absl::Span<float> values) const override;
+  void ObservationTensor(Player player,
+                         absl::Span<uint8_t> values) const override;
   std::unique_ptr<State> Clone() const override;
+  bool CopyFrom(const State& other) override;
+  int64_t ApproximateMemoryUsage() const override;
+  uint64_t HashValue() const override { return hash_; }
   void UndoAction(Player player, Action move) override;
+  bool SupportsUndoAction() const override { return true; }
   std::vector<Action> LegalActions() const override;
+  void LegalActions(std::vector<Action>* actions) const override;
   CellState BoardAt(int cell) const { return board_[cell]; }
   CellState BoardAt(int row, int column) const {
     return board_[row * kNumCols + column];
@@ -80,11 +90,15 @@ class TicTacToeState : public State {
   void DoApplyAction(Action move) override;
 
  private:
+  // Shared implementation of the ObservationTensor overloads.
+  template <typename T>
+  void WriteObservationTensor(Player player, absl::Span<T> values) const;
   bool HasLine(Player player) const;  // Does this player have a line?
   bool IsFull() const;                // Is the board full?
   Player current_player_ = 0;         // Player zero goes first
   Player outcome_ = kInvalidPlayer;
   int num_moves_ = 0;
+  uint64_t hash_ = 0;  // Zobrist hash of the board.
 };
 
 // Game object.
@@ -27,10 +27,25 @@ void BasicTicTacToeTests() {
   testing::RandomSimTest(*LoadGame("tic_tac_toe"), 100);
 }
 
+// Different move orders reaching the same board share a hash.
+void TranspositionHashTest() {
+  std::shared_ptr<const Game> game = LoadGame("tic_tac_toe");
+  std::unique_ptr<State> state = game->NewInitialState();
+  std::unique_ptr<State> other = game->NewInitialState();
+  for (Action action : {0, 4, 8}) state->ApplyAction(action);
+  for (Action action : {8, 4, 0}) other->ApplyAction(action);
+  SPIEL_CHECK_EQ(state->HashValue(), other->HashValue());
+
+  other->UndoAction(0, 0);
+  other->ApplyAction(2);
+  SPIEL_CHECK_NE(state->HashValue(), other->HashValue());
+}
+
 }  // namespace
 }  // namespace tic_tac_toe
 }  // namespace open_spiel
 
 int main(int argc, char** argv) {
   open_spiel::tic_tac_toe::BasicTicTacToeTests();
+  open_spiel::tic_tac_toe::TranspositionHashTest();
 }
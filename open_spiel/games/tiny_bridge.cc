@@ -14,8 +14,14 @@
 
 #include "open_spiel/games/tiny_bridge.h"
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
-#include "open_spiel/algorithms/minimax.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
 
@@ -38,8 +44,22 @@ std::string RelativeSeatString(Seat player, Seat observer) {
   return std::string(relative_player[RelativeSeatIndex(player, observer)]);
 }
 
-int Suit(int card) { return card / kNumRanks; }
-int Rank(int card) { return card % kNumRanks; }
+constexpr int Suit(int card) { return card / kNumRanks; }
+constexpr int Rank(int card) { return card % kNumRanks; }
+
+// The position from the leader of the winning card of a trick, given the
+// cards in the order they were played.
+int WinningPosition(const std::array<int, kNumSeats>& cards, int trumps) {
+  int winner = 0;
+  for (int i = 1; i < kNumSeats; ++i) {
+    if (Suit(cards[i]) == Suit(cards[winner])) {
+      if (Rank(cards[i]) > Rank(cards[winner])) winner = i;
+    } else if (Suit(cards[i]) == trumps) {
+      winner = i;
+    }
+  }
+  return winner;
+}
 
 int CharToRank(char c) {
   switch (c) {
@@ -90,6 +110,21 @@ std::string CardString(int card) {
                       std::string(1, kRankChar[Rank(card)]));
 }
 
+// The cards of each hand, indexed by chance outcome, the higher card first.
+// The outcomes enumerate the hands in the colexicographic order of their
+// cards, so that the hand (card0, card1) is outcome card0 * (card0 - 1) / 2 +
+// card1.
+constexpr std::array<std::array<int, 2>, kNumPrivates> kHandCards = [] {
+  std::array<std::array<int, 2>, kNumPrivates> hand_cards{};
+  int outcome = 0;
+  for (int card0 = 1; card0 < kDeckSize; ++card0) {
+    for (int card1 = 0; card1 < card0; ++card1) {
+      hand_cards[outcome++] = {card0, card1};
+    }
+  }
+  return hand_cards;
+}();
+
 // Requires card0 > card1
 int CardsToChanceOutcome(int card0, int card1) {
   return (card0 * (card0 - 1)) / 2 + card1;
@@ -97,11 +132,22 @@ int CardsToChanceOutcome(int card0, int card1) {
 
 // Returns first > second
 std::pair<int, int> ChanceOutcomeToCards(int outcome) {
-  int card0 = 1;
-  while (CardsToChanceOutcome(card0 + 1, 0) <= outcome) ++card0;
-  return {card0, outcome - CardsToChanceOutcome(card0, 0)};
+  return {kHandCards[outcome][0], kHandCards[outcome][1]};
 }
 
+// The string of each hand, e.g. "SAHJ", indexed by chance outcome.
+constexpr std::array<std::array<char, 4>, kNumPrivates> kHandStrings = [] {
+  std::array<std::array<char, 4>, kNumPrivates> hand_strings{};
+  for (int outcome = 0; outcome < kNumPrivates; ++outcome) {
+    for (int i = 0; i < 2; ++i) {
+      const int card = kHandCards[outcome][i];
+      hand_strings[outcome][2 * i] = kSuitChar[Suit(card)];
+      hand_strings[outcome][2 * i + 1] = kRankChar[Rank(card)];
+    }
+  }
+  return hand_strings;
+}();
+
 // Hand abstraction. Each line is a bucket of hands that are
 // indistinguishable.
 inline constexpr const char* kAbstraction[kNumAbstractHands] = {
@@ -122,29 +168,42 @@ inline constexpr const char* kAbstraction[kNumAbstractHands] = {
     "SQSJ",
 };
 
-// Computes the abstraction lookup.
-std::vector<int> ConcreteToAbstract() {
-  std::vector<int> concrete_to_abstract(kNumPrivates, -1);
-  for (int c = 0; c < kNumPrivates; ++c) {
-    auto hand = HandString(c);
+constexpr bool BucketContains(const char* bucket,
+                              const std::array<char, 4>& hand) {
+  for (; *bucket != '\0'; ++bucket) {
+    int i = 0;
+    while (i < 4 && bucket[i] == hand[i]) ++i;
+    if (i == 4) return true;
+  }
+  return false;
+}
+
+// The abstraction of each hand, indexed by chance outcome.
+constexpr std::array<int, kNumPrivates> kHandAbstraction = [] {
+  std::array<int, kNumPrivates> hand_abstraction{};
+  for (int outcome = 0; outcome < kNumPrivates; ++outcome) {
+    hand_abstraction[outcome] = -1;
     for (int ah = 0; ah < kNumAbstractHands; ++ah) {
-      if (absl::StrContains(kAbstraction[ah], hand)) {
-        concrete_to_abstract[c] = ah;
+      if (BucketContains(kAbstraction[ah], kHandStrings[outcome])) {
+        hand_abstraction[outcome] = ah;
         break;
       }
     }
-    if (concrete_to_abstract[c] == -1) {
-      SpielFatalError(
-          absl::StrCat("Abstraction not found for concrete hand '", hand, "'"));
-    }
   }
-  return concrete_to_abstract;
+  return hand_abstraction;
+}();
+
+constexpr bool AllHandsAbstracted() {
+  for (int abstraction : kHandAbstraction) {
+    if (abstraction == -1) return false;
+  }
+  return true;
 }
+static_assert(AllHandsAbstracted(), "Abstraction not found for a hand");
 
 // Returns an abstraction.
 int ChanceOutcomeToHandAbstraction(int outcome) {
-  static std::vector<int> concrete_to_abstract = ConcreteToAbstract();
-  return concrete_to_abstract[outcome];
+  return kHandAbstraction[outcome];
 }
 
 // Abstract hand string.
@@ -249,11 +308,86 @@ int Score(int contract, int tricks, bool doubled, bool redoubled, int trumps) {
   return score * double_factor;
 }
 
+// The most tricks the side of `side` can take in the play phase, with both
+// sides playing the cards open, as the value of TinyBridgePlayGame. Only the
+// cards of the first trick are chosen, and each hand has at most two choices,
+// so this searches at most 16 lines of play.
+int SideTricks(const std::array<std::array<int, 2>, kNumSeats>& hands,
+               int trumps, Seat leader, int side,
+               std::array<int, kNumSeats>* first_trick, int num_played) {
+  if (num_played == kNumSeats) {
+    const int winner0 =
+        (leader + WinningPosition(*first_trick, trumps)) % kNumSeats;
+    std::array<int, kNumSeats> second_trick;
+    for (int i = 0; i < kNumSeats; ++i) {
+      const int seat = (winner0 + i) % kNumSeats;
+      const int position = (kNumSeats + seat - leader) % kNumSeats;
+      const auto& hand = hands[seat];
+      second_trick[i] =
+          hand[0] == (*first_trick)[position] ? hand[1] : hand[0];
+    }
+    const int winner1 =
+        (winner0 + WinningPosition(second_trick, trumps)) % kNumSeats;
+    return (winner0 % 2 == side) + (winner1 % 2 == side);
+  }
+  const int seat = (leader + num_played) % kNumSeats;
+  const auto& hand = hands[seat];
+  const bool maximize = seat % 2 == side;
+  int best = maximize ? -1 : kNumTricks + 1;
+  for (int card : hand) {
+    // Have to follow suit if we have two cards of different suits.
+    if (num_played > 0 && Suit(hand[0]) != Suit(hand[1]) &&
+        Suit(card) != Suit((*first_trick)[0])) {
+      continue;
+    }
+    (*first_trick)[num_played] = card;
+    const int tricks =
+        SideTricks(hands, trumps, leader, side, first_trick, num_played + 1);
+    best = maximize ? std::max(best, tricks) : std::min(best, tricks);
+  }
+  return best;
+}
+
+// The deals as keys of 2 * kDeckSize bits, the holder of each card.
+int DealKey(const std::array<Seat, kDeckSize>& holder) {
+  int key = 0;
+  for (int card = 0; card < kDeckSize; ++card) {
+    key |= holder[card] << (2 * card);
+  }
+  return key;
+}
+
+// The tricks taken by the declaring side of each deal, with each trump suit
+// (or notrumps) and leader, by DealKey and then 2 bits per trumps and leader.
+std::vector<uint32_t> MakeDeclarerTricks() {
+  std::vector<uint32_t> declarer_tricks(1 << (2 * kDeckSize), 0);
+  for (int key = 0; key < declarer_tricks.size(); ++key) {
+    std::array<std::array<int, 2>, kNumSeats> hands;
+    std::array<int, kNumSeats> num_cards{};
+    bool is_deal = true;
+    for (int card = 0; card < kDeckSize && is_deal; ++card) {
+      const int seat = (key >> (2 * card)) & 3;
+      is_deal = num_cards[seat] < kNumTricks;
+      if (is_deal) hands[seat][num_cards[seat]++] = card;
+    }
+    if (!is_deal) continue;
+    for (int trumps = 0; trumps <= kNumSuits; ++trumps) {
+      for (int leader = 0; leader < kNumSeats; ++leader) {
+        std::array<int, kNumSeats> first_trick;
+        const int tricks =
+            SideTricks(hands, trumps, Seat(leader), (leader + 1) % 2,
+                       &first_trick, /*num_played=*/0);
+        declarer_tricks[key] |= tricks << (2 * (trumps * kNumSeats + leader));
+      }
+    }
+  }
+  return declarer_tricks;
+}
+
 }  // namespace
 
 std::string HandString(Action outcome) {
-  auto cards = ChanceOutcomeToCards(outcome);
-  return absl::StrCat(CardString(cards.first), CardString(cards.second));
+  return std::string(kHandStrings[outcome].data(), 4);
 }
 
 std::string SeatString(Seat seat) { return std::string(1, kSeatChar[seat]); }
@@ -345,15 +479,12 @@ TinyBridgeAuctionState::AuctionState TinyBridgeAuctionState::AnalyzeAuction()
 int Score_p0(std::array<Seat, kDeckSize> holder,
              const TinyBridgeAuctionState::AuctionState& state) {
   if (state.last_bid == Call::kPass) return 0;
-  std::shared_ptr<Game> game(new TinyBridgePlayGame({}));
+  static const std::vector<uint32_t> declarer_tricks = MakeDeclarerTricks();
   int trumps = (state.last_bid - 1) % 3;
   Seat leader = Seat((state.last_bidder + 3) % 4);
   Seat decl = Seat(state.last_bidder % 2);
-  TinyBridgePlayState play{game, trumps, leader, holder};
-  const double tricks =
-      algorithms::AlphaBetaSearch(*game, &play, nullptr, -1, decl).first;
-  SPIEL_CHECK_GE(tricks, 0);
-  SPIEL_CHECK_LE(tricks, kNumTricks);
+  const int tricks = (declarer_tricks[DealKey(holder)] >>
+                      (2 * (trumps * kNumSeats + leader))) & 3;
   const int declarer_score =
       Score(state.last_bid, tricks, state.doubler != kInvalidSeat,
             state.redoubler != kInvalidSeat, trumps);
@@ -517,7 +648,7 @@ std::string TinyBridgeAuctionState::AuctionString() const {
   std::string auction{};
   for (int i = num_players_; i < actions_.size(); ++i) {
     if (!auction.empty()) auction.push_back('-');
-    auction.append(ActionToString(i % num_players_, actions_[i]));
+    auction.append(kActionStr[actions_[i]]);
   }
   return auction;
 }
@@ -560,6 +691,26 @@ std::string TinyBridgeAuctionState::InformationStateString(
     return hand;
 }
 
+// The hand (or its abstraction) and then the calls, a byte each.
+std::string TinyBridgeAuctionState::InformationStateKey(Player player) const {
+  SPIEL_CHECK_GE(player, 0);
+  SPIEL_CHECK_LT(player, num_players_);
+
+  std::string key;
+  if (!IsDealt(player)) {
+    key.push_back(static_cast<char>(kNumPrivates));
+  } else if (is_abstracted_) {
+    key.push_back(
+        static_cast<char>(ChanceOutcomeToHandAbstraction(actions_[player])));
+  } else {
+    key.push_back(static_cast<char>(actions_[player]));
+  }
+  for (int i = num_players_; i < actions_.size(); ++i) {
+    key.push_back(static_cast<char>(actions_[i]));
+  }
+  return key;
+}
+
 // Observation string is the player's cards plus the most recent bid,
 // plus any doubles or redoubles. E.g. "HJSA 2NT:Us Dbl:RH RDbl:Pd"
 // This is an observation for a player who holds HJ and SA.
@@ -710,28 +861,18 @@ std::unique_ptr<State> TinyBridgeAuctionState::Clone() const {
 
 void TinyBridgeAuctionState::UndoAction(Player player, Action action) {
   actions_.pop_back();
+  PopHistory();
   is_terminal_ = false;
 }
 
 void TinyBridgePlayState::DoApplyAction(Action action) {
   actions_.emplace_back(CurrentHand(), action);
   if (actions_.size() % 4 == 0) {
-    Seat win_hand = actions_[actions_.size() - 4].first;
-    int win_card = actions_[actions_.size() - 4].second;
-    for (int i = actions_.size() - 3; i < actions_.size(); ++i) {
-      Seat hand = actions_[i].first;
-      int card = actions_[i].second;
-      if (Suit(card) == Suit(win_card)) {
-        if (Rank(card) > Rank(win_card)) {
-          win_card = card;
-          win_hand = hand;
-        }
-      } else if (Suit(card) == trumps_) {
-        win_card = card;
-        win_hand = hand;
-      }
-    }
-    winner_[actions_.size() / 4 - 1] = win_hand;
+    const int first = actions_.size() - 4;
+    std::array<int, kNumSeats> cards;
+    for (int i = 0; i < kNumSeats; ++i) cards[i] = actions_[first + i].second;
+    winner_[actions_.size() / 4 - 1] =
+        actions_[first + WinningPosition(cards, trumps_)].first;
   }
 }
 
@@ -787,7 +928,7 @@ std::unique_ptr<State> TinyBridgePlayState::Clone() const {
 
 void TinyBridgePlayState::UndoAction(Player player, Action action) {
   actions_.pop_back();
-  history_.pop_back();
+  PopHistory();
 }
 
 std::string TinyBridgePlayState::ToString() const {
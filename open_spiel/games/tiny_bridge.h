@@ -34,9 +34,10 @@
 // perhaps also to bid a 'slam' contract which scores bonus points.
 //
 // The play phase is not very interesting with only two tricks being played.
-// For simplicity, we replace it with a perfect-information result, which is
-// computed using minimax on a two-player perfect-information game representing
-// the play phase.
+// For simplicity, we replace it with a perfect-information result: the value
+// of a two-player perfect-information game representing the play phase,
+// TinyBridgePlayGame. The values of all the deals are found by a small search
+// on first use, and kept in a table.
 //
 // The game comes in two varieties - the full four-player version, and a
 // simplified two-player version in which one partnership does not make
@@ -162,6 +163,7 @@ class TinyBridgeAuctionState : public State {
   bool IsTerminal() const override;
   std::vector<double> Returns() const override;
   std::string InformationStateString(Player player) const override;
+  std::string InformationStateKey(Player player) const override;
   void InformationStateTensor(Player player,
                               std::vector<double>* values) const override;
   std::string ObservationString(Player player) const override;
@@ -169,6 +171,7 @@ class TinyBridgeAuctionState : public State {
                          std::vector<double>* values) const override;
   std::unique_ptr<State> Clone() const override;
   void UndoAction(Player player, Action action) override;
+  bool SupportsUndoAction() const override { return true; }
   std::vector<std::pair<Action, double>> ChanceOutcomes() const override;
   std::string AuctionString() const;
   std::string PlayerHandString(Player player, bool abstracted) const;
@@ -210,6 +213,7 @@ class TinyBridgePlayState : public State {
   std::vector<double> Returns() const override;
   std::unique_ptr<State> Clone() const override;
   void UndoAction(Player player, Action action) override;
+  bool SupportsUndoAction() const override { return true; }
   std::string ToString() const override;
   std::vector<Action> LegalActions() const override;
 
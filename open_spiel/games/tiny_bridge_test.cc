@@ -15,6 +15,7 @@
 #include "open_spiel/games/tiny_bridge.h"
 
 #include "open_spiel/algorithms/get_all_states.h"
+#include "open_spiel/algorithms/minimax.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
 #include "open_spiel/tests/basic_tests.h"
@@ -54,6 +55,40 @@ void CountStates2p() {
   SPIEL_CHECK_EQ(states.size(), 107100);
 }
 
+// The scores of the two-level contracts, which tell the number of tricks
+// apart, agree with a search of the play phase for every deal.
+void ScoreMatchesPlayGame() {
+  std::shared_ptr<Game> game(new TinyBridgePlayGame({}));
+  int num_deals = 0;
+  for (int deal = 0; deal < (1 << (2 * kDeckSize)); ++deal) {
+    std::array<Seat, kDeckSize> holder;
+    std::array<int, kNumSeats> num_cards{};
+    for (int card = 0; card < kDeckSize; ++card) {
+      holder[card] = Seat((deal >> (2 * card)) & 3);
+      ++num_cards[holder[card]];
+    }
+    if (num_cards != std::array<int, kNumSeats>{2, 2, 2, 2}) continue;
+    ++num_deals;
+    for (int trumps = 0; trumps < 3; ++trumps) {
+      for (Seat declarer : {kWest, kNorth, kEast, kSouth}) {
+        const Seat leader = Seat((declarer + 3) % 4);
+        TinyBridgePlayState play{game, trumps, leader, holder};
+        const int tricks =
+            algorithms::AlphaBetaSearch(*game, &play, nullptr, -1,
+                                        declarer % 2)
+                .first;
+        const int score = tricks == 2   ? (trumps == 2 ? 35 : 30)
+                          : tricks == 1 ? -20
+                                        : -40;
+        SPIEL_CHECK_EQ(Score_p0(holder, {k2H + trumps, declarer, kInvalidSeat,
+                                         kInvalidSeat}),
+                       declarer % 2 == 0 ? score : -score);
+      }
+    }
+  }
+  SPIEL_CHECK_EQ(num_deals, 2520);
+}
+
 }  // namespace
 }  // namespace tiny_bridge
 }  // namespace open_spiel
@@ -62,4 +97,5 @@ int main(int argc, char** argv) {
   open_spiel::tiny_bridge::BasicTinyBridge2pTests();
   open_spiel::tiny_bridge::BasicTinyBridge4pTests();
   open_spiel::tiny_bridge::CountStates2p();
+  open_spiel::tiny_bridge::ScoreMatchesPlayGame();
 }
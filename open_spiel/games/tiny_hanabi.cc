@@ -18,6 +18,7 @@
 
 #include "open_spiel/abseil-cpp/absl/strings/numbers.h"
 #include "open_spiel/spiel.h"
+#include "open_spiel/utils/varint.h"
 
 namespace open_spiel {
 namespace tiny_hanabi {
@@ -163,6 +164,20 @@ std::string TinyHanabiState::InformationStateString(Player player) const {
   return rv;
 }
 
+// The player's chance outcome plus one (0 before the deal), then the actions,
+// as varints.
+std::string TinyHanabiState::InformationStateKey(Player player) const {
+  SPIEL_CHECK_GE(player, 0);
+  SPIEL_CHECK_LT(player, num_players_);
+
+  std::string key;
+  AppendVarint(history_.size() > player ? history_[player] + 1 : 0, &key);
+  for (int i = payoff_.NumPlayers(); i < history_.size(); ++i) {
+    AppendVarint(history_[i], &key);
+  }
+  return key;
+}
+
 void TinyHanabiState::InformationStateTensor(
     Player player, std::vector<double>* values) const {
   SPIEL_CHECK_GE(player, 0);
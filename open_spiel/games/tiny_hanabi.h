@@ -105,8 +105,9 @@ class TinyHanabiGame : public Game {
 class TinyHanabiState : public State {
  public:
   TinyHanabiState(const TinyHanabiState&) = default;
+  // The payoff matrix is the game's, which the state keeps alive.
   TinyHanabiState(std::shared_ptr<const Game> game,
-                  TinyHanabiPayoffMatrix payoff)
+                  const TinyHanabiPayoffMatrix& payoff)
       : State(game), payoff_(payoff) {}
 
   Player CurrentPlayer() const override;
@@ -118,6 +119,7 @@ class TinyHanabiState : public State {
   std::unique_ptr<State> Clone() const override;
   std::vector<Action> LegalActions() const override;
   std::string InformationStateString(Player player) const override;
+  std::string InformationStateKey(Player player) const override;
   void InformationStateTensor(Player player,
                               std::vector<double>* values) const override;
   std::string ObservationString(Player player) const override;
@@ -126,7 +128,7 @@ class TinyHanabiState : public State {
 
  private:
   void DoApplyAction(Action action) override;
-  TinyHanabiPayoffMatrix payoff_;
+  const TinyHanabiPayoffMatrix& payoff_;
 };
 
 }  // namespace tiny_hanabi
@@ -27,6 +27,7 @@
 #include "open_spiel/games/universal_poker/logic/card_set.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/varint.h"
 
 namespace open_spiel {
 namespace universal_poker {
@@ -101,7 +102,14 @@ const GameType kGameType{
      // nolimit games. Available options are: "fc" for fold and check/call.
      // "fcpa" for fold, check/call, bet pot and all in (default).
      // Use "fullgame" for the unabstracted game.
-     {"bettingAbstraction", GameParameter(std::string("fcpa"))}}};
+     {"bettingAbstraction", GameParameter(std::string("fcpa"))},
+     // Lossless suit isomorphism: the deals which only differ by a relabelling
+     // of the suits are dealt once, with their total probability, and the
+     // information states see the cards with canonical suits. This shrinks
+     // the tree and the number of information states by up to 24 times with
+     // 4 suits, without changing the value of the game. It may also be given
+     // with a gamedef.
+     {"suitIsomorphism", GameParameter(false)}}};
 
 std::shared_ptr<const Game> Factory(const GameParameters &params) {
   return std::shared_ptr<const Game>(new UniversalPokerGame(params));
@@ -126,14 +134,54 @@ UniversalPokerState::UniversalPokerState(std::shared_ptr<const Game> game,
       starting_stack_big_blinds_(starting_stack_big_blinds),
       acpc_game_(
           static_cast<const UniversalPokerGame *>(game.get())->GetACPCGame()),
-      acpc_state_(acpc_game_),
+      betting_tree_(static_cast<const UniversalPokerGame *>(game.get())
+                        ->betting_tree()
+                        .get()),
+      betting_node_(betting_tree_->Root()),
       deck_(/*num_suits=*/acpc_game_->NumSuitsDeck(),
             /*num_ranks=*/acpc_game_->NumRanksDeck()),
-      hole_cards_(acpc_game_->GetNbPlayers()),
       cur_player_(kChancePlayerId),
-      possibleActions_(ACTION_DEAL),
       betting_abstraction_(static_cast<const UniversalPokerGame *>(game.get())
-                               ->betting_abstraction()) {}
+                               ->betting_abstraction()),
+      suit_isomorphism_(static_cast<const UniversalPokerGame *>(game.get())
+                            ->suit_isomorphism()) {}
+
+const acpc_cpp::ACPCState &UniversalPokerState::acpc_state() const {
+  return betting_node_->acpc_state;
+}
+
+acpc_cpp::ACPCState UniversalPokerState::AcpcStateWithCards() const {
+  // Copy Board Cards and Hole Cards
+  uint8_t holeCards[10][3], boardCards[7], nbHoleCards[10];
+
+  for (int p = 0; p < acpc_game_->GetNbPlayers(); ++p) {
+    auto cards = hole_cards_[p].ToCardArray();
+    for (size_t c = 0; c < cards.size(); ++c) {
+      holeCards[p][c] = cards[c];
+    }
+    nbHoleCards[p] = cards.size();
+  }
+
+  auto bc = board_cards_.ToCardArray();
+  for (size_t c = 0; c < bc.size(); ++c) {
+    boardCards[c] = bc[c];
+  }
+
+  acpc_cpp::ACPCState acpc_state = betting_node_->acpc_state;
+  acpc_state.SetHoleAndBoardCards(holeCards, boardCards, nbHoleCards,
+                                  /*nbBoardCards=*/bc.size());
+  return acpc_state;
+}
+
+std::pair<logic::CardSet, logic::CardSet> UniversalPokerState::VisibleCards(
+    Player player) const {
+  if (!suit_isomorphism_) return {hole_cards_[player], board_cards_};
+  const std::array<int, logic::kMaxSuits> permutation =
+      logic::CanonicalSuitPermutation({hole_cards_[player], board_cards_},
+                                      acpc_game_->NumSuitsDeck());
+  return {hole_cards_[player].PermuteSuits(permutation),
+          board_cards_.PermuteSuits(permutation)};
+}
 
 std::string UniversalPokerState::ToString() const {
   std::ostringstream buf;
@@ -165,7 +213,7 @@ std::string UniversalPokerState::ToString() const {
       betting_abstraction_ == BettingAbstraction::kFCPA) {
     buf << "PossibleActions (" << GetPossibleActionCount() << "): [";
     for (auto action : ALL_ACTIONS) {
-      if (action & possibleActions_) {
+      if (action & GetPossibleActionsMask()) {
         buf << ((action == ACTION_ALL_IN) ? " ACTION_ALL_IN " : "");
         buf << ((action == ACTION_BET) ? " ACTION_BET " : "");
         buf << ((action == ACTION_CHECK_CALL) ? " ACTION_CHECK_CALL " : "");
@@ -175,13 +223,39 @@ std::string UniversalPokerState::ToString() const {
     }
   }
   buf << "]" << std::endl;
-  buf << "Round: " << acpc_state_.GetRound() << std::endl;
-  buf << "ACPC State: " << acpc_state_.ToString() << std::endl;
-  buf << "Action Sequence: " << actionSequence_ << std::endl;
+  buf << "Round: " << betting_node_->round << std::endl;
+  // The cards are only given to the ACPC state at the showdown.
+  buf << "ACPC State: "
+      << (IsTerminal() ? AcpcStateWithCards().ToString()
+                       : acpc_state().ToString())
+      << std::endl;
+  buf << "Action Sequence: " << GetActionSequence() << std::endl;
 
   return buf.str();
 }
 
+// Replays the history: as in _CalculateActionsAndNodeType, cards are dealt
+// until the players have theirs and the board has those of the round.
+std::string UniversalPokerState::GetActionSequence() const {
+  const int num_hole_cards =
+      acpc_game_->GetNbPlayers() * acpc_game_->GetNbHoleCardsRequired();
+  std::string sequence;
+  sequence.reserve(history_.size());
+  const BettingTreeNode *node = betting_tree_->Root();
+  int num_dealt = 0;
+  for (Action action : history_) {
+    if (num_dealt <
+        num_hole_cards + acpc_game_->GetNbBoardCardsRequired(node->round)) {
+      sequence += 'd';
+      ++num_dealt;
+    } else {
+      node = betting_tree_->Child(node, action);
+      sequence += node->action_char;
+    }
+  }
+  return sequence;
+}
+
 std::string UniversalPokerState::ActionToString(Player player,
                                                 Action move) const {
   return absl::StrCat("player=", player, " move=", move);
@@ -189,7 +263,7 @@ std::string UniversalPokerState::ActionToString(Player player,
 
 bool UniversalPokerState::IsTerminal() const {
   bool finished = cur_player_ == kTerminalPlayerId;
-  assert(acpc_state_.IsFinished() || !finished);
+  assert(betting_node_->finished || !finished);
   return finished;
 }
 
@@ -205,7 +279,7 @@ Player UniversalPokerState::CurrentPlayer() const {
     return kChancePlayerId;
   }
 
-  return Player(acpc_state_.CurrentPlayer());
+  return betting_node_->player;
 }
 
 std::vector<double> UniversalPokerState::Returns() const {
@@ -245,7 +319,7 @@ void UniversalPokerState::InformationStateTensor(
   const logic::CardSet full_deck(acpc_game_->NumSuitsDeck(),
                                  acpc_game_->NumRanksDeck());
   const std::vector<uint8_t> deckCards = full_deck.ToCardArray();
-  logic::CardSet holeCards = hole_cards_[player];
+  const auto [holeCards, boardCards] = VisibleCards(player);
   // TODO(author2): it should be way more efficient to iterate over the cards
   // of the player, rather than iterating over all the cards.
   for (uint32_t i = 0; i < full_deck.NumCards(); i++) {
@@ -255,8 +329,7 @@ void UniversalPokerState::InformationStateTensor(
 
   // Public cards
   for (int i = 0; i < full_deck.NumCards(); ++i) {
-    (*values)[i + offset] =
-        board_cards_.ContainsCards(deckCards[i]) ? 1.0 : 0.0;
+    (*values)[i + offset] = boardCards.ContainsCards(deckCards[i]) ? 1.0 : 0.0;
   }
   offset += full_deck.NumCards();
 
@@ -296,6 +369,45 @@ void UniversalPokerState::InformationStateTensor(
   SPIEL_CHECK_EQ(offset, game_->InformationStateTensorShape()[0]);
 }
 
+void UniversalPokerState::InformationStateTensor(Player player,
+                                                 SparseTensor *tensor) const {
+  SPIEL_CHECK_GE(player, 0);
+  SPIEL_CHECK_LT(player, num_players_);
+
+  // The same layout as the dense version above, of which only the player, the
+  // cards seen and the calls and raises are ones.
+  tensor->Reset(game_->InformationStateTensorShape()[0]);
+  int offset = 0;
+  tensor->Add(player);
+  offset += NumPlayers();
+
+  const logic::CardSet full_deck(acpc_game_->NumSuitsDeck(),
+                                 acpc_game_->NumRanksDeck());
+  const std::vector<uint8_t> deckCards = full_deck.ToCardArray();
+  const auto [holeCards, boardCards] = VisibleCards(player);
+  for (const logic::CardSet &cards : {holeCards, boardCards}) {
+    for (uint32_t i = 0; i < full_deck.NumCards(); i++) {
+      if (cards.ContainsCards(deckCards[i])) tensor->Add(offset + i);
+    }
+    offset += full_deck.NumCards();
+  }
+
+  const std::string actionSeq = GetActionSequence();
+  const int length = actionSeq.length();
+  SPIEL_CHECK_LT(length, game_->MaxGameLength());
+  for (int i = 0; i < length; ++i) {
+    // Calls are 10, raises 01 and all-ins 11.
+    if (actionSeq[i] == 'c' || actionSeq[i] == 'a') {
+      tensor->Add(offset + (2 * i));
+    }
+    if (actionSeq[i] == 'p' || actionSeq[i] == 'a') {
+      tensor->Add(offset + (2 * i) + 1);
+    }
+  }
+  offset += game_->MaxGameLength() * 2;
+  SPIEL_CHECK_EQ(offset, tensor->size);
+}
+
 void UniversalPokerState::ObservationTensor(Player player,
                                             std::vector<double> *values) const {
   SPIEL_CHECK_GE(player, 0);
@@ -319,7 +431,7 @@ void UniversalPokerState::ObservationTensor(Player player,
   const logic::CardSet full_deck(acpc_game_->NumSuitsDeck(),
                                  acpc_game_->NumRanksDeck());
   const std::vector<uint8_t> all_cards = full_deck.ToCardArray();
-  logic::CardSet holeCards = hole_cards_[player];
+  const auto [holeCards, boardCards] = VisibleCards(player);
 
   for (uint32_t i = 0; i < full_deck.NumCards(); i++) {
     (*values)[i + offset] = holeCards.ContainsCards(all_cards[i]) ? 1.0 : 0.0;
@@ -327,14 +439,13 @@ void UniversalPokerState::ObservationTensor(Player player,
   offset += full_deck.NumCards();
 
   for (uint32_t i = 0; i < full_deck.NumCards(); i++) {
-    (*values)[i + offset] =
-        board_cards_.ContainsCards(all_cards[i]) ? 1.0 : 0.0;
+    (*values)[i + offset] = boardCards.ContainsCards(all_cards[i]) ? 1.0 : 0.0;
   }
   offset += full_deck.NumCards();
 
   // Adding the contribution of each players to the pot.
   for (auto p = Player{0}; p < NumPlayers(); p++) {
-    (*values)[offset + p] = acpc_state_.Ante(p);
+    (*values)[offset + p] = acpc_state().Ante(p);
   }
   offset += NumPlayers();
   SPIEL_CHECK_EQ(offset, game_->ObservationTensorShape()[0]);
@@ -343,23 +454,28 @@ void UniversalPokerState::ObservationTensor(Player player,
 std::string UniversalPokerState::InformationStateString(Player player) const {
   SPIEL_CHECK_GE(player, 0);
   SPIEL_CHECK_LT(player, acpc_game_->GetNbPlayers());
-  const uint32_t pot = acpc_state_.MaxSpend() *
-                       (acpc_game_->GetNbPlayers() - acpc_state_.NumFolded());
-  std::vector<int> money;
-  for (auto p = Player{0}; p < acpc_game_->GetNbPlayers(); p++) {
-    money.emplace_back(acpc_state_.Money(p));
-  }
-  std::vector<std::string> sequences;
-  for (auto r = 0; r <= acpc_state_.GetRound(); r++) {
-    sequences.emplace_back(acpc_state_.BettingSequence(r));
-  }
+  const auto [hole_cards, board_cards] = VisibleCards(player);
 
   return absl::StrFormat(
       "[Round %i][Player: %i][Pot: %i][Money: %s][Private: %s][Public: "
       "%s][Sequences: %s]",
-      acpc_state_.GetRound(), CurrentPlayer(), pot, absl::StrJoin(money, " "),
-      hole_cards_[player].ToString(), board_cards_.ToString(),
-      absl::StrJoin(sequences, "|"));
+      betting_node_->round, CurrentPlayer(), betting_node_->pot,
+      betting_node_->money_string, hole_cards.ToString(),
+      board_cards.ToString(), betting_node_->betting_sequences_string);
+}
+
+// The pot and money follow from the betting sequences, so they are left out.
+std::string UniversalPokerState::InformationStateKey(Player player) const {
+  SPIEL_CHECK_GE(player, 0);
+  SPIEL_CHECK_LT(player, acpc_game_->GetNbPlayers());
+  std::string key;
+  AppendVarint(betting_node_->round, &key);
+  AppendSignedVarint(CurrentPlayer(), &key);
+  const auto [hole_cards, board_cards] = VisibleCards(player);
+  AppendVarint(hole_cards.cs.cards, &key);
+  AppendVarint(board_cards.cs.cards, &key);
+  key.append(betting_node_->betting_sequences_key);
+  return key;
 }
 
 std::string UniversalPokerState::ObservationString(Player player) const {
@@ -367,21 +483,21 @@ std::string UniversalPokerState::ObservationString(Player player) const {
   SPIEL_CHECK_LT(player, acpc_game_->GetNbPlayers());
   std::string result;
 
-  const uint32_t pot = acpc_state_.MaxSpend() *
-                       (acpc_game_->GetNbPlayers() - acpc_state_.NumFolded());
-  absl::StrAppend(&result, "[Round ", acpc_state_.GetRound(),
-                  "][Player: ", CurrentPlayer(), "][Pot: ", pot, "][Money:");
+  absl::StrAppend(&result, "[Round ", betting_node_->round,
+                  "][Player: ", CurrentPlayer(), "][Pot: ", betting_node_->pot,
+                  "][Money:");
   for (auto p = Player{0}; p < acpc_game_->GetNbPlayers(); p++) {
-    absl::StrAppend(&result, " ", acpc_state_.Money(p));
+    absl::StrAppend(&result, " ", acpc_state().Money(p));
   }
   // Add the player's private cards
   if (player != kChancePlayerId) {
-    absl::StrAppend(&result, "[Private: ", hole_cards_[player].ToString(), "]");
+    absl::StrAppend(&result, "[Private: ",
+                    VisibleCards(player).first.ToString(), "]");
   }
   // Adding the contribution of each players to the pot
   absl::StrAppend(&result, "[Ante:");
   for (auto p = Player{0}; p < num_players_; p++) {
-    absl::StrAppend(&result, " ", acpc_state_.Ante(p));
+    absl::StrAppend(&result, " ", acpc_state().Ante(p));
   }
   absl::StrAppend(&result, "]");
 
@@ -402,6 +518,22 @@ std::vector<std::pair<Action, double>> UniversalPokerState::ChanceOutcomes()
   // We need to convert std::vector<uint8_t> into std::vector<Action>.
   std::vector<std::pair<Action, double>> outcomes;
   outcomes.reserve(num_cards);
+  if (suit_isomorphism_) {
+    // Only one suit of each group of suits dealt alike so far is dealt, for
+    // all the group.
+    std::vector<logic::CardSet> dealt_cards(
+        hole_cards_.begin(), hole_cards_.begin() + acpc_game_->GetNbPlayers());
+    dealt_cards.push_back(board_cards_);
+    const std::array<int, logic::kMaxSuits> multiplicities =
+        logic::SuitMultiplicities(dealt_cards, acpc_game_->NumSuitsDeck());
+    for (const auto &card : available_cards) {
+      const int multiplicity = multiplicities[card % logic::kMaxSuits];
+      if (multiplicity > 0) {
+        outcomes.push_back({Action{card}, multiplicity * p});
+      }
+    }
+    return outcomes;
+  }
   for (const auto &card : available_cards) {
     outcomes.push_back({Action{card}, p});
   }
@@ -410,6 +542,7 @@ std::vector<std::pair<Action, double>> UniversalPokerState::ChanceOutcomes()
 
 std::vector<Action> UniversalPokerState::LegalActions() const {
   if (IsChanceNode()) {
+    if (suit_isomorphism_) return LegalChanceOutcomes();
     std::vector<uint8_t> available_cards = deck_.ToCardArray();
     std::vector<Action> actions;
     actions.reserve(available_cards.size());
@@ -419,35 +552,7 @@ std::vector<Action> UniversalPokerState::LegalActions() const {
     return actions;
   }
 
-  std::vector<Action> legal_actions;
-
-  if (betting_abstraction_ != BettingAbstraction::kFULLGAME) {
-    if (ACTION_FOLD & possibleActions_) legal_actions.push_back(kFold);
-    if (ACTION_CHECK_CALL & possibleActions_) legal_actions.push_back(kCall);
-    if (ACTION_BET & possibleActions_) legal_actions.push_back(kBet);
-    if (ACTION_ALL_IN & possibleActions_) legal_actions.push_back(kAllIn);
-    return legal_actions;
-  } else {
-    if (acpc_state_.IsValidAction(
-            acpc_cpp::ACPCState::ACPCActionType::ACPC_FOLD, 0)) {
-      legal_actions.push_back(kFold);
-    }
-    if (acpc_state_.IsValidAction(
-            acpc_cpp::ACPCState::ACPCActionType::ACPC_CALL, 0)) {
-      legal_actions.push_back(kCall);
-    }
-    int32_t min_bet_size = 0;
-    int32_t max_bet_size = 0;
-    bool valid_to_raise =
-        acpc_state_.RaiseIsValid(&min_bet_size, &max_bet_size);
-    if (valid_to_raise) {
-      assert(min_bet_size % big_blind_ == 0);
-      for (int i = min_bet_size; i <= max_bet_size; i += big_blind_) {
-        legal_actions.push_back(1 + i / big_blind_);
-      }
-    }
-  }
-  return legal_actions;
+  return betting_node_->legal_actions;
 }
 
 // We first deal the cards to each player, dealing all the cards to the first
@@ -458,7 +563,6 @@ void UniversalPokerState::DoApplyAction(Action action_id) {
     // In chance nodes, the action_id is exactly the card being dealt.
     uint8_t card = action_id;
     deck_.RemoveCard(card);
-    actionSequence_ += 'd';
 
     // Check where to add this card
     for (int p = 0; p < acpc_game_->GetNbPlayers(); ++p) {
@@ -470,68 +574,28 @@ void UniversalPokerState::DoApplyAction(Action action_id) {
     }
 
     if (board_cards_.NumCards() <
-        acpc_game_->GetNbBoardCardsRequired(acpc_state_.GetRound())) {
+        acpc_game_->GetNbBoardCardsRequired(betting_node_->round)) {
       board_cards_.AddCard(card);
       _CalculateActionsAndNodeType();
       return;
     }
   } else {
-    int action_int = static_cast<int>(action_id);
-    if (action_int == kFold) {
-      ApplyChoiceAction(ACTION_FOLD, 0);
-      return;
-    }
-    if (action_int == kCall) {
-      ApplyChoiceAction(ACTION_CHECK_CALL, 0);
-      return;
-    }
-    if (betting_abstraction_ != BettingAbstraction::kFULLGAME) {
-      if (action_int == kBet) {
-        ApplyChoiceAction(ACTION_BET, potSize_);
-        return;
-      }
-      if (action_int == kAllIn) {
-        ApplyChoiceAction(ACTION_ALL_IN, allInSize_);
-        return;
-      }
-    }
-    if (action_int >= 2 && action_int <= NumDistinctActions()) {
-      ApplyChoiceAction(ACTION_BET, (action_int - 1) * big_blind_);
-      return;
-    }
-    SpielFatalError(absl::StrFormat("Action not recognized: %i", action_id));
+    SPIEL_CHECK_GE(cur_player_, 0);
+    betting_node_ = betting_tree_->Child(betting_node_, action_id);
+    _CalculateActionsAndNodeType();
   }
 }
 
 double UniversalPokerState::GetTotalReward(Player player) const {
   SPIEL_CHECK_GE(player, 0);
   SPIEL_CHECK_LT(player, acpc_game_->GetNbPlayers());
-  // Copy Board Cards and Hole Cards
-  uint8_t holeCards[10][3], boardCards[7], nbHoleCards[10];
-
-  for (size_t p = 0; p < hole_cards_.size(); ++p) {
-    auto cards = hole_cards_[p].ToCardArray();
-    for (size_t c = 0; c < cards.size(); ++c) {
-      holeCards[p][c] = cards[c];
-    }
-    nbHoleCards[p] = cards.size();
-  }
-
-  auto bc = board_cards_.ToCardArray();
-  for (size_t c = 0; c < bc.size(); ++c) {
-    boardCards[c] = bc[c];
-  }
-
-  acpc_state_.SetHoleAndBoardCards(holeCards, boardCards, nbHoleCards,
-                                   /*nbBoardCards=*/bc.size());
-
-  return acpc_state_.ValueOfState(player);
+  return AcpcStateWithCards().ValueOfState(player);
 }
 
 std::unique_ptr<HistoryDistribution>
 UniversalPokerState::GetHistoriesConsistentWithInfostate(int player_id) const {
-  // This is only implemented for 2 players.
-  if (acpc_game_->GetNbPlayers() != 2) return {};
+  // This is only implemented for 2 players, without suit isomorphism.
+  if (acpc_game_->GetNbPlayers() != 2 || suit_isomorphism_) return {};
 
   logic::CardSet is_cards;
   const logic::CardSet &our_cards = hole_cards_[player_id];
@@ -566,6 +630,34 @@ UniversalPokerState::GetHistoriesConsistentWithInfostate(int player_id) const {
   return dist;
 }
 
+std::unique_ptr<State> UniversalPokerState::ResampleFromInfostate(
+    int player_id, std::function<double()> rng) const {
+  if (suit_isomorphism_) {
+    SpielFatalError(
+        "ResampleFromInfostate() is not implemented with suit isomorphism.");
+  }
+  // The others can't hold the cards the player has seen.
+  logic::CardSet seen = hole_cards_[player_id];
+  for (uint8_t card : board_cards_.ToCardArray()) seen.AddCard(card);
+
+  // The hole cards are dealt first, all of a player's before the next's.
+  const int num_hole_cards = acpc_game_->GetNbHoleCardsRequired();
+  const int num_dealt_to_players = acpc_game_->GetNbPlayers() * num_hole_cards;
+  std::unique_ptr<State> state = game_->NewInitialState();
+  int num_dealt = 0;
+  for (Action action : history_) {
+    if (state->IsChanceNode() && num_dealt < num_dealt_to_players &&
+        num_dealt / num_hole_cards != player_id) {
+      do {
+        action = SampleAction(state->ChanceOutcomes(), rng()).first;
+      } while (seen.ContainsCards(action));
+    }
+    if (state->IsChanceNode()) ++num_dealt;
+    state->ApplyAction(action);
+  }
+  return state;
+}
+
 /**
  * Universal Poker Game Constructor
  * @param params
@@ -573,7 +665,8 @@ UniversalPokerState::GetHistoriesConsistentWithInfostate(int player_id) const {
 UniversalPokerGame::UniversalPokerGame(const GameParameters &params)
     : Game(kGameType, params),
       gameDesc_(parseParameters(params)),
-      acpc_game_(gameDesc_) {
+      acpc_game_(gameDesc_),
+      suit_isomorphism_(ParameterValue<bool>("suitIsomorphism")) {
   max_game_length_ = MaxGameLength();
   SPIEL_CHECK_TRUE(max_game_length_.has_value());
   std::string betting_abstraction =
@@ -587,7 +680,8 @@ UniversalPokerGame::UniversalPokerGame(const GameParameters &params)
   } else {
     SpielFatalError(absl::StrFormat("bettingAbstraction: %s not supported.",
                                     betting_abstraction));
-  }
+  }  betting_tree_ = std::make_shared<BettingTree>(
+      acpc_game_, betting_abstraction_, big_blind_);
 }
 
 std::unique_ptr<State> UniversalPokerGame::NewInitialState() const {
@@ -693,7 +787,7 @@ int UniversalPokerGame::MaxGameLength() const {
 std::string UniversalPokerGame::parseParameters(const GameParameters &map) {
   if (map.find("gamedef") != map.end()) {
     // We check for sanity that all parameters are empty
-    if (map.size() != 1) {
+    if (map.size() != 1 + map.count("suitIsomorphism")) {
       std::vector<std::string> game_parameter_keys;
       game_parameter_keys.reserve(map.size());
       for (auto const &imap : map) {
@@ -755,123 +849,190 @@ std::string UniversalPokerGame::parseParameters(const GameParameters &map) {
   return generated_gamedef;
 }
 
-const char *actions = "0df0c000p0000000a";
-
-void UniversalPokerState::ApplyChoiceAction(ActionType action_type, int size) {
-  SPIEL_CHECK_GE(cur_player_, 0);  // No chance not terminal.
-
-  actionSequence_ += (char)actions[action_type];
-  switch (action_type) {
-    case ACTION_FOLD:
-      acpc_state_.DoAction(acpc_cpp::ACPCState::ACPCActionType::ACPC_FOLD, 0);
-      break;
-    case ACTION_CHECK_CALL:
-      acpc_state_.DoAction(acpc_cpp::ACPCState::ACPCActionType::ACPC_CALL, 0);
-      break;
-    case ACTION_BET:
-      if (betting_abstraction_ == BettingAbstraction::kFULLGAME) {
-        acpc_state_.DoAction(acpc_cpp::ACPCState::ACPCActionType::ACPC_RAISE,
-                             size);
-      } else {
-        acpc_state_.DoAction(acpc_cpp::ACPCState::ACPCActionType::ACPC_RAISE,
-                             potSize_);
-      }
-      break;
-    case ACTION_ALL_IN:
-      acpc_state_.DoAction(acpc_cpp::ACPCState::ACPCActionType::ACPC_RAISE,
-                           allInSize_);
-      break;
-    case ACTION_DEAL:
-    default:
-      assert(false);
-      break;
-  }
-
-  _CalculateActionsAndNodeType();
-}
-
 void UniversalPokerState::_CalculateActionsAndNodeType() {
-  possibleActions_ = 0;
-
-  if (acpc_state_.IsFinished()) {
-    if (acpc_state_.NumFolded() >= acpc_game_->GetNbPlayers() - 1) {
+  const BettingTreeNode &node = *betting_node_;
+  if (node.finished) {
+    if (node.folded) {
       // All players except one has fold.
       cur_player_ = kTerminalPlayerId;
+    } else if (board_cards_.NumCards() <
+               acpc_game_->GetNbBoardCardsRequired(node.round)) {
+      cur_player_ = kChancePlayerId;
     } else {
-      if (board_cards_.NumCards() <
-          acpc_game_->GetNbBoardCardsRequired(acpc_state_.GetRound())) {
-        cur_player_ = kChancePlayerId;
-        possibleActions_ = ACTION_DEAL;
-        return;
-      }
       // Showdown!
       cur_player_ = kTerminalPlayerId;
     }
-
-  } else {
-    // Check for sth to deal
-    // 1. We still need to deal cards if a player still has missing cards.
+  } else if (hole_cards_[acpc_game_->GetNbPlayers() - 1].NumCards() <
+             acpc_game_->GetNbHoleCardsRequired()) {
+    // We still need to deal cards if a player still has missing cards.
     // Because we deal from 0 to num_players - 1, we can just check the last
     // player.
-    if (hole_cards_[acpc_game_->GetNbPlayers() - 1].NumCards() <
-        acpc_game_->GetNbHoleCardsRequired()) {
-      cur_player_ = kChancePlayerId;
-      possibleActions_ = ACTION_DEAL;
-      return;
-    }
-    // 2. We need to deal a public card.
-    if (board_cards_.NumCards() <
-        acpc_game_->GetNbBoardCardsRequired(acpc_state_.GetRound())) {
-      cur_player_ = kChancePlayerId;
-      possibleActions_ = ACTION_DEAL;
-      return;
-    }
+    cur_player_ = kChancePlayerId;
+  } else if (board_cards_.NumCards() <
+             acpc_game_->GetNbBoardCardsRequired(node.round)) {
+    // We need to deal a public card.
+    cur_player_ = kChancePlayerId;
+  } else {
+    cur_player_ = node.player;
+  }
+}
 
-    // Check for CHOICE Actions
-    cur_player_ = acpc_state_.CurrentPlayer();
-    if (acpc_state_.IsValidAction(
-            acpc_cpp::ACPCState::ACPCActionType::ACPC_FOLD, 0)) {
-      possibleActions_ |= ACTION_FOLD;
-    }
-    if (acpc_state_.IsValidAction(
-            acpc_cpp::ACPCState::ACPCActionType::ACPC_CALL, 0)) {
-      possibleActions_ |= ACTION_CHECK_CALL;
-    }
+uint32_t UniversalPokerState::GetPossibleActionsMask() const {
+  if (IsChanceNode()) return ACTION_DEAL;
+  if (IsTerminal()) return 0;
+  return betting_node_->possible_actions;
+}
 
-    potSize_ = 0;
-    allInSize_ = 0;
-    // We have to call this as this sets potSize_ and allInSize_.
-    bool valid_to_raise = acpc_state_.RaiseIsValid(&potSize_, &allInSize_);
-    if (betting_abstraction_ == BettingAbstraction::kFC) return;
+const int UniversalPokerState::GetPossibleActionCount() const {
+  // _builtin_popcount(int) function is used to count the number of one's
+  return __builtin_popcount(GetPossibleActionsMask());
+}
+
+BettingTree::BettingTree(const acpc_cpp::ACPCGame &acpc_game,
+                         BettingAbstraction betting_abstraction, int big_blind)
+    : acpc_game_(acpc_game),
+      betting_abstraction_(betting_abstraction),
+      big_blind_(big_blind) {
+  absl::MutexLock lock(&mutex_);
+  root_ = AddNode(acpc_cpp::ACPCState(&acpc_game_), /*action_char=*/'\0');
+}
+
+int BettingTree::NumNodes() const {
+  absl::MutexLock lock(&mutex_);
+  return nodes_.size();
+}
+
+const BettingTreeNode *BettingTree::AddNode(acpc_cpp::ACPCState acpc_state,
+                                            char action_char) {
+  using ACPCActionType = acpc_cpp::ACPCState::ACPCActionType;
+  nodes_.emplace_back(std::move(acpc_state), action_char);
+  BettingTreeNode &node = nodes_.back();
+  const acpc_cpp::ACPCState &state = node.acpc_state;
+  const int num_players = acpc_game_.GetNbPlayers();
+  node.finished = state.IsFinished();
+  node.folded = state.NumFolded() >= num_players - 1;
+  node.round = state.GetRound();
+  for (int r = 0; r <= node.round; ++r) {
+    node.betting_sequences.push_back(state.BettingSequence(r));
+    AppendVarint(node.betting_sequences.back().size(),
+                 &node.betting_sequences_key);
+    node.betting_sequences_key.append(node.betting_sequences.back());
+  }
+  node.betting_sequences_string = absl::StrJoin(node.betting_sequences, "|");
+  for (auto p = Player{0}; p < num_players; ++p) {
+    if (p > 0) node.money_string.push_back(' ');
+    absl::StrAppend(&node.money_string, state.Money(p));
+  }
+  node.pot = state.MaxSpend() * (num_players - state.NumFolded());
+  children_[&node];
+  if (node.finished) {
+    node.player = kTerminalPlayerId;
+    return &node;
+  }
+
+  // Check for CHOICE Actions
+  node.player = state.CurrentPlayer();
+  const bool can_fold = state.IsValidAction(ACPCActionType::ACPC_FOLD, 0);
+  const bool can_call = state.IsValidAction(ACPCActionType::ACPC_CALL, 0);
+  if (can_fold) node.possible_actions |= UniversalPokerState::ACTION_FOLD;
+  if (can_call) node.possible_actions |= UniversalPokerState::ACTION_CHECK_CALL;
+
+  int32_t min_bet_size = 0;
+  int32_t max_bet_size = 0;
+  const bool valid_to_raise = state.RaiseIsValid(&min_bet_size, &max_bet_size);
+  if (betting_abstraction_ == BettingAbstraction::kFULLGAME) {
+    if (can_fold) node.legal_actions.push_back(kFold);
+    if (can_call) node.legal_actions.push_back(kCall);
     if (valid_to_raise) {
-      if (acpc_game_->IsLimitGame()) {
-        potSize_ = 0;
+      assert(min_bet_size % big_blind_ == 0);
+      for (int i = min_bet_size; i <= max_bet_size; i += big_blind_) {
+        node.legal_actions.push_back(1 + i / big_blind_);
+      }
+    }
+  } else {
+    node.pot_size = min_bet_size;
+    node.all_in_size = max_bet_size;
+    if (betting_abstraction_ == BettingAbstraction::kFCPA && valid_to_raise) {
+      if (acpc_game_.IsLimitGame()) {
+        node.pot_size = 0;
         // There's only one "bet" allowed in Limit, which is "all-in or fixed
         // bet".
-        possibleActions_ |= ACTION_BET;
+        node.possible_actions |= UniversalPokerState::ACTION_BET;
       } else {
-        int cur_spent = acpc_state_.CurrentSpent(acpc_state_.CurrentPlayer());
+        int cur_spent = state.CurrentSpent(state.CurrentPlayer());
         int pot_raise_to =
-            acpc_state_.TotalSpent() + 2 * acpc_state_.MaxSpend() - cur_spent;
+            state.TotalSpent() + 2 * state.MaxSpend() - cur_spent;
 
-        if (pot_raise_to >= potSize_ && pot_raise_to <= allInSize_) {
-          potSize_ = pot_raise_to;
-          possibleActions_ |= ACTION_BET;
+        if (pot_raise_to >= node.pot_size && pot_raise_to <= node.all_in_size) {
+          node.pot_size = pot_raise_to;
+          node.possible_actions |= UniversalPokerState::ACTION_BET;
         }
 
-        if (pot_raise_to != allInSize_) {
+        if (pot_raise_to != node.all_in_size) {
           // If the raise to amount happens to match the number of chips I have,
           // then this action was already added as a pot-bet.
-          possibleActions_ |= ACTION_ALL_IN;
+          node.possible_actions |= UniversalPokerState::ACTION_ALL_IN;
         }
       }
     }
+    const uint32_t mask = node.possible_actions;
+    if (UniversalPokerState::ACTION_FOLD & mask) {
+      node.legal_actions.push_back(kFold);
+    }
+    if (UniversalPokerState::ACTION_CHECK_CALL & mask) {
+      node.legal_actions.push_back(kCall);
+    }
+    if (UniversalPokerState::ACTION_BET & mask) {
+      node.legal_actions.push_back(kBet);
+    }
+    if (UniversalPokerState::ACTION_ALL_IN & mask) {
+      node.legal_actions.push_back(kAllIn);
+    }
   }
+  children_[&node].resize(node.legal_actions.size(), nullptr);
+  return &node;
 }
 
-const int UniversalPokerState::GetPossibleActionCount() const {
-  // _builtin_popcount(int) function is used to count the number of one's
-  return __builtin_popcount(possibleActions_);
+const BettingTreeNode *BettingTree::Child(const BettingTreeNode *node,
+                                          Action action) {
+  const auto it = std::lower_bound(node->legal_actions.begin(),
+                                   node->legal_actions.end(), action);
+  if (it == node->legal_actions.end() || *it != action) {
+    SpielFatalError(absl::StrFormat("Action not recognized: %i", action));
+  }
+  const int index = it - node->legal_actions.begin();
+  {
+    absl::ReaderMutexLock lock(&mutex_);
+    const BettingTreeNode *child = children_.at(node)[index];
+    if (child != nullptr) return child;
+  }
+
+  absl::MutexLock lock(&mutex_);
+  const BettingTreeNode *child = children_.at(node)[index];
+  if (child != nullptr) return child;
+  using ACPCActionType = acpc_cpp::ACPCState::ACPCActionType;
+  acpc_cpp::ACPCState state = node->acpc_state;
+  char action_char;
+  if (action == kFold) {
+    state.DoAction(ACPCActionType::ACPC_FOLD, 0);
+    action_char = 'f';
+  } else if (action == kCall) {
+    state.DoAction(ACPCActionType::ACPC_CALL, 0);
+    action_char = 'c';
+  } else if (betting_abstraction_ != BettingAbstraction::kFULLGAME &&
+             action == kAllIn) {
+    state.DoAction(ACPCActionType::ACPC_RAISE, node->all_in_size);
+    action_char = 'a';
+  } else if (betting_abstraction_ != BettingAbstraction::kFULLGAME) {
+    state.DoAction(ACPCActionType::ACPC_RAISE, node->pot_size);
+    action_char = 'p';
+  } else {
+    state.DoAction(ACPCActionType::ACPC_RAISE, (action - 1) * big_blind_);
+    action_char = 'p';
+  }
+  child = AddNode(std::move(state), action_char);
+  children_.at(node)[index] = child;
+  return child;
 }
 
 std::ostream &operator<<(std::ostream &os, const BettingAbstraction &betting) {
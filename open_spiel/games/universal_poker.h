@@ -16,12 +16,15 @@
 #define OPEN_SPIEL_GAMES_UNIVERSAL_POKER_H_
 
 #include <array>
+#include <deque>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "open_spiel/abseil-cpp/absl/algorithm/container.h"
+#include "open_spiel/abseil-cpp/absl/container/flat_hash_map.h"
+#include "open_spiel/abseil-cpp/absl/synchronization/mutex.h"
 #include "open_spiel/games/universal_poker/acpc_cpp/acpc_game.h"
 #include "open_spiel/games/universal_poker/logic/card_set.h"
 #include "open_spiel/policy.h"
@@ -38,6 +41,8 @@ namespace open_spiel {
 namespace universal_poker {
 
 class UniversalPokerGame;
+struct BettingTreeNode;
+class BettingTree;
 
 constexpr uint8_t kMaxUniversalPokerPlayers = 10;
 
@@ -59,9 +64,12 @@ class UniversalPokerState : public State {
   std::string ToString() const override;
   std::vector<double> Returns() const override;
   std::string InformationStateString(Player player) const override;
+  std::string InformationStateKey(Player player) const override;
   std::string ObservationString(Player player) const override;
   void InformationStateTensor(Player player,
                               std::vector<double> *values) const override;
+  void InformationStateTensor(Player player,
+                              SparseTensor *tensor) const override;
   void ObservationTensor(Player player,
                          std::vector<double> *values) const override;
   std::unique_ptr<State> Clone() const override;
@@ -73,10 +81,16 @@ class UniversalPokerState : public State {
   // Used to make UpdateIncrementalStateDistribution much faster.
   std::unique_ptr<HistoryDistribution> GetHistoriesConsistentWithInfostate(
       int player_id) const override;
+  // Deals the other players' hole cards anew, from those the player hasn't
+  // seen. Not implemented with suit isomorphism.
+  std::unique_ptr<State> ResampleFromInfostate(
+      int player_id, std::function<double()> rng) const override;
 
  protected:
   void DoApplyAction(Action action_id) override;
 
+  friend class BettingTree;
+
   int big_blind_;
   int starting_stack_big_blinds_;
 
@@ -91,11 +105,18 @@ class UniversalPokerState : public State {
       ACTION_DEAL, ACTION_FOLD, ACTION_CHECK_CALL, ACTION_BET, ACTION_ALL_IN};
 
  public:
+  // Besides the history, a state is only fixed-size values and pointers into
+  // the game, so that it is cheap to clone, as CFR and MCTS do at every node.
+  // The ACPC state and the action sequence are rebuilt when needed.
   const acpc_cpp::ACPCGame *acpc_game_;
-  acpc_cpp::ACPCState acpc_state_;
+  // The betting so far, as a node of the game's betting tree, which the game
+  // owns and game_ keeps alive.
+  BettingTree *betting_tree_;
+  const BettingTreeNode *betting_node_;
   logic::CardSet deck_;  // The remaining cards to deal.
-  // The cards already owned by each player
-  std::vector<logic::CardSet> hole_cards_;
+  // The cards already owned by each player, the sets past the number of
+  // players staying empty.
+  std::array<logic::CardSet, kMaxUniversalPokerPlayers> hole_cards_;
   logic::CardSet board_cards_;  // The public cards.
   // The current player:
   // kChancePlayerId for chance nodes
@@ -103,10 +124,6 @@ class UniversalPokerState : public State {
   // we have reached the showdown.
   // The current player >= 0 otherwise.
   Player cur_player_;
-  uint32_t possibleActions_;
-  int32_t potSize_ = 0;
-  int32_t allInSize_ = 0;
-  std::string actionSequence_;
 
   BettingAbstraction betting_abstraction_;
 
@@ -114,11 +131,25 @@ class UniversalPokerState : public State {
 
   double GetTotalReward(Player player) const;
 
-  const uint32_t &GetPossibleActionsMask() const { return possibleActions_; }
+  // The ACPC state of the betting so far, without the cards.
+  const acpc_cpp::ACPCState &acpc_state() const;
+  // The ACPC state with the cards dealt so far.
+  acpc_cpp::ACPCState AcpcStateWithCards() const;
+
+  uint32_t GetPossibleActionsMask() const;
   const int GetPossibleActionCount() const;
 
-  void ApplyChoiceAction(ActionType action_type, int size);
-  std::string GetActionSequence() const { return actionSequence_; }
+  // The actions so far, as a 'd' for each card dealt and the ACPC character
+  // of each betting action.
+  std::string GetActionSequence() const;
+
+  // Whether isomorphic deals are dealt once, with their total probability,
+  // and the cards shown in the player's information state and observation
+  // are relabelled canonically (see UniversalPokerGame).
+  bool suit_isomorphism_;
+
+  // The hole cards of the player and the board cards, as the player sees them.
+  std::pair<logic::CardSet, logic::CardSet> VisibleCards(Player player) const;
 };
 
 class UniversalPokerGame : public Game {
@@ -139,12 +170,19 @@ class UniversalPokerGame : public Game {
   BettingAbstraction betting_abstraction() const {
     return betting_abstraction_;
   }
+  bool suit_isomorphism() const { return suit_isomorphism_; }
+  const std::shared_ptr<BettingTree> &betting_tree() const {
+    return betting_tree_;
+  }
 
  private:
   std::string gameDesc_;
   const acpc_cpp::ACPCGame acpc_game_;
   std::optional<int> max_game_length_;
   BettingAbstraction betting_abstraction_ = BettingAbstraction::kFULLGAME;
+  bool suit_isomorphism_;
+  // Shared by the clones of the game.
+  std::shared_ptr<BettingTree> betting_tree_;
 
  public:
   const acpc_cpp::ACPCGame *GetACPCGame() const { return &acpc_game_; }
@@ -154,6 +192,79 @@ class UniversalPokerGame : public Game {
   int starting_stack_big_blinds_;
 };
 
+// A node of the betting tree: what the players can do after some betting,
+// which does not depend on the cards. It does not change once it is built.
+struct BettingTreeNode {
+  BettingTreeNode(acpc_cpp::ACPCState state, char last_action)
+      : acpc_state(std::move(state)), action_char(last_action) {}
+
+  acpc_cpp::ACPCState acpc_state;
+  // The character of the action leading here in the action sequence.
+  char action_char;
+  // Whether the betting of the hand is over, and if so, whether it ended by
+  // all the players but one folding.
+  bool finished;
+  bool folded;
+  int round;
+  // The player to act, when the betting is not over.
+  Player player;
+  // The mask of the UniversalPokerState::ActionType which are possible, and
+  // the sizes of the pot bet and all-in raise in the abstracted games.
+  uint32_t possible_actions = 0;
+  int32_t pot_size = 0;
+  int32_t all_in_size = 0;
+  // In increasing order.
+  std::vector<Action> legal_actions;
+  // The betting sequences of the rounds so far, and the pot.
+  std::vector<std::string> betting_sequences;
+  uint32_t pot;
+  // The public parts of the information state strings and keys, built once
+  // here rather than on every call: the players' money and the betting
+  // sequences joined by '|', and the sequences each prefixed by its size.
+  std::string money_string;
+  std::string betting_sequences_string;
+  std::string betting_sequences_key;
+};
+
+// The betting tree of a game, for its betting abstraction. Its nodes are built
+// the first time a state reaches them, and then shared by all the states, so
+// that the legal actions and the public part of the information states are
+// looked up rather than computed from the ACPC state after every action. It
+// can be used from several threads at once.
+class BettingTree {
+ public:
+  BettingTree(const acpc_cpp::ACPCGame &acpc_game,
+              BettingAbstraction betting_abstraction, int big_blind);
+
+  const BettingTreeNode *Root() const { return root_; }
+
+  // The node reached from node by one of its legal actions.
+  const BettingTreeNode *Child(const BettingTreeNode *node, Action action);
+
+  int NumNodes() const;
+
+ private:
+  const BettingTreeNode *AddNode(acpc_cpp::ACPCState acpc_state,
+                                 char action_char)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Nodes point to it through their ACPC states, so the tree has its own copy
+  // of the game.
+  const acpc_cpp::ACPCGame acpc_game_;
+  const BettingAbstraction betting_abstraction_;
+  const int big_blind_;
+
+  mutable absl::Mutex mutex_;
+  // A deque, so that the nodes never move.
+  std::deque<BettingTreeNode> nodes_ ABSL_GUARDED_BY(mutex_);
+  // The children of each node, by index of the action in its legal actions,
+  // or null where they have not been built yet.
+  absl::flat_hash_map<const BettingTreeNode *,
+                      std::vector<const BettingTreeNode *>>
+      children_ ABSL_GUARDED_BY(mutex_);
+  const BettingTreeNode *root_;
+};
+
 // Only supported for UniversalPoker. Randomly plays an action from a fixed list
 // of actions. If none of the actions are legal, selects uniformly from the
 // list of legal actions.
@@ -14,6 +14,7 @@
 
 #include "open_spiel/games/universal_poker/logic/card_set.h"
 
+#include <algorithm>
 #include <bitset>
 #include <iostream>
 #include <sstream>
@@ -150,6 +151,54 @@ std::vector<CardSet> CardSet::SampleCards(int nbCards) {
   return combinations;
 }
 
+CardSet CardSet::PermuteSuits(
+    const std::array<int, kMaxSuits>& permutation) const {
+  CardSet permuted;
+  for (int s = 0; s < kMaxSuits; ++s) {
+    permuted.cs.bySuit[permutation[s]] = cs.bySuit[s];
+  }
+  return permuted;
+}
+
+namespace {
+
+// Whether suit a has the same ranks as suit b in each of the sets.
+bool SameSuits(const std::vector<CardSet>& sets, int a, int b) {
+  for (const CardSet& set : sets) {
+    if (set.cs.bySuit[a] != set.cs.bySuit[b]) return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+std::array<int, kMaxSuits> CanonicalSuitPermutation(
+    const std::vector<CardSet>& sets, int num_suits) {
+  std::array<int, kMaxSuits> order = {0, 1, 2, 3};
+  std::sort(order.begin(), order.begin() + num_suits, [&sets](int a, int b) {
+    for (const CardSet& set : sets) {
+      if (set.cs.bySuit[a] != set.cs.bySuit[b]) {
+        return set.cs.bySuit[a] > set.cs.bySuit[b];
+      }
+    }
+    return a < b;
+  });
+  std::array<int, kMaxSuits> permutation = {0, 1, 2, 3};
+  for (int i = 0; i < num_suits; ++i) permutation[order[i]] = i;
+  return permutation;
+}
+
+std::array<int, kMaxSuits> SuitMultiplicities(const std::vector<CardSet>& sets,
+                                              int num_suits) {
+  std::array<int, kMaxSuits> multiplicities = {0, 0, 0, 0};
+  for (int s = 0; s < num_suits; ++s) {
+    int lower = 0;
+    while (lower < s && !SameSuits(sets, lower, s)) ++lower;
+    multiplicities[lower] += 1;
+  }
+  return multiplicities;
+}
+
 bool CardSet::ContainsCards(uint8_t card) const {
   int rank = rankOfCard(card);
   int suit = suitOfCard(card);
@@ -15,6 +15,7 @@
 #ifndef OPEN_SPIEL_CARD_SET_H
 #define OPEN_SPIEL_CARD_SET_H
 
+#include <array>
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -60,8 +61,27 @@ class CardSet {
 
   // Returns all the possible nbCards-subsets of this CardSet.
   std::vector<CardSet> SampleCards(int nbCards);
+
+  // Returns this set with the cards of suit s moved to suit permutation[s].
+  CardSet PermuteSuits(const std::array<int, kMaxSuits>& permutation) const;
 };
 
+// Suit isomorphism: poker hands are worth the same after any relabelling of
+// the suits, so sets of cards which differ only by one are equivalent.
+
+// Returns the relabelling of the first num_suits suits which sorts them by
+// their ranks in sets[0], then in sets[1], etc. Applied to each of the sets,
+// it gives the same sets for all the equivalent ones.
+std::array<int, kMaxSuits> CanonicalSuitPermutation(
+    const std::vector<CardSet>& sets, int num_suits);
+
+// Returns for each of the first num_suits suits the number of suits which
+// have the same ranks as it in each of the sets, or 0 if a lower suit does:
+// the cards of the suits with a zero can be left out when dealing the next
+// card, and those of the others count that many times.
+std::array<int, kMaxSuits> SuitMultiplicities(const std::vector<CardSet>& sets,
+                                              int num_suits);
+
 }  // namespace logic
 }  // namespace universal_poker
 }  // namespace open_spiel
@@ -0,0 +1,191 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/games/universal_poker/logic/hand_rank_table.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/abseil-cpp/absl/strings/string_view.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/file.h"
+
+namespace open_spiel::universal_poker::logic {
+namespace {
+
+constexpr char kMagic[8] = {'O', 'S', 'P', 'K', 'R', 'A', 'N', 'K'};
+constexpr uint32_t kVersion = 1;
+
+// Its size is a multiple of 8 bytes, so that the ranks after it stay aligned.
+struct Header {
+  char magic[8];
+  uint32_t version;
+  int32_t num_suits;
+  int32_t num_ranks;
+  int32_t num_cards;
+  int64_t num_hands;
+};
+
+}  // namespace
+
+HandRankTable::HandRankTable(int num_suits, int num_ranks, int num_cards)
+    : num_suits_(num_suits), num_ranks_(num_ranks), num_cards_(num_cards) {
+  InitBinomials();
+  owned_ranks_.resize(num_hands_);
+  ranks_ = owned_ranks_.data();
+
+  // Enumerates the hands in colexicographic order of their cards, which is
+  // the order of their indices.
+  const int deck_size = num_suits_ * num_ranks_;
+  std::vector<int> cards(num_cards_ + 1);
+  for (int i = 0; i < num_cards_; ++i) cards[i] = i;
+  cards[num_cards_] = deck_size;
+  for (int64_t index = 0; index < num_hands_; ++index) {
+    CardSet hand;
+    for (int i = 0; i < num_cards_; ++i) {
+      hand.cs.bySuit[cards[i] / num_ranks_] |= (uint16_t)1
+                                               << (cards[i] % num_ranks_);
+    }
+    owned_ranks_[index] = hand.RankCards();
+
+    int i = 0;
+    while (i < num_cards_ && cards[i] + 1 == cards[i + 1]) {
+      cards[i] = i;
+      ++i;
+    }
+    if (i < num_cards_) ++cards[i];
+  }
+}
+
+HandRankTable::HandRankTable(const std::string& filename) {
+  const int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    SpielFatalError(absl::StrCat("Could not open the rank table ", filename));
+  }
+  struct stat file_stat;
+  SPIEL_CHECK_EQ(fstat(fd, &file_stat), 0);
+  size_ = file_stat.st_size;
+  if (size_ < static_cast<int64_t>(sizeof(Header))) {
+    close(fd);
+    SpielFatalError(absl::StrCat(filename, " is not a rank table"));
+  }
+  void* data = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    SpielFatalError(absl::StrCat("Could not map the rank table ", filename));
+  }
+  data_ = static_cast<const char*>(data);
+
+  const Header* header = reinterpret_cast<const Header*>(data_);
+  if (std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0) {
+    SpielFatalError(absl::StrCat(filename, " is not a rank table"));
+  }
+  if (header->version != kVersion) {
+    SpielFatalError(absl::StrCat("Unsupported version ", header->version,
+                                 " of the rank table ", filename));
+  }
+  num_suits_ = header->num_suits;
+  num_ranks_ = header->num_ranks;
+  num_cards_ = header->num_cards;
+  InitBinomials();
+  if (header->num_hands != num_hands_ ||
+      size_ != sizeof(Header) + num_hands_ * sizeof(int32_t)) {
+    SpielFatalError(absl::StrCat("The rank table ", filename,
+                                 " has the wrong size"));
+  }
+  ranks_ = reinterpret_cast<const int32_t*>(data_ + sizeof(Header));
+}
+
+HandRankTable::~HandRankTable() {
+  if (data_ != nullptr) munmap(const_cast<char*>(data_), size_);
+}
+
+void HandRankTable::InitBinomials() {
+  SPIEL_CHECK_GE(num_suits_, 1);
+  SPIEL_CHECK_LE(num_suits_, kMaxSuits);
+  SPIEL_CHECK_GE(num_ranks_, 1);
+  SPIEL_CHECK_LE(num_ranks_, kMaxRanks);
+  SPIEL_CHECK_GE(num_cards_, 1);
+  SPIEL_CHECK_LE(num_cards_, kMaxCardsPerHand);
+  const int deck_size = num_suits_ * num_ranks_;
+  SPIEL_CHECK_LE(num_cards_, deck_size);
+  for (int n = 0; n <= deck_size; ++n) {
+    binomials_[n][0] = 1;
+    for (int k = 1; k <= kMaxCardsPerHand; ++k) {
+      binomials_[n][k] = n == 0 ? 0 : binomials_[n - 1][k - 1] +
+                                           binomials_[n - 1][k];
+    }
+  }
+  num_hands_ = binomials_[deck_size][num_cards_];
+}
+
+void HandRankTable::Write(const std::string& filename) const {
+  Header header;
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.num_suits = num_suits_;
+  header.num_ranks = num_ranks_;
+  header.num_cards = num_cards_;
+  header.num_hands = num_hands_;
+
+  // Written next to the table first, so that it is never seen half written,
+  // even by processes which have it mapped.
+  const std::string tmp_filename = absl::StrCat(filename, ".tmp");
+  {
+    file::File file(tmp_filename, "wb");
+    SPIEL_CHECK_TRUE(file.Write(absl::string_view(
+        reinterpret_cast<const char*>(&header), sizeof(header))));
+    SPIEL_CHECK_TRUE(file.Write(absl::string_view(
+        reinterpret_cast<const char*>(ranks_), num_hands_ * sizeof(int32_t))));
+    SPIEL_CHECK_TRUE(file.Flush());
+  }
+  if (std::rename(tmp_filename.c_str(), filename.c_str()) != 0) {
+    SpielFatalError(absl::StrCat("Could not write the rank table ", filename));
+  }
+}
+
+int64_t HandRankTable::Index(const CardSet& hand) const {
+  int64_t index = 0;
+  int k = 0;
+  for (int suit = 0; suit < num_suits_; ++suit) {
+    for (uint32_t ranks = hand.cs.bySuit[suit]; ranks; ranks &= ranks - 1) {
+      const int card = suit * num_ranks_ + __builtin_ctz(ranks);
+      index += binomials_[card][++k];
+    }
+  }
+  SPIEL_CHECK_EQ(k, num_cards_);
+  return index;
+}
+
+std::vector<int> HandRankTable::RankHands(
+    const CardSet& board, const std::vector<CardSet>& hands) const {
+  std::vector<int> ranks(hands.size(), kInvalidRank);
+  for (int i = 0; i < hands.size(); ++i) {
+    if (hands[i].cs.cards & board.cs.cards) continue;
+    CardSet cards;
+    cards.cs.cards = hands[i].cs.cards | board.cs.cards;
+    ranks[i] = ranks_[Index(cards)];
+  }
+  return ranks;
+}
+
+}  // namespace open_spiel::universal_poker::logic
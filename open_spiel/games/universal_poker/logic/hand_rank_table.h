@@ -0,0 +1,99 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_HAND_RANK_TABLE_H
+#define OPEN_SPIEL_HAND_RANK_TABLE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "open_spiel/games/universal_poker/logic/card_set.h"
+
+namespace open_spiel {
+namespace universal_poker {
+namespace logic {
+
+constexpr int kMaxRanks = 13;         // Also defined in ACPC game.h
+constexpr int kMaxCardsPerHand = 7;   // The most ACPC ranks at once.
+
+// The ranks CardSet::RankCards gives to all the hands of num_cards cards of a
+// deck with num_suits suits of num_ranks ranks, so that a showdown is a lookup
+// instead of a call to the ACPC evaluator.
+//
+// The hands are indexed by a perfect hash: numbering the cards of the deck
+// suit by suit, a hand whose cards are c_1 < ... < c_k is at
+// C(c_1, 1) + ... + C(c_k, k), its position in the colexicographic order of
+// the hands. The table has one 32-bit rank per hand, 535MB for the 7-card
+// hands of a full deck, so it can be written to a file once and mapped by all
+// the processes using it.
+class HandRankTable {
+ public:
+  // The rank of hands which overlap the board in RankHands.
+  static constexpr int kInvalidRank = -1;
+
+  // Ranks all the hands with CardSet::RankCards.
+  HandRankTable(int num_suits, int num_ranks, int num_cards);
+
+  // Maps a table written by Write, read-only, for as long as this lives. The
+  // numbers are in the byte order of the machine which wrote it.
+  explicit HandRankTable(const std::string& filename);
+  ~HandRankTable();
+
+  HandRankTable(const HandRankTable&) = delete;
+  HandRankTable& operator=(const HandRankTable&) = delete;
+
+  void Write(const std::string& filename) const;
+
+  int NumSuits() const { return num_suits_; }
+  int NumRanks() const { return num_ranks_; }
+  int NumCards() const { return num_cards_; }
+  int64_t NumHands() const { return num_hands_; }
+
+  // The index of a hand of NumCards() cards from the deck.
+  int64_t Index(const CardSet& hand) const;
+
+  // The rank of a hand of NumCards() cards, as CardSet::RankCards gives it.
+  int Rank(const CardSet& hand) const { return ranks_[Index(hand)]; }
+
+  // The ranks of each of the hands together with the board, which must make
+  // NumCards() cards, or kInvalidRank for the hands which share cards with
+  // the board. This is the showdown of all the private hands at a public
+  // state at once.
+  std::vector<int> RankHands(const CardSet& board,
+                             const std::vector<CardSet>& hands) const;
+
+ private:
+  void InitBinomials();
+
+  int num_suits_;
+  int num_ranks_;
+  int num_cards_;
+  int64_t num_hands_;
+
+  // binomials_[n][k] is C(n, k), for n up to the size of the deck.
+  int64_t binomials_[kMaxSuits * kMaxRanks + 1][kMaxCardsPerHand + 1];
+
+  // The ranks, either owned by the table or mapped from a file.
+  std::vector<int32_t> owned_ranks_;
+  const char* data_ = nullptr;
+  int64_t size_ = 0;
+  const int32_t* ranks_;
+};
+
+}  // namespace logic
+}  // namespace universal_poker
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_HAND_RANK_TABLE_H
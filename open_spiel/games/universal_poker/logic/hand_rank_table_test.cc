@@ -0,0 +1,71 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/games/universal_poker/logic/hand_rank_table.h"
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/file.h"
+
+namespace open_spiel {
+namespace universal_poker {
+namespace logic {
+
+// Every hand has its own index, and the rank the ACPC evaluator gives it.
+void TableMatchesRankCardsTest() {
+  const HandRankTable table(/*num_suits=*/4, /*num_ranks=*/8, /*num_cards=*/5);
+  SPIEL_CHECK_EQ(table.NumHands(), 201376);
+  std::vector<bool> seen(table.NumHands(), false);
+  for (const CardSet& hand : CardSet(4, 8).SampleCards(5)) {
+    const int64_t index = table.Index(hand);
+    SPIEL_CHECK_GE(index, 0);
+    SPIEL_CHECK_LT(index, table.NumHands());
+    SPIEL_CHECK_FALSE(seen[index]);
+    seen[index] = true;
+    SPIEL_CHECK_EQ(table.Rank(hand), hand.RankCards());
+  }
+}
+
+void MappedTableTest() {
+  const std::string filename = absl::StrCat(
+      file::GetTmpDir(), "/open_spiel-test-", std::rand(),  // NOLINT
+      "-hand_rank_table");
+  HandRankTable(/*num_suits=*/4, /*num_ranks=*/13, /*num_cards=*/5)
+      .Write(filename);
+  const HandRankTable table(filename);
+  SPIEL_CHECK_EQ(table.NumHands(), 2598960);
+
+  const CardSet board("AhKsQhJh");
+  const std::vector<CardSet> hands = {CardSet("Th"), CardSet("2c"),
+                                      CardSet("Ks")};
+  const std::vector<int> ranks = table.RankHands(board, hands);
+  SPIEL_CHECK_EQ(ranks[0], CardSet("AhKsQhJhTh").RankCards());
+  SPIEL_CHECK_EQ(ranks[1], CardSet("AhKsQhJh2c").RankCards());
+  SPIEL_CHECK_GT(ranks[0], ranks[1]);
+  SPIEL_CHECK_EQ(ranks[2], HandRankTable::kInvalidRank);
+  SPIEL_CHECK_TRUE(file::Remove(filename));
+}
+
+}  // namespace logic
+}  // namespace universal_poker
+}  // namespace open_spiel
+
+int main(int argc, char **argv) {
+  open_spiel::universal_poker::logic::TableMatchesRankCardsTest();
+  open_spiel::universal_poker::logic::MappedTableTest();
+}
@@ -15,11 +15,14 @@
 #include "open_spiel/games/universal_poker.h"
 
 #include <memory>
+#include <set>
 
 #include "open_spiel/abseil-cpp/absl/algorithm/container.h"
 #include "open_spiel/abseil-cpp/absl/strings/str_join.h"
 #include "open_spiel/canonical_game_strings.h"
 #include "open_spiel/algorithms/evaluate_bots.h"
+#include "open_spiel/algorithms/expected_returns.h"
+#include "open_spiel/algorithms/get_all_states.h"
 #include "open_spiel/game_parameters.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
@@ -200,6 +203,8 @@ void BasicUniversalPokerTests() {
   // testing::RandomSimBenchmark("universal_poker", 10000, false);
 
   testing::CheckChanceOutcomes(*LoadGame("universal_poker"));
+  testing::ResampleInfostateTest(*LoadGame("universal_poker"),
+                                 /*num_sims=*/10);
 }
 
 constexpr absl::string_view kHULHString =
@@ -413,6 +418,92 @@ void FullNLBettingTest3() {
       ":2c2d|2h2s|3c3d/3h3s4c/4d/4h"));
 }
 
+GameParameters LeducLimitParameters(bool suit_isomorphism) {
+  return {{"betting", GameParameter(std::string("limit"))},
+          {"numPlayers", GameParameter(2)},
+          {"numRounds", GameParameter(2)},
+          {"blind", GameParameter(std::string("1 1"))},
+          {"raiseSize", GameParameter(std::string("2 4"))},
+          {"firstPlayer", GameParameter(std::string("1 1"))},
+          {"maxRaises", GameParameter(std::string("2 2"))},
+          {"numSuits", GameParameter(3)},
+          {"numRanks", GameParameter(3)},
+          {"numHoleCards", GameParameter(1)},
+          {"numBoardCards", GameParameter(std::string("0 1"))},
+          {"suitIsomorphism", GameParameter(suit_isomorphism)}};
+}
+
+std::set<std::string> AllInformationStates(const Game &game) {
+  std::set<std::string> information_states;
+  for (const auto &[history, state] : algorithms::GetAllStates(
+           game, /*depth_limit=*/-1, /*include_terminals=*/false,
+           /*include_chance_states=*/false)) {
+    information_states.insert(
+        state->InformationStateString(state->CurrentPlayer()));
+  }
+  return information_states;
+}
+
+// Dealing the deals which only differ by their suits once does not change the
+// value of the game, and merges their information states.
+void SuitIsomorphismTest() {
+  std::shared_ptr<const Game> game =
+      LoadGame("universal_poker", LeducLimitParameters(false));
+  std::shared_ptr<const Game> isomorphic_game =
+      LoadGame("universal_poker", LeducLimitParameters(true));
+  testing::RandomSimTestNoSerialize(*isomorphic_game, 10);
+
+  std::unique_ptr<State> state = isomorphic_game->NewInitialState();
+  SPIEL_CHECK_EQ(state->ChanceOutcomes().size(), 3);
+  for (const auto &[card, probability] : state->ChanceOutcomes()) {
+    SPIEL_CHECK_FLOAT_EQ(probability, 1. / 3);
+  }
+
+  const UniformPolicy uniform;
+  const std::vector<double> returns = algorithms::ExpectedReturns(
+      *game->NewInitialState(), uniform, /*depth_limit=*/-1);
+  const std::vector<double> isomorphic_returns = algorithms::ExpectedReturns(
+      *isomorphic_game->NewInitialState(), uniform, /*depth_limit=*/-1);
+  SPIEL_CHECK_FLOAT_NEAR(returns[0], isomorphic_returns[0], 1e-9);
+  SPIEL_CHECK_FLOAT_NEAR(returns[1], isomorphic_returns[1], 1e-9);
+  SPIEL_CHECK_LT(AllInformationStates(*isomorphic_game).size(),
+                 AllInformationStates(*game).size());
+}
+
+// States with the same betting share the nodes of the game's betting tree,
+// whatever their cards.
+void BettingTreeTest() {
+  std::shared_ptr<const Game> game =
+      LoadGame("universal_poker", LeducLimitParameters(false));
+  const auto &poker_game = static_cast<const UniversalPokerGame &>(*game);
+  const std::vector<Action> betting = {kBet, kCall, kCall, kBet, kCall};
+  std::vector<std::unique_ptr<State>> states;
+  for (int deal = 0; deal < 2; ++deal) {
+    std::unique_ptr<State> state = game->NewInitialState();
+    auto next_betting_action = betting.begin();
+    int num_cards_dealt = 0;
+    while (!state->IsTerminal()) {
+      if (state->IsChanceNode()) {
+        // The lowest cards, but for player 1 in the second deal, who loses
+        // to player 0's pair then.
+        std::vector<Action> cards = state->LegalActions();
+        const bool lowest = deal == 0 || num_cards_dealt != 1;
+        state->ApplyAction(lowest ? cards.front() : cards.back());
+        ++num_cards_dealt;
+      } else {
+        state->ApplyAction(*next_betting_action++);
+      }
+    }
+    SPIEL_CHECK_TRUE(next_betting_action == betting.end());
+    states.push_back(std::move(state));
+  }
+  const auto &state0 = static_cast<const UniversalPokerState &>(*states[0]);
+  const auto &state1 = static_cast<const UniversalPokerState &>(*states[1]);
+  SPIEL_CHECK_EQ(state0.betting_node_, state1.betting_node_);
+  SPIEL_CHECK_NE(state0.Returns(), state1.Returns());
+  SPIEL_CHECK_EQ(poker_game.betting_tree()->NumNodes(), 1 + betting.size());
+}
+
 }  // namespace
 }  // namespace universal_poker
 }  // namespace open_spiel
@@ -430,4 +521,6 @@ int main(int argc, char **argv) {
   open_spiel::universal_poker::FullNLBettingTest1();
   open_spiel::universal_poker::FullNLBettingTest2();
   open_spiel::universal_poker::FullNLBettingTest3();
+  open_spiel::universal_poker::SuitIsomorphismTest();
+  open_spiel::universal_poker::BettingTreeTest();
 }
@@ -19,6 +19,7 @@
 #include <utility>
 #include <vector>
 
+#include "open_spiel/abseil-cpp/absl/random/distributions.h"
 #include "open_spiel/game_parameters.h"
 #include "open_spiel/utils/tensor_view.h"
 
@@ -98,6 +99,9 @@ const NeighborList& get_neighbors(int board_size) {
   return neighbor_list[board_size];
 }
 
+// The same number of random cells tried as in hex.
+constexpr int kMaxSampleTries = 16;
+
 }  // namespace
 
 int Move::Edge(int board_size) const {
@@ -120,10 +124,11 @@ YState::YState(std::shared_ptr<const Game> game, int board_size,
       neighbors(get_neighbors(board_size)),
       ansi_color_output_(ansi_color_output) {
   board_.resize(board_size * board_size);
+  groups_ = UnionFind(board_size * board_size);
   for (int i = 0; i < board_.size(); i++) {
     Move m = ActionToMove(i);
-    board_[i] = Cell((m.OnBoard() ? kPlayerNone : kPlayerInvalid), i,
-                     m.Edge(board_size));
+    board_[i] = m.OnBoard() ? kPlayerNone : kPlayerInvalid;
+    groups_.Reset(i, m.Edge(board_size));
   }
 }
 
@@ -132,16 +137,69 @@ Move YState::ActionToMove(Action action_id) const {
 }
 
 std::vector<Action> YState::LegalActions() const {
-  // Can move in any empty cell.
   std::vector<Action> moves;
-  if (IsTerminal()) return moves;
-  moves.reserve(board_.size() - moves_made_);
+  LegalActions(&moves);
+  return moves;
+}
+
+void YState::LegalActions(std::vector<Action>* moves) const {
+  // Can move in any empty cell.
+  moves->clear();
+  if (IsTerminal()) return;
+  moves->reserve(board_.size() - moves_made_);
   for (int cell = 0; cell < board_.size(); ++cell) {
-    if (board_[cell].player == kPlayerNone) {
-      moves.push_back(cell);
+    if (board_[cell] == kPlayerNone) {
+      moves->push_back(cell);
     }
   }
-  return moves;
+}
+
+Action YState::SampleRandomLegalAction(absl::BitGenRef rng) const {
+  // Samples as HexState does, but about half of the random cells are off the
+  // triangular board, in the half of the square that stores it.
+  SPIEL_CHECK_FALSE(IsTerminal());
+  for (int i = 0; i < kMaxSampleTries; ++i) {
+    int cell = absl::Uniform<int>(rng, 0, board_.size());
+    if (board_[cell] == kPlayerNone) return cell;
+  }
+  int num_empty = 0;
+  for (YPlayer cell : board_) num_empty += cell == kPlayerNone;
+  int index = absl::Uniform<int>(rng, 0, num_empty);
+  for (int cell = 0; cell < board_.size(); ++cell) {
+    if (board_[cell] == kPlayerNone && index-- == 0) return cell;
+  }
+  SpielFatalError("No empty cell to play in.");
+}
+
+std::vector<double> YState::RandomFillReturns(absl::BitGenRef rng) const {
+  if (IsTerminal()) return Returns();
+  std::vector<YPlayer> board = board_;
+  UnionFind groups = groups_;
+  std::vector<int> empty_cells;
+  empty_cells.reserve(board_.size() - moves_made_);
+  for (int cell = 0; cell < board_.size(); ++cell) {
+    if (board_[cell] == kPlayerNone) empty_cells.push_back(cell);
+  }
+  std::shuffle(empty_cells.begin(), empty_cells.end(), rng);
+
+  YPlayer player = current_player_;
+  for (int cell : empty_cells) {
+    board[cell] = player;
+    for (const Move& m : neighbors[cell]) {
+      if (m.OnBoard() && board[m.xy] == player) groups.Join(cell, m.xy);
+    }
+    player = (player == kPlayer1 ? kPlayer2 : kPlayer1);
+  }
+
+  // The group of the winner touches every edge, the left one among them.
+  for (int y = 0; y < board_size_; ++y) {
+    const int cell = y * board_size_;
+    if (groups.Features(cell) == 0x7) {
+      return board[cell] == kPlayer1 ? std::vector<double>{1, -1}
+                                     : std::vector<double>{-1, 1};
+    }
+  }
+  SpielFatalError("Nobody won on a full board.");
 }
 
 std::string YState::ActionToString(Player player, Action action_id) const {
@@ -206,7 +264,7 @@ std::string YState::ToString() const {
       }
 
       // Actual piece.
-      Player p = board_[pos.xy].player;
+      Player p = board_[pos.xy];
       if (p == kPlayerNone) out << empty;
       if (p == kPlayer1) out << white;
       if (p == kPlayer2) out << black;
@@ -259,70 +317,54 @@ void YState::ObservationTensor(Player player,
   TensorView<2> view(values, {kCellStates, static_cast<int>(board_.size())},
                      true);
   for (int i = 0; i < board_.size(); ++i) {
-    if (board_[i].player != kPlayerInvalid) {
-      view[{PlayerRelative(board_[i].player, player), i}] = 1.0;
+    if (board_[i] != kPlayerInvalid) {
+      view[{PlayerRelative(board_[i], player), i}] = 1.0;
     }
   }
 }
 
 void YState::DoApplyAction(Action action) {
-  SPIEL_CHECK_EQ(board_[action].player, kPlayerNone);
+  SPIEL_CHECK_EQ(board_[action], kPlayerNone);
   SPIEL_CHECK_EQ(outcome_, kPlayerNone);
 
   Move move = ActionToMove(action);
   SPIEL_CHECK_TRUE(move.OnBoard());
 
   last_move_ = move;
-  board_[move.xy].player = current_player_;
+  board_[move.xy] = current_player_;
   moves_made_++;
 
   for (const Move& m : neighbors[move.xy]) {
-    if (m.OnBoard() && current_player_ == board_[m.xy].player) {
-      JoinGroups(move.xy, m.xy);
+    if (m.OnBoard() && current_player_ == board_[m.xy]) {
+      groups_.Join(move.xy, m.xy);
     }
   }
 
-  if (board_[FindGroupLeader(move.xy)].edge == 0x7) {  // ie all 3 edges.
+  if (groups_.Features(move.xy) == 0x7) {  // ie all 3 edges.
     outcome_ = current_player_;
   }
 
   current_player_ = (current_player_ == kPlayer1 ? kPlayer2 : kPlayer1);
 }
 
-int YState::FindGroupLeader(int cell) {
-  int parent = board_[cell].parent;
-  if (parent != cell) {
-    do {  // Follow the parent chain up to the group leader.
-      parent = board_[parent].parent;
-    } while (parent != board_[parent].parent);
-    // Do path compression, but only the current one to avoid recursion.
-    board_[cell].parent = parent;
-  }
-  return parent;
+std::unique_ptr<State> YState::Clone() const {
+  return std::unique_ptr<State>(new YState(*this));
 }
 
-bool YState::JoinGroups(int cell_a, int cell_b) {
-  int leader_a = FindGroupLeader(cell_a);
-  int leader_b = FindGroupLeader(cell_b);
-
-  if (leader_a == leader_b)  // Already the same group.
-    return true;
-
-  if (board_[leader_a].size < board_[leader_b].size) {
-    // Force group a's subtree to be bigger.
-    std::swap(leader_a, leader_b);
+bool YState::CopyFrom(const State& other) {
+  const auto& state = static_cast<const YState&>(other);
+  if (board_size_ != state.board_size_ ||
+      ansi_color_output_ != state.ansi_color_output_) {
+    return false;
   }
-
-  // Group b joins group a.
-  board_[leader_b].parent = leader_a;
-  board_[leader_a].size += board_[leader_b].size;
-  board_[leader_a].edge |= board_[leader_b].edge;
-
-  return false;
-}
-
-std::unique_ptr<State> YState::Clone() const {
-  return std::unique_ptr<State>(new YState(*this));
+  State::operator=(state);
+  board_ = state.board_;
+  groups_ = state.groups_;
+  current_player_ = state.current_player_;
+  outcome_ = state.outcome_;
+  moves_made_ = state.moves_made_;
+  last_move_ = state.last_move_;
+  return true;
 }
 
 YGame::YGame(const GameParameters& params)
@@ -23,6 +23,7 @@
 #include <vector>
 
 #include "open_spiel/spiel.h"
+#include "open_spiel/utils/union_find.h"
 
 // https://en.wikipedia.org/wiki/Y_(game)
 // Does not implement pie rule to balance the game
@@ -53,7 +54,7 @@ enum MoveSpecial {
   kMoveOffset = -3,
 };
 
-int CalcXY(int x, int y, int board_size) {
+inline int CalcXY(int x, int y, int board_size) {
   if (x >= 0 && y >= 0 && x < board_size && y < board_size &&
       (x + y < board_size)) {
     return x + y * board_size;
@@ -91,30 +92,6 @@ typedef std::vector<std::array<Move, kMaxNeighbors>> NeighborList;
 
 // State of an in-play game.
 class YState : public State {
-  // Represents a single cell on the board, as well as the structures needed for
-  // groups of cells. Groups of cells are defined by a union-find structure
-  // embedded in the array of cells. Following the `parent` indices will lead to
-  // the group leader which has the up to date size and edge
-  // connectivity of that group. Size and edge are not valid for any
-  // cell that is not a group leader.
-  struct Cell {
-    // Who controls this cell.
-    YPlayer player;
-
-    // A parent index to allow finding the group leader. It is the leader of the
-    // group if it points to itself. Allows path compression to shorten the path
-    // from a direct parent to the leader.
-    uint16_t parent;
-
-    // These three are only defined for the group leader's cell.
-    uint16_t size;  // Size of this group of cells.
-    uint8_t edge;   // A bitset of which edges this group is connected to.
-
-    Cell() {}
-    Cell(YPlayer player_, int parent_, int edge_)
-        : player(player_), parent(parent_), size(1), edge(edge_) {}
-  };
-
  public:
   YState(std::shared_ptr<const Game> game, int board_size,
          bool ansi_color_output = false);
@@ -136,23 +113,26 @@ class YState : public State {
   void ObservationTensor(Player player,
                          std::vector<double>* values) const override;
   std::unique_ptr<State> Clone() const override;
+  bool CopyFrom(const State& other) override;
   std::vector<Action> LegalActions() const override;
+  void LegalActions(std::vector<Action>* actions) const override;
+  Action SampleRandomLegalAction(absl::BitGenRef rng) const override;
+
+  // The returns of the game if the empty cells were played in a random order.
+  // Filling the board cannot change who connects the three edges, so this is
+  // a random playout which only looks for the winner once, at the end.
+  std::vector<double> RandomFillReturns(absl::BitGenRef rng) const;
 
  protected:
   void DoApplyAction(Action action) override;
 
-  // Find the leader of the group. Not const due to union-find path compression.
-  int FindGroupLeader(int cell);
-
-  // Join the groups of two positions, propagating group size, and edge
-  // connections. Returns true if they were already the same group.
-  bool JoinGroups(int cell_a, int cell_b);
-
   // Turn an action id into a `Move` with an x,y.
   Move ActionToMove(Action action_id) const;
 
  private:
-  std::vector<Cell> board_;
+  std::vector<YPlayer> board_;
+  // The groups of stones, with the bitset of the edges they touch.
+  UnionFind groups_;
   YPlayer current_player_ = kPlayer1;
   YPlayer outcome_ = kPlayerNone;
   const int board_size_;
@@ -12,6 +12,14 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include "open_spiel/games/y.h"
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/random/distributions.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
 #include "open_spiel/tests/basic_tests.h"
@@ -43,8 +51,39 @@ void BasicYTests() {
                          3);
 }
 
+void RandomFillTest() {
+  std::mt19937 rng(42);
+  std::shared_ptr<const Game> game = LoadGame("y(board_size=9)");
+  for (int i = 0; i < 20; ++i) {
+    std::unique_ptr<State> state = game->NewInitialState();
+    while (true) {
+      const auto& y_state = static_cast<const YState&>(*state);
+      const std::vector<double> returns = y_state.RandomFillReturns(rng);
+      if (state->IsTerminal()) {
+        SPIEL_CHECK_EQ(returns, state->Returns());
+        break;
+      }
+      SPIEL_CHECK_EQ(std::abs(returns[0]), 1);
+      SPIEL_CHECK_EQ(returns[0], -returns[1]);
+      std::vector<Action> actions = state->LegalActions();
+      state->ApplyAction(actions[absl::Uniform<int>(rng, 0, actions.size())]);
+    }
+  }
+
+  // On a board of 3 cells, the first stone wins with either of the others.
+  std::unique_ptr<State> state = LoadGame("y(board_size=2)")->NewInitialState();
+  state->ApplyAction(0);
+  for (int i = 0; i < 10; ++i) {
+    SPIEL_CHECK_EQ(static_cast<const YState&>(*state).RandomFillReturns(rng),
+                   (std::vector<double>{1, -1}));
+  }
+}
+
 }  // namespace
 }  // namespace y_game
 }  // namespace open_spiel
 
-int main(int argc, char** argv) { open_spiel::y_game::BasicYTests(); }
+int main(int argc, char** argv) {
+  open_spiel::y_game::BasicYTests();
+  open_spiel::y_game::RandomFillTest();
+}
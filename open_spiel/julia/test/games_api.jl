@@ -64,6 +64,34 @@ end
     @test history(state) == history(state2)
 end
 
+@testset "in-place tensors" begin
+    game = load_game("tic_tac_toe")
+    state = new_initial_state(game)
+    apply_action(state, 4)
+    obs = zeros(Float32, observation_tensor_size(game))
+    observation_tensor!(state, 1, obs)
+    @test obs == observation_tensor(state, 1)
+    mask = zeros(UInt8, num_distinct_actions(game))
+    legal_actions_mask!(state, 1, mask)
+    @test mask == legal_actions_mask(state, 1)
+    actions = zeros(Int, num_distinct_actions(game))
+    n = legal_actions!(state, 1, actions)
+    @test actions[1:n] == legal_actions(state, 1)
+end
+
+@testset "VectorState" begin
+    game = load_game("tic_tac_toe")
+    vec = VectorState(game, 4, 0, 2)
+    obs = zeros(Float32, observation_tensors_size(vec))
+    observation_tensors!(vec, obs)
+    @test obs[1:observation_tensor_size(game)] == observation_tensor(get_state(vec, 0), 0)
+    step!(vec, [0, 1, 2, 3])
+    @test history(get_state(vec, 3)) == [3]
+    dones = ones(Float32, 4)
+    dones!(vec, dones)
+    @test dones == zeros(Float32, 4)
+end
+
 @testset "Matrixrame" begin
     matrix_blotto = load_matrix_game("blotto")
     @test num_rows(matrix_blotto) == 66
@@ -12,8 +12,14 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "jlcxx/array.hpp"
 #include "jlcxx/jlcxx.hpp"
 #include "jlcxx/stl.hpp"
+#include "open_spiel/abseil-cpp/absl/types/span.h"
 #include "open_spiel/algorithms/best_response.h"
 #include "open_spiel/algorithms/cfr.h"
 #include "open_spiel/algorithms/cfr_br.h"
@@ -31,6 +37,7 @@
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_bots.h"
 #include "open_spiel/spiel_utils.h"
+#include "open_spiel/vector_state.h"
 
 namespace jlcxx {
 template <>
@@ -113,6 +120,30 @@ struct jlcxx::julia_type_factory<std::pair<K, V>> {
   }
 };
 
+namespace {
+
+// The contents of a Julia array as a span, for the methods ending in "!",
+// which fill arrays allocated on the Julia side instead of returning copies.
+// The array must have exactly `size` elements.
+template <typename T>
+absl::Span<T> MutableSpan(jlcxx::ArrayRef<T> array, int size) {
+  SPIEL_CHECK_EQ(array.size(), size);
+  return absl::Span<T>(array.data(), array.size());
+}
+
+template <typename T>
+void FillLegalActionsMask(const open_spiel::State& state,
+                          open_spiel::Player player,
+                          jlcxx::ArrayRef<T> array) {
+  absl::Span<T> mask = MutableSpan(array, state.NumDistinctActions());
+  std::fill(mask.begin(), mask.end(), T{0});
+  for (open_spiel::Action action : state.LegalActions(player)) {
+    mask[action] = T{1};
+  }
+}
+
+}  // namespace
+
 JLCXX_MODULE define_julia_module(jlcxx::Module& mod) {
   jlcxx::stl::apply_stl<std::pair<open_spiel::Action, double>>(mod);
   jlcxx::stl::apply_stl<std::vector<std::pair<open_spiel::Action, double>>>(
@@ -357,7 +388,57 @@ JLCXX_MODULE define_julia_module(jlcxx::Module& mod) {
       .method("num_players", &open_spiel::State::NumPlayers)
       .method("chance_outcomes", &open_spiel::State::ChanceOutcomes)
       .method("get_type", &open_spiel::State::GetType)
-      .method("serialize", &open_spiel::State::Serialize);
+      .method("serialize", &open_spiel::State::Serialize)
+      // In-place versions of the above, filling preallocated arrays.
+      .method("legal_actions!",
+              [](open_spiel::State& s, open_spiel::Player p,
+                 jlcxx::ArrayRef<open_spiel::Action> out) {
+                // Writes the actions at the start of out, which must hold
+                // num_distinct_actions elements, and returns their number.
+                absl::Span<open_spiel::Action> actions =
+                    MutableSpan(out, s.NumDistinctActions());
+                const std::vector<open_spiel::Action> legal_actions =
+                    s.LegalActions(p);
+                std::copy(legal_actions.begin(), legal_actions.end(),
+                          actions.begin());
+                return static_cast<int>(legal_actions.size());
+              })
+      .method("legal_actions_mask!",
+              [](open_spiel::State& s, open_spiel::Player p,
+                 jlcxx::ArrayRef<float> out) {
+                FillLegalActionsMask(s, p, out);
+              })
+      .method("legal_actions_mask!",
+              [](open_spiel::State& s, open_spiel::Player p,
+                 jlcxx::ArrayRef<uint8_t> out) {
+                FillLegalActionsMask(s, p, out);
+              })
+      .method("information_state_tensor!",
+              [](open_spiel::State& s, open_spiel::Player p,
+                 jlcxx::ArrayRef<float> out) {
+                s.InformationStateTensor(
+                    p, MutableSpan(out,
+                                   s.GetGame()->InformationStateTensorSize()));
+              })
+      .method("information_state_tensor!",
+              [](open_spiel::State& s, open_spiel::Player p,
+                 jlcxx::ArrayRef<uint8_t> out) {
+                s.InformationStateTensor(
+                    p, MutableSpan(out,
+                                   s.GetGame()->InformationStateTensorSize()));
+              })
+      .method("observation_tensor!",
+              [](open_spiel::State& s, open_spiel::Player p,
+                 jlcxx::ArrayRef<float> out) {
+                s.ObservationTensor(
+                    p, MutableSpan(out, s.GetGame()->ObservationTensorSize()));
+              })
+      .method("observation_tensor!",
+              [](open_spiel::State& s, open_spiel::Player p,
+                 jlcxx::ArrayRef<uint8_t> out) {
+                s.ObservationTensor(
+                    p, MutableSpan(out, s.GetGame()->ObservationTensorSize()));
+              });
 
   mod.add_type<open_spiel::Game>("Game")
       .method("num_distinct_actions", &open_spiel::Game::NumDistinctActions)
@@ -381,6 +462,50 @@ JLCXX_MODULE define_julia_module(jlcxx::Module& mod) {
       .method("max_game_length", &open_spiel::Game::MaxGameLength)
       .method("to_string", &open_spiel::Game::ToString);
 
+  // Steps a batch of states in lockstep; see vector_state.h. The outputs are
+  // written into preallocated Float32 arrays, in the layout documented there.
+  mod.add_type<open_spiel::VectorState>("VectorState")
+      .constructor([](const open_spiel::Game& game, int num_states, int seed,
+                      int num_threads) {
+        return new open_spiel::VectorState(game.shared_from_this(), num_states,
+                                           seed, num_threads);
+      })
+      .method("num_states", &open_spiel::VectorState::NumStates)
+      .method("num_players", &open_spiel::VectorState::NumPlayers)
+      .method("actions_per_state", &open_spiel::VectorState::ActionsPerState)
+      .method("observation_tensors_size",
+              &open_spiel::VectorState::ObservationTensorsSize)
+      .method("legal_actions_masks_size",
+              &open_spiel::VectorState::LegalActionsMasksSize)
+      .method("get_state",
+              [](const open_spiel::VectorState& v, int index) {
+                return v.GetState(index).Clone();
+              })
+      .method("reset!", &open_spiel::VectorState::Reset)
+      .method("step!",
+              [](open_spiel::VectorState& v,
+                 jlcxx::ArrayRef<open_spiel::Action> actions) {
+                v.Step(absl::MakeConstSpan(actions.data(), actions.size()));
+              })
+      .method("rewards!",
+              [](const open_spiel::VectorState& v, jlcxx::ArrayRef<float> out) {
+                v.Rewards(MutableSpan(out, v.RewardsSize()));
+              })
+      .method("dones!",
+              [](const open_spiel::VectorState& v, jlcxx::ArrayRef<float> out) {
+                v.Dones(MutableSpan(out, v.DonesSize()));
+              })
+      .method("observation_tensors!",
+              [](const open_spiel::VectorState& v, jlcxx::ArrayRef<float> out) {
+                v.ObservationTensors(
+                    MutableSpan(out, v.ObservationTensorsSize()));
+              })
+      .method("legal_actions_masks!",
+              [](const open_spiel::VectorState& v, jlcxx::ArrayRef<float> out) {
+                v.LegalActionsMasks(
+                    MutableSpan(out, v.LegalActionsMasksSize()));
+              });
+
   mod.add_type<open_spiel::SimMoveGame>("SimMoveGame");
   mod.add_type<open_spiel::NormalFormGame>("NormalFormGame");
 
@@ -431,8 +556,9 @@ JLCXX_MODULE define_julia_module(jlcxx::Module& mod) {
                return open_spiel::LoadGameAsTurnBased(s, ps);
              });
   mod.method("load_matrix_game", &open_spiel::algorithms::LoadMatrixGame);
-  mod.method("extensive_to_matrix_game",
-             &open_spiel::algorithms::ExtensiveToMatrixGame);
+  mod.method("extensive_to_matrix_game", [](const open_spiel::Game& game) {
+    return open_spiel::algorithms::ExtensiveToMatrixGame(game);
+  });
   mod.method("registered_names", &open_spiel::GameRegisterer::RegisteredNames);
   mod.method("registered_games", &open_spiel::GameRegisterer::RegisteredGames);
 
@@ -556,21 +682,27 @@ JLCXX_MODULE define_julia_module(jlcxx::Module& mod) {
       .method("children_str", &open_spiel::algorithms::SearchNode::ChildrenStr)
       // TODO(author11): https://github.com/JuliaInterop/CxxWrap.jl/issues/90
       .method("get_action",
-              [](open_spiel::algorithms::SearchNode& sn) { return sn.action; })
+              [](open_spiel::algorithms::SearchNode& sn) {
+                return static_cast<open_spiel::Action>(sn.action);
+              })
       .method("get_prior",
-              [](open_spiel::algorithms::SearchNode& sn) { return sn.prior; })
+              [](open_spiel::algorithms::SearchNode& sn) {
+                return static_cast<double>(sn.prior);
+              })
       .method("get_player",
               [](open_spiel::algorithms::SearchNode& sn) { return sn.player; })
       .method("get_explore_count",
               [](open_spiel::algorithms::SearchNode& sn) {
-                return sn.explore_count;
+                return sn.explore_count.load();
               })
       .method("get_total_reward",
               [](open_spiel::algorithms::SearchNode& sn) {
-                return sn.total_reward;
+                return sn.total_reward.load();
               })
       .method("get_outcome",
-              [](open_spiel::algorithms::SearchNode& sn) { return sn.outcome; })
+              [](open_spiel::algorithms::SearchNode& sn) {
+                return sn.outcome.ToVector();
+              })
       .method("set_action!",
               [](open_spiel::algorithms::SearchNode& sn,
                  open_spiel::Action action) { sn.action = action; })
@@ -594,12 +726,13 @@ JLCXX_MODULE define_julia_module(jlcxx::Module& mod) {
   jlcxx::stl::apply_stl<open_spiel::algorithms::SearchNode>(mod);
 
   mod.method("get_children", [](open_spiel::algorithms::SearchNode& sn) {
-    return sn.children;
+    return std::vector<open_spiel::algorithms::SearchNode>(sn.children.begin(),
+                                                           sn.children.end());
   });
   mod.method("set_children!",
              [](open_spiel::algorithms::SearchNode& sn,
                 std::vector<open_spiel::algorithms::SearchNode> children) {
-               sn.children = children;
+               sn.children.assign(children.begin(), children.end());
              });
 
   mod.add_type<open_spiel::algorithms::MCTSBot>(
@@ -614,7 +747,27 @@ JLCXX_MODULE define_julia_module(jlcxx::Module& mod) {
       .method("step", &open_spiel::algorithms::MCTSBot::Step)
       .method("step_with_policy",
               &open_spiel::algorithms::MCTSBot::StepWithPolicy)
-      .method("mcts_search", &open_spiel::algorithms::MCTSBot::MCTSearch);
+      .method("mcts_search", &open_spiel::algorithms::MCTSBot::MCTSearch)
+      // Searches the state, and writes the visit counts of the actions of the
+      // root, normalized, into an array of num_distinct_actions elements,
+      // e.g. as the policy target of an AlphaZero-style learner.
+      .method("mcts_policy!",
+              [](open_spiel::algorithms::MCTSBot& bot,
+                 const open_spiel::State& state, jlcxx::ArrayRef<float> out) {
+                absl::Span<float> policy =
+                    MutableSpan(out, state.NumDistinctActions());
+                std::fill(policy.begin(), policy.end(), 0);
+                const std::unique_ptr<open_spiel::algorithms::SearchNode>
+                    root = bot.MCTSearch(state);
+                int total = 0;
+                for (const auto& child : root->children) {
+                  policy[child.action] = child.explore_count;
+                  total += child.explore_count;
+                }
+                if (total > 0) {
+                  for (float& p : policy) p /= total;
+                }
+              });
 
   jlcxx::stl::apply_stl<open_spiel::algorithms::MCTSBot*>(mod);
 
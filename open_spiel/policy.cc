@@ -14,6 +14,8 @@
 
 #include "open_spiel/policy.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <iterator>
 #include <list>
 #include <memory>
@@ -24,10 +26,17 @@
 #include <vector>
 
 #include "open_spiel/abseil-cpp/absl/algorithm/container.h"
+#include "open_spiel/abseil-cpp/absl/strings/string_view.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
 
 namespace open_spiel {
+namespace {
+
+// The size of the blocks holding the keys of a CompactTabularPolicy.
+constexpr int64_t kKeyBlockSize = 1 << 20;
+
+}  // namespace
 
 double GetProb(const ActionsAndProbs& action_and_probs, Action action) {
   auto it = absl::c_find_if(action_and_probs,
@@ -170,4 +179,127 @@ TabularPolicy GetFirstActionPolicy(const Game& game) {
   return TabularPolicy(policy);
 }
 
+CompactTabularPolicy::CompactTabularPolicy(bool single_precision)
+    : single_precision_(single_precision), action_offsets_({0}) {}
+
+CompactTabularPolicy::CompactTabularPolicy(const TabularPolicy& policy,
+                                           bool single_precision)
+    : CompactTabularPolicy(single_precision) {
+  std::vector<const std::pair<const std::string, ActionsAndProbs>*> entries;
+  entries.reserve(policy.PolicyTable().size());
+  for (const auto& entry : policy.PolicyTable()) entries.push_back(&entry);
+  std::sort(entries.begin(), entries.end(),
+            [](const auto* a, const auto* b) { return a->first < b->first; });
+  index_.reserve(entries.size());
+  std::vector<Action> actions;
+  std::vector<double> probs;
+  for (const auto* entry : entries) {
+    actions.clear();
+    probs.clear();
+    for (const auto& [action, prob] : entry->second) {
+      actions.push_back(action);
+      probs.push_back(prob);
+    }
+    Add(entry->first, actions, probs);
+  }
+  action_list_index_.clear();
+}
+
+CompactTabularPolicy::CompactTabularPolicy(const Game& game,
+                                           const Policy& policy,
+                                           bool single_precision)
+    : CompactTabularPolicy(single_precision) {
+  if (game.GetType().dynamics != GameType::Dynamics::kSequential) {
+    SpielFatalError("Game is not sequential.");
+  }
+  std::vector<std::unique_ptr<State>> to_visit;
+  to_visit.push_back(game.NewInitialState());
+  std::vector<double> probs;
+  while (!to_visit.empty()) {
+    std::unique_ptr<State> state = std::move(to_visit.back());
+    to_visit.pop_back();
+    if (state->IsTerminal()) continue;
+    if (state->IsChanceNode()) {
+      for (const auto& [outcome, prob] : state->ChanceOutcomes()) {
+        to_visit.push_back(state->Child(outcome));
+      }
+      continue;
+    }
+    const std::vector<Action> legal_actions = state->LegalActions();
+    const std::string info_state = state->InformationStateString();
+    if (Index(info_state) < 0) {
+      const ActionsAndProbs state_policy = policy.GetStatePolicy(*state);
+      probs.clear();
+      for (Action action : legal_actions) {
+        probs.push_back(std::max(0., GetProb(state_policy, action)));
+      }
+      Add(info_state, legal_actions, probs);
+    }
+    for (Action action : legal_actions) {
+      to_visit.push_back(state->Child(action));
+    }
+  }
+  action_list_index_.clear();
+}
+
+void CompactTabularPolicy::Add(absl::string_view info_state,
+                               const std::vector<Action>& actions,
+                               const std::vector<double>& probs) {
+  SPIEL_CHECK_EQ(actions.size(), probs.size());
+  if (key_block_free_ < info_state.size()) {
+    const int64_t size = std::max<int64_t>(kKeyBlockSize, info_state.size());
+    key_blocks_.push_back(std::make_unique<char[]>(size));
+    key_block_next_ = key_blocks_.back().get();
+    key_block_free_ = size;
+    key_bytes_ += size;
+  }
+  std::copy(info_state.begin(), info_state.end(), key_block_next_);
+  const absl::string_view key(key_block_next_, info_state.size());
+  key_block_next_ += info_state.size();
+  key_block_free_ -= info_state.size();
+  SPIEL_CHECK_TRUE(index_.emplace(key, keys_.size()).second);
+  keys_.push_back(key);
+
+  auto [it, inserted] =
+      action_list_index_.emplace(actions, action_offsets_.size() - 1);
+  if (inserted) {
+    actions_.insert(actions_.end(), actions.begin(), actions.end());
+    action_offsets_.push_back(actions_.size());
+  }
+  action_lists_.push_back(it->second);
+
+  if (single_precision_) {
+    prob_offsets_.push_back(probs32_.size());
+    probs32_.insert(probs32_.end(), probs.begin(), probs.end());
+  } else {
+    prob_offsets_.push_back(probs64_.size());
+    probs64_.insert(probs64_.end(), probs.begin(), probs.end());
+  }
+}
+
+ActionsAndProbs CompactTabularPolicy::GetStatePolicy(
+    const std::string& info_state) const {
+  const int index = Index(info_state);
+  if (index < 0) return {};
+  absl::Span<const Action> actions = Actions(index);
+  ActionsAndProbs state_policy;
+  state_policy.reserve(actions.size());
+  for (int i = 0; i < actions.size(); ++i) {
+    state_policy.push_back({actions[i], Prob(index, i)});
+  }
+  return state_policy;
+}
+
+int64_t CompactTabularPolicy::MemoryBytes() const {
+  return key_bytes_ + keys_.capacity() * sizeof(absl::string_view) +
+         index_.capacity() *
+             (sizeof(std::pair<absl::string_view, int>) + 1) +
+         actions_.capacity() * sizeof(Action) +
+         (action_offsets_.capacity() + action_lists_.capacity()) *
+             sizeof(int) +
+         prob_offsets_.capacity() * sizeof(int64_t) +
+         probs32_.capacity() * sizeof(float) +
+         probs64_.capacity() * sizeof(double);
+}
+
 }  // namespace open_spiel
@@ -15,13 +15,18 @@
 #ifndef OPEN_SPIEL_POLICY_H_
 #define OPEN_SPIEL_POLICY_H_
 
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "open_spiel/abseil-cpp/absl/algorithm/container.h"
+#include "open_spiel/abseil-cpp/absl/container/flat_hash_map.h"
 #include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/abseil-cpp/absl/strings/string_view.h"
+#include "open_spiel/abseil-cpp/absl/types/span.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
 
@@ -158,6 +163,93 @@ class TabularPolicy : public Policy {
   std::unordered_map<std::string, ActionsAndProbs> policy_table_;
 };
 
+// A read-only tabular policy laid out for large tables, e.g. the average
+// policies of CFR and MCCFR. Rather than a map node with a string key and a
+// vector of (action, prob) pairs per information state, it holds:
+//   - the keys back to back in large blocks, indexed by a flat hash map of
+//     views into them,
+//   - one contiguous array of probabilities, optionally single precision, and
+//     the offset of each information state's in it,
+//   - the actions of each information state as an index into the distinct
+//     lists of actions, which most games only have a few of. The probabilities
+//     are in the order of the list, that of the legal actions.
+// Lookups are safe to make concurrently. It is movable but not copyable.
+class CompactTabularPolicy : public Policy {
+ public:
+  // Converts the table, taking the information states in sorted order.
+  explicit CompactTabularPolicy(const TabularPolicy& policy,
+                                bool single_precision = false);
+
+  // Converts any policy of a sequential game, visiting each information state
+  // once in a depth-first traversal, without building an intermediate table.
+  // The probabilities are those of the legal actions, 0 for those the policy
+  // does not return.
+  CompactTabularPolicy(const Game& game, const Policy& policy,
+                       bool single_precision = false);
+
+  CompactTabularPolicy(CompactTabularPolicy&&) = default;
+  CompactTabularPolicy& operator=(CompactTabularPolicy&&) = default;
+
+  ActionsAndProbs GetStatePolicy(const std::string& info_state) const override;
+
+  int NumInfoStates() const { return keys_.size(); }
+  bool SinglePrecision() const { return single_precision_; }
+
+  // Returns the index of the information state, or -1 if it is not in the
+  // table.
+  int Index(absl::string_view info_state) const {
+    auto it = index_.find(info_state);
+    return it == index_.end() ? -1 : it->second;
+  }
+
+  // The information state, actions and probabilities of each index.
+  absl::string_view InfoState(int index) const { return keys_[index]; }
+  absl::Span<const Action> Actions(int index) const {
+    const int list = action_lists_[index];
+    return absl::MakeConstSpan(
+        actions_.data() + action_offsets_[list],
+        action_offsets_[list + 1] - action_offsets_[list]);
+  }
+  double Prob(int index, int action_index) const {
+    const int64_t i = prob_offsets_[index] + action_index;
+    return single_precision_ ? probs32_[i] : probs64_[i];
+  }
+
+  // The bytes taken by the table, including the hash map of the keys.
+  int64_t MemoryBytes() const;
+
+ private:
+  explicit CompactTabularPolicy(bool single_precision);
+
+  // Appends an information state which is not in the table yet, its actions
+  // and their probabilities.
+  void Add(absl::string_view info_state, const std::vector<Action>& actions,
+           const std::vector<double>& probs);
+
+  bool single_precision_;
+
+  // The keys are copied to blocks which are never reallocated, so the views
+  // stay valid as the table grows or is moved.
+  std::vector<std::unique_ptr<char[]>> key_blocks_;
+  char* key_block_next_ = nullptr;
+  int64_t key_block_free_ = 0;
+  int64_t key_bytes_ = 0;
+  std::vector<absl::string_view> keys_;
+  absl::flat_hash_map<absl::string_view, int> index_;
+
+  // The distinct lists of actions, back to back, and the list of each
+  // information state.
+  std::vector<Action> actions_;
+  std::vector<int> action_offsets_;
+  std::vector<int> action_lists_;
+  // The position of each list, only kept while adding.
+  absl::flat_hash_map<std::vector<Action>, int> action_list_index_;
+
+  std::vector<int64_t> prob_offsets_;
+  std::vector<float> probs32_;
+  std::vector<double> probs64_;
+};
+
 // Chooses all legal actions with equal probability. This is equivalent to the
 // tabular version, except that this works for large games.
 class UniformPolicy : public Policy {
@@ -0,0 +1,157 @@
+# Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+# Lint as: python3
+"""Reports the speed and accuracy of a lower precision ONNX model.
+
+Compares the float16 or int8 copy of a checkpoint's model, as OnnxBackend runs
+it, with the float32 one:
+  - the inference time of batches of several sizes, on the CPU,
+  - how far the values and policies are from those of the float model, on the
+    states of random games,
+  - the results of games between MCTS bots using each, with the same number of
+    simulations.
+
+The models are exported with export_onnx.py if missing.
+"""
+
+import time
+
+from absl import app
+from absl import flags
+import numpy as np
+
+from open_spiel.python.algorithms import mcts
+from open_spiel.python.algorithms.alpha_zero import evaluator as evaluator_lib
+from open_spiel.python.algorithms.alpha_zero import export_onnx
+from open_spiel.python.algorithms.alpha_zero import onnx_quantization
+import pyspiel
+
+FLAGS = flags.FLAGS
+flags.DEFINE_string("checkpoint", None, "Path of the checkpoint to compare.")
+flags.DEFINE_string("game", None, "The game the checkpoint was trained on.")
+flags.DEFINE_enum("precision", "int8", ["float16", "int8"],
+                  "The precision to compare with float32.")
+flags.DEFINE_string("calibration", None,
+                    "Observations for the int8 model, as for export_onnx.py.")
+flags.DEFINE_list("batch_sizes", ["1", "8", "32"],
+                  "The batch sizes to time inference at.")
+flags.DEFINE_integer("num_states", 1000,
+                     "How many states of random games to compare outputs on.")
+flags.DEFINE_integer("num_games", 20, "How many games the MCTS bots play.")
+flags.DEFINE_integer("max_simulations", 100, "Simulations per MCTS move.")
+flags.DEFINE_float("uct_c", 2, "UCT exploration constant.")
+flags.DEFINE_integer("seed", 0, "Seed of the random games and bots.")
+flags.mark_flag_as_required("checkpoint")
+flags.mark_flag_as_required("game")
+
+
+class OnnxModel(object):
+  """Runs an ONNX model on the CPU, with the interface of model.Model."""
+
+  def __init__(self, filename):
+    import onnxruntime  # pylint: disable=g-import-not-at-top
+    self._session = onnxruntime.InferenceSession(
+        filename, providers=["CPUExecutionProvider"])
+
+  def inference(self, observation, legals_mask):
+    policy, value = self._session.run(
+        ["policy_softmax:0", "value_out:0"],
+        onnx_quantization.inference_feed(observation, legals_mask))
+    return value, policy
+
+
+def random_states(game, num_states, rng):
+  """Observations and legal masks of the states of random games."""
+  observations = []
+  masks = []
+  while len(observations) < num_states:
+    state = game.new_initial_state()
+    while not state.is_terminal() and len(observations) < num_states:
+      observations.append(state.observation_tensor())
+      masks.append(state.legal_actions_mask())
+      state.apply_action(rng.choice(state.legal_actions()))
+  return np.array(observations), np.array(masks, dtype=np.bool)
+
+
+def time_inference(model, observations, masks, batch_size, repeats=20):
+  """The median time of a batch, in milliseconds."""
+  batch = (observations[:batch_size], masks[:batch_size])
+  model.inference(*batch)  # Warm up.
+  times = []
+  for _ in range(repeats):
+    start = time.perf_counter()
+    model.inference(*batch)
+    times.append(time.perf_counter() - start)
+  return 1000 * np.median(times)
+
+
+def play_games(game, models, num_games, rng):
+  """Plays MCTS bots using each model, returns the scores of the second."""
+  scores = []
+  for game_num in range(num_games):
+    # The bots swap seats every game.
+    order = [0, 1] if game_num % 2 == 0 else [1, 0]
+    bots = [
+        mcts.MCTSBot(
+            game, FLAGS.uct_c, FLAGS.max_simulations,
+            evaluator_lib.AlphaZeroEvaluator(game, models[i]),
+            solve=False, random_state=np.random.RandomState(rng.randint(2**31)),
+            child_selection_fn=mcts.SearchNode.puct_value)
+        for i in order]
+    state = game.new_initial_state()
+    while not state.is_terminal():
+      state.apply_action(bots[state.current_player()].step(state))
+    scores.append(state.returns()[order.index(1)])
+  return np.array(scores)
+
+
+def main(_):
+  game = pyspiel.load_game(FLAGS.game)
+  rng = np.random.RandomState(FLAGS.seed)
+  filenames = [
+      export_onnx.export(FLAGS.checkpoint),
+      export_onnx.export(FLAGS.checkpoint, FLAGS.precision, FLAGS.calibration)]
+  models = [OnnxModel(f) for f in filenames]
+  observations, masks = random_states(game, FLAGS.num_states, rng)
+
+  print("Inference time (ms)  float32  {}  speedup".format(FLAGS.precision))
+  for batch_size in map(int, FLAGS.batch_sizes):
+    times = [time_inference(m, observations, masks, batch_size)
+             for m in models]
+    print("  batch {:<12} {:8.3f} {:8.3f}  {:6.2f}x".format(
+        batch_size, times[0], times[1], times[0] / times[1]))
+
+  (values, policies), (low_values, low_policies) = [
+      m.inference(observations, masks) for m in models]
+  print("Accuracy on {} states:".format(len(observations)))
+  print("  value mean abs error:  {:.4f}".format(
+      np.mean(np.abs(values - low_values))))
+  print("  policy mean total variation: {:.4f}".format(
+      np.mean(0.5 * np.sum(np.abs(policies - low_policies), axis=1))))
+  print("  same most likely action: {:.1%}".format(
+      np.mean(np.argmax(policies, axis=1) == np.argmax(low_policies, axis=1))))
+
+  if FLAGS.num_games > 0:
+    scores = play_games(game, models, FLAGS.num_games, rng)
+    print("{} games at {} simulations, {} vs float32: {} wins, {} draws, "
+          "{} losses, mean score {:+.3f}".format(
+              FLAGS.num_games, FLAGS.max_simulations, FLAGS.precision,
+              np.sum(scores > 0), np.sum(scores == 0), np.sum(scores < 0),
+              np.mean(scores)))
+
+
+if __name__ == "__main__":
+  app.run(main)
@@ -0,0 +1,67 @@
+# Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Lint as: python3
+"""Export the inference part of a model checkpoint as an ONNX model."""
+
+import os
+
+from absl import app
+from absl import flags
+
+from open_spiel.python.algorithms.alpha_zero import model as model_lib
+from open_spiel.python.algorithms.alpha_zero import onnx_quantization
+
+FLAGS = flags.FLAGS
+flags.DEFINE_string("checkpoint", None, "Path of the checkpoint to export")
+flags.DEFINE_string("output", None,
+                    "Filename for the ONNX model, by default <checkpoint>.onnx, "
+                    "or <checkpoint>.fp16.onnx or <checkpoint>.int8.onnx")
+flags.DEFINE_enum("precision", "float32", ["float32", "float16", "int8"],
+                  "The precision of the weights. The lower ones are converted "
+                  "from <checkpoint>.onnx, which is also written if missing.")
+flags.DEFINE_string("calibration", None,
+                    "Observations to calibrate the int8 activations on, as "
+                    "raw float32 rows. Without them, they are quantized "
+                    "dynamically.")
+flags.mark_flag_as_required("checkpoint")
+
+SUFFIXES = {"float32": ".onnx", "float16": ".fp16.onnx", "int8": ".int8.onnx"}
+
+
+def export(checkpoint, precision="float32", calibration=None, output=None):
+  """Writes the model of the checkpoint at a precision, returns its filename."""
+  output = output or checkpoint + SUFFIXES[precision]
+  float_filename = checkpoint + SUFFIXES["float32"]
+  if precision == "float32" or not os.path.exists(float_filename):
+    model = model_lib.Model.from_checkpoint(checkpoint)
+    model.write_onnx(output if precision == "float32" else float_filename)
+  if precision == "float16":
+    onnx_quantization.to_float16(float_filename, output)
+  elif precision == "int8":
+    observations = None
+    if calibration:
+      observation_size, _ = onnx_quantization.input_sizes(float_filename)
+      observations = onnx_quantization.read_calibration(
+          calibration, observation_size)
+    onnx_quantization.to_int8(float_filename, output, observations)
+  return output
+
+
+def main(_):
+  export(FLAGS.checkpoint, FLAGS.precision, FLAGS.calibration, FLAGS.output)
+
+
+if __name__ == "__main__":
+  app.run(main)
@@ -31,6 +31,7 @@
 import collections
 import functools
 import os
+import tempfile
 from typing import Sequence
 
 import numpy as np
@@ -321,6 +322,22 @@ class Model(object):
     with tf.control_dependencies(bn_updates):
       train = optimizer.minimize(total_loss, name="train")
 
+    # For data parallel training from C++, which computes the gradients of
+    # each shard of a batch on its own device, and applies their average on
+    # all of them. The gradients of all the variables are flattened into one.
+    with tf.control_dependencies(bn_updates):
+      grads_and_vars = [(g, v) for g, v in optimizer.compute_gradients(
+          total_loss) if g is not None]
+      tf.concat([tf.reshape(g, [-1]) for g, _ in grads_and_vars], 0,
+                name="flat_gradients")
+    sizes = [int(np.prod(v.shape)) for _, v in grads_and_vars]
+    flat_gradients_input = tf.placeholder(
+        tf.float32, [sum(sizes)], name="flat_gradients_input")
+    optimizer.apply_gradients(
+        [(tf.reshape(g, v.shape), v) for g, (_, v) in zip(
+            tf.split(flat_gradients_input, sizes), grads_and_vars)],
+        name="apply_flat_gradients")
+
   @property
   def num_trainable_variables(self):
     return sum(np.prod(v.shape) for v in tf.trainable_variables())
@@ -336,6 +353,23 @@ class Model(object):
         filename=full_path, as_text=False)
     return full_path
 
+  def write_onnx(self, filename):
+    """Write the inference part of the graph, with its weights, as ONNX."""
+    import tf2onnx  # pylint: disable=g-import-not-at-top
+    graph_def = tf.graph_util.convert_variables_to_constants(
+        self._session, self._session.graph_def,
+        ["policy_softmax", "value_out"])
+    # Written aside and renamed, so that readers never see a partial model.
+    fd, tmp_filename = tempfile.mkstemp(
+        suffix=".onnx.tmp", dir=os.path.dirname(os.path.abspath(filename)))
+    os.close(fd)
+    tf2onnx.convert.from_graph_def(
+        graph_def, input_names=["input:0", "legals_mask:0", "training:0"],
+        output_names=["policy_softmax:0", "value_out:0"],
+        output_path=tmp_filename)
+    os.replace(tmp_filename, filename)
+    return filename
+
   def inference(self, observation, legals_mask):
     return self._session.run(
         [self._value_out, self._policy_softmax],
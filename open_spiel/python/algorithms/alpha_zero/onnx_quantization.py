@@ -0,0 +1,108 @@
+# Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+# Lint as: python3
+"""Lower precision copies of the ONNX models written by Model.write_onnx."""
+
+import os
+import tempfile
+
+import numpy as np
+
+# The inputs of the graph from model.py, as named by tf2onnx.
+_OBSERVATIONS = "input:0"
+_LEGALS_MASK = "legals_mask:0"
+_TRAINING = "training:0"
+
+
+def _write_atomically(filename, write):
+  """Calls write on a temporary file then renames it, like write_onnx."""
+  fd, tmp_filename = tempfile.mkstemp(
+      suffix=".onnx.tmp", dir=os.path.dirname(os.path.abspath(filename)))
+  os.close(fd)
+  write(tmp_filename)
+  os.replace(tmp_filename, filename)
+  return filename
+
+
+def input_sizes(filename):
+  """Returns the observation size and number of actions of a model."""
+  import onnx  # pylint: disable=g-import-not-at-top
+  dims = {}
+  for graph_input in onnx.load(filename).graph.input:
+    dims[graph_input.name] = graph_input.type.tensor_type.shape.dim
+  return dims[_OBSERVATIONS][1].dim_value, dims[_LEGALS_MASK][1].dim_value
+
+
+def inference_feed(observations, legals_mask):
+  """The inputs of a session run of the model, as from OnnxBackend."""
+  return {_OBSERVATIONS: np.asarray(observations, dtype=np.float32),
+          _LEGALS_MASK: np.asarray(legals_mask, dtype=np.bool),
+          _TRAINING: np.array(False)}
+
+
+def to_float16(filename, output):
+  """Converts the weights and activations to float16, not the inputs."""
+  import onnx  # pylint: disable=g-import-not-at-top
+  from onnxconverter_common import float16  # pylint: disable=g-import-not-at-top
+  model = float16.convert_float_to_float16(
+      onnx.load(filename), keep_io_types=True)
+  return _write_atomically(output, lambda f: onnx.save(model, f))
+
+
+def to_int8(filename, output, observations=None, batch_size=32):
+  """Quantizes the weights to int8, and the activations to uint8.
+
+  Args:
+    filename: The float model.
+    output: Where to write the quantized model.
+    observations: An array of observation rows the activation ranges are
+      calibrated on, with all actions legal. If None, the activations are
+      quantized dynamically, from the range of each batch.
+    batch_size: How many observations to calibrate with at once.
+
+  Returns:
+    The output filename.
+  """
+  from onnxruntime import quantization  # pylint: disable=g-import-not-at-top
+  if observations is None or not len(observations):  # pylint: disable=g-explicit-length-test
+    return _write_atomically(output, lambda f: quantization.quantize_dynamic(
+        filename, f, weight_type=quantization.QuantType.QInt8))
+
+  _, num_actions = input_sizes(filename)
+
+  class Reader(quantization.CalibrationDataReader):
+    """Feeds the observations in batches."""
+
+    def __init__(self):
+      super().__init__()
+      self._start = 0
+
+    def get_next(self):
+      if self._start >= len(observations):
+        return None
+      batch = observations[self._start:self._start + batch_size]
+      self._start += batch_size
+      return inference_feed(batch, np.ones((len(batch), num_actions), np.bool))
+
+  return _write_atomically(output, lambda f: quantization.quantize_static(
+      filename, f, Reader(), quant_format=quantization.QuantFormat.QDQ,
+      per_channel=True, activation_type=quantization.QuantType.QUInt8,
+      weight_type=quantization.QuantType.QInt8))
+
+
+def read_calibration(filename, observation_size):
+  """Reads the observations written by OnnxBackend, as raw float32 rows."""
+  return np.fromfile(filename, dtype=np.float32).reshape(-1, observation_size)
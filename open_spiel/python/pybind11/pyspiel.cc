@@ -12,18 +12,29 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <cstdint>
 #include <memory>
+#include <random>
+#include <type_traits>
 #include <unordered_map>
+#include <vector>
 
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/abseil-cpp/absl/types/span.h"
 #include "open_spiel/algorithms/best_response.h"
 #include "open_spiel/algorithms/cfr.h"
 #include "open_spiel/algorithms/cfr_br.h"
 #include "open_spiel/algorithms/deterministic_policy.h"
 #include "open_spiel/algorithms/evaluate_bots.h"
 #include "open_spiel/algorithms/expected_returns.h"
+#include "open_spiel/algorithms/external_sampling_mccfr.h"
 #include "open_spiel/algorithms/is_mcts.h"
+#include "open_spiel/algorithms/matrix_game_solvers.h"
 #include "open_spiel/algorithms/matrix_game_utils.h"
 #include "open_spiel/algorithms/mcts.h"
+#include "open_spiel/algorithms/minimax.h"
+#include "open_spiel/algorithms/policy_file.h"
 #include "open_spiel/algorithms/tabular_exploitability.h"
 #include "open_spiel/algorithms/tensor_game_utils.h"
 #include "open_spiel/algorithms/trajectories.h"
@@ -39,6 +50,8 @@
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_bots.h"
 #include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/thread.h"
+#include "open_spiel/vector_state.h"
 #include "pybind11/include/pybind11/functional.h"
 #include "pybind11/include/pybind11/numpy.h"
 #include "pybind11/include/pybind11/operators.h"
@@ -175,8 +188,164 @@ class PyBot : public Bot {
         state                // Arguments
     );
   }
+  bool ProvidesPondering() override {
+    PYBIND11_OVERLOAD_NAME(
+        bool,  // Return type (must be a simple token for macro parser)
+        Bot,   // Parent class
+        "provides_pondering",  // Name of function in Python
+        ProvidesPondering,     // Name of function in C++
+                               // Arguments
+    );
+  }
+  void StartPondering(const State& state) override {
+    PYBIND11_OVERLOAD_NAME(
+        void,  // Return type (must be a simple token for macro parser)
+        Bot,   // Parent class
+        "start_pondering",  // Name of function in Python
+        StartPondering,     // Name of function in C++
+        state               // Arguments
+    );
+  }
+  void StopPondering() override {
+    PYBIND11_OVERLOAD_NAME(
+        void,  // Return type (must be a simple token for macro parser)
+        Bot,   // Parent class
+        "stop_pondering",  // Name of function in Python
+        StopPondering,     // Name of function in C++
+                           // Arguments
+    );
+  }
 };
 
+// The contents of a NumPy array as a span, for the functions writing tensors
+// and masks in place. The array must be C-contiguous, writable, of dtype T and
+// hold exactly size elements; anything else raises an exception rather than
+// being silently copied, which would lose the writes.
+template <typename T>
+absl::Span<T> MutableSpan(py::array& array, int size) {
+  if (!py::isinstance<py::array_t<T>>(array)) {
+    SpielFatalError(absl::StrCat("Expected an array of dtype ",
+                                 std::string(py::str(py::dtype::of<T>())),
+                                 ", got ",
+                                 std::string(py::str(array.dtype()))));
+  }
+  if (!(array.flags() & py::array::c_style)) {
+    SpielFatalError("Expected a C-contiguous array.");
+  }
+  if (!array.writeable()) SpielFatalError("Expected a writable array.");
+  if (array.size() != size) {
+    SpielFatalError(absl::StrCat("Expected an array of size ", size, ", got ",
+                                 array.size()));
+  }
+  return absl::Span<T>(static_cast<T*>(array.mutable_data()), size);
+}
+
+// Writes a tensor into a float32 or uint8 array; see State::ObservationTensor.
+// Bool arrays are written as uint8, as the two have the same layout.
+template <typename Float, typename Byte>
+void WriteTensor(py::array& array, int size, Float write_float,
+                 Byte write_byte) {
+  if (py::isinstance<py::array_t<float>>(array)) {
+    write_float(MutableSpan<float>(array, size));
+  } else if (py::isinstance<py::array_t<bool>>(array)) {
+    const absl::Span<bool> values = MutableSpan<bool>(array, size);
+    write_byte(absl::Span<uint8_t>(reinterpret_cast<uint8_t*>(values.data()),
+                                   values.size()));
+  } else {
+    write_byte(MutableSpan<uint8_t>(array, size));
+  }
+}
+
+void WriteObservationTensor(const State& state, Player player,
+                            py::array& array) {
+  WriteTensor(
+      array, state.GetGame()->ObservationTensorSize(),
+      [&](absl::Span<float> values) {
+        state.ObservationTensor(player, values);
+      },
+      [&](absl::Span<uint8_t> values) {
+        state.ObservationTensor(player, values);
+      });
+}
+
+void WriteInformationStateTensor(const State& state, Player player,
+                                 py::array& array) {
+  WriteTensor(
+      array, state.GetGame()->InformationStateTensorSize(),
+      [&](absl::Span<float> values) {
+        state.InformationStateTensor(player, values);
+      },
+      [&](absl::Span<uint8_t> values) {
+        state.InformationStateTensor(player, values);
+      });
+}
+
+// Writes State::LegalActionsMask into an int32, float32, uint8 or bool array
+// of size NumDistinctActions, without building any intermediate vector.
+template <typename T>
+void FillLegalActionsMask(const State& state, Player player,
+                          absl::Span<T> mask) {
+  std::fill(mask.begin(), mask.end(), T{0});
+  for (Action action : state.LegalActions(player)) mask[action] = T{1};
+}
+
+void WriteLegalActionsMask(const State& state, Player player,
+                           py::array& array) {
+  const int size = state.NumDistinctActions();
+  if (py::isinstance<py::array_t<int32_t>>(array)) {
+    FillLegalActionsMask(state, player, MutableSpan<int32_t>(array, size));
+  } else if (py::isinstance<py::array_t<float>>(array)) {
+    FillLegalActionsMask(state, player, MutableSpan<float>(array, size));
+  } else if (py::isinstance<py::array_t<bool>>(array)) {
+    FillLegalActionsMask(state, player, MutableSpan<bool>(array, size));
+  } else {
+    FillLegalActionsMask(state, player, MutableSpan<uint8_t>(array, size));
+  }
+}
+
+// A new float32 array of the tensor's shape, written by the game directly.
+template <typename Write>
+py::array_t<float> TensorArray(const std::vector<int>& shape, Write write) {
+  py::array_t<float> array(shape);
+  write(absl::Span<float>(array.mutable_data(), array.size()));
+  return array;
+}
+
+// The non-zero entries of a tensor, as an int32 array of their indices into
+// the flattened tensor and a float32 array of their values.
+template <typename Write>
+py::tuple SparseTensorArrays(Write write) {
+  SparseTensor tensor;
+  write(&tensor);
+  return py::make_tuple(
+      py::array_t<int32_t>(tensor.indices.size(), tensor.indices.data()),
+      py::array_t<float>(tensor.values.size(), tensor.values.data()));
+}
+
+// Runs iterations of a CFR solver until num_iterations or a stop request,
+// returning the number performed. The caller releases the GIL.
+template <typename Solver>
+int RunCFRIterations(Solver* solver, int num_iterations,
+                     const StopToken* stop) {
+  int i = 0;
+  for (; i < num_iterations && (stop == nullptr || !stop->StopRequested());
+       ++i) {
+    solver->EvaluateAndUpdatePolicy();
+  }
+  return i;
+}
+
+// A new float32 array of the given shape, filled by the VectorState with the
+// GIL released, so that other Python threads run meanwhile.
+template <typename Fill>
+py::array_t<float> VectorStateArray(const std::vector<int>& shape, Fill fill) {
+  py::array_t<float> array(shape);
+  absl::Span<float> values(array.mutable_data(), array.size());
+  py::gil_scoped_release release;
+  fill(values);
+  return array;
+}
+
 // Definintion of our Python module.
 PYBIND11_MODULE(pyspiel, m) {
   m.doc() = "Open Spiel";
@@ -248,6 +417,8 @@ PYBIND11_MODULE(pyspiel, m) {
       .def_readonly("parameter_specification",
                     &GameType::parameter_specification)
       .def_readonly("default_loadable", &GameType::default_loadable)
+      .def_readonly("hash_determines_observation",
+                    &GameType::hash_determines_observation)
       .def("__repr__", [](const GameType& gt) {
         return "<GameType '" + gt.short_name + "'>";
       });
@@ -302,6 +473,11 @@ PYBIND11_MODULE(pyspiel, m) {
            (std::vector<int>(State::*)(int) const) & State::LegalActionsMask)
       .def("legal_actions_mask",
            (std::vector<int>(State::*)(void) const) & State::LegalActionsMask)
+      .def("write_legal_actions_mask", &WriteLegalActionsMask)
+      .def("write_legal_actions_mask",
+           [](const State& state, py::array& array) {
+             WriteLegalActionsMask(state, state.CurrentPlayer(), array);
+           })
       .def("action_to_string", (std::string(State::*)(Player, Action) const) &
                                    State::ActionToString)
       .def("action_to_string",
@@ -338,6 +514,72 @@ PYBIND11_MODULE(pyspiel, m) {
                                      State::ObservationTensor)
       .def("observation_tensor",
            (std::vector<double>(State::*)() const) & State::ObservationTensor)
+      .def("observation_tensor_array",
+           [](const State& state, Player player) {
+             return TensorArray(
+                 state.GetGame()->ObservationTensorShape(),
+                 [&](absl::Span<float> values) {
+                   state.ObservationTensor(player, values);
+                 });
+           })
+      .def("observation_tensor_array",
+           [](const State& state) {
+             return TensorArray(
+                 state.GetGame()->ObservationTensorShape(),
+                 [&](absl::Span<float> values) {
+                   state.ObservationTensor(state.CurrentPlayer(), values);
+                 });
+           })
+      .def("write_observation_tensor", &WriteObservationTensor)
+      .def("write_observation_tensor",
+           [](const State& state, py::array& array) {
+             WriteObservationTensor(state, state.CurrentPlayer(), array);
+           })
+      .def("observation_tensor_sparse",
+           [](const State& state, Player player) {
+             return SparseTensorArrays([&](SparseTensor* tensor) {
+               state.ObservationTensor(player, tensor);
+             });
+           })
+      .def("observation_tensor_sparse",
+           [](const State& state) {
+             return SparseTensorArrays([&](SparseTensor* tensor) {
+               state.ObservationTensor(state.CurrentPlayer(), tensor);
+             });
+           })
+      .def("information_state_tensor_array",
+           [](const State& state, Player player) {
+             return TensorArray(
+                 state.GetGame()->InformationStateTensorShape(),
+                 [&](absl::Span<float> values) {
+                   state.InformationStateTensor(player, values);
+                 });
+           })
+      .def("information_state_tensor_array",
+           [](const State& state) {
+             return TensorArray(
+                 state.GetGame()->InformationStateTensorShape(),
+                 [&](absl::Span<float> values) {
+                   state.InformationStateTensor(state.CurrentPlayer(), values);
+                 });
+           })
+      .def("write_information_state_tensor", &WriteInformationStateTensor)
+      .def("write_information_state_tensor",
+           [](const State& state, py::array& array) {
+             WriteInformationStateTensor(state, state.CurrentPlayer(), array);
+           })
+      .def("information_state_tensor_sparse",
+           [](const State& state, Player player) {
+             return SparseTensorArrays([&](SparseTensor* tensor) {
+               state.InformationStateTensor(player, tensor);
+             });
+           })
+      .def("information_state_tensor_sparse",
+           [](const State& state) {
+             return SparseTensorArrays([&](SparseTensor* tensor) {
+               state.InformationStateTensor(state.CurrentPlayer(), tensor);
+             });
+           })
       .def("clone", &State::Clone)
       .def("child", &State::Child)
       .def("undo_action", &State::UndoAction)
@@ -348,15 +590,23 @@ PYBIND11_MODULE(pyspiel, m) {
       .def("get_game", &State::GetGame)
       .def("get_type", &State::GetType)
       .def("serialize", &State::Serialize)
+      .def("serialize_binary",
+           [](const State& state) {
+             return py::bytes(state.SerializeBinary());
+           })
       .def("resample_from_infostate", &State::ResampleFromInfostate)
       .def(py::pickle(              // Pickle support
           [](const State& state) {  // __getstate__
-            return SerializeGameAndState(*state.GetGame(), state);
+            return py::bytes(
+                SerializeGameAndStateBinary(*state.GetGame(), state));
           },
-          [](const std::string& data) {  // __setstate__
-            std::pair<std::shared_ptr<const Game>, std::unique_ptr<State>>
-                game_and_state = DeserializeGameAndState(data);
-            return std::move(game_and_state.second);
+          [](const py::object& data) {  // __setstate__
+            // States pickled as text by earlier versions still load.
+            const std::string str = data.cast<std::string>();
+            if (py::isinstance<py::bytes>(data)) {
+              return std::move(DeserializeGameAndStateBinary(str).second);
+            }
+            return std::move(DeserializeGameAndState(str).second);
           }));
 
   py::class_<Game, std::shared_ptr<Game>> game(m, "Game");
@@ -378,6 +628,10 @@ PYBIND11_MODULE(pyspiel, m) {
       .def("observation_tensor_size", &Game::ObservationTensorSize)
       .def("policy_tensor_shape", &Game::PolicyTensorShape)
       .def("deserialize_state", &Game::DeserializeState)
+      .def("deserialize_state_binary",
+           [](const Game& game, const py::bytes& bytes) {
+             return game.DeserializeStateBinary(std::string(bytes));
+           })
       .def("max_game_length", &Game::MaxGameLength)
       .def("__str__", &Game::ToString)
       .def("__eq__",
@@ -392,9 +646,82 @@ PYBIND11_MODULE(pyspiel, m) {
             // Have to remove the const here for this to compile, presumably
             // because the holder type is non-const. But seems like you can't
             // set the holder type to std::shared_ptr<const Game> either.
-            return std::const_pointer_cast<Game>(LoadGame(data));
+            return std::const_pointer_cast<Game>(LoadSerializedGame(data));
           }));
 
+  // Steps a batch of states with one call, see vector_state.h. All the work in
+  // C++ runs with the GIL released, on num_threads threads.
+  py::class_<VectorState> vector_state(m, "VectorState");
+  vector_state
+      .def(py::init<std::shared_ptr<const Game>, int, int, int, bool>(),
+           py::arg("game"), py::arg("num_states"), py::arg("seed"),
+           py::arg("num_threads") = 1, py::arg("use_batched_kernel") = false)
+      .def("num_states", &VectorState::NumStates)
+      .def("num_players", &VectorState::NumPlayers)
+      .def("num_threads", &VectorState::NumThreads)
+      .def("uses_batched_kernel", &VectorState::UsesBatchedKernel)
+      .def("actions_per_state", &VectorState::ActionsPerState)
+      .def("get_state",
+           [](const VectorState& vec, int index) {
+             SPIEL_CHECK_GE(index, 0);
+             SPIEL_CHECK_LT(index, vec.NumStates());
+             return vec.GetState(index).Clone();
+           })
+      .def("reset", &VectorState::Reset,
+           py::call_guard<py::gil_scoped_release>())
+      .def("step",
+           [](VectorState& vec,
+              py::array_t<Action, py::array::c_style | py::array::forcecast>
+                  actions) {
+             absl::Span<const Action> values(actions.data(), actions.size());
+             py::gil_scoped_release release;
+             vec.Step(values);
+           })
+      .def("observation_tensors",
+           [](const VectorState& vec) {
+             std::vector<int> shape = vec.GetState(0).GetGame()
+                                          ->ObservationTensorShape();
+             shape.insert(shape.begin(), {vec.NumStates(), vec.NumPlayers()});
+             return VectorStateArray(shape, [&](absl::Span<float> values) {
+               vec.ObservationTensors(values);
+             });
+           })
+      .def("legal_actions_masks",
+           [](const VectorState& vec) {
+             return VectorStateArray(
+                 {vec.NumStates(), vec.NumPlayers(),
+                  vec.GetState(0).NumDistinctActions()},
+                 [&](absl::Span<float> values) {
+                   vec.LegalActionsMasks(values);
+                 });
+           })
+      .def("rewards",
+           [](const VectorState& vec) {
+             return VectorStateArray(
+                 {vec.NumStates(), vec.NumPlayers()},
+                 [&](absl::Span<float> values) { vec.Rewards(values); });
+           })
+      .def("dones",
+           [](const VectorState& vec) {
+             return VectorStateArray(
+                 {vec.NumStates()},
+                 [&](absl::Span<float> values) { vec.Dones(values); });
+           })
+      .def("write_observation_tensors",
+           [](const VectorState& vec, py::array& array) {
+             absl::Span<float> values =
+                 MutableSpan<float>(array, vec.ObservationTensorsSize());
+             py::gil_scoped_release release;
+             vec.ObservationTensors(values);
+           })
+      .def("write_legal_actions_masks",
+           [](const VectorState& vec, py::array& array) {
+             absl::Span<float> values =
+                 MutableSpan<float>(array, vec.LegalActionsMasksSize());
+             py::gil_scoped_release release;
+             vec.LegalActionsMasks(values);
+           });
+
   py::class_<NormalFormGame, std::shared_ptr<NormalFormGame>> normal_form_game(
       m, "NormalFormGame", game);
   normal_form_game.def(py::pickle(                      // Pickle support
@@ -494,7 +821,20 @@ PYBIND11_MODULE(pyspiel, m) {
       .def("inform_action", &Bot::InformAction)
       .def("provides_policy", &Bot::ProvidesPolicy)
       .def("get_policy", &Bot::GetPolicy)
-      .def("step_with_policy", &Bot::StepWithPolicy);
+      .def("step_with_policy", &Bot::StepWithPolicy)
+      .def("provides_pondering", &Bot::ProvidesPondering)
+      .def("start_pondering", &Bot::StartPondering)
+      .def("stop_pondering", &Bot::StopPondering,
+           py::call_guard<py::gil_scoped_release>());
+
+  // Cancels the searches and solvers it is given to, when stop() is called
+  // from another Python thread. The calls doing the work release the GIL, so
+  // that other threads can run meanwhile; bots and functions implemented in
+  // Python that they call take it back.
+  py::class_<StopToken>(m, "StopToken")
+      .def(py::init<>())
+      .def("stop", &StopToken::Stop)
+      .def("stop_requested", &StopToken::StopRequested);
 
   py::class_<algorithms::Evaluator,
              std::shared_ptr<algorithms::Evaluator>> mcts_evaluator(
@@ -503,7 +843,8 @@ PYBIND11_MODULE(pyspiel, m) {
              algorithms::Evaluator,
              std::shared_ptr<algorithms::RandomRolloutEvaluator>>(
                  m, "RandomRolloutEvaluator")
-      .def(py::init<int, int>(), py::arg("n_rollouts"), py::arg("seed"));
+      .def(py::init<int, int, int>(), py::arg("n_rollouts"), py::arg("seed"),
+           py::arg("num_threads") = 1);
 
   py::enum_<algorithms::ChildSelectionPolicy>(m, "ChildSelectionPolicy")
       .value("UCT", algorithms::ChildSelectionPolicy::UCT)
@@ -520,8 +861,43 @@ PYBIND11_MODULE(pyspiel, m) {
           py::arg("verbose"),
           py::arg("child_selection_policy") =
               algorithms::ChildSelectionPolicy::UCT)
-      .def("step", &algorithms::MCTSBot::Step)
-      .def("mcts_search", &algorithms::MCTSBot::MCTSearch);
+      .def("step", &algorithms::MCTSBot::Step,
+           py::call_guard<py::gil_scoped_release>())
+      .def("mcts_search", &algorithms::MCTSBot::MCTSearch,
+           py::call_guard<py::gil_scoped_release>())
+      .def("set_stop_token", &algorithms::MCTSBot::SetStopToken,
+           py::keep_alive<1, 2>());
+
+  py::class_<algorithms::AlphaBetaSearcher>(m, "AlphaBetaSearcher")
+      .def(py::init<const Game&, std::function<double(const State&)>, int64_t,
+                    int>(),
+           py::arg("game"), py::arg("value_function") = nullptr,
+           py::arg("max_memory_mb") = 64, py::arg("num_threads") = 1)
+      .def("search", &algorithms::AlphaBetaSearcher::Search, py::arg("state"),
+           py::arg("depth_limit"), py::arg("time_limit_seconds") = 0,
+           py::call_guard<py::gil_scoped_release>())
+      .def("clear", &algorithms::AlphaBetaSearcher::Clear)
+      .def("set_stop_token", &algorithms::AlphaBetaSearcher::SetStopToken,
+           py::keep_alive<1, 2>())
+      .def("last_depth", &algorithms::AlphaBetaSearcher::LastDepth)
+      .def("last_search_solved",
+           &algorithms::AlphaBetaSearcher::LastSearchSolved)
+      .def("num_states_visited",
+           &algorithms::AlphaBetaSearcher::NumStatesVisited);
+
+  m.def("alpha_beta_search",
+        [](const Game& game, const State* state,
+           std::function<double(const State&)> value_function,
+           int depth_limit, Player maximizing_player) {
+          return algorithms::AlphaBetaSearch(game, state, value_function,
+                                             depth_limit, maximizing_player);
+        },
+        py::arg("game"), py::arg("state") = nullptr,
+        py::arg("value_function") = nullptr, py::arg("depth_limit") = -1,
+        py::arg("maximizing_player") = 0,
+        py::call_guard<py::gil_scoped_release>(),
+        "Solves a two-player zero-sum game with perfect information by "
+        "alpha-beta search, returning the value and the best action.");
 
   py::enum_<algorithms::ISMCTSFinalPolicyType>(m, "ISMCTSFinalPolicyType")
       .value("NORMALIZED_VISIT_COUNT",
@@ -532,14 +908,15 @@ PYBIND11_MODULE(pyspiel, m) {
 
   py::class_<algorithms::ISMCTSBot, Bot>(m, "ISMCTSBot")
       .def(py::init<int, std::shared_ptr<Evaluator>, double, int, int,
-                    algorithms::ISMCTSFinalPolicyType, bool, bool>(),
+                    algorithms::ISMCTSFinalPolicyType, bool, bool, int>(),
            py::arg("seed"), py::arg("evaluator"), py::arg("uct_c"),
            py::arg("max_simulations"),
            py::arg("max_world_samples") = algorithms::kUnlimitedNumWorldSamples,
            py::arg("final_policy_type") =
                algorithms::ISMCTSFinalPolicyType::kNormalizedVisitCount,
            py::arg("use_observation_string") = false,
-           py::arg("allow_inconsistent_action_sets") = false)
+           py::arg("allow_inconsistent_action_sets") = false,
+           py::arg("num_threads") = 1)
       .def("step", &algorithms::ISMCTSBot::Step)
       .def("provides_policy", &algorithms::MCTSBot::ProvidesPolicy)
       .def("get_policy", &algorithms::ISMCTSBot::GetPolicy)
@@ -550,13 +927,18 @@ PYBIND11_MODULE(pyspiel, m) {
   py::class_<TabularBestResponse>(m, "TabularBestResponse")
       .def(py::init<const open_spiel::Game&, int,
                     const std::unordered_map<std::string,
-                                             open_spiel::ActionsAndProbs>&>())
-      .def(py::init<const open_spiel::Game&, int, const open_spiel::Policy*>())
-      .def("value", &TabularBestResponse::Value)
+                                             open_spiel::ActionsAndProbs>&>(),
+           py::call_guard<py::gil_scoped_release>())
+      .def(py::init<const open_spiel::Game&, int, const open_spiel::Policy*>(),
+           py::call_guard<py::gil_scoped_release>())
+      .def("value", &TabularBestResponse::Value,
+           py::call_guard<py::gil_scoped_release>())
       .def("get_best_response_policy",
-           &TabularBestResponse::GetBestResponsePolicy)
+           &TabularBestResponse::GetBestResponsePolicy,
+           py::call_guard<py::gil_scoped_release>())
       .def("get_best_response_actions",
-           &TabularBestResponse::GetBestResponseActions)
+           &TabularBestResponse::GetBestResponseActions,
+           py::call_guard<py::gil_scoped_release>())
       .def("set_policy", py::overload_cast<const std::unordered_map<
                              std::string, open_spiel::ActionsAndProbs>&>(
                              &TabularBestResponse::SetPolicy))
@@ -584,19 +966,57 @@ PYBIND11_MODULE(pyspiel, m) {
       .def("get_state_policy", &open_spiel::TabularPolicy::GetStatePolicy)
       .def("policy_table",
            py::overload_cast<>(&open_spiel::TabularPolicy::PolicyTable));
+  py::class_<open_spiel::CompactTabularPolicy, open_spiel::Policy>(
+      m, "CompactTabularPolicy")
+      .def(py::init<const open_spiel::TabularPolicy&, bool>(),
+           py::arg("policy"), py::arg("single_precision") = false)
+      .def(py::init<const Game&, const open_spiel::Policy&, bool>(),
+           py::arg("game"), py::arg("policy"),
+           py::arg("single_precision") = false)
+      .def("get_state_policy",
+           &open_spiel::CompactTabularPolicy::GetStatePolicy)
+      .def("num_info_states",
+           &open_spiel::CompactTabularPolicy::NumInfoStates)
+      .def("memory_bytes", &open_spiel::CompactTabularPolicy::MemoryBytes);
   m.def("UniformRandomPolicy", &open_spiel::GetUniformPolicy);
 
+  py::class_<open_spiel::algorithms::MappedTabularPolicy, open_spiel::Policy>(
+      m, "MappedTabularPolicy")
+      .def(py::init<const std::string&>(), py::arg("filename"))
+      .def("get_state_policy",
+           &open_spiel::algorithms::MappedTabularPolicy::GetStatePolicy)
+      .def("num_info_states",
+           &open_spiel::algorithms::MappedTabularPolicy::NumInfoStates);
+  m.def("save_policy_file",
+        py::overload_cast<const std::string&, const open_spiel::TabularPolicy&,
+                          bool>(&open_spiel::algorithms::SavePolicyFile),
+        py::arg("filename"), py::arg("policy"),
+        py::arg("single_precision") = false);
+
   py::class_<open_spiel::algorithms::CFRSolver>(m, "CFRSolver")
       .def(py::init<const Game&>())
       .def("evaluate_and_update_policy",
-           &open_spiel::algorithms::CFRSolver::EvaluateAndUpdatePolicy)
+           &open_spiel::algorithms::CFRSolver::EvaluateAndUpdatePolicy,
+           py::call_guard<py::gil_scoped_release>())
+      .def("run_iterations",
+           &RunCFRIterations<open_spiel::algorithms::CFRSolver>,
+           py::arg("num_iterations"), py::arg("stop") = nullptr,
+           py::call_guard<py::gil_scoped_release>())
       .def("current_policy", &open_spiel::algorithms::CFRSolver::CurrentPolicy)
-      .def("average_policy", &open_spiel::algorithms::CFRSolver::AveragePolicy);
+      .def("average_policy", &open_spiel::algorithms::CFRSolver::AveragePolicy)
+      .def("save_average_policy",
+           &open_spiel::algorithms::CFRSolver::SaveAveragePolicy,
+           py::arg("filename"), py::arg("single_precision") = false);
 
   py::class_<open_spiel::algorithms::CFRPlusSolver>(m, "CFRPlusSolver")
       .def(py::init<const Game&>())
       .def("evaluate_and_update_policy",
-           &open_spiel::algorithms::CFRPlusSolver::EvaluateAndUpdatePolicy)
+           &open_spiel::algorithms::CFRPlusSolver::EvaluateAndUpdatePolicy,
+           py::call_guard<py::gil_scoped_release>())
+      .def("run_iterations",
+           &RunCFRIterations<open_spiel::algorithms::CFRPlusSolver>,
+           py::arg("num_iterations"), py::arg("stop") = nullptr,
+           py::call_guard<py::gil_scoped_release>())
       .def("current_policy", &open_spiel::algorithms::CFRSolver::CurrentPolicy)
       .def("average_policy",
            &open_spiel::algorithms::CFRPlusSolver::AveragePolicy);
@@ -604,11 +1024,37 @@ PYBIND11_MODULE(pyspiel, m) {
   py::class_<open_spiel::algorithms::CFRBRSolver>(m, "CFRBRSolver")
       .def(py::init<const Game&>())
       .def("evaluate_and_update_policy",
-           &open_spiel::algorithms::CFRPlusSolver::EvaluateAndUpdatePolicy)
+           &open_spiel::algorithms::CFRPlusSolver::EvaluateAndUpdatePolicy,
+           py::call_guard<py::gil_scoped_release>())
+      .def("run_iterations",
+           &RunCFRIterations<open_spiel::algorithms::CFRBRSolver>,
+           py::arg("num_iterations"), py::arg("stop") = nullptr,
+           py::call_guard<py::gil_scoped_release>())
       .def("current_policy", &open_spiel::algorithms::CFRSolver::CurrentPolicy)
       .def("average_policy",
            &open_spiel::algorithms::CFRPlusSolver::AveragePolicy);
 
+  py::enum_<algorithms::AverageType>(m, "MCCFRAverageType")
+      .value("SIMPLE", algorithms::AverageType::kSimple)
+      .value("FULL", algorithms::AverageType::kFull);
+
+  py::class_<algorithms::ExternalSamplingMCCFRSolver>(
+      m, "ExternalSamplingMCCFRSolver")
+      .def(py::init<const Game&, int, algorithms::AverageType, int>(),
+           py::arg("game"), py::arg("seed") = 0,
+           py::arg("avg_type") = algorithms::AverageType::kSimple,
+           py::arg("num_threads") = 1)
+      .def("run_iteration",
+           py::overload_cast<>(
+               &algorithms::ExternalSamplingMCCFRSolver::RunIteration),
+           py::call_guard<py::gil_scoped_release>())
+      .def("run_iterations",
+           &algorithms::ExternalSamplingMCCFRSolver::RunIterations,
+           py::arg("num_iterations"), py::arg("stop") = nullptr,
+           py::call_guard<py::gil_scoped_release>())
+      .def("average_policy",
+           &algorithms::ExternalSamplingMCCFRSolver::AveragePolicy);
+
   py::class_<open_spiel::algorithms::TrajectoryRecorder>(m,
                                                          "TrajectoryRecorder")
       .def(py::init<const Game&, const std::unordered_map<std::string, int>&,
@@ -706,12 +1152,77 @@ PYBIND11_MODULE(pyspiel, m) {
         "Get sample EFG data.");
 
   m.def("extensive_to_matrix_game",
-        open_spiel::algorithms::ExtensiveToMatrixGame,
+        open_spiel::algorithms::ExtensiveToMatrixGame, py::arg("game"),
+        py::arg("num_threads") = 1,
         "Converts a two-player extensive-game to its equivalent matrix game, "
         "which is exponentially larger. Use only with small games.");
 
+  m.def(
+      "matrix_game_expected_payoffs",
+      [](const MatrixGame& game, const std::vector<double>& row_strategy,
+         const std::vector<double>& col_strategy) {
+        return algorithms::ExpectedPayoffs(game, row_strategy, col_strategy);
+      },
+      py::arg("game"), py::arg("row_strategy"), py::arg("col_strategy"),
+      "The expected payoffs of both players under a strategy profile.");
+
+  m.def(
+      "matrix_game_nash_conv",
+      [](const MatrixGame& game, const std::vector<double>& row_strategy,
+         const std::vector<double>& col_strategy) {
+        return algorithms::MatrixGameNashConv(game, row_strategy,
+                                              col_strategy);
+      },
+      py::arg("game"), py::arg("row_strategy"), py::arg("col_strategy"),
+      "The NashConv of a strategy profile of a matrix game.");
+
+  m.def(
+      "solve_matrix_game_with_regret_matching",
+      [](const MatrixGame& game, int num_iterations,
+         bool regret_matching_plus) {
+        algorithms::MatrixGameSolution solution =
+            algorithms::SolveWithRegretMatching(game, num_iterations,
+                                                regret_matching_plus);
+        return std::make_pair(std::move(solution.row_strategy),
+                              std::move(solution.col_strategy));
+      },
+      py::arg("game"), py::arg("num_iterations"),
+      py::arg("regret_matching_plus") = true,
+      py::call_guard<py::gil_scoped_release>(),
+      "Returns the average (row, column) strategies of regret matching "
+      "self-play.");
+
+  m.def(
+      "solve_matrix_game_with_fictitious_play",
+      [](const MatrixGame& game, int num_iterations) {
+        algorithms::MatrixGameSolution solution =
+            algorithms::SolveWithFictitiousPlay(game, num_iterations);
+        return std::make_pair(std::move(solution.row_strategy),
+                              std::move(solution.col_strategy));
+      },
+      py::arg("game"), py::arg("num_iterations"),
+      py::call_guard<py::gil_scoped_release>(),
+      "Returns the average (row, column) strategies of fictitious play.");
+
+  m.def(
+      "solve_zero_sum_matrix_game",
+      [](const MatrixGame& game, double epsilon, int max_iterations,
+         int num_threads) {
+        algorithms::MatrixGameSolution solution =
+            algorithms::SolveZeroSumMatrixGame(game, epsilon, max_iterations,
+                                               num_threads);
+        return std::make_pair(std::move(solution.row_strategy),
+                              std::move(solution.col_strategy));
+      },
+      py::arg("game"), py::arg("epsilon") = 1e-6,
+      py::arg("max_iterations") = 100000, py::arg("num_threads") = 1,
+      py::call_guard<py::gil_scoped_release>(),
+      "Returns (row, column) strategies within epsilon of a Nash equilibrium "
+      "of the zero-sum game given by the row player's utilities.");
+
   m.def("extensive_to_tensor_game",
-        open_spiel::ExtensiveToTensorGame,
+        open_spiel::ExtensiveToTensorGame, py::arg("game"),
+        py::arg("num_threads") = 1,
         "Converts an extensive-game to its equivalent tensor game, "
         "which is exponentially larger. Use only with small games.");
 
@@ -739,8 +1250,25 @@ PYBIND11_MODULE(pyspiel, m) {
         "A general implementation of deserialization of a game and state "
         "string serialized by serialize_game_and_state.");
 
+  m.def(
+      "serialize_game_and_state_binary",
+      [](const Game& game, const State& state) {
+        return py::bytes(SerializeGameAndStateBinary(game, state));
+      },
+      "A compact binary serialization of a game and state, which is what "
+      "pickling a state uses.");
+
+  m.def(
+      "deserialize_game_and_state_binary",
+      [](const py::bytes& bytes) {
+        return DeserializeGameAndStateBinary(std::string(bytes));
+      },
+      "Deserializes a game and state serialized by "
+      "serialize_game_and_state_binary.");
+
   m.def("exploitability",
         py::overload_cast<const Game&, const Policy&>(&Exploitability),
+        py::call_guard<py::gil_scoped_release>(),
         "Returns the sum of the utility that a best responder wins when when "
         "playing against 1) the player 0 policy contained in `policy` and 2) "
         "the player 1 policy contained in `policy`."
@@ -753,6 +1281,7 @@ PYBIND11_MODULE(pyspiel, m) {
       py::overload_cast<
           const Game&, const std::unordered_map<std::string, ActionsAndProbs>&>(
           &Exploitability),
+      py::call_guard<py::gil_scoped_release>(),
       "Returns the sum of the utility that a best responder wins when when "
       "playing against 1) the player 0 policy contained in `policy` and 2) "
       "the player 1 policy contained in `policy`."
@@ -761,6 +1290,7 @@ PYBIND11_MODULE(pyspiel, m) {
       "to it.");
 
   m.def("nash_conv", py::overload_cast<const Game&, const Policy&>(&NashConv),
+        py::call_guard<py::gil_scoped_release>(),
         "Returns the sum of the utility that a best responder wins when when "
         "playing against 1) the player 0 policy contained in `policy` and 2) "
         "the player 1 policy contained in `policy`."
@@ -773,6 +1303,7 @@ PYBIND11_MODULE(pyspiel, m) {
       py::overload_cast<
           const Game&, const std::unordered_map<std::string, ActionsAndProbs>&>(
           &NashConv),
+      py::call_guard<py::gil_scoped_release>(),
       "Calculates a measure of how far the given policy is from a Nash "
       "equilibrium by returning the sum of the improvements in the value "
       "that each player could obtain by unilaterally changing their strategy "
@@ -783,15 +1314,27 @@ PYBIND11_MODULE(pyspiel, m) {
         "Returns a turn-based version of the given game.");
 
   m.def("num_deterministic_policies",
-        open_spiel::algorithms::NumDeterministicPolicies,
+        open_spiel::algorithms::NumDeterministicPolicies, py::arg("game"),
+        py::arg("player"), py::arg("num_threads") = 1,
         "Returns number of determinstic policies in this game for a player, "
         "or -1 if there are more than 2^64 - 1 policies.");
 
-  m.def("expected_returns",
-        py::overload_cast<const State&, const std::vector<const Policy*>&, int,
-                          bool>(&open_spiel::algorithms::ExpectedReturns),
-        "Computes the undiscounted expected returns from a depth-limited "
-        "search.");
+  // Without threads, which could call policies implemented in Python without
+  // holding the GIL.
+  m.def(
+      "expected_returns",
+      [](const State& state, const std::vector<const Policy*>& policies,
+         int depth_limit, bool use_infostate_get_policy,
+         bool use_transposition_cache) {
+        return open_spiel::algorithms::ExpectedReturns(
+            state, policies, depth_limit, use_infostate_get_policy,
+            use_transposition_cache);
+      },
+      py::arg("state"), py::arg("policies"), py::arg("depth_limit"),
+      py::arg("use_infostate_get_policy"),
+      py::arg("use_transposition_cache") = false,
+      "Computes the undiscounted expected returns from a depth-limited "
+      "search.");
 
   py::class_<open_spiel::algorithms::BatchedTrajectory>(m, "BatchedTrajectory")
       .def(py::init<int>())
@@ -829,6 +1372,80 @@ PYBIND11_MODULE(pyspiel, m) {
             &open_spiel::algorithms::RecordBatchedTrajectory),
         "Records a batch of trajectories.");
 
+  // The fields are NumPy arrays viewing the buffers, which they keep alive.
+  using open_spiel::algorithms::ColumnarTrajectory;
+  auto columnar_field = [](auto field, auto shape) {
+    return [field, shape](py::object self) {
+      ColumnarTrajectory& trajectory = self.cast<ColumnarTrajectory&>();
+      auto& values = trajectory.*field;
+      using T = typename std::decay_t<decltype(values)>::value_type;
+      return py::array_t<T>(shape(trajectory), values.data(), self);
+    };
+  };
+  auto steps = [](const ColumnarTrajectory& t) {
+    return std::vector<int>{t.batch_size, t.max_length};
+  };
+  auto actions = [](const ColumnarTrajectory& t) {
+    return std::vector<int>{t.batch_size, t.max_length, t.num_actions};
+  };
+  py::class_<ColumnarTrajectory>(m, "ColumnarTrajectory")
+      .def_readonly("batch_size", &ColumnarTrajectory::batch_size)
+      .def_readonly("max_length", &ColumnarTrajectory::max_length)
+      .def_readonly("lengths", &ColumnarTrajectory::lengths)
+      .def_property_readonly(
+          "observations",
+          columnar_field(&ColumnarTrajectory::observations,
+                         [](const ColumnarTrajectory& t) {
+                           return std::vector<int>{t.batch_size, t.max_length,
+                                                   t.observation_size};
+                         }))
+      .def_property_readonly(
+          "state_indices",
+          columnar_field(&ColumnarTrajectory::state_indices, steps))
+      .def_property_readonly(
+          "legal_actions",
+          columnar_field(&ColumnarTrajectory::legal_actions, actions))
+      .def_property_readonly(
+          "actions", columnar_field(&ColumnarTrajectory::actions, steps))
+      .def_property_readonly(
+          "player_policies",
+          columnar_field(&ColumnarTrajectory::player_policies, actions))
+      .def_property_readonly(
+          "player_ids", columnar_field(&ColumnarTrajectory::player_ids, steps))
+      .def_property_readonly(
+          "rewards", columnar_field(&ColumnarTrajectory::rewards,
+                                    [](const ColumnarTrajectory& t) {
+                                      return std::vector<int>{t.batch_size,
+                                                              t.num_players};
+                                    }))
+      .def_property_readonly(
+          "valid", columnar_field(&ColumnarTrajectory::valid, steps))
+      .def_property_readonly(
+          "next_is_terminal",
+          columnar_field(&ColumnarTrajectory::next_is_terminal, steps))
+      .def("resize", &ColumnarTrajectory::Resize)
+      .def("shrink_to_fit", &ColumnarTrajectory::ShrinkToFit);
+
+  m.def(
+      "record_columnar_trajectories",
+      [](const Game& game,
+         const std::vector<open_spiel::TabularPolicy>& policies,
+         const std::unordered_map<std::string, int>& state_to_index,
+         int batch_size, bool include_full_observations, int seed,
+         int max_unroll_length, int num_threads) {
+        std::mt19937 rng(seed);
+        py::gil_scoped_release release;
+        return open_spiel::algorithms::RecordColumnarTrajectory(
+            game, policies, *game.NewInitialState(), state_to_index,
+            batch_size, include_full_observations, &rng, max_unroll_length,
+            num_threads);
+      },
+      py::arg("game"), py::arg("policies"), py::arg("state_to_index"),
+      py::arg("batch_size"), py::arg("include_full_observations"),
+      py::arg("seed"), py::arg("max_unroll_length") = -1,
+      py::arg("num_threads") = 1,
+      "Records a batch of trajectories into contiguous buffers.");
+
   // Game-Specific Query API.
   m.def("negotiation_item_pool", &open_spiel::query::NegotiationItemPool);
   m.def("negotiation_agent_utils", &open_spiel::query::NegotiationAgentUtils);
@@ -19,7 +19,9 @@ from __future__ import division
 from __future__ import print_function
 
 import os
+import pickle
 from absl.testing import absltest
+import numpy as np
 import six
 
 from open_spiel.python import policy
@@ -71,6 +73,7 @@ class PyspielTest(absltest.TestCase):
         "misere",
         "negotiation",
         "normal_form_extensive_game",
+        "observation_history",
         "oshi_zumo",
         "othello",
         "oware",
@@ -115,6 +118,7 @@ class PyspielTest(absltest.TestCase):
         "misere",
         "turn_based_simultaneous_game",
         "normal_form_extensive_game",
+        "observation_history",
     ]
     self.assertCountEqual(games_with_mandatory_parameters, expected)
 
@@ -200,6 +204,127 @@ class PyspielTest(absltest.TestCase):
     self.assertEqual(game_type.chance_mode,
                      pyspiel.GameType.ChanceMode.DETERMINISTIC)
 
+  def test_tensors_into_arrays(self):
+    game = pyspiel.load_game("tic_tac_toe")
+    state = game.new_initial_state()
+    state.apply_action(4)
+    expected = np.array(state.observation_tensor(1), dtype=np.float32)
+    np.testing.assert_array_equal(
+        state.observation_tensor_array(1),
+        expected.reshape(game.observation_tensor_shape()))
+
+    values = np.full(game.observation_tensor_size(), 7, dtype=np.float32)
+    state.write_observation_tensor(1, values)
+    np.testing.assert_array_equal(values, expected)
+    planes = np.zeros(game.observation_tensor_shape(), dtype=np.uint8)
+    state.write_observation_tensor(planes)
+    np.testing.assert_array_equal(planes.ravel(), expected)
+
+    with six.assertRaisesRegex(self, RuntimeError, "size"):
+      state.write_observation_tensor(np.zeros(3, dtype=np.float32))
+    with six.assertRaisesRegex(self, RuntimeError, "dtype"):
+      state.write_observation_tensor(
+          np.zeros(game.observation_tensor_size(), dtype=np.float64))
+
+  def test_information_state_tensor_into_array(self):
+    game = pyspiel.load_game("kuhn_poker")
+    state = game.new_initial_state()
+    state.apply_action(0)
+    state.apply_action(1)
+    values = np.zeros(game.information_state_tensor_size(), dtype=np.float32)
+    state.write_information_state_tensor(values)
+    np.testing.assert_array_equal(values, state.information_state_tensor())
+    np.testing.assert_array_equal(
+        state.information_state_tensor_array(1),
+        state.information_state_tensor(1))
+
+  def test_sparse_tensors(self):
+    game = pyspiel.load_game("goofspiel", {"imp_info": True, "num_cards": 4})
+    state = game.new_initial_state()
+    state.apply_action(0)
+    state.apply_actions([1, 2])
+    for player in range(game.num_players()):
+      for sparse_fn, dense_fn in [
+          (state.observation_tensor_sparse, state.observation_tensor),
+          (state.information_state_tensor_sparse,
+           state.information_state_tensor)]:
+        indices, values = sparse_fn(player)
+        dense = np.zeros(len(dense_fn(player)), dtype=np.float32)
+        dense[indices] = values
+        np.testing.assert_array_equal(dense, dense_fn(player))
+
+  def test_legal_actions_mask_into_array(self):
+    game = pyspiel.load_game("tic_tac_toe")
+    state = game.new_initial_state()
+    state.apply_action(4)
+    for dtype in [np.int32, np.float32, np.uint8, np.bool_]:
+      mask = np.ones(game.num_distinct_actions(), dtype=dtype)
+      state.write_legal_actions_mask(mask)
+      np.testing.assert_array_equal(mask, state.legal_actions_mask())
+
+  def test_vector_state(self):
+    game = pyspiel.load_game("tic_tac_toe")
+    vec = pyspiel.VectorState(game, num_states=8, seed=0, num_threads=2)
+    self.assertEqual(vec.num_threads(), 2)
+    observations = vec.observation_tensors()
+    self.assertEqual(observations.shape,
+                     (8, 2) + tuple(game.observation_tensor_shape()))
+    np.testing.assert_array_equal(
+        observations[3, 1].ravel(), vec.get_state(3).observation_tensor(1))
+    masks = np.zeros((8, 2, game.num_distinct_actions()), dtype=np.float32)
+    vec.write_legal_actions_masks(masks)
+    np.testing.assert_array_equal(masks[:, 0], 1)
+    np.testing.assert_array_equal(masks[:, 1], 0)
+
+    vec.step(np.arange(8))
+    for i in range(8):
+      self.assertEqual(vec.get_state(i).history(), [i])
+    np.testing.assert_array_equal(vec.rewards(), np.zeros((8, 2)))
+    np.testing.assert_array_equal(vec.dones(), np.zeros(8))
+    with six.assertRaisesRegex(self, RuntimeError, "actions.size"):
+      vec.step([0])
+
+  def test_stop_token(self):
+    game = pyspiel.load_game("connect_four")
+    stop = pyspiel.StopToken()
+    stop.stop()
+    searcher = pyspiel.AlphaBetaSearcher(game)
+    searcher.set_stop_token(stop)
+    _, action = searcher.search(game.new_initial_state(), depth_limit=-1)
+    self.assertIn(action, range(game.num_distinct_actions()))
+    self.assertEqual(searcher.last_depth(), 1)
+
+    solver = pyspiel.CFRSolver(pyspiel.load_game("kuhn_poker"))
+    self.assertEqual(solver.run_iterations(3), 3)
+    self.assertEqual(solver.run_iterations(3, stop), 0)
+
+  def test_binary_pickling(self):
+    game = pyspiel.load_game("leduc_poker")
+    state = game.new_initial_state()
+    for action in [0, 3, 1, 1]:
+      state.apply_action(action)
+    data = pickle.dumps(state)
+    self.assertLess(
+        len(data), len(pyspiel.serialize_game_and_state(game, state)))
+    clone = pickle.loads(data)
+    self.assertEqual(clone.history(), state.history())
+    self.assertEqual(str(clone), str(state))
+
+  def test_solve_matrix_game(self):
+    game = pyspiel.extensive_to_matrix_game(pyspiel.load_game("kuhn_poker"))
+    row_strategy, col_strategy = (
+        pyspiel.solve_matrix_game_with_regret_matching(game, 2000))
+    self.assertLen(row_strategy, 64)
+    self.assertLess(
+        pyspiel.matrix_game_nash_conv(game, row_strategy, col_strategy), 0.01)
+    values = pyspiel.matrix_game_expected_payoffs(game, row_strategy,
+                                                  col_strategy)
+    self.assertAlmostEqual(values[0], -1 / 18, places=2)
+    row_strategy, col_strategy = pyspiel.solve_zero_sum_matrix_game(
+        game, epsilon=1e-8)
+    self.assertLess(
+        pyspiel.matrix_game_nash_conv(game, row_strategy, col_strategy), 1e-8)
+
   def test_error_handling(self):
     with six.assertRaisesRegex(self, RuntimeError,
                                "Unknown game 'invalid_game_name'"):
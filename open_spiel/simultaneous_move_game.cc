@@ -14,6 +14,7 @@
 
 #include "open_spiel/simultaneous_move_game.h"
 
+#include <algorithm>
 #include <numeric>
 #include <string>
 #include <vector>
@@ -24,23 +25,101 @@
 
 namespace open_spiel {
 
-std::vector<Action> SimMoveState::FlatJointActionToActions(
-    Action flat_action) const {
-  std::vector<Action> actions(num_players_, kInvalidAction);
-  for (Player player = 0; player < num_players_; ++player) {
+FlatJointActions::FlatJointActions(const State& state)
+    : legal_actions_(state.NumPlayers()), num_joint_actions_(1) {
+  for (Player player = 0; player < state.NumPlayers(); ++player) {
+    legal_actions_[player] = state.LegalActions(player);
+    if (!legal_actions_[player].empty()) {
+      num_joint_actions_ *= legal_actions_[player].size();
+    }
+  }
+}
+
+std::vector<Action> FlatJointActions::Actions(Action flat_action) const {
+  std::vector<Action> actions;
+  Actions(flat_action, &actions);
+  return actions;
+}
+
+void FlatJointActions::Actions(Action flat_action,
+                               std::vector<Action>* actions) const {
+  SPIEL_CHECK_GE(flat_action, 0);
+  SPIEL_CHECK_LT(flat_action, num_joint_actions_);
+  actions->assign(legal_actions_.size(), kInvalidAction);
+  for (Player player = 0; player < legal_actions_.size(); ++player) {
     // For each player with legal actions available:
-    const auto legal_actions = LegalActions(player);
+    const std::vector<Action>& legal_actions = legal_actions_[player];
     int num_actions = legal_actions.size();
     if (num_actions > 0) {
       // Extract the least-significant digit (radix = the number legal actions
       // for the current player) from flat_action. Use the digit as an index
       // into the player's set of legal actions.
-      actions[player] = legal_actions[flat_action % num_actions];
+      (*actions)[player] = legal_actions[flat_action % num_actions];
       // Update the flat_action to be for the remaining players only.
       flat_action /= num_actions;
     }
   }
-  return actions;
+}
+
+Action FlatJointActions::FlatAction(const std::vector<Action>& actions) const {
+  SPIEL_CHECK_EQ(actions.size(), legal_actions_.size());
+  Action flat_action = 0;
+  for (Player player = legal_actions_.size() - 1; player >= 0; --player) {
+    const std::vector<Action>& legal_actions = legal_actions_[player];
+    if (legal_actions.empty()) continue;
+    // The legal actions are in ascending order.
+    auto it = std::lower_bound(legal_actions.begin(), legal_actions.end(),
+                               actions[player]);
+    if (it == legal_actions.end() || *it != actions[player]) {
+      SpielFatalError(absl::StrCat("Action ", actions[player],
+                                   " is not legal for player ", player));
+    }
+    flat_action = flat_action * legal_actions.size() +
+                  (it - legal_actions.begin());
+  }
+  return flat_action;
+}
+
+FlatJointActions::Iterator::Iterator(const FlatJointActions* joint_actions,
+                                     Action flat_action)
+    : joint_actions_(joint_actions), flat_action_(flat_action) {
+  if (flat_action_ < joint_actions_->num_joint_actions_) {
+    joint_actions_->Actions(flat_action_, &actions_);
+    digits_.resize(actions_.size());
+    for (Player player = 0; player < actions_.size(); ++player) {
+      const std::vector<Action>& legal_actions =
+          joint_actions_->legal_actions_[player];
+      if (legal_actions.empty()) continue;
+      digits_[player] =
+          std::lower_bound(legal_actions.begin(), legal_actions.end(),
+                           actions_[player]) -
+          legal_actions.begin();
+    }
+  }
+}
+
+FlatJointActions::Iterator& FlatJointActions::Iterator::operator++() {
+  ++flat_action_;
+  if (flat_action_ == joint_actions_->num_joint_actions_) return *this;
+  // Adds one to the least-significant digit, carrying over to the next
+  // players as needed.
+  for (Player player = 0; player < digits_.size(); ++player) {
+    const std::vector<Action>& legal_actions =
+        joint_actions_->legal_actions_[player];
+    if (legal_actions.empty()) continue;
+    if (++digits_[player] < legal_actions.size()) {
+      actions_[player] = legal_actions[digits_[player]];
+      break;
+    }
+    digits_[player] = 0;
+    actions_[player] = legal_actions[0];
+  }
+  return *this;
+}
+
+std::vector<Action> SimMoveState::FlatJointActionToActions(
+    Action flat_action) const {
+  return FlatJointActions(*this).Actions(flat_action);
 }
 
 void SimMoveState::ApplyFlatJointAction(Action flat_action) {
@@ -48,16 +127,9 @@ void SimMoveState::ApplyFlatJointAction(Action flat_action) {
 }
 
 std::vector<Action> SimMoveState::LegalFlatJointActions() const {
-  // Compute the number of possible joint actions = \prod #actions(i)
-  // over all players with any legal actions available.
-  int number_joint_actions = 1;
-  for (auto player = Player{0}; player < num_players_; ++player) {
-    int num_actions = LegalActions(player).size();
-    if (num_actions > 1) number_joint_actions *= num_actions;
-  }
   // The possible joint actions are just numbered 0, 1, 2, ....
   // So build a vector of the right size containing consecutive integers.
-  std::vector<Action> joint_actions(number_joint_actions);
+  std::vector<Action> joint_actions(FlatJointActions(*this).NumJointActions());
   std::iota(joint_actions.begin(), joint_actions.end(), 0);
   return joint_actions;
 }
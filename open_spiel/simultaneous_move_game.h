@@ -31,6 +31,62 @@ namespace open_spiel {
 
 class SimMoveGame;
 
+// The legal joint actions at a simultaneous node, numbered as the flat joint
+// actions of SimMoveState below, without listing them: a flat joint action is
+// a mixed-radix number, with a digit per player with legal actions. The legal
+// actions of the players are queried once, when the view is made, after which
+// converting a flat joint action takes no call to the state, and iterating
+// over all of them costs O(1) per joint action.
+//
+//   FlatJointActions joint_actions(state);
+//   for (auto it = joint_actions.begin(); it != joint_actions.end(); ++it) {
+//     // it.flat_action() is the flat joint action of the actions *it.
+//   }
+class FlatJointActions {
+ public:
+  explicit FlatJointActions(const State& state);
+
+  // The number of joint actions, the product of the numbers of legal actions
+  // of the players who have any.
+  Action NumJointActions() const { return num_joint_actions_; }
+
+  // The action of each player in a flat joint action, kInvalidAction for the
+  // players without legal actions.
+  std::vector<Action> Actions(Action flat_action) const;
+  void Actions(Action flat_action, std::vector<Action>* actions) const;
+
+  // The flat joint action of an action per player; the inverse of Actions.
+  Action FlatAction(const std::vector<Action>& actions) const;
+
+  // Iterates over the joint actions in the order of the flat ones.
+  class Iterator {
+   public:
+    const std::vector<Action>& operator*() const { return actions_; }
+    const std::vector<Action>* operator->() const { return &actions_; }
+    Action flat_action() const { return flat_action_; }
+    Iterator& operator++();
+    bool operator==(const Iterator& other) const {
+      return flat_action_ == other.flat_action_;
+    }
+    bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+   private:
+    friend class FlatJointActions;
+    Iterator(const FlatJointActions* joint_actions, Action flat_action);
+
+    const FlatJointActions* joint_actions_;
+    Action flat_action_;
+    std::vector<int> digits_;  // The index of the action of each player.
+    std::vector<Action> actions_;
+  };
+  Iterator begin() const { return Iterator(this, 0); }
+  Iterator end() const { return Iterator(this, num_joint_actions_); }
+
+ private:
+  std::vector<std::vector<Action>> legal_actions_;  // Per player.
+  Action num_joint_actions_;
+};
+
 class SimMoveState : public State {
  public:
   SimMoveState(std::shared_ptr<const Game> game) : State(game) {}
@@ -60,11 +116,12 @@ class SimMoveState : public State {
       ApplyFlatJointAction(action);
     } else {
       DoApplyAction(action);
-      history_.push_back(action);
+      PushHistory(action);
     }
   }
 
-  // Convert a flat joint action to a list of actions.
+  // Convert a flat joint action to a list of actions. To convert many, use a
+  // FlatJointActions.
   std::vector<Action> FlatJointActionToActions(Action flat_action) const;
 
  protected:
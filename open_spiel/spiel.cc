@@ -14,21 +14,38 @@
 
 #include "open_spiel/spiel.h"
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <dlfcn.h>
+#include <unistd.h>
+#endif
+
 #include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
 #include <functional>
 #include <iostream>
 #include <map>
 #include <memory>
 #include <optional>
 #include <string>
+#include <typeinfo>
 #include <utility>
 #include <vector>
 
+#include "open_spiel/abseil-cpp/absl/algorithm/container.h"
+#include "open_spiel/abseil-cpp/absl/strings/ascii.h"
 #include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
 #include "open_spiel/abseil-cpp/absl/strings/str_join.h"
 #include "open_spiel/abseil-cpp/absl/strings/str_split.h"
+#include "open_spiel/abseil-cpp/absl/strings/string_view.h"
+#include "open_spiel/abseil-cpp/absl/synchronization/mutex.h"
+#include "open_spiel/abseil-cpp/absl/types/span.h"
 #include "open_spiel/game_parameters.h"
 #include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/lru_cache.h"
+#include "open_spiel/utils/varint.h"
 
 namespace open_spiel {
 namespace {
@@ -38,6 +55,19 @@ constexpr const char* kSerializeMetaSectionHeader = "[Meta]";
 constexpr const char* kSerializeGameSectionHeader = "[Game]";
 constexpr const char* kSerializeStateSectionHeader = "[State]";
 
+// Binary serialization: a version byte, a format byte, the varint-packed
+// history, and a game-specific snapshot for kBinaryFormatSnapshot.
+constexpr const char kBinarySerializationVersion = 1;
+constexpr const char kBinaryFormatHistory = 0;
+constexpr const char kBinaryFormatSnapshot = 1;
+
+// The game and state of SerializeGameAndStateBinary: a version byte, this
+// format byte, the game string with its varint size, and the binary state.
+constexpr const char kBinaryFormatGameAndState = 2;
+
+// How many games LoadSerializedGame keeps.
+constexpr int kSerializedGameCacheSize = 16;
+
 // Returns the available parameter keys, to be used as a utility function.
 std::string ListValidParameters(
     const std::map<std::string, GameParameter>& param_spec) {
@@ -79,6 +109,55 @@ void ValidateParams(const GameParameters& params,
   }
 }
 
+// Copies a double-precision tensor into a reduced-precision buffer.
+void ConvertTensor(const std::vector<double>& tensor, absl::Span<float> values) {
+  SPIEL_CHECK_EQ(tensor.size(), values.size());
+  std::copy(tensor.begin(), tensor.end(), values.begin());
+}
+
+void ConvertTensor(const std::vector<double>& tensor,
+                   absl::Span<uint8_t> values) {
+  SPIEL_CHECK_EQ(tensor.size(), values.size());
+  for (int i = 0; i < tensor.size(); ++i) {
+    // Casting a value out of range is undefined, so check it first.
+    if (!(tensor[i] >= 0 && tensor[i] <= 255 &&
+          tensor[i] == std::floor(tensor[i]))) {
+      SpielFatalError(absl::StrCat("Tensor value ", tensor[i],
+                                   " does not fit in a uint8_t."));
+    }
+    values[i] = static_cast<uint8_t>(tensor[i]);
+  }
+}
+
+void ConvertTensor(const std::vector<double>& tensor, SparseTensor* sparse) {
+  sparse->Reset(tensor.size());
+  for (int i = 0; i < tensor.size(); ++i) {
+    if (tensor[i] != 0) sparse->Add(i, tensor[i]);
+  }
+}
+
+// Applies `history` to `state`, grouping the actions at simultaneous nodes the
+// same way State::ApplyActions appends them to the history.
+void ReplayHistory(const std::vector<Action>& history, State* state) {
+  if (state->GetGame()->GetType().dynamics == GameType::Dynamics::kSequential) {
+    state->ApplyActionsUnchecked(history);
+    return;
+  }
+  std::vector<Action> joint_action;
+  for (int i = 0; i < history.size();) {
+    if (state->IsSimultaneousNode()) {
+      SPIEL_CHECK_LE(i + state->NumPlayers(), history.size());
+      joint_action.assign(history.begin() + i,
+                          history.begin() + i + state->NumPlayers());
+      state->ApplyActions(joint_action);
+      i += state->NumPlayers();
+    } else {
+      state->ApplyAction(history[i]);
+      ++i;
+    }
+  }
+}
+
 }  // namespace
 
 std::ostream& operator<<(std::ostream& os, const StateType& type) {
@@ -118,47 +197,139 @@ bool GameType::ContainsRequiredParameters() const {
   return false;
 }
 
-GameRegisterer::GameRegisterer(const GameType& game_type, CreateFunc creator) {
-  RegisterGame(game_type, creator);
+struct GameRegisterer::Registry {
+  // Copies the pending registerers into the games, oldest first, so that
+  // later registrations of a name replace earlier ones.
+  void AddPending() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex) {
+    std::vector<GameRegisterer*> registerers;
+    for (GameRegisterer* r = pending; r != nullptr; r = r->next_) {
+      registerers.push_back(r);
+    }
+    for (auto it = registerers.rbegin(); it != registerers.rend(); ++it) {
+      games[(*it)->game_type_.short_name] =
+          std::make_pair((*it)->game_type_, (*it)->creator_);
+    }
+    pending = nullptr;
+  }
+
+  absl::Mutex mutex;
+  GameRegisterer* pending ABSL_GUARDED_BY(mutex) = nullptr;
+  std::map<std::string, std::pair<GameType, CreateFunc>> games
+      ABSL_GUARDED_BY(mutex);
+};
+
+GameRegisterer::Registry& GameRegisterer::GetRegistry() {
+  static Registry* registry = new Registry();
+  return *registry;
 }
 
+GameRegisterer::GameRegisterer(const GameType& game_type, CreateFunc creator)
+    : game_type_(game_type), creator_(std::move(creator)) {
+  Registry& registry = GetRegistry();
+  absl::MutexLock lock(&registry.mutex);
+  next_ = registry.pending;
+  registry.pending = this;
+}
+
+namespace {
+
+// Opens the library of a game from OPEN_SPIEL_GAME_LIBRARY_PATH, and returns
+// whether there was one.
+bool LoadLibraryOfGame(const std::string& short_name) {
+#if defined(__unix__) || defined(__APPLE__)
+  const char* path = std::getenv("OPEN_SPIEL_GAME_LIBRARY_PATH");
+  if (path == nullptr || short_name.empty() ||
+      !absl::c_all_of(short_name, [](char c) {
+        return absl::ascii_isalnum(c) || c == '_';
+      })) {
+    return false;
+  }
+  for (absl::string_view dir : absl::StrSplit(path, ':', absl::SkipEmpty())) {
+    const std::string library =
+        absl::StrCat(dir, "/libopen_spiel_game_", short_name, ".so");
+    if (access(library.c_str(), F_OK) == 0) {
+      LoadGameLibrary(library);
+      return true;
+    }
+  }
+#endif
+  return false;
+}
+
+}  // namespace
+
 std::shared_ptr<const Game> GameRegisterer::CreateByName(
     const std::string& short_name, const GameParameters& params) {
-  auto iter = factories().find(short_name);
-  if (iter == factories().end()) {
+  // The factory is called without the lock, as it may load other games.
+  auto find_game = [&short_name]()
+      -> std::optional<std::pair<GameType, CreateFunc>> {
+    Registry& registry = GetRegistry();
+    absl::MutexLock lock(&registry.mutex);
+    registry.AddPending();
+    auto iter = registry.games.find(short_name);
+    if (iter == registry.games.end()) return std::nullopt;
+    return iter->second;
+  };
+  std::optional<std::pair<GameType, CreateFunc>> game = find_game();
+  if (!game.has_value() && LoadLibraryOfGame(short_name)) game = find_game();
+  if (!game.has_value()) {
     SpielFatalError(absl::StrCat("Unknown game '", short_name,
                                  "'. Available games are:\n",
                                  absl::StrJoin(RegisteredNames(), "\n")));
-
-  } else {
-    ValidateParams(params, iter->second.first.parameter_specification);
-    return (iter->second.second)(params);
   }
+  ValidateParams(params, game->first.parameter_specification);
+  return game->second(params);
 }
 
 std::vector<std::string> GameRegisterer::RegisteredNames() {
+  Registry& registry = GetRegistry();
+  absl::MutexLock lock(&registry.mutex);
+  registry.AddPending();
   std::vector<std::string> names;
-  for (const auto& key_val : factories()) {
+  for (const auto& key_val : registry.games) {
     names.push_back(key_val.first);
   }
   return names;
 }
 
 std::vector<GameType> GameRegisterer::RegisteredGames() {
+  Registry& registry = GetRegistry();
+  absl::MutexLock lock(&registry.mutex);
+  registry.AddPending();
   std::vector<GameType> games;
-  for (const auto& key_val : factories()) {
+  for (const auto& key_val : registry.games) {
     games.push_back(key_val.second.first);
   }
   return games;
 }
 
 bool GameRegisterer::IsValidName(const std::string& short_name) {
-  return factories().find(short_name) != factories().end();
+  Registry& registry = GetRegistry();
+  absl::MutexLock lock(&registry.mutex);
+  registry.AddPending();
+  return registry.games.find(short_name) != registry.games.end();
 }
 
 void GameRegisterer::RegisterGame(const GameType& game_info,
                                   GameRegisterer::CreateFunc creator) {
-  factories()[game_info.short_name] = std::make_pair(game_info, creator);
+  Registry& registry = GetRegistry();
+  absl::MutexLock lock(&registry.mutex);
+  registry.AddPending();
+  registry.games[game_info.short_name] = std::make_pair(game_info, creator);
+}
+
+void LoadGameLibrary(const std::string& path) {
+#if defined(__unix__) || defined(__APPLE__)
+  // The games register themselves from the static initializers of the
+  // library, which is never closed, as the games point into it.
+  if (dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL) == nullptr) {
+    SpielFatalError(absl::StrCat("Could not load the game library ", path,
+                                 ": ", dlerror()));
+  }
+#else
+  SpielFatalError(absl::StrCat("Game libraries are not supported here: ",
+                               path));
+#endif
 }
 
 bool IsGameRegistered(const std::string& short_name) {
@@ -173,12 +344,21 @@ std::vector<GameType> RegisteredGameTypes() {
   return GameRegisterer::RegisteredGames();
 }
 
-std::shared_ptr<const Game> LoadGame(const std::string& game_string) {
-  return LoadGame(GameParametersFromString(game_string));
+namespace {
+
+// The games cached by LoadGame; see EnableLoadGameCache.
+struct LoadGameCache {
+  std::atomic<bool> enabled{false};
+  LRUCache<std::string, std::shared_ptr<const Game>> games{0};
+};
+
+LoadGameCache& GetLoadGameCache() {
+  static LoadGameCache* cache = new LoadGameCache();
+  return *cache;
 }
 
-std::shared_ptr<const Game> LoadGame(const std::string& short_name,
-                                     const GameParameters& params) {
+std::shared_ptr<const Game> CreateGame(const std::string& short_name,
+                                       const GameParameters& params) {
   std::shared_ptr<const Game> result =
       GameRegisterer::CreateByName(short_name, params);
   if (result == nullptr) {
@@ -187,6 +367,55 @@ std::shared_ptr<const Game> LoadGame(const std::string& short_name,
   return result;
 }
 
+}  // namespace
+
+void EnableLoadGameCache(int max_size) {
+  LoadGameCache& cache = GetLoadGameCache();
+  cache.games.SetMaxSize(max_size);
+  cache.enabled = true;
+}
+
+void DisableLoadGameCache() {
+  LoadGameCache& cache = GetLoadGameCache();
+  cache.enabled = false;
+  cache.games.Clear();
+}
+
+LRUCacheInfo LoadGameCacheInfo() { return GetLoadGameCache().games.Info(); }
+
+std::shared_ptr<const Game> LoadSerializedGame(const std::string& game_string) {
+  static auto* games =
+      new LRUCache<std::string, std::shared_ptr<const Game>>(
+          kSerializedGameCacheSize);
+  if (std::optional<const std::shared_ptr<const Game>> game =
+          games->Get(game_string)) {
+    return *game;
+  }
+  return games->Insert(game_string, LoadGame(game_string));
+}
+
+std::shared_ptr<const Game> LoadGame(const std::string& game_string) {
+  return LoadGame(GameParametersFromString(game_string));
+}
+
+std::shared_ptr<const Game> LoadGame(const std::string& short_name,
+                                     const GameParameters& params) {
+  LoadGameCache& cache = GetLoadGameCache();
+  if (!cache.enabled) return CreateGame(short_name, params);
+
+  GameParameters key_params = params;
+  key_params["name"] = GameParameter(short_name);
+  const std::string key = GameParametersToString(key_params);
+  if (std::optional<const std::shared_ptr<const Game>> game =
+          cache.games.Get(key)) {
+    return *game;
+  }
+  // The lock is not held while the game is created, as games may load other
+  // games. Two threads missing on the same key both create it, and Insert
+  // makes them agree on the first one.
+  return cache.games.Insert(key, CreateGame(short_name, params));
+}
+
 std::shared_ptr<const Game> LoadGame(GameParameters params) {
   auto it = params.find("name");
   if (it == params.end()) {
@@ -195,12 +424,7 @@ std::shared_ptr<const Game> LoadGame(GameParameters params) {
   }
   std::string name = it->second.string_value();
   params.erase(it);
-  std::shared_ptr<const Game> result =
-      GameRegisterer::CreateByName(name, params);
-  if (result == nullptr) {
-    SpielFatalError(absl::StrCat("Unable to create game: ", name));
-  }
-  return result;
+  return LoadGame(name, params);
 }
 
 State::State(std::shared_ptr<const Game> game)
@@ -334,6 +558,15 @@ void NormalizePolicy(ActionsAndProbs* policy) {
   }
 }
 
+std::pair<Action, double> State::SampleChanceOutcome(double z) const {
+  return SampleAction(ChanceOutcomes(), z);
+}
+
+std::pair<Action, double> State::SampleChanceOutcome(
+    absl::BitGenRef rng) const {
+  return SampleChanceOutcome(absl::Uniform(rng, 0.0, 1.0));
+}
+
 std::pair<Action, double> SampleAction(const ActionsAndProbs& outcomes,
                                        absl::BitGenRef rng) {
   return SampleAction(outcomes, absl::Uniform(rng, 0.0, 1.0));
@@ -372,6 +605,46 @@ std::pair<Action, double> SampleAction(const ActionsAndProbs& outcomes,
       absl::StrCat("Internal error: failed to sample an outcome; z=", z));
 }
 
+void State::InformationStateTensor(Player player,
+                                   absl::Span<float> values) const {
+  ConvertTensor(InformationStateTensor(player), values);
+}
+
+void State::InformationStateTensor(Player player,
+                                   absl::Span<uint8_t> values) const {
+  ConvertTensor(InformationStateTensor(player), values);
+}
+
+void State::InformationStateTensor(Player player,
+                                   SparseTensor* tensor) const {
+  ConvertTensor(InformationStateTensor(player), tensor);
+}
+
+void State::LegalActionsMask(Player player, absl::Span<uint8_t> mask) const {
+  SPIEL_CHECK_EQ(mask.size(), num_distinct_actions_);
+  std::fill(mask.begin(), mask.end(), 0);
+  for (Action action : LegalActions(player)) mask[action] = 1;
+}
+
+void State::ObservationTensor(Player player, absl::Span<float> values) const {
+  ConvertTensor(ObservationTensor(player), values);
+}
+
+void State::ObservationTensor(Player player,
+                              absl::Span<uint8_t> values) const {
+  ConvertTensor(ObservationTensor(player), values);
+}
+
+void State::ObservationTensor(Player player, SparseTensor* tensor) const {
+  ConvertTensor(ObservationTensor(player), tensor);
+}
+
+void SparseTensor::ToDense(absl::Span<float> dense) const {
+  SPIEL_CHECK_EQ(dense.size(), size);
+  std::fill(dense.begin(), dense.end(), 0);
+  for (int i = 0; i < indices.size(); ++i) dense[indices[i]] = values[i];
+}
+
 std::string State::Serialize() const {
   // This simple serialization doesn't work for games with sampled chance
   // nodes, since the history doesn't give us enough information to reconstruct
@@ -382,6 +655,60 @@ std::string State::Serialize() const {
   return absl::StrCat(absl::StrJoin(History(), "\n"), "\n");
 }
 
+namespace {
+
+// The key of an action at a position in the history, as in Zobrist hashing.
+// MixBits(0) is 0, so the positions are offset by one for action 0 at the
+// start of the history to change the hash.
+uint64_t HistoryKey(int position, Action action) {
+  return MixBits(MixBits(position + 1) ^ action);
+}
+
+}  // namespace
+
+uint64_t State::HistoryHash() const {
+  if (history_hash_size_ == history_.size()) return history_hash_;
+  // history_ was modified directly.
+  uint64_t hash = 0;
+  for (int i = 0; i < history_.size(); ++i) {
+    hash ^= HistoryKey(i, history_[i]);
+  }
+  return hash;
+}
+
+void State::PushHistory(Action action) {
+  history_hash_ = HistoryHash() ^ HistoryKey(history_.size(), action);
+  history_.push_back(action);
+  history_hash_size_ = history_.size();
+}
+
+void State::PopHistory() {
+  SPIEL_CHECK_FALSE(history_.empty());
+  history_hash_ =
+      HistoryHash() ^ HistoryKey(history_.size() - 1, history_.back());
+  history_.pop_back();
+  history_hash_size_ = history_.size();
+}
+
+uint64_t State::HashValue() const { return HistoryHash(); }
+
+std::string State::SerializeBinary() const {
+  const std::vector<Action> history = History();
+  std::string bytes = {kBinarySerializationVersion, kBinaryFormatHistory};
+  AppendVarint(history.size(), &bytes);
+  for (Action action : history) AppendSignedVarint(action, &bytes);
+  const int history_size = bytes.size();
+  if (AppendSnapshot(&bytes)) {
+    bytes[1] = kBinaryFormatSnapshot;
+  } else {
+    // See Serialize() for why replaying the history is not enough here.
+    SPIEL_CHECK_NE(game_->GetType().chance_mode,
+                   GameType::ChanceMode::kSampledStochastic);
+    bytes.resize(history_size);
+  }
+  return bytes;
+}
+
 Action State::StringToAction(Player player,
                              const std::string& action_str) const {
   for (const Action action : LegalActions()) {
@@ -403,7 +730,18 @@ std::unique_ptr<State> Game::DeserializeState(const std::string& str) const {
   if (str.length() == 0) {
     return state;
   }
-  std::vector<std::string> lines = absl::StrSplit(str, '\n');
+  // State::Serialize ends each action with a newline.
+  std::vector<std::string> lines =
+      absl::StrSplit(str, '\n', absl::SkipEmpty());
+  if (game_type_.dynamics == GameType::Dynamics::kSequential) {
+    std::vector<Action> history;
+    history.reserve(lines.size());
+    for (const std::string& line : lines) {
+      history.push_back(static_cast<Action>(std::stol(line)));
+    }
+    state->ApplyActionsUnchecked(history);
+    return state;
+  }
   for (int i = 0; i < lines.size(); ++i) {
     if (state->IsSimultaneousNode()) {
       std::vector<Action> actions;
@@ -423,6 +761,50 @@ std::unique_ptr<State> Game::DeserializeState(const std::string& str) const {
   return state;
 }
 
+std::unique_ptr<State> Game::DeserializeStateBinary(
+    absl::string_view bytes) const {
+  if (bytes.size() < 2 || bytes[0] != kBinarySerializationVersion) {
+    SpielFatalError("Unsupported binary state serialization version.");
+  }
+  const char format = bytes[1];
+  VarintReader reader(bytes.substr(2));
+  std::vector<Action> history(reader.ReadSize());
+  for (Action& action : history) action = reader.ReadSigned();
+  if (!reader.ok()) SpielFatalError("Malformed binary state serialization.");
+
+  std::unique_ptr<State> state = NewInitialState();
+  if (format == kBinaryFormatSnapshot) {
+    if (!state->RestoreSnapshot(history, reader.remaining())) {
+      SpielFatalError("Malformed binary state snapshot.");
+    }
+  } else if (format == kBinaryFormatHistory && reader.empty()) {
+    ReplayHistory(history, state.get());
+  } else {
+    SpielFatalError("Malformed binary state serialization.");
+  }
+  return state;
+}
+
+void CopyOrCloneState(const State& source, std::unique_ptr<State>* dest) {
+  if (*dest != nullptr && typeid(**dest) == typeid(source) &&
+      (*dest)->CopyFrom(source)) {
+    return;
+  }
+  *dest = source.Clone();
+}
+
+void LegalActionsMasks(absl::Span<const State* const> states,
+                       absl::Span<uint8_t> masks) {
+  if (states.empty()) return;
+  const int num_distinct_actions = states[0]->NumDistinctActions();
+  SPIEL_CHECK_EQ(masks.size(), states.size() * num_distinct_actions);
+  for (int i = 0; i < states.size(); ++i) {
+    states[i]->LegalActionsMask(
+        states[i]->CurrentPlayer(),
+        masks.subspan(i * num_distinct_actions, num_distinct_actions));
+  }
+}
+
 std::string SerializeGameAndState(const Game& game, const State& state) {
   std::string str = "";
 
@@ -494,6 +876,33 @@ DeserializeGameAndState(const std::string& serialized_state) {
       game, std::move(state));
 }
 
+std::string SerializeGameAndStateBinary(const Game& game, const State& state) {
+  const std::string game_string = game.ToString();
+  std::string bytes = {kBinarySerializationVersion, kBinaryFormatGameAndState};
+  AppendVarint(game_string.size(), &bytes);
+  bytes += game_string;
+  bytes += state.SerializeBinary();
+  return bytes;
+}
+
+std::pair<std::shared_ptr<const Game>, std::unique_ptr<State>>
+DeserializeGameAndStateBinary(absl::string_view bytes) {
+  if (bytes.size() < 2 || bytes[0] != kBinarySerializationVersion ||
+      bytes[1] != kBinaryFormatGameAndState) {
+    SpielFatalError("Unsupported binary game and state serialization.");
+  }
+  VarintReader reader(bytes.substr(2));
+  const absl::string_view game_string = reader.ReadBytes(reader.ReadSize());
+  if (!reader.ok()) {
+    SpielFatalError("Malformed binary game and state serialization.");
+  }
+  std::shared_ptr<const Game> game =
+      LoadSerializedGame(std::string(game_string));
+  std::unique_ptr<State> state =
+      game->DeserializeStateBinary(reader.remaining());
+  return {std::move(game), std::move(state)};
+}
+
 std::ostream& operator<<(std::ostream& stream, GameType::Dynamics value) {
   switch (value) {
     case GameType::Dynamics::kSimultaneous:
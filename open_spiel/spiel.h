@@ -15,6 +15,7 @@
 #ifndef OPEN_SPIEL_SPIEL_H_
 #define OPEN_SPIEL_SPIEL_H_
 
+#include <cstdint>
 #include <functional>
 #include <iostream>
 #include <map>
@@ -30,8 +31,11 @@
 
 #include "open_spiel/abseil-cpp/absl/random/bit_gen_ref.h"
 #include "open_spiel/abseil-cpp/absl/strings/str_join.h"
+#include "open_spiel/abseil-cpp/absl/strings/string_view.h"
+#include "open_spiel/abseil-cpp/absl/types/span.h"
 #include "open_spiel/game_parameters.h"
 #include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/lru_cache.h"
 
 namespace open_spiel {
 
@@ -140,6 +144,12 @@ struct GameType {
   // Can the game be loaded with no parameters? It is strongly recommended that
   // games be loadable with default arguments.
   bool default_loadable = true;
+
+  // Do states with equal State::HashValue() have the same current player and
+  // observation tensors, barring hash collisions? Caches of evaluations (e.g.
+  // VPNetEvaluator's) can then look a state up by its hash without encoding
+  // its observation first.
+  bool hash_determines_observation = false;
 };
 
 enum class StateType {
@@ -166,6 +176,34 @@ enum class TensorLayout {
   kCHW,  // indexes are in the order (channels, height, width)
 };
 
+// The non-zero entries of a tensor, for encodings which are mostly zeros:
+// `values[i]` is the entry at `indices[i]` of the flattened tensor, laid out as
+// by the dense versions, and the indices are increasing. `size` is the number
+// of entries of the dense tensor.
+struct SparseTensor {
+  int size = 0;
+  std::vector<int> indices;
+  std::vector<float> values;
+
+  // Empties the tensor, keeping its storage, for a dense tensor of `size`.
+  void Reset(int dense_size) {
+    size = dense_size;
+    indices.clear();
+    values.clear();
+  }
+
+  // Appends an entry, after all those already added.
+  void Add(int index, float value = 1) {
+    SPIEL_DCHECK_TRUE(indices.empty() || indices.back() < index);
+    SPIEL_DCHECK_LT(index, size);
+    indices.push_back(index);
+    values.push_back(value);
+  }
+
+  // Writes the dense tensor into `dense`, which must hold `size` entries.
+  void ToDense(absl::Span<float> dense) const;
+};
+
 // Forward declaration needed for the backpointer within State.
 class Game;
 
@@ -184,6 +222,7 @@ class State {
   // See the documentation of the Game object for further details.
   State(std::shared_ptr<const Game> game);
   State(const State&) = default;
+  State& operator=(const State&) = default;
 
   // Returns current player. Player numbers start from 0.
   // Negative numbers are for chance (-1) or simultaneous (-2).
@@ -206,7 +245,18 @@ class State {
     // history_ needs to be modified *after* DoApplyAction which could
     // be using it.
     DoApplyAction(action_id);
-    history_.push_back(action_id);
+    PushHistory(action_id);
+  }
+
+  // Applies the actions in turn, as ApplyAction does, to rebuild a state from
+  // a history already known to be legal, e.g. when deserializing a state or
+  // replaying a trajectory. The actions are not checked: games may override
+  // DoApplyActionsUnchecked to skip their legality checks, and to bring what
+  // they derive from the position (e.g. observation planes or legal action
+  // caches) up to date once at the end rather than after each action. For
+  // sequential nodes only; see ApplyActions for simultaneous ones.
+  void ApplyActionsUnchecked(absl::Span<const Action> actions) {
+    DoApplyActionsUnchecked(actions);
   }
 
   // `LegalActions(Player player)` is valid for all nodes in all games,
@@ -239,18 +289,44 @@ class State {
   // is added.
   virtual std::vector<Action> LegalActions() const = 0;
 
+  // Same as `LegalActions()`, but writes the actions into the supplied vector
+  // instead of returning a new one. The vector is cleared first; its capacity
+  // is kept, so a caller that reuses the same buffer (e.g. in a rollout loop)
+  // does not allocate once the buffer is large enough.
+  //
+  // The default implementation forwards to `LegalActions()`. Games where
+  // legal action generation is on the hot path should override this method
+  // and implement `LegalActions()` in terms of it.
+  virtual void LegalActions(std::vector<Action>* actions) const {
+    std::vector<Action> legal_actions = LegalActions();
+    actions->assign(legal_actions.begin(), legal_actions.end());
+  }
+
+  // Returns a legal action of the current player chosen uniformly at random,
+  // without generating the list of legal actions, for fast random playouts.
+  // Must only be called at decision nodes. Returns kInvalidAction if the game
+  // does not support it, in which case callers sample from `LegalActions()`
+  // instead.
+  virtual Action SampleRandomLegalAction(absl::BitGenRef rng) const {
+    return kInvalidAction;
+  }
+
   // Returns a vector of length `game.NumDistinctActions()` containing 1 for
   // legal actions and 0 for illegal actions.
   std::vector<int> LegalActionsMask(Player player) const {
-    std::vector<int> mask(num_distinct_actions_, 0);
-    std::vector<Action> legal_actions = LegalActions(player);
-
-    for (auto const& value : legal_actions) {
-      mask[value] = 1;
-    }
-    return mask;
+    std::vector<uint8_t> mask(num_distinct_actions_);
+    LegalActionsMask(player, absl::MakeSpan(mask));
+    return std::vector<int>(mask.begin(), mask.end());
   }
 
+  // Same as `LegalActionsMask(player)`, but writes the mask into a buffer of
+  // size `game.NumDistinctActions()` supplied by the caller.
+  //
+  // The default implementation goes through `LegalActions(player)`. Games
+  // which can tell their legal actions straight from their representation
+  // (e.g. bitboards) should override it, so that no list of actions is built.
+  virtual void LegalActionsMask(Player player, absl::Span<uint8_t> mask) const;
+
   // Convenience function for turn-based games.
   std::vector<int> LegalActionsMask() const {
     return LegalActionsMask(CurrentPlayer());
@@ -344,8 +420,28 @@ class State {
   // including chance) and the `State` objects.
   virtual std::vector<Action> History() const { return history_; }
 
+  // The history without a copy, for callers which only read it.
+  const std::vector<Action>& FullHistory() const { return history_; }
+
   std::string HistoryString() const { return absl::StrJoin(history_, " "); }
 
+  // A 64-bit hash of the history, maintained as actions are applied and
+  // undone, so that it costs O(1) rather than a pass over the history. Equal
+  // histories have equal hashes. Unlike HashValue(), games do not override
+  // it, so it can key tables of histories in place of HistoryString().
+  uint64_t HistoryHash() const;
+
+  // A 64-bit hash of the state, meant as a cheap key for transposition tables
+  // and deduplication in place of ToString() or HistoryString(). States that
+  // compare equal must have the same hash; distinct states may collide, so
+  // users needing exactness must still compare the states.
+  //
+  // The default implementation hashes the history. Games where different
+  // histories lead to the same position can override it (e.g. with an
+  // incrementally updated Zobrist hash of the board) so that transpositions
+  // share a hash.
+  virtual uint64_t HashValue() const;
+
   // For imperfect information games. Returns an identifier for the current
   // information state for the specified player.
   // Different ground states can yield the same information state for a player
@@ -381,6 +477,22 @@ class State {
     return InformationStateString(CurrentPlayer());
   }
 
+  // A compact key for the information state of `player`, for tabular
+  // algorithms (e.g. the CFR family) that would otherwise build and hash
+  // InformationStateString on every visit. At the nodes where `player` acts,
+  // two states must have the same key exactly when they have the same
+  // InformationStateString. Keys are opaque byte strings; games overriding
+  // this should pack them tightly (e.g. as varints) so that they usually fit
+  // in std::string's inline buffer and need no allocation.
+  //
+  // The default implementation returns InformationStateString(player).
+  virtual std::string InformationStateKey(Player player) const {
+    return InformationStateString(player);
+  }
+  std::string InformationStateKey() const {
+    return InformationStateKey(CurrentPlayer());
+  }
+
   // Vector form, useful for neural-net function approximation approaches.
   // The size of the vector must match Game::InformationStateShape()
   // with values in lexicographic order. E.g. for 2x4x3, order would be:
@@ -407,6 +519,25 @@ class State {
     return InformationStateTensor(CurrentPlayer());
   }
 
+  // Reduced-precision versions writing into a buffer owned by the caller,
+  // which must hold exactly Game::InformationStateTensorSize() elements. These
+  // are meant for feeding neural networks and filling replay buffers, which
+  // want float32 or byte planes rather than doubles. The default
+  // implementations go through the std::vector<double> version and convert;
+  // games can override them to write the buffer directly. The uint8_t version
+  // requires every value of the tensor to be an integer in [0, 255].
+  virtual void InformationStateTensor(Player player,
+                                      absl::Span<float> values) const;
+  virtual void InformationStateTensor(Player player,
+                                      absl::Span<uint8_t> values) const;
+
+  // Sparse version, for encodings which are mostly zeros, e.g. to feed
+  // embedding layers: overwrites `tensor` with the non-zero entries. The
+  // default goes through the std::vector<double> version; games whose tensors
+  // are large and sparse override it to write only the non-zero entries.
+  virtual void InformationStateTensor(Player player,
+                                      SparseTensor* tensor) const;
+
   // We have functions for observations which are parallel to those for
   // information states. An observation should have the following properties:
   //  - It has at most the same information content as the information state
@@ -455,9 +586,49 @@ class State {
     return ObservationTensor(CurrentPlayer());
   }
 
+  // Reduced-precision and sparse versions, the first two writing into a buffer
+  // owned by the caller, of size Game::ObservationTensorSize(). See
+  // InformationStateTensor above.
+  virtual void ObservationTensor(Player player, absl::Span<float> values) const;
+  virtual void ObservationTensor(Player player,
+                                 absl::Span<uint8_t> values) const;
+  virtual void ObservationTensor(Player player, SparseTensor* tensor) const;
+
+  // Incremental version of ObservationTensor(player, values), for callers
+  // that keep each player's tensor from one step of a game to the next.
+  // `values` must hold the player's observation tensor of the state before the
+  // last action of the history; only the entries which that action may have
+  // changed are rewritten, after which `values` is this state's tensor. Must
+  // not be called on an initial state. Returns false, leaving `values`
+  // untouched, if the game does not support it; the caller should then call
+  // ObservationTensor.
+  virtual bool UpdateObservationTensor(Player player,
+                                       absl::Span<float> values) const {
+    return false;
+  }
+
   // Return a copy of this state.
   virtual std::unique_ptr<State> Clone() const = 0;
 
+  // Overwrites this state with a copy of `other`, reusing the storage already
+  // owned by this object (e.g. history_) rather than allocating a new state.
+  // `other` must be a state of the same game and of the same concrete type as
+  // this one. Returns false, leaving this state unchanged, if the game does not
+  // support in-place copies; use CopyOrCloneState below to fall back to
+  // Clone() in that case.
+  virtual bool CopyFrom(const State& other) { return false; }
+
+  // An estimate of the memory the state uses, in bytes: the object itself and
+  // the heap memory it owns (e.g. history_ and boards held in vectors), but
+  // not what it shares with other states, such as the game. It is what a
+  // Clone() costs, which search algorithms keeping states account for. The
+  // default only knows of the State base class, so games with larger states
+  // should override it, typically as sizeof(*this) + HistoryMemoryUsage()
+  // plus the capacity of their own containers.
+  virtual int64_t ApproximateMemoryUsage() const {
+    return sizeof(State) + HistoryMemoryUsage();
+  }
+
   // Creates the child from State corresponding to action.
   std::unique_ptr<State> Child(Action action) const {
     std::unique_ptr<State> child = Clone();
@@ -468,11 +639,16 @@ class State {
   // Undoes the last action, which must be supplied. This is a fast method to
   // undo an action. It is only necessary for algorithms that need a fast undo
   // (e.g. minimax search).
-  // One must call history_.pop_back() in the implementations.
+  // One must call PopHistory() in the implementations.
   virtual void UndoAction(Player player, Action action) {
     SpielFatalError("UndoAction function is not overridden; not undoing.");
   }
 
+  // Whether UndoAction is implemented, and exactly restores everything the
+  // state exposes. Tree walks (see algorithms/scoped_child.h) then apply and
+  // undo actions on a single state instead of cloning one per node.
+  virtual bool SupportsUndoAction() const { return false; }
+
   // Change the state of the game by applying the specified actions, one per
   // player, for simultaneous action games. This function encodes the logic of
   // the game rules. Element i of the vector is the action for player i.
@@ -485,7 +661,7 @@ class State {
     // be using it.
     DoApplyActions(actions);
     history_.reserve(history_.size() + actions.size());
-    history_.insert(history_.end(), actions.begin(), actions.end());
+    for (Action action : actions) PushHistory(action);
   }
 
   // The size of the action space. See `Game` for a full description.
@@ -525,6 +701,17 @@ class State {
     return outcome_list;
   }
 
+  // Samples a chance outcome, returned with its probability, as
+  // SampleAction(ChanceOutcomes(), z) does, for search and sampling algorithms
+  // that need one outcome rather than the distribution. z should be uniform on
+  // [0, 1). Derived classes may override it to sample without building the
+  // outcomes, e.g. uniformly over the cards left in the deck, or from an
+  // AliasTable (see utils/alias_table.h) of a distribution which never changes.
+  // An override must sample the same distribution, but need not map each z to
+  // the outcome SampleAction would.
+  virtual std::pair<Action, double> SampleChanceOutcome(double z) const;
+  std::pair<Action, double> SampleChanceOutcome(absl::BitGenRef rng) const;
+
   // Returns the type of the state. Either Chance, Terminal, or Decision. See
   // StateType definition for definitions of the different types.
   StateType GetType() const;
@@ -540,6 +727,29 @@ class State {
   // If overridden, this must be the inverse of Game::DeserializeState.
   virtual std::string Serialize() const;
 
+  // Compact binary alternative to Serialize(), the inverse of
+  // Game::DeserializeStateBinary. The encoding starts with a format version,
+  // followed by the varint-packed history and, for games that support it, a
+  // game-specific snapshot (see AppendSnapshot) from which the state is
+  // restored without replaying the history. Without a snapshot, the same
+  // restrictions as the default Serialize() apply.
+  std::string SerializeBinary() const;
+
+  // Game-specific snapshot used by SerializeBinary. Implementations append to
+  // `bytes` enough information to rebuild the state (apart from its history,
+  // which is stored separately) and return true; the default returns false,
+  // meaning the state is rebuilt by replaying its history.
+  virtual bool AppendSnapshot(std::string* bytes) const { return false; }
+
+  // Inverse of AppendSnapshot: overwrites this state, a new initial state of
+  // the same game, from `bytes`. `history` is the sequence of actions leading
+  // to the snapshotted state, which must become this state's history. Returns
+  // false if `bytes` is malformed.
+  virtual bool RestoreSnapshot(const std::vector<Action>& history,
+                               absl::string_view bytes) {
+    return false;
+  }
+
   // Resamples a new history from the information state from player_id's view.
   // This resamples a private for the other players, but holds player_id's
   // privates constant, and the public information constant.
@@ -581,6 +791,22 @@ class State {
   virtual void DoApplyActions(const std::vector<Action>& actions) {
     SpielFatalError("DoApplyActions is not implemented.");
   }
+  // See ApplyActionsUnchecked. Overrides must push each action to the
+  // history, like ApplyAction. By default, applies each with ApplyAction.
+  virtual void DoApplyActionsUnchecked(absl::Span<const Action> actions) {
+    for (Action action : actions) ApplyAction(action);
+  }
+
+  // Append to and remove from history_, keeping HistoryHash() up to date.
+  // Modifying history_ directly is allowed, but the hash then has to be
+  // recomputed from the whole history on the next call.
+  void PushHistory(Action action);
+  void PopHistory();
+
+  // The heap memory of history_, for ApproximateMemoryUsage.
+  int64_t HistoryMemoryUsage() const {
+    return history_.capacity() * sizeof(Action);
+  }
 
   // Fields common to every game state.
   int num_distinct_actions_;
@@ -589,6 +815,12 @@ class State {
 
   // A pointer to the game that created this state.
   std::shared_ptr<const Game> game_;
+
+ private:
+  // The XOR of a key per (position, action) in history_, for the first
+  // history_hash_size_ actions.
+  uint64_t history_hash_ = 0;
+  int history_hash_size_ = 0;
 };
 
 // A class that refers to a particular game instantiation, for example
@@ -716,6 +948,10 @@ class Game : public std::enable_shared_from_this<Game> {
   // Game::SerializeState (i.e. that method should also be overridden).
   virtual std::unique_ptr<State> DeserializeState(const std::string& str) const;
 
+  // Returns a newly allocated state built from the output of
+  // State::SerializeBinary. Malformed input is a fatal error.
+  std::unique_ptr<State> DeserializeStateBinary(absl::string_view bytes) const;
+
   // The maximum length of any one game (in terms of number of decision nodes
   // visited in the game tree). For a simultaneous action game, this is the
   // maximum number of joint decisions. In a turn-based game, this is the
@@ -754,30 +990,41 @@ class Game : public std::enable_shared_from_this<Game> {
 #define REGISTER_SPIEL_GAME(info, factory) \
   GameRegisterer CONCAT(game, __COUNTER__)(info, factory);
 
+// The registry of games. The games of a binary register themselves with
+// REGISTER_SPIEL_GAME when it starts, and those of a game library when it is
+// opened; see LoadGameLibrary. It is thread-safe.
 class GameRegisterer {
  public:
   using CreateFunc =
       std::function<std::shared_ptr<const Game>(const GameParameters& params)>;
 
+  // Only records the game: its type, which must outlive the registerer as
+  // with REGISTER_SPIEL_GAME's static objects, is copied into the registry on
+  // its first use, so the games a binary links but never loads cost little
+  // at startup.
   GameRegisterer(const GameType& game_type, CreateFunc creator);
 
+  // Unknown games are looked for in the game libraries, before failing.
   static std::shared_ptr<const Game> CreateByName(const std::string& short_name,
                                                   const GameParameters& params);
 
+  // These only cover the games registered so far, not those of the game
+  // libraries which were not opened.
   static std::vector<std::string> RegisteredNames();
   static std::vector<GameType> RegisteredGames();
   static bool IsValidName(const std::string& short_name);
   static void RegisterGame(const GameType& game_type, CreateFunc creator);
 
  private:
-  // Returns a "global" map of registrations (i.e. an object that lives from
-  // initialization to the end of the program). Note that we do not just use
-  // a static data member, as we want the map to be initialized before first
-  // use.
-  static std::map<std::string, std::pair<GameType, CreateFunc>>& factories() {
-    static std::map<std::string, std::pair<GameType, CreateFunc>> impl;
-    return impl;
-  }
+  struct Registry;
+  // Returns the registry, which is created on first use and never destroyed,
+  // so that it outlives the registerers of all the translation units.
+  static Registry& GetRegistry();
+
+  const GameType& game_type_;
+  CreateFunc creator_;
+  // The previous registerer not yet copied into the registry.
+  GameRegisterer* next_ = nullptr;
 };
 
 // Returns true if the game is registered, false otherwise.
@@ -789,6 +1036,19 @@ std::vector<std::string> RegisteredGames();
 // Returns a list of registered game types.
 std::vector<GameType> RegisteredGameTypes();
 
+// Opens a shared library of games, whose games register themselves as it is
+// loaded, e.g. one of the libopen_spiel_game_<short_name>.so built with the
+// CMake option OPEN_SPIEL_GAME_LIBRARIES. Their undefined symbols, such as
+// those of spiel.cc, are resolved against the binary, which must export them
+// (CMake's ENABLE_EXPORTS). Fails if the library cannot be opened.
+//
+// LoadGame does this by itself when asked for a game which is not registered:
+// it opens libopen_spiel_game_<short_name>.so from the first directory of the
+// colon-separated OPEN_SPIEL_GAME_LIBRARY_PATH environment variable which has
+// it. So a small binary linking only the core objects only pays for the games
+// it loads.
+void LoadGameLibrary(const std::string& path);
+
 // Returns a new game object from the specified string, which is the short
 // name plus optional parameters, e.g. "go(komi=4.5,board_size=19)"
 std::shared_ptr<const Game> LoadGame(const std::string& game_string);
@@ -802,6 +1062,31 @@ std::shared_ptr<const Game> LoadGame(const std::string& short_name,
 // implementation).
 std::shared_ptr<const Game> LoadGame(GameParameters params);
 
+// An opt-in cache for LoadGame, for callers that load the same games over and
+// over (e.g. DeserializeGameAndState on every request). While enabled, all the
+// LoadGame overloads return the same Game object for the same name and
+// parameters, as compared through their canonical string (so "go(komi=7.5,
+// board_size=9)" and "go(board_size=9,komi=7.5)" share an entry), keeping the
+// `max_size` most recently used games alive. LoadGame stays thread-safe, but
+// the cache should be enabled or disabled before games are loaded from other
+// threads.
+//
+// Only parameters spelled out by the caller are part of the key: "go" and
+// "go(board_size=19)" are cached separately.
+void EnableLoadGameCache(int max_size);
+
+// Disables the cache, and drops all the games and statistics it holds.
+void DisableLoadGameCache();
+
+// Hits, misses and size of the cache since it was last disabled.
+LRUCacheInfo LoadGameCacheInfo();
+
+// LoadGame(game_string) through a small cache of its own, keyed by the exact
+// string, for deserializers which see the same few game strings over and
+// over, such as unpickling in worker processes. Unlike EnableLoadGameCache,
+// it is always on, and hits skip parsing the string.
+std::shared_ptr<const Game> LoadSerializedGame(const std::string& game_string);
+
 // Normalize a policy into a proper discrete distribution where the
 // probabilities sum to 1.
 void NormalizePolicy(ActionsAndProbs* policy);
@@ -815,6 +1100,19 @@ std::pair<Action, double> SampleAction(const ActionsAndProbs& outcomes,
 std::pair<Action, double> SampleAction(const ActionsAndProbs& outcomes,
                                        absl::BitGenRef rng);
 
+// Makes `*dest` a copy of `source`. If `*dest` already holds a state of the
+// same concrete type, it is overwritten in place via State::CopyFrom so that
+// its storage is reused; otherwise (or if the game does not implement
+// CopyFrom) it is replaced by `source.Clone()`. Intended for search loops that
+// repeatedly reset a scratch state to the same root.
+void CopyOrCloneState(const State& source, std::unique_ptr<State>* dest);
+
+// Writes the legal actions masks of the current players of many states of the
+// same game, one after the other, into `masks`, of size states.size() times
+// NumDistinctActions(). See State::LegalActionsMask.
+void LegalActionsMasks(absl::Span<const State* const> states,
+                       absl::Span<uint8_t> masks);
+
 // Serialize the game and the state into one self-contained string that can
 // be reloaded via open_spiel::DeserializeGameAndState.
 //
@@ -852,6 +1150,14 @@ std::string SerializeGameAndState(const Game& game, const State& state);
 std::pair<std::shared_ptr<const Game>, std::unique_ptr<State>>
 DeserializeGameAndState(const std::string& serialized_state);
 
+// Binary counterparts of the above: the game string followed by
+// State::SerializeBinary, so that states with a snapshot are restored without
+// replaying their history, and the game is loaded with LoadSerializedGame.
+// Malformed input is a fatal error.
+std::string SerializeGameAndStateBinary(const Game& game, const State& state);
+std::pair<std::shared_ptr<const Game>, std::unique_ptr<State>>
+DeserializeGameAndStateBinary(absl::string_view bytes);
+
 // We alias this here as we can't import state_distribution.h or we'd have a
 // circular dependency.
 using HistoryDistribution =
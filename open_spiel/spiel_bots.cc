@@ -14,6 +14,7 @@
 
 #include "open_spiel/spiel_bots.h"
 
+#include <future>  // NOLINT
 #include <memory>
 #include <random>
 #include <unordered_set>
@@ -21,6 +22,7 @@
 #include <vector>
 
 #include "open_spiel/abseil-cpp/absl/random/uniform_int_distribution.h"
+#include "open_spiel/abseil-cpp/absl/time/time.h"
 #include "open_spiel/policy.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
@@ -163,6 +165,13 @@ class FixedActionPreferenceBot : public Bot {
 
 }  // namespace
 
+std::future<Action> Bot::StartStep(const State& state, absl::Time deadline) {
+  return std::async(std::launch::async,
+                    [this, state = state.Clone(), deadline]() {
+                      return StepUntil(*state, deadline);
+                    });
+}
+
 // A uniform random bot, for test purposes.
 std::unique_ptr<Bot> MakeUniformRandomBot(Player player_id, int seed) {
   return std::make_unique<UniformRandomBot>(player_id, seed);
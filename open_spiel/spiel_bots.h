@@ -15,10 +15,12 @@
 #ifndef OPEN_SPIEL_SPIEL_BOTS_H_
 #define OPEN_SPIEL_SPIEL_BOTS_H_
 
+#include <future>  // NOLINT
 #include <memory>
 #include <utility>
 #include <vector>
 
+#include "open_spiel/abseil-cpp/absl/time/time.h"
 #include "open_spiel/policy.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
@@ -78,6 +80,19 @@ class Bot {
   // safely assumes the action was played.
   virtual Action Step(const State& state) = 0;
 
+  // Like Step, but the bot should return by the deadline, e.g. that of a game
+  // server. Bots which cannot stop their search early ignore it, as does the
+  // default implementation, which calls Step.
+  virtual Action StepUntil(const State& state, absl::Time deadline) {
+    return Step(state);
+  }
+
+  // Starts StepUntil on a copy of the state in another thread, and returns the
+  // future action. The bot must not be used again until the action is ready,
+  // and must outlive the future; destroying the future waits for the step.
+  std::future<Action> StartStep(
+      const State& state, absl::Time deadline = absl::InfiniteFuture());
+
   // Let the bot know that a different player made an action at a given state.
   // This is useful for stateful bots so they know that the state of the game
   // has advanced. This should not be called for the bot that generated the
@@ -138,6 +153,17 @@ class Bot {
           "policy.");
     }
   }
+
+  // Returns `true` if the bot can think during the other players' turns.
+  virtual bool ProvidesPondering() { return false; }
+  // Tells the bot that the state was reached after its own move, and that it
+  // may think in the background while the other players decide, e.g. a search
+  // bot searching their likely replies to reuse in its next step. The bot
+  // stops by itself on the next call to Step, InformAction or Restart, or on
+  // StopPondering. The default implementations do nothing, so they can be
+  // called whether or not the bot provides pondering.
+  virtual void StartPondering(const State& state) {}
+  virtual void StopPondering() {}
 };
 
 // A uniform random bot, for test purposes.
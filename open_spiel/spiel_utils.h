@@ -123,6 +123,15 @@ int NextPlayerRoundRobin(Player player, int nplayers);
 // Helper function to determine the previous player in a round robin.
 int PreviousPlayerRoundRobin(Player player, int nplayers);
 
+// Scrambles the bits of `value` (the splitmix64 finalizer), so that nearby
+// inputs give unrelated outputs. Useful to derive hash keys from small integers
+// such as actions or (cell, piece) indices.
+inline uint64_t MixBits(uint64_t value) {
+  value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+  return value ^ (value >> 31);
+}
+
 // Finds a file by looking up a number of directories. For example: if levels is
 // 3 and filename is my.txt, it will look for ./my.txt, ../my.txt, ../../my.txt,
 // and ../../../my.txt, return the first file found or std::nullopt if not
@@ -213,6 +222,52 @@ bool Near(T a, T b, T epsilon) {
   open_spiel::SpielFatalError(open_spiel::internal::SpielStrCat( \
       __FILE__, ":", __LINE__, " CHECK_FALSE(", #x, ")"))
 
+// Assertion levels. SPIEL_CHECK_* are always on, and guard what comes from
+// outside the code checked: the actions, players, parameters and buffers
+// passed in, and files read. The internal invariants of hot paths, e.g. move
+// generation or filling tensors, use SPIEL_DCHECK_*, which are on at
+// OPEN_SPIEL_CHECK_LEVEL 1 and up, the default, and the expensive checks, e.g.
+// of every tensor index, SPIEL_PARANOID_CHECK_*, on at level 2. At level 0,
+// e.g. for actors in production, only the SPIEL_CHECK_* remain. Disabled
+// checks are compiled but never evaluated. The level is set by the cmake
+// option of the same name.
+#ifndef OPEN_SPIEL_CHECK_LEVEL
+#define OPEN_SPIEL_CHECK_LEVEL 1
+#endif
+
+#define SPIEL_DISABLED_CHECK(check) \
+  while (false) check
+
+#if OPEN_SPIEL_CHECK_LEVEL >= 1
+#define SPIEL_DCHECK(check) check
+#else
+#define SPIEL_DCHECK(check) SPIEL_DISABLED_CHECK(check)
+#endif
+
+#if OPEN_SPIEL_CHECK_LEVEL >= 2
+#define SPIEL_PARANOID_CHECK(check) check
+#else
+#define SPIEL_PARANOID_CHECK(check) SPIEL_DISABLED_CHECK(check)
+#endif
+
+#define SPIEL_DCHECK_GE(x, y) SPIEL_DCHECK(SPIEL_CHECK_GE(x, y))
+#define SPIEL_DCHECK_GT(x, y) SPIEL_DCHECK(SPIEL_CHECK_GT(x, y))
+#define SPIEL_DCHECK_LE(x, y) SPIEL_DCHECK(SPIEL_CHECK_LE(x, y))
+#define SPIEL_DCHECK_LT(x, y) SPIEL_DCHECK(SPIEL_CHECK_LT(x, y))
+#define SPIEL_DCHECK_EQ(x, y) SPIEL_DCHECK(SPIEL_CHECK_EQ(x, y))
+#define SPIEL_DCHECK_NE(x, y) SPIEL_DCHECK(SPIEL_CHECK_NE(x, y))
+#define SPIEL_DCHECK_TRUE(x) SPIEL_DCHECK(SPIEL_CHECK_TRUE(x))
+#define SPIEL_DCHECK_FALSE(x) SPIEL_DCHECK(SPIEL_CHECK_FALSE(x))
+
+#define SPIEL_PARANOID_CHECK_GE(x, y) SPIEL_PARANOID_CHECK(SPIEL_CHECK_GE(x, y))
+#define SPIEL_PARANOID_CHECK_GT(x, y) SPIEL_PARANOID_CHECK(SPIEL_CHECK_GT(x, y))
+#define SPIEL_PARANOID_CHECK_LE(x, y) SPIEL_PARANOID_CHECK(SPIEL_CHECK_LE(x, y))
+#define SPIEL_PARANOID_CHECK_LT(x, y) SPIEL_PARANOID_CHECK(SPIEL_CHECK_LT(x, y))
+#define SPIEL_PARANOID_CHECK_EQ(x, y) SPIEL_PARANOID_CHECK(SPIEL_CHECK_EQ(x, y))
+#define SPIEL_PARANOID_CHECK_NE(x, y) SPIEL_PARANOID_CHECK(SPIEL_CHECK_NE(x, y))
+#define SPIEL_PARANOID_CHECK_TRUE(x) SPIEL_PARANOID_CHECK(SPIEL_CHECK_TRUE(x))
+#define SPIEL_PARANOID_CHECK_FALSE(x) SPIEL_PARANOID_CHECK(SPIEL_CHECK_FALSE(x))
+
 // When an error is encountered, OpenSpiel code should call SpielFatalError()
 // which will forward the message to the current error handler.
 // The default error handler outputs the error message to stderr, and exits
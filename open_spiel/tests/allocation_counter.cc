@@ -0,0 +1,125 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/tests/allocation_counter.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace open_spiel {
+namespace testing {
+namespace {
+
+// The totals of the thread, which the counters take differences of.
+thread_local int64_t thread_allocations = 0;
+thread_local int64_t thread_bytes = 0;
+thread_local int64_t thread_live_bytes = 0;
+thread_local int64_t thread_peak_live_bytes = 0;
+
+// Each allocation is preceded by a header, which ends with its size so that
+// it can be freed from the pointer. The header keeps the allocation aligned.
+std::size_t HeaderBytes(std::size_t alignment) {
+  return std::max(alignment, alignof(std::max_align_t));
+}
+
+void* CountedAlloc(std::size_t size, std::size_t alignment) {
+  ++thread_allocations;
+  thread_bytes += size;
+  const std::size_t header = HeaderBytes(alignment);
+  char* block;
+  if (alignment <= alignof(std::max_align_t)) {
+    block = static_cast<char*>(std::malloc(header + size));
+  } else {
+    // aligned_alloc wants a multiple of the alignment.
+    block = static_cast<char*>(std::aligned_alloc(
+        alignment, (header + size + alignment - 1) / alignment * alignment));
+  }
+  if (block == nullptr) return nullptr;
+  char* ptr = block + header;
+  reinterpret_cast<std::size_t*>(ptr)[-1] = size;
+  thread_live_bytes += size;
+  thread_peak_live_bytes = std::max(thread_peak_live_bytes, thread_live_bytes);
+  return ptr;
+}
+
+void CountedFree(void* ptr, std::size_t alignment) {
+  if (ptr == nullptr) return;
+  thread_live_bytes -= static_cast<std::size_t*>(ptr)[-1];
+  std::free(static_cast<char*>(ptr) - HeaderBytes(alignment));
+}
+
+}  // namespace
+
+AllocationCounter::AllocationCounter()
+    : start_allocations_(thread_allocations),
+      start_bytes_(thread_bytes),
+      start_live_bytes_(thread_live_bytes) {
+  ResetPeak();
+}
+
+int64_t AllocationCounter::Allocations() const {
+  return thread_allocations - start_allocations_;
+}
+
+int64_t AllocationCounter::Bytes() const {
+  return thread_bytes - start_bytes_;
+}
+
+int64_t AllocationCounter::LiveBytes() const {
+  return thread_live_bytes - start_live_bytes_;
+}
+
+int64_t AllocationCounter::PeakLiveBytes() const {
+  return thread_peak_live_bytes - start_live_bytes_;
+}
+
+void AllocationCounter::ResetPeak() {
+  thread_peak_live_bytes = thread_live_bytes;
+}
+
+}  // namespace testing
+}  // namespace open_spiel
+
+// The replacements of the global allocation functions. The array and
+// nothrow forms default to calling these, so only the deletes that release
+// their memory need replacing too.
+void* operator new(std::size_t size) {
+  void* ptr = open_spiel::testing::CountedAlloc(size, 0);
+  if (ptr == nullptr) throw std::bad_alloc();
+  return ptr;
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+  void* ptr = open_spiel::testing::CountedAlloc(
+      size, static_cast<std::size_t>(alignment));
+  if (ptr == nullptr) throw std::bad_alloc();
+  return ptr;
+}
+
+void operator delete(void* ptr) noexcept {
+  open_spiel::testing::CountedFree(ptr, 0);
+}
+void operator delete(void* ptr, std::size_t) noexcept {
+  open_spiel::testing::CountedFree(ptr, 0);
+}
+void operator delete(void* ptr, std::align_val_t alignment) noexcept {
+  open_spiel::testing::CountedFree(ptr, static_cast<std::size_t>(alignment));
+}
+void operator delete(void* ptr, std::size_t,
+                     std::align_val_t alignment) noexcept {
+  open_spiel::testing::CountedFree(ptr, static_cast<std::size_t>(alignment));
+}
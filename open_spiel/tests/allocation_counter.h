@@ -0,0 +1,68 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_TESTS_ALLOCATION_COUNTER_H_
+#define OPEN_SPIEL_TESTS_ALLOCATION_COUNTER_H_
+
+#include <cstdint>
+
+namespace open_spiel {
+namespace testing {
+
+// Counts the heap allocations the calling thread makes while it is in scope,
+// e.g. to check that a hot path doesn't allocate:
+//
+//   AllocationCounter counter;
+//   state->ApplyAction(action);
+//   SPIEL_CHECK_EQ(counter.Allocations(), 0);
+//
+// The binary's global operator new is replaced by allocation_counter.cc to
+// count them, so this counts what goes through new, including that of the
+// standard containers, but not direct calls to malloc, nor the allocations of
+// other threads.
+//
+// It also follows the bytes the thread has allocated and not freed yet, and
+// their peak, e.g. for the memory a solver needs:
+//
+//   AllocationCounter counter;
+//   solver.RunIteration();
+//   int64_t peak = counter.PeakLiveBytes();
+class AllocationCounter {
+ public:
+  // Also restarts the peak of the thread's live bytes.
+  AllocationCounter();
+
+  // Since construction.
+  int64_t Allocations() const;
+  int64_t Bytes() const;
+
+  // The bytes allocated and not freed by the thread since construction, which
+  // is negative if it freed more than it allocated.
+  int64_t LiveBytes() const;
+
+  // The highest LiveBytes() since construction or the last ResetPeak(), unless
+  // another counter of the thread was constructed or reset since.
+  int64_t PeakLiveBytes() const;
+  void ResetPeak();
+
+ private:
+  int64_t start_allocations_;
+  int64_t start_bytes_;
+  int64_t start_live_bytes_;
+};
+
+}  // namespace testing
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_TESTS_ALLOCATION_COUNTER_H_
@@ -0,0 +1,98 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/tests/allocation_counter.h"
+
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/tests/basic_tests.h"
+#include "open_spiel/utils/thread.h"
+
+namespace open_spiel {
+namespace testing {
+namespace {
+
+struct alignas(64) Aligned {
+  char data[64];
+};
+
+void CountsAllocationsTest() {
+  AllocationCounter counter;
+  SPIEL_CHECK_EQ(counter.Allocations(), 0);
+  std::vector<int64_t> values(100);
+  SPIEL_CHECK_EQ(counter.Allocations(), 1);
+  SPIEL_CHECK_EQ(counter.Bytes(), 100 * sizeof(int64_t));
+  auto array = std::make_unique<int[]>(10);
+  auto aligned = std::make_unique<Aligned>();
+  SPIEL_CHECK_EQ(reinterpret_cast<uintptr_t>(aligned.get()) % 64, 0);
+  delete new (std::nothrow) int;
+  SPIEL_CHECK_EQ(counter.Allocations(), 4);
+
+  {
+    AllocationCounter nested;
+    values.push_back(1);  // Grows.
+    SPIEL_CHECK_EQ(nested.Allocations(), 1);
+  }
+  SPIEL_CHECK_EQ(counter.Allocations(), 5);
+
+  // Other threads' allocations don't count.
+  Thread thread([]() { std::string s(1000, 'x'); });
+  AllocationCounter joining;
+  thread.join();
+  SPIEL_CHECK_EQ(joining.Allocations(), 0);
+}
+
+void LiveBytesTest() {
+  AllocationCounter counter;
+  auto values = std::make_unique<std::vector<int64_t>>(100);
+  const int64_t vector_bytes = sizeof(std::vector<int64_t>);
+  SPIEL_CHECK_EQ(counter.LiveBytes(), vector_bytes + 100 * sizeof(int64_t));
+  auto aligned = std::make_unique<Aligned>();
+  aligned.reset();
+  values.reset();
+  SPIEL_CHECK_EQ(counter.LiveBytes(), 0);
+  SPIEL_CHECK_EQ(counter.PeakLiveBytes(),
+                 vector_bytes + 100 * sizeof(int64_t) + sizeof(Aligned));
+
+  counter.ResetPeak();
+  std::make_unique<char[]>(1000).reset();
+  SPIEL_CHECK_EQ(counter.LiveBytes(), 0);
+  SPIEL_CHECK_EQ(counter.PeakLiveBytes(), 1000);
+}
+
+void RandomSimAllocationsTest() {
+  std::mt19937 rng;
+  std::shared_ptr<const Game> game = LoadGame("tic_tac_toe");
+  AllocationReport report = RandomSimAllocations(*game, 10, &rng);
+  // A vector of actions, and a state with its history.
+  SPIEL_CHECK_GE(report.legal_actions, 1);
+  SPIEL_CHECK_GE(report.clone, 1);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  open_spiel::testing::CountsAllocationsTest();
+  open_spiel::testing::LiveBytesTest();
+  open_spiel::testing::RandomSimAllocationsTest();
+}
@@ -14,19 +14,28 @@
 
 #include "open_spiel/tests/basic_tests.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <iostream>
+#include <iterator>
 #include <memory>
 #include <numeric>
 #include <optional>
 #include <random>
 #include <set>
 #include <string>
+#include <unordered_map>
 
+#include "open_spiel/abseil-cpp/absl/algorithm/container.h"
 #include "open_spiel/abseil-cpp/absl/random/uniform_int_distribution.h"
 #include "open_spiel/abseil-cpp/absl/time/clock.h"
+#include "open_spiel/abseil-cpp/absl/types/span.h"
 #include "open_spiel/game_transforms/turn_based_simultaneous_game.h"
+#include "open_spiel/policy.h"
 #include "open_spiel/spiel.h"
 #include "open_spiel/spiel_utils.h"
+#include "open_spiel/tests/allocation_counter.h"
 
 namespace open_spiel {
 namespace testing {
@@ -76,6 +85,12 @@ void ApplyActionTestClone(const Game& game, State* state, Action action) {
   clone->ApplyAction(action);
   SPIEL_CHECK_EQ(state->ToString(), clone->ToString());
   SPIEL_CHECK_EQ(state->History(), clone->History());
+
+  // Copy into an existing state, which uses CopyFrom when implemented.
+  std::unique_ptr<State> copy = game.NewInitialState();
+  CopyOrCloneState(*state, &copy);
+  SPIEL_CHECK_EQ(state->ToString(), copy->ToString());
+  SPIEL_CHECK_EQ(state->History(), copy->History());
 }
 
 // Check that the legal actions list is empty for the non-current player.
@@ -137,10 +152,99 @@ void LegalActionsMaskTest(const Game& game, const State& state,
   }
 
   SPIEL_CHECK_EQ(num_ones, legal_actions.size());
+
+  // The masks of every player agree with their legal actions.
+  for (auto p = Player{0}; p < game.NumPlayers(); ++p) {
+    std::vector<int> expected(game.NumDistinctActions(), 0);
+    for (Action action : state.LegalActions(p)) expected[action] = 1;
+    SPIEL_CHECK_EQ(state.LegalActionsMask(p), expected);
+  }
+
+  // The batched version overwrites stale contents.
+  const std::vector<const State*> states = {&state, &state};
+  std::vector<uint8_t> masks(states.size() * game.NumDistinctActions(), 2);
+  LegalActionsMasks(absl::MakeConstSpan(states), absl::MakeSpan(masks));
+  for (int i = 0; i < masks.size(); ++i) {
+    SPIEL_CHECK_EQ(masks[i],
+                   legal_actions_mask[i % game.NumDistinctActions()]);
+  }
+}
+
+// Check that the buffer-filling LegalActions overload agrees with the one
+// returning a new vector, even when the buffer holds stale contents.
+void LegalActionsBufferTest(const State& state,
+                            const std::vector<Action>& legal_actions) {
+  std::vector<Action> buffer = {kInvalidAction, kInvalidAction};
+  state.LegalActions(&buffer);
+  SPIEL_CHECK_EQ(buffer, legal_actions);
+}
+
+// Check that the actions sampled by SampleRandomLegalAction, if the game
+// supports it, are legal. It uses its own random generator so that the
+// simulation does not depend on it.
+void SampleRandomLegalActionTest(const State& state,
+                                 const std::vector<Action>& legal_actions) {
+  std::mt19937 rng(legal_actions.size());
+  for (int i = 0; i < 5; ++i) {
+    Action action = state.SampleRandomLegalAction(rng);
+    if (action == kInvalidAction) return;
+    SPIEL_CHECK_TRUE(absl::c_linear_search(legal_actions, action));
+  }
+}
+
+// Check that the reduced-precision and sparse tensor overloads agree with the
+// std::vector<double> ones: float and sparse always, and uint8_t whenever the
+// tensor only holds byte values.
+template <typename TensorFn>
+void TensorOverloadsTest(const std::vector<double>& tensor,
+                         TensorFn write_tensor) {
+  std::vector<float> float_tensor(tensor.size(), -1);
+  write_tensor(absl::MakeSpan(float_tensor));
+  for (int i = 0; i < tensor.size(); ++i) {
+    SPIEL_CHECK_EQ(float_tensor[i], static_cast<float>(tensor[i]));
+  }
+  SparseTensor sparse;
+  write_tensor(&sparse);
+  SPIEL_CHECK_EQ(sparse.size, tensor.size());
+  SPIEL_CHECK_EQ(sparse.indices.size(), sparse.values.size());
+  for (int i = 0; i < sparse.indices.size(); ++i) {
+    if (i > 0) SPIEL_CHECK_LT(sparse.indices[i - 1], sparse.indices[i]);
+    SPIEL_CHECK_NE(sparse.values[i], 0);
+  }
+  std::fill(float_tensor.begin(), float_tensor.end(), -1);
+  sparse.ToDense(absl::MakeSpan(float_tensor));
+  for (int i = 0; i < tensor.size(); ++i) {
+    SPIEL_CHECK_EQ(float_tensor[i], static_cast<float>(tensor[i]));
+  }
+  for (double value : tensor) {
+    if (value < 0 || value > 255 || value != static_cast<int>(value)) return;
+  }
+  std::vector<uint8_t> byte_tensor(tensor.size(), 42);
+  write_tensor(absl::MakeSpan(byte_tensor));
+  for (int i = 0; i < tensor.size(); ++i) {
+    SPIEL_CHECK_EQ(byte_tensor[i], tensor[i]);
+  }
 }
 
 bool IsPowerOfTwo(int n) { return n == 0 || (n & (n - 1)) == 0; }
 
+// Checks that, over all the decision nodes it is shown, InformationStateKey
+// partitions the states exactly like InformationStateString.
+class InformationStateKeyChecker {
+ public:
+  void Check(const State& state, Player player) {
+    const std::string info_state = state.InformationStateString(player);
+    const std::string key = state.InformationStateKey(player);
+    SPIEL_CHECK_EQ(key_of_.emplace(info_state, key).first->second, key);
+    SPIEL_CHECK_EQ(info_state_of_.emplace(key, info_state).first->second,
+                   info_state);
+  }
+
+ private:
+  std::unordered_map<std::string, std::string> key_of_;
+  std::unordered_map<std::string, std::string> info_state_of_;
+};
+
 }  // namespace
 
 // Checks that the game can be loaded.
@@ -163,14 +267,36 @@ void ChanceOutcomesTest(const Game& game) {
   SPIEL_CHECK_GT(max_outcomes, 0);
 }
 
+// Checks that UpdateObservationTensor, where supported, brings the tensors of
+// the state before the last action up to date.
+void UpdateObservationTensorTest(const State& parent, const State& state) {
+  std::shared_ptr<const Game> game = state.GetGame();
+  if (!game->GetType().provides_observation_tensor) return;
+  for (auto p = Player{0}; p < game->NumPlayers(); ++p) {
+    std::vector<float> values(game->ObservationTensorSize());
+    parent.ObservationTensor(p, absl::MakeSpan(values));
+    if (!state.UpdateObservationTensor(p, absl::MakeSpan(values))) return;
+    std::vector<float> expected(game->ObservationTensorSize());
+    state.ObservationTensor(p, absl::MakeSpan(expected));
+    SPIEL_CHECK_EQ(values, expected);
+  }
+}
+
 void TestUndo(std::unique_ptr<State> state,
               const std::vector<HistoryItem>& history) {
   // TODO(author2): We can just check each UndoAction.
   for (auto prev = history.rbegin(); prev != history.rend(); ++prev) {
     state->UndoAction(prev->player, prev->action);
     SPIEL_CHECK_EQ(state->ToString(), prev->state->ToString());
+    SPIEL_CHECK_EQ(state->HashValue(), prev->state->HashValue());
     // We also check that UndoActions correctly updates history_.
     SPIEL_CHECK_EQ(state->History(), prev->state->History());
+    SPIEL_CHECK_EQ(state->HistoryHash(), prev->state->HistoryHash());
+    SPIEL_CHECK_EQ(state->CurrentPlayer(), prev->state->CurrentPlayer());
+    SPIEL_CHECK_EQ(state->LegalActions(), prev->state->LegalActions());
+    if (std::next(prev) != history.rend() && std::next(prev)->state) {
+      UpdateObservationTensorTest(*std::next(prev)->state, *state);
+    }
   }
 }
 
@@ -182,6 +308,17 @@ void TestSerializeDeserialize(const Game& game, const State* state) {
   SPIEL_CHECK_EQ(state->ToString(), game_and_state.second->ToString());
 }
 
+void TestBinarySerializeDeserialize(const Game& game, const State& state) {
+  std::unique_ptr<State> new_state =
+      game.DeserializeStateBinary(state.SerializeBinary());
+  SPIEL_CHECK_EQ(state.ToString(), new_state->ToString());
+  SPIEL_CHECK_EQ(state.History(), new_state->History());
+  SPIEL_CHECK_EQ(state.HashValue(), new_state->HashValue());
+  if (!state.IsTerminal() && !state.IsSimultaneousNode()) {
+    SPIEL_CHECK_EQ(state.LegalActions(), new_state->LegalActions());
+  }
+}
+
 void TestHistoryContainsActions(const Game& game,
                                 const std::vector<HistoryItem>& history) {
   std::vector<Action> actions = {};
@@ -236,10 +373,15 @@ void CheckObservables(const Game& game, const State& state) {
     if (game.GetType().provides_information_state_tensor) {
       std::vector<double> v = state.InformationStateTensor(p);
       SPIEL_CHECK_EQ(v.size(), game.InformationStateTensorSize());
+      TensorOverloadsTest(v, [&state, p](auto values) {
+        state.InformationStateTensor(p, values);
+      });
     }
     if (game.GetType().provides_observation_tensor) {
       std::vector<double> v = state.ObservationTensor(p);
       SPIEL_CHECK_EQ(v.size(), game.ObservationTensorSize());
+      TensorOverloadsTest(
+          v, [&state, p](auto values) { state.ObservationTensor(p, values); });
     }
     if (game.GetType().provides_information_state_string) {
       // Checking it does not raise errors.
@@ -253,7 +395,7 @@ void CheckObservables(const Game& game, const State& state) {
 }
 
 void RandomSimulation(std::mt19937* rng, const Game& game, bool undo,
-                      bool serialize) {
+                      bool serialize, InformationStateKeyChecker* key_checker) {
   std::vector<HistoryItem> history;
   std::vector<double> episode_returns(game.NumPlayers(), 0);
 
@@ -275,6 +417,8 @@ void RandomSimulation(std::mt19937* rng, const Game& game, bool undo,
 
   std::cout << "Starting new game.." << std::endl;
   std::unique_ptr<open_spiel::State> state = game.NewInitialState();
+  // Tree walks rely on UndoAction wherever it is advertised, so always test it.
+  undo = undo || state->SupportsUndoAction();
 
   std::cout << "Initial state:" << std::endl;
   std::cout << "State:" << std::endl << state->ToString() << std::endl;
@@ -290,21 +434,34 @@ void RandomSimulation(std::mt19937* rng, const Game& game, bool undo,
     std::unique_ptr<open_spiel::State> state_copy = state->Clone();
     SPIEL_CHECK_EQ(state->ToString(), state_copy->ToString());
     SPIEL_CHECK_EQ(state->History(), state_copy->History());
+    SPIEL_CHECK_EQ(state->HashValue(), state_copy->HashValue());
 
     if (serialize && (history.size() < 10 || IsPowerOfTwo(history.size()))) {
       TestSerializeDeserialize(game, state.get());
+      if (game.GetType().chance_mode !=
+          GameType::ChanceMode::kSampledStochastic) {
+        TestBinarySerializeDeserialize(game, *state);
+      }
     }
 
     if (state->IsChanceNode()) {
-      // Chance node; sample one according to underlying distribution
+      // Chance node; sample one according to underlying distribution, with
+      // the probability ChanceOutcomes() gives it.
       std::vector<std::pair<Action, double>> outcomes = state->ChanceOutcomes();
-      Action action = open_spiel::SampleAction(outcomes, *rng).first;
+      const auto [action, prob] = state->SampleChanceOutcome(*rng);
+      auto outcome = absl::c_find_if(
+          outcomes, [action = action](const std::pair<Action, double>& o) {
+            return o.first == action;
+          });
+      SPIEL_CHECK_TRUE(outcome != outcomes.end());
+      SPIEL_CHECK_FLOAT_EQ(outcome->second, prob);
 
       std::cout << "sampled outcome: "
                 << state->ActionToString(kChancePlayerId, action) << std::endl;
 
       history.emplace_back(state->Clone(), kChancePlayerId, action);
       state->ApplyAction(action);
+      UpdateObservationTensorTest(*history.back().state, *state);
 
       if (undo && (history.size() < 10 || IsPowerOfTwo(history.size()))) {
         TestUndo(state->Clone(), history);
@@ -335,6 +492,9 @@ void RandomSimulation(std::mt19937* rng, const Game& game, bool undo,
                   << state->ActionToString(p, action) << std::endl;
 
         CheckObservables(game, *state);
+        if (game.GetType().provides_information_state_string) {
+          key_checker->Check(*state, p);
+        }
       }
 
       ApplyActionTestClone(game, state.get(), joint_action);
@@ -351,14 +511,20 @@ void RandomSimulation(std::mt19937* rng, const Game& game, bool undo,
       Player player = state->CurrentPlayer();
 
       CheckObservables(game, *state);
+      if (game.GetType().provides_information_state_string) {
+        key_checker->Check(*state, player);
+      }
 
       // Sample an action uniformly.
       std::vector<Action> actions = state->LegalActions();
       LegalActionsMaskTest(game, *state, actions);
-      if (state->IsTerminal())
+      LegalActionsBufferTest(*state, actions);
+      if (state->IsTerminal()) {
         SPIEL_CHECK_TRUE(actions.empty());
-      else
+      } else {
         SPIEL_CHECK_FALSE(actions.empty());
+        SampleRandomLegalActionTest(*state, actions);
+      }
       std::uniform_int_distribution<int> dis(0, actions.size() - 1);
       Action action = actions[dis(*rng)];
 
@@ -367,6 +533,7 @@ void RandomSimulation(std::mt19937* rng, const Game& game, bool undo,
 
       history.emplace_back(state->Clone(), player, action);
       ApplyActionTestClone(game, state.get(), action);
+      UpdateObservationTensorTest(*history.back().state, *state);
       game_length++;
 
       if (undo && (history.size() < 10 || IsPowerOfTwo(history.size()))) {
@@ -410,22 +577,129 @@ void RandomSimulation(std::mt19937* rng, const Game& game, bool undo,
   }
 }
 
+// Checks that, in games whose type says so, the decision nodes of random
+// playouts which share a hash have the same current player and observation.
+void HashDeterminesObservationTest(std::mt19937* rng, const Game& game,
+                                   int num_sims) {
+  if (!game.GetType().hash_determines_observation) return;
+  std::unordered_map<uint64_t, std::pair<Player, std::vector<double>>> seen;
+  for (int sim = 0; sim < num_sims; ++sim) {
+    std::unique_ptr<State> state = game.NewInitialState();
+    while (!state->IsTerminal()) {
+      if (state->CurrentPlayer() >= 0) {
+        auto [it, inserted] = seen.emplace(
+            state->HashValue(),
+            std::make_pair(state->CurrentPlayer(), state->ObservationTensor()));
+        if (!inserted) {
+          SPIEL_CHECK_EQ(it->second.first, state->CurrentPlayer());
+          SPIEL_CHECK_EQ(it->second.second, state->ObservationTensor());
+        }
+      }
+      std::vector<Action> actions = state->LegalActions();
+      std::uniform_int_distribution<int> dis(0, actions.size() - 1);
+      state->ApplyAction(actions[dis(*rng)]);
+    }
+  }
+}
+
+AllocationReport RandomSimAllocations(const Game& game, int num_sims,
+                                      std::mt19937* rng) {
+  AllocationReport report;
+  const bool observations = game.GetType().provides_observation_tensor;
+  std::vector<float> observation(
+      observations ? game.ObservationTensorSize() : 0);
+  int64_t num_states = 0;
+  int64_t apply_action = 0;
+  int64_t legal_actions = 0;
+  int64_t clone = 0;
+  int64_t observation_tensor = 0;
+  for (int sim = 0; sim < num_sims; ++sim) {
+    std::unique_ptr<State> state = game.NewInitialState();
+    while (!state->IsTerminal()) {
+      ++num_states;
+      const Player player = state->CurrentPlayer();
+      {
+        AllocationCounter counter;
+        std::unique_ptr<State> copy = state->Clone();
+        clone += counter.Allocations();
+      }
+      if (observations) {
+        AllocationCounter counter;
+        state->ObservationTensor(std::max(player, Player{0}),
+                                 absl::MakeSpan(observation));
+        observation_tensor += counter.Allocations();
+      }
+      if (player == kSimultaneousPlayerId) {
+        std::vector<Action> joint_action;
+        for (Player p = 0; p < game.NumPlayers(); ++p) {
+          AllocationCounter counter;
+          std::vector<Action> actions = state->LegalActions(p);
+          legal_actions += counter.Allocations();
+          std::uniform_int_distribution<int> dis(0, actions.size() - 1);
+          joint_action.push_back(actions.empty() ? kInvalidAction
+                                                 : actions[dis(*rng)]);
+        }
+        AllocationCounter counter;
+        state->ApplyActions(joint_action);
+        apply_action += counter.Allocations();
+      } else {
+        int64_t allocations;
+        std::vector<Action> actions;
+        {
+          AllocationCounter counter;
+          actions = state->LegalActions();
+          allocations = counter.Allocations();
+        }
+        legal_actions += allocations;
+        std::uniform_int_distribution<int> dis(0, actions.size() - 1);
+        const Action action = actions[dis(*rng)];
+        AllocationCounter counter;
+        state->ApplyAction(action);
+        apply_action += counter.Allocations();
+      }
+    }
+  }
+  if (num_states == 0) return report;
+  // LegalActions is called for each player at simultaneous nodes, but is
+  // still reported per node.
+  report.apply_action = static_cast<double>(apply_action) / num_states;
+  report.legal_actions = static_cast<double>(legal_actions) / num_states;
+  report.clone = static_cast<double>(clone) / num_states;
+  report.observation_tensor =
+      static_cast<double>(observation_tensor) / num_states;
+  return report;
+}
+
+void PrintAllocations(std::mt19937* rng, const Game& game, int num_sims) {
+  AllocationReport report = RandomSimAllocations(game, num_sims, rng);
+  std::cout << "Allocations per call: ApplyAction " << report.apply_action
+            << ", LegalActions " << report.legal_actions << ", Clone "
+            << report.clone << ", ObservationTensor "
+            << report.observation_tensor << std::endl;
+}
+
 // Perform sims random simulations of the specified game.
 void RandomSimTest(const Game& game, int num_sims) {
   std::mt19937 rng;
   std::cout << "\nRandomSimTest, game = " << game.GetType().short_name
             << ", num_sims = " << num_sims << std::endl;
+  InformationStateKeyChecker key_checker;
   for (int sim = 0; sim < num_sims; ++sim) {
-    RandomSimulation(&rng, game, /*undo=*/false, /*serialize=*/true);
+    RandomSimulation(&rng, game, /*undo=*/false, /*serialize=*/true,
+                     &key_checker);
   }
+  HashDeterminesObservationTest(&rng, game, num_sims);
+  PrintAllocations(&rng, game, num_sims);
 }
 
 void RandomSimTestWithUndo(const Game& game, int num_sims) {
   std::mt19937 rng;
   std::cout << "RandomSimTestWithUndo, game = " << game.GetType().short_name
             << ", num_sims = " << num_sims << std::endl;
+  InformationStateKeyChecker key_checker;
   for (int sim = 0; sim < num_sims; ++sim) {
-    RandomSimulation(&rng, game, /*undo=*/true, /*serialize=*/true);
+    RandomSimulation(&rng, game, /*undo=*/true, /*serialize=*/true,
+                     &key_checker);
   }
 }
 
@@ -433,8 +707,10 @@ void RandomSimTestNoSerialize(const Game& game, int num_sims) {
   std::mt19937 rng;
   std::cout << "RandomSimTestNoSerialize, game = " << game.GetType().short_name
             << ", num_sims = " << num_sims << std::endl;
+  InformationStateKeyChecker key_checker;
   for (int sim = 0; sim < num_sims; ++sim) {
-    RandomSimulation(&rng, game, /*undo=*/false, /*serialize=*/false);
+    RandomSimulation(&rng, game, /*undo=*/false, /*serialize=*/false,
+                     &key_checker);
   }
 }
 
@@ -522,6 +798,7 @@ void CheckChanceOutcomes(const Game& game) {
 
 // Verifies that ResampleFromInfostate is correctly implemented.
 void ResampleInfostateTest(const Game& game, int num_sims) {
+  const GameType& type = game.GetType();
   std::mt19937 rng;
   UniformProbabilitySampler sampler;
   for (int i = 0; i < num_sims; ++i) {
@@ -531,10 +808,22 @@ void ResampleInfostateTest(const Game& game, int num_sims) {
         for (int p = 0; p < state->NumPlayers(); ++p) {
           std::unique_ptr<State> other_state =
               state->ResampleFromInfostate(p, sampler);
-          SPIEL_CHECK_EQ(state->InformationStateString(p),
-                         other_state->InformationStateString(p));
-          SPIEL_CHECK_EQ(state->InformationStateTensor(p),
-                         other_state->InformationStateTensor(p));
+          if (type.provides_information_state_string) {
+            SPIEL_CHECK_EQ(state->InformationStateString(p),
+                           other_state->InformationStateString(p));
+          }
+          if (type.provides_information_state_tensor) {
+            SPIEL_CHECK_EQ(state->InformationStateTensor(p),
+                           other_state->InformationStateTensor(p));
+          }
+          if (type.provides_observation_string) {
+            SPIEL_CHECK_EQ(state->ObservationString(p),
+                           other_state->ObservationString(p));
+          }
+          if (type.provides_observation_tensor) {
+            SPIEL_CHECK_EQ(state->ObservationTensor(p),
+                           other_state->ObservationTensor(p));
+          }
           SPIEL_CHECK_EQ(state->CurrentPlayer(), other_state->CurrentPlayer());
         }
       }
@@ -546,5 +835,20 @@ void ResampleInfostateTest(const Game& game, int num_sims) {
   }
 }
 
+void CheckSamePolicies(const Game& game, const Policy& policy,
+                       const Policy& expected_policy, double tolerance) {
+  for (const auto& [info_state, uniform_policy] :
+       GetUniformPolicy(game).PolicyTable()) {
+    const ActionsAndProbs probs = policy.GetStatePolicy(info_state);
+    const ActionsAndProbs expected = expected_policy.GetStatePolicy(info_state);
+    SPIEL_CHECK_EQ(probs.size(), expected.size());
+    for (int i = 0; i < expected.size(); ++i) {
+      SPIEL_CHECK_EQ(probs[i].first, expected[i].first);
+      SPIEL_CHECK_LE(std::abs(probs[i].second - expected[i].second),
+                     tolerance);
+    }
+  }
+}
+
 }  // namespace testing
 }  // namespace open_spiel
@@ -19,6 +19,7 @@
 #include <string>
 
 #include "open_spiel/game_parameters.h"
+#include "open_spiel/policy.h"
 #include "open_spiel/spiel.h"
 
 namespace open_spiel {
@@ -33,9 +34,24 @@ void ChanceOutcomesTest(const Game& game);
 // Test to ensure that there are no chance outcomes.
 void NoChanceOutcomesTest(const Game& game);
 
-// Perform num_sims random simulations of the specified game.
+// Perform num_sims random simulations of the specified game. Also reports the
+// allocations of the core State methods, as by RandomSimAllocations.
 void RandomSimTest(const Game& game, int num_sims);
 
+// The mean number of heap allocations per call of some State methods, over the
+// states of num_sims random simulations, as counted by AllocationCounter.
+// Games can check theirs against a bound to catch regressions in their hot
+// paths. The observation tensors are written into a buffer, so that only those
+// of the game count.
+struct AllocationReport {
+  double apply_action = 0;  // ApplyAction, or ApplyActions if simultaneous.
+  double legal_actions = 0;
+  double clone = 0;
+  double observation_tensor = 0;  // 0 if the game has none.
+};
+AllocationReport RandomSimAllocations(const Game& game, int num_sims,
+                                      std::mt19937* rng);
+
 // Perform num_sims random simulations of the specified game. Also tests the
 // Undo function. Note: for every step in the simulation, the entire simulation
 // up to that point is rolled backward all the way to the beginning via undo,
@@ -55,9 +71,16 @@ void CheckChanceOutcomes(const Game& game);
 // mode kSampledStochastic).
 void RandomSimTestNoSerialize(const Game& game, int num_sims);
 
-// Verifies that ResampleFromInfostate is correctly implemented.
+// Verifies that ResampleFromInfostate is correctly implemented: that the
+// resampled states look the same to the player, by whichever of the
+// information state and observation the game provides.
 void ResampleInfostateTest(const Game& game, int num_sims);
 
+// Checks that two policies have the same actions, with probabilities within
+// the tolerance, at all the information states of the game.
+void CheckSamePolicies(const Game& game, const Policy& policy,
+                       const Policy& expected_policy, double tolerance = 0);
+
 }  // namespace testing
 }  // namespace open_spiel
 
@@ -0,0 +1,55 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/algorithm/container.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+
+// Only links the core, and loads its games from the libraries in
+// OPEN_SPIEL_GAME_LIBRARY_PATH.
+namespace open_spiel {
+namespace {
+
+void LoadsGameLibrariesOnFirstUse() {
+  SPIEL_CHECK_FALSE(IsGameRegistered("tic_tac_toe"));
+  std::shared_ptr<const Game> game = LoadGame("tic_tac_toe");
+  SPIEL_CHECK_EQ(game->GetType().short_name, "tic_tac_toe");
+  SPIEL_CHECK_TRUE(IsGameRegistered("tic_tac_toe"));
+  std::unique_ptr<State> state = game->NewInitialState();
+  state->ApplyAction(4);
+  SPIEL_CHECK_EQ(state->LegalActions().size(), 8);
+
+  // The game is only loaded once.
+  SPIEL_CHECK_EQ(LoadGame("tic_tac_toe")->ToString(), game->ToString());
+}
+
+void LoadsGamesWithSeveralNames() {
+  SPIEL_CHECK_EQ(LoadGame("tiny_bridge_2p")->NumPlayers(), 2);
+  // The other games of the library are registered along with it.
+  const std::vector<std::string> names = RegisteredGames();
+  SPIEL_CHECK_TRUE(absl::c_linear_search(names, "tiny_bridge_4p"));
+  SPIEL_CHECK_EQ(LoadGame("tiny_bridge_4p")->NumPlayers(), 4);
+}
+
+}  // namespace
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  open_spiel::LoadsGameLibrariesOnFirstUse();
+  open_spiel::LoadsGamesWithSeveralNames();
+}
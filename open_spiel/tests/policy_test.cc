@@ -0,0 +1,105 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/policy.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "open_spiel/algorithms/best_response.h"
+#include "open_spiel/algorithms/tabular_exploitability.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_bots.h"
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace testing {
+namespace {
+
+void CheckSamePolicy(const TabularPolicy& tabular,
+                     const CompactTabularPolicy& compact, double tolerance) {
+  SPIEL_CHECK_EQ(compact.NumInfoStates(), tabular.PolicyTable().size());
+  for (const auto& [info_state, state_policy] : tabular.PolicyTable()) {
+    const ActionsAndProbs compact_policy = compact.GetStatePolicy(info_state);
+    SPIEL_CHECK_EQ(compact_policy.size(), state_policy.size());
+    for (int i = 0; i < state_policy.size(); ++i) {
+      SPIEL_CHECK_EQ(compact_policy[i].first, state_policy[i].first);
+      SPIEL_CHECK_FLOAT_NEAR(compact_policy[i].second, state_policy[i].second,
+                             tolerance);
+    }
+  }
+  SPIEL_CHECK_TRUE(compact.GetStatePolicy("not an info state").empty());
+  SPIEL_CHECK_EQ(compact.Index("not an info state"), -1);
+}
+
+void CompactTabularPolicyTest() {
+  std::shared_ptr<const Game> game = LoadGame("leduc_poker");
+  const TabularPolicy tabular = GetRandomPolicy(*game, /*seed=*/7);
+
+  const CompactTabularPolicy compact(tabular);
+  CheckSamePolicy(tabular, compact, 0);
+  // Leduc poker only has a handful of distinct lists of legal actions, and
+  // the keys are sorted.
+  for (int i = 0; i + 1 < compact.NumInfoStates(); ++i) {
+    SPIEL_CHECK_LT(compact.InfoState(i), compact.InfoState(i + 1));
+    SPIEL_CHECK_EQ(compact.Index(compact.InfoState(i)), i);
+  }
+  SPIEL_CHECK_GT(compact.MemoryBytes(), 0);
+
+  // Moving keeps the keys valid.
+  CompactTabularPolicy moved = CompactTabularPolicy(tabular);
+  CompactTabularPolicy single(*game, tabular, /*single_precision=*/true);
+  SPIEL_CHECK_TRUE(single.SinglePrecision());
+  moved = std::move(single);
+  CheckSamePolicy(tabular, moved, 1e-7);
+
+  // Built from the game, the information states are the same.
+  CheckSamePolicy(tabular, CompactTabularPolicy(*game, tabular), 0);
+}
+
+void ConsumersTest() {
+  std::shared_ptr<const Game> game = LoadGame("kuhn_poker");
+  const TabularPolicy tabular = GetRandomPolicy(*game, /*seed=*/3);
+  const CompactTabularPolicy compact(tabular);
+
+  SPIEL_CHECK_FLOAT_NEAR(algorithms::Exploitability(*game, compact),
+                         algorithms::Exploitability(*game, tabular), 1e-12);
+  const std::string root = game->NewInitialState()->ToString();
+  for (Player player : {0, 1}) {
+    algorithms::TabularBestResponse tabular_br(*game, player, &tabular);
+    algorithms::TabularBestResponse compact_br(*game, player, &compact);
+    SPIEL_CHECK_FLOAT_NEAR(compact_br.Value(root), tabular_br.Value(root),
+                           1e-12);
+  }
+
+  std::unique_ptr<Bot> bot =
+      MakePolicyBot(*game, /*player_id=*/0, /*seed=*/0,
+                    std::make_unique<CompactTabularPolicy>(tabular));
+  std::unique_ptr<State> state = game->NewInitialState();
+  state->ApplyAction(0);
+  state->ApplyAction(1);
+  const Action action = bot->Step(*state);
+  SPIEL_CHECK_TRUE(action == 0 || action == 1);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  open_spiel::testing::CompactTabularPolicyTest();
+  open_spiel::testing::ConsumersTest();
+}
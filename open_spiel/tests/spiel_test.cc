@@ -131,6 +131,23 @@ void FlatJointactionTest() {
   SPIEL_CHECK_EQ(state.JointAction(), expected_joint_action);
 }
 
+void FlatJointActionsTest() {
+  FlatJointActionTestState state;
+  FlatJointActions joint_actions(state);
+  SPIEL_CHECK_EQ(joint_actions.NumJointActions(), 18);
+  Action flat_action = 0;
+  for (auto it = joint_actions.begin(); it != joint_actions.end(); ++it) {
+    SPIEL_CHECK_EQ(it.flat_action(), flat_action);
+    SPIEL_CHECK_EQ(*it, state.FlatJointActionToActions(flat_action));
+    SPIEL_CHECK_EQ(*it, joint_actions.Actions(flat_action));
+    SPIEL_CHECK_EQ(joint_actions.FlatAction(*it), flat_action);
+    ++flat_action;
+  }
+  SPIEL_CHECK_EQ(flat_action, 18);
+  std::vector<Action> expected_joint_action{4, 5, 100};
+  SPIEL_CHECK_EQ(joint_actions.Actions(16), expected_joint_action);
+}
+
 using PolicyGenerator = std::function<TabularPolicy(const Game& game)>;
 
 constexpr int kNumSimulations = 10;
@@ -243,6 +260,23 @@ void LeducPokerDeserializeTest() {
       serialized_game_and_state);
 }
 
+void BinaryGameAndStateTest() {
+  std::shared_ptr<const Game> game = LoadGame("leduc_poker");
+  std::unique_ptr<State> state = game->NewInitialState();
+  for (Action action : {0, 3, 1, 1}) state->ApplyAction(action);
+  const std::string bytes = SerializeGameAndStateBinary(*game, *state);
+  SPIEL_CHECK_LT(bytes.size(), SerializeGameAndState(*game, *state).size());
+
+  std::pair<std::shared_ptr<const Game>, std::unique_ptr<State>>
+      game_and_state = DeserializeGameAndStateBinary(bytes);
+  SPIEL_CHECK_EQ(game_and_state.first->ToString(), game->ToString());
+  SPIEL_CHECK_EQ(game_and_state.second->History(), state->History());
+  SPIEL_CHECK_EQ(game_and_state.second->ToString(), state->ToString());
+  // The game is loaded once for all the states deserialized.
+  SPIEL_CHECK_EQ(DeserializeGameAndStateBinary(bytes).first,
+                 game_and_state.first);
+}
+
 void GameParametersTest() {
   // Bare name
   auto params = GameParametersFromString("game_one");
@@ -282,6 +316,109 @@ void GameParametersTest() {
   SPIEL_CHECK_EQ(game2["param"].string_value(), "val");
 }
 
+void LoadGameCacheTest() {
+  SPIEL_CHECK_NE(LoadGame("kuhn_poker"), LoadGame("kuhn_poker"));
+
+  EnableLoadGameCache(8);
+  std::shared_ptr<const Game> game = LoadGame("leduc_poker(players=3)");
+  SPIEL_CHECK_EQ(LoadGame("leduc_poker(players=3)"), game);
+  SPIEL_CHECK_EQ(LoadGame("leduc_poker", {{"players", GameParameter(3)}}),
+                 game);
+  SPIEL_CHECK_NE(LoadGame("leduc_poker"), game);
+  // Nested games are keyed by their parameters too.
+  std::shared_ptr<const Game> turn_based =
+      LoadGame("turn_based_simultaneous_game(game=goofspiel(num_cards=3))");
+  SPIEL_CHECK_EQ(
+      LoadGame("turn_based_simultaneous_game(game=goofspiel(num_cards=3))"),
+      turn_based);
+
+  LRUCacheInfo info = LoadGameCacheInfo();
+  SPIEL_CHECK_EQ(info.hits, 3);
+  // The nested goofspiel is loaded, and cached, by the transform.
+  SPIEL_CHECK_EQ(info.misses, 4);
+  SPIEL_CHECK_EQ(info.size, 4);
+  SPIEL_CHECK_EQ(info.max_size, 8);
+
+  DisableLoadGameCache();
+  SPIEL_CHECK_NE(LoadGame("leduc_poker(players=3)"), game);
+  SPIEL_CHECK_EQ(LoadGameCacheInfo().size, 0);
+}
+
+void HistoryHashTest() {
+  std::shared_ptr<const Game> game = LoadGame("tic_tac_toe");
+  std::unique_ptr<State> state = game->NewInitialState();
+  const uint64_t initial_hash = state->HistoryHash();
+  state->ApplyAction(4);
+  state->ApplyAction(0);
+  SPIEL_CHECK_EQ(&state->FullHistory(), &state->FullHistory());
+  SPIEL_CHECK_EQ(state->FullHistory(), std::vector<Action>({4, 0}));
+  const uint64_t hash = state->HistoryHash();
+  SPIEL_CHECK_NE(hash, initial_hash);
+  SPIEL_CHECK_EQ(state->Clone()->HistoryHash(), hash);
+
+  // The hash depends on the order of the actions.
+  std::unique_ptr<State> other = game->NewInitialState();
+  other->ApplyAction(0);
+  other->ApplyAction(4);
+  SPIEL_CHECK_NE(other->HistoryHash(), hash);
+  other->UndoAction(1, 4);
+  SPIEL_CHECK_NE(other->HistoryHash(), initial_hash);
+
+  // Undoing restores the hash, and redoing gives it back.
+  state->UndoAction(1, 0);
+  state->UndoAction(0, 4);
+  SPIEL_CHECK_EQ(state->HistoryHash(), initial_hash);
+  state->ApplyAction(4);
+  state->ApplyAction(0);
+  SPIEL_CHECK_EQ(state->HistoryHash(), hash);
+
+  // A joint action is hashed as its actions in order, whether it is applied
+  // as such or as a flat joint action.
+  game = LoadGame("goofspiel(num_cards=3)");
+  state = game->NewInitialState();
+  state->ApplyAction(0);
+  std::unique_ptr<State> joint = state->Clone();
+  joint->ApplyActions({1, 2});
+  bool found = false;
+  for (Action flat_action : state->LegalActions()) {
+    std::unique_ptr<State> child = state->Child(flat_action);
+    if (child->FullHistory() == joint->FullHistory()) {
+      SPIEL_CHECK_EQ(child->HistoryHash(), joint->HistoryHash());
+      found = true;
+    } else {
+      SPIEL_CHECK_NE(child->HistoryHash(), joint->HistoryHash());
+    }
+  }
+  SPIEL_CHECK_TRUE(found);
+}
+
+void ApproximateMemoryUsageTest() {
+  // The default counts the base state and its history.
+  std::shared_ptr<const Game> game = LoadGame("kuhn_poker");
+  std::unique_ptr<State> state = game->NewInitialState();
+  SPIEL_CHECK_GE(state->ApproximateMemoryUsage(), sizeof(State));
+  const int64_t initial_bytes = state->ApproximateMemoryUsage();
+  state->ApplyAction(0);
+  state->ApplyAction(1);
+  SPIEL_CHECK_GE(state->ApproximateMemoryUsage(),
+                 initial_bytes + 2 * sizeof(Action));
+
+  // Games with larger states count them.
+  game = LoadGame("tic_tac_toe");
+  state = game->NewInitialState();
+  SPIEL_CHECK_GT(state->ApproximateMemoryUsage(), sizeof(State));
+}
+
+void CheckLevelTest() {
+  // Checks above the level are compiled, but their arguments not evaluated.
+  int dchecks = 0;
+  int paranoid_checks = 0;
+  SPIEL_DCHECK_EQ(++dchecks, 1);
+  SPIEL_PARANOID_CHECK_EQ(++paranoid_checks, 1);
+  SPIEL_CHECK_EQ(dchecks, OPEN_SPIEL_CHECK_LEVEL >= 1 ? 1 : 0);
+  SPIEL_CHECK_EQ(paranoid_checks, OPEN_SPIEL_CHECK_LEVEL >= 2 ? 1 : 0);
+}
+
 }  // namespace
 }  // namespace testing
 }  // namespace open_spiel
@@ -291,7 +428,13 @@ int main(int argc, char** argv) {
   open_spiel::testing::KuhnTests();
   open_spiel::testing::TicTacToeTests();
   open_spiel::testing::FlatJointactionTest();
+  open_spiel::testing::FlatJointActionsTest();
   open_spiel::testing::PolicyTest();
   open_spiel::testing::LeducPokerDeserializeTest();
+  open_spiel::testing::BinaryGameAndStateTest();
   open_spiel::testing::GameParametersTest();
+  open_spiel::testing::LoadGameCacheTest();
+  open_spiel::testing::HistoryHashTest();
+  open_spiel::testing::ApproximateMemoryUsageTest();
+  open_spiel::testing::CheckLevelTest();
 }
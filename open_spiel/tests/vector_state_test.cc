@@ -0,0 +1,211 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/vector_state.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace testing {
+namespace {
+
+// Plays uniformly random actions in every slot for a number of steps,
+// checking the buffers against the underlying states.
+void RandomVectorStateTest(const std::string& game_name, int num_states,
+                           int num_steps) {
+  std::shared_ptr<const Game> game = LoadGame(game_name);
+  VectorState vec(game, num_states, /*seed=*/1234);
+  std::mt19937 rng(0);
+
+  std::vector<float> observations(vec.ObservationTensorsSize());
+  std::vector<float> masks(vec.LegalActionsMasksSize());
+  std::vector<uint8_t> byte_masks(vec.LegalActionsMasksSize());
+  std::vector<float> rewards(vec.RewardsSize());
+  std::vector<float> dones(vec.DonesSize());
+  std::vector<Action> actions(num_states * vec.ActionsPerState());
+  int num_done = 0;
+  for (int step = 0; step < num_steps; ++step) {
+    vec.ObservationTensors(absl::MakeSpan(observations));
+    vec.LegalActionsMasks(absl::MakeSpan(masks));
+    vec.LegalActionsMasks(absl::MakeSpan(byte_masks));
+    SPIEL_CHECK_TRUE(std::equal(masks.begin(), masks.end(),
+                                byte_masks.begin()));
+    const int obs_size = game->ObservationTensorSize();
+    const int num_actions = game->NumDistinctActions();
+    for (int i = 0; i < num_states; ++i) {
+      const State& state = vec.GetState(i);
+      SPIEL_CHECK_FALSE(state.IsTerminal());
+      SPIEL_CHECK_FALSE(state.IsChanceNode());
+      for (Player p = 0; p < game->NumPlayers(); ++p) {
+        std::vector<double> obs = state.ObservationTensor(p);
+        int offset = (i * game->NumPlayers() + p) * obs_size;
+        for (int k = 0; k < obs_size; ++k) {
+          SPIEL_CHECK_FLOAT_EQ(observations[offset + k], obs[k]);
+        }
+        std::vector<int> mask = state.LegalActionsMask(p);
+        offset = (i * game->NumPlayers() + p) * num_actions;
+        for (int k = 0; k < num_actions; ++k) {
+          SPIEL_CHECK_EQ(masks[offset + k], mask[k]);
+        }
+      }
+
+      // Pick a random legal action for every player that acts.
+      for (int j = 0; j < vec.ActionsPerState(); ++j) {
+        Player player = vec.ActionsPerState() == 1 ? state.CurrentPlayer() : j;
+        std::vector<Action> legal_actions = state.LegalActions(player);
+        if (legal_actions.empty()) {
+          actions[i * vec.ActionsPerState() + j] = kInvalidAction;
+        } else {
+          std::uniform_int_distribution<int> dis(0, legal_actions.size() - 1);
+          actions[i * vec.ActionsPerState() + j] = legal_actions[dis(rng)];
+        }
+      }
+    }
+    vec.Step(actions);
+    vec.Rewards(absl::MakeSpan(rewards));
+    vec.Dones(absl::MakeSpan(dones));
+    for (float done : dones) {
+      SPIEL_CHECK_TRUE(done == 0 || done == 1);
+      num_done += done;
+    }
+  }
+  // Every game tested here has episodes much shorter than num_steps.
+  SPIEL_CHECK_GT(num_done, 0);
+
+  vec.Reset();
+  vec.Dones(absl::MakeSpan(dones));
+  for (float done : dones) SPIEL_CHECK_EQ(done, 0);
+}
+
+// The episodes played do not depend on the number of threads.
+void ThreadedVectorStateTest(const std::string& game_name, int num_states,
+                             int num_steps) {
+  std::shared_ptr<const Game> game = LoadGame(game_name);
+  VectorState serial(game, num_states, /*seed=*/1234);
+  VectorState threaded(game, num_states, /*seed=*/1234, /*num_threads=*/3);
+  SPIEL_CHECK_EQ(threaded.NumThreads(), 3);
+  std::mt19937 rng(0);
+
+  std::vector<float> serial_observations(serial.ObservationTensorsSize());
+  std::vector<float> observations(threaded.ObservationTensorsSize());
+  std::vector<float> serial_masks(serial.LegalActionsMasksSize());
+  std::vector<float> masks(threaded.LegalActionsMasksSize());
+  std::vector<float> serial_rewards(serial.RewardsSize());
+  std::vector<float> rewards(threaded.RewardsSize());
+  std::vector<Action> actions(num_states * serial.ActionsPerState());
+  for (int step = 0; step < num_steps; ++step) {
+    serial.ObservationTensors(absl::MakeSpan(serial_observations));
+    threaded.ObservationTensors(absl::MakeSpan(observations));
+    SPIEL_CHECK_TRUE(observations == serial_observations);
+    serial.LegalActionsMasks(absl::MakeSpan(serial_masks));
+    threaded.LegalActionsMasks(absl::MakeSpan(masks));
+    SPIEL_CHECK_TRUE(masks == serial_masks);
+    for (int i = 0; i < num_states; ++i) {
+      const State& state = serial.GetState(i);
+      SPIEL_CHECK_EQ(state.ToString(), threaded.GetState(i).ToString());
+      std::vector<Action> legal_actions = state.LegalActions();
+      std::uniform_int_distribution<int> dis(0, legal_actions.size() - 1);
+      actions[i] = legal_actions[dis(rng)];
+    }
+    serial.Step(actions);
+    threaded.Step(actions);
+    serial.Rewards(absl::MakeSpan(serial_rewards));
+    threaded.Rewards(absl::MakeSpan(rewards));
+    SPIEL_CHECK_TRUE(rewards == serial_rewards);
+  }
+}
+
+// The batched kernel plays the same episodes as the States.
+void BatchedKernelTest(const std::string& game_name, int num_states,
+                       int num_steps) {
+  std::shared_ptr<const Game> game = LoadGame(game_name);
+  VectorState states(game, num_states, /*seed=*/1234);
+  VectorState batched(game, num_states, /*seed=*/1234, /*num_threads=*/2,
+                      /*use_batched_kernel=*/true);
+  SPIEL_CHECK_FALSE(states.UsesBatchedKernel());
+  SPIEL_CHECK_TRUE(batched.UsesBatchedKernel());
+  std::mt19937 rng(0);
+
+  std::vector<float> state_observations(states.ObservationTensorsSize());
+  std::vector<float> observations(batched.ObservationTensorsSize());
+  std::vector<float> state_masks(states.LegalActionsMasksSize());
+  std::vector<float> masks(batched.LegalActionsMasksSize());
+  std::vector<uint8_t> byte_masks(batched.LegalActionsMasksSize());
+  std::vector<float> state_rewards(states.RewardsSize());
+  std::vector<float> rewards(batched.RewardsSize());
+  std::vector<float> state_dones(states.DonesSize());
+  std::vector<float> dones(batched.DonesSize());
+  std::vector<Action> actions(num_states * states.ActionsPerState());
+  const int num_actions = game->NumDistinctActions();
+  int num_done = 0;
+  for (int step = 0; step < num_steps; ++step) {
+    states.ObservationTensors(absl::MakeSpan(state_observations));
+    batched.ObservationTensors(absl::MakeSpan(observations));
+    SPIEL_CHECK_TRUE(observations == state_observations);
+    states.LegalActionsMasks(absl::MakeSpan(state_masks));
+    batched.LegalActionsMasks(absl::MakeSpan(masks));
+    batched.LegalActionsMasks(absl::MakeSpan(byte_masks));
+    SPIEL_CHECK_TRUE(masks == state_masks);
+    SPIEL_CHECK_TRUE(std::equal(masks.begin(), masks.end(),
+                                byte_masks.begin()));
+
+    // A random legal action for every player that acts.
+    for (int k = 0; k < actions.size(); ++k) {
+      std::vector<Action> legal_actions;
+      for (Action a = 0; a < num_actions; ++a) {
+        if (masks[k * num_actions + a]) legal_actions.push_back(a);
+      }
+      if (legal_actions.empty()) {
+        actions[k] = kInvalidAction;
+      } else {
+        std::uniform_int_distribution<int> dis(0, legal_actions.size() - 1);
+        actions[k] = legal_actions[dis(rng)];
+      }
+    }
+    states.Step(actions);
+    batched.Step(actions);
+    states.Rewards(absl::MakeSpan(state_rewards));
+    batched.Rewards(absl::MakeSpan(rewards));
+    SPIEL_CHECK_TRUE(rewards == state_rewards);
+    states.Dones(absl::MakeSpan(state_dones));
+    batched.Dones(absl::MakeSpan(dones));
+    SPIEL_CHECK_TRUE(dones == state_dones);
+    for (float done : dones) num_done += done;
+  }
+  SPIEL_CHECK_GT(num_done, 0);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  open_spiel::testing::RandomVectorStateTest("catch", 8, 50);
+  open_spiel::testing::RandomVectorStateTest("deep_sea", 8, 50);
+  open_spiel::testing::RandomVectorStateTest("connect_four", 4, 100);
+  open_spiel::testing::RandomVectorStateTest("laser_tag(horizon=20)", 4, 50);
+  open_spiel::testing::RandomVectorStateTest("kuhn_poker", 16, 20);
+  open_spiel::testing::ThreadedVectorStateTest("leduc_poker", 10, 30);
+  open_spiel::testing::BatchedKernelTest("catch", 20, 100);
+  open_spiel::testing::BatchedKernelTest("deep_sea(size=8)", 20, 100);
+  open_spiel::testing::BatchedKernelTest("cliff_walking(horizon=30)", 20, 200);
+  open_spiel::testing::BatchedKernelTest("markov_soccer(horizon=50)", 20, 300);
+}
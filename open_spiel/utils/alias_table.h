@@ -0,0 +1,91 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_UTILS_ALIAS_TABLE_H_
+#define OPEN_SPIEL_UTILS_ALIAS_TABLE_H_
+
+#include <algorithm>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/types/span.h"
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+
+// Samples from a fixed discrete distribution in constant time, by Vose's alias
+// method, for distributions sampled many times such as the dice rolls of a
+// game. The n outcomes are spread over n columns of equal width, each holding
+// part of one outcome and, above a threshold, part of a second one, its alias.
+// Building the table takes O(n).
+class AliasTable {
+ public:
+  AliasTable() = default;
+
+  // The probabilities must sum to 1.
+  explicit AliasTable(absl::Span<const double> probs)
+      : probs_(probs.begin(), probs.end()),
+        thresholds_(probs.size()),
+        aliases_(probs.size()) {
+    const int n = probs.size();
+    SPIEL_CHECK_GT(n, 0);
+    std::vector<int> small;
+    std::vector<int> large;
+    double sum = 0;
+    for (int i = 0; i < n; ++i) {
+      SPIEL_CHECK_GE(probs[i], 0);
+      sum += probs[i];
+      thresholds_[i] = probs[i] * n;
+      aliases_[i] = i;
+      (thresholds_[i] < 1 ? small : large).push_back(i);
+    }
+    SPIEL_CHECK_FLOAT_EQ(sum, 1.0);
+    while (!small.empty() && !large.empty()) {
+      const int less = small.back();
+      small.pop_back();
+      const int more = large.back();
+      aliases_[less] = more;
+      thresholds_[more] -= 1 - thresholds_[less];
+      if (thresholds_[more] < 1) {
+        large.pop_back();
+        small.push_back(more);
+      }
+    }
+    // What is left is full up to rounding errors.
+    for (int i : small) thresholds_[i] = 1;
+    for (int i : large) thresholds_[i] = 1;
+  }
+
+  int size() const { return probs_.size(); }
+  double prob(int index) const { return probs_[index]; }
+
+  // Returns the index of an outcome, drawn with its probability. z should be
+  // uniform on [0, 1): its integer part once scaled picks the column, and the
+  // fractional part the outcome within it.
+  int Sample(double z) const {
+    const double scaled = z * probs_.size();
+    // z just below 1 can round up to the last column's end.
+    const int column =
+        std::min<int>(static_cast<int>(scaled), probs_.size() - 1);
+    return scaled - column < thresholds_[column] ? column : aliases_[column];
+  }
+
+ private:
+  std::vector<double> probs_;
+  std::vector<double> thresholds_;
+  std::vector<int> aliases_;
+};
+
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_UTILS_ALIAS_TABLE_H_
@@ -0,0 +1,55 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/utils/alias_table.h"
+
+#include <vector>
+
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace {
+
+// Sampling on a fine grid of z gives back the probabilities.
+void CheckDistribution(const std::vector<double>& probs) {
+  AliasTable table(probs);
+  SPIEL_CHECK_EQ(table.size(), probs.size());
+  const int num_samples = 1 << 20;
+  std::vector<int> counts(probs.size(), 0);
+  for (int i = 0; i < num_samples; ++i) {
+    ++counts[table.Sample((i + 0.5) / num_samples)];
+  }
+  for (int i = 0; i < probs.size(); ++i) {
+    SPIEL_CHECK_EQ(table.prob(i), probs[i]);
+    SPIEL_CHECK_FLOAT_NEAR(static_cast<double>(counts[i]) / num_samples,
+                           probs[i], 1e-5);
+  }
+  SPIEL_CHECK_LT(table.Sample(0), probs.size());
+  SPIEL_CHECK_LT(table.Sample(0.9999999999999999), probs.size());
+}
+
+void TestAliasTable() {
+  CheckDistribution({1.0});
+  CheckDistribution({0.5, 0.5});
+  CheckDistribution({0.1, 0.0, 0.6, 0.3});
+  // The rolls of two dice, as in backgammon.
+  std::vector<double> dice(21, 1.0 / 18);
+  for (int i = 15; i < 21; ++i) dice[i] = 1.0 / 36;
+  CheckDistribution(dice);
+}
+
+}  // namespace
+}  // namespace open_spiel
+
+int main(int argc, char** argv) { open_spiel::TestAliasTable(); }
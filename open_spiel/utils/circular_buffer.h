@@ -16,11 +16,54 @@
 #define OPEN_SPIEL_UTILS_CIRCULAR_BUFFER_H_
 
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
 #include <random>
 #include <vector>
 
+#include "open_spiel/abseil-cpp/absl/container/flat_hash_set.h"
+#include "open_spiel/abseil-cpp/absl/synchronization/mutex.h"
+
 namespace open_spiel {
 
+namespace internal {
+
+// `num` distinct indices in [0, size), in random order, or all of them if
+// there are fewer. Uses Floyd's algorithm, so only needs as much work and
+// memory as the sample rather than the buffer.
+inline std::vector<int> SampleIndices(std::mt19937* rng, int size, int num) {
+  num = std::min(num, size);
+  std::vector<int> indices;
+  if (num <= 0) return indices;
+  indices.reserve(num);
+  absl::flat_hash_set<int> chosen;
+  chosen.reserve(num);
+  for (int j = size - num; j < size; ++j) {
+    int t = std::uniform_int_distribution<int>(0, j)(*rng);
+    if (!chosen.insert(t).second) {
+      chosen.insert(j);
+      t = j;
+    }
+    indices.push_back(t);
+  }
+  std::shuffle(indices.begin(), indices.end(), *rng);
+  return indices;
+}
+
+// `num` indices in [0, size), with replacement.
+inline std::vector<int> SampleIndicesWithReplacement(std::mt19937* rng,
+                                                     int size, int num) {
+  std::vector<int> indices;
+  if (size <= 0) return indices;
+  indices.reserve(num);
+  std::uniform_int_distribution<int> dist(0, size - 1);
+  for (int i = 0; i < num; ++i) indices.push_back(dist(*rng));
+  return indices;
+}
+
+}  // namespace internal
+
 // A simple circular buffer of fixed size.
 template <class T>
 class CircularBuffer {
@@ -38,12 +81,15 @@ class CircularBuffer {
     total_added_ += 1;
   }
 
-  // Return `num` elements without replacement.
-  std::vector<T> Sample(std::mt19937* rng, int num) {
-    std::vector<T> out;
-    out.reserve(num);
-    std::sample(data_.begin(), data_.end(), std::back_inserter(out), num, *rng);
-    return out;
+  // Return `num` elements without replacement, or all of them if there are
+  // fewer, in random order. Takes O(num), not O(Size()).
+  std::vector<T> Sample(std::mt19937* rng, int num) const {
+    return Gather(internal::SampleIndices(rng, Size(), num));
+  }
+
+  // Return `num` elements with replacement, or none if the buffer is empty.
+  std::vector<T> SampleWithReplacement(std::mt19937* rng, int num) const {
+    return Gather(internal::SampleIndicesWithReplacement(rng, Size(), num));
   }
 
   // Return the full buffer.
@@ -62,11 +108,90 @@ class CircularBuffer {
   int64_t TotalAdded() const { return total_added_; }
 
  private:
+  std::vector<T> Gather(const std::vector<int>& indices) const {
+    std::vector<T> out;
+    out.reserve(indices.size());
+    for (int i : indices) out.push_back(data_[i]);
+    return out;
+  }
+
   const int max_size_;
   int64_t total_added_;
   std::vector<T> data_;
 };
 
+// A circular buffer of fixed size that many threads can add to while others
+// sample from it. A slot is reserved by atomically incrementing the count of
+// elements added, so adders only contend when they write the same slot, and
+// each slot has its own lock so that a sample never sees a half written
+// element. The slots are allocated up front, so T must be default
+// constructible.
+template <class T>
+class ConcurrentCircularBuffer {
+ public:
+  explicit ConcurrentCircularBuffer(int max_size)
+      : max_size_(max_size), slots_(new Slot[max_size]) {}
+
+  // Add one element, replacing the oldest once it's full. An add that loses a
+  // race with a newer one for the same slot, a full lap later, is dropped.
+  void Add(const T& value) {
+    const int64_t n = total_added_.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = slots_[n % max_size_];
+    absl::MutexLock lock(&slot.m);
+    if (n > slot.added) {
+      slot.value = value;
+      slot.added = n;
+    }
+  }
+
+  // Return up to `num` elements without replacement, in random order. Takes
+  // O(num). While the buffer first fills, the slots reserved by adds that
+  // haven't finished yet are skipped, so fewer may be returned.
+  std::vector<T> Sample(std::mt19937* rng, int num) const {
+    return Gather(internal::SampleIndices(rng, Size(), num));
+  }
+
+  // Return up to `num` elements with replacement; see Sample.
+  std::vector<T> SampleWithReplacement(std::mt19937* rng, int num) const {
+    return Gather(internal::SampleIndicesWithReplacement(rng, Size(), num));
+  }
+
+  // How many elements are in the buffer, including those being added.
+  int Size() const {
+    return std::min<int64_t>(TotalAdded(), max_size_);
+  }
+
+  // Is the buffer empty?
+  bool Empty() const { return TotalAdded() == 0; }
+
+  // How many elements have ever been added to the buffer.
+  int64_t TotalAdded() const {
+    return total_added_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct Slot {
+    mutable absl::Mutex m;
+    T value ABSL_GUARDED_BY(m);
+    int64_t added ABSL_GUARDED_BY(m) = -1;  // Which add wrote it, if any.
+  };
+
+  std::vector<T> Gather(const std::vector<int>& indices) const {
+    std::vector<T> out;
+    out.reserve(indices.size());
+    for (int i : indices) {
+      const Slot& slot = slots_[i];
+      absl::MutexLock lock(&slot.m);
+      if (slot.added >= 0) out.push_back(slot.value);
+    }
+    return out;
+  }
+
+  const int max_size_;
+  std::atomic<int64_t> total_added_{0};
+  std::unique_ptr<Slot[]> slots_;
+};
+
 }  // namespace open_spiel
 
 #endif  // OPEN_SPIEL_UTILS_CIRCULAR_BUFFER_H_
@@ -15,8 +15,11 @@
 #include "open_spiel/utils/circular_buffer.h"
 
 #include <random>
+#include <vector>
 
+#include "open_spiel/abseil-cpp/absl/container/flat_hash_set.h"
 #include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/thread.h"
 
 namespace open_spiel {
 namespace {
@@ -63,9 +66,74 @@ void TestCircularBuffer() {
   SPIEL_CHECK_EQ(sample.size(), 1);
   SPIEL_CHECK_GE(sample[0], 15);
   SPIEL_CHECK_LE(sample[0], 18);
+
+  // Without replacement, asking for more returns them all.
+  sample = buffer.Sample(&rng, 10);
+  SPIEL_CHECK_EQ(sample.size(), 4);
+  absl::flat_hash_set<int> distinct(sample.begin(), sample.end());
+  SPIEL_CHECK_TRUE(distinct == absl::flat_hash_set<int>({15, 16, 17, 18}));
+
+  sample = buffer.SampleWithReplacement(&rng, 10);
+  SPIEL_CHECK_EQ(sample.size(), 10);
+  for (int value : sample) {
+    SPIEL_CHECK_GE(value, 15);
+    SPIEL_CHECK_LE(value, 18);
+  }
+  SPIEL_CHECK_TRUE(CircularBuffer<int>(4).SampleWithReplacement(&rng, 2)
+                       .empty());
+}
+
+void TestSampleIsUniform() {
+  CircularBuffer<int> buffer(10);
+  for (int i = 0; i < 10; ++i) buffer.Add(i);
+  std::mt19937 rng;
+  std::vector<int> counts(10);
+  for (int i = 0; i < 10000; ++i) {
+    for (int value : buffer.Sample(&rng, 3)) counts[value] += 1;
+  }
+  for (int count : counts) {
+    SPIEL_CHECK_GT(count, 2700);
+    SPIEL_CHECK_LT(count, 3300);
+  }
+}
+
+void TestConcurrentCircularBuffer() {
+  ConcurrentCircularBuffer<int> buffer(100);
+  std::mt19937 rng;
+  SPIEL_CHECK_TRUE(buffer.Empty());
+  SPIEL_CHECK_TRUE(buffer.Sample(&rng, 5).empty());
+
+  // Many threads add, while this one samples.
+  constexpr int kThreads = 4;
+  constexpr int kAdds = 10000;
+  std::vector<Thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&buffer, t]() {
+      for (int i = 0; i < kAdds; ++i) buffer.Add(t * kAdds + i);
+    });
+  }
+  while (buffer.TotalAdded() < kThreads * kAdds) {
+    for (int value : buffer.Sample(&rng, 10)) {
+      SPIEL_CHECK_GE(value, 0);
+      SPIEL_CHECK_LT(value, kThreads * kAdds);
+    }
+  }
+  for (Thread& thread : threads) thread.join();
+
+  SPIEL_CHECK_EQ(buffer.Size(), 100);
+  SPIEL_CHECK_EQ(buffer.TotalAdded(), kThreads * kAdds);
+  std::vector<int> sample = buffer.Sample(&rng, 100);
+  SPIEL_CHECK_EQ(sample.size(), 100);
+  SPIEL_CHECK_EQ(absl::flat_hash_set<int>(sample.begin(), sample.end()).size(),
+                 100);
+  SPIEL_CHECK_EQ(buffer.SampleWithReplacement(&rng, 300).size(), 300);
 }
 
 }  // namespace
 }  // namespace open_spiel
 
-int main(int argc, char** argv) { open_spiel::TestCircularBuffer(); }
+int main(int argc, char** argv) {
+  open_spiel::TestCircularBuffer();
+  open_spiel::TestSampleIsUniform();
+  open_spiel::TestConcurrentCircularBuffer();
+}
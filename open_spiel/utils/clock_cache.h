@@ -0,0 +1,212 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_UTILS_CLOCK_CACHE_H_
+#define OPEN_SPIEL_UTILS_CLOCK_CACHE_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+#include "open_spiel/abseil-cpp/absl/hash/hash.h"
+#include "open_spiel/abseil-cpp/absl/synchronization/mutex.h"
+#include "open_spiel/utils/lru_cache.h"
+
+namespace open_spiel {
+
+// A threadsafe cache with the same interface as LRUCache, meant for caches
+// shared by many threads with a high hit rate.
+//
+// The storage is allocated up front, as buckets of kWays slots: a key can only
+// be stored in the slots of the bucket given by its hash. Reads don't take any
+// lock: they mark the slot as being read with an atomic counter, which only
+// waits for a writer replacing that very slot. Writes take a lock per bucket.
+// Eviction uses the CLOCK algorithm within a bucket: a read marks the entry as
+// referenced, and the eviction skips, and unmarks, the referenced entries.
+//
+// K must be hashable with absl::Hash, and K and V default constructible and
+// copyable. A read racing with the write of its slot may miss.
+template <typename K, typename V>
+class ClockCache {
+ public:
+  // The max size is rounded up to a multiple of kWays.
+  explicit ClockCache(int max_size)
+      : num_buckets_(std::max(1, (max_size + kWays - 1) / kWays)),
+        buckets_(new Bucket[num_buckets_]) {}
+
+  ClockCache(const ClockCache&) = delete;
+  ClockCache& operator=(const ClockCache&) = delete;
+
+  int Size() const { return size_.load(std::memory_order_relaxed); }
+
+  void Clear() {
+    for (int b = 0; b < num_buckets_; ++b) {
+      Bucket& bucket = buckets_[b];
+      absl::MutexLock lock(&bucket.mutex);
+      for (Slot& slot : bucket.slots) {
+        if (!slot.occupied) continue;
+        LockExclusive(&slot);
+        slot.occupied = false;
+        slot.key = K();
+        slot.value = V();
+        UnlockExclusive(&slot);
+        size_.fetch_sub(1, std::memory_order_relaxed);
+      }
+    }
+    for (Counters& counters : counters_) {
+      counters.hits.store(0, std::memory_order_relaxed);
+      counters.misses.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  void Set(const K& key, const V& value) { Insert(key, value); }
+
+  // Same as Set, but returns the cached value: `value` if the key was new, or
+  // the value already stored for it.
+  V Insert(const K& key, const V& value) {
+    const int b = BucketIndex(key);
+    Bucket& bucket = buckets_[b];
+    absl::MutexLock lock(&bucket.mutex);
+    // Writers of this bucket hold the lock, and readers don't modify the
+    // slots, so they can be read directly.
+    Slot* victim = nullptr;
+    for (Slot& slot : bucket.slots) {
+      if (!slot.occupied) {
+        if (victim == nullptr) victim = &slot;
+      } else if (slot.key == key) {
+        return slot.value;
+      }
+    }
+    if (victim == nullptr) {
+      while (true) {
+        Slot& slot = bucket.slots[bucket.clock_hand];
+        bucket.clock_hand = (bucket.clock_hand + 1) % kWays;
+        if (!slot.referenced.exchange(false, std::memory_order_relaxed)) {
+          victim = &slot;
+          break;
+        }
+      }
+    } else {
+      size_.fetch_add(1, std::memory_order_relaxed);
+    }
+    LockExclusive(victim);
+    victim->occupied = true;
+    victim->key = key;
+    victim->value = value;
+    victim->referenced.store(false, std::memory_order_relaxed);
+    UnlockExclusive(victim);
+    return value;
+  }
+
+  std::optional<const V> Get(const K& key) {
+    const int b = BucketIndex(key);
+    Counters& counters = counters_[b % kNumCounters];
+    for (Slot& slot : buckets_[b].slots) {
+      if (!TryLockShared(&slot)) continue;  // Being replaced.
+      if (slot.occupied && slot.key == key) {
+        std::optional<const V> value(slot.value);
+        // Checked first to avoid writing to the cache line of hot entries.
+        if (!slot.referenced.load(std::memory_order_relaxed)) {
+          slot.referenced.store(true, std::memory_order_relaxed);
+        }
+        UnlockShared(&slot);
+        counters.hits.fetch_add(1, std::memory_order_relaxed);
+        return value;
+      }
+      UnlockShared(&slot);
+    }
+    counters.misses.fetch_add(1, std::memory_order_relaxed);
+    return std::nullopt;
+  }
+
+  LRUCacheInfo Info() const {
+    LRUCacheInfo info;
+    for (const Counters& counters : counters_) {
+      info.hits += counters.hits.load(std::memory_order_relaxed);
+      info.misses += counters.misses.load(std::memory_order_relaxed);
+    }
+    info.size = Size();
+    info.max_size = num_buckets_ * kWays;
+    return info;
+  }
+
+ private:
+  static constexpr int kWays = 8;
+  // The hits and misses are counted in several places to avoid contention.
+  static constexpr int kNumCounters = 16;
+  // Set in the slot state while it is written, otherwise the number of
+  // readers.
+  static constexpr uint32_t kWriter = 1u << 31;
+
+  struct Slot {
+    std::atomic<uint32_t> state{0};
+    std::atomic<bool> referenced{false};
+    bool occupied = false;
+    K key;
+    V value;
+  };
+
+  struct Bucket {
+    absl::Mutex mutex;  // Held by the writers of the bucket.
+    int clock_hand = 0;
+    Slot slots[kWays];
+  };
+
+  struct alignas(64) Counters {
+    std::atomic<int64_t> hits{0};
+    std::atomic<int64_t> misses{0};
+  };
+
+  int BucketIndex(const K& key) const {
+    return absl::Hash<K>{}(key) % num_buckets_;
+  }
+
+  static bool TryLockShared(Slot* slot) {
+    uint32_t state = slot->state.load(std::memory_order_relaxed);
+    while (!(state & kWriter)) {
+      if (slot->state.compare_exchange_weak(state, state + 1,
+                                            std::memory_order_acquire,
+                                            std::memory_order_relaxed)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  static void UnlockShared(Slot* slot) {
+    slot->state.fetch_sub(1, std::memory_order_release);
+  }
+
+  // Only called with the bucket lock held, so there is a single writer. New
+  // readers are kept out, and the current ones are waited for.
+  static void LockExclusive(Slot* slot) {
+    slot->state.fetch_or(kWriter, std::memory_order_acquire);
+    while (slot->state.load(std::memory_order_acquire) != kWriter) {}
+  }
+
+  static void UnlockExclusive(Slot* slot) {
+    slot->state.store(0, std::memory_order_release);
+  }
+
+  const int num_buckets_;
+  std::unique_ptr<Bucket[]> buckets_;
+  std::atomic<int> size_{0};
+  Counters counters_[kNumCounters];
+};
+
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_UTILS_CLOCK_CACHE_H_
@@ -0,0 +1,119 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/utils/clock_cache.h"
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/thread.h"
+
+namespace open_spiel {
+namespace {
+
+void TestClockCache() {
+  // A single bucket, so that the eviction order is known.
+  ClockCache<int, std::string> cache(8);
+
+  SPIEL_CHECK_EQ(cache.Size(), 0);
+
+  LRUCacheInfo info = cache.Info();
+  SPIEL_CHECK_EQ(info.hits, 0);
+  SPIEL_CHECK_EQ(info.misses, 0);
+  SPIEL_CHECK_EQ(info.size, 0);
+  SPIEL_CHECK_EQ(info.max_size, 8);
+  SPIEL_CHECK_EQ(info.Usage(), 0);
+  SPIEL_CHECK_EQ(info.HitRate(), 0);
+
+  SPIEL_CHECK_FALSE(cache.Get(1));
+
+  cache.Set(10, "10");
+  SPIEL_CHECK_EQ(cache.Size(), 1);
+
+  {
+    std::optional<const std::string> v = cache.Get(10);
+    SPIEL_CHECK_TRUE(v);
+    SPIEL_CHECK_EQ(*v, "10");
+  }
+
+  for (int i = 11; i < 18; ++i) cache.Set(i, absl::StrCat(i));
+  SPIEL_CHECK_EQ(cache.Size(), 8);
+
+  // 10 was read, so it gets a second chance, and 11 is evicted instead.
+  cache.Set(18, "18");
+  SPIEL_CHECK_EQ(cache.Size(), 8);
+  SPIEL_CHECK_TRUE(cache.Get(10));
+  SPIEL_CHECK_FALSE(cache.Get(11));  // evicted
+
+  // The clock hand moves on to the next entries.
+  cache.Set(19, "19");
+  SPIEL_CHECK_FALSE(cache.Get(12));  // evicted
+  cache.Set(20, "20");
+  SPIEL_CHECK_FALSE(cache.Get(13));  // evicted
+  SPIEL_CHECK_TRUE(cache.Get(10));
+
+  info = cache.Info();
+  SPIEL_CHECK_EQ(info.hits, 3);
+  SPIEL_CHECK_EQ(info.misses, 4);
+  SPIEL_CHECK_EQ(info.Usage(), 1);
+
+  cache.Clear();
+
+  SPIEL_CHECK_EQ(cache.Size(), 0);
+  SPIEL_CHECK_FALSE(cache.Get(18));  // evicted
+
+  SPIEL_CHECK_EQ(cache.Insert(19, "19"), "19");
+  SPIEL_CHECK_EQ(cache.Insert(19, "nineteen"), "19");  // keeps the first
+  SPIEL_CHECK_EQ(*cache.Get(19), "19");
+  SPIEL_CHECK_EQ(cache.Size(), 1);
+}
+
+void TestClockCacheThreads() {
+  constexpr int kNumThreads = 4;
+  constexpr int kNumKeys = 1000;
+  ClockCache<int, std::vector<int>> cache(256);
+  std::vector<Thread> threads;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&cache, t]() {
+      for (int i = 0; i < 20000; ++i) {
+        const int key = (i * 7919 + t * 104729) % kNumKeys;
+        std::optional<const std::vector<int>> value = cache.Get(key);
+        if (value) {
+          SPIEL_CHECK_EQ(*value, std::vector<int>({key, -key}));
+        } else {
+          SPIEL_CHECK_EQ(cache.Insert(key, {key, -key}),
+                         std::vector<int>({key, -key}));
+        }
+      }
+    });
+  }
+  for (Thread& thread : threads) thread.join();
+
+  LRUCacheInfo info = cache.Info();
+  SPIEL_CHECK_EQ(info.Total(), kNumThreads * 20000);
+  SPIEL_CHECK_GT(info.hits, 0);
+  SPIEL_CHECK_LE(info.size, info.max_size);
+  SPIEL_CHECK_EQ(info.max_size, 256);
+}
+
+}  // namespace
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  open_spiel::TestClockCache();
+  open_spiel::TestClockCacheThreads();
+}
@@ -0,0 +1,99 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/utils/constrained_deal.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/types/span.h"
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace {
+
+// Whether the cards still to deal, counted by the set of hands they may go
+// to, fit into the free space: for every set of hands, the cards that may only
+// go to those hands fit into them.
+bool Possible(const std::vector<int>& counts, const std::vector<int>& space,
+              int num_hands) {
+  // The number of cards confined to each set of hands, by summing over its
+  // subsets one hand at a time.
+  std::vector<int> confined = counts;
+  for (int h = 0; h < num_hands; ++h) {
+    for (int set = 0; set < confined.size(); ++set) {
+      if (set & (1 << h)) confined[set] += confined[set ^ (1 << h)];
+    }
+  }
+  if (confined[0] > 0) return false;
+  for (int set = 1; set < confined.size(); ++set) {
+    int free = 0;
+    for (int h = 0; h < num_hands; ++h) {
+      if (set & (1 << h)) free += space[h];
+    }
+    if (confined[set] > free) return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+std::vector<int> ConstrainedDeal(absl::Span<const uint32_t> allowed,
+                                 absl::Span<const int> hand_sizes,
+                                 const std::function<double()>& rng) {
+  const int num_hands = hand_sizes.size();
+  SPIEL_CHECK_LE(num_hands, kMaxConstrainedDealHands);
+  const uint32_t all_hands = (1 << num_hands) - 1;
+  std::vector<int> counts(1 << num_hands, 0);
+  for (uint32_t hands : allowed) ++counts[hands & all_hands];
+  std::vector<int> space(hand_sizes.begin(), hand_sizes.end());
+  int total_space = 0;
+  for (int size : space) total_space += size;
+  SPIEL_CHECK_EQ(total_space, allowed.size());
+  SPIEL_CHECK_TRUE(Possible(counts, space, num_hands));
+
+  std::vector<int> deal(allowed.size());
+  for (int i = 0; i < allowed.size(); ++i) {
+    const uint32_t hands = allowed[i] & all_hands;
+    --counts[hands];
+    // Drop the hands that would make the rest impossible until one is drawn
+    // that doesn't. As the deal was possible, one of them keeps it so.
+    uint32_t candidates = hands;
+    while (true) {
+      int total = 0;
+      for (int h = 0; h < num_hands; ++h) {
+        if (candidates & (1 << h)) total += space[h];
+      }
+      SPIEL_CHECK_GT(total, 0);
+      int target = std::min<int>(rng() * total, total - 1);
+      int hand = 0;
+      while (!(candidates & (1 << hand)) || target >= space[hand]) {
+        if (candidates & (1 << hand)) target -= space[hand];
+        ++hand;
+      }
+      --space[hand];
+      if (Possible(counts, space, num_hands)) {
+        deal[i] = hand;
+        break;
+      }
+      ++space[hand];
+      candidates &= ~(1 << hand);
+    }
+  }
+  return deal;
+}
+
+}  // namespace open_spiel
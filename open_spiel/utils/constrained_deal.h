@@ -0,0 +1,45 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_UTILS_CONSTRAINED_DEAL_H_
+#define OPEN_SPIEL_UTILS_CONSTRAINED_DEAL_H_
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/types/span.h"
+
+namespace open_spiel {
+
+inline constexpr int kMaxConstrainedDealHands = 8;
+
+// Deals cards into hands of the given sizes, where each card may only go to
+// some of the hands, e.g. for resampling the hidden hands of a card game in
+// which a player who didn't follow suit can't hold that suit. allowed[i] is
+// the bitmask of the hands that card i may go to, and the sizes must add up
+// to the number of cards. Returns the hand of each card.
+//
+// The cards are dealt one at a time, each to a hand drawn with probability
+// proportional to its free space among the hands that keep the rest of the
+// deal possible, which Hall's condition on the sets of hands tells. Without
+// constraints that is a uniformly random deal; with them it is close to one.
+// It takes O(n h 2^h) for n cards and h hands, and the deal must be possible.
+std::vector<int> ConstrainedDeal(absl::Span<const uint32_t> allowed,
+                                 absl::Span<const int> hand_sizes,
+                                 const std::function<double()>& rng);
+
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_UTILS_CONSTRAINED_DEAL_H_
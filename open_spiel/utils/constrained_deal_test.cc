@@ -0,0 +1,75 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/utils/constrained_deal.h"
+
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace {
+
+std::function<double()> Sampler(std::mt19937* rng) {
+  return [rng]() { return std::uniform_real_distribution<double>()(*rng); };
+}
+
+void TestUnconstrainedDealIsUniform() {
+  // Two cards into hands of sizes 1 and 1: each card is equally likely in
+  // either hand.
+  std::mt19937 gen(1);
+  std::function<double()> rng = Sampler(&gen);
+  std::vector<uint32_t> allowed = {0b11, 0b11};
+  std::vector<int> sizes = {1, 1};
+  int first_in_hand_0 = 0;
+  const int num_deals = 10000;
+  for (int i = 0; i < num_deals; ++i) {
+    std::vector<int> deal = ConstrainedDeal(allowed, sizes, rng);
+    SPIEL_CHECK_NE(deal[0], deal[1]);
+    first_in_hand_0 += deal[0] == 0;
+  }
+  SPIEL_CHECK_GT(first_in_hand_0, 0.45 * num_deals);
+  SPIEL_CHECK_LT(first_in_hand_0, 0.55 * num_deals);
+}
+
+void TestConstrainedDeal() {
+  // Hand 0 can't hold cards 0-3, and hand 2 can't hold cards 4-5, so whatever
+  // is drawn first, cards 4 and 5 must end up in hands 0 and 1 and leave room
+  // for cards 0-3 in hands 1 and 2.
+  std::mt19937 gen(2);
+  std::function<double()> rng = Sampler(&gen);
+  std::vector<uint32_t> allowed = {0b110, 0b110, 0b110, 0b110,
+                                   0b011, 0b011, 0b111};
+  std::vector<int> sizes = {2, 2, 3};
+  for (int i = 0; i < 1000; ++i) {
+    std::vector<int> deal = ConstrainedDeal(allowed, sizes, rng);
+    std::vector<int> dealt(sizes.size(), 0);
+    for (int card = 0; card < allowed.size(); ++card) {
+      SPIEL_CHECK_TRUE(allowed[card] & (1 << deal[card]));
+      ++dealt[deal[card]];
+    }
+    SPIEL_CHECK_EQ(dealt, sizes);
+  }
+}
+
+}  // namespace
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  open_spiel::TestUnconstrainedDealIsUniform();
+  open_spiel::TestConstrainedDeal();
+}
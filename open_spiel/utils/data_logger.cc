@@ -14,14 +14,176 @@
 
 #include "open_spiel/utils/data_logger.h"
 
+#include <cmath>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
 #include "open_spiel/abseil-cpp/absl/strings/str_format.h"
 #include "open_spiel/abseil-cpp/absl/strings/str_join.h"
+#include "open_spiel/abseil-cpp/absl/strings/string_view.h"
+#include "open_spiel/abseil-cpp/absl/strings/strip.h"
+#include "open_spiel/abseil-cpp/absl/synchronization/mutex.h"
 #include "open_spiel/abseil-cpp/absl/time/clock.h"
 #include "open_spiel/abseil-cpp/absl/time/time.h"
 #include "open_spiel/spiel_utils.h"
 #include "open_spiel/utils/json.h"
+#include "open_spiel/utils/varint.h"
 
 namespace open_spiel {
+namespace {
+
+// Adds time_abs and time_rel to the record, unless it was timestamped
+// already, e.g. by DataLoggerAsync when it was written.
+void AddTimes(absl::Time start_time, DataLogger::Record* record) {
+  if (record->count("time_abs")) return;
+  absl::Time now = absl::Now();
+  record->insert({
+      {"time_abs", absl::ToUnixMicros(now) / 1000000.},
+      {"time_rel", absl::ToDoubleSeconds(now - start_time)},
+  });
+}
+
+// Adds time_str, derived from time_abs.
+void AddTimeString(DataLogger::Record* record) {
+  static absl::TimeZone utc = absl::UTCTimeZone();
+  auto time_abs = record->find("time_abs");
+  if (time_abs == record->end() || !time_abs->second.IsDouble()) return;
+  absl::Time time = absl::FromUnixMicros(
+      std::llround(time_abs->second.GetDouble() * 1000000.));
+  record->insert(
+      {"time_str", absl::FormatTime("%Y-%m-%d %H:%M:%E6S %z", time, utc)});
+}
+
+// The binary log's value types, written as a byte before each value.
+enum BinaryTag : char {
+  kNullTag,
+  kFalseTag,
+  kTrueTag,
+  kIntTag,
+  kDoubleTag,
+  kStringTag,
+  kArrayTag,
+  kObjectTag,
+};
+
+void AppendString(absl::string_view str, std::string* out) {
+  AppendVarint(str.size(), out);
+  out->append(str.data(), str.size());
+}
+
+void AppendKey(const std::string& key, std::map<std::string, int64_t>* keys,
+               std::string* out) {
+  auto [iter, inserted] = keys->emplace(key, keys->size());
+  AppendVarint(iter->second, out);
+  if (inserted) AppendString(key, out);
+}
+
+void AppendValue(const json::Value& value,
+                 std::map<std::string, int64_t>* keys, std::string* out);
+
+void AppendObject(const json::Object& object,
+                  std::map<std::string, int64_t>* keys, std::string* out) {
+  AppendVarint(object.size(), out);
+  for (const auto& [key, value] : object) {
+    AppendKey(key, keys, out);
+    AppendValue(value, keys, out);
+  }
+}
+
+void AppendValue(const json::Value& value,
+                 std::map<std::string, int64_t>* keys, std::string* out) {
+  if (value.IsNull()) {
+    out->push_back(kNullTag);
+  } else if (value.IsBool()) {
+    out->push_back(value.GetBool() ? kTrueTag : kFalseTag);
+  } else if (value.IsInt()) {
+    out->push_back(kIntTag);
+    AppendSignedVarint(value.GetInt(), out);
+  } else if (value.IsDouble()) {
+    out->push_back(kDoubleTag);
+    AppendDouble(value.GetDouble(), out);
+  } else if (value.IsString()) {
+    out->push_back(kStringTag);
+    AppendString(value.GetString(), out);
+  } else if (value.IsArray()) {
+    out->push_back(kArrayTag);
+    AppendVarint(value.GetArray().size(), out);
+    for (const json::Value& element : value.GetArray()) {
+      AppendValue(element, keys, out);
+    }
+  } else {
+    out->push_back(kObjectTag);
+    AppendObject(value.GetObject(), keys, out);
+  }
+}
+
+// Reads the values of a binary log, learning its keys as they appear.
+class BinaryLogReader {
+ public:
+  json::Object ReadObject(VarintReader* reader) {
+    json::Object object;
+    const uint64_t size = reader->ReadSize();
+    for (uint64_t i = 0; i < size && reader->ok(); ++i) {
+      std::string key = ReadKey(reader);
+      object.emplace(std::move(key), ReadValue(reader));
+    }
+    return object;
+  }
+
+ private:
+  std::string ReadKey(VarintReader* reader) {
+    const uint64_t index = reader->Read();
+    if (index == keys_.size()) {
+      keys_.emplace_back(reader->ReadBytes(reader->Read()));
+    }
+    if (!reader->ok() || index >= keys_.size()) {
+      SpielFatalError("Malformed key in binary log.");
+    }
+    return keys_[index];
+  }
+
+  json::Value ReadValue(VarintReader* reader) {
+    const absl::string_view tag = reader->ReadBytes(1);
+    if (!reader->ok()) return json::Null();
+    switch (tag[0]) {
+      case kNullTag:
+        return json::Null();
+      case kFalseTag:
+        return false;
+      case kTrueTag:
+        return true;
+      case kIntTag:
+        return reader->ReadSigned();
+      case kDoubleTag:
+        return reader->ReadDouble();
+      case kStringTag:
+        return std::string(reader->ReadBytes(reader->Read()));
+      case kArrayTag: {
+        json::Array array;
+        const uint64_t size = reader->ReadSize();
+        for (uint64_t i = 0; i < size && reader->ok(); ++i) {
+          array.push_back(ReadValue(reader));
+        }
+        return array;
+      }
+      case kObjectTag:
+        return ReadObject(reader);
+      default:
+        SpielFatalError(absl::StrCat("Unknown value tag in binary log: ",
+                                     static_cast<int>(tag[0])));
+    }
+  }
+
+  std::vector<std::string> keys_;
+};
+
+}  // namespace
 
 DataLoggerJsonLines::DataLoggerJsonLines(const std::string& path,
                                          const std::string& name, bool flush)
@@ -30,15 +192,12 @@ DataLoggerJsonLines::DataLoggerJsonLines(const std::string& path,
       start_time_(absl::Now()) {}
 
 void DataLoggerJsonLines::Write(DataLogger::Record record) {
-  static absl::TimeZone utc = absl::UTCTimeZone();
-  absl::Time now = absl::Now();
-  record.insert({
-      {"time_str", absl::FormatTime("%Y-%m-%d %H:%M:%E6S %z", now, utc)},
-      {"time_abs", absl::ToUnixMicros(now) / 1000000.},
-      {"time_rel", absl::ToDoubleSeconds(now - start_time_)},
-  });
-  fd_.Write(json::ToString(record));
-  fd_.Write("\n");
+  AddTimes(start_time_, &record);
+  AddTimeString(&record);
+  buffer_.clear();
+  json::AppendToString(record, &buffer_);
+  buffer_.push_back('\n');
+  fd_.Write(buffer_);
   if (flush_) {
     Flush();
   }
@@ -48,4 +207,120 @@ void DataLoggerJsonLines::Flush() { fd_.Flush(); }
 
 DataLoggerJsonLines::~DataLoggerJsonLines() { Flush(); }
 
+DataLoggerBinary::DataLoggerBinary(const std::string& path,
+                                   const std::string& name, bool flush)
+    : fd_(absl::StrFormat("%s/%s.binlog", path, name), "w"),
+      flush_(flush),
+      start_time_(absl::Now()) {
+  fd_.Write(kBinaryLogMagic);
+}
+
+void DataLoggerBinary::Write(DataLogger::Record record) {
+  AddTimes(start_time_, &record);
+  buffer_.clear();
+  AppendObject(record, &keys_, &buffer_);
+  std::string size;
+  AppendVarint(buffer_.size(), &size);
+  fd_.Write(size);
+  fd_.Write(buffer_);
+  if (flush_) {
+    Flush();
+  }
+}
+
+void DataLoggerBinary::Flush() { fd_.Flush(); }
+
+DataLoggerBinary::~DataLoggerBinary() { Flush(); }
+
+std::vector<DataLogger::Record> ReadBinaryLog(const std::string& filename) {
+  const file::MMapFile log(filename,
+                          {file::MMapFile::Access::kSequential});
+  absl::string_view bytes = log.Contents();
+  if (!absl::ConsumePrefix(&bytes, kBinaryLogMagic)) {
+    SpielFatalError(absl::StrCat(filename, " is not a binary log."));
+  }
+  std::vector<DataLogger::Record> records;
+  BinaryLogReader log_reader;
+  VarintReader reader(bytes);
+  while (!reader.empty()) {
+    absl::string_view record_bytes = reader.ReadBytes(reader.Read());
+    // A record cut short, by a crash while it was written, ends the log.
+    if (!reader.ok()) break;
+    VarintReader record_reader(record_bytes);
+    records.push_back(log_reader.ReadObject(&record_reader));
+    if (!record_reader.ok() || !record_reader.empty()) {
+      SpielFatalError(absl::StrCat("Malformed record in ", filename));
+    }
+    AddTimeString(&records.back());
+  }
+  return records;
+}
+
+void BinaryLogToJsonLines(const std::string& binary_filename,
+                          const std::string& json_lines_filename) {
+  file::File fd(json_lines_filename, "w");
+  std::string buffer;
+  for (const DataLogger::Record& record : ReadBinaryLog(binary_filename)) {
+    buffer.clear();
+    json::AppendToString(record, &buffer);
+    buffer.push_back('\n');
+    fd.Write(buffer);
+  }
+}
+
+DataLoggerAsync::DataLoggerAsync(std::unique_ptr<DataLogger> logger,
+                                 int max_queued, bool flush)
+    : logger_(std::move(logger)),
+      flush_(flush),
+      start_time_(absl::Now()),
+      queue_(max_queued),
+      writer_([this]() { WriteRecords(); }) {}
+
+DataLoggerAsync::~DataLoggerAsync() {
+  // The writer drains the queue before it stops.
+  queue_.BlockNewValues();
+  writer_.join();
+  logger_->Flush();
+}
+
+void DataLoggerAsync::Write(DataLogger::Record record) {
+  AddTimes(start_time_, &record);
+  {
+    absl::MutexLock lock(&mutex_);
+    ++num_queued_;
+  }
+  SPIEL_CHECK_TRUE(queue_.Push(std::move(record)));
+}
+
+void DataLoggerAsync::Flush() {
+  {
+    absl::MutexLock lock(&mutex_);
+    std::pair<DataLoggerAsync*, int64_t> flush(this, num_queued_);
+    mutex_.Await(absl::Condition(
+        +[](std::pair<DataLoggerAsync*, int64_t>* flush) {
+          return flush->first->num_written_ >= flush->second;
+        },
+        &flush));
+  }
+  absl::MutexLock lock(&logger_mutex_);
+  logger_->Flush();
+}
+
+void DataLoggerAsync::WriteRecords() {
+  while (std::optional<Record> record = queue_.Pop()) {
+    int64_t num_written = 0;
+    {
+      absl::MutexLock lock(&logger_mutex_);
+      do {
+        logger_->Write(std::move(*record));
+        ++num_written;
+        record = queue_.Pop(absl::ZeroDuration());
+      } while (record);
+      if (flush_) logger_->Flush();
+    }
+    absl::MutexLock lock(&mutex_);
+    num_written_ += num_written;
+  }
+}
+
 }  // namespace open_spiel
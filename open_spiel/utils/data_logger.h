@@ -15,13 +15,20 @@
 #ifndef OPEN_SPIEL_UTILS_DATA_LOGGER_H_
 #define OPEN_SPIEL_UTILS_DATA_LOGGER_H_
 
+#include <cstdint>
+#include <map>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "open_spiel/abseil-cpp/absl/strings/string_view.h"
+#include "open_spiel/abseil-cpp/absl/synchronization/mutex.h"
 #include "open_spiel/abseil-cpp/absl/time/time.h"
 #include "open_spiel/utils/file.h"
 #include "open_spiel/utils/json.h"
+#include "open_spiel/utils/thread.h"
+#include "open_spiel/utils/threaded_queue.h"
 
 namespace open_spiel {
 
@@ -54,6 +61,81 @@ class DataLoggerJsonLines : public DataLogger {
   file::File fd_;
   bool flush_;
   absl::Time start_time_;
+  std::string buffer_;
+};
+
+inline constexpr absl::string_view kBinaryLogMagic = "OSLOGv1\n";
+
+// Writes to a file in a compact binary format, which is cheaper to produce
+// than json for frequent records. The file starts with kBinaryLogMagic, and
+// each record is a varint byte count followed by its fields. Keys are
+// numbered in order of first appearance, and a new key is written in full
+// after its number, so the repeated keys of a log cost a byte or two each.
+// Records are timestamped like the json lines logger, except that time_str is
+// left for ReadBinaryLog to derive from time_abs.
+class DataLoggerBinary : public DataLogger {
+ public:
+  explicit DataLoggerBinary(const std::string& path, const std::string& name,
+                            bool flush = false);
+  ~DataLoggerBinary() override;
+
+  DataLoggerBinary(DataLoggerBinary&& other) = default;
+  DataLoggerBinary& operator=(DataLoggerBinary&& other) = default;
+  DataLoggerBinary(const DataLoggerBinary&) = delete;
+  DataLoggerBinary& operator=(const DataLoggerBinary&) = delete;
+
+  void Write(Record record) override;
+  void Flush() override;
+
+ private:
+  file::File fd_;
+  bool flush_;
+  absl::Time start_time_;
+  std::map<std::string, int64_t> keys_;
+  std::string buffer_;
+};
+
+// Reads the records of a file written by DataLoggerBinary, as the json lines
+// logger would have written them.
+std::vector<DataLogger::Record> ReadBinaryLog(const std::string& filename);
+
+// Converts a file written by DataLoggerBinary to json lines.
+void BinaryLogToJsonLines(const std::string& binary_filename,
+                          const std::string& json_lines_filename);
+
+// Passes the records on to another logger from a background thread, so that
+// Write only timestamps and enqueues them, and the formatting and the disk
+// writes stay off the caller's thread. At most max_queued records wait to be
+// written, beyond which Write blocks. The writer thread takes all the records
+// waiting at once, and flushes the logger once per batch rather than once per
+// record. Flush returns once the records written before it reach the logger,
+// and are flushed. Write may be called from several threads.
+class DataLoggerAsync : public DataLogger {
+ public:
+  explicit DataLoggerAsync(std::unique_ptr<DataLogger> logger,
+                           int max_queued = 1024, bool flush = false);
+  ~DataLoggerAsync() override;
+
+  DataLoggerAsync(const DataLoggerAsync&) = delete;
+  DataLoggerAsync& operator=(const DataLoggerAsync&) = delete;
+
+  void Write(Record record) override;
+  void Flush() override;
+
+ private:
+  void WriteRecords();
+
+  std::unique_ptr<DataLogger> logger_;
+  bool flush_;
+  absl::Time start_time_;
+  ThreadedQueue<Record> queue_;
+  absl::Mutex mutex_;
+  // The numbers of records queued and written so far, guarded by mutex_.
+  int64_t num_queued_ = 0;
+  int64_t num_written_ = 0;
+  // Held while the writer thread uses the logger.
+  absl::Mutex logger_mutex_;
+  Thread writer_;
 };
 
 class DataLoggerNoop : public DataLogger {
@@ -15,11 +15,18 @@
 #include "open_spiel/utils/data_logger.h"
 
 #include <cstdlib>
+#include <memory>
 #include <string>
+#include <vector>
 
+#include "open_spiel/abseil-cpp/absl/strings/match.h"
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/abseil-cpp/absl/strings/str_split.h"
+#include "open_spiel/abseil-cpp/absl/strings/string_view.h"
 #include "open_spiel/spiel_utils.h"
 #include "open_spiel/utils/file.h"
 #include "open_spiel/utils/json.h"
+#include "open_spiel/utils/thread.h"
 
 namespace open_spiel {
 namespace {
@@ -70,9 +77,116 @@ void TestDataLogger() {
   SPIEL_CHECK_TRUE(file::Remove(dir));
 }
 
+std::string MakeTestDir() {
+  std::string dir = absl::StrCat(file::GetTmpDir(), "/open_spiel-test-",
+                                 std::rand());  // NOLINT
+  SPIEL_CHECK_TRUE(file::Mkdir(dir));
+  return dir;
+}
+
+void TestDataLoggerBinary() {
+  std::string dir = MakeTestDir();
+  std::string filename = dir + "/data-test.binlog";
+  std::string json_filename = dir + "/data-test.jsonl";
+  json::Object nested = {{"null", json::Null()}, {"list", json::Array{1, "a"}}};
+  {
+    DataLoggerBinary logger(dir, "data-test");
+    logger.Write({{"step", 1}, {"avg", 1.5}, {"name", "first"}});
+    logger.Write({{"step", -2}, {"done", true}, {"nested", nested}});
+  }
+  {
+    // A record of 5 bytes cut short after 2 at the end of the file is
+    // dropped.
+    file::File f(filename, "a");
+    f.Write("\x05" "ab");
+  }
+  SPIEL_CHECK_TRUE(absl::EndsWith(file::File(filename, "r").ReadContents(),
+                                  absl::string_view("\x05" "ab", 3)));
+
+  std::vector<json::Object> records = ReadBinaryLog(filename);
+  SPIEL_CHECK_EQ(records.size(), 2);
+  SPIEL_CHECK_EQ(records[0]["step"], 1);
+  SPIEL_CHECK_EQ(records[0]["avg"], 1.5);
+  SPIEL_CHECK_EQ(records[0]["name"], "first");
+  SPIEL_CHECK_TRUE(records[0]["time_str"].IsString());
+  SPIEL_CHECK_TRUE(records[0]["time_abs"].IsDouble());
+  SPIEL_CHECK_TRUE(records[0]["time_rel"].IsDouble());
+  SPIEL_CHECK_EQ(records[1]["step"], -2);
+  SPIEL_CHECK_EQ(records[1]["done"], true);
+  SPIEL_CHECK_EQ(records[1]["nested"], nested);
+  SPIEL_CHECK_LE(records[0]["time_rel"].GetDouble(),
+                 records[1]["time_rel"].GetDouble());
+
+  // The keys are written in full once, so the second record repeats none.
+  std::string contents = file::File(filename, "r").ReadContents();
+  std::vector<std::string> parts = absl::StrSplit(contents, "time_abs");
+  SPIEL_CHECK_EQ(parts.size(), 2);
+
+  BinaryLogToJsonLines(filename, json_filename);
+  std::vector<std::string> lines = absl::StrSplit(
+      file::File(json_filename, "r").ReadContents(), '\n');
+  SPIEL_CHECK_EQ(lines.size(), 3);
+  for (int i = 0; i < 2; ++i) {
+    json::Object record = json::FromString(lines[i])->GetObject();
+    SPIEL_CHECK_EQ(record.size(), records[i].size());
+    SPIEL_CHECK_EQ(record["step"], records[i]["step"]);
+    SPIEL_CHECK_EQ(record["time_str"], records[i]["time_str"]);
+  }
+
+  SPIEL_CHECK_TRUE(file::Remove(filename));
+  SPIEL_CHECK_TRUE(file::Remove(json_filename));
+  SPIEL_CHECK_TRUE(file::Remove(dir));
+}
+
+void TestDataLoggerAsync() {
+  std::string dir = MakeTestDir();
+  std::string filename = dir + "/data-test.jsonl";
+  constexpr int kNumThreads = 4;
+  constexpr int kRecordsPerThread = 500;
+  {
+    // A small queue, so that the writers block on it.
+    DataLoggerAsync logger(
+        std::make_unique<DataLoggerJsonLines>(dir, "data-test"),
+        /*max_queued=*/16);
+    logger.Write({{"thread", -1}, {"step", 0}});
+    logger.Flush();
+    std::vector<std::string> lines = absl::StrSplit(
+        file::File(filename, "r").ReadContents(), '\n');
+    SPIEL_CHECK_EQ(lines.size(), 2);
+
+    std::vector<Thread> threads;
+    for (int t = 0; t < kNumThreads; ++t) {
+      threads.emplace_back([&logger, t]() {
+        for (int step = 0; step < kRecordsPerThread; ++step) {
+          logger.Write({{"thread", t}, {"step", step}});
+        }
+      });
+    }
+    for (Thread& thread : threads) thread.join();
+  }
+
+  // Each thread's records are in order, and timestamped when written.
+  std::vector<std::string> lines =
+      absl::StrSplit(file::File(filename, "r").ReadContents(), '\n');
+  SPIEL_CHECK_EQ(lines.size(), kNumThreads * kRecordsPerThread + 2);
+  std::vector<int> next_step(kNumThreads, 0);
+  for (int i = 1; i + 1 < lines.size(); ++i) {
+    json::Object record = json::FromString(lines[i])->GetObject();
+    int thread = record["thread"].GetInt();
+    SPIEL_CHECK_EQ(record["step"].GetInt(), next_step[thread]++);
+    SPIEL_CHECK_TRUE(record["time_str"].IsString());
+  }
+  SPIEL_CHECK_EQ(next_step, std::vector<int>(kNumThreads, kRecordsPerThread));
+
+  SPIEL_CHECK_TRUE(file::Remove(filename));
+  SPIEL_CHECK_TRUE(file::Remove(dir));
+}
+
 }  // namespace
 }  // namespace open_spiel
 
 int main(int argc, char** argv) {
   open_spiel::TestDataLogger();
+  open_spiel::TestDataLoggerBinary();
+  open_spiel::TestDataLoggerAsync();
 }
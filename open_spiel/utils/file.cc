@@ -24,9 +24,15 @@
 #define mkdir(dir, mode) _mkdir(dir)
 #define unlink(file) _unlink(file)
 #define rmdir(dir) _rmdir(dir)
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
 #endif
 
 #include <cstdio>
+#include <utility>
+
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
 
 #include "open_spiel/spiel_utils.h"
 
@@ -81,6 +87,106 @@ std::int64_t File::Length() {
   return length;
 }
 
+MMapFile::MMapFile(const std::string& filename)
+    : MMapFile(filename, Options()) {}
+
+#ifdef _WIN32
+
+MMapFile::MMapFile(const std::string& filename, const Options& options)
+    : contents_(File(filename, "rb").ReadContents()) {
+  data_ = contents_.data();
+  size_ = contents_.size();
+}
+
+MMapFile::~MMapFile() = default;
+
+MMapFile::MMapFile(MMapFile&& other)
+    : contents_(std::move(other.contents_)) {
+  data_ = contents_.data();
+  size_ = contents_.size();
+  other.data_ = nullptr;
+  other.size_ = 0;
+}
+
+MMapFile& MMapFile::operator=(MMapFile&& other) {
+  contents_ = std::move(other.contents_);
+  data_ = contents_.data();
+  size_ = contents_.size();
+  other.data_ = nullptr;
+  other.size_ = 0;
+  return *this;
+}
+
+void MMapFile::Unmap() {}
+
+#else
+
+MMapFile::MMapFile(const std::string& filename, const Options& options) {
+  const int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    SpielFatalError(absl::StrCat("Could not open ", filename));
+  }
+  struct stat info;
+  if (fstat(fd, &info) != 0) {
+    close(fd);
+    SpielFatalError(absl::StrCat("Could not stat ", filename));
+  }
+  size_ = info.st_size;
+  // Empty files cannot be mapped, and need not be.
+  if (size_ == 0) {
+    close(fd);
+    return;
+  }
+  int flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+  if (options.populate) flags |= MAP_POPULATE;
+#endif
+  void* data = mmap(nullptr, size_, PROT_READ, flags, fd, 0);
+  close(fd);  // The mapping keeps the file open.
+  if (data == MAP_FAILED) {
+    SpielFatalError(absl::StrCat("Could not map ", filename));
+  }
+  data_ = static_cast<const char*>(data);
+
+  // The hints are only hints, so failures are ignored.
+  switch (options.access) {
+    case Access::kNormal:
+      break;
+    case Access::kSequential:
+      madvise(data, size_, MADV_SEQUENTIAL);
+      break;
+    case Access::kRandom:
+      madvise(data, size_, MADV_RANDOM);
+      break;
+  }
+#ifdef MADV_HUGEPAGE
+  if (options.huge_pages) madvise(data, size_, MADV_HUGEPAGE);
+#endif
+}
+
+MMapFile::~MMapFile() { Unmap(); }
+
+MMapFile::MMapFile(MMapFile&& other)
+    : data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)) {}
+
+MMapFile& MMapFile::operator=(MMapFile&& other) {
+  if (this != &other) {
+    Unmap();
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+  }
+  return *this;
+}
+
+void MMapFile::Unmap() {
+  if (data_ != nullptr) munmap(const_cast<char*>(data_), size_);
+  data_ = nullptr;
+  size_ = 0;
+}
+
+#endif  // _WIN32
+
 bool Exists(const std::string& path) {
   struct stat info;
   return stat(path.c_str(), &info) == 0;
@@ -123,6 +229,10 @@ bool Remove(const std::string& path) {
   }
 }
 
+bool Rename(const std::string& from, const std::string& to) {
+  return std::rename(from.c_str(), to.c_str()) == 0;
+}
+
 std::string GetEnv(const std::string& key, const std::string& default_value) {
     char* val = std::getenv(key.c_str());
     return ((val != nullptr) ? std::string(val) : default_value);
@@ -15,6 +15,7 @@
 #ifndef OPEN_SPIEL_UTILS_FILE_H_
 #define OPEN_SPIEL_UTILS_FILE_H_
 
+#include <cstdint>
 #include <string>
 #include <memory>
 
@@ -54,11 +55,64 @@ class File {
   std::unique_ptr<FileImpl> fd_;
 };
 
+// A file mapped read-only into memory for as long as this lives, so that
+// large files are read in place rather than copied to the heap, and the
+// processes mapping the same file share its pages in the page cache.
+class MMapFile {
+ public:
+  // How the contents will be read, passed on to the kernel with madvise to
+  // tune the read-ahead.
+  enum class Access {
+    kNormal,
+    kSequential,
+    kRandom,
+  };
+
+  struct Options {
+    Access access = Access::kNormal;
+    // Read the whole file in when it is mapped, rather than on first access.
+    bool populate = false;
+    // Ask for transparent huge pages, which cut TLB misses when reading a
+    // large file randomly. Only some filesystems support them for files, and
+    // the hint is ignored elsewhere.
+    bool huge_pages = false;
+  };
+
+  explicit MMapFile(const std::string& filename);
+  MMapFile(const std::string& filename, const Options& options);
+  ~MMapFile();  // Unmap.
+
+  // MMapFile is move only.
+  MMapFile(MMapFile&& other);
+  MMapFile& operator=(MMapFile&& other);
+  MMapFile(const MMapFile&) = delete;
+  MMapFile& operator=(const MMapFile&) = delete;
+
+  absl::string_view Contents() const {
+    return absl::string_view(data_, size_);
+  }
+  const char* data() const { return data_; }
+  std::int64_t size() const { return size_; }
+
+ private:
+  void Unmap();
+
+  const char* data_ = nullptr;
+  std::int64_t size_ = 0;
+#ifdef _WIN32
+  // Windows has no mmap, so the contents are read instead.
+  std::string contents_;
+#endif
+};
+
 bool Exists(const std::string& path);  // Does the file/directory exist?
 bool IsDirectory(const std::string& path);  // Is it a directory?
 bool Mkdir(const std::string& path, int mode = 0755);  // Make a directory.
 bool Mkdirs(const std::string& path, int mode = 0755);  // Mkdir recursively.
 bool Remove(const std::string& path);  // Remove/delete the file/directory.
+// Moves the file, replacing any file at to. The replacement is atomic on
+// POSIX, so readers of to see either file, e.g. to publish a finished file.
+bool Rename(const std::string& from, const std::string& to);
 
 std::string GetEnv(const std::string& key, const std::string& default_value);
 std::string GetTmpDir();
@@ -69,6 +69,26 @@ void TestFile() {
     File f3(std::move(f2));
   }
 
+  {
+    MMapFile mapped(filename, {MMapFile::Access::kRandom, /*populate=*/true,
+                               /*huge_pages=*/true});
+    SPIEL_CHECK_EQ(mapped.size(), expected.size());
+    SPIEL_CHECK_EQ(mapped.Contents(), expected);
+    MMapFile moved(std::move(mapped));
+    SPIEL_CHECK_EQ(moved.Contents(), expected);
+    SPIEL_CHECK_TRUE(mapped.Contents().empty());  // NOLINT
+    mapped = std::move(moved);
+    SPIEL_CHECK_EQ(mapped.Contents(), expected);
+  }
+
+  std::string renamed = dir + "/renamed.txt";
+  File(renamed, "w").Write("replaced");
+  SPIEL_CHECK_TRUE(Rename(filename, renamed));
+  SPIEL_CHECK_FALSE(Exists(filename));
+  SPIEL_CHECK_EQ(File(renamed, "r").ReadContents(), expected);
+  SPIEL_CHECK_FALSE(Rename(filename, renamed));  // already moved
+  SPIEL_CHECK_TRUE(Rename(renamed, filename));
+
   SPIEL_CHECK_TRUE(Remove(filename));
   SPIEL_CHECK_FALSE(Remove(filename));  // already gone
   SPIEL_CHECK_FALSE(Exists(filename));
@@ -81,6 +101,15 @@ void TestFile() {
   SPIEL_CHECK_TRUE(Remove(dir + "/1/2"));
   SPIEL_CHECK_TRUE(Remove(dir + "/1"));
 
+  std::string empty_filename = dir + "/empty.txt";
+  File(empty_filename, "w");
+  {
+    MMapFile mapped(empty_filename);
+    SPIEL_CHECK_EQ(mapped.size(), 0);
+    SPIEL_CHECK_TRUE(mapped.Contents().empty());
+  }
+  SPIEL_CHECK_TRUE(Remove(empty_filename));
+
   SPIEL_CHECK_TRUE(Remove(dir));
   SPIEL_CHECK_FALSE(Exists(dir));
 }
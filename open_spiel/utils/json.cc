@@ -16,10 +16,12 @@
 
 #include <cmath>
 #include <cstdint>
+#include <cstdio>
 #include <optional>
 #include <string>
 
 #include "open_spiel/abseil-cpp/absl/strings/numbers.h"
+#include "open_spiel/abseil-cpp/absl/strings/match.h"
 #include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
 #include "open_spiel/abseil-cpp/absl/strings/string_view.h"
 #include "open_spiel/spiel_utils.h"
@@ -28,37 +30,86 @@ namespace open_spiel::json {
 
 namespace {
 
-std::string Escape(const std::string& input) {
-  std::string out;
-  out.reserve(input.length());
-  for (const char c : input) {
-    switch (c) {
-      case '"': out.append("\\\""); break;
-      case '\\': out.append("\\\\"); break;
-      case '\b': out.append("\\b"); break;
-      case '\f': out.append("\\f"); break;
-      case '\n': out.append("\\n"); break;
-      case '\r': out.append("\\r"); break;
-      case '\t': out.append("\\t"); break;
-      default: out.push_back(c); break;
+// Appends the string, quoted and escaped.
+void AppendQuoted(absl::string_view input, std::string* out) {
+  out->push_back('"');
+  const char* run = input.begin();
+  for (const char* c = input.begin(); c < input.end(); ++c) {
+    const char* escaped;
+    switch (*c) {
+      case '"': escaped = "\\\""; break;
+      case '\\': escaped = "\\\\"; break;
+      case '\b': escaped = "\\b"; break;
+      case '\f': escaped = "\\f"; break;
+      case '\n': escaped = "\\n"; break;
+      case '\r': escaped = "\\r"; break;
+      case '\t': escaped = "\\t"; break;
+      default: continue;
     }
+    out->append(run, c - run);
+    out->append(escaped);
+    run = c + 1;
   }
-  return out;
+  out->append(run, input.end() - run);
+  out->push_back('"');
 }
 
-void ConsumeWhitespace(absl::string_view* str) {
-  for (const char* c = str->begin(); c < str->end(); ++c) {
-    switch (*c) {
-      case ' ':
-      case '\n':
-      case '\r':
-      case '\t':
-        break;
-      default:
-        str->remove_prefix(c - str->begin());
-        return;
+// Appends the double as std::to_string would format it, quoted if it is not
+// finite, without allocating.
+void AppendDouble(double value, std::string* out) {
+  // Large enough for any double in %f notation.
+  char buffer[512];
+  const int size = std::snprintf(buffer, sizeof(buffer), "%f", value);
+  if (std::isfinite(value)) {
+    out->append(buffer, size);
+  } else {
+    // It'd be nice to show an error with a path, but at least this is
+    // debuggable by looking at the json. Crashing doesn't tell you where
+    // the problem is.
+    out->push_back('"');
+    out->append(buffer, size);
+    out->push_back('"');
+  }
+}
+
+void AppendIndent(bool wrap, int indent, std::string* out) {
+  if (wrap) {
+    out->push_back('\n');
+    out->append(indent, ' ');
+  }
+}
+
+void AppendArray(const Array& array, std::string* out, bool wrap, int indent) {
+  out->push_back('[');
+  bool first = true;
+  for (const Value& v : array) {
+    if (!first) {
+      out->append(wrap ? "," : ", ");
     }
+    first = false;
+    AppendIndent(wrap, indent + 2, out);
+    AppendToString(v, out, wrap, indent + 2);
   }
+  if (wrap) AppendIndent(wrap, indent, out);
+  out->push_back(']');
+}
+
+void AppendObject(const Object& obj, std::string* out, bool wrap,
+                  int indent) {
+  out->push_back('{');
+  bool first = true;
+  for (const auto& [key, value] : obj) {
+    if (!first) {
+      out->append(wrap ? "," : ", ");
+    }
+    first = false;
+    AppendIndent(wrap, indent + 2, out);
+    AppendQuoted(key, out);
+    out->append(": ");
+    AppendToString(value, out, wrap, indent + 2);
+  }
+  if (wrap) AppendIndent(wrap, indent, out);
+  out->push_back('}');
 }
 
 std::nullopt_t ParseError(absl::string_view error, absl::string_view str) {
@@ -70,252 +121,324 @@ std::nullopt_t ParseError(absl::string_view error, absl::string_view str) {
   return std::nullopt;
 }
 
-bool ConsumeToken(absl::string_view* str, absl::string_view token) {
-  if (absl::StartsWith(*str, token)) {
-    str->remove_prefix(token.size());
-    return true;
+// A single pass over the input, which parses each value in place into its
+// parent, and only allocates for the strings, arrays and objects it returns.
+class Parser {
+ public:
+  explicit Parser(absl::string_view str) : str_(str) {}
+
+  bool ParseValue(Value* out) {
+    ConsumeWhitespace();
+    if (str_.empty()) {
+      return Error("Empty string");
+    }
+    switch (str_.front()) {
+      case '-':
+      case '0':
+      case '1':
+      case '2':
+      case '3':
+      case '4':
+      case '5':
+      case '6':
+      case '7':
+      case '8':
+      case '9': return ParseNumber(out);
+      case 'n': return ParseConstant("null", Null(), out);
+      case 't': return ParseConstant("true", true, out);
+      case 'f': return ParseConstant("false", false, out);
+      case '"': return ParseString(&out->emplace<std::string>());
+      case '[': return ParseArray(&out->emplace<Array>());
+      case '{': return ParseObject(&out->emplace<Object>());
+      default: return Error("Unexpected char: ");
+    }
   }
-  return false;
-}
 
-template <typename T>
-std::optional<Value> ParseConstant(absl::string_view* str,
-                                   absl::string_view token, T value) {
-  if (ConsumeToken(str, token)) {
-    return value;
+ private:
+  bool Error(absl::string_view error) {
+    ParseError(error, str_);
+    return false;
   }
-  return ParseError("Invalid constant: ", *str);
-}
 
-std::optional<Value> ParseNumber(absl::string_view* str) {
-  size_t valid_double =
-      std::min(str->find_first_not_of("-+.0123456789eE"), str->size());
-  size_t valid_int =
-      std::min(str->find_first_not_of("-0123456789"), str->size());
-  if (valid_double == valid_int) {
-    if (int64_t v; absl::SimpleAtoi(str->substr(0, valid_int), &v)) {
-      str->remove_prefix(valid_int);
-      return Value(v);
+  void ConsumeWhitespace() {
+    size_t size = 0;
+    while (size < str_.size() &&
+           (str_[size] == ' ' || str_[size] == '\n' || str_[size] == '\r' ||
+            str_[size] == '\t')) {
+      ++size;
     }
-  } else {
-    if (double v; absl::SimpleAtod(str->substr(0, valid_double), &v)) {
-      str->remove_prefix(valid_double);
-      return Value(v);
+    str_.remove_prefix(size);
+  }
+
+  bool ConsumeToken(char token) {
+    if (!str_.empty() && str_.front() == token) {
+      str_.remove_prefix(1);
+      return true;
     }
+    return false;
   }
-  return ParseError("Invalid number", *str);
-}
 
-std::optional<std::string> ParseString(absl::string_view* str) {
-  if (!ConsumeToken(str, "\"")) {
-    return ParseError("Expected '\"'", *str);
+  template <typename T>
+  bool ParseConstant(absl::string_view token, T value, Value* out) {
+    if (absl::StartsWith(str_, token)) {
+      str_.remove_prefix(token.size());
+      *out = value;
+      return true;
+    }
+    return Error("Invalid constant: ");
   }
-  std::string out;
-  bool escape = false;
-  for (const char* c = str->begin(); c < str->end(); ++c) {
-    switch (*c) {
-      case '\\':
-        if (escape) {
-          out.push_back('\\');
-        }
-        escape = !escape;
-        break;
-      case '"':
-        if (escape) {
-          out.push_back('"');
-          escape = false;
-          break;
-        } else {
-          str->remove_prefix(c - str->begin() + 1);
-          return out;
-        }
-      default:
-        if (escape) {
-          switch (*c) {
-            case 'b': out.append("\b"); break;
-            case 'f': out.append("\f"); break;
-            case 'n': out.append("\n"); break;
-            case 'r': out.append("\r"); break;
-            case 't': out.append("\t"); break;
-            default: out.push_back(*c); break;
-          }
-          escape = false;
-        } else {
-          out.push_back(*c);
-        }
+
+  // Numbers without a fraction or exponent are integers.
+  bool ParseNumber(Value* out) {
+    size_t size = 0;
+    bool is_int = true;
+    for (; size < str_.size(); ++size) {
+      const char c = str_[size];
+      if (c == '.' || c == '+' || c == 'e' || c == 'E') {
+        is_int = false;
+      } else if (c != '-' && (c < '0' || c > '9')) {
         break;
+      }
+    }
+    if (is_int) {
+      if (int64_t v; absl::SimpleAtoi(str_.substr(0, size), &v)) {
+        str_.remove_prefix(size);
+        *out = v;
+        return true;
+      }
+    } else {
+      if (double v; absl::SimpleAtod(str_.substr(0, size), &v)) {
+        str_.remove_prefix(size);
+        *out = v;
+        return true;
+      }
     }
+    return Error("Invalid number");
   }
-  return ParseError("Unfinished string", *str);
-}
-
-std::optional<Value> ParseValue(absl::string_view* str);
 
-std::optional<Array> ParseArray(absl::string_view* str) {
-  if (!ConsumeToken(str, "[")) {
-    return ParseError("Expected '['", *str);
-  }
-  Array out;
-  bool first = true;
-  while (!str->empty()) {
-    ConsumeWhitespace(str);
-    if (ConsumeToken(str, "]")) {
-      return out;
+  // Copies the runs between escapes whole.
+  bool ParseString(std::string* out) {
+    if (!ConsumeToken('"')) {
+      return Error("Expected '\"'");
     }
-    if (!first && !ConsumeToken(str, ",")) {
-      return ParseError("Expected ','", *str);
+    size_t run = 0;
+    for (size_t i = 0; i < str_.size(); ++i) {
+      if (str_[i] == '"') {
+        out->append(str_.data() + run, i - run);
+        str_.remove_prefix(i + 1);
+        return true;
+      }
+      if (str_[i] != '\\') continue;
+      out->append(str_.data() + run, i - run);
+      if (++i == str_.size()) break;
+      switch (str_[i]) {
+        case 'b': out->push_back('\b'); break;
+        case 'f': out->push_back('\f'); break;
+        case 'n': out->push_back('\n'); break;
+        case 'r': out->push_back('\r'); break;
+        case 't': out->push_back('\t'); break;
+        default: out->push_back(str_[i]); break;
+      }
+      run = i + 1;
     }
-    first = false;
-    ConsumeWhitespace(str);
-    std::optional<Value> v = ParseValue(str);
-    if (!v) {
-      return std::nullopt;
-    }
-    out.push_back(*v);
+    return Error("Unfinished string");
   }
-  return ParseError("Unfinished array", *str);
-}
 
-std::optional<Object> ParseObject(absl::string_view* str) {
-  if (!ConsumeToken(str, "{")) {
-    return ParseError("Expected '{'", *str);
-  }
-  Object out;
-  bool first = true;
-  while (!str->empty()) {
-    ConsumeWhitespace(str);
-    if (ConsumeToken(str, "}")) {
-      return out;
-    }
-    if (!first && !ConsumeToken(str, ",")) {
-      return ParseError("Expected ','", *str);
+  bool ParseArray(Array* out) {
+    if (!ConsumeToken('[')) {
+      return Error("Expected '['");
     }
-    first = false;
-    ConsumeWhitespace(str);
-    std::optional<std::string> key = ParseString(str);
-    if (!key) {
-      return std::nullopt;
+    bool first = true;
+    while (!str_.empty()) {
+      ConsumeWhitespace();
+      if (ConsumeToken(']')) {
+        return true;
+      }
+      if (!first && !ConsumeToken(',')) {
+        return Error("Expected ','");
+      }
+      first = false;
+      ConsumeWhitespace();
+      if (!ParseValue(&out->emplace_back())) {
+        return false;
+      }
     }
-    ConsumeWhitespace(str);
-    if (!ConsumeToken(str, ":")) {
-      return ParseError("Expected ':'", *str);
+    return Error("Unfinished array");
+  }
+
+  bool ParseObject(Object* out) {
+    if (!ConsumeToken('{')) {
+      return Error("Expected '{'");
     }
-    ConsumeWhitespace(str);
-    std::optional<Value> v = ParseValue(str);
-    if (!v) {
-      return std::nullopt;
+    bool first = true;
+    std::string key;
+    while (!str_.empty()) {
+      ConsumeWhitespace();
+      if (ConsumeToken('}')) {
+        return true;
+      }
+      if (!first && !ConsumeToken(',')) {
+        return Error("Expected ','");
+      }
+      first = false;
+      ConsumeWhitespace();
+      key.clear();
+      if (!ParseString(&key)) {
+        return false;
+      }
+      ConsumeWhitespace();
+      if (!ConsumeToken(':')) {
+        return Error("Expected ':'");
+      }
+      ConsumeWhitespace();
+      // The first of repeated keys is kept.
+      auto [iter, inserted] = out->try_emplace(key);
+      Value repeated;
+      if (!ParseValue(inserted ? &iter->second : &repeated)) {
+        return false;
+      }
     }
-    out.emplace(*key, *v);
+    return Error("Unfinished object");
   }
-  return ParseError("Unfinished object", *str);
-}
 
-std::optional<Value> ParseValue(absl::string_view* str) {
-  ConsumeWhitespace(str);
-  if (str->empty()) {
-    return ParseError("Empty string", *str);
-  }
-  switch (str->at(0)) {
-    case '-':
-    case '0':
-    case '1':
-    case '2':
-    case '3':
-    case '4':
-    case '5':
-    case '6':
-    case '7':
-    case '8':
-    case '9': return ParseNumber(str);
-    case 'n': return ParseConstant(str, "null", Null());
-    case 't': return ParseConstant(str, "true", true);
-    case 'f': return ParseConstant(str, "false", false);
-    case '"': return ParseString(str);
-    case '[': return ParseArray(str);
-    case '{': return ParseObject(str);
-    default: return ParseError("Unexpected char: ", *str);
-  }
-}
+  absl::string_view str_;
+};
 
 }  // namespace
 
 bool Null::operator==(const Null& o) const { return true; }
 bool Null::operator!=(const Null& o) const { return false; }
 
-std::string ToString(const Array& array, bool wrap, int indent) {
-  std::string out = "[";
-  bool first = true;
-  for (const Value& v : array) {
-    if (!first) {
-      absl::StrAppend(&out, ",");
-    }
-    if (wrap) {
-      absl::StrAppend(&out, "\n", std::string(indent + 2, ' '));
-    } else if (!first) {
-      absl::StrAppend(&out, " ");
-    }
-    first = false;
-    absl::StrAppend(&out, json::ToString(v, wrap, indent + 2));
-  }
-  if (wrap) {
-    absl::StrAppend(&out, "\n", std::string(indent, ' '));
-  }
-  absl::StrAppend(&out, "]");
-  return out;
-}
-
-std::string ToString(const Object& obj, bool wrap, int indent) {
-  std::string out = "{";
-  bool first = true;
-  for (const auto& [key, value] : obj) {
-    if (!first) {
-      absl::StrAppend(&out, ",");
-    }
-    if (wrap) {
-      absl::StrAppend(&out, "\n", std::string(indent + 2, ' '));
-    } else if (!first) {
-      absl::StrAppend(&out, " ");
-    }
-    first = false;
-    absl::StrAppend(&out, "\"", Escape(key), "\": ",
-                    json::ToString(value, wrap, indent + 2));
-  }
-  if (wrap) {
-    absl::StrAppend(&out, "\n", std::string(indent, ' '));
-  }
-  absl::StrAppend(&out, "}");
-  return out;
-}
-
-
-std::string ToString(const Value& value, bool wrap, int indent) {
+void AppendToString(const Value& value, std::string* out, bool wrap,
+                    int indent) {
   if (value.IsNull()) {
-    return "null";
+    out->append("null");
   } else if (value.IsBool()) {
-    return (value.GetBool() ? "true" : "false");
+    out->append(value.GetBool() ? "true" : "false");
   } else if (value.IsInt()) {
-    return std::to_string(value.GetInt());
+    absl::StrAppend(out, value.GetInt());
   } else if (value.IsDouble()) {
-    double v = value.GetDouble();
-    if (std::isfinite(v)) {
-      return std::to_string(v);
-    } else {
-      // It'd be nice to show an error with a path, but at least this is
-      // debuggable by looking at the json. Crashing doesn't tell you where
-      // the problem is.
-      return absl::StrCat("\"", std::to_string(v), "\"");
-    }
+    AppendDouble(value.GetDouble(), out);
   } else if (value.IsString()) {
-    return absl::StrCat("\"", Escape(value.GetString()), "\"");
+    AppendQuoted(value.GetString(), out);
   } else if (value.IsArray()) {
-    return ToString(value.GetArray(), wrap, indent);
+    AppendArray(value.GetArray(), out, wrap, indent);
   } else if (value.IsObject()) {
-    return ToString(value.GetObject(), wrap, indent);
+    AppendObject(value.GetObject(), out, wrap, indent);
   } else {
     SpielFatalError("json::ToString is missing a type.");
   }
 }
 
+std::string ToString(const Array& array, bool wrap, int indent) {
+  std::string out;
+  AppendArray(array, &out, wrap, indent);
+  return out;
+}
+
+std::string ToString(const Object& obj, bool wrap, int indent) {
+  std::string out;
+  AppendObject(obj, &out, wrap, indent);
+  return out;
+}
+
+std::string ToString(const Value& value, bool wrap, int indent) {
+  std::string out;
+  AppendToString(value, &out, wrap, indent);
+  return out;
+}
+
+Writer& Writer::BeginObject() {
+  Separate();
+  out_->push_back('{');
+  scopes_.push_back('{');
+  first_ = true;
+  return *this;
+}
+
+Writer& Writer::EndObject() {
+  SPIEL_CHECK_FALSE(after_key_);
+  SPIEL_CHECK_TRUE(!scopes_.empty() && scopes_.back() == '{');
+  scopes_.pop_back();
+  out_->push_back('}');
+  first_ = false;
+  return *this;
+}
+
+Writer& Writer::BeginArray() {
+  Separate();
+  out_->push_back('[');
+  scopes_.push_back('[');
+  first_ = true;
+  return *this;
+}
+
+Writer& Writer::EndArray() {
+  SPIEL_CHECK_TRUE(!scopes_.empty() && scopes_.back() == '[');
+  scopes_.pop_back();
+  out_->push_back(']');
+  first_ = false;
+  return *this;
+}
+
+Writer& Writer::Key(absl::string_view key) {
+  SPIEL_CHECK_FALSE(after_key_);
+  SPIEL_CHECK_TRUE(!scopes_.empty() && scopes_.back() == '{');
+  if (!first_) out_->append(", ");
+  first_ = false;
+  AppendQuoted(key, out_);
+  out_->append(": ");
+  after_key_ = true;
+  return *this;
+}
+
+Writer& Writer::WriteNull() {
+  Separate();
+  out_->append("null");
+  return *this;
+}
+
+Writer& Writer::WriteBool(bool value) {
+  Separate();
+  out_->append(value ? "true" : "false");
+  return *this;
+}
+
+Writer& Writer::WriteInt(int64_t value) {
+  Separate();
+  absl::StrAppend(out_, value);
+  return *this;
+}
+
+Writer& Writer::WriteDouble(double value) {
+  Separate();
+  AppendDouble(value, out_);
+  return *this;
+}
+
+Writer& Writer::WriteString(absl::string_view value) {
+  Separate();
+  AppendQuoted(value, out_);
+  return *this;
+}
+
+Writer& Writer::WriteValue(const Value& value) {
+  Separate();
+  AppendToString(value, out_);
+  return *this;
+}
+
+void Writer::Separate() {
+  if (after_key_) {
+    after_key_ = false;
+    return;
+  }
+  // Values in objects follow their key.
+  SPIEL_CHECK_TRUE(scopes_.empty() || scopes_.back() == '[');
+  if (!first_) out_->append(", ");
+  first_ = false;
+}
+
 std::ostream& operator<<(std::ostream& os, const Null& n) {
   return os << ToString(n);
 }
@@ -333,7 +456,11 @@ std::ostream& operator<<(std::ostream& os, const Value& v) {
 }
 
 std::optional<Value> FromString(absl::string_view str) {
-  return ParseValue(&str);
+  Value value;
+  if (!Parser(str).ParseValue(&value)) {
+    return std::nullopt;
+  }
+  return value;
 }
 
 }  // namespace open_spiel::json
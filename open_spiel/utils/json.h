@@ -18,6 +18,7 @@
 #include <cstdint>
 
 #include <map>
+#include <optional>
 #include <ostream>
 #include <string>
 #include <variant>
@@ -120,6 +121,49 @@ std::string ToString(const Array& array, bool wrap = false, int indent = 0);
 std::string ToString(const Object& obj, bool wrap = false, int indent = 0);
 std::string ToString(const Value& value, bool wrap = false, int indent = 0);
 
+// As ToString, but appends to out, so that a buffer can be reused.
+void AppendToString(const Value& value, std::string* out, bool wrap = false,
+                    int indent = 0);
+
+// Writes json straight into a string, in the format of ToString without
+// wrapping, for callers that would otherwise build a Value only to serialize
+// it. Values are written in order, preceded by their key inside objects:
+//
+//   std::string buffer;
+//   json::Writer(&buffer).BeginObject().Key("step").WriteInt(3).EndObject();
+//
+// The writer appends to the string, which is not cleared, and checks that the
+// calls nest properly.
+class Writer {
+ public:
+  explicit Writer(std::string* out) : out_(out) {}
+
+  Writer& BeginObject();
+  Writer& EndObject();
+  Writer& BeginArray();
+  Writer& EndArray();
+  Writer& Key(absl::string_view key);
+
+  Writer& WriteNull();
+  Writer& WriteBool(bool value);
+  Writer& WriteInt(int64_t value);
+  Writer& WriteDouble(double value);
+  Writer& WriteString(absl::string_view value);
+  Writer& WriteValue(const Value& value);
+
+ private:
+  // Writes the separator before a value.
+  void Separate();
+
+  std::string* out_;
+  // The open objects and arrays, innermost last, as '{' or '['.
+  std::string scopes_;
+  // Whether the innermost object or array has no elements yet.
+  bool first_ = true;
+  // Whether a key was written, which the next value belongs to.
+  bool after_key_ = false;
+};
+
 std::ostream& operator<<(std::ostream& os, const Null& n);
 std::ostream& operator<<(std::ostream& os, const Array& a);
 std::ostream& operator<<(std::ostream& os, const Object& o);
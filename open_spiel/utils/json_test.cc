@@ -52,6 +52,37 @@ void TestToString() {
 })");
 }
 
+void TestAppendToString() {
+  std::string out = "x";
+  AppendToString(Array({1, "a\"b\n"}), &out);
+  SPIEL_CHECK_EQ(out, "x[1, \"a\\\"b\\n\"]");
+  out.clear();
+  AppendToString(1e-9, &out);
+  AppendToString(-2.5, &out);
+  SPIEL_CHECK_EQ(out, "0.000000-2.500000");
+  SPIEL_CHECK_EQ(ToString(Array()), "[]");
+  SPIEL_CHECK_EQ(ToString(Object(), true), "{\n}");
+}
+
+void TestWriter() {
+  Object obj = {{"asdf", Object({{"bar", 6}, {"baz", Array()}})},
+                {"foo", Array({1, true, Null(), 2.5, "s"})},
+                {"nested", Array({Array({1}), Object({{"a", "b"}})})}};
+  std::string out = "reused";
+  out.clear();
+  Writer writer(&out);
+  writer.BeginObject();
+  writer.Key("asdf").BeginObject().Key("bar").WriteInt(6);
+  writer.Key("baz").BeginArray().EndArray().EndObject();
+  writer.Key("foo").BeginArray().WriteInt(1).WriteBool(true).WriteNull();
+  writer.WriteDouble(2.5).WriteString("s").EndArray();
+  writer.Key("nested").BeginArray().BeginArray().WriteInt(1).EndArray();
+  writer.WriteValue(Object({{"a", "b"}})).EndArray();
+  writer.EndObject();
+  SPIEL_CHECK_EQ(out, ToString(obj));
+  SPIEL_CHECK_EQ(FromString(out)->GetObject(), obj);
+}
+
 void TestFromString() {
   std::optional<Value> v;
 
@@ -125,6 +156,19 @@ void TestFromString() {
   SPIEL_CHECK_TRUE(v->IsObject());
   SPIEL_CHECK_EQ(v->GetObject(), Object({{"asdf", Object({{"bar", 6}})},
                                          {"foo", Array({1, true, false})}}));
+
+  v = FromString(R"("\tab\ncd\/" )");
+  SPIEL_CHECK_TRUE(v);
+  SPIEL_CHECK_EQ(v->GetString(), "\tab\ncd/");
+
+  v = FromString("[-1.5e3, 12, []]");
+  SPIEL_CHECK_TRUE(v);
+  SPIEL_CHECK_EQ(v->GetArray(), Array({-1500.0, 12, Array()}));
+
+  // The first of repeated keys is kept.
+  v = FromString(R"({"a": 1, "a": [2]})");
+  SPIEL_CHECK_TRUE(v);
+  SPIEL_CHECK_EQ(v->GetObject(), Object({{"a", 1}}));
 }
 
 void TestValue() {
@@ -219,6 +263,8 @@ void TestValue() {
 
 int main(int argc, char** argv) {
   open_spiel::json::TestToString();
+  open_spiel::json::TestAppendToString();
+  open_spiel::json::TestWriter();
   open_spiel::json::TestFromString();
   open_spiel::json::TestValue();
 }
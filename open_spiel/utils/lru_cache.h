@@ -16,6 +16,7 @@
 #define OPEN_SPIEL_UTILS_LRU_CACHE_H_
 
 #include <list>
+#include <optional>
 
 #include "open_spiel/abseil-cpp/absl/container/flat_hash_map.h"
 #include "open_spiel/abseil-cpp/absl/synchronization/mutex.h"
@@ -79,7 +80,12 @@ class LRUCache {  // Least Recently Used Cache.
     misses_ = 0;
   }
 
-  void Set(const K& key, const V& value) {
+  void Set(const K& key, const V& value) { Insert(key, value); }
+
+  // Same as Set, but returns the cached value: `value` if the key was new, or
+  // the value already stored for it. This lets concurrent writers that raced
+  // on a miss all agree on a single value.
+  V Insert(const K& key, const V& value) {
     absl::MutexLock lock(&m_);
     auto pos = map_.find(key);
     if (pos == map_.end()) {           // Not found, add it.
@@ -89,10 +95,12 @@ class LRUCache {  // Least Recently Used Cache.
       }
       order_.push_front(key);
       map_[key] = Entry{value, order_.begin()};
+      return value;
     } else {  // Found, move it to the front.
       order_.erase(pos->second.order_iterator);
       order_.push_front(key);
       pos->second.order_iterator = order_.begin();
+      return pos->second.value;
     }
   }
 
@@ -71,6 +71,10 @@ void TestLRUCache() {
   cache.Clear();
 
   SPIEL_CHECK_FALSE(cache.Get(18));  // evicted
+
+  SPIEL_CHECK_EQ(cache.Insert(19, "19"), "19");
+  SPIEL_CHECK_EQ(cache.Insert(19, "nineteen"), "19");  // keeps the first
+  SPIEL_CHECK_EQ(*cache.Get(19), "19");
 }
 
 }  // namespace
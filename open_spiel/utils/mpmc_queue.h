@@ -0,0 +1,208 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_UTILS_MPMC_QUEUE_H_
+#define OPEN_SPIEL_UTILS_MPMC_QUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/synchronization/mutex.h"
+#include "open_spiel/abseil-cpp/absl/time/clock.h"
+#include "open_spiel/abseil-cpp/absl/time/time.h"
+
+namespace open_spiel {
+
+// A bounded threadsafe-queue for many producers and consumers, with the same
+// interface as ThreadedQueue. Pushing and popping are lock-free, using a ring
+// of slots each with a sequence number (Vyukov's bounded MPMC queue). Only
+// threads waiting on a full or empty queue, after spinning for a while, take a
+// lock, and the others only take it to notify them.
+//
+// T must be default constructible and movable.
+template <class T>
+class MPMCQueue {
+ public:
+  explicit MPMCQueue(int max_size)
+      : max_size_(max_size), slots_(new Slot[max_size]) {
+    for (int i = 0; i < max_size_; ++i) {
+      slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  // Add an element to the queue.
+  bool Push(const T& value) { return Push(value, absl::InfiniteFuture()); }
+  bool Push(const T& value, absl::Duration wait) {
+    return Push(value, absl::Now() + wait);
+  }
+  bool Push(const T& value, absl::Time deadline) {
+    if (block_new_values_) return false;
+    if (!Wait([&]() { return TryPush(value); }, deadline)) return false;
+    NotifyWaiters();
+    return true;
+  }
+
+  std::optional<T> Pop() { return Pop(absl::InfiniteFuture()); }
+  std::optional<T> Pop(absl::Duration wait) { return Pop(absl::Now() + wait); }
+  std::optional<T> Pop(absl::Time deadline) {
+    std::optional<T> value;
+    if (!Wait([&]() { return TryPop(&value); }, deadline)) return std::nullopt;
+    NotifyWaiters();
+    return value;
+  }
+
+  // Pops up to max_items elements into `items`, waiting for them until the
+  // deadline at most. Returns the number of elements popped.
+  int PopBatch(int max_items, absl::Time deadline, std::vector<T>* items) {
+    int num_popped = 0;
+    while (num_popped < max_items) {
+      std::optional<T> value = Pop(deadline);
+      if (!value) break;
+      items->push_back(std::move(*value));
+      ++num_popped;
+    }
+    return num_popped;
+  }
+
+  bool Empty() const { return Size() == 0; }
+
+  void Clear() {
+    std::optional<T> value;
+    while (TryPop(&value)) {}
+    NotifyWaiters();
+  }
+
+  // The number of elements, which may be out of date by the time it returns.
+  int Size() const {
+    const int64_t size = static_cast<int64_t>(
+        push_pos_.load(std::memory_order_relaxed) -
+        pop_pos_.load(std::memory_order_relaxed));
+    return size < 0 ? 0 : (size > max_size_ ? max_size_ : size);
+  }
+
+  // Causes pushing new values to fail. Useful for shutting down the queue.
+  void BlockNewValues() {
+    absl::MutexLock lock(&m_);
+    block_new_values_ = true;
+    cv_.SignalAll();
+  }
+
+ private:
+  // Tries this many times before waiting on the condition variable.
+  static constexpr int kSpinTries = 64;
+
+  // A slot is ready for the push of position `pos` when its sequence is `pos`,
+  // and for the pop of that position when it is `pos + 1`.
+  struct Slot {
+    std::atomic<uint64_t> sequence;
+    T value;
+  };
+
+  bool TryPush(const T& value) {
+    uint64_t pos = push_pos_.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+      slot = &slots_[pos % max_size_];
+      const uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+      const int64_t diff =
+          static_cast<int64_t>(sequence) - static_cast<int64_t>(pos);
+      if (diff == 0) {
+        if (push_pos_.compare_exchange_weak(pos, pos + 1,
+                                            std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;  // Full.
+      } else {
+        pos = push_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    slot->value = value;
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool TryPop(std::optional<T>* value) {
+    uint64_t pos = pop_pos_.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+      slot = &slots_[pos % max_size_];
+      const uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+      const int64_t diff =
+          static_cast<int64_t>(sequence) - static_cast<int64_t>(pos + 1);
+      if (diff == 0) {
+        if (pop_pos_.compare_exchange_weak(pos, pos + 1,
+                                           std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;  // Empty.
+      } else {
+        pos = pop_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    *value = std::move(slot->value);
+    slot->value = T();  // Release what the value holds.
+    slot->sequence.store(pos + max_size_, std::memory_order_release);
+    return true;
+  }
+
+  // Calls try_fn until it succeeds, the deadline passes, or the queue is
+  // blocked. Waiters are counted before trying a last time under the lock, so
+  // that the threads making progress possible see them and notify them.
+  template <typename TryFn>
+  bool Wait(TryFn try_fn, absl::Time deadline) {
+    for (int i = 0; i < kSpinTries; ++i) {
+      if (try_fn()) return true;
+      if (block_new_values_) return false;
+    }
+    absl::MutexLock lock(&m_);
+    num_waiters_.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    bool done;
+    while (!(done = try_fn()) && !block_new_values_ &&
+           absl::Now() <= deadline) {
+      cv_.WaitWithDeadline(&m_, deadline);
+    }
+    num_waiters_.fetch_sub(1);
+    return done;
+  }
+
+  void NotifyWaiters() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (num_waiters_.load(std::memory_order_relaxed) > 0) {
+      absl::MutexLock lock(&m_);
+      cv_.SignalAll();
+    }
+  }
+
+  const int max_size_;
+  std::unique_ptr<Slot[]> slots_;
+  // Kept on separate cache lines, as producers and consumers update them.
+  alignas(64) std::atomic<uint64_t> push_pos_{0};
+  alignas(64) std::atomic<uint64_t> pop_pos_{0};
+  alignas(64) std::atomic<int> num_waiters_{0};
+  std::atomic<bool> block_new_values_{false};
+  absl::Mutex m_;
+  absl::CondVar cv_;
+};
+
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_UTILS_MPMC_QUEUE_H_
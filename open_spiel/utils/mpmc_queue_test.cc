@@ -0,0 +1,152 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/utils/mpmc_queue.h"
+
+#include <optional>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/time/clock.h"
+#include "open_spiel/abseil-cpp/absl/time/time.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/thread.h"
+
+namespace open_spiel {
+namespace {
+
+void TestMPMCQueue() {
+  MPMCQueue<int> q(4);
+
+  auto CheckPopEq = [&q](int expected) {
+    std::optional<int> v = q.Pop();
+    SPIEL_CHECK_TRUE(v);
+    SPIEL_CHECK_EQ(*v, expected);
+  };
+
+  SPIEL_CHECK_TRUE(q.Empty());
+  SPIEL_CHECK_EQ(q.Size(), 0);
+
+  SPIEL_CHECK_FALSE(q.Pop(absl::Milliseconds(1)));
+  SPIEL_CHECK_FALSE(q.Pop(absl::Now() + absl::Milliseconds(1)));
+
+  SPIEL_CHECK_TRUE(q.Push(10, absl::Now() + absl::Milliseconds(1)));
+  SPIEL_CHECK_FALSE(q.Empty());
+  SPIEL_CHECK_EQ(q.Size(), 1);
+
+  CheckPopEq(10);
+
+  SPIEL_CHECK_TRUE(q.Push(11));
+  SPIEL_CHECK_TRUE(q.Push(12));
+  SPIEL_CHECK_EQ(q.Size(), 2);
+  SPIEL_CHECK_TRUE(q.Push(13));
+  SPIEL_CHECK_TRUE(q.Push(14));
+  SPIEL_CHECK_EQ(q.Size(), 4);
+  SPIEL_CHECK_FALSE(q.Push(15, absl::Milliseconds(1)));
+
+  CheckPopEq(11);
+
+  SPIEL_CHECK_TRUE(q.Push(16, absl::Milliseconds(1)));
+
+  CheckPopEq(12);
+  CheckPopEq(13);
+  CheckPopEq(14);
+  CheckPopEq(16);
+  SPIEL_CHECK_EQ(q.Size(), 0);
+
+  SPIEL_CHECK_TRUE(q.Push(17));
+  SPIEL_CHECK_TRUE(q.Push(18));
+  SPIEL_CHECK_EQ(q.Size(), 2);
+
+  q.Clear();
+
+  SPIEL_CHECK_TRUE(q.Empty());
+  SPIEL_CHECK_EQ(q.Size(), 0);
+
+  SPIEL_CHECK_TRUE(q.Push(19));
+  SPIEL_CHECK_TRUE(q.Push(20));
+
+  q.BlockNewValues();
+
+  SPIEL_CHECK_EQ(q.Size(), 2);
+  SPIEL_CHECK_FALSE(q.Push(21));
+  SPIEL_CHECK_EQ(q.Size(), 2);
+  CheckPopEq(19);
+  CheckPopEq(20);
+  SPIEL_CHECK_FALSE(q.Pop());
+}
+
+void TestMPMCQueuePopBatch() {
+  MPMCQueue<int> q(3);
+  std::vector<int> items;
+  SPIEL_CHECK_EQ(q.PopBatch(2, absl::Now() + absl::Milliseconds(1), &items),
+                 0);
+  SPIEL_CHECK_TRUE(items.empty());
+
+  for (int i = 0; i < 3; ++i) SPIEL_CHECK_TRUE(q.Push(i));
+  SPIEL_CHECK_EQ(q.PopBatch(2, absl::Now() + absl::Milliseconds(1), &items),
+                 2);
+  SPIEL_CHECK_EQ(q.PopBatch(2, absl::Now() + absl::Milliseconds(1), &items),
+                 1);
+  SPIEL_CHECK_EQ(items, std::vector<int>({0, 1, 2}));
+  SPIEL_CHECK_TRUE(q.Empty());
+}
+
+void TestMPMCQueueThreads() {
+  constexpr int kNumThreads = 4;
+  constexpr int kItemsPerThread = 10000;
+  MPMCQueue<int> q(16);
+  std::vector<Thread> producers;
+  for (int t = 0; t < kNumThreads; ++t) {
+    producers.emplace_back([&q, t]() {
+      for (int i = 0; i < kItemsPerThread; ++i) {
+        SPIEL_CHECK_TRUE(q.Push(t * kItemsPerThread + i));
+      }
+    });
+  }
+  std::vector<std::vector<int>> popped(kNumThreads);
+  std::vector<Thread> consumers;
+  for (int t = 0; t < kNumThreads; ++t) {
+    consumers.emplace_back([&q, &popped, t]() {
+      while (std::optional<int> v = q.Pop()) {
+        popped[t].push_back(*v);
+        q.PopBatch(7, absl::Now() + absl::Milliseconds(1), &popped[t]);
+      }
+    });
+  }
+  for (Thread& thread : producers) thread.join();
+  q.BlockNewValues();
+  for (Thread& thread : consumers) thread.join();
+
+  // Every item is popped exactly once, in order for each producer.
+  std::vector<int> counts(kNumThreads * kItemsPerThread, 0);
+  for (const std::vector<int>& items : popped) {
+    std::vector<int> last(kNumThreads, -1);
+    for (int v : items) {
+      counts[v] += 1;
+      SPIEL_CHECK_GT(v, last[v / kItemsPerThread]);
+      last[v / kItemsPerThread] = v;
+    }
+  }
+  for (int count : counts) SPIEL_CHECK_EQ(count, 1);
+  SPIEL_CHECK_TRUE(q.Empty());
+}
+
+}  // namespace
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  open_spiel::TestMPMCQueue();
+  open_spiel::TestMPMCQueuePopBatch();
+  open_spiel::TestMPMCQueueThreads();
+}
@@ -0,0 +1,89 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_UTILS_PLANE_ENCODING_H_
+#define OPEN_SPIEL_UTILS_PLANE_ENCODING_H_
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+#include "open_spiel/abseil-cpp/absl/types/span.h"
+#include "open_spiel/spiel_utils.h"
+
+// Helpers writing the planes of board games' observation tensors, i.e. one
+// value per cell of the board, in the row-major order of the cells.
+//
+// Rather than clearing the tensor and then setting the value of each cell in
+// turn, they write every value of each plane in one pass over contiguous
+// memory, with no branches, which compilers turn into vector compares and
+// stores. So the tensors need not be cleared first.
+namespace open_spiel {
+
+// Sets the plane to 1 at the cells whose bit is set, cell i being bit i, and
+// to 0 elsewhere. The plane has at most 64 cells.
+template <typename T>
+void BitboardPlane(uint64_t bits, absl::Span<T> plane) {
+  SPIEL_CHECK_LE(plane.size(), 64);
+  for (int i = 0; i < plane.size(); ++i) {
+    plane[i] = static_cast<T>((bits >> i) & 1);
+  }
+}
+
+// Writes num_planes one-hot planes of num_cells cells each, one after the
+// other: plane p has 1 at the cells c for which plane_of(c) == p, and 0
+// elsewhere. plane_of(c) must be in [0, num_planes), and there are at most 255
+// planes.
+template <typename T, typename PlaneOf>
+void OneHotPlanes(int num_cells, int num_planes, const PlaneOf& plane_of,
+                  absl::Span<T> values) {
+  SPIEL_CHECK_EQ(values.size(), num_cells * num_planes);
+  SPIEL_CHECK_LE(num_planes, 255);
+  // The planes of the cells are computed a chunk at a time, and compared to
+  // each plane in turn.
+  constexpr int kChunk = 256;
+  std::array<uint8_t, kChunk> planes;
+  for (int begin = 0; begin < num_cells; begin += kChunk) {
+    const int size = std::min(kChunk, num_cells - begin);
+    uint8_t max_plane = 0;
+    for (int i = 0; i < size; ++i) {
+      planes[i] = plane_of(begin + i);
+      max_plane = std::max(max_plane, planes[i]);
+    }
+    SPIEL_CHECK_LT(max_plane, num_planes);
+    for (int p = 0; p < num_planes; ++p) {
+      T* plane = values.data() + p * num_cells + begin;
+      for (int i = 0; i < size; ++i) {
+        plane[i] = static_cast<T>(planes[i] == p);
+      }
+    }
+  }
+}
+
+// The one-hot planes of a board whose cells hold enums or integers: plane p
+// has 1 at the cells whose value is first_value + p.
+template <typename T, typename Cell>
+void OneHotPlanes(absl::Span<const Cell> cells, int num_planes,
+                  absl::Span<T> values, int first_value = 0) {
+  OneHotPlanes(
+      cells.size(), num_planes,
+      [cells, first_value](int c) {
+        return static_cast<int>(cells[c]) - first_value;
+      },
+      values);
+}
+
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_UTILS_PLANE_ENCODING_H_
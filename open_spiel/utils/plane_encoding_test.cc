@@ -0,0 +1,84 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/utils/plane_encoding.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/types/span.h"
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace {
+
+void TestBitboardPlane() {
+  // Stale values are overwritten.
+  std::vector<float> plane(10, 7);
+  BitboardPlane(0b1000000101, absl::MakeSpan(plane));
+  SPIEL_CHECK_EQ(plane, (std::vector<float>{1, 0, 1, 0, 0, 0, 0, 0, 0, 1}));
+
+  // Bits past the plane are ignored.
+  std::vector<double> full(64);
+  BitboardPlane(~uint64_t{0}, absl::MakeSpan(full).subspan(0, 3));
+  SPIEL_CHECK_EQ(full[2], 1);
+  SPIEL_CHECK_EQ(full[3], 0);
+  BitboardPlane(uint64_t{1} << 63, absl::MakeSpan(full));
+  SPIEL_CHECK_EQ(full[63], 1);
+  SPIEL_CHECK_EQ(full[0], 0);
+}
+
+void TestOneHotPlanes() {
+  enum class Cell { kEmpty, kNought, kCross };
+  const std::array<Cell, 4> cells = {Cell::kCross, Cell::kEmpty,
+                                     Cell::kNought, Cell::kCross};
+  std::vector<double> values(12, -1);
+  OneHotPlanes(absl::MakeConstSpan(cells), 3, absl::MakeSpan(values));
+  SPIEL_CHECK_EQ(values, (std::vector<double>{0, 1, 0, 0,    // Empty.
+                                              0, 0, 1, 0,    // Nought.
+                                              1, 0, 0, 1}));  // Cross.
+
+  // Values starting at first_value.
+  const std::array<int, 3> offset = {-1, 1, 0};
+  std::vector<float> offset_values(9);
+  OneHotPlanes(absl::MakeConstSpan(offset), 3, absl::MakeSpan(offset_values),
+               -1);
+  SPIEL_CHECK_EQ(offset_values,
+                 (std::vector<float>{1, 0, 0, 0, 0, 1, 0, 1, 0}));
+}
+
+void TestOneHotPlanesOverChunks() {
+  // More cells than fit a chunk, and a plane missing from the cells.
+  const int num_cells = 1000;
+  const int num_planes = 4;
+  std::vector<double> values(num_cells * num_planes, -1);
+  OneHotPlanes(
+      num_cells, num_planes, [](int cell) { return cell % 3; },
+      absl::MakeSpan(values));
+  for (int p = 0; p < num_planes; ++p) {
+    for (int cell = 0; cell < num_cells; ++cell) {
+      SPIEL_CHECK_EQ(values[p * num_cells + cell], cell % 3 == p ? 1 : 0);
+    }
+  }
+}
+
+}  // namespace
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  open_spiel::TestBitboardPlane();
+  open_spiel::TestOneHotPlanes();
+  open_spiel::TestOneHotPlanesOverChunks();
+}
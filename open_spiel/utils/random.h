@@ -0,0 +1,145 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_UTILS_RANDOM_H_
+#define OPEN_SPIEL_UTILS_RANDOM_H_
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+namespace open_spiel {
+
+// A counter-based random number generator, Philox4x32-10, from "Parallel
+// Random Numbers: As Easy as 1, 2, 3" by Salmon et al. The n-th output of a
+// stream is a function of its seed, its stream number and n only: a block
+// cipher applied to the counter. So a generator is a few words, is free to
+// construct and copy, unlike the 2.5KB std::mt19937, and splits into
+// independent streams, e.g. one per thread or task, whose outputs don't
+// depend on what was drawn before, which keeps parallel runs reproducible.
+//
+// It's a UniformRandomBitGenerator, so works with the std and absl
+// distributions and absl::BitGenRef, as a drop-in for std::mt19937.
+class Philox {
+ public:
+  using result_type = uint64_t;
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  explicit Philox(uint64_t seed = 0, uint64_t stream = 0) {
+    this->seed(seed, stream);
+  }
+
+  void seed(uint64_t seed, uint64_t stream = 0) {
+    seed_ = seed;
+    stream_ = stream;
+    block_ = 0;
+    next_ = kOutputsPerBlock;
+  }
+
+  result_type operator()() {
+    if (next_ == kOutputsPerBlock) {
+      outputs_ = Block(seed_, stream_, block_++);
+      next_ = 0;
+    }
+    return outputs_[next_++];
+  }
+
+  // Skips n outputs, in constant time.
+  void discard(uint64_t n) {
+    const uint64_t buffered = kOutputsPerBlock - next_;
+    if (n <= buffered) {
+      next_ += n;
+      return;
+    }
+    n -= buffered;
+    block_ += n / kOutputsPerBlock;
+    next_ = kOutputsPerBlock;
+    if (n % kOutputsPerBlock != 0) {
+      (*this)();
+      next_ = n % kOutputsPerBlock;
+    }
+  }
+
+  // A generator of the i-th substream of this one, e.g. for the i-th thread
+  // or task. It doesn't depend on how much this one has drawn, and is
+  // independent of it and of the other substreams, including theirs.
+  Philox Split(uint64_t i) const {
+    return Philox(seed_, Mix(stream_ ^ Mix(i + 1)));
+  }
+
+  uint64_t Seed() const { return seed_; }
+  uint64_t Stream() const { return stream_; }
+
+  bool operator==(const Philox& other) const {
+    return seed_ == other.seed_ && stream_ == other.stream_ &&
+           block_ == other.block_ && next_ == other.next_;
+  }
+  bool operator!=(const Philox& other) const { return !(*this == other); }
+
+  // The cipher: the 128 bit counter encrypted with the 64 bit key, as four
+  // 32 bit words, least significant first.
+  static std::array<uint32_t, 4> Encrypt(std::array<uint32_t, 4> counter,
+                                         std::array<uint32_t, 2> key) {
+    for (int round = 0; round < 10; ++round) {
+      if (round > 0) {
+        key[0] += 0x9E3779B9;
+        key[1] += 0xBB67AE85;
+      }
+      const uint64_t product0 = uint64_t{0xD2511F53} * counter[0];
+      const uint64_t product1 = uint64_t{0xCD9E8D57} * counter[2];
+      counter = {static_cast<uint32_t>(product1 >> 32) ^ counter[1] ^ key[0],
+                 static_cast<uint32_t>(product1),
+                 static_cast<uint32_t>(product0 >> 32) ^ counter[3] ^ key[1],
+                 static_cast<uint32_t>(product0)};
+    }
+    return counter;
+  }
+
+ private:
+  static constexpr int kOutputsPerBlock = 2;
+
+  // The SplitMix64 finalizer, to spread the stream numbers of substreams.
+  static uint64_t Mix(uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+  }
+
+  // The block of outputs at this position: the counter holds the block
+  // number and the stream, and the key is the seed.
+  static std::array<uint64_t, kOutputsPerBlock> Block(uint64_t seed,
+                                                      uint64_t stream,
+                                                      uint64_t block) {
+    const std::array<uint32_t, 4> words = Encrypt(
+        {static_cast<uint32_t>(block), static_cast<uint32_t>(block >> 32),
+         static_cast<uint32_t>(stream), static_cast<uint32_t>(stream >> 32)},
+        {static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)});
+    return {words[0] | uint64_t{words[1]} << 32,
+            words[2] | uint64_t{words[3]} << 32};
+  }
+
+  uint64_t seed_;
+  uint64_t stream_;
+  uint64_t block_;  // The next block to encrypt.
+  std::array<uint64_t, kOutputsPerBlock> outputs_;
+  int next_;  // The next of outputs_ to return.
+};
+
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_UTILS_RANDOM_H_
@@ -0,0 +1,104 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/utils/random.h"
+
+#include <array>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/random/bit_gen_ref.h"
+#include "open_spiel/abseil-cpp/absl/random/distributions.h"
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace {
+
+// The known answers of the reference implementation, Random123.
+void PhiloxKnownAnswerTest() {
+  SPIEL_CHECK_TRUE(
+      Philox::Encrypt({0, 0, 0, 0}, {0, 0}) ==
+      (std::array<uint32_t, 4>{0x6627e8d5, 0xe169c58d, 0xbc57ac4c,
+                               0x9b00dbd8}));
+  SPIEL_CHECK_TRUE(
+      Philox::Encrypt({0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff},
+                      {0xffffffff, 0xffffffff}) ==
+      (std::array<uint32_t, 4>{0x408f276d, 0x41c83b0e, 0xa20bc7c6,
+                               0x6d5451fd}));
+  SPIEL_CHECK_TRUE(
+      Philox::Encrypt({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344},
+                      {0xa4093822, 0x299f31d0}) ==
+      (std::array<uint32_t, 4>{0xd16cfe09, 0x94fdcceb, 0x5001e420,
+                               0x24126ea1}));
+}
+
+void PhiloxStreamsTest() {
+  Philox rng(42);
+  std::vector<uint64_t> outputs;
+  for (int i = 0; i < 10; ++i) outputs.push_back(rng());
+
+  // Seeding starts over, and skipping ahead lands on the same outputs.
+  rng.seed(42);
+  for (uint64_t output : outputs) SPIEL_CHECK_EQ(rng(), output);
+  for (int skip = 0; skip < 5; ++skip) {
+    for (int start = 0; start < 3; ++start) {
+      Philox skipped(42);
+      for (int i = 0; i < start; ++i) skipped();
+      skipped.discard(skip);
+      SPIEL_CHECK_EQ(skipped(), outputs[start + skip]);
+    }
+  }
+
+  // Different seeds and streams differ, and substreams don't depend on how
+  // much the parent has drawn.
+  SPIEL_CHECK_NE(Philox(43)(), outputs[0]);
+  SPIEL_CHECK_NE(Philox(42, 1)(), outputs[0]);
+  Philox parent(42);
+  Philox child = parent.Split(3);
+  parent();
+  SPIEL_CHECK_TRUE(parent.Split(3) == child);
+  SPIEL_CHECK_EQ(parent.Split(3)(), child());
+  std::set<uint64_t> streams = {parent.Stream()};
+  for (int i = 0; i < 100; ++i) {
+    streams.insert(parent.Split(i).Stream());
+    streams.insert(parent.Split(i).Split(i).Stream());
+  }
+  SPIEL_CHECK_EQ(streams.size(), 201);
+}
+
+void PhiloxDistributionTest() {
+  Philox rng(7);
+  std::vector<int> counts(10, 0);
+  const int num_samples = 100000;
+  absl::BitGenRef ref(rng);
+  for (int i = 0; i < num_samples; ++i) {
+    ++counts[std::uniform_int_distribution<int>(0, 4)(rng)];
+    ++counts[5 + absl::Uniform(ref, 0, 5)];
+  }
+  for (int count : counts) {
+    SPIEL_CHECK_FLOAT_NEAR(static_cast<double>(count) / num_samples, 0.2,
+                           0.01);
+  }
+}
+
+}  // namespace
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  open_spiel::PhiloxKnownAnswerTest();
+  open_spiel::PhiloxStreamsTest();
+  open_spiel::PhiloxDistributionTest();
+}
@@ -0,0 +1,277 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/utils/replay_buffer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/abseil-cpp/absl/strings/string_view.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/circular_buffer.h"
+#include "open_spiel/utils/file.h"
+
+namespace open_spiel {
+
+namespace {
+
+constexpr char kSnapshotMagic[8] = {'O', 'S', 'R', 'E', 'P', 'L', 'A', 'Y'};
+constexpr uint32_t kSnapshotVersion = 1;
+
+template <typename T>
+void WriteRows(file::File* file, const std::vector<T>& column, int64_t size) {
+  SPIEL_CHECK_TRUE(file->Write(absl::string_view(
+      reinterpret_cast<const char*>(column.data()), size * sizeof(T))));
+}
+
+}  // namespace
+
+// Followed by the columns of the saved rows, in the order of the buffer's
+// slots: the observations, the policies, the values, the priorities if
+// prioritized, and the legal masks.
+struct ReplayBuffer::SnapshotHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t prioritized;
+  int64_t max_size;
+  int64_t observation_size;
+  int64_t num_actions;
+  int64_t size;
+  int64_t next;
+  int64_t total_added;
+  double max_priority;
+};
+
+ReplayBuffer::ReplayBuffer(int max_size, int observation_size,
+                           int num_actions, double priority_exponent)
+    : max_size_(max_size),
+      observation_size_(observation_size),
+      num_actions_(num_actions),
+      priority_exponent_(priority_exponent),
+      observations_(static_cast<int64_t>(max_size) * observation_size),
+      policies_(static_cast<int64_t>(max_size) * num_actions),
+      legal_masks_(static_cast<int64_t>(max_size) * num_actions),
+      values_(max_size) {
+  SPIEL_CHECK_GT(max_size, 0);
+  SPIEL_CHECK_GE(priority_exponent, 0);
+  if (Prioritized()) {
+    priorities_.resize(max_size, 0);
+    num_leaves_ = 1;
+    while (num_leaves_ < max_size) num_leaves_ *= 2;
+    sum_tree_.resize(2 * num_leaves_, 0);
+  }
+}
+
+int ReplayBuffer::Add(absl::Span<const double> observation,
+                      absl::Span<const int64_t> legal_actions,
+                      absl::Span<const std::pair<int64_t, double>> policy,
+                      double value) {
+  return Add(observation, legal_actions, policy, value, max_priority_);
+}
+
+int ReplayBuffer::Add(absl::Span<const double> observation,
+                      absl::Span<const int64_t> legal_actions,
+                      absl::Span<const std::pair<int64_t, double>> policy,
+                      double value, double priority) {
+  SPIEL_CHECK_EQ(observation.size(), observation_size_);
+  const int index = next_;
+  const int64_t obs_offset = static_cast<int64_t>(index) * observation_size_;
+  std::copy(observation.begin(), observation.end(),
+            observations_.begin() + obs_offset);
+
+  const int64_t action_offset = static_cast<int64_t>(index) * num_actions_;
+  float* policy_row = &policies_[action_offset];
+  uint8_t* mask_row = &legal_masks_[action_offset];
+  std::fill(policy_row, policy_row + num_actions_, 0);
+  std::fill(mask_row, mask_row + num_actions_, 0);
+  for (int64_t action : legal_actions) {
+    SPIEL_CHECK_GE(action, 0);
+    SPIEL_CHECK_LT(action, num_actions_);
+    mask_row[action] = 1;
+  }
+  for (const auto& [action, prob] : policy) {
+    SPIEL_CHECK_GE(action, 0);
+    SPIEL_CHECK_LT(action, num_actions_);
+    policy_row[action] = prob;
+  }
+  values_[index] = value;
+
+  size_ = std::min(size_ + 1, max_size_);
+  next_ = (next_ + 1) % max_size_;
+  total_added_ += 1;
+  if (Prioritized()) SetPriority(index, priority);
+  return index;
+}
+
+void ReplayBuffer::SetPriority(int index, double priority) {
+  SPIEL_CHECK_GE(index, 0);
+  SPIEL_CHECK_LT(index, size_);
+  SPIEL_CHECK_GT(priority, 0);
+  if (!Prioritized()) return;
+  priorities_[index] = priority;
+  max_priority_ = std::max(max_priority_, priority);
+  SetWeight(index, std::pow(priority, priority_exponent_));
+}
+
+double ReplayBuffer::Priority(int index) const {
+  return Prioritized() ? priorities_[index] : 1;
+}
+
+void ReplayBuffer::SetWeight(int index, double weight) {
+  int node = num_leaves_ + index;
+  sum_tree_[node] = weight;
+  for (node /= 2; node >= 1; node /= 2) {
+    sum_tree_[node] = sum_tree_[2 * node] + sum_tree_[2 * node + 1];
+  }
+}
+
+void ReplayBuffer::Save(const std::string& filename) const {
+  SnapshotHeader header;
+  std::memcpy(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic));
+  header.version = kSnapshotVersion;
+  header.prioritized = Prioritized();
+  header.max_size = max_size_;
+  header.observation_size = observation_size_;
+  header.num_actions = num_actions_;
+  header.size = size_;
+  header.next = next_;
+  header.total_added = total_added_;
+  header.max_priority = max_priority_;
+
+  // Written next to it then renamed, so a crash never leaves half a file.
+  const std::string tmp = absl::StrCat(filename, ".tmp");
+  {
+    file::File file(tmp, "wb");
+    SPIEL_CHECK_TRUE(file.Write(absl::string_view(
+        reinterpret_cast<const char*>(&header), sizeof(header))));
+    WriteRows(&file, observations_,
+              static_cast<int64_t>(size_) * observation_size_);
+    WriteRows(&file, policies_, static_cast<int64_t>(size_) * num_actions_);
+    WriteRows(&file, values_, size_);
+    if (Prioritized()) WriteRows(&file, priorities_, size_);
+    WriteRows(&file, legal_masks_, static_cast<int64_t>(size_) * num_actions_);
+  }
+  SPIEL_CHECK_TRUE(file::Rename(tmp, filename));
+}
+
+void ReplayBuffer::Load(const std::string& filename) {
+  const file::MMapFile file(
+      filename, {file::MMapFile::Access::kSequential, /*populate=*/true});
+  SnapshotHeader header;
+  if (file.size() < static_cast<int64_t>(sizeof(header))) {
+    SpielFatalError(absl::StrCat(filename, " is not a replay buffer"));
+  }
+  std::memcpy(&header, file.data(), sizeof(header));
+  if (std::memcmp(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0) {
+    SpielFatalError(absl::StrCat(filename, " is not a replay buffer"));
+  }
+  if (header.version != kSnapshotVersion) {
+    SpielFatalError(absl::StrCat("Unsupported version ", header.version,
+                                 " of the replay buffer ", filename));
+  }
+  if (header.observation_size != observation_size_ ||
+      header.num_actions != num_actions_) {
+    SpielFatalError(absl::StrCat(
+        "The replay buffer ", filename, " has observations of size ",
+        header.observation_size, " and ", header.num_actions,
+        " actions, instead of ", observation_size_, " and ", num_actions_));
+  }
+  const int64_t size = header.size;
+  const int64_t expected_size =
+      sizeof(header) +
+      size * (sizeof(float) * (observation_size_ + num_actions_ + 1) +
+              (header.prioritized ? sizeof(double) : 0) + num_actions_);
+  if (size < 0 || size > header.max_size || header.next < 0 ||
+      header.next >= header.max_size || file.size() != expected_size) {
+    SpielFatalError(absl::StrCat("The replay buffer ", filename,
+                                 " is truncated or corrupt"));
+  }
+  const char* observations = file.data() + sizeof(header);
+  const char* policies =
+      observations + size * observation_size_ * sizeof(float);
+  const char* values = policies + size * num_actions_ * sizeof(float);
+  const char* priorities = values + size * sizeof(float);
+  const char* legal_masks =
+      priorities + (header.prioritized ? size * sizeof(double) : 0);
+
+  // The saved positions kept are copied from the oldest to the newest, into
+  // the first slots.
+  const int num_kept = std::min<int64_t>(size, max_size_);
+  size_ = 0;
+  next_ = 0;
+  total_added_ = header.total_added;
+  if (Prioritized()) {
+    std::fill(sum_tree_.begin(), sum_tree_.end(), 0);
+    max_priority_ = std::max(max_priority_, header.max_priority);
+  }
+  // The oldest position is in the next slot once the buffer is full.
+  const int64_t oldest = size < header.max_size ? 0 : header.next;
+  for (int to = 0; to < num_kept; ++to) {
+    const int64_t from = (oldest + size - num_kept + to) % size;
+    std::memcpy(&observations_[static_cast<int64_t>(to) * observation_size_],
+                observations + from * observation_size_ * sizeof(float),
+                observation_size_ * sizeof(float));
+    std::memcpy(&policies_[static_cast<int64_t>(to) * num_actions_],
+                policies + from * num_actions_ * sizeof(float),
+                num_actions_ * sizeof(float));
+    std::memcpy(&values_[to], values + from * sizeof(float), sizeof(float));
+    std::memcpy(&legal_masks_[static_cast<int64_t>(to) * num_actions_],
+                legal_masks + from * num_actions_, num_actions_);
+    size_ += 1;
+    if (Prioritized()) {
+      double priority = max_priority_;
+      if (header.prioritized) {
+        std::memcpy(&priority, priorities + from * sizeof(double),
+                    sizeof(double));
+      }
+      SetPriority(to, priority);
+    }
+  }
+  next_ = num_kept % max_size_;
+}
+
+std::vector<int> ReplayBuffer::Sample(std::mt19937* rng, int num) const {
+  std::vector<int> indices;
+  if (size_ == 0) return indices;
+  if (Prioritized()) {
+    indices.reserve(num);
+    std::uniform_real_distribution<double> dist(0, sum_tree_[1]);
+    for (int i = 0; i < num; ++i) {
+      // Walk down from the root to the leaf covering the drawn weight.
+      double target = dist(*rng);
+      int node = 1;
+      while (node < num_leaves_) {
+        if (target < sum_tree_[2 * node] || sum_tree_[2 * node + 1] == 0) {
+          node = 2 * node;
+        } else {
+          target -= sum_tree_[2 * node];
+          node = 2 * node + 1;
+        }
+      }
+      indices.push_back(std::min(node - num_leaves_, size_ - 1));
+    }
+    return indices;
+  }
+
+  return internal::SampleIndices(rng, size_, num);
+}
+
+}  // namespace open_spiel
@@ -0,0 +1,132 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_UTILS_REPLAY_BUFFER_H_
+#define OPEN_SPIEL_UTILS_REPLAY_BUFFER_H_
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/types/span.h"
+
+namespace open_spiel {
+
+// A circular buffer of training positions for AlphaZero-style learners, with
+// fixed size observations and a fixed number of actions.
+//
+// The positions are stored as float32 columns allocated up front, one row per
+// position: the observations, the dense policy targets, the legal actions mask,
+// and the value targets. The rows can be read in place, so that a learner can
+// copy a sampled batch straight into its input tensors.
+//
+// Sampling is uniform without replacement by default. With a positive
+// priority_exponent, positions are instead sampled with replacement with a
+// probability proportional to priority^priority_exponent, as in prioritized
+// experience replay (Schaul et al., 2015). New positions get the highest
+// priority seen so far unless one is given.
+class ReplayBuffer {
+ public:
+  ReplayBuffer(int max_size, int observation_size, int num_actions,
+               double priority_exponent = 0);
+
+  // Adds one position, replacing the oldest once full. Returns its index. The
+  // policy is given as (action, probability) pairs, like ActionsAndProbs, and
+  // the actions not listed have probability 0.
+  int Add(absl::Span<const double> observation,
+          absl::Span<const int64_t> legal_actions,
+          absl::Span<const std::pair<int64_t, double>> policy, double value);
+  int Add(absl::Span<const double> observation,
+          absl::Span<const int64_t> legal_actions,
+          absl::Span<const std::pair<int64_t, double>> policy, double value,
+          double priority);
+
+  // Returns the indices of `num` positions; see the class comment. Fewer are
+  // returned if sampling without replacement from a smaller buffer.
+  std::vector<int> Sample(std::mt19937* rng, int num) const;
+
+  // Sets the priority of a position. Only meaningful for prioritized buffers.
+  void SetPriority(int index, double priority);
+  double Priority(int index) const;
+
+  // The rows of a position.
+  absl::Span<const float> Observation(int index) const {
+    return {&observations_[static_cast<int64_t>(index) * observation_size_],
+            static_cast<size_t>(observation_size_)};
+  }
+  absl::Span<const float> Policy(int index) const {
+    return {&policies_[static_cast<int64_t>(index) * num_actions_],
+            static_cast<size_t>(num_actions_)};
+  }
+  absl::Span<const uint8_t> LegalMask(int index) const {
+    return {&legal_masks_[static_cast<int64_t>(index) * num_actions_],
+            static_cast<size_t>(num_actions_)};
+  }
+  float Value(int index) const { return values_[index]; }
+
+  int ObservationSize() const { return observation_size_; }
+  int NumActions() const { return num_actions_; }
+  bool Prioritized() const { return priority_exponent_ > 0; }
+
+  // How many positions are in the buffer.
+  int Size() const { return size_; }
+  bool Empty() const { return size_ == 0; }
+
+  // How many positions have ever been added to the buffer.
+  int64_t TotalAdded() const { return total_added_; }
+
+  // Writes the positions, and their priorities if prioritized, to a binary
+  // file, replacing it atomically, e.g. to restore them when a run restarts.
+  void Save(const std::string& filename) const;
+
+  // Replaces the positions with those saved to a file, which is mapped into
+  // memory and copied from row by row, from the oldest position into slot 0.
+  // Only the newest positions are kept if the file holds more than fit, and
+  // those restored into a prioritized
+  // buffer from an unprioritized one get the highest priority. The
+  // observation size and the number of actions must match.
+  void Load(const std::string& filename);
+
+ private:
+  struct SnapshotHeader;
+
+  // Sets the leaf of a position in the sum tree, and updates its ancestors.
+  void SetWeight(int index, double weight);
+
+  const int max_size_;
+  const int observation_size_;
+  const int num_actions_;
+  const double priority_exponent_;
+  int size_ = 0;
+  int next_ = 0;  // The slot of the next position added.
+  int64_t total_added_ = 0;
+  double max_priority_ = 1;
+
+  std::vector<float> observations_;
+  std::vector<float> policies_;
+  std::vector<uint8_t> legal_masks_;
+  std::vector<float> values_;
+
+  // For prioritized buffers: the priorities, and a sum tree of their weights,
+  // with the root at 1 and the leaves from num_leaves_.
+  std::vector<double> priorities_;
+  int num_leaves_ = 0;
+  std::vector<double> sum_tree_;
+};
+
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_UTILS_REPLAY_BUFFER_H_
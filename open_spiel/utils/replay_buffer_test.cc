@@ -0,0 +1,189 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/utils/replay_buffer.h"
+
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/container/flat_hash_set.h"
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/file.h"
+
+namespace open_spiel {
+namespace {
+
+// Adds a position whose observation and value are `i`, with action `i % 3`
+// legal and certain.
+int AddPosition(ReplayBuffer* buffer, int i) {
+  std::vector<double> observation = {static_cast<double>(i), 0.5};
+  std::vector<int64_t> legal_actions = {i % 3};
+  std::vector<std::pair<int64_t, double>> policy = {{i % 3, 1.0}};
+  return buffer->Add(observation, legal_actions, policy, i);
+}
+
+void TestReplayBuffer() {
+  ReplayBuffer buffer(4, 2, 3);
+  std::mt19937 rng;
+
+  SPIEL_CHECK_TRUE(buffer.Empty());
+  SPIEL_CHECK_EQ(buffer.Size(), 0);
+  SPIEL_CHECK_TRUE(buffer.Sample(&rng, 2).empty());
+
+  SPIEL_CHECK_EQ(AddPosition(&buffer, 13), 0);
+  SPIEL_CHECK_FALSE(buffer.Empty());
+  SPIEL_CHECK_EQ(buffer.Size(), 1);
+  SPIEL_CHECK_EQ(buffer.TotalAdded(), 1);
+  SPIEL_CHECK_EQ(buffer.Observation(0)[0], 13);
+  SPIEL_CHECK_EQ(buffer.Observation(0)[1], 0.5);
+  SPIEL_CHECK_EQ(buffer.Value(0), 13);
+  SPIEL_CHECK_EQ(buffer.LegalMask(0)[1], 1);
+  SPIEL_CHECK_EQ(buffer.LegalMask(0)[0], 0);
+  SPIEL_CHECK_EQ(buffer.Policy(0)[1], 1);
+  SPIEL_CHECK_EQ(buffer.Policy(0)[2], 0);
+
+  // Only one position to sample from without replacement.
+  std::vector<int> sample = buffer.Sample(&rng, 3);
+  SPIEL_CHECK_EQ(sample, std::vector<int>({0}));
+
+  for (int i = 14; i <= 18; ++i) AddPosition(&buffer, i);
+  SPIEL_CHECK_EQ(buffer.Size(), 4);
+  SPIEL_CHECK_EQ(buffer.TotalAdded(), 6);
+
+  // 17 and 18 replaced 13 and 14, and overwrote the whole rows.
+  SPIEL_CHECK_EQ(buffer.Value(0), 17);
+  SPIEL_CHECK_EQ(buffer.Value(1), 18);
+  SPIEL_CHECK_EQ(buffer.LegalMask(0)[1], 0);
+  SPIEL_CHECK_EQ(buffer.LegalMask(0)[2], 1);
+  SPIEL_CHECK_EQ(buffer.Policy(0)[1], 0);
+
+  for (int trial = 0; trial < 10; ++trial) {
+    sample = buffer.Sample(&rng, 3);
+    SPIEL_CHECK_EQ(sample.size(), 3);
+    absl::flat_hash_set<int> distinct(sample.begin(), sample.end());
+    SPIEL_CHECK_EQ(distinct.size(), 3);
+    for (int index : sample) {
+      SPIEL_CHECK_GE(buffer.Value(index), 15);
+      SPIEL_CHECK_LE(buffer.Value(index), 18);
+    }
+  }
+}
+
+void TestPrioritizedReplayBuffer() {
+  ReplayBuffer buffer(3, 2, 3, /*priority_exponent=*/1);
+  std::mt19937 rng;
+  SPIEL_CHECK_TRUE(buffer.Prioritized());
+
+  for (int i = 0; i < 3; ++i) AddPosition(&buffer, i);
+  SPIEL_CHECK_EQ(buffer.Priority(2), 1);
+  buffer.SetPriority(0, 8);
+  buffer.SetPriority(1, 1e-9);
+  buffer.SetPriority(2, 2);
+
+  std::vector<int> counts(3, 0);
+  constexpr int kNumSamples = 10000;
+  for (int index : buffer.Sample(&rng, kNumSamples)) counts[index] += 1;
+  SPIEL_CHECK_EQ(counts[0] + counts[1] + counts[2], kNumSamples);
+  SPIEL_CHECK_EQ(counts[1], 0);
+  SPIEL_CHECK_GT(counts[0], 3.5 * counts[2]);
+  SPIEL_CHECK_LT(counts[0], 4.5 * counts[2]);
+
+  // New positions get the highest priority so far, and replace the oldest.
+  AddPosition(&buffer, 3);
+  SPIEL_CHECK_EQ(buffer.Value(0), 3);
+  SPIEL_CHECK_EQ(buffer.Priority(0), 8);
+}
+
+// Checks that a position holds what AddPosition added for `i`.
+void CheckPosition(const ReplayBuffer& buffer, int index, int i) {
+  SPIEL_CHECK_EQ(buffer.Value(index), i);
+  SPIEL_CHECK_EQ(buffer.Observation(index)[0], i);
+  SPIEL_CHECK_EQ(buffer.Observation(index)[1], 0.5);
+  for (int action = 0; action < 3; ++action) {
+    SPIEL_CHECK_EQ(buffer.LegalMask(index)[action], action == i % 3);
+    SPIEL_CHECK_EQ(buffer.Policy(index)[action], action == i % 3);
+  }
+}
+
+void TestReplayBufferSnapshot() {
+  const std::string filename = absl::StrCat(
+      file::GetTmpDir(), "/open_spiel-test-", std::rand(),  // NOLINT
+      "-replay_buffer");
+  // Positions 0 to 5, of which 2 to 5 are kept, with 4 and 5 in slots 0 and
+  // 1, and priority 10 + i.
+  ReplayBuffer buffer(4, 2, 3, /*priority_exponent=*/1);
+  for (int i = 0; i < 6; ++i) {
+    buffer.SetPriority(AddPosition(&buffer, i), 10 + i);
+  }
+  buffer.Save(filename);
+
+  // They are restored from the oldest, in slot 0.
+  ReplayBuffer same(4, 2, 3, /*priority_exponent=*/1);
+  AddPosition(&same, 100);
+  same.Load(filename);
+  SPIEL_CHECK_EQ(same.Size(), 4);
+  SPIEL_CHECK_EQ(same.TotalAdded(), 6);
+  for (int index = 0; index < 4; ++index) {
+    CheckPosition(same, index, index + 2);
+    SPIEL_CHECK_EQ(same.Priority(index), index + 12);
+  }
+  SPIEL_CHECK_EQ(AddPosition(&same, 6), 0);
+  CheckPosition(same, 0, 6);
+  SPIEL_CHECK_EQ(same.Priority(0), 15);
+  SPIEL_CHECK_EQ(same.TotalAdded(), 7);
+
+  // Only the newest positions fit in a smaller buffer.
+  ReplayBuffer smaller(3, 2, 3);
+  smaller.Load(filename);
+  SPIEL_CHECK_EQ(smaller.Size(), 3);
+  for (int index = 0; index < 3; ++index) {
+    CheckPosition(smaller, index, index + 3);
+  }
+  SPIEL_CHECK_EQ(AddPosition(&smaller, 6), 0);
+
+  // A larger buffer has room for more.
+  ReplayBuffer larger(8, 2, 3);
+  larger.Load(filename);
+  SPIEL_CHECK_EQ(larger.Size(), 4);
+  for (int index = 0; index < 4; ++index) {
+    CheckPosition(larger, index, index + 2);
+  }
+  SPIEL_CHECK_EQ(AddPosition(&larger, 6), 4);
+  SPIEL_CHECK_EQ(larger.Size(), 5);
+
+  // The positions of an unprioritized buffer are all as likely to be sampled
+  // in a prioritized one.
+  ReplayBuffer unprioritized(4, 2, 3);
+  for (int i = 0; i < 2; ++i) AddPosition(&unprioritized, i);
+  unprioritized.Save(filename);
+  ReplayBuffer prioritized(4, 2, 3, /*priority_exponent=*/1);
+  prioritized.Load(filename);
+  SPIEL_CHECK_EQ(prioritized.Size(), 2);
+  SPIEL_CHECK_EQ(prioritized.Priority(0), prioritized.Priority(1));
+  CheckPosition(prioritized, 1, 1);
+  SPIEL_CHECK_TRUE(file::Remove(filename));
+}
+
+}  // namespace
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  open_spiel::TestReplayBuffer();
+  open_spiel::TestPrioritizedReplayBuffer();
+  open_spiel::TestReplayBufferSnapshot();
+}
@@ -16,7 +16,14 @@
 #define OPEN_SPIEL_UTILS_STATS_H_
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
 
 #include "open_spiel/abseil-cpp/absl/algorithm/container.h"
 #include "open_spiel/utils/json.h"
@@ -27,6 +34,9 @@ namespace open_spiel {
 class BasicStats {
  public:
   BasicStats() { Reset(); }
+  // From the running sums, e.g. to merge stats gathered elsewhere.
+  BasicStats(int64_t num, double min, double max, double sum, double sum_sq)
+      : num_(num), min_(min), max_(max), sum_(sum), sum_sq_(sum_sq) {}
 
   // Reset all the stats to 0.
   void Reset() {
@@ -90,7 +100,12 @@ class HistogramNumbered {
  public:
   explicit HistogramNumbered(int num_buckets) : counts_(num_buckets, 0) {}
   void Reset() { absl::c_fill(counts_, 0); }
-  void Add(int bucket_id) { counts_[bucket_id] += 1; }
+  void Add(int bucket_id, int count = 1) { counts_[bucket_id] += count; }
+  // Merges a histogram with the same buckets.
+  HistogramNumbered& operator+=(const HistogramNumbered& o) {
+    for (int i = 0; i < counts_.size(); ++i) counts_[i] += o.counts_[i];
+    return *this;
+  }
   json::Array ToJson() const { return json::CastToArray(counts_); }
 
  private:
@@ -117,6 +132,301 @@ class HistogramNamed {
   std::vector<std::string> names_;
 };
 
+// A histogram of non-negative integers, such as latencies in microseconds,
+// with buckets of log-linear widths as in HdrHistogram: the values below 16
+// have their own bucket, and each power of two above is split into 16
+// buckets, so a bucket is at most 1/16 of its values wide. Values of 2^40 and
+// more are counted in the last bucket. Histograms can be merged, e.g. those of
+// several threads.
+class LatencyHistogram {
+ public:
+  static constexpr int kSubBucketBits = 4;
+  static constexpr int kSubBuckets = 1 << kSubBucketBits;
+  static constexpr int kMaxBits = 40;
+  static constexpr int kNumBuckets =
+      (kMaxBits - kSubBucketBits + 1) * kSubBuckets;
+
+  LatencyHistogram() { Reset(); }
+
+  void Reset() {
+    counts_.fill(0);
+    num_ = 0;
+    sum_ = 0;
+  }
+
+  LatencyHistogram& operator+=(const LatencyHistogram& o) {
+    for (int i = 0; i < kNumBuckets; ++i) counts_[i] += o.counts_[i];
+    num_ += o.num_;
+    sum_ += o.sum_;
+    return *this;
+  }
+
+  void Add(int64_t value) {
+    counts_[Bucket(value)] += 1;
+    num_ += 1;
+    sum_ += value;
+  }
+
+  // Adds count values in a bucket, with their sum, as when merging.
+  void AddBucket(int bucket, int64_t count, int64_t sum) {
+    counts_[bucket] += count;
+    num_ += count;
+    sum_ += sum;
+  }
+
+  int64_t Num() const { return num_; }
+  double Avg() const {
+    return num_ == 0 ? 0 : static_cast<double>(sum_) / num_;
+  }
+
+  // The value below which a fraction q of the values lie, as the upper edge
+  // of the bucket holding it, so at most 1/16 above the exact quantile.
+  int64_t Percentile(double q) const {
+    if (num_ == 0) return 0;
+    const int64_t rank =
+        std::max<int64_t>(1, static_cast<int64_t>(std::ceil(q * num_)));
+    int64_t seen = 0;
+    for (int bucket = 0; bucket < kNumBuckets; ++bucket) {
+      seen += counts_[bucket];
+      if (seen >= rank) return BucketLimit(bucket);
+    }
+    return BucketLimit(kNumBuckets - 1);
+  }
+
+  json::Object ToJson() const {
+    return {
+        {"num", Num()},
+        {"avg", Avg()},
+        {"p50", Percentile(0.5)},
+        {"p90", Percentile(0.9)},
+        {"p99", Percentile(0.99)},
+        {"p999", Percentile(0.999)},
+        {"max", Percentile(1)},
+    };
+  }
+
+  static int Bucket(int64_t value) {
+    if (value < kSubBuckets) return std::max<int64_t>(value, 0);
+    value = std::min<int64_t>(value, (int64_t{1} << kMaxBits) - 1);
+    const int shift = HighestBit(value) - kSubBucketBits;
+    // The top kSubBucketBits + 1 bits, the first of which is set.
+    return (shift + 1) * kSubBuckets +
+           static_cast<int>(value >> shift) - kSubBuckets;
+  }
+
+  // The largest value in the bucket.
+  static int64_t BucketLimit(int bucket) {
+    if (bucket < kSubBuckets) return bucket;
+    const int shift = bucket / kSubBuckets - 1;
+    const int64_t top = bucket % kSubBuckets + kSubBuckets;
+    return ((top + 1) << shift) - 1;
+  }
+
+ private:
+  static int HighestBit(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(value);
+#else
+    int bit = 0;
+    while (value >>= 1) ++bit;
+    return bit;
+#endif
+  }
+
+  std::array<int64_t, kNumBuckets> counts_;
+  int64_t num_;
+  int64_t sum_;
+};
+
+// The concurrent versions of the stats above, which threads update without
+// locks, e.g. to measure hot paths without perturbing them. The values are
+// spread over shards, each thread adding to its own (threads share a shard
+// only once there are more than kStatsShards), and Snapshot sums the shards
+// into the plain version for reporting. Updates are relaxed atomics, so a
+// snapshot taken while threads are adding may miss some of their latest
+// values, and a Reset may miss concurrent ones.
+inline constexpr int kStatsShards = 16;
+
+// The shard of the calling thread.
+inline int StatsShard() {
+  static std::atomic<int> next_shard{0};
+  thread_local const int shard =
+      next_shard.fetch_add(1, std::memory_order_relaxed) % kStatsShards;
+  return shard;
+}
+
+class ConcurrentCounter {
+ public:
+  ConcurrentCounter() { Reset(); }
+
+  void Add(int64_t n = 1) {
+    shards_[StatsShard()].value.fetch_add(n, std::memory_order_relaxed);
+  }
+
+  int64_t Value() const {
+    int64_t value = 0;
+    for (const Shard& shard : shards_) {
+      value += shard.value.load(std::memory_order_relaxed);
+    }
+    return value;
+  }
+
+  void Reset() {
+    for (Shard& shard : shards_) {
+      shard.value.store(0, std::memory_order_relaxed);
+    }
+  }
+
+ private:
+  // A cache line each, so that the threads don't contend for them.
+  struct alignas(64) Shard {
+    std::atomic<int64_t> value;
+  };
+  std::array<Shard, kStatsShards> shards_;
+};
+
+class ConcurrentBasicStats {
+ public:
+  ConcurrentBasicStats() { Reset(); }
+
+  void Add(double val) {
+    Shard& shard = shards_[StatsShard()];
+    shard.num.fetch_add(1, std::memory_order_relaxed);
+    AtomicUpdate(&shard.sum, [val](double sum) { return sum + val; });
+    AtomicUpdate(&shard.sum_sq,
+                 [val](double sum_sq) { return sum_sq + val * val; });
+    AtomicUpdate(&shard.min, [val](double min) { return std::min(min, val); });
+    AtomicUpdate(&shard.max, [val](double max) { return std::max(max, val); });
+  }
+
+  BasicStats Snapshot() const {
+    BasicStats stats;
+    for (const Shard& shard : shards_) {
+      stats += BasicStats(shard.num.load(std::memory_order_relaxed),
+                          shard.min.load(std::memory_order_relaxed),
+                          shard.max.load(std::memory_order_relaxed),
+                          shard.sum.load(std::memory_order_relaxed),
+                          shard.sum_sq.load(std::memory_order_relaxed));
+    }
+    return stats;
+  }
+
+  void Reset() {
+    for (Shard& shard : shards_) {
+      shard.num.store(0, std::memory_order_relaxed);
+      shard.min.store(std::numeric_limits<double>::max(),
+                      std::memory_order_relaxed);
+      shard.max.store(std::numeric_limits<double>::min(),
+                      std::memory_order_relaxed);
+      shard.sum.store(0, std::memory_order_relaxed);
+      shard.sum_sq.store(0, std::memory_order_relaxed);
+    }
+  }
+
+ private:
+  // Shards are rarely shared, so the compare-exchange rarely loops, and is
+  // skipped when the value doesn't change, as for most mins and maxes.
+  template <typename Fn>
+  static void AtomicUpdate(std::atomic<double>* value, Fn fn) {
+    double old_value = value->load(std::memory_order_relaxed);
+    double new_value;
+    do {
+      new_value = fn(old_value);
+      if (new_value == old_value) return;
+    } while (!value->compare_exchange_weak(old_value, new_value,
+                                           std::memory_order_relaxed));
+  }
+
+  struct alignas(64) Shard {
+    std::atomic<int64_t> num;
+    std::atomic<double> min;
+    std::atomic<double> max;
+    std::atomic<double> sum;
+    std::atomic<double> sum_sq;
+  };
+  std::array<Shard, kStatsShards> shards_;
+};
+
+class ConcurrentHistogramNumbered {
+ public:
+  explicit ConcurrentHistogramNumbered(int num_buckets)
+      : num_buckets_(num_buckets),
+        counts_(new std::atomic<int64_t>[kStatsShards * num_buckets]) {
+    Reset();
+  }
+
+  void Add(int bucket_id) {
+    counts_[StatsShard() * num_buckets_ + bucket_id].fetch_add(
+        1, std::memory_order_relaxed);
+  }
+
+  HistogramNumbered Snapshot() const {
+    HistogramNumbered hist(num_buckets_);
+    for (int shard = 0; shard < kStatsShards; ++shard) {
+      for (int bucket = 0; bucket < num_buckets_; ++bucket) {
+        hist.Add(bucket, counts_[shard * num_buckets_ + bucket].load(
+                             std::memory_order_relaxed));
+      }
+    }
+    return hist;
+  }
+
+  void Reset() {
+    for (int i = 0; i < kStatsShards * num_buckets_; ++i) {
+      counts_[i].store(0, std::memory_order_relaxed);
+    }
+  }
+
+ private:
+  int num_buckets_;
+  // The counts of each shard in turn.
+  std::unique_ptr<std::atomic<int64_t>[]> counts_;
+};
+
+class ConcurrentLatencyHistogram {
+ public:
+  ConcurrentLatencyHistogram() : shards_(new Shard[kStatsShards]) { Reset(); }
+
+  void Add(int64_t value) {
+    Shard& shard = shards_[StatsShard()];
+    shard.counts[LatencyHistogram::Bucket(value)].fetch_add(
+        1, std::memory_order_relaxed);
+    shard.sum.fetch_add(value, std::memory_order_relaxed);
+  }
+
+  LatencyHistogram Snapshot() const {
+    LatencyHistogram hist;
+    for (int s = 0; s < kStatsShards; ++s) {
+      const Shard& shard = shards_[s];
+      // The sum is only needed for the average, so it goes with any bucket.
+      hist.AddBucket(0, 0, shard.sum.load(std::memory_order_relaxed));
+      for (int bucket = 0; bucket < LatencyHistogram::kNumBuckets; ++bucket) {
+        const int64_t count =
+            shard.counts[bucket].load(std::memory_order_relaxed);
+        if (count > 0) hist.AddBucket(bucket, count, 0);
+      }
+    }
+    return hist;
+  }
+
+  void Reset() {
+    for (int s = 0; s < kStatsShards; ++s) {
+      for (auto& count : shards_[s].counts) {
+        count.store(0, std::memory_order_relaxed);
+      }
+      shards_[s].sum.store(0, std::memory_order_relaxed);
+    }
+  }
+
+ private:
+  struct alignas(64) Shard {
+    std::array<std::atomic<int64_t>, LatencyHistogram::kNumBuckets> counts;
+    std::atomic<int64_t> sum;
+  };
+  // On the heap, as there are 16 shards of 5KB.
+  std::unique_ptr<Shard[]> shards_;
+};
+
 }  // namespace open_spiel
 
 #endif  // OPEN_SPIEL_UTILS_STATS_H_
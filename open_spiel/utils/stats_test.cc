@@ -14,8 +14,11 @@
 
 #include "open_spiel/utils/stats.h"
 
+#include <vector>
+
 #include "open_spiel/spiel_utils.h"
 #include "open_spiel/utils/json.h"
+#include "open_spiel/utils/thread.h"
 
 namespace open_spiel {
 namespace {
@@ -80,6 +83,11 @@ void TestHistogramNumbered() {
 
   SPIEL_CHECK_EQ(hist.ToJson(), json::Array({1, 1, 3}));
 
+  HistogramNumbered other(3);
+  other.Add(1, 2);
+  hist += other;
+  SPIEL_CHECK_EQ(hist.ToJson(), json::Array({1, 3, 3}));
+
   hist.Reset();
 
   SPIEL_CHECK_EQ(hist.ToJson(), json::Array({0, 0, 0}));
@@ -106,6 +114,87 @@ void TestHistogramNamed() {
   }));
 }
 
+void TestLatencyHistogram() {
+  // Each value is in a bucket whose limit is within 1/16 above it.
+  for (int64_t value = 0; value < 100000; value = value * 9 / 8 + 1) {
+    const int bucket = LatencyHistogram::Bucket(value);
+    SPIEL_CHECK_GE(LatencyHistogram::BucketLimit(bucket), value);
+    SPIEL_CHECK_LE(LatencyHistogram::BucketLimit(bucket), value + value / 16);
+    if (bucket > 0) {
+      SPIEL_CHECK_LT(LatencyHistogram::BucketLimit(bucket - 1), value);
+    }
+  }
+  SPIEL_CHECK_EQ(LatencyHistogram::Bucket(int64_t{1} << 50),
+                 LatencyHistogram::kNumBuckets - 1);
+
+  LatencyHistogram hist;
+  SPIEL_CHECK_EQ(hist.Percentile(0.5), 0);
+  for (int value = 1; value <= 1000; ++value) hist.Add(value);
+  SPIEL_CHECK_EQ(hist.Num(), 1000);
+  SPIEL_CHECK_FLOAT_EQ(hist.Avg(), 500.5);
+  SPIEL_CHECK_EQ(hist.Percentile(0.01), 10);
+  SPIEL_CHECK_EQ(hist.Percentile(0.5), 511);
+  SPIEL_CHECK_EQ(hist.Percentile(0.99), 991);
+  SPIEL_CHECK_EQ(hist.Percentile(1), 1023);
+
+  LatencyHistogram other;
+  other.Add(100000);
+  hist += other;
+  SPIEL_CHECK_EQ(hist.Num(), 1001);
+  SPIEL_CHECK_EQ(hist.Percentile(0.99), 991);
+  SPIEL_CHECK_EQ(hist.Percentile(1), 102399);
+  SPIEL_CHECK_EQ(hist.ToJson()["num"], json::Value(1001));
+
+  hist.Reset();
+  SPIEL_CHECK_EQ(hist.Num(), 0);
+  SPIEL_CHECK_EQ(hist.Avg(), 0);
+}
+
+void TestConcurrentStats() {
+  ConcurrentCounter counter;
+  ConcurrentBasicStats stats;
+  ConcurrentHistogramNumbered numbered(4);
+  ConcurrentLatencyHistogram latency;
+  constexpr int kThreads = 20;
+  constexpr int kValues = 10000;
+  std::vector<Thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i < kValues; ++i) {
+        counter.Add();
+        stats.Add(t);
+        numbered.Add(i % 4);
+        latency.Add(t * 100);
+      }
+    });
+  }
+  for (Thread& thread : threads) thread.join();
+
+  SPIEL_CHECK_EQ(counter.Value(), kThreads * kValues);
+  const BasicStats basic = stats.Snapshot();
+  SPIEL_CHECK_EQ(basic.Num(), kThreads * kValues);
+  SPIEL_CHECK_EQ(basic.Min(), 0);
+  SPIEL_CHECK_EQ(basic.Max(), kThreads - 1);
+  SPIEL_CHECK_FLOAT_EQ(basic.Avg(), (kThreads - 1) / 2.0);
+  const int quarter = kThreads * kValues / 4;
+  SPIEL_CHECK_EQ(numbered.Snapshot().ToJson(),
+                 json::Array({quarter, quarter, quarter, quarter}));
+  const LatencyHistogram hist = latency.Snapshot();
+  SPIEL_CHECK_EQ(hist.Num(), kThreads * kValues);
+  SPIEL_CHECK_FLOAT_EQ(hist.Avg(), (kThreads - 1) * 100 / 2.0);
+  SPIEL_CHECK_EQ(hist.Percentile(0), 0);
+  SPIEL_CHECK_EQ(hist.Percentile(1), 1919);
+
+  counter.Reset();
+  stats.Reset();
+  numbered.Reset();
+  latency.Reset();
+  SPIEL_CHECK_EQ(counter.Value(), 0);
+  SPIEL_CHECK_EQ(stats.Snapshot().Num(), 0);
+  SPIEL_CHECK_EQ(numbered.Snapshot().ToJson(), json::Array({0, 0, 0, 0}));
+  SPIEL_CHECK_EQ(latency.Snapshot().Num(), 0);
+}
+
 }  // namespace
 }  // namespace open_spiel
 
@@ -113,4 +202,6 @@ int main(int argc, char** argv) {
   open_spiel::TestBasicStats();
   open_spiel::TestHistogramNumbered();
   open_spiel::TestHistogramNamed();
+  open_spiel::TestLatencyHistogram();
+  open_spiel::TestConcurrentStats();
 }
@@ -16,35 +16,47 @@
 #define OPEN_SPIEL_UTILS_TENSOR_VIEW_H_
 
 #include <algorithm>
+#include <array>
 #include <numeric>
 #include <vector>
 
+#include "open_spiel/abseil-cpp/absl/types/span.h"
 #include "open_spiel/spiel_utils.h"
 
 namespace open_spiel {
 
-// Treat a `std::vector<double>` as a tensor of fixed shape. The rank (number of
+// Treat a `std::vector<T>` (by default `std::vector<double>`) or a
+// caller-owned `absl::Span<T>` as a tensor of fixed shape. The rank (number of
 // dimensions) must be known at compile time, though the actual sizes of the
 // dimensions can be supplied at construction time. It then lets you index into
-// the vector easily without having to compute the 1d-vector's indices manually.
+// the buffer easily without having to compute the 1d-vector's indices manually.
 // Given the common use case is to fill the observations in
 // ObservationTensor and InformationStateTensor it offers a way to resize and
-// clear the vector to match the specified shape at construction.
-template <int Rank>
+// clear the vector to match the specified shape at construction. Spans cannot
+// be resized, so their size must already match the shape.
+template <int Rank, typename T = double>
 class TensorView {
  public:
-  constexpr TensorView(std::vector<double>* values,
+  constexpr TensorView(std::vector<T>* values,
                        const std::array<int, Rank>& shape, bool reset)
-      : values_(values), shape_(shape) {
+      : shape_(shape) {
     if (reset) {
-      int old_size = values_->size();
+      int old_size = values->size();
       int new_size = size();
-      values_->resize(new_size, 0.0);
-      std::fill(values_->begin(),
-                values_->begin() + std::min(old_size, new_size), 0.0);
+      values->resize(new_size, 0);
+      std::fill(values->begin(), values->begin() + std::min(old_size, new_size),
+                0);
     } else {
-      SPIEL_CHECK_EQ(size(), values_->size());
+      SPIEL_CHECK_EQ(size(), values->size());
     }
+    values_ = absl::MakeSpan(*values);
+  }
+
+  constexpr TensorView(absl::Span<T> values,
+                       const std::array<int, Rank>& shape, bool reset)
+      : values_(values), shape_(shape) {
+    SPIEL_CHECK_EQ(size(), values_.size());
+    if (reset) clear();
   }
 
   constexpr int size() const {
@@ -52,21 +64,23 @@ class TensorView {
                            std::multiplies<int>());
   }
 
-  void clear() { std::fill(values_->begin(), values_->end(), 0.0); }
+  void clear() { std::fill(values_.begin(), values_.end(), 0); }
 
   constexpr int index(const std::array<int, Rank>& args) const {
     int ind = 0;
     for (int i = 0; i < Rank; ++i) {
+      SPIEL_PARANOID_CHECK_GE(args[i], 0);
+      SPIEL_PARANOID_CHECK_LT(args[i], shape_[i]);
       ind = ind * shape_[i] + args[i];
     }
     return ind;
   }
 
-  constexpr double& operator[](const std::array<int, Rank>& args) {
-    return (*values_)[index(args)];
+  constexpr T& operator[](const std::array<int, Rank>& args) {
+    return values_[index(args)];
   }
-  constexpr const double& operator[](const std::array<int, Rank>& args) const {
-    return (*values_)[index(args)];
+  constexpr const T& operator[](const std::array<int, Rank>& args) const {
+    return values_[index(args)];
   }
 
   constexpr int rank() const { return Rank; }
@@ -74,7 +88,7 @@ class TensorView {
   constexpr int shape(int i) const { return shape_[i]; }
 
  private:
-  std::vector<double>* values_;
+  absl::Span<T> values_;
   const std::array<int, Rank> shape_;
 };
 
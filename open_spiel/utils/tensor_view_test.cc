@@ -15,8 +15,10 @@
 #include "open_spiel/utils/tensor_view.h"
 
 #include <array>
+#include <cstdint>
 #include <vector>
 
+#include "open_spiel/abseil-cpp/absl/types/span.h"
 #include "open_spiel/spiel_utils.h"
 
 namespace open_spiel {
@@ -134,7 +136,33 @@ void TestTensorView() {
   }
 }
 
+void TestTensorViewOverSpan() {
+  // Spans are not resized, but are cleared when asked to.
+  std::vector<float> values(6, 7);
+  TensorView<2, float> view(absl::MakeSpan(values), {2, 3}, true);
+  SPIEL_CHECK_EQ(view.size(), 6);
+  for (float value : values) SPIEL_CHECK_EQ(value, 0);
+
+  view[{1, 2}] = 0.5;
+  SPIEL_CHECK_EQ(values[5], 0.5);
+
+  // Views over a part of a larger buffer only touch that part.
+  std::vector<uint8_t> planes(8, 1);
+  TensorView<2, uint8_t> plane_view(absl::MakeSpan(planes).subspan(2, 4),
+                                    {2, 2}, true);
+  plane_view[{0, 1}] = 255;
+  SPIEL_CHECK_EQ(planes, (std::vector<uint8_t>{1, 1, 0, 255, 0, 0, 1, 1}));
+
+  // Other element types work over vectors too.
+  std::vector<float> float_values;
+  TensorView<1, float> float_view(&float_values, {4}, true);
+  SPIEL_CHECK_EQ(float_values.size(), 4);
+}
+
 }  // namespace
 }  // namespace open_spiel
 
-int main(int argc, char** argv) { open_spiel::TestTensorView(); }
+int main(int argc, char** argv) {
+  open_spiel::TestTensorView();
+  open_spiel::TestTensorViewOverSpan();
+}
@@ -14,10 +14,98 @@
 
 #include "open_spiel/utils/thread.h"
 
+#include <algorithm>
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <exception>
+#include <mutex>  // NOLINT
+#include <string>
 #include <thread>  // NOLINT
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/strings/numbers.h"
+#include "open_spiel/abseil-cpp/absl/strings/str_cat.h"
+#include "open_spiel/abseil-cpp/absl/strings/str_split.h"
+#include "open_spiel/abseil-cpp/absl/strings/string_view.h"
+#include "open_spiel/utils/file.h"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 namespace open_spiel {
 
+#ifdef __linux__
+std::vector<std::vector<int>> CpusByNode() {
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return {};
+  std::vector<std::vector<int>> nodes;
+  std::vector<bool> listed(CPU_SETSIZE, false);
+  for (int node = 0;; ++node) {
+    const std::string cpulist =
+        absl::StrCat("/sys/devices/system/node/node", node, "/cpulist");
+    if (!file::Exists(cpulist)) break;
+    // A list of ranges, e.g. "0-3,8-11".
+    const std::string ranges = file::File(cpulist, "r").ReadContents();
+    std::vector<int> cpus;
+    for (absl::string_view range :
+         absl::StrSplit(ranges, ',', absl::SkipWhitespace())) {
+      std::vector<absl::string_view> bounds = absl::StrSplit(range, '-');
+      int first, last;
+      if (!absl::SimpleAtoi(bounds.front(), &first) ||
+          !absl::SimpleAtoi(bounds.back(), &last)) {
+        continue;
+      }
+      for (int cpu = first; cpu <= last && cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &allowed)) {
+          cpus.push_back(cpu);
+          listed[cpu] = true;
+        }
+      }
+    }
+    if (!cpus.empty()) nodes.push_back(std::move(cpus));
+  }
+  std::vector<int> unlisted;
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+    if (CPU_ISSET(cpu, &allowed) && !listed[cpu]) unlisted.push_back(cpu);
+  }
+  if (!unlisted.empty()) nodes.push_back(std::move(unlisted));
+  return nodes;
+}
+
+std::vector<int> GetThreadAffinity() {
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if (pthread_getaffinity_np(pthread_self(), sizeof(allowed), &allowed) != 0) {
+    return {};
+  }
+  std::vector<int> cpus;
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+    if (CPU_ISSET(cpu, &allowed)) cpus.push_back(cpu);
+  }
+  return cpus;
+}
+
+bool SetThreadAffinity(const std::vector<int>& cpus) {
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  for (int cpu : cpus) {
+    if (cpu >= 0 && cpu < CPU_SETSIZE) CPU_SET(cpu, &allowed);
+  }
+  return pthread_setaffinity_np(pthread_self(), sizeof(allowed), &allowed) ==
+         0;
+}
+#else
+std::vector<std::vector<int>> CpusByNode() { return {}; }
+std::vector<int> GetThreadAffinity() { return {}; }
+bool SetThreadAffinity(const std::vector<int>& cpus) { return false; }
+#endif
+
+
 class Thread::ThreadImpl : public std::thread {
  public:
   using std::thread::thread;  // Inherit the constructors.
@@ -32,4 +120,224 @@ Thread& Thread::operator=(Thread&& other) = default;
 
 void Thread::join() { thread_->join(); }
 
+namespace {
+
+// The pool and queue of the worker running on this thread, if any.
+thread_local const void* current_pool = nullptr;
+thread_local int current_queue = -1;
+
+}  // namespace
+
+class ThreadPool::Impl {
+ public:
+  explicit Impl(const Options& options);
+  ~Impl();
+
+  int NumThreads() const { return threads_.size(); }
+
+  // Queues the task on the calling worker's deque, or the shared one.
+  void Push(std::function<void()> task);
+
+  // Runs a queued task, if any: the last of the calling worker's, else the
+  // first of another's. Returns whether there was one.
+  bool RunOne();
+
+ private:
+  // Aligned so that the workers don't contend for a cache line.
+  struct alignas(64) Queue {
+    std::mutex m;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  void Work(int worker, int cpu);
+  int CurrentQueue() const {
+    return current_pool == this ? current_queue : NumThreads();
+  }
+
+  // A deque per worker, then the one shared by the other threads.
+  std::vector<std::unique_ptr<Queue>> queues_;
+  // The deques each steals from, in order.
+  std::vector<std::vector<int>> victims_;
+  std::vector<Thread> threads_;
+
+  // The number of queued tasks, only increased with sleep_m_ held so that the
+  // workers waiting for one don't miss it.
+  std::atomic<int64_t> num_queued_{0};
+  std::mutex sleep_m_;
+  std::condition_variable wake_;
+  bool stop_ = false;
+};
+
+ThreadPool::Impl::Impl(const Options& options) {
+  const int num_threads = std::max(0, options.num_threads);
+  for (int i = 0; i <= num_threads; ++i) {
+    queues_.push_back(std::make_unique<Queue>());
+  }
+
+  // With pinning, the workers fill each node's CPUs in turn, wrapping around
+  // if there are more workers than CPUs.
+  std::vector<int> cpus(num_threads, -1);
+  std::vector<int> nodes(num_threads + 1, 0);
+  if (options.pin_threads) {
+    std::vector<std::vector<int>> cpus_by_node = CpusByNode();
+    std::vector<std::pair<int, int>> placements;  // (node, cpu)
+    for (int node = 0; node < cpus_by_node.size(); ++node) {
+      for (int cpu : cpus_by_node[node]) placements.emplace_back(node, cpu);
+    }
+    for (int i = 0; i < num_threads && !placements.empty(); ++i) {
+      std::tie(nodes[i], cpus[i]) = placements[i % placements.size()];
+    }
+  }
+
+  // Each steals from its node first, then the others, each starting after
+  // itself so that the thieves spread out.
+  const int num_queues = num_threads + 1;
+  victims_.resize(num_queues);
+  for (int i = 0; i < num_queues; ++i) {
+    for (bool same_node : {true, false}) {
+      for (int j = 1; j < num_queues; ++j) {
+        const int victim = (i + j) % num_queues;
+        if ((nodes[victim] == nodes[i]) == same_node) {
+          victims_[i].push_back(victim);
+        }
+      }
+    }
+  }
+
+  threads_.reserve(num_threads);
+  for (int i = 0; i < num_threads; ++i) {
+    const int cpu = cpus[i];
+    threads_.emplace_back([this, i, cpu]() { Work(i, cpu); });
+  }
+}
+
+ThreadPool::Impl::~Impl() {
+  {
+    std::lock_guard<std::mutex> lock(sleep_m_);
+    stop_ = true;
+  }
+  wake_.notify_all();
+  for (Thread& thread : threads_) thread.join();
+  // Without workers, the tasks left are run here.
+  while (RunOne()) {}
+}
+
+void ThreadPool::Impl::Push(std::function<void()> task) {
+  Queue& queue = *queues_[CurrentQueue()];
+  {
+    std::lock_guard<std::mutex> lock(queue.m);
+    queue.tasks.push_back(std::move(task));
+  }
+  {
+    std::lock_guard<std::mutex> lock(sleep_m_);
+    num_queued_.fetch_add(1, std::memory_order_relaxed);
+  }
+  wake_.notify_one();
+}
+
+bool ThreadPool::Impl::RunOne() {
+  const int self = CurrentQueue();
+  std::function<void()> task;
+  {
+    Queue& queue = *queues_[self];
+    std::lock_guard<std::mutex> lock(queue.m);
+    if (!queue.tasks.empty()) {
+      task = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+    }
+  }
+  for (int i = 0; !task && i < victims_[self].size(); ++i) {
+    Queue& queue = *queues_[victims_[self][i]];
+    std::lock_guard<std::mutex> lock(queue.m);
+    if (!queue.tasks.empty()) {
+      task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+    }
+  }
+  if (!task) return false;
+  num_queued_.fetch_sub(1, std::memory_order_relaxed);
+  task();
+  return true;
+}
+
+void ThreadPool::Impl::Work(int worker, int cpu) {
+  current_pool = this;
+  current_queue = worker;
+  if (cpu >= 0) SetThreadAffinity({cpu});
+  while (true) {
+    if (RunOne()) continue;
+    std::unique_lock<std::mutex> lock(sleep_m_);
+    wake_.wait(lock, [this]() {
+      return stop_ || num_queued_.load(std::memory_order_relaxed) > 0;
+    });
+    if (stop_ && num_queued_.load(std::memory_order_relaxed) == 0) return;
+  }
+}
+
+ThreadPool::ThreadPool(int num_threads)
+    : ThreadPool(Options{num_threads, /*pin_threads=*/false}) {}
+
+ThreadPool::ThreadPool(const Options& options)
+    : impl_(new Impl(options)) {}
+
+ThreadPool::~ThreadPool() = default;
+
+ThreadPool* ThreadPool::Default() {
+  // Never destroyed, so that it outlives the threads using it.
+  static ThreadPool* pool =
+      new ThreadPool(std::max(1u, std::thread::hardware_concurrency()));
+  return pool;
+}
+
+int ThreadPool::NumThreads() const { return impl_->NumThreads(); }
+
+void ThreadPool::Schedule(std::function<void()> fn) {
+  impl_->Push(std::move(fn));
+}
+
+void ThreadPool::ParallelFor(
+    int64_t begin, int64_t end, int64_t grain,
+    const std::function<void(int64_t, int64_t)>& fn) {
+  if (end <= begin) return;
+  if (grain < 1) grain = 1;
+  if (end - begin <= grain) {
+    fn(begin, end);
+    return;
+  }
+
+  // The forked halves not done yet, and the first error.
+  std::atomic<int64_t> pending{0};
+  std::mutex error_m;
+  std::exception_ptr error;
+  auto run = [&](int64_t block_begin, int64_t block_end) {
+    try {
+      fn(block_begin, block_end);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(error_m);
+      if (!error) error = std::current_exception();
+    }
+  };
+  // Forks the second half until the first is at most grain long, then runs
+  // that. The thieves take the largest halves, forked first.
+  std::function<void(int64_t, int64_t)> split = [&](int64_t block_begin,
+                                                    int64_t block_end) {
+    while (block_end - block_begin > grain) {
+      const int64_t middle = block_begin + (block_end - block_begin) / 2;
+      pending.fetch_add(1, std::memory_order_relaxed);
+      impl_->Push([&split, &pending, middle, block_end]() {
+        split(middle, block_end);
+        pending.fetch_sub(1, std::memory_order_release);
+      });
+      block_end = middle;
+    }
+    run(block_begin, block_end);
+  };
+  split(begin, end);
+  // Help with the queued tasks, ours or not, until ours are done.
+  while (pending.load(std::memory_order_acquire) > 0) {
+    if (!impl_->RunOne()) std::this_thread::yield();
+  }
+  if (error) std::rethrow_exception(error);
+}
+
 }  // namespace open_spiel
@@ -15,9 +15,12 @@
 #ifndef OPEN_SPIEL_UTILS_THREAD_H_
 #define OPEN_SPIEL_UTILS_THREAD_H_
 
+#include <algorithm>
 #include <atomic>
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <vector>
 
 namespace open_spiel {
 
@@ -52,6 +55,88 @@ class StopToken {
   std::atomic<bool> token_;
 };
 
+// The CPUs this process may run on, grouped by NUMA node, from sysfs. They
+// are all in one group when the nodes are unknown, and there are none where
+// affinity isn't supported, i.e. off Linux.
+std::vector<std::vector<int>> CpusByNode();
+
+// The CPUs the calling thread may run on, and restricting it to some of them.
+// The threads it starts afterwards inherit them. Off Linux there are none,
+// and setting them does nothing and returns false.
+std::vector<int> GetThreadAffinity();
+bool SetThreadAffinity(const std::vector<int>& cpus);
+
+// A pool of worker threads for fork/join parallelism, to be shared by the
+// parallel parts of a program rather than each starting its own threads.
+//
+// Each worker has a deque of tasks: it pushes the tasks it forks at the back,
+// takes its own from the back, and when it runs out steals from the front of
+// the others', which hold the larger pieces of work. Threads outside the pool
+// share an extra deque. A thread waiting for its forked tasks runs queued ones
+// meanwhile, so the parallel loops can nest, e.g. a parallel search in each
+// of several games played in parallel, without deadlocking or starting more
+// threads.
+class ThreadPool {
+ public:
+  struct Options {
+    // The number of workers. 0 runs every task on the thread waiting for it.
+    int num_threads = 0;
+    // Whether to pin each worker to a CPU, those of each NUMA node in turn.
+    // Workers then steal from those on their own node first. Only supported
+    // on Linux, and ignored elsewhere.
+    bool pin_threads = false;
+  };
+
+  explicit ThreadPool(int num_threads);
+  explicit ThreadPool(const Options& options);
+  // Waits for the scheduled tasks to complete.
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  // A pool with a worker per hardware thread, created on first use and shared
+  // by the whole program.
+  static ThreadPool* Default();
+
+  int NumThreads() const;
+
+  // Runs fn on a worker, without waiting for it. It must not throw.
+  void Schedule(std::function<void()> fn);
+
+  // Calls fn(block_begin, block_end) on blocks covering [begin, end), in
+  // parallel, and returns once they are all done. The range is split in
+  // halves until the blocks are at most grain long. An exception thrown by
+  // any of the calls is thrown again once they are all done.
+  void ParallelFor(int64_t begin, int64_t end, int64_t grain,
+                   const std::function<void(int64_t, int64_t)>& fn);
+
+  // Reduces map(block_begin, block_end) over the blocks of grain values
+  // covering [begin, end) with reduce, in order, starting from init. The
+  // blocks are fixed, so the result doesn't depend on the scheduling.
+  template <typename T, typename Map, typename Reduce>
+  T ParallelReduce(int64_t begin, int64_t end, int64_t grain, T init, Map map,
+                   Reduce reduce) {
+    if (end <= begin) return init;
+    if (grain < 1) grain = 1;
+    const int64_t num_blocks = (end - begin + grain - 1) / grain;
+    std::vector<T> partials(num_blocks, init);
+    ParallelFor(0, num_blocks, 1, [&](int64_t first, int64_t last) {
+      for (int64_t block = first; block < last; ++block) {
+        const int64_t block_begin = begin + block * grain;
+        partials[block] = map(block_begin, std::min(block_begin + grain, end));
+      }
+    });
+    T result = std::move(init);
+    for (T& partial : partials) result = reduce(result, std::move(partial));
+    return result;
+  }
+
+ private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
 }  // namespace open_spiel
 
 #endif  // OPEN_SPIEL_UTILS_THREAD_H_
@@ -14,6 +14,11 @@
 
 #include "open_spiel/utils/thread.h"
 
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
 #include "open_spiel/spiel_utils.h"
 
 namespace open_spiel {
@@ -42,6 +47,112 @@ void TestThreadMoveAssign() {
   SPIEL_CHECK_EQ(value, 2);
 }
 
+void TestThreadAffinity() {
+  const std::vector<int> allowed = GetThreadAffinity();
+  if (allowed.empty()) return;  // Unsupported.
+  int num_cpus = 0;
+  for (const std::vector<int>& cpus : CpusByNode()) num_cpus += cpus.size();
+  SPIEL_CHECK_EQ(num_cpus, allowed.size());
+
+  // The affinity is inherited by the threads started afterwards.
+  SPIEL_CHECK_TRUE(SetThreadAffinity({allowed.back()}));
+  std::vector<int> inherited;
+  Thread thread([&]() { inherited = GetThreadAffinity(); });
+  thread.join();
+  SPIEL_CHECK_EQ(inherited, std::vector<int>{allowed.back()});
+  SPIEL_CHECK_TRUE(SetThreadAffinity(allowed));
+  SPIEL_CHECK_EQ(GetThreadAffinity(), allowed);
+}
+
+void TestThreadPoolParallelFor() {
+  for (int num_threads : {0, 1, 4}) {
+    ThreadPool pool(num_threads);
+    SPIEL_CHECK_EQ(pool.NumThreads(), num_threads);
+    std::vector<int> counts(10007, 0);
+    pool.ParallelFor(0, counts.size(), 100, [&](int64_t begin, int64_t end) {
+      SPIEL_CHECK_LE(end - begin, 100);
+      for (int64_t i = begin; i < end; ++i) ++counts[i];
+    });
+    for (int count : counts) SPIEL_CHECK_EQ(count, 1);
+  }
+}
+
+void TestThreadPoolNested() {
+  // The outer loop occupies every worker, so the inner loops only complete
+  // because the waiting threads run their tasks.
+  ThreadPool pool(
+      ThreadPool::Options{/*num_threads=*/3, /*pin_threads=*/true});
+  std::atomic<int64_t> sum{0};
+  pool.ParallelFor(0, 16, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      pool.ParallelFor(0, 1000, 10, [&](int64_t first, int64_t last) {
+        for (int64_t j = first; j < last; ++j) sum += j;
+      });
+    }
+  });
+  SPIEL_CHECK_EQ(sum.load(), 16 * 999 * 1000 / 2);
+}
+
+void TestThreadPoolParallelReduce() {
+  ThreadPool pool(4);
+  const int64_t sum = pool.ParallelReduce(
+      1, 100001, 1000, int64_t{0},
+      [](int64_t begin, int64_t end) {
+        int64_t partial = 0;
+        for (int64_t i = begin; i < end; ++i) partial += i;
+        return partial;
+      },
+      [](int64_t a, int64_t b) { return a + b; });
+  SPIEL_CHECK_EQ(sum, int64_t{100000} * 100001 / 2);
+
+  // The blocks are reduced in order.
+  std::vector<int64_t> order = pool.ParallelReduce(
+      0, 10, 3, std::vector<int64_t>(),
+      [](int64_t begin, int64_t end) {
+        return std::vector<int64_t>{begin, end};
+      },
+      [](std::vector<int64_t> a, std::vector<int64_t> b) {
+        a.insert(a.end(), b.begin(), b.end());
+        return a;
+      });
+  SPIEL_CHECK_EQ(order, std::vector<int64_t>({0, 3, 3, 6, 6, 9, 9, 10}));
+  SPIEL_CHECK_EQ(pool.ParallelReduce(
+                     5, 5, 1, 7, [](int64_t, int64_t) { return 1; },
+                     [](int a, int b) { return a + b; }),
+                 7);
+}
+
+void TestThreadPoolErrors() {
+  ThreadPool pool(2);
+  bool thrown = false;
+  try {
+    pool.ParallelFor(0, 100, 1, [](int64_t begin, int64_t end) {
+      if (begin == 50) throw std::runtime_error("fifty");
+    });
+  } catch (const std::runtime_error& error) {
+    thrown = true;
+    SPIEL_CHECK_EQ(std::string(error.what()), "fifty");
+  }
+  SPIEL_CHECK_TRUE(thrown);
+}
+
+void TestThreadPoolSchedule() {
+  std::atomic<int> count{0};
+  {
+    ThreadPool pool(2);
+    for (int i = 0; i < 100; ++i) pool.Schedule([&count]() { ++count; });
+  }  // The destructor waits for the tasks.
+  SPIEL_CHECK_EQ(count.load(), 100);
+
+  // Also without workers.
+  {
+    ThreadPool pool(0);
+    pool.Schedule([&count]() { ++count; });
+  }
+  SPIEL_CHECK_EQ(count.load(), 101);
+  SPIEL_CHECK_GE(ThreadPool::Default()->NumThreads(), 1);
+}
+
 }  // namespace
 }  // namespace open_spiel
 
@@ -49,4 +160,10 @@ int main(int argc, char** argv) {
   open_spiel::TestThread();
   open_spiel::TestThreadMove();
   open_spiel::TestThreadMoveAssign();
+  open_spiel::TestThreadAffinity();
+  open_spiel::TestThreadPoolParallelFor();
+  open_spiel::TestThreadPoolNested();
+  open_spiel::TestThreadPoolParallelReduce();
+  open_spiel::TestThreadPoolErrors();
+  open_spiel::TestThreadPoolSchedule();
 }
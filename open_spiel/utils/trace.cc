@@ -0,0 +1,160 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/utils/trace.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/synchronization/mutex.h"
+#include "open_spiel/abseil-cpp/absl/time/clock.h"
+#include "open_spiel/utils/file.h"
+#include "open_spiel/utils/json.h"
+
+namespace open_spiel::trace {
+namespace {
+
+struct Span {
+  const char* category;
+  const char* name;
+  int64_t begin_ns;
+  int64_t end_ns;
+};
+
+// The spans of a thread. Only the thread itself records into it, so the lock
+// is uncontended except while the trace is dumped.
+struct ThreadBuffer {
+  explicit ThreadBuffer(int tid) : tid(tid) {}
+
+  const int tid;
+  absl::Mutex m;
+  std::string name ABSL_GUARDED_BY(m);
+  std::vector<Span> spans ABSL_GUARDED_BY(m);  // Allocated by the first.
+  int64_t count ABSL_GUARDED_BY(m) = 0;  // Recorded, including overwritten.
+};
+
+// The buffers of every thread that has recorded a span. They are shared with
+// the threads, so outlive them.
+struct Registry {
+  absl::Mutex m;
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers ABSL_GUARDED_BY(m);
+};
+
+Registry& GetRegistry() {
+  static Registry* registry = new Registry();
+  return *registry;
+}
+
+ThreadBuffer& CurrentBuffer() {
+  thread_local std::shared_ptr<ThreadBuffer> buffer = []() {
+    Registry& registry = GetRegistry();
+    absl::MutexLock lock(&registry.m);
+    registry.buffers.push_back(
+        std::make_shared<ThreadBuffer>(registry.buffers.size()));
+    return registry.buffers.back();
+  }();
+  return *buffer;
+}
+
+std::vector<std::shared_ptr<ThreadBuffer>> Buffers() {
+  Registry& registry = GetRegistry();
+  absl::MutexLock lock(&registry.m);
+  return registry.buffers;
+}
+
+}  // namespace
+
+int64_t NowNanos() { return absl::GetCurrentTimeNanos(); }
+
+void Record(const char* category, const char* name, int64_t begin_ns,
+            int64_t end_ns) {
+  ThreadBuffer& buffer = CurrentBuffer();
+  absl::MutexLock lock(&buffer.m);
+  if (buffer.spans.empty()) buffer.spans.resize(kSpansPerThread);
+  buffer.spans[buffer.count % kSpansPerThread] = {category, name, begin_ns,
+                                                  end_ns};
+  ++buffer.count;
+}
+
+void SetThreadName(const std::string& name) {
+  ThreadBuffer& buffer = CurrentBuffer();
+  absl::MutexLock lock(&buffer.m);
+  buffer.name = name;
+}
+
+// Complete ("X") events, with times in microseconds from the first span, and
+// metadata events for the thread names. See
+// https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU
+std::string ChromeTraceJson() {
+  struct ThreadSpans {
+    int tid;
+    std::string name;
+    std::vector<Span> spans;
+  };
+  std::vector<ThreadSpans> threads;
+  int64_t start_ns = std::numeric_limits<int64_t>::max();
+  for (const std::shared_ptr<ThreadBuffer>& buffer : Buffers()) {
+    absl::MutexLock lock(&buffer->m);
+    ThreadSpans thread{buffer->tid, buffer->name, {}};
+    const int64_t kept = std::min<int64_t>(buffer->count, kSpansPerThread);
+    thread.spans.reserve(kept);
+    for (int64_t i = buffer->count - kept; i < buffer->count; ++i) {
+      thread.spans.push_back(buffer->spans[i % kSpansPerThread]);
+      start_ns = std::min(start_ns, thread.spans.back().begin_ns);
+    }
+    threads.push_back(std::move(thread));
+  }
+
+  json::Array events;
+  for (const ThreadSpans& thread : threads) {
+    if (!thread.name.empty()) {
+      events.push_back(json::Object({
+          {"name", "thread_name"},
+          {"ph", "M"},
+          {"pid", 0},
+          {"tid", thread.tid},
+          {"args", json::Object({{"name", thread.name}})},
+      }));
+    }
+    for (const Span& span : thread.spans) {
+      events.push_back(json::Object({
+          {"name", span.name},
+          {"cat", span.category},
+          {"ph", "X"},
+          {"ts", (span.begin_ns - start_ns) / 1000.0},
+          {"dur", (span.end_ns - span.begin_ns) / 1000.0},
+          {"pid", 0},
+          {"tid", thread.tid},
+      }));
+    }
+  }
+  return json::ToString(json::Object({{"traceEvents", std::move(events)}}));
+}
+
+void WriteChromeTrace(const std::string& filename) {
+  file::File(filename, "w").Write(ChromeTraceJson());
+}
+
+void Clear() {
+  for (const std::shared_ptr<ThreadBuffer>& buffer : Buffers()) {
+    absl::MutexLock lock(&buffer->m);
+    buffer->count = 0;
+  }
+}
+
+}  // namespace open_spiel::trace
@@ -0,0 +1,87 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_UTILS_TRACE_H_
+#define OPEN_SPIEL_UTILS_TRACE_H_
+
+#include <cstdint>
+#include <string>
+
+// A timeline of what the threads are doing, as spans of time with a category
+// and a name, to be viewed in chrome://tracing or https://ui.perfetto.dev:
+//
+//   void Search() {
+//     OPEN_SPIEL_TRACE_SPAN("mcts", "Search");
+//     ...
+//   }
+//   ...
+//   trace::WriteChromeTrace("/tmp/trace.json");
+//
+// The macro is only compiled in when OPEN_SPIEL_TRACING is defined, e.g. by
+// the OPEN_SPIEL_TRACING cmake option, and is free otherwise. Each thread
+// records its spans into its own ring buffer, keeping its last
+// kSpansPerThread, so a span costs two clock reads and an uncontended lock.
+// The category and name aren't copied, so must be string literals.
+
+#ifdef OPEN_SPIEL_TRACING
+#define OPEN_SPIEL_TRACE_CONCAT_INNER(a, b) a##b
+#define OPEN_SPIEL_TRACE_CONCAT(a, b) OPEN_SPIEL_TRACE_CONCAT_INNER(a, b)
+#define OPEN_SPIEL_TRACE_SPAN(category, name)                              \
+  ::open_spiel::trace::ScopedSpan OPEN_SPIEL_TRACE_CONCAT(trace_span_, \
+                                                          __LINE__)(   \
+      category, name)
+#else
+#define OPEN_SPIEL_TRACE_SPAN(category, name) static_cast<void>(0)
+#endif
+
+namespace open_spiel::trace {
+
+inline constexpr int kSpansPerThread = 1 << 16;
+
+int64_t NowNanos();
+
+// Records a span of the calling thread, with times from NowNanos.
+void Record(const char* category, const char* name, int64_t begin_ns,
+            int64_t end_ns);
+
+// Records the span of its lifetime.
+class ScopedSpan {
+ public:
+  ScopedSpan(const char* category, const char* name)
+      : category_(category), name_(name), begin_ns_(NowNanos()) {}
+  ~ScopedSpan() { Record(category_, name_, begin_ns_, NowNanos()); }
+
+  ScopedSpan(const ScopedSpan&) = delete;
+  ScopedSpan& operator=(const ScopedSpan&) = delete;
+
+ private:
+  const char* category_;
+  const char* name_;
+  int64_t begin_ns_;
+};
+
+// Names the calling thread in the trace, e.g. "actor-3".
+void SetThreadName(const std::string& name);
+
+// The spans of all the threads so far, including those that have exited, in
+// the Chrome trace event format, and the same written to a file.
+std::string ChromeTraceJson();
+void WriteChromeTrace(const std::string& filename);
+
+// Forgets the spans recorded so far.
+void Clear();
+
+}  // namespace open_spiel::trace
+
+#endif  // OPEN_SPIEL_UTILS_TRACE_H_
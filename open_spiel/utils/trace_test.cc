@@ -0,0 +1,99 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/utils/trace.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/json.h"
+#include "open_spiel/utils/thread.h"
+
+namespace open_spiel::trace {
+namespace {
+
+json::Array Events() {
+  std::optional<json::Value> trace = json::FromString(ChromeTraceJson());
+  SPIEL_CHECK_TRUE(trace.has_value());
+  return trace->GetObject().at("traceEvents").GetArray();
+}
+
+void TestSpans() {
+  Clear();
+  {
+    ScopedSpan outer("test", "outer");
+    ScopedSpan inner("test", "inner");
+  }
+  Thread thread([]() {
+    SetThreadName("worker");
+    const int64_t now = NowNanos();
+    Record("test", "worker", now, now + 2000);
+  });
+  thread.join();
+
+  // The spans of exited threads are kept.
+  json::Array events = Events();
+  SPIEL_CHECK_EQ(events.size(), 4);
+  SPIEL_CHECK_EQ(events[0].GetObject().at("name"), "inner");
+  SPIEL_CHECK_EQ(events[1].GetObject().at("name"), "outer");
+  SPIEL_CHECK_EQ(events[1].GetObject().at("ph"), "X");
+  SPIEL_CHECK_EQ(events[2].GetObject().at("ph"), "M");
+  SPIEL_CHECK_EQ(events[2].GetObject().at("args").GetObject().at("name"),
+                 "worker");
+  const json::Object& worker = events[3].GetObject();
+  SPIEL_CHECK_EQ(worker.at("cat"), "test");
+  SPIEL_CHECK_EQ(worker.at("dur"), 2.0);
+  SPIEL_CHECK_EQ(worker.at("tid"), events[2].GetObject().at("tid"));
+  SPIEL_CHECK_NE(worker.at("tid"), events[0].GetObject().at("tid"));
+
+  Clear();
+  SPIEL_CHECK_EQ(Events().size(), 1);  // Only the thread name.
+}
+
+void TestRingBuffer() {
+  Clear();
+  for (int i = 0; i < kSpansPerThread + 10; ++i) {
+    Record("test", i < 10 ? "dropped" : "kept", i, i + 1);
+  }
+  int kept = 0;
+  for (const json::Value& event : Events()) {
+    if (event.GetObject().at("ph") == "X") {
+      SPIEL_CHECK_EQ(event.GetObject().at("name"), "kept");
+      ++kept;
+    }
+  }
+  SPIEL_CHECK_EQ(kept, kSpansPerThread);
+  Clear();
+}
+
+void TestMacro() {
+  Clear();
+  { OPEN_SPIEL_TRACE_SPAN("test", "macro"); }
+#ifdef OPEN_SPIEL_TRACING
+  SPIEL_CHECK_EQ(Events().size(), 2);
+#else
+  SPIEL_CHECK_EQ(Events().size(), 1);
+#endif
+}
+
+}  // namespace
+}  // namespace open_spiel::trace
+
+int main(int argc, char** argv) {
+  open_spiel::trace::TestSpans();
+  open_spiel::trace::TestRingBuffer();
+  open_spiel::trace::TestMacro();
+}
@@ -0,0 +1,100 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_UTILS_UNION_FIND_H_
+#define OPEN_SPIEL_UTILS_UNION_FIND_H_
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+
+// The groups of connected stones of a connection game (hex, havannah, y...),
+// as a union-find over the cells of the board. Each group knows its size and
+// a bitmask of the features of the board its stones touch, such as edges or
+// corners, so that a win can be checked after each stone in near constant
+// time, without searching the board.
+//
+// Lookups halve the paths they follow, and joins put the smaller group under
+// the larger one. A cell is 6 bytes, all in one array, for at most 65536
+// cells.
+class UnionFind {
+ public:
+  UnionFind() = default;
+
+  // Each cell starts as a group of its own, touching no feature.
+  explicit UnionFind(int num_cells) : nodes_(num_cells) {
+    SPIEL_CHECK_LE(num_cells, 1 << 16);
+    for (int cell = 0; cell < num_cells; ++cell) Reset(cell, 0);
+  }
+
+  int NumCells() const { return nodes_.size(); }
+
+  // Makes the cell a group of its own, touching these features.
+  void Reset(int cell, uint16_t features) {
+    nodes_[cell] = {static_cast<uint16_t>(cell), 1, features};
+  }
+
+  // The leader of the group of the cell.
+  int Find(int cell) {
+    while (nodes_[cell].parent != cell) {
+      nodes_[cell].parent = nodes_[nodes_[cell].parent].parent;
+      cell = nodes_[cell].parent;
+    }
+    return cell;
+  }
+  int Find(int cell) const {
+    while (nodes_[cell].parent != cell) cell = nodes_[cell].parent;
+    return cell;
+  }
+
+  // Joins the groups of the two cells. Returns true if they were already the
+  // same group.
+  bool Join(int cell_a, int cell_b) {
+    int leader_a = Find(cell_a);
+    int leader_b = Find(cell_b);
+    if (leader_a == leader_b) return true;
+    if (nodes_[leader_a].size < nodes_[leader_b].size) {
+      std::swap(leader_a, leader_b);
+    }
+    nodes_[leader_b].parent = leader_a;
+    nodes_[leader_a].size += nodes_[leader_b].size;
+    nodes_[leader_a].features |= nodes_[leader_b].features;
+    return false;
+  }
+
+  // The size and features of the group of the cell.
+  int GroupSize(int cell) { return nodes_[Find(cell)].size; }
+  uint16_t Features(int cell) { return nodes_[Find(cell)].features; }
+  uint16_t Features(int cell) const { return nodes_[Find(cell)].features; }
+
+  // The memory the cells take on the heap, in bytes.
+  int64_t HeapMemoryUsage() const { return nodes_.capacity() * sizeof(Node); }
+
+ private:
+  struct Node {
+    uint16_t parent;  // The leader of the group if it is the cell itself.
+    uint16_t size;      // Only defined for the leader.
+    uint16_t features;  // Only defined for the leader.
+  };
+
+  std::vector<Node> nodes_;
+};
+
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_UTILS_UNION_FIND_H_
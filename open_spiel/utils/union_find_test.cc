@@ -0,0 +1,69 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/utils/union_find.h"
+
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace {
+
+void TestUnionFind() {
+  UnionFind groups(8);
+  SPIEL_CHECK_EQ(groups.NumCells(), 8);
+  groups.Reset(0, 1);
+  groups.Reset(7, 2);
+  for (int cell = 0; cell < 8; ++cell) {
+    SPIEL_CHECK_EQ(groups.Find(cell), cell);
+    SPIEL_CHECK_EQ(groups.GroupSize(cell), 1);
+  }
+
+  // A chain from one end to the other.
+  for (int cell = 0; cell < 7; ++cell) {
+    SPIEL_CHECK_EQ(groups.Features(0), 1);
+    SPIEL_CHECK_FALSE(groups.Join(cell, cell + 1));
+  }
+  SPIEL_CHECK_TRUE(groups.Join(0, 7));
+  SPIEL_CHECK_EQ(groups.GroupSize(3), 8);
+  SPIEL_CHECK_EQ(groups.Features(3), 3);
+  const UnionFind& const_groups = groups;
+  for (int cell = 0; cell < 8; ++cell) {
+    SPIEL_CHECK_EQ(const_groups.Find(cell), groups.Find(0));
+    SPIEL_CHECK_EQ(const_groups.Features(cell), 3);
+  }
+
+  groups.Reset(4, 4);
+  SPIEL_CHECK_EQ(groups.Find(4), 4);
+  SPIEL_CHECK_EQ(groups.Features(4), 4);
+}
+
+void TestUnionBySize() {
+  UnionFind groups(5);
+  SPIEL_CHECK_FALSE(groups.Join(1, 2));
+  SPIEL_CHECK_FALSE(groups.Join(1, 3));
+  // The single cell joins the larger group, whoever is first.
+  const int leader = groups.Find(1);
+  SPIEL_CHECK_FALSE(groups.Join(0, 1));
+  SPIEL_CHECK_EQ(groups.Find(0), leader);
+  SPIEL_CHECK_EQ(groups.GroupSize(0), 4);
+  SPIEL_CHECK_EQ(groups.GroupSize(4), 1);
+}
+
+}  // namespace
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  open_spiel::TestUnionFind();
+  open_spiel::TestUnionBySize();
+}
@@ -0,0 +1,152 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_UTILS_VARINT_H_
+#define OPEN_SPIEL_UTILS_VARINT_H_
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "open_spiel/abseil-cpp/absl/strings/string_view.h"
+
+// Variable-length integer encoding, used for compact binary serialization.
+// Values are written 7 bits at a time, least significant group first, with the
+// high bit of each byte set when more bytes follow. Signed values are
+// zigzag-encoded first so that small negative numbers also stay short.
+namespace open_spiel {
+
+inline void AppendVarint(uint64_t value, std::string* out) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<char>(value));
+}
+
+inline void AppendSignedVarint(int64_t value, std::string* out) {
+  AppendVarint((static_cast<uint64_t>(value) << 1) ^
+                   static_cast<uint64_t>(value >> 63),
+               out);
+}
+
+// Floats are written as their 4 bytes, least significant first, for the values
+// that don't compress as integers.
+inline void AppendFloat(float value, std::string* out) {
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  for (int i = 0; i < 4; ++i) {
+    out->push_back(static_cast<char>((bits >> (8 * i)) & 0xff));
+  }
+}
+
+inline void AppendDouble(double value, std::string* out) {
+  uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  for (int i = 0; i < 8; ++i) {
+    out->push_back(static_cast<char>((bits >> (8 * i)) & 0xff));
+  }
+}
+
+// Decodes consecutive varints from a byte buffer. Reading past the end of the
+// buffer or a malformed varint puts the reader in a failed state, in which
+// every later read returns 0, so callers can decode a whole record and check
+// ok() once at the end.
+class VarintReader {
+ public:
+  explicit VarintReader(absl::string_view bytes) : bytes_(bytes) {}
+
+  uint64_t Read() {
+    uint64_t value = 0;
+    for (int shift = 0; ok_ && shift < 64; shift += 7) {
+      if (bytes_.empty()) break;
+      const uint8_t byte = static_cast<uint8_t>(bytes_.front());
+      bytes_.remove_prefix(1);
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) return value;
+    }
+    ok_ = false;
+    return 0;
+  }
+
+  int64_t ReadSigned() {
+    const uint64_t value = Read();
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+  }
+
+  // Reads the number of elements of a sequence that follows, each of which
+  // takes at least one byte. Counts larger than the remaining input are
+  // treated as malformed, which bounds allocations made from corrupted input.
+  uint64_t ReadSize() {
+    const uint64_t size = Read();
+    if (size <= bytes_.size()) return size;
+    ok_ = false;
+    return 0;
+  }
+
+  float ReadFloat() {
+    if (!ok_ || bytes_.size() < 4) {
+      ok_ = false;
+      return 0;
+    }
+    uint32_t bits = 0;
+    for (int i = 0; i < 4; ++i) {
+      bits |= static_cast<uint32_t>(static_cast<uint8_t>(bytes_[i])) << (8 * i);
+    }
+    bytes_.remove_prefix(4);
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  double ReadDouble() {
+    if (!ok_ || bytes_.size() < 8) {
+      ok_ = false;
+      return 0;
+    }
+    uint64_t bits = 0;
+    for (int i = 0; i < 8; ++i) {
+      bits |= static_cast<uint64_t>(static_cast<uint8_t>(bytes_[i])) << (8 * i);
+    }
+    bytes_.remove_prefix(8);
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  // Reads `size` raw bytes, e.g. a record whose size was read before.
+  absl::string_view ReadBytes(uint64_t size) {
+    if (!ok_ || size > bytes_.size()) {
+      ok_ = false;
+      return {};
+    }
+    absl::string_view value = bytes_.substr(0, size);
+    bytes_.remove_prefix(size);
+    return value;
+  }
+
+  bool ok() const { return ok_; }
+  bool empty() const { return bytes_.empty(); }
+
+  // The bytes not consumed yet.
+  absl::string_view remaining() const { return bytes_; }
+
+ private:
+  absl::string_view bytes_;
+  bool ok_ = true;
+};
+
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_UTILS_VARINT_H_
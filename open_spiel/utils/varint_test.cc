@@ -0,0 +1,117 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/utils/varint.h"
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "open_spiel/spiel_utils.h"
+
+namespace open_spiel {
+namespace {
+
+void TestVarintRoundTrip() {
+  const std::vector<int64_t> values = {0,
+                                       1,
+                                       -1,
+                                       63,
+                                       -64,
+                                       127,
+                                       128,
+                                       300,
+                                       -300,
+                                       1 << 20,
+                                       std::numeric_limits<int64_t>::max(),
+                                       std::numeric_limits<int64_t>::min()};
+  std::string bytes;
+  for (int64_t value : values) AppendSignedVarint(value, &bytes);
+  AppendVarint(std::numeric_limits<uint64_t>::max(), &bytes);
+
+  VarintReader reader(bytes);
+  for (int64_t value : values) SPIEL_CHECK_EQ(reader.ReadSigned(), value);
+  SPIEL_CHECK_EQ(reader.Read(), std::numeric_limits<uint64_t>::max());
+  SPIEL_CHECK_TRUE(reader.ok());
+  SPIEL_CHECK_TRUE(reader.empty());
+}
+
+void TestVarintSizes() {
+  std::string bytes;
+  AppendVarint(127, &bytes);
+  SPIEL_CHECK_EQ(bytes.size(), 1);
+  AppendVarint(128, &bytes);
+  SPIEL_CHECK_EQ(bytes.size(), 3);
+  // Zigzag keeps small negative values to a single byte.
+  AppendSignedVarint(-64, &bytes);
+  SPIEL_CHECK_EQ(bytes.size(), 4);
+}
+
+void TestVarintTruncated() {
+  std::string bytes;
+  AppendVarint(1 << 20, &bytes);
+  bytes.pop_back();
+  VarintReader reader(bytes);
+  SPIEL_CHECK_EQ(reader.Read(), 0);
+  SPIEL_CHECK_FALSE(reader.ok());
+  SPIEL_CHECK_EQ(reader.Read(), 0);
+  SPIEL_CHECK_FALSE(reader.ok());
+}
+
+void TestVarintReadSize() {
+  std::string bytes;
+  AppendVarint(2, &bytes);
+  AppendVarint(5, &bytes);
+  AppendVarint(7, &bytes);
+  VarintReader reader(bytes);
+  SPIEL_CHECK_EQ(reader.ReadSize(), 2);
+  SPIEL_CHECK_TRUE(reader.ok());
+
+  // There is a single byte left, so a sequence of 5 elements cannot follow.
+  SPIEL_CHECK_EQ(reader.ReadSize(), 0);
+  SPIEL_CHECK_FALSE(reader.ok());
+}
+
+void TestFloatsAndBytes() {
+  std::string bytes;
+  AppendFloat(0.25, &bytes);
+  AppendFloat(-1e30, &bytes);
+  SPIEL_CHECK_EQ(bytes.size(), 8);
+  AppendVarint(3, &bytes);
+  bytes += "abc";
+  AppendDouble(0.1, &bytes);
+  AppendFloat(1, &bytes);
+  bytes.pop_back();
+
+  VarintReader reader(bytes);
+  SPIEL_CHECK_EQ(reader.ReadFloat(), 0.25);
+  SPIEL_CHECK_EQ(reader.ReadFloat(), -1e30f);
+  SPIEL_CHECK_EQ(reader.ReadBytes(reader.Read()), "abc");
+  SPIEL_CHECK_EQ(reader.ReadDouble(), 0.1);
+  SPIEL_CHECK_TRUE(reader.ok());
+  SPIEL_CHECK_EQ(reader.ReadFloat(), 0);  // Truncated.
+  SPIEL_CHECK_FALSE(reader.ok());
+}
+
+}  // namespace
+}  // namespace open_spiel
+
+int main(int argc, char** argv) {
+  open_spiel::TestVarintRoundTrip();
+  open_spiel::TestVarintSizes();
+  open_spiel::TestVarintTruncated();
+  open_spiel::TestVarintReadSize();
+  open_spiel::TestFloatsAndBytes();
+}
@@ -0,0 +1,231 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "open_spiel/vector_state.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+#include "open_spiel/utils/thread.h"
+
+namespace open_spiel {
+
+BatchedKernelRegisterer::BatchedKernelRegisterer(const std::string& short_name,
+                                                 CreateFunc creator) {
+  factories()[short_name] = creator;
+}
+
+std::unique_ptr<BatchedKernel> BatchedKernelRegisterer::Create(
+    const Game& game, int num_states) {
+  auto iter = factories().find(game.GetType().short_name);
+  if (iter == factories().end()) return nullptr;
+  return iter->second(game, num_states);
+}
+
+VectorState::VectorState(std::shared_ptr<const Game> game, int num_states,
+                         int seed, int num_threads, bool use_batched_kernel)
+    : game_(game),
+      num_players_(game->NumPlayers()),
+      num_distinct_actions_(game->NumDistinctActions()),
+      actions_per_state_(game->GetType().dynamics ==
+                                 GameType::Dynamics::kSimultaneous
+                             ? game->NumPlayers()
+                             : 1),
+      num_states_(num_states),
+      num_threads_(std::min(num_threads, num_states)),
+      rewards_(num_states * game->NumPlayers(), 0),
+      dones_(num_states, 0),
+      rngs_(num_states) {
+  SPIEL_CHECK_GT(num_states, 0);
+  SPIEL_CHECK_GT(num_threads, 0);
+  for (int i = 0; i < num_states; ++i) {
+    std::seed_seq seeds{seed, i};
+    rngs_[i].seed(seeds);
+  }
+  if (use_batched_kernel) {
+    kernel_ = BatchedKernelRegisterer::Create(*game_, num_states);
+  }
+  if (kernel_ == nullptr) states_.resize(num_states);
+  Reset();
+}
+
+const State& VectorState::GetState(int index) const {
+  if (kernel_ != nullptr) {
+    SpielFatalError("GetState is not available with a batched kernel.");
+  }
+  return *states_[index];
+}
+
+int VectorState::ObservationTensorsSize() const {
+  return NumStates() * num_players_ * game_->ObservationTensorSize();
+}
+
+int VectorState::LegalActionsMasksSize() const {
+  return NumStates() * num_players_ * num_distinct_actions_;
+}
+
+void VectorState::ParallelFor(const std::function<void(int, int)>& fn) const {
+  if (num_threads_ == 1) {
+    fn(0, NumStates());
+    return;
+  }
+  // The blocks are the same whatever the size of the shared pool.
+  ThreadPool::Default()->ParallelFor(
+      0, num_threads_, 1, [&](int64_t first, int64_t last) {
+        for (int64_t block = first; block < last; ++block) {
+          fn(block * NumStates() / num_threads_,
+             (block + 1) * NumStates() / num_threads_);
+        }
+      });
+}
+
+void VectorState::SampleChance(int index) {
+  State* state = states_[index].get();
+  while (state->IsChanceNode()) {
+    state->ApplyAction(
+        SampleAction(state->ChanceOutcomes(), rngs_[index]).first);
+  }
+}
+
+void VectorState::ResetState(int index) {
+  states_[index] = game_->NewInitialState();
+  SampleChance(index);
+}
+
+void VectorState::Reset() {
+  if (kernel_ != nullptr) {
+    kernel_->Reset(0, NumStates(), absl::MakeSpan(rngs_));
+  } else {
+    for (int i = 0; i < NumStates(); ++i) {
+      ResetState(i);
+    }
+  }
+  std::fill(rewards_.begin(), rewards_.end(), 0);
+  std::fill(dones_.begin(), dones_.end(), 0);
+}
+
+void VectorState::Step(absl::Span<const Action> actions) {
+  SPIEL_CHECK_EQ(actions.size(), NumStates() * actions_per_state_);
+  if (kernel_ != nullptr) {
+    ParallelFor([this, actions](int begin, int end) {
+      kernel_->Step(begin, end, actions, absl::MakeSpan(rngs_),
+                    absl::MakeSpan(rewards_), absl::MakeSpan(dones_));
+    });
+    return;
+  }
+  ParallelFor([this, actions](int begin, int end) {
+    std::vector<Action> joint_action;
+    for (int i = begin; i < end; ++i) {
+      State* state = states_[i].get();
+      absl::Span<const Action> state_actions =
+          actions.subspan(i * actions_per_state_, actions_per_state_);
+      if (state->IsSimultaneousNode()) {
+        joint_action.assign(state_actions.begin(), state_actions.end());
+        state->ApplyActions(joint_action);
+      } else {
+        // Turn-based nodes of simultaneous games take the acting player's
+        // entry.
+        Player player = actions_per_state_ == 1 ? 0 : state->CurrentPlayer();
+        state->ApplyAction(state_actions[player]);
+      }
+      SampleChance(i);
+
+      std::vector<double> rewards = state->Rewards();
+      std::copy(rewards.begin(), rewards.end(),
+                rewards_.begin() + i * num_players_);
+      dones_[i] = state->IsTerminal() ? 1 : 0;
+      if (state->IsTerminal()) ResetState(i);
+    }
+  });
+}
+
+void VectorState::Rewards(absl::Span<float> rewards) const {
+  SPIEL_CHECK_EQ(rewards.size(), rewards_.size());
+  std::copy(rewards_.begin(), rewards_.end(), rewards.begin());
+}
+
+void VectorState::Dones(absl::Span<float> dones) const {
+  SPIEL_CHECK_EQ(dones.size(), dones_.size());
+  std::copy(dones_.begin(), dones_.end(), dones.begin());
+}
+
+void VectorState::ObservationTensors(absl::Span<float> values) const {
+  SPIEL_CHECK_TRUE(game_->GetType().provides_observation_tensor);
+  SPIEL_CHECK_EQ(values.size(), ObservationTensorsSize());
+  if (kernel_ != nullptr) {
+    ParallelFor([this, values](int begin, int end) {
+      kernel_->ObservationTensors(begin, end, values);
+    });
+    return;
+  }
+  const int size = game_->ObservationTensorSize();
+  ParallelFor([this, values, size](int begin, int end) {
+    int offset = begin * num_players_ * size;
+    for (int i = begin; i < end; ++i) {
+      for (Player player = 0; player < num_players_; ++player) {
+        states_[i]->ObservationTensor(player, values.subspan(offset, size));
+        offset += size;
+      }
+    }
+  });
+}
+
+void VectorState::LegalActionsMasks(absl::Span<float> values) const {
+  SPIEL_CHECK_EQ(values.size(), LegalActionsMasksSize());
+  if (kernel_ != nullptr) {
+    std::vector<uint8_t> masks(values.size());
+    LegalActionsMasks(absl::MakeSpan(masks));
+    std::copy(masks.begin(), masks.end(), values.begin());
+    return;
+  }
+  ParallelFor([this, values](int begin, int end) {
+    std::vector<uint8_t> mask(num_distinct_actions_);
+    float* out = values.data() + begin * num_players_ * num_distinct_actions_;
+    for (int i = begin; i < end; ++i) {
+      for (Player player = 0; player < num_players_; ++player) {
+        states_[i]->LegalActionsMask(player, absl::MakeSpan(mask));
+        out = std::copy(mask.begin(), mask.end(), out);
+      }
+    }
+  });
+}
+
+void VectorState::LegalActionsMasks(absl::Span<uint8_t> values) const {
+  SPIEL_CHECK_EQ(values.size(), LegalActionsMasksSize());
+  if (kernel_ != nullptr) {
+    ParallelFor([this, values](int begin, int end) {
+      kernel_->LegalActionsMasks(begin, end, values);
+    });
+    return;
+  }
+  ParallelFor([this, values](int begin, int end) {
+    for (int i = begin; i < end; ++i) {
+      for (Player player = 0; player < num_players_; ++player) {
+        states_[i]->LegalActionsMask(
+            player, values.subspan((i * num_players_ + player) *
+                                       num_distinct_actions_,
+                                   num_distinct_actions_));
+      }
+    }
+  });
+}
+
+}  // namespace open_spiel
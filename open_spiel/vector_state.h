@@ -0,0 +1,183 @@
+// Copyright 2019 DeepMind Technologies Ltd. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPEN_SPIEL_VECTOR_STATE_H_
+#define OPEN_SPIEL_VECTOR_STATE_H_
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "open_spiel/abseil-cpp/absl/types/span.h"
+#include "open_spiel/spiel.h"
+#include "open_spiel/spiel_utils.h"
+
+// A batch of independent episodes of the same game, stepped in lockstep.
+//
+// This is meant as a backend for RL training loops, where driving thousands of
+// State objects one call at a time (and allocating a fresh vector for every
+// observation) dominates the cost of a step. All the outputs are written into
+// contiguous, caller-owned float buffers, laid out state-major:
+//
+//   ObservationTensors: [NumStates(), NumPlayers(), ObservationTensorSize()]
+//   LegalActionsMasks:  [NumStates(), NumPlayers(), NumDistinctActions()]
+//   Rewards:            [NumStates(), NumPlayers()]
+//   Dones:              [NumStates()]
+//
+// Chance nodes are sampled internally, so every state is always at a decision
+// node. When an episode ends during Step, its final rewards and done flag are
+// reported for that step and the slot is immediately reset to a new initial
+// state ("auto-reset"): the observation and legal actions reported for that
+// slot are then the first ones of the next episode.
+//
+// With num_threads > 1, Step, ObservationTensors and LegalActionsMasks split
+// the slots in num_threads contiguous blocks processed in parallel by the
+// shared ThreadPool::Default(). Every slot samples its chance outcomes from its
+// own random number generator, so the episodes do not depend on the number of
+// threads.
+//
+// With use_batched_kernel, games that register a BatchedKernel (see below) are
+// stepped by it instead of through State objects. It plays the same episodes,
+// but GetState is then unavailable.
+namespace open_spiel {
+
+// A struct-of-arrays implementation of a game's episodes for VectorState,
+// keeping each quantity of all the slots in one array so that a step is a few
+// loops over the slots rather than virtual calls on each State. A kernel holds
+// num_states slots and must play exactly the episodes the game's States would:
+// it samples each chance node with SampleAction on the slot's generator, as
+// VectorState does, and reports the same observations, masks and rewards.
+//
+// The methods work on the slots in [begin, end), indexing the buffers and
+// generators, which are laid out as in VectorState, by the slot. VectorState
+// calls them concurrently on disjoint ranges.
+class BatchedKernel {
+ public:
+  virtual ~BatchedKernel() = default;
+
+  // Starts new episodes, sampling through the initial chance nodes.
+  virtual void Reset(int begin, int end, absl::Span<std::mt19937> rngs) = 0;
+
+  // Applies the actions, samples through the chance nodes that follow, writes
+  // the rewards and dones, and resets the slots whose episode ended.
+  virtual void Step(int begin, int end, absl::Span<const Action> actions,
+                    absl::Span<std::mt19937> rngs, absl::Span<float> rewards,
+                    absl::Span<float> dones) = 0;
+
+  virtual void ObservationTensors(int begin, int end,
+                                  absl::Span<float> values) const = 0;
+  virtual void LegalActionsMasks(int begin, int end,
+                                 absl::Span<uint8_t> values) const = 0;
+};
+
+// Registers a kernel factory for a game, by its short name. The factory may
+// return nullptr for parameters the kernel does not support.
+#define REGISTER_BATCHED_KERNEL(short_name, factory) \
+  BatchedKernelRegisterer CONCAT(batched_kernel, __COUNTER__)(short_name, \
+                                                              factory);
+
+class BatchedKernelRegisterer {
+ public:
+  using CreateFunc = std::function<std::unique_ptr<BatchedKernel>(
+      const Game& game, int num_states)>;
+
+  BatchedKernelRegisterer(const std::string& short_name, CreateFunc creator);
+
+  // The kernel for the game, or nullptr if there is none.
+  static std::unique_ptr<BatchedKernel> Create(const Game& game,
+                                               int num_states);
+
+ private:
+  static std::map<std::string, CreateFunc>& factories() {
+    static std::map<std::string, CreateFunc> impl;
+    return impl;
+  }
+};
+
+class VectorState {
+ public:
+  VectorState(std::shared_ptr<const Game> game, int num_states, int seed,
+              int num_threads = 1, bool use_batched_kernel = false);
+
+  int NumStates() const { return num_states_; }
+  int NumPlayers() const { return num_players_; }
+  int NumThreads() const { return num_threads_; }
+  bool UsesBatchedKernel() const { return kernel_ != nullptr; }
+
+  // Number of actions `Step` expects per state: 1 for turn-based games (the
+  // action of the current player) and NumPlayers() for simultaneous-move games
+  // (one action per player, kInvalidAction for players who cannot act).
+  int ActionsPerState() const { return actions_per_state_; }
+
+  // Sizes of the buffers expected by the functions below.
+  int ObservationTensorsSize() const;
+  int LegalActionsMasksSize() const;
+  int RewardsSize() const { return NumStates() * num_players_; }
+  int DonesSize() const { return NumStates(); }
+
+  // Not available when stepping with a batched kernel.
+  const State& GetState(int index) const;
+
+  // Starts a new episode in every slot, and clears the rewards and dones.
+  void Reset();
+
+  // Applies actions[i * ActionsPerState(), (i + 1) * ActionsPerState()) to
+  // state i, samples through any chance nodes that follow, and resets the
+  // states whose episode ended.
+  void Step(absl::Span<const Action> actions);
+
+  // Rewards received by each player during the last Step.
+  void Rewards(absl::Span<float> rewards) const;
+
+  // 1 if the episode in the slot ended during the last Step, 0 otherwise.
+  void Dones(absl::Span<float> dones) const;
+
+  // Observation tensors of every player, for every state. Requires the game to
+  // provide observation tensors.
+  void ObservationTensors(absl::Span<float> values) const;
+
+  // Legal actions masks of every player, for every state. A player who does
+  // not act in a state (e.g. not their turn) has an all-zero mask.
+  void LegalActionsMasks(absl::Span<float> values) const;
+  void LegalActionsMasks(absl::Span<uint8_t> values) const;
+
+ private:
+  void ResetState(int index);
+  void SampleChance(int index);
+
+  // Calls fn(begin, end) on num_threads_ blocks of slots covering them all.
+  // An error raised by any of the calls is raised again once they are done.
+  void ParallelFor(const std::function<void(int, int)>& fn) const;
+
+  std::shared_ptr<const Game> game_;
+  int num_players_;
+  int num_distinct_actions_;
+  int actions_per_state_;
+  int num_states_;
+  int num_threads_;
+  std::unique_ptr<BatchedKernel> kernel_;
+  // Empty when stepping with the kernel.
+  std::vector<std::unique_ptr<State>> states_;
+  std::vector<float> rewards_;
+  std::vector<float> dones_;
+  std::vector<std::mt19937> rngs_;
+};
+
+}  // namespace open_spiel
+
+#endif  // OPEN_SPIEL_VECTOR_STATE_H_